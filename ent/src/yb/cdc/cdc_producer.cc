@@ -308,8 +308,16 @@ CHECKED_STATUS PopulateWriteRecord(const ReplicateMsgPtr& msg,
         docdb::DocKey::EncodedSize(key, docdb::DocKeyPart::kWholeDocKey));
 
     Slice value = write_pair.value();
+    const bool wal_format = metadata.record_format == CDCRecordFormat::WAL;
+    // The WAL format ships the encoded pair as is, so only the value type is needed from it.
     docdb::Value decoded_value;
-    RETURN_NOT_OK(decoded_value.Decode(value));
+    docdb::ValueType value_type;
+    if (wal_format) {
+      RETURN_NOT_OK(docdb::Value::DecodePrimitiveValueType(value, &value_type));
+    } else {
+      RETURN_NOT_OK(decoded_value.Decode(value));
+      value_type = decoded_value.value_type();
+    }
 
     // Compare key hash with previously seen key hash to determine whether the write pair
     // is part of the same row or not.
@@ -317,23 +325,26 @@ CHECKED_STATUS PopulateWriteRecord(const ReplicateMsgPtr& msg,
     if (prev_key != primary_key) {
       // Write pair contains record for different row. Create a new CDCRecord in this case.
       record = resp->add_records();
-      Slice sub_doc_key = key;
-      docdb::SubDocKey decoded_key;
-      RETURN_NOT_OK(decoded_key.DecodeFrom(&sub_doc_key, docdb::HybridTimeRequired::kFalse));
+      bool has_subkeys;
 
-      if (metadata.record_format == CDCRecordFormat::WAL) {
+      if (wal_format) {
         // For 2DC, populate serialized data from WAL, to avoid unnecessary deserializing on
         // producer and re-serializing on consumer.
         auto kv_pair = record->add_key();
-        kv_pair->set_key(std::to_string(decoded_key.doc_key().hash()));
+        kv_pair->set_key(std::to_string(VERIFY_RESULT(docdb::DocKey::DecodeHash(key))));
         kv_pair->mutable_value()->set_binary_value(write_pair.key());
+        has_subkeys = key.size() > key_size &&
+                      key[key_size] != docdb::ValueTypeAsChar::kHybridTime;
       } else {
+        Slice sub_doc_key = key;
+        docdb::SubDocKey decoded_key;
+        RETURN_NOT_OK(decoded_key.DecodeFrom(&sub_doc_key, docdb::HybridTimeRequired::kFalse));
         AddPrimaryKey(decoded_key, schema, record);
+        has_subkeys = decoded_key.num_subkeys() != 0;
       }
 
       // Check whether operation is WRITE or DELETE.
-      if (decoded_value.value_type() == docdb::ValueType::kTombstone &&
-          decoded_key.num_subkeys() == 0) {
+      if (value_type == docdb::ValueType::kTombstone && !has_subkeys) {
         record->set_operation(CDCRecordPB::DELETE);
       } else {
         record->set_operation(CDCRecordPB::WRITE);
@@ -357,7 +368,7 @@ CHECKED_STATUS PopulateWriteRecord(const ReplicateMsgPtr& msg,
     prev_key = primary_key;
     DCHECK(record);
 
-    if (metadata.record_format == CDCRecordFormat::WAL) {
+    if (wal_format) {
       auto kv_pair = record->add_changes();
       kv_pair->set_key(write_pair.key());
       kv_pair->mutable_value()->set_binary_value(write_pair.value());
@@ -66,6 +66,13 @@ TAG_FLAG(cdc_ybclient_reactor_threads, advanced);
 DEFINE_int32(cdc_state_checkpoint_update_interval_ms, 15 * 1000,
              "Rate at which CDC state's checkpoint is updated.");
 
+DEFINE_bool(cdc_state_batch_checkpoint_updates, false,
+            "When set, GetChanges queues its cdc_state checkpoint update instead of writing it, "
+            "and the CDC service background thread writes the latest queued update of every "
+            "tablet and stream in one batch.");
+TAG_FLAG(cdc_state_batch_checkpoint_updates, advanced);
+TAG_FLAG(cdc_state_batch_checkpoint_updates, runtime);
+
 DEFINE_string(certs_for_cdc_dir, "",
               "Directory that contains certificate authorities for CDC producer universes.");
 
@@ -138,6 +145,21 @@ bool YsqlTableHasPrimaryKey(const client::YBSchema& schema) {
 bool IsTabletPeerLeader(const std::shared_ptr<tablet::TabletPeer>& peer) {
   return peer->LeaderStatus() == consensus::LeaderStatus::LEADER_AND_READY;
 }
+
+client::YBqlWriteOpPtr PrepareCdcStateUpdateOp(
+    const client::TableHandle& table, const ProducerTabletInfo& producer_tablet,
+    const OpId& checkpoint, uint64_t last_replication_time_micros) {
+  const auto op = table.NewUpdateOp();
+  auto* const req = op->mutable_request();
+  DCHECK(!producer_tablet.stream_id.empty() && !producer_tablet.tablet_id.empty());
+  QLAddStringHashValue(req, producer_tablet.tablet_id);
+  QLAddStringRangeValue(req, producer_tablet.stream_id);
+  table.AddStringColumnValue(req, master::kCdcCheckpoint, checkpoint.ToString());
+  table.AddTimestampColumnValue(
+      req, master::kCdcLastReplicationTime,
+      last_replication_time_micros);
+  return op;
+}
 } // namespace
 
 template <class ReqType, class RespType>
@@ -596,6 +618,7 @@ void CDCServiceImpl::UpdatePeersAndMetrics() {
       // Have not yet received any GetChanges requests, so skip background thread work.
       continue;
     }
+    FlushPendingCdcStateUpdates();
     // Should we update lag metrics default every 1s.
     if (ShouldUpdateLagMetrics(time_since_update_metrics)) {
       UpdateLagMetrics();
@@ -1180,27 +1203,63 @@ Status CDCServiceImpl::UpdateCheckpoint(const ProducerTabletInfo& producer_table
   }
 
   if (update_cdc_state) {
-    client::TableHandle table;
-    RETURN_NOT_OK(table.Open(kCdcStateTableName, async_client_init_->client()));
-    const auto op = table.NewUpdateOp();
-    auto* const req = op->mutable_request();
-    DCHECK(!producer_tablet.stream_id.empty() && !producer_tablet.tablet_id.empty());
-    QLAddStringHashValue(req, producer_tablet.tablet_id);
-    QLAddStringRangeValue(req, producer_tablet.stream_id);
-    table.AddStringColumnValue(req, master::kCdcCheckpoint, commit_op_id.ToString());
     // If we have a last record hybrid time, use that for physical time. If not, it means we're
     // caught up, so the current time.
     uint64_t last_replication_time_micros = last_record_hybrid_time != 0 ?
         HybridTime(last_record_hybrid_time).GetPhysicalValueMicros() : GetCurrentTimeMicros();
-    table.AddTimestampColumnValue(
-        req, master::kCdcLastReplicationTime,
-        last_replication_time_micros);
-    RETURN_NOT_OK(session->ApplyAndFlush(op));
+    if (GetAtomicFlag(&FLAGS_cdc_state_batch_checkpoint_updates)) {
+      std::lock_guard<std::mutex> l(pending_cdc_state_updates_mutex_);
+      pending_cdc_state_updates_[producer_tablet] =
+          PendingCdcStateUpdate{commit_op_id, last_replication_time_micros};
+      return Status::OK();
+    }
+
+    client::TableHandle table;
+    RETURN_NOT_OK(table.Open(kCdcStateTableName, async_client_init_->client()));
+    RETURN_NOT_OK(session->ApplyAndFlush(PrepareCdcStateUpdateOp(
+        table, producer_tablet, commit_op_id, last_replication_time_micros)));
   }
 
   return Status::OK();
 }
 
+void CDCServiceImpl::FlushPendingCdcStateUpdates() {
+  std::unordered_map<ProducerTabletInfo, PendingCdcStateUpdate, ProducerTabletInfo::Hash> updates;
+  {
+    std::lock_guard<std::mutex> l(pending_cdc_state_updates_mutex_);
+    updates.swap(pending_cdc_state_updates_);
+  }
+  if (updates.empty()) {
+    return;
+  }
+
+  auto status = [this, &updates]() -> Status {
+    client::TableHandle table;
+    RETURN_NOT_OK(table.Open(kCdcStateTableName, async_client_init_->client()));
+    auto session = async_client_init_->client()->NewSession();
+    session->SetTimeout(MonoDelta::FromMilliseconds(FLAGS_cdc_write_rpc_timeout_ms));
+    for (const auto& tablet_and_update : updates) {
+      RETURN_NOT_OK(session->Apply(PrepareCdcStateUpdateOp(
+          table, tablet_and_update.first, tablet_and_update.second.checkpoint,
+          tablet_and_update.second.last_replication_time_micros)));
+    }
+    return session->Flush();
+  }();
+  if (status.ok()) {
+    VLOG(2) << "Wrote " << updates.size() << " cdc_state checkpoint updates";
+    return;
+  }
+
+  LOG(WARNING) << "Unable to write " << updates.size() << " cdc_state checkpoint updates: "
+               << status;
+  // Queue the updates again, unless UpdateCheckpoint has queued a newer one in the meantime.
+  std::lock_guard<std::mutex> l(pending_cdc_state_updates_mutex_);
+  for (auto& tablet_and_update : updates) {
+    pending_cdc_state_updates_.emplace(
+        tablet_and_update.first, std::move(tablet_and_update.second));
+  }
+}
+
 OpId CDCServiceImpl::GetMinSentCheckpointForTablet(const std::string& tablet_id) {
   OpId min_op_id = OpId::Max();
   auto now = CoarseMonoClock::Now();
@@ -129,6 +129,10 @@ class CDCServiceImpl : public CDCServiceIf {
                                   const std::shared_ptr<client::YBSession>& session,
                                   uint64_t last_record_hybrid_time);
 
+  // Writes the cdc_state updates queued by UpdateCheckpoint in a single session, see
+  // cdc_state_batch_checkpoint_updates.
+  void FlushPendingCdcStateUpdates();
+
   Result<google::protobuf::RepeatedPtrField<master::TabletLocationsPB>> GetTablets(
       const CDCStreamId& stream_id);
 
@@ -254,6 +258,16 @@ class CDCServiceImpl : public CDCServiceIf {
   std::unordered_map<std::string, std::shared_ptr<StreamMetadata>> stream_metadata_
       GUARDED_BY(mutex_);
 
+  // Latest cdc_state values of producer tablets that UpdateCheckpoint queued for
+  // FlushPendingCdcStateUpdates.
+  struct PendingCdcStateUpdate {
+    OpId checkpoint;
+    uint64_t last_replication_time_micros;
+  };
+  std::mutex pending_cdc_state_updates_mutex_;
+  std::unordered_map<ProducerTabletInfo, PendingCdcStateUpdate, ProducerTabletInfo::Hash>
+      pending_cdc_state_updates_ GUARDED_BY(pending_cdc_state_updates_mutex_);
+
   // Map of HostPort -> CDCServiceProxy. This is used to redirect requests to tablet leader's
   // CDC service proxy.
   CDCServiceProxyMap cdc_service_map_ GUARDED_BY(mutex_);
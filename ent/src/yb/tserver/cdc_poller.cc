@@ -21,6 +21,7 @@
 #include "yb/client/client.h"
 
 #include "yb/consensus/opid_util.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/threadpool.h"
 
@@ -32,6 +33,11 @@ DEFINE_int32(async_replication_idle_delay_ms, 100,
 DEFINE_int32(async_replication_max_idle_wait, 3,
              "Maximum number of consecutive empty GetChanges until the poller "
              "backs off to the idle interval, rather than immediately retrying.");
+DEFINE_int32(async_replication_max_idle_delay_ms, 100,
+             "When larger than async_replication_idle_delay_ms, the idle interval doubles with "
+             "every further empty GetChanges, up to this value, so that idle replication streams "
+             "poll their producer tablets less often.");
+TAG_FLAG(async_replication_max_idle_delay_ms, runtime);
 DEFINE_int32(replication_failure_delay_exponent, 16 /* ~ 2^16/1000 ~= 65 sec */,
              "Max number of failures (N) to use when calculating exponential backoff (2^N-1).");
 DEFINE_bool(cdc_consumer_use_proxy_forwarding, false,
@@ -110,7 +116,14 @@ void CDCPoller::DoPoll() {
   // determine if we should delay our upcoming poll
   int64_t delay = FLAGS_async_replication_polling_delay_ms; // normal throttling.
   if (idle_polls_ >= FLAGS_async_replication_max_idle_wait) {
-    delay = max(delay, (int64_t)FLAGS_async_replication_idle_delay_ms); // idle backoff.
+    // idle backoff, doubling with every further empty poll up to the max idle delay.
+    int64_t idle_delay = FLAGS_async_replication_idle_delay_ms;
+    const int64_t max_idle_delay = FLAGS_async_replication_max_idle_delay_ms;
+    for (int i = FLAGS_async_replication_max_idle_wait; i < idle_polls_ && idle_delay > 0 &&
+         idle_delay < max_idle_delay; ++i) {
+      idle_delay = min(idle_delay * 2, max_idle_delay);
+    }
+    delay = max(delay, idle_delay);
   }
   if (poll_failures_ > 0) {
     delay = max(delay, (int64_t)1 << poll_failures_); // exponential backoff for failures.
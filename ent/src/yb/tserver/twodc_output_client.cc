@@ -12,6 +12,8 @@
 
 #include "yb/tserver/twodc_output_client.h"
 
+#include <map>
+#include <set>
 #include <shared_mutex>
 
 #include "yb/cdc/cdc_util.h"
@@ -35,6 +37,11 @@ DEFINE_bool(cdc_force_remote_tserver, false,
             "Avoid local tserver apply optimization for CDC and force remote RPCs.");
 TAG_FLAG(cdc_force_remote_tserver, runtime);
 
+DEFINE_int32(cdc_max_parallel_apply_tablets, 1,
+             "Max number of consumer tablets a CDC output client writes a polled batch to at the "
+             "same time. Writes to the same tablet are always sent one after another, in order.");
+TAG_FLAG(cdc_max_parallel_apply_tablets, runtime);
+
 DECLARE_int32(cdc_read_rpc_timeout_ms);
 
 using namespace std::placeholders;
@@ -58,18 +65,20 @@ class TwoDCOutputClient : public cdc::CDCOutputClient {
       consumer_tablet_info_(consumer_tablet_info),
       local_client_(local_client),
       rpcs_(rpcs),
-      write_handle_(rpcs->InvalidHandle()),
       apply_changes_clbk_(std::move(apply_changes_clbk)),
       use_local_tserver_(use_local_tserver) {}
 
   ~TwoDCOutputClient() {
     std::lock_guard<decltype(lock_)> l(lock_);
-    rpcs_->Abort({&write_handle_});
+    for (auto& tablet_and_handle : write_handles_) {
+      rpcs_->Abort({&tablet_and_handle.second});
+    }
   }
 
   CHECKED_STATUS ApplyChanges(const cdc::GetChangesResponsePB* resp) override;
 
-  void WriteCDCRecordDone(const Status& status, const WriteResponsePB& response);
+  void WriteCDCRecordDone(
+      const TabletId& tablet_id, const Status& status, const WriteResponsePB& response);
 
  private:
   void TabletLookupCallback(
@@ -80,7 +89,14 @@ class TwoDCOutputClient : public cdc::CDCOutputClient {
   // Processes the Record and sends the CDCWrite for it.
   void ProcessRecord(const std::vector<std::string>& tablet_ids, const cdc::CDCRecordPB& record);
 
-  void SendNextCDCWriteToTablet(std::unique_ptr<WriteRequestPB> write_request);
+  // Sends the next write requests, see SendNextCDCWritesUnlocked, and responds to the poller if
+  // nothing is left in flight.
+  void SendNextCDCWrites() EXCLUDES(lock_);
+
+  // Sends write requests to tablets that have no write in flight, until
+  // cdc_max_parallel_apply_tablets writes are in flight. Nothing new is sent after an error.
+  // Returns true if no write is in flight anymore, i.e. the batch is done.
+  bool SendNextCDCWritesUnlocked() REQUIRES(lock_);
 
   // Increment processed record count.
   // Returns true if all records are processed, false if there are still some pending records.
@@ -104,14 +120,15 @@ class TwoDCOutputClient : public cdc::CDCOutputClient {
   cdc::ConsumerTabletInfo consumer_tablet_info_;
   std::shared_ptr<CDCClient> local_client_;
   rpc::Rpcs* rpcs_;
-  rpc::Rpcs::Handle write_handle_ GUARDED_BY(lock_);
+  // Write RPC handle per consumer tablet, invalid when there is no write in flight to the tablet.
+  std::map<TabletId, rpc::Rpcs::Handle> write_handles_ GUARDED_BY(lock_);
   std::function<void(const cdc::OutputClientResponse& response)> apply_changes_clbk_;
 
   bool use_local_tserver_;
 
   std::shared_ptr<client::YBTable> table_;
 
-  // Used to protect error_status_, op_id_, done_processing_, write_handle_ and record counts.
+  // Used to protect error_status_, op_id_, done_processing_, write_handles_ and record counts.
   mutable rw_spinlock lock_;
   Status error_status_ GUARDED_BY(lock_);
   OpIdPB op_id_ GUARDED_BY(lock_) = consensus::MinimumOpId();
@@ -158,6 +175,7 @@ Status TwoDCOutputClient::ApplyChanges(const cdc::GetChangesResponsePB* poller_r
     done_processing_ = false;
     processed_record_count_ = 0;
     record_count_ = poller_resp->records_size();
+    write_handles_.clear();
     ResetWriteInterface(&write_strategy_);
   }
 
@@ -215,7 +233,6 @@ bool TwoDCOutputClient::UseLocalTserver() {
 
 void TwoDCOutputClient::ProcessRecord(const std::vector<std::string>& tablet_ids,
                                       const cdc::CDCRecordPB& record) {
-  std::unique_ptr<WriteRequestPB> write_request;
   {
     std::lock_guard<decltype(lock_)> l(lock_);
     for (const auto& tablet_id : tablet_ids) {
@@ -228,18 +245,10 @@ void TwoDCOutputClient::ProcessRecord(const std::vector<std::string>& tablet_ids
     if (!IncProcessedRecordCount()) {
       return;
     }
-    if (error_status_.ok()) {
-      write_request = write_strategy_->GetNextWriteRequest();
-    }
   }
   // Found tablets for all records, now we should write the records.
-  if (write_request) {
-    // Apply the writes on consumer.
-    SendNextCDCWriteToTablet(std::move(write_request));
-  } else {
-    // No write_request on error. Respond, without applying records.
-    HandleResponse();
-  }
+  // On error nothing is sent, and we respond without applying records.
+  SendNextCDCWrites();
 }
 
 void TwoDCOutputClient::TabletLookupCallback(
@@ -273,54 +282,84 @@ void TwoDCOutputClient::TabletLookupCallbackFastTrack(const size_t record_idx) {
   ProcessRecord({consumer_tablet_info_.tablet_id}, twodc_resp_copy_.records(record_idx));
 }
 
-void TwoDCOutputClient::SendNextCDCWriteToTablet(std::unique_ptr<WriteRequestPB> write_request) {
-  // TODO: This should be parallelized for better performance with M:N setups.
-  auto deadline = CoarseMonoClock::Now() +
-                  MonoDelta::FromMilliseconds(FLAGS_cdc_write_rpc_timeout_ms);
-  std::lock_guard<decltype(lock_)> l(lock_);
-  write_handle_ = rpcs_->Prepare();
-  if (write_handle_ != rpcs_->InvalidHandle()) {
+void TwoDCOutputClient::SendNextCDCWrites() {
+  bool done;
+  {
+    std::lock_guard<decltype(lock_)> l(lock_);
+    done = SendNextCDCWritesUnlocked();
+  }
+  if (done) {
+    HandleResponse();
+  }
+}
+
+bool TwoDCOutputClient::SendNextCDCWritesUnlocked() {
+  std::set<TabletId> busy_tablets;
+  for (const auto& tablet_and_handle : write_handles_) {
+    if (tablet_and_handle.second != rpcs_->InvalidHandle()) {
+      busy_tablets.insert(tablet_and_handle.first);
+    }
+  }
+
+  const size_t max_parallel_tablets = std::max(FLAGS_cdc_max_parallel_apply_tablets, 1);
+  while (error_status_.ok() && busy_tablets.size() < max_parallel_tablets) {
+    auto write_request = write_strategy_->GetNextWriteRequest(busy_tablets);
+    if (!write_request) {
+      break;
+    }
+    const TabletId tablet_id = write_request->tablet_id();
+    auto& write_handle =
+        write_handles_.emplace(tablet_id, rpcs_->InvalidHandle()).first->second;
+    write_handle = rpcs_->Prepare();
+    if (write_handle == rpcs_->InvalidHandle()) {
+      LOG(WARNING) << "Invalid handle for CDC write, tablet ID: " << tablet_id;
+      // Do not report the batch as applied, so that the poller retries it.
+      error_status_ = STATUS_FORMAT(Aborted, "Unable to send CDC write to tablet $0", tablet_id);
+      break;
+    }
+    auto deadline = CoarseMonoClock::Now() +
+                    MonoDelta::FromMilliseconds(FLAGS_cdc_write_rpc_timeout_ms);
     // Send in nullptr for RemoteTablet since cdc rpc now gets the tablet_id from the write request.
-    *write_handle_ = CreateCDCWriteRpc(
+    *write_handle = CreateCDCWriteRpc(
         deadline,
         nullptr /* RemoteTablet */,
         local_client_->client.get(),
         write_request.get(),
-        std::bind(&TwoDCOutputClient::WriteCDCRecordDone, this, _1, _2),
+        std::bind(&TwoDCOutputClient::WriteCDCRecordDone, this, tablet_id, _1, _2),
         UseLocalTserver());
-    (**write_handle_).SendRpc();
-  } else {
-    LOG(WARNING) << "Invalid handle for CDC write, tablet ID: " << write_request->tablet_id();
+    (**write_handle).SendRpc();
+    busy_tablets.insert(tablet_id);
   }
+  return busy_tablets.empty();
 }
 
-void TwoDCOutputClient::WriteCDCRecordDone(const Status& status, const WriteResponsePB& response) {
+void TwoDCOutputClient::WriteCDCRecordDone(
+    const TabletId& tablet_id, const Status& status, const WriteResponsePB& response) {
   // Handle response.
   rpc::RpcCommandPtr retained = nullptr;
-  {
-    std::lock_guard<decltype(lock_)> l(lock_);
-    retained = rpcs_->Unregister(&write_handle_);
-  }
-  if (!status.ok()) {
-    HandleError(status, true /* done */);
-    return;
-  } else if (response.has_error()) {
-    HandleError(StatusFromPB(response.error().status()), true /* done */);
-    return;
+  Status write_status = status;
+  if (write_status.ok() && response.has_error()) {
+    write_status = StatusFromPB(response.error().status());
   }
-  cdc_consumer_->IncrementNumSuccessfulWriteRpcs();
-
-  // See if we need to handle any more writes.
-  std::unique_ptr <WriteRequestPB> write_request;
+  bool done;
   {
     std::lock_guard<decltype(lock_)> l(lock_);
-    write_request = write_strategy_->GetNextWriteRequest();
+    retained = rpcs_->Unregister(&write_handles_[tablet_id]);
+    if (!write_status.ok()) {
+      error_status_ = write_status;
+    }
+    // Writes to other tablets may still be in flight, the last one to finish responds.
+    done = SendNextCDCWritesUnlocked();
   }
 
-  if (write_request) {
-    SendNextCDCWriteToTablet(std::move(write_request));
+  if (write_status.ok()) {
+    cdc_consumer_->IncrementNumSuccessfulWriteRpcs();
   } else {
-    // Last record, return response to caller.
+    LOG(ERROR) << "Error while applying replicated record: " << write_status
+               << ", consumer tablet: " << consumer_tablet_info_.tablet_id;
+  }
+
+  if (done) {
     HandleResponse();
   }
 }
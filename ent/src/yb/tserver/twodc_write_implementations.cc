@@ -170,15 +170,20 @@ class BatchedWriteImplementation : public TwoDCWriteInterface {
     return AddRecord(record, write_request->mutable_write_batch());
   }
 
-  std::unique_ptr <WriteRequestPB> GetNextWriteRequest() override {
-    if (records_.empty()) {
+  std::unique_ptr <WriteRequestPB> GetNextWriteRequest(
+      const std::set<std::string>& busy_tablets) override {
+    auto it = records_.begin();
+    while (it != records_.end() && busy_tablets.count(it->first)) {
+      ++it;
+    }
+    if (it == records_.end()) {
       return nullptr;
     }
-    auto& queue = records_.begin()->second;
+    auto& queue = it->second;
     auto next_req = std::move(queue.front());
     queue.pop_front();
     if (queue.empty()) {
-      records_.erase(next_req->tablet_id());
+      records_.erase(it);
     }
     return next_req;
   }
@@ -14,6 +14,7 @@
 #define ENT_SRC_YB_TSERVER_TWODC_WRITE_INTERFACE_H
 
 #include <memory>
+#include <set>
 #include <string>
 
 namespace yb {
@@ -31,7 +32,10 @@ namespace enterprise {
 class TwoDCWriteInterface {
  public:
   virtual ~TwoDCWriteInterface() {}
-  virtual std::unique_ptr<WriteRequestPB> GetNextWriteRequest() = 0;
+  // Returns the next write request for a tablet that is not in busy_tablets, or nullptr if there
+  // is none. Requests to the same tablet are returned in the order their records were processed.
+  virtual std::unique_ptr<WriteRequestPB> GetNextWriteRequest(
+      const std::set<std::string>& busy_tablets) = 0;
   virtual CHECKED_STATUS ProcessRecord(
       const std::string& tablet_id, const cdc::CDCRecordPB& record) = 0;
 };
@@ -477,6 +477,32 @@ public class TestPgSelect extends BasePgSQLTest {
     }
   }
 
+  @Test
+  public void testFollowerReadStaleness() throws Exception {
+    try (Statement statement = connection.createStatement()) {
+      statement.execute("CREATE TABLE stalefollowerread(k int primary key)");
+      Thread.sleep(2000);
+      statement.execute("SET yb_follower_read_staleness_ms = 1000");
+      statement.execute(
+          "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL READ COMMITTED");
+      statement.execute("SET yb_read_from_followers = true");
+      statement.execute("INSERT INTO stalefollowerread(k) SELECT generate_series(0, 9)");
+
+      // Read-only transactions read as of a second ago, before the rows were inserted.
+      statement.execute("START TRANSACTION READ ONLY");
+      assertOneRow(statement, "SELECT count(*) FROM stalefollowerread", 0L);
+      statement.execute("COMMIT");
+
+      // Other transactions ignore the staleness.
+      assertOneRow(statement, "SELECT count(*) FROM stalefollowerread", 10L);
+
+      Thread.sleep(2000);
+      statement.execute("START TRANSACTION READ ONLY");
+      assertOneRow(statement, "SELECT count(*) FROM stalefollowerread", 10L);
+      statement.execute("COMMIT");
+    }
+  }
+
   @Test
   public void testOrderedSelectConsistentPrefix() throws Exception {
     List<Row> expected_rows = new ArrayList<>();
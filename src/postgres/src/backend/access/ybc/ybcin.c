@@ -350,6 +350,7 @@ ybcingettuple(IndexScanDesc scan, ScanDirection dir)
 		ereport(DEBUG1, (errmsg("null exec_params")));
 	} else {
 		ybscan->exec_params->read_from_followers = YBReadFromFollowersEnabled();
+		ybscan->exec_params->follower_read_staleness_ms = YBFollowerReadStalenessMs();
 	}
 	Assert(PointerIsValid(ybscan));
 
@@ -59,6 +59,29 @@ void YBCGetMasterCatalogVersion(uint64_t *version)
 				errmsg("Catalog version type was not set, cannot load system catalog.")));
 }
 
+bool YBCGetLocalTserverCatalogVersion(uint64_t *version)
+{
+	/* Tablet servers may not be running in initdb, e.g. for the initial snapshot. */
+	if (YBCIsInitDbModeEnvVarSet())
+		return false;
+
+	YBCStatus status = YBCGetSharedCatalogVersion(version);
+	if (status)
+	{
+		YBCFreeStatus(status);
+		return false;
+	}
+	return true;
+}
+
+void YBCGetStartupCatalogVersion(uint64_t *version)
+{
+	if (yb_use_tserver_catalog_version_on_startup &&
+		YBCGetLocalTserverCatalogVersion(version))
+		return;
+	YBCGetMasterCatalogVersion(version);
+}
+
 /* Modify Catalog Version */
 
 bool YBCIncrementMasterCatalogVersionTableEntry(bool is_breaking_change)
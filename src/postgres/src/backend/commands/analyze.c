@@ -372,9 +372,17 @@ do_analyze_rel(Relation onerel, int options, VacuumParams *params,
 	int			save_nestlevel;
 	bool		is_yb_relation;
 	bool		is_simple_yb_analyze;
+	bool		yb_collect_stats;
 
 	is_yb_relation = IsYBRelation(onerel);
-	is_simple_yb_analyze = is_yb_relation && !va_cols && !(options & VACOPT_VACUUM);
+	/*
+	 * With sampling enabled, column statistics of a Yugabyte relation are
+	 * computed from rows sampled by DocDB.  Otherwise only the row count is
+	 * collected.
+	 */
+	yb_collect_stats = is_yb_relation && yb_enable_analyze_sampling && !inh;
+	is_simple_yb_analyze = is_yb_relation && (!va_cols || yb_collect_stats) &&
+		!(options & VACOPT_VACUUM);
 	/*
 	 * ANALYZE not supported for Yugabyte relations.
 	 */
@@ -386,9 +394,12 @@ do_analyze_rel(Relation onerel, int options, VacuumParams *params,
 			return;
 		}
 
+		Irel = NULL;
 		nindexes = 0;
+		hasindex = false;
 		totaldeadrows = 0;
-		totalrows = YBCAnalyzeTable(onerel);
+		if (!yb_collect_stats)
+			totalrows = YBCAnalyzeTable(onerel);
 	}
 
 	if (inh)
@@ -429,7 +440,7 @@ do_analyze_rel(Relation onerel, int options, VacuumParams *params,
 			starttime = GetCurrentTimestamp();
 	}
 
-	if (!is_yb_relation)
+	if (!is_yb_relation || yb_collect_stats)
 	{
 		/*
 		* Determine which columns to analyze
@@ -490,9 +501,9 @@ do_analyze_rel(Relation onerel, int options, VacuumParams *params,
 		* columns in the indexes.  We do not analyze index columns if there was
 		* an explicit column list in the ANALYZE command, however.  If we are
 		* doing a recursive scan, we don't want to touch the parent's indexes at
-		* all.
+		* all.  Index expressions of Yugabyte relations are not analyzed.
 		*/
-		if (!inh)
+		if (!inh && !is_yb_relation)
 			vac_open_indexes(onerel, AccessShareLock, &nindexes, &Irel);
 		else
 		{
@@ -573,6 +584,9 @@ do_analyze_rel(Relation onerel, int options, VacuumParams *params,
 			numrows = acquire_inherited_sample_rows(onerel, elevel,
 													rows, targrows,
 													&totalrows, &totaldeadrows);
+		else if (is_yb_relation)
+			numrows = YBCAcquireSampleRows(onerel, rows, targrows,
+										   &totalrows, &totaldeadrows);
 		else
 			numrows = (*acquirefunc) (onerel, elevel,
 										rows, targrows,
@@ -707,6 +707,7 @@ nextval_internal(Oid relid, bool check_permissions)
 				rescnt = 0;
 	bool		cycle;
 	bool		logit = false;
+	int64		yb_node_cache_size;
 
 	/* open and lock sequence */
 	init_sequence(relid, &elm, &seqrel);
@@ -751,6 +752,36 @@ nextval_internal(Oid relid, bool check_permissions)
 	cycle = pgsform->seqcycle;
 	ReleaseSysCache(pgstuple);
 
+	/*
+	 * Values of non-cycling YugaByte sequences are claimed in larger ranges
+	 * when the node level cache is enabled.  The values this backend does not
+	 * cache are kept by the local tserver for the other backends of the node.
+	 */
+	yb_node_cache_size = IsYugaByteEnabled() && !cycle ? YBCGetSequenceNodeCacheSize() : 0;
+	if (yb_node_cache_size > 0)
+	{
+		int64_t first_value;
+		int64_t count;
+
+		HandleYBStatus(YBCTakeNodeCachedSequenceValues(MyDatabaseId,
+													   relid,
+													   yb_catalog_cache_version,
+													   incby,
+													   cache,
+													   &first_value,
+													   &count));
+		if (count > 0)
+		{
+			elm->increment = incby;
+			elm->last = first_value;
+			elm->cached = first_value + (count - 1) * incby;
+			elm->last_valid = true;
+			last_used_seq = elm;
+			relation_close(seqrel, NoLock);
+			return first_value;
+		}
+	}
+
 retry:
 	rescnt = 0;
 	if (IsYugaByteEnabled())
@@ -776,7 +807,7 @@ retry:
 
 	elm->increment = incby;
 	last = next = result = seq->last_value;
-	fetch = cache;
+	fetch = Max(cache, yb_node_cache_size);
 	log = seq->log_cnt;
 
 	if (!seq->is_called)
@@ -909,7 +940,7 @@ check_bounds:
 		HandleYBStatus(YBCUpdateSequenceTupleConditionally(MyDatabaseId,
 														   relid,
 														   yb_catalog_cache_version,
-														   last /* last_val */,
+														   next /* last_val */,
 														   true /* is_called */,
 														   seq->last_value /* expected_last_val */,
 														   seq->is_called /* expected_is_called */,
@@ -918,6 +949,14 @@ check_bounds:
 		{
 			goto retry;
 		}
+		/* Values fetched beyond this backend's cache go to the node level cache. */
+		if (next != last)
+			HandleYBStatus(YBCPutNodeCachedSequenceValues(MyDatabaseId,
+														  relid,
+														  yb_catalog_cache_version,
+														  incby,
+														  last + incby /* first_value */,
+														  (next - last) / incby /* count */));
 		relation_close(seqrel, NoLock);
 		return result;
 	}
@@ -1159,3 +1159,78 @@ YBCAnalyzeTable(Relation rel)
 
 	return res;
 }
+
+/*
+ * Collect a random sample of up to targrows rows of a YugaByte relation for
+ * ANALYZE.  The sample is selected by DocDB while scanning all tablets, so
+ * the rows are not ordered by physical position and the caller must not rely
+ * on that when computing correlation.
+ */
+int
+YBCAcquireSampleRows(Relation rel, HeapTuple *rows, int targrows,
+					 double *totalrows, double *totaldeadrows)
+{
+	YBCPgStatement	ybc_stmt;
+	TupleDesc		tupdesc = RelationGetDescr(rel);
+	Datum		   *values;
+	bool		   *nulls;
+	YBCPgSysColumns	syscols;
+	bool			has_data = false;
+	int				numrows = 0;
+
+	HandleYBStatus(YBCPgNewSample(YBCGetDatabaseOid(rel),
+								  RelationGetRelid(rel),
+								  targrows,
+								  &ybc_stmt));
+
+	/* Set up the scan targets: all live columns of the relation. */
+	if (RelationGetForm(rel)->relhasoids)
+	{
+		YBCPgTypeAttrs type_attrs = { 0 };
+		YBCPgExpr	expr = YBCNewColumnRef(ybc_stmt, ObjectIdAttributeNumber, InvalidOid,
+										   &type_attrs);
+		HandleYBStatus(YBCPgDmlAppendTarget(ybc_stmt, expr));
+	}
+	for (AttrNumber attnum = 1; attnum <= tupdesc->natts; attnum++)
+	{
+		Form_pg_attribute att = TupleDescAttr(tupdesc, attnum - 1);
+		YBCPgTypeAttrs type_attrs = { att->atttypmod };
+		YBCPgExpr	expr;
+
+		if (att->attisdropped)
+			continue;
+		expr = YBCNewColumnRef(ybc_stmt, attnum, att->atttypid, &type_attrs);
+		HandleYBStatus(YBCPgDmlAppendTarget(ybc_stmt, expr));
+	}
+
+	HandleYBStatus(YBCPgExecSample(ybc_stmt));
+
+	values = (Datum *) palloc0(tupdesc->natts * sizeof(Datum));
+	nulls = (bool *) palloc(tupdesc->natts * sizeof(bool));
+	while (numrows < targrows)
+	{
+		memset(nulls, true, tupdesc->natts * sizeof(bool));
+		HandleYBStatus(YBCPgDmlFetch(ybc_stmt,
+									 tupdesc->natts,
+									 (uint64_t *) values,
+									 nulls,
+									 &syscols,
+									 &has_data));
+		if (!has_data)
+			break;
+
+		rows[numrows] = heap_form_tuple(tupdesc, values, nulls);
+		if (syscols.oid != InvalidOid)
+			HeapTupleSetOid(rows[numrows], syscols.oid);
+		rows[numrows]->t_tableOid = RelationGetRelid(rel);
+		numrows++;
+	}
+	pfree(values);
+	pfree(nulls);
+
+	HandleYBStatus(YBCPgGetEstimatedRowCount(ybc_stmt, totalrows));
+	*totaldeadrows = 0;
+	YBCPgDeleteStatement(ybc_stmt);
+
+	return numrows;
+}
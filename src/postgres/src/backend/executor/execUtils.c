@@ -179,6 +179,7 @@ CreateExecutorState(void)
 	estate->yb_exec_params.rowmark = -1;
 	estate->yb_can_batch_updates = false;
 	estate->yb_exec_params.read_from_followers = false;
+	estate->yb_exec_params.follower_read_staleness_ms = 0;
 
 	return estate;
 }
@@ -241,6 +241,8 @@
 #include "utils/tuplesort.h"
 #include "utils/datum.h"
 
+#include "pg_yb_utils.h"
+
 
 static void select_current_set(AggState *aggstate, int setno, bool is_hash);
 static void initialize_phase(AggState *aggstate, int newphase);
@@ -298,6 +300,9 @@ static int find_compatible_pertrans(AggState *aggstate, Aggref *newagg,
 						 List *transnos);
 static void yb_agg_pushdown_supported(AggState *aggstate);
 static void yb_agg_pushdown(AggState *aggstate);
+static bool yb_agg_grouping_pushdown_supported(AggState *aggstate);
+static void yb_agg_advance_pushdown(AggState *aggstate, AggStatePerGroup pergroup,
+									TupleTableSlot *slot);
 
 
 /*
@@ -1461,15 +1466,32 @@ lookup_hash_entry(AggState *aggstate)
 	int			i;
 
 	/* transfer just the needed columns into hashslot */
-	slot_getsomeattrs(inputslot, perhash->largestGrpColIdx);
-	ExecClearTuple(hashslot);
+	if (aggstate->yb_pushdown_supported)
+	{
+		/*
+		 * Rows of aggregates pushed down to YB have values of the grouping
+		 * columns after the aggregate results.
+		 */
+		ExecClearTuple(hashslot);
 
-	for (i = 0; i < perhash->numhashGrpCols; i++)
+		for (i = 0; i < perhash->numhashGrpCols; i++)
+		{
+			hashslot->tts_values[i] = inputslot->tts_values[aggstate->numaggs + i];
+			hashslot->tts_isnull[i] = inputslot->tts_isnull[aggstate->numaggs + i];
+		}
+	}
+	else
 	{
-		int			varNumber = perhash->hashGrpColIdxInput[i] - 1;
+		slot_getsomeattrs(inputslot, perhash->largestGrpColIdx);
+		ExecClearTuple(hashslot);
+
+		for (i = 0; i < perhash->numhashGrpCols; i++)
+		{
+			int			varNumber = perhash->hashGrpColIdxInput[i] - 1;
 
-		hashslot->tts_values[i] = inputslot->tts_values[varNumber];
-		hashslot->tts_isnull[i] = inputslot->tts_isnull[varNumber];
+			hashslot->tts_values[i] = inputslot->tts_values[varNumber];
+			hashslot->tts_isnull[i] = inputslot->tts_isnull[varNumber];
+		}
 	}
 	ExecStoreVirtualTuple(hashslot);
 
@@ -1536,17 +1558,26 @@ yb_agg_pushdown_supported(AggState *aggstate)
 	/* Initially set pushdown supported to false. */
 	aggstate->yb_pushdown_supported = false;
 
-	/* Phase 0 is a dummy phase, so there should be two phases. */
-	if (aggstate->numphases != 2)
-		return;
+	if (aggstate->aggstrategy == AGG_HASHED)
+	{
+		/* GROUP BY columns that DocDB can group rows by. */
+		if (!yb_agg_grouping_pushdown_supported(aggstate))
+			return;
+	}
+	else
+	{
+		/* Phase 0 is a dummy phase, so there should be two phases. */
+		if (aggstate->numphases != 2)
+			return;
 
-	/* Plain agg strategy. */
-	if (aggstate->phase->aggstrategy != AGG_PLAIN)
-		return;
+		/* Plain agg strategy. */
+		if (aggstate->phase->aggstrategy != AGG_PLAIN)
+			return;
 
-	/* No GROUP BY. */
-	if (aggstate->phase->numsets != 0)
-		return;
+		/* No GROUP BY. */
+		if (aggstate->phase->numsets != 0)
+			return;
+	}
 
 	/* Foreign scan outer plan. */
 	if (!IsA(outerPlanState(aggstate), ForeignScanState))
@@ -1648,6 +1679,54 @@ yb_agg_pushdown_supported(AggState *aggstate)
 	aggstate->yb_pushdown_supported = true;
 }
 
+/*
+ * Evaluates whether hashed aggregation can be pushed down to DocDB, which
+ * returns partial aggregates per group of each tablet. Only a single grouping
+ * set of plain table columns is supported, and the output may not reference
+ * other columns.
+ */
+static bool
+yb_agg_grouping_pushdown_supported(AggState *aggstate)
+{
+	Agg		   *aggnode = (Agg *) aggstate->ss.ps.plan;
+	List	   *outer_tlist = outerPlanState(aggstate)->plan->targetlist;
+	AggStatePerHash perhash;
+	int			i;
+
+	if (!yb_enable_grouped_aggregate_pushdown)
+		return false;
+
+	/* DocDB groups rows only to evaluate aggregates. */
+	if (aggstate->aggs == NIL)
+		return false;
+
+	/* Single hashed grouping set. */
+	if (aggstate->numphases != 1 || aggstate->num_hashes != 1 ||
+		aggnode->groupingSets != NIL)
+		return false;
+
+	/* Hash table stores only the grouping columns. */
+	perhash = &aggstate->perhash[0];
+	if (perhash->numCols == 0 || perhash->numhashGrpCols != perhash->numCols)
+		return false;
+
+	for (i = 0; i < perhash->numCols; i++)
+	{
+		TargetEntry *tle = list_nth_node(TargetEntry, outer_tlist,
+										 perhash->hashGrpColIdxInput[i] - 1);
+		Var		   *var;
+
+		if (!IsA(tle->expr, Var))
+			return false;
+
+		/* Same as aggregate arguments, DocDB should be able to compare the values. */
+		var = castNode(Var, tle->expr);
+		if (var->varattno <= 0 || !YBCDataTypeIsValidForKey(var->vartype))
+			return false;
+	}
+	return true;
+}
+
 /*
  * Populates aggregate pushdown information in the YB foreign scan state.
  */
@@ -1656,7 +1735,13 @@ yb_agg_pushdown(AggState *aggstate)
 {
 	ForeignScanState *scan_state = castNode(ForeignScanState, outerPlanState(aggstate));
 	List *pushdown_aggs = NIL;
+	List *group_cols = NIL;
 	int aggno;
+	int i;
+
+	/* Hashed aggregation calls this for each output row, setup the scan once. */
+	if (scan_state->yb_fdw_aggs != NIL)
+		return;
 
 	for (aggno = 0; aggno < aggstate->numaggs; aggno++)
 	{
@@ -1665,10 +1750,70 @@ yb_agg_pushdown(AggState *aggstate)
 		pushdown_aggs = lappend(pushdown_aggs, aggref);
 	}
 	scan_state->yb_fdw_aggs = pushdown_aggs;
+
+	if (aggstate->aggstrategy == AGG_HASHED)
+	{
+		List *outer_tlist = outerPlanState(aggstate)->plan->targetlist;
+		AggStatePerHash perhash = &aggstate->perhash[0];
+
+		for (i = 0; i < perhash->numCols; i++)
+		{
+			TargetEntry *tle = list_nth_node(TargetEntry, outer_tlist,
+											 perhash->hashGrpColIdxInput[i] - 1);
+
+			group_cols = lappend(group_cols, tle->expr);
+		}
+	}
+	scan_state->yb_fdw_group_cols = group_cols;
 	/* Disable projection for tuples produced by pushed down aggregate operators. */
 	scan_state->ss.ps.ps_ProjInfo = NULL;
 }
 
+/*
+ * Combines partial aggregate results returned by DocDB into the transition
+ * values of the group. The slot contains one value for each aggno.
+ *
+ * We special case for COUNT and sum values so it returns the proper count
+ * aggregated across all responses.
+ */
+static void
+yb_agg_advance_pushdown(AggState *aggstate, AggStatePerGroup pergroup, TupleTableSlot *slot)
+{
+	int aggno;
+
+	for (aggno = 0; aggno < aggstate->numaggs; aggno++)
+	{
+		MemoryContext oldContext;
+		int transno = aggstate->peragg[aggno].transno;
+		Aggref *aggref = aggstate->peragg[aggno].aggref;
+		char *func_name = get_func_name(aggref->aggfnoid);
+		AggStatePerGroup pergroupstate = &pergroup[transno];
+		AggStatePerTrans pertrans = &aggstate->pertrans[transno];
+		FunctionCallInfo fcinfo = &pertrans->transfn_fcinfo;
+		Datum value = slot->tts_values[aggno];
+		bool isnull = slot->tts_isnull[aggno];
+
+		if (strcmp(func_name, "count") == 0)
+		{
+			/*
+			 * Sum results from each response for COUNT. It is safe to do this
+			 * directly on the datum as it is guaranteed to be an int64.
+			 */
+			oldContext = MemoryContextSwitchTo(
+				aggstate->curaggcontext->ecxt_per_tuple_memory);
+			pergroupstate->transValue += value;
+			MemoryContextSwitchTo(oldContext);
+		}
+		else
+		{
+			/* Set slot result as argument, then advance the transition function. */
+			fcinfo->arg[1] = value;
+			fcinfo->argnull[1] = isnull;
+			advance_transition_function(aggstate, pertrans, pergroupstate);
+		}
+	}
+}
+
 /*
  * ExecAgg -
  *
@@ -1749,7 +1894,6 @@ agg_retrieve_direct(AggState *aggstate)
 	int			nextSetSize;
 	int			numReset;
 	int			i;
-	int			aggno;
 
 	/*
 	 * get state info from node
@@ -1917,38 +2061,7 @@ agg_retrieve_direct(AggState *aggstate)
 
 				Assert(aggstate->numaggs == outerslot->tts_nvalid);
 
-				for (aggno = 0; aggno < aggstate->numaggs; aggno++)
-				{
-					MemoryContext oldContext;
-					int transno = peragg[aggno].transno;
-					Aggref *aggref = aggstate->peragg[aggno].aggref;
-					char *func_name = get_func_name(aggref->aggfnoid);
-					AggStatePerGroup pergroup = pergroups[currentSet];
-					AggStatePerGroup pergroupstate = &pergroup[transno];
-					AggStatePerTrans pertrans = &aggstate->pertrans[transno];
-					FunctionCallInfo fcinfo = &pertrans->transfn_fcinfo;
-					Datum value = outerslot->tts_values[aggno];
-					bool isnull = outerslot->tts_isnull[aggno];
-
-					if (strcmp(func_name, "count") == 0)
-					{
-						/*
-						 * Sum results from each response for COUNT. It is safe to do this
-						 * directly on the datum as it is guaranteed to be an int64.
-						 */
-						oldContext = MemoryContextSwitchTo(
-							aggstate->curaggcontext->ecxt_per_tuple_memory);
-						pergroupstate->transValue += value;
-						MemoryContextSwitchTo(oldContext);
-					}
-					else
-					{
-						/* Set slot result as argument, then advance the transition function. */
-						fcinfo->arg[1] = value;
-						fcinfo->argnull[1] = isnull;
-						advance_transition_function(aggstate, pertrans, pergroupstate);
-					}
-				}
+				yb_agg_advance_pushdown(aggstate, pergroups[currentSet], outerslot);
 
 				/* Reset per-input-tuple context after each tuple */
 				ResetExprContext(tmpcontext);
@@ -2161,8 +2274,14 @@ agg_fill_hash_table(AggState *aggstate)
 		/* Find or build hashtable entries */
 		lookup_hash_entries(aggstate);
 
-		/* Advance the aggregates (or combine functions) */
-		advance_aggregates(aggstate);
+		/*
+		 * Advance the aggregates (or combine functions). Aggregates pushed
+		 * down to YB return partial results of the group, which are combined.
+		 */
+		if (aggstate->yb_pushdown_supported)
+			yb_agg_advance_pushdown(aggstate, aggstate->hash_pergroup[0], outerslot);
+		else
+			advance_aggregates(aggstate);
 
 		/*
 		 * Reset per-input-tuple context after each tuple, but note that the
@@ -122,6 +122,7 @@ IndexOnlyNext(IndexOnlyScanState *node)
 		// TODO(hector) Add row marks for INDEX_ONLY_SCAN
 		scandesc->yb_exec_params->rowmark = -1;
 		scandesc->yb_exec_params->read_from_followers = YBReadFromFollowersEnabled();
+		scandesc->yb_exec_params->follower_read_staleness_ms = YBFollowerReadStalenessMs();
 	}
 
 	/*
@@ -74,18 +74,16 @@ YBCPgExpr YBCNewEvalSingleParamExprCall(YBCPgStatement ybc_stmt,
 	return YBCNewEvalExprCall(ybc_stmt, pg_expr, params, 1);
 }
 
-/*
- * Assuming the first param is the target column, therefore representing both 
- * the first argument and return type.
- */
-YBCPgExpr YBCNewEvalExprCall(YBCPgStatement ybc_stmt,
-                             Expr *pg_expr,
-                             YBExprParamDesc *params,
-                             int num_params)
+static YBCPgExpr YBCNewEvalCall(YBCPgStatement ybc_stmt,
+                                const char *opname,
+                                Oid result_typid,
+                                Expr *pg_expr,
+                                YBExprParamDesc *params,
+                                int num_params)
 {
 	YBCPgExpr ybc_expr = NULL;
-	const YBCPgTypeEntity *type_ent = YBCDataTypeFromOidMod(InvalidAttrNumber, params[0].typid);
-	YBCPgNewOperator(ybc_stmt, "eval_expr_call", type_ent, &ybc_expr);
+	const YBCPgTypeEntity *type_ent = YBCDataTypeFromOidMod(InvalidAttrNumber, result_typid);
+	YBCPgNewOperator(ybc_stmt, opname, type_ent, &ybc_expr);
 
 	Datum expr_datum = CStringGetDatum(nodeToString(pg_expr));
 	YBCPgExpr expr = YBCNewConstant(ybc_stmt, CSTRINGOID, expr_datum , /* IsNull */ false);
@@ -111,3 +109,29 @@ YBCPgExpr YBCNewEvalExprCall(YBCPgStatement ybc_stmt,
 	}
 	return ybc_expr;
 }
+
+/*
+ * Assuming the first param is the target column, therefore representing both 
+ * the first argument and return type.
+ */
+YBCPgExpr YBCNewEvalExprCall(YBCPgStatement ybc_stmt,
+                             Expr *pg_expr,
+                             YBExprParamDesc *params,
+                             int num_params)
+{
+	return YBCNewEvalCall(ybc_stmt, "eval_expr_call", params[0].typid, pg_expr, params,
+	                      num_params);
+}
+
+/*
+ * Boolean expression, e.g. a scan qual, to be evaluated by DocDB for each row.
+ * Params are all table columns referenced by the expression.
+ */
+YBCPgExpr YBCNewEvalBoolExprCall(YBCPgStatement ybc_stmt,
+                                 Expr *pg_expr,
+                                 YBExprParamDesc *params,
+                                 int num_params)
+{
+	return YBCNewEvalCall(ybc_stmt, "eval_bool_expr_call", BOOLOID, pg_expr, params,
+	                      num_params);
+}
@@ -43,6 +43,7 @@
 #include "foreign/foreign.h"
 #include "miscadmin.h"
 #include "nodes/makefuncs.h"
+#include "optimizer/clauses.h"
 #include "optimizer/cost.h"
 #include "optimizer/pathnode.h"
 #include "optimizer/paths.h"
@@ -51,12 +52,14 @@
 #include "optimizer/var.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
+#include "utils/ruleutils.h"
 #include "utils/sampling.h"
 
 /*  YB includes. */
 #include "commands/dbcommands.h"
 #include "catalog/pg_operator.h"
 #include "catalog/ybctype.h"
+#include "optimizer/ybcplan.h"
 #include "utils/lsyscache.h"
 #include "utils/syscache.h"
 
@@ -164,9 +167,21 @@ ybcGetForeignPlan(PlannerInfo *root,
 	YbFdwPlanState *yb_plan_state = (YbFdwPlanState *) baserel->fdw_private;
 	Index          scan_relid     = baserel->relid;
 	ListCell       *lc;
+	List           *local_clauses = NIL;
+	List           *remote_clauses = NIL;
 
 	scan_clauses = extract_actual_clauses(scan_clauses, false);
 
+	/* Clauses that DocDB can evaluate are sent to it, others are checked by the executor. */
+	foreach(lc, scan_clauses)
+	{
+		Expr *expr = (Expr *) lfirst(lc);
+		if (yb_enable_expression_pushdown && YBCIsSupportedDocDBFilterExpr(expr, scan_relid))
+			remote_clauses = lappend(remote_clauses, expr);
+		else
+			local_clauses = lappend(local_clauses, expr);
+	}
+
 	/* Get the target columns that need to be retrieved from YugaByte */
 	foreach(lc, baserel->reltarget->exprs)
 	{
@@ -177,7 +192,8 @@ ybcGetForeignPlan(PlannerInfo *root,
 		                        baserel->min_attr);
 	}
 
-	foreach(lc, scan_clauses)
+	/* Columns referenced only by remote clauses are read by DocDB, but not returned. */
+	foreach(lc, local_clauses)
 	{
 		Expr *expr = (Expr *) lfirst(lc);
 		pull_varattnos_min_attr((Node *) expr,
@@ -230,9 +246,9 @@ ybcGetForeignPlan(PlannerInfo *root,
 
 	/* Create the ForeignScan node */
 	return make_foreignscan(tlist,  /* target list */
-	                        scan_clauses,
+	                        local_clauses,
 	                        scan_relid,
-	                        NIL,    /* expressions YB may evaluate (none) */
+	                        remote_clauses,  /* expressions YB evaluates */
 	                        target_attrs,  /* fdw_private data for YB */
 	                        NIL,    /* custom YB target list (none for now) */
 	                        NIL,    /* custom YB target list (none for now) */
@@ -251,6 +267,7 @@ typedef struct YbFdwExecState
 	YBCPgStatement	handle;
 	YBCPgExecParameters *exec_params; /* execution control parameters for YugaByte */
 	bool is_exec_done; /* Each statement should be executed exactly one time */
+	YBCPgExecStats exec_stats; /* DocDB stats of the statements freed by rescans */
 } YbFdwExecState;
 
 /*
@@ -281,6 +298,7 @@ ybcBeginForeignScan(ForeignScanState *node, int eflags)
 
 	ybc_state->exec_params->rowmark = -1;
 	ybc_state->exec_params->read_from_followers = YBReadFromFollowersEnabled();
+	ybc_state->exec_params->follower_read_staleness_ms = YBFollowerReadStalenessMs();
 	if (YBReadFromFollowersEnabled()) {
 		ereport(DEBUG2, (errmsg("Doing read from followers")));
 	}
@@ -298,6 +316,15 @@ ybcBeginForeignScan(ForeignScanState *node, int eflags)
 
 	/* Set the current syscatalog version (will check that we are up to date) */
 	HandleYBStatus(YBCPgSetCatalogCacheVersion(ybc_state->handle, yb_catalog_cache_version));
+
+	/* Collect DocDB execution stats for EXPLAIN ANALYZE. */
+	if (node->ss.ps.instrument)
+		HandleYBStatus(YBCPgDmlSetCollectExecStats(ybc_state->handle, true));
+
+	/* Keep large scans from evicting the cached blocks of other reads. */
+	if (yb_large_scan_rows_threshold > 0 &&
+		node->ss.ps.plan->plan_rows >= yb_large_scan_rows_threshold)
+		HandleYBStatus(YBCPgDmlSetFillBlockCache(ybc_state->handle, false));
 }
 
 /*
@@ -458,18 +485,84 @@ ybcSetupScanTargets(ForeignScanState *node)
 			HandleYBStatus(YBCPgDmlAppendTarget(ybc_state->handle, op_handle));
 		}
 
+		/* Grouping columns, their values follow aggregate results in the returned rows. */
+		foreach(lc, node->yb_fdw_group_cols)
+		{
+			Var *var = lfirst_node(Var, lc);
+			Form_pg_attribute attr = TupleDescAttr(tupdesc, var->varattno - 1);
+			YBCPgTypeAttrs type_attrs = {attr->atttypmod};
+
+			YBCPgExpr colref = YBCNewColumnRef(ybc_state->handle,
+											   var->varattno,
+											   attr->atttypid,
+											   &type_attrs);
+			HandleYBStatus(YBCPgDmlAppendGroupingColumn(ybc_state->handle, colref));
+		}
+
 		/*
 		 * Setup the scan slot based on new tuple descriptor for the given targets. This is a dummy
 		 * tupledesc that only includes the number of attributes. Switch to per-query memory from
 		 * per-tuple memory so the slot persists across iterations.
 		 */
-		TupleDesc target_tupdesc = CreateTemplateTupleDesc(list_length(node->yb_fdw_aggs),
+		TupleDesc target_tupdesc = CreateTemplateTupleDesc(list_length(node->yb_fdw_aggs) +
+														   list_length(node->yb_fdw_group_cols),
 														   false /* hasoid */);
 		ExecInitScanTupleSlot(estate, &node->ss, target_tupdesc);
 	}
 	MemoryContextSwitchTo(oldcontext);
 }
 
+/*
+ * Send the clauses chosen by ybcGetForeignPlan to DocDB as a single filter.
+ */
+static void
+ybcSetupScanQuals(ForeignScanState *node)
+{
+	ForeignScan *foreignScan = (ForeignScan *) node->ss.ps.plan;
+	Relation relation = node->ss.ss_currentRelation;
+	YbFdwExecState *ybc_state = (YbFdwExecState *) node->fdw_state;
+	TupleDesc tupdesc = RelationGetDescr(relation);
+	ListCell *lc;
+
+	if (foreignScan->fdw_exprs == NIL)
+		return;
+
+	MemoryContext oldcontext =
+		MemoryContextSwitchTo(node->ss.ps.ps_ExprContext->ecxt_per_query_memory);
+
+	Expr *qual = make_ands_explicit(foreignScan->fdw_exprs);
+	List *vars = pull_var_clause((Node *) qual, 0 /* flags */);
+	YBExprParamDesc *params = palloc(sizeof(YBExprParamDesc) * list_length(vars));
+	Bitmapset *referenced_attrs = NULL;
+	int num_params = 0;
+
+	foreach(lc, vars)
+	{
+		Var *var = lfirst_node(Var, lc);
+		if (bms_is_member(var->varattno, referenced_attrs))
+			continue;
+		referenced_attrs = bms_add_member(referenced_attrs, var->varattno);
+
+		Form_pg_attribute attr = TupleDescAttr(tupdesc, var->varattno - 1);
+		params[num_params].attno = var->varattno;
+		params[num_params].typid = attr->atttypid;
+		params[num_params].typmod = attr->atttypmod;
+		++num_params;
+
+		/* DocDB should read the column to evaluate the filter. */
+		YBCPgTypeAttrs type_attrs = {attr->atttypmod};
+		YBCPgExpr colref = YBCNewColumnRef(ybc_state->handle,
+		                                   var->varattno,
+		                                   attr->atttypid,
+		                                   &type_attrs);
+		HandleYBStatus(YBCPgDmlAppendColumnRef(ybc_state->handle, colref));
+	}
+
+	YBCPgExpr where_expr = YBCNewEvalBoolExprCall(ybc_state->handle, qual, params, num_params);
+	HandleYBStatus(YBCPgDmlSetWhereExpr(ybc_state->handle, where_expr));
+	MemoryContextSwitchTo(oldcontext);
+}
+
 /*
  * ybcIterateForeignScan
  *		Read next record from the data file and store it into the
@@ -490,6 +583,7 @@ ybcIterateForeignScan(ForeignScanState *node)
 	 */
 	if (!ybc_state->is_exec_done) {
 		ybcSetupScanTargets(node);
+		ybcSetupScanQuals(node);
 		HandleYBStatus(YBCPgExecSelect(ybc_state->handle, ybc_state->exec_params));
 		ybc_state->is_exec_done = true;
 	}
@@ -562,12 +656,18 @@ static void
 ybcReScanForeignScan(ForeignScanState *node)
 {
 	YbFdwExecState *ybc_state = (YbFdwExecState *) node->fdw_state;
+	YBCPgExecStats exec_stats = ybc_state->exec_stats;
+
+	/* Keep the stats of the previous select for EXPLAIN ANALYZE. */
+	if (node->ss.ps.instrument && ybc_state->handle != NULL)
+		HandleYBStatus(YBCPgDmlAddExecStats(ybc_state->handle, &exec_stats));
 
 	/* Clear (delete) the previous select */
 	ybcFreeStatementObject(ybc_state);
 
 	/* Re-allocate and execute the select. */
 	ybcBeginForeignScan(node, 0 /* eflags */);
+	((YbFdwExecState *) node->fdw_state)->exec_stats = exec_stats;
 }
 
 /*
@@ -581,6 +681,60 @@ ybcEndForeignScan(ForeignScanState *node)
 	ybcFreeStatementObject(ybc_state);
 }
 
+/*
+ * ybcExplainExecStats
+ *		Show the work done by DocDB to execute the scan, for EXPLAIN (ANALYZE, DIST).
+ */
+static void
+ybcExplainExecStats(ForeignScanState *node, ExplainState *es)
+{
+	YbFdwExecState *ybc_state = (YbFdwExecState *) node->fdw_state;
+	YBCPgExecStats stats;
+
+	if (ybc_state == NULL)
+		return;
+
+	stats = ybc_state->exec_stats;
+	if (ybc_state->handle != NULL)
+		HandleYBStatus(YBCPgDmlAddExecStats(ybc_state->handle, &stats));
+
+	ExplainPropertyInteger("Storage Read Requests", NULL, stats.num_requests, es);
+	ExplainPropertyInteger("Storage Rows Examined", NULL, stats.rows_examined, es);
+	ExplainPropertyInteger("Storage Rows Returned", NULL, stats.rows_returned, es);
+	ExplainPropertyInteger("Storage Seeks", NULL, stats.rocksdb_seeks, es);
+	ExplainPropertyInteger("Storage Nexts", NULL, stats.rocksdb_nexts + stats.rocksdb_prevs, es);
+	ExplainPropertyInteger("Storage Block Cache Hits", NULL, stats.block_cache_hits, es);
+	ExplainPropertyInteger("Storage Block Reads", NULL, stats.block_reads, es);
+	ExplainPropertyInteger("Storage Block Read Bytes", NULL, stats.block_read_bytes, es);
+	ExplainPropertyFloat("Storage Execution Time", "ms",
+						 stats.execution_time_us / 1000.0, 3, es);
+}
+
+/*
+ * ybcExplainForeignScan
+ *		Show the clauses that are evaluated by DocDB.
+ */
+static void
+ybcExplainForeignScan(ForeignScanState *node, ExplainState *es)
+{
+	ForeignScan *foreignScan = (ForeignScan *) node->ss.ps.plan;
+
+	if (es->analyze && es->dist)
+		ybcExplainExecStats(node, es);
+
+	if (foreignScan->fdw_exprs == NIL)
+		return;
+
+	List *context = set_deparse_context_planstate(es->deparse_cxt,
+	                                              (Node *) node,
+	                                              NIL /* ancestors */);
+	char *exprstr = deparse_expression((Node *) make_ands_explicit(foreignScan->fdw_exprs),
+	                                   context,
+	                                   list_length(es->rtable) > 1 /* useprefix */,
+	                                   false /* showimplicit */);
+	ExplainPropertyText("Remote Filter", exprstr, es);
+}
+
 /* ------------------------------------------------------------------------- */
 /*  FDW declaration */
 
@@ -601,8 +755,9 @@ ybc_fdw_handler()
 	fdwroutine->ReScanForeignScan  = ybcReScanForeignScan;
 	fdwroutine->EndForeignScan     = ybcEndForeignScan;
 
+	fdwroutine->ExplainForeignScan = ybcExplainForeignScan;
+
 	/* TODO: These are optional but we should support them eventually. */
-	/* fdwroutine->ExplainForeignScan = ybcExplainForeignScan; */
 	/* fdwroutine->AnalyzeForeignTable = ybcAnalyzeForeignTable; */
 	/* fdwroutine->IsForeignScanParallelSafe = ybcIsForeignScanParallelSafe; */
 
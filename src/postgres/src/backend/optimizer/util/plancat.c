@@ -962,7 +962,11 @@ estimate_rel_size(Relation rel, int32 *attr_widths,
 	{
 		*pages = rel->rd_rel->relpages;
 		*tuples = rel->rd_rel->reltuples;
-		*allvisfrac = 0;
+		/*
+		 * Index-only scans of YugaByte relations never visit the base table,
+		 * as DocDB resolves visibility, so treat all of it as all-visible.
+		 */
+		*allvisfrac = IsYBRelation(rel) ? 1 : 0;
 		return;
 	}
 
@@ -28,11 +28,14 @@
 #include "catalog/pg_proc.h"
 #include "catalog/pg_type.h"
 #include "nodes/makefuncs.h"
+#include "nodes/nodeFuncs.h"
 #include "nodes/nodes.h"
 #include "nodes/plannodes.h"
 #include "nodes/print.h"
 #include "nodes/relation.h"
+#include "optimizer/var.h"
 #include "utils/datum.h"
+#include "utils/pg_locale.h"
 #include "utils/rel.h"
 #include "utils/syscache.h"
 #include "utils/lsyscache.h"
@@ -377,6 +380,134 @@ bool YBCIsSupportedSingleRowModifyAssignExpr(Expr *expr, AttrNumber target_attnu
 	return false;
 }
 
+/*
+ * Column types whose values DocDB converts to datums to evaluate YSQL expressions.
+ */
+static bool YBCIsSupportedDocDBFilterColumnType(Oid typid)
+{
+	switch (typid)
+	{
+		case BOOLOID:
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+		case OIDOID:
+		case FLOAT4OID:
+		case FLOAT8OID:
+		case NUMERICOID:
+		case TEXTOID:
+		case VARCHAROID:
+		case BPCHAROID:
+		case NAMEOID:
+		case DATEOID:
+		case TIMEOID:
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * DocDB evaluates functions without locale data, so collation dependent functions are pushed
+ * down only if they would use the C locale anyway.
+ */
+static bool YBCIsSupportedDocDBCollation(Oid collid)
+{
+	return !OidIsValid(collid) || (lc_collate_is_c(collid) && lc_ctype_is_c(collid));
+}
+
+static bool YBCIsSupportedDocDBFilterFunction(Oid funcid, Oid inputcollid)
+{
+	HeapTuple tuple;
+	Form_pg_proc pg_proc;
+	bool result;
+
+	if (!YBCIsSupportedDocDBCollation(inputcollid))
+		return false;
+
+	tuple = SearchSysCache1(PROCOID, ObjectIdGetDatum(funcid));
+	if (!HeapTupleIsValid(tuple))
+		elog(ERROR, "cache lookup failed for function %u", funcid);
+	pg_proc = (Form_pg_proc) GETSTRUCT(tuple);
+
+	/* Only immutable functions, since DocDB cannot do lookups or access other rows. */
+	result = pg_proc->provolatile == PROVOLATILE_IMMUTABLE &&
+	         !pg_proc->proretset &&
+	         YBCIsSupportedDocDBFunctionId(funcid, pg_proc);
+	ReleaseSysCache(tuple);
+	return result;
+}
+
+/*
+ * Returns true (abort the walk) if the node cannot be evaluated by DocDB.
+ * Node types here should match the ones handled by the DocDB expression evaluator (ybgate).
+ */
+static bool YBCDocDBFilterExprWalker(Node *node, Index *relid)
+{
+	if (node == NULL)
+		return false;
+
+	switch (nodeTag(node))
+	{
+		case T_Const:
+			return false;
+		case T_Var:
+		{
+			/* Only regular columns of the scanned table are available to DocDB. */
+			Var *var = castNode(Var, node);
+			return var->varno != *relid ||
+			       var->varlevelsup != 0 ||
+			       var->varattno <= 0 ||
+			       !YBCIsSupportedDocDBFilterColumnType(var->vartype);
+		}
+		case T_List:
+		case T_RelabelType:
+		case T_BoolExpr:
+			break;
+		case T_NullTest:
+			if (castNode(NullTest, node)->argisrow)
+				return true;
+			break;
+		case T_OpExpr:
+		{
+			OpExpr *op_expr = castNode(OpExpr, node);
+			set_opfuncid(op_expr);
+			if (!YBCIsSupportedDocDBFilterFunction(op_expr->opfuncid, op_expr->inputcollid))
+				return true;
+			break;
+		}
+		case T_FuncExpr:
+		{
+			FuncExpr *func_expr = castNode(FuncExpr, node);
+			if (func_expr->funcvariadic ||
+			    !YBCIsSupportedDocDBFilterFunction(func_expr->funcid, func_expr->inputcollid))
+				return true;
+			break;
+		}
+		default:
+			/* Params, subplans, aggregates, etc. are evaluated by the query layer. */
+			return true;
+	}
+
+	return expression_tree_walker(node, YBCDocDBFilterExprWalker, (void *) relid);
+}
+
+/*
+ * Can the scan qual be evaluated in DocDB, so rows that do not satisfy it are not sent to the
+ * query layer. It should be a boolean expression of immutable built-in functions and operators
+ * whose only variables are columns of the scanned relation.
+ */
+bool YBCIsSupportedDocDBFilterExpr(Expr *expr, Index relid)
+{
+	/* Expressions without variables are evaluated once by the query layer. */
+	if (!contain_var_clause((Node *) expr))
+		return false;
+
+	return !YBCDocDBFilterExprWalker((Node *) expr, &relid);
+}
+
 /*
  * Returns true if the following are all true:
  *  - is insert, update, or delete command.
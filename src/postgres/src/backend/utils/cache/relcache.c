@@ -4342,7 +4342,7 @@ RelationCacheInitializePhase3(void)
 	if (IsYugaByteEnabled())
 	{
 		YBCPgResetCatalogReadTime();
-		YBCGetMasterCatalogVersion(&yb_catalog_cache_version);
+		YBCGetStartupCatalogVersion(&yb_catalog_cache_version);
 	}
 
 	/*
@@ -6259,7 +6259,7 @@ load_relcache_init_file(bool shared)
 		/* Else, still need to check with the master version to be sure. */
 		YBCPgResetCatalogReadTime();
 		uint64_t catalog_master_version = 0;
-		YBCGetMasterCatalogVersion(&catalog_master_version);
+		YBCGetStartupCatalogVersion(&catalog_master_version);
 
 		/* File version does not match actual master version (i.e. too old) */
 		if (ybc_stored_cache_version != catalog_master_version)
@@ -1960,6 +1960,46 @@ static struct config_bool ConfigureNamesBool[] =
 		false,
 		NULL, NULL, NULL
 	},
+	{
+		{"yb_enable_expression_pushdown", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Push down supported WHERE conditions of table scans to DocDB, "
+						 "so rows that do not satisfy them are not sent to the query layer."),
+			NULL
+		},
+		&yb_enable_expression_pushdown,
+		false,
+		NULL, NULL, NULL
+	},
+	{
+		{"yb_enable_grouped_aggregate_pushdown", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Push down supported GROUP BY aggregates to DocDB, so each tablet "
+						 "returns partial aggregates per group instead of rows."),
+			NULL
+		},
+		&yb_enable_grouped_aggregate_pushdown,
+		false,
+		NULL, NULL, NULL
+	},
+	{
+		{"yb_use_tserver_catalog_version_on_startup", PGC_SIGHUP, CONN_AUTH_SETTINGS,
+			gettext_noop("Start new connections with the catalog version of the local "
+						 "tablet server instead of reading it from the master."),
+			NULL
+		},
+		&yb_use_tserver_catalog_version_on_startup,
+		false,
+		NULL, NULL, NULL
+	},
+	{
+		{"yb_enable_analyze_sampling", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Collect column statistics in ANALYZE from a sample "
+						 "of rows selected by DocDB."),
+			NULL
+		},
+		&yb_enable_analyze_sampling,
+		false,
+		NULL, NULL, NULL
+	},
 	{
 		{"yb_enable_geolocation_costing", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Allow the optimizer to cost and choose between duplicate indexes based on locality"),
@@ -3300,6 +3340,34 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"yb_large_scan_rows_threshold", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Scans estimated to return at least this number of rows"
+						 " do not fill the DocDB block cache."),
+			gettext_noop("Keeps large scans from evicting the cached blocks of"
+						 " frequently read rows. 0 disables it."),
+			0
+		},
+		&yb_large_scan_rows_threshold,
+		0, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"yb_follower_read_staleness_ms", PGC_USERSET, CLIENT_CONN_STATEMENT,
+			gettext_noop("Staleness of the reads of read-only transactions"
+						 " from followers."),
+			gettext_noop("When yb_read_from_followers is set, read-only"
+						 " transactions read the data as of this many"
+						 " milliseconds ago from the closest replica. 0 reads"
+						 " at the safe time of each replica."),
+			GUC_UNIT_MS
+		},
+		&yb_follower_read_staleness_ms,
+		0, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
 	/* End-of-list marker */
 	{
 		{NULL, 0, 0, NULL, NULL}, NULL, 0, 0, 0, NULL, NULL, NULL
@@ -80,6 +80,7 @@ int ybc_disable_pg_locking = -1;
 static void YBCInstallTxnDdlHook();
 
 bool yb_read_from_followers = false;
+int yb_follower_read_staleness_ms = 0;
 
 bool
 IsYugaByteEnabled()
@@ -811,7 +812,12 @@ PowerWithUpperLimit(double base, int exp, double upper_limit)
 // YB GUC variables.
 
 bool yb_enable_create_with_table_oid = false;
+bool yb_enable_expression_pushdown = false;
+bool yb_enable_grouped_aggregate_pushdown = false;
+bool yb_use_tserver_catalog_version_on_startup = false;
+bool yb_enable_analyze_sampling = false;
 int yb_index_state_flags_update_delay = 1000;
+int yb_large_scan_rows_threshold = 0;
 
 //------------------------------------------------------------------------------
 // YB Debug utils.
@@ -1249,6 +1255,14 @@ bool YBReadFromFollowersEnabled() {
   return yb_read_from_followers;
 }
 
+int YBFollowerReadStalenessMs() {
+  /*
+   * Only read-only transactions read in the past, the reads of a transaction that writes must
+   * see the latest data to detect conflicts.
+   */
+  return XactReadOnly ? yb_follower_read_staleness_ms : 0;
+}
+
 YBCPgYBTupleIdDescriptor* YBCCreateYBTupleIdDescriptor(Oid db_oid, Oid table_oid, int nattrs) {
 	void* mem = palloc(sizeof(YBCPgYBTupleIdDescriptor) + nattrs * sizeof(YBCPgAttrValueDescriptor));
 	YBCPgYBTupleIdDescriptor* result = mem;
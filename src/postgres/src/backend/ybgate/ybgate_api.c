@@ -18,6 +18,7 @@
 
 #include "ybgate/ybgate_api.h"
 
+#include "catalog/pg_collation.h"
 #include "catalog/pg_type.h"
 #include "catalog/pg_type_d.h"
 #include "catalog/ybctype.h"
@@ -108,6 +109,7 @@ static Datum evalExpr(YbgExprContext ctx, Expr* expr, bool *is_null)
 		case T_OpExpr:
 		{
 			Oid          funcid = InvalidOid;
+			Oid          inputcollid = InvalidOid;
 			List         *args = NULL;
 			ListCell     *lc = NULL;
 
@@ -117,14 +119,23 @@ static Datum evalExpr(YbgExprContext ctx, Expr* expr, bool *is_null)
 				FuncExpr *func_expr = castNode(FuncExpr, expr);
 				args = func_expr->args;
 				funcid = func_expr->funcid;
+				inputcollid = func_expr->inputcollid;
 			}
 			else if (IsA(expr, OpExpr))
 			{
 				OpExpr *op_expr = castNode(OpExpr, expr);
 				args = op_expr->args;
 				funcid = op_expr->opfuncid;
+				inputcollid = op_expr->inputcollid;
 			}
 
+			/*
+			 * The planner pushes down collation dependent functions only when
+			 * they use the C locale, locale data is not available here.
+			 */
+			if (OidIsValid(inputcollid))
+				inputcollid = C_COLLATION_OID;
+
 			FmgrInfo *flinfo = palloc0(sizeof(FmgrInfo));
 			FunctionCallInfoData fcinfo;
 
@@ -132,7 +143,7 @@ static Datum evalExpr(YbgExprContext ctx, Expr* expr, bool *is_null)
 			InitFunctionCallInfoData(fcinfo,
 			                         flinfo,
 			                         args->length,
-			                         InvalidOid,
+			                         inputcollid,
 			                         NULL,
 			                         NULL);
 			int i = 0;
@@ -159,6 +170,43 @@ static Datum evalExpr(YbgExprContext ctx, Expr* expr, bool *is_null)
 			RelabelType *rt = castNode(RelabelType, expr);
 			return evalExpr(ctx, rt->arg, is_null);
 		}
+		case T_BoolExpr:
+		{
+			/* Three-valued logic, the same as ExecEvalBoolExpr. */
+			BoolExpr *bool_expr = castNode(BoolExpr, expr);
+			ListCell *lc = NULL;
+			bool     any_null = false;
+
+			if (bool_expr->boolop == NOT_EXPR)
+			{
+				Datum arg = evalExpr(ctx, linitial(bool_expr->args), is_null);
+				return *is_null ? (Datum) 0 : BoolGetDatum(!DatumGetBool(arg));
+			}
+
+			foreach(lc, bool_expr->args)
+			{
+				bool arg_is_null = false;
+				bool arg = DatumGetBool(evalExpr(ctx, (Expr *) lfirst(lc), &arg_is_null));
+				if (arg_is_null)
+					any_null = true;
+				else if (arg == (bool_expr->boolop == OR_EXPR))
+				{
+					/* Result is decided by this argument: true for OR, false for AND. */
+					*is_null = false;
+					return BoolGetDatum(arg);
+				}
+			}
+			*is_null = any_null;
+			return BoolGetDatum(bool_expr->boolop == AND_EXPR);
+		}
+		case T_NullTest:
+		{
+			NullTest *null_test = castNode(NullTest, expr);
+			bool     arg_is_null = false;
+			evalExpr(ctx, null_test->arg, &arg_is_null);
+			*is_null = false;
+			return BoolGetDatum(null_test->nulltesttype == IS_NULL ? arg_is_null : !arg_is_null);
+		}
 		case T_Const:
 		{
 			Const* const_expr = castNode(Const, expr);
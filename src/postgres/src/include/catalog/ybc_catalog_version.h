@@ -41,6 +41,12 @@ extern void YBCGetMasterCatalogVersion(uint64_t *version);
 /* The catalog version caches by the local tserver. */
 extern bool YBCGetLocalTserverCatalogVersion(uint64_t *version);
 
+/*
+ * The catalog version a new backend validates its relcache init files against
+ * and starts with. See yb_use_tserver_catalog_version_on_startup.
+ */
+extern void YBCGetStartupCatalogVersion(uint64_t *version);
+
 /* Send a request to increment the master catalog version. */
 extern bool YBCIncrementMasterCatalogVersionTableEntry(bool is_breaking_change);
 
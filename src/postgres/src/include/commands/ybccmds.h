@@ -87,4 +87,7 @@ extern void YBCRename(RenameStmt* stmt, Oid relationId);
 
 extern int32_t YBCAnalyzeTable(Relation rel);
 
+extern int YBCAcquireSampleRows(Relation rel, HeapTuple *rows, int targrows,
+								double *totalrows, double *totaldeadrows);
+
 #endif
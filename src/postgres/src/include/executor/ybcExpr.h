@@ -60,4 +60,11 @@ YBCPgExpr YBCNewEvalExprCall(YBCPgStatement ybc_stmt,
                              YBExprParamDesc *params,
                              int num_params);
 
+// Construct a boolean eval_expr call, used to filter rows in DocDB, for a PG Expr that references
+// the columns described by params.
+YBCPgExpr YBCNewEvalBoolExprCall(YBCPgStatement ybc_stmt,
+                                 Expr *pg_expr,
+                                 YBExprParamDesc *params,
+                                 int num_params);
+
 #endif							/* YBCEXPR_H */
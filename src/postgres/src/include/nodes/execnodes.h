@@ -1682,6 +1682,7 @@ typedef struct ForeignScanState
 
 	/* YB specific attributes. */
 	List	   *yb_fdw_aggs;	/* aggregate pushdown information */
+	List	   *yb_fdw_group_cols;	/* Vars that pushed down aggregates are grouped by */
 } ForeignScanState;
 
 /* ----------------
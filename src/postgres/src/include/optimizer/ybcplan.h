@@ -37,6 +37,8 @@ bool YBCIsSupportedSingleRowModifyAssignExpr(Expr *expr,
                                              AttrNumber target_attno,
                                              bool *needs_pushdown);
 
+bool YBCIsSupportedDocDBFilterExpr(Expr *expr, Index relid);
+
 bool YBCIsSingleRowModify(PlannedStmt *pstmt);
 
 bool YBCIsSingleRowUpdateOrDelete(ModifyTable *modifyTable);
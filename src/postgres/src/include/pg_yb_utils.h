@@ -84,6 +84,12 @@ extern bool IsYugaByteEnabled();
 
 extern bool yb_read_from_followers;
 
+/*
+ * When greater than 0, follower reads of read-only transactions are done at the time this many
+ * milliseconds ago, so they see a consistent snapshot across tablets.
+ */
+extern int yb_follower_read_staleness_ms;
+
 /*
  * Iterate over databases and execute a given code snippet.
  * Should terminate with YB_FOR_EACH_DB_END.
@@ -362,6 +368,25 @@ extern double PowerWithUpperLimit(double base, int exponent, double upper_limit)
 /* Enables tables/indexes to be created WITH (table_oid = x). */
 extern bool yb_enable_create_with_table_oid;
 
+/* Enables evaluation of supported scan quals by DocDB, see YBCIsSupportedDocDBFilterExpr. */
+extern bool yb_enable_expression_pushdown;
+
+/* Enables pushdown of hashed GROUP BY aggregation, DocDB returns partial aggregates per group. */
+extern bool yb_enable_grouped_aggregate_pushdown;
+
+/*
+ * Start new backends with the catalog version published by the local tserver
+ * instead of reading it from the master, so that a burst of new connections
+ * does not send a master read per connection.
+ */
+extern bool yb_use_tserver_catalog_version_on_startup;
+
+/*
+ * Collect column statistics in ANALYZE from a random sample of rows selected
+ * by DocDB, instead of only counting the table rows.
+ */
+extern bool yb_enable_analyze_sampling;
+
 /*
  * During CREATE INDEX, the delay between stages, from
  * - indislive=true to indisready=true
@@ -369,6 +394,12 @@ extern bool yb_enable_create_with_table_oid;
  */
 extern int yb_index_state_flags_update_delay;
 
+/*
+ * Scans estimated to return at least this number of rows do not add the
+ * blocks they read to the DocDB block cache. 0 disables it.
+ */
+extern int yb_large_scan_rows_threshold;
+
 //------------------------------------------------------------------------------
 // YB Debug utils.
 
@@ -436,6 +467,7 @@ extern void YBEndOperationsBuffering();
 extern void YBResetOperationsBuffering();
 
 bool YBReadFromFollowersEnabled();
+int YBFollowerReadStalenessMs();
 
 /*
  * Allocates YBCPgYBTupleIdDescriptor with nattrs arguments by using palloc.
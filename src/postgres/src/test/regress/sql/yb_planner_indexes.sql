@@ -26,6 +26,10 @@ EXPLAIN SELECT * FROM t1 WHERE h = 1 and r = 2 and v1 = 1 and v2 = 2;
 -- Should prioritize the t1_v1_v2_idx because it is fully specified.
 EXPLAIN SELECT * FROM t1 WHERE h = 1 and v1 = 1 and v2 = 2;
 
+-- Should use t1_v1_v2_idx without fetching the rows from t1 (index only scan), so no cost is
+-- charged for reading t1.
+EXPLAIN SELECT v1, v2 FROM t1 WHERE v1 = 1 and v2 = 2;
+
 --------------------------------------
 -- Test partial indexes.
 
@@ -32,6 +32,7 @@
 #include "yb/util/debug-util.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/object_pool.h"
 #include "yb/util/yb_pg_errcodes.h"
 
 // TODO: do we need word Redis in following two metrics? ReadRpc and WriteRpc objects emitting
@@ -84,8 +85,28 @@ DEFINE_bool(detect_duplicates_for_retryable_requests, true,
 DEFINE_bool(ysql_forward_rpcs_to_local_tserver, false,
             "When true, forward the PGSQL rpcs to the local tServer.");
 
+DEFINE_bool(ybclient_accept_compressed_read_sidecars, false,
+            "Allow tablet servers to compress row data of read responses, see "
+            "rpc_sidecars_compression_min_size.");
+TAG_FLAG(ybclient_accept_compressed_read_sidecars, advanced);
+TAG_FLAG(ybclient_accept_compressed_read_sidecars, runtime);
+
+
+DEFINE_bool(ybclient_coalesce_writes_per_tserver, false,
+            "Send writes of a batch to different tablets hosted by the same tablet server in a "
+            "single WriteMulti RPC.");
+TAG_FLAG(ybclient_coalesce_writes_per_tserver, advanced);
+TAG_FLAG(ybclient_coalesce_writes_per_tserver, runtime);
+
+DEFINE_bool(ybclient_recycle_write_batch_buffers, false,
+            "Build write RPCs in recycled request buffers, so that batching operations and parsing "
+            "their responses reuse per operation protobufs of earlier writes instead of "
+            "allocating them.");
+TAG_FLAG(ybclient_recycle_write_batch_buffers, advanced);
+TAG_FLAG(ybclient_recycle_write_batch_buffers, runtime);
 
 DEFINE_CAPABILITY(PickReadTimeAtTabletServer, 0x8284d67b);
+DEFINE_CAPABILITY(WriteMulti, 0x6f0a3c51);
 
 using namespace std::placeholders;
 
@@ -400,8 +421,53 @@ void AsyncRpcBase<Req, Resp>::SendRpcToTserver(int attempt_num) {
   AsyncRpc::SendRpcToTserver(attempt_num);
 }
 
+// Per operation parts of a finished write request and response. Cleared repeated protobuf fields
+// keep their elements, so the next write adds operations to them and parses responses into them
+// without allocation.
+struct WriteRpcBuffers {
+  google::protobuf::RepeatedPtrField<RedisWriteRequestPB> redis_write_batch;
+  google::protobuf::RepeatedPtrField<QLWriteRequestPB> ql_write_batch;
+  google::protobuf::RepeatedPtrField<PgsqlWriteRequestPB> pgsql_write_batch;
+  google::protobuf::RepeatedPtrField<RedisResponsePB> redis_response_batch;
+  google::protobuf::RepeatedPtrField<QLResponsePB> ql_response_batch;
+  google::protobuf::RepeatedPtrField<PgsqlResponsePB> pgsql_response_batch;
+
+  // Exchanges the buffers with the batches of the request and response.
+  void Swap(tserver::WriteRequestPB* req, tserver::WriteResponsePB* resp) {
+    req->mutable_redis_write_batch()->Swap(&redis_write_batch);
+    req->mutable_ql_write_batch()->Swap(&ql_write_batch);
+    req->mutable_pgsql_write_batch()->Swap(&pgsql_write_batch);
+    resp->mutable_redis_response_batch()->Swap(&redis_response_batch);
+    resp->mutable_ql_response_batch()->Swap(&ql_response_batch);
+    resp->mutable_pgsql_response_batch()->Swap(&pgsql_response_batch);
+  }
+
+  void Clear() {
+    redis_write_batch.Clear();
+    ql_write_batch.Clear();
+    pgsql_write_batch.Clear();
+    redis_response_batch.Clear();
+    ql_response_batch.Clear();
+    pgsql_response_batch.Clear();
+  }
+};
+
+namespace {
+
+ThreadSafeObjectPool<WriteRpcBuffers>& WriteRpcBuffersPool() {
+  static ThreadSafeObjectPool<WriteRpcBuffers> pool;
+  return pool;
+}
+
+} // namespace
+
 WriteRpc::WriteRpc(AsyncRpcData* data)
-    : AsyncRpcBase(data, YBConsistencyLevel::STRONG) {
+    : AsyncRpcBase(data, YBConsistencyLevel::STRONG), coalescer_(data->write_coalescer) {
+
+  if (FLAGS_ybclient_recycle_write_batch_buffers) {
+    buffers_ = WriteRpcBuffersPool().Take();
+    buffers_->Swap(&req_, &resp_);
+  }
 
   TRACE_TO(trace_, "WriteRpc initiated");
   VTRACE_TO(1, trace_, "Tablet $0 table $1", data->tablet->tablet_id(), table()->name().ToString());
@@ -484,9 +550,30 @@ WriteRpc::~WriteRpc() {
                                               async_rpc_metrics_->remote_write_rpc_time;
     write_rpc_time->Increment(ToMicroseconds(end_time - start_));
   }
+
+  if (buffers_) {
+    // Operation requests and responses are swapped back to operations by now, so the batches
+    // hold only their cleared former contents.
+    buffers_->Swap(&req_, &resp_);
+    buffers_->Clear();
+    WriteRpcBuffersPool().Release(buffers_);
+  }
 }
 
 void WriteRpc::CallRemoteMethod() {
+  multi_batch_.reset();
+  // Only the first attempt is coalesced, retries are sent directly.
+  auto coalescer = std::move(coalescer_);
+  if (coalescer && !tablet_invoker_.IsLocalCall() &&
+      !tablet_invoker_.should_use_local_node_proxy() &&
+      coalescer->Add(this, &tablet_invoker_.current_ts())) {
+    TRACE_TO(trace_, "Write added to coalescer");
+    return;
+  }
+  SendWrite();
+}
+
+void WriteRpc::SendWrite() {
   auto trace = trace_; // It is possible that we receive reply before returning from WriteAsync.
                        // Since send happens before we return from WriteAsync.
                        // So under heavy load it is possible that our request is handled and
@@ -566,8 +653,7 @@ void WriteRpc::SwapRequestsAndResponses(bool skip_responses = false) {
         ql_op->mutable_response()->Swap(resp_.mutable_ql_response_batch(ql_idx));
         const auto& ql_response = ql_op->response();
         if (ql_response.has_rows_data_sidecar()) {
-          Slice rows_data = CHECK_RESULT(
-              retrier().controller().GetSidecar(ql_response.rows_data_sidecar()));
+          Slice rows_data = CHECK_RESULT(GetSidecar(ql_response.rows_data_sidecar()));
           ql_op->mutable_rows_data()->assign(rows_data.cdata(), rows_data.size());
         }
         ql_idx++;
@@ -583,8 +669,7 @@ void WriteRpc::SwapRequestsAndResponses(bool skip_responses = false) {
         pgsql_op->mutable_response()->Swap(resp_.mutable_pgsql_response_batch(pgsql_idx));
         const auto& pgsql_response = pgsql_op->response();
         if (pgsql_response.has_rows_data_sidecar()) {
-          Slice rows_data = CHECK_RESULT(retrier().controller().GetSidecar(
-              pgsql_response.rows_data_sidecar()));
+          Slice rows_data = CHECK_RESULT(GetSidecar(pgsql_response.rows_data_sidecar()));
           down_cast<YBPgsqlWriteOp*>(yb_op)->mutable_rows_data()->assign(
               util::to_char_ptr(rows_data.data()), rows_data.size());
         }
@@ -635,10 +720,106 @@ bool WriteRpc::ShouldRetryExpiredRequest() {
   return req_.min_running_request_id() == kInitializeFromMinRunning;
 }
 
+// Writes sent to the same tablet server in one WriteMulti RPC.
+class WriteRpc::MultiBatch : public std::enable_shared_from_this<MultiBatch> {
+ public:
+  explicit MultiBatch(std::vector<WriteRpc*> rpcs) : rpcs_(std::move(rpcs)) {}
+
+  void Send(const RemoteTabletServer& ts) {
+    auto deadline = CoarseTimePoint::max();
+    for (auto* rpc : rpcs_) {
+      req_.add_requests()->Swap(&rpc->req_);
+      deadline = std::min(deadline, rpc->deadline());
+    }
+    controller_.set_deadline(deadline);
+    auto self = shared_from_this();
+    ts.proxy()->WriteMultiAsync(req_, &resp_, &controller_, [self] {
+      self->Done();
+    });
+  }
+
+  const rpc::RpcController& controller() const {
+    return controller_;
+  }
+
+ private:
+  void Done() {
+    const auto status = controller_.status();
+    if (!status.ok()) {
+      VLOG(1) << "WriteMulti with " << rpcs_.size() << " writes failed: " << status;
+    }
+    for (size_t i = 0; i != rpcs_.size(); ++i) {
+      auto* rpc = rpcs_[i];
+      rpc->req_.Swap(req_.mutable_requests(i));
+      if (!status.ok() || i >= static_cast<size_t>(resp_.responses_size())) {
+        // Let each write handle the failure using its own RPC, so the regular retry logic applies.
+        rpc->SendWrite();
+        continue;
+      }
+      rpc->resp_.Swap(resp_.mutable_responses(i));
+      rpc->multi_batch_ = shared_from_this();
+      rpc->Finished(Status::OK());
+    }
+  }
+
+  std::vector<WriteRpc*> rpcs_;
+  tserver::WriteMultiRequestPB req_;
+  tserver::WriteMultiResponsePB resp_;
+  rpc::RpcController controller_;
+};
+
+Result<Slice> WriteRpc::GetSidecar(int idx) const {
+  if (multi_batch_) {
+    return multi_batch_->controller().GetSidecar(idx);
+  }
+  return retrier().controller().GetSidecar(idx);
+}
+
+bool WriteRpcCoalescer::Add(WriteRpc* rpc, const RemoteTabletServer* ts) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (flushed_) {
+    return false;
+  }
+  rpcs_.emplace_back(ts, rpc);
+  return true;
+}
+
+void WriteRpcCoalescer::Flush() {
+  decltype(rpcs_) rpcs;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flushed_ = true;
+    rpcs.swap(rpcs_);
+  }
+  std::stable_sort(rpcs.begin(), rpcs.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first < rhs.first;
+  });
+  for (auto it = rpcs.begin(); it != rpcs.end();) {
+    const auto* ts = it->first;
+    auto group_end = std::find_if(it, rpcs.end(), [ts](const auto& entry) {
+      return entry.first != ts;
+    });
+    if (group_end - it == 1 || !ts->HasCapability(CAPABILITY_WriteMulti)) {
+      for (; it != group_end; ++it) {
+        it->second->SendWrite();
+      }
+      continue;
+    }
+    std::vector<WriteRpc*> group;
+    group.reserve(group_end - it);
+    for (; it != group_end; ++it) {
+      group.push_back(it->second);
+    }
+    std::make_shared<WriteRpc::MultiBatch>(std::move(group))->Send(*ts);
+  }
+}
+
 ReadRpc::ReadRpc(AsyncRpcData* data, YBConsistencyLevel yb_consistency_level)
     : AsyncRpcBase(data, yb_consistency_level) {
 
   TRACE_TO(trace_, "ReadRpc initiated");
+  mutable_retrier()->mutable_controller()->set_accept_compressed_sidecars(
+      FLAGS_ybclient_accept_compressed_read_sidecars);
   VTRACE_TO(1, trace_, "Tablet $0 table $1", data->tablet->tablet_id(), table()->name().ToString());
   req_.set_consistency_level(yb_consistency_level);
   req_.set_proxy_uuid(data->batcher->proxy_uuid());
@@ -712,8 +893,15 @@ void ReadRpc::CallRemoteMethod() {
   TRACE_TO(trace, "SendRpcToTserver");
   ADOPT_TRACE(trace.get());
 
-  tablet_invoker_.ReadAsync(req_, &resp_, PrepareController(),
-                            std::bind(&ReadRpc::Finished, this, Status::OK()));
+  auto* ts = tablet_invoker_.current_ts_ptr();
+  tablet_invoker_.ReadAsync(
+      req_, &resp_, PrepareController(), [this, ts, send_time = MonoTime::Now()] {
+    // Only successful calls are sampled, failed replicas are handled by the invoker.
+    if (retrier().controller().status().ok() && !resp_.has_error()) {
+      ts->RecordResponseTime(MonoTime::Now() - send_time);
+    }
+    Finished(Status::OK());
+  });
   TRACE_TO(trace, "RpcDispatched Asynchronously");
 }
 
@@ -14,6 +14,8 @@
 #ifndef YB_CLIENT_ASYNC_RPC_H_
 #define YB_CLIENT_ASYNC_RPC_H_
 
+#include <mutex>
+
 #include "yb/client/tablet_rpc.h"
 
 #include "yb/common/read_hybrid_time.h"
@@ -34,6 +36,7 @@ class Batcher;
 struct InFlightOp;
 class RemoteTablet;
 class RemoteTabletServer;
+class WriteRpcCoalescer;
 
 // Container for async rpc metrics
 struct AsyncRpcMetrics {
@@ -56,8 +59,13 @@ struct AsyncRpcData {
   HybridTime write_time_for_backfill_ = HybridTime::kInvalid;
   InFlightOps ops;
   bool need_metadata = false;
+  // When specified, the first attempt of a write is sent together with other writes to the same
+  // tablet server.
+  std::shared_ptr<WriteRpcCoalescer> write_coalescer;
 };
 
+struct WriteRpcBuffers;
+
 struct FlushExtraResult {
   // Latest hybrid time that was present on tserver during processing of this request.
   HybridTime propagated_hybrid_time;
@@ -164,10 +172,44 @@ class WriteRpc : public AsyncRpcBase<tserver::WriteRequestPB, tserver::WriteResp
   virtual ~WriteRpc();
 
  private:
+  friend class WriteRpcCoalescer;
+  class MultiBatch;
+
   void SwapRequestsAndResponses(bool skip_responses);
   void CallRemoteMethod() override;
   void ProcessResponseFromTserver(const Status& status) override;
   bool ShouldRetryExpiredRequest() override;
+
+  // Sends this write in its own Write RPC.
+  void SendWrite();
+
+  Result<Slice> GetSidecar(int idx) const;
+
+  std::shared_ptr<WriteRpcCoalescer> coalescer_;
+
+  // WriteMulti call that delivered the current response, its controller holds the sidecars.
+  std::shared_ptr<MultiBatch> multi_batch_;
+
+  // Recycled batches the request and response are built in, see
+  // ybclient_recycle_write_batch_buffers.
+  WriteRpcBuffers* buffers_ = nullptr;
+};
+
+// Collects writes that are sent by a batcher at the same moment and sends writes addressed to the
+// same tablet server in a single WriteMulti RPC, see ybclient_coalesce_writes_per_tserver.
+// Each write is retried separately, if its first attempt fails.
+class WriteRpcCoalescer {
+ public:
+  // Returns false if the coalescer was already flushed, so the write should be sent directly.
+  bool Add(WriteRpc* rpc, const RemoteTabletServer* ts);
+
+  // Sends writes collected so far, writes added later are not coalesced.
+  void Flush();
+
+ private:
+  std::mutex mutex_;
+  bool flushed_ = false;
+  std::vector<std::pair<const RemoteTabletServer*, WriteRpc*>> rpcs_;
 };
 
 class ReadRpc : public AsyncRpcBase<tserver::ReadRequestPB, tserver::ReadResponsePB> {
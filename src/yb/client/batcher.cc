@@ -76,6 +76,8 @@ DEFINE_test_flag(double, simulate_tablet_lookup_does_not_match_partition_key_pro
                  "Probability for simulating the error that happens when a key is not in the key "
                  "range of the resolved tablet's partition.");
 
+DECLARE_bool(ybclient_coalesce_writes_per_tserver);
+
 using std::pair;
 using std::set;
 using std::unique_ptr;
@@ -673,12 +675,18 @@ void Batcher::ExecuteOperations(Initial initial) {
   // Consistent read is not required when whole batch fits into one command.
   const auto need_consistent_read = force_consistent_read || ops_info_.groups.size() > 1;
 
+  std::shared_ptr<WriteRpcCoalescer> write_coalescer;
+  if (FLAGS_ybclient_coalesce_writes_per_tserver && ops_info_.groups.size() > 1) {
+    write_coalescer = std::make_shared<WriteRpcCoalescer>();
+  }
+
   for (const auto& group : ops_info_.groups) {
     // Allow local calls for last group only.
     const auto allow_local_calls =
         allow_local_calls_in_curr_thread_ && (&group == &ops_info_.groups.back());
     rpcs.push_back(CreateRpc(
-        group.begin->get()->tablet.get(), group, allow_local_calls, need_consistent_read));
+        group.begin->get()->tablet.get(), group, allow_local_calls, need_consistent_read,
+        write_coalescer));
   }
 
   LOG_IF(DFATAL, ops_number != ops_queue_.size())
@@ -691,6 +699,11 @@ void Batcher::ExecuteOperations(Initial initial) {
     }
     rpc->SendRpc();
   }
+
+  // Writes whose tablet leaders are not known yet are added after the flush and sent directly.
+  if (write_coalescer) {
+    write_coalescer->Flush();
+  }
 }
 
 rpc::Messenger* Batcher::messenger() const {
@@ -724,7 +737,8 @@ void Batcher::RequestFinished(const TabletId& tablet_id, RetryableRequestId requ
 
 std::shared_ptr<AsyncRpc> Batcher::CreateRpc(
     RemoteTablet* tablet, const InFlightOpsGroup& group,
-    const bool allow_local_calls_in_curr_thread, const bool need_consistent_read) {
+    const bool allow_local_calls_in_curr_thread, const bool need_consistent_read,
+    const std::shared_ptr<WriteRpcCoalescer>& write_coalescer) {
   VLOG_WITH_PREFIX(3) << "FlushBuffersIfReady: already in flushing state, immediately flushing to "
                       << tablet->tablet_id();
 
@@ -746,7 +760,8 @@ std::shared_ptr<AsyncRpc> Batcher::CreateRpc(
     .need_consistent_read = need_consistent_read,
     .write_time_for_backfill_ = hybrid_time_for_write_,
     .ops = InFlightOps(group.begin, group.end),
-    .need_metadata = group.need_metadata
+    .need_metadata = group.need_metadata,
+    .write_coalescer = op_group == OpGroup::kWrite ? write_coalescer : nullptr,
   };
 
   switch (op_group) {
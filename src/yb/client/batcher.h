@@ -69,6 +69,7 @@ class Batcher;
 class ErrorCollector;
 class RemoteTablet;
 class AsyncRpc;
+class WriteRpcCoalescer;
 
 // Batcher state changes sequentially in the order listed below, with the exception that kAborted
 // could be reached from any state.
@@ -245,7 +246,8 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   void FlushBuffersIfReady();
   std::shared_ptr<AsyncRpc> CreateRpc(
       RemoteTablet* tablet, const InFlightOpsGroup& group,
-      bool allow_local_calls_in_curr_thread, bool need_consistent_read);
+      bool allow_local_calls_in_curr_thread, bool need_consistent_read,
+      const std::shared_ptr<WriteRpcCoalescer>& write_coalescer);
 
   // Calls/Schedules flush_callback_ and resets it to free resources.
   void RunCallback(const Status& s);
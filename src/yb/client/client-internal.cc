@@ -75,6 +75,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/flags.h"
 #include "yb/util/net/net_util.h"
+#include "yb/util/random_util.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/thread_restrictions.h"
 
@@ -88,6 +89,18 @@ DEFINE_test_flag(string, assert_tablet_server_select_is_in_zone, "",
                  "Verify that SelectTServer selected a talet server in the AZ specified by this "
                  "flag.");
 
+DEFINE_bool(ybclient_latency_aware_replica_selection, false,
+            "When no replica is on the local tablet server, choose the closest replica for "
+            "follower reads by measured response time instead of the placement information.");
+TAG_FLAG(ybclient_latency_aware_replica_selection, advanced);
+TAG_FLAG(ybclient_latency_aware_replica_selection, runtime);
+
+DEFINE_double(ybclient_replica_selection_explore_probability, 0.05,
+              "Probability of sending a follower read to a random replica, when replicas are "
+              "selected by response time, so estimations of other replicas are kept fresh.");
+TAG_FLAG(ybclient_replica_selection_explore_probability, advanced);
+TAG_FLAG(ybclient_replica_selection_explore_probability, runtime);
+
 DECLARE_string(flagfile);
 
 namespace yb {
@@ -391,6 +404,11 @@ RemoteTabletServer* YBClient::Data::SelectTServer(RemoteTablet* rt,
           }
         }
 
+        if (FLAGS_ybclient_latency_aware_replica_selection && !filtered.empty() &&
+            (ret == nullptr || !IsTabletServerLocal(*ret))) {
+          ret = SelectReplicaByResponseTime(filtered, ret);
+        }
+
         // If ret is not null here, it should point to the closest replica from the client.
 
         // Fallback to a random replica if none are local.
@@ -426,6 +444,31 @@ RemoteTabletServer* YBClient::Data::SelectTServer(RemoteTablet* rt,
   return ret;
 }
 
+RemoteTabletServer* YBClient::Data::SelectReplicaByResponseTime(
+    const std::vector<RemoteTabletServer*>& candidates, RemoteTabletServer* closest_by_placement) {
+  if (RandomActWithProbability(FLAGS_ybclient_replica_selection_explore_probability)) {
+    return RandomElement(candidates);
+  }
+  RemoteTabletServer* result = nullptr;
+  MonoDelta best_response_time;
+  for (auto* candidate : candidates) {
+    auto response_time = candidate->ExpectedResponseTime();
+    if (!response_time) {
+      // Replicas without samples are tried first, preferring the closest one by placement.
+      if (candidate == closest_by_placement || !result || best_response_time.Initialized()) {
+        result = candidate;
+        best_response_time = MonoDelta();
+      }
+      continue;
+    }
+    if (!result || (best_response_time.Initialized() && *response_time < best_response_time)) {
+      result = candidate;
+      best_response_time = *response_time;
+    }
+  }
+  return result;
+}
+
 Status YBClient::Data::GetTabletServer(YBClient* client,
                                        const scoped_refptr<RemoteTablet>& rt,
                                        ReplicaSelection selection,
@@ -308,6 +308,12 @@ class YBClient::Data {
       const std::set<std::string>& blacklist,
       std::vector<internal::RemoteTabletServer*>* candidates);
 
+  // Returns the candidate with the lowest expected response time, see
+  // ybclient_latency_aware_replica_selection.
+  internal::RemoteTabletServer* SelectReplicaByResponseTime(
+      const std::vector<internal::RemoteTabletServer*>& candidates,
+      internal::RemoteTabletServer* closest_by_placement);
+
   // Sets 'master_proxy_' from the address specified by
   // 'leader_master_hostport_'.  Called by
   // GetLeaderMasterRpc::Finished() upon successful completion.
@@ -503,6 +509,14 @@ Status RetryFunc(
     const std::function<Status(CoarseTimePoint, bool*)>& func,
     const CoarseDuration max_wait = std::chrono::seconds(2));
 
+namespace internal {
+
+// Fills the table info from a master GetTableSchema response.
+CHECKED_STATUS CreateTableInfoFromTableSchemaResp(
+    const master::GetTableSchemaResponsePB& resp, YBTableInfo* info);
+
+} // namespace internal
+
 } // namespace client
 } // namespace yb
 
@@ -115,6 +115,10 @@ DEFINE_int32(test_scan_num_rows, 1000, "Number of rows to insert and scan");
 DECLARE_int32(min_backoff_ms_exponent);
 DECLARE_int32(max_backoff_ms_exponent);
 DECLARE_bool(TEST_force_master_lookup_all_tablets);
+DECLARE_bool(meta_cache_lock_free_lookups);
+DECLARE_bool(ybclient_coalesce_writes_per_tserver);
+DECLARE_bool(ybclient_recycle_write_batch_buffers);
+DECLARE_double(ybclient_replica_selection_explore_probability);
 DECLARE_double(TEST_simulate_lookup_timeout_probability);
 
 METRIC_DECLARE_counter(rpcs_queue_overflow);
@@ -1173,6 +1177,131 @@ TEST_F(ClientTest, TestMultipleMultiRowManualBatches) {
   ASSERT_EQ("{ int32:0, int32:0, string:\"hello world\", null }", rows[0]);
 }
 
+// Writes to tablets hosted by the same tablet server are sent in a single WriteMulti RPC.
+TEST_F(ClientTest, CoalescedWritesPerTserver) {
+  FLAGS_ybclient_coalesce_writes_per_tserver = true;
+  constexpr int kNumRows = 100;
+
+  // The first flush also looks up tablets, the second one writes with known leaders.
+  ASSERT_NO_FATALS(InsertTestRows(client_table_, kNumRows));
+  ASSERT_NO_FATALS(InsertTestRows(client_table_, kNumRows, kNumRows));
+  ASSERT_NO_FATALS(UpdateTestRows(client_table_, 0, kNumRows * 2));
+
+  ASSERT_EQ(kNumRows * 2, CountRowsFromClient(client_table_));
+  auto rows = ScanTableToStrings(client_table_);
+  ASSERT_EQ(kNumRows * 2, rows.size());
+}
+
+TEST_F(ClientTest, RecycleWriteBatchBuffers) {
+  FLAGS_ybclient_recycle_write_batch_buffers = true;
+  constexpr int kNumRows = 100;
+
+  // Later flushes build their requests in buffers recycled from earlier ones.
+  for (int i = 0; i != 3; ++i) {
+    ASSERT_NO_FATALS(InsertTestRows(client_table_, kNumRows, kNumRows * i));
+  }
+  ASSERT_NO_FATALS(UpdateTestRows(client_table_, 0, kNumRows));
+  ASSERT_NO_FATALS(DeleteTestRows(client_table_, kNumRows * 2, kNumRows * 3));
+
+  // Requests are swapped back to operations once their writes complete.
+  auto session = CreateSession();
+  auto op = BuildTestRow(client_table_, kNumRows * 3);
+  const auto request = op->request().ShortDebugString();
+  ASSERT_OK(session->ApplyAndFlush(op));
+  ASSERT_EQ(request, op->request().ShortDebugString());
+  ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
+
+  ASSERT_EQ(kNumRows * 2 + 1, CountRowsFromClient(client_table_));
+  auto rows = ScanTableToStrings(client_table_);
+  ASSERT_EQ(kNumRows * 2 + 1, rows.size());
+  ASSERT_EQ(kNumRows, std::count_if(rows.begin(), rows.end(), [](const std::string& row) {
+    return row.find("hello again") != std::string::npos;
+  }));
+}
+
+TEST_F(ClientTest, AutoFlush) {
+  constexpr int kNumRows = 500;
+  auto session = CreateSession();
+  AutoFlushOptions options;
+  options.max_buffer_bytes = 2048;
+  options.min_buffer_bytes = 512;
+  options.target_batch_latency = 1s;
+  session->SetAutoFlush(options);
+
+  int max_buffered = 0;
+  for (int i = 0; i != kNumRows; ++i) {
+    ASSERT_OK(session->Apply(BuildTestRow(client_table_, i)));
+    max_buffered = std::max(max_buffered, session->GetAddedNotFlushedOperationsCount());
+  }
+  // Rows are flushed when their size reaches the threshold, without explicit flush.
+  ASSERT_LT(max_buffered, kNumRows / 4);
+  ASSERT_OK(session->Flush());
+  ASSERT_FALSE(session->TEST_HasPendingOperations());
+  ASSERT_EQ(kNumRows, CountRowsFromClient(client_table_));
+
+  // Zero delay flushes every applied operation.
+  options.max_buffer_delay = MonoDelta::kZero;
+  session->SetAutoFlush(options);
+  ASSERT_OK(session->Apply(BuildTestRow(client_table_, kNumRows)));
+  ASSERT_EQ(session->GetAddedNotFlushedOperationsCount(), 0);
+  ASSERT_OK(session->Flush());
+  ASSERT_EQ(kNumRows + 1, CountRowsFromClient(client_table_));
+}
+
+TEST_F(ClientTest, AsyncFutures) {
+  constexpr int kNumSessions = 10;
+  constexpr int kRowsPerSession = 10;
+
+  // All flushes are in flight at the same time, and results are collected without a thread per
+  // session.
+  std::vector<YBSessionPtr> sessions;
+  std::vector<AsyncFuture<Status>> futures;
+  for (int i = 0; i != kNumSessions; ++i) {
+    sessions.push_back(CreateSession());
+    for (int j = 0; j != kRowsPerSession; ++j) {
+      ASSERT_OK(sessions.back()->Apply(BuildTestRow(client_table_, i * kRowsPerSession + j)));
+    }
+    futures.push_back(sessions.back()->FlushAsyncFuture().Map([](FlushStatus flush_status) {
+      return flush_status.status;
+    }));
+  }
+  for (const auto& status : WhenAll(std::move(futures)).Get()) {
+    ASSERT_OK(status);
+  }
+  ASSERT_EQ(kNumSessions * kRowsPerSession, CountRowsFromClient(client_table_));
+
+  auto tablets = ASSERT_RESULT(client_->LookupAllTabletsAsyncFuture(
+      client_table_.table(), CoarseMonoClock::now() + 10s).Get());
+  ASSERT_EQ(tablets.size(), static_cast<size_t>(kNumTablets));
+}
+
+TEST_F(ClientTest, SelectReplicaByResponseTime) {
+  FLAGS_ybclient_replica_selection_explore_probability = 0;
+  internal::RemoteTabletServer fast("fast", nullptr);
+  internal::RemoteTabletServer slow("slow", nullptr);
+  internal::RemoteTabletServer unknown("unknown", nullptr);
+  std::vector<internal::RemoteTabletServer*> candidates = {&slow, &fast};
+
+  ASSERT_FALSE(fast.ExpectedResponseTime());
+  for (int i = 0; i != 10; ++i) {
+    fast.RecordResponseTime(1ms);
+    slow.RecordResponseTime(10ms);
+  }
+  ASSERT_LT(*fast.ExpectedResponseTime(), *slow.ExpectedResponseTime());
+  ASSERT_EQ(client_->data_->SelectReplicaByResponseTime(candidates, &slow), &fast);
+
+  // Replicas without samples are probed first.
+  candidates.push_back(&unknown);
+  ASSERT_EQ(client_->data_->SelectReplicaByResponseTime(candidates, &slow), &unknown);
+
+  // Estimation follows changes of response time.
+  for (int i = 0; i != 50; ++i) {
+    fast.RecordResponseTime(20ms);
+  }
+  candidates.pop_back();
+  ASSERT_EQ(client_->data_->SelectReplicaByResponseTime(candidates, &fast), &slow);
+}
+
 // Test a batch where one of the inserted rows succeeds and duplicates succeed too.
 TEST_F(ClientTest, TestBatchWithDuplicates) {
   auto session = CreateSession();
@@ -2552,6 +2681,43 @@ TEST_F(ClientTest, RefreshPartitions) {
   LOG(INFO) << "num_lookups_done: " << num_lookups_done;
 }
 
+// Cached tablets should be found through the lock-free snapshot without new master lookups, and
+// the snapshot should not be used after table partitions were invalidated.
+TEST_F(ClientTest, LockFreeMetaCacheLookups) {
+  const auto kLookupTimeout = 10s;
+  FLAGS_meta_cache_lock_free_lookups = true;
+
+  auto client = ASSERT_RESULT(YBClientBuilder()
+      .add_master_server_addr(yb::ToString(cluster_->mini_master()->bound_rpc_addr()))
+      .Build());
+  auto table = ASSERT_RESULT(client->OpenTable(kTableName));
+
+  const auto partition_keys = table->GetPartitionsCopy();
+  ASSERT_EQ(partition_keys.size(), kNumTablets);
+
+  auto lookup_all = [&]() -> Result<std::vector<internal::RemoteTabletPtr>> {
+    std::vector<internal::RemoteTabletPtr> result;
+    for (const auto& partition_key : partition_keys) {
+      result.push_back(VERIFY_RESULT(client->LookupTabletByKeyFuture(
+          table, partition_key, CoarseMonoClock::now() + kLookupTimeout).get()));
+    }
+    return result;
+  };
+
+  const auto tablets = ASSERT_RESULT(lookup_all());
+  auto lookup_serial = client::internal::TEST_GetLookupSerial();
+  ASSERT_EQ(ASSERT_RESULT(lookup_all()), tablets);
+  ASSERT_EQ(client::internal::TEST_GetLookupSerial(), lookup_serial);
+
+  // Stale tablets are ignored by the snapshot lookup, so the master is asked again.
+  tablets.front()->MarkStale();
+  ASSERT_RESULT(lookup_all());
+  ASSERT_GT(client::internal::TEST_GetLookupSerial(), lookup_serial);
+  lookup_serial = client::internal::TEST_GetLookupSerial();
+  ASSERT_RESULT(lookup_all());
+  ASSERT_EQ(client::internal::TEST_GetLookupSerial(), lookup_serial);
+}
+
 // There should be only one lookup RPC asking for colocated tables tablet locations.
 // When we ask for tablet lookup for other tables colocated with the first one we asked, MetaCache
 // should be able to respond without sending RPCs to master again.
@@ -660,6 +660,15 @@ Status YBClient::GetTableSchemaById(const TableId& table_id, std::shared_ptr<YBT
   return data_->GetTableSchemaById(this, table_id, deadline, info, callback);
 }
 
+Status YBClient::GetTableSchemaById(const TableId& table_id, GetTableSchemaResponsePB* resp) {
+  GetTableSchemaRequestPB req;
+  GetTableSchemaResponsePB result;
+  req.mutable_table()->set_table_id(table_id);
+  CALL_SYNC_LEADER_MASTER_RPC(req, result, GetTableSchema);
+  *resp = std::move(result);
+  return Status::OK();
+}
+
 Status YBClient::GetColocatedTabletSchemaById(const TableId& parent_colocated_table_id,
                                               std::shared_ptr<std::vector<YBTableInfo>> info,
                                               StatusCallback callback) {
@@ -1806,6 +1815,23 @@ std::future<Result<std::vector<internal::RemoteTabletPtr>>> YBClient::LookupAllT
   });
 }
 
+AsyncFuture<Result<internal::RemoteTabletPtr>> YBClient::LookupTabletByKeyAsyncFuture(
+    const std::shared_ptr<YBTable>& table,
+    const std::string& partition_key,
+    CoarseTimePoint deadline) {
+  return MakeAsyncFuture<Result<internal::RemoteTabletPtr>>([&](auto callback) {
+    this->LookupTabletByKey(table, partition_key, deadline, std::move(callback));
+  });
+}
+
+AsyncFuture<Result<std::vector<internal::RemoteTabletPtr>>> YBClient::LookupAllTabletsAsyncFuture(
+    const std::shared_ptr<const YBTable>& table,
+    CoarseTimePoint deadline) {
+  return MakeAsyncFuture<Result<std::vector<internal::RemoteTabletPtr>>>([&](auto callback) {
+    this->LookupAllTablets(table, deadline, std::move(callback));
+  });
+}
+
 HostPort YBClient::GetMasterLeaderAddress() {
   return data_->leader_master_hostport();
 }
@@ -1935,6 +1961,19 @@ Status YBClient::OpenTable(const TableId& table_id, shared_ptr<YBTable>* table)
   return Status::OK();
 }
 
+Status YBClient::OpenTable(const GetTableSchemaResponsePB& resp, shared_ptr<YBTable>* table) {
+  if (resp.has_error()) {
+    return StatusFromPB(resp.error().status());
+  }
+  YBTableInfo info;
+  RETURN_NOT_OK(internal::CreateTableInfoFromTableSchemaResp(resp, &info));
+
+  std::shared_ptr<YBTable> ret(new YBTable(this, info));
+  RETURN_NOT_OK(ret->Open());
+  table->swap(ret);
+  return Status::OK();
+}
+
 shared_ptr<YBSession> YBClient::NewSession() {
   return std::make_shared<YBSession>(this);
 }
@@ -70,6 +70,7 @@
 
 #include "yb/rpc/rpc_fwd.h"
 
+#include "yb/util/async_future.h"
 #include "yb/util/enums.h"
 #include "yb/util/monotime.h"
 #include "yb/util/net/net_fwd.h"
@@ -333,6 +334,11 @@ class YBClient {
   CHECKED_STATUS GetTableSchemaById(const TableId& table_id, std::shared_ptr<YBTableInfo> info,
                                     StatusCallback callback);
 
+  // Fetches the raw master schema response of the table, so that it could be handed to another
+  // client process and opened there with OpenTable(resp, table).
+  CHECKED_STATUS GetTableSchemaById(const TableId& table_id,
+                                    master::GetTableSchemaResponsePB* resp);
+
   CHECKED_STATUS GetColocatedTabletSchemaById(const TableId& parent_colocated_table_id,
                                               std::shared_ptr<std::vector<YBTableInfo>> info,
                                               StatusCallback callback);
@@ -642,6 +648,11 @@ class YBClient {
   CHECKED_STATUS OpenTable(const YBTableName& table_name, std::shared_ptr<YBTable>* table);
   CHECKED_STATUS OpenTable(const TableId& table_id, std::shared_ptr<YBTable>* table);
 
+  // Open the table described by a schema response fetched earlier, possibly by another client,
+  // without contacting the master for the schema.
+  CHECKED_STATUS OpenTable(const master::GetTableSchemaResponsePB& resp,
+                           std::shared_ptr<YBTable>* table);
+
   Result<YBTablePtr> OpenTable(const TableId& table_id) {
     YBTablePtr result;
     RETURN_NOT_OK(OpenTable(table_id, &result));
@@ -744,6 +755,16 @@ class YBClient {
       const std::shared_ptr<const YBTable>& table,
       CoarseTimePoint deadline);
 
+  // Versions of lookups above, that return futures which could be consumed by continuations.
+  AsyncFuture<Result<internal::RemoteTabletPtr>> LookupTabletByKeyAsyncFuture(
+      const std::shared_ptr<YBTable>& table,
+      const std::string& partition_key,
+      CoarseTimePoint deadline);
+
+  AsyncFuture<Result<std::vector<internal::RemoteTabletPtr>>> LookupAllTabletsAsyncFuture(
+      const std::shared_ptr<const YBTable>& table,
+      CoarseTimePoint deadline);
+
   rpc::Messenger* messenger() const;
 
   const scoped_refptr<MetricEntity>& metric_entity() const;
@@ -86,6 +86,11 @@ DEFINE_int64(meta_cache_lookup_throttling_step_ms, 5,
 DEFINE_int64(meta_cache_lookup_throttling_max_delay_ms, 1000,
              "Max delay between calls during lookup throttling.");
 
+DEFINE_bool(meta_cache_lock_free_lookups, false,
+            "Whether MetaCache should keep a read-copy-update snapshot of table partition maps, "
+            "so lookups of cached tablets by key do not acquire the MetaCache lock.");
+TAG_FLAG(meta_cache_lock_free_lookups, advanced);
+
 DEFINE_test_flag(bool, force_master_lookup_all_tablets, false,
                  "If set, force the client to go to the master for all tablet lookup "
                  "instead of reading from cache.");
@@ -273,6 +278,29 @@ bool RemoteTabletServer::HasCapability(CapabilityId capability) const {
   return std::binary_search(capabilities_.begin(), capabilities_.end(), capability);
 }
 
+void RemoteTabletServer::RecordResponseTime(MonoDelta response_time) {
+  const auto sample = response_time.ToMicroseconds();
+  const auto smoothed = smoothed_response_time_us_.load(std::memory_order_relaxed);
+  if (smoothed < 0) {
+    smoothed_response_time_us_.store(sample, std::memory_order_relaxed);
+    response_time_variation_us_.store(sample / 2, std::memory_order_relaxed);
+    return;
+  }
+  const auto variation = response_time_variation_us_.load(std::memory_order_relaxed);
+  response_time_variation_us_.store(
+      variation + (std::abs(sample - smoothed) - variation) / 4, std::memory_order_relaxed);
+  smoothed_response_time_us_.store(smoothed + (sample - smoothed) / 8, std::memory_order_relaxed);
+}
+
+boost::optional<MonoDelta> RemoteTabletServer::ExpectedResponseTime() const {
+  const auto smoothed = smoothed_response_time_us_.load(std::memory_order_relaxed);
+  if (smoothed < 0) {
+    return boost::none;
+  }
+  return MonoDelta::FromMicroseconds(
+      smoothed + response_time_variation_us_.load(std::memory_order_relaxed));
+}
+
 ////////////////////////////////////////////////////////////
 
 RemoteTablet::~RemoteTablet() {
@@ -325,8 +353,7 @@ void RemoteTablet::MarkStale() {
 }
 
 bool RemoteTablet::stale() const {
-  SharedLock<rw_spinlock> lock(mutex_);
-  return stale_;
+  return stale_.load(std::memory_order_acquire);
 }
 
 void RemoteTablet::MarkAsSplit() {
@@ -1116,6 +1143,18 @@ Status MetaCache::ProcessTabletLocations(
       lookup_rpc->AddCallbacksToBeNotified(processed_tables, &tables_, &to_notify);
       lookup_rpc->CleanupRequest();
     }
+    if (FLAGS_meta_cache_lock_free_lookups) {
+      for (const auto& processed_table : processed_tables) {
+        auto it = tables_.find(processed_table.first);
+        if (it != tables_.end()) {
+          UpdateTableSnapshotUnlocked(it->first, it->second);
+        }
+      }
+    }
+  }
+
+  if (FLAGS_meta_cache_lock_free_lookups) {
+    PublishTablesSnapshot();
   }
 
   for (const auto& callback_and_param : to_notify) {
@@ -1217,6 +1256,12 @@ void MetaCache::InvalidateTableCache(const YBTable& table) {
     // Only update partitions here after invalidating TableData cache to avoid inconsistencies.
     // See https://github.com/yugabyte/yugabyte-db/issues/6890.
     table_data.partition_list = table_partition_list;
+    if (FLAGS_meta_cache_lock_free_lookups) {
+      UpdateTableSnapshotUnlocked(table_id, table_data);
+    }
+  }
+  if (FLAGS_meta_cache_lock_free_lookups) {
+    PublishTablesSnapshot();
   }
   for (const auto& callback : to_notify) {
     const auto s =
@@ -1764,6 +1809,37 @@ void MetaCache::LookupByIdFailed(
   }
 }
 
+namespace {
+
+// Returns tablet from tablets_by_partition that starts at partition_start_key, if it is not stale
+// and covers partition_start_key.
+RemoteTabletPtr FindTabletByPartitionStart(
+    const std::map<PartitionKey, RemoteTabletPtr>& tablets_by_partition,
+    const PartitionKey& partition_start_key) {
+  auto tablet_it = tablets_by_partition.find(partition_start_key);
+  if (PREDICT_FALSE(tablet_it == tablets_by_partition.end())) {
+    // No tablets with a start partition key lower than 'partition_key'.
+    return nullptr;
+  }
+
+  const auto& result = tablet_it->second;
+
+  // Stale entries must be re-fetched.
+  if (result->stale()) {
+    return nullptr;
+  }
+
+  if (result->partition().partition_key_end().compare(partition_start_key) > 0 ||
+      result->partition().partition_key_end().empty()) {
+    // partition_start_key < partition.end OR tablet does not end.
+    return result;
+  }
+
+  return nullptr;
+}
+
+} // namespace
+
 RemoteTabletPtr MetaCache::LookupTabletByKeyFastPathUnlocked(
     const TableId& table_id, const VersionedPartitionStartKey& versioned_partition_start_key) {
   auto it = tables_.find(table_id);
@@ -1787,28 +1863,50 @@ RemoteTabletPtr MetaCache::LookupTabletByKeyFastPathUnlocked(
   DCHECK_EQ(
       partition_start_key,
       *client::FindPartitionStart(table_data.partition_list, partition_start_key));
-  auto tablet_it = table_data.tablets_by_partition.find(partition_start_key);
-  if (PREDICT_FALSE(tablet_it == it->second.tablets_by_partition.end())) {
-    // No tablets with a start partition key lower than 'partition_key'.
-    return nullptr;
-  }
-
-  const auto& result = tablet_it->second;
+  return FindTabletByPartitionStart(table_data.tablets_by_partition, partition_start_key);
+}
 
-  // Stale entries must be re-fetched.
-  if (result->stale()) {
+RemoteTabletPtr MetaCache::FastLookupTabletByKeyInSnapshot(
+    const TableId& table_id, const VersionedPartitionStartKey& partition_start) {
+  // Only the thread local URCU state is modified here, so concurrent lookups do not contend.
+  auto snapshot = tables_snapshot_.get();
+  auto it = snapshot->tables.find(table_id);
+  if (it == snapshot->tables.end() ||
+      it->second->partition_list_version != partition_start.partition_list_version) {
     return nullptr;
   }
-
-  if (result->partition().partition_key_end().compare(partition_start_key) > 0 ||
-      result->partition().partition_key_end().empty()) {
-    // partition_start_key < partition.end OR tablet does not end.
+  auto result = FindTabletByPartitionStart(
+      it->second->tablets_by_partition, *partition_start.key);
+  if (result && result->HasLeader()) {
+    VLOG_WITH_PREFIX(5) << "Lock-free lookup: found tablet " << result->tablet_id();
     return result;
   }
-
   return nullptr;
 }
 
+void MetaCache::UpdateTableSnapshotUnlocked(const TableId& table_id, const TableData& table_data) {
+  tables_snapshot_draft_.tables[table_id] = std::make_shared<TablePartitionsSnapshot>(
+      TablePartitionsSnapshot {
+        .partition_list_version = table_data.partition_list->version,
+        .tablets_by_partition = table_data.tablets_by_partition,
+      });
+  ++tables_snapshot_draft_.serial;
+}
+
+void MetaCache::PublishTablesSnapshot() {
+  std::lock_guard<std::mutex> publish_lock(tables_snapshot_mutex_);
+  TablesSnapshot snapshot;
+  {
+    SharedLock<decltype(mutex_)> lock(mutex_);
+    if (tables_snapshot_draft_.serial == tables_snapshot_.get()->serial) {
+      return;
+    }
+    snapshot = tables_snapshot_draft_;
+  }
+  // Waits until readers of the previous snapshot are done, so it is done without mutex_.
+  tables_snapshot_.Set(std::move(snapshot));
+}
+
 boost::optional<std::vector<RemoteTabletPtr>> MetaCache::FastLookupAllTabletsUnlocked(
     const std::shared_ptr<const YBTable>& table) {
   auto tablets = std::vector<RemoteTabletPtr>();
@@ -2015,6 +2113,15 @@ void MetaCache::LookupTabletByKey(const std::shared_ptr<YBTable>& table,
                     << ", partition_key: " << Slice(partition_key).ToDebugHexString()
                     << ", partition_start: " << Slice(*partition_start).ToDebugHexString();
 
+  if (FLAGS_meta_cache_lock_free_lookups) {
+    auto tablet = FastLookupTabletByKeyInSnapshot(
+        table->id(), {partition_start, table_partition_list->version});
+    if (tablet) {
+      callback(tablet);
+      return;
+    }
+  }
+
   PartitionGroupStartKeyPtr partition_group_start;
   if (DoLookupTabletByKey<SharedLock<boost::shared_mutex>>(
           table, table_partition_list, partition_start, deadline, &callback,
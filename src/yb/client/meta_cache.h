@@ -33,7 +33,9 @@
 #ifndef YB_CLIENT_META_CACHE_H
 #define YB_CLIENT_META_CACHE_H
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <string>
 #include <memory>
 #include <unordered_map>
@@ -62,6 +64,7 @@
 
 #include "yb/util/async_util.h"
 #include "yb/util/capabilities.h"
+#include "yb/util/concurrent_value.h"
 #include "yb/util/locks.h"
 #include "yb/util/lockfree.h"
 #include "yb/util/monotime.h"
@@ -142,10 +145,22 @@ class RemoteTabletServer {
 
   bool HasCapability(CapabilityId capability) const;
 
+  // Updates smoothed response time of this server and its variation with a new sample, in the
+  // same way TCP estimates round trip time (RFC 6298).
+  // Concurrent updates could overwrite each other, which is acceptable for an estimate.
+  void RecordResponseTime(MonoDelta response_time);
+
+  // Returns smoothed response time plus its variation, or none if no responses were recorded.
+  boost::optional<MonoDelta> ExpectedResponseTime() const;
+
  private:
   mutable rw_spinlock mutex_;
   const std::string uuid_;
 
+  // Negative while there are no samples.
+  std::atomic<int64_t> smoothed_response_time_us_{-1};
+  std::atomic<int64_t> response_time_variation_us_{0};
+
   google::protobuf::RepeatedPtrField<HostPortPB> public_rpc_hostports_;
   google::protobuf::RepeatedPtrField<HostPortPB> private_rpc_hostports_;
   yb::CloudInfoPB cloud_info_pb_;
@@ -372,7 +387,8 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
 
   // All non-const members are protected by 'mutex_'.
   mutable rw_spinlock mutex_;
-  bool stale_;
+  // Modified under mutex_, but could be read without it, see MetaCache::tables_snapshot_.
+  std::atomic<bool> stale_;
   bool is_split_ = false;
   std::vector<RemoteReplica> replicas_;
   PartitionListVersion last_known_partition_list_version_ = 0;
@@ -485,6 +501,20 @@ struct TableData {
   // miss the key, because it doesn't exist in 1st post-split tablet.
 };
 
+// Immutable copy of TableData::tablets_by_partition together with the partition list version it
+// corresponds to.
+struct TablePartitionsSnapshot {
+  PartitionListVersion partition_list_version;
+  std::map<PartitionKey, RemoteTabletPtr> tablets_by_partition;
+};
+
+// Copy of partition maps of all cached tables, published by MetaCache for lookups that do not
+// acquire MetaCache::mutex_. Snapshots of unchanged tables are shared between versions.
+struct TablesSnapshot {
+  int64_t serial = 0;
+  std::unordered_map<TableId, std::shared_ptr<const TablePartitionsSnapshot>> tables;
+};
+
 class LookupCallbackVisitor : public boost::static_visitor<> {
  public:
   explicit LookupCallbackVisitor(const LookupCallbackParam& param) : param_(param) {
@@ -606,6 +636,19 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   RemoteTabletPtr LookupTabletByIdFastPathUnlocked(const TabletId& tablet_id)
       REQUIRES_SHARED(mutex_);
 
+  // Same as FastLookupTabletByKeyUnlocked, but consults tables_snapshot_ instead of tables_, so
+  // does not acquire mutex_.
+  RemoteTabletPtr FastLookupTabletByKeyInSnapshot(
+      const TableId& table_id, const VersionedPartitionStartKey& partition_start);
+
+  // Copies partition map of the specified table to the draft of the next tables snapshot.
+  void UpdateTableSnapshotUnlocked(const TableId& table_id, const TableData& table_data)
+      REQUIRES(mutex_);
+
+  // Publishes the draft of the tables snapshot, if it has changed since the last publication.
+  // Should be called without holding mutex_, since it waits for readers of the previous snapshot.
+  void PublishTablesSnapshot() EXCLUDES(mutex_);
+
   // Update our information about the given tablet server.
   //
   // This is called when we get some response from the master which contains
@@ -706,6 +749,14 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
 
   std::unordered_map<TabletId, LookupDataGroup> tablet_lookups_by_id_ GUARDED_BY(mutex_);
 
+  // Partition maps of tables_ used by the lock-free lookup path, maintained only when
+  // meta_cache_lock_free_lookups is set. Updates are accumulated in tables_snapshot_draft_ and
+  // published to tables_snapshot_ after mutex_ is released.
+  TablesSnapshot tables_snapshot_draft_ GUARDED_BY(mutex_);
+  // Serializes publications of tables_snapshot_.
+  std::mutex tables_snapshot_mutex_;
+  ConcurrentValue<TablesSnapshot> tables_snapshot_;
+
   // Prevents master lookup "storms" by delaying master lookups when all
   // permits have been acquired.
   Semaphore master_lookup_sem_;
@@ -37,6 +37,7 @@
 #include "yb/util/jsonreader.h"
 #include "yb/util/random.h"
 #include "yb/util/random_util.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/tostring.h"
 #include "yb/util/tsan_util.h"
 
@@ -45,10 +46,13 @@
 DECLARE_bool(mini_cluster_reuse_data);
 DECLARE_bool(rocksdb_disable_compactions);
 DECLARE_int32(yb_num_shards_per_tserver);
+DECLARE_int32(db_compressed_block_cache_size_percentage);
 DECLARE_int64(db_block_cache_size_bytes);
 DECLARE_bool(flush_rocksdb_on_shutdown);
 DECLARE_int32(max_stale_read_bound_time_ms);
 
+METRIC_DECLARE_counter(compressed_block_cache_hits);
+
 using namespace std::literals;
 
 namespace yb {
@@ -443,6 +447,50 @@ TEST_F_EX(QLDmlTest, RangeFilter, QLDmlRangeFilterBase) {
   }
 }
 
+TEST_F_EX(QLDmlTest, CompressedBlockCache, QLDmlRangeFilterBase) {
+  constexpr int32_t kTotalLines = NonTsanVsTsan(5000, 1000);
+  constexpr int32_t kProbeStep = 7;
+  // Values compress well, so the compressed tier keeps all data blocks, while the uncompressed
+  // tier keeps only a part of them.
+  auto value_at = [](int32_t idx) {
+    return std::string(1000, 'a' + idx % 26) + std::to_string(idx);
+  };
+  auto session = NewSession();
+  for (int32_t i = 0; i != kTotalLines; ++i) {
+    InsertRow(session, kHashInt, kHashStr, i, StrRangeFor(i), -i, value_at(i));
+    if ((i + 1) % 100 == 0) {
+      ASSERT_OK(session->Flush());
+    }
+  }
+  ASSERT_OK(session->Flush());
+  ASSERT_OK(cluster_->FlushTablets());
+
+  FLAGS_db_block_cache_size_bytes = 2_MB;
+  FLAGS_db_compressed_block_cache_size_percentage = 50;
+  ASSERT_OK(cluster_->RestartSync());
+
+  auto compressed_hits = [this] {
+    int64_t result = 0;
+    for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+      result += METRIC_compressed_block_cache_hits.Instantiate(
+          cluster_->mini_tablet_server(i)->server()->metric_entity())->value();
+    }
+    return result;
+  };
+
+  session = NewSession();
+  for (int pass = 0; pass != 2; ++pass) {
+    for (int32_t idx = 0; idx < kTotalLines; idx += kProbeStep) {
+      ASSERT_VERIFY(VerifyRow(
+          session, kHashInt, kHashStr, idx, StrRangeFor(idx), -idx, value_at(idx)));
+    }
+    LOG(INFO) << "Pass " << pass << ", compressed block cache hits: " << compressed_hits();
+  }
+  // Blocks evicted from the uncompressed tier during the first pass are found in the compressed
+  // tier by the second pass.
+  ASSERT_GT(compressed_hits(), 0);
+}
+
 TEST_F(QLDmlTest, TestInsertMultipleRows) {
   {
     const YBSessionPtr session(NewSession());
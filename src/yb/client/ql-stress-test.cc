@@ -55,10 +55,14 @@ DECLARE_bool(TEST_combine_batcher_errors);
 DECLARE_bool(allow_preempting_compactions);
 DECLARE_bool(detect_duplicates_for_retryable_requests);
 DECLARE_bool(enable_ondisk_compression);
+DECLARE_bool(leader_lease_handover_on_stepdown);
+DECLARE_bool(tablet_write_backpressure);
 DECLARE_double(TEST_respond_write_failed_probability);
 DECLARE_double(transaction_max_missed_heartbeat_periods);
 DECLARE_int32(TEST_max_write_waiters);
 DECLARE_int32(client_read_write_timeout_ms);
+DECLARE_int32(ht_lease_duration_ms);
+DECLARE_int32(leader_lease_duration_ms);
 DECLARE_int32(log_cache_size_limit_mb);
 DECLARE_int32(log_min_seconds_to_retain);
 DECLARE_int32(raft_heartbeat_interval_ms);
@@ -68,6 +72,7 @@ DECLARE_int32(rocksdb_level0_slowdown_writes_trigger);
 DECLARE_int32(rocksdb_max_background_compactions);
 DECLARE_int32(rocksdb_universal_compaction_min_merge_width);
 DECLARE_int32(rocksdb_universal_compaction_size_ratio);
+DECLARE_int32(tablet_write_backpressure_start_percentage);
 DECLARE_int64(db_write_buffer_size);
 DECLARE_int64(remote_bootstrap_rate_limit_bytes_per_sec);
 DECLARE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec);
@@ -77,6 +82,7 @@ DECLARE_uint64(sst_files_hard_limit);
 DECLARE_uint64(sst_files_soft_limit);
 
 METRIC_DECLARE_counter(majority_sst_files_rejections);
+METRIC_DECLARE_counter(write_backpressure_rejections);
 
 using namespace std::literals;
 
@@ -218,7 +224,8 @@ class QLStressTest : public QLDmlTestBase<MiniCluster> {
       bool allow_failures = false, TransactionManager* txn_manager = nullptr,
       double transactional_write_probability = 0.0);
 
-  void TestWriteRejection();
+  void TestWriteRejection(
+      const CounterPrototype& rejections_metric = METRIC_majority_sst_files_rejections);
 
   TableHandle table_;
 
@@ -646,6 +653,87 @@ void QLStressTest::VerifyFlushedFrontiers() {
   }
 }
 
+class QLStressTestLeaseHandover : public QLStressTestSingleTablet {
+ protected:
+  void SetUp() override {
+    FLAGS_leader_lease_handover_on_stepdown = true;
+    // Long leases, so waiting for the old leader lease to expire is noticeable.
+    FLAGS_leader_lease_duration_ms = ToMilliseconds(kLeaseDuration);
+    FLAGS_ht_lease_duration_ms = ToMilliseconds(kLeaseDuration);
+    ASSERT_NO_FATALS(QLStressTestSingleTablet::SetUp());
+  }
+
+  // Waits until the peer is the leader that could serve reads and writes, and returns the time
+  // it took since start.
+  Result<MonoDelta> WaitLeaderReady(
+      const tablet::TabletPeerPtr& peer, CoarseTimePoint start) {
+    RETURN_NOT_OK(WaitFor([peer] {
+      return peer->consensus()->GetLeaderStatus() ==
+             consensus::LeaderStatus::LEADER_AND_READY;
+    }, kLeaseDuration * 3, "Leader ready"));
+    return MonoDelta(CoarseMonoClock::now() - start);
+  }
+
+  const std::chrono::milliseconds kLeaseDuration = 10s * kTimeMultiplier;
+};
+
+TEST_F_EX(QLStressTest, LeaderLeaseHandoverOnStepDown, QLStressTestLeaseHandover) {
+  auto session = NewSession();
+  ASSERT_OK(WriteRow(session, 0, "value0"));
+
+  auto leaders = ListTabletPeers(cluster_.get(), ListPeersFilter::kLeaders);
+  ASSERT_EQ(1, leaders.size());
+  auto old_leader = leaders[0];
+  auto followers = ListTabletPeers(cluster_.get(), ListPeersFilter::kNonLeaders);
+  ASSERT_EQ(2, followers.size());
+  auto protege = followers[0];
+  auto other_follower = followers[1];
+  ASSERT_OK(WaitLeaderReady(old_leader, CoarseMonoClock::now()));
+  const auto old_term = old_leader->consensus()->LeaderTerm();
+
+  ASSERT_OK(WriteRow(session, 1, "value1"));
+  // The last hybrid time of the old leader is after the write.
+  const auto old_leader_ht = old_leader->clock().Now();
+
+  LOG(INFO) << "Step down " << old_leader->permanent_uuid() << " in favor of "
+            << protege->permanent_uuid();
+  auto start = CoarseMonoClock::now();
+  ASSERT_OK(StepDown(old_leader, protege->permanent_uuid(), ForceStepDown::kFalse));
+
+  // The protege serves without waiting for the old leader lease to expire.
+  auto ready_delay = ASSERT_RESULT(WaitLeaderReady(protege, start));
+  LOG(INFO) << "Protege ready in " << ready_delay;
+  ASSERT_LT(ready_delay, MonoDelta(kLeaseDuration / 2));
+  const auto new_term = protege->consensus()->LeaderTerm();
+  ASSERT_EQ(old_term + 1, new_term);
+
+  // Hybrid times of the new leader follow the ones of the old leader, so a read at the old
+  // leader's last hybrid time sees all writes done by the old leader.
+  auto safe_time = ASSERT_RESULT(protege->tablet()->SafeTime(
+      tablet::RequireLease::kTrue, old_leader_ht, CoarseMonoClock::now() + kLeaseDuration));
+  ASSERT_GE(safe_time, old_leader_ht);
+  ASSERT_GT(protege->clock().Now(), old_leader_ht);
+  ASSERT_EQ(ASSERT_RESULT(ReadRow(session, 1)).string_value(), "value1");
+  ASSERT_OK(WriteRow(session, 1, "value2"));
+  ASSERT_EQ(ASSERT_RESULT(ReadRow(session, 1)).string_value(), "value2");
+
+  // A handover from a term before the current one is ignored, so the new leader waits for the
+  // lease of the current leader to expire.
+  LOG(INFO) << "Elect " << other_follower->permanent_uuid() << " with stale handover";
+  start = CoarseMonoClock::now();
+  ASSERT_OK(other_follower->consensus()->StartElection(consensus::LeaderElectionData {
+    .mode = consensus::ElectionMode::ELECT_EVEN_IF_LEADER_IS_ALIVE,
+    .originator_uuid = protege->permanent_uuid(),
+    .relinquished_lease_term = old_term,
+    .relinquished_lease_ht = protege->clock().Now(),
+  }));
+  ready_delay = ASSERT_RESULT(WaitLeaderReady(other_follower, start));
+  LOG(INFO) << "Leader elected with stale handover ready in " << ready_delay;
+  ASSERT_GT(other_follower->consensus()->LeaderTerm(), new_term);
+  ASSERT_GE(ready_delay, MonoDelta(kLeaseDuration / 2));
+  ASSERT_EQ(ASSERT_RESULT(ReadRow(session, 1)).string_value(), "value2");
+}
+
 TEST_F_EX(QLStressTest, FlushCompact, QLStressTestSingleTablet) {
   std::atomic<int> key;
 
@@ -814,7 +902,7 @@ void QLStressTest::AddWriter(
   });
 }
 
-void QLStressTest::TestWriteRejection() {
+void QLStressTest::TestWriteRejection(const CounterPrototype& rejections_metric) {
   constexpr int kWriters = IsDebug() ? 10 : 20;
   constexpr int kKeyBase = 10000;
 
@@ -873,8 +961,7 @@ void QLStressTest::TestWriteRejection() {
       int64_t rejections = 0;
       auto peers = cluster_->mini_tablet_server(i)->server()->tablet_manager()->GetTabletPeers();
       for (const auto& peer : peers) {
-        auto counter = METRIC_majority_sst_files_rejections.Instantiate(
-            peer->tablet()->GetTabletMetricsEntity());
+        auto counter = rejections_metric.Instantiate(peer->tablet()->GetTabletMetricsEntity());
         rejections += counter->value();
       }
       total_rejections += rejections;
@@ -922,6 +1009,21 @@ TEST_F_EX(QLStressTest, WriteStop, QLStressTestDelayWrite_6_6) {
   TestWriteRejection();
 }
 
+class QLStressTestWriteBackpressure : public QLStressTestDelayWrite<1000, 1000> {
+ public:
+  void SetUp() override {
+    FLAGS_tablet_write_backpressure = true;
+    FLAGS_tablet_write_backpressure_start_percentage = 40;
+    FLAGS_rocksdb_level0_slowdown_writes_trigger = 10;
+    QLStressTestDelayWrite::SetUp();
+  }
+};
+
+// RocksDB slows down writes at 10 SST files, backpressure should start to reject writes at 4.
+TEST_F_EX(QLStressTest, WriteBackpressure, QLStressTestWriteBackpressure) {
+  TestWriteRejection(METRIC_write_backpressure_rejections);
+}
+
 class QLStressTestLongRemoteBootstrap : public QLStressTestSingleTablet {
  public:
   void SetUp() override {
@@ -25,6 +25,7 @@
 #include "yb/client/table_handle.h"
 
 #include "yb/common/ql_value.h"
+#include "yb/common/wire_protocol.h"
 
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/consensus.pb.h"
@@ -47,6 +48,7 @@
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/tserver/tserver_service.proxy.h"
 
+#include "yb/util/file_util.h"
 #include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/shared_lock.h"
@@ -323,6 +325,59 @@ class QLTabletTest : public QLDmlTestBase<MiniCluster> {
     return Status::OK();
   }
 
+  // Imports data through the Raft log of the destination tablets. Files of each source tablet are
+  // staged in the directory shared by all replicas, as bulk load stages them on every node.
+  CHECKED_STATUS ReplicatedImport() {
+    auto source_infos = VERIFY_RESULT(GetTabletInfos(kTable1Name));
+    auto dest_infos = VERIFY_RESULT(GetTabletInfos(kTable2Name));
+    EXPECT_EQ(source_infos.size(), dest_infos.size());
+    // Files are taken from source leaders, and imported through destination leaders.
+    RETURN_NOT_OK(WaitFor([this, &source_infos, &dest_infos]() -> Result<bool> {
+      for (size_t i = 0; i != source_infos.size(); ++i) {
+        if (!FindTabletLeader(cluster_.get(), source_infos[i]->id()) ||
+            !FindTabletLeader(cluster_.get(), dest_infos[i]->id())) {
+          return false;
+        }
+      }
+      return true;
+    }, 30s, "Wait for tablet leaders"));
+    RETURN_NOT_OK(cluster_->FlushTablets());
+
+    for (size_t i = 0; i != source_infos.size(); ++i) {
+      auto* source_leader = FindTabletLeader(cluster_.get(), source_infos[i]->id());
+      auto* dest_leader = FindTabletLeader(cluster_.get(), dest_infos[i]->id());
+      if (!source_leader || !dest_leader) {
+        return STATUS_FORMAT(IllegalState, "No leader for tablet $0", i);
+      }
+      tablet::TabletPeerPtr source_peer;
+      source_leader->server()->tablet_manager()->LookupTablet(source_infos[i]->id(), &source_peer);
+      EXPECT_NE(nullptr, source_peer);
+      auto source_dir = GetTestPath(Format("import-$0", i));
+      RETURN_NOT_OK(CopyDirectory(
+          Env::Default(), source_peer->tablet()->metadata()->rocksdb_dir(), source_dir,
+          UseHardLinks::kTrue, CreateIfMissing::kTrue));
+
+      auto endpoint = dest_leader->server()->rpc_server()->GetBoundAddresses().front();
+      tserver::TabletServerServiceProxy proxy(
+          &dest_leader->server()->proxy_cache(), HostPort::FromBoundEndpoint(endpoint));
+      tserver::ImportDataRequestPB req;
+      req.set_tablet_id(dest_infos[i]->id());
+      req.set_source_dir(source_dir);
+      req.set_replicated(true);
+      tserver::ImportDataResponsePB resp;
+      rpc::RpcController controller;
+      controller.set_timeout(30s);
+      RETURN_NOT_OK(proxy.ImportData(req, &resp, &controller));
+      if (resp.has_error()) {
+        auto status = StatusFromPB(resp.error().status());
+        if (!status.IsNotFound()) {
+          return status;
+        }
+      }
+    }
+    return Status::OK();
+  }
+
   Result<scoped_refptr<master::TableInfo>> GetTableInfo(const YBTableName& table_name) {
     auto* catalog_manager =
         VERIFY_RESULT(cluster_->GetLeaderMiniMaster())->master()->catalog_manager();
@@ -377,6 +432,19 @@ TEST_F(QLTabletTest, ImportToEmpty) {
   VerifyTable(0, kTotalKeys, table2_);
 }
 
+TEST_F(QLTabletTest, ReplicatedImportToEmptyAndRestart) {
+  CreateTables(0, kBigSeqNo);
+
+  FillTable(0, kTotalKeys, table1_);
+  ASSERT_OK(ReplicatedImport());
+  VerifyTable(0, kTotalKeys, table2_);
+  ASSERT_OK(WaitSync(0, kTotalKeys, table2_));
+
+  // Import is flushed together with the imported files, so it is not replayed on bootstrap.
+  ASSERT_OK(cluster_->RestartSync());
+  VerifyTable(0, kTotalKeys, table2_);
+}
+
 TEST_F(QLTabletTest, ImportToNonEmpty) {
   CreateTables(0, kBigSeqNo);
 
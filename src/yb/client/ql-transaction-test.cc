@@ -53,6 +53,7 @@ DECLARE_bool(TEST_disable_proactive_txn_cleanup_on_abort);
 DECLARE_bool(TEST_fail_in_apply_if_no_metadata);
 DECLARE_bool(TEST_master_fail_transactional_tablet_lookups);
 DECLARE_bool(TEST_transaction_allow_rerequest_status);
+DECLARE_bool(conflict_resolution_single_pass);
 DECLARE_bool(delete_intents_sst_files);
 DECLARE_bool(enable_load_balancing);
 DECLARE_bool(fail_on_out_of_range_clock_skew);
@@ -576,6 +577,46 @@ TEST_F(QLTransactionTest, SimpleWriteConflict) {
   ASSERT_NOK(transaction->CommitFuture().get());
 }
 
+TEST_F(QLTransactionTest, BatchConflictResolution) {
+  constexpr int32_t kNumRows = 100;
+  for (bool single_pass : {false, true}) {
+    FLAGS_conflict_resolution_single_pass = single_pass;
+    const int32_t base = single_pass ? 10 * kNumRows : 0;
+
+    // Transactions write interleaved rows, so their batches don't conflict.
+    auto txn1 = CreateTransaction();
+    auto txn2 = CreateTransaction();
+    auto session1 = CreateSession(txn1);
+    auto session2 = CreateSession(txn2);
+    for (int32_t r = 0; r < kNumRows; r += 2) {
+      ASSERT_OK(WriteRow(session1, base + r, 1, WriteOpType::INSERT, Flush::kFalse));
+      ASSERT_OK(WriteRow(session2, base + r + 1, 2, WriteOpType::INSERT, Flush::kFalse));
+    }
+    ASSERT_OK(session1->Flush());
+    ASSERT_OK(session2->Flush());
+
+    // Batch of the third transaction conflicts with the second one by its last row only.
+    auto txn3 = CreateTransaction();
+    auto session3 = CreateSession(txn3);
+    for (int32_t r = kNumRows - 1; r != 2 * kNumRows; ++r) {
+      ASSERT_OK(WriteRow(session3, base + r, 3, WriteOpType::INSERT, Flush::kFalse));
+    }
+    auto flush_status = session3->Flush();
+    LOG(INFO) << "Single pass: " << single_pass << ", conflicting flush: " << flush_status;
+
+    ASSERT_OK(txn1->CommitFuture().get());
+    auto commit2 = txn2->CommitFuture().get();
+    auto commit3 = flush_status.ok() ? txn3->CommitFuture().get() : flush_status;
+    ASSERT_NE(commit2.ok(), commit3.ok()) << commit2 << ", " << commit3;
+
+    auto session = CreateSession();
+    for (int32_t r = 0; r < kNumRows; r += 2) {
+      ASSERT_EQ(1, ASSERT_RESULT(SelectRow(session, base + r)));
+    }
+    ASSERT_EQ(commit2.ok() ? 2 : 3, ASSERT_RESULT(SelectRow(session, base + kNumRows - 1)));
+  }
+}
+
 void QLTransactionTest::TestReadOnlyTablets(IsolationLevel isolation_level,
                                             bool perform_write,
                                             bool written_intents_expected) {
@@ -13,6 +13,11 @@
 
 #include "yb/client/session.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
+
 #include "yb/client/batcher.h"
 #include "yb/client/client.h"
 #include "yb/client/client_error.h"
@@ -30,6 +35,8 @@ using namespace std::placeholders;
 
 DEFINE_int32(client_read_write_timeout_ms, 60000, "Timeout for client read and write operations.");
 
+DECLARE_int32(rpc_max_message_size);
+
 namespace yb {
 namespace client {
 
@@ -39,6 +46,111 @@ using internal::ErrorCollector;
 
 using std::shared_ptr;
 
+// Tracks batches flushed in auto flush mode: bounds the number of batches in flight, accumulates
+// their errors until the next explicit flush and adapts flush size to batch latency.
+class YBSession::AutoFlusher {
+ public:
+  explicit AutoFlusher(const AutoFlushOptions& options)
+      : options_(options), flush_bytes_(options.max_buffer_bytes) {
+    options_.min_buffer_bytes = std::min(options_.min_buffer_bytes, options_.max_buffer_bytes);
+  }
+
+  const AutoFlushOptions& options() const {
+    return options_;
+  }
+
+  size_t flush_bytes() const {
+    return flush_bytes_.load(std::memory_order_acquire);
+  }
+
+  // Registers a new batch, waiting for a free slot first if wait is true.
+  void BatchStarted(bool wait) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (wait) {
+      cond_.wait(lock, [this] {
+        return num_in_flight_ < std::max<size_t>(options_.max_in_flight_batches, 1);
+      });
+    }
+    ++num_in_flight_;
+  }
+
+  void BatchFinished(FlushStatus* flush_status, CoarseDuration latency) {
+    std::vector<FlushCallback> waiters;
+    FlushStatus accumulated;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      UpdateFlushBytes(latency);
+      if (!flush_status->status.ok() && status_.status.ok()) {
+        status_.status = flush_status->status;
+      }
+      std::move(flush_status->errors.begin(), flush_status->errors.end(),
+                std::back_inserter(status_.errors));
+      --num_in_flight_;
+      if (num_in_flight_ == 0) {
+        waiters.swap(waiters_);
+        accumulated = TakeStatus();
+      }
+    }
+    cond_.notify_all();
+    Notify(&waiters, &accumulated);
+  }
+
+  // Invokes callback with accumulated errors after all batches in flight have finished.
+  void NotifyWhenIdle(FlushCallback callback) {
+    std::vector<FlushCallback> waiters;
+    FlushStatus accumulated;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      waiters_.push_back(std::move(callback));
+      if (num_in_flight_ != 0) {
+        return;
+      }
+      waiters.swap(waiters_);
+      accumulated = TakeStatus();
+    }
+    Notify(&waiters, &accumulated);
+  }
+
+ private:
+  FlushStatus TakeStatus() REQUIRES(mutex_) {
+    FlushStatus result = std::move(status_);
+    status_ = FlushStatus();
+    return result;
+  }
+
+  // Per operation errors are passed to the first waiter only.
+  static void Notify(std::vector<FlushCallback>* waiters, FlushStatus* accumulated) {
+    for (auto& waiter : *waiters) {
+      waiter(accumulated);
+      accumulated->errors.clear();
+    }
+  }
+
+  // Multiplicative increase and decrease, so flush size converges quickly after load changes.
+  void UpdateFlushBytes(CoarseDuration latency) REQUIRES(mutex_) {
+    if (!options_.target_batch_latency.Initialized()) {
+      return;
+    }
+    auto flush_bytes = flush_bytes_.load(std::memory_order_acquire);
+    if (MonoDelta(latency) < options_.target_batch_latency) {
+      flush_bytes = std::min(flush_bytes + std::max<size_t>(flush_bytes / 4, 1),
+                             options_.max_buffer_bytes);
+    } else {
+      flush_bytes = std::max(flush_bytes / 2, options_.min_buffer_bytes);
+    }
+    flush_bytes_.store(flush_bytes, std::memory_order_release);
+  }
+
+  AutoFlushOptions options_;
+  std::atomic<size_t> flush_bytes_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  size_t num_in_flight_ GUARDED_BY(mutex_) = 0;
+  FlushStatus status_ GUARDED_BY(mutex_);
+  std::vector<FlushCallback> waiters_ GUARDED_BY(mutex_);
+};
+
 YBSession::YBSession(YBClient* client, const scoped_refptr<ClockBase>& clock) {
   batcher_config_.client = client;
   batcher_config_.non_transactional_read_point =
@@ -235,7 +347,59 @@ void FlushBatcherAsync(
 
 } // namespace
 
+void YBSession::SetAutoFlush(const AutoFlushOptions& options) {
+  if (options.max_buffer_bytes == 0) {
+    auto_flusher_.reset();
+    return;
+  }
+  auto adjusted = options;
+  adjusted.max_buffer_bytes = std::min<size_t>(
+      adjusted.max_buffer_bytes, std::max(FLAGS_rpc_max_message_size / 2, 1));
+  auto_flusher_ = std::make_shared<AutoFlusher>(adjusted);
+}
+
+void YBSession::AutoFlushIfNeeded(size_t op_size) {
+  const auto now = CoarseMonoClock::now();
+  // The first operation of a new batcher, previous one was flushed or aborted.
+  if (batcher_->GetAddedNotFlushedOperationsCount() <= 1) {
+    buffered_bytes_ = 0;
+    buffer_start_ = now;
+  }
+  buffered_bytes_ += op_size;
+  const auto& delay = auto_flusher_->options().max_buffer_delay;
+  if (buffered_bytes_ < auto_flusher_->flush_bytes() &&
+      (!delay.Initialized() || MonoDelta(now - buffer_start_) < delay)) {
+    return;
+  }
+  auto_flusher_->BatchStarted(/* wait= */ true);
+  StartAutoFlushedBatch();
+}
+
+void YBSession::StartAutoFlushedBatch() {
+  internal::BatcherPtr old_batcher;
+  old_batcher.swap(batcher_);
+  auto auto_flusher = auto_flusher_;
+  const auto start = CoarseMonoClock::now();
+  FlushBatcherAsync(
+      old_batcher,
+      [auto_flusher, start](FlushStatus* flush_status) {
+        auto_flusher->BatchFinished(flush_status, CoarseMonoClock::now() - start);
+      },
+      batcher_config_, internal::IsWithinTransactionRetry::kFalse);
+}
+
 void YBSession::FlushAsync(FlushCallback callback) {
+  if (auto_flusher_) {
+    // Keep auto_flusher, because completion of the last batch could trigger session destruction.
+    auto auto_flusher = auto_flusher_;
+    if (batcher_) {
+      auto_flusher->BatchStarted(/* wait= */ false);
+      StartAutoFlushedBatch();
+    }
+    auto_flusher->NotifyWhenIdle(std::move(callback));
+    return;
+  }
+
   // Swap in a new batcher to start building the next batch.
   // Save off the old batcher.
   //
@@ -264,6 +428,15 @@ std::future<FlushStatus> YBSession::FlushFuture() {
   return future;
 }
 
+AsyncFuture<FlushStatus> YBSession::FlushAsyncFuture() {
+  AsyncPromise<FlushStatus> promise;
+  auto future = promise.GetFuture();
+  FlushAsync([promise](FlushStatus* status) {
+    promise.SetValue(std::move(*status));
+  });
+  return future;
+}
+
 Status YBSession::ReadSync(std::shared_ptr<YBOperation> yb_op) {
   CHECK(yb_op->read_only());
   return ApplyAndFlush(std::move(yb_op));
@@ -339,7 +512,13 @@ internal::Batcher& YBSession::Batcher() {
 }
 
 Status YBSession::Apply(YBOperationPtr yb_op) {
-  return Batcher().Add(yb_op);
+  if (!auto_flusher_) {
+    return Batcher().Add(yb_op);
+  }
+  const auto op_size = yb_op->space_used_by_request();
+  RETURN_NOT_OK(Batcher().Add(yb_op));
+  AutoFlushIfNeeded(op_size);
+  return Status::OK();
 }
 
 Status YBSession::ApplyAndFlush(YBOperationPtr yb_op) {
@@ -362,6 +541,12 @@ bool YBSession::IsInProgress(YBOperationPtr yb_op) const {
 }
 
 Status YBSession::Apply(const std::vector<YBOperationPtr>& ops) {
+  if (auto_flusher_) {
+    for (const auto& op : ops) {
+      RETURN_NOT_OK(Apply(op));
+    }
+    return Status::OK();
+  }
   auto& batcher = Batcher();
   for (const auto& op : ops) {
     RETURN_NOT_OK(batcher.Add(op));
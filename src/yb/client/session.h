@@ -22,6 +22,7 @@
 #include "yb/common/common_fwd.h"
 #include "yb/common/hybrid_time.h"
 
+#include "yb/util/async_future.h"
 #include "yb/util/async_util.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
@@ -47,6 +48,26 @@ struct NODISCARD_CLASS FlushStatus {
   CollectedErrors errors;
 };
 
+// Options of the mode that flushes buffered operations without explicit Flush calls.
+struct AutoFlushOptions {
+  // Buffered operations are flushed after their requests reach this size.
+  // It is capped by half of rpc_max_message_size. 0 disables auto flush.
+  size_t max_buffer_bytes = 0;
+
+  // Buffered operations are also flushed when the oldest of them waits for this long.
+  // Checked when operations are applied. Not initialized means no time limit.
+  MonoDelta max_buffer_delay;
+
+  // Apply blocks while this many auto flushed batches are in flight.
+  size_t max_in_flight_batches = 2;
+
+  // When target_batch_latency is initialized, flush size is adapted between min_buffer_bytes
+  // and max_buffer_bytes: it grows while batches complete faster than target_batch_latency,
+  // and shrinks when they become slower.
+  size_t min_buffer_bytes = 0;
+  MonoDelta target_batch_latency;
+};
+
 // A YBSession belongs to a specific YBClient, and represents a context in
 // which all read/write data access should take place. Within a session,
 // multiple operations may be accumulated and batched together for better
@@ -185,9 +206,20 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   // For FlushAsync, 'callback' must remain valid until it is invoked.
   void FlushAsync(FlushCallback callback);
   std::future<FlushStatus> FlushFuture();
+  // Version of FlushFuture, that allows to handle the result in a continuation, so a caller with
+  // many sessions in flight does not need a thread blocked on each of them.
+  AsyncFuture<FlushStatus> FlushAsyncFuture();
   CHECKED_STATUS Flush();
   FlushStatus FlushAndGetOpsErrors();
 
+  // Enables auto flush with specified options, or disables it when max_buffer_bytes is 0.
+  //
+  // In this mode Apply flushes buffered operations according to options, and blocks while too
+  // many batches are in flight, so it should not be called from reactor threads.
+  // Errors of auto flushed batches are accumulated, and Flush/FlushAsync report them after all
+  // auto flushed batches and the batch flushed by this call have completed.
+  void SetAutoFlush(const AutoFlushOptions& options);
+
   // Abort the unflushed or in-flight operations in the session.
   void Abort();
 
@@ -260,8 +292,17 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   friend class YBClient;
   friend class internal::Batcher;
 
+  class AutoFlusher;
+
   internal::Batcher& Batcher();
 
+  // Accounts an operation of specified size applied in auto flush mode and flushes buffered
+  // operations when it is time to do so.
+  void AutoFlushIfNeeded(size_t op_size);
+
+  // Flushes batcher_, that should not be null, as a batch tracked by auto_flusher_.
+  void StartAutoFlushedBatch();
+
   BatcherConfig batcher_config_;
 
   // Lock protecting flushed_batchers_.
@@ -288,6 +329,12 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
 
   internal::AsyncRpcMetricsPtr async_rpc_metrics_;
 
+  // Shared with the callbacks of auto flushed batches, that could outlive the session.
+  std::shared_ptr<AutoFlusher> auto_flusher_;
+  // Size of requests buffered in the current batcher and time the first of them was applied.
+  size_t buffered_bytes_ = 0;
+  CoarseTimePoint buffer_start_;
+
   DISALLOW_COPY_AND_ASSIGN(YBSession);
 };
 
@@ -45,6 +45,7 @@ DECLARE_bool(ycql_consistent_transactional_paging);
 DECLARE_int32(TEST_inject_load_transaction_delay_ms);
 DECLARE_int32(TEST_inject_status_resolver_delay_ms);
 DECLARE_int32(log_min_seconds_to_retain);
+DECLARE_int32(transaction_conflict_max_wait_ms);
 DECLARE_int32(txn_max_apply_batch_records);
 DECLARE_int64(transaction_rpc_timeout_ms);
 DECLARE_uint64(max_clock_skew_usec);
@@ -943,6 +944,44 @@ TEST_F_EX(SnapshotTxnTest, ResolveIntents, SingleTabletSnapshotTxnTest) {
   }
 }
 
+// Lower priority write should wait for the conflicting higher priority transaction, instead of
+// failing right away.
+TEST_F_EX(SnapshotTxnTest, WaitForHigherPriority, SingleTabletSnapshotTxnTest) {
+  const auto kMaxWait = 3s * kTimeMultiplier;
+  FLAGS_transaction_conflict_max_wait_ms = ToMilliseconds(kMaxWait);
+
+  for (bool commit_blocker : {true, false}) {
+    SCOPED_TRACE(Format("Commit blocker: $0", commit_blocker));
+    const int32_t key = commit_blocker ? 1 : 2;
+    auto blocker = CreateTransaction();
+    blocker->SetPriority(std::numeric_limits<uint64_t>::max());
+    ASSERT_OK(WriteRow(CreateSession(blocker), key, 1));
+
+    auto waiter = CreateTransaction();
+    waiter->SetPriority(1);
+    auto waiter_session = CreateSession(waiter);
+    ASSERT_OK(WriteRow(waiter_session, key, 2, WriteOpType::INSERT, Flush::kFalse));
+    auto start = CoarseMonoClock::now();
+    auto flush_future = waiter_session->FlushFuture();
+
+    if (commit_blocker) {
+      // The write waits while the blocker is running, and succeeds after it is committed.
+      ASSERT_EQ(flush_future.wait_for(kMaxWait / 3), std::future_status::timeout);
+      ASSERT_OK(blocker->CommitFuture().get());
+      ASSERT_OK(flush_future.get().status);
+      ASSERT_LT(CoarseMonoClock::now() - start, kMaxWait);
+      ASSERT_OK(waiter->CommitFuture().get());
+      ASSERT_EQ(2, ASSERT_RESULT(SelectRow(CreateSession(), key)));
+    } else {
+      // The write fails with conflict when the blocker is still running after the max wait time.
+      ASSERT_NOK(flush_future.get().status);
+      ASSERT_GE(CoarseMonoClock::now() - start, kMaxWait);
+      ASSERT_OK(blocker->CommitFuture().get());
+      ASSERT_EQ(1, ASSERT_RESULT(SelectRow(CreateSession(), key)));
+    }
+  }
+}
+
 TEST_F(SnapshotTxnTest, DeleteOnLoad) {
   constexpr int kTransactions = 400;
 
@@ -95,6 +95,9 @@ class TabletInvoker {
   ::yb::HostPort ProxyEndpoint() const;
   YBClient& client() const { return *client_; }
   const RemoteTabletServer& current_ts() { return *current_ts_; }
+  RemoteTabletServer* current_ts_ptr() { return current_ts_; }
+
+  bool should_use_local_node_proxy() const { return should_use_local_node_proxy_; }
   bool local_tserver_only() const { return local_tserver_only_; }
 
   bool is_consistent_prefix() const { return consistent_prefix_; }
@@ -62,6 +62,10 @@ TAG_FLAG(txn_slow_op_threshold_ms, runtime);
 DEFINE_uint64(transaction_heartbeat_usec, 500000 * yb::kTimeMultiplier,
               "Interval of transaction heartbeat in usec.");
 DEFINE_bool(transaction_disable_heartbeat_in_tests, false, "Disable heartbeat during test.");
+DEFINE_bool(transaction_heartbeat_batching, false,
+            "Send heartbeats of transactions that share a status tablet in a single RPC.");
+TAG_FLAG(transaction_heartbeat_batching, advanced);
+TAG_FLAG(transaction_heartbeat_batching, runtime);
 DECLARE_uint64(max_clock_skew_usec);
 
 DEFINE_test_flag(int32, transaction_inject_flushed_delay_ms, 0,
@@ -945,6 +949,17 @@ class YBTransaction::Impl final {
       status_tablet = status_tablet_;
     }
 
+    if (status == TransactionStatus::PENDING &&
+        GetAtomicFlag(&FLAGS_transaction_heartbeat_batching)) {
+      manager_->SendHeartbeat(
+          status_tablet, metadata_.transaction_id, CoarseMonoClock::now() + timeout,
+          [this, transaction](const Status& heartbeat_status) {
+            HeartbeatDone(heartbeat_status, /* request= */ {}, /* response= */ {},
+                          TransactionStatus::PENDING, transaction);
+          });
+      return;
+    }
+
     req.set_tablet_id(status_tablet->tablet_id());
     req.set_propagated_hybrid_time(manager_->Now().ToUint64());
     auto& state = *req.mutable_state();
@@ -1241,6 +1256,13 @@ std::future<Status> YBTransaction::CommitFuture(
   });
 }
 
+AsyncFuture<Status> YBTransaction::CommitAsyncFuture(
+    CoarseTimePoint deadline, SealOnly seal_only) {
+  return MakeAsyncFuture<Status>([this, deadline, seal_only](auto callback) {
+    impl_->Commit(AdjustDeadline(deadline), seal_only, std::move(callback));
+  });
+}
+
 void YBTransaction::Abort(CoarseTimePoint deadline) {
   impl_->Abort(AdjustDeadline(deadline));
 }
@@ -28,6 +28,7 @@
 
 #include "yb/client/client_fwd.h"
 
+#include "yb/util/async_future.h"
 #include "yb/util/async_util.h"
 #include "yb/util/status.h"
 
@@ -141,6 +142,10 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
   std::future<Status> CommitFuture(
       CoarseTimePoint deadline = CoarseTimePoint(), SealOnly seal_only = SealOnly::kFalse);
 
+  // Same as CommitFuture, but result could be consumed by a continuation.
+  AsyncFuture<Status> CommitAsyncFuture(
+      CoarseTimePoint deadline = CoarseTimePoint(), SealOnly seal_only = SealOnly::kFalse);
+
   // Aborts this transaction.
   void Abort(CoarseTimePoint deadline = CoarseTimePoint());
 
@@ -15,25 +15,43 @@
 
 #include "yb/client/transaction_manager.h"
 
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
 #include "yb/rpc/rpc.h"
 #include "yb/rpc/thread_pool.h"
 #include "yb/rpc/tasks_pool.h"
 
+#include "yb/util/atomic.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
 #include "yb/util/thread_restrictions.h"
 
 #include "yb/client/client.h"
+#include "yb/client/meta_cache.h"
+#include "yb/client/transaction_rpc.h"
 
 #include "yb/common/transaction.h"
+#include "yb/common/wire_protocol.h"
 
+#include "yb/master/master.pb.h"
 #include "yb/master/master_defaults.h"
 
+#include "yb/tserver/tserver_service.pb.h"
+
 DEFINE_uint64(transaction_manager_workers_limit, 50,
               "Max number of workers used by transaction manager");
 
 DEFINE_uint64(transaction_manager_queue_limit, 500,
               "Max number of tasks used by transaction manager");
 
+DEFINE_bool(transaction_status_tablet_prefer_local_region, false,
+            "When there is no transaction status tablet led by the local tablet server, pick "
+            "one whose leader is in the same cloud and region as the client.");
+TAG_FLAG(transaction_status_tablet_prefer_local_region, advanced);
+TAG_FLAG(transaction_status_tablet_prefer_local_region, runtime);
+
 namespace yb {
 namespace client {
 
@@ -48,6 +66,7 @@ const YBTableName kTransactionTableName(
 YB_DEFINE_ENUM(TransactionTableStatus, (kExists)(kUpdating)(kResolved));
 
 void InvokeCallback(const LocalTabletFilter& filter, const std::vector<TabletId>& tablets,
+                    const std::vector<TabletId>& local_region_tablets,
                     const PickStatusTabletCallback& callback) {
   if (filter) {
     std::vector<const TabletId*> ids;
@@ -62,13 +81,46 @@ void InvokeCallback(const LocalTabletFilter& filter, const std::vector<TabletId>
     }
     YB_LOG_EVERY_N_SECS(WARNING, 1) << "No local transaction status tablet";
   }
+  if (!local_region_tablets.empty() &&
+      GetAtomicFlag(&FLAGS_transaction_status_tablet_prefer_local_region)) {
+    callback(RandomElement(local_region_tablets));
+    return;
+  }
   callback(RandomElement(tablets));
 }
 
+bool SameRegion(const CloudInfoPB& lhs, const CloudInfoPB& rhs) {
+  return lhs.placement_cloud() == rhs.placement_cloud() &&
+         lhs.placement_region() == rhs.placement_region();
+}
+
+// Returns tablets whose leader is in the same region as the client.
+std::vector<TabletId> LocalRegionTablets(
+    const CloudInfoPB& cloud_info, const std::vector<master::TabletLocationsPB>& locations) {
+  std::vector<TabletId> result;
+  if (!cloud_info.has_placement_region()) {
+    return result;
+  }
+  for (const auto& tablet : locations) {
+    for (const auto& replica : tablet.replicas()) {
+      if (replica.role() == consensus::RaftPeerPB::LEADER) {
+        if (SameRegion(replica.ts_info().cloud_info(), cloud_info)) {
+          result.push_back(tablet.tablet_id());
+        }
+        break;
+      }
+    }
+  }
+  return result;
+}
+
 struct TransactionTableState {
   LocalTabletFilter local_tablet_filter;
   std::atomic<TransactionTableStatus> status{TransactionTableStatus::kExists};
   std::vector<TabletId> tablets;
+  // Tablets whose leader was in the client region when the tablets were resolved.
+  // Leaders could move later, so it is only a hint.
+  std::vector<TabletId> local_region_tablets;
 };
 
 // Picks status tablet for transaction.
@@ -83,21 +135,24 @@ class PickStatusTabletTask {
 
   void Run() {
     // TODO(dtxn) async
-    auto tablets_result = GetTransactionTableTablets();
+    std::vector<master::TabletLocationsPB> locations;
+    auto tablets_result = GetTransactionTableTablets(&locations);
     if (!tablets_result) {
       VLOG(1) << "Failed to get tablets of txn status table: " << tablets_result.status();
       callback_(tablets_result.status());
       return;
     }
     const auto tablets = std::move(*tablets_result);
+    const auto local_region_tablets = LocalRegionTablets(client_->cloud_info(), locations);
     auto expected = TransactionTableStatus::kExists;
     if (table_state_->status.compare_exchange_strong(
         expected, TransactionTableStatus::kUpdating, std::memory_order_acq_rel)) {
       table_state_->tablets = tablets;
+      table_state_->local_region_tablets = local_region_tablets;
       table_state_->status.store(TransactionTableStatus::kResolved, std::memory_order_release);
     }
 
-    InvokeCallback(table_state_->local_tablet_filter, tablets, callback_);
+    InvokeCallback(table_state_->local_tablet_filter, tablets, local_region_tablets, callback_);
   }
 
   void Done(const Status& status) {
@@ -109,24 +164,28 @@ class PickStatusTabletTask {
   }
 
  private:
-  Result<std::vector<TabletId>> GetTransactionTableTablets() {
+  Result<std::vector<TabletId>> GetTransactionTableTablets(
+      std::vector<master::TabletLocationsPB>* locations) {
     std::vector<TabletId> tablets;
-    if (!FetchTransactionTableTablets(&tablets).ok()) {
+    if (!FetchTransactionTableTablets(&tablets, locations).ok()) {
       // Tablets for txn status table are not ready yet.
       // Wait for table creation completion and try again.
       RETURN_NOT_OK(client_->WaitForCreateTableToFinish(kTransactionTableName));
-      RETURN_NOT_OK(FetchTransactionTableTablets(&tablets));
+      tablets.clear();
+      locations->clear();
+      RETURN_NOT_OK(FetchTransactionTableTablets(&tablets, locations));
     }
     SCHECK(!tablets.empty(), IllegalState, Format("No tablets in table $0", kTransactionTableName));
     return std::move(tablets);
   }
 
-  CHECKED_STATUS FetchTransactionTableTablets(std::vector<TabletId>* tablets) {
+  CHECKED_STATUS FetchTransactionTableTablets(
+      std::vector<TabletId>* tablets, std::vector<master::TabletLocationsPB>* locations) {
     return client_->GetTablets(kTransactionTableName,
                                0 /* max_tablets */,
                                tablets,
                                nullptr /* ranges */,
-                               nullptr /* locations */,
+                               locations,
                                RequireTabletsRunning::kTrue);
   }
 
@@ -143,7 +202,8 @@ class InvokeCallbackTask {
   }
 
   void Run() {
-    InvokeCallback(table_state_->local_tablet_filter, table_state_->tablets, callback_);
+    InvokeCallback(table_state_->local_tablet_filter, table_state_->tablets,
+                   table_state_->local_region_tablets, callback_);
   }
 
   void Done(const Status& status) {
@@ -182,7 +242,8 @@ class TransactionManager::Impl {
   void PickStatusTablet(PickStatusTabletCallback callback) {
     if (table_state_.status.load(std::memory_order_acquire) == TransactionTableStatus::kResolved) {
       if (ThreadRestrictions::IsWaitAllowed()) {
-        InvokeCallback(table_state_.local_tablet_filter, table_state_.tablets, callback);
+        InvokeCallback(table_state_.local_tablet_filter, table_state_.tablets,
+                       table_state_.local_region_tablets, callback);
       } else if (!invoke_callback_tasks_.Enqueue(&thread_pool_, &table_state_, callback)) {
         callback(STATUS_FORMAT(ServiceUnavailable,
                               "Invoke callback queue overflow, number of tasks: $0",
@@ -219,12 +280,115 @@ class TransactionManager::Impl {
     clock_->Update(time);
   }
 
+  void SendHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                     const TransactionId& transaction_id,
+                     CoarseTimePoint deadline,
+                     StdStatusCallback callback) {
+    std::vector<QueuedHeartbeat> heartbeats;
+    {
+      std::lock_guard<std::mutex> lock(heartbeats_mutex_);
+      auto& batch = heartbeat_batches_[status_tablet->tablet_id()];
+      batch.queue.push_back(QueuedHeartbeat{transaction_id, deadline, std::move(callback)});
+      if (batch.in_flight) {
+        return;
+      }
+      batch.in_flight = true;
+      heartbeats.swap(batch.queue);
+    }
+    SendHeartbeats(status_tablet, std::move(heartbeats));
+  }
+
   void Shutdown() {
     rpcs_.Shutdown();
     thread_pool_.Shutdown();
   }
 
  private:
+  struct QueuedHeartbeat {
+    TransactionId transaction_id;
+    CoarseTimePoint deadline;
+    StdStatusCallback callback;
+  };
+
+  struct HeartbeatBatch {
+    std::vector<QueuedHeartbeat> queue;
+    bool in_flight = false;
+  };
+
+  void SendHeartbeats(const internal::RemoteTabletPtr& status_tablet,
+                      std::vector<QueuedHeartbeat> heartbeats) {
+    auto handle = rpcs_.Prepare();
+    if (handle == rpcs_.InvalidHandle()) {
+      {
+        std::lock_guard<std::mutex> lock(heartbeats_mutex_);
+        heartbeat_batches_.erase(status_tablet->tablet_id());
+      }
+      for (const auto& heartbeat : heartbeats) {
+        heartbeat.callback(STATUS(Aborted, "Transaction manager is shutting down"));
+      }
+      return;
+    }
+
+    tserver::UpdateTransactionsRequestPB req;
+    req.set_tablet_id(status_tablet->tablet_id());
+    req.set_propagated_hybrid_time(Now().ToUint64());
+    // The batch is sent with the earliest deadline, so no heartbeat waits longer than requested.
+    auto deadline = CoarseTimePoint::max();
+    for (const auto& heartbeat : heartbeats) {
+      auto& state = *req.add_states();
+      state.set_transaction_id(heartbeat.transaction_id.data(), heartbeat.transaction_id.size());
+      state.set_status(TransactionStatus::PENDING);
+      deadline = std::min(deadline, heartbeat.deadline);
+    }
+
+    auto shared_heartbeats = std::make_shared<std::vector<QueuedHeartbeat>>(
+        std::move(heartbeats));
+    *handle = UpdateTransactions(
+        deadline,
+        status_tablet.get(),
+        client_,
+        &req,
+        [this, handle, status_tablet, shared_heartbeats](
+            const Status& status, const tserver::UpdateTransactionsResponsePB& resp) {
+          client::UpdateClock(resp, this);
+          rpcs_.Unregister(handle);
+          HeartbeatsDone(status, resp, status_tablet, *shared_heartbeats);
+        });
+    (**handle).SendRpc();
+  }
+
+  void HeartbeatsDone(const Status& status,
+                      const tserver::UpdateTransactionsResponsePB& resp,
+                      const internal::RemoteTabletPtr& status_tablet,
+                      const std::vector<QueuedHeartbeat>& heartbeats) {
+    for (size_t i = 0; i != heartbeats.size(); ++i) {
+      if (!status.ok()) {
+        heartbeats[i].callback(status);
+      } else if (static_cast<int>(i) >= resp.transaction_status_size()) {
+        heartbeats[i].callback(STATUS_FORMAT(
+            IllegalState, "Wrong number of statuses in response: $0, expected: $1",
+            resp.transaction_status_size(), heartbeats.size()));
+      } else {
+        heartbeats[i].callback(StatusFromPB(resp.transaction_status(i)));
+      }
+    }
+
+    std::vector<QueuedHeartbeat> next_heartbeats;
+    {
+      std::lock_guard<std::mutex> lock(heartbeats_mutex_);
+      auto it = heartbeat_batches_.find(status_tablet->tablet_id());
+      if (it == heartbeat_batches_.end()) {
+        return;
+      }
+      if (it->second.queue.empty()) {
+        heartbeat_batches_.erase(it);
+        return;
+      }
+      next_heartbeats.swap(it->second.queue);
+    }
+    SendHeartbeats(status_tablet, std::move(next_heartbeats));
+  }
+
   YBClient* const client_;
   scoped_refptr<ClockBase> clock_;
   TransactionTableState table_state_;
@@ -233,6 +397,9 @@ class TransactionManager::Impl {
   yb::rpc::TasksPool<PickStatusTabletTask> tasks_pool_;
   yb::rpc::TasksPool<InvokeCallbackTask> invoke_callback_tasks_;
   yb::rpc::Rpcs rpcs_;
+
+  std::mutex heartbeats_mutex_;
+  std::unordered_map<TabletId, HeartbeatBatch> heartbeat_batches_ GUARDED_BY(heartbeats_mutex_);
 };
 
 TransactionManager::TransactionManager(
@@ -246,6 +413,12 @@ void TransactionManager::PickStatusTablet(PickStatusTabletCallback callback) {
   impl_->PickStatusTablet(std::move(callback));
 }
 
+void TransactionManager::SendHeartbeat(
+    const internal::RemoteTabletPtr& status_tablet, const TransactionId& transaction_id,
+    CoarseTimePoint deadline, StdStatusCallback callback) {
+  impl_->SendHeartbeat(status_tablet, transaction_id, deadline, std::move(callback));
+}
+
 YBClient* TransactionManager::client() const {
   return impl_->client();
 }
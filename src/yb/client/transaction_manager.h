@@ -23,10 +23,12 @@
 
 #include "yb/common/clock.h"
 #include "yb/common/hybrid_time.h"
+#include "yb/common/transaction.h"
 
 #include "yb/rpc/rpc_fwd.h"
 
 #include "yb/util/result.h"
+#include "yb/util/status_callback.h"
 
 namespace yb {
 namespace client {
@@ -45,6 +47,15 @@ class TransactionManager {
 
   void PickStatusTablet(PickStatusTabletCallback callback);
 
+  // Sends PENDING heartbeat of the specified transaction to its status tablet.
+  // Heartbeats for the same status tablet are sent in a single UpdateTransactions RPC, at most
+  // one such RPC is in flight per status tablet. Heartbeats that arrive while it is in flight
+  // are sent after it completes.
+  void SendHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                     const TransactionId& transaction_id,
+                     CoarseTimePoint deadline,
+                     StdStatusCallback callback);
+
   rpc::Rpcs& rpcs();
   YBClient* client() const;
 
@@ -133,8 +133,9 @@ const RedisResponsePB& YBRedisOp::response() const {
 }
 
 OpGroup YBRedisReadOp::group() {
-  return FLAGS_redis_allow_reads_from_followers ? OpGroup::kConsistentPrefixRead
-                                                : OpGroup::kLeaderRead;
+  return FLAGS_redis_allow_reads_from_followers ||
+         yb_consistency_level_ == YBConsistencyLevel::CONSISTENT_PREFIX
+      ? OpGroup::kConsistentPrefixRead : OpGroup::kLeaderRead;
 }
 
 // YBRedisWriteOp -----------------------------------------------------------------
@@ -249,6 +250,10 @@ std::unique_ptr<YBqlWriteOp> YBqlWriteOp::NewDelete(const std::shared_ptr<YBTabl
   return NewYBqlWriteOp(table, QLWriteRequestPB::QL_STMT_DELETE);
 }
 
+size_t YBqlWriteOp::space_used_by_request() const {
+  return ql_write_request_->ByteSizeLong();
+}
+
 std::string YBqlWriteOp::ToString() const {
   return "QL_WRITE " + ql_write_request_->ShortDebugString();
 }
@@ -392,6 +397,10 @@ std::unique_ptr<YBqlReadOp> YBqlReadOp::NewSelect(const shared_ptr<YBTable>& tab
   return op;
 }
 
+size_t YBqlReadOp::space_used_by_request() const {
+  return ql_read_request_->ByteSizeLong();
+}
+
 std::string YBqlReadOp::ToString() const {
   return "QL_READ " + ql_read_request_->DebugString();
 }
@@ -650,6 +659,10 @@ std::unique_ptr<YBPgsqlWriteOp> YBPgsqlWriteOp::NewTruncateColocated(
   return NewYBPgsqlWriteOp(table, PgsqlWriteRequestPB::PGSQL_TRUNCATE_COLOCATED);
 }
 
+size_t YBPgsqlWriteOp::space_used_by_request() const {
+  return write_request_->ByteSizeLong();
+}
+
 std::string YBPgsqlWriteOp::ToString() const {
   return "PGSQL_WRITE " + write_request_->ShortDebugString() +
          ", response: " + response().ShortDebugString();
@@ -717,6 +730,10 @@ std::unique_ptr<YBPgsqlReadOp> YBPgsqlReadOp::DeepCopy() {
   return op;
 }
 
+size_t YBPgsqlReadOp::space_used_by_request() const {
+  return read_request_->ByteSizeLong();
+}
+
 std::string YBPgsqlReadOp::ToString() const {
   return "PGSQL_READ " + read_request_->DebugString();
 }
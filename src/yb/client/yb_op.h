@@ -119,6 +119,9 @@ class YBOperation {
 
   virtual void SetHashCode(uint16_t hash_code) = 0;
 
+  // Approximate size of the request, used to bound memory and the size of flushed batches.
+  virtual size_t space_used_by_request() const = 0;
+
   const scoped_refptr<internal::RemoteTablet>& tablet() const {
     return tablet_;
   }
@@ -182,7 +185,6 @@ class YBRedisOp : public YBOperation {
   explicit YBRedisOp(const std::shared_ptr<YBTable>& table);
 
   bool has_response() { return redis_response_ ? true : false; }
-  virtual size_t space_used_by_request() const = 0;
 
   const RedisResponsePB& response() const;
 
@@ -258,6 +260,14 @@ class YBRedisReadOp : public YBRedisOp {
 
   CHECKED_STATUS GetPartitionKey(std::string* partition_key) const override;
 
+  const YBConsistencyLevel yb_consistency_level() {
+    return yb_consistency_level_;
+  }
+
+  void set_yb_consistency_level(const YBConsistencyLevel yb_consistency_level) {
+    yb_consistency_level_ = yb_consistency_level;
+  }
+
  protected:
   Type type() const override { return REDIS_READ; }
   OpGroup group() override;
@@ -265,6 +275,7 @@ class YBRedisReadOp : public YBRedisOp {
  private:
   friend class YBTable;
   std::unique_ptr<RedisReadRequestPB> redis_read_request_;
+  YBConsistencyLevel yb_consistency_level_ = YBConsistencyLevel::STRONG;
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -303,6 +314,8 @@ class YBqlWriteOp : public YBqlOp {
 
   QLWriteRequestPB* mutable_request() { return ql_write_request_.get(); }
 
+  size_t space_used_by_request() const override;
+
   std::string ToString() const override;
 
   bool read_only() const override { return false; };
@@ -367,6 +380,8 @@ class YBqlReadOp : public YBqlOp {
 
   QLReadRequestPB* mutable_request() { return ql_read_request_.get(); }
 
+  size_t space_used_by_request() const override;
+
   std::string ToString() const override;
 
   bool read_only() const override { return true; };
@@ -470,6 +485,8 @@ class YBPgsqlWriteOp : public YBPgsqlOp {
 
   PgsqlWriteRequestPB* mutable_request() { return write_request_.get(); }
 
+  size_t space_used_by_request() const override;
+
   std::string ToString() const override;
 
   bool read_only() const override { return false; };
@@ -523,6 +540,8 @@ class YBPgsqlReadOp : public YBPgsqlOp {
 
   PgsqlReadRequestPB* mutable_request() { return read_request_.get(); }
 
+  size_t space_used_by_request() const override;
+
   std::string ToString() const override;
 
   bool read_only() const override { return true; };
@@ -15,6 +15,7 @@
 #include <rapidjson/prettywriter.h>
 
 #include "yb/common/jsonb.h"
+#include "yb/common/ql_value.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 
@@ -151,5 +152,39 @@ TEST(JsonbTest, TestArrays) {
   VerifyArray(document);
 }
 
+TEST(JsonbTest, TestApplyJsonbOperators) {
+  std::string json = "{";
+  for (int i = 0; i < 100; ++i) {
+    json += Format(R"#("k$0" : { "n" : $0, "s" : "v$0" }, )#", i);
+  }
+  json += R"#("a" : [10, 20, 30]})#";
+  Jsonb jsonb;
+  ASSERT_OK(jsonb.FromString(json));
+
+  auto apply = [&jsonb](std::initializer_list<std::string> keys, JsonOperatorPB last_operator) {
+    QLJsonColumnOperationsPB json_ops;
+    for (const auto& key : keys) {
+      auto* op = json_ops.add_json_operations();
+      op->set_json_operator(JsonOperatorPB::JSON_OBJECT);
+      op->mutable_operand()->mutable_value()->set_string_value(key);
+    }
+    json_ops.mutable_json_operations(json_ops.json_operations_size() - 1)->set_json_operator(
+        last_operator);
+    QLValue result;
+    EXPECT_OK(Jsonb::ApplyJsonbOperators(jsonb.SerializedJsonb(), json_ops, &result));
+    return result;
+  };
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(Format("v$0", i), apply({Format("k$0", i), "s"}, JsonOperatorPB::JSON_TEXT)
+                                    .string_value());
+    ASSERT_EQ(std::to_string(i), apply({Format("k$0", i), "n"}, JsonOperatorPB::JSON_TEXT)
+                                     .string_value());
+  }
+  ASSERT_TRUE(apply({"k100"}, JsonOperatorPB::JSON_TEXT).IsNull());
+  ASSERT_TRUE(apply({"k1", "x"}, JsonOperatorPB::JSON_OBJECT).IsNull());
+  ASSERT_EQ("[10,20,30]", apply({"a"}, JsonOperatorPB::JSON_TEXT).string_value());
+}
+
 }  // namespace common
 }  // namespace yb
@@ -691,7 +691,8 @@ Status Jsonb::ApplyJsonbOperatorToObject(const Slice& jsonb, const QLJsonOperati
   size_t metadata_begin_offset = sizeof(jsonb_header);
   size_t data_begin_offset = ComputeDataOffset(num_kv_pairs, kJBObject);
 
-  // Binary search to find the key.
+  // Binary search to find the key. Keys are sorted in std::string order, which is the byte-wise
+  // order used by Slice::compare, so keys are compared in place without copying them.
   int64_t low = 0, high = num_kv_pairs - 1;
   auto search_key_slice = Slice(search_key);
   while (low <= high) {
@@ -699,12 +700,12 @@ Status Jsonb::ApplyJsonbOperatorToObject(const Slice& jsonb, const QLJsonOperati
     Slice mid_key;
     RETURN_NOT_OK(GetObjectKey(mid, jsonb, metadata_begin_offset, data_begin_offset, &mid_key));
 
-    if (mid_key == search_key_slice) {
-      RETURN_NOT_OK(GetObjectValue(mid, jsonb, sizeof(jsonb_header),
-                                   ComputeDataOffset(num_kv_pairs, kJBObject), num_kv_pairs,
-                                   result, element_metadata));
+    const int cmp = mid_key.compare(search_key_slice);
+    if (cmp == 0) {
+      RETURN_NOT_OK(GetObjectValue(mid, jsonb, metadata_begin_offset, data_begin_offset,
+                                   num_kv_pairs, result, element_metadata));
       return Status::OK();
-    } else if (mid_key.ToBuffer() > search_key) {
+    } else if (cmp > 0) {
       high = mid - 1;
     } else {
       low = mid + 1;
@@ -714,10 +715,15 @@ Status Jsonb::ApplyJsonbOperatorToObject(const Slice& jsonb, const QLJsonOperati
 }
 
 Status Jsonb::ApplyJsonbOperators(const QLJsonColumnOperationsPB& json_ops, QLValue* result) const {
+  return ApplyJsonbOperators(serialized_jsonb_, json_ops, result);
+}
+
+Status Jsonb::ApplyJsonbOperators(const Slice& jsonb, const QLJsonColumnOperationsPB& json_ops,
+                                  QLValue* result) {
   const int num_ops = json_ops.json_operations().size();
 
   Slice jsonop_result;
-  Slice operand(serialized_jsonb_);
+  Slice operand(jsonb);
   JEntry element_metadata;
   for (int i = 0; i < num_ops; i++) {
     const QLJsonOperationPB &op = json_ops.json_operations().Get(i);
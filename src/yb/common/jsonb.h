@@ -86,6 +86,12 @@ class Jsonb {
   CHECKED_STATUS ApplyJsonbOperators(const QLJsonColumnOperationsPB& json_ops,
                                      QLValue* result) const;
 
+  // Same as above, but works directly on serialized jsonb, so the caller doesn't have to copy it
+  // into a Jsonb object.
+  static CHECKED_STATUS ApplyJsonbOperators(const Slice& jsonb,
+                                            const QLJsonColumnOperationsPB& json_ops,
+                                            QLValue* result);
+
   const std::string& SerializedJsonb() const;
 
   // Use with extreme care since this destroys the internal state of the object. The only purpose
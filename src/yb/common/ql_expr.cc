@@ -46,9 +46,9 @@ CHECKED_STATUS QLExprExecutor::EvalExpr(const QLExpressionPB& ql_expr,
       if (temp.IsNull()) {
         result_writer.SetNull();
       } else {
-        common::Jsonb jsonb;
-        temp.MoveToJsonb(&jsonb);
-        RETURN_NOT_OK(jsonb.ApplyJsonbOperators(json_ops, &result_writer.NewValue()));
+        // Apply the operators to the column value in place instead of copying it into a Jsonb.
+        RETURN_NOT_OK(common::Jsonb::ApplyJsonbOperators(
+            temp.Value().jsonb_value(), json_ops, &result_writer.NewValue()));
       }
       break;
     }
@@ -55,4 +55,8 @@ size_t QLResultSet::rsrow_count() const {
   return CQLDecodeLength(rows_data_->data());
 }
 
+size_t QLResultSet::rows_data_size() const {
+  return rows_data_->size();
+}
+
 } // namespace yb
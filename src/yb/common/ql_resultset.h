@@ -78,6 +78,9 @@ class QLResultSet {
   // Row count
   size_t rsrow_count() const;
 
+  // Size of the serialized rows data, including the row count.
+  size_t rows_data_size() const;
+
  private:
   const QLRSRowDesc* rsrow_desc_ = nullptr;
   faststring* rows_data_ = nullptr;
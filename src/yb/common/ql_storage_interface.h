@@ -14,6 +14,8 @@
 #ifndef YB_COMMON_QL_STORAGE_INTERFACE_H
 #define YB_COMMON_QL_STORAGE_INTERFACE_H
 
+#include <vector>
+
 #include <boost/optional.hpp>
 
 #include "yb/common/hybrid_time.h"
@@ -23,6 +25,8 @@
 
 #include "yb/docdb/docdb_fwd.h"
 
+#include "yb/util/slice.h"
+
 namespace yb {
 namespace common {
 
@@ -100,6 +104,17 @@ class YQLStorageIf {
                                      const ReadHybridTime& read_time,
                                      const QLValuePB& ybctid,
                                      common::YQLRowwiseIteratorIf::UniPtr* iter) const = 0;
+
+  // Create iterator for querying a batch of ybctids, that should be sorted and unique.
+  // Rows are returned in the same order, ybctids that are not associated with any row are skipped.
+  virtual CHECKED_STATUS GetIterator(uint64 stmt_id,
+                                     const Schema& projection,
+                                     const Schema& schema,
+                                     const TransactionOperationContextOpt& txn_op_context,
+                                     CoarseTimePoint deadline,
+                                     const ReadHybridTime& read_time,
+                                     const std::vector<Slice>& ybctids,
+                                     common::YQLRowwiseIteratorIf::UniPtr* iter) const = 0;
 };
 
 }  // namespace common
@@ -97,6 +97,9 @@ void TableProperties::ToTablePropertiesPB(TablePropertiesPB *pb) const {
   }
   pb->set_is_ysql_catalog_table(is_ysql_catalog_table_);
   pb->set_retain_delete_markers(retain_delete_markers_);
+  if (HasCompactionTimeWindow()) {
+    pb->set_compaction_time_window_seconds(*compaction_time_window_seconds_);
+  }
 }
 
 TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB& pb) {
@@ -128,6 +131,9 @@ TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB&
   if (pb.has_retain_delete_markers()) {
     table_properties.SetRetainDeleteMarkers(pb.retain_delete_markers());
   }
+  if (pb.has_compaction_time_window_seconds()) {
+    table_properties.SetCompactionTimeWindowSeconds(pb.compaction_time_window_seconds());
+  }
   return table_properties;
 }
 
@@ -156,6 +162,9 @@ void TableProperties::AlterFromTablePropertiesPB(const TablePropertiesPB& pb) {
   if (pb.has_retain_delete_markers()) {
     SetRetainDeleteMarkers(pb.retain_delete_markers());
   }
+  if (pb.has_compaction_time_window_seconds()) {
+    SetCompactionTimeWindowSeconds(pb.compaction_time_window_seconds());
+  }
 }
 
 void TableProperties::Reset() {
@@ -168,6 +177,7 @@ void TableProperties::Reset() {
   num_tablets_ = 0;
   is_ysql_catalog_table_ = false;
   retain_delete_markers_ = false;
+  compaction_time_window_seconds_ = boost::none;
 }
 
 string TableProperties::ToString() const {
@@ -180,6 +190,9 @@ string TableProperties::ToString() const {
   if (HasCopartitionTableId()) {
     result += Format("copartition_table_id: $0 ", copartition_table_id_);
   }
+  if (compaction_time_window_seconds() != 0) {
+    result += Format("compaction_time_window_seconds: $0 ", compaction_time_window_seconds());
+  }
   return result + Format(
       "consistency_level: $0 is_ysql_catalog_table: $1 }",
       consistency_level_,
@@ -420,6 +420,7 @@ class TableProperties {
     // Ignoring num_tablets_.
     // Ignoring retain_delete_markers_.
     // Ignoring wal_retention_secs_.
+    // Ignoring compaction_time_window_seconds_.
   }
 
   bool operator!=(const TableProperties& other) const {
@@ -451,6 +452,7 @@ class TableProperties {
     // Ignoring contain_counters_.
     // Ignoring retain_delete_markers_.
     // Ignoring wal_retention_secs_.
+    // Ignoring compaction_time_window_seconds_.
     return true;
   }
 
@@ -538,6 +540,19 @@ class TableProperties {
     retain_delete_markers_ = retain_delete_markers;
   }
 
+  bool HasCompactionTimeWindow() const {
+    return compaction_time_window_seconds_.is_initialized();
+  }
+
+  // Returns 0 when SST files are not grouped by time windows.
+  uint64_t compaction_time_window_seconds() const {
+    return compaction_time_window_seconds_.get_value_or(0);
+  }
+
+  void SetCompactionTimeWindowSeconds(uint64_t compaction_time_window_seconds) {
+    compaction_time_window_seconds_ = compaction_time_window_seconds;
+  }
+
   void ToTablePropertiesPB(TablePropertiesPB *pb) const;
 
   static TableProperties FromTablePropertiesPB(const TablePropertiesPB& pb);
@@ -564,6 +579,8 @@ class TableProperties {
   bool use_mangled_column_name_ = false;
   int num_tablets_ = 0;
   bool is_ysql_catalog_table_ = false;
+  // Set only when the compaction strategy was specified, so ALTER of other properties keeps it.
+  boost::optional<uint64_t> compaction_time_window_seconds_;
 };
 
 typedef uint32_t PgTableOid;
@@ -18,6 +18,7 @@
 namespace yb {
 
 void TransactionStatusManagerMock::RequestStatusAt(const StatusRequest& request) {
+  ++num_status_requests_;
   auto it = txn_commit_time_.find(*request.id);
   if (it == txn_commit_time_.end()) {
     request.callback(STATUS_FORMAT(TryAgain, "Unknown transaction id: $0", *request.id));
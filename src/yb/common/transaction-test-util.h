@@ -70,8 +70,32 @@ class TransactionStatusManagerMock : public TransactionStatusManager {
     return tablet_id;
   }
 
+  docdb::SharedTransactionStatusCache* shared_status_cache() override {
+    return shared_status_cache_;
+  }
+
+  void set_shared_status_cache(docdb::SharedTransactionStatusCache* shared_status_cache) {
+    shared_status_cache_ = shared_status_cache;
+  }
+
+  size_t num_status_requests() const {
+    return num_status_requests_;
+  }
+
+  bool WaitForTransactionDone(
+      const TransactionId& id, CoarseTimePoint deadline,
+      TransactionWaitCallback callback) override {
+    return false;
+  }
+
+  bool ScheduleRetry(CoarseDuration delay, TransactionWaitCallback callback) override {
+    return false;
+  }
+
  private:
   std::unordered_map<TransactionId, HybridTime, TransactionIdHash> txn_commit_time_;
+  docdb::SharedTransactionStatusCache* shared_status_cache_ = nullptr;
+  size_t num_status_requests_ = 0;
 };
 
 } // namespace yb
@@ -43,6 +43,12 @@ class DB;
 
 namespace yb {
 
+namespace docdb {
+
+class SharedTransactionStatusCache;
+
+}
+
 YB_STRONGLY_TYPED_UUID(TransactionId);
 using TransactionIdSet = std::unordered_set<TransactionId, TransactionIdHash>;
 
@@ -81,6 +87,7 @@ inline std::ostream& operator<<(std::ostream& out, const TransactionStatusResult
 }
 
 typedef std::function<void(Result<TransactionStatusResult>)> TransactionStatusCallback;
+typedef std::function<void(const Status&)> TransactionWaitCallback;
 struct TransactionMetadata;
 
 YB_DEFINE_ENUM(TransactionLoadFlag, (kMustExist)(kCleanup));
@@ -143,6 +150,22 @@ class TransactionStatusManager {
 
   virtual const TabletId& tablet_id() const = 0;
 
+  // Returns tablet level cache of transaction commit times, shared by all reads of the tablet,
+  // or nullptr if there is no such cache.
+  virtual docdb::SharedTransactionStatusCache* shared_status_cache() = 0;
+
+  // Invokes callback once the specified transaction is no longer running at this tablet, i.e. its
+  // intents were applied or removed, or once deadline is reached, whichever happens first.
+  // Callback receives a non OK status when waiting was interrupted by shutdown.
+  // Returns false without invoking callback when waiting is not supported.
+  virtual bool WaitForTransactionDone(
+      const TransactionId& id, CoarseTimePoint deadline, TransactionWaitCallback callback) = 0;
+
+  // Invokes callback on a background thread after the specified delay, so the caller could retry
+  // an operation without blocking its thread. Callback receives a non OK status on shutdown.
+  // Returns false without invoking callback when it is not supported.
+  virtual bool ScheduleRetry(CoarseDuration delay, TransactionWaitCallback callback) = 0;
+
  private:
   friend class RequestScope;
 
@@ -46,7 +46,9 @@ using std::shared_ptr;
 using strings::Substitute;
 
 std::string LeaderElectionData::ToString() const {
-  return YB_STRUCT_TO_STRING(mode, originator_uuid, pending_commit, must_be_committed_opid);
+  return YB_STRUCT_TO_STRING(
+      mode, originator_uuid, pending_commit, must_be_committed_opid, relinquished_lease_term,
+      relinquished_lease_ht);
 }
 
 ConsensusBootstrapInfo::ConsensusBootstrapInfo()
@@ -135,6 +135,12 @@ struct LeaderElectionData {
 
   bool initial_election = false;
 
+  // Set when the originator stepped down in term relinquished_lease_term and does not hold the
+  // leader lease anymore. relinquished_lease_ht is its hybrid time after the step down, the
+  // hybrid time leases of the new leader should start after it.
+  int64_t relinquished_lease_term = OpId::kUnknownTerm;
+  HybridTime relinquished_lease_ht;
+
   std::string ToString() const;
 };
 
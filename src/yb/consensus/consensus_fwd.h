@@ -49,6 +49,8 @@ typedef std::vector<ConsensusRoundPtr> ConsensusRounds;
 class ConsensusServiceProxy;
 typedef std::unique_ptr<ConsensusServiceProxy> ConsensusServiceProxyPtr;
 
+class MultiRaftHeartbeatBatcher;
+
 class LeaderElection;
 typedef scoped_refptr<LeaderElection> LeaderElectionPtr;
 
@@ -49,6 +49,7 @@
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/consensus_queue.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/consensus/replicate_msgs_holder.h"
 
 #include "yb/gutil/strings/substitute.h"
@@ -83,6 +84,7 @@ DEFINE_int32(max_wait_for_processresponse_before_closing_ms,
 TAG_FLAG(max_wait_for_processresponse_before_closing_ms, advanced);
 
 DECLARE_int32(raft_heartbeat_interval_ms);
+DECLARE_bool(enable_multi_raft_heartbeat_batcher);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
                  "Fraction of the time when the leader will crash just before sending an "
@@ -302,7 +304,8 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
     request_.set_dest_uuid(peer_pb_.permanent_uuid());
   }
 
-  const bool req_has_ops = (request_.ops_size() > 0) || (commit_index_after > commit_index_before);
+  const bool req_has_ops = (request_.ops_size() > 0) || (request_.compressed_ops_size() > 0) ||
+                           (commit_index_after > commit_index_before);
 
   // If the queue is empty, check if we were told to send a status-only message (which is what
   // happens during heartbeats). If not, just return.
@@ -350,6 +353,9 @@ void Peer::ProcessResponse() {
   if (status.ok()) {
     status = controller_.thread_pool_failure();
   }
+  if (status.ok()) {
+    status = proxy_->TakeUpdateError();
+  }
   controller_.Reset();
 
   auto performing_lock = LockPerforming(std::adopt_lock);
@@ -526,10 +532,14 @@ Peer::~Peer() {
 
 void Peer::CleanRequestOps() {
   request_.mutable_ops()->ExtractSubrange(0, request_.ops().size(), nullptr /* elements */);
+  request_.clear_compressed_ops();
+  request_.clear_ops_compression();
 }
 
-RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy)
-    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)) {
+RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+                           rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache)
+    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)),
+      messenger_(messenger), proxy_cache_(proxy_cache) {
 }
 
 void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
@@ -537,10 +547,25 @@ void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
                                ConsensusResponsePB* response,
                                rpc::RpcController* controller,
                                const rpc::ResponseCallback& callback) {
+  // Only requests without ops are batched. Follower responds to ops after they are written to its
+  // log, so batching them would delay heartbeat responses of other tablets.
+  if (FLAGS_enable_multi_raft_heartbeat_batcher && request->ops().empty() &&
+      request->compressed_ops().empty() && messenger_ && proxy_cache_) {
+    if (!batcher_) {
+      batcher_ = MultiRaftHeartbeatBatcher::Get(messenger_, proxy_cache_, hostport_);
+    }
+    if (batcher_->AddRequest(*request, response, &update_error_, callback)) {
+      return;
+    }
+  }
   controller->set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
   consensus_proxy_->UpdateConsensusAsync(*request, response, controller, callback);
 }
 
+Status RpcPeerProxy::TakeUpdateError() {
+  return std::move(update_error_);
+}
+
 void RpcPeerProxy::RequestConsensusVoteAsync(const VoteRequestPB* request,
                                              VoteResponsePB* response,
                                              rpc::RpcController* controller,
@@ -579,7 +604,8 @@ RpcPeerProxyFactory::RpcPeerProxyFactory(
 PeerProxyPtr RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb) {
   auto hostport = HostPortFromPB(DesiredHostPort(peer_pb, from_));
   auto proxy = std::make_unique<ConsensusServiceProxy>(proxy_cache_, hostport);
-  return std::make_unique<RpcPeerProxy>(std::move(hostport), std::move(proxy));
+  return std::make_unique<RpcPeerProxy>(
+      std::move(hostport), std::move(proxy), messenger_, proxy_cache_);
 }
 
 RpcPeerProxyFactory::~RpcPeerProxyFactory() {}
@@ -60,6 +60,7 @@ class ThreadPoolToken;
 namespace rpc {
 class Messenger;
 class PeriodicTimer;
+class ProxyCache;
 }
 
 namespace consensus {
@@ -262,6 +263,12 @@ class PeerProxy {
                            rpc::RpcController* controller,
                            const rpc::ResponseCallback& callback) = 0;
 
+  // Returns the error of the last UpdateAsync, that is not reflected in its controller. For
+  // instance, when the request was sent as part of a batch.
+  virtual CHECKED_STATUS TakeUpdateError() {
+    return Status::OK();
+  }
+
   // Sends a RequestConsensusVote to a remote peer.
   virtual void RequestConsensusVoteAsync(const VoteRequestPB* request,
                                          VoteResponsePB* response,
@@ -312,7 +319,8 @@ class PeerProxyFactory {
 // PeerProxy implementation that does RPC calls
 class RpcPeerProxy : public PeerProxy {
  public:
-  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy);
+  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+               rpc::Messenger* messenger = nullptr, rpc::ProxyCache* proxy_cache = nullptr);
 
   virtual void UpdateAsync(const ConsensusRequestPB* request,
                            RequestTriggerMode trigger_mode,
@@ -320,6 +328,8 @@ class RpcPeerProxy : public PeerProxy {
                            rpc::RpcController* controller,
                            const rpc::ResponseCallback& callback) override;
 
+  CHECKED_STATUS TakeUpdateError() override;
+
   virtual void RequestConsensusVoteAsync(const VoteRequestPB* request,
                                          VoteResponsePB* response,
                                          rpc::RpcController* controller,
@@ -345,6 +355,14 @@ class RpcPeerProxy : public PeerProxy {
  private:
   HostPort hostport_;
   ConsensusServiceProxyPtr consensus_proxy_;
+  rpc::Messenger* const messenger_;
+  rpc::ProxyCache* const proxy_cache_;
+
+  // Batcher of heartbeats to the same server, obtained on the first batched heartbeat.
+  std::shared_ptr<MultiRaftHeartbeatBatcher> batcher_;
+
+  // Error of the batch, that carried the last update request.
+  Status update_error_;
 };
 
 // PeerProxyFactory implementation that generates RPCPeerProxies
@@ -40,6 +40,7 @@
 #include <utility>
 
 #include <boost/container/small_vector.hpp>
+#include <boost/optional.hpp>
 
 #include <gflags/gflags.h>
 
@@ -86,6 +87,13 @@ DEFINE_int32(consensus_max_batch_size_bytes, 4_MB,
 TAG_FLAG(consensus_max_batch_size_bytes, advanced);
 TAG_FLAG(consensus_max_batch_size_bytes, runtime);
 
+DEFINE_bool(enable_consensus_ops_compression, false,
+            "Send operations to followers compressed with LZ4, when followers support it. "
+            "Compressed operations are kept in the log cache, so each operation is compressed "
+            "once for all followers.");
+TAG_FLAG(enable_consensus_ops_compression, advanced);
+TAG_FLAG(enable_consensus_ops_compression, runtime);
+
 DEFINE_int32(follower_unavailable_considered_failed_sec, 900,
              "Seconds that a leader is unable to successfully heartbeat to a "
              "follower after which the follower is considered to be failed and "
@@ -117,6 +125,13 @@ DEFINE_int32(consensus_lagging_follower_threshold, 10,
 TAG_FLAG(consensus_lagging_follower_threshold, advanced);
 TAG_FLAG(consensus_lagging_follower_threshold, runtime);
 
+DEFINE_bool(remote_bootstrap_from_closest_follower, false,
+            "When a peer in another region than the leader needs remote bootstrap, use an up to "
+            "date follower from the region of the peer as the source. The leader changes the role "
+            "of such a peer after it catches up.");
+TAG_FLAG(remote_bootstrap_from_closest_follower, advanced);
+TAG_FLAG(remote_bootstrap_from_closest_follower, runtime);
+
 DEFINE_test_flag(bool, disallow_lmp_failures, false,
                  "Whether we disallow PRECEDING_ENTRY_DIDNT_MATCH failures for non new peers.");
 
@@ -124,6 +139,15 @@ namespace {
 
 constexpr const auto kMinRpcThrottleThresholdBytes = 16;
 
+bool SameRegion(const CloudInfoPB& lhs, const CloudInfoPB& rhs) {
+  return lhs.placement_cloud() == rhs.placement_cloud() &&
+         lhs.placement_region() == rhs.placement_region();
+}
+
+bool IsPreMember(RaftPeerPB::MemberType member_type) {
+  return member_type == RaftPeerPB::PRE_VOTER || member_type == RaftPeerPB::PRE_OBSERVER;
+}
+
 static bool RpcThrottleThresholdBytesValidator(const char* flagname, int32_t value) {
   if (value > 0) {
     if (value < kMinRpcThrottleThresholdBytes) {
@@ -445,6 +469,9 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
   int64_t previously_sent_index;
   uint64_t num_log_ops_to_send;
   HybridTime propagated_safe_time;
+  CompressOps compress_ops = CompressOps::kFalse;
+  // Id of the last operation sent in this request.
+  boost::optional<OpId> last_sent_op_id;
 
   // Should be before now_ht, i.e. not greater than propagated_hybrid_time.
   if (context_) {
@@ -539,6 +566,8 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     if (peer->member_type == RaftPeerPB::VOTER) {
       is_voter = true;
     }
+    compress_ops = CompressOps(
+        FLAGS_enable_consensus_ops_compression && peer->supports_ops_compression);
   }
 
   if (unreachable_time.ToSeconds() > FLAGS_follower_unavailable_considered_failed_sec) {
@@ -573,7 +602,8 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     int max_batch_size = FLAGS_consensus_max_batch_size_bytes - request->ByteSize();
     auto to_index = num_log_ops_to_send == kSendUnboundedLogOps ?
         0 : previously_sent_index + num_log_ops_to_send;
-    auto result = ReadFromLogCache(previously_sent_index, to_index, max_batch_size, uuid);
+    auto result = ReadFromLogCache(
+        previously_sent_index, to_index, max_batch_size, uuid, compress_ops);
 
     if (PREDICT_FALSE(!result.ok())) {
       if (PREDICT_TRUE(result.status().IsNotFound())) {
@@ -586,11 +616,22 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     }
 
     preceding_id = result->preceding_op;
-    // We use AddAllocated rather than copy, because we pin the log cache at the "all replicated"
-    // point. At some point we may want to allow partially loading (and not pinning) earlier
-    // messages. At that point we'll need to do something smarter here, like copy or ref-count.
-    for (const auto& msg : result->messages) {
-      request->mutable_ops()->AddAllocated(msg.get());
+    if (!result->messages.empty()) {
+      last_sent_op_id = OpId::FromPB(result->messages.back()->id());
+    }
+    if (compress_ops) {
+      // Compressed messages are copied to the request, so they don't need to be held.
+      request->set_ops_compression(OPS_COMPRESSION_LZ4);
+      for (const auto& compressed : result->compressed_messages) {
+        request->add_compressed_ops()->CopyFrom(*compressed);
+      }
+    } else {
+      // We use AddAllocated rather than copy, because we pin the log cache at the "all replicated"
+      // point. At some point we may want to allow partially loading (and not pinning) earlier
+      // messages. At that point we'll need to do something smarter here, like copy or ref-count.
+      for (const auto& msg : result->messages) {
+        request->mutable_ops()->AddAllocated(msg.get());
+      }
     }
 
     {
@@ -632,8 +673,7 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
   // We don't have to change committed_op_id when it is less than max_allowed_committed_op_id,
   // because it will have actual committed_op_id value and this operation is known to the
   // follower.
-  const auto max_allowed_committed_op_id = !request->ops().empty()
-      ? OpId::FromPB(request->ops().rbegin()->id()) : preceding_id;
+  const auto max_allowed_committed_op_id = last_sent_op_id ? *last_sent_op_id : preceding_id;
   if (max_allowed_committed_op_id.index < request->committed_op_id().index()) {
     max_allowed_committed_op_id.ToPB(request->mutable_committed_op_id());
   }
@@ -645,6 +685,9 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
           << ". From: " << request->ops(0).id().ShortDebugString() << ". To: "
           << request->ops(request->ops_size() - 1).id().ShortDebugString();
       VLOG_WITH_PREFIX_UNLOCKED(3) << "Operations: " << yb::ToString(request->ops());
+    } else if (request->compressed_ops_size() > 0) {
+      VLOG_WITH_PREFIX_UNLOCKED(2) << "Sending request with compressed operations to Peer: "
+          << uuid << ". Size: " << request->compressed_ops_size() << ". To: " << *last_sent_op_id;
     } else {
       VLOG_WITH_PREFIX_UNLOCKED(2)
           << "Sending " << (is_new ? "new " : "") << "status only request to Peer: " << uuid
@@ -658,12 +701,13 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
 Result<ReadOpsResult> PeerMessageQueue::ReadFromLogCache(int64_t after_index,
                                                          int64_t to_index,
                                                          int max_batch_size,
-                                                         const std::string& peer_uuid) {
+                                                         const std::string& peer_uuid,
+                                                         CompressOps compress_ops) {
   DCHECK_LT(FLAGS_consensus_max_batch_size_bytes + 1_KB, FLAGS_rpc_max_message_size);
 
   // We try to get the follower's next_index from our log.
   // Note this is not using "term" and needs to change
-  auto result = log_cache_.ReadOps(after_index, to_index, max_batch_size);
+  auto result = log_cache_.ReadOps(after_index, to_index, max_batch_size, compress_ops);
   if (PREDICT_FALSE(!result.ok())) {
     auto s = result.status();
     if (PREDICT_TRUE(s.IsNotFound())) {
@@ -732,6 +776,7 @@ Result<ReadOpsResult> PeerMessageQueue::ReadReplicatedMessagesForCDC(const yb::O
 Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
                                                           StartRemoteBootstrapRequestPB* req) {
   TrackedPeer* peer = nullptr;
+  boost::optional<RaftPeerPB> source;
   {
     LockGuard lock(queue_lock_);
     DCHECK_EQ(queue_state_.state, State::kQueueOpen);
@@ -740,6 +785,13 @@ Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
     if (PREDICT_FALSE(peer == nullptr || queue_state_.mode == Mode::NON_LEADER)) {
       return STATUS(NotFound, "Peer not tracked or queue not in leader mode.");
     }
+    if (peer->needs_remote_bootstrap &&
+        GetAtomicFlag(&FLAGS_remote_bootstrap_from_closest_follower)) {
+      const auto* source_pb = FindRemoteBootstrapSourceUnlocked(uuid);
+      if (source_pb) {
+        source = *source_pb;
+      }
+    }
   }
 
   if (PREDICT_FALSE(!peer->needs_remote_bootstrap)) {
@@ -751,18 +803,67 @@ Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
               << RaftPeerPB::MemberType_Name(peer->member_type);
   }
 
+  const auto& source_pb = source ? *source : local_peer_pb_;
+  if (source) {
+    LOG_WITH_PREFIX_UNLOCKED(INFO)
+        << "Remote bootstrapping peer " << uuid << " from follower " << source_pb.permanent_uuid();
+  }
+
   req->Clear();
   req->set_dest_uuid(uuid);
   req->set_tablet_id(tablet_id_);
-  req->set_bootstrap_peer_uuid(local_peer_uuid_);
-  *req->mutable_source_private_addr() = local_peer_pb_.last_known_private_addr();
-  *req->mutable_source_broadcast_addr() = local_peer_pb_.last_known_broadcast_addr();
-  *req->mutable_source_cloud_info() = local_peer_pb_.cloud_info();
+  req->set_bootstrap_peer_uuid(source_pb.permanent_uuid());
+  *req->mutable_source_private_addr() = source_pb.last_known_private_addr();
+  *req->mutable_source_broadcast_addr() = source_pb.last_known_broadcast_addr();
+  *req->mutable_source_cloud_info() = source_pb.cloud_info();
   req->set_caller_term(queue_state_.current_term);
   peer->needs_remote_bootstrap = false; // Now reset the flag.
+  peer->promote_when_caught_up = source.is_initialized();
   return Status::OK();
 }
 
+const RaftPeerPB* PeerMessageQueue::FindRemoteBootstrapSourceUnlocked(
+    const std::string& dest_uuid) {
+  if (!queue_state_.active_config) {
+    return nullptr;
+  }
+  const RaftPeerPB* dest_pb = nullptr;
+  for (const auto& peer_pb : queue_state_.active_config->peers()) {
+    if (peer_pb.permanent_uuid() == dest_uuid) {
+      dest_pb = &peer_pb;
+      break;
+    }
+  }
+  // The leader is as close as any follower when it is in the same region.
+  if (!dest_pb || !dest_pb->has_cloud_info() ||
+      SameRegion(dest_pb->cloud_info(), local_peer_pb_.cloud_info())) {
+    return nullptr;
+  }
+
+  const RaftPeerPB* result = nullptr;
+  for (const auto& peer_pb : queue_state_.active_config->peers()) {
+    if (peer_pb.permanent_uuid() == dest_uuid || peer_pb.permanent_uuid() == local_peer_uuid_ ||
+        peer_pb.member_type() != RaftPeerPB::VOTER ||
+        !SameRegion(peer_pb.cloud_info(), dest_pb->cloud_info())) {
+      continue;
+    }
+    auto* tracked = FindPtrOrNull(peers_map_, peer_pb.permanent_uuid());
+    // Only a follower that has all committed operations could be used, so the bootstrapped peer
+    // could continue from the log tail that the leader still has.
+    if (!tracked || tracked->needs_remote_bootstrap || !tracked->is_last_exchange_successful ||
+        tracked->last_received.index < queue_state_.committed_op_id.index) {
+      continue;
+    }
+    if (peer_pb.cloud_info().placement_zone() == dest_pb->cloud_info().placement_zone()) {
+      return &peer_pb;
+    }
+    if (!result) {
+      result = &peer_pb;
+    }
+  }
+  return result;
+}
+
 void PeerMessageQueue::UpdateCDCConsumerOpId(const yb::OpId& op_id) {
   std::lock_guard<rw_spinlock> l(cdc_consumer_lock_);
   cdc_consumer_op_id_ = op_id;
@@ -1073,6 +1174,8 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
   MajorityReplicatedData majority_replicated;
   Mode mode_copy;
   bool result = false;
+  bool peer_caught_up = false;
+  int64_t term = 0;
   {
     LockGuard scoped_lock(queue_lock_);
     DCHECK_NE(State::kQueueConstructed, queue_state_.state);
@@ -1119,6 +1222,12 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
 
     // Update the peer status based on the response.
     peer->is_new = false;
+    peer->supports_ops_compression = false;
+    for (auto compression : response.supported_ops_compression()) {
+      if (compression == OPS_COMPRESSION_LZ4) {
+        peer->supports_ops_compression = true;
+      }
+    }
     peer->last_successful_communication_time = MonoTime::Now();
 
     peer->ResetLastRequest();
@@ -1219,6 +1328,16 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
         (peer->last_known_committed_idx < queue_state_.committed_op_id.index);
 
     mode_copy = queue_state_.mode;
+    if (peer->promote_when_caught_up) {
+      if (!IsPreMember(peer->member_type)) {
+        peer->promote_when_caught_up = false;
+      } else if (mode_copy == Mode::LEADER &&
+                 peer->last_received.index >= queue_state_.committed_op_id.index) {
+        // Stays set until the role changes, so failed attempts are retried on next responses.
+        peer_caught_up = true;
+        term = queue_state_.current_term;
+      }
+    }
     if (mode_copy == Mode::LEADER) {
       auto new_majority_replicated_opid = OpIdWatermark();
       if (new_majority_replicated_opid != OpId::Min()) {
@@ -1263,6 +1382,10 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
     NotifyObserversOfMajorityReplOpChange(majority_replicated);
   }
 
+  if (peer_caught_up) {
+    NotifyObserversOfPeerCaughtUp(peer_uuid, term);
+  }
+
   return result;
 }
 
@@ -1489,6 +1612,12 @@ void PeerMessageQueue::NotifyObserversOfFailedFollower(const string& uuid,
   });
 }
 
+void PeerMessageQueue::NotifyObserversOfPeerCaughtUp(const string& uuid, int64_t term) {
+  NotifyObservers("peer caught up", [uuid, term](PeerMessageQueueObserver* observer) {
+    observer->NotifyPeerCaughtUp(uuid, term);
+  });
+}
+
 bool PeerMessageQueue::PeerAcceptedOurLease(const std::string& uuid) const {
   std::lock_guard<simple_spinlock> lock(queue_lock_);
   TrackedPeer* peer = FindPtrOrNull(peers_map_, uuid);
@@ -1595,6 +1724,10 @@ size_t PeerMessageQueue::EvictLogCache(size_t bytes_to_evict) {
   return log_cache_.EvictThroughOp(std::numeric_limits<int64_t>::max(), bytes_to_evict);
 }
 
+CoarseTimePoint PeerMessageQueue::LogCacheOldestEvictableEntryTime() {
+  return log_cache_.OldestEvictableEntryTime();
+}
+
 Status PeerMessageQueue::FlushLogIndex() {
   return log_cache_.FlushIndex();
 }
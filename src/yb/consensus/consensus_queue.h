@@ -173,11 +173,18 @@ class PeerMessageQueue {
     // Whether the follower was detected to need remote bootstrap.
     bool needs_remote_bootstrap = false;
 
+    // Whether the follower was remote bootstrapped from another follower. Such a source cannot
+    // change the role of the follower, so the leader does it once the follower catches up.
+    bool promote_when_caught_up = false;
+
     // Member type of this peer in the config.
     RaftPeerPB::MemberType member_type = RaftPeerPB::UNKNOWN_MEMBER_TYPE;
 
     uint64_t num_sst_files = 0;
 
+    // Whether the peer accepts LZ4 compressed ops, as reported in its last response.
+    bool supports_ops_compression = false;
+
    private:
     // The last term we saw from a given peer.
     // This is only used for sanity checking that a peer doesn't
@@ -363,6 +370,7 @@ class PeerMessageQueue {
 
   size_t LogCacheSize();
   size_t EvictLogCache(size_t bytes_to_evict);
+  CoarseTimePoint LogCacheOldestEvictableEntryTime();
 
   CHECKED_STATUS FlushLogIndex();
 
@@ -464,6 +472,13 @@ class PeerMessageQueue {
                                        int64_t term,
                                        const std::string& reason);
 
+  void NotifyObserversOfPeerCaughtUp(const std::string& uuid, int64_t term);
+
+  // Returns a follower that is closer to the peer with dest_uuid than this leader and is up to
+  // date enough to be a remote bootstrap source, or nullptr if there is no such follower.
+  const RaftPeerPB* FindRemoteBootstrapSourceUnlocked(const std::string& dest_uuid)
+      REQUIRES(queue_lock_);
+
   template <class Func>
   void NotifyObservers(const char* title, Func&& func);
 
@@ -520,7 +535,8 @@ class PeerMessageQueue {
   Result<ReadOpsResult> ReadFromLogCache(int64_t after_index,
                                          int64_t to_index,
                                          int max_batch_size,
-                                         const std::string& peer_uuid);
+                                         const std::string& peer_uuid,
+                                         CompressOps compress_ops = CompressOps::kFalse);
 
   std::vector<PeerMessageQueueObserver*> observers_;
 
@@ -611,6 +627,10 @@ class PeerMessageQueueObserver {
 
   virtual void MajorityReplicatedNumSSTFilesChanged(uint64_t majority_replicated_num_sst_files) = 0;
 
+  // Notify Consensus that a PRE_VOTER or PRE_OBSERVER peer that was remote bootstrapped from
+  // another follower caught up with the leader, so its role could be changed.
+  virtual void NotifyPeerCaughtUp(const std::string& peer_uuid, int64_t term) = 0;
+
   virtual ~PeerMessageQueueObserver() {}
 };
 
@@ -34,6 +34,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <thread>
 #include <vector>
 
 #include <boost/bind.hpp>
@@ -43,6 +44,7 @@
 #include "yb/consensus/consensus-test-util.h"
 #include "yb/consensus/log-test-base.h"
 #include "yb/consensus/log_index.h"
+#include "yb/consensus/log_sync_group.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
@@ -52,6 +54,7 @@ DEFINE_int32(num_batches, 10000,
              "Number of batches to write to/read from the Log in TestWriteManyBatches");
 
 DECLARE_int32(log_min_segments_to_retain);
+DECLARE_int32(log_max_recycled_segments);
 DECLARE_bool(never_fsync);
 DECLARE_bool(writable_file_use_fsync);
 DECLARE_int32(o_direct_block_alignment_bytes);
@@ -222,6 +225,51 @@ TEST_F(LogTest, TestFsync) {
   ASSERT_OK(log_->Close());
 }
 
+// Tests durable wal write with syncs shared across the logs on the same file system.
+TEST_F(LogTest, TestFsyncGroupAcrossTablets) {
+  options_.durable_wal_write = true;
+  options_.group_sync_across_tablets = true;
+  BuildLog();
+
+  OpIdPB opid;
+  opid.set_term(1);
+  opid.set_index(1);
+
+  ASSERT_OK(AppendNoOpsToLogSync(clock_, log_.get(), &opid, 10));
+  ASSERT_OK(log_->AllocateSegmentAndRollOver());
+
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  auto read_entries = segments[0]->ReadEntries();
+  ASSERT_OK(read_entries.status);
+  ASSERT_EQ(10, read_entries.entries.size());
+
+  ASSERT_OK(log_->Close());
+}
+
+TEST_F(LogTest, TestFileSystemSyncGroup) {
+  auto group = ASSERT_RESULT(FileSystemSyncGroup::ForDirectory(GetTestDataDirectory()));
+  // Logs on the same file system share the group.
+  ASSERT_EQ(group, ASSERT_RESULT(FileSystemSyncGroup::ForDirectory(GetTestDataDirectory())));
+
+  constexpr int kNumThreads = 8;
+  constexpr int kSyncsPerThread = 20;
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([&group] {
+      for (int j = 0; j != kSyncsPerThread; ++j) {
+        ASSERT_OK(group->Sync());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // Concurrent calls could be served by the same syncfs().
+  ASSERT_LE(group->num_syncs(), kNumThreads * kSyncsPerThread);
+  ASSERT_GT(group->num_syncs(), 0);
+}
+
 // Tests interval for durable wal write
 TEST_F(LogTest, TestFsyncInterval) {
   options_.interval_durable_wal_write = MonoDelta::FromMilliseconds(1);
@@ -663,6 +711,51 @@ TEST_F(LogTest, TestGCWithLogRunning) {
   }
 }
 
+TEST_F(LogTest, TestRecycleGCedSegments) {
+  FLAGS_log_max_recycled_segments = 1;
+  BuildLog();
+
+  vector<LogAnchor*> anchors;
+  ElementDeleter deleter(&anchors);
+
+  const int kNumTotalSegments = 4;
+  const int kNumOpsPerSegment = 5;
+  OpIdPB op_id = MakeOpId(1, 1);
+  ASSERT_OK(AppendMultiSegmentSequence(kNumTotalSegments, kNumOpsPerSegment, &op_id, &anchors));
+  for (auto* anchor : anchors) {
+    ASSERT_OK(log_anchor_registry_->Unregister(anchor));
+  }
+
+  auto count_recycled = [this] {
+    auto files = CHECK_RESULT(env_->GetChildren(tablet_wal_path_, ExcludeDots::kTrue));
+    return std::count_if(files.begin(), files.end(), [](const string& file) {
+      return HasPrefixString(file, ".tmp.recycledsegment-");
+    });
+  };
+
+  // Only one of GCed segments is kept for reuse, the other one is deleted.
+  int num_gced_segments;
+  ASSERT_OK(log_->GC(op_id.index(), &num_gced_segments));
+  ASSERT_EQ(2, num_gced_segments);
+  CheckRightNumberOfSegmentFiles(2);
+  ASSERT_EQ(1, count_recycled());
+
+  // Next segment is allocated from the recycled file.
+  ASSERT_OK(log_->AllocateSegmentAndRollOver());
+  ASSERT_EQ(0, count_recycled());
+  CheckRightNumberOfSegmentFiles(3);
+
+  // Stale entries of the recycled file should not be visible in the new segment.
+  ASSERT_OK(AppendNoOpsToLogSync(clock_, log_.get(), &op_id, kNumOpsPerSegment));
+  ASSERT_OK(log_->Close());
+
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  auto read_entries = segments.back()->ReadEntries();
+  ASSERT_OK(read_entries.status);
+  ASSERT_EQ(kNumOpsPerSegment, read_entries.entries.size());
+}
+
 // Test that, when we are set to retain a given number of log segments,
 // we also retain any relevant log index chunks, even if those operations
 // are not necessary for recovery.
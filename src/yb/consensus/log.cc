@@ -32,6 +32,9 @@
 
 #include "yb/consensus/log.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <mutex>
 #include <thread>
@@ -44,6 +47,7 @@
 #include "yb/consensus/log_index.h"
 #include "yb/consensus/log_metrics.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/consensus/log_sync_group.h"
 #include "yb/consensus/log_util.h"
 #include "yb/consensus/opid_util.h"
 
@@ -52,11 +56,13 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/strings/util.h"
 #include "yb/gutil/walltime.h"
 #include "yb/util/coding.h"
 #include "yb/util/countdown_latch.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/env_util.h"
+#include "yb/util/errno.h"
 #include "yb/util/fault_injection.h"
 #include "yb/util/file_util.h"
 #include "yb/util/flag_tags.h"
@@ -77,6 +83,7 @@
 #include "yb/util/trace.h"
 #include "yb/util/tsan_util.h"
 #include "yb/util/shared_lock.h"
+#include "yb/util/wait_state.h"
 
 using namespace yb::size_literals;  // NOLINT.
 using namespace std::literals;  // NOLINT.
@@ -142,6 +149,13 @@ DEFINE_test_flag(bool, log_consider_all_ops_safe, false,
 // We have to make the queue length really long.
 // TODO: Create new flags log_taskstream_queue_max_size and log_taskstream_queue_max_wait_ms
 // and deprecate these flags.
+DEFINE_int32(log_max_recycled_segments, 0,
+             "Maximal number of GCed log segment files per tablet, that are kept to be reused "
+             "for new segments instead of being deleted. Reused files are zeroed in place, so "
+             "their blocks stay allocated. 0 to always delete GCed segments.");
+TAG_FLAG(log_max_recycled_segments, runtime);
+TAG_FLAG(log_max_recycled_segments, advanced);
+
 DEFINE_int32(taskstream_queue_max_size, 100000,
              "Maximum number of operations waiting in the taskstream queue.");
 
@@ -164,6 +178,7 @@ static bool dummy = google::RegisterFlagValidator(
     &FLAGS_log_min_segments_to_retain, &ValidateLogsToRetain);
 
 static const char kSegmentPlaceholderFileTemplate[] = ".tmp.newsegmentXXXXXX";
+static const char kRecycledSegmentPrefix[] = ".tmp.recycledsegment-";
 
 namespace yb {
 namespace log {
@@ -227,6 +242,12 @@ class LogEntryBatch {
     return Slice(buffer_);
   }
 
+  // Returns CRC32C of the serialized contents, computed while serializing them.
+  uint32_t data_crc() const {
+    DCHECK_EQ(state_, kEntrySerialized);
+    return data_crc_;
+  }
+
   bool flush_marker() const;
 
   size_t count() const { return count_; }
@@ -273,6 +294,9 @@ class LogEntryBatch {
   // Buffer to which 'phys_entries_' are serialized by call to 'Serialize()'
   faststring buffer_;
 
+  // CRC32C of 'buffer_'.
+  uint32_t data_crc_ = 0;
+
   // Offset into the log file for this entry batch.
   int64_t offset_;
 
@@ -576,8 +600,19 @@ Status Log::Init() {
 
   }
 
+  if (durable_wal_write_ && options_.group_sync_across_tablets) {
+    auto sync_group = FileSystemSyncGroup::ForDirectory(wal_dir_);
+    if (sync_group.ok()) {
+      sync_group_ = std::move(*sync_group);
+    } else {
+      YB_LOG_FIRST_N(WARNING, 1) << "Failed to share WAL syncs across tablets: "
+                                 << sync_group.status();
+    }
+  }
+
   if (durable_wal_write_) {
-    YB_LOG_FIRST_N(INFO, 1) << "durable_wal_write is turned on.";
+    YB_LOG_FIRST_N(INFO, 1) << "durable_wal_write is turned on"
+                            << (sync_group_ ? ", syncs are shared across tablets." : ".");
   } else if (interval_durable_wal_write_) {
     YB_LOG_FIRST_N(INFO, 1) << "interval_durable_wal_write_ms is turned on to sync every "
                             << interval_durable_wal_write_.ToMilliseconds() << " ms.";
@@ -588,6 +623,8 @@ Status Log::Init() {
     YB_LOG_FIRST_N(INFO, 1) << "durable_wal_write is turned off. Buffered IO will be used for WAL.";
   }
 
+  RETURN_NOT_OK(LoadRecycledSegments());
+
   if (create_new_segment_at_start_) {
     RETURN_NOT_OK(EnsureInitialNewSegmentAllocated());
   }
@@ -825,7 +862,8 @@ Status Log::DoAppend(LogEntryBatch* entry_batch,
       LongOperationTracker long_operation_tracker(
           "Log append", FLAGS_consensus_log_scoped_watch_delay_append_threshold_ms * 1ms);
 
-      RETURN_NOT_OK(active_segment_->WriteEntryBatch(entry_batch_data));
+      RETURN_NOT_OK(active_segment_->WriteEntryBatch(
+          entry_batch_data, entry_batch->data_crc()));
     }
 
     if (metrics_) {
@@ -957,7 +995,12 @@ Status Log::Sync() {
       periodic_sync_needed_.store(false);
       periodic_sync_unsynced_bytes_ = 0;
       LOG_SLOW_EXECUTION(WARNING, 50, "Fsync log took a long time") {
-        RETURN_NOT_OK(active_segment_->Sync());
+        ScopedWaitEvent wait_event(WaitEvent::kWalSync);
+        if (durable_wal_write_ && sync_group_) {
+          RETURN_NOT_OK(sync_group_->Sync());
+        } else {
+          RETURN_NOT_OK(active_segment_->Sync());
+        }
       }
     }
   }
@@ -1144,18 +1187,28 @@ Status Log::GC(int64_t min_op_idx, int32_t* num_gced) {
           segments_to_delete[segments_to_delete.size() - 1]->header().sequence_number()));
     }
 
-    // Now that they are no longer referenced by the Log, delete the files.
+    // Now that they are no longer referenced by the Log, recycle or delete the files.
     *num_gced = 0;
+    bool recycled = false;
     for (const scoped_refptr<ReadableLogSegment>& segment : segments_to_delete) {
-      LOG_WITH_PREFIX(INFO) << "Deleting log segment in path: " << segment->path()
-                            << " (GCed ops < " << min_op_idx << ")";
-      RETURN_NOT_OK(get_env()->DeleteFile(segment->path()));
+      if (RecycleSegment(segment)) {
+        LOG_WITH_PREFIX(INFO) << "Recycled log segment in path: " << segment->path()
+                              << " (GCed ops < " << min_op_idx << ")";
+        recycled = true;
+      } else {
+        LOG_WITH_PREFIX(INFO) << "Deleting log segment in path: " << segment->path()
+                              << " (GCed ops < " << min_op_idx << ")";
+        RETURN_NOT_OK(get_env()->DeleteFile(segment->path()));
+      }
       (*num_gced)++;
 
       if (metrics_) {
         metrics_->wal_size->IncrementBy(-1 * segment->file_size());
       }
     }
+    if (recycled) {
+      RETURN_NOT_OK(get_env()->SyncDir(wal_dir_));
+    }
 
     // Determine the minimum remaining replicate index in order to properly GC the index chunks.
     int64_t min_remaining_op_idx = reader_->GetMinReplicateIndex();
@@ -1367,15 +1420,22 @@ Status Log::PreAllocateNewSegment() {
   WritableFileOptions opts;
   // We always want to sync on close: https://github.com/yugabyte/yugabyte-db/issues/3490
   opts.sync_on_close = true;
-  opts.o_direct = durable_wal_write_;
-  RETURN_NOT_OK(CreatePlaceholderSegment(opts, &next_segment_path_, &next_segment_file_));
+  // Segments of a sync group are made durable by syncfs(), so they are written through the page
+  // cache instead of O_DIRECT | O_SYNC writes.
+  opts.o_direct = durable_wal_write_ && !sync_group_;
+  uint64_t allocated_size = 0;
+  if (!ReuseRecycledSegment(opts, &next_segment_path_, &next_segment_file_, &allocated_size)) {
+    RETURN_NOT_OK(CreatePlaceholderSegment(opts, &next_segment_path_, &next_segment_file_));
+  }
 
   if (options_.preallocate_segments) {
     uint64_t next_segment_size = NextSegmentDesiredSize();
     TRACE("Preallocating $0 byte segment in $1", next_segment_size, next_segment_path_);
     // TODO (perf) zero the new segments -- this could result in additional performance
     // improvements.
-    RETURN_NOT_OK(next_segment_file_->PreAllocate(next_segment_size));
+    if (next_segment_size > allocated_size) {
+      RETURN_NOT_OK(next_segment_file_->PreAllocate(next_segment_size - allocated_size));
+    }
   }
 
   {
@@ -1486,6 +1546,114 @@ Status Log::CreatePlaceholderSegment(const WritableFileOptions& opts,
   return Status::OK();
 }
 
+namespace {
+
+size_t MaxRecycledSegments() {
+  return std::max(FLAGS_log_max_recycled_segments, 0);
+}
+
+// Zeroes the contents of the file, keeping its size and allocated blocks. So stale entries could
+// not be read from the reused segment file after a crash. Works directly with the local file
+// system, so reuse of recycled segments fails and falls back to a new file for other envs.
+Status ZeroFile(const std::string& path, uint64_t size) {
+#if defined(__linux__) && defined(FALLOC_FL_ZERO_RANGE)
+  int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return STATUS(IOError, path, Errno(errno));
+  }
+  auto se = ScopeExit([fd] { close(fd); });
+  if (size != 0 && fallocate(fd, FALLOC_FL_ZERO_RANGE | FALLOC_FL_KEEP_SIZE, 0, size) != 0) {
+    return STATUS(IOError, "Failed to zero " + path, Errno(errno));
+  }
+  if (fdatasync(fd) != 0) {
+    return STATUS(IOError, "Failed to sync " + path, Errno(errno));
+  }
+  return Status::OK();
+#else
+  return STATUS(NotSupported, "Zeroing of file range is not supported on this platform");
+#endif
+}
+
+} // namespace
+
+bool Log::RecycleSegment(const scoped_refptr<ReadableLogSegment>& segment) {
+  std::lock_guard<std::mutex> lock(recycled_segments_mutex_);
+  if (recycled_segments_.size() >= MaxRecycledSegments()) {
+    return false;
+  }
+  auto path = JoinPathSegments(
+      wal_dir_, kRecycledSegmentPrefix + std::to_string(segment->header().sequence_number()));
+  auto status = get_env()->RenameFile(segment->path(), path);
+  if (!status.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Failed to recycle " << segment->path() << ": " << status;
+    return false;
+  }
+  recycled_segments_.push_back(RecycledSegment{std::move(path), segment});
+  return true;
+}
+
+Status Log::LoadRecycledSegments() {
+  vector<string> children;
+  RETURN_NOT_OK(get_env()->GetChildren(wal_dir_, ExcludeDots::kTrue, &children));
+  std::lock_guard<std::mutex> lock(recycled_segments_mutex_);
+  for (const auto& child : children) {
+    if (!HasPrefixString(child, kRecycledSegmentPrefix)) {
+      continue;
+    }
+    auto path = JoinPathSegments(wal_dir_, child);
+    if (recycled_segments_.size() < MaxRecycledSegments()) {
+      recycled_segments_.push_back(RecycledSegment{std::move(path), nullptr});
+    } else {
+      RETURN_NOT_OK(get_env()->DeleteFile(path));
+    }
+  }
+  return Status::OK();
+}
+
+bool Log::ReuseRecycledSegment(const WritableFileOptions& opts,
+                               string* result_path,
+                               shared_ptr<WritableFile>* out,
+                               uint64_t* allocated_size) {
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(recycled_segments_mutex_);
+    auto it = std::find_if(
+        recycled_segments_.begin(), recycled_segments_.end(), [](const RecycledSegment& entry) {
+      return !entry.segment || entry.segment->HasOneRef();
+    });
+    if (it == recycled_segments_.end()) {
+      return false;
+    }
+    path = std::move(it->path);
+    recycled_segments_.erase(it);
+  }
+
+  auto status = [this, &opts, &path, out, allocated_size]() -> Status {
+    uint64_t size = VERIFY_RESULT(get_env()->GetFileSize(path));
+    RETURN_NOT_OK(ZeroFile(path, size));
+    WritableFileOptions reuse_opts = opts;
+    reuse_opts.mode = Env::OPEN_EXISTING;
+    reuse_opts.overwrite = true;
+    std::unique_ptr<WritableFile> segment_file;
+    RETURN_NOT_OK(get_env()->NewWritableFile(reuse_opts, path, &segment_file));
+    // Covers the whole existing file, so closing the segment truncates it to the written size.
+    if (size != 0) {
+      RETURN_NOT_OK(segment_file->PreAllocate(size));
+    }
+    out->reset(segment_file.release());
+    *allocated_size = size;
+    return Status::OK();
+  }();
+  if (!status.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Failed to reuse recycled segment " << path << ": " << status;
+    WARN_NOT_OK(get_env()->DeleteFile(path), "Failed to delete recycled segment");
+    return false;
+  }
+  VLOG_WITH_PREFIX(1) << "Reused recycled segment as next WAL segment: " << path;
+  *result_path = std::move(path);
+  return true;
+}
+
 uint64_t Log::active_segment_sequence_number() const {
   return active_segment_sequence_number_;
 }
@@ -1557,7 +1725,9 @@ Status LogEntryBatch::Serialize() {
   total_size_bytes_ = entry_batch_pb_.ByteSize();
   buffer_.reserve(total_size_bytes_);
 
-  pb_util::AppendToString(entry_batch_pb_, &buffer_);
+  // Checksum is computed while serialized bytes are still in cache, so WriteEntryBatch does not
+  // read the whole batch again.
+  data_crc_ = pb_util::AppendToStringWithCrc32c(entry_batch_pb_, &buffer_);
 
   state_ = kEntrySerialized;
   return Status::OK();
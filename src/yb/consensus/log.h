@@ -34,6 +34,7 @@
 #define YB_CONSENSUS_LOG_H_
 
 #include <atomic>
+#include <deque>
 #include <map>
 #include <memory>
 #include <string>
@@ -360,6 +361,21 @@ class Log : public RefCountedThreadSafe<Log> {
                                           std::string* result_path,
                                           std::shared_ptr<WritableFile>* out);
 
+  // Takes a recycled segment file that is no longer read by anybody, zeroes it and opens it for
+  // writing from the beginning. Sets 'allocated_size' to the size of the file, that is already
+  // allocated. Returns false if there is no such file, or it could not be reused.
+  bool ReuseRecycledSegment(const WritableFileOptions& opts,
+                            std::string* result_path,
+                            std::shared_ptr<WritableFile>* out,
+                            uint64_t* allocated_size);
+
+  // Moves the file of GCed segment to the recycled segments of this log. Returns false if the
+  // segment should be deleted instead.
+  bool RecycleSegment(const scoped_refptr<ReadableLogSegment>& segment);
+
+  // Picks up recycled segment files, left by previous instance of the log.
+  CHECKED_STATUS LoadRecycledSegments();
+
   // Creates a new WAL segment on disk, writes the next_segment_header_ to disk as the header, and
   // sets active_segment_ to point to this new segment.
   CHECKED_STATUS SwitchToAllocatedSegment() EXCLUDES(allocation_mutex_);
@@ -440,6 +456,16 @@ class Log : public RefCountedThreadSafe<Log> {
   // The path for the next allocated segment.
   std::string next_segment_path_;
 
+  // Files of GCed segments, that could be reused for new segments instead of allocating new files.
+  // The segment is kept while it could still be read by somebody, the file is reused only after
+  // all other references are gone.
+  struct RecycledSegment {
+    std::string path;
+    scoped_refptr<ReadableLogSegment> segment;
+  };
+  std::mutex recycled_segments_mutex_;
+  std::deque<RecycledSegment> recycled_segments_ GUARDED_BY(recycled_segments_mutex_);
+
   // Lock to protect mutations to log_state_ and other shared state variables.
   mutable percpu_rwlock state_lock_;
 
@@ -485,6 +511,10 @@ class Log : public RefCountedThreadSafe<Log> {
   // If true, sync on all appends.
   bool durable_wal_write_;
 
+  // If set, durable_wal_write_ syncs are shared with the logs of other tablets on the same file
+  // system, and segments are written through the page cache.
+  std::shared_ptr<FileSystemSyncGroup> sync_group_;
+
   // If non-zero, sync every interval of time.
   MonoDelta interval_durable_wal_write_;
 
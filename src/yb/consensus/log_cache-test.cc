@@ -60,6 +60,7 @@ using std::thread;
 
 DECLARE_int32(log_cache_size_limit_mb);
 DECLARE_int32(global_log_cache_size_limit_mb);
+DECLARE_bool(log_cache_compress_cold_entries);
 
 METRIC_DECLARE_entity(tablet);
 
@@ -306,6 +307,73 @@ TEST_F(LogCacheTest, TestMemoryLimit) {
   ASSERT_EQ(cache_->BytesUsed(), 0);
 }
 
+TEST_F(LogCacheTest, TestCompressColdEntries) {
+  FLAGS_log_cache_size_limit_mb = 1;
+  FLAGS_log_cache_compress_cold_entries = true;
+  CloseAndReopenCache(MinimumOpId());
+
+  const int kPayloadSize = 400_KB;
+  ASSERT_OK(AppendReplicateMessagesToCache(1, 2, kPayloadSize));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  int size_with_two_msgs = cache_->BytesUsed();
+
+  // The third operation pushes the cache above the limit, so the first one is compressed instead
+  // of being evicted.
+  ASSERT_OK(AppendReplicateMessagesToCache(3, 1, kPayloadSize));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  ASSERT_EQ(3, cache_->num_cached_ops());
+  ASSERT_EQ(1, cache_->metrics_.compressed_ops->value());
+  ASSERT_LT(cache_->BytesUsed(), size_with_two_msgs + 100_KB);
+
+  auto read_result = ASSERT_RESULT(cache_->ReadOps(0, 8_MB));
+  ASSERT_EQ(3, read_result.messages.size());
+  ASSERT_EQ(0, cache_->metrics_.disk_reads->value());
+  for (int i = 0; i != 3; ++i) {
+    ASSERT_EQ(OpIdStrForIndex(i + 1), OpIdToString(read_result.messages[i]->id()));
+    ASSERT_EQ(kPayloadSize, read_result.messages[i]->noop_request().payload_for_tests().size());
+  }
+
+  // Compressed entries are evicted as usual.
+  cache_->EvictThroughOp(3);
+  ASSERT_EQ(0, cache_->num_cached_ops());
+  ASSERT_EQ(0, cache_->BytesUsed());
+}
+
+TEST_F(LogCacheTest, TestReadCompressedOps) {
+  const int kPayloadSize = 4_KB;
+  ASSERT_OK(AppendReplicateMessagesToCache(1, 3, kPayloadSize));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+
+  auto read_result = ASSERT_RESULT(cache_->ReadOps(0, 0, 8_MB, CompressOps::kTrue));
+  ASSERT_EQ(3, read_result.messages.size());
+  ASSERT_EQ(3, read_result.compressed_messages.size());
+  const auto input_bytes = cache_->metrics_.ops_compression_input_bytes->value();
+  ASSERT_GT(input_bytes, 3 * kPayloadSize);
+  ASSERT_LT(cache_->metrics_.ops_compression_output_bytes->value(), input_bytes);
+
+  // Compressed messages are kept in the cache, so they are not compressed again.
+  auto second_result = ASSERT_RESULT(cache_->ReadOps(0, 0, 8_MB, CompressOps::kTrue));
+  ASSERT_EQ(read_result.compressed_messages, second_result.compressed_messages);
+  ASSERT_EQ(input_bytes, cache_->metrics_.ops_compression_input_bytes->value());
+
+  ConsensusRequestPB request;
+  request.set_ops_compression(OPS_COMPRESSION_LZ4);
+  for (const auto& compressed : read_result.compressed_messages) {
+    request.add_compressed_ops()->CopyFrom(*compressed);
+  }
+  ASSERT_OK(DecompressOps(&request));
+  ASSERT_EQ(3, request.ops_size());
+  ASSERT_EQ(0, request.compressed_ops_size());
+  for (int i = 0; i != 3; ++i) {
+    ASSERT_EQ(read_result.messages[i]->SerializeAsString(), request.ops(i).SerializeAsString());
+  }
+
+  // Memory of compressed messages is released with the entries.
+  cache_->EvictThroughOp(3);
+  ASSERT_EQ(0, cache_->num_cached_ops());
+  ASSERT_EQ(0, cache_->BytesUsed());
+}
+
 TEST_F(LogCacheTest, TestGlobalMemoryLimit) {
   FLAGS_global_log_cache_size_limit_mb = 4;
   CloseAndReopenCache(MinimumOpId());
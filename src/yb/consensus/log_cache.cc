@@ -40,6 +40,7 @@
 #include <gflags/gflags.h>
 #include <google/protobuf/wire_format_lite.h>
 #include <google/protobuf/wire_format_lite_inl.h>
+#include <snappy.h>
 
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_reader.h"
@@ -72,6 +73,12 @@ DEFINE_int32(global_log_cache_size_limit_mb, 1024,
              "caching log entries across all tablets is kept under this threshold.");
 TAG_FLAG(global_log_cache_size_limit_mb, advanced);
 
+DEFINE_bool(log_cache_compress_cold_entries, false,
+            "When log cache entries should be evicted because of the memory limit, keep them "
+            "compressed in the cache instead, so lagging followers could still be served "
+            "without reading the WAL. Compressed entries are evicted on the next pass.");
+TAG_FLAG(log_cache_compress_cold_entries, advanced);
+
 DEFINE_test_flag(bool, log_cache_skip_eviction, false,
                  "Don't evict log entries in tests.");
 
@@ -86,6 +93,18 @@ METRIC_DEFINE_gauge_int64(tablet, log_cache_size, "Log Cache Memory Usage",
 METRIC_DEFINE_counter(tablet, log_cache_disk_reads, "Log Cache Disk Reads",
                       yb::MetricUnit::kEntries,
                       "Amount of operations read from disk.");
+METRIC_DEFINE_counter(tablet, log_cache_compressed_ops, "Log Cache Compressed Operations",
+                      yb::MetricUnit::kEntries,
+                      "Amount of operations that were compressed instead of being evicted.");
+METRIC_DEFINE_counter(tablet, log_cache_ops_compression_input_bytes,
+                      "Log Cache Ops Compression Input Bytes", yb::MetricUnit::kBytes,
+                      "Size of operations compressed for sending to peers, before compression.");
+METRIC_DEFINE_counter(tablet, log_cache_ops_compression_output_bytes,
+                      "Log Cache Ops Compression Output Bytes", yb::MetricUnit::kBytes,
+                      "Size of operations compressed for sending to peers, after compression.");
+METRIC_DEFINE_counter(tablet, log_cache_ops_compression_time_us,
+                      "Log Cache Ops Compression Time", yb::MetricUnit::kMicroseconds,
+                      "Time spent compressing operations for sending to peers.");
 
 namespace yb {
 namespace consensus {
@@ -94,8 +113,29 @@ namespace {
 
 const std::string kParentMemTrackerId = "log_cache"s;
 
+// Calculate the total byte size that will be used on the wire to replicate this message as part of
+// a consensus update request. This accounts for the length delimiting and tagging of the message.
+int64_t TotalByteSizeForMessage(const ReplicateMsg& msg) {
+  int msg_size = google::protobuf::internal::WireFormatLite::LengthDelimitedSize(
+    msg.ByteSize());
+  msg_size += 1; // for the type tag
+  return msg_size;
+}
+
+Result<ReplicateMsgPtr> DecompressMessage(const std::string& compressed) {
+  std::string serialized;
+  if (!snappy::Uncompress(compressed.data(), compressed.size(), &serialized)) {
+    return STATUS(Corruption, "Failed to uncompress log cache entry");
+  }
+  auto msg = std::make_shared<ReplicateMsg>();
+  if (!msg->ParseFromString(serialized)) {
+    return STATUS(Corruption, "Failed to parse log cache entry");
+  }
+  return msg;
 }
 
+} // namespace
+
 typedef vector<const ReplicateMsg*>::const_iterator MsgIter;
 
 LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
@@ -126,6 +166,7 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
   auto zero_op = std::make_shared<ReplicateMsg>();
   *zero_op->mutable_id() = MinimumOpId();
   InsertOrDie(&cache_, 0, { zero_op, zero_op->SpaceUsed() });
+  cache_[0].append_time = CoarseMonoClock::Now();
 }
 
 MemTrackerPtr LogCache::GetServerMemTracker(const MemTrackerPtr& server_tracker) {
@@ -153,8 +194,12 @@ LogCache::PrepareAppendResult LogCache::PrepareAppendOperations(const ReplicateM
   PrepareAppendResult result;
   std::vector<CacheEntry> entries_to_insert;
   entries_to_insert.reserve(msgs.size());
+  const auto now = CoarseMonoClock::Now();
   for (const auto& msg : msgs) {
     CacheEntry e = { msg, static_cast<int64_t>(msg->SpaceUsedLong()) };
+    e.op_id = yb::OpId::FromPB(msg->id());
+    e.wire_size = TotalByteSizeForMessage(*msg);
+    e.append_time = now;
     result.mem_required += e.mem_usage;
     entries_to_insert.emplace_back(std::move(e));
   }
@@ -181,7 +226,7 @@ LogCache::PrepareAppendResult LogCache::PrepareAppendOperations(const ReplicateM
   }
 
   for (auto& e : entries_to_insert) {
-    auto index = e.msg->id().index();
+    auto index = e.op_id.index;
     EmplaceOrDie(&cache_, index, std::move(e));
     next_sequential_op_index_ = index + 1;
   }
@@ -233,6 +278,16 @@ int64_t LogCache::earliest_op_index() const {
   return ret;
 }
 
+CoarseTimePoint LogCache::OldestEvictableEntryTime() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  // Skip our special '0' op.
+  auto it = cache_.upper_bound(0);
+  if (it == cache_.end() || it->second.op_id.index >= min_pinned_op_index_) {
+    return CoarseTimePoint::max();
+  }
+  return it->second.append_time;
+}
+
 bool LogCache::HasOpBeenWritten(int64_t index) const {
   std::lock_guard<simple_spinlock> l(lock_);
   return index < next_sequential_op_index_;
@@ -253,7 +308,7 @@ Result<yb::OpId> LogCache::LookupOpId(int64_t op_index) const {
     }
     auto iter = cache_.find(op_index);
     if (iter != cache_.end()) {
-      return yb::OpId::FromPB(iter->second.msg->id());
+      return iter->second.op_id;
     }
   }
 
@@ -261,19 +316,6 @@ Result<yb::OpId> LogCache::LookupOpId(int64_t op_index) const {
   return log_->GetLogReader()->LookupOpId(op_index);
 }
 
-namespace {
-
-// Calculate the total byte size that will be used on the wire to replicate this message as part of
-// a consensus update request. This accounts for the length delimiting and tagging of the message.
-int64_t TotalByteSizeForMessage(const ReplicateMsg& msg) {
-  int msg_size = google::protobuf::internal::WireFormatLite::LengthDelimitedSize(
-    msg.ByteSize());
-  msg_size += 1; // for the type tag
-  return msg_size;
-}
-
-} // anonymous namespace
-
 Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
                                         int max_size_bytes) {
   return ReadOps(after_op_index, 0 /* to_op_index */, max_size_bytes);
@@ -281,7 +323,8 @@ Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
 
 Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
                                         int64_t to_op_index,
-                                        int max_size_bytes) {
+                                        int max_size_bytes,
+                                        CompressOps compress_ops) {
   DCHECK_GE(after_op_index, 0);
 
   VLOG_WITH_PREFIX_UNLOCKED(4) << "ReadOps, after_op_index: " << after_op_index
@@ -291,6 +334,9 @@ Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
   ReadOpsResult result;
   result.preceding_op = VERIFY_RESULT(LookupOpId(after_op_index));
 
+  // Compressed entries are added to result as nulls, and uncompressed after releasing the lock.
+  std::vector<std::pair<size_t, std::shared_ptr<const std::string>>> compressed_messages;
+
   std::unique_lock<simple_spinlock> l(lock_);
   int64_t next_index = after_op_index + 1;
   int64_t to_index = to_op_index > 0
@@ -342,28 +388,92 @@ Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
         if (to_op_index > 0 && next_index > to_op_index) {
           break;
         }
-        const ReplicateMsgPtr& msg = iter->second.msg;
-        int64_t index = msg->id().index();
+        const CacheEntry& entry = iter->second;
+        int64_t index = entry.op_id.index;
         if (index != next_index) {
           continue;
         }
 
-        auto current_message_size = TotalByteSizeForMessage(*msg);
-        remaining_space -= current_message_size;
+        remaining_space -= entry.wire_size;
         if (remaining_space < 0 && !result.messages.empty()) {
           break;
         }
 
-        result.messages.push_back(msg);
+        if (entry.compressed) {
+          compressed_messages.emplace_back(result.messages.size(), entry.compressed);
+        }
+        if (compress_ops) {
+          result.compressed_messages.resize(result.messages.size());
+          result.compressed_messages.push_back(entry.wire_compressed);
+        }
+        result.messages.push_back(entry.msg);
         next_index++;
       }
     }
   }
   result.have_more_messages = remaining_space < 0;
+  l.unlock();
+
+  for (const auto& p : compressed_messages) {
+    result.messages[p.first] = VERIFY_RESULT(DecompressMessage(*p.second));
+  }
+
+  if (compress_ops) {
+    CompressReadOps(&result);
+  }
 
   return result;
 }
 
+void LogCache::CompressReadOps(ReadOpsResult* result) {
+  result->compressed_messages.resize(result->messages.size());
+  std::vector<size_t> compressed_now;
+  int64_t input_bytes = 0;
+  int64_t output_bytes = 0;
+  auto start = MonoTime::Now();
+  for (size_t i = 0; i != result->messages.size(); ++i) {
+    auto& compressed = result->compressed_messages[i];
+    if (compressed) {
+      continue;
+    }
+    compressed = CompressReplicateMsg(*result->messages[i]);
+    input_bytes += compressed->has_uncompressed_size() ? compressed->uncompressed_size()
+                                                       : compressed->data().size();
+    output_bytes += compressed->data().size();
+    compressed_now.push_back(i);
+  }
+  if (compressed_now.empty()) {
+    return;
+  }
+  metrics_.ops_compression_time_us->IncrementBy((MonoTime::Now() - start).ToMicroseconds());
+  metrics_.ops_compression_input_bytes->IncrementBy(input_bytes);
+  metrics_.ops_compression_output_bytes->IncrementBy(output_bytes);
+
+  std::lock_guard<simple_spinlock> lock(lock_);
+  for (auto i : compressed_now) {
+    StoreWireCompressedUnlocked(*result->messages[i], result->compressed_messages[i]);
+  }
+}
+
+void LogCache::StoreWireCompressedUnlocked(
+    const ReplicateMsg& msg, const CompressedReplicateMsgPtr& compressed) {
+  auto it = cache_.find(msg.id().index());
+  if (it == cache_.end()) {
+    return;
+  }
+  auto& entry = it->second;
+  if (entry.wire_compressed || entry.op_id != OpId::FromPB(msg.id())) {
+    return;
+  }
+  const int64_t mem_usage = compressed->SpaceUsedLong();
+  if (entry.tracked) {
+    tracker_->Consume(mem_usage);
+  }
+  metrics_.size->IncrementBy(mem_usage);
+  entry.mem_usage += mem_usage;
+  entry.wire_compressed = compressed;
+}
+
 size_t LogCache::EvictThroughOp(int64_t index, int64_t bytes_to_evict) {
   std::lock_guard<simple_spinlock> lock(lock_);
   return EvictSomeUnlocked(index, bytes_to_evict);
@@ -380,12 +490,16 @@ size_t LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_ev
     return 0;
   }
 
+  // Entries that are evicted because of the memory limit could still be needed by lagging peers,
+  // so they are compressed first when log_cache_compress_cold_entries is set.
+  const bool compress = bytes_to_evict != std::numeric_limits<int64_t>::max() &&
+                        FLAGS_log_cache_compress_cold_entries;
+
   int64_t bytes_evicted = 0;
   for (auto iter = cache_.begin(); iter != cache_.end();) {
-    const CacheEntry& entry = iter->second;
-    const ReplicateMsgPtr& msg = entry.msg;
-    VLOG_WITH_PREFIX_UNLOCKED(2) << "considering for eviction: " << msg->id();
-    int64_t msg_index = msg->id().index();
+    CacheEntry& entry = iter->second;
+    VLOG_WITH_PREFIX_UNLOCKED(2) << "considering for eviction: " << entry.op_id;
+    int64_t msg_index = entry.op_id.index;
     if (msg_index == 0) {
       // Always keep our special '0' op.
       ++iter;
@@ -396,7 +510,19 @@ size_t LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_ev
       break;
     }
 
-    VLOG_WITH_PREFIX_UNLOCKED(2) << "Evicting cache. Removing: " << msg->id();
+    if (compress && !entry.compressed) {
+      auto freed = CompressEntryUnlocked(&entry);
+      if (freed > 0) {
+        bytes_evicted += freed;
+        if (bytes_evicted >= bytes_to_evict) {
+          break;
+        }
+        ++iter;
+        continue;
+      }
+    }
+
+    VLOG_WITH_PREFIX_UNLOCKED(2) << "Evicting cache. Removing: " << entry.op_id;
     AccountForMessageRemovalUnlocked(entry);
     bytes_evicted += entry.mem_usage;
     cache_.erase(iter++);
@@ -422,6 +548,33 @@ void LogCache::AccountForMessageRemovalUnlocked(const CacheEntry& entry) {
   metrics_.num_ops->Decrement();
 }
 
+int64_t LogCache::CompressEntryUnlocked(CacheEntry* entry) {
+  // Nothing would be freed if the message is also referenced from outside of the cache.
+  if (entry->msg.use_count() != 1) {
+    return 0;
+  }
+  const auto serialized = entry->msg->SerializeAsString();
+  auto compressed = std::make_shared<std::string>();
+  snappy::Compress(serialized.data(), serialized.size(), compressed.get());
+  compressed->shrink_to_fit();
+  const int64_t new_mem_usage = sizeof(std::string) + compressed->capacity();
+  if (new_mem_usage >= entry->mem_usage) {
+    return 0;
+  }
+
+  const int64_t freed = entry->mem_usage - new_mem_usage;
+  if (entry->tracked) {
+    tracker_->Release(freed);
+  }
+  metrics_.size->DecrementBy(freed);
+  metrics_.compressed_ops->Increment();
+  entry->mem_usage = new_mem_usage;
+  entry->compressed = std::move(compressed);
+  entry->msg.reset();
+  entry->wire_compressed.reset();
+  return freed;
+}
+
 int64_t LogCache::BytesUsed() const {
   return tracker_->consumption();
 }
@@ -484,6 +637,12 @@ void LogCache::DumpToStrings(vector<string>* lines) const {
   lines->push_back("Messages:");
   for (const auto& entry : cache_) {
     const ReplicateMsgPtr msg = entry.second.msg;
+    if (!msg) {
+      lines->push_back(Substitute("Message[$0] $1.$2 : REPLICATE. Compressed, Size: $3",
+                                  counter++, entry.second.op_id.term, entry.second.op_id.index,
+                                  entry.second.compressed->size()));
+      continue;
+    }
     lines->push_back(
       Substitute("Message[$0] $1.$2 : REPLICATE. Type: $3, Size: $4",
                  counter++, msg->id().term(), msg->id().index(),
@@ -503,6 +662,13 @@ void LogCache::DumpToHtml(std::ostream& out) const {
   int counter = 0;
   for (const auto& entry : cache_) {
     const ReplicateMsgPtr msg = entry.second.msg;
+    if (!msg) {
+      out << Substitute("<tr><th>$0</th><th>$1.$2</th><td>REPLICATE (compressed)</td>"
+                        "<td>$3</td><td></td></tr>",
+                        counter++, entry.second.op_id.term, entry.second.op_id.index,
+                        entry.second.compressed->size()) << endl;
+      continue;
+    }
     out << Substitute("<tr><th>$0</th><th>$1.$2</th><td>REPLICATE $3</td>"
                       "<td>$4</td><td>$5</td></tr>",
                       counter++, msg->id().term(), msg->id().index(),
@@ -522,7 +688,7 @@ void LogCache::TrackOperationsMemory(const OpIds& op_ids) {
   int mem_required = 0;
   for (const auto& op_id : op_ids) {
     auto it = cache_.find(op_id.index);
-    if (it != cache_.end() && it->second.msg->id().term() == op_id.term) {
+    if (it != cache_.end() && it->second.op_id.term == op_id.term) {
       mem_required += it->second.mem_usage;
       it->second.tracked = true;
     }
@@ -556,7 +722,11 @@ void LogCache::TrackOperationsMemory(const OpIds& op_ids) {
 LogCache::Metrics::Metrics(const scoped_refptr<MetricEntity>& metric_entity)
   : INSTANTIATE_METRIC(num_ops, 0),
     INSTANTIATE_METRIC(size, 0),
-    INSTANTIATE_METRIC(disk_reads) {
+    INSTANTIATE_METRIC(disk_reads),
+    INSTANTIATE_METRIC(compressed_ops),
+    INSTANTIATE_METRIC(ops_compression_input_bytes),
+    INSTANTIATE_METRIC(ops_compression_output_bytes),
+    INSTANTIATE_METRIC(ops_compression_time_us) {
 }
 #undef INSTANTIATE_METRIC
 
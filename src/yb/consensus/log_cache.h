@@ -41,11 +41,13 @@
 #include "yb/consensus/log_fwd.h"
 #include "yb/consensus/consensus.pb.h"
 #include "yb/consensus/opid_util.h"
+#include "yb/consensus/ops_compression.h"
 #include "yb/gutil/macros.h"
 
 #include "yb/util/async_util.h"
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
 #include "yb/util/opid.h"
 #include "yb/util/restart_safe_clock.h"
 #include "yb/util/result.h"
@@ -59,8 +61,12 @@ namespace consensus {
 
 class ReplicateMsg;
 
+YB_STRONGLY_TYPED_BOOL(CompressOps);
+
 struct ReadOpsResult {
   ReplicateMsgs messages;
+  // Compressed forms of messages, in the same order. Filled only when requested by ReadOps.
+  std::vector<CompressedReplicateMsgPtr> compressed_messages;
   yb::OpId preceding_op;
   bool have_more_messages = false;
   int64_t read_from_disk_size = 0;
@@ -110,9 +116,13 @@ class LogCache {
   // until 'to_op_index' (inclusive).
   //
   // If 'to_op_index' is 0, then all operations after 'after_op_index' will be included.
+  //
+  // With compress_ops, also fills compressed_messages of the result. The compressed forms of
+  // cached messages are kept in the cache, so they are compressed once for all peers.
   Result<ReadOpsResult> ReadOps(int64_t after_op_index,
                                 int64_t to_op_index,
-                                int max_size_bytes);
+                                int max_size_bytes,
+                                CompressOps compress_ops = CompressOps::kFalse);
 
   // Append the operations into the log and the cache.  When the messages have completed writing
   // into the on-disk log, fires 'callback'.
@@ -142,6 +152,10 @@ class LogCache {
 
   int64_t earliest_op_index() const;
 
+  // Append time of the oldest entry that could be evicted, or CoarseTimePoint::max() if there is
+  // no such entry. Used to evict the least recently appended entries across all tablets first.
+  CoarseTimePoint OldestEvictableEntryTime() const;
+
   // Dump the current contents of the cache to the log.
   void DumpToLog() const;
 
@@ -172,6 +186,8 @@ class LogCache {
  private:
   FRIEND_TEST(LogCacheTest, TestAppendAndGetMessages);
   FRIEND_TEST(LogCacheTest, TestGlobalMemoryLimit);
+  FRIEND_TEST(LogCacheTest, TestCompressColdEntries);
+  FRIEND_TEST(LogCacheTest, TestReadCompressedOps);
   FRIEND_TEST(LogCacheTest, TestReplaceMessages);
   friend class LogCacheTest;
 
@@ -184,6 +200,21 @@ class LogCache {
 
     // Did we start memory tracking for this entry.
     bool tracked = false;
+
+    // Id of the message, also available when msg is compressed.
+    yb::OpId op_id;
+
+    // Wire size of msg, see TotalByteSizeForMessage.
+    int64_t wire_size = 0;
+
+    CoarseTimePoint append_time;
+
+    // Snappy compressed serialized msg, set instead of msg for the entries that were compressed
+    // instead of being evicted, see log_cache_compress_cold_entries.
+    std::shared_ptr<const std::string> compressed;
+
+    // Compressed form of msg sent to peers, see ReadOps.
+    CompressedReplicateMsgPtr wire_compressed;
   };
 
   // Try to evict the oldest operations from the queue, stopping either when
@@ -195,6 +226,17 @@ class LogCache {
   // given message.
   void AccountForMessageRemovalUnlocked(const CacheEntry& entry);
 
+  // Fills missing compressed_messages of the result, storing them to the cache.
+  void CompressReadOps(ReadOpsResult* result);
+
+  // Stores compressed form of the message to the cache entry with the same op id, if present.
+  void StoreWireCompressedUnlocked(const ReplicateMsg& msg,
+                                   const CompressedReplicateMsgPtr& compressed);
+
+  // Replaces the message of the entry with its compressed form. Returns the number of freed bytes,
+  // or 0 if the entry was not compressed.
+  int64_t CompressEntryUnlocked(CacheEntry* entry);
+
   // Return a string with stats
   std::string StatsStringUnlocked() const;
 
@@ -261,6 +303,15 @@ class LogCache {
     scoped_refptr<AtomicGauge<int64_t>> size;
 
     scoped_refptr<Counter> disk_reads;
+
+    // Number of entries that were compressed instead of being evicted.
+    scoped_refptr<Counter> compressed_ops;
+
+    // Sizes of operations before and after compression for sending to peers, and time spent on
+    // this compression.
+    scoped_refptr<Counter> ops_compression_input_bytes;
+    scoped_refptr<Counter> ops_compression_output_bytes;
+    scoped_refptr<Counter> ops_compression_time_us;
   };
   Metrics metrics_;
 
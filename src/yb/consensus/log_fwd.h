@@ -19,6 +19,7 @@
 namespace yb {
 namespace log {
 
+class FileSystemSyncGroup;
 class Log;
 using LogPtr = scoped_refptr<Log>;
 class LogEntryBatch;
@@ -0,0 +1,118 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/log_sync_group.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <unordered_map>
+
+#include "yb/util/errno.h"
+#include "yb/util/logging.h"
+#include "yb/util/stopwatch.h"
+
+namespace yb {
+namespace log {
+
+namespace {
+
+std::mutex groups_mutex;
+std::unordered_map<uint64_t, std::weak_ptr<FileSystemSyncGroup>> groups;
+
+} // namespace
+
+Result<std::shared_ptr<FileSystemSyncGroup>> FileSystemSyncGroup::ForDirectory(
+    const std::string& dir) {
+#if defined(__linux__)
+  struct stat st;
+  if (stat(dir.c_str(), &st) != 0) {
+    return STATUS(IOError, dir, Errno(errno));
+  }
+
+  std::lock_guard<std::mutex> lock(groups_mutex);
+  auto& weak_group = groups[st.st_dev];
+  auto group = weak_group.lock();
+  if (group) {
+    return group;
+  }
+  int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    return STATUS(IOError, dir, Errno(errno));
+  }
+  group.reset(new FileSystemSyncGroup(fd, dir));
+  weak_group = group;
+  return group;
+#else
+  return STATUS(NotSupported, "Sync of whole file system is not supported on this platform");
+#endif
+}
+
+FileSystemSyncGroup::FileSystemSyncGroup(int fd, std::string path)
+    : fd_(fd), path_(std::move(path)) {
+}
+
+FileSystemSyncGroup::~FileSystemSyncGroup() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+Status FileSystemSyncGroup::Sync() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const uint64_t ticket = ++requested_;
+  for (;;) {
+    if (synced_ >= ticket) {
+      return last_status_;
+    }
+    if (!sync_in_progress_) {
+      break;
+    }
+    cond_.wait(lock);
+  }
+
+  // All callers that took their ticket before this point have finished their writes, so this
+  // syncfs() covers them.
+  sync_in_progress_ = true;
+  const uint64_t covered = requested_;
+  lock.unlock();
+
+  Status status;
+#if defined(__linux__)
+  // Writeback errors are reported by syncfs() starting with Linux 5.8.
+  LOG_SLOW_EXECUTION(WARNING, 50, "syncfs for " + path_) {
+    if (syncfs(fd_) != 0) {
+      status = STATUS(IOError, "syncfs failed for " + path_, Errno(errno));
+    }
+  }
+#else
+  status = STATUS(NotSupported, "Sync of whole file system is not supported on this platform");
+#endif
+
+  lock.lock();
+  sync_in_progress_ = false;
+  synced_ = covered;
+  last_status_ = status;
+  ++num_syncs_;
+  cond_.notify_all();
+  return status;
+}
+
+uint64_t FileSystemSyncGroup::num_syncs() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_syncs_;
+}
+
+} // namespace log
+} // namespace yb
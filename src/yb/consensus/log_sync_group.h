@@ -0,0 +1,75 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_LOG_SYNC_GROUP_H
+#define YB_CONSENSUS_LOG_SYNC_GROUP_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "yb/util/result.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace log {
+
+// Group commit of the logs of different tablets, that reside on the same file system.
+//
+// Each Sync call makes durable all data written to the file system before the call. Only one
+// syncfs() is running at a time. Callers that arrive while it is running wait for it to finish,
+// and then one of them issues the next syncfs() on behalf of all of them. So the number of
+// system calls does not depend on the number of tablets, that sync their logs concurrently.
+class FileSystemSyncGroup {
+ public:
+  // Returns the group shared by all directories on the same file system as dir.
+  static Result<std::shared_ptr<FileSystemSyncGroup>> ForDirectory(const std::string& dir);
+
+  ~FileSystemSyncGroup();
+
+  FileSystemSyncGroup(const FileSystemSyncGroup&) = delete;
+  void operator=(const FileSystemSyncGroup&) = delete;
+
+  CHECKED_STATUS Sync();
+
+  // Number of syncfs() calls issued by this group.
+  uint64_t num_syncs() const;
+
+ private:
+  FileSystemSyncGroup(int fd, std::string path);
+
+  const int fd_;
+  const std::string path_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+
+  // Number of Sync calls that were started.
+  uint64_t requested_ = 0;
+
+  // All Sync calls with ticket not greater than synced_ are covered by a finished syncfs().
+  uint64_t synced_ = 0;
+
+  bool sync_in_progress_ = false;
+
+  // Status of the last finished syncfs().
+  Status last_status_;
+
+  uint64_t num_syncs_ = 0;
+};
+
+} // namespace log
+} // namespace yb
+
+#endif // YB_CONSENSUS_LOG_SYNC_GROUP_H
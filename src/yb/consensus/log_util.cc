@@ -84,6 +84,12 @@ DEFINE_int32(bytes_durable_wal_write_mb, 1,
              "If 0 fsysnc() is not called.");
 TAG_FLAG(bytes_durable_wal_write_mb, stable);
 
+DEFINE_bool(log_group_sync_across_tablets, false,
+            "When durable_wal_write is on, write WAL segments through the page cache and make "
+            "them durable with a single syncfs() call shared by all tablets, that sync their log "
+            "on the same file system at the same time, instead of a synchronous write per tablet.");
+TAG_FLAG(log_group_sync_across_tablets, advanced);
+
 DEFINE_bool(log_preallocate_segments, true,
             "Whether the WAL should preallocate the entire segment before writing to it");
 TAG_FLAG(log_preallocate_segments, advanced);
@@ -141,6 +147,7 @@ LogOptions::LogOptions()
                                      MonoDelta::FromMilliseconds(
                                          FLAGS_interval_durable_wal_write_ms) : MonoDelta()),
       bytes_durable_wal_write_mb(FLAGS_bytes_durable_wal_write_mb),
+      group_sync_across_tablets(FLAGS_log_group_sync_across_tablets),
       preallocate_segments(FLAGS_log_preallocate_segments),
       async_preallocate_segments(FLAGS_log_async_preallocate_segments),
       env(Env::Default()) {
@@ -846,6 +853,10 @@ Status WritableLogSegment::WriteFooterAndClose(const LogSegmentFooterPB& footer)
 
 
 Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
+  return WriteEntryBatch(data, crc::Crc32c(data.data(), data.size()));
+}
+
+Status WritableLogSegment::WriteEntryBatch(const Slice& data, uint32_t msg_crc) {
   DCHECK(is_header_written_);
   DCHECK(!is_footer_written_);
   uint8_t header_buf[kEntryHeaderSize];
@@ -855,7 +866,7 @@ Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
   InlineEncodeFixed32(&header_buf[0], len);
 
   // Then the CRC of the message.
-  uint32_t msg_crc = crc::Crc32c(data.data(), data.size());
+  DCHECK_EQ(msg_crc, crc::Crc32c(data.data(), data.size()));
   InlineEncodeFixed32(&header_buf[4], msg_crc);
 
   // Then the CRC of the header
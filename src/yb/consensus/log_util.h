@@ -93,6 +93,10 @@ struct LogOptions {
   // If non-zero, call fsync on a call to Append() if more than given amount of data to sync.
   int32_t bytes_durable_wal_write_mb;
 
+  // If durable_wal_write is set, share syncs with the logs of other tablets on the same file
+  // system, see FileSystemSyncGroup.
+  bool group_sync_across_tablets;
+
   // Whether to fallocate segments before writing to them.
   bool preallocate_segments;
 
@@ -400,6 +404,9 @@ class WritableLogSegment {
   // Makes sure that the log segment has not been closed.
   CHECKED_STATUS WriteEntryBatch(const Slice& entry_batch_data);
 
+  // Same as above, but uses already computed CRC32C of entry_batch_data.
+  CHECKED_STATUS WriteEntryBatch(const Slice& entry_batch_data, uint32_t entry_batch_crc);
+
   // Makes sure the I/O buffers in the underlying writable file are flushed.
   CHECKED_STATUS Sync() {
     return writable_file_->Sync();
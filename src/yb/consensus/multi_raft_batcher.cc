@@ -0,0 +1,192 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/multi_raft_batcher.h"
+
+#include <map>
+
+#include "yb/consensus/consensus.proxy.h"
+
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/rpc_controller.h"
+#include "yb/rpc/rpc_header.pb.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
+
+using namespace std::literals;
+
+DEFINE_bool(enable_multi_raft_heartbeat_batcher, false,
+            "Send heartbeats of all tablets between the same pair of servers as a single "
+            "MultiRaftUpdateConsensus RPC. Requires all servers to support this RPC.");
+TAG_FLAG(enable_multi_raft_heartbeat_batcher, advanced);
+TAG_FLAG(enable_multi_raft_heartbeat_batcher, runtime);
+
+DEFINE_int32(multi_raft_batch_window_ms, 2,
+             "How long heartbeats are collected into a batch before it is sent.");
+TAG_FLAG(multi_raft_batch_window_ms, advanced);
+TAG_FLAG(multi_raft_batch_window_ms, runtime);
+
+DEFINE_int32(multi_raft_batch_max_size, 1000,
+             "Maximal number of heartbeats in a single batch, the batch is sent as soon as it "
+             "reaches this size.");
+TAG_FLAG(multi_raft_batch_max_size, advanced);
+TAG_FLAG(multi_raft_batch_max_size, runtime);
+
+DECLARE_int32(consensus_rpc_timeout_ms);
+
+namespace yb {
+namespace consensus {
+
+namespace {
+
+std::mutex batchers_mutex;
+std::map<std::pair<rpc::ProxyCache*, std::string>, std::weak_ptr<MultiRaftHeartbeatBatcher>>
+    batchers;
+
+} // namespace
+
+struct MultiRaftHeartbeatBatcher::Batch {
+  struct Item {
+    ConsensusResponsePB* response;
+    Status* status;
+    rpc::ResponseCallback callback;
+  };
+
+  MultiRaftConsensusRequestPB request;
+  MultiRaftConsensusResponsePB response;
+  rpc::RpcController controller;
+  std::vector<Item> items;
+};
+
+std::shared_ptr<MultiRaftHeartbeatBatcher> MultiRaftHeartbeatBatcher::Get(
+    rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, const HostPort& hostport) {
+  std::lock_guard<std::mutex> lock(batchers_mutex);
+  auto& weak_batcher = batchers[std::make_pair(proxy_cache, hostport.ToString())];
+  auto batcher = weak_batcher.lock();
+  if (!batcher) {
+    batcher = std::make_shared<MultiRaftHeartbeatBatcher>(messenger, proxy_cache, hostport);
+    weak_batcher = batcher;
+  }
+  return batcher;
+}
+
+MultiRaftHeartbeatBatcher::MultiRaftHeartbeatBatcher(
+    rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, const HostPort& hostport)
+    : messenger_(messenger),
+      hostport_(hostport),
+      proxy_(std::make_unique<ConsensusServiceProxy>(proxy_cache, hostport)) {
+}
+
+MultiRaftHeartbeatBatcher::~MultiRaftHeartbeatBatcher() {
+  // Every scheduled flush and every batch RPC holds a reference to the batcher.
+  DCHECK(!pending_batch_);
+}
+
+bool MultiRaftHeartbeatBatcher::AddRequest(const ConsensusRequestPB& request,
+                                           ConsensusResponsePB* response,
+                                           Status* status,
+                                           rpc::ResponseCallback callback) {
+  if (unsupported_.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  bool schedule_flush = false;
+  bool flush_now = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pending_batch_) {
+      pending_batch_ = std::make_shared<Batch>();
+      schedule_flush = true;
+    }
+    pending_batch_->request.add_consensus_request()->CopyFrom(request);
+    pending_batch_->items.push_back(Batch::Item{response, status, std::move(callback)});
+    flush_now =
+        pending_batch_->request.consensus_request_size() >= FLAGS_multi_raft_batch_max_size;
+  }
+
+  if (flush_now) {
+    Flush(Status::OK());
+  } else if (schedule_flush) {
+    messenger_->scheduler().Schedule(
+        [batcher = shared_from_this()](const Status& status) {
+          batcher->Flush(status);
+        },
+        FLAGS_multi_raft_batch_window_ms * 1ms);
+  }
+  return true;
+}
+
+void MultiRaftHeartbeatBatcher::Flush(const Status& status) {
+  std::shared_ptr<Batch> batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch.swap(pending_batch_);
+  }
+  // Batch was already sent because it reached the max size.
+  if (!batch) {
+    return;
+  }
+
+  if (!status.ok()) {
+    // Messenger is shutting down.
+    for (auto& item : batch->items) {
+      *item.status = status;
+      item.callback();
+    }
+    return;
+  }
+
+  batch->controller.set_invoke_callback_mode(rpc::InvokeCallbackMode::kThreadPoolHigh);
+  batch->controller.set_timeout(FLAGS_consensus_rpc_timeout_ms * 1ms);
+  proxy_->MultiRaftUpdateConsensusAsync(
+      batch->request, &batch->response, &batch->controller,
+      [batcher = shared_from_this(), batch] {
+        batcher->ProcessResponse(batch);
+      });
+}
+
+void MultiRaftHeartbeatBatcher::ProcessResponse(const std::shared_ptr<Batch>& batch) {
+  Status status = batch->controller.status();
+  if (status.ok()) {
+    status = batch->controller.thread_pool_failure();
+  }
+  if (status.ok() &&
+      batch->response.consensus_response_size() != batch->request.consensus_request_size()) {
+    status = STATUS_FORMAT(
+        IllegalState, "Wrong number of responses from $0: $1, while $2 requests were sent",
+        hostport_, batch->response.consensus_response_size(),
+        batch->request.consensus_request_size());
+  }
+  if (!status.ok()) {
+    const auto* error = batch->controller.error_response();
+    if (error && error->code() == rpc::ErrorStatusPB::ERROR_NO_SUCH_METHOD) {
+      LOG(WARNING) << hostport_ << " does not support MultiRaftUpdateConsensus, "
+                   << "sending heartbeats one by one";
+      unsupported_.store(true, std::memory_order_release);
+    }
+  }
+
+  for (size_t i = 0; i != batch->items.size(); ++i) {
+    auto& item = batch->items[i];
+    if (status.ok()) {
+      item.response->Swap(batch->response.mutable_consensus_response(static_cast<int>(i)));
+    } else {
+      *item.status = status;
+    }
+    item.callback();
+  }
+}
+
+} // namespace consensus
+} // namespace yb
@@ -0,0 +1,81 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+#define YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "yb/consensus/consensus_fwd.h"
+#include "yb/consensus/consensus.pb.h"
+
+#include "yb/rpc/response_callback.h"
+
+#include "yb/util/net/net_util.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+namespace rpc {
+class Messenger;
+class ProxyCache;
+}
+
+namespace consensus {
+
+// Coalesces heartbeats of all tablets, that are sent by this server to the same remote server,
+// into a single MultiRaftUpdateConsensus RPC.
+//
+// The first request of a batch schedules its sending after --multi_raft_batch_window_ms, so
+// heartbeats are delayed by at most this window. Batches are sent independently of each other,
+// a slow batch does not hold requests that were added after it was sent.
+class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftHeartbeatBatcher> {
+ public:
+  // Returns the batcher shared by all peers, that send requests to hostport via proxy_cache.
+  static std::shared_ptr<MultiRaftHeartbeatBatcher> Get(
+      rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, const HostPort& hostport);
+
+  MultiRaftHeartbeatBatcher(
+      rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, const HostPort& hostport);
+  ~MultiRaftHeartbeatBatcher();
+
+  // Adds request to the next batch. When the batch RPC is finished, fills response, or sets
+  // status to the error of the batch RPC, and invokes callback.
+  // Returns false if the remote server does not support batches, so the request should be sent
+  // on its own.
+  bool AddRequest(const ConsensusRequestPB& request,
+                  ConsensusResponsePB* response,
+                  Status* status,
+                  rpc::ResponseCallback callback);
+
+ private:
+  struct Batch;
+
+  void Flush(const Status& status);
+  void ProcessResponse(const std::shared_ptr<Batch>& batch);
+
+  rpc::Messenger* const messenger_;
+  const HostPort hostport_;
+  const std::unique_ptr<ConsensusServiceProxy> proxy_;
+
+  std::mutex mutex_;
+  std::shared_ptr<Batch> pending_batch_;
+  std::atomic<bool> unsupported_{false};
+};
+
+} // namespace consensus
+} // namespace yb
+
+#endif // YB_CONSENSUS_MULTI_RAFT_BATCHER_H
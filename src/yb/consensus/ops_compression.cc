@@ -0,0 +1,77 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/ops_compression.h"
+
+#include <lz4.h>
+
+#include <string>
+
+namespace yb {
+namespace consensus {
+
+CompressedReplicateMsgPtr CompressReplicateMsg(const ReplicateMsg& msg) {
+  auto result = std::make_shared<CompressedReplicateMsgPB>();
+  const auto serialized = msg.SerializeAsString();
+  auto* data = result->mutable_data();
+  data->resize(LZ4_compressBound(serialized.size()));
+  int compressed_size = LZ4_compress_default(
+      serialized.data(), &(*data)[0], serialized.size(), data->size());
+  if (compressed_size > 0 && static_cast<size_t>(compressed_size) < serialized.size()) {
+    data->resize(compressed_size);
+    data->shrink_to_fit();
+    result->set_uncompressed_size(serialized.size());
+  } else {
+    *data = serialized;
+  }
+  return result;
+}
+
+Status DecompressOps(ConsensusRequestPB* request) {
+  if (request->ops_compression() != OPS_COMPRESSION_LZ4) {
+    return STATUS_FORMAT(
+        NotSupported, "Unsupported ops compression: $0",
+        OpsCompressionPB_Name(request->ops_compression()));
+  }
+  if (!request->ops().empty()) {
+    return STATUS(InvalidArgument, "Both compressed and uncompressed ops are present");
+  }
+
+  std::string buffer;
+  for (const auto& compressed : request->compressed_ops()) {
+    auto* msg = request->add_ops();
+    if (!compressed.has_uncompressed_size()) {
+      if (!msg->ParseFromString(compressed.data())) {
+        return STATUS(Corruption, "Failed to parse replicate message");
+      }
+      continue;
+    }
+    buffer.resize(compressed.uncompressed_size());
+    int size = LZ4_decompress_safe(
+        compressed.data().data(), &buffer[0], compressed.data().size(), buffer.size());
+    if (size < 0 || static_cast<size_t>(size) != compressed.uncompressed_size()) {
+      return STATUS_FORMAT(
+          Corruption, "Failed to decompress replicate message, result: $0, expected size: $1",
+          size, compressed.uncompressed_size());
+    }
+    if (!msg->ParseFromString(buffer)) {
+      return STATUS(Corruption, "Failed to parse replicate message");
+    }
+  }
+  request->clear_compressed_ops();
+  request->clear_ops_compression();
+  return Status::OK();
+}
+
+} // namespace consensus
+} // namespace yb
@@ -0,0 +1,38 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_OPS_COMPRESSION_H
+#define YB_CONSENSUS_OPS_COMPRESSION_H
+
+#include <memory>
+
+#include "yb/consensus/consensus.pb.h"
+
+#include "yb/util/status.h"
+
+namespace yb {
+namespace consensus {
+
+typedef std::shared_ptr<const CompressedReplicateMsgPB> CompressedReplicateMsgPtr;
+
+// Compresses serialized msg with LZ4. Message is stored uncompressed if compression does not
+// make it smaller.
+CompressedReplicateMsgPtr CompressReplicateMsg(const ReplicateMsg& msg);
+
+// Moves compressed_ops of the request to ops.
+CHECKED_STATUS DecompressOps(ConsensusRequestPB* request);
+
+} // namespace consensus
+} // namespace yb
+
+#endif // YB_CONSENSUS_OPS_COMPRESSION_H
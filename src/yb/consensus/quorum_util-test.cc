@@ -71,5 +71,20 @@ TEST(QuorumUtilTest, TestMemberExtraction) {
   ASSERT_EQ("B", peer_pb.permanent_uuid());
 }
 
+TEST(QuorumUtilTest, TestWitness) {
+  RaftConfigPB config;
+  SetPeerInfo("A", RaftPeerPB::VOTER, config.add_peers());
+  SetPeerInfo("B", RaftPeerPB::VOTER, config.add_peers());
+  auto* witness = config.add_peers();
+  SetPeerInfo("C", RaftPeerPB::VOTER, witness);
+  witness->set_witness(true);
+
+  ASSERT_FALSE(IsRaftConfigWitness("A", config));
+  ASSERT_TRUE(IsRaftConfigWitness("C", config));
+  ASSERT_FALSE(IsRaftConfigWitness("invalid", config));
+  // Witness is a voter.
+  ASSERT_TRUE(IsRaftConfigVoter("C", config));
+}
+
 } // namespace consensus
 } // namespace yb
@@ -149,6 +149,7 @@ class RaftConsensusSpy : public RaftConsensus {
                     std::move(queue),
                     std::move(peer_manager),
                     std::move(raft_pool_token),
+                    nullptr /* apply_pool_token */,
                     table_metric_entity,
                     tablet_metric_entity,
                     peer_uuid,
@@ -47,6 +47,7 @@
 #include "yb/consensus/consensus_round.h"
 #include "yb/consensus/leader_election.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/ops_compression.h"
 #include "yb/consensus/peer_manager.h"
 #include "yb/consensus/quorum_util.h"
 #include "yb/consensus/replica_state.h"
@@ -151,6 +152,10 @@ METRIC_DEFINE_counter(tablet, follower_memory_pressure_rejections,
                       yb::MetricUnit::kRequests,
                       "Number of RPC requests rejected due to "
                       "memory pressure while FOLLOWER.");
+METRIC_DEFINE_counter(tablet, follower_ops_decompression_time_us,
+                      "Follower Ops Decompression Time",
+                      yb::MetricUnit::kMicroseconds,
+                      "Time spent decompressing operations received from the leader.");
 METRIC_DEFINE_gauge_int64(tablet, raft_term,
                           "Current Raft Consensus Term",
                           yb::MetricUnit::kUnits,
@@ -232,6 +237,13 @@ DEFINE_int64(protege_synchronization_timeout_ms, 1000,
              "Timeout to synchronize protege before performing step down. "
              "0 to disable synchronization.");
 
+DEFINE_bool(leader_lease_handover_on_stepdown, false,
+            "Whether a leader that steps down in favor of a protege hands its leader lease over "
+            "to it, so the protege does not wait for the old lease to expire and skips the "
+            "pre-election after winning the election.");
+TAG_FLAG(leader_lease_handover_on_stepdown, advanced);
+TAG_FLAG(leader_lease_handover_on_stepdown, runtime);
+
 namespace yb {
 namespace consensus {
 
@@ -323,6 +335,7 @@ shared_ptr<RaftConsensus> RaftConsensus::Create(
     const Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk,
     TableType table_type,
     ThreadPool* raft_pool,
+    ThreadPool* raft_apply_pool,
     RetryableRequests* retryable_requests) {
   auto rpc_factory = std::make_unique<RpcPeerProxyFactory>(
       messenger, proxy_cache, local_peer_pb.cloud_info());
@@ -367,6 +380,7 @@ shared_ptr<RaftConsensus> RaftConsensus::Create(
       std::move(queue),
       std::move(peer_manager),
       std::move(raft_pool_token),
+      raft_apply_pool ? raft_apply_pool->NewToken(ThreadPool::ExecutionMode::SERIAL) : nullptr,
       table_metric_entity,
       tablet_metric_entity,
       peer_uuid,
@@ -385,6 +399,7 @@ RaftConsensus::RaftConsensus(
     std::unique_ptr<PeerMessageQueue> queue,
     std::unique_ptr<PeerManager> peer_manager,
     std::unique_ptr<ThreadPoolToken> raft_pool_token,
+    std::unique_ptr<ThreadPoolToken> apply_pool_token,
     const scoped_refptr<MetricEntity>& table_metric_entity,
     const scoped_refptr<MetricEntity>& tablet_metric_entity,
     const std::string& peer_uuid, const scoped_refptr<server::Clock>& clock,
@@ -394,6 +409,7 @@ RaftConsensus::RaftConsensus(
     TableType table_type,
     RetryableRequests* retryable_requests)
     : raft_pool_token_(std::move(raft_pool_token)),
+      apply_pool_token_(std::move(apply_pool_token)),
       log_(log),
       clock_(clock),
       peer_proxy_factory_(std::move(proxy_factory)),
@@ -406,6 +422,8 @@ RaftConsensus::RaftConsensus(
       shutdown_(false),
       follower_memory_pressure_rejections_(tablet_metric_entity->FindOrCreateCounter(
           &METRIC_follower_memory_pressure_rejections)),
+      ops_decompression_time_us_(tablet_metric_entity->FindOrCreateCounter(
+          &METRIC_follower_ops_decompression_time_us)),
       term_metric_(tablet_metric_entity->FindOrCreateGauge(&METRIC_raft_term,
                                                     cmeta->current_term())),
       follower_last_update_time_ms_metric_(
@@ -432,7 +450,8 @@ RaftConsensus::RaftConsensus(
       DCHECK_NOTNULL(consensus_context),
       this,
       retryable_requests,
-      std::bind(&PeerMessageQueue::TrackOperationsMemory, queue_.get(), _1));
+      std::bind(&PeerMessageQueue::TrackOperationsMemory, queue_.get(), _1),
+      apply_pool_token_.get());
 
   peer_manager_->SetConsensus(this);
 }
@@ -552,8 +571,15 @@ Status RaftConsensus::DoStartElection(const LeaderElectionData& data, PreElected
   // If pre-elections disabled or we already won pre-election then start regular election,
   // otherwise pre-election is started.
   // Pre-elections could be disable via flag, or temporarily if some nodes do not support them.
+  // The old leader that handed over its lease has stepped down in favor of this peer already.
+  const bool lease_handed_over = data.relinquished_lease_term != OpId::kUnknownTerm;
   auto preelection = ANNOTATE_UNPROTECTED_READ(FLAGS_use_preelection) && !preelected &&
+                     !lease_handed_over &&
                      disable_pre_elections_until_ < CoarseMonoClock::now();
+  if (lease_handed_over && data.relinquished_lease_ht.is_valid()) {
+    // Hybrid times assigned by this peer as a leader should be after the ones of the old leader.
+    clock_->Update(data.relinquished_lease_ht);
+  }
   const char* election_name = preelection ? "pre-election" : "election";
 
   LeaderElectionPtr election;
@@ -586,6 +612,12 @@ Status RaftConsensus::DoStartElection(const LeaderElectionData& data, PreElected
           "Not starting $0: Node is currently a non-participant in the raft config: $1",
           election_name, state_->GetActiveConfigUnlocked());
     }
+    if (IsRaftConfigWitness(peer_uuid(), state_->GetActiveConfigUnlocked())) {
+      VLOG_WITH_PREFIX(1) << "Not starting " << election_name << " -- witness";
+      // Witness never becomes leader, so it does not need to detect leader failures.
+      SnoozeFailureDetector(DO_NOT_LOG);
+      return Status::OK();
+    }
 
     // Default is to start the election now. But if we are starting a pending election, see if
     // there is an op id pending upon indeed and if it has been committed to the log. The op id
@@ -738,13 +770,33 @@ Status RaftConsensus::StartStepDownUnlocked(const RaftPeerPB& peer, bool gracefu
   election_state->req.set_dest_uuid(peer.permanent_uuid());
   election_state->req.set_tablet_id(state_->GetOptions().tablet_id);
   election_state->rpc.set_invoke_callback_mode(rpc::InvokeCallbackMode::kThreadPoolHigh);
+
+  LOG_WITH_PREFIX(INFO) << "Transferring leadership to " << peer.permanent_uuid();
+
+  // The lease could be handed over only when no older leader could still have a lease.
+  const auto term = state_->GetCurrentTermUnlocked();
+  const bool handover_lease =
+      FLAGS_leader_lease_handover_on_stepdown &&
+      state_->GetLeaderLeaseStatusUnlocked() == LeaderLeaseStatus::HAS_LEASE &&
+      state_->GetHybridTimeLeaseStatusAtUnlocked(clock_->Now().GetPhysicalValueMicros()) ==
+          LeaderLeaseStatus::HAS_LEASE;
+  if (handover_lease) {
+    // Stop acting as a leader before the protege has a chance to receive the request, so the
+    // lease is not used after it is handed over.
+    RETURN_NOT_OK(BecomeReplicaUnlocked(
+        graceful ? std::string() : peer.permanent_uuid(), MonoDelta()));
+    election_state->req.set_leader_lease_relinquished_term(term);
+    election_state->req.set_leader_lease_relinquished_ht(clock_->Now().ToUint64());
+  }
+
   election_state->proxy->RunLeaderElectionAsync(
       &election_state->req, &election_state->resp, &election_state->rpc,
       std::bind(&RaftConsensus::RunLeaderElectionResponseRpcCallback, this,
           election_state));
 
-  LOG_WITH_PREFIX(INFO) << "Transferring leadership to " << peer.permanent_uuid();
-
+  if (handover_lease) {
+    return Status::OK();
+  }
   return BecomeReplicaUnlocked(
       graceful ? std::string() : peer.permanent_uuid(), MonoDelta());
 }
@@ -816,6 +868,14 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
   const bool forced = (req->has_force_step_down() && req->force_step_down());
   if (req->has_new_leader_uuid()) {
     new_leader_uuid = req->new_leader_uuid();
+    if (IsRaftConfigWitness(new_leader_uuid, state_->GetActiveConfigUnlocked())) {
+      resp->mutable_error()->set_code(TabletServerErrorPB::LEADER_NOT_READY_TO_STEP_DOWN);
+      StatusToPB(
+          STATUS(InvalidArgument, "Suggested peer is a witness"),
+          resp->mutable_error()->mutable_status());
+      // We return OK so that the tablet service won't overwrite the error code.
+      return Status::OK();
+    }
     if (!forced && !queue_->CanPeerBecomeLeader(new_leader_uuid)) {
       resp->mutable_error()->set_code(TabletServerErrorPB::LEADER_NOT_READY_TO_STEP_DOWN);
       StatusToPB(
@@ -830,6 +890,9 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
   if (new_leader_uuid.empty() && !FLAGS_stepdown_disable_graceful_transition &&
       !(req->has_disable_graceful_transition() && req->disable_graceful_transition())) {
     new_leader_uuid = queue_->GetUpToDatePeer();
+    if (IsRaftConfigWitness(new_leader_uuid, state_->GetActiveConfigUnlocked())) {
+      new_leader_uuid.clear();
+    }
     LOG_WITH_PREFIX(INFO) << "Selected up to date candidate protege leader [" << new_leader_uuid
                           << "]";
     graceful_stepdown = true;
@@ -1465,6 +1528,35 @@ void RaftConsensus::TryRemoveFollowerTask(const string& uuid,
               state_->LogPrefix() + "Unable to remove follower " + uuid);
 }
 
+void RaftConsensus::NotifyPeerCaughtUp(const std::string& uuid, int64_t term) {
+  RaftConfigPB committed_config;
+  {
+    auto lock = state_->LockForRead();
+    if (state_->GetCurrentTermUnlocked() != term || state_->IsConfigChangePendingUnlocked()) {
+      return;
+    }
+    committed_config = state_->GetCommittedConfigUnlocked();
+  }
+
+  WARN_NOT_OK(raft_pool_token_->SubmitFunc(std::bind(&RaftConsensus::TryPromotePeerTask,
+                                               shared_from_this(), uuid, committed_config)),
+              state_->LogPrefix() + "Unable to start TryPromotePeerTask");
+}
+
+void RaftConsensus::TryPromotePeerTask(const std::string& uuid,
+                                       const RaftConfigPB& committed_config) {
+  ChangeConfigRequestPB req;
+  req.set_tablet_id(tablet_id());
+  req.mutable_server()->set_permanent_uuid(uuid);
+  req.set_type(CHANGE_ROLE);
+  req.set_cas_config_opid_index(committed_config.opid_index());
+  LOG_WITH_PREFIX(INFO)
+      << "Changing role of peer " << uuid << " that was remote bootstrapped from a follower";
+  boost::optional<TabletServerErrorPB::Code> error_code;
+  WARN_NOT_OK(ChangeConfig(req, &DoNothingStatusCB, &error_code),
+              state_->LogPrefix() + "Unable to change role of " + uuid);
+}
+
 Status RaftConsensus::Update(ConsensusRequestPB* request,
                              ConsensusResponsePB* response,
                              CoarseTimePoint deadline) {
@@ -1474,6 +1566,12 @@ Status RaftConsensus::Update(ConsensusRequestPB* request,
   }
   TEST_PAUSE_IF_FLAG(TEST_follower_pause_update_consensus_requests);
 
+  if (!request->compressed_ops().empty()) {
+    auto start = MonoTime::Now();
+    RETURN_NOT_OK(DecompressOps(request));
+    ops_decompression_time_us_->IncrementBy((MonoTime::Now() - start).ToMicroseconds());
+  }
+
   auto reject_mode = reject_mode_.load(std::memory_order_acquire);
   if (reject_mode != RejectMode::kNone) {
     if (reject_mode == RejectMode::kAll ||
@@ -1498,6 +1596,7 @@ Status RaftConsensus::Update(ConsensusRequestPB* request,
 
   RETURN_NOT_OK(ExecuteHook(PRE_UPDATE));
   response->set_responder_uuid(state_->GetPeerUuid());
+  response->add_supported_ops_compression(OPS_COMPRESSION_LZ4);
 
   VLOG_WITH_PREFIX(2) << "Replica received request: " << request->ShortDebugString();
 
@@ -2483,6 +2582,11 @@ Status RaftConsensus::ChangeConfig(const ChangeConfigRequestPB& req,
                          "member_type received: $1", server_uuid,
                          RaftPeerPB::MemberType_Name(server.member_type())));
         }
+        if (server.witness() && server.member_type() != RaftPeerPB::PRE_VOTER) {
+          return STATUS_FORMAT(InvalidArgument,
+                               "Witness server with UUID $0 must be of member_type PRE_VOTER",
+                               server_uuid);
+        }
         if (server.last_known_private_addr().empty()) {
           return STATUS(InvalidArgument, "server must have last_known_addr specified",
                                          req.ShortDebugString());
@@ -2539,8 +2643,11 @@ Status RaftConsensus::ChangeConfig(const ChangeConfigRequestPB& req,
             Substitute("Server with UUID $0 not a member of the config. RaftConfig: $1",
                        server_uuid, new_config.ShortDebugString()));
         }
-        if (new_peer->member_type() != RaftPeerPB::PRE_OBSERVER &&
-            new_peer->member_type() != RaftPeerPB::PRE_VOTER) {
+        if (new_peer->member_type() == RaftPeerPB::VOTER && new_peer->witness()) {
+          // Promote the witness to a regular voter, that could become leader.
+          new_peer->clear_witness();
+        } else if (new_peer->member_type() != RaftPeerPB::PRE_OBSERVER &&
+                   new_peer->member_type() != RaftPeerPB::PRE_VOTER) {
           return STATUS(IllegalState, Substitute("Cannot change role of server with UUID $0 "
                                                  "because its member type is $1",
                                                  server_uuid, new_peer->member_type()));
@@ -2615,6 +2722,10 @@ void RaftConsensus::Shutdown() {
 
   CHECK_OK(state_->CancelPendingOperations());
 
+  // Committed operations are already removed from pending operations, so they should be applied
+  // before shutdown.
+  state_->WaitForPipelinedApply();
+
   {
     ReplicaState::UniqueLock lock;
     CHECK_OK(state_->LockForShutdown(&lock));
@@ -2625,6 +2736,9 @@ void RaftConsensus::Shutdown() {
 
   // Shut down things that might acquire locks during destruction.
   raft_pool_token_->Shutdown();
+  if (apply_pool_token_) {
+    apply_pool_token_->Shutdown();
+  }
   // We might not have run Start yet, so make sure we have a FD.
   if (failure_detector_) {
     DisableFailureDetector();
@@ -3141,6 +3255,13 @@ void RaftConsensus::DoElectionCallback(const LeaderElectionData& data,
   // Apply lease updates that were possible received from voters.
   state_->UpdateOldLeaderLeaseExpirationOnNonLeaderUnlocked(
       result.old_leader_lease, result.old_leader_ht_lease);
+  if (data.relinquished_lease_term != OpId::kUnknownTerm &&
+      data.relinquished_lease_term + 1 == result.election_term) {
+    // No leader could have been elected between the originator and us, so the leases held by the
+    // originator are the ones it has relinquished.
+    state_->RelinquishOldLeaderLeaseUnlocked(
+        data.originator_uuid, data.relinquished_lease_ht.GetPhysicalValueMicros());
+  }
 
   state_->SetLeaderNoOpCommittedUnlocked(false);
   // Convert role to LEADER.
@@ -3330,6 +3451,10 @@ size_t RaftConsensus::EvictLogCache(size_t bytes_to_evict) {
   return queue_->EvictLogCache(bytes_to_evict);
 }
 
+CoarseTimePoint RaftConsensus::LogCacheOldestEvictableEntryTime() {
+  return queue_->LogCacheOldestEvictableEntryTime();
+}
+
 RetryableRequestsCounts RaftConsensus::TEST_CountRetryableRequests() {
   return state_->TEST_CountRetryableRequests();
 }
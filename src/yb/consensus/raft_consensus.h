@@ -117,9 +117,12 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
     const Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk,
     TableType table_type,
     ThreadPool* raft_pool,
+    ThreadPool* raft_apply_pool,
     RetryableRequests* retryable_requests);
 
   // Creates RaftConsensus.
+  // apply_pool_token is used to apply committed write operations, see enable_pipelined_apply.
+  // Could be null.
   RaftConsensus(
     const ConsensusOptions& options,
     std::unique_ptr<ConsensusMetadata> cmeta,
@@ -127,6 +130,7 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
     std::unique_ptr<PeerMessageQueue> queue,
     std::unique_ptr<PeerManager> peer_manager,
     std::unique_ptr<ThreadPoolToken> raft_pool_token,
+    std::unique_ptr<ThreadPoolToken> apply_pool_token,
     const scoped_refptr<MetricEntity>& table_metric_entity,
     const scoped_refptr<MetricEntity>& tablet_metric_entity,
     const std::string& peer_uuid,
@@ -237,6 +241,7 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
 
   size_t LogCacheSize();
   size_t EvictLogCache(size_t bytes_to_evict);
+  CoarseTimePoint LogCacheOldestEvictableEntryTime();
 
   const scoped_refptr<log::Log>& log() { return log_; }
 
@@ -329,6 +334,8 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
 
   void MajorityReplicatedNumSSTFilesChanged(uint64_t majority_replicated_num_sst_files) override;
 
+  void NotifyPeerCaughtUp(const std::string& uuid, int64_t term) override;
+
   // Control whether printing of log messages should be done for a particular
   // function call.
   enum AllowLogging {
@@ -582,6 +589,10 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
                              const RaftConfigPB& committed_config,
                              const std::string& reason);
 
+  // Changes role of a PRE_VOTER or PRE_OBSERVER peer that was remote bootstrapped from another
+  // follower. Logs a warning on failure, the queue notifies again on the next response.
+  void TryPromotePeerTask(const std::string& uuid, const RaftConfigPB& committed_config);
+
   // Called when the failure detector expires.
   // Submits ReportFailureDetectedTask() to a thread pool.
   void ReportFailureDetected();
@@ -640,6 +651,10 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
   // etc.
   std::unique_ptr<ThreadPoolToken> raft_pool_token_;
 
+  // Serial threadpool token used to apply committed write operations outside of the replica state
+  // lock. Could be null.
+  std::unique_ptr<ThreadPoolToken> apply_pool_token_;
+
   scoped_refptr<log::Log> log_;
   scoped_refptr<server::Clock> clock_;
   std::unique_ptr<PeerProxyFactory> peer_proxy_factory_;
@@ -699,6 +714,7 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
   AtomicBool shutdown_;
 
   scoped_refptr<Counter> follower_memory_pressure_rejections_;
+  scoped_refptr<Counter> ops_decompression_time_us_;
   scoped_refptr<AtomicGauge<int64_t>> term_metric_;
   scoped_refptr<AtomicMillisLag> follower_last_update_time_ms_metric_;
   scoped_refptr<AtomicGauge<int64_t>> is_raft_leader_metric_;
@@ -193,6 +193,7 @@ class RaftConsensusQuorumTest : public YBTest {
           std::move(queue),
           std::move(peer_manager),
           std::move(pool_token),
+          nullptr /* apply_pool_token */,
           table_metric_entity_,
           tablet_metric_entity_,
           config_.peers(i).permanent_uuid(),
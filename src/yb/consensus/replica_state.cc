@@ -49,6 +49,7 @@
 #include "yb/util/logging.h"
 #include "yb/util/opid.h"
 #include "yb/util/status.h"
+#include "yb/util/threadpool.h"
 #include "yb/util/tostring.h"
 #include "yb/util/trace.h"
 #include "yb/util/thread_restrictions.h"
@@ -63,6 +64,13 @@ DEFINE_int32(inject_delay_commit_pre_voter_to_voter_secs, 0,
 TAG_FLAG(inject_delay_commit_pre_voter_to_voter_secs, unsafe);
 TAG_FLAG(inject_delay_commit_pre_voter_to_voter_secs, hidden);
 
+DEFINE_bool(enable_pipelined_apply, false,
+            "Apply committed write operations on a dedicated per-tablet pipeline, so the replica "
+            "state lock is released before they are written to the tablet, and replication of "
+            "the next operations does not wait for the apply.");
+TAG_FLAG(enable_pipelined_apply, advanced);
+TAG_FLAG(enable_pipelined_apply, runtime);
+
 namespace yb {
 namespace consensus {
 
@@ -78,13 +86,15 @@ ReplicaState::ReplicaState(
     ConsensusOptions options, string peer_uuid, std::unique_ptr<ConsensusMetadata> cmeta,
     ConsensusContext* consensus_context, SafeOpIdWaiter* safe_op_id_waiter,
     RetryableRequests* retryable_requests,
-    std::function<void(const OpIds&)> applied_ops_tracker)
+    std::function<void(const OpIds&)> applied_ops_tracker,
+    ThreadPoolToken* apply_pool_token)
     : options_(std::move(options)),
       peer_uuid_(std::move(peer_uuid)),
       cmeta_(std::move(cmeta)),
       context_(consensus_context),
       safe_op_id_waiter_(safe_op_id_waiter),
-      applied_ops_tracker_(std::move(applied_ops_tracker)) {
+      applied_ops_tracker_(std::move(applied_ops_tracker)),
+      apply_pool_token_(apply_pool_token) {
   CHECK(cmeta_) << "ConsensusMeta passed as NULL";
   if (retryable_requests) {
     retryable_requests_ = std::move(*retryable_requests);
@@ -836,6 +846,13 @@ Status ReplicaState::ApplyPendingOperationsUnlocked(
   OpIds applied_op_ids;
   applied_op_ids.reserve(committed_op_id.index - prev_id.index);
 
+  // Write operations are only ordered between themselves and do not change the replica state,
+  // so they could be applied after the lock is released. Other operations are applied here, after
+  // all write operations preceding them.
+  const bool pipelined_apply =
+      apply_pool_token_ && GetAtomicFlag(&FLAGS_enable_pipelined_apply);
+  ConsensusRounds pipelined_rounds;
+
   Status status;
 
   while (!pending_operations_.empty()) {
@@ -896,9 +913,21 @@ Status ReplicaState::ApplyPendingOperationsUnlocked(
     }
 
     prev_id = current_id;
+    if (pipelined_apply && type == OperationType::WRITE_OP) {
+      pipelined_rounds.push_back(round);
+      continue;
+    }
+    if (!pipelined_rounds.empty()) {
+      SubmitToApplyPipelineUnlocked(&pipelined_rounds, leader_term);
+    }
+    WaitForPipelinedApply();
     NotifyReplicationFinishedUnlocked(round, Status::OK(), leader_term, &applied_op_ids);
   }
 
+  if (!pipelined_rounds.empty()) {
+    SubmitToApplyPipelineUnlocked(&pipelined_rounds, leader_term);
+  }
+
   SetLastCommittedIndexUnlocked(prev_id);
 
   applied_ops_tracker_(applied_op_ids);
@@ -906,6 +935,37 @@ Status ReplicaState::ApplyPendingOperationsUnlocked(
   return status;
 }
 
+void ReplicaState::SubmitToApplyPipelineUnlocked(ConsensusRounds* rounds, int64_t leader_term) {
+  auto task_rounds = std::make_shared<ConsensusRounds>(std::move(*rounds));
+  rounds->clear();
+  pipelined_apply_tasks_.fetch_add(1, std::memory_order_acq_rel);
+  auto status = apply_pool_token_->SubmitFunc([this, task_rounds, leader_term] {
+    ApplyPipelinedRounds(*task_rounds, leader_term);
+  });
+  if (!status.ok()) {
+    // The pipeline is shut down after consensus, so it should not happen. But committed operations
+    // have to be applied anyway.
+    LOG_WITH_PREFIX(DFATAL) << "Failed to submit operations to apply pipeline: " << status;
+    ApplyPipelinedRounds(*task_rounds, leader_term);
+  }
+}
+
+void ReplicaState::ApplyPipelinedRounds(const ConsensusRounds& rounds, int64_t leader_term) {
+  OpIds applied_op_ids;
+  applied_op_ids.reserve(rounds.size());
+  for (const auto& round : rounds) {
+    round->NotifyReplicationFinished(Status::OK(), leader_term, &applied_op_ids);
+  }
+  applied_ops_tracker_(applied_op_ids);
+  pipelined_apply_tasks_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void ReplicaState::WaitForPipelinedApply() {
+  if (pipelined_apply_tasks_.load(std::memory_order_acquire) != 0) {
+    apply_pool_token_->Wait();
+  }
+}
+
 void ReplicaState::ApplyConfigChangeUnlocked(const ConsensusRoundPtr& round) {
   DCHECK(round->replicate_msg()->change_config_record().has_old_config());
   DCHECK(round->replicate_msg()->change_config_record().has_new_config());
@@ -1084,6 +1144,19 @@ Status ReplicaState::CheckOpInSequence(const yb::OpId& previous, const yb::OpId&
   return Status::OK();
 }
 
+void ReplicaState::RelinquishOldLeaderLeaseUnlocked(
+    const std::string& holder_uuid, MicrosTime ht_lease_expiration) {
+  if (old_leader_lease_.holder_uuid == holder_uuid) {
+    LOG_WITH_PREFIX(INFO) << "Old leader " << holder_uuid << " relinquished lease: "
+                          << MonoDelta(old_leader_lease_.expiration - CoarseMonoClock::now());
+    old_leader_lease_.Reset();
+  }
+  if (old_leader_ht_lease_.holder_uuid == holder_uuid &&
+      old_leader_ht_lease_.expiration > ht_lease_expiration) {
+    old_leader_ht_lease_.expiration = ht_lease_expiration;
+  }
+}
+
 void ReplicaState::UpdateOldLeaderLeaseExpirationOnNonLeaderUnlocked(
     const CoarseTimeLease& lease, const PhysicalComponentLease& ht_lease) {
   old_leader_lease_.TryUpdate(lease);
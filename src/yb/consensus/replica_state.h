@@ -61,6 +61,7 @@ namespace yb {
 class HostPort;
 class ReplicaState;
 class ThreadPool;
+class ThreadPoolToken;
 
 namespace consensus {
 
@@ -118,11 +119,15 @@ class ReplicaState {
 
   typedef std::unique_lock<std::mutex> UniqueLock;
 
+  // apply_pool_token is used to apply committed write operations outside of the replica state
+  // lock, when enabled by enable_pipelined_apply. Could be null, then all operations are applied
+  // under the lock.
   ReplicaState(
       ConsensusOptions options, std::string peer_uuid, std::unique_ptr<ConsensusMetadata> cmeta,
       ConsensusContext* consensus_context, SafeOpIdWaiter* safe_op_id_waiter,
       RetryableRequests* retryable_requests,
-      std::function<void(const OpIds&)> applied_ops_tracker);
+      std::function<void(const OpIds&)> applied_ops_tracker,
+      ThreadPoolToken* apply_pool_token);
 
   ~ReplicaState();
 
@@ -371,6 +376,11 @@ class ReplicaState {
   void UpdateOldLeaderLeaseExpirationOnNonLeaderUnlocked(
       const CoarseTimeLease& lease, const PhysicalComponentLease& ht_lease);
 
+  // Resets the old leader lease, and limits the old leader hybrid time lease to
+  // ht_lease_expiration, when they are held by the specified peer that has relinquished them.
+  void RelinquishOldLeaderLeaseUnlocked(
+      const std::string& holder_uuid, MicrosTime ht_lease_expiration);
+
   void SetMajorityReplicatedLeaseExpirationUnlocked(
       const MajorityReplicatedData& majority_replicated_data,
       EnumBitSet<SetMajorityReplicatedLeaseExpirationFlag> flags);
@@ -426,6 +436,10 @@ class ReplicaState {
       const ConsensusRoundPtr& round, const Status& status, int64_t leader_term,
       OpIds* applied_op_ids);
 
+  // Waits until all operations passed to the apply pipeline are applied.
+  // Should not be called from the apply pool.
+  void WaitForPipelinedApply();
+
  private:
   typedef std::deque<ConsensusRoundPtr> PendingOperations;
 
@@ -439,6 +453,12 @@ class ReplicaState {
 
   void SetLastCommittedIndexUnlocked(const yb::OpId& committed_op_id);
 
+  // Passes committed rounds to the apply pipeline. They are applied in order, after all rounds
+  // passed before. Applies them in the current thread if the pipeline was shut down.
+  void SubmitToApplyPipelineUnlocked(ConsensusRounds* rounds, int64_t leader_term);
+
+  void ApplyPipelinedRounds(const ConsensusRounds& rounds, int64_t leader_term);
+
   // Applies committed config change.
   void ApplyConfigChangeUnlocked(const ConsensusRoundPtr& round);
 
@@ -532,6 +552,11 @@ class ReplicaState {
 
   std::function<void(const OpIds&)> applied_ops_tracker_;
 
+  ThreadPoolToken* const apply_pool_token_;
+
+  // Number of submitted apply pipeline tasks that did not finish yet.
+  std::atomic<int64_t> pipelined_apply_tasks_{0};
+
   struct LeaderStateCache {
     static constexpr size_t kStatusBits = 3;
     static_assert(kLeaderStatusMapSize <= (1 << kStatusBits),
@@ -13,13 +13,16 @@
 
 #include "yb/docdb/bounded_rocksdb_iterator.h"
 
+#include "yb/docdb/value_log.h"
+
 namespace yb {
 namespace docdb {
 
 BoundedRocksDbIterator::BoundedRocksDbIterator(
     rocksdb::DB* rocksdb, const rocksdb::ReadOptions& read_opts,
-    const KeyBounds* key_bounds)
-    : iterator_(rocksdb->NewIterator(read_opts)), key_bounds_(key_bounds) {
+    const KeyBounds* key_bounds, ValueLog* value_log)
+    : iterator_(rocksdb->NewIterator(read_opts)), key_bounds_(key_bounds),
+      value_log_(value_log && value_log->MayHaveReferences() ? value_log : nullptr) {
   CHECK_NOTNULL(key_bounds_);
   VLOG(3) << "key_bounds_ = " << yb::ToString(key_bounds_);
 }
@@ -76,10 +79,30 @@ Slice BoundedRocksDbIterator::key() const {
 }
 
 Slice BoundedRocksDbIterator::value() const {
-  return iterator_->value();
+  auto value = iterator_->value();
+  if (!value_log_ || !ValueLog::FindReference(value)) {
+    return value;
+  }
+  if (value == Slice(resolved_reference_)) {
+    return resolved_value_;
+  }
+
+  auto status = value_log_->Resolve(value, &resolved_value_);
+  if (!status.ok()) {
+    // The reference could not be decoded as a value, so readers fail with the corruption error.
+    LOG(WARNING) << "Failed to read value of " << key().ToDebugHexString() << ": " << status;
+    value_log_status_ = status;
+    resolved_reference_.clear();
+    return value;
+  }
+  resolved_reference_.assign(value.cdata(), value.size());
+  return resolved_value_;
 }
 
 Status BoundedRocksDbIterator::status() const {
+  if (!value_log_status_.ok()) {
+    return value_log_status_;
+  }
   return iterator_->status();
 }
 
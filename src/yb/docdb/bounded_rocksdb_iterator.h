@@ -25,12 +25,17 @@ namespace yb {
 
 namespace docdb {
 
+class ValueLog;
+
 class BoundedRocksDbIterator : public rocksdb::Iterator {
  public:
   BoundedRocksDbIterator() = default;
 
+  // When value_log is not null, values stored in it are returned instead of their references.
+  // Values are not checked for references when the value log does not have files.
   BoundedRocksDbIterator(
-      rocksdb::DB* rocksdb, const rocksdb::ReadOptions& read_opts, const KeyBounds* key_bounds);
+      rocksdb::DB* rocksdb, const rocksdb::ReadOptions& read_opts, const KeyBounds* key_bounds,
+      ValueLog* value_log = nullptr);
 
   BoundedRocksDbIterator(const BoundedRocksDbIterator& other) = delete;
   void operator=(const BoundedRocksDbIterator& other) = delete;
@@ -54,6 +59,7 @@ class BoundedRocksDbIterator : public rocksdb::Iterator {
 
   Slice key() const override;
 
+  // The value read from the value log is valid until the next call of value().
   Slice value() const override;
 
   Status status() const override;
@@ -77,6 +83,13 @@ class BoundedRocksDbIterator : public rocksdb::Iterator {
  private:
   std::unique_ptr<rocksdb::Iterator> iterator_;
   const KeyBounds* key_bounds_;
+  ValueLog* value_log_ = nullptr;
+
+  // The last resolved value log reference and its value, the same value could be requested
+  // multiple times.
+  mutable std::string resolved_reference_;
+  mutable std::string resolved_value_;
+  mutable Status value_log_status_;
 };
 
 } // namespace docdb
@@ -26,9 +26,12 @@
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/lock_batch.h"
 #include "yb/docdb/shared_lock_manager.h"
 #include "yb/docdb/transaction_dump.h"
 
+#include "yb/util/atomic.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/metrics.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/trace.h"
@@ -37,6 +40,20 @@
 using namespace std::literals;
 using namespace std::placeholders;
 
+DEFINE_bool(conflict_resolution_single_pass, true,
+            "Read intents that conflict with a transaction write batch in a single forward pass of "
+            "the intents DB iterator, instead of seeking for each intent of the batch.");
+TAG_FLAG(conflict_resolution_single_pass, advanced);
+
+DEFINE_int32(transaction_conflict_max_wait_ms, 0,
+             "When positive, an operation that conflicts with a higher priority transaction "
+             "releases its locks and waits up to this amount of time for the transaction to be "
+             "applied or removed at the tablet, instead of failing with a conflict error right "
+             "away. Only lower priority operations wait for higher priority ones, so waits "
+             "could not form a deadlock cycle.");
+TAG_FLAG(transaction_conflict_max_wait_ms, advanced);
+TAG_FLAG(transaction_conflict_max_wait_ms, runtime);
+
 namespace yb {
 namespace docdb {
 
@@ -44,6 +61,10 @@ namespace {
 
 using TransactionIdSet = std::unordered_set<TransactionId, TransactionIdHash>;
 
+// Bounds of the delay between attempts to reacquire locks after waiting for a transaction.
+constexpr auto kMinRelockRetryDelay = 1ms;
+constexpr auto kMaxRelockRetryDelay = 50ms;
+
 struct TransactionData {
   TransactionId id;
   TransactionStatus status;
@@ -111,10 +132,12 @@ class ConflictResolver : public std::enable_shared_from_this<ConflictResolver> {
                    TransactionStatusManager* status_manager,
                    PartialRangeKeyIntents partial_range_key_intents,
                    std::unique_ptr<ConflictResolverContext> context,
+                   LockBatch* lock_batch,
+                   CoarseTimePoint deadline,
                    ResolutionCallback callback)
       : doc_db_(doc_db), status_manager_(*status_manager), request_scope_(status_manager),
         partial_range_key_intents_(partial_range_key_intents), context_(std::move(context)),
-        callback_(std::move(callback)) {}
+        lock_batch_(lock_batch), deadline_(deadline), callback_(std::move(callback)) {}
 
   PartialRangeKeyIntents partial_range_key_intents() {
     return partial_range_key_intents_;
@@ -147,15 +170,29 @@ class ConflictResolver : public std::enable_shared_from_this<ConflictResolver> {
     ResolveConflicts();
   }
 
+  // Switches ReadIntentConflicts to the single pass mode, where it should be invoked for keys in
+  // increasing order, that are not greater than max_key. In this mode the intents iterator is
+  // bounded by max_key and only moved forward, so close keys are reached with Next() instead of
+  // seeking for each key.
+  void StartSinglePassIntentScan(const Slice& max_key) {
+    single_pass_upperbound_.Reset(max_key);
+    single_pass_upperbound_.AppendValueType(ValueType::kMaxByte);
+  }
+
   // Reads conflicts for specified intent from DB.
   CHECKED_STATUS ReadIntentConflicts(IntentTypeSet type, KeyBytes* intent_key_prefix) {
     EnsureIntentIteratorCreated();
 
     const auto conflicting_intent_types = kIntentTypeSetConflicts[type.ToUIntPtr()];
 
-    KeyBytes upperbound_key(*intent_key_prefix);
-    upperbound_key.AppendValueType(ValueType::kMaxByte);
-    intent_key_upperbound_ = upperbound_key.AsSlice();
+    KeyBytes upperbound_key;
+    if (single_pass_upperbound_.empty()) {
+      upperbound_key.Reset(intent_key_prefix->AsSlice());
+      upperbound_key.AppendValueType(ValueType::kMaxByte);
+      intent_key_upperbound_ = upperbound_key.AsSlice();
+    } else {
+      intent_key_upperbound_ = single_pass_upperbound_.AsSlice();
+    }
 
     size_t original_size = intent_key_prefix->size();
     intent_key_prefix->AppendValueType(ValueType::kIntentTypeSet);
@@ -170,7 +207,11 @@ class ConflictResolver : public std::enable_shared_from_this<ConflictResolver> {
     });
     Slice prefix_slice(intent_key_prefix->AsSlice().data(), original_size);
     VLOG_WITH_PREFIX_AND_FUNC(4) << "Seek: " << intent_key_prefix->AsSlice().ToDebugString();
-    intent_iter_.Seek(intent_key_prefix->AsSlice());
+    if (single_pass_upperbound_.empty()) {
+      intent_iter_.Seek(intent_key_prefix->AsSlice());
+    } else {
+      SeekIntentIterForward(intent_key_prefix->AsSlice());
+    }
     while (intent_iter_.Valid()) {
       auto existing_key = intent_iter_.key();
       auto existing_value = intent_iter_.value();
@@ -214,6 +255,34 @@ class ConflictResolver : public std::enable_shared_from_this<ConflictResolver> {
     return Status::OK();
   }
 
+  // Positions intent iterator to the first intent not less than target, in the single pass mode.
+  void SeekIntentIterForward(const Slice& target) {
+    // Number of Next() calls to try before falling back to seek.
+    constexpr int kMaxNextsBeforeSeek = 8;
+
+    if (single_pass_scan_started_) {
+      // Intents after the current position were not visited yet, so invalid iterator means that
+      // there are no more intents up to the upperbound.
+      if (!intent_iter_.Valid()) {
+        return;
+      }
+      for (int i = 0; i != kMaxNextsBeforeSeek; ++i) {
+        if (intent_iter_.key().compare(target) >= 0) {
+          return;
+        }
+        intent_iter_.Next();
+        if (!intent_iter_.Valid()) {
+          return;
+        }
+      }
+      if (intent_iter_.key().compare(target) >= 0) {
+        return;
+      }
+    }
+    single_pass_scan_started_ = true;
+    intent_iter_.Seek(target);
+  }
+
   void EnsureIntentIteratorCreated() {
     if (!intent_iter_.Initialized()) {
       intent_iter_ = CreateRocksDBIterator(
@@ -289,12 +358,96 @@ class ConflictResolver : public std::enable_shared_from_this<ConflictResolver> {
       return true;
     }
 
-    RETURN_NOT_OK(context_->CheckPriority(this, RemainingTransactions()));
+    auto status = context_->CheckPriority(this, RemainingTransactions());
+    if (!status.ok()) {
+      if (TransactionError(status) == TransactionErrorCode::kConflict && WaitForBlocker()) {
+        return false;
+      }
+      return status;
+    }
 
     AbortTransactions();
     return false;
   }
 
+  // Starts waiting for the highest priority transaction among the remaining ones, which prevents
+  // us from aborting conflicting transactions. Locks are released while waiting, so the blocker
+  // could proceed with its writes, and conflicts are resolved from scratch after it is done.
+  // Returns false when we should not wait, so the conflict should be reported.
+  bool WaitForBlocker() {
+    auto max_wait_ms = GetAtomicFlag(&FLAGS_transaction_conflict_max_wait_ms);
+    if (max_wait_ms <= 0 || !lock_batch_ || lock_batch_->empty()) {
+      return false;
+    }
+    auto now = CoarseMonoClock::now();
+    if (wait_deadline_ == CoarseTimePoint()) {
+      wait_deadline_ = std::min(deadline_, now + max_wait_ms * 1ms);
+    }
+    if (now >= wait_deadline_) {
+      return false;
+    }
+
+    auto remaining = RemainingTransactions();
+    const auto& blocker = *std::max_element(
+        remaining.begin(), remaining.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.priority < rhs.priority;
+    });
+    VLOG_WITH_PREFIX(4) << "Wait for: " << blocker.id;
+
+    lock_batch_->Unlock();
+    auto self = shared_from_this();
+    // When waiting is not supported, the conflict is reported with locks still released. It is
+    // fine, since the operation fails and does not need them anymore.
+    return status_manager().WaitForTransactionDone(
+        blocker.id, wait_deadline_, [self](const Status& status) {
+      self->WaitForBlockerDone(status);
+    });
+  }
+
+  void WaitForBlockerDone(const Status& status) {
+    if (!status.ok()) {
+      InvokeCallback(status);
+      return;
+    }
+    relock_retry_delay_ = kMinRelockRetryDelay;
+    RelockAndResolve();
+  }
+
+  // Invoked on the scheduler thread, so it should not block waiting for locks held by other
+  // operations. Locks are acquired without waiting, and we retry after a delay if some of them are
+  // busy, until the operation deadline.
+  void RelockAndResolve() {
+    auto now = CoarseMonoClock::now();
+    auto status = lock_batch_->Relock(now);
+    if (!status.ok()) {
+      if (now >= deadline_) {
+        InvokeCallback(status);
+        return;
+      }
+      auto delay = std::min<CoarseDuration>(relock_retry_delay_, deadline_ - now);
+      relock_retry_delay_ = std::min<CoarseDuration>(relock_retry_delay_ * 2, kMaxRelockRetryDelay);
+      auto self = shared_from_this();
+      if (!status_manager().ScheduleRetry(delay, [self](const Status& status) {
+            if (!status.ok()) {
+              self->InvokeCallback(status);
+              return;
+            }
+            self->RelockAndResolve();
+          })) {
+        InvokeCallback(status);
+      }
+      return;
+    }
+
+    conflicts_.clear();
+    transactions_.clear();
+    remaining_transactions_ = 0;
+    single_pass_upperbound_.Clear();
+    single_pass_scan_started_ = false;
+    intent_iter_.Reset();
+    Resolve();
+  }
+
   // Returns true when there are no conflicts left.
   Result<bool> CheckLocalCommits() {
     return DoCleanup([this](auto* transaction) -> Result<bool> {
@@ -459,10 +612,19 @@ class ConflictResolver : public std::enable_shared_from_this<ConflictResolver> {
   RequestScope request_scope_;
   PartialRangeKeyIntents partial_range_key_intents_;
   std::unique_ptr<ConflictResolverContext> context_;
+  LockBatch* lock_batch_;
+  const CoarseTimePoint deadline_;
+  // Time until we could wait for conflicting transactions, picked when we start the first wait.
+  CoarseTimePoint wait_deadline_;
+  // Delay before the next attempt to reacquire locks after waiting, see RelockAndResolve.
+  CoarseDuration relock_retry_delay_ = kMinRelockRetryDelay;
   ResolutionCallback callback_;
 
   BoundedRocksDbIterator intent_iter_;
   Slice intent_key_upperbound_;
+  // Upperbound of the intents iterator in the single pass mode, empty otherwise.
+  KeyBytes single_pass_upperbound_;
+  bool single_pass_scan_started_ = false;
   TransactionIdSet conflicts_;
 
   // Resolution state for all transactions. Resolved transactions are moved to the end of it.
@@ -555,7 +717,10 @@ class StrongConflictChecker {
           resolver_.doc_db().key_bounds,
           BloomFilterMode::USE_BLOOM_FILTER,
           intent_key,
-          rocksdb::kDefaultQueryId);
+          rocksdb::kDefaultQueryId,
+          /* file_filter= */ nullptr,
+          /* iterate_upper_bound= */ nullptr,
+          resolver_.doc_db().value_log);
       value_iter_hash_ = hash;
     }
     value_iter_.Seek(intent_key);
@@ -660,6 +825,12 @@ class ConflictResolverContextBase : public ConflictResolverContext {
   }
 
  protected:
+  // Should be invoked when conflicts are read again, so priorities of the new set of conflicting
+  // transactions are fetched.
+  void ResetFetchedPriorities() {
+    fetched_metadata_for_transactions_ = false;
+  }
+
   CHECKED_STATUS CheckPriorityInternal(
       ConflictResolver* resolver,
       boost::iterator_range<TransactionData*> transactions,
@@ -721,6 +892,7 @@ class TransactionConflictResolverContext : public ConflictResolverContextBase {
     RETURN_NOT_OK(transaction_id_);
 
     VLOG_WITH_PREFIX(3) << "Resolve conflicts";
+    ResetFetchedPriorities();
 
     metadata_ = VERIFY_RESULT(resolver->PrepareMetadata(write_batch_.transaction()));
 
@@ -781,6 +953,11 @@ class TransactionConflictResolverContext : public ConflictResolverContextBase {
     // DB where the provisional record has already been removed.
     resolver->EnsureIntentIteratorCreated();
 
+    // Container is ordered by intent key, so conflicting intents could be read in a single pass.
+    if (FLAGS_conflict_resolution_single_pass) {
+      resolver->StartSinglePassIntentScan(container.rbegin()->first.AsSlice());
+    }
+
     for(const auto& i : container) {
       if (read_time_ != HybridTime::kMax) {
         const Slice intent_key = i.first.AsSlice();
@@ -869,6 +1046,7 @@ class OperationConflictResolverContext : public ConflictResolverContextBase {
 
   // Reads stored intents that could conflict with our operations.
   CHECKED_STATUS ReadConflicts(ConflictResolver* resolver) override {
+    ResetFetchedPriorities();
     boost::container::small_vector<RefCntPrefix, 8> doc_paths;
     boost::container::small_vector<size_t, 32> key_prefix_lengths;
     KeyBytes encoded_key_buffer;
@@ -944,13 +1122,16 @@ void ResolveTransactionConflicts(const DocOperations& doc_ops,
                                  PartialRangeKeyIntents partial_range_key_intents,
                                  TransactionStatusManager* status_manager,
                                  Counter* conflicts_metric,
+                                 LockBatch* lock_batch,
+                                 CoarseTimePoint deadline,
                                  ResolutionCallback callback) {
   DCHECK(hybrid_time.is_valid());
   TRACE("ResolveTransactionConflicts");
   auto context = std::make_unique<TransactionConflictResolverContext>(
       doc_ops, write_batch, hybrid_time, read_time, conflicts_metric);
   auto resolver = std::make_shared<ConflictResolver>(
-      doc_db, status_manager, partial_range_key_intents, std::move(context), std::move(callback));
+      doc_db, status_manager, partial_range_key_intents, std::move(context), lock_batch, deadline,
+      std::move(callback));
   // Resolve takes a self reference to extend lifetime.
   resolver->Resolve();
   TRACE("resolver->Resolve done");
@@ -962,12 +1143,15 @@ void ResolveOperationConflicts(const DocOperations& doc_ops,
                                PartialRangeKeyIntents partial_range_key_intents,
                                TransactionStatusManager* status_manager,
                                Counter* conflicts_metric,
+                               LockBatch* lock_batch,
+                               CoarseTimePoint deadline,
                                ResolutionCallback callback) {
   TRACE("ResolveOperationConflicts");
   auto context = std::make_unique<OperationConflictResolverContext>(&doc_ops, resolution_ht,
                                                                     conflicts_metric);
   auto resolver = std::make_shared<ConflictResolver>(
-      doc_db, status_manager, partial_range_key_intents, std::move(context), std::move(callback));
+      doc_db, status_manager, partial_range_key_intents, std::move(context), lock_batch, deadline,
+      std::move(callback));
   // Resolve takes a self reference to extend lifetime.
   resolver->Resolve();
   TRACE("resolver->Resolve done");
@@ -44,12 +44,18 @@ using ResolutionCallback = boost::function<void(const Result<HybridTime>&)>;
 // Forms set of conflicting transactions.
 // Tries to abort transactions with lower priority.
 // If it conflicts with transaction with higher priority or committed one then error is returned.
+// When --transaction_conflict_max_wait_ms is positive, conflict with a higher priority transaction
+// is not reported right away. Instead lock_batch is released, and conflicts are resolved again
+// after that transaction is applied or removed at this tablet. Locks are reacquired without
+// blocking the thread, retrying through status_manager until deadline.
 //
 // write_batch - values that would be written as part of transaction.
 // hybrid_time - current hybrid time.
 // db - db that contains tablet data.
 // status_manager - status manager that should be used during this conflict resolution.
 // conflicts_metric - transaction_conflicts metric to update.
+// lock_batch - locks held by the operation, could be null if waiting is not allowed.
+// deadline - deadline of the operation.
 void ResolveTransactionConflicts(const DocOperations& doc_ops,
                                  const KeyValueWriteBatchPB& write_batch,
                                  HybridTime resolution_ht,
@@ -58,6 +64,8 @@ void ResolveTransactionConflicts(const DocOperations& doc_ops,
                                  PartialRangeKeyIntents partial_range_key_intents,
                                  TransactionStatusManager* status_manager,
                                  Counter* conflicts_metric,
+                                 LockBatch* lock_batch,
+                                 CoarseTimePoint deadline,
                                  ResolutionCallback callback);
 
 // Resolves conflicts for doc operations.
@@ -72,12 +80,15 @@ void ResolveTransactionConflicts(const DocOperations& doc_ops,
 // resolution_ht - current hybrid time. Used to request status of conflicting transactions.
 // db - db that contains tablet data.
 // status_manager - status manager that should be used during this conflict resolution.
+// lock_batch and deadline - see ResolveTransactionConflicts.
 void ResolveOperationConflicts(const DocOperations& doc_ops,
                                HybridTime resolution_ht,
                                const DocDB& doc_db,
                                PartialRangeKeyIntents partial_range_key_intents,
                                TransactionStatusManager* status_manager,
                                Counter* conflicts_metric,
+                               LockBatch* lock_batch,
+                               CoarseTimePoint deadline,
                                ResolutionCallback callback);
 
 struct ParsedIntent {
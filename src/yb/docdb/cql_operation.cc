@@ -35,7 +35,9 @@
 #include "yb/docdb/primitive_value_util.h"
 
 #include "yb/util/bfpg/tserver_opcodes.h"
+#include "yb/util/bfql/gen_opcodes.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/random_util.h"
 #include "yb/util/status.h"
 #include "yb/util/trace.h"
 
@@ -56,6 +58,19 @@ DEFINE_bool(ycql_disable_index_updating_optimization, false,
             "the index data.");
 TAG_FLAG(ycql_disable_index_updating_optimization, advanced);
 
+DEFINE_bool(ycql_blind_counter_increments, false,
+            "Apply counter increments and decrements of non-transactional tables as blind writes "
+            "of delta records, which readers add to the older counter value, instead of reading "
+            "the counter and writing the new value.");
+TAG_FLAG(ycql_blind_counter_increments, advanced);
+
+DEFINE_int32(ycql_counter_delta_consolidation_interval, 16,
+             "When blind counter increments are enabled, one in this many counter updates on "
+             "average is applied as a read-modify-write storing the full counter value. This "
+             "bounds the number of deltas readers have to add, and lets compactions remove the "
+             "older deltas. Zero or a negative value disables the consolidation.");
+TAG_FLAG(ycql_counter_delta_consolidation_interval, advanced);
+
 namespace yb {
 namespace docdb {
 
@@ -232,6 +247,85 @@ CHECKED_STATUS FindMemberForIndex(const QLColumnValuePB& column_value,
   return Status::OK();
 }
 
+// Applies a json operator of column_value to document.
+CHECKED_STATUS ApplyJsonOperator(const QLColumnValuePB& column_value, bool is_insert,
+                                 rapidjson::Document* document_ptr) {
+  using common::Jsonb;
+  rapidjson::Document& document = *document_ptr;
+
+  // Deserialize the rhs.
+  Jsonb rhs(std::move(column_value.expr().value().jsonb_value()));
+  rapidjson::Document rhs_doc;
+  RETURN_NOT_OK(rhs.ToRapidJson(&rhs_doc));
+  // The document outlives rhs_doc, so the value is copied into the allocator of the document.
+  rapidjson::Value rhs_value(rhs_doc, document.GetAllocator());
+
+  // Update the json value.
+  rapidjson::Value::MemberIterator memberit;
+  rapidjson::Value::ValueIterator valueit;
+  bool last_elem_object;
+  rapidjson::Value* node = &document;
+
+  int i = 0;
+  auto status = FindMemberForIndex(column_value, i, node, &memberit, &valueit,
+      &last_elem_object, is_insert);
+  for (i = 1; i < column_value.json_args_size() && status.ok(); i++) {
+    node = (last_elem_object) ? &(memberit->value) : &(*valueit);
+    status = FindMemberForIndex(column_value, i, node, &memberit, &valueit,
+        &last_elem_object, is_insert);
+  }
+
+  bool update_missing = false;
+  if (is_insert) {
+    RETURN_NOT_OK(status);
+  } else {
+    update_missing = !status.ok();
+  }
+
+  if (update_missing) {
+    // NOTE: lhs path cannot exceed by more than one hop
+    if (last_elem_object && i == column_value.json_args_size()) {
+      auto val = column_value.json_args(i - 1).operand().value().string_value();
+      rapidjson::Value v(val.c_str(), val.size(), document.GetAllocator());
+      node->AddMember(v, rhs_value, document.GetAllocator());
+    } else {
+      RETURN_NOT_OK(status);
+    }
+  } else if (last_elem_object) {
+    memberit->value = rhs_value.Move();
+  } else {
+    *valueit = rhs_value.Move();
+  }
+  return Status::OK();
+}
+
+// Returns the value added to a counter by column_value if it increments or decrements the counter
+// by a constant, i.e. "c = c + n" or "c = c - n".
+boost::optional<int64_t> GetCounterDelta(const QLColumnValuePB& column_value) {
+  if (!column_value.expr().has_bfcall() || !column_value.subscript_args().empty() ||
+      !column_value.json_args().empty()) {
+    return boost::none;
+  }
+  const auto& bfcall = column_value.expr().bfcall();
+  if (bfcall.operands_size() != 2 || !bfcall.operands(0).has_column_id() ||
+      bfcall.operands(0).column_id() != column_value.column_id() ||
+      !bfcall.operands(1).has_value() || !bfcall.operands(1).value().has_int64_value()) {
+    return boost::none;
+  }
+  static const int32_t kIncCounterOpcode =
+      static_cast<int32_t>(bfql::kBfqlName2Opcode.at("counter+"));
+  static const int32_t kDecCounterOpcode =
+      static_cast<int32_t>(bfql::kBfqlName2Opcode.at("counter-"));
+  const int64_t delta = bfcall.operands(1).value().int64_value();
+  if (bfcall.opcode() == kIncCounterOpcode) {
+    return delta;
+  }
+  if (bfcall.opcode() == kDecCounterOpcode) {
+    return -delta;
+  }
+  return boost::none;
+}
+
 CHECKED_STATUS CheckUserTimestampForCollections(const UserTimeMicros user_timestamp) {
   if (user_timestamp != Value::kInvalidUserTimestamp) {
     return STATUS(InvalidArgument, "User supplied timestamp is only allowed for "
@@ -259,6 +353,10 @@ Status QLWriteOperation::Init(QLWriteRequestPB* request, QLResponsePB* response)
                               unique_index_key_schema_ != nullptr;
   require_read_ = RequireRead(request_, *schema_) || insert_into_unique_index_
                   || !index_map_.empty();
+  blind_counter_increments_ = CanApplyBlindCounterIncrements();
+  if (blind_counter_increments_) {
+    require_read_ = false;
+  }
   update_indexes_ = !request_.update_index_ids().empty();
 
   // Determine if static / non-static columns are being written.
@@ -292,6 +390,24 @@ Status QLWriteOperation::Init(QLWriteRequestPB* request, QLResponsePB* response)
       schema_->num_range_key_columns() == 0);
 }
 
+bool QLWriteOperation::CanApplyBlindCounterIncrements() const {
+  // Counter deltas are only summed from regular records, so they are not written by transactions.
+  if (!FLAGS_ycql_blind_counter_increments || txn_op_context_ || !index_map_.empty() ||
+      request_.type() != QLWriteRequestPB::QL_STMT_UPDATE || request_.has_if_expr() ||
+      request_.returns_status() || request_.has_ttl() || request_.has_user_timestamp_usec() ||
+      request_.column_values().empty() || IsRangeOperation(request_, *schema_)) {
+    return false;
+  }
+  for (const auto& column_value : request_.column_values()) {
+    const auto column = schema_->column_by_id(ColumnId(column_value.column_id()));
+    if (!column.ok() || !column->is_counter() || !GetCounterDelta(column_value)) {
+      return false;
+    }
+  }
+  return FLAGS_ycql_counter_delta_consolidation_interval <= 0 ||
+         !RandomWithChance(FLAGS_ycql_counter_delta_consolidation_interval);
+}
+
 Status QLWriteOperation::InitializeKeys(const bool hashed_key, const bool primary_key) {
   // Populate the hashed and range components in the same order as they are in the table schema.
   const auto& hashed_column_values = request_.hashed_column_values();
@@ -610,7 +726,8 @@ Result<HybridTime> QLWriteOperation::FindOldestOverwrittenTimestamp(
   return result;
 }
 
-Status QLWriteOperation::ApplyForJsonOperators(const QLColumnValuePB& column_value,
+Status QLWriteOperation::ApplyForJsonOperators(ColumnValuesIterator begin,
+                                               ColumnValuesIterator end,
                                                const DocOperationApplyData& data,
                                                const DocPath& sub_path, const MonoDelta& ttl,
                                                const UserTimeMicros& user_timestamp,
@@ -621,68 +738,24 @@ Status QLWriteOperation::ApplyForJsonOperators(const QLColumnValuePB& column_val
   // Read the json column value inorder to perform a read modify write.
   QLExprResult temp;
   rapidjson::Document document;
-  RETURN_NOT_OK(existing_row->ReadColumn(column_value.column_id(), temp.Writer()));
+  RETURN_NOT_OK(existing_row->ReadColumn(begin->column_id(), temp.Writer()));
   const auto& ql_value = temp.Value();
   if (!IsNull(ql_value)) {
     Jsonb jsonb(std::move(ql_value.jsonb_value()));
     RETURN_NOT_OK(jsonb.ToRapidJson(&document));
   } else {
-    if (!is_insert && column_value.json_args_size() > 1) {
+    if (!is_insert && begin->json_args_size() > 1) {
       return STATUS_SUBSTITUTE(QLError, "JSON path depth should be 1 for upsert",
-        column_value.ShortDebugString());
+        begin->ShortDebugString());
     }
-    common::Jsonb empty_jsonb;
-    RETURN_NOT_OK(empty_jsonb.FromString("{}"));
-    QLTableColumn& column = existing_row->AllocColumn(column_value.column_id());
-    column.value.set_jsonb_value(empty_jsonb.MoveSerializedJsonb());
-
-    Jsonb jsonb(column.value.jsonb_value());
-    RETURN_NOT_OK(jsonb.ToRapidJson(&document));
+    document.SetObject();
   }
 
-  // Deserialize the rhs.
-  Jsonb rhs(std::move(column_value.expr().value().jsonb_value()));
-  rapidjson::Document rhs_doc;
-  RETURN_NOT_OK(rhs.ToRapidJson(&rhs_doc));
-
-  // Update the json value.
-  rapidjson::Value::MemberIterator memberit;
-  rapidjson::Value::ValueIterator valueit;
-  bool last_elem_object;
-  rapidjson::Value* node = &document;
-
-  int i = 0;
-  auto status = FindMemberForIndex(column_value, i, node, &memberit, &valueit,
-      &last_elem_object, is_insert);
-  for (i = 1; i < column_value.json_args_size() && status.ok(); i++) {
-    node = (last_elem_object) ? &(memberit->value) : &(*valueit);
-    status = FindMemberForIndex(column_value, i, node, &memberit, &valueit,
-        &last_elem_object, is_insert);
+  for (auto it = begin; it != end; ++it) {
+    RETURN_NOT_OK(ApplyJsonOperator(*it, is_insert, &document));
   }
 
-  bool update_missing = false;
-  if (is_insert) {
-    RETURN_NOT_OK(status);
-  } else {
-    update_missing = !status.ok();
-  }
-
-  if (update_missing) {
-    // NOTE: lhs path cannot exceed by more than one hop
-    if (last_elem_object && i == column_value.json_args_size()) {
-      auto val = column_value.json_args(i - 1).operand().value().string_value();
-      rapidjson::Value v(val.c_str(), val.size(), document.GetAllocator());
-      node->AddMember(v, rhs_doc, document.GetAllocator());
-    } else {
-      RETURN_NOT_OK(status);
-    }
-  } else if (last_elem_object) {
-    memberit->value = rhs_doc.Move();
-  } else {
-    *valueit = rhs_doc.Move();
-  }
-
-  // Now write the new json value back.
+  // Now write the new json value back, once for all the operators.
   QLValue result;
   Jsonb jsonb_result;
   RETURN_NOT_OK(jsonb_result.FromRapidJson(document));
@@ -696,7 +769,7 @@ Status QLWriteOperation::ApplyForJsonOperators(const QLColumnValuePB& column_val
 
   // Update the current row as well so that we can accumulate the result of multiple json
   // operations and write the final value.
-  existing_row->AllocColumn(column_value.column_id()).value = result.value();
+  existing_row->AllocColumn(begin->column_id()).value = result.value();
   return Status::OK();
 }
 
@@ -840,7 +913,8 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
     }
 
     TEST_PAUSE_IF_FLAG(TEST_pause_write_apply_after_if);
-  } else if (RequireReadForExpressions(request_) || request_.returns_status()) {
+  } else if ((RequireReadForExpressions(request_) && !blind_counter_increments_) ||
+             request_.returns_status()) {
     RETURN_NOT_OK(ReadColumns(data, nullptr, nullptr, &existing_row));
     if (request_.returns_status()) {
       RETURN_NOT_OK(PopulateStatusRow(data, /* should_apply = */ true, existing_row, &rowblock_));
@@ -896,7 +970,9 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
             sub_path, value, data.read_time, data.deadline, request_.query_id()));
       }
 
-      for (const auto& column_value : request_.column_values()) {
+      const auto& column_values = request_.column_values();
+      for (auto it = column_values.begin(); it != column_values.end(); ++it) {
+        const auto& column_value = *it;
         if (!column_value.has_column_id()) {
           return STATUS_FORMAT(InvalidArgument, "column id missing: $0",
                                column_value.DebugString());
@@ -912,9 +988,24 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
             PrimitiveValue(column_id));
 
         QLValue expr_result;
-        if (!column_value.json_args().empty()) {
-          RETURN_NOT_OK(ApplyForJsonOperators(column_value, data, sub_path, ttl,
+        if (blind_counter_increments_) {
+          const Value delta(
+              PrimitiveValue(*GetCounterDelta(column_value)), Value::kMaxTtl,
+              Value::kInvalidUserTimestamp, Value::kCounterDeltaFlag);
+          RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+              sub_path, delta, data.read_time, data.deadline, request_.query_id()));
+        } else if (!column_value.json_args().empty()) {
+          // Consecutive json operators on the same column are applied to the document together,
+          // so it is decoded, encoded and written once.
+          auto json_end = std::next(it);
+          while (json_end != column_values.end() &&
+                 json_end->column_id() == column_value.column_id() &&
+                 !json_end->json_args().empty()) {
+            ++json_end;
+          }
+          RETURN_NOT_OK(ApplyForJsonOperators(it, json_end, data, sub_path, ttl,
                                               user_timestamp, column, &new_row, is_insert));
+          it = std::prev(json_end);
         } else if (!column_value.subscript_args().empty()) {
           RETURN_NOT_OK(ApplyForSubscriptArgs(column_value, existing_row, data, ttl,
                                               user_timestamp, column, &sub_path));
@@ -1421,6 +1512,16 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
     }
     row_count_limit = request_.limit();
   }
+  // The size limit bounds the page together with the row count limit. At least one row is always
+  // returned, so that paging makes progress.
+  size_t rows_data_size_limit = std::numeric_limits<std::size_t>::max();
+  if (request_.return_paging_state() && request_.rows_data_size_limit() > 0 &&
+      !request_.is_aggregate()) {
+    rows_data_size_limit = request_.rows_data_size_limit();
+  }
+  auto size_limit_reached = [resultset, rows_data_size_limit] {
+    return resultset->rows_data_size() >= rows_data_size_limit && resultset->rsrow_count() > 0;
+  };
 
   // Create the projections of the non-key columns selected by the row block plus any referenced in
   // the WHERE condition. When DocRowwiseIterator::NextRow() populates the value map, it uses this
@@ -1461,7 +1562,8 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   // Begin the normal fetch.
   int match_count = 0;
   bool static_dealt_with = true;
-  while (resultset->rsrow_count() < row_count_limit && VERIFY_RESULT(iter->HasNext())) {
+  while (resultset->rsrow_count() < row_count_limit && !size_limit_reached() &&
+         VERIFY_RESULT(iter->HasNext())) {
     const bool last_read_static = iter->IsNextStaticColumn();
 
     // Note that static columns are sorted before non-static columns in DocDB as follows. This is
@@ -1544,7 +1646,7 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   VTRACE(1, "Fetched $0 rows.", resultset->rsrow_count());
 
   RETURN_NOT_OK(SetPagingStateIfNecessary(
-      iter.get(), resultset, row_count_limit, num_rows_skipped, read_time));
+      iter.get(), resultset, row_count_limit, size_limit_reached(), num_rows_skipped, read_time));
 
   // SetPagingStateIfNecessary could perform read, so we assign restart_read_ht after it.
   *restart_read_ht = iter->RestartReadHt();
@@ -1555,9 +1657,11 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
 Status QLReadOperation::SetPagingStateIfNecessary(const common::YQLRowwiseIteratorIf* iter,
                                                   const QLResultSet* resultset,
                                                   const size_t row_count_limit,
+                                                  const bool size_limit_reached,
                                                   const size_t num_rows_skipped,
                                                   const ReadHybridTime& read_time) {
-  if ((resultset->rsrow_count() >= row_count_limit || request_.has_offset()) &&
+  if ((resultset->rsrow_count() >= row_count_limit || size_limit_reached ||
+       request_.has_offset()) &&
       !request_.is_aggregate()) {
     SubDocKey next_row_key;
     RETURN_NOT_OK(iter->GetNextReadSubDocKey(&next_row_key));
@@ -58,7 +58,12 @@ class QLWriteOperation :
 
   CHECKED_STATUS Apply(const DocOperationApplyData& data) override;
 
-  CHECKED_STATUS ApplyForJsonOperators(const QLColumnValuePB& column_value,
+  typedef google::protobuf::RepeatedPtrField<QLColumnValuePB>::const_iterator
+      ColumnValuesIterator;
+
+  // Applies the json operators of column values in [begin, end), that all update the same column.
+  CHECKED_STATUS ApplyForJsonOperators(ColumnValuesIterator begin,
+                                       ColumnValuesIterator end,
                                        const DocOperationApplyData& data,
                                        const DocPath& sub_path, const MonoDelta& ttl,
                                        const UserTimeMicros& user_timestamp,
@@ -100,6 +105,10 @@ class QLWriteOperation :
     }
   }
 
+  // Whether all column values of the request are counter increments that can be written as deltas
+  // without reading the counters.
+  bool CanApplyBlindCounterIncrements() const;
+
   // Initialize hashed_doc_key_ and/or pk_doc_key_.
   CHECKED_STATUS InitializeKeys(bool hashed_key, bool primary_key);
 
@@ -165,6 +174,9 @@ class QLWriteOperation :
   // Does this write operation require a read?
   bool require_read_ = false;
 
+  // Are the counter updates of this write operation applied as blind writes of deltas?
+  bool blind_counter_increments_ = false;
+
   // Any indexes that may need update?
   bool update_indexes_ = false;
 
@@ -227,6 +239,7 @@ class QLReadOperation : public DocExprExecutor {
   CHECKED_STATUS SetPagingStateIfNecessary(const common::YQLRowwiseIteratorIf* iter,
                                            const QLResultSet* resultset,
                                            const size_t row_count_limit,
+                                           const bool size_limit_reached,
                                            const size_t num_rows_skipped,
                                            const ReadHybridTime& read_time);
 
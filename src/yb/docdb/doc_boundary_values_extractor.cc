@@ -13,10 +13,21 @@
 //
 //
 
+#include <boost/optional.hpp>
+
 #include "yb/rocksdb/db/dbformat.h"
 
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_ttl_util.h"
+#include "yb/docdb/value.h"
+#include "yb/docdb/value_log.h"
+
+#include "yb/gutil/endian.h"
+
+#include "yb/server/hybrid_clock.h"
+
+DECLARE_bool(docdb_delete_expired_files);
 
 namespace yb {
 namespace docdb {
@@ -30,6 +41,14 @@ Status GetPrimitiveValue(const rocksdb::UserBoundaryValues& values,
 namespace {
 
 constexpr rocksdb::UserBoundaryTag kDocHybridTimeTag = 1;
+// Max expiration time of records with value level TTL, kMin if there are no such records.
+constexpr rocksdb::UserBoundaryTag kMaxValueTtlExpirationTag = 2;
+// Max write time of records that expire with table TTL, kMin if there are no such records.
+constexpr rocksdb::UserBoundaryTag kMaxTableTtlWriteTimeTag = 3;
+// 1 if there are merge records, 0 otherwise.
+constexpr rocksdb::UserBoundaryTag kMergeRecordsTag = 4;
+// Number of the value log file referenced by the record, only present for such records.
+constexpr rocksdb::UserBoundaryTag kValueLogFileTag = 5;
 // Here we reserve some tags for future use.
 // Because Tag is persistent.
 constexpr rocksdb::UserBoundaryTag kRangeComponentsStart = 10;
@@ -80,6 +99,78 @@ class DocHybridTimeValue : public rocksdb::UserBoundaryValue {
   Slice encoded_;
 };
 
+// Wrapper for UserBoundaryValue that stores unsigned integer with specified tag.
+class UInt64BoundaryValue : public rocksdb::UserBoundaryValue {
+ public:
+  UInt64BoundaryValue(rocksdb::UserBoundaryTag tag, uint64_t value) : tag_(tag), value_(value) {
+    BigEndian::Store64(buffer_, value);
+  }
+
+  static CHECKED_STATUS Create(
+      rocksdb::UserBoundaryTag tag, Slice data, rocksdb::UserBoundaryValuePtr* value) {
+    CHECK_NOTNULL(value);
+    if (data.size() != sizeof(uint64_t)) {
+      return STATUS_FORMAT(
+          Corruption, "Wrong size of boundary value with tag $0: $1", tag, data.size());
+    }
+
+    *value = std::make_shared<UInt64BoundaryValue>(tag, BigEndian::Load64(data.data()));
+    return Status::OK();
+  }
+
+  virtual ~UInt64BoundaryValue() {}
+
+  rocksdb::UserBoundaryTag Tag() override {
+    return tag_;
+  }
+
+  Slice Encode() override {
+    return Slice(buffer_, sizeof(buffer_));
+  }
+
+  int CompareTo(const UserBoundaryValue& pre_rhs) override {
+    const auto* rhs = down_cast<const UInt64BoundaryValue*>(&pre_rhs);
+    return value_ < rhs->value_ ? -1 : (value_ > rhs->value_ ? 1 : 0);
+  }
+
+  uint64_t value() const {
+    return value_;
+  }
+
+ private:
+  rocksdb::UserBoundaryTag tag_;
+  uint64_t value_;
+  char buffer_[sizeof(uint64_t)];
+};
+
+// Appends values with expiration of the record, used to detect files whose records are all
+// expired.
+void AppendExpirationValues(Slice value, HybridTime write_ht, rocksdb::UserBoundaryValues* values) {
+  HybridTime value_ttl_expiration = HybridTime::kMin;
+  HybridTime table_ttl_write_time = HybridTime::kMin;
+  bool merge_record = false;
+  Value control_fields;
+  if (write_ht.is_valid() && control_fields.DecodeControlFields(&value).ok()) {
+    merge_record = control_fields.merge_flags() != 0;
+    if (!control_fields.has_ttl()) {
+      table_ttl_write_time = write_ht;
+    } else {
+      auto ttl = ComputeTTL(control_fields.ttl(), Value::kMaxTtl);
+      value_ttl_expiration = ttl.Equals(Value::kMaxTtl)
+          ? HybridTime::kMax : server::HybridClock::AddPhysicalTimeToHybridTime(write_ht, ttl);
+    }
+  } else {
+    // Expiration of the record is unknown, so it should never be treated as expired.
+    value_ttl_expiration = HybridTime::kMax;
+  }
+
+  values->push_back(std::make_shared<UInt64BoundaryValue>(
+      kMaxValueTtlExpirationTag, value_ttl_expiration.ToUint64()));
+  values->push_back(std::make_shared<UInt64BoundaryValue>(
+      kMaxTableTtlWriteTimeTag, table_ttl_write_time.ToUint64()));
+  values->push_back(std::make_shared<UInt64BoundaryValue>(kMergeRecordsTag, merge_record));
+}
+
 // Wrapper for UserBoundaryValue that stores PrimitiveValue with index.
 class PrimitiveBoundaryValue : public rocksdb::UserBoundaryValue {
  public:
@@ -147,6 +238,10 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
     if (tag == kDocHybridTimeTag) {
       return DocHybridTimeValue::Create(data, value);
     }
+    if (tag == kMaxValueTtlExpirationTag || tag == kMaxTableTtlWriteTimeTag ||
+        tag == kMergeRecordsTag || tag == kValueLogFileTag) {
+      return UInt64BoundaryValue::Create(tag, data, value);
+    }
     if (tag >= kRangeComponentsStart) {
       return PrimitiveBoundaryValue::Create(tag - kRangeComponentsStart, data, value);
     }
@@ -164,6 +259,9 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
       // - external transaction records (transactions that originated on a CDC producer)
       // For regular db:
       // - transaction apply state records.
+      if (FLAGS_docdb_delete_expired_files) {
+        AppendExpirationValues(Slice(), HybridTime(), values);
+      }
       return Status::OK();
     }
 
@@ -182,6 +280,22 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
     RETURN_NOT_OK(DocHybridTimeValue::Create(slices.back(), &temp));
     values->push_back(std::move(temp));
 
+    if (FLAGS_docdb_delete_expired_files) {
+      DocHybridTime doc_ht;
+      RETURN_NOT_OK(doc_ht.FullyDecodeFrom(slices.back()));
+      AppendExpirationValues(value, doc_ht.hybrid_time(), values);
+    }
+
+    // Always recorded, so value log files referenced by SST files are known even if the value
+    // log was disabled when the SST file was written.
+    const char* reference_start = ValueLog::FindReference(value);
+    if (reference_start) {
+      auto reference = VERIFY_RESULT(
+          ValueLogReference::Decode(Slice(reference_start, value.cend())));
+      values->push_back(std::make_shared<UInt64BoundaryValue>(
+          kValueLogFileTag, reference.file_number));
+    }
+
     for (size_t i = 0; i != size; ++i) {
       RETURN_NOT_OK(PrimitiveBoundaryValue::Create(i, slices[i], &temp));
       values->push_back(std::move(temp));
@@ -257,6 +371,39 @@ Status GetDocHybridTime(const rocksdb::UserBoundaryValues& values, DocHybridTime
   return time_value->value(out);
 }
 
+HybridTime MaxFileExpiration(const rocksdb::UserBoundaryValues& largest, MonoDelta table_ttl) {
+  auto value_ttl_expiration = rocksdb::UserValueWithTag(largest, kMaxValueTtlExpirationTag);
+  auto table_ttl_write_time = rocksdb::UserValueWithTag(largest, kMaxTableTtlWriteTimeTag);
+  if (!value_ttl_expiration || !table_ttl_write_time) {
+    return HybridTime();
+  }
+  HybridTime result(down_cast<UInt64BoundaryValue*>(value_ttl_expiration.get())->value());
+  HybridTime write_time(down_cast<UInt64BoundaryValue*>(table_ttl_write_time.get())->value());
+  if (write_time != HybridTime::kMin) {
+    if (table_ttl.Equals(Value::kMaxTtl)) {
+      return HybridTime::kMax;
+    }
+    result.MakeAtLeast(server::HybridClock::AddPhysicalTimeToHybridTime(write_time, table_ttl));
+  }
+  return result;
+}
+
+Result<bool> HasMergeRecords(const rocksdb::UserBoundaryValues& largest) {
+  auto value = rocksdb::UserValueWithTag(largest, kMergeRecordsTag);
+  if (!value) {
+    return STATUS(NotFound, "Not found value for merge records");
+  }
+  return down_cast<UInt64BoundaryValue*>(value.get())->value() != 0;
+}
+
+boost::optional<uint64_t> MinValueLogFileNumber(const rocksdb::UserBoundaryValues& smallest) {
+  auto value = rocksdb::UserValueWithTag(smallest, kValueLogFileTag);
+  if (!value) {
+    return boost::none;
+  }
+  return down_cast<UInt64BoundaryValue*>(value.get())->value();
+}
+
 rocksdb::UserBoundaryTag TagForRangeComponent(size_t index) {
   return PrimitiveBoundaryValue::TagForIndex(index);
 }
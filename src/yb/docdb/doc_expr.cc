@@ -247,7 +247,9 @@ CHECKED_STATUS DocExprExecutor::EvalTSCall(const PgsqlBCallPB& tscall,
       return EvalMax(arg_result.Value(), result);
     }
 
-    case bfpg::TSOpcode::kPgEvalExprCall: {
+    case bfpg::TSOpcode::kPgEvalExprCall: FALLTHROUGH_INTENDED;
+    case bfpg::TSOpcode::kPgEvalBoolExprCall: {
+      SCHECK(schema != nullptr, InvalidArgument, "Schema is required to evaluate YSQL expression");
       const std::string& expr_str = tscall.operands(0).value().string_value();
 
       std::vector<DocPgParamDesc> params;
@@ -260,11 +262,19 @@ CHECKED_STATUS DocExprExecutor::EvalTSCall(const PgsqlBCallPB& tscall,
         params.emplace_back(attno, typid, typmod);
       }
 
-      RETURN_NOT_OK(DocPgEvalExpr(expr_str,
-                                  params,
-                                  table_row,
-                                  schema,
-                                  result));
+      if (tsopcode == bfpg::TSOpcode::kPgEvalBoolExprCall) {
+        RETURN_NOT_OK(DocPgEvalBoolExpr(expr_str,
+                                        params,
+                                        table_row,
+                                        schema,
+                                        result));
+      } else {
+        RETURN_NOT_OK(DocPgEvalExpr(expr_str,
+                                    params,
+                                    table_row,
+                                    schema,
+                                    result));
+      }
 
       return Status::OK();
     }
@@ -313,9 +323,16 @@ CHECKED_STATUS DocExprExecutor::EvalSum(const QLValuePB& val, QLValue *aggr_sum)
     case InternalType::kInt64Value:
       aggr_sum->set_int64_value(aggr_sum->int64_value() + val.int64_value());
       break;
-    case InternalType::kVarintValue:
-      aggr_sum->set_varint_value(aggr_sum->varint_value() + QLValue::varint_value(val));
+    case InternalType::kVarintValue: {
+      std::string sum;
+      if (util::VarInt::TryAddComparable(
+              aggr_sum->value().varint_value(), val.varint_value(), &sum)) {
+        *aggr_sum->mutable_varint_value() = std::move(sum);
+      } else {
+        aggr_sum->set_varint_value(aggr_sum->varint_value() + QLValue::varint_value(val));
+      }
       break;
+    }
     case InternalType::kFloatValue:
       aggr_sum->set_float_value(aggr_sum->float_value() + val.float_value());
       break;
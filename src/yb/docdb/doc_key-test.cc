@@ -432,6 +432,44 @@ TEST_F(DocKeyTest, TestKeyMatching) {
   ASSERT_FALSE(may_match(EncodeSimpleSubDocKey(absent_key))) << "Key: " << absent_key;
 }
 
+TEST_F(DocKeyTest, TestRangePrefixKeyMatching) {
+  DocDbAwareRangePrefixFilterPolicy policy(
+      rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr, 2 /* num_range_components */);
+  ASSERT_EQ(std::string("DocKeyRangePrefix2Filter"), policy.Name());
+  auto encode = [](std::vector<PrimitiveValue> range_components) {
+    return DocKey(std::move(range_components)).Encode();
+  };
+  const auto* transformer = policy.GetKeyTransformer();
+
+  std::unique_ptr<FilterBitsBuilder> builder(policy.GetFilterBitsBuilder());
+  for (int i = 0; i != 10; ++i) {
+    const auto key = encode({PrimitiveValue("tenant"), PrimitiveValue(i), PrimitiveValue(i)});
+    builder->AddKey(transformer->Transform(key.AsSlice()));
+  }
+  std::unique_ptr<const char[]> buf;
+  rocksdb::Slice filter = builder->Finish(&buf);
+  std::unique_ptr<FilterBitsReader> reader(policy.GetFilterBitsReader(filter));
+
+  auto lower = encode({PrimitiveValue("tenant"), PrimitiveValue(5), PrimitiveValue(0)});
+  auto upper = encode({PrimitiveValue("tenant"), PrimitiveValue(5), PrimitiveValue(100)});
+  auto prefix = ASSERT_RESULT(EqualComponentsPrefix(lower.AsSlice(), upper.AsSlice()));
+  ASSERT_TRUE(reader->MayMatch(transformer->Transform(prefix)));
+
+  lower = encode({PrimitiveValue("tenant"), PrimitiveValue(50), PrimitiveValue(0)});
+  upper = encode({PrimitiveValue("tenant"), PrimitiveValue(50), PrimitiveValue(100)});
+  prefix = ASSERT_RESULT(EqualComponentsPrefix(lower.AsSlice(), upper.AsSlice()));
+  ASSERT_FALSE(reader->MayMatch(transformer->Transform(prefix)));
+
+  // Only the first component is fixed, so the key should match any filter.
+  lower = encode({PrimitiveValue("other_tenant"), PrimitiveValue(0)});
+  upper = encode({PrimitiveValue("other_tenant"), PrimitiveValue(100)});
+  prefix = ASSERT_RESULT(EqualComponentsPrefix(lower.AsSlice(), upper.AsSlice()));
+  // Prefix does not contain the end of range group.
+  const auto first_component = encode({PrimitiveValue("other_tenant")});
+  ASSERT_EQ(first_component.AsSlice().Prefix(first_component.size() - 1), prefix);
+  ASSERT_TRUE(transformer->Transform(prefix).empty());
+}
+
 TEST_F(DocKeyTest, TestWriteId) {
   SubDocKey subdoc_key(DocKey({PrimitiveValue("a"), PrimitiveValue(135)}),
                        DocHybridTime(1000000, 4091, 135));
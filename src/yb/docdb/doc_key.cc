@@ -363,7 +363,8 @@ Result<DocKeyHash> DocKey::DecodeHash(const Slice& slice) {
   DocKeyDecoder decoder(slice);
   RETURN_NOT_OK(decoder.DecodeCotableId());
   RETURN_NOT_OK(decoder.DecodePgtableId());
-  uint16_t hash;
+  // Keys without a hash component leave it untouched, report them like DocKey::hash() does.
+  uint16_t hash = 0;
   RETURN_NOT_OK(decoder.DecodeHashCode(&hash));
   return hash;
 }
@@ -1161,6 +1162,52 @@ DocDbAwareV3FilterPolicy::GetKeyTransformer() const {
   return &DocKeyComponentsExtractor<DocKeyPart::kUpToHashOrFirstRange>::GetInstance();
 }
 
+class DocDbAwareRangePrefixFilterPolicy::Extractor : public rocksdb::FilterPolicy::KeyTransformer {
+ public:
+  explicit Extractor(size_t num_range_components) : num_range_components_(num_range_components) {}
+
+  // For encoded DocKey extracts prefix up to hashed components if hash code is present, or first
+  // num_range_components_ range components otherwise. For non-DocKey or DocKey with fewer range
+  // components returns empty key, so they will always match the filter.
+  Slice Transform(Slice key) const override {
+    auto size_result = EncodedPrefixSize(key);
+    return size_result.ok() ? Slice(key.data(), *size_result) : Slice();
+  }
+
+ private:
+  Result<size_t> EncodedPrefixSize(Slice key) const {
+    DocKeyDecoder decoder(key);
+    RETURN_NOT_OK(decoder.DecodeCotableId());
+    RETURN_NOT_OK(decoder.DecodePgtableId());
+    if (VERIFY_RESULT(decoder.DecodeHashCode())) {
+      return DocKey::EncodedSize(key, DocKeyPart::kUpToHash);
+    }
+    for (size_t i = 0; i != num_range_components_; ++i) {
+      if (decoder.GroupEnded()) {
+        return 0;
+      }
+      RETURN_NOT_OK(decoder.DecodePrimitiveValue());
+    }
+    return decoder.ConsumedSizeFrom(key.data());
+  }
+
+  const size_t num_range_components_;
+};
+
+DocDbAwareRangePrefixFilterPolicy::DocDbAwareRangePrefixFilterPolicy(
+    size_t filter_block_size_bits, rocksdb::Logger* logger, size_t num_range_components)
+    : DocDbAwareFilterPolicyBase(filter_block_size_bits, logger),
+      name_(Format("DocKeyRangePrefix$0Filter", num_range_components)),
+      extractor_(std::make_unique<Extractor>(num_range_components)) {
+}
+
+DocDbAwareRangePrefixFilterPolicy::~DocDbAwareRangePrefixFilterPolicy() = default;
+
+const rocksdb::FilterPolicy::KeyTransformer*
+DocDbAwareRangePrefixFilterPolicy::GetKeyTransformer() const {
+  return extractor_.get();
+}
+
 DocKeyEncoderAfterTableIdStep DocKeyEncoder::CotableId(const Uuid& cotable_id) {
   if (!cotable_id.IsNil()) {
     std::string bytes;
@@ -1373,6 +1420,55 @@ Result<bool> HashedOrFirstRangeComponentsEqual(const Slice& lhs, const Slice& rh
   return rhs_decoder.GroupEnded();
 }
 
+Result<Slice> EqualComponentsPrefix(const Slice& lhs, const Slice& rhs) {
+  DocKeyDecoder lhs_decoder(lhs);
+  DocKeyDecoder rhs_decoder(rhs);
+  RETURN_NOT_OK(lhs_decoder.DecodeCotableId());
+  RETURN_NOT_OK(rhs_decoder.DecodeCotableId());
+  RETURN_NOT_OK(lhs_decoder.DecodePgtableId());
+  RETURN_NOT_OK(rhs_decoder.DecodePgtableId());
+
+  const bool hash_present = VERIFY_RESULT(lhs_decoder.DecodeHashCode(AllowSpecial::kTrue));
+  if (hash_present != VERIFY_RESULT(rhs_decoder.DecodeHashCode(AllowSpecial::kTrue))) {
+    return Slice();
+  }
+
+  size_t consumed = lhs_decoder.ConsumedSizeFrom(lhs.data());
+  if (consumed != rhs_decoder.ConsumedSizeFrom(rhs.data()) ||
+      !strings::memeq(lhs.data(), rhs.data(), consumed)) {
+    return Slice();
+  }
+
+  // Hashed group is followed by range group, so it is checked first when hash is present.
+  for (int groups_left = hash_present ? 2 : 1; groups_left > 0; --groups_left) {
+    while (!lhs_decoder.GroupEnded()) {
+      auto lhs_start = lhs_decoder.left_input().data();
+      auto rhs_start = rhs_decoder.left_input().data();
+      auto value_type = lhs_start[0];
+      if (rhs_decoder.GroupEnded() || rhs_start[0] != value_type ||
+          PREDICT_FALSE(!IsPrimitiveOrSpecialValueType(static_cast<ValueType>(value_type)))) {
+        return Slice(lhs.data(), lhs_start);
+      }
+
+      RETURN_NOT_OK(lhs_decoder.DecodePrimitiveValue(AllowSpecial::kTrue));
+      RETURN_NOT_OK(rhs_decoder.DecodePrimitiveValue(AllowSpecial::kTrue));
+      consumed = lhs_decoder.ConsumedSizeFrom(lhs_start);
+      if (consumed != rhs_decoder.ConsumedSizeFrom(rhs_start) ||
+          !strings::memeq(lhs_start, rhs_start, consumed)) {
+        return Slice(lhs.data(), lhs_start);
+      }
+    }
+    if (groups_left == 1 || !rhs_decoder.GroupEnded() || lhs_decoder.left_input().empty() ||
+        rhs_decoder.left_input().empty()) {
+      break;
+    }
+    RETURN_NOT_OK(lhs_decoder.ConsumeGroupEnd());
+    RETURN_NOT_OK(rhs_decoder.ConsumeGroupEnd());
+  }
+
+  return Slice(lhs.data(), lhs_decoder.left_input().data());
+}
+
 bool DocKeyBelongsTo(Slice doc_key, const Schema& schema) {
   bool has_table_id = !doc_key.empty() &&
       (doc_key[0] == ValueTypeAsChar::kTableId || doc_key[0] == ValueTypeAsChar::kPgTableOid);
@@ -439,6 +439,11 @@ Result<bool> ClearRangeComponents(KeyBytes* out, AllowSpecial allow_special = Al
 // hashed components and first range components are equal and false otherwise.
 Result<bool> HashedOrFirstRangeComponentsEqual(const Slice& lhs, const Slice& rhs);
 
+// Returns prefix of lhs, that contains table id, hash code and leading doc key components, that
+// are equal in lhs and rhs. Could be used as a key for bloom filter, when reading keys in range
+// [lhs, rhs].
+Result<Slice> EqualComponentsPrefix(const Slice& lhs, const Slice& rhs);
+
 bool DocKeyBelongsTo(Slice doc_key, const Schema& schema);
 
 // Consumes single primitive value from start of slice.
@@ -893,6 +898,34 @@ class DocDbAwareV3FilterPolicy : public DocDbAwareFilterPolicyBase {
   const KeyTransformer* GetKeyTransformer() const override;
 };
 
+// Max number of leading range components, that could be used by
+// DocDbAwareRangePrefixFilterPolicy.
+constexpr size_t kMaxRangePrefixFilterComponents = 8;
+
+// This filter policy takes into account following parts of keys for filtering:
+// - For range-based partitioned tables: first num_range_components range components of the doc
+// key. Keys with fewer range components always match the filter.
+// - For hash-based partitioned tables: all hashed components of the doc key, the same as
+// DocDbAwareV3FilterPolicy.
+// Number of range components is a part of the policy name, so SST files written with different
+// number of components use their own policy.
+class DocDbAwareRangePrefixFilterPolicy : public DocDbAwareFilterPolicyBase {
+ public:
+  DocDbAwareRangePrefixFilterPolicy(
+      size_t filter_block_size_bits, rocksdb::Logger* logger, size_t num_range_components);
+  ~DocDbAwareRangePrefixFilterPolicy();
+
+  const char* Name() const override { return name_.c_str(); }
+
+  const KeyTransformer* GetKeyTransformer() const override;
+
+ private:
+  class Extractor;
+
+  const std::string name_;
+  std::unique_ptr<Extractor> extractor_;
+};
+
 // Optional inclusive lower bound and exclusive upper bound for keys served by DocDB.
 // Could be used to split tablet without doing actual splitting of RocksDB files.
 // DocDBCompactionFilter also respects these bounds, so it will filter out non-relevant keys
@@ -927,13 +960,18 @@ struct DocDB {
   rocksdb::DB* regular = nullptr;
   rocksdb::DB* intents = nullptr;
   const KeyBounds* key_bounds = nullptr;
+  // Optional cache of rows resolved by point reads, see RowCache.
+  RowCache* row_cache = nullptr;
+  // Optional value log of the regular DB, see ValueLog.
+  ValueLog* value_log = nullptr;
 
-  static DocDB FromRegularUnbounded(rocksdb::DB* regular) {
-    return {regular, nullptr /* intents */, &KeyBounds::kNoBounds};
+  static DocDB FromRegularUnbounded(rocksdb::DB* regular, ValueLog* value_log = nullptr) {
+    return {regular, nullptr /* intents */, &KeyBounds::kNoBounds, nullptr /* row_cache */,
+            value_log};
   }
 
   DocDB WithoutIntents() {
-    return {regular, nullptr /* intents */, key_bounds};
+    return {regular, nullptr /* intents */, key_bounds, nullptr /* row_cache */, value_log};
   }
 };
 
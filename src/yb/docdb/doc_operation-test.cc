@@ -16,6 +16,7 @@
 #include "yb/common/common.pb.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/db/column_family.h"
+#include "yb/rocksdb/db/filename.h"
 #include "yb/rocksdb/db/internal_stats.h"
 
 #include "yb/common/partial_row.h"
@@ -40,6 +41,8 @@
 #include "yb/util/size_literals.h"
 #include "yb/util/tostring.h"
 
+DECLARE_bool(docdb_delete_expired_files);
+DECLARE_int32(rocksdb_level0_file_num_compaction_trigger);
 DECLARE_uint64(rocksdb_max_file_size_for_compaction);
 DECLARE_int32(rocksdb_level0_slowdown_writes_trigger);
 DECLARE_int32(rocksdb_level0_stop_writes_trigger);
@@ -1116,5 +1119,51 @@ TEST_F(DocOperationTest, MaxFileSizeWithWritesTrigger) {
   ASSERT_EQ(0, stats->GetCFStats(rocksdb::InternalStats::LEVEL0_SLOWDOWN_TOTAL));
 }
 
+TEST_F(DocOperationTest, DeleteExpiredFiles) {
+  google::FlagSaver flag_saver;
+  FLAGS_docdb_delete_expired_files = true;
+
+  ASSERT_OK(DisableCompactions());
+  auto schema = CreateSchema();
+  const auto t0 = HybridTime::FromMicrosecondsAndLogicalValue(1000, 0);
+  const int kRowsPerFile = 10;
+  const int64_t kTtlMs = 1000;
+  // Expired file, followed by file without TTL, followed by expired file.
+  for (int i = 0; i != 3; ++i) {
+    const auto write_time = t0.AddSeconds(i * 10);
+    for (int j = i * kRowsPerFile; j != (i + 1) * kRowsPerFile; ++j) {
+      if (i == 1) {
+        WriteQLRow(QLWriteRequestPB_QLStmtType_QL_STMT_INSERT, schema, {j, j, j, j}, write_time);
+      } else {
+        WriteQLRow(
+            QLWriteRequestPB_QLStmtType_QL_STMT_INSERT, schema, {j, j, j, j}, kTtlMs, write_time);
+      }
+    }
+    ASSERT_OK(FlushRocksDbAndWait());
+  }
+
+  std::vector<rocksdb::LiveFileMetaData> files;
+  rocksdb()->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(3, files.size());
+  std::sort(files.begin(), files.end(), [](const auto& lhs, const auto& rhs) {
+    return rocksdb::TableFileNameToNumber(lhs.name) < rocksdb::TableFileNameToNumber(rhs.name);
+  });
+
+  SetHistoryCutoffHybridTime(t0.AddSeconds(100));
+  FLAGS_rocksdb_level0_file_num_compaction_trigger = 3;
+  ASSERT_OK(ReinitDBOptions());
+  WaitCompactionsDone(rocksdb());
+
+  // Only the oldest file is deleted, because the newest one could overwrite records of the file
+  // without TTL.
+  std::vector<rocksdb::LiveFileMetaData> files_after_deletion;
+  rocksdb()->GetLiveFilesMetaData(&files_after_deletion);
+  ASSERT_EQ(2, files_after_deletion.size());
+  for (const auto& file : files_after_deletion) {
+    ASSERT_NE(files[0].name, file.name);
+  }
+  ASSERT_EQ(1, ReadQLRow(schema, kRowsPerFile, t0.AddSeconds(100)).row_count());
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -13,6 +13,8 @@
 
 #include "yb/docdb/doc_pgsql_scanspec.h"
 
+#include <algorithm>
+
 #include "yb/common/pgsql_protocol.pb.h"
 #include "yb/common/ql_value.h"
 
@@ -103,6 +105,24 @@ DocPgsqlScanSpec::DocPgsqlScanSpec(const Schema& schema,
   upper_doc_key_.AppendValueTypeBeforeGroupEnd(ValueType::kHighest);
 }
 
+DocPgsqlScanSpec::DocPgsqlScanSpec(const Schema& schema,
+                                   const rocksdb::QueryId query_id,
+                                   std::shared_ptr<const std::vector<KeyBytes>> doc_keys)
+    : PgsqlScanSpec(nullptr),
+      doc_keys_(std::move(doc_keys)),
+      schema_(schema),
+      query_id_(query_id),
+      hashed_components_(nullptr),
+      range_components_(nullptr),
+      is_forward_scan_(true) {
+  DCHECK(!doc_keys_->empty());
+  DCHECK(std::is_sorted(doc_keys_->begin(), doc_keys_->end()));
+
+  lower_doc_key_ = doc_keys_->front();
+  upper_doc_key_ = doc_keys_->back();
+  upper_doc_key_.AppendValueTypeBeforeGroupEnd(ValueType::kHighest);
+}
+
 DocPgsqlScanSpec::DocPgsqlScanSpec(
     const Schema& schema,
     const rocksdb::QueryId query_id,
@@ -35,6 +35,12 @@ class DocPgsqlScanSpec : public common::PgsqlScanSpec {
                    const DocKey& start_doc_key = DocKey(),
                    bool is_forward_scan = true);
 
+  // Scan for the specified doc keys, that should be sorted and unique. Only forward scan is
+  // supported.
+  DocPgsqlScanSpec(const Schema& schema,
+                   const rocksdb::QueryId query_id,
+                   std::shared_ptr<const std::vector<KeyBytes>> doc_keys);
+
   // Scan for the given hash key, a condition, and optional doc_key.
   //
   // Note: std::reference_wrapper is used instead of raw lvalue reference to prevent
@@ -86,6 +92,31 @@ class DocPgsqlScanSpec : public common::PgsqlScanSpec {
     return range_options_;
   }
 
+  const std::shared_ptr<const std::vector<KeyBytes>>& doc_keys() const {
+    return doc_keys_;
+  }
+
+  // Number of leading key columns, for which only the first row of each distinct combination of
+  // values is scanned. The rest of the rows with the same values are skipped with a single seek.
+  // Hash columns could only be included all together. 0 means that all rows are scanned.
+  size_t distinct_prefix_length() const {
+    return distinct_prefix_length_;
+  }
+
+  void set_distinct_prefix_length(size_t value) {
+    distinct_prefix_length_ = value;
+  }
+
+  // Whether blocks read by the scan are added to the block cache. Large scans do not add them, so
+  // they do not evict the blocks of frequently read rows.
+  FillBlockCache fill_block_cache() const {
+    return fill_block_cache_;
+  }
+
+  void set_fill_block_cache(FillBlockCache value) {
+    fill_block_cache_ = value;
+  }
+
  private:
   // Return inclusive lower/upper range doc key considering the start_doc_key.
   Result<KeyBytes> Bound(const bool lower_bound) const;
@@ -104,6 +135,9 @@ class DocPgsqlScanSpec : public common::PgsqlScanSpec {
   // The range value options if set. (possibly more than one due to IN conditions).
   std::shared_ptr<std::vector<std::vector<PrimitiveValue>>> range_options_;
 
+  // The exact doc keys to scan for if set.
+  std::shared_ptr<const std::vector<KeyBytes>> doc_keys_;
+
   // Schema of the columns to scan.
   const Schema& schema_;
 
@@ -133,6 +167,10 @@ class DocPgsqlScanSpec : public common::PgsqlScanSpec {
   // Scan behavior.
   bool is_forward_scan_;
 
+  size_t distinct_prefix_length_ = 0;
+
+  FillBlockCache fill_block_cache_ = FillBlockCache::kTrue;
+
   DISALLOW_COPY_AND_ASSIGN(DocPgsqlScanSpec);
 };
 
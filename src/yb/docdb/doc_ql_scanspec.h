@@ -51,6 +51,11 @@ class DocQLScanSpec : public common::QLScanSpec {
       rocksdb::QueryId query_id, bool is_forward_scan = true,
       bool include_static_columns = false, const DocKey& start_doc_key = DocKey());
 
+  // Returns the doc key of the scan for the specified doc_key, or empty key otherwise.
+  const KeyBytes& doc_key() const {
+    return doc_key_;
+  }
+
   // Return the inclusive lower and upper bounds of the scan.
   Result<KeyBytes> LowerBound() const {
     return Bound(true /* lower_bound */);
@@ -25,6 +25,7 @@
 #include "yb/docdb/docdb_fwd.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/subdoc_reader.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/value.h"
@@ -139,6 +140,13 @@ Result<bool> DocDBTableReader::Get(
   key_bytes.AppendRawBytes(root_doc_key);
   if (projection != nullptr) {
     bool doc_found = false;
+    boost::optional<PackedRow> packed_row;
+    const auto packed_row_write_time = subdoc_reader_builder_.packed_row_write_time();
+    if (!subdoc_reader_builder_.packed_row().empty()) {
+      packed_row = VERIFY_RESULT(PackedRow::Decode(subdoc_reader_builder_.packed_row()));
+      // The packed row implies existence of the row.
+      doc_found = true;
+    }
     const size_t subdocument_key_size = key_bytes.size();
     for (const PrimitiveValue& subkey : *projection) {
       // Append subkey to subdocument key. Reserve extra kMaxBytesPerEncodedHybridTime + 1 bytes in
@@ -146,6 +154,17 @@ Result<bool> DocDBTableReader::Get(
       // appending the hybrid time, thereby invalidating the buffer pointer saved by prefix_scope.
       subkey.AppendToKey(&key_bytes);
       key_bytes.Reserve(key_bytes.size() + kMaxBytesPerEncodedHybridTime + 1);
+      if (packed_row) {
+        // Take the column from the packed row, unless it was written after the row.
+        DocHybridTime column_write_time = packed_row_write_time;
+        RETURN_NOT_OK(iter_->FindLatestRecord(key_bytes, &column_write_time));
+        if (column_write_time == packed_row_write_time) {
+          result->SetChild(
+              subkey, VERIFY_RESULT(GetPackedColumn(*packed_row, subkey, packed_row_write_time)));
+          key_bytes.Truncate(subdocument_key_size);
+          continue;
+        }
+      }
       // This seek is to initialize the iterator for BuildSubDocument call.
       iter_->SeekForward(&key_bytes);
       SubDocument descendant;
@@ -13,6 +13,8 @@
 
 #include "yb/docdb/doc_rowwise_iterator.h"
 
+#include <gflags/gflags.h>
+
 #include "yb/common/common.pb.h"
 #include "yb/common/partition.h"
 #include "yb/common/transaction.h"
@@ -28,6 +30,7 @@
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/row_cache.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksdb/db/compaction.h"
@@ -37,6 +40,8 @@
 
 using std::string;
 
+DECLARE_int32(range_key_bloom_filter_components);
+
 namespace yb {
 namespace docdb {
 
@@ -295,6 +300,55 @@ Status DiscreteScanChoices::SeekToCurrentTarget(IntentAwareIterator* db_iter) {
   return Status::OK();
 }
 
+// Scan choices for the explicit list of doc keys, used by batched lookups of rows by ybctid.
+// Keys are visited in sorted order, so consecutive seeks move forward through the same iterator
+// and reuse its data blocks.
+class DocKeysScanChoices : public ScanChoices {
+ public:
+  explicit DocKeysScanChoices(const std::shared_ptr<const std::vector<KeyBytes>>& doc_keys)
+      : ScanChoices(true /* is_forward_scan */), doc_keys_(doc_keys), current_(doc_keys->begin()) {
+    UpdateCurrentTarget();
+  }
+
+  CHECKED_STATUS DoneWithCurrentTarget() override {
+    DCHECK(!FinishedWithScanChoices());
+    ++current_;
+    UpdateCurrentTarget();
+    return Status::OK();
+  }
+
+  CHECKED_STATUS SkipTargetsUpTo(const Slice& new_target) override {
+    DCHECK(!FinishedWithScanChoices());
+    current_ = std::lower_bound(
+        current_, doc_keys_->end(), new_target,
+        [](const KeyBytes& lhs, const Slice& rhs) { return lhs.CompareTo(rhs) < 0; });
+    UpdateCurrentTarget();
+    return Status::OK();
+  }
+
+  CHECKED_STATUS SeekToCurrentTarget(IntentAwareIterator* db_iter) override {
+    if (!FinishedWithScanChoices()) {
+      VLOG(2) << __PRETTY_FUNCTION__ << " Seeking to " << current_scan_target_;
+      db_iter->Seek(current_scan_target_);
+    }
+    return Status::OK();
+  }
+
+ private:
+  void UpdateCurrentTarget() {
+    if (current_ == doc_keys_->end()) {
+      finished_ = true;
+      current_scan_target_.Clear();
+    } else {
+      current_scan_target_ = *current_;
+    }
+  }
+
+  // Sorted and unique doc keys to look up.
+  std::shared_ptr<const std::vector<KeyBytes>> doc_keys_;
+  std::vector<KeyBytes>::const_iterator current_;
+};
+
 class RangeBasedScanChoices : public ScanChoices {
  public:
   RangeBasedScanChoices(const Schema& schema, const DocQLScanSpec& doc_spec)
@@ -520,6 +574,12 @@ Result<bool> DocRowwiseIterator::InitScanChoices(
 Result<bool> DocRowwiseIterator::InitScanChoices(
     const DocPgsqlScanSpec& doc_spec, const KeyBytes& lower_doc_key,
     const KeyBytes& upper_doc_key) {
+  if (doc_spec.doc_keys()) {
+    scan_choices_.reset(new DocKeysScanChoices(doc_spec.doc_keys()));
+    RETURN_NOT_OK(AdvanceIteratorToNextDesiredRow());
+    return true;
+  }
+
   if (doc_spec.range_options()) {
     scan_choices_.reset(new DiscreteScanChoices(doc_spec, lower_doc_key, upper_doc_key));
     // Let's not seek to the lower doc key or upper doc key. We know exactly what we want.
@@ -551,13 +611,26 @@ Status DocRowwiseIterator::DoInit(const T& doc_spec) {
       VERIFY_RESULT(HashedOrFirstRangeComponentsEqual(lower_doc_key, upper_doc_key));
   const auto mode = is_fixed_point_get ? BloomFilterMode::USE_BLOOM_FILTER
                                        : BloomFilterMode::DONT_USE_BLOOM_FILTER;
+  // DocDbAwareRangePrefixFilterPolicy could use more range components than checked above, so only
+  // components that are common for all keys of the scan are provided to the filter. Default
+  // DocDbAwareV3FilterPolicy keeps using the lower bound.
+  const bool range_prefix_filter = FLAGS_range_key_bloom_filter_components > 1;
+  const Slice user_key_for_filter = is_fixed_point_get && range_prefix_filter
+      ? VERIFY_RESULT(EqualComponentsPrefix(lower_doc_key, upper_doc_key))
+      : lower_doc_key.AsSlice();
 
   db_iter_ = CreateIntentAwareIterator(
-      doc_db_, mode, lower_doc_key.AsSlice(), doc_spec.QueryId(), txn_op_context_,
-      deadline_, read_time_, doc_spec.CreateFileFilter());
+      doc_db_, mode, user_key_for_filter, doc_spec.QueryId(), txn_op_context_,
+      deadline_, read_time_, doc_spec.CreateFileFilter(), nullptr /* iterate_upper_bound */,
+      fill_block_cache_);
 
   row_ready_ = false;
 
+  row_cache_key_ = RowCacheKey(doc_spec);
+  if (!row_cache_key_.empty() && VERIFY_RESULT(ReadFromRowCache())) {
+    return Status::OK();
+  }
+
   if (is_forward_scan_) {
     has_bound_key_ = !upper_doc_key.empty();
     if (has_bound_key_) {
@@ -594,7 +667,74 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
 
 Status DocRowwiseIterator::Init(const common::PgsqlScanSpec& spec) {
   ignore_ttl_ = true;
-  return DoInit(dynamic_cast<const DocPgsqlScanSpec&>(spec));
+  const auto& doc_spec = dynamic_cast<const DocPgsqlScanSpec&>(spec);
+  distinct_prefix_length_ = doc_spec.distinct_prefix_length();
+  fill_block_cache_ = doc_spec.fill_block_cache();
+  return DoInit(doc_spec);
+}
+
+KeyBytes DocRowwiseIterator::RowCacheKey(const DocQLScanSpec& doc_spec) const {
+  // Intents are not visible to reads without transaction context, so the cache is used only by
+  // such reads.
+  if (!doc_db_.row_cache || txn_op_context_ || !doc_spec.is_forward_scan() ||
+      doc_spec.doc_key().empty()) {
+    return KeyBytes();
+  }
+  // Only reads of the whole primary key of hash partitioned tables are cached, because the cache
+  // is invalidated by hash part of written keys.
+  DocKey doc_key;
+  if (!doc_key.FullyDecodeFrom(doc_spec.doc_key().AsSlice()).ok() ||
+      doc_key.has_cotable_id() || doc_key.has_pgtable_id() || doc_key.hashed_group().empty() ||
+      doc_key.range_group().size() != schema_.num_range_key_columns()) {
+    return KeyBytes();
+  }
+  return doc_spec.doc_key();
+}
+
+Result<bool> DocRowwiseIterator::ReadFromRowCache() {
+  auto row = doc_db_.row_cache->Get(
+      row_cache_key_.AsSlice(), projection_subkeys_, read_time_.read);
+  if (!row) {
+    return false;
+  }
+  iter_key_ = row_cache_key_;
+  auto dockey_sizes = VERIFY_RESULT(DocKey::EncodedHashPartAndDocKeySizes(iter_key_));
+  row_hash_key_ = iter_key_.AsSlice().Prefix(dockey_sizes.first);
+  row_key_ = iter_key_.AsSlice().Prefix(dockey_sizes.second);
+  row_ = std::move(*row);
+  row_ready_ = true;
+  done_ = true;
+  return true;
+}
+
+Result<Slice> DocRowwiseIterator::DistinctPrefix(const Slice& row_key) const {
+  DocKeyDecoder decoder(row_key);
+  RETURN_NOT_OK(decoder.DecodeToRangeGroup());
+  for (size_t i = schema_.num_hash_key_columns(); i < distinct_prefix_length_; ++i) {
+    if (!VERIFY_RESULT(decoder.HasPrimitiveValue())) {
+      break;
+    }
+    RETURN_NOT_OK(decoder.DecodePrimitiveValue());
+  }
+  return Slice(row_key.data(), decoder.left_input().data());
+}
+
+Result<bool> DocRowwiseIterator::SkipToNextDistinctPrefix() const {
+  if (last_distinct_prefix_.empty() || !row_key_.starts_with(last_distinct_prefix_.AsSlice())) {
+    return false;
+  }
+  // All keys with the prefix are greater than the prefix itself and less than the prefix followed
+  // by kMaxByte.
+  if (is_forward_scan_) {
+    auto target = last_distinct_prefix_;
+    target.AppendValueType(ValueType::kMaxByte);
+    VLOG(4) << __PRETTY_FUNCTION__ << " Seeking to " << target;
+    db_iter_->Seek(target);
+  } else {
+    VLOG(4) << __PRETTY_FUNCTION__ << " Going to PrevDocKey " << last_distinct_prefix_;
+    db_iter_->PrevDocKey(last_distinct_prefix_);
+  }
+  return true;
 }
 
 Status DocRowwiseIterator::AdvanceIteratorToNextDesiredRow() const {
@@ -673,6 +813,17 @@ Result<bool> DocRowwiseIterator::HasNext() const {
       return false;
     }
 
+    if (distinct_prefix_length_ != 0) {
+      auto skipped = SkipToNextDistinctPrefix();
+      if (!skipped.ok()) {
+        has_next_status_ = skipped.status();
+        return has_next_status_;
+      }
+      if (*skipped) {
+        continue;
+      }
+    }
+
     // Prepare the DocKey to get the SubDocument. Trim the DocKey to contain just the primary key.
     Slice sub_doc_key = row_key_;
     VLOG(4) << " sub_doc_key part of iter_key_ is " << DocKey::DebugSliceToString(sub_doc_key);
@@ -711,6 +862,23 @@ Result<bool> DocRowwiseIterator::HasNext() const {
     } else {
       doc_found = VERIFY_RESULT(doc_found_res);
     }
+    if (doc_found && !row_cache_key_.empty() && row_key_ == row_cache_key_.AsSlice()) {
+      // Row that requires read restart is not cached, since it could be overwritten at read time.
+      auto max_seen_ht = db_iter_->max_seen_ht();
+      if (!max_seen_ht.is_valid() || max_seen_ht <= read_time_.read) {
+        doc_db_.row_cache->Put(
+            row_cache_key_.AsSlice(), row_hash_key_.size(), projection_subkeys_, read_time_.read,
+            row_);
+      }
+    }
+    if (doc_found && distinct_prefix_length_ != 0) {
+      auto prefix = DistinctPrefix(row_key_);
+      if (!prefix.ok()) {
+        has_next_status_ = prefix.status();
+        return has_next_status_;
+      }
+      last_distinct_prefix_.Reset(*prefix);
+    }
     if (scan_choices_ && !is_static_column) {
       has_next_status_ = scan_choices_->DoneWithCurrentTarget();
       RETURN_NOT_OK(has_next_status_);
@@ -805,10 +973,11 @@ Status DocRowwiseIterator::DoNextRow(const Schema& projection, QLTableRow* table
   for (size_t i = projection.num_key_columns(); i < projection.num_columns(); i++) {
     const auto& column_id = projection.column_id(i);
     const auto ql_type = projection.column(i).type();
-    const SubDocument* column_value = row_.GetChild(PrimitiveValue(column_id));
+    // The row is read again for the next row, so column values could be moved out of it.
+    SubDocument* column_value = row_.GetChild(PrimitiveValue(column_id));
     if (column_value != nullptr) {
       QLTableColumn& column = table_row->AllocColumn(column_id);
-      SubDocument::ToQLValuePB(*column_value, ql_type, &column.value);
+      SubDocument::MoveToQLValuePB(column_value, ql_type, &column.value);
       column.ttl_seconds = column_value->GetTtl();
       if (column_value->IsWriteTimeSet()) {
         column.write_time = column_value->GetWriteTime();
@@ -121,6 +121,22 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
       const DocPgsqlScanSpec& doc_spec, const KeyBytes& lower_doc_key,
       const KeyBytes& upper_doc_key);
 
+  // Returns the key of the point read, that could be served from the row cache, or empty key.
+  KeyBytes RowCacheKey(const DocQLScanSpec& doc_spec) const;
+  KeyBytes RowCacheKey(const DocPgsqlScanSpec& doc_spec) const {
+    return KeyBytes();
+  }
+
+  // Tries to read the row at row_cache_key_ from the row cache. Returns true on success.
+  Result<bool> ReadFromRowCache();
+
+  // Returns the prefix of the row key, that contains distinct_prefix_length_ leading key columns.
+  Result<Slice> DistinctPrefix(const Slice& row_key) const;
+
+  // When the current row has the same distinct prefix as the previously found row, seeks past
+  // the rows with this prefix and returns true.
+  Result<bool> SkipToNextDistinctPrefix() const;
+
   // Get the non-key column values of a QL row.
   CHECKED_STATUS GetValues(const Schema& projection, vector<SubDocument>* values);
 
@@ -221,6 +237,18 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   mutable std::unique_ptr<DocDBTableReader> doc_reader_ = nullptr;
 
   mutable bool ignore_ttl_ = false;
+
+  // Key of the row that is looked up and stored in the row cache, empty if the cache is not used.
+  KeyBytes row_cache_key_;
+
+  // See DocPgsqlScanSpec::distinct_prefix_length.
+  size_t distinct_prefix_length_ = 0;
+
+  // See DocPgsqlScanSpec::fill_block_cache.
+  FillBlockCache fill_block_cache_ = FillBlockCache::kTrue;
+
+  // Distinct prefix of the last found row, empty until a row is found.
+  mutable KeyBytes last_distinct_prefix_;
 };
 
 }  // namespace docdb
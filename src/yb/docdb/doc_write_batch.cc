@@ -386,6 +386,21 @@ Status DocWriteBatch::SetPrimitive(const DocPath& doc_path,
   return SetPrimitive(doc_path, value, &iter);
 }
 
+Status DocWriteBatch::SetPackedRow(const Slice& encoded_doc_key, const Slice& packed_row) {
+  DOCDB_DEBUG_LOG("Called SetPackedRow with doc_key=$0", BestEffortDocDBKeyToStr(encoded_doc_key));
+  if (put_batch_.size() > numeric_limits<IntraTxnWriteId>::max()) {
+    return STATUS_SUBSTITUTE(
+        NotSupported,
+        "Trying to add more than $0 key/value pairs in the same single-shard txn.",
+        numeric_limits<IntraTxnWriteId>::max());
+  }
+  const auto write_id = static_cast<IntraTxnWriteId>(put_batch_.size());
+  key_prefix_.Reset(encoded_doc_key);
+  put_batch_.emplace_back(key_prefix_.ToStringBuffer(), packed_row.ToBuffer());
+  cache_.Put(key_prefix_, DocHybridTime(HybridTime::kMax, write_id), ValueType::kPackedRow);
+  return Status::OK();
+}
+
 Status DocWriteBatch::ExtendSubDocument(
     const DocPath& doc_path,
     const SubDocument& value,
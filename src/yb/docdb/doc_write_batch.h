@@ -186,6 +186,10 @@ class DocWriteBatch {
                         read_ht, deadline, query_id, user_timestamp);
   }
 
+  // Sets the value of the document with the specified encoded key to the packed row, see
+  // packed_row.h.
+  CHECKED_STATUS SetPackedRow(const Slice& encoded_doc_key, const Slice& packed_row);
+
   void Clear();
   bool IsEmpty() const { return put_batch_.empty(); }
 
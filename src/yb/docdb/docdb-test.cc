@@ -37,6 +37,7 @@
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/in_mem_docdb.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/walltime.h"
 #include "yb/rocksutil/yb_rocksdb.h"
@@ -685,6 +686,112 @@ TEST_F(DocDBTestQl, ColocatedTableTombstoneTest) {
   VerifySubDocument(SubDocKey(doc_key_1), 1500_usec_ht, "1");
 }
 
+namespace {
+
+std::string PackRow(const std::vector<std::pair<ColumnId, PrimitiveValue>>& columns) {
+  RowPacker packer(/* schema_version= */ 1);
+  for (const auto& column : columns) {
+    CHECK_OK(packer.AddValue(column.first, column.second));
+  }
+  return CHECK_RESULT(packer.Complete()).ToBuffer();
+}
+
+} // namespace
+
+TEST_F(DocDBTestQl, PackedRow) {
+  const DocKey doc_key(PrimitiveValues("mydockey", 123456));
+  KeyBytes encoded_doc_key(doc_key.Encode());
+  const PrimitiveValue c10(10_ColId), c11(11_ColId), c12(12_ColId), c13(13_ColId);
+  const auto column_path = [&encoded_doc_key](const PrimitiveValue& column) {
+    return DocPath(encoded_doc_key, column);
+  };
+
+  // The previous version of the row, that is deleted before the packed row is inserted.
+  ASSERT_OK(SetPrimitive(column_path(c10), PrimitiveValue(0), 500_usec_ht));
+  ASSERT_OK(DeleteSubDoc(DocPath(encoded_doc_key), 700_usec_ht));
+  auto dwb = MakeDocWriteBatch();
+  ASSERT_OK(dwb.SetPackedRow(
+      encoded_doc_key.AsSlice(),
+      PackRow({{10_ColId, PrimitiveValue(1)}, {11_ColId, PrimitiveValue("a")},
+               {12_ColId, PrimitiveValue(3)}, {14_ColId, PrimitiveValue::kTombstone}})));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, 1000_usec_ht));
+  // Updates of the row after the insert.
+  ASSERT_OK(SetPrimitive(column_path(c11), PrimitiveValue("b"), 2000_usec_ht));
+  ASSERT_OK(DeleteSubDoc(column_path(c12), 3000_usec_ht));
+  ASSERT_OK(SetPrimitive(column_path(c13), PrimitiveValue(13), 4000_usec_ht));
+  ASSERT_OK(SetPrimitive(column_path(c11), PrimitiveValue("c"), 6000_usec_ht));
+
+  const auto encoded_subdoc_key = SubDocKey(doc_key).EncodeWithoutHt();
+  const vector<PrimitiveValue> projection = {
+      PrimitiveValue::kLivenessColumn, c10, c11, c12, c13, PrimitiveValue(14_ColId)};
+  const auto read = [&](HybridTime read_ht, const vector<PrimitiveValue>* projection) {
+    SubDocument doc;
+    bool found = false;
+    GetSubDocQl(
+        doc_db(), encoded_subdoc_key, &doc, &found, kNonTransactionalOperationContext,
+        ReadHybridTime::SingleTime(read_ht), projection);
+    EXPECT_TRUE(found);
+    return doc;
+  };
+  const auto column_type = [](SubDocument* doc, const PrimitiveValue& column) {
+    auto* child = doc->GetChild(column);
+    return child ? child->value_type() : ValueType::kInvalid;
+  };
+  const auto check_latest = [&](HybridTime read_ht) {
+    for (auto* p : {&projection, static_cast<const vector<PrimitiveValue>*>(nullptr)}) {
+      SCOPED_TRACE(Format("Read at $0, projection: $1", read_ht, p != nullptr));
+      auto doc = read(read_ht, p);
+      ASSERT_EQ(PrimitiveValue(1), *doc.GetChild(c10));
+      ASSERT_EQ(PrimitiveValue("b"), *doc.GetChild(c11));
+      ASSERT_NE(column_type(&doc, c12), ValueType::kInt64);
+      ASSERT_EQ(PrimitiveValue(13), *doc.GetChild(c13));
+      // NULL is not read as a value, the same as a deleted column.
+      ASSERT_NE(column_type(&doc, PrimitiveValue(14_ColId)), ValueType::kNullLow);
+      ASSERT_EQ(ValueType::kNullLow, column_type(&doc, PrimitiveValue::kLivenessColumn));
+    }
+  };
+
+  {
+    auto doc = read(1500_usec_ht, &projection);
+    ASSERT_EQ(PrimitiveValue(1), *doc.GetChild(c10));
+    ASSERT_EQ(PrimitiveValue("a"), *doc.GetChild(c11));
+    ASSERT_EQ(PrimitiveValue(3), *doc.GetChild(c12));
+    ASSERT_EQ(ValueType::kInvalid, column_type(&doc, c13));
+    ASSERT_EQ(ValueType::kTombstone, column_type(&doc, PrimitiveValue(14_ColId)));
+    // The value of the packed column has the write time of the row.
+    ASSERT_EQ(1000, doc.GetChild(c10)->GetWriteTime());
+  }
+  ASSERT_NO_FATALS(check_latest(5000_usec_ht));
+  ASSERT_EQ(PrimitiveValue("c"), *read(7000_usec_ht, &projection).GetChild(c11));
+  ASSERT_NE(DocDBDebugDumpToStr().find("schema_version: 1"), std::string::npos);
+
+  // Minor compactions do not fold columns into the packed row.
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_OK(SetPrimitive(column_path(c10), PrimitiveValue(2), 8000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  MinorCompaction(5000_usec_ht, /* num_files_to_compact */ 2);
+  auto dump = DocDBDebugDumpToStr();
+  ASSERT_NE(dump.find("\"b\""), std::string::npos) << dump;
+  ASSERT_NO_FATALS(check_latest(5000_usec_ht));
+
+  // Major compaction folds the columns written at or below the history cutoff into the packed row,
+  // so only the packed row and the later column values are left.
+  retention_policy_->AddDeletedColumn(12_ColId);
+  FullyCompactHistoryBefore(5000_usec_ht);
+  dump = DocDBDebugDumpToStr();
+  ASSERT_EQ(3, std::count(dump.begin(), dump.end(), '\n')) << dump;
+  ASSERT_NE(dump.find("schema_version: 1"), std::string::npos) << dump;
+  ASSERT_NO_FATALS(check_latest(5000_usec_ht));
+  ASSERT_EQ(PrimitiveValue("c"), *read(7000_usec_ht, &projection).GetChild(c11));
+  ASSERT_EQ(PrimitiveValue(2), *read(9000_usec_ht, &projection).GetChild(c10));
+
+  // The row deleted after the packed row is not found.
+  ASSERT_OK(DeleteSubDoc(DocPath(encoded_doc_key), 10000_usec_ht));
+  VerifySubDocument(SubDocKey(doc_key), 11000_usec_ht, "");
+  FullyCompactHistoryBefore(12000_usec_ht);
+  ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ("");
+}
+
 TEST_P(DocDBTestWrapper, HistoryCompactionFirstRowHandlingRegression) {
   // A regression test for a bug in an initial version of compaction cleanup.
   const DocKey doc_key(PrimitiveValues("mydockey", 123456));
@@ -3249,6 +3356,71 @@ SubDocKey(DocKey(0x0000, ["h1"], ["r2"]), ["c8"; HT{ physical: 1000 }]) -> "v82"
       )#");
 }
 
+TEST_F(DocDBTestQl, CounterDeltas) {
+  const DocKey doc_key(PrimitiveValues("k1"));
+  const KeyBytes encoded_doc_key(doc_key.Encode());
+  const DocPath counter_path(encoded_doc_key, PrimitiveValue("c"));
+  const auto delta = [](int64_t value) {
+    return Value(PrimitiveValue(value), Value::kMaxTtl, Value::kInvalidUserTimestamp,
+                 Value::kCounterDeltaFlag);
+  };
+
+  ASSERT_OK(SetPrimitive(counter_path, delta(3), 1000_usec_ht));
+  ASSERT_OK(SetPrimitive(counter_path, delta(-1), 2000_usec_ht));
+  ASSERT_OK(SetPrimitive(counter_path, Value(PrimitiveValue(int64_t{10})), 3000_usec_ht));
+  ASSERT_OK(SetPrimitive(counter_path, delta(5), 4000_usec_ht));
+  ASSERT_OK(SetPrimitive(counter_path, delta(7), 5000_usec_ht));
+  // Deltas written after the row is deleted start from zero.
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key), PrimitiveValue::kTombstone, 6000_usec_ht));
+  ASSERT_OK(SetPrimitive(counter_path, delta(4), 7000_usec_ht));
+
+  VerifySubDocument(SubDocKey(doc_key), 1500_usec_ht, R"#(
+{
+  "c": 3
+}
+      )#");
+  VerifySubDocument(SubDocKey(doc_key), 2000_usec_ht, R"#(
+{
+  "c": 2
+}
+      )#");
+  VerifySubDocument(SubDocKey(doc_key), 3000_usec_ht, R"#(
+{
+  "c": 10
+}
+      )#");
+  VerifySubDocument(SubDocKey(doc_key), 5000_usec_ht, R"#(
+{
+  "c": 22
+}
+      )#");
+  VerifySubDocument(SubDocKey(doc_key), 7000_usec_ht, R"#(
+{
+  "c": 4
+}
+      )#");
+
+  // The deltas overwritten by the full value are removed, the newer ones are kept.
+  FullyCompactHistoryBefore(5000_usec_ht);
+  ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(R"#(
+SubDocKey(DocKey([], ["k1"]), [HT{ physical: 6000 }]) -> DEL
+SubDocKey(DocKey([], ["k1"]), ["c"; HT{ physical: 7000 }]) -> 4; merge flags: 2
+SubDocKey(DocKey([], ["k1"]), ["c"; HT{ physical: 5000 }]) -> 7; merge flags: 2
+SubDocKey(DocKey([], ["k1"]), ["c"; HT{ physical: 4000 }]) -> 5; merge flags: 2
+SubDocKey(DocKey([], ["k1"]), ["c"; HT{ physical: 3000 }]) -> 10
+      )#");
+  VerifySubDocument(SubDocKey(doc_key), 5000_usec_ht, R"#(
+{
+  "c": 22
+}
+      )#");
+  VerifySubDocument(SubDocKey(doc_key), 7000_usec_ht, R"#(
+{
+  "c": 4
+}
+      )#");
+}
+
 TEST_P(DocDBTestWrapper, TestUserTimestamp) {
   const DocKey doc_key(PrimitiveValues("k1"));
   KeyBytes encoded_doc_key(doc_key.Encode());
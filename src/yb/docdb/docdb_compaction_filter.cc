@@ -23,9 +23,22 @@
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_ttl_util.h"
 #include "yb/docdb/docdb-internal.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/value.h"
+#include "yb/docdb/value_log.h"
 #include "yb/docdb/consensus_frontier.h"
+#include "yb/rocksdb/db/version_edit.h"
 #include "yb/rocksutil/yb_rocksdb.h"
+#include "yb/server/hybrid_clock.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
+
+DEFINE_bool(docdb_delete_expired_files, false,
+            "Record expiration time of records in SST file metadata, and delete files whose "
+            "records are all expired before the history cutoff without compacting them.");
+TAG_FLAG(docdb_delete_expired_files, advanced);
+
+DECLARE_int32(docdb_value_log_min_value_size);
 
 using std::shared_ptr;
 using std::unique_ptr;
@@ -37,18 +50,29 @@ using rocksdb::FilterDecision;
 namespace yb {
 namespace docdb {
 
+Status GetDocHybridTime(const rocksdb::UserBoundaryValues& values, DocHybridTime* out);
+HybridTime MaxFileExpiration(const rocksdb::UserBoundaryValues& largest, MonoDelta table_ttl);
+Result<bool> HasMergeRecords(const rocksdb::UserBoundaryValues& largest);
+
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilter::DocDBCompactionFilter(
     HistoryRetentionDirective retention,
     IsMajorCompaction is_major_compaction,
-    const KeyBounds* key_bounds)
+    const KeyBounds* key_bounds,
+    ValueLog* value_log)
     : retention_(std::move(retention)),
       key_bounds_(key_bounds),
-      is_major_compaction_(is_major_compaction) {
+      is_major_compaction_(is_major_compaction),
+      value_log_(value_log) {
 }
 
 DocDBCompactionFilter::~DocDBCompactionFilter() {
+  // Output files of the compaction are written at this point, so they keep value log files from
+  // deletion, while they are not live yet.
+  if (pinned_value_log_file_) {
+    value_log_->Unpin(pinned_value_log_file_);
+  }
 }
 
 FilterDecision DocDBCompactionFilter::Filter(
@@ -59,10 +83,11 @@ FilterDecision DocDBCompactionFilter::Filter(
   if (!result.ok()) {
     LOG(FATAL) << "Error filtering " << key.ToDebugString() << ": " << result.status();
   }
-  if (*result != FilterDecision::kKeep) {
+  if (*result == FilterDecision::kDiscard) {
     VLOG(3) << "Discarding key: " << BestEffortDocDBKeyToStr(key);
   } else {
-    VLOG(4) << "Keeping key: " << BestEffortDocDBKeyToStr(key);
+    VLOG(4) << (*result == FilterDecision::kDelay ? "Delaying key: " : "Keeping key: ")
+            << BestEffortDocDBKeyToStr(key);
   }
   return *result;
 }
@@ -112,6 +137,11 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
   RETURN_NOT_OK(SubDocKey::DecodeDocKeyAndSubKeyEnds(key, &sub_key_ends_));
   const size_t new_stack_size = sub_key_ends_.size();
 
+  // All column values of the delayed packed row precede the next document.
+  if (delayed_packed_row_ && Slice(key.data(), sub_key_ends_[0]) != delayed_packed_row_->doc_key) {
+    RETURN_NOT_OK(CompletePackedRow());
+  }
+
   // Remove overwrite hybrid_times for components that are no longer relevant for the current
   // SubDocKey.
   overwrite_.resize(min(overwrite_.size(), num_shared_components));
@@ -157,8 +187,15 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
   // hybrid_time stack, and we might as well do that while handling the next key/value pair that
   // does not get cleaned up the same way as this one.
   //
-  // TODO: When more merge records are supported, isTtlRow should be redefined appropriately.
-  bool isTtlRow = IsMergeRecord(existing_value);
+  uint64_t merge_flags = 0;
+  if (IsMergeRecord(existing_value)) {
+    RETURN_NOT_OK(Value::DecodeMergeFlags(existing_value, &merge_flags));
+  }
+  const bool isTtlRow = merge_flags == Value::kTtlFlag;
+  // A counter delta does not overwrite the older versions of the counter, which are summed by the
+  // readers. Deltas are removed like other entries once a full counter value written at or before
+  // the history cutoff overwrites them.
+  const bool is_counter_delta = merge_flags == Value::kCounterDeltaFlag;
   if (ht < prev_overwrite_ht && !isTtlRow) {
     return FilterDecision::kDiscard;
   }
@@ -198,20 +235,22 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
   //
   // TODO: could there be a case when there is still a read request running that uses an old schema,
   //       and we end up removing some data that the client expects to see?
+  boost::optional<ColumnId> column_id;
   if (sub_key_ends_.size() > 1) {
     // Column ID is the first subkey in every CQL row.
     if (key[sub_key_ends_[0]]  == ValueTypeAsChar::kColumnId) {
       Slice column_id_slice(key.data() + sub_key_ends_[0] + 1, key.data() + sub_key_ends_[1]);
       auto column_id_as_int64 = VERIFY_RESULT(util::FastDecodeSignedVarInt(&column_id_slice));
-      ColumnId column_id;
-      RETURN_NOT_OK(ColumnId::FromInt64(column_id_as_int64, &column_id));
-      if (retention_.deleted_cols->count(column_id) != 0) {
+      column_id.emplace();
+      RETURN_NOT_OK(ColumnId::FromInt64(column_id_as_int64, &*column_id));
+      if (retention_.deleted_cols->count(*column_id) != 0) {
         return FilterDecision::kDiscard;
       }
     }
   }
 
-  auto overwrite_ht = isTtlRow ? prev_overwrite_ht : max(prev_overwrite_ht, ht);
+  auto overwrite_ht =
+      isTtlRow || is_counter_delta ? prev_overwrite_ht : max(prev_overwrite_ht, ht);
 
   Value value;
   Slice value_slice = existing_value;
@@ -299,6 +338,33 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
     value.EncodeAndAppend(new_value, &value_slice);
   }
 
+  // The packed row is delayed to fold the columns that follow it. Folding is done only by major
+  // compactions, since older column values could be stored in files that are not compacted.
+  // Tombstones of columns are folded as NULL, so the row is not packed while delete markers are
+  // retained.
+  const bool has_ttl = has_expired || value.has_ttl() || within_merge_block_;
+  if (value_type == ValueType::kPackedRow && new_stack_size == 1 && !has_ttl &&
+      is_major_compaction_ && !retention_.retain_delete_markers_in_major_compaction) {
+    DCHECK(!delayed_packed_row_);
+    delayed_packed_row_.emplace();
+    delayed_packed_row_->doc_key.assign(key.cdata(), sub_key_ends_[0]);
+    delayed_packed_row_->control_fields = value;
+    delayed_packed_row_->packed_row = value_slice.ToBuffer();
+    return FilterDecision::kDelay;
+  }
+
+  // Only the latest column value at or below the history cutoff reaches this point, since older
+  // ones are overwritten by it. Values with TTL or user timestamp, counters and values stored in
+  // the value log keep their own entries.
+  if (delayed_packed_row_ && column_id && new_stack_size == 2 && !has_ttl && merge_flags == 0 &&
+      !value.has_user_timestamp() &&
+      (value_type == ValueType::kTombstone ||
+       (IsPrimitiveValueType(value_type) && value_type != ValueType::kValueLogReference &&
+        value_type != ValueType::kPackedRow))) {
+    delayed_packed_row_->updates[*column_id] = value_slice.ToBuffer();
+    return FilterDecision::kDiscard;
+  }
+
   // If we are backfilling an index table, we want to preserve the delete markers in the table
   // until the backfill process is completed. For other normal use cases, delete markers/tombstones
   // can be cleaned up on a major compaction.
@@ -309,10 +375,59 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
   // compactions. However, we do need to update the overwrite hybrid time stack in this case (as we
   // just did), because this deletion (tombstone) entry might be the only reason for cleaning up
   // more entries appearing at earlier hybrid times.
-  return value_type == ValueType::kTombstone && is_major_compaction_ &&
-                 !retention_.retain_delete_markers_in_major_compaction
-             ? FilterDecision::kDiscard
-             : FilterDecision::kKeep;
+  if (value_type == ValueType::kTombstone) {
+    return is_major_compaction_ && !retention_.retain_delete_markers_in_major_compaction
+               ? FilterDecision::kDiscard
+               : FilterDecision::kKeep;
+  }
+
+  // Move the value to the value log, keeping its control fields. Values that are already in the
+  // value log are written with the same reference.
+  const int64_t min_value_log_size = FLAGS_docdb_value_log_min_value_size;
+  if (value_log_ && !has_expired && min_value_log_size > 0 &&
+      value_type != ValueType::kValueLogReference && value_type != ValueType::kPackedRow &&
+      value_slice.size() >= static_cast<size_t>(min_value_log_size)) {
+    auto reference = value_log_->Append(value_slice, &pinned_value_log_file_);
+    if (reference.ok()) {
+      std::string encoded_reference;
+      reference->AppendEncoded(&encoded_reference);
+      Slice reference_slice(encoded_reference);
+      new_value->clear();
+      value.EncodeAndAppend(new_value, &reference_slice);
+      *value_changed = true;
+    } else {
+      // The value is kept in the SST file.
+      YB_LOG_EVERY_N_SECS(WARNING, 10) << "Failed to append to value log: " << reference.status();
+    }
+  }
+  return FilterDecision::kKeep;
+}
+
+Status DocDBCompactionFilter::CompletePackedRow() {
+  auto packed_row = VERIFY_RESULT(PackedRow::Decode(delayed_packed_row_->packed_row));
+  std::string repacked;
+  RETURN_NOT_OK(RepackRow(
+      packed_row, delayed_packed_row_->updates, *retention_.deleted_cols, &repacked));
+  completed_value_.emplace();
+  Slice repacked_slice(repacked);
+  delayed_packed_row_->control_fields.EncodeAndAppend(&*completed_value_, &repacked_slice);
+  delayed_packed_row_.reset();
+  return Status::OK();
+}
+
+bool DocDBCompactionFilter::CompleteDelayedValue(bool end_of_input, std::string* value) {
+  if (end_of_input && delayed_packed_row_) {
+    auto status = CompletePackedRow();
+    if (!status.ok()) {
+      LOG(FATAL) << "Error completing packed row: " << status;
+    }
+  }
+  if (!completed_value_) {
+    return false;
+  }
+  *value = std::move(*completed_value_);
+  completed_value_.reset();
+  return true;
 }
 
 void DocDBCompactionFilter::AssignPrevSubDocKey(
@@ -341,11 +456,17 @@ Slice DocDBCompactionFilter::DropKeysGreaterOrEqual() const {
   return key_bounds_ ? key_bounds_->upper.AsSlice() : Slice();
 }
 
+Status DocDBCompactionFilter::SyncExternalData() {
+  return value_log_ ? value_log_->Sync() : Status::OK();
+}
+
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilterFactory::DocDBCompactionFilterFactory(
-    std::shared_ptr<HistoryRetentionPolicy> retention_policy, const KeyBounds* key_bounds)
-    : retention_policy_(std::move(retention_policy)), key_bounds_(key_bounds) {
+    std::shared_ptr<HistoryRetentionPolicy> retention_policy, const KeyBounds* key_bounds,
+    ValueLog* value_log)
+    : retention_policy_(std::move(retention_policy)), key_bounds_(key_bounds),
+      value_log_(value_log) {
 }
 
 DocDBCompactionFilterFactory::~DocDBCompactionFilterFactory() {
@@ -356,7 +477,109 @@ unique_ptr<CompactionFilter> DocDBCompactionFilterFactory::CreateCompactionFilte
   return std::make_unique<DocDBCompactionFilter>(
       retention_policy_->GetRetentionDirective(),
       IsMajorCompaction(context.is_full_compaction),
-      key_bounds_);
+      key_bounds_,
+      value_log_);
+}
+
+std::vector<rocksdb::FileMetaData*> DocDBCompactionFilterFactory::ObsoleteFiles(
+    const std::vector<rocksdb::FileMetaData*>& files) {
+  std::vector<rocksdb::FileMetaData*> result;
+  if (!FLAGS_docdb_delete_expired_files || files.empty()) {
+    return result;
+  }
+
+  struct FileInfo {
+    rocksdb::FileMetaData* file;
+    HybridTime smallest_ht;
+    HybridTime largest_ht;
+    bool expired;
+  };
+  std::vector<FileInfo> infos;
+  infos.reserve(files.size());
+  const auto retention = retention_policy_->GetRetentionDirective();
+  if (retention.retain_delete_markers_in_major_compaction) {
+    return result;
+  }
+  const auto history_cutoff_micros =
+      server::HybridClock::GetPhysicalValueMicros(retention.history_cutoff);
+  for (auto* file : files) {
+    DocHybridTime smallest, largest;
+    auto has_merge_records = HasMergeRecords(file->largest.user_values);
+    // Merge records could extend TTL of records in other files. Also all files should have
+    // expiration recorded, so it is known which records could be overwritten by the file.
+    if (!has_merge_records.ok() || *has_merge_records ||
+        !GetDocHybridTime(file->smallest.user_values, &smallest).ok() ||
+        !GetDocHybridTime(file->largest.user_values, &largest).ok()) {
+      return result;
+    }
+    const auto expiration = MaxFileExpiration(file->largest.user_values, retention.table_ttl);
+    infos.push_back(FileInfo {
+      .file = file,
+      .smallest_ht = smallest.hybrid_time(),
+      .largest_ht = largest.hybrid_time(),
+      .expired = !file->being_compacted && expiration.is_valid() &&
+                 expiration != HybridTime::kMax &&
+                 server::HybridClock::GetPhysicalValueMicros(expiration) < history_cutoff_micros,
+    });
+  }
+
+  // Deleting a file could make visible records of kept files, that were overwritten or deleted
+  // by the records of deleted file. So file is deleted only when all records of kept files are
+  // newer than its records.
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    auto min_kept_ht = HybridTime::kMax;
+    for (const auto& info : infos) {
+      if (!info.expired) {
+        min_kept_ht.MakeAtMost(info.smallest_ht);
+      }
+    }
+    for (auto& info : infos) {
+      if (info.expired && info.largest_ht >= min_kept_ht) {
+        info.expired = false;
+        changed = true;
+      }
+    }
+  }
+
+  for (const auto& info : infos) {
+    if (info.expired) {
+      result.push_back(info.file);
+    }
+  }
+  return result;
+}
+
+std::vector<uint64_t> DocDBCompactionFilterFactory::FileTimeWindows(
+    const std::vector<rocksdb::FileMetaData*>& files) {
+  std::vector<uint64_t> result;
+  const auto window = retention_policy_->GetRetentionDirective().compaction_time_window;
+  if (!window || window.ToMicroseconds() <= 0) {
+    return result;
+  }
+  const uint64_t window_micros = window.ToMicroseconds();
+  result.reserve(files.size());
+  for (auto* file : files) {
+    DocHybridTime largest;
+    // Files written before frontiers were recorded could contain records of any time, so they
+    // are not grouped by time windows.
+    if (!GetDocHybridTime(file->largest.user_values, &largest).ok()) {
+      return std::vector<uint64_t>();
+    }
+    result.push_back(
+        server::HybridClock::GetPhysicalValueMicros(largest.hybrid_time()) / window_micros);
+  }
+  return result;
+}
+
+Slice DocDBCompactionFilterFactory::SubcompactionBoundary(const Slice& user_key) {
+  auto doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::kWholeDocKey);
+  if (!doc_key_size.ok()) {
+    // Not a DocDB record, so it does not depend on other records.
+    return user_key;
+  }
+  return user_key.Prefix(*doc_key_size);
 }
 
 const char* DocDBCompactionFilterFactory::Name() const {
@@ -369,7 +592,8 @@ HistoryRetentionDirective ManualHistoryRetentionPolicy::GetRetentionDirective()
   std::lock_guard<std::mutex> lock(deleted_cols_mtx_);
   return {history_cutoff_.load(std::memory_order_acquire),
           std::make_shared<ColumnIds>(deleted_cols_), table_ttl_.load(std::memory_order_acquire),
-          ShouldRetainDeleteMarkersInMajorCompaction::kFalse};
+          ShouldRetainDeleteMarkersInMajorCompaction::kFalse,
+          compaction_time_window_.load(std::memory_order_acquire)};
 }
 
 void ManualHistoryRetentionPolicy::SetHistoryCutoff(HybridTime history_cutoff) {
@@ -385,5 +609,9 @@ void ManualHistoryRetentionPolicy::SetTableTTLForTests(MonoDelta ttl) {
   table_ttl_.store(ttl, std::memory_order_release);
 }
 
+void ManualHistoryRetentionPolicy::SetCompactionTimeWindowForTests(MonoDelta window) {
+  compaction_time_window_.store(window, std::memory_order_release);
+}
+
 }  // namespace docdb
 }  // namespace yb
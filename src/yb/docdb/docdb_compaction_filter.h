@@ -15,7 +15,9 @@
 #define YB_DOCDB_DOCDB_COMPACTION_FILTER_H
 
 #include <atomic>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <boost/container/small_vector.hpp>
@@ -31,6 +33,7 @@
 
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/expiration.h"
+#include "yb/docdb/value.h"
 
 namespace yb {
 namespace docdb {
@@ -39,6 +42,7 @@ YB_STRONGLY_TYPED_BOOL(IsMajorCompaction);
 YB_STRONGLY_TYPED_BOOL(ShouldRetainDeleteMarkersInMajorCompaction);
 
 struct Expiration;
+class ValueLog;
 
 // A "directive" of how a particular compaction should retain old (overwritten or deleted) values.
 struct HistoryRetentionDirective {
@@ -55,15 +59,22 @@ struct HistoryRetentionDirective {
   MonoDelta table_ttl;
 
   ShouldRetainDeleteMarkersInMajorCompaction retain_delete_markers_in_major_compaction{false};
+
+  // When initialized, SST files are compacted only with files of the same time window of this
+  // size.
+  MonoDelta compaction_time_window;
 };
 
 // DocDB compaction filter. A new instance of this class is created for every compaction.
 class DocDBCompactionFilter : public rocksdb::CompactionFilter {
  public:
+  // Values not less than docdb_value_log_min_value_size are moved to value_log, when it is not
+  // null.
   DocDBCompactionFilter(
       HistoryRetentionDirective retention,
       IsMajorCompaction is_major_compaction,
-      const KeyBounds* key_bounds);
+      const KeyBounds* key_bounds,
+      ValueLog* value_log = nullptr);
 
   ~DocDBCompactionFilter() override;
   rocksdb::FilterDecision Filter(
@@ -85,7 +96,27 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   Slice DropKeysLessThan() const override;
   Slice DropKeysGreaterOrEqual() const override;
 
+  // Syncs values moved to the value log, before output files referencing them are installed.
+  Status SyncExternalData() override;
+
+  // Returns the packed row delayed by Filter, with the column values folded into it.
+  bool CompleteDelayedValue(bool end_of_input, std::string* value) override;
+
  private:
+  // Packed row of the current document, that is delayed during a major compaction to fold the
+  // latest column values written at or below the history cutoff into it, see packed_row.h.
+  struct DelayedPackedRow {
+    std::string doc_key;
+    // Control fields of the packed row.
+    Value control_fields;
+    std::string packed_row;
+    // Encoded values of folded columns, by column id.
+    std::map<ColumnId, std::string> updates;
+  };
+
+  // Stores the delayed packed row with the folded columns to completed_value_.
+  CHECKED_STATUS CompletePackedRow();
+
   // Assigns prev_subdoc_key_ from memory addressed by data. The length of key is taken from
   // sub_key_ends_ and same_bytes are reused.
   void AssignPrevSubDocKey(const char* data, size_t same_bytes);
@@ -98,6 +129,9 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   const HistoryRetentionDirective retention_;
   const KeyBounds* key_bounds_;
   const IsMajorCompaction is_major_compaction_;
+  ValueLog* const value_log_;
+  // Value log file pinned by the first value appended by this compaction, 0 if none.
+  uint64_t pinned_value_log_file_ = 0;
 
   std::vector<char> prev_subdoc_key_;
 
@@ -147,6 +181,9 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
 
   std::vector<OverwriteData> overwrite_;
 
+  boost::optional<DelayedPackedRow> delayed_packed_row_;
+  boost::optional<std::string> completed_value_;
+
   // We use this to only log a message that the filter is being used once on the first call to
   // the Filter function.
   bool filter_usage_logged_ = false;
@@ -163,16 +200,32 @@ class HistoryRetentionPolicy {
 
 class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
  public:
-  explicit DocDBCompactionFilterFactory(
-      std::shared_ptr<HistoryRetentionPolicy> retention_policy, const KeyBounds* key_bounds);
+  DocDBCompactionFilterFactory(
+      std::shared_ptr<HistoryRetentionPolicy> retention_policy, const KeyBounds* key_bounds,
+      ValueLog* value_log = nullptr);
   ~DocDBCompactionFilterFactory() override;
   std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
       const rocksdb::CompactionFilter::Context& context) override;
   const char* Name() const override;
 
+  // Returns files whose records are all expired before the history cutoff, when
+  // docdb_delete_expired_files is enabled.
+  std::vector<rocksdb::FileMetaData*> ObsoleteFiles(
+      const std::vector<rocksdb::FileMetaData*>& files) override;
+
+  // Returns the hybrid time window of the newest record of each file, when the table uses time
+  // window compaction.
+  std::vector<uint64_t> FileTimeWindows(
+      const std::vector<rocksdb::FileMetaData*>& files) override;
+
+  // Returns encoded DocKey of user_key, so all records of the same document are processed by the
+  // same subcompaction. The state of DocDBCompactionFilter is reset on each new DocKey.
+  Slice SubcompactionBoundary(const Slice& user_key) override;
+
  private:
   std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
   const KeyBounds* key_bounds_;
+  ValueLog* const value_log_;
 };
 
 // A history retention policy that can be configured manually. Useful in tests. This class is
@@ -187,6 +240,8 @@ class ManualHistoryRetentionPolicy : public HistoryRetentionPolicy {
 
   void SetTableTTLForTests(MonoDelta ttl);
 
+  void SetCompactionTimeWindowForTests(MonoDelta window);
+
  private:
   std::atomic<HybridTime> history_cutoff_{HybridTime::kMin};
 
@@ -194,6 +249,8 @@ class ManualHistoryRetentionPolicy : public HistoryRetentionPolicy {
   ColumnIds deleted_cols_ GUARDED_BY(deleted_cols_mtx_);
 
   std::atomic<MonoDelta> table_ttl_{MonoDelta::kMax};
+
+  std::atomic<MonoDelta> compaction_time_window_{MonoDelta()};
 };
 
 }  // namespace docdb
@@ -28,14 +28,20 @@ class DocWriteBatch;
 class IntentAwareIterator;
 class KeyBytes;
 class KeyValueWriteBatchPB;
+class LockBatch;
+class PackedRow;
 class PgsqlWriteOperation;
+class PrimitiveValue;
 class QLWriteOperation;
+class RowCache;
 class SubDocKey;
+class ValueLog;
 
 struct ApplyTransactionState;
 struct DocDB;
 
 YB_STRONGLY_TYPED_BOOL(PartialRangeKeyIntents);
+YB_STRONGLY_TYPED_BOOL(FillBlockCache);
 
 }  // namespace docdb
 }  // namespace yb
@@ -0,0 +1,271 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+// Micro-benchmarks of DocDB hot paths. Each benchmark logs the time per operation, run for
+// example with:
+//   docdb_microbench-test --docdb_bench_iterations=1000000 --gtest_filter='*DocKey*'
+// Inputs are generated with a fixed seed, so the results of different builds are comparable.
+
+#include <random>
+
+#include <gflags/gflags.h>
+
+#include "yb/common/transaction-test-util.h"
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_write_batch.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/docdb_test_base.h"
+#include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/lock_batch.h"
+#include "yb/docdb/shared_lock_manager.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/test_macros.h"
+
+DEFINE_int32(docdb_bench_iterations, 10000, "Number of operations run by each benchmark.");
+DEFINE_int32(docdb_bench_rows, 1000, "Number of rows in DocDB for iterator benchmarks.");
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+constexpr uint64_t kSeed = 23874297385L;
+
+YB_STRONGLY_TYPED_BOOL(WideRow);
+
+// Narrow rows have a hash and a range key component and 2 columns, wide rows have 3 hash and 3
+// range key components and 20 columns.
+int NumColumns(WideRow wide) {
+  return wide ? 20 : 2;
+}
+
+DocKey MakeDocKey(int64_t index, WideRow wide) {
+  const auto hash_value = Format("h$0", index % 100);
+  if (!wide) {
+    return DocKey(index % 100, {PrimitiveValue(hash_value)}, {PrimitiveValue(index)});
+  }
+  return DocKey(index % 100,
+                {PrimitiveValue(hash_value), PrimitiveValue(index % 7), PrimitiveValue("hash")},
+                {PrimitiveValue(index), PrimitiveValue::Double(index * 0.5),
+                 PrimitiveValue(Format("range_$0", index))});
+}
+
+PrimitiveValue ColumnValue(int64_t index, int column) {
+  return column % 2 ? PrimitiveValue(index * column) : PrimitiveValue(Format("v$0", index));
+}
+
+// Runs the operation the number of times, and logs time per operation.
+template <class Functor>
+void RunBenchmark(const std::string& name, const Functor& functor) {
+  const int iterations = FLAGS_docdb_bench_iterations;
+  // Warm up caches and allocators.
+  for (int i = 0; i != std::min(iterations, 100); ++i) {
+    functor(i);
+  }
+  const auto start = MonoTime::Now();
+  for (int i = 0; i != iterations; ++i) {
+    functor(i);
+  }
+  const auto elapsed = MonoTime::Now() - start;
+  LOG(INFO) << "Benchmark " << name << ": " << iterations << " iterations, "
+            << elapsed.ToNanoseconds() / std::max(iterations, 1) << " ns/op";
+}
+
+} // namespace
+
+class DocDBMicroBenchTest : public DocDBTestBase {
+ protected:
+  // Writes the rows to RocksDB, within a committed transaction that is not applied yet when
+  // with_intents is set, so the rows are read from intents.
+  void WriteRows(WideRow wide, bool with_intents);
+
+  void BenchmarkIntentAwareIterator(WideRow wide, bool with_intents);
+
+  TransactionStatusManagerMock txn_status_manager_;
+};
+
+TEST_F(DocDBMicroBenchTest, DocKeyEncode) {
+  for (auto wide : {WideRow::kFalse, WideRow::kTrue}) {
+    const auto doc_key = MakeDocKey(12345, wide);
+    size_t total_size = 0;
+    RunBenchmark(Format("DocKeyEncode/wide:$0", wide), [&doc_key, &total_size](int) {
+      total_size += doc_key.Encode().size();
+    });
+    ASSERT_GT(total_size, 0);
+  }
+}
+
+TEST_F(DocDBMicroBenchTest, DocKeyDecode) {
+  for (auto wide : {WideRow::kFalse, WideRow::kTrue}) {
+    std::vector<KeyBytes> encoded_keys;
+    for (int i = 0; i != 100; ++i) {
+      encoded_keys.push_back(MakeDocKey(i, wide).Encode());
+    }
+    size_t total_components = 0;
+    RunBenchmark(Format("DocKeyDecode/wide:$0", wide), [&](int i) {
+      DocKey doc_key;
+      CHECK_OK(doc_key.FullyDecodeFrom(encoded_keys[i % encoded_keys.size()].AsSlice()));
+      total_components += doc_key.range_group().size();
+    });
+    ASSERT_GT(total_components, 0);
+  }
+}
+
+TEST_F(DocDBMicroBenchTest, PrimitiveValueDecodeFromKey) {
+  std::mt19937_64 rng(kSeed);
+  KeyBytes encoded;
+  int num_values = 0;
+  for (; num_values != 100; ++num_values) {
+    GenRandomPrimitiveValue(&rng).AppendToKey(&encoded);
+  }
+  int decoded = 0;
+  RunBenchmark("PrimitiveValueDecodeFromKey/100_values", [&](int) {
+    Slice slice = encoded.AsSlice();
+    PrimitiveValue value;
+    while (!slice.empty()) {
+      CHECK_OK(value.DecodeFromKey(&slice));
+      ++decoded;
+    }
+  });
+  ASSERT_GE(decoded, num_values);
+}
+
+TEST_F(DocDBMicroBenchTest, DocWriteBatchBuild) {
+  for (auto wide : {WideRow::kFalse, WideRow::kTrue}) {
+    auto dwb = MakeDocWriteBatch();
+    size_t total_pairs = 0;
+    RunBenchmark(Format("DocWriteBatchBuild/wide:$0", wide), [&](int i) {
+      const auto encoded_doc_key = MakeDocKey(i, wide).Encode();
+      for (int column = 0; column != NumColumns(wide); ++column) {
+        CHECK_OK(dwb.SetPrimitive(
+            DocPath(encoded_doc_key, PrimitiveValue(ColumnId(column + 10))),
+            ColumnValue(i, column)));
+      }
+      total_pairs += dwb.size();
+      dwb.Clear();
+    });
+    ASSERT_GT(total_pairs, 0);
+  }
+}
+
+TEST_F(DocDBMicroBenchTest, SharedLockManagerLockUnlock) {
+  SharedLockManager lock_manager;
+  for (auto wide : {WideRow::kFalse, WideRow::kTrue}) {
+    // Locks taken by a write of a row: strong locks on the columns and weak locks on the row.
+    std::vector<RefCntPrefix> column_keys;
+    const auto encoded_doc_key = MakeDocKey(12345, wide).Encode();
+    for (int column = 0; column != NumColumns(wide); ++column) {
+      KeyBytes key = encoded_doc_key;
+      PrimitiveValue(ColumnId(column + 10)).AppendToKey(&key);
+      column_keys.emplace_back(key.AsSlice());
+    }
+    const RefCntPrefix row_key(encoded_doc_key.AsSlice());
+    const IntentTypeSet kWeakIntents({IntentType::kWeakRead, IntentType::kWeakWrite});
+    const IntentTypeSet kStrongIntents({IntentType::kStrongRead, IntentType::kStrongWrite});
+    RunBenchmark(Format("SharedLockManagerLockUnlock/wide:$0", wide), [&](int) {
+      LockBatchEntries entries;
+      entries.push_back({row_key, kWeakIntents});
+      for (const auto& key : column_keys) {
+        entries.push_back({key, kStrongIntents});
+      }
+      LockBatch lock_batch(&lock_manager, std::move(entries), CoarseTimePoint::max());
+      CHECK_OK(lock_batch.status());
+    });
+  }
+}
+
+void DocDBMicroBenchTest::WriteRows(WideRow wide, bool with_intents) {
+  const auto txn_id = TransactionId::GenerateRandom();
+  if (with_intents) {
+    SetCurrentTransactionId(txn_id);
+  }
+  auto dwb = MakeDocWriteBatch();
+  for (int i = 0; i != FLAGS_docdb_bench_rows; ++i) {
+    const auto encoded_doc_key = MakeDocKey(i, wide).Encode();
+    for (int column = 0; column != NumColumns(wide); ++column) {
+      ASSERT_OK(dwb.SetPrimitive(
+          DocPath(encoded_doc_key, PrimitiveValue(ColumnId(column + 10))),
+          ColumnValue(i, column)));
+    }
+    ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(1000)));
+  }
+  if (with_intents) {
+    txn_status_manager_.Commit(txn_id, HybridTime::FromMicros(2000));
+    ResetCurrentTransactionId();
+  }
+  ASSERT_OK(FlushRocksDbAndWait());
+}
+
+void DocDBMicroBenchTest::BenchmarkIntentAwareIterator(WideRow wide, bool with_intents) {
+  ASSERT_NO_FATALS(WriteRows(wide, with_intents));
+
+  std::vector<KeyBytes> encoded_keys;
+  for (int i = 0; i != FLAGS_docdb_bench_rows; ++i) {
+    encoded_keys.push_back(MakeDocKey(i, wide).Encode());
+  }
+  std::mt19937_64 rng(kSeed);
+  std::shuffle(encoded_keys.begin(), encoded_keys.end(), rng);
+
+  const TransactionOperationContext txn_op_context(
+      TransactionId::GenerateRandom(), &txn_status_manager_);
+  auto iter = CreateIntentAwareIterator(
+      doc_db(), BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, rocksdb::kDefaultQueryId,
+      txn_op_context, CoarseTimePoint::max(), ReadHybridTime::FromMicros(3000));
+
+  size_t found = 0;
+  RunBenchmark(Format("IntentAwareIteratorRandomSeek/wide:$0/intents:$1", wide, with_intents),
+               [&](int i) {
+    iter->Seek(encoded_keys[i % encoded_keys.size()].AsSlice());
+    if (iter->valid()) {
+      found += !CHECK_RESULT(iter->FetchKey()).key.empty();
+    }
+  });
+  ASSERT_GT(found, 0);
+
+  size_t num_columns = 0;
+  RunBenchmark(Format("IntentAwareIteratorScanColumns/wide:$0/intents:$1", wide, with_intents),
+               [&](int i) {
+    const auto& encoded_key = encoded_keys[i % encoded_keys.size()];
+    iter->Seek(encoded_key.AsSlice());
+    while (iter->valid()) {
+      const auto key = CHECK_RESULT(iter->FetchKey()).key;
+      if (!key.starts_with(encoded_key.AsSlice())) {
+        break;
+      }
+      ++num_columns;
+      iter->SeekPastSubKey(key);
+    }
+  });
+  ASSERT_GT(num_columns, 0);
+}
+
+TEST_F(DocDBMicroBenchTest, IntentAwareIteratorNarrowRows) {
+  BenchmarkIntentAwareIterator(WideRow::kFalse, /* with_intents = */ false);
+}
+
+TEST_F(DocDBMicroBenchTest, IntentAwareIteratorWideRows) {
+  BenchmarkIntentAwareIterator(WideRow::kTrue, /* with_intents = */ false);
+}
+
+TEST_F(DocDBMicroBenchTest, IntentAwareIteratorNarrowRowsWithIntents) {
+  BenchmarkIntentAwareIterator(WideRow::kFalse, /* with_intents = */ true);
+}
+
+TEST_F(DocDBMicroBenchTest, IntentAwareIteratorWideRowsWithIntents) {
+  BenchmarkIntentAwareIterator(WideRow::kTrue, /* with_intents = */ true);
+}
+
+} // namespace docdb
+} // namespace yb
@@ -93,6 +93,19 @@ Status DocPgEvalExpr(const std::string& expr_str,
                      const QLTableRow& table_row,
                      const Schema *schema,
                      QLValue* result) {
+  // Assuming first arg is the target column, so using it for the return type.
+  // YSQL layer should guarantee this when producing the params.
+  YbgTypeDesc pg_type = {params[0].typid, params[0].typmod};
+  return DocPgEvalExpr(expr_str, params, pg_type, table_row, schema, result);
+}
+
+Status DocPgEvalExpr(const std::string& expr_str,
+                     const std::vector<DocPgParamDesc>& params,
+                     YbgTypeDesc result_type,
+                     const QLTableRow& table_row,
+                     const Schema *schema,
+                     QLValue* result) {
+  SCHECK(!params.empty(), InvalidArgument, "Expression without column references");
   PG_RETURN_NOT_OK(YbgPrepareMemoryContext());
 
   char *expr_cstring = const_cast<char *>(expr_str.c_str());
@@ -117,23 +130,24 @@ Status DocPgEvalExpr(const std::string& expr_str,
     auto column = schema->column_by_id(col_id);
     SCHECK(column.ok(), InternalError, "Invalid Schema");
 
-    // Loop here is ok as params.size() will always be 1 for user tables,
-    // and 2 for some internal queries (catalog version increment).
-    // TODO Rethink this if we ever allow more params here.
-    DCHECK_LT(params.size(), 3);
+    // Loop here is ok as params.size() is 1 for assignments of user tables, 2 for some internal
+    // queries (catalog version increment), and the number of referenced columns for filters.
     for (int i = 0; i < params.size(); i++) {
       if (column->order() == params[i].attno) {
         const QLValuePB* val = table_row.GetColumn(col_id.rep());
-        bool is_null = false;
+        // Column that was not read for this row is NULL.
+        bool is_null = val == nullptr;
         uint64_t datum = 0;
-        YbgTypeDesc pg_arg_type = {params[i].typid, params[i].typmod};
-        const YBCPgTypeEntity *arg_type = DocPgGetTypeEntity(pg_arg_type);
-        YBCPgTypeAttrs arg_type_attrs = { pg_arg_type.type_mod };
-
-        Status s = PgValueFromPB(arg_type, arg_type_attrs, *val, &datum, &is_null);
-        if (!s.ok()) {
-          PG_RETURN_NOT_OK(YbgResetMemoryContext());
-          return s;
+        if (val != nullptr) {
+          YbgTypeDesc pg_arg_type = {params[i].typid, params[i].typmod};
+          const YBCPgTypeEntity *arg_type = DocPgGetTypeEntity(pg_arg_type);
+          YBCPgTypeAttrs arg_type_attrs = { pg_arg_type.type_mod };
+
+          Status s = PgValueFromPB(arg_type, arg_type_attrs, *val, &datum, &is_null);
+          if (!s.ok()) {
+            PG_RETURN_NOT_OK(YbgResetMemoryContext());
+            return s;
+          }
         }
 
         PG_RETURN_NOT_OK(YbgExprContextAddColValue(expr_ctx, column->order(), datum, is_null));
@@ -147,16 +161,22 @@ Status DocPgEvalExpr(const std::string& expr_str,
   uint64_t datum;
   PG_RETURN_NOT_OK(YbgEvalExpr(expr_cstring, expr_ctx, &datum, &is_null));
 
-  // Assuming first arg is the target column, so using it for the return type.
-  // YSQL layer should guarantee this when producing the params.
-  YbgTypeDesc pg_type = {params[0].typid, params[0].typmod};
-  const YBCPgTypeEntity *ret_type = DocPgGetTypeEntity(pg_type);
+  const YBCPgTypeEntity *ret_type = DocPgGetTypeEntity(result_type);
 
   Status s = PgValueToPB(ret_type, datum, is_null, result);
   PG_RETURN_NOT_OK(YbgResetMemoryContext());
   return s;
 }
 
+Status DocPgEvalBoolExpr(const std::string& expr_str,
+                         const std::vector<DocPgParamDesc>& params,
+                         const QLTableRow& table_row,
+                         const Schema *schema,
+                         QLValue* result) {
+  YbgTypeDesc pg_type = {BOOLOID, -1 /* typmod */};
+  return DocPgEvalExpr(expr_str, params, pg_type, table_row, schema, result);
+}
+
 Status ExtractTextArrayFromQLBinaryValue(const QLValuePB& ql_value,
                                          vector<QLValuePB> *const ql_value_vec) {
   PG_RETURN_NOT_OK(YbgPrepareMemoryContext());
@@ -52,12 +52,29 @@ const YBCPgTypeEntity* DocPgGetTypeEntity(YbgTypeDesc pg_type);
 // Expressions/Values
 //-----------------------------------------------------------------------------
 
+// The result has the type of the first param.
 Status DocPgEvalExpr(const std::string& expr_str,
                      std::vector<DocPgParamDesc> params,
                      const QLTableRow& table_row,
                      const Schema *schema,
                      QLValue* result);
 
+// Evaluates expression with the given result type. All params are columns referenced by the
+// expression.
+Status DocPgEvalExpr(const std::string& expr_str,
+                     const std::vector<DocPgParamDesc>& params,
+                     YbgTypeDesc result_type,
+                     const QLTableRow& table_row,
+                     const Schema *schema,
+                     QLValue* result);
+
+// Evaluates boolean expression, like a filter of scanned rows.
+Status DocPgEvalBoolExpr(const std::string& expr_str,
+                         const std::vector<DocPgParamDesc>& params,
+                         const QLTableRow& table_row,
+                         const Schema *schema,
+                         QLValue* result);
+
 // Given a 'ql_value' with a binary value, interpret the binary value as a text
 // array, and store the individual elements in 'ql_value_vec';
 Status ExtractTextArrayFromQLBinaryValue(const QLValuePB& ql_value,
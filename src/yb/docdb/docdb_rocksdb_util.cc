@@ -14,7 +14,11 @@
 #include "yb/docdb/docdb_rocksdb_util.h"
 
 #include <thread>
+#include <sys/stat.h>
+
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "yb/common/transaction.h"
 
@@ -38,11 +42,13 @@
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
+#include "yb/util/errno.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/priority_thread_pool.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/status.h"
+#include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
 #include "yb/gutil/sysinfo.h"
 
@@ -52,11 +58,25 @@ using namespace std::literals;
 DEFINE_int32(rocksdb_max_background_flushes, -1, "Number threads to do background flushes.");
 DEFINE_bool(rocksdb_disable_compactions, false, "Disable rocksdb compactions.");
 DEFINE_bool(rocksdb_compaction_measure_io_stats, false, "Measure stats for rocksdb compactions.");
+DEFINE_uint64(rocksdb_compaction_readahead_size_bytes, 0,
+              "If non-zero, compaction inputs are read with readahead windows of this size, using "
+              "table readers separate from the ones used by user reads.");
+TAG_FLAG(rocksdb_compaction_readahead_size_bytes, advanced);
+DEFINE_bool(rocksdb_use_direct_io_for_compaction, false,
+            "Write compaction outputs with O_DIRECT, and read compaction inputs with O_DIRECT "
+            "when rocksdb_compaction_readahead_size_bytes is set, so compactions do not evict "
+            "the OS page cache.");
+TAG_FLAG(rocksdb_use_direct_io_for_compaction, advanced);
 DEFINE_int32(rocksdb_base_background_compactions, -1,
              "Number threads to do background compactions.");
 DEFINE_int32(rocksdb_max_background_compactions, -1,
              "Increased number of threads to do background compactions (used when compactions need "
              "to catch up.)");
+DEFINE_int32(rocksdb_max_subcompactions, 1,
+             "Max number of key ranges the compaction could be split into, to process them in "
+             "parallel. If -1 - use max_background_compactions. Applies to regular DB only, "
+             "intents DB is always compacted by a single subcompaction.");
+TAG_FLAG(rocksdb_max_subcompactions, advanced);
 DEFINE_int32(rocksdb_level0_file_num_compaction_trigger, 5,
              "Number of files to trigger level-0 compaction. -1 if compaction should not be "
              "triggered by number of files at all.");
@@ -73,6 +93,27 @@ DEFINE_int32(rocksdb_universal_compaction_min_merge_width, 4,
              "The minimum number of files in a single compaction run.");
 DEFINE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec, 256_MB,
              "Use to control write rate of flush and compaction.");
+DEFINE_bool(rocksdb_compact_flush_rate_limit_per_device, false,
+            "Apply rocksdb_compact_flush_rate_limit_bytes_per_sec to all tablets whose RocksDB "
+            "directory is on the same device together, instead of to each tablet separately, so "
+            "flushes and compactions of many tablets do not saturate a disk used by user reads.");
+TAG_FLAG(rocksdb_compact_flush_rate_limit_per_device, advanced);
+DEFINE_bool(rocksdb_compact_flush_rate_limit_auto_tune, false,
+            "Adjust the flush and compaction rate limit between 1/20 of "
+            "rocksdb_compact_flush_rate_limit_bytes_per_sec and its value: increase it while "
+            "flushes and compactions keep waiting for the limiter, and decrease it while they do "
+            "not use the budget.");
+TAG_FLAG(rocksdb_compact_flush_rate_limit_auto_tune, advanced);
+DEFINE_bool(rocksdb_high_priority_index_and_filter_blocks, false,
+            "Keep the top level data index block of each open SST file out of the block cache, "
+            "and add lower level index blocks and filter blocks to the multi-touch part of the "
+            "block cache at once, so they are evicted after data blocks.");
+TAG_FLAG(rocksdb_high_priority_index_and_filter_blocks, advanced);
+DEFINE_uint64(rocksdb_max_scan_readahead_bytes, 0,
+              "Maximal readahead size of scans that read SST data blocks sequentially. Readahead "
+              "starts small after a few sequential block reads and doubles while the scan stays "
+              "sequential. 0 disables it.");
+TAG_FLAG(rocksdb_max_scan_readahead_bytes, advanced);
 DEFINE_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 1024 * 1024,
              "Threshold beyond which compaction is considered large.");
 DEFINE_uint64(rocksdb_max_file_size_for_compaction, 0,
@@ -100,12 +141,23 @@ DEFINE_int32(memstore_size_mb, 128,
 
 DEFINE_bool(use_docdb_aware_bloom_filter, true,
             "Whether to use the DocDbAwareFilterPolicy for both bloom storage and seeks.");
+DEFINE_int32(range_key_bloom_filter_components, 1,
+             "Number of leading range components of the doc key, used by bloom filter of "
+             "range-partitioned tables. Reads use bloom filter only when all these components "
+             "are fixed. Value 1 corresponds to DocKeyV3Filter, max value is 8.");
+TAG_FLAG(range_key_bloom_filter_components, advanced);
 // Empirically 2 is a minimal value that provides best performance on sequential scan.
 DEFINE_int32(max_nexts_to_avoid_seek, 2,
              "The number of next calls to try before doing resorting to do a rocksdb seek.");
 
 DEFINE_bool(use_multi_level_index, true, "Whether to use multi-level data index.");
 
+DEFINE_bool(db_block_key_shared_middle_encoding, false,
+            "Whether to encode keys in new SST data blocks sharing, in addition to the prefix, "
+            "the leading bytes of the DocHybridTime with the previous key. Files written with "
+            "this encoding can't be read by versions that don't support it.");
+TAG_FLAG(db_block_key_shared_middle_encoding, advanced);
+
 DEFINE_uint64(initial_seqno, 1ULL << 50, "Initial seqno for new RocksDB instances.");
 
 DEFINE_int32(num_reserved_small_compaction_threads, -1, "Number of reserved small compaction "
@@ -123,6 +175,45 @@ DEFINE_string(compression_type, "Snappy",
               "On-disk compression type to use in RocksDB."
               "By default, Snappy is used if supported.");
 
+DEFINE_int32(compression_max_dict_bytes, 0,
+             "Max size of the dictionary trained from samples of data blocks of each SST file, "
+             "and used to compress them. Only used with ZSTD compression, 0 disables dictionary "
+             "compression.");
+TAG_FLAG(compression_max_dict_bytes, advanced);
+
+DEFINE_int32(compression_zstd_max_train_bytes, 0,
+             "Size of data blocks of each SST file, that are buffered as dictionary training "
+             "samples. 0 means 100 times compression_max_dict_bytes.");
+TAG_FLAG(compression_zstd_max_train_bytes, advanced);
+
+DEFINE_int32(compression_parallel_threads, 1,
+             "Max number of threads, that compress data blocks of each SST file being written by "
+             "flush or compaction. Threads are taken from a pool shared by all tablets, that has "
+             "a thread per CPU. 1 means that blocks are compressed by the thread, that builds "
+             "the file.");
+TAG_FLAG(compression_parallel_threads, advanced);
+
+DEFINE_int32(rocksdb_memtable_insert_threads, 0,
+             "Size of the thread pool shared by all tablets, that inserts entries of large write "
+             "batches into memtables in parallel. 0 disables parallel memtable inserts.");
+TAG_FLAG(rocksdb_memtable_insert_threads, advanced);
+
+DEFINE_int32(rocksdb_min_entries_per_parallel_memtable_insert, 1024,
+             "Min number of write batch entries inserted into memtable by each thread, when "
+             "rocksdb_memtable_insert_threads is set.");
+TAG_FLAG(rocksdb_min_entries_per_parallel_memtable_insert, advanced);
+
+DEFINE_int32(rocksdb_memtable_filter_bloom_bits, 0,
+             "Size in bits of the bloom filter of each memtable on the hashed components of the "
+             "keys, that lets point reads skip memtables without the key. 0 disables the filter.");
+TAG_FLAG(rocksdb_memtable_filter_bloom_bits, advanced);
+
+DEFINE_uint64(rocksdb_memtable_huge_page_size, 0,
+              "Allocate memtable arena blocks in pages of this size, from reserved huge pages "
+              "when available and from transparent huge pages otherwise. Should be the huge page "
+              "size of the system, e.g. 2097152. 0 allocates arena blocks with malloc.");
+TAG_FLAG(rocksdb_memtable_huge_page_size, advanced);
+
 namespace yb {
 namespace {
 
@@ -133,7 +224,8 @@ Result<rocksdb::CompressionType> GetConfiguredCompressionType(const std::string&
   const std::vector<rocksdb::CompressionType> kValidRocksDBCompressionTypes = {
     rocksdb::kNoCompression,
     rocksdb::kSnappyCompression,
-    rocksdb::kLZ4Compression
+    rocksdb::kLZ4Compression,
+    rocksdb::kZSTDNotFinalCompression
   };
   for (const auto& compression_type : kValidRocksDBCompressionTypes) {
     if (flag_value == rocksdb::CompressionTypeToString(compression_type)) {
@@ -164,10 +256,24 @@ bool CompressionTypeValidator(const char* flagname, const std::string& flag_comp
   return true;
 }
 
+// Each builder keeps up to 2 blocks per thread in memory, so the bound keeps that memory small.
+constexpr int32_t kMaxCompressionParallelThreads = 64;
+
+bool CompressionParallelThreadsValidator(const char* flagname, int32_t value) {
+  if (value < 1 || value > kMaxCompressionParallelThreads) {
+    LOG(ERROR) << yb::Format("$0 should be in range [1, $1], but $2 specified",
+                             flagname, kMaxCompressionParallelThreads, value);
+    return false;
+  }
+  return true;
+}
+
 } // namespace
 
 __attribute__((unused))
 DEFINE_validator(compression_type, &CompressionTypeValidator);
+__attribute__((unused))
+DEFINE_validator(compression_parallel_threads, &CompressionParallelThreadsValidator);
 
 using std::shared_ptr;
 using std::string;
@@ -268,9 +374,11 @@ rocksdb::ReadOptions PrepareReadOptions(
     const boost::optional<const Slice>& user_key_for_filter,
     const rocksdb::QueryId query_id,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter,
-    const Slice* iterate_upper_bound) {
+    const Slice* iterate_upper_bound,
+    FillBlockCache fill_block_cache = FillBlockCache::kTrue) {
   rocksdb::ReadOptions read_opts;
   read_opts.query_id = query_id;
+  read_opts.fill_cache = fill_block_cache.get();
   if (FLAGS_use_docdb_aware_bloom_filter &&
     bloom_filter_mode == BloomFilterMode::USE_BLOOM_FILTER) {
     DCHECK(user_key_for_filter);
@@ -291,10 +399,11 @@ BoundedRocksDbIterator CreateRocksDBIterator(
     const boost::optional<const Slice>& user_key_for_filter,
     const rocksdb::QueryId query_id,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter,
-    const Slice* iterate_upper_bound) {
+    const Slice* iterate_upper_bound,
+    ValueLog* value_log) {
   rocksdb::ReadOptions read_opts = PrepareReadOptions(rocksdb, bloom_filter_mode,
       user_key_for_filter, query_id, std::move(file_filter), iterate_upper_bound);
-  return BoundedRocksDbIterator(rocksdb, read_opts, docdb_key_bounds);
+  return BoundedRocksDbIterator(rocksdb, read_opts, docdb_key_bounds, value_log);
 }
 
 unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
@@ -306,10 +415,12 @@ unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     CoarseTimePoint deadline,
     const ReadHybridTime& read_time,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter,
-    const Slice* iterate_upper_bound) {
+    const Slice* iterate_upper_bound,
+    FillBlockCache fill_block_cache) {
   // TODO(dtxn) do we need separate options for intents db?
   rocksdb::ReadOptions read_opts = PrepareReadOptions(doc_db.regular, bloom_filter_mode,
-      user_key_for_filter, query_id, std::move(file_filter), iterate_upper_bound);
+      user_key_for_filter, query_id, std::move(file_filter), iterate_upper_bound,
+      fill_block_cache);
   return std::make_unique<IntentAwareIterator>(
       doc_db, read_opts, deadline, read_time, txn_op_context);
 }
@@ -387,6 +498,8 @@ void AutoInitFromRocksDBFlags(rocksdb::Options* options) {
 
   options->max_background_compactions = GetMaxBackgroundCompactions();
   options->base_background_compactions = GetBaseBackgroundCompactions();
+  options->max_subcompactions = static_cast<uint32_t>(FLAGS_rocksdb_max_subcompactions >= 0
+      ? FLAGS_rocksdb_max_subcompactions : options->max_background_compactions);
 }
 
 class HybridTimeFilteringIterator : public rocksdb::FilteringIterator {
@@ -436,14 +549,46 @@ void AddSupportedFilterPolicy(
   table_options->supported_filter_policies->emplace(filter_policy->Name(), filter_policy);
 }
 
+ThreadPool* GetGlobalMemTableInsertThreadPool() {
+  static std::unique_ptr<ThreadPool> memtable_insert_thread_pool = [] {
+    std::unique_ptr<ThreadPool> result;
+    if (FLAGS_rocksdb_memtable_insert_threads > 0) {
+      CHECK_OK(ThreadPoolBuilder("memtable-insert")
+                   .set_max_threads(FLAGS_rocksdb_memtable_insert_threads)
+                   .Build(&result));
+    }
+    return result;
+  }();
+  return memtable_insert_thread_pool.get();
+}
+
+ThreadPool* GetGlobalCompressionThreadPool() {
+  static std::unique_ptr<ThreadPool> compression_thread_pool = [] {
+    std::unique_ptr<ThreadPool> result;
+    if (FLAGS_compression_parallel_threads > 1) {
+      CHECK_OK(ThreadPoolBuilder("block-compress")
+                   .set_max_threads(base::NumCPUs())
+                   .Build(&result));
+    }
+    return result;
+  }();
+  return compression_thread_pool.get();
+}
+
+rocksdb::RateLimiter* NewCompactFlushRateLimiter() {
+  return rocksdb::NewGenericRateLimiter(
+      FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec, 100 * 1000 /* refill_period_us */,
+      10 /* fairness */, FLAGS_rocksdb_compact_flush_rate_limit_auto_tune);
+}
+
+} // namespace
+
 PriorityThreadPool* GetGlobalPriorityThreadPool() {
   static PriorityThreadPool priority_thread_pool_for_compactions_and_flushes(
       GetGlobalRocksDBPriorityThreadPoolSize());
   return &priority_thread_pool_for_compactions_and_flushes;
 }
 
-} // namespace
-
 rocksdb::Options TEST_AutoInitFromRocksDBFlags() {
   rocksdb::Options options;
   AutoInitFromRocksDBFlags(&options);
@@ -498,7 +643,11 @@ void InitRocksDBOptions(
   options->initial_seqno = FLAGS_initial_seqno;
   options->boundary_extractor = DocBoundaryValuesExtractorInstance();
   options->compaction_measure_io_stats = FLAGS_rocksdb_compaction_measure_io_stats;
+  options->compaction_readahead_size = FLAGS_rocksdb_compaction_readahead_size_bytes;
+  options->use_direct_io_for_compaction = FLAGS_rocksdb_use_direct_io_for_compaction;
   options->memory_monitor = tablet_options.memory_monitor;
+  options->skip_stats_update_on_db_open = tablet_options.skip_stats_update_on_db_open;
+  options->shared_table_cache = tablet_options.table_reader_cache;
   if (FLAGS_db_write_buffer_size != -1) {
     options->write_buffer_size = FLAGS_db_write_buffer_size;
   } else {
@@ -507,6 +656,13 @@ void InitRocksDBOptions(
   options->env = tablet_options.rocksdb_env;
   options->checkpoint_env = rocksdb::Env::Default();
   options->priority_thread_pool_for_compactions_and_flushes = GetGlobalPriorityThreadPool();
+  options->memtable_insert_thread_pool = GetGlobalMemTableInsertThreadPool();
+  options->min_entries_per_parallel_memtable_insert =
+      FLAGS_rocksdb_min_entries_per_parallel_memtable_insert;
+  // The writing thread inserts one of the ranges itself.
+  options->max_parallel_memtable_inserts = FLAGS_rocksdb_memtable_insert_threads + 1;
+  options->memtable_filter_bloom_bits = FLAGS_rocksdb_memtable_filter_bloom_bits;
+  options->memtable_huge_page_size = FLAGS_rocksdb_memtable_huge_page_size;
 
   if (FLAGS_num_reserved_small_compaction_threads != -1) {
     options->num_reserved_small_compaction_threads = FLAGS_num_reserved_small_compaction_threads;
@@ -515,6 +671,10 @@ void InitRocksDBOptions(
   // Since the flag validator for FLAGS_compression_type will fail if the result of this call is not
   // OK, this CHECK_RESULT should never fail and is safe.
   options->compression = CHECK_RESULT(GetConfiguredCompressionType(FLAGS_compression_type));
+  options->compression_opts.max_dict_bytes = FLAGS_compression_max_dict_bytes;
+  options->compression_opts.zstd_max_train_bytes = FLAGS_compression_zstd_max_train_bytes;
+  options->compression_opts.parallel_threads = FLAGS_compression_parallel_threads;
+  options->compression_opts.thread_pool = GetGlobalCompressionThreadPool();
 
   options->listeners.insert(
       options->listeners.end(), tablet_options.listeners.begin(),
@@ -524,28 +684,51 @@ void InitRocksDBOptions(
   rocksdb::BlockBasedTableOptions table_options;
   if (tablet_options.block_cache) {
     table_options.block_cache = tablet_options.block_cache;
+    table_options.block_cache_compressed = tablet_options.compressed_block_cache;
+    table_options.persistent_cache = tablet_options.persistent_cache;
     // Cache the bloom filters in the block cache.
     table_options.cache_index_and_filter_blocks = true;
+    table_options.high_priority_index_and_filter_blocks =
+        FLAGS_rocksdb_high_priority_index_and_filter_blocks;
   } else {
     table_options.no_block_cache = true;
     table_options.cache_index_and_filter_blocks = false;
   }
   table_options.block_size = FLAGS_db_block_size_bytes;
   table_options.filter_block_size = FLAGS_db_filter_block_size_bytes;
+  table_options.max_scan_readahead_size = FLAGS_rocksdb_max_scan_readahead_bytes;
   table_options.index_block_size = FLAGS_db_index_block_size_bytes;
   table_options.min_keys_per_index_block = FLAGS_db_min_keys_per_index_block;
+  if (FLAGS_db_block_key_shared_middle_encoding) {
+    table_options.data_block_key_value_encoding_format =
+        rocksdb::KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefixAndMiddle;
+  }
 
   // Set our custom bloom filter that is docdb aware.
   if (FLAGS_use_docdb_aware_bloom_filter) {
     const auto filter_block_size_bits = table_options.filter_block_size * 8;
-    table_options.filter_policy = std::make_unique<const DocDbAwareV3FilterPolicy>(
-        filter_block_size_bits, options->info_log.get());
+    const size_t range_components = std::min<size_t>(
+        std::max(FLAGS_range_key_bloom_filter_components, 1), kMaxRangePrefixFilterComponents);
+    if (range_components == 1) {
+      table_options.filter_policy = std::make_unique<const DocDbAwareV3FilterPolicy>(
+          filter_block_size_bits, options->info_log.get());
+    } else {
+      table_options.filter_policy = std::make_unique<const DocDbAwareRangePrefixFilterPolicy>(
+          filter_block_size_bits, options->info_log.get(), range_components);
+    }
     table_options.supported_filter_policies =
         std::make_shared<rocksdb::BlockBasedTableOptions::FilterPoliciesMap>();
     AddSupportedFilterPolicy(std::make_shared<const DocDbAwareHashedComponentsFilterPolicy>(
             filter_block_size_bits, options->info_log.get()), &table_options);
     AddSupportedFilterPolicy(std::make_shared<const DocDbAwareV2FilterPolicy>(
             filter_block_size_bits, options->info_log.get()), &table_options);
+    // Files could be written before range_key_bloom_filter_components was changed.
+    AddSupportedFilterPolicy(std::make_shared<const DocDbAwareV3FilterPolicy>(
+            filter_block_size_bits, options->info_log.get()), &table_options);
+    for (size_t i = 2; i <= kMaxRangePrefixFilterComponents; ++i) {
+      AddSupportedFilterPolicy(std::make_shared<const DocDbAwareRangePrefixFilterPolicy>(
+              filter_block_size_bits, options->info_log.get(), i), &table_options);
+    }
   }
 
   if (FLAGS_use_multi_level_index) {
@@ -584,8 +767,7 @@ void InitRocksDBOptions(
         FLAGS_rocksdb_universal_compaction_min_merge_width;
     options->compaction_size_threshold_bytes = FLAGS_rocksdb_compaction_size_threshold_bytes;
     if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
-      options->rate_limiter.reset(
-          rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
+      options->rate_limiter.reset(NewCompactFlushRateLimiter());
     }
   } else {
     options->level0_slowdown_writes_trigger = std::numeric_limits<int>::max();
@@ -610,6 +792,26 @@ void SetLogPrefix(rocksdb::Options* options, const std::string& log_prefix) {
   options->info_log = std::make_shared<YBRocksDBLogger>(options->log_prefix);
 }
 
+Status SetDeviceRateLimiter(const std::string& db_dir, rocksdb::Options* options) {
+  if (!FLAGS_rocksdb_compact_flush_rate_limit_per_device || !options->rate_limiter) {
+    return Status::OK();
+  }
+  struct stat st;
+  if (stat(db_dir.c_str(), &st) != 0) {
+    return STATUS_EC_FORMAT(IOError, Errno(errno), "Failed to stat $0", db_dir);
+  }
+
+  static std::mutex mutex;
+  static std::unordered_map<dev_t, std::shared_ptr<rocksdb::RateLimiter>> rate_limiters;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& rate_limiter = rate_limiters[st.st_dev];
+  if (!rate_limiter) {
+    rate_limiter.reset(NewCompactFlushRateLimiter());
+  }
+  options->rate_limiter = rate_limiter;
+  return Status::OK();
+}
+
 namespace {
 
 // Helper class for RocksDBPatcher.
@@ -88,7 +88,8 @@ BoundedRocksDbIterator CreateRocksDBIterator(
     const boost::optional<const Slice>& user_key_for_filter,
     const rocksdb::QueryId query_id,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter = nullptr,
-    const Slice* iterate_upper_bound = nullptr);
+    const Slice* iterate_upper_bound = nullptr,
+    ValueLog* value_log = nullptr);
 
 // Values and transactions committed later than high_ht can be skipped, so we won't spend time
 // for re-requesting pending transaction status if we already know it wasn't committed at high_ht.
@@ -101,7 +102,8 @@ std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     CoarseTimePoint deadline,
     const ReadHybridTime& read_time,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter = nullptr,
-    const Slice* iterate_upper_bound = nullptr);
+    const Slice* iterate_upper_bound = nullptr,
+    FillBlockCache fill_block_cache = FillBlockCache::kTrue);
 
 // Request RocksDB compaction and wait until it completes.
 CHECKED_STATUS ForceRocksDBCompact(rocksdb::DB* db);
@@ -119,9 +121,17 @@ void InitRocksDBOptions(
 // Sets logs prefix for RocksDB options. This will also reinitialize options->info_log.
 void SetLogPrefix(rocksdb::Options* options, const std::string& log_prefix);
 
+// When rocksdb_compact_flush_rate_limit_per_device is set, replaces the flush and compaction rate
+// limiter of options with the one shared by all RocksDB instances on the device of db_dir, which
+// must exist.
+CHECKED_STATUS SetDeviceRateLimiter(const std::string& db_dir, rocksdb::Options* options);
+
 // Gets the configured size of the node-global RocksDB priority thread pool.
 int32_t GetGlobalRocksDBPriorityThreadPoolSize();
 
+// Gets the node-global priority thread pool used for RocksDB compactions and flushes.
+PriorityThreadPool* GetGlobalPriorityThreadPool();
+
 // Class to edit RocksDB manifest w/o fully loading DB into memory.
 class RocksDBPatcher {
  public:
@@ -115,6 +115,22 @@ class NonTransactionalStatusProvider: public TransactionStatusManager {
     return result;
   }
 
+  SharedTransactionStatusCache* shared_status_cache() override {
+    return nullptr;
+  }
+
+  bool WaitForTransactionDone(
+      const TransactionId& id, CoarseTimePoint deadline,
+      TransactionWaitCallback callback) override {
+    Fail();
+    return false;
+  }
+
+  bool ScheduleRetry(CoarseDuration delay, TransactionWaitCallback callback) override {
+    Fail();
+    return false;
+  }
+
  private:
   static void Fail() {
     LOG(FATAL) << "Internal error: trying to get transaction status for non transactional table";
@@ -11,6 +11,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -20,6 +21,7 @@
 #include "yb/common/read_hybrid_time.h"
 #include "yb/common/transaction-test-util.h"
 
+#include "yb/docdb/doc_pgsql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb_debug.h"
@@ -35,6 +37,8 @@
 #include "yb/util/test_util.h"
 
 DECLARE_bool(TEST_docdb_sort_weak_intents_in_tests);
+DECLARE_int32(intent_range_check_after_seeks);
+DECLARE_int32(reverse_scan_max_prev_steps);
 
 namespace yb {
 namespace docdb {
@@ -61,8 +65,77 @@ class DocRowwiseIteratorTest : public DocDBTestBase {
     ASSERT_OK(kSchemaForIteratorTests.CreateProjectionByNames({"c", "d", "e"},
         &kProjectionForIteratorTests));
   }
+
+  // Writes num_rows rows, where column d of every third row among the first num_intent_rows is
+  // overwritten by a committed transaction, and odd rows have a record written after
+  // kScanReadTime. Returns the expected scan result in forward order.
+  std::vector<std::string> WriteRowsWithIntents(
+      TransactionStatusManagerMock* txn_status_manager, int num_rows, int num_intent_rows);
+
+  // Scans all rows at kScanReadTime, returning values of columns c and d.
+  Result<std::vector<std::string>> ScanRows(
+      const TransactionOperationContext& txn_context, bool is_forward_scan);
+
+  static constexpr uint64_t kScanReadTime = 2000;
 };
 
+std::vector<std::string> DocRowwiseIteratorTest::WriteRowsWithIntents(
+    TransactionStatusManagerMock* txn_status_manager, int num_rows, int num_intent_rows) {
+  auto txn = CHECK_RESULT(FullyDecodeTransactionId("0000000000000001"));
+  std::vector<std::string> expected;
+  for (int i = 0; i != num_rows; ++i) {
+    const auto doc_key = DocKey(PrimitiveValues(Format("row$0", 100 + i), i)).Encode();
+    CHECK_OK(SetPrimitive(
+        DocPath(doc_key, PrimitiveValue(30_ColId)),
+        PrimitiveValue(Format("row$0_c", i)), HybridTime::FromMicros(1000)));
+    CHECK_OK(SetPrimitive(
+        DocPath(doc_key, PrimitiveValue(40_ColId)),
+        PrimitiveValue(i), HybridTime::FromMicros(1000)));
+    if (i % 2) {
+      CHECK_OK(SetPrimitive(
+          DocPath(doc_key, PrimitiveValue(40_ColId)),
+          PrimitiveValue(i + 1000), HybridTime::FromMicros(kScanReadTime + 1000)));
+    }
+    int64_t d = i;
+    if (i < num_intent_rows && i % 3 == 0) {
+      SetCurrentTransactionId(txn);
+      CHECK_OK(SetPrimitive(
+          DocPath(doc_key, PrimitiveValue(40_ColId)),
+          PrimitiveValue(-i), HybridTime::FromMicros(500)));
+      ResetCurrentTransactionId();
+      d = -i;
+    }
+    expected.push_back(Format("row$0_c $1", i, d));
+  }
+  txn_status_manager->Commit(txn, HybridTime::FromMicros(1500));
+  return expected;
+}
+
+Result<std::vector<std::string>> DocRowwiseIteratorTest::ScanRows(
+    const TransactionOperationContext& txn_context, bool is_forward_scan) {
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  const std::vector<PrimitiveValue> empty_components;
+  DocRowwiseIterator iter(
+      projection, schema, txn_context, doc_db(),
+      CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(kScanReadTime));
+  RETURN_NOT_OK(iter.Init(DocPgsqlScanSpec(
+      schema, rocksdb::kDefaultQueryId, empty_components, empty_components,
+      nullptr /* condition */, boost::none /* hash_code */, boost::none /* max_hash_code */,
+      nullptr /* where_expr */, DocKey(), is_forward_scan)));
+
+  std::vector<std::string> result;
+  QLTableRow row;
+  QLValue c, d;
+  while (VERIFY_RESULT(iter.HasNext())) {
+    RETURN_NOT_OK(iter.NextRow(&row));
+    RETURN_NOT_OK(row.GetValue(projection.column_id(0), &c));
+    RETURN_NOT_OK(row.GetValue(projection.column_id(1), &d));
+    result.push_back(Format("$0 $1", c.string_value(), d.int64_value()));
+  }
+  return result;
+}
+
 const KeyBytes DocRowwiseIteratorTest::kEncodedDocKey1(
     DocKey(PrimitiveValues("row1", 11111)).Encode());
 
@@ -1270,5 +1343,131 @@ TEST_F(DocRowwiseIteratorTest, ScanWithinTheSameTxn) {
   ASSERT_EQ(intents_db_options_.statistics->getTickerCount(rocksdb::Tickers::NUMBER_DB_SEEK), 3);
 }
 
+TEST_F(DocRowwiseIteratorTest, DocKeysScan) {
+  const KeyBytes encoded_doc_key3(DocKey(PrimitiveValues("row3", 33333)).Encode());
+  const KeyBytes missing_doc_key(DocKey(PrimitiveValues("row2", 11111)).Encode());
+  for (const auto* doc_key : {&kEncodedDocKey1, &kEncodedDocKey2, &encoded_doc_key3}) {
+    ASSERT_OK(SetPrimitive(
+        DocPath(*doc_key, PrimitiveValue(40_ColId)),
+        PrimitiveValue(10000), HybridTime::FromMicros(1000)));
+  }
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  auto doc_keys = std::make_shared<std::vector<KeyBytes>>(std::initializer_list<KeyBytes>{
+      kEncodedDocKey1, missing_doc_key, encoded_doc_key3});
+  ASSERT_TRUE(std::is_sorted(doc_keys->begin(), doc_keys->end()));
+
+  DocRowwiseIterator iter(
+      projection, schema, kNonTransactionalOperationContext, doc_db(),
+      CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+  ASSERT_OK(iter.Init(DocPgsqlScanSpec(schema, rocksdb::kDefaultQueryId, doc_keys)));
+
+  // Only requested rows are returned in key order, missing key is skipped.
+  QLTableRow row;
+  for (const auto* doc_key : {&kEncodedDocKey1, &encoded_doc_key3}) {
+    ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_OK(iter.NextRow(&row));
+    ASSERT_EQ(doc_key->AsSlice(), ASSERT_RESULT(iter.GetTupleId()));
+  }
+  ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+}
+
+TEST_F(DocRowwiseIteratorTest, DistinctPrefixScan) {
+  std::vector<KeyBytes> doc_keys;
+  for (const auto& key : {std::make_pair("row1", 1), std::make_pair("row1", 2),
+                          std::make_pair("row2", 3), std::make_pair("row3", 1),
+                          std::make_pair("row3", 5), std::make_pair("row3", 7)}) {
+    doc_keys.push_back(DocKey(PrimitiveValues(key.first, key.second)).Encode());
+  }
+  for (const auto& doc_key : doc_keys) {
+    ASSERT_OK(SetPrimitive(
+        DocPath(doc_key, PrimitiveValue(40_ColId)),
+        PrimitiveValue(10000), HybridTime::FromMicros(1000)));
+  }
+  // The first row with the prefix is deleted, so the next row of the same prefix is returned.
+  ASSERT_OK(DeleteSubDoc(DocPath(doc_keys[3]), HybridTime::FromMicros(1500)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  const std::vector<PrimitiveValue> empty_components;
+  for (bool is_forward_scan : {true, false}) {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+    DocPgsqlScanSpec spec(
+        schema, rocksdb::kDefaultQueryId, empty_components, empty_components,
+        nullptr /* condition */, boost::none /* hash_code */, boost::none /* max_hash_code */,
+        nullptr /* where_expr */, DocKey(), is_forward_scan);
+    spec.set_distinct_prefix_length(1);
+    ASSERT_OK(iter.Init(spec));
+
+    std::vector<size_t> expected = is_forward_scan ? std::vector<size_t>{0, 2, 4}
+                                                   : std::vector<size_t>{5, 2, 1};
+    QLTableRow row;
+    for (auto idx : expected) {
+      ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+      ASSERT_OK(iter.NextRow(&row));
+      ASSERT_EQ(doc_keys[idx].AsSlice(), ASSERT_RESULT(iter.GetTupleId()));
+    }
+    ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+  }
+}
+
+TEST_F(DocRowwiseIteratorTest, IntentRangeCheck) {
+  SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+  constexpr int kNumRows = 50;
+
+  TransactionStatusManagerMock txn_status_manager;
+  // Intents are written to the first rows only, so most of the scan is past the last intent key.
+  const auto expected = WriteRowsWithIntents(
+      &txn_status_manager, kNumRows, 10 /* num_intent_rows */);
+
+  const auto txn_context = TransactionOperationContext(
+      TransactionId::GenerateRandom(), &txn_status_manager);
+  auto& statistics = *intents_db_options_.statistics;
+  std::vector<uint64_t> intent_seeks;
+  for (int check_after_seeks : {0, 1, 2}) {
+    FLAGS_intent_range_check_after_seeks = check_after_seeks;
+    statistics.resetTickersForTest();
+    ASSERT_EQ(expected, ASSERT_RESULT(ScanRows(txn_context, /* is_forward_scan */ true)))
+        << "check_after_seeks: " << check_after_seeks;
+    intent_seeks.push_back(statistics.getTickerCount(rocksdb::Tickers::NUMBER_DB_SEEK));
+  }
+  LOG(INFO) << "Intent seeks: " << yb::ToString(intent_seeks);
+  // Rows past the last intent key are read without seeking the intents DB.
+  ASSERT_LT(intent_seeks[1] + kNumRows / 2, intent_seeks[0]);
+  ASSERT_LT(intent_seeks[2] + kNumRows / 2, intent_seeks[0]);
+}
+
+TEST_F(DocRowwiseIteratorTest, ReverseScan) {
+  SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+  constexpr int kNumRows = 50;
+
+  TransactionStatusManagerMock txn_status_manager;
+  auto expected = WriteRowsWithIntents(&txn_status_manager, kNumRows, kNumRows);
+  std::reverse(expected.begin(), expected.end());
+
+  const auto txn_context = TransactionOperationContext(
+      TransactionId::GenerateRandom(), &txn_status_manager);
+  auto& statistics = *regular_db_options_.statistics;
+  std::vector<uint64_t> regular_seeks;
+  for (int max_prev_steps : {0, 1, 32}) {
+    FLAGS_reverse_scan_max_prev_steps = max_prev_steps;
+    statistics.resetTickersForTest();
+    ASSERT_EQ(expected, ASSERT_RESULT(ScanRows(txn_context, /* is_forward_scan */ false)))
+        << "max_prev_steps: " << max_prev_steps;
+    regular_seeks.push_back(statistics.getTickerCount(rocksdb::Tickers::NUMBER_DB_SEEK));
+  }
+  LOG(INFO) << "Regular seeks: " << yb::ToString(regular_seeks);
+  // Previous row is found by stepping back the backward-only iterator instead of seeking.
+  ASSERT_LT(regular_seeks[2], regular_seeks[0]);
+
+  // Forward scan returns the same rows in the opposite order.
+  auto forward = ASSERT_RESULT(ScanRows(txn_context, /* is_forward_scan */ true));
+  std::reverse(forward.begin(), forward.end());
+  ASSERT_EQ(expected, forward);
+}
+
 }  // namespace docdb
 }  // namespace yb
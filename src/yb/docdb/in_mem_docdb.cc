@@ -119,7 +119,8 @@ void InMemDocDbState::CaptureAt(const DocDB& doc_db, HybridTime hybrid_time,
 
   auto rocksdb_iter = CreateRocksDBIterator(
       doc_db.regular, doc_db.key_bounds, BloomFilterMode::DONT_USE_BLOOM_FILTER,
-      boost::none /* user_key_for_filter */, query_id);
+      boost::none /* user_key_for_filter */, query_id, nullptr /* file_filter */,
+      nullptr /* iterate_upper_bound */, doc_db.value_log);
   rocksdb_iter.SeekToFirst();
   KeyBytes prev_key;
   while (rocksdb_iter.Valid()) {
@@ -37,6 +37,18 @@
 
 using namespace std::literals;
 
+DEFINE_int32(intent_range_check_after_seeks, 2,
+             "Number of intent seeks done by IntentAwareIterator, after which it finds the largest "
+             "intent key in the intents DB, and skips further intent seeks past this key. "
+             "Zero disables this check.");
+TAG_FLAG(intent_range_check_after_seeks, advanced);
+
+DEFINE_int32(reverse_scan_max_prev_steps, 32,
+             "Maximal number of Prev() calls done by IntentAwareIterator::PrevDocKey on its "
+             "backward-only regular DB iterator, before falling back to seek. "
+             "Zero disables the backward-only iterator.");
+TAG_FLAG(reverse_scan_max_prev_steps, advanced);
+
 namespace yb {
 namespace docdb {
 
@@ -49,12 +61,6 @@ void GetIntentPrefixForKeyWithoutHt(const Slice& key, KeyBytes* out) {
   out->AppendRawBytes(key);
 }
 
-KeyBytes GetIntentPrefixForKeyWithoutHt(const Slice& key) {
-  KeyBytes result;
-  GetIntentPrefixForKeyWithoutHt(key, &result);
-  return result;
-}
-
 void AppendEncodedDocHt(const Slice& encoded_doc_ht, KeyBytes* key_bytes) {
   key_bytes->AppendValueType(ValueType::kHybridTime);
   key_bytes->AppendRawBytes(encoded_doc_ht);
@@ -222,6 +228,10 @@ IntentAwareIterator::IntentAwareIterator(
           read_time_.local_limit > read_time_.read ? Slice(encoded_read_time_local_limit_)
                                                    : Slice(encoded_read_time_read_)),
       txn_op_context_(txn_op_context),
+      regular_db_(doc_db.regular),
+      regular_read_opts_(read_opts),
+      key_bounds_(doc_db.key_bounds),
+      value_log_(doc_db.value_log),
       transaction_status_cache_(txn_op_context_, read_time, deadline) {
   VLOG(4) << "IntentAwareIterator, read_time: " << read_time
           << ", txn_op_context: " << txn_op_context_;
@@ -247,7 +257,7 @@ IntentAwareIterator::IntentAwareIterator(
   // 4) Transaction T1 is applied, k1->v1 is written into regular DB, intent k1->v1 is deleted.
   // 5) Intents DB iterator is created on an intents DB snapshot containing no intents for k1.
   // 6) Client reads no values for k1.
-  iter_ = BoundedRocksDbIterator(doc_db.regular, read_opts, doc_db.key_bounds);
+  iter_ = BoundedRocksDbIterator(doc_db.regular, read_opts, doc_db.key_bounds, doc_db.value_log);
 }
 
 void IntentAwareIterator::Seek(const DocKey &doc_key) {
@@ -274,12 +284,12 @@ void IntentAwareIterator::Seek(const Slice& key) {
 }
 
 void IntentAwareIterator::SeekForward(const Slice& key) {
-  KeyBytes key_bytes;
   // Reserve space for key plus kMaxBytesPerEncodedHybridTime + 1 bytes for SeekForward() below to
   // avoid extra realloc while appending the read time.
-  key_bytes.Reserve(key.size() + kMaxBytesPerEncodedHybridTime + 1);
-  key_bytes.AppendRawBytes(key);
-  SeekForward(&key_bytes);
+  slice_seek_buffer_.Clear();
+  slice_seek_buffer_.Reserve(key.size() + kMaxBytesPerEncodedHybridTime + 1);
+  slice_seek_buffer_.AppendRawBytes(key);
+  SeekForward(&slice_seek_buffer_);
 }
 
 void IntentAwareIterator::SeekForward(KeyBytes* key_bytes) {
@@ -354,12 +364,12 @@ void IntentAwareIterator::SeekOutOfSubDoc(KeyBytes* key_bytes) {
 }
 
 void IntentAwareIterator::SeekOutOfSubDoc(const Slice& key) {
-  KeyBytes key_bytes;
   // Reserve space for key + 1 byte for docdb::SeekOutOfSubKey() above to avoid extra realloc while
   // appending kMaxByte.
-  key_bytes.Reserve(key.size() + 1);
-  key_bytes.AppendRawBytes(key);
-  SeekOutOfSubDoc(&key_bytes);
+  slice_seek_buffer_.Clear();
+  slice_seek_buffer_.Reserve(key.size() + 1);
+  slice_seek_buffer_.AppendRawBytes(key);
+  SeekOutOfSubDoc(&slice_seek_buffer_);
 }
 
 bool IntentAwareIterator::HasCurrentEntry() {
@@ -446,6 +456,45 @@ Status IntentAwareIterator::NextFullValue(
   return status_;
 }
 
+Result<int64_t> IntentAwareIterator::SumCounterDeltas(const DocHybridTime& min_write_time) {
+  RETURN_NOT_OK(status_);
+  if (!IsEntryRegular()) {
+    return STATUS(Corruption, "Counter delta found in intents");
+  }
+  const KeyBytes key_without_ht(VERIFY_RESULT(FetchKey()).key);
+  const size_t key_size = key_without_ht.size();
+
+  int64_t sum = 0;
+  Value value;
+  for (;;) {
+    RETURN_NOT_OK(value.Decode(iter_.value()));
+    if (value.value_type() == ValueType::kTombstone) {
+      break;
+    }
+    if (value.value_type() != ValueType::kInt64) {
+      return STATUS_FORMAT(Corruption, "Unexpected counter value: $0", value);
+    }
+    sum += value.primitive_value().GetInt64();
+    if (value.merge_flags() != Value::kCounterDeltaFlag) {
+      break;
+    }
+
+    iter_.Next();
+    if (!iter_.Valid()) {
+      break;
+    }
+    Slice key = iter_.key();
+    if (!key.starts_with(key_without_ht.AsSlice()) || key.size() <= key_size ||
+        key[key_size] != ValueTypeAsChar::kHybridTime) {
+      break;
+    }
+    if (VERIFY_RESULT(DocHybridTime::DecodeFromEnd(&key)) < min_write_time) {
+      break;
+    }
+  }
+  return sum;
+}
+
 bool IntentAwareIterator::PreparePrev(const Slice& key) {
   VLOG(4) << __func__ << "(" << SubDocKey::DebugSliceToString(key) << ")";
 
@@ -458,9 +507,16 @@ bool IntentAwareIterator::PreparePrev(const Slice& key) {
   }
   SkipFutureRecords(Direction::kBackward);
 
+  PreparePrevIntent(key);
+
+  return HasCurrentEntry();
+}
+
+void IntentAwareIterator::PreparePrevIntent(const Slice& key) {
   if (intent_iter_.Initialized()) {
     ResetIntentUpperbound();
-    ROCKSDB_SEEK(&intent_iter_, GetIntentPrefixForKeyWithoutHt(key));
+    GetIntentPrefixForKeyWithoutHt(key, &slice_seek_buffer_);
+    ROCKSDB_SEEK(&intent_iter_, slice_seek_buffer_);
     if (intent_iter_.Valid()) {
       intent_iter_.Prev();
     } else {
@@ -470,8 +526,33 @@ bool IntentAwareIterator::PreparePrev(const Slice& key) {
     seek_intent_iter_needed_ = SeekIntentIterNeeded::kNoNeed;
     skip_future_intents_needed_ = false;
   }
+}
 
-  return HasCurrentEntry();
+void IntentAwareIterator::PositionReverseIter(const Slice& key) {
+  // Called while reverse_iter_ is swapped into iter_.
+  if (!iter_.Initialized()) {
+    // It is safe to create regular DB iterator after intents DB iterator, see comment in the
+    // constructor.
+    iter_ = BoundedRocksDbIterator(regular_db_, regular_read_opts_, key_bounds_, value_log_);
+  } else if (!reverse_iter_target_.empty() && key.compare(reverse_iter_target_.AsSlice()) <= 0) {
+    // All records between the current position and reverse_iter_target_ were skipped as future
+    // records, so it is enough to step back before the key.
+    for (int steps = FLAGS_reverse_scan_max_prev_steps; steps > 0; --steps) {
+      if (!iter_.Valid() || iter_.key().compare(key) < 0) {
+        reverse_iter_target_.Reset(key);
+        return;
+      }
+      iter_.Prev();
+    }
+  }
+
+  ROCKSDB_SEEK(&iter_, key);
+  if (iter_.Valid()) {
+    iter_.Prev();
+  } else {
+    iter_.SeekToLast();
+  }
+  reverse_iter_target_.Reset(key);
 }
 
 void IntentAwareIterator::PrevSubDocKey(const KeyBytes& key_bytes) {
@@ -485,8 +566,41 @@ void IntentAwareIterator::PrevDocKey(const DocKey& doc_key) {
 }
 
 void IntentAwareIterator::PrevDocKey(const Slice& encoded_doc_key) {
-  if (PreparePrev(encoded_doc_key)) {
-    SeekToLatestDocKeyInternal();
+  if (FLAGS_reverse_scan_max_prev_steps <= 0 || !prefix_stack_.empty() || !upperbound_.empty()) {
+    if (PreparePrev(encoded_doc_key)) {
+      SeekToLatestDocKeyInternal();
+    }
+    return;
+  }
+
+  VLOG(4) << __func__ << "(" << SubDocKey::DebugSliceToString(encoded_doc_key) << ")";
+
+  // Regular records are located by reverse_iter_, that is only moved backward. So consecutive
+  // PrevDocKey calls of a backward scan step over previous row with Prev() instead of seeking, and
+  // avoid changing direction of RocksDB iterator, that is expensive. Then the found row is read in
+  // forward direction by iter_, as usual.
+  std::swap(iter_, reverse_iter_);
+  PositionReverseIter(encoded_doc_key);
+  SkipFutureRecords(Direction::kBackward);
+  PreparePrevIntent(encoded_doc_key);
+
+  Slice doc_key;
+  if (HasCurrentEntry()) {
+    // Points to reverse_iter_ key or resolved intent, so stays valid after swap.
+    auto subdockey_slice = LatestSubDocKey();
+    auto dockey_size = DocKey::EncodedSize(subdockey_slice, DocKeyPart::kWholeDocKey);
+    if (!dockey_size.ok()) {
+      status_ = dockey_size.status();
+    } else {
+      doc_key = Slice(subdockey_slice.data(), *dockey_size);
+    }
+  }
+  std::swap(iter_, reverse_iter_);
+
+  if (!doc_key.empty()) {
+    Seek(doc_key);
+  } else {
+    iter_valid_ = false;
   }
 }
 
@@ -536,8 +650,17 @@ void IntentAwareIterator::SeekIntentIterIfNeeded() {
       break;
     case SeekIntentIterNeeded::kSeek:
       VLOG(4) << __func__ << ", seek: " << SubDocKey::DebugSliceToString(seek_key_buffer_);
-      ROCKSDB_SEEK(&intent_iter_, seek_key_buffer_);
-      SeekToSuitableIntent<Direction::kForward>();
+      // Single key reads do only a few seeks, so the range is looked up only for longer scans.
+      if (!last_intent_key_found_ && FLAGS_intent_range_check_after_seeks > 0 &&
+          ++num_intent_seeks_ >= static_cast<size_t>(FLAGS_intent_range_check_after_seeks)) {
+        FindLastIntentKey();
+      }
+      if (IntentSeekNotNeeded()) {
+        SkipIntentSeek();
+      } else {
+        ROCKSDB_SEEK(&intent_iter_, seek_key_buffer_);
+        SeekToSuitableIntent<Direction::kForward>();
+      }
       seek_intent_iter_needed_ = SeekIntentIterNeeded::kNoNeed;
       return;
     case SeekIntentIterNeeded::kSeekForward:
@@ -548,6 +671,42 @@ void IntentAwareIterator::SeekIntentIterIfNeeded() {
   FATAL_INVALID_ENUM_VALUE(SeekIntentIterNeeded, seek_intent_iter_needed_);
 }
 
+void IntentAwareIterator::SkipIntentSeek() {
+  // There are no intents at or after the seek key, so intent iterator is not positioned, and
+  // the iterator proceeds with regular records only.
+  VLOG(4) << __func__ << ", intent seek skipped, last intent key: "
+          << DebugDumpKeyToStr(last_intent_key_);
+  resolved_intent_state_ = ResolvedIntentState::kNoIntent;
+  resolved_intent_txn_dht_ = DocHybridTime::kMin;
+  intent_dht_from_same_txn_ = DocHybridTime::kMin;
+}
+
+void IntentAwareIterator::FindLastIntentKey() {
+  last_intent_key_found_ = true;
+  last_intent_key_.Clear();
+  ResetIntentUpperbound();
+  intent_iter_.SeekToLast();
+  if (intent_iter_.Valid() && intent_iter_.key()[0] == ValueTypeAsChar::kTransactionId) {
+    // Step back before the transaction metadata and reverse index region.
+    static const std::array<char, 1> kTxnRegionStart{ValueTypeAsChar::kTransactionId};
+    ROCKSDB_SEEK(&intent_iter_, Slice(kTxnRegionStart));
+    if (intent_iter_.Valid()) {
+      intent_iter_.Prev();
+    }
+  }
+  if (intent_iter_.Valid()) {
+    last_intent_key_.AppendRawBytes(intent_iter_.key());
+  }
+  VLOG(4) << __func__ << ": " << DebugDumpKeyToStr(last_intent_key_);
+  // Restore upperbound for the current position of the regular iterator.
+  status_ = SetIntentUpperbound();
+}
+
+bool IntentAwareIterator::IntentSeekNotNeeded() const {
+  return last_intent_key_found_ &&
+         (last_intent_key_.empty() || seek_key_buffer_.CompareTo(last_intent_key_) > 0);
+}
+
 bool IntentAwareIterator::valid() {
   if (skip_future_records_needed_) {
     SkipFutureRecords(Direction::kForward);
@@ -708,6 +867,11 @@ void IntentAwareIterator::SeekForwardToSuitableIntent() {
     }
   }
 
+  if (IntentSeekNotNeeded()) {
+    SkipIntentSeek();
+    return;
+  }
+
   docdb::SeekForward(seek_key_buffer_.AsSlice(), &intent_iter_);
   SeekToSuitableIntent<Direction::kForward>();
 }
@@ -130,6 +130,15 @@ class IntentAwareIterator {
       Slice* result_value,
       Slice* final_key = nullptr);
 
+  // Iterate through Next() from the current counter delta record (see Value::kCounterDeltaFlag),
+  // and return the sum of this delta and the values of the older versions of the same key, down to
+  // and including the latest full value. Versions written before min_write_time are overwritten by
+  // an ancestor, so iteration stops there as well as at a tombstone.
+  //
+  // Counter deltas are only written to non-transactional tables, so only regular records are
+  // scanned.
+  Result<int64_t> SumCounterDeltas(const DocHybridTime& min_write_time);
+
   // Finds the latest record for a particular key after the provided max_overwrite_time, returns the
   // write time of the found record, and optionally also the result value. This latest record may
   // not be a full record, but instead a merge record (e.g. a TTL row).
@@ -248,10 +257,26 @@ class IntentAwareIterator {
 
   void SeekIntentIterIfNeeded();
 
+  // Finds the largest intent key in the intents DB snapshot, used by this iterator, skipping the
+  // transaction metadata and reverse index region. So intent seeks past this key could be skipped.
+  void FindLastIntentKey();
+
+  // Returns true if there are no intents at or after seek_key_buffer_ in the intents DB snapshot.
+  bool IntentSeekNotNeeded() const;
+
+  // Resets resolved intent instead of seeking intent iterator, when IntentSeekNotNeeded.
+  void SkipIntentSeek();
+
   // Does initial steps for prev doc key/sub doc key seek.
   // Returns true if prepare succeed.
   bool PreparePrev(const Slice& key);
 
+  // Positions intent iterator for prev doc key/sub doc key seek.
+  void PreparePrevIntent(const Slice& key);
+
+  // Positions iter_, that is swapped with reverse_iter_, to the last record before the key.
+  void PositionReverseIter(const Slice& key);
+
   bool SatisfyBounds(const Slice& slice);
 
   bool ResolvedIntentFromSameTransaction() const {
@@ -287,6 +312,14 @@ class IntentAwareIterator {
   const TransactionOperationContextOpt txn_op_context_;
   docdb::BoundedRocksDbIterator intent_iter_;
   docdb::BoundedRocksDbIterator iter_;
+  // Regular DB iterator that is only moved backward by PrevDocKey, created on demand.
+  docdb::BoundedRocksDbIterator reverse_iter_;
+  // Key passed to the last PositionReverseIter call.
+  KeyBytes reverse_iter_target_;
+  rocksdb::DB* const regular_db_;
+  const rocksdb::ReadOptions regular_read_opts_;
+  const KeyBounds* const key_bounds_;
+  ValueLog* const value_log_;
   // iter_valid_ is true if and only if iter_ is positioned at key which matches top prefix from
   // the stack and record time satisfies read_time_ criteria.
   bool iter_valid_ = false;
@@ -321,6 +354,16 @@ class IntentAwareIterator {
   // Reusable buffer to prepare seek key to avoid reallocating temporary buffers in critical paths.
   KeyBytes seek_key_buffer_;
   Slice seek_key_prefix_;
+
+  // Reusable buffer for the Slice overloads of Seek* methods, that need a mutable copy of the key.
+  // Kept separate from seek_key_buffer_, which has to survive until the next intent seek.
+  KeyBytes slice_seek_buffer_;
+
+  // Number of intent seeks performed before an intent range was found.
+  size_t num_intent_seeks_ = 0;
+  bool last_intent_key_found_ = false;
+  // Largest intent key, or empty if the intents DB snapshot does not contain intents at all.
+  KeyBytes last_intent_key_;
 };
 
 class IntentAwareIteratorPrefixScope {
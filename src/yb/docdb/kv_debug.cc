@@ -23,6 +23,7 @@
 #include "yb/docdb/intent.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/doc_kv_util.h"
+#include "yb/docdb/packed_row.h"
 
 namespace yb {
 namespace docdb {
@@ -95,6 +96,11 @@ Result<std::string> DocDBValueToDebugStrInternal(Slice value_slice, KeyType key_
   // Empty values are allowed for weak intents.
   if (!value_slice.empty() || key_type != KeyType::kIntentKey) {
     Value v;
+    Slice packed_row = value_slice;
+    RETURN_NOT_OK(v.DecodeControlFields(&packed_row));
+    if (DecodeValueType(packed_row) == ValueType::kPackedRow) {
+      return prefix + VERIFY_RESULT(PackedRow::Decode(packed_row)).ToString();
+    }
     RETURN_NOT_OK_PREPEND(
         v.Decode(value_slice),
         Format("Error: failed to decode value $0", prefix));
@@ -24,18 +24,26 @@ DEFINE_bool(dump_lock_keys, true,
 namespace yb {
 namespace docdb {
 
+namespace {
+
+Status LockTimedOutStatus(const LockBatchEntries& key_to_type, CoarseTimePoint deadline) {
+  std::string batch_str;
+  if (FLAGS_dump_lock_keys) {
+    batch_str = Format(", batch: $0", key_to_type);
+  }
+  return STATUS_FORMAT(
+      TryAgain, "Failed to obtain locks until deadline: $0$1", deadline, batch_str);
+}
+
+} // namespace
+
 LockBatch::LockBatch(SharedLockManager* lock_manager, LockBatchEntries&& key_to_intent_type,
                      CoarseTimePoint deadline)
     : data_(std::move(key_to_intent_type), lock_manager) {
   if (!empty() && !lock_manager->Lock(&data_.key_to_type, deadline)) {
     data_.shared_lock_manager = nullptr;
-    std::string batch_str;
-    if (FLAGS_dump_lock_keys) {
-      batch_str = Format(", batch: $0", data_.key_to_type);
-    }
+    data_.status = LockTimedOutStatus(data_.key_to_type, deadline);
     data_.key_to_type.clear();
-    data_.status = STATUS_FORMAT(
-        TryAgain, "Failed to obtain locks until deadline: $0$1", deadline, batch_str);
   }
 }
 
@@ -45,10 +53,31 @@ LockBatch::~LockBatch() {
 
 void LockBatch::Reset() {
   if (!empty()) {
-    VLOG(1) << "Auto-unlocking a LockBatch with " << size() << " keys";
-    DCHECK_NOTNULL(data_.shared_lock_manager)->Unlock(data_.key_to_type);
+    if (!data_.unlocked) {
+      VLOG(1) << "Auto-unlocking a LockBatch with " << size() << " keys";
+      DCHECK_NOTNULL(data_.shared_lock_manager)->Unlock(data_.key_to_type);
+    }
     data_.key_to_type.clear();
+    data_.unlocked = false;
+  }
+}
+
+void LockBatch::Unlock() {
+  if (!empty() && !data_.unlocked) {
+    DCHECK_NOTNULL(data_.shared_lock_manager)->Unlock(data_.key_to_type);
+    data_.unlocked = true;
+  }
+}
+
+Status LockBatch::Relock(CoarseTimePoint deadline) {
+  if (empty() || !data_.unlocked) {
+    return Status::OK();
+  }
+  if (!data_.shared_lock_manager->Lock(&data_.key_to_type, deadline)) {
+    return LockTimedOutStatus(data_.key_to_type, deadline);
   }
+  data_.unlocked = false;
+  return Status::OK();
 }
 
 void LockBatch::MoveFrom(LockBatch* other) {
@@ -74,6 +74,14 @@ class LockBatch {
   // Unlocks this batch if it is non-empty.
   void Reset();
 
+  // Temporarily releases locks of this batch, while keeping its keys, so they could be locked
+  // again using Relock. Used while the operation is waiting for a conflicting transaction.
+  void Unlock();
+
+  // Locks keys released by Unlock again, waiting for them until deadline. On failure the batch
+  // stays unlocked with its keys, so locking could be retried.
+  CHECKED_STATUS Relock(CoarseTimePoint deadline);
+
  private:
   void MoveFrom(LockBatch* other);
 
@@ -93,6 +101,9 @@ class LockBatch {
     SharedLockManager* shared_lock_manager = nullptr;
 
     Status status;
+
+    // Whether locks were released by Unlock.
+    bool unlocked = false;
   };
 
   Data data_;
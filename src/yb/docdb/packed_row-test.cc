@@ -0,0 +1,200 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/packed_row.h"
+
+#include "yb/docdb/primitive_value.h"
+#include "yb/docdb/value_type.h"
+
+#include "yb/gutil/endian.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+PrimitiveValue DecodeColumn(const boost::optional<Slice>& encoded) {
+  CHECK(encoded);
+  PrimitiveValue result;
+  CHECK_OK(result.DecodeFromValue(*encoded));
+  return result;
+}
+
+std::string Pack(
+    uint32_t schema_version, const std::vector<std::pair<ColumnId, PrimitiveValue>>& columns) {
+  RowPacker packer(schema_version);
+  for (const auto& column : columns) {
+    CHECK_OK(packer.AddValue(column.first, column.second));
+  }
+  return CHECK_RESULT(packer.Complete()).ToBuffer();
+}
+
+} // namespace
+
+class PackedRowTest : public YBTest {
+};
+
+TEST_F(PackedRowTest, PackAndDecode) {
+  RowPacker packer(3);
+  // Columns could be added in any order.
+  ASSERT_OK(packer.AddValue(12_ColId, PrimitiveValue("twelve")));
+  ASSERT_OK(packer.AddValue(10_ColId, PrimitiveValue(42)));
+  ASSERT_OK(packer.AddValue(11_ColId, PrimitiveValue::kTombstone));
+  ASSERT_OK(packer.AddValue(14_ColId, PrimitiveValue(ValueType::kNullLow)));
+  auto packed = ASSERT_RESULT(packer.Complete()).ToBuffer();
+  ASSERT_EQ(ValueType::kPackedRow, DecodeValueType(packed));
+
+  auto row = ASSERT_RESULT(PackedRow::Decode(packed));
+  ASSERT_EQ(3, row.schema_version());
+  ASSERT_EQ(4, row.columns());
+  ASSERT_EQ(10_ColId, row.column_id(0));
+  ASSERT_EQ(11_ColId, row.column_id(1));
+  ASSERT_EQ(12_ColId, row.column_id(2));
+  ASSERT_EQ(14_ColId, row.column_id(3));
+  ASSERT_EQ(PrimitiveValue(42), DecodeColumn(row.GetValue(10_ColId)));
+  ASSERT_EQ(PrimitiveValue("twelve"), DecodeColumn(row.GetValue(12_ColId)));
+
+  // NULL and tombstone are both stored as NULL, while a column that was not added is absent.
+  ASSERT_EQ(ValueType::kNullLow, DecodeValueType(*row.GetValue(11_ColId)));
+  ASSERT_EQ(ValueType::kNullLow, DecodeValueType(*row.GetValue(14_ColId)));
+  ASSERT_FALSE(row.GetValue(13_ColId));
+  ASSERT_FALSE(row.GetValue(9_ColId));
+  ASSERT_FALSE(row.GetValue(15_ColId));
+
+  // The packer is reused for the next row.
+  packer.Restart();
+  ASSERT_OK(packer.AddValue(10_ColId, PrimitiveValue(1)));
+  row = ASSERT_RESULT(PackedRow::Decode(ASSERT_RESULT(packer.Complete())));
+  ASSERT_EQ(1, row.columns());
+  ASSERT_EQ(PrimitiveValue(1), DecodeColumn(row.GetValue(10_ColId)));
+
+  // Empty row.
+  packer.Restart();
+  row = ASSERT_RESULT(PackedRow::Decode(ASSERT_RESULT(packer.Complete())));
+  ASSERT_EQ(0, row.columns());
+  ASSERT_FALSE(row.GetValue(10_ColId));
+}
+
+TEST_F(PackedRowTest, DuplicateColumn) {
+  RowPacker packer(1);
+  ASSERT_OK(packer.AddValue(10_ColId, PrimitiveValue(1)));
+  ASSERT_OK(packer.AddValue(10_ColId, PrimitiveValue(2)));
+  ASSERT_NOK(packer.Complete());
+  ASSERT_NOK(packer.AddValue(11_ColId, Slice()));
+}
+
+TEST_F(PackedRowTest, Corruption) {
+  const auto packed = Pack(1, {{10_ColId, PrimitiveValue(1)}, {11_ColId, PrimitiveValue("a")}});
+  ASSERT_OK(PackedRow::Decode(packed));
+
+  // No prefix of the row, nor the row with trailing bytes, is decoded.
+  for (size_t size = 0; size != packed.size(); ++size) {
+    ASSERT_NOK(PackedRow::Decode(Slice(packed.data(), size))) << size;
+  }
+  ASSERT_NOK(PackedRow::Decode(packed + "x"));
+
+  // Not a packed row.
+  ASSERT_NOK(PackedRow::Decode(PrimitiveValue(1).ToValue()));
+
+  // The header starts after kPackedRow, schema version and number of columns, that are single
+  // byte varints here.
+  constexpr size_t kHeaderStart = 3;
+  constexpr size_t kEntrySize = 2 * sizeof(uint32_t);
+  auto corrupt = [&packed](size_t offset, uint32_t value) {
+    auto result = packed;
+    LittleEndian::Store32(&result[offset], value);
+    return result;
+  };
+  // Column ids should be increasing.
+  ASSERT_NOK(PackedRow::Decode(corrupt(kHeaderStart + kEntrySize, 10)));
+  ASSERT_NOK(PackedRow::Decode(corrupt(kHeaderStart + kEntrySize, 9)));
+  // Column id should fit into ColumnId.
+  ASSERT_NOK(PackedRow::Decode(corrupt(kHeaderStart + kEntrySize, 0x80000000)));
+  // Column values should not end beyond the data.
+  ASSERT_NOK(PackedRow::Decode(corrupt(kHeaderStart + sizeof(uint32_t), 0x10000)));
+  // Column values should not end before the previous column.
+  auto first_end = LittleEndian::Load32(&packed[kHeaderStart + sizeof(uint32_t)]);
+  ASSERT_NOK(PackedRow::Decode(
+      corrupt(kHeaderStart + kEntrySize + sizeof(uint32_t), first_end - 1)));
+  // Number of columns should fit into the value.
+  auto bad_count = packed;
+  bad_count[2] = 0x7f;
+  ASSERT_NOK(PackedRow::Decode(bad_count));
+}
+
+TEST_F(PackedRowTest, Repack) {
+  const auto packed = Pack(2, {
+      {10_ColId, PrimitiveValue(1)}, {11_ColId, PrimitiveValue("old")},
+      {12_ColId, PrimitiveValue(3)}, {14_ColId, PrimitiveValue(4)}});
+  auto row = ASSERT_RESULT(PackedRow::Decode(packed));
+
+  std::map<ColumnId, std::string> updates;
+  updates[9_ColId] = PrimitiveValue("added before").ToValue();
+  updates[11_ColId] = PrimitiveValue("new").ToValue();
+  updates[12_ColId] = PrimitiveValue::kTombstone.ToValue();
+  updates[13_ColId] = PrimitiveValue(13).ToValue();
+  updates[15_ColId] = PrimitiveValue("added after").ToValue();
+  ColumnIds deleted_columns = {14_ColId, 15_ColId};
+
+  std::string repacked;
+  ASSERT_OK(RepackRow(row, updates, deleted_columns, &repacked));
+  auto result = ASSERT_RESULT(PackedRow::Decode(repacked));
+  ASSERT_EQ(2, result.schema_version());
+  ASSERT_EQ(5, result.columns());
+  ASSERT_EQ(PrimitiveValue("added before"), DecodeColumn(result.GetValue(9_ColId)));
+  ASSERT_EQ(PrimitiveValue(1), DecodeColumn(result.GetValue(10_ColId)));
+  ASSERT_EQ(PrimitiveValue("new"), DecodeColumn(result.GetValue(11_ColId)));
+  ASSERT_EQ(ValueType::kNullLow, DecodeValueType(*result.GetValue(12_ColId)));
+  ASSERT_EQ(PrimitiveValue(13), DecodeColumn(result.GetValue(13_ColId)));
+  ASSERT_FALSE(result.GetValue(14_ColId));
+  ASSERT_FALSE(result.GetValue(15_ColId));
+
+  // Repacking without changes keeps the row as is.
+  repacked.clear();
+  ASSERT_OK(RepackRow(row, {}, {}, &repacked));
+  ASSERT_EQ(packed, repacked);
+}
+
+TEST_F(PackedRowTest, SchemaVersions) {
+  // Rows written with different schema versions are decoded without the schema. Column 11 was
+  // dropped and column 12 was added by version 2.
+  const auto v1 = Pack(1, {{10_ColId, PrimitiveValue(1)}, {11_ColId, PrimitiveValue("v1")}});
+  const auto v2 = Pack(2, {{10_ColId, PrimitiveValue(2)}, {12_ColId, PrimitiveValue("v2")}});
+
+  auto row1 = ASSERT_RESULT(PackedRow::Decode(v1));
+  auto row2 = ASSERT_RESULT(PackedRow::Decode(v2));
+  ASSERT_EQ(1, row1.schema_version());
+  ASSERT_EQ(2, row2.schema_version());
+  ASSERT_EQ(PrimitiveValue(1), DecodeColumn(row1.GetValue(10_ColId)));
+  ASSERT_EQ(PrimitiveValue("v1"), DecodeColumn(row1.GetValue(11_ColId)));
+  // The column added later is absent from the old row, so it is read as NULL.
+  ASSERT_FALSE(row1.GetValue(12_ColId));
+  ASSERT_EQ(PrimitiveValue(2), DecodeColumn(row2.GetValue(10_ColId)));
+  ASSERT_FALSE(row2.GetValue(11_ColId));
+  ASSERT_EQ(PrimitiveValue("v2"), DecodeColumn(row2.GetValue(12_ColId)));
+
+  // Compaction drops the deleted column from the old row, keeping its schema version.
+  std::string repacked;
+  ASSERT_OK(RepackRow(row1, {}, {11_ColId}, &repacked));
+  auto result = ASSERT_RESULT(PackedRow::Decode(repacked));
+  ASSERT_EQ(1, result.schema_version());
+  ASSERT_EQ(1, result.columns());
+  ASSERT_FALSE(result.GetValue(11_ColId));
+  ASSERT_NE(result.ToString().find("schema_version: 1"), std::string::npos) << result.ToString();
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,230 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/packed_row.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "yb/gutil/endian.h"
+
+#include "yb/docdb/primitive_value.h"
+#include "yb/docdb/value_type.h"
+
+#include "yb/util/fast_varint.h"
+#include "yb/util/status.h"
+#include "yb/util/tostring.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+constexpr size_t kColumnEntrySize = 2 * sizeof(uint32_t);
+
+// Appends the packed row with the specified columns, that should be ordered by id, to out.
+void EncodePackedRow(
+    uint32_t schema_version, const std::vector<std::pair<ColumnId, Slice>>& columns,
+    std::string* out) {
+  out->push_back(ValueTypeAsChar::kPackedRow);
+  util::FastAppendUnsignedVarIntToStr(schema_version, out);
+  util::FastAppendUnsignedVarIntToStr(columns.size(), out);
+  size_t header_start = out->size();
+  out->resize(header_start + columns.size() * kColumnEntrySize);
+  uint32_t end = 0;
+  for (const auto& column : columns) {
+    end += column.second.size();
+    auto* entry = &(*out)[header_start];
+    LittleEndian::Store32(entry, static_cast<uint32_t>(column.first.rep()));
+    LittleEndian::Store32(entry + sizeof(uint32_t), end);
+    header_start += kColumnEntrySize;
+  }
+  for (const auto& column : columns) {
+    out->append(column.second.cdata(), column.second.size());
+  }
+}
+
+Slice NullIfTombstone(const Slice& encoded_value) {
+  static const std::string kEncodedNull(1, ValueTypeAsChar::kNullLow);
+  return DecodeValueType(encoded_value) == ValueType::kTombstone ? Slice(kEncodedNull)
+                                                                 : encoded_value;
+}
+
+} // namespace
+
+Result<PackedRow> PackedRow::Decode(const Slice& value) {
+  Slice slice = value;
+  if (!slice.TryConsumeByte(ValueTypeAsChar::kPackedRow)) {
+    return STATUS_FORMAT(Corruption, "Packed row expected: $0", value.ToDebugHexString());
+  }
+  PackedRow result;
+  const auto schema_version = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&slice));
+  const auto num_columns = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&slice));
+  if (schema_version > std::numeric_limits<uint32_t>::max() ||
+      num_columns > slice.size() / kColumnEntrySize) {
+    return STATUS_FORMAT(Corruption, "Bad packed row header: $0", value.ToDebugHexString());
+  }
+  result.schema_version_ = static_cast<uint32_t>(schema_version);
+  result.num_columns_ = num_columns;
+  result.header_ = slice.data();
+  result.data_ = Slice(slice.data() + num_columns * kColumnEntrySize, slice.end());
+
+  int64_t prev_id = -1;
+  size_t prev_end = 0;
+  for (size_t idx = 0; idx != num_columns; ++idx) {
+    const auto* entry = result.header_ + idx * kColumnEntrySize;
+    const int64_t id = LittleEndian::Load32(entry);
+    const size_t end = LittleEndian::Load32(entry + sizeof(uint32_t));
+    if (id <= prev_id || id > std::numeric_limits<ColumnIdRep>::max() ||
+        end < prev_end || end > result.data_.size()) {
+      return STATUS_FORMAT(
+          Corruption, "Bad packed row column $0: $1", idx, value.ToDebugHexString());
+    }
+    prev_id = id;
+    prev_end = end;
+  }
+  if (prev_end != result.data_.size()) {
+    return STATUS_FORMAT(
+        Corruption, "Extra data after packed row columns: $0", value.ToDebugHexString());
+  }
+  return result;
+}
+
+ColumnId PackedRow::column_id(size_t idx) const {
+  DCHECK_LT(idx, num_columns_);
+  return ColumnId(
+      static_cast<ColumnIdRep>(LittleEndian::Load32(header_ + idx * kColumnEntrySize)));
+}
+
+size_t PackedRow::End(size_t idx) const {
+  return LittleEndian::Load32(header_ + idx * kColumnEntrySize + sizeof(uint32_t));
+}
+
+Slice PackedRow::value(size_t idx) const {
+  DCHECK_LT(idx, num_columns_);
+  const auto begin = idx == 0 ? 0 : End(idx - 1);
+  return Slice(data_.data() + begin, data_.data() + End(idx));
+}
+
+boost::optional<Slice> PackedRow::GetValue(ColumnId column_id) const {
+  size_t lo = 0;
+  size_t hi = num_columns_;
+  while (lo < hi) {
+    const auto mid = (lo + hi) / 2;
+    const auto mid_id = this->column_id(mid);
+    if (mid_id == column_id) {
+      return value(mid);
+    }
+    if (mid_id < column_id) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return boost::none;
+}
+
+std::string PackedRow::ToString() const {
+  std::string result = Format("{ schema_version: $0 columns: {", schema_version_);
+  for (size_t idx = 0; idx != num_columns_; ++idx) {
+    PrimitiveValue column_value;
+    auto status = column_value.DecodeFromValue(value(idx));
+    result += Format(
+        " $0: $1", column_id(idx), status.ok() ? column_value.ToString() : status.ToString());
+  }
+  result += " } }";
+  return result;
+}
+
+RowPacker::RowPacker(uint32_t schema_version) : schema_version_(schema_version) {
+}
+
+void RowPacker::Restart() {
+  columns_.clear();
+  values_.clear();
+  result_.clear();
+}
+
+Status RowPacker::AddValue(ColumnId column_id, const PrimitiveValue& value) {
+  return AddValue(column_id, value.ToValue());
+}
+
+Status RowPacker::AddValue(ColumnId column_id, const Slice& encoded_value) {
+  const auto value = NullIfTombstone(encoded_value);
+  if (value.empty()) {
+    return STATUS_FORMAT(InvalidArgument, "Empty value of column $0", column_id);
+  }
+  const auto begin = values_.size();
+  values_.append(value.cdata(), value.size());
+  columns_.push_back(Column {
+    .id = column_id,
+    .begin = begin,
+    .end = values_.size(),
+  });
+  return Status::OK();
+}
+
+Result<Slice> RowPacker::Complete() {
+  std::sort(columns_.begin(), columns_.end(), [](const Column& lhs, const Column& rhs) {
+    return lhs.id < rhs.id;
+  });
+  std::vector<std::pair<ColumnId, Slice>> columns;
+  columns.reserve(columns_.size());
+  for (const auto& column : columns_) {
+    if (!columns.empty() && columns.back().first == column.id) {
+      return STATUS_FORMAT(InvalidArgument, "Column $0 added twice", column.id);
+    }
+    columns.emplace_back(
+        column.id, Slice(values_.data() + column.begin, values_.data() + column.end));
+  }
+  result_.clear();
+  EncodePackedRow(schema_version_, columns, &result_);
+  return Slice(result_);
+}
+
+Status RepackRow(
+    const PackedRow& row, const std::map<ColumnId, std::string>& updates,
+    const ColumnIds& deleted_columns, std::string* out) {
+  std::vector<std::pair<ColumnId, Slice>> columns;
+  columns.reserve(row.columns() + updates.size());
+  auto update_it = updates.begin();
+  // Merges columns of the row with updates, both being ordered by column id.
+  for (size_t idx = 0; idx != row.columns() || update_it != updates.end();) {
+    ColumnId column_id;
+    Slice value;
+    if (idx != row.columns() &&
+        (update_it == updates.end() || row.column_id(idx) < update_it->first)) {
+      column_id = row.column_id(idx);
+      value = row.value(idx);
+      ++idx;
+    } else {
+      column_id = update_it->first;
+      value = NullIfTombstone(update_it->second);
+      if (idx != row.columns() && row.column_id(idx) == column_id) {
+        ++idx;
+      }
+      ++update_it;
+    }
+    if (value.empty()) {
+      return STATUS_FORMAT(InvalidArgument, "Empty value of column $0", column_id);
+    }
+    if (deleted_columns.count(column_id) == 0) {
+      columns.emplace_back(column_id, value);
+    }
+  }
+  EncodePackedRow(row.schema_version(), columns, out);
+  return Status::OK();
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,128 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_PACKED_ROW_H_
+#define YB_DOCDB_PACKED_ROW_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "yb/common/schema.h"
+
+#include "yb/docdb/docdb_fwd.h"
+
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace docdb {
+
+// Packed row stores the non-key columns of a row in a single RocksDB value written at the document
+// key, instead of a separate key/value pair per column. It is written by YSQL inserts when
+// ysql_enable_packed_row is set, and implies existence of the row, so no liveness column is
+// written with it. The value has the following layout:
+//
+//   kPackedRow | schema_version | num_columns | (column_id, end) * num_columns | data
+//
+// schema_version and num_columns are unsigned varints. column_id and end are 4-byte little endian
+// integers, end being the offset of the end of the column value relative to the beginning of the
+// data section. Columns are ordered by id, and their values are encoded using
+// PrimitiveValue::ToValue, NULL being stored as ValueType::kNullLow.
+//
+// The row carries the ids of its columns, so it is decoded without the schema it was written with.
+// A column that was not a part of the row (e.g. it was added by a later schema version, or was not
+// specified by the insert) is absent from it, and is read as NULL. Later per-column updates and
+// deletes are written as usual and override the packed value. Major compactions fold them back
+// into the packed row, and drop deleted columns from it, see DocDBCompactionFilter.
+class PackedRow {
+ public:
+  // Decodes the packed row, starting with ValueType::kPackedRow. The row references the specified
+  // slice, so its data should outlive the row.
+  static Result<PackedRow> Decode(const Slice& value);
+
+  uint32_t schema_version() const {
+    return schema_version_;
+  }
+
+  size_t columns() const {
+    return num_columns_;
+  }
+
+  ColumnId column_id(size_t idx) const;
+
+  // Returns the encoded value of the column with the specified index.
+  Slice value(size_t idx) const;
+
+  // Returns the encoded value of the specified column, or boost::none if the column is absent from
+  // the row. NULL is returned as a value of type ValueType::kNullLow.
+  boost::optional<Slice> GetValue(ColumnId column_id) const;
+
+  std::string ToString() const;
+
+ private:
+  PackedRow() = default;
+
+  size_t End(size_t idx) const;
+
+  uint32_t schema_version_ = 0;
+  size_t num_columns_ = 0;
+  const uint8_t* header_ = nullptr;
+  Slice data_;
+};
+
+// Builds a packed row. Columns could be added in any order, but each of them only once.
+class RowPacker {
+ public:
+  explicit RowPacker(uint32_t schema_version);
+
+  // Adds the column value. Tombstone is stored as NULL.
+  CHECKED_STATUS AddValue(ColumnId column_id, const PrimitiveValue& value);
+
+  // Adds the column value that is already encoded using PrimitiveValue::ToValue.
+  CHECKED_STATUS AddValue(ColumnId column_id, const Slice& encoded_value);
+
+  // Returns the encoded packed row. The returned slice is valid until the next call to Restart or
+  // until the packer is destroyed.
+  Result<Slice> Complete();
+
+  // Prepares the packer to build the next row.
+  void Restart();
+
+ private:
+  struct Column {
+    ColumnId id;
+    size_t begin;
+    size_t end;
+  };
+
+  uint32_t schema_version_;
+  std::vector<Column> columns_;
+  // Values of added columns, in the order they were added.
+  std::string values_;
+  std::string result_;
+};
+
+// Re-encodes the packed row to out, replacing column values with the ones specified by updates and
+// dropping columns in deleted_columns. Columns that are absent from the row are added. Tombstone
+// updates are stored as NULL.
+CHECKED_STATUS RepackRow(
+    const PackedRow& row, const std::map<ColumnId, std::string>& updates,
+    const ColumnIds& deleted_columns, std::string* out);
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_PACKED_ROW_H_
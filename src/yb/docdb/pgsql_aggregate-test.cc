@@ -0,0 +1,140 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/pgsql_aggregate.h"
+
+#include "yb/common/ql_expr.h"
+
+#include "yb/docdb/doc_expr.h"
+
+#include "yb/util/bfpg/tserver_opcodes.h"
+#include "yb/util/random_util.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+constexpr ColumnIdRep kInt32Column = 10;
+constexpr ColumnIdRep kInt64Column = 11;
+constexpr ColumnIdRep kDoubleColumn = 12;
+constexpr ColumnIdRep kStringColumn = 13;
+
+PgsqlExpressionPB MakeAggregate(bfpg::TSOpcode opcode, ColumnIdRep column_id) {
+  PgsqlExpressionPB result;
+  auto* tscall = result.mutable_tscall();
+  tscall->set_opcode(static_cast<int32_t>(opcode));
+  tscall->add_operands()->set_column_id(column_id);
+  return result;
+}
+
+PgsqlExpressionPB MakeCountStar() {
+  PgsqlExpressionPB result;
+  auto* tscall = result.mutable_tscall();
+  tscall->set_opcode(static_cast<int32_t>(bfpg::TSOpcode::kCount));
+  tscall->add_operands()->mutable_value()->set_int64_value(0);
+  return result;
+}
+
+} // namespace
+
+class PgsqlAggregateTest : public YBTest {
+ protected:
+  void GenerateRows(size_t count) {
+    rows_.resize(count);
+    for (auto& row : rows_) {
+      // Every column is NULL in some rows.
+      if (RandomUniformInt(0, 9) != 0) {
+        row.AllocColumn(kInt32Column).value.set_int32_value(RandomUniformInt<int32_t>());
+      }
+      if (RandomUniformInt(0, 9) != 0) {
+        row.AllocColumn(kInt64Column).value.set_int64_value(RandomUniformInt<int64_t>());
+      }
+      if (RandomUniformInt(0, 9) != 0) {
+        row.AllocColumn(kDoubleColumn).value.set_double_value(RandomUniformReal(-1e6, 1e6));
+      }
+      if (RandomUniformInt(0, 9) != 0) {
+        row.AllocColumn(kStringColumn).value.set_string_value(std::to_string(RandomUniformInt<uint32_t>()));
+      }
+    }
+  }
+
+  // Checks that batched aggregate produces exactly the same result as DocExprExecutor.
+  void CheckAggregate(const PgsqlExpressionPB& target) {
+    auto batched = PgsqlBatchedAggregate::Create(target);
+    ASSERT_NE(batched, nullptr) << target.ShortDebugString();
+
+    DocExprExecutor executor;
+    QLExprResult expected;
+    for (const auto& row : rows_) {
+      ASSERT_OK(batched->Add(row));
+      ASSERT_OK(executor.EvalExpr(target, row, expected.Writer()));
+    }
+    QLValue actual;
+    ASSERT_OK(batched->Complete(&actual));
+    ASSERT_EQ(expected.Value().ShortDebugString(), actual.value().ShortDebugString())
+        << target.ShortDebugString();
+  }
+
+  std::vector<QLTableRow> rows_;
+};
+
+TEST_F(PgsqlAggregateTest, MatchesRowByRowEvaluation) {
+  // Use size that is not a multiple of block size, so the last block is partial.
+  GenerateRows(kAggregateBlockSize * 3 + 17);
+
+  CheckAggregate(MakeCountStar());
+  for (auto column : {kInt32Column, kInt64Column, kDoubleColumn, kStringColumn}) {
+    CheckAggregate(MakeAggregate(bfpg::TSOpcode::kCount, column));
+    CheckAggregate(MakeAggregate(bfpg::TSOpcode::kMin, column));
+    CheckAggregate(MakeAggregate(bfpg::TSOpcode::kMax, column));
+  }
+  CheckAggregate(MakeAggregate(bfpg::TSOpcode::kSumInt32, kInt32Column));
+  CheckAggregate(MakeAggregate(bfpg::TSOpcode::kSumInt64, kInt64Column));
+  CheckAggregate(MakeAggregate(bfpg::TSOpcode::kSumDouble, kDoubleColumn));
+}
+
+TEST_F(PgsqlAggregateTest, EmptyInput) {
+  for (const auto& target : {MakeCountStar(),
+                             MakeAggregate(bfpg::TSOpcode::kSumInt64, kInt64Column),
+                             MakeAggregate(bfpg::TSOpcode::kMax, kStringColumn)}) {
+    auto batched = PgsqlBatchedAggregate::Create(target);
+    ASSERT_NE(batched, nullptr);
+    QLValue result;
+    ASSERT_OK(batched->Complete(&result));
+    ASSERT_TRUE(result.IsNull());
+  }
+}
+
+TEST_F(PgsqlAggregateTest, Unsupported) {
+  // Average and system columns are evaluated row by row.
+  ASSERT_EQ(PgsqlBatchedAggregate::Create(MakeAggregate(bfpg::TSOpcode::kAvg, kInt64Column)),
+            nullptr);
+  ASSERT_EQ(PgsqlBatchedAggregate::Create(MakeAggregate(bfpg::TSOpcode::kCount, -8)), nullptr);
+  PgsqlExpressionPB column_ref;
+  column_ref.set_column_id(kInt64Column);
+  ASSERT_EQ(PgsqlBatchedAggregate::Create(column_ref), nullptr);
+}
+
+TEST_F(PgsqlAggregateTest, Kernels) {
+  std::vector<int64_t> values = {5, -3, std::numeric_limits<int64_t>::max(), 7};
+  ASSERT_EQ(-3, MinBlock(values.data(), values.size()));
+  ASSERT_EQ(std::numeric_limits<int64_t>::max(), MaxBlock(values.data(), values.size()));
+  // Sum wraps around on overflow.
+  ASSERT_EQ(std::numeric_limits<int64_t>::min() + 8, SumBlock(values.data(), values.size()));
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,342 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/pgsql_aggregate.h"
+
+#include <array>
+
+#include <boost/optional.hpp>
+
+#include "yb/common/ql_expr.h"
+
+#include "yb/gutil/macros.h"
+
+#include "yb/util/bfpg/tserver_opcodes.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// Returns the value of the column referenced by operand in the row, or nullptr if it is NULL.
+const QLValuePB* GetNotNullColumn(const QLTableRow& row, ColumnIdRep column_id) {
+  const auto* value = row.GetColumn(column_id);
+  return value && !IsNull(*value) ? value : nullptr;
+}
+
+// COUNT of rows, or of non-NULL values of a column when column_id is specified.
+class CountAggregate : public PgsqlBatchedAggregate {
+ public:
+  explicit CountAggregate(boost::optional<ColumnIdRep> column_id) : column_id_(column_id) {}
+
+  CHECKED_STATUS Add(const QLTableRow& row) override {
+    if (!column_id_ || GetNotNullColumn(row, *column_id_)) {
+      ++count_;
+    }
+    return Status::OK();
+  }
+
+  CHECKED_STATUS Complete(QLValue* result) override {
+    if (count_ != 0) {
+      result->set_int64_value(count_);
+    }
+    return Status::OK();
+  }
+
+ private:
+  const boost::optional<ColumnIdRep> column_id_;
+  int64_t count_ = 0;
+};
+
+// Extracts integer value of any width as int64. Returns false if the value is not an integer.
+bool ExtractInt(const QLValuePB& value, int64_t* out) {
+  switch (value.value_case()) {
+    case QLValuePB::kInt8Value:
+      *out = value.int8_value();
+      return true;
+    case QLValuePB::kInt16Value:
+      *out = value.int16_value();
+      return true;
+    case QLValuePB::kInt32Value:
+      *out = value.int32_value();
+      return true;
+    case QLValuePB::kInt64Value:
+      *out = value.int64_value();
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Base class for aggregates that collect column values in blocks.
+template <class T>
+class BlockAggregate : public PgsqlBatchedAggregate {
+ public:
+  explicit BlockAggregate(ColumnIdRep column_id) : column_id_(column_id) {}
+
+  CHECKED_STATUS Add(const QLTableRow& row) override {
+    const auto* value = GetNotNullColumn(row, column_id_);
+    if (!value) {
+      return Status::OK();
+    }
+    RETURN_NOT_OK(Append(*value));
+    if (size_ == kAggregateBlockSize) {
+      FlushBlock();
+    }
+    return Status::OK();
+  }
+
+  CHECKED_STATUS Complete(QLValue* result) override {
+    FlushBlock();
+    return DoComplete(result);
+  }
+
+ protected:
+  void Push(T value) {
+    block_[size_++] = value;
+  }
+
+  virtual CHECKED_STATUS Append(const QLValuePB& value) = 0;
+  virtual void ProcessBlock(const T* values, size_t count) = 0;
+  virtual CHECKED_STATUS DoComplete(QLValue* result) = 0;
+
+ private:
+  void FlushBlock() {
+    if (size_ != 0) {
+      ProcessBlock(block_.data(), size_);
+      size_ = 0;
+    }
+  }
+
+  const ColumnIdRep column_id_;
+  std::array<T, kAggregateBlockSize> block_;
+  size_t size_ = 0;
+};
+
+// SUM of integer column, the result is always int64 as in DocExprExecutor::EvalSumInt.
+class SumIntAggregate : public BlockAggregate<int64_t> {
+ public:
+  using BlockAggregate::BlockAggregate;
+
+ protected:
+  CHECKED_STATUS Append(const QLValuePB& value) override {
+    int64_t int_value;
+    if (!ExtractInt(value, &int_value)) {
+      return STATUS_FORMAT(RuntimeError, "Cannot find SUM of value: $0", value.ShortDebugString());
+    }
+    Push(int_value);
+    return Status::OK();
+  }
+
+  void ProcessBlock(const int64_t* values, size_t count) override {
+    sum_ = static_cast<int64_t>(
+        static_cast<uint64_t>(sum_) + static_cast<uint64_t>(SumBlock(values, count)));
+    has_value_ = true;
+  }
+
+  CHECKED_STATUS DoComplete(QLValue* result) override {
+    if (has_value_) {
+      result->set_int64_value(sum_);
+    }
+    return Status::OK();
+  }
+
+ private:
+  int64_t sum_ = 0;
+  bool has_value_ = false;
+};
+
+template <class T>
+struct RealTraits;
+
+template <>
+struct RealTraits<float> {
+  static constexpr QLValuePB::ValueCase kValueCase = QLValuePB::kFloatValue;
+  static float Get(const QLValuePB& value) { return value.float_value(); }
+  static void Set(float value, QLValue* out) { out->set_float_value(value); }
+};
+
+template <>
+struct RealTraits<double> {
+  static constexpr QLValuePB::ValueCase kValueCase = QLValuePB::kDoubleValue;
+  static double Get(const QLValuePB& value) { return value.double_value(); }
+  static void Set(double value, QLValue* out) { out->set_double_value(value); }
+};
+
+// SUM of float or double column.
+template <class T>
+class SumRealAggregate : public BlockAggregate<T> {
+ public:
+  using BlockAggregate<T>::BlockAggregate;
+
+ protected:
+  CHECKED_STATUS Append(const QLValuePB& value) override {
+    if (value.value_case() != RealTraits<T>::kValueCase) {
+      return STATUS_FORMAT(RuntimeError, "Cannot find SUM of value: $0", value.ShortDebugString());
+    }
+    this->Push(RealTraits<T>::Get(value));
+    return Status::OK();
+  }
+
+  void ProcessBlock(const T* values, size_t count) override {
+    // The first value is used as is, as in DocExprExecutor::EvalSumReal, to preserve its sign if
+    // it is zero.
+    if (!has_value_) {
+      sum_ = values[0];
+      ++values;
+      --count;
+      has_value_ = true;
+    }
+    sum_ = SumBlockInOrder(sum_, values, count);
+  }
+
+  CHECKED_STATUS DoComplete(QLValue* result) override {
+    if (has_value_) {
+      RealTraits<T>::Set(sum_, result);
+    }
+    return Status::OK();
+  }
+
+ private:
+  T sum_ = 0;
+  bool has_value_ = false;
+};
+
+// MIN or MAX of a column. Integer values are aggregated in blocks, values of other types are
+// compared one by one in the same way as DocExprExecutor::EvalMin and EvalMax do.
+template <bool kIsMax>
+class MinMaxAggregate : public BlockAggregate<int64_t> {
+ public:
+  using BlockAggregate::BlockAggregate;
+
+ protected:
+  CHECKED_STATUS Append(const QLValuePB& value) override {
+    int64_t int_value;
+    if (generic_result_.IsNull() && ExtractInt(value, &int_value)) {
+      if (value_case_ == QLValuePB::VALUE_NOT_SET) {
+        value_case_ = value.value_case();
+      }
+      if (value_case_ == value.value_case()) {
+        Push(int_value);
+        return Status::OK();
+      }
+    }
+    if (kIsMax ? (generic_result_.IsNull() || generic_result_.value() < value)
+               : (generic_result_.IsNull() || generic_result_.value() > value)) {
+      generic_result_ = value;
+    }
+    return Status::OK();
+  }
+
+  void ProcessBlock(const int64_t* values, size_t count) override {
+    auto block_result = kIsMax ? MaxBlock(values, count) : MinBlock(values, count);
+    if (!has_int_value_) {
+      int_result_ = block_result;
+      has_int_value_ = true;
+    } else {
+      int_result_ = kIsMax ? std::max(int_result_, block_result)
+                           : std::min(int_result_, block_result);
+    }
+  }
+
+  CHECKED_STATUS DoComplete(QLValue* result) override {
+    if (has_int_value_) {
+      SCHECK(generic_result_.IsNull(), RuntimeError, "Cannot compare values of different types");
+      switch (value_case_) {
+        case QLValuePB::kInt8Value:
+          result->set_int8_value(static_cast<int8_t>(int_result_));
+          break;
+        case QLValuePB::kInt16Value:
+          result->set_int16_value(static_cast<int16_t>(int_result_));
+          break;
+        case QLValuePB::kInt32Value:
+          result->set_int32_value(static_cast<int32_t>(int_result_));
+          break;
+        default:
+          result->set_int64_value(int_result_);
+          break;
+      }
+    } else if (!generic_result_.IsNull()) {
+      *result = generic_result_;
+    }
+    return Status::OK();
+  }
+
+ private:
+  QLValuePB::ValueCase value_case_ = QLValuePB::VALUE_NOT_SET;
+  int64_t int_result_ = 0;
+  bool has_int_value_ = false;
+  QLValue generic_result_;
+};
+
+} // namespace
+
+std::unique_ptr<PgsqlBatchedAggregate> PgsqlBatchedAggregate::Create(
+    const PgsqlExpressionPB& target) {
+  if (!target.has_tscall() || target.tscall().operands_size() != 1) {
+    return nullptr;
+  }
+  const auto& operand = target.tscall().operands(0);
+  boost::optional<ColumnIdRep> column_id;
+  if (operand.has_column_id()) {
+    if (operand.column_id() < 0) {
+      // System columns are evaluated by DocExprExecutor.
+      return nullptr;
+    }
+    column_id = operand.column_id();
+  }
+
+  switch (static_cast<bfpg::TSOpcode>(target.tscall().opcode())) {
+    case bfpg::TSOpcode::kCount:
+      if (column_id) {
+        return std::make_unique<CountAggregate>(column_id);
+      }
+      if (operand.has_value() && !QLValue::IsNull(operand.value())) {
+        return std::make_unique<CountAggregate>(boost::none);
+      }
+      return nullptr;
+    case bfpg::TSOpcode::kSumInt8: FALLTHROUGH_INTENDED;
+    case bfpg::TSOpcode::kSumInt16: FALLTHROUGH_INTENDED;
+    case bfpg::TSOpcode::kSumInt32: FALLTHROUGH_INTENDED;
+    case bfpg::TSOpcode::kSumInt64:
+      if (column_id) {
+        return std::make_unique<SumIntAggregate>(*column_id);
+      }
+      return nullptr;
+    case bfpg::TSOpcode::kSumFloat:
+      if (column_id) {
+        return std::make_unique<SumRealAggregate<float>>(*column_id);
+      }
+      return nullptr;
+    case bfpg::TSOpcode::kSumDouble:
+      if (column_id) {
+        return std::make_unique<SumRealAggregate<double>>(*column_id);
+      }
+      return nullptr;
+    case bfpg::TSOpcode::kMin:
+      if (column_id) {
+        return std::make_unique<MinMaxAggregate<false>>(*column_id);
+      }
+      return nullptr;
+    case bfpg::TSOpcode::kMax:
+      if (column_id) {
+        return std::make_unique<MinMaxAggregate<true>>(*column_id);
+      }
+      return nullptr;
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace docdb
+}  // namespace yb
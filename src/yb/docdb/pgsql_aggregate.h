@@ -0,0 +1,96 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_PGSQL_AGGREGATE_H_
+#define YB_DOCDB_PGSQL_AGGREGATE_H_
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include "yb/common/pgsql_protocol.pb.h"
+#include "yb/common/ql_value.h"
+
+#include "yb/util/status.h"
+
+namespace yb {
+
+class QLTableRow;
+
+namespace docdb {
+
+// Number of column values collected before an aggregate kernel is run over them.
+constexpr size_t kAggregateBlockSize = 1024;
+
+// Typed kernels over a block of non-NULL column values. They are written as plain loops over
+// arrays, so the compiler is able to vectorize them.
+
+// Integer sum uses wrap-around arithmetic, so the result does not depend on the order in which
+// values are added.
+inline int64_t SumBlock(const int64_t* values, size_t count) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i != count; ++i) {
+    sum += static_cast<uint64_t>(values[i]);
+  }
+  return static_cast<int64_t>(sum);
+}
+
+inline int64_t MinBlock(const int64_t* values, size_t count) {
+  int64_t result = std::numeric_limits<int64_t>::max();
+  for (size_t i = 0; i != count; ++i) {
+    result = std::min(result, values[i]);
+  }
+  return result;
+}
+
+inline int64_t MaxBlock(const int64_t* values, size_t count) {
+  int64_t result = std::numeric_limits<int64_t>::min();
+  for (size_t i = 0; i != count; ++i) {
+    result = std::max(result, values[i]);
+  }
+  return result;
+}
+
+// Floating point sum is accumulated in the row order, to produce exactly the same result as the
+// row by row evaluation in DocExprExecutor::EvalSumReal.
+template <class T>
+T SumBlockInOrder(T initial, const T* values, size_t count) {
+  T sum = initial;
+  for (size_t i = 0; i != count; ++i) {
+    sum += values[i];
+  }
+  return sum;
+}
+
+// Evaluates one COUNT, SUM, MIN or MAX target of a YSQL aggregate pushdown request over all rows
+// of the scan, bypassing the generic QLExprExecutor. Per row it only extracts the column value
+// from the row and appends it to the current block.
+class PgsqlBatchedAggregate {
+ public:
+  virtual ~PgsqlBatchedAggregate() = default;
+
+  // Returns nullptr if the target could not be evaluated by a batched aggregate, so it should be
+  // evaluated by DocExprExecutor.
+  static std::unique_ptr<PgsqlBatchedAggregate> Create(const PgsqlExpressionPB& target);
+
+  virtual CHECKED_STATUS Add(const QLTableRow& row) = 0;
+
+  // Stores the aggregated value to the result, using the same representation as
+  // DocExprExecutor. Result is left untouched (NULL) when no non-NULL value was aggregated.
+  virtual CHECKED_STATUS Complete(QLValue* result) = 0;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_PGSQL_AGGREGATE_H_
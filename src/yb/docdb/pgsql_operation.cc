@@ -14,6 +14,8 @@
 #include "yb/docdb/pgsql_operation.h"
 
 #include <limits>
+#include <numeric>
+#include <queue>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -30,9 +32,15 @@
 #include "yb/docdb/docdb_debug.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/packed_row.h"
+#include "yb/docdb/pgsql_aggregate.h"
 #include "yb/docdb/primitive_value_util.h"
 
+#include "yb/rocksdb/perf_context.h"
+
+#include "yb/util/coding.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/random_util.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/trace.h"
 
@@ -50,6 +58,20 @@ DEFINE_bool(pgsql_consistent_transactional_paging, true,
             "be stale. The latter is preferable for long scans. The data returned for the first "
             "page of results is never stale regardless of this flag.");
 
+DEFINE_bool(ysql_enable_batched_aggregates, true,
+            "Whether to evaluate COUNT, SUM, MIN and MAX of pushed down YSQL aggregates over blocks "
+            "of column values, instead of evaluating a generic expression per row.");
+
+DEFINE_bool(ysql_enable_sorted_batch_ybctid_lookup, true,
+            "Whether to look up a batch of ybctids in key order through a single iterator, instead "
+            "of creating an iterator per ybctid.");
+
+DEFINE_bool(ysql_enable_packed_row, false,
+            "Whether YSQL inserts store all non-key columns of a row in a single packed value, "
+            "instead of a key/value pair per column.");
+TAG_FLAG(ysql_enable_packed_row, advanced);
+TAG_FLAG(ysql_enable_packed_row, runtime);
+
 DEFINE_test_flag(int32, slowdown_pgsql_aggregate_read_ms, 0,
                  "If set > 0, slows down the response to pgsql aggregate read by this amount.");
 
@@ -185,6 +207,11 @@ Status PgsqlWriteOperation::Init(PgsqlWriteRequestPB* request, PgsqlResponsePB*
 
   doc_key_ = VERIFY_RESULT(FetchDocKey(schema_, request_));
   encoded_doc_key_ = doc_key_->EncodeAsRefCntPrefix();
+  // Upserts keep the columns they do not specify, so only inserts replace the row with a packed
+  // one. Backfill writes rows in the past, so they are not packed either.
+  pack_row_ = FLAGS_ysql_enable_packed_row &&
+              request_.stmt_type() == PgsqlWriteRequestPB::PGSQL_INSERT &&
+              !request_.is_backfill();
 
   return Status::OK();
 }
@@ -368,10 +395,16 @@ Status PgsqlWriteOperation::ApplyInsert(const DocOperationApplyData& data, IsUps
     }
   }
 
-  RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
-      DocPath(encoded_doc_key_.as_slice(), PrimitiveValue::kLivenessColumn),
-      Value(PrimitiveValue()),
-      data.read_time, data.deadline, request_.stmt_id()));
+  boost::optional<RowPacker> packer;
+  if (pack_row_) {
+    // The packed row implies existence of the row, so the liveness column is not written.
+    packer.emplace(request_.schema_version());
+  } else {
+    RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+        DocPath(encoded_doc_key_.as_slice(), PrimitiveValue::kLivenessColumn),
+        Value(PrimitiveValue()),
+        data.read_time, data.deadline, request_.stmt_id()));
+  }
 
   for (const auto& column_value : request_.column_values()) {
     // Get the column.
@@ -391,12 +424,26 @@ Status PgsqlWriteOperation::ApplyInsert(const DocOperationApplyData& data, IsUps
     const SubDocument sub_doc =
         SubDocument::FromQLValuePB(expr_result.Value(), column.sorting_type());
 
+    if (packer) {
+      if (IsCollectionType(sub_doc.value_type())) {
+        return STATUS_FORMAT(
+            NotSupported, "Collection value of column $0 could not be packed", column_id);
+      }
+      RETURN_NOT_OK(packer->AddValue(column_id, sub_doc));
+      continue;
+    }
+
     // Inserting into specified column.
     DocPath sub_path(encoded_doc_key_.as_slice(), PrimitiveValue(column_id));
     RETURN_NOT_OK(data.doc_write_batch->InsertSubDocument(
         sub_path, sub_doc, data.read_time, data.deadline, request_.stmt_id()));
   }
 
+  if (packer) {
+    RETURN_NOT_OK(data.doc_write_batch->SetPackedRow(
+        encoded_doc_key_.as_slice(), VERIFY_RESULT(packer->Complete())));
+  }
+
   RETURN_NOT_OK(PopulateResultSet(table_row));
 
   response_->set_status(PgsqlResponsePB::PGSQL_STATUS_OK);
@@ -603,7 +650,8 @@ Status PgsqlWriteOperation::GetDocPaths(GetDocPathsMode mode,
   *level = RequireReadSnapshot() ? IsolationLevel::SNAPSHOT_ISOLATION
                                  : IsolationLevel::SERIALIZABLE_ISOLATION;
 
-  if (mode == GetDocPathsMode::kIntents) {
+  // The packed row is written at the document key, so it is locked as a whole.
+  if (mode == GetDocPathsMode::kIntents && !pack_row_) {
     const google::protobuf::RepeatedPtrField<PgsqlColumnValuePB>* column_values = nullptr;
     if (request_.stmt_type() == PgsqlWriteRequestPB::PGSQL_INSERT ||
         request_.stmt_type() == PgsqlWriteRequestPB::PGSQL_UPSERT) {
@@ -637,6 +685,13 @@ Status PgsqlWriteOperation::GetDocPaths(GetDocPathsMode mode,
 
 //--------------------------------------------------------------------------------------------------
 
+PgsqlReadOperation::PgsqlReadOperation(const PgsqlReadRequestPB& request,
+                                       const TransactionOperationContextOpt& txn_op_context)
+    : request_(request), txn_op_context_(txn_op_context) {
+}
+
+PgsqlReadOperation::~PgsqlReadOperation() = default;
+
 Result<size_t> PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storage,
                                            CoarseTimePoint deadline,
                                            const ReadHybridTime& read_time,
@@ -653,6 +708,13 @@ Result<size_t> PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storag
   });
   VLOG(4) << "Read, read time: " << read_time << ", txn: " << txn_op_context_;
 
+  // RocksDB counts the work of this thread in perf_context, so the stats of the request are the
+  // difference of the counters before and after the execution.
+  const bool collect_stats = request_.collect_execution_stats();
+  const rocksdb::PerfContext perf_start = collect_stats ? rocksdb::perf_context
+                                                        : rocksdb::PerfContext();
+  const MonoTime start_time = collect_stats ? MonoTime::Now() : MonoTime();
+
   // Fetching data.
   bool has_paging_state = false;
   if (request_.batch_arguments_size() > 0) {
@@ -670,6 +732,20 @@ Result<size_t> PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storag
 
   VTRACE(1, "Fetched $0 rows. $1 paging state", fetched_rows, (has_paging_state ? "No" : "Has"));
   *restart_read_ht = table_iter_->RestartReadHt();
+
+  if (collect_stats) {
+    const auto& perf = rocksdb::perf_context;
+    auto* stats = response_.mutable_execution_stats();
+    stats->set_rows_examined(examined_rows_);
+    stats->set_rows_returned(fetched_rows);
+    stats->set_rocksdb_seeks(perf.iter_seek_count - perf_start.iter_seek_count);
+    stats->set_rocksdb_nexts(perf.iter_next_count - perf_start.iter_next_count);
+    stats->set_rocksdb_prevs(perf.iter_prev_count - perf_start.iter_prev_count);
+    stats->set_block_cache_hits(perf.block_cache_hit_count - perf_start.block_cache_hit_count);
+    stats->set_block_reads(perf.block_read_count - perf_start.block_read_count);
+    stats->set_block_read_bytes(perf.block_read_byte - perf_start.block_read_byte);
+    stats->set_execution_time_us(MonoTime::Now().GetDeltaSince(start_time).ToMicroseconds());
+  }
   return fetched_rows;
 }
 
@@ -729,11 +805,32 @@ Result<size_t> PgsqlReadOperation::ExecuteScalar(const common::YQLStorageIf& ql_
   // Set scan start time.
   bool scan_time_exceeded = false;
 
+  // Rows of non-aggregate scans are accumulated in columnar layout when requested, and are
+  // appended to the result buffer once the scan is complete.
+  const bool sampling = request_.has_sampling_state();
+  std::unique_ptr<pggate::PgDocColumnarWriter> columnar_writer;
+  if (request_.columnar_result() && !request_.is_aggregate() && !sampling) {
+    columnar_writer = std::make_unique<pggate::PgDocColumnarWriter>(request_.targets().size());
+  }
+
+  // Stop when the rows data reaches the requested size, so a page of wide rows does not
+  // produce an oversized response.
+  const size_t size_limit = request_.is_aggregate() ? 0 : request_.size_limit();
+  const bool grouped_aggregate = request_.is_aggregate() && request_.group_by_exprs_size() > 0;
+  const size_t result_start_size = result_buffer->size();
+  bool size_limit_exceeded = false;
+
+  // Keys of the rows returned by a sampling request, the highest on top.
+  std::priority_queue<double> sample_keys;
+  const size_t targrows = sampling ? std::max(request_.sampling_state().targrows(), 1) : 0;
+  const double key_threshold = sampling ? request_.sampling_state().key_threshold() : 0;
+  uint64_t sample_scanned_rows = 0;
+
   // Fetching data.
   int match_count = 0;
   QLTableRow row;
   while (fetched_rows < row_count_limit && VERIFY_RESULT(iter->HasNext()) &&
-         !scan_time_exceeded) {
+         !scan_time_exceeded && !size_limit_exceeded) {
     row.Clear();
 
     // If there is an index request, fetch ybbasectid from the index and use it as ybctid
@@ -754,19 +851,39 @@ Result<size_t> PgsqlReadOperation::ExecuteScalar(const common::YQLStorageIf& ql_
     }
 
     // Match the row with the where condition before adding to the row block.
-    bool is_match = true;
-    if (request_.has_where_expr()) {
-      QLExprResult match;
-      RETURN_NOT_OK(EvalExpr(request_.where_expr(), row, match.Writer()));
-      is_match = match.Value().bool_value();
-    }
-    if (is_match) {
+    if (VERIFY_RESULT(MatchesWhereExpr(row, schema))) {
       match_count++;
-      if (request_.is_aggregate()) {
+      if (sampling) {
+        ++sample_scanned_rows;
+        // Rows with higher keys than targrows rows returned already can't be in the sample.
+        const auto key = RandomUniformReal<double>();
+        if (key < key_threshold && (sample_keys.size() < targrows || key < sample_keys.top())) {
+          sample_keys.push(key);
+          if (sample_keys.size() > targrows) {
+            sample_keys.pop();
+          }
+          response_.add_sample_keys(key);
+          RETURN_NOT_OK(PopulateResultSet(row, result_buffer));
+          ++fetched_rows;
+          size_limit_exceeded =
+              size_limit != 0 && result_buffer->size() - result_start_size >= size_limit;
+        }
+      } else if (grouped_aggregate) {
+        RETURN_NOT_OK(EvalGroupedAggregate(row));
+        // Return partial aggregates of the groups found so far, the client combines partial
+        // aggregates of the same group from different pages.
+        size_limit_exceeded = aggregate_groups_.size() >= row_count_limit;
+      } else if (request_.is_aggregate()) {
         RETURN_NOT_OK(EvalAggregate(row));
+      } else if (columnar_writer) {
+        RETURN_NOT_OK(PopulateResultSet(row, columnar_writer.get()));
+        ++fetched_rows;
+        size_limit_exceeded = size_limit != 0 && columnar_writer->data_size() >= size_limit;
       } else {
         RETURN_NOT_OK(PopulateResultSet(row, result_buffer));
         ++fetched_rows;
+        size_limit_exceeded =
+            size_limit != 0 && result_buffer->size() - result_start_size >= size_limit;
       }
     }
 
@@ -776,19 +893,31 @@ Result<size_t> PgsqlReadOperation::ExecuteScalar(const common::YQLStorageIf& ql_
     }
   }
 
-  if (request_.is_aggregate() && match_count > 0) {
+  if (sampling) {
+    response_.set_sample_scanned_rows(sample_scanned_rows);
+  }
+
+  if (grouped_aggregate) {
+    RETURN_NOT_OK(PopulateGroupedAggregates(result_buffer));
+    fetched_rows = aggregate_groups_.size();
+  } else if (request_.is_aggregate() && match_count > 0) {
     RETURN_NOT_OK(PopulateAggregate(row, result_buffer));
     ++fetched_rows;
   }
 
+  if (columnar_writer) {
+    columnar_writer->Serialize(result_buffer);
+    response_.set_columnar_rows_data(true);
+  }
+
   if (PREDICT_FALSE(FLAGS_TEST_slowdown_pgsql_aggregate_read_ms > 0) && request_.is_aggregate()) {
     TRACE("Sleeping for $0 ms", FLAGS_TEST_slowdown_pgsql_aggregate_read_ms);
     SleepFor(MonoDelta::FromMilliseconds(FLAGS_TEST_slowdown_pgsql_aggregate_read_ms));
   }
 
   RETURN_NOT_OK(SetPagingStateIfNecessary(
-      iter, fetched_rows, row_count_limit, scan_time_exceeded, scan_schema,
-      read_time, has_paging_state));
+      iter, fetched_rows, row_count_limit, scan_time_exceeded || size_limit_exceeded,
+      scan_schema, read_time, has_paging_state));
   return fetched_rows;
 }
 
@@ -802,6 +931,13 @@ Result<size_t> PgsqlReadOperation::ExecuteBatchYbctid(const common::YQLStorageIf
   Schema projection;
   RETURN_NOT_OK(CreateProjection(schema, request_.column_refs(), &projection));
 
+  const auto& batch_arguments = request_.batch_arguments();
+  if (FLAGS_ysql_enable_sorted_batch_ybctid_lookup && batch_arguments.size() > 1) {
+    return ExecuteSortedBatchYbctid(
+        ql_storage, deadline, read_time, schema, projection, unknown_ybctid_allowed,
+        result_buffer);
+  }
+
   QLTableRow row;
   size_t row_count = 0;
   for (const PgsqlBatchArgumentPB& batch_argument : request_.batch_arguments()) {
@@ -819,6 +955,9 @@ Result<size_t> PgsqlReadOperation::ExecuteBatchYbctid(const common::YQLStorageIf
       }
     }
     RETURN_NOT_OK(table_iter_->NextRow(projection, &row));
+    if (!VERIFY_RESULT(MatchesWhereExpr(row, schema))) {
+      continue;
+    }
 
     // Populate result set.
     RETURN_NOT_OK(PopulateResultSet(row, result_buffer));
@@ -832,6 +971,98 @@ Result<size_t> PgsqlReadOperation::ExecuteBatchYbctid(const common::YQLStorageIf
   return row_count;
 }
 
+Result<size_t> PgsqlReadOperation::ExecuteSortedBatchYbctid(
+    const common::YQLStorageIf& ql_storage,
+    CoarseTimePoint deadline,
+    const ReadHybridTime& read_time,
+    const Schema& schema,
+    const Schema& projection,
+    bool unknown_ybctid_allowed,
+    faststring *result_buffer) {
+  const auto& batch_arguments = request_.batch_arguments();
+  auto ybctid = [&batch_arguments](int idx) {
+    return Slice(batch_arguments.Get(idx).ybctid().value().binary_value());
+  };
+
+  // Rows are looked up in key order, so all of them are read from the same version of the table
+  // files and consecutive lookups reuse data blocks. But they should be returned in the order
+  // of batch arguments.
+  std::vector<int> order(batch_arguments.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&ybctid](int lhs, int rhs) {
+    return ybctid(lhs).compare(ybctid(rhs)) < 0;
+  });
+
+  // Unique ybctids in key order, and index of ybctid for each batch argument.
+  std::vector<Slice> ybctids;
+  ybctids.reserve(order.size());
+  std::vector<size_t> ybctid_indexes(order.size());
+  for (int idx : order) {
+    if (ybctids.empty() || ybctids.back() != ybctid(idx)) {
+      ybctids.push_back(ybctid(idx));
+    }
+    ybctid_indexes[idx] = ybctids.size() - 1;
+  }
+
+  RETURN_NOT_OK(ql_storage.GetIterator(request_.stmt_id(), projection, schema, txn_op_context_,
+                                       deadline, read_time, ybctids, &table_iter_));
+
+  // Location of the populated row for each ybctid in rows_buffer.
+  constexpr size_t kNotFound = std::numeric_limits<size_t>::max();
+  constexpr size_t kFilteredOut = kNotFound - 1;
+  std::vector<std::pair<size_t, size_t>> row_locations(ybctids.size(), {kNotFound, 0});
+  faststring rows_buffer;
+  QLTableRow row;
+  size_t ybctid_index = 0;
+  while (VERIFY_RESULT(table_iter_->HasNext())) {
+    row.Clear();
+    RETURN_NOT_OK(table_iter_->NextRow(projection, &row));
+    const Slice tuple_id = VERIFY_RESULT(table_iter_->GetTupleId());
+    while (ybctid_index < ybctids.size() && ybctids[ybctid_index] != tuple_id) {
+      ++ybctid_index;
+    }
+    SCHECK_FORMAT(ybctid_index < ybctids.size(), IllegalState,
+                  "Row $0 does not match any requested ybctid", tuple_id.ToDebugHexString());
+    if (!VERIFY_RESULT(MatchesWhereExpr(row, schema))) {
+      row_locations[ybctid_index++] = {kFilteredOut, 0};
+      continue;
+    }
+    const size_t start = rows_buffer.size();
+    RETURN_NOT_OK(PopulateResultSet(row, &rows_buffer));
+    row_locations[ybctid_index++] = {start, rows_buffer.size() - start};
+  }
+
+  size_t row_count = 0;
+  for (size_t idx : ybctid_indexes) {
+    const auto& location = row_locations[idx];
+    if (location.first == kFilteredOut) {
+      continue;
+    }
+    if (location.first == kNotFound) {
+      if (unknown_ybctid_allowed) {
+        continue;
+      }
+      return STATUS(Corruption, "Given ybctid is not associated with any row in table");
+    }
+    result_buffer->append(rows_buffer.data() + location.first, location.second);
+    row_count++;
+  }
+
+  response_.set_batch_arg_count(batch_arguments.size());
+
+  return row_count;
+}
+
+Result<bool> PgsqlReadOperation::MatchesWhereExpr(const QLTableRow& row, const Schema& schema) {
+  ++examined_rows_;
+  if (!request_.has_where_expr()) {
+    return true;
+  }
+  QLExprResult match;
+  RETURN_NOT_OK(EvalExpr(request_.where_expr(), row, match.Writer(), &schema));
+  return match.Value().bool_value();
+}
+
 Status PgsqlReadOperation::SetPagingStateIfNecessary(const common::YQLRowwiseIteratorIf* iter,
                                                      size_t fetched_rows,
                                                      const size_t row_count_limit,
@@ -890,6 +1121,17 @@ Status PgsqlReadOperation::PopulateResultSet(const QLTableRow& table_row,
   return Status::OK();
 }
 
+Status PgsqlReadOperation::PopulateResultSet(const QLTableRow& table_row,
+                                             pggate::PgDocColumnarWriter *columnar_writer) {
+  QLExprResult result;
+  for (const PgsqlExpressionPB& expr : request_.targets()) {
+    RETURN_NOT_OK(EvalExpr(expr, table_row, result.Writer()));
+    RETURN_NOT_OK(columnar_writer->WriteColumn(result.Value()));
+  }
+  columnar_writer->FinishRow();
+  return Status::OK();
+}
+
 Status PgsqlReadOperation::GetTupleId(QLValue *result) const {
   // Get row key and save to QLValue.
   // TODO(neil) Check if we need to append a table_id and other info to TupleID. For example, we
@@ -904,10 +1146,21 @@ Status PgsqlReadOperation::EvalAggregate(const QLTableRow& table_row) {
   if (aggr_result_.empty()) {
     int column_count = request_.targets().size();
     aggr_result_.resize(column_count);
+    // Batched aggregates accumulate the whole scan, so they are not used for grouped aggregates.
+    if (FLAGS_ysql_enable_batched_aggregates && request_.group_by_exprs().empty()) {
+      batched_aggregates_.reserve(column_count);
+      for (const PgsqlExpressionPB& expr : request_.targets()) {
+        batched_aggregates_.push_back(PgsqlBatchedAggregate::Create(expr));
+      }
+    }
   }
 
   int aggr_index = 0;
   for (const PgsqlExpressionPB& expr : request_.targets()) {
+    if (!batched_aggregates_.empty() && batched_aggregates_[aggr_index]) {
+      RETURN_NOT_OK(batched_aggregates_[aggr_index++]->Add(table_row));
+      continue;
+    }
     RETURN_NOT_OK(EvalExpr(expr, table_row, aggr_result_[aggr_index++].Writer()));
   }
   return Status::OK();
@@ -916,12 +1169,58 @@ Status PgsqlReadOperation::EvalAggregate(const QLTableRow& table_row) {
 Status PgsqlReadOperation::PopulateAggregate(const QLTableRow& table_row,
                                              faststring *result_buffer) {
   int column_count = request_.targets().size();
+  for (size_t i = 0; i != batched_aggregates_.size(); ++i) {
+    if (batched_aggregates_[i]) {
+      RETURN_NOT_OK(batched_aggregates_[i]->Complete(&aggr_result_[i].ForceNewValue()));
+    }
+  }
   for (int rscol_index = 0; rscol_index < column_count; rscol_index++) {
     RETURN_NOT_OK(pggate::WriteColumn(aggr_result_[rscol_index].Value(), result_buffer));
   }
   return Status::OK();
 }
 
+Status PgsqlReadOperation::EvalGroupedAggregate(const QLTableRow& table_row) {
+  faststring group_key;
+  std::vector<QLValuePB> group_values(request_.group_by_exprs().size());
+  auto value_it = group_values.begin();
+  for (const PgsqlExpressionPB& expr : request_.group_by_exprs()) {
+    QLExprResult value;
+    RETURN_NOT_OK(EvalExpr(expr, table_row, value.Writer()));
+    value.MoveTo(&*value_it);
+    // Values are length prefixed, so NULL does not make keys of different groups equal.
+    const std::string encoded_value = value_it->SerializeAsString();
+    PutVarint32(&group_key, static_cast<uint32_t>(encoded_value.size()));
+    group_key.append(encoded_value);
+    ++value_it;
+  }
+
+  std::string key = group_key.ToString();
+  auto it = aggregate_groups_.find(key);
+  if (it == aggregate_groups_.end()) {
+    it = aggregate_groups_.emplace(std::move(key), AggregateGroup()).first;
+    it->second.group_values = std::move(group_values);
+  }
+
+  // Evaluate aggregates over the results of the group.
+  aggr_result_.swap(it->second.aggr_result);
+  auto status = EvalAggregate(table_row);
+  aggr_result_.swap(it->second.aggr_result);
+  return status;
+}
+
+Status PgsqlReadOperation::PopulateGroupedAggregates(faststring *result_buffer) {
+  for (const auto& group : aggregate_groups_) {
+    for (const QLExprResult& aggr_result : group.second.aggr_result) {
+      RETURN_NOT_OK(pggate::WriteColumn(aggr_result.Value(), result_buffer));
+    }
+    for (const QLValuePB& group_value : group.second.group_values) {
+      RETURN_NOT_OK(pggate::WriteColumn(group_value, result_buffer));
+    }
+  }
+  return Status::OK();
+}
+
 Status PgsqlReadOperation::GetIntents(const Schema& schema, KeyValueWriteBatchPB* out) {
   if (request_.batch_arguments_size() > 0 && request_.has_ybctid_column_value()) {
     for (const auto& batch_argument : request_.batch_arguments()) {
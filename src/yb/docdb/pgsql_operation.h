@@ -14,6 +14,9 @@
 #ifndef YB_DOCDB_PGSQL_OPERATION_H
 #define YB_DOCDB_PGSQL_OPERATION_H
 
+#include <string>
+#include <unordered_map>
+
 #include "yb/common/ql_rowwise_iterator_interface.h"
 
 #include "yb/docdb/doc_expr.h"
@@ -31,8 +34,16 @@ class YQLStorageIf;
 
 }
 
+namespace pggate {
+
+class PgDocColumnarWriter;
+
+}
+
 namespace docdb {
 
+class PgsqlBatchedAggregate;
+
 YB_STRONGLY_TYPED_BOOL(IsUpsert);
 
 class PgsqlWriteOperation :
@@ -120,6 +131,10 @@ class PgsqlWriteOperation :
   boost::optional<DocKey> doc_key_;
   RefCntPrefix encoded_doc_key_;
 
+  // Whether the insert writes a packed row instead of a key/value pair per column, see
+  // packed_row.h.
+  bool pack_row_ = false;
+
   // Rows result requested.
   int64_t result_rows_ = 0;
   faststring result_buffer_;
@@ -129,9 +144,9 @@ class PgsqlReadOperation : public DocExprExecutor {
  public:
   // Construct and access methods.
   PgsqlReadOperation(const PgsqlReadRequestPB& request,
-                     const TransactionOperationContextOpt& txn_op_context)
-      : request_(request), txn_op_context_(txn_op_context) {
-  }
+                     const TransactionOperationContextOpt& txn_op_context);
+
+  ~PgsqlReadOperation();
 
   const PgsqlReadRequestPB& request() const { return request_; }
   PgsqlResponsePB& response() { return response_; }
@@ -181,14 +196,38 @@ class PgsqlReadOperation : public DocExprExecutor {
                                     faststring *result_buffer,
                                     HybridTime *restart_read_ht);
 
+  // Execute a READ operator for a given batch of ybctids, looking them up in key order through
+  // a single iterator.
+  Result<size_t> ExecuteSortedBatchYbctid(const common::YQLStorageIf& ql_storage,
+                                          CoarseTimePoint deadline,
+                                          const ReadHybridTime& read_time,
+                                          const Schema& schema,
+                                          const Schema& projection,
+                                          bool unknown_ybctid_allowed,
+                                          faststring *result_buffer);
+
   CHECKED_STATUS PopulateResultSet(const QLTableRow& table_row,
                                    faststring *result_buffer);
 
+  // The same as above, but accumulates the row in columnar layout.
+  CHECKED_STATUS PopulateResultSet(const QLTableRow& table_row,
+                                   pggate::PgDocColumnarWriter *columnar_writer);
+
   CHECKED_STATUS EvalAggregate(const QLTableRow& table_row);
 
   CHECKED_STATUS PopulateAggregate(const QLTableRow& table_row,
                                    faststring *result_buffer);
 
+  // Evaluates aggregate targets for the group of the row, by values of group_by_exprs.
+  CHECKED_STATUS EvalGroupedAggregate(const QLTableRow& table_row);
+
+  // Writes a row per group: partial aggregates followed by the values of group_by_exprs.
+  CHECKED_STATUS PopulateGroupedAggregates(faststring *result_buffer);
+
+  // Returns true if the row satisfies where_expr of the request, or there is no where_expr.
+  // Rows that do not satisfy it are not returned to the client. Counts the examined rows.
+  Result<bool> MatchesWhereExpr(const QLTableRow& row, const Schema& schema);
+
   // Checks whether we have processed enough rows for a page and sets the appropriate paging
   // state in the response object.
   CHECKED_STATUS SetPagingStateIfNecessary(const common::YQLRowwiseIteratorIf* iter,
@@ -205,6 +244,17 @@ class PgsqlReadOperation : public DocExprExecutor {
   PgsqlResponsePB response_;
   common::YQLRowwiseIteratorIf::UniPtr table_iter_;
   common::YQLRowwiseIteratorIf::UniPtr index_iter_;
+  // Number of rows read from DocDB and matched against where_expr, for execution stats.
+  uint64_t examined_rows_ = 0;
+  // Batched evaluators of aggregate targets, nullptr for targets that are evaluated row by row.
+  std::vector<std::unique_ptr<PgsqlBatchedAggregate>> batched_aggregates_;
+
+  struct AggregateGroup {
+    std::vector<QLValuePB> group_values;
+    std::vector<QLExprResult> aggr_result;
+  };
+  // Groups of grouped aggregate request, by encoded values of group_by_exprs.
+  std::unordered_map<std::string, AggregateGroup> aggregate_groups_;
 };
 
 }  // namespace docdb
@@ -67,6 +67,7 @@ using yb::util::DecodeDoubleFromKey;
     case ValueType::kMergeFlags: FALLTHROUGH_INTENDED; \
     case ValueType::kObject: FALLTHROUGH_INTENDED; \
     case ValueType::kObsoleteIntentPrefix: FALLTHROUGH_INTENDED; \
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED; \
     case ValueType::kRedisList: FALLTHROUGH_INTENDED;            \
     case ValueType::kRedisSet: FALLTHROUGH_INTENDED; \
     case ValueType::kRedisSortedSet: FALLTHROUGH_INTENDED;  \
@@ -74,6 +75,7 @@ using yb::util::DecodeDoubleFromKey;
     case ValueType::kRowLock: FALLTHROUGH_INTENDED; \
     case ValueType::kTombstone: FALLTHROUGH_INTENDED; \
     case ValueType::kTtl: FALLTHROUGH_INTENDED; \
+    case ValueType::kValueLogReference: FALLTHROUGH_INTENDED; \
     case ValueType::kUserTimestamp: \
   break
 
@@ -249,6 +251,8 @@ string PrimitiveValue::ToString(AutoDecodeKeys auto_decode_keys) const {
     case ValueType::kUserTimestamp: FALLTHROUGH_INTENDED;
     case ValueType::kObsoleteIntentPrefix: FALLTHROUGH_INTENDED;
     case ValueType::kExternalIntents: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
+    case ValueType::kValueLogReference: FALLTHROUGH_INTENDED;
     case ValueType::kGreaterThanIntentType:
       break;
     case ValueType::kLowest:
@@ -581,6 +585,8 @@ string PrimitiveValue::ToValue() const {
     case ValueType::kGroupEnd: FALLTHROUGH_INTENDED;
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED;
     case ValueType::kObsoleteIntentPrefix: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
+    case ValueType::kValueLogReference: FALLTHROUGH_INTENDED;
     case ValueType::kGreaterThanIntentType: FALLTHROUGH_INTENDED;
     case ValueType::kTtl: FALLTHROUGH_INTENDED;
     case ValueType::kUserTimestamp: FALLTHROUGH_INTENDED;
@@ -1177,6 +1183,8 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
     case ValueType::kGroupEnd: FALLTHROUGH_INTENDED;
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED;
     case ValueType::kObsoleteIntentPrefix: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
+    case ValueType::kValueLogReference: FALLTHROUGH_INTENDED;
     case ValueType::kGreaterThanIntentType: FALLTHROUGH_INTENDED;
     case ValueType::kUInt16Hash: FALLTHROUGH_INTENDED;
     case ValueType::kInvalid: FALLTHROUGH_INTENDED;
@@ -1656,6 +1664,24 @@ PrimitiveValue PrimitiveValue::FromQLValuePB(const QLValuePB& value,
   LOG(FATAL) << "Unsupported datatype in PrimitiveValue: " << value.value_case();
 }
 
+void PrimitiveValue::MoveToQLValuePB(PrimitiveValue* primitive_value,
+                                     const std::shared_ptr<QLType>& ql_type,
+                                     QLValuePB* ql_value) {
+  if (primitive_value->IsString()) {
+    switch (ql_type->main()) {
+      case STRING:
+        ql_value->set_string_value(std::move(primitive_value->str_val_));
+        return;
+      case BINARY:
+        ql_value->set_binary_value(std::move(primitive_value->str_val_));
+        return;
+      default:
+        break;
+    }
+  }
+  ToQLValuePB(*primitive_value, ql_type, ql_value);
+}
+
 void PrimitiveValue::ToQLValuePB(const PrimitiveValue& primitive_value,
                                  const std::shared_ptr<QLType>& ql_type,
                                  QLValuePB* ql_value) {
@@ -214,6 +214,11 @@ class PrimitiveValue {
                           const std::shared_ptr<QLType>& ql_type,
                           QLValuePB* ql_val);
 
+  // Same as ToQLValuePB, but string value is moved from pv instead of being copied.
+  static void MoveToQLValuePB(PrimitiveValue* pv,
+                              const std::shared_ptr<QLType>& ql_type,
+                              QLValuePB* ql_val);
+
   ValueType value_type() const { return type_; }
 
   void AppendToKey(KeyBytes* key_bytes) const;
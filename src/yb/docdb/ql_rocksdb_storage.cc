@@ -141,6 +141,29 @@ Status QLRocksDBStorage::GetIterator(uint64 stmt_id,
   return Status::OK();
 }
 
+Status QLRocksDBStorage::GetIterator(uint64 stmt_id,
+                                     const Schema& projection,
+                                     const Schema& schema,
+                                     const TransactionOperationContextOpt& txn_op_context,
+                                     CoarseTimePoint deadline,
+                                     const ReadHybridTime& read_time,
+                                     const std::vector<Slice>& ybctids,
+                                     common::YQLRowwiseIteratorIf::UniPtr* iter) const {
+  SCHECK(!ybctids.empty(), InvalidArgument, "Empty batch of ybctids");
+  auto doc_keys = std::make_shared<std::vector<KeyBytes>>();
+  doc_keys->reserve(ybctids.size());
+  DocKey doc_key(schema);
+  for (const auto& ybctid : ybctids) {
+    RETURN_NOT_OK(doc_key.DecodeFrom(ybctid));
+    doc_keys->push_back(doc_key.Encode());
+  }
+  auto doc_iter = std::make_unique<DocRowwiseIterator>(
+      projection, schema, txn_op_context, doc_db_, deadline, read_time);
+  RETURN_NOT_OK(doc_iter->Init(DocPgsqlScanSpec(schema, stmt_id, std::move(doc_keys))));
+  *iter = std::move(doc_iter);
+  return Status::OK();
+}
+
 Status QLRocksDBStorage::GetIterator(const PgsqlReadRequestPB& request,
                                      const Schema& projection,
                                      const Schema& schema,
@@ -161,7 +184,7 @@ Status QLRocksDBStorage::GetIterator(const PgsqlReadRequestPB& request,
 
   if (range_components.size() == schema.num_range_key_columns()) {
     // Construct the scan spec basing on the RANGE condition as all range columns are specified.
-    RETURN_NOT_OK(doc_iter->Init(DocPgsqlScanSpec(
+    DocPgsqlScanSpec spec(
         schema,
         request.stmt_id(),
         hashed_components.empty()
@@ -171,14 +194,16 @@ Status QLRocksDBStorage::GetIterator(const PgsqlReadRequestPB& request,
                    std::move(hashed_components),
                    std::move(range_components)),
         start_doc_key,
-        request.is_forward_scan())));
+        request.is_forward_scan());
+    spec.set_fill_block_cache(FillBlockCache(request.fill_block_cache()));
+    RETURN_NOT_OK(doc_iter->Init(spec));
   } else {
     // Construct the scan spec basing on the HASH condition.
 
     SCHECK(!request.has_where_expr(),
            InternalError,
            "WHERE clause is not yet supported in docdb::pgsql");
-    RETURN_NOT_OK(doc_iter->Init(DocPgsqlScanSpec(
+    DocPgsqlScanSpec spec(
         schema,
         request.stmt_id(),
         hashed_components,
@@ -189,7 +214,10 @@ Status QLRocksDBStorage::GetIterator(const PgsqlReadRequestPB& request,
                                     : boost::none,
         nullptr /* where_expr */,
         start_doc_key,
-        request.is_forward_scan())));
+        request.is_forward_scan());
+    spec.set_distinct_prefix_length(request.distinct_prefix_length());
+    spec.set_fill_block_cache(FillBlockCache(request.fill_block_cache()));
+    RETURN_NOT_OK(doc_iter->Init(spec));
   }
 
   *iter = std::move(doc_iter);
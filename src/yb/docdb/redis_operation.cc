@@ -1428,6 +1428,15 @@ Status RedisReadOperation::ExecuteCollectionGetRangeByBounds(
       int32_t offset = request_.index_range().lower_bound().index();
       int32_t limit = request_.range_request_limit();
 
+      // The cardinality counter of the set tells, without a scan, when the offset skips all its
+      // members.
+      if (offset >= 0 && limit != 0) {
+        int64_t card = VERIFY_RESULT(GetCardinality(iterator_.get(), request_.key_value()));
+        if (offset >= card) {
+          limit = 0;
+        }
+      }
+
       if (offset < 0 || limit == 0) {
         // Return an empty response.
         response_.set_code(RedisResponsePB::OK);
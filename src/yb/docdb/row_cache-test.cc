@@ -0,0 +1,120 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/row_cache.h"
+
+#include "yb/docdb/doc_key.h"
+
+#include "yb/util/size_literals.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+const HybridTime kReadTime = HybridTime::FromMicros(1000);
+
+std::string EncodeKey(const std::string& hashed, int64_t range) {
+  return DocKey(
+      0x1234, {PrimitiveValue(hashed)}, {PrimitiveValue(range)}).Encode().ToStringBuffer();
+}
+
+size_t HashPartSize(const std::string& doc_key) {
+  return CHECK_RESULT(DocKey::EncodedHashPartAndDocKeySizes(doc_key)).first;
+}
+
+SubDocument MakeRow(const std::string& value) {
+  SubDocument result;
+  result.SetChildPrimitive(PrimitiveValue(ColumnId(10)), PrimitiveValue(value));
+  return result;
+}
+
+} // namespace
+
+class RowCacheTest : public YBTest {
+ protected:
+  void Put(const std::string& key, HybridTime read_ht, const SubDocument& row) {
+    cache_.Put(key, HashPartSize(key), projection_, read_ht, row);
+  }
+
+  std::vector<PrimitiveValue> projection_ = {
+      PrimitiveValue::kLivenessColumn, PrimitiveValue(ColumnId(10)) };
+  RowCache cache_{1_MB, MemTrackerPtr(), nullptr /* metric_entity */};
+};
+
+TEST_F(RowCacheTest, GetAndPut) {
+  const auto key = EncodeKey("a", 1);
+  ASSERT_FALSE(cache_.Get(key, projection_, kReadTime));
+
+  Put(key, kReadTime, MakeRow("value"));
+  auto row = cache_.Get(key, projection_, kReadTime.AddMicroseconds(1));
+  ASSERT_TRUE(row);
+  ASSERT_EQ(MakeRow("value"), *row);
+
+  // Row is not known before the time it was read at.
+  ASSERT_FALSE(cache_.Get(key, projection_, HybridTime::FromMicros(999)));
+  // Row read with other projection does not match.
+  ASSERT_FALSE(cache_.Get(key, {PrimitiveValue::kLivenessColumn}, kReadTime));
+}
+
+TEST_F(RowCacheTest, Invalidate) {
+  const auto key1 = EncodeKey("a", 1);
+  const auto key2 = EncodeKey("a", 2);
+  const auto key3 = EncodeKey("b", 1);
+  for (const auto& key : {key1, key2, key3}) {
+    Put(key, kReadTime, MakeRow(key));
+  }
+
+  // Write invalidates all rows with the same hash part.
+  const auto write_time = kReadTime.AddMicroseconds(10);
+  cache_.Invalidate(Slice(key1).Prefix(HashPartSize(key1)), write_time);
+  ASSERT_FALSE(cache_.Get(key1, projection_, write_time));
+  ASSERT_FALSE(cache_.Get(key2, projection_, write_time));
+  ASSERT_TRUE(cache_.Get(key3, projection_, write_time));
+
+  // Row that was read before the write could be overwritten, so should not be cached.
+  Put(key1, kReadTime.AddMicroseconds(9), MakeRow("old"));
+  ASSERT_FALSE(cache_.Get(key1, projection_, write_time));
+  Put(key1, write_time, MakeRow("new"));
+  ASSERT_EQ(MakeRow("new"), *cache_.Get(key1, projection_, write_time));
+
+  cache_.Clear(write_time.AddMicroseconds(1));
+  ASSERT_FALSE(cache_.Get(key1, projection_, write_time));
+  ASSERT_FALSE(cache_.Get(key3, projection_, write_time));
+  Put(key3, write_time, MakeRow("value"));
+  ASSERT_FALSE(cache_.Get(key3, projection_, write_time));
+}
+
+TEST_F(RowCacheTest, NotCacheable) {
+  const auto key = EncodeKey("a", 1);
+  auto row = MakeRow("value");
+  row.GetChild(PrimitiveValue(ColumnId(10)))->SetTtl(10);
+  Put(key, kReadTime, row);
+  ASSERT_FALSE(cache_.Get(key, projection_, kReadTime));
+}
+
+TEST_F(RowCacheTest, Eviction) {
+  constexpr int kNumRows = 1000;
+  const std::string value(10_KB, 'x');
+  for (int i = 0; i != kNumRows; ++i) {
+    Put(EncodeKey("a", i), kReadTime, MakeRow(value));
+  }
+  // Only recently added rows fit into the capacity.
+  ASSERT_FALSE(cache_.Get(EncodeKey("a", 0), projection_, kReadTime));
+  ASSERT_TRUE(cache_.Get(EncodeKey("a", kNumRows - 1), projection_, kReadTime));
+}
+
+}  // namespace docdb
+}  // namespace yb
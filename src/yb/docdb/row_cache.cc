@@ -0,0 +1,172 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/row_cache.h"
+
+#include "yb/docdb/value_type.h"
+
+METRIC_DEFINE_counter(
+    tablet, row_cache_hits,
+    "Row cache hits",
+    yb::MetricUnit::kCacheHits,
+    "Number of point reads served from the tablet row cache.");
+METRIC_DEFINE_counter(
+    tablet, row_cache_misses,
+    "Row cache misses",
+    yb::MetricUnit::kCacheQueries,
+    "Number of point reads that were not found in the tablet row cache.");
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// Approximate memory used by a node of std::map, in addition to its value.
+constexpr size_t kMapNodeOverhead = 32;
+
+size_t PrimitiveValueMemoryUsage(const PrimitiveValue& value) {
+  return value.IsString() ? value.GetString().size() : 0;
+}
+
+// Returns estimated memory used by the row, or boost::none if the row could not be cached.
+// Values with TTL are not cached, because they would be different for the later reads.
+boost::optional<size_t> CacheableMemoryUsage(const SubDocument& doc) {
+  if (doc.GetTtl() != -1 || doc.value_type() == ValueType::kArray) {
+    return boost::none;
+  }
+  size_t result = sizeof(SubDocument);
+  if (!IsObjectType(doc.value_type())) {
+    return result + PrimitiveValueMemoryUsage(doc);
+  }
+  if (doc.object_num_keys() == 0) {
+    return result;
+  }
+  for (const auto& key_and_child : doc.object_container()) {
+    auto child_usage = CacheableMemoryUsage(key_and_child.second);
+    if (!child_usage) {
+      return boost::none;
+    }
+    result += kMapNodeOverhead + sizeof(PrimitiveValue) +
+              PrimitiveValueMemoryUsage(key_and_child.first) + *child_usage;
+  }
+  return result;
+}
+
+} // namespace
+
+RowCache::RowCache(size_t capacity, const MemTrackerPtr& parent_mem_tracker,
+                   const scoped_refptr<MetricEntity>& metric_entity)
+    : capacity_(capacity),
+      mem_tracker_(MemTracker::FindOrCreateTracker("RowCache", parent_mem_tracker)) {
+  bucket_watermarks_.fill(HybridTime::kMin);
+  if (metric_entity) {
+    hits_ = METRIC_row_cache_hits.Instantiate(metric_entity);
+    misses_ = METRIC_row_cache_misses.Instantiate(metric_entity);
+  }
+}
+
+RowCache::~RowCache() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  mem_tracker_->Release(memory_usage_);
+}
+
+boost::optional<SubDocument> RowCache::Get(
+    const Slice& doc_key, const std::vector<PrimitiveValue>& projection, HybridTime read_ht) {
+  boost::optional<SubDocument> result;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& index = entries_.get<DocKeyTag>();
+    auto it = index.find(doc_key.ToBuffer());
+    if (it != index.end() && it->read_ht <= read_ht && it->projection == projection) {
+      result = it->row;
+      entries_.relocate(entries_.begin(), entries_.project<0>(it));
+    }
+  }
+  auto& counter = result ? hits_ : misses_;
+  if (counter) {
+    counter->Increment();
+  }
+  return result;
+}
+
+void RowCache::Put(
+    const Slice& doc_key, size_t hash_part_size, const std::vector<PrimitiveValue>& projection,
+    HybridTime read_ht, const SubDocument& row) {
+  auto row_usage = CacheableMemoryUsage(row);
+  if (!row_usage) {
+    return;
+  }
+  const size_t memory_usage = sizeof(Entry) + doc_key.size() + hash_part_size +
+                              projection.size() * sizeof(PrimitiveValue) + *row_usage;
+  if (memory_usage > capacity_) {
+    return;
+  }
+  Slice hash_part = doc_key.Prefix(hash_part_size);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Row could have been overwritten by a write that is not visible at read_ht.
+  if (read_ht < watermark_ || read_ht < bucket_watermarks_[BucketIndex(hash_part)]) {
+    return;
+  }
+  auto& index = entries_.get<DocKeyTag>();
+  auto it = index.find(doc_key.ToBuffer());
+  if (it != index.end()) {
+    if (it->read_ht >= read_ht) {
+      return;
+    }
+    ReleaseMemory(*it);
+    index.erase(it);
+  }
+  entries_.push_front(Entry {
+    .doc_key = doc_key.ToBuffer(),
+    .hash_part = hash_part.ToBuffer(),
+    .projection = projection,
+    .read_ht = read_ht,
+    .row = row,
+    .memory_usage = memory_usage,
+  });
+  memory_usage_ += memory_usage;
+  mem_tracker_->Consume(memory_usage);
+  while (memory_usage_ > capacity_) {
+    ReleaseMemory(entries_.back());
+    entries_.pop_back();
+  }
+}
+
+void RowCache::Invalidate(const Slice& hash_part, HybridTime write_ht) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& watermark = bucket_watermarks_[BucketIndex(hash_part)];
+  watermark = std::max(watermark, write_ht);
+  auto& index = entries_.get<HashPartTag>();
+  auto range = index.equal_range(hash_part.ToBuffer());
+  for (auto it = range.first; it != range.second;) {
+    ReleaseMemory(*it);
+    it = index.erase(it);
+  }
+}
+
+void RowCache::Clear(HybridTime write_ht) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  watermark_ = std::max(watermark_, write_ht);
+  mem_tracker_->Release(memory_usage_);
+  memory_usage_ = 0;
+  entries_.clear();
+}
+
+void RowCache::ReleaseMemory(const Entry& entry) {
+  memory_usage_ -= entry.memory_usage;
+  mem_tracker_->Release(entry.memory_usage);
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,124 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_ROW_CACHE_H
+#define YB_DOCDB_ROW_CACHE_H
+
+#include <array>
+#include <mutex>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/optional.hpp>
+
+#include "yb/common/hybrid_time.h"
+
+#include "yb/docdb/subdocument.h"
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/mem_tracker.h"
+#include "yb/util/metrics.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace docdb {
+
+// Tablet level cache of rows, resolved by point reads of non transactional tables.
+// Row is stored by its encoded DocKey, together with the projection it was read with, and the
+// hybrid time of the read that resolved it. Cached row is returned to reads with the same
+// projection and read time not less than the stored one.
+//
+// Each write should invalidate the rows with the same hash part of DocKey, before it becomes
+// visible to reads. Writes also raise the invalidation watermark of their hash bucket, so a row
+// that was resolved at a read time older than a concurrent write to the bucket is not cached.
+//
+// Memory used by the rows is limited by capacity and tracked by the mem tracker. Thread safe.
+class RowCache {
+ public:
+  RowCache(size_t capacity, const MemTrackerPtr& parent_mem_tracker,
+           const scoped_refptr<MetricEntity>& metric_entity);
+  ~RowCache();
+
+  boost::optional<SubDocument> Get(
+      const Slice& doc_key, const std::vector<PrimitiveValue>& projection, HybridTime read_ht);
+
+  // Stores the row that was resolved at read_ht. When the row is not suitable for caching, for
+  // instance contains values with TTL, it is not stored.
+  void Put(
+      const Slice& doc_key, size_t hash_part_size, const std::vector<PrimitiveValue>& projection,
+      HybridTime read_ht, const SubDocument& row);
+
+  // Invalidates rows with specified hash part of DocKey, on write at write_ht.
+  void Invalidate(const Slice& hash_part, HybridTime write_ht);
+
+  // Invalidates all rows, on write at write_ht that could affect any of them.
+  void Clear(HybridTime write_ht);
+
+ private:
+  static constexpr size_t kNumBuckets = 1024;
+
+  struct Entry {
+    std::string doc_key;
+    std::string hash_part;
+    std::vector<PrimitiveValue> projection;
+    HybridTime read_ht;
+    SubDocument row;
+    size_t memory_usage;
+  };
+
+  class DocKeyTag;
+  class HashPartTag;
+
+  using Entries = boost::multi_index_container<
+      Entry,
+      boost::multi_index::indexed_by<
+        boost::multi_index::sequenced<>,
+        boost::multi_index::hashed_unique<
+          boost::multi_index::tag<DocKeyTag>,
+          boost::multi_index::member<Entry, std::string, &Entry::doc_key>
+        >,
+        boost::multi_index::hashed_non_unique<
+          boost::multi_index::tag<HashPartTag>,
+          boost::multi_index::member<Entry, std::string, &Entry::hash_part>
+        >
+      >
+  >;
+
+  static size_t BucketIndex(const Slice& hash_part) {
+    return hash_part.hash() % kNumBuckets;
+  }
+
+  // Should be invoked before entry is removed from entries_.
+  void ReleaseMemory(const Entry& entry) REQUIRES(mutex_);
+
+  const size_t capacity_;
+  MemTrackerPtr mem_tracker_;
+  scoped_refptr<Counter> hits_;
+  scoped_refptr<Counter> misses_;
+
+  std::mutex mutex_;
+  Entries entries_ GUARDED_BY(mutex_);
+  size_t memory_usage_ GUARDED_BY(mutex_) = 0;
+  // Max hybrid time of writes invalidating rows of the bucket.
+  std::array<HybridTime, kNumBuckets> bucket_watermarks_ GUARDED_BY(mutex_);
+  // Max hybrid time of writes invalidating all rows.
+  HybridTime watermark_ GUARDED_BY(mutex_) = HybridTime::kMin;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_ROW_CACHE_H
@@ -122,6 +122,37 @@ TEST_F(SharedLockManagerTest, LockBatchReset) {
   EXPECT_TRUE(lb.empty());
 }
 
+TEST_F(SharedLockManagerTest, LockBatchUnlockRelock) {
+  LockBatch lb = TestLockBatch();
+  lb.Unlock();
+  EXPECT_EQ(2, lb.size());
+  EXPECT_FALSE(lb.empty());
+
+  {
+    // Keys are not locked by lb while it is unlocked.
+    LockBatch lb2 = TestLockBatch(CoarseMonoClock::now() + 10ms);
+    ASSERT_OK(lb2.status());
+    ASSERT_NOK(lb.Relock(CoarseMonoClock::now() + 10ms));
+    // Failed relock keeps keys, so it could be retried.
+    EXPECT_EQ(2, lb.size());
+    // Relock with deadline in the past does not wait.
+    ASSERT_NOK(lb.Relock(CoarseMonoClock::now()));
+  }
+
+  ASSERT_OK(lb.Relock(CoarseMonoClock::now()));
+  EXPECT_EQ(2, lb.size());
+
+  LockBatch lb_fail = TestLockBatch(CoarseMonoClock::now() + 10ms);
+  ASSERT_FALSE(lb_fail.status().ok());
+  ASSERT_TRUE(lb_fail.empty());
+
+  // Unlocked batch does not unlock keys again on reset.
+  lb.Unlock();
+  lb.Reset();
+  LockBatch lb3 = TestLockBatch(CoarseMonoClock::now() + 10ms);
+  ASSERT_OK(lb3.status());
+}
+
 // Launch pairs of threads. Each pair tries to lock/unlock on the same key sequence.
 // This catches bug in SharedLockManager when condition is waited incorrectly.
 TEST_F(SharedLockManagerTest, QuickLockUnlock) {
@@ -161,6 +192,50 @@ TEST_F(SharedLockManagerTest, QuickLockUnlock) {
   }
 }
 
+// Batches with keys from different stripes of the lock manager should exclude each other.
+TEST_F(SharedLockManagerTest, MultiKeyBatches) {
+  constexpr size_t kThreads = 16;
+  constexpr size_t kKeys = 64;
+  constexpr size_t kKeysPerBatch = 8;
+  constexpr size_t kIterations = 2000;
+
+  std::vector<RefCntPrefix> keys;
+  for (size_t i = 0; i != kKeys; ++i) {
+    keys.emplace_back(Format("key_$0", i));
+  }
+  // Counters are updated without synchronization, relying only on acquired locks.
+  std::vector<size_t> counters(kKeys);
+  std::vector<std::thread> threads;
+  while (threads.size() != kThreads) {
+    threads.emplace_back([this, &keys, &counters] {
+      for (size_t i = 0; i != kIterations; ++i) {
+        // Keys are always locked in the same order, to avoid deadlocks.
+        auto first = RandomUniformInt<size_t>(0, kKeys - kKeysPerBatch);
+        LockBatchEntries entries;
+        for (size_t idx = first; idx != first + kKeysPerBatch; ++idx) {
+          entries.push_back(LockBatchEntry {
+              keys[idx], IntentTypeSet({IntentType::kStrongWrite, IntentType::kStrongRead}) });
+        }
+        LockBatch lb(&lm_, std::move(entries), CoarseTimePoint::max());
+        ASSERT_OK(lb.status());
+        for (size_t idx = first; idx != first + kKeysPerBatch; ++idx) {
+          ++counters[idx];
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  size_t total = 0;
+  for (auto counter : counters) {
+    total += counter;
+  }
+  ASSERT_EQ(kThreads * kIterations * kKeysPerBatch, total);
+}
+
 TEST_F(SharedLockManagerTest, LockConflicts) {
   rpc::ThreadPool tp(rpc::ThreadPoolOptions{"test_pool"s, 10, 1});
 
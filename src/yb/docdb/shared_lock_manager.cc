@@ -13,6 +13,7 @@
 
 #include "yb/docdb/shared_lock_manager.h"
 
+#include <array>
 #include <vector>
 
 #include <boost/range/adaptor/reversed.hpp>
@@ -24,6 +25,7 @@
 #include "yb/util/scope_exit.h"
 #include "yb/util/tostring.h"
 #include "yb/util/trace.h"
+#include "yb/util/wait_state.h"
 
 using std::string;
 
@@ -88,6 +90,21 @@ std::array<LockState, kIntentTypeSetMapSize> GenerateByMask(LockState single_int
 
 const std::array<LockState, kIntentTypeSetMapSize> kIntentTypeSetAdd = GenerateByMask(1);
 
+// Number of independently locked parts of the lock entries map.
+constexpr size_t kNumLockStripes = 32;
+
+// Makes lock hold the specified mutex. The previously held mutex is released before acquiring the
+// new one, so stripe mutexes are never held together and could not deadlock.
+void SwitchStripeLock(std::mutex* mutex, std::unique_lock<std::mutex>* lock) {
+  if (lock->mutex() == mutex) {
+    return;
+  }
+  if (lock->owns_lock()) {
+    lock->unlock();
+  }
+  *lock = std::unique_lock<std::mutex>(*mutex);
+}
+
 } // namespace
 
 bool IntentTypeSetsConflict(IntentTypeSet lhs, IntentTypeSet rhs) {
@@ -107,10 +124,13 @@ struct LockedBatchEntry {
 
   std::condition_variable cond_var;
 
-  // Refcounting for garbage collection. Can only be used while the global mutex is locked.
-  // Global mutex resides in lock manager and the same for all LockBatchEntries.
+  // Refcounting for garbage collection. Can only be used while the mutex of the stripe is locked.
+  // Stripe resides in lock manager and the same for all LockBatchEntries with keys of this stripe.
   size_t ref_count = 0;
 
+  // Index of the lock manager stripe that owns this entry.
+  size_t stripe = 0;
+
   // Number of holders for each type
   std::atomic<LockState> num_holding{0};
 
@@ -134,28 +154,41 @@ class SharedLockManager::Impl {
   void Unlock(const LockBatchEntries& key_to_intent_type);
 
   ~Impl() {
-    std::lock_guard<std::mutex> lock(global_mutex_);
-    LOG_IF(DFATAL, !locks_.empty()) << "Locks not empty in dtor: " << yb::ToString(locks_);
+    for (auto& stripe : stripes_) {
+      std::lock_guard<std::mutex> lock(stripe.mutex);
+      LOG_IF(DFATAL, !stripe.locks.empty())
+          << "Locks not empty in dtor: " << yb::ToString(stripe.locks);
+    }
   }
 
  private:
   typedef std::unordered_map<RefCntPrefix, LockedBatchEntry*, RefCntPrefixHash> LockEntryMap;
 
-  // Make sure the entries exist in the locks_ map and return pointers so we can access
-  // them without holding the global lock. Returns a vector with pointers in the same order
+  // Lock entries are split into stripes by key hash, so concurrent batches with different keys
+  // usually don't contend on the same mutex.
+  struct Stripe {
+    // Should be taken only for very short duration, with no blocking wait.
+    std::mutex mutex;
+
+    LockEntryMap locks GUARDED_BY(mutex);
+    // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
+    std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries GUARDED_BY(mutex);
+    std::vector<LockedBatchEntry*> free_lock_entries GUARDED_BY(mutex);
+  };
+
+  static size_t StripeIndex(const RefCntPrefix& key) {
+    return RefCntPrefixHash()(key) % kNumLockStripes;
+  }
+
+  // Make sure the entries exist in the stripe maps and return pointers so we can access
+  // them without holding the stripe locks. Returns a vector with pointers in the same order
   // as the keys in the batch.
   void Reserve(LockBatchEntries* batch);
 
   // Update refcounts and maybe collect garbage.
   void Cleanup(const LockBatchEntries& key_to_intent_type);
 
-  // The global mutex should be taken only for very short duration, with no blocking wait.
-  std::mutex global_mutex_;
-
-  LockEntryMap locks_ GUARDED_BY(global_mutex_);
-  // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
-  std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries_ GUARDED_BY(global_mutex_);
-  std::vector<LockedBatchEntry*> free_lock_entries_ GUARDED_BY(global_mutex_);
+  std::array<Stripe, kNumLockStripes> stripes_;
 };
 
 const std::array<LockState, kIntentTypeSetMapSize> kIntentTypeSetMask = GenerateByMask(
@@ -200,6 +233,7 @@ bool LockedBatchEntry::Lock(IntentTypeSet lock_type, CoarseTimePoint deadline) {
     std::unique_lock<std::mutex> lock(mutex);
     old_value = num_holding.load(std::memory_order_acquire);
     if ((old_value & kIntentTypeSetConflicts[type_idx]) != 0) {
+      ScopedWaitEvent wait_event(WaitEvent::kLockManager);
       if (deadline != CoarseTimePoint::max()) {
         if (cond_var.wait_until(lock, deadline) == std::cv_status::timeout) {
           return false;
@@ -274,16 +308,22 @@ bool SharedLockManager::Impl::Lock(LockBatchEntries* key_to_intent_type, CoarseT
 }
 
 void SharedLockManager::Impl::Reserve(LockBatchEntries* key_to_intent_type) {
-  std::lock_guard<std::mutex> lock(global_mutex_);
+  // At most one stripe mutex is held at a time, keeping it while consecutive keys of the batch
+  // belong to the same stripe.
+  std::unique_lock<std::mutex> lock;
   for (auto& key_and_intent_type : *key_to_intent_type) {
-    auto& value = locks_[key_and_intent_type.key];
+    auto stripe_idx = StripeIndex(key_and_intent_type.key);
+    auto& stripe = stripes_[stripe_idx];
+    SwitchStripeLock(&stripe.mutex, &lock);
+    auto& value = stripe.locks[key_and_intent_type.key];
     if (!value) {
-      if (!free_lock_entries_.empty()) {
-        value = free_lock_entries_.back();
-        free_lock_entries_.pop_back();
+      if (!stripe.free_lock_entries.empty()) {
+        value = stripe.free_lock_entries.back();
+        stripe.free_lock_entries.pop_back();
       } else {
-        lock_entries_.emplace_back(std::make_unique<LockedBatchEntry>());
-        value = lock_entries_.back().get();
+        stripe.lock_entries.emplace_back(std::make_unique<LockedBatchEntry>());
+        value = stripe.lock_entries.back().get();
+        value->stripe = stripe_idx;
       }
     }
     value->ref_count++;
@@ -302,11 +342,13 @@ void SharedLockManager::Impl::Unlock(const LockBatchEntries& key_to_intent_type)
 }
 
 void SharedLockManager::Impl::Cleanup(const LockBatchEntries& key_to_intent_type) {
-  std::lock_guard<std::mutex> lock(global_mutex_);
+  std::unique_lock<std::mutex> lock;
   for (const auto& item : key_to_intent_type) {
+    auto& stripe = stripes_[item.locked->stripe];
+    SwitchStripeLock(&stripe.mutex, &lock);
     if (--(item.locked->ref_count) == 0) {
-      locks_.erase(item.key);
-      free_lock_entries_.push_back(item.locked);
+      stripe.locks.erase(item.key);
+      stripe.free_lock_entries.push_back(item.locked);
     }
   }
 }
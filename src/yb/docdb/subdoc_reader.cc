@@ -32,6 +32,7 @@
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/docdb/key_bytes.h"
 #include "yb/docdb/kv_debug.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/primitive_value.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/value.h"
@@ -181,6 +182,10 @@ class LazySubDocumentHolder {
   // if it has not yet been constructed.
   Result<SubDocument*> Get();
 
+  // Returns the SubDocument specified by this instance if it already exists in its parent, e.g. it
+  // was filled from a packed row, or nullptr otherwise. Does not construct it.
+  Result<SubDocument*> GetIfExists();
+
  private:
   // The constructed SubDocument specified by this instance.
   SubDocument* target_ = nullptr;
@@ -226,10 +231,27 @@ Result<SubDocument*> LazySubDocumentHolder::Get() {
       "never get here.");
 }
 
+Result<SubDocument*> LazySubDocumentHolder::GetIfExists() {
+  if (target_) {
+    return target_;
+  }
+  SubDocument* current = VERIFY_RESULT(parent_->GetIfExists());
+  Slice temp = key_;
+  temp.remove_prefix(parent_->key_.size());
+  while (current && !temp.empty()) {
+    PrimitiveValue child_key_part;
+    RETURN_NOT_OK(child_key_part.DecodeFromKey(&temp));
+    current = current->GetChild(child_key_part);
+  }
+  return current;
+}
+
 // This class provides a wrapper to access data corresponding to a RocksDB row.
 class DocDbRowData {
  public:
-  DocDbRowData(const Slice& key, const DocHybridTime& write_time, Value&& value);
+  DocDbRowData(
+      const Slice& key, const DocHybridTime& write_time, Value&& value,
+      std::string packed_row = std::string());
 
   static Result<std::unique_ptr<DocDbRowData>> CurrentRow(IntentAwareIterator* iter);
 
@@ -245,19 +267,29 @@ class DocDbRowData {
 
   bool IsPrimitiveValue() const { return IsPrimitiveValueType(value_.value_type()); }
 
+  bool IsCounterDelta() const { return value_.merge_flags() == Value::kCounterDeltaFlag; }
+
+  bool IsPackedRow() const { return !packed_row_.empty(); }
+
+  // The encoded packed row, if this row is a packed row, see packed_row.h.
+  const std::string& packed_row() const { return packed_row_; }
+
   PrimitiveValue* mutable_primitive_value() { return value_.mutable_primitive_value(); }
 
  private:
   const KeyBytes target_key_;
   const DocHybridTime write_time_;
+  // Control fields of the packed row are stored here, while the row itself is kept encoded.
   Value value_;
+  const std::string packed_row_;
 
   DISALLOW_COPY_AND_ASSIGN(DocDbRowData);
 };
 
 DocDbRowData::DocDbRowData(
-    const Slice& key, const DocHybridTime& write_time, Value&& value):
-    target_key_(std::move(key)), write_time_(std::move(write_time)), value_(std::move(value)) {}
+    const Slice& key, const DocHybridTime& write_time, Value&& value, std::string packed_row):
+    target_key_(std::move(key)), write_time_(std::move(write_time)), value_(std::move(value)),
+    packed_row_(std::move(packed_row)) {}
 
 Result<std::unique_ptr<DocDbRowData>> DocDbRowData::CurrentRow(IntentAwareIterator* iter) {
   auto key_data = VERIFY_RESULT(iter->FetchKey());
@@ -270,13 +302,23 @@ Result<std::unique_ptr<DocDbRowData>> DocDbRowData::CurrentRow(IntentAwareIterat
   // TODO -- we could optimize be decoding directly into a SubDocument instance on the heap which
   // could be later bound to our result SubDocument. This could work if e.g. Value could be
   // initialized with a PrimitiveValue*.
-  RETURN_NOT_OK(value.Decode(iter->value()));
+  Slice value_slice = iter->value();
+  RETURN_NOT_OK(value.DecodeControlFields(&value_slice));
+  std::string packed_row;
+  if (DecodeValueType(value_slice) == ValueType::kPackedRow) {
+    packed_row = value_slice.ToBuffer();
+  } else {
+    RETURN_NOT_OK_PREPEND(
+        value.mutable_primitive_value()->DecodeFromValue(value_slice),
+        Format("Failed to decode value in $0", iter->value().ToDebugHexString()));
+  }
 
   if (key_data.write_time == DocHybridTime::kMin) {
     return STATUS(Corruption, "No hybrid timestamp found on entry");
   }
 
-  return std::make_unique<DocDbRowData>(key_data.key, key_data.write_time, std::move(value));
+  return std::make_unique<DocDbRowData>(
+      key_data.key, key_data.write_time, std::move(value), std::move(packed_row));
 }
 
 // This class provides a convenience handle for modifying a SubDocument specified by a provided
@@ -295,8 +337,15 @@ class DocDbRowAssembler {
 
   CHECKED_STATUS SetTombstone();
 
+  // Replaces the value filled from the packed row of an ancestor with a tombstone, when the
+  // value is deleted after the packed row was written.
+  CHECKED_STATUS DeletePackedValue();
+
   CHECKED_STATUS SetPrimitiveValue(DocDbRowData* row);
 
+  // Fills children of this SubDocument with the columns of the packed row.
+  CHECKED_STATUS SetPackedRow(const DocDbRowData& row);
+
   Result<bool> HasStoredValue();
 
  private:
@@ -324,6 +373,33 @@ Status DocDbRowAssembler::SetTombstone() {
   return Status::OK();
 }
 
+Status DocDbRowAssembler::DeletePackedValue() {
+  auto* subdoc = VERIFY_RESULT(root_.GetIfExists());
+  if (subdoc) {
+    *subdoc = SubDocument(ValueType::kTombstone);
+  }
+  return Status::OK();
+}
+
+Status DocDbRowAssembler::SetPackedRow(const DocDbRowData& row) {
+  auto* subdoc = VERIFY_RESULT(root_.Get());
+  *subdoc = SubDocument();
+  const auto packed_row = VERIFY_RESULT(PackedRow::Decode(row.packed_row()));
+  for (size_t idx = 0; idx != packed_row.columns(); ++idx) {
+    const PrimitiveValue subkey(packed_row.column_id(idx));
+    auto column = VERIFY_RESULT(GetPackedColumn(packed_row, subkey, row.write_time()));
+    // NULL columns are not surfaced, the same as tombstoned columns.
+    if (column.value_type() != ValueType::kTombstone) {
+      subdoc->SetChild(subkey, std::move(column));
+    }
+  }
+  subdoc->SetChild(
+      PrimitiveValue::kLivenessColumn,
+      VERIFY_RESULT(GetPackedColumn(packed_row, PrimitiveValue::kLivenessColumn,
+                                    row.write_time())));
+  return Status::OK();
+}
+
 Status DocDbRowAssembler::SetPrimitiveValue(DocDbRowData* row) {
   // TODO -- this interface with a non-const row pointer is not ideal. It's awkward to allow the
   // DocDbRowAssembler to modify the DocDbRowData's state. In the future, it might make more
@@ -483,8 +559,13 @@ class ScopedDocDbRowContextWithData : public ScopedDocDbRowContext {
 
   void SeekOutOfPrefix();
 
+  // Replaces the counter delta of this row with the value of the counter.
+  CHECKED_STATUS ResolveCounterDelta();
+
  private:
   std::unique_ptr<DocDbRowData> data_;
+  // Versions of this row written before this time are overwritten by an ancestor.
+  const DocHybridTime ancestor_write_time_watermark_;
 
   DISALLOW_COPY_AND_ASSIGN(ScopedDocDbRowContextWithData);
 };
@@ -498,7 +579,8 @@ ScopedDocDbRowContextWithData::ScopedDocDbRowContextWithData(
     ScopedDocDbRowContext(
         iter, deadline_info, row->key(), assembly_target,
         ancestor_obsolescence_tracker.Child(row->write_time(), row->value().ttl())),
-    data_(std::move(row)) {}
+    data_(std::move(row)),
+    ancestor_write_time_watermark_(ancestor_obsolescence_tracker.GetHighWriteTime()) {}
 
 ScopedDocDbRowContextWithData::ScopedDocDbRowContextWithData(
     std::unique_ptr<DocDbRowData> row,
@@ -509,12 +591,19 @@ ScopedDocDbRowContextWithData::ScopedDocDbRowContextWithData(
     ScopedDocDbRowContext(
         iter, deadline_info, row->key(), ancestor_assembler,
         ancestor_obsolescence_tracker.Child(row->write_time(), row->value().ttl())),
-    data_(std::move(row)) {}
+    data_(std::move(row)),
+    ancestor_write_time_watermark_(ancestor_obsolescence_tracker.GetHighWriteTime()) {}
 
 void ScopedDocDbRowContextWithData::SeekOutOfPrefix() {
   iter_->SeekOutOfSubDoc(data_->key());
 }
 
+Status ScopedDocDbRowContextWithData::ResolveCounterDelta() {
+  const auto sum = VERIFY_RESULT(iter_->SumCounterDeltas(ancestor_write_time_watermark_));
+  *data_->mutable_primitive_value() = PrimitiveValue(sum);
+  return Status::OK();
+}
+
 ScopedDocDbCollectionContext::ScopedDocDbCollectionContext(ScopedDocDbRowContext* parent):
     parent_(parent) {}
 
@@ -602,8 +691,24 @@ Status ProcessSubDocument(ScopedDocDbRowContextWithData* scope) {
   auto data = scope->data();
   auto assembler = scope->mutable_assembler();
   auto obsolescence_tracker = scope->obsolescence_tracker();
+  const bool is_obsolete = obsolescence_tracker->IsObsolete(data->write_time());
+
+  if (data->IsPackedRow()) {
+    if (is_obsolete) {
+      return MaybeReviveCollection(scope);
+    }
+    // Columns written after the packed row are processed as children of the row, and override
+    // the packed values.
+    RETURN_NOT_OK(assembler->SetPackedRow(*data));
+    RETURN_NOT_OK(ProcessChildren(scope->collection()));
+    return Status::OK();
+  }
 
-  if (data->IsTombstone() || obsolescence_tracker->IsObsolete(data->write_time())) {
+  if (data->IsTombstone() && !is_obsolete) {
+    RETURN_NOT_OK(assembler->DeletePackedValue());
+  }
+
+  if (data->IsTombstone() || is_obsolete) {
     if (data->IsPrimitiveValue()) {
       VLOG(4) << "Discarding overwritten or expired primitive value";
       return assembler->SetTombstone();
@@ -619,6 +724,9 @@ Status ProcessSubDocument(ScopedDocDbRowContextWithData* scope) {
   }
 
   if (data->IsPrimitiveValue()) {
+    if (data->IsCounterDelta()) {
+      RETURN_NOT_OK(scope->ResolveCounterDelta());
+    }
     auto ttl_opt = obsolescence_tracker->GetTtlRemainingSeconds(data->write_time().hybrid_time());
     if (ttl_opt) {
       data->mutable_primitive_value()->SetTtl(*ttl_opt);
@@ -634,6 +742,29 @@ Status ProcessSubDocument(ScopedDocDbRowContextWithData* scope) {
 
 }  // namespace
 
+Result<SubDocument> GetPackedColumn(
+    const PackedRow& row, const PrimitiveValue& subkey, const DocHybridTime& write_time) {
+  if (subkey == PrimitiveValue::kLivenessColumn) {
+    // The packed row implies existence of the row.
+    return SubDocument(ValueType::kNullLow);
+  }
+  if (subkey.value_type() != ValueType::kColumnId) {
+    return SubDocument(ValueType::kInvalid);
+  }
+  auto value = row.GetValue(subkey.GetColumnId());
+  if (!value) {
+    return SubDocument(ValueType::kInvalid);
+  }
+  if (DecodeValueType(*value) == ValueType::kNullLow) {
+    // NULL is read the same way as the column that was set to NULL by a separate write.
+    return SubDocument(ValueType::kTombstone);
+  }
+  SubDocument result;
+  RETURN_NOT_OK(result.DecodeFromValue(*value));
+  result.SetWriteTime(write_time.hybrid_time().GetPhysicalValueMicros());
+  return result;
+}
+
 SubDocumentReader::SubDocumentReader(
     const KeyBytes& target_subdocument_key,
     IntentAwareIterator* iter,
@@ -685,6 +816,7 @@ Status SubDocumentReaderBuilder::InitObsolescenceInfo(
     const ObsolescenceTracker& table_obsolescence_tracker,
     const Slice& root_doc_key, const Slice& target_subdocument_key) {
   parent_obsolescence_tracker_ = table_obsolescence_tracker;
+  packed_row_.clear();
 
   // Look at ancestors to collect ttl/write-time metadata.
   IntentAwareIteratorPrefixScope prefix_scope(root_doc_key, iter_);
@@ -717,6 +849,19 @@ Status SubDocumentReaderBuilder::UpdateWithParentWriteInfo(
   }
 
   parent_obsolescence_tracker_ = parent_obsolescence_tracker_.Child(doc_ht);
+
+  if (!value.empty()) {
+    // The latest record of the document could be a packed row, that should be copied since value
+    // is invalidated when the iterator moves.
+    Value control_fields;
+    RETURN_NOT_OK(control_fields.DecodeControlFields(&value));
+    if (DecodeValueType(value) == ValueType::kPackedRow) {
+      packed_row_.assign(value.cdata(), value.size());
+      packed_row_write_time_ = doc_ht;
+    } else {
+      packed_row_.clear();
+    }
+  }
   return Status::OK();
 }
 
@@ -124,14 +124,28 @@ class SubDocumentReaderBuilder {
   // without explicit seeking to sub_doc_key by the caller is not supported.
   Result<std::unique_ptr<SubDocumentReader>> Build(const KeyBytes& sub_doc_key);
 
+  // The encoded packed row found by InitObsolescenceInfo as the latest record of an ancestor, or
+  // an empty slice if there is no such row.
+  Slice packed_row() const { return packed_row_; }
+
+  const DocHybridTime& packed_row_write_time() const { return packed_row_write_time_; }
+
  private:
   CHECKED_STATUS UpdateWithParentWriteInfo(const Slice& parent_key_without_ht);
 
   IntentAwareIterator* iter_;
   DeadlineInfo* deadline_info_;
   ObsolescenceTracker parent_obsolescence_tracker_;
+  std::string packed_row_;
+  DocHybridTime packed_row_write_time_;
 };
 
+// Returns the value of the column with the specified subkey from the packed row written at
+// write_time. A column that is absent from the row is returned as ValueType::kInvalid, and NULL as
+// a tombstone.
+Result<SubDocument> GetPackedColumn(
+    const PackedRow& row, const PrimitiveValue& subkey, const DocHybridTime& write_time);
+
 }  // namespace docdb
 }  // namespace yb
 
@@ -408,6 +408,16 @@ SubDocument SubDocument::FromQLValuePB(const QLValuePB& value,
   }
 }
 
+void SubDocument::MoveToQLValuePB(SubDocument* doc,
+                                  const shared_ptr<QLType>& ql_type,
+                                  QLValuePB* ql_value) {
+  if (ql_type->HasComplexValues()) {
+    ToQLValuePB(*doc, ql_type, ql_value);
+    return;
+  }
+  PrimitiveValue::MoveToQLValuePB(doc, ql_type, ql_value);
+}
+
 void SubDocument::ToQLValuePB(const SubDocument& doc,
                               const shared_ptr<QLType>& ql_type,
                               QLValuePB* ql_value) {
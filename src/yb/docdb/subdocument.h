@@ -181,6 +181,11 @@ class SubDocument : public PrimitiveValue {
                           const std::shared_ptr<QLType>& ql_type,
                           QLValuePB* v);
 
+  // Same as ToQLValuePB, but primitive string value is moved from the doc instead of being copied.
+  static void MoveToQLValuePB(SubDocument* doc,
+                              const std::shared_ptr<QLType>& ql_type,
+                              QLValuePB* v);
+
  private:
 
   CHECKED_STATUS ConvertToCollection(ValueType value_type);
@@ -0,0 +1,116 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/transaction_status_cache.h"
+
+#include "yb/common/transaction-test-util.h"
+
+#include "yb/util/metrics.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+METRIC_DECLARE_entity(tablet);
+METRIC_DECLARE_counter(shared_transaction_status_cache_hits);
+METRIC_DECLARE_counter(shared_transaction_status_cache_misses);
+
+namespace yb {
+namespace docdb {
+
+class TransactionStatusCacheTest : public YBTest {
+ protected:
+  Result<HybridTime> GetCommitTime(const TransactionId& transaction_id, uint64_t read_micros) {
+    TransactionStatusCache cache(
+        txn_context_, ReadHybridTime::FromMicros(read_micros), CoarseTimePoint::max());
+    return cache.GetCommitTime(transaction_id);
+  }
+
+  MetricRegistry registry_;
+  scoped_refptr<MetricEntity> entity_ = METRIC_ENTITY_tablet.Instantiate(&registry_, "test");
+  TransactionStatusManagerMock txn_status_manager_;
+  TransactionOperationContextOpt txn_context_ = TransactionOperationContext(
+      TransactionId::GenerateRandom(), &txn_status_manager_);
+};
+
+TEST_F(TransactionStatusCacheTest, Shared) {
+  SharedTransactionStatusCache cache(2 /* capacity */, entity_);
+  auto hits = METRIC_shared_transaction_status_cache_hits.Instantiate(entity_);
+  auto misses = METRIC_shared_transaction_status_cache_misses.Instantiate(entity_);
+  const auto txn1 = TransactionId::GenerateRandom();
+  const auto txn2 = TransactionId::GenerateRandom();
+  const auto txn3 = TransactionId::GenerateRandom();
+
+  ASSERT_FALSE(cache.GetCommitTime(txn1).is_valid());
+  ASSERT_EQ(0, hits->value());
+  ASSERT_EQ(1, misses->value());
+
+  cache.PutCommitTime(txn1, HybridTime::FromMicros(100));
+  cache.PutCommitTime(txn2, HybridTime::FromMicros(200));
+  ASSERT_EQ(HybridTime::FromMicros(100), cache.GetCommitTime(txn1));
+  ASSERT_EQ(HybridTime::FromMicros(200), cache.GetCommitTime(txn2));
+  ASSERT_EQ(2, hits->value());
+  ASSERT_EQ(1, misses->value());
+
+  // The least recently added transaction is evicted.
+  cache.PutCommitTime(txn3, HybridTime::FromMicros(300));
+  ASSERT_FALSE(cache.GetCommitTime(txn1).is_valid());
+  ASSERT_EQ(HybridTime::FromMicros(200), cache.GetCommitTime(txn2));
+  ASSERT_EQ(HybridTime::FromMicros(300), cache.GetCommitTime(txn3));
+
+  // Adding the transaction again makes it the most recently added one.
+  cache.PutCommitTime(txn2, HybridTime::FromMicros(200));
+  cache.PutCommitTime(txn1, HybridTime::FromMicros(100));
+  ASSERT_EQ(HybridTime::FromMicros(100), cache.GetCommitTime(txn1));
+  ASSERT_EQ(HybridTime::FromMicros(200), cache.GetCommitTime(txn2));
+  ASSERT_FALSE(cache.GetCommitTime(txn3).is_valid());
+
+  cache.Erase(txn2);
+  ASSERT_FALSE(cache.GetCommitTime(txn2).is_valid());
+  ASSERT_EQ(HybridTime::FromMicros(100), cache.GetCommitTime(txn1));
+
+  // Cache with zero capacity does not store anything.
+  SharedTransactionStatusCache disabled(0 /* capacity */, nullptr /* metric_entity */);
+  disabled.PutCommitTime(txn1, HybridTime::FromMicros(100));
+  ASSERT_FALSE(disabled.GetCommitTime(txn1).is_valid());
+}
+
+TEST_F(TransactionStatusCacheTest, ReadsShareCommitTime) {
+  SharedTransactionStatusCache shared_cache(10 /* capacity */, entity_);
+  txn_status_manager_.set_shared_status_cache(&shared_cache);
+  const auto committed = TransactionId::GenerateRandom();
+  txn_status_manager_.Commit(committed, HybridTime::FromMicros(1000));
+
+  ASSERT_EQ(HybridTime::FromMicros(1000), ASSERT_RESULT(GetCommitTime(committed, 2000)));
+  ASSERT_EQ(1, txn_status_manager_.num_status_requests());
+
+  // Following reads use the shared commit time, each comparing it with its own read time.
+  ASSERT_EQ(HybridTime::FromMicros(1000), ASSERT_RESULT(GetCommitTime(committed, 3000)));
+  ASSERT_EQ(HybridTime::kMin, ASSERT_RESULT(GetCommitTime(committed, 500)));
+  ASSERT_EQ(1, txn_status_manager_.num_status_requests());
+
+  // Status is requested again after the transaction is removed from the tablet.
+  shared_cache.Erase(committed);
+  ASSERT_EQ(HybridTime::FromMicros(1000), ASSERT_RESULT(GetCommitTime(committed, 2000)));
+  ASSERT_EQ(2, txn_status_manager_.num_status_requests());
+
+  // Pending status is not shared.
+  const auto pending = TransactionId::GenerateRandom();
+  txn_status_manager_.Commit(pending, HybridTime::FromMicros(5000));
+  ASSERT_EQ(HybridTime::kMin, ASSERT_RESULT(GetCommitTime(pending, 4000)));
+  ASSERT_EQ(HybridTime::kMin, ASSERT_RESULT(GetCommitTime(pending, 4000)));
+  ASSERT_EQ(4, txn_status_manager_.num_status_requests());
+  ASSERT_EQ(HybridTime::FromMicros(5000), ASSERT_RESULT(GetCommitTime(pending, 6000)));
+  ASSERT_EQ(5, txn_status_manager_.num_status_requests());
+}
+
+} // namespace docdb
+} // namespace yb
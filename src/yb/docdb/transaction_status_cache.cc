@@ -23,6 +23,18 @@ using namespace std::literals;
 DEFINE_bool(TEST_transaction_allow_rerequest_status, true,
             "Allow rerequest transaction status when TryAgain is received.");
 
+METRIC_DEFINE_counter(
+    tablet, shared_transaction_status_cache_hits,
+    "Shared transaction status cache hits",
+    yb::MetricUnit::kCacheHits,
+    "Number of transaction commit times found in the tablet level transaction status cache.");
+METRIC_DEFINE_counter(
+    tablet, shared_transaction_status_cache_misses,
+    "Shared transaction status cache misses",
+    yb::MetricUnit::kCacheQueries,
+    "Number of transaction statuses that were not found in the tablet level transaction status "
+    "cache, and were requested from the transaction coordinator.");
+
 namespace yb {
 namespace docdb {
 
@@ -39,7 +51,8 @@ YB_DEFINE_ENUM(CommitTimeSource,
                ((kLocalAfter, 2)) // Transaction was committed locally after the remote check.
                ((kRemoteAborted, 3)) // Coordinator responded that transaction was aborted.
                ((kRemoteCommitted, 4)) // Coordinator responded that transaction was committed.
-               ((kRemotePending, 5))); // Coordinator responded that transaction is pending.
+               ((kRemotePending, 5)) // Coordinator responded that transaction is pending.
+               ((kSharedCache, 6))); // Commit time found in the tablet level cache.
 
 } // namespace
 
@@ -84,6 +97,18 @@ Result<TransactionStatusCache::GetCommitTimeResult> TransactionStatusCache::DoGe
     };
   }
 
+  auto* shared_cache = txn_context_opt_->txn_status_manager.shared_status_cache();
+  if (shared_cache) {
+    auto cached_commit_time = shared_cache->GetCommitTime(transaction_id);
+    if (cached_commit_time.is_valid()) {
+      return GetCommitTimeResult {
+        .commit_time = cached_commit_time <= read_time_.global_limit ? cached_commit_time
+                                                                     : HybridTime::kMin,
+        .source = CommitTimeSource::kSharedCache,
+      };
+    }
+  }
+
   // Since TransactionStatusResult does not have default ctor we should init it somehow.
   TransactionStatusResult txn_status(TransactionStatus::ABORTED, HybridTime());
   const auto kMaxWait = 50ms * kTimeMultiplier;
@@ -175,6 +200,9 @@ Result<TransactionStatusCache::GetCommitTimeResult> TransactionStatusCache::DoGe
   }
 
   if (txn_status.status == TransactionStatus::COMMITTED) {
+    if (shared_cache) {
+      shared_cache->PutCommitTime(transaction_id, txn_status.status_time);
+    }
     return GetCommitTimeResult {
       .commit_time = txn_status.status_time,
       .source = CommitTimeSource::kRemoteCommitted,
@@ -187,5 +215,50 @@ Result<TransactionStatusCache::GetCommitTimeResult> TransactionStatusCache::DoGe
   };
 }
 
+SharedTransactionStatusCache::SharedTransactionStatusCache(
+    size_t capacity, const scoped_refptr<MetricEntity>& metric_entity)
+    : capacity_(capacity) {
+  if (metric_entity) {
+    hits_ = METRIC_shared_transaction_status_cache_hits.Instantiate(metric_entity);
+    misses_ = METRIC_shared_transaction_status_cache_misses.Instantiate(metric_entity);
+  }
+}
+
+HybridTime SharedTransactionStatusCache::GetCommitTime(const TransactionId& transaction_id) {
+  HybridTime result = HybridTime::kInvalid;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& index = entries_.get<TransactionIdTag>();
+    auto it = index.find(transaction_id);
+    if (it != index.end()) {
+      result = it->commit_time;
+    }
+  }
+  auto& counter = result.is_valid() ? hits_ : misses_;
+  if (counter) {
+    counter->Increment();
+  }
+  return result;
+}
+
+void SharedTransactionStatusCache::PutCommitTime(
+    const TransactionId& transaction_id, HybridTime commit_time) {
+  if (capacity_ == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto p = entries_.push_front(Entry{transaction_id, commit_time});
+  if (!p.second) {
+    entries_.relocate(entries_.begin(), p.first);
+  } else if (entries_.size() > capacity_) {
+    entries_.pop_back();
+  }
+}
+
+void SharedTransactionStatusCache::Erase(const TransactionId& transaction_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.get<TransactionIdTag>().erase(transaction_id);
+}
+
 } // namespace docdb
 } // namespace yb
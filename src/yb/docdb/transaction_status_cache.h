@@ -14,9 +14,20 @@
 #ifndef YB_DOCDB_TRANSACTION_STATUS_CACHE_H
 #define YB_DOCDB_TRANSACTION_STATUS_CACHE_H
 
+#include <mutex>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+
 #include "yb/common/read_hybrid_time.h"
 #include "yb/common/transaction.h"
 
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/metrics.h"
+
 namespace yb {
 namespace docdb {
 
@@ -45,6 +56,50 @@ class TransactionStatusCache {
   std::unordered_map<TransactionId, HybridTime, TransactionIdHash> cache_;
 };
 
+// Tablet level cache of commit times of transactions, that were resolved as committed by the
+// transaction coordinator. Shared by all reads of the tablet, so concurrent reads that meet intents
+// of the same committed but not yet applied transaction don't request its status again.
+// Stores at most capacity recently added transactions. Thread safe.
+class SharedTransactionStatusCache {
+ public:
+  SharedTransactionStatusCache(size_t capacity, const scoped_refptr<MetricEntity>& metric_entity);
+
+  // Returns commit time of the transaction, or HybridTime::kInvalid if it is not cached.
+  HybridTime GetCommitTime(const TransactionId& transaction_id);
+
+  void PutCommitTime(const TransactionId& transaction_id, HybridTime commit_time);
+
+  // Should be invoked when transaction is removed from the tablet, i.e. applied or cleaned up.
+  void Erase(const TransactionId& transaction_id);
+
+ private:
+  struct Entry {
+    TransactionId transaction_id;
+    HybridTime commit_time;
+  };
+
+  class TransactionIdTag;
+
+  using Entries = boost::multi_index_container<
+      Entry,
+      boost::multi_index::indexed_by<
+        boost::multi_index::sequenced<>,
+        boost::multi_index::hashed_unique<
+          boost::multi_index::tag<TransactionIdTag>,
+          boost::multi_index::member<Entry, TransactionId, &Entry::transaction_id>,
+          TransactionIdHash
+        >
+      >
+  >;
+
+  const size_t capacity_;
+  scoped_refptr<Counter> hits_;
+  scoped_refptr<Counter> misses_;
+
+  std::mutex mutex_;
+  Entries entries_ GUARDED_BY(mutex_);
+};
+
 } // namespace docdb
 } // namespace yb
 
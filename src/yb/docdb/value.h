@@ -44,6 +44,9 @@ class Value {
   }
 
   static const uint64_t kTtlFlag = 0x1;
+  // An int64 value that is added to the older versions of a counter column, down to its latest
+  // full value.
+  static const uint64_t kCounterDeltaFlag = 0x2;
 
   static const MonoDelta kMaxTtl;
   // kResetTtl is useful for CQL when zero TTL indicates no TTL.
@@ -145,6 +148,7 @@ class Value {
 
   // A place to store various merge flags; in particular, the MERGE flag currently used for TTL.
   // 0x1 = TTL-only entry
+  // 0x2 = Counter delta entry
   // 0x3 = Value-only entry (potentially)
   uint64_t merge_flags_;
 
@@ -0,0 +1,128 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/value_log.h"
+
+#include "yb/docdb/value.h"
+
+#include "yb/rocksdb/cache.h"
+
+#include "yb/util/env.h"
+#include "yb/util/path_util.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(docdb_value_log_file_size_mb);
+
+namespace yb {
+namespace docdb {
+
+class ValueLogTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    dir_ = GetTestPath("value_log");
+    ASSERT_OK(env_->CreateDir(dir_));
+    value_log_ = OpenValueLog(dir_);
+  }
+
+  std::unique_ptr<ValueLog> OpenValueLog(const std::string& dir) {
+    auto result = std::make_unique<ValueLog>(env_.get(), dir, block_cache_, "" /* log_prefix */);
+    CHECK_OK(result->Open());
+    return result;
+  }
+
+  std::string Read(ValueLog* value_log, const ValueLogReference& reference) {
+    std::string result;
+    CHECK_OK(value_log->Read(reference, &result));
+    return result;
+  }
+
+  std::string dir_;
+  std::shared_ptr<rocksdb::Cache> block_cache_ = rocksdb::NewLRUCache(1_MB);
+  std::unique_ptr<ValueLog> value_log_;
+};
+
+TEST_F(ValueLogTest, AppendAndRead) {
+  std::vector<std::pair<ValueLogReference, std::string>> values;
+  for (int i = 0; i != 100; ++i) {
+    auto value = RandomHumanReadableString(100 + i);
+    values.emplace_back(ASSERT_RESULT(value_log_->Append(value)), value);
+  }
+  ASSERT_OK(value_log_->Sync());
+
+  for (const auto& p : values) {
+    ASSERT_EQ(Read(value_log_.get(), p.first), p.second);
+    // Second read is served by the block cache.
+    ASSERT_EQ(Read(value_log_.get(), p.first), p.second);
+  }
+
+  // New values are appended to a new file after reopen.
+  value_log_ = OpenValueLog(dir_);
+  auto reference = ASSERT_RESULT(value_log_->Append("new value"));
+  ASSERT_GT(reference.file_number, values.front().first.file_number);
+  ASSERT_EQ(Read(value_log_.get(), values.back().first), values.back().second);
+}
+
+TEST_F(ValueLogTest, Resolve) {
+  const Slice kValue("value stored in the value log");
+  auto reference = ASSERT_RESULT(value_log_->Append(kValue));
+  ASSERT_OK(value_log_->Sync());
+  std::string encoded_reference;
+  reference.AppendEncoded(&encoded_reference);
+  ASSERT_EQ(ASSERT_RESULT(ValueLogReference::Decode(encoded_reference)).ToString(),
+            reference.ToString());
+
+  // Control fields stay in the encoded value.
+  Value value(PrimitiveValue(), MonoDelta::FromSeconds(10));
+  Slice reference_slice(encoded_reference);
+  const auto encoded_value = value.Encode(&reference_slice);
+  ASSERT_NE(ValueLog::FindReference(encoded_value), nullptr);
+  ASSERT_EQ(ValueLog::FindReference(value.Encode(&kValue)), nullptr);
+
+  std::string resolved;
+  ASSERT_OK(value_log_->Resolve(encoded_value, &resolved));
+  ASSERT_EQ(resolved.size(), encoded_value.size() - encoded_reference.size() + kValue.size());
+  ASSERT_EQ(resolved, value.Encode(&kValue));
+}
+
+TEST_F(ValueLogTest, LinkFiles) {
+  FLAGS_docdb_value_log_file_size_mb = 1;
+  std::vector<std::pair<ValueLogReference, std::string>> values;
+  for (int i = 0; i != 30; ++i) {
+    auto value = RandomHumanReadableString(100_KB);
+    values.emplace_back(ASSERT_RESULT(value_log_->Append(value)), value);
+  }
+  ASSERT_GT(values.back().first.file_number, values.front().first.file_number);
+
+  const auto checkpoint_dir = GetTestPath("checkpoint");
+  ASSERT_OK(env_->CreateDir(checkpoint_dir));
+  ASSERT_OK(value_log_->LinkFiles(checkpoint_dir));
+  // Linked files are not changed by following appends.
+  auto reference = ASSERT_RESULT(value_log_->Append("new value"));
+  ASSERT_GT(reference.file_number, values.back().first.file_number);
+  ASSERT_FALSE(env_->FileExists(ValueLog::FileName(checkpoint_dir, reference.file_number)));
+
+  auto checkpoint_value_log = OpenValueLog(checkpoint_dir);
+  for (const auto& p : values) {
+    ASSERT_EQ(Read(checkpoint_value_log.get(), p.first), p.second);
+  }
+
+  ASSERT_OK(value_log_->DeleteAllFiles());
+  ASSERT_FALSE(env_->FileExists(ValueLog::FileName(dir_, reference.file_number)));
+  ASSERT_EQ(Read(checkpoint_value_log.get(), values.front().first), values.front().second);
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,400 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/value_log.h"
+
+#include <cinttypes>
+#include <unordered_set>
+
+#include <boost/optional.hpp>
+
+#include "yb/docdb/value.h"
+#include "yb/docdb/value_type.h"
+
+#include "yb/gutil/endian.h"
+#include "yb/gutil/stringprintf.h"
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/strings/util.h"
+
+#include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/db/filename.h"
+#include "yb/rocksdb/metadata.h"
+#include "yb/rocksdb/util/coding.h"
+
+#include "yb/util/crc.h"
+#include "yb/util/env.h"
+#include "yb/util/env_util.h"
+#include "yb/util/fast_varint.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/path_util.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int32(docdb_value_log_min_value_size, 0,
+             "Values of the regular RocksDB not less than this size are moved to the value log "
+             "by compactions, so following compactions rewrite only a reference to the value. "
+             "0 to disable.");
+TAG_FLAG(docdb_value_log_min_value_size, advanced);
+TAG_FLAG(docdb_value_log_min_value_size, runtime);
+
+DEFINE_int32(docdb_value_log_file_size_mb, 64,
+             "Size of a value log file, after which values are appended to a new file.");
+TAG_FLAG(docdb_value_log_file_size_mb, advanced);
+TAG_FLAG(docdb_value_log_file_size_mb, runtime);
+
+namespace yb {
+namespace docdb {
+
+boost::optional<uint64_t> MinValueLogFileNumber(const rocksdb::UserBoundaryValues& smallest);
+
+namespace {
+
+constexpr size_t kChecksumSize = sizeof(uint32_t);
+
+// Control fields and the reference are much smaller, so bigger values are not checked for the
+// reference.
+constexpr size_t kMaxValueWithReferenceSize = 96;
+
+void DeleteCachedValue(const Slice& key, void* value) {
+  delete static_cast<std::string*>(value);
+}
+
+bool StartsWithControlField(char first_byte) {
+  switch (first_byte) {
+    case ValueTypeAsChar::kMergeFlags: FALLTHROUGH_INTENDED;
+    case ValueTypeAsChar::kHybridTime: FALLTHROUGH_INTENDED;
+    case ValueTypeAsChar::kTtl: FALLTHROUGH_INTENDED;
+    case ValueTypeAsChar::kUserTimestamp:
+      return true;
+  }
+  return false;
+}
+
+} // namespace
+
+void ValueLogReference::AppendEncoded(std::string* out) const {
+  out->push_back(ValueTypeAsChar::kValueLogReference);
+  util::FastAppendUnsignedVarIntToStr(file_number, out);
+  util::FastAppendUnsignedVarIntToStr(offset, out);
+  util::FastAppendUnsignedVarIntToStr(size, out);
+}
+
+Result<ValueLogReference> ValueLogReference::Decode(Slice slice) {
+  if (!slice.TryConsumeByte(ValueTypeAsChar::kValueLogReference)) {
+    return STATUS_FORMAT(Corruption, "Value log reference expected: $0", slice.ToDebugHexString());
+  }
+  ValueLogReference result;
+  result.file_number = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&slice));
+  result.offset = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&slice));
+  result.size = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&slice));
+  if (!slice.empty()) {
+    return STATUS_FORMAT(
+        Corruption, "Extra data after value log reference $0: $1", result,
+        slice.ToDebugHexString());
+  }
+  return result;
+}
+
+std::string ValueLogReference::ToString() const {
+  return Format("{ file_number: $0 offset: $1 size: $2 }", file_number, offset, size);
+}
+
+ValueLog::ValueLog(Env* env, std::string dir, std::shared_ptr<rocksdb::Cache> block_cache,
+                   std::string log_prefix)
+    : env_(env), dir_(std::move(dir)), block_cache_(std::move(block_cache)),
+      log_prefix_(std::move(log_prefix)) {
+  if (block_cache_) {
+    // Same as prefixes of SST files, so cache keys of values and blocks do not collide.
+    rocksdb::PutVarint64(&cache_key_prefix_, block_cache_->NewId());
+  }
+}
+
+ValueLog::~ValueLog() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  WARN_NOT_OK(CloseCurrentFile(), LogPrefix() + "Failed to close value log file");
+}
+
+std::string ValueLog::FileName(const std::string& dir, uint64_t file_number) {
+  return JoinPathSegments(dir, StringPrintf("%06" PRIu64 "%s", file_number, kFileExtension));
+}
+
+Status ValueLog::Open() {
+  std::vector<std::string> children;
+  RETURN_NOT_OK(env_->GetChildren(dir_, ExcludeDots::kTrue, &children));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& child : children) {
+    if (!HasSuffixString(child, kFileExtension)) {
+      continue;
+    }
+    uint64_t file_number;
+    if (!safe_strtou64(child.substr(0, child.size() - strlen(kFileExtension)), &file_number)) {
+      LOG_WITH_PREFIX(WARNING) << "Unexpected value log file name: " << child;
+      continue;
+    }
+    file_numbers_.insert(file_number);
+    next_file_number_ = std::max(next_file_number_, file_number + 1);
+  }
+  has_files_.store(!file_numbers_.empty(), std::memory_order_release);
+  LOG_WITH_PREFIX(INFO) << "Opened value log in " << dir_ << ", files: " << file_numbers_.size();
+  return Status::OK();
+}
+
+Result<ValueLogReference> ValueLog::Append(const Slice& value, uint64_t* pinned_file_number) {
+  char checksum[kChecksumSize];
+  LittleEndian::Store32(checksum, crc::Crc32c(value.data(), value.size()));
+  const Slice slices[] = { value, Slice(checksum, sizeof(checksum)) };
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (current_file_ && current_file_->Size() >= FLAGS_docdb_value_log_file_size_mb * 1_MB) {
+    RETURN_NOT_OK(CloseCurrentFile());
+  }
+  if (!current_file_) {
+    const auto file_number = next_file_number_;
+    RETURN_NOT_OK(env_->NewWritableFile(FileName(dir_, file_number), &current_file_));
+    ++next_file_number_;
+    current_file_number_ = file_number;
+    file_numbers_.insert(file_number);
+    has_files_.store(true, std::memory_order_release);
+    // The new file should be present in the directory before it is referenced by SST files.
+    RETURN_NOT_OK(env_->SyncDir(dir_));
+  }
+
+  ValueLogReference reference;
+  reference.file_number = current_file_number_;
+  reference.offset = current_file_->Size();
+  reference.size = value.size();
+  auto status = current_file_->AppendSlices(slices, arraysize(slices));
+  if (!status.ok()) {
+    // The size of the file is unknown after the failed append, so the following values are
+    // appended to a new file.
+    WARN_NOT_OK(current_file_->Close(), LogPrefix() + "Failed to close value log file");
+    current_file_.reset();
+    return status;
+  }
+  if (pinned_file_number && *pinned_file_number == 0) {
+    pinned_files_.insert(current_file_number_);
+    *pinned_file_number = current_file_number_;
+  }
+  return reference;
+}
+
+void ValueLog::Unpin(uint64_t file_number) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = pinned_files_.find(file_number);
+  if (it == pinned_files_.end()) {
+    LOG_WITH_PREFIX(DFATAL) << "Unpin of not pinned file " << file_number;
+    return;
+  }
+  pinned_files_.erase(it);
+}
+
+Status ValueLog::Sync() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return current_file_ ? current_file_->Sync() : Status::OK();
+}
+
+Status ValueLog::CloseCurrentFile() {
+  if (!current_file_) {
+    return Status::OK();
+  }
+  auto file = std::move(current_file_);
+  RETURN_NOT_OK(file->Sync());
+  return file->Close();
+}
+
+const char* ValueLog::FindReference(const Slice& value) {
+  if (value.size() > kMaxValueWithReferenceSize) {
+    return nullptr;
+  }
+  const char first_byte = value.empty() ? ValueTypeAsChar::kInvalid : value[0];
+  if (first_byte == ValueTypeAsChar::kValueLogReference) {
+    return value.cdata();
+  }
+  if (!StartsWithControlField(first_byte)) {
+    return nullptr;
+  }
+  Value control_fields;
+  Slice slice = value;
+  if (!control_fields.DecodeControlFields(&slice).ok() ||
+      slice.FirstByteOr(ValueTypeAsChar::kInvalid) != ValueTypeAsChar::kValueLogReference) {
+    return nullptr;
+  }
+  return slice.cdata();
+}
+
+Status ValueLog::Resolve(const Slice& value, std::string* out) {
+  const char* reference_start = FindReference(value);
+  if (!reference_start) {
+    return STATUS_FORMAT(
+        InvalidArgument, "Value does not reference value log: $0", value.ToDebugHexString());
+  }
+  auto reference = VERIFY_RESULT(ValueLogReference::Decode(Slice(reference_start, value.cend())));
+  out->assign(value.cdata(), reference_start);
+  return Read(reference, out);
+}
+
+Status ValueLog::Read(const ValueLogReference& reference, std::string* out) {
+  std::string cache_key;
+  if (block_cache_) {
+    cache_key = cache_key_prefix_;
+    rocksdb::PutVarint64(&cache_key, reference.file_number);
+    rocksdb::PutVarint64(&cache_key, reference.offset);
+    auto* handle = block_cache_->Lookup(cache_key, rocksdb::kDefaultQueryId);
+    if (handle) {
+      out->append(*static_cast<const std::string*>(block_cache_->Value(handle)));
+      block_cache_->Release(handle);
+      return Status::OK();
+    }
+  }
+
+  auto reader = VERIFY_RESULT(GetReader(reference.file_number));
+  std::string buffer;
+  buffer.resize(reference.size + kChecksumSize);
+  Slice data;
+  RETURN_NOT_OK_PREPEND(
+      env_util::ReadFully(
+          reader.get(), reference.offset, buffer.size(), &data,
+          reinterpret_cast<uint8_t*>(&buffer[0])),
+      Format("Failed to read value log $0", reference));
+  const auto expected_checksum = LittleEndian::Load32(data.data() + reference.size);
+  const auto checksum = crc::Crc32c(data.data(), reference.size);
+  if (checksum != expected_checksum) {
+    return STATUS_FORMAT(
+        Corruption, "Wrong checksum of value log $0: $1, expected: $2", reference, checksum,
+        expected_checksum);
+  }
+  data.remove_suffix(kChecksumSize);
+
+  out->append(data.cdata(), data.size());
+  if (block_cache_) {
+    // Value is deleted by the cache when it could not be inserted.
+    auto* value = new std::string(data.cdata(), data.size());
+    block_cache_->Insert(
+        cache_key, rocksdb::kDefaultQueryId, value, value->size(), &DeleteCachedValue);
+  }
+  return Status::OK();
+}
+
+Result<std::shared_ptr<RandomAccessFile>> ValueLog::GetReader(uint64_t file_number) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = readers_.find(file_number);
+  if (it != readers_.end()) {
+    return it->second;
+  }
+  if (file_numbers_.count(file_number) == 0) {
+    return STATUS_FORMAT(NotFound, "Value log file $0 does not exist", file_number);
+  }
+  std::unique_ptr<RandomAccessFile> reader;
+  RETURN_NOT_OK(env_->NewRandomAccessFile(FileName(dir_, file_number), &reader));
+  std::shared_ptr<RandomAccessFile> result(std::move(reader));
+  readers_.emplace(file_number, result);
+  return result;
+}
+
+Status ValueLog::DeleteObsoleteFiles(rocksdb::DB* db) {
+  std::lock_guard<std::mutex> deletion_lock(deletion_mutex_);
+
+  // Values appended after this point are not referenced by live SST files listed below, so
+  // newer files are always kept. Pinned files could be referenced by SST files that are not
+  // created yet, so they are kept as well.
+  uint64_t min_referenced_file_number;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_numbers_.empty()) {
+      return Status::OK();
+    }
+    min_referenced_file_number = current_file_ ? current_file_number_ : next_file_number_;
+    if (!pinned_files_.empty()) {
+      min_referenced_file_number = std::min(min_referenced_file_number, *pinned_files_.begin());
+    }
+  }
+
+  std::vector<std::string> children;
+  RETURN_NOT_OK(env_->GetChildren(dir_, ExcludeDots::kTrue, &children));
+  std::unordered_set<uint64_t> sst_files;
+  for (const auto& child : children) {
+    uint64_t number;
+    rocksdb::FileType type;
+    if (rocksdb::ParseFileName(child, &number, &type) && type == rocksdb::kTableFile) {
+      sst_files.insert(number);
+    }
+  }
+
+  for (const auto& file : db->GetLiveFilesMetaData()) {
+    sst_files.erase(rocksdb::TableFileNameToNumber(file.name));
+    auto file_number = MinValueLogFileNumber(file.smallest.user_values);
+    if (file_number) {
+      min_referenced_file_number = std::min(min_referenced_file_number, *file_number);
+    }
+  }
+
+  // SST files that are being written or are not deleted yet, could reference older files.
+  if (!sst_files.empty()) {
+    VLOG_WITH_PREFIX(1) << "Skip deleting value log files, not live SST files: "
+                        << sst_files.size();
+    return Status::OK();
+  }
+
+  std::vector<uint64_t> obsolete_files;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = file_numbers_.begin();
+         it != file_numbers_.end() && *it < min_referenced_file_number;) {
+      obsolete_files.push_back(*it);
+      readers_.erase(*it);
+      it = file_numbers_.erase(it);
+    }
+    has_files_.store(!file_numbers_.empty(), std::memory_order_release);
+  }
+
+  for (auto file_number : obsolete_files) {
+    LOG_WITH_PREFIX(INFO) << "Deleting obsolete value log file " << file_number;
+    RETURN_NOT_OK(env_->DeleteFile(FileName(dir_, file_number)));
+  }
+  return Status::OK();
+}
+
+std::unique_lock<std::mutex> ValueLog::LockFileDeletions() {
+  return std::unique_lock<std::mutex>(deletion_mutex_);
+}
+
+Status ValueLog::LinkFiles(const std::string& dest_dir) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  RETURN_NOT_OK(CloseCurrentFile());
+  for (auto file_number : file_numbers_) {
+    RETURN_NOT_OK(env_->LinkFile(FileName(dir_, file_number), FileName(dest_dir, file_number)));
+  }
+  return Status::OK();
+}
+
+Status ValueLog::DeleteAllFiles() {
+  std::lock_guard<std::mutex> deletion_lock(deletion_mutex_);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (current_file_) {
+    WARN_NOT_OK(current_file_->Close(), LogPrefix() + "Failed to close value log file");
+    current_file_.reset();
+  }
+  readers_.clear();
+  for (auto file_number : file_numbers_) {
+    RETURN_NOT_OK(env_->DeleteFile(FileName(dir_, file_number)));
+  }
+  file_numbers_.clear();
+  has_files_.store(false, std::memory_order_release);
+  return Status::OK();
+}
+
+} // namespace docdb
+} // namespace yb
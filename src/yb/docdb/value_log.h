@@ -0,0 +1,158 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_VALUE_LOG_H
+#define YB_DOCDB_VALUE_LOG_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+class Cache;
+class DB;
+
+}
+
+namespace yb {
+
+class Env;
+class RandomAccessFile;
+class WritableFile;
+
+namespace docdb {
+
+// Location of a value stored in the value log.
+struct ValueLogReference {
+  uint64_t file_number = 0;
+  uint64_t offset = 0;
+  uint64_t size = 0;
+
+  // Appends ValueType::kValueLogReference followed by the encoded location.
+  void AppendEncoded(std::string* out) const;
+
+  // Decodes the reference from the slice, that starts with ValueType::kValueLogReference.
+  static Result<ValueLogReference> Decode(Slice slice);
+
+  std::string ToString() const;
+};
+
+// Append-only files of the regular RocksDB of a tablet, that store large values separately from
+// SST files. The compaction filter moves values not less than docdb_value_log_min_value_size to
+// the value log and keeps only their reference, so following compactions rewrite the reference
+// instead of the value. The control fields of a value are kept in RocksDB, so TTL and overwrite
+// handling of compactions does not have to read the value log.
+//
+// A value is stored with its checksum, and is read through the block cache. Files older than
+// the oldest reference of all SST files are deleted by DeleteObsoleteFiles. Thread safe.
+class ValueLog {
+ public:
+  static constexpr const char* kFileExtension = ".vlog";
+
+  ValueLog(Env* env, std::string dir, std::shared_ptr<rocksdb::Cache> block_cache,
+           std::string log_prefix);
+  ~ValueLog();
+
+  // Loads numbers of existing files, new values are appended to a new file.
+  CHECKED_STATUS Open();
+
+  // Appends the value to the current file, starting a new file when the current one reaches
+  // docdb_value_log_file_size_mb. The value is durable after the following Sync.
+  //
+  // The value is referenced only by SST files of the writer, e.g. a compaction, that could be not
+  // created yet. So when pinned_file_number is not null and contains 0, the file that the value is
+  // appended to is pinned and its number is stored to pinned_file_number. The pinned file and the
+  // following ones are not deleted by DeleteObsoleteFiles until Unpin is called.
+  Result<ValueLogReference> Append(const Slice& value, uint64_t* pinned_file_number = nullptr);
+
+  void Unpin(uint64_t file_number);
+
+  CHECKED_STATUS Sync();
+
+  // Returns the position of ValueType::kValueLogReference in the encoded RocksDB value, or nullptr
+  // if the value is not stored in the value log.
+  static const char* FindReference(const Slice& value);
+
+  // Returns false when there are no value log files, so RocksDB values could not reference them
+  // and readers do not have to look for references.
+  bool MayHaveReferences() const {
+    return has_files_.load(std::memory_order_acquire);
+  }
+
+  // Replaces the reference in the encoded RocksDB value with the referenced value, and stores the
+  // result to out.
+  CHECKED_STATUS Resolve(const Slice& value, std::string* out);
+
+  // Appends the referenced value to out, verifying its checksum.
+  CHECKED_STATUS Read(const ValueLogReference& reference, std::string* out);
+
+  // Deletes files that are not referenced by SST files of db. Files are kept when there are SST
+  // files that are not live anymore, but are not deleted yet, since they could be still read.
+  CHECKED_STATUS DeleteObsoleteFiles(rocksdb::DB* db);
+
+  // Files are not deleted by DeleteObsoleteFiles while the returned lock is held, e.g. while the
+  // RocksDB checkpoint is created.
+  std::unique_lock<std::mutex> LockFileDeletions();
+
+  // Creates hard links to all files in the dest_dir. New values are appended to a new file, so
+  // linked files are not changed.
+  CHECKED_STATUS LinkFiles(const std::string& dest_dir);
+
+  // Deletes all files, when RocksDB is destroyed.
+  CHECKED_STATUS DeleteAllFiles();
+
+  static std::string FileName(const std::string& dir, uint64_t file_number);
+
+ private:
+  CHECKED_STATUS CloseCurrentFile() REQUIRES(mutex_);
+
+  Result<std::shared_ptr<RandomAccessFile>> GetReader(uint64_t file_number);
+
+  const std::string& LogPrefix() const {
+    return log_prefix_;
+  }
+
+  Env* const env_;
+  const std::string dir_;
+  const std::shared_ptr<rocksdb::Cache> block_cache_;
+  const std::string log_prefix_;
+  // Prefix of block cache keys of this value log.
+  std::string cache_key_prefix_;
+
+  std::mutex deletion_mutex_;
+
+  std::mutex mutex_;
+  std::set<uint64_t> file_numbers_ GUARDED_BY(mutex_);
+  uint64_t next_file_number_ GUARDED_BY(mutex_) = 1;
+  std::unique_ptr<WritableFile> current_file_ GUARDED_BY(mutex_);
+  uint64_t current_file_number_ GUARDED_BY(mutex_) = 0;
+  std::map<uint64_t, std::shared_ptr<RandomAccessFile>> readers_ GUARDED_BY(mutex_);
+  // Files pinned by writers, see Append.
+  std::multiset<uint64_t> pinned_files_ GUARDED_BY(mutex_);
+  // Whether file_numbers_ is not empty, checked by readers without locking mutex_.
+  std::atomic<bool> has_files_{false};
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_VALUE_LOG_H
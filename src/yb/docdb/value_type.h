@@ -103,6 +103,8 @@ namespace docdb {
     ((kString, 'S'))  /* ASCII code 83 */ \
     ((kTrue, 'T'))  /* ASCII code 84 */ \
     ((kUInt64, 'U')) /* ASCII code 85 */ \
+    /* Reference to a value stored in the value log, see value_log.h. */ \
+    ((kValueLogReference, 'V')) /* ASCII code 86 */ \
     ((kTombstone, 'X'))  /* ASCII code 88 */ \
     ((kExternalIntents, 'Z')) /* ASCII code 90 */ \
     ((kArrayIndex, '['))  /* ASCII code 91 */ \
@@ -136,6 +138,8 @@ namespace docdb {
     ((kWriteId, 'w')) /* ASCII code 119 */ \
     ((kTransactionId, 'x')) /* ASCII code 120 */ \
     ((kTableId, 'y')) /* ASCII code 121 */ \
+    /* All non-key columns of a row packed into a single value, see packed_row.h. */ \
+    ((kPackedRow, 'z')) /* ASCII code 122 */ \
     \
     ((kObject, '{'))  /* ASCII code 123 */ \
     \
@@ -253,9 +257,9 @@ inline ValueType DecodeValueType(char value_type_byte) {
 }
 
 // Checks if a value is a merge record, meaning it begins with the
-// kMergeFlags value type. Currently, the only merge records supported are
-// TTL records, when the flags value is 0x1. In the future, value
-// merge records may be implemented, such as a +1 merge record for INCR.
+// kMergeFlags value type. Currently, the merge records supported are TTL
+// records, when the flags value is 0x1, and CQL counter deltas, when the
+// flags value is 0x2.
 inline bool IsMergeRecord(const rocksdb::Slice& value) {
   return DecodeValueType(value) == ValueType::kMergeFlags;
 }
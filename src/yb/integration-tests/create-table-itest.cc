@@ -332,6 +332,31 @@ TEST_F(CreateTableITest, TestSpreadReplicasEvenly) {
   ASSERT_GE(avg_num_peers, kNumServers / 2);
 }
 
+// Creates replicas with BatchCreateTablets RPCs, splitting replicas of a tablet server into
+// multiple RPCs.
+TEST_F(CreateTableITest, TestBatchedCreateTabletRpcs) {
+  const int kNumServers = 3;
+  const int kNumTablets = 20;
+  vector<string> ts_flags;
+  vector<string> master_flags;
+  ts_flags.push_back("--never_fsync");
+  master_flags.push_back("--max_tablets_per_create_tablets_rpc=6");
+  ASSERT_NO_FATALS(StartCluster(ts_flags, master_flags, kNumServers));
+
+  ASSERT_OK(client_->CreateNamespaceIfNotExists(kTableName.namespace_name(),
+                                                kTableName.namespace_type()));
+  std::unique_ptr<client::YBTableCreator> table_creator(client_->NewTableCreator());
+  client::YBSchema client_schema(client::YBSchemaFromSchema(GetSimpleTestSchema()));
+  ASSERT_OK(table_creator->table_name(kTableName)
+            .schema(&client_schema)
+            .num_tablets(kNumTablets)
+            .Create());
+
+  for (int ts_idx = 0; ts_idx < kNumServers; ts_idx++) {
+    ASSERT_EQ(inspect_->ListTabletsOnTS(ts_idx).size(), kNumTablets);
+  }
+}
+
 TEST_F(CreateTableITest, TestNoAllocBlacklist) {
   const int kNumServers = 4;
   const int kNumTablets = 24;
@@ -256,7 +256,7 @@ TEST_F(CreateTableStressTest, GetTableLocationsBenchmark) {
 
   LOG(INFO) << "LOCK PROFILE\n" << profile.str();
   LOG(INFO) << "BENCHMARK HISTOGRAM:";
-  hist->histogram()->DumpHumanReadable(&LOG(INFO));
+  hist->Snapshot()->DumpHumanReadable(&LOG(INFO));
 }
 
 class CreateMultiHBTableStressTest : public CreateTableStressTest,
@@ -1703,6 +1703,51 @@ TEST_F(RaftConsensusITest, TestAutomaticLeaderElection) {
   ASSERT_ALL_REPLICAS_AGREE(FLAGS_client_inserts_per_thread * kFinalNumReplicas);
 }
 
+// Test replication and leader failover with heartbeats batched between tablet servers.
+TEST_F(RaftConsensusITest, TestMultiRaftHeartbeatBatcher) {
+  ASSERT_NO_FATALS(BuildAndStart({"--enable_multi_raft_heartbeat_batcher=true"}));
+
+  ASSERT_NO_FATALS(InsertTestRowsRemoteThread(
+      0, FLAGS_client_inserts_per_thread, FLAGS_client_num_batches_per_thread,
+      vector<CountDownLatch*>()));
+
+  TServerDetails* leader;
+  ASSERT_OK(GetLeaderReplicaWithRetries(tablet_id_, &leader));
+  auto* leader_ts = cluster_->tablet_server_by_uuid(leader->uuid());
+  leader_ts->Shutdown();
+  ASSERT_OK(GetLeaderReplicaWithRetries(tablet_id_, &leader));
+
+  ASSERT_NO_FATALS(InsertTestRowsRemoteThread(
+      FLAGS_client_inserts_per_thread, FLAGS_client_inserts_per_thread,
+      FLAGS_client_num_batches_per_thread, vector<CountDownLatch*>()));
+
+  ASSERT_OK(leader_ts->Restart());
+  ASSERT_ALL_REPLICAS_AGREE(FLAGS_client_inserts_per_thread * 2);
+}
+
+// Writes are applied on the apply pipeline, while the NO_OP of the new leader is applied after them
+// under the replica state lock.
+TEST_F(RaftConsensusITest, TestPipelinedApply) {
+  ASSERT_NO_FATALS(BuildAndStart({"--enable_pipelined_apply=true"}));
+
+  ASSERT_NO_FATALS(InsertTestRowsRemoteThread(
+      0, FLAGS_client_inserts_per_thread, FLAGS_client_num_batches_per_thread,
+      vector<CountDownLatch*>()));
+
+  TServerDetails* leader;
+  ASSERT_OK(GetLeaderReplicaWithRetries(tablet_id_, &leader));
+  auto* leader_ts = cluster_->tablet_server_by_uuid(leader->uuid());
+  leader_ts->Shutdown();
+  ASSERT_OK(GetLeaderReplicaWithRetries(tablet_id_, &leader));
+
+  ASSERT_NO_FATALS(InsertTestRowsRemoteThread(
+      FLAGS_client_inserts_per_thread, FLAGS_client_inserts_per_thread,
+      FLAGS_client_num_batches_per_thread, vector<CountDownLatch*>()));
+
+  ASSERT_OK(leader_ts->Restart());
+  ASSERT_ALL_REPLICAS_AGREE(FLAGS_client_inserts_per_thread * 2);
+}
+
 // Single-replica leader election test.
 TEST_F(RaftConsensusITest, TestAutomaticLeaderElectionOneReplica) {
   FLAGS_num_tablet_servers = 1;
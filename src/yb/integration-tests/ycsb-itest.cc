@@ -0,0 +1,270 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+// YCSB core workloads against a cluster, for comparing performance across versions. Examples:
+//   ycsb-itest --gtest_filter=YcsbITest.Run --ycsb_workload=B --ycsb_record_count=100000
+//       --ycsb_operation_count=1000000 --ycsb_target_ops_per_sec=5000 --ycsb_threads=32
+//       --ycsb_output_json=/tmp/ycsb_b.json
+// With a target rate the run is open-loop: operations are scheduled at the rate regardless of
+// how fast previous ones complete, and latencies are measured from the scheduled start, so they
+// include the queueing delay of an overloaded cluster.
+
+#include <algorithm>
+#include <thread>
+
+#include <gflags/gflags.h>
+
+#include "yb/client/session.h"
+#include "yb/client/table_handle.h"
+#include "yb/client/yb_op.h"
+
+#include "yb/integration-tests/yb_table_test_base.h"
+#include "yb/integration-tests/ycsb_workload.h"
+
+#include "yb/util/env.h"
+#include "yb/util/random_util.h"
+#include "yb/util/test_macros.h"
+
+DEFINE_string(ycsb_workload, "A", "YCSB core workload to run, A to F.");
+DEFINE_string(ycsb_distribution, "",
+              "Overrides the key distribution of the workload: uniform, zipfian, latest or "
+              "hotspot.");
+DEFINE_int64(ycsb_record_count, 1000, "Number of records loaded before running the workload.");
+DEFINE_int64(ycsb_operation_count, 2000, "Number of workload operations.");
+DEFINE_double(ycsb_target_ops_per_sec, 0,
+              "Rate at which operations are started. 0 runs closed-loop, each thread starting "
+              "the next operation once the previous one completes.");
+DEFINE_int32(ycsb_threads, 4, "Number of client threads running operations.");
+DEFINE_int32(ycsb_value_size, 100, "Size of record values in bytes.");
+DEFINE_string(ycsb_output_json, "", "File to write the results to as JSON.");
+DEFINE_bool(ycsb_use_external_mini_cluster, false,
+            "Run the workload against an external mini cluster instead of an in-process one.");
+
+namespace yb {
+namespace ycsb {
+
+namespace {
+
+Result<YcsbDistribution> ParseDistribution(const std::string& name) {
+  for (auto distribution : kYcsbDistributionList) {
+    auto distribution_name = ToString(distribution).substr(1);
+    std::transform(distribution_name.begin(), distribution_name.end(), distribution_name.begin(),
+                   ::tolower);
+    if (name == distribution_name) {
+      return distribution;
+    }
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unknown key distribution: $0", name);
+}
+
+} // namespace
+
+class YcsbITest : public integration_tests::YBTableTestBase {
+ protected:
+  bool use_external_mini_cluster() override { return FLAGS_ycsb_use_external_mini_cluster; }
+
+  void Load(YcsbWorkload* workload);
+  void Run(YcsbWorkload* workload, YcsbStats* stats);
+
+  // Executes the operation, returns whether it succeeded.
+  bool Execute(YcsbOperation op, YcsbWorkload* workload, client::YBSession* session,
+               std::mt19937_64* rng);
+
+  bool Read(const std::string& key, client::YBSession* session);
+  bool Write(const std::string& key, client::YBSession* session, std::mt19937_64* rng);
+  bool Scan(const std::string& start_key, int length, client::YBSession* session);
+};
+
+void YcsbITest::Load(YcsbWorkload* workload) {
+  constexpr int kBatchSize = 100;
+  std::atomic<int64_t> next_index{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i != FLAGS_ycsb_threads; ++i) {
+    threads.emplace_back([this, workload, &next_index] {
+      auto session = NewSession();
+      std::mt19937_64 rng;
+      Seed(&rng);
+      for (;;) {
+        const auto start = next_index.fetch_add(kBatchSize);
+        const auto end = std::min<int64_t>(start + kBatchSize, workload->options().record_count);
+        if (start >= end) {
+          break;
+        }
+        for (auto key_index = start; key_index != end; ++key_index) {
+          auto op = table_.NewInsertOp();
+          QLAddStringHashValue(op->mutable_request(), YcsbWorkload::Key(key_index));
+          table_.AddStringColumnValue(
+              op->mutable_request(), "v", RandomHumanReadableString(FLAGS_ycsb_value_size, &rng));
+          ASSERT_OK(session->Apply(op));
+        }
+        ASSERT_OK(session->Flush());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+void YcsbITest::Run(YcsbWorkload* workload, YcsbStats* stats) {
+  std::atomic<int64_t> next_op{0};
+  const auto start = MonoTime::Now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i != FLAGS_ycsb_threads; ++i) {
+    threads.emplace_back([this, workload, stats, start, &next_op] {
+      auto session = NewSession();
+      std::mt19937_64 rng;
+      Seed(&rng);
+      for (;;) {
+        const auto op_index = next_op.fetch_add(1);
+        if (op_index >= FLAGS_ycsb_operation_count) {
+          break;
+        }
+        // Operations are scheduled at the target rate independently of their completion, so a
+        // slow operation does not hide the latency of the following ones by delaying them.
+        auto op_start = MonoTime::Now();
+        if (FLAGS_ycsb_target_ops_per_sec > 0) {
+          const auto scheduled_start =
+              start + MonoDelta::FromSeconds(op_index / FLAGS_ycsb_target_ops_per_sec);
+          if (scheduled_start > op_start) {
+            SleepFor(scheduled_start - op_start);
+          }
+          op_start = scheduled_start;
+        }
+        const auto op = workload->NextOperation(&rng);
+        const bool success = Execute(op, workload, session.get(), &rng);
+        stats->Record(op, MonoTime::Now() - op_start, success);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+bool YcsbITest::Execute(
+    YcsbOperation op, YcsbWorkload* workload, client::YBSession* session, std::mt19937_64* rng) {
+  switch (op) {
+    case YcsbOperation::kRead:
+      return Read(YcsbWorkload::Key(workload->NextKeyIndex(rng)), session);
+    case YcsbOperation::kUpdate:
+      return Write(YcsbWorkload::Key(workload->NextKeyIndex(rng)), session, rng);
+    case YcsbOperation::kInsert: {
+      const auto key_index = workload->NextInsertKeyIndex();
+      if (!Write(YcsbWorkload::Key(key_index), session, rng)) {
+        return false;
+      }
+      workload->AckInsert(key_index);
+      return true;
+    }
+    case YcsbOperation::kScan:
+      return Scan(YcsbWorkload::Key(workload->NextKeyIndex(rng)),
+                  workload->NextScanLength(rng), session);
+    case YcsbOperation::kReadModifyWrite: {
+      const auto key = YcsbWorkload::Key(workload->NextKeyIndex(rng));
+      return Read(key, session) && Write(key, session, rng);
+    }
+  }
+  FATAL_INVALID_ENUM_VALUE(YcsbOperation, op);
+}
+
+bool YcsbITest::Read(const std::string& key, client::YBSession* session) {
+  auto op = table_.NewReadOp();
+  auto* const req = op->mutable_request();
+  QLAddStringHashValue(req, key);
+  table_.AddColumns({"v"}, req);
+  return session->ApplyAndFlush(op).ok() && op->response().status() == QLResponsePB::YQL_STATUS_OK;
+}
+
+bool YcsbITest::Write(
+    const std::string& key, client::YBSession* session, std::mt19937_64* rng) {
+  auto op = table_.NewInsertOp();
+  QLAddStringHashValue(op->mutable_request(), key);
+  table_.AddStringColumnValue(
+      op->mutable_request(), "v", RandomHumanReadableString(FLAGS_ycsb_value_size, rng));
+  return session->ApplyAndFlush(op).ok() && op->response().status() == QLResponsePB::YQL_STATUS_OK;
+}
+
+bool YcsbITest::Scan(const std::string& start_key, int length, client::YBSession* session) {
+  // Keys are hash partitioned, so the scan reads the rows following the start key in hash order,
+  // as "WHERE token(k) >= token(start_key) LIMIT length". The scan stops at the end of the tablet.
+  auto op = table_.NewReadOp();
+  auto* const req = op->mutable_request();
+  QLAddStringHashValue(req, start_key);
+  QLSetHashCode(req);
+  req->clear_hashed_column_values();
+  req->set_limit(length);
+  table_.AddColumns({"k", "v"}, req);
+  return session->ApplyAndFlush(op).ok() && op->response().status() == QLResponsePB::YQL_STATUS_OK;
+}
+
+TEST_F(YcsbITest, Run) {
+  auto options = ASSERT_RESULT(YcsbWorkloadOptions::Standard(FLAGS_ycsb_workload));
+  if (!FLAGS_ycsb_distribution.empty()) {
+    options.distribution = ASSERT_RESULT(ParseDistribution(FLAGS_ycsb_distribution));
+  }
+  options.record_count = FLAGS_ycsb_record_count;
+
+  YcsbWorkload workload(options);
+  ASSERT_NO_FATALS(Load(&workload));
+
+  YcsbStats stats;
+  const auto start = MonoTime::Now();
+  Run(&workload, &stats);
+  const auto json = stats.ToJson(MonoTime::Now() - start, FLAGS_ycsb_target_ops_per_sec);
+  LOG(INFO) << "YCSB workload " << FLAGS_ycsb_workload << " results: " << json;
+  if (!FLAGS_ycsb_output_json.empty()) {
+    ASSERT_OK(WriteStringToFile(Env::Default(), json, FLAGS_ycsb_output_json));
+  }
+  ASSERT_EQ(stats.TotalErrors(), 0);
+}
+
+TEST(YcsbWorkloadTest, Distributions) {
+  constexpr int64_t kNumRecords = 1000;
+  constexpr int kNumSamples = 100000;
+  std::mt19937_64 rng(42);
+
+  ZipfianGenerator zipfian(kNumRecords);
+  int zipfian_first = 0;
+  for (int i = 0; i != kNumSamples; ++i) {
+    const auto item = zipfian.Next(kNumRecords, &rng);
+    ASSERT_GE(item, 0);
+    ASSERT_LT(item, kNumRecords);
+    zipfian_first += item == 0;
+  }
+  // The most popular of 1000 items gets about 13% of samples with theta 0.99, and 0.1% uniformly.
+  ASSERT_GT(zipfian_first, kNumSamples / 20);
+
+  YcsbWorkloadOptions options;
+  options.record_count = kNumRecords;
+  options.distribution = YcsbDistribution::kHotspot;
+  YcsbWorkload hotspot(options);
+  int hot = 0;
+  for (int i = 0; i != kNumSamples; ++i) {
+    hot += hotspot.NextKeyIndex(&rng) < kNumRecords * options.hotspot_data_fraction;
+  }
+  ASSERT_NEAR(hot, kNumSamples * options.hotspot_operation_fraction, kNumSamples / 100);
+
+  options.distribution = YcsbDistribution::kLatest;
+  YcsbWorkload latest(options);
+  latest.AckInsert(latest.NextInsertKeyIndex());
+  ASSERT_EQ(latest.num_records(), kNumRecords + 1);
+  int newest = 0;
+  for (int i = 0; i != kNumSamples; ++i) {
+    newest += latest.NextKeyIndex(&rng) == kNumRecords;
+  }
+  ASSERT_GT(newest, kNumSamples / 20);
+}
+
+} // namespace ycsb
+} // namespace yb
@@ -0,0 +1,266 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/integration-tests/ycsb_workload.h"
+
+#include <cmath>
+#include <sstream>
+
+#include "yb/util/jsonwriter.h"
+#include "yb/util/random_util.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace ycsb {
+
+namespace {
+
+// Latencies above it are recorded as it.
+constexpr uint64_t kMaxLatencyUs = 60 * 1000 * 1000;
+
+// 64-bit FNV-1a hash of the bytes of the value, as used by YCSB to scramble keys.
+uint64_t FnvHash64(int64_t value) {
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for (int i = 0; i != 8; ++i) {
+    hash ^= value & 0xff;
+    hash *= 1099511628211ULL;
+    value >>= 8;
+  }
+  return hash;
+}
+
+double Zeta(int64_t from, int64_t to, double theta) {
+  double sum = 0;
+  for (int64_t i = from; i < to; ++i) {
+    sum += 1 / std::pow(i + 1, theta);
+  }
+  return sum;
+}
+
+} // namespace
+
+Result<YcsbWorkloadOptions> YcsbWorkloadOptions::Standard(const std::string& name) {
+  YcsbWorkloadOptions result;
+  if (name == "A") {
+    // Update heavy.
+    result.read_proportion = 0.5;
+    result.update_proportion = 0.5;
+  } else if (name == "B") {
+    // Read mostly.
+    result.read_proportion = 0.95;
+    result.update_proportion = 0.05;
+  } else if (name == "C") {
+    // Read only.
+    result.read_proportion = 1;
+  } else if (name == "D") {
+    // Read latest.
+    result.read_proportion = 0.95;
+    result.insert_proportion = 0.05;
+    result.distribution = YcsbDistribution::kLatest;
+  } else if (name == "E") {
+    // Short ranges.
+    result.scan_proportion = 0.95;
+    result.insert_proportion = 0.05;
+  } else if (name == "F") {
+    // Read-modify-write.
+    result.read_proportion = 0.5;
+    result.read_modify_write_proportion = 0.5;
+  } else {
+    return STATUS_FORMAT(InvalidArgument, "Unknown YCSB workload: $0", name);
+  }
+  return result;
+}
+
+ZipfianGenerator::ZipfianGenerator(int64_t num_items, double theta)
+    : theta_(theta), alpha_(1 / (1 - theta)), zeta2_(Zeta(0, 2, theta)) {
+  Resize(num_items);
+}
+
+void ZipfianGenerator::Resize(int64_t num_items) {
+  if (num_items > num_items_) {
+    zetan_ += Zeta(num_items_, num_items, theta_);
+  } else {
+    zetan_ = Zeta(0, num_items, theta_);
+  }
+  num_items_ = num_items;
+  eta_ = (1 - std::pow(2.0 / num_items_, 1 - theta_)) / (1 - zeta2_ / zetan_);
+}
+
+int64_t ZipfianGenerator::Next(int64_t num_items, std::mt19937_64* rng) {
+  if (num_items != num_items_) {
+    Resize(num_items);
+  }
+  const double u = RandomUniformReal<double>(rng);
+  const double uz = u * zetan_;
+  if (uz < 1) {
+    return 0;
+  }
+  if (uz < 1 + std::pow(0.5, theta_)) {
+    return std::min<int64_t>(1, num_items_ - 1);
+  }
+  const auto result = static_cast<int64_t>(num_items_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+  return std::min(result, num_items_ - 1);
+}
+
+YcsbWorkload::YcsbWorkload(const YcsbWorkloadOptions& options)
+    : options_(options),
+      num_records_(options.record_count),
+      next_insert_index_(options.record_count),
+      zipfian_(std::max<int64_t>(options.record_count, 1)) {
+  total_proportion_ = options_.read_proportion + options_.update_proportion +
+                      options_.insert_proportion + options_.scan_proportion +
+                      options_.read_modify_write_proportion;
+}
+
+YcsbOperation YcsbWorkload::NextOperation(std::mt19937_64* rng) const {
+  double value = RandomUniformReal<double>(0, total_proportion_, rng);
+  const std::pair<double, YcsbOperation> proportions[] = {
+    {options_.read_proportion, YcsbOperation::kRead},
+    {options_.update_proportion, YcsbOperation::kUpdate},
+    {options_.insert_proportion, YcsbOperation::kInsert},
+    {options_.scan_proportion, YcsbOperation::kScan},
+  };
+  for (const auto& proportion : proportions) {
+    if (value < proportion.first) {
+      return proportion.second;
+    }
+    value -= proportion.first;
+  }
+  return YcsbOperation::kReadModifyWrite;
+}
+
+int64_t YcsbWorkload::NextKeyIndex(std::mt19937_64* rng) {
+  const int64_t num_records = std::max<int64_t>(this->num_records(), 1);
+  switch (options_.distribution) {
+    case YcsbDistribution::kUniform:
+      return RandomUniformInt<int64_t>(0, num_records - 1, rng);
+    case YcsbDistribution::kZipfian: {
+      int64_t item;
+      {
+        std::lock_guard<std::mutex> lock(zipfian_mutex_);
+        item = zipfian_.Next(num_records, rng);
+      }
+      // Popular items are spread over the key space, instead of being the first records.
+      return FnvHash64(item) % num_records;
+    }
+    case YcsbDistribution::kLatest: {
+      std::lock_guard<std::mutex> lock(zipfian_mutex_);
+      return num_records - 1 - zipfian_.Next(num_records, rng);
+    }
+    case YcsbDistribution::kHotspot: {
+      const auto hot_records = std::max<int64_t>(
+          1, std::min<int64_t>(num_records, num_records * options_.hotspot_data_fraction));
+      if (hot_records == num_records ||
+          RandomActWithProbability(options_.hotspot_operation_fraction, rng)) {
+        return RandomUniformInt<int64_t>(0, hot_records - 1, rng);
+      }
+      return RandomUniformInt<int64_t>(hot_records, num_records - 1, rng);
+    }
+  }
+  FATAL_INVALID_ENUM_VALUE(YcsbDistribution, options_.distribution);
+}
+
+int64_t YcsbWorkload::NextInsertKeyIndex() {
+  return next_insert_index_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void YcsbWorkload::AckInsert(int64_t key_index) {
+  // Inserts could complete out of order, so reads could pick a key that is still being inserted
+  // by another thread and find no row.
+  int64_t num_records = this->num_records();
+  while (num_records <= key_index &&
+         !num_records_.compare_exchange_weak(num_records, key_index + 1,
+                                             std::memory_order_acq_rel)) {
+  }
+}
+
+int YcsbWorkload::NextScanLength(std::mt19937_64* rng) const {
+  return RandomUniformInt(1, std::max(options_.max_scan_length, 1), rng);
+}
+
+std::string YcsbWorkload::Key(int64_t key_index) {
+  return "user" + std::to_string(FnvHash64(key_index));
+}
+
+YcsbStats::OperationStats::OperationStats() : latency_us(kMaxLatencyUs, 3) {
+}
+
+YcsbStats::YcsbStats() {
+  for (auto& stats : stats_) {
+    stats = std::make_unique<OperationStats>();
+  }
+}
+
+void YcsbStats::Record(YcsbOperation op, MonoDelta latency, bool success) {
+  auto& stats = *stats_[to_underlying(op)];
+  stats.latency_us.Increment(
+      std::min<uint64_t>(std::max<int64_t>(latency.ToMicroseconds(), 0), kMaxLatencyUs));
+  if (!success) {
+    stats.errors.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+uint64_t YcsbStats::TotalErrors() const {
+  uint64_t result = 0;
+  for (const auto& stats : stats_) {
+    result += stats->errors.load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+std::string YcsbStats::ToJson(MonoDelta elapsed, double target_ops_per_sec) const {
+  std::stringstream out;
+  JsonWriter writer(&out, JsonWriter::PRETTY);
+  uint64_t total_count = 0;
+  writer.StartObject();
+  writer.String("operations");
+  writer.StartObject();
+  for (auto op : kYcsbOperationList) {
+    const auto& stats = *stats_[to_underlying(op)];
+    const auto& histogram = stats.latency_us;
+    if (histogram.TotalCount() == 0) {
+      continue;
+    }
+    total_count += histogram.TotalCount();
+    writer.String(ToString(op).substr(1));
+    writer.StartObject();
+    writer.String("count");
+    writer.Uint64(histogram.TotalCount());
+    writer.String("errors");
+    writer.Uint64(stats.errors.load(std::memory_order_relaxed));
+    writer.String("mean_us");
+    writer.Double(histogram.MeanValue());
+    for (const auto& percentile : {std::make_pair("p50_us", 50.0),
+                                   std::make_pair("p95_us", 95.0),
+                                   std::make_pair("p99_us", 99.0),
+                                   std::make_pair("p999_us", 99.9)}) {
+      writer.String(percentile.first);
+      writer.Uint64(histogram.ValueAtPercentile(percentile.second));
+    }
+    writer.String("max_us");
+    writer.Uint64(histogram.MaxValue());
+    writer.EndObject();
+  }
+  writer.EndObject();
+  writer.String("elapsed_sec");
+  writer.Double(elapsed.ToSeconds());
+  writer.String("target_ops_per_sec");
+  writer.Double(target_ops_per_sec);
+  writer.String("throughput_ops_per_sec");
+  writer.Double(elapsed.ToSeconds() > 0 ? total_count / elapsed.ToSeconds() : 0);
+  writer.EndObject();
+  return out.str();
+}
+
+} // namespace ycsb
+} // namespace yb
@@ -0,0 +1,149 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_INTEGRATION_TESTS_YCSB_WORKLOAD_H
+#define YB_INTEGRATION_TESTS_YCSB_WORKLOAD_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+
+#include "yb/util/enums.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/monotime.h"
+#include "yb/util/result.h"
+
+namespace yb {
+namespace ycsb {
+
+YB_DEFINE_ENUM(YcsbOperation, (kRead)(kUpdate)(kInsert)(kScan)(kReadModifyWrite));
+
+// How keys of operations are picked among the inserted records:
+// - kUniform: Every record is equally likely.
+// - kZipfian: Few records are popular, popular records are spread over the key space.
+// - kLatest: Zipfian, where the most recently inserted records are the most popular.
+// - kHotspot: hotspot_operation_fraction of operations go to the hotspot_data_fraction of records.
+YB_DEFINE_ENUM(YcsbDistribution, (kUniform)(kZipfian)(kLatest)(kHotspot));
+
+struct YcsbWorkloadOptions {
+  // Proportions of operations, do not have to add up to 1.
+  double read_proportion = 0;
+  double update_proportion = 0;
+  double insert_proportion = 0;
+  double scan_proportion = 0;
+  double read_modify_write_proportion = 0;
+
+  YcsbDistribution distribution = YcsbDistribution::kZipfian;
+  double hotspot_data_fraction = 0.2;
+  double hotspot_operation_fraction = 0.8;
+
+  // Number of records loaded before running operations.
+  int64_t record_count = 1000;
+  int max_scan_length = 100;
+
+  // Returns options of the standard YCSB core workload, "A" to "F".
+  static Result<YcsbWorkloadOptions> Standard(const std::string& name);
+};
+
+// Picks items in [0, num_items) with the zipfian distribution, item 0 being the most popular.
+// Uses the algorithm of "Quickly Generating Billion-Record Synthetic Databases" by Gray et al.,
+// the same as YCSB. Changing the number of items is incremental, as inserts only add items.
+class ZipfianGenerator {
+ public:
+  static constexpr double kDefaultTheta = 0.99;
+
+  explicit ZipfianGenerator(int64_t num_items, double theta = kDefaultTheta);
+
+  int64_t Next(int64_t num_items, std::mt19937_64* rng);
+
+ private:
+  void Resize(int64_t num_items);
+
+  const double theta_;
+  const double alpha_;
+  const double zeta2_;
+  int64_t num_items_ = 0;
+  double zetan_ = 0;
+  double eta_ = 0;
+};
+
+// Generates the operations of a workload. Thread safe, except for the random number generators
+// passed by the caller.
+class YcsbWorkload {
+ public:
+  explicit YcsbWorkload(const YcsbWorkloadOptions& options);
+
+  const YcsbWorkloadOptions& options() const { return options_; }
+
+  // Index of the inserted records, keys of all of them are below it.
+  int64_t num_records() const { return num_records_.load(std::memory_order_acquire); }
+
+  YcsbOperation NextOperation(std::mt19937_64* rng) const;
+
+  // Key index of an existing record for read, update and scan operations.
+  int64_t NextKeyIndex(std::mt19937_64* rng);
+
+  // Key index of a new record, NextKeyIndex could return it after AckInsert is called for it.
+  int64_t NextInsertKeyIndex();
+  void AckInsert(int64_t key_index);
+
+  int NextScanLength(std::mt19937_64* rng) const;
+
+  // Key of the record, the key index is hashed so consecutive records are spread over tablets,
+  // like the "ordered = false" YCSB key format.
+  static std::string Key(int64_t key_index);
+
+ private:
+  const YcsbWorkloadOptions options_;
+  double total_proportion_ = 0;
+
+  std::atomic<int64_t> num_records_;
+  std::atomic<int64_t> next_insert_index_;
+
+  std::mutex zipfian_mutex_;
+  ZipfianGenerator zipfian_;
+};
+
+// Latencies and errors of workload operations. Thread safe.
+class YcsbStats {
+ public:
+  YcsbStats();
+
+  // Latency of the operation since its intended start time, so that queueing delays of an
+  // open-loop run are included.
+  void Record(YcsbOperation op, MonoDelta latency, bool success);
+
+  uint64_t TotalErrors() const;
+
+  // Returns JSON with throughput, and count, errors and latency percentiles in microseconds per
+  // operation type.
+  std::string ToJson(MonoDelta elapsed, double target_ops_per_sec) const;
+
+ private:
+  struct OperationStats {
+    OperationStats();
+
+    HdrHistogram latency_us;
+    std::atomic<uint64_t> errors{0};
+  };
+
+  std::array<std::unique_ptr<OperationStats>, kYcsbOperationMapSize> stats_;
+};
+
+} // namespace ycsb
+} // namespace yb
+
+#endif // YB_INTEGRATION_TESTS_YCSB_WORKLOAD_H
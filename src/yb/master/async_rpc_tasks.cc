@@ -502,41 +502,52 @@ TabletServerId AsyncTabletLeaderTask::permanent_uuid() const {
 // ============================================================================
 //  Class AsyncCreateReplica.
 // ============================================================================
-AsyncCreateReplica::AsyncCreateReplica(Master *master,
-                                       ThreadPool *callback_pool,
-                                       const string& permanent_uuid,
-                                       const scoped_refptr<TabletInfo>& tablet,
-                                       const std::vector<SnapshotScheduleId>& snapshot_schedules)
-  : RetrySpecificTSRpcTask(master, callback_pool, permanent_uuid, tablet->table().get()),
-    tablet_id_(tablet->tablet_id()) {
-  deadline_ = start_ts_;
-  deadline_.AddDelta(MonoDelta::FromMilliseconds(FLAGS_tablet_creation_timeout_ms));
+namespace {
 
+void FillCreateTabletRequest(
+    const std::string& permanent_uuid, TabletInfo* tablet,
+    const std::vector<SnapshotScheduleId>& snapshot_schedules,
+    tserver::CreateTabletRequestPB* req) {
   auto table_lock = tablet->table()->LockForRead();
   const SysTabletsEntryPB& tablet_pb = tablet->metadata().dirty().pb;
 
-  req_.set_dest_uuid(permanent_uuid);
-  req_.set_table_id(tablet->table()->id());
-  req_.set_tablet_id(tablet->tablet_id());
-  req_.set_table_type(tablet->table()->metadata().state().pb.table_type());
-  req_.mutable_partition()->CopyFrom(tablet_pb.partition());
-  req_.set_namespace_id(table_lock->pb.namespace_id());
-  req_.set_namespace_name(table_lock->pb.namespace_name());
-  req_.set_table_name(table_lock->pb.name());
-  req_.mutable_schema()->CopyFrom(table_lock->pb.schema());
-  req_.mutable_partition_schema()->CopyFrom(table_lock->pb.partition_schema());
-  req_.mutable_config()->CopyFrom(tablet_pb.committed_consensus_state().config());
-  req_.set_colocated(tablet_pb.colocated());
+  req->set_dest_uuid(permanent_uuid);
+  req->set_table_id(tablet->table()->id());
+  req->set_tablet_id(tablet->tablet_id());
+  req->set_table_type(tablet->table()->metadata().state().pb.table_type());
+  req->mutable_partition()->CopyFrom(tablet_pb.partition());
+  req->set_namespace_id(table_lock->pb.namespace_id());
+  req->set_namespace_name(table_lock->pb.namespace_name());
+  req->set_table_name(table_lock->pb.name());
+  req->mutable_schema()->CopyFrom(table_lock->pb.schema());
+  req->mutable_partition_schema()->CopyFrom(table_lock->pb.partition_schema());
+  req->mutable_config()->CopyFrom(tablet_pb.committed_consensus_state().config());
+  req->set_colocated(tablet_pb.colocated());
   if (table_lock->pb.has_index_info()) {
-    req_.mutable_index_info()->CopyFrom(table_lock->pb.index_info());
+    req->mutable_index_info()->CopyFrom(table_lock->pb.index_info());
   }
-  auto& req_schedules = *req_.mutable_snapshot_schedules();
+  auto& req_schedules = *req->mutable_snapshot_schedules();
   req_schedules.Reserve(snapshot_schedules.size());
   for (const auto& id : snapshot_schedules) {
     req_schedules.Add()->assign(id.AsSlice().cdata(), id.size());
   }
 }
 
+} // namespace
+
+AsyncCreateReplica::AsyncCreateReplica(Master *master,
+                                       ThreadPool *callback_pool,
+                                       const string& permanent_uuid,
+                                       const scoped_refptr<TabletInfo>& tablet,
+                                       const std::vector<SnapshotScheduleId>& snapshot_schedules)
+  : RetrySpecificTSRpcTask(master, callback_pool, permanent_uuid, tablet->table().get()),
+    tablet_id_(tablet->tablet_id()) {
+  deadline_ = start_ts_;
+  deadline_.AddDelta(MonoDelta::FromMilliseconds(FLAGS_tablet_creation_timeout_ms));
+
+  FillCreateTabletRequest(permanent_uuid, tablet.get(), snapshot_schedules, &req_);
+}
+
 void AsyncCreateReplica::HandleResponse(int attempt) {
   if (resp_.has_error()) {
     Status s = StatusFromPB(resp_.error().status());
@@ -564,6 +575,77 @@ bool AsyncCreateReplica::SendRequest(int attempt) {
   return true;
 }
 
+// ============================================================================
+//  Class AsyncCreateReplicas.
+// ============================================================================
+AsyncCreateReplicas::AsyncCreateReplicas(
+    Master *master,
+    ThreadPool *callback_pool,
+    const string& permanent_uuid,
+    const scoped_refptr<TableInfo>& table,
+    const std::vector<TabletWithSnapshotSchedules>& tablets)
+  : RetrySpecificTSRpcTask(master, callback_pool, permanent_uuid, table),
+    num_tablets_(tablets.size()) {
+  deadline_ = start_ts_;
+  deadline_.AddDelta(MonoDelta::FromMilliseconds(FLAGS_tablet_creation_timeout_ms));
+
+  req_.set_dest_uuid(permanent_uuid);
+  req_.mutable_tablets()->Reserve(tablets.size());
+  for (const auto& tablet : tablets) {
+    FillCreateTabletRequest(
+        permanent_uuid, tablet.first.get(), tablet.second, req_.mutable_tablets()->Add());
+  }
+}
+
+std::string AsyncCreateReplicas::description() const {
+  return Format("BatchCreateTablets RPC for $0 tablets on TS $1",
+                num_tablets_, permanent_uuid_);
+}
+
+void AsyncCreateReplicas::HandleResponse(int attempt) {
+  if (resp_.has_error()) {
+    LOG_WITH_PREFIX(WARNING) << "BatchCreateTablets RPC on TS " << permanent_uuid_ << " failed: "
+                             << StatusFromPB(resp_.error().status());
+    return;
+  }
+
+  // Keep only the tablets that failed, to retry them.
+  google::protobuf::RepeatedPtrField<tserver::CreateTabletRequestPB> failed_tablets;
+  for (int i = 0; i != req_.tablets_size(); ++i) {
+    auto* tablet_req = req_.mutable_tablets(i);
+    if (i >= resp_.tablets_size()) {
+      failed_tablets.Add()->Swap(tablet_req);
+      continue;
+    }
+    const auto& tablet_resp = resp_.tablets(i);
+    if (!tablet_resp.has_error()) {
+      continue;
+    }
+    Status s = StatusFromPB(tablet_resp.error().status());
+    if (s.IsAlreadyPresent()) {
+      LOG_WITH_PREFIX(INFO) << "CreateTablet for tablet " << tablet_req->tablet_id()
+                            << " on TS " << permanent_uuid_ << " returned already present: " << s;
+      continue;
+    }
+    LOG_WITH_PREFIX(WARNING) << "CreateTablet for tablet " << tablet_req->tablet_id()
+                             << " on TS " << permanent_uuid_ << " failed: " << s;
+    failed_tablets.Add()->Swap(tablet_req);
+  }
+  req_.mutable_tablets()->Swap(&failed_tablets);
+
+  if (req_.tablets().empty()) {
+    TransitionToCompleteState();
+  }
+}
+
+bool AsyncCreateReplicas::SendRequest(int attempt) {
+  resp_.Clear();
+  ts_admin_proxy_->BatchCreateTabletsAsync(req_, &resp_, &rpc_, BindRpcCallback());
+  VLOG_WITH_PREFIX(1) << "Send batch create tablets request to " << permanent_uuid_
+                      << " (attempt " << attempt << "): " << req_.tablets_size() << " tablets";
+  return true;
+}
+
 // ============================================================================
 //  Class AsyncStartElection.
 // ============================================================================
@@ -1250,9 +1332,13 @@ bool IsDefinitelyPermanentError(const Status& s) {
 // ============================================================================
 AsyncGetTabletSplitKey::AsyncGetTabletSplitKey(
     Master* master, ThreadPool* callback_pool, const scoped_refptr<TabletInfo>& tablet,
+    bool use_key_access_samples,
     std::function<void(const std::string&, const std::string&)> result_cb)
     : AsyncTabletLeaderTask(master, callback_pool, tablet), result_cb_(result_cb) {
   req_.set_tablet_id(tablet_id());
+  if (use_key_access_samples) {
+    req_.set_use_key_access_samples(true);
+  }
 }
 
 void AsyncGetTabletSplitKey::HandleResponse(int attempt) {
@@ -322,6 +322,38 @@ class AsyncCreateReplica : public RetrySpecificTSRpcTask {
   tserver::CreateTabletResponsePB resp_;
 };
 
+using TabletWithSnapshotSchedules =
+    std::pair<scoped_refptr<TabletInfo>, std::vector<SnapshotScheduleId>>;
+
+// Creates replicas of multiple tablets of the same table on a tablet server with a single
+// BatchCreateTablets RPC. Only the tablets that failed are sent again by retries.
+// The same locking requirements as for AsyncCreateReplica apply.
+class AsyncCreateReplicas : public RetrySpecificTSRpcTask {
+ public:
+  AsyncCreateReplicas(Master *master,
+                      ThreadPool *callback_pool,
+                      const std::string& permanent_uuid,
+                      const scoped_refptr<TableInfo>& table,
+                      const std::vector<TabletWithSnapshotSchedules>& tablets);
+
+  Type type() const override { return ASYNC_CREATE_REPLICA; }
+
+  std::string type_name() const override { return "Create Tablets"; }
+
+  std::string description() const override;
+
+ protected:
+  TabletId tablet_id() const override { return TabletId(); }
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+
+ private:
+  const size_t num_tablets_;
+  tserver::BatchCreateTabletsRequestPB req_;
+  tserver::BatchCreateTabletsResponsePB resp_;
+};
+
 // Task to start election at hinted leader for a newly created tablet.
 class AsyncStartElection : public RetrySpecificTSRpcTask {
  public:
@@ -675,6 +707,7 @@ class AsyncGetTabletSplitKey : public AsyncTabletLeaderTask {
  public:
   AsyncGetTabletSplitKey(
       Master* master, ThreadPool* callback_pool, const scoped_refptr<TabletInfo>& tablet,
+      bool use_key_access_samples,
       std::function<void(const std::string&, const std::string&)> result_cb);
 
   Type type() const override { return ASYNC_GET_TABLET_SPLIT_KEY; }
@@ -1386,6 +1386,7 @@ bool BackfillChunk::SendRequest(int attempt) {
   }
   req.set_propagated_hybrid_time(backfill_tablet_->master()->clock()->Now().ToUint64());
 
+  rpc_.set_background_priority(true);
   ts_admin_proxy_->BackfillIndexAsync(req, &resp_, &rpc_, BindRpcCallback());
   VLOG(1) << "Send " << description() << " to " << permanent_uuid()
           << " (attempt " << attempt << "):\n"
@@ -185,6 +185,18 @@ std::shared_ptr<const TabletInfo::ReplicaMap> TabletInfo::GetReplicaLocations()
   return replica_locations_;
 }
 
+void TabletInfo::SetReplicaLocationsPBCache(
+    std::shared_ptr<const ReplicaLocationsPBCache> cache) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  replica_locations_pb_cache_ = std::move(cache);
+}
+
+std::shared_ptr<const TabletInfo::ReplicaLocationsPBCache>
+TabletInfo::GetReplicaLocationsPBCache() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  return replica_locations_pb_cache_;
+}
+
 void TabletInfo::UpdateReplicaLocations(const TabletReplica& replica) {
   std::lock_guard<simple_spinlock> l(lock_);
   LeaderChangeReporter leader_change_reporter(this);
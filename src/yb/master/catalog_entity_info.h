@@ -60,6 +60,9 @@ struct TabletReplicaDriveInfo {
   uint64 wal_files_size = 0;
   uint64 uncompressed_sst_file_size = 0;
   bool may_have_orphaned_post_split_data = true;
+  // Average read and write rates of the replica, 0 if not reported yet.
+  double read_ops_per_sec = 0;
+  double write_ops_per_sec = 0;
 };
 
 // Information on a current replica of a tablet.
@@ -214,6 +217,14 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
  public:
   typedef std::unordered_map<std::string, TabletReplica> ReplicaMap;
 
+  // Replicas section of TabletLocationsPB, built for a particular replica map and the tablet
+  // server registrations it was built from. Valid for as long as neither of them is replaced.
+  struct ReplicaLocationsPBCache {
+    std::shared_ptr<const ReplicaMap> replica_locations;
+    std::vector<std::shared_ptr<TSInformationPB>> ts_informations;
+    google::protobuf::RepeatedPtrField<TabletLocationsPB_ReplicaPB> replicas;
+  };
+
   TabletInfo(const scoped_refptr<TableInfo>& table, TabletId tablet_id);
   virtual const TabletId& id() const override { return tablet_id_; }
 
@@ -229,6 +240,10 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   Result<TSDescriptor*> GetLeader() const;
   Result<TabletReplicaDriveInfo> GetLeaderReplicaDriveInfo() const;
 
+  // Accessors for the cached replicas section of TabletLocationsPB.
+  void SetReplicaLocationsPBCache(std::shared_ptr<const ReplicaLocationsPBCache> cache);
+  std::shared_ptr<const ReplicaLocationsPBCache> GetReplicaLocationsPBCache() const;
+
   // Replaces a replica in replica_locations_ map if it exists. Otherwise, it adds it to the map.
   void UpdateReplicaLocations(const TabletReplica& replica);
 
@@ -293,6 +308,8 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   // reported. The map is keyed by tablet server UUID.
   std::shared_ptr<ReplicaMap> replica_locations_ GUARDED_BY(lock_);
 
+  std::shared_ptr<const ReplicaLocationsPBCache> replica_locations_pb_cache_ GUARDED_BY(lock_);
+
   // Reported schema version (in-memory only).
   std::unordered_map<TableId, uint32_t> reported_schema_version_ GUARDED_BY(lock_) = {};
 
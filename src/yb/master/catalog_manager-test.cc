@@ -384,5 +384,53 @@ TEST(TestCatalogManager, CheckIfCanDeleteSingleTablet) {
   }
 }
 
+namespace {
+
+void SetLeaderDriveInfo(TabletInfo* tablet, uint64_t sst_files_size, double ops_per_sec) {
+  TabletReplica replica;
+  replica.role = consensus::RaftPeerPB::LEADER;
+  replica.drive_info.sst_files_size = sst_files_size;
+  replica.drive_info.may_have_orphaned_post_split_data = false;
+  replica.drive_info.read_ops_per_sec = ops_per_sec;
+  auto replica_map = std::make_shared<TabletInfo::ReplicaMap>();
+  replica_map->emplace("ts", replica);
+  tablet->SetReplicaLocations(replica_map);
+}
+
+} // namespace
+
+TEST(TestCatalogManager, FindTabletMergeCandidates) {
+  const string table_id = CURRENT_TEST_NAME();
+  scoped_refptr<TableInfo> table(new TableInfo(table_id));
+  TabletInfos tablets;
+  CreateTable({"a", "b", "c", "d", "e"}, 1, true, table.get(), &tablets);
+  ASSERT_EQ(6, tablets.size());
+
+  constexpr uint64_t kMaxSize = 100;
+  constexpr double kMaxOpsPerSec = 10;
+  // "-a" and "a-b" are small and cold, "b-c" is hot, "c-d" together with "d-e" is too large,
+  // "d-e" and "e-" are small and cold.
+  SetLeaderDriveInfo(tablets[0].get(), 10, 0);
+  SetLeaderDriveInfo(tablets[1].get(), 10, 1);
+  SetLeaderDriveInfo(tablets[2].get(), 10, 100);
+  SetLeaderDriveInfo(tablets[3].get(), 60, 0);
+  SetLeaderDriveInfo(tablets[4].get(), 50, 0);
+  SetLeaderDriveInfo(tablets[5].get(), 20, 0);
+
+  auto candidates = CatalogManagerUtil::FindTabletMergeCandidates(
+      tablets, kMaxSize, kMaxOpsPerSec);
+  ASSERT_EQ(2, candidates.size());
+  ASSERT_EQ(tablets[0], candidates[0].first);
+  ASSERT_EQ(tablets[1], candidates[0].second);
+  ASSERT_EQ(tablets[4], candidates[1].first);
+  ASSERT_EQ(tablets[5], candidates[1].second);
+
+  // Tablets that are not running are not merged.
+  SetTabletState(tablets[1].get(), SysTabletsEntryPB::CREATING);
+  candidates = CatalogManagerUtil::FindTabletMergeCandidates(tablets, kMaxSize, kMaxOpsPerSec);
+  ASSERT_EQ(1, candidates.size());
+  ASSERT_EQ(tablets[4], candidates[0].first);
+}
+
 } // namespace master
 } // namespace yb
@@ -59,6 +59,7 @@
 #include <algorithm>
 #include <bitset>
 #include <functional>
+#include <future>
 #include <mutex>
 #include <set>
 #include <unordered_map>
@@ -242,6 +243,11 @@ METRIC_DEFINE_gauge_uint32(cluster, num_tablet_servers_live,
                            "in the time interval defined by the gflag "
                            "FLAGS_tserver_unresponsive_timeout_ms.");
 
+METRIC_DEFINE_gauge_uint32(cluster, tablet_merge_candidates,
+                           "Number of tablet merge candidates", yb::MetricUnit::kUnits,
+                           "The number of pairs of adjacent small and cold tablets found by the "
+                           "last scan, see FLAGS_tablet_merge_size_threshold_bytes.");
+
 METRIC_DEFINE_gauge_uint32(cluster, num_tablet_servers_dead,
                            "Number of dead tservers in the cluster", yb::MetricUnit::kUnits,
                            "The number of tablet servers that have not responded or done a "
@@ -399,6 +405,29 @@ DEFINE_int64(tablet_force_split_threshold_bytes, 50_GB,
              "exist in the table already. This should be configured to prevent runaway whale "
              "tablets from forming in your cluster even if both automatic splitting phases have "
              "been finished.");
+DEFINE_int64(tablet_split_load_ops_per_sec_threshold, 0,
+             "The sum of read and write rates of the tablet leader, averaged over "
+             "tablet_load_report_window_secs on the tablet server, at which to split the tablet "
+             "regardless of its size. The split key is chosen from sampled key accesses. "
+             "0 disables load based splitting.");
+TAG_FLAG(tablet_split_load_ops_per_sec_threshold, advanced);
+TAG_FLAG(tablet_split_load_ops_per_sec_threshold, runtime);
+
+DEFINE_int64(tablet_merge_size_threshold_bytes, 0,
+             "Adjacent tablets of a table that are both smaller than this, and not larger than "
+             "this together, are reported as merge candidates in the tablet_merge_candidates "
+             "metric and the master log. 0 disables looking for merge candidates.");
+TAG_FLAG(tablet_merge_size_threshold_bytes, advanced);
+TAG_FLAG(tablet_merge_size_threshold_bytes, runtime);
+DEFINE_double(tablet_merge_load_ops_per_sec_threshold, 1.0,
+              "Max sum of read and write rates of the leader of a tablet merge candidate, see "
+              "tablet_merge_size_threshold_bytes.");
+TAG_FLAG(tablet_merge_load_ops_per_sec_threshold, advanced);
+TAG_FLAG(tablet_merge_load_ops_per_sec_threshold, runtime);
+DEFINE_int32(tablet_merge_candidates_scan_interval_secs, 300,
+             "Interval between scans of the tablets of all tables for merge candidates.");
+TAG_FLAG(tablet_merge_candidates_scan_interval_secs, advanced);
+TAG_FLAG(tablet_merge_candidates_scan_interval_secs, runtime);
 
 DEFINE_test_flag(bool, crash_server_on_sys_catalog_leader_affinity_move, false,
                  "When set, crash the master process if it performs a sys catalog leader affinity "
@@ -428,6 +457,26 @@ DEFINE_bool(enable_tablet_split_of_pitr_tables, false,
             "Point In Time Restore schedules.");
 TAG_FLAG(enable_tablet_split_of_pitr_tables, runtime);
 
+DEFINE_bool(parallel_sys_catalog_load, false,
+            "When set, the master leader loads tables and tablets from the sys catalog concurrently "
+            "with the remaining entity types (namespaces, types, roles, configs).");
+TAG_FLAG(parallel_sys_catalog_load, advanced);
+TAG_FLAG(parallel_sys_catalog_load, runtime);
+
+DEFINE_bool(cache_tablet_replica_locations_pb, false,
+            "When set, the master caches the replicas section of each tablet's locations and "
+            "reuses it in GetTableLocations and GetTabletLocations until the tablet's replica "
+            "locations or a replica's tablet server registration change.");
+TAG_FLAG(cache_tablet_replica_locations_pb, advanced);
+TAG_FLAG(cache_tablet_replica_locations_pb, runtime);
+
+DEFINE_int32(max_tablets_per_create_tablets_rpc, 0,
+             "Maximum number of replicas of the same table the master creates on a tablet server "
+             "with a single BatchCreateTablets RPC. 0 sends a CreateTablet RPC per replica, as "
+             "required while tablet servers that do not support BatchCreateTablets are running.");
+TAG_FLAG(max_tablets_per_create_tablets_rpc, advanced);
+TAG_FLAG(max_tablets_per_create_tablets_rpc, runtime);
+
 namespace yb {
 namespace master {
 
@@ -708,6 +757,9 @@ Status CatalogManager::Init() {
   metric_num_tablet_servers_dead_ =
     METRIC_num_tablet_servers_dead.Instantiate(master_->metric_entity_cluster(), 0);
 
+  metric_tablet_merge_candidates_ =
+    METRIC_tablet_merge_candidates.Instantiate(master_->metric_entity_cluster(), 0);
+
   RETURN_NOT_OK_PREPEND(InitSysCatalogAsync(),
                         "Failed to initialize sys tables async");
 
@@ -1048,16 +1100,32 @@ Status CatalogManager::RunLoaders(int64_t term) {
     ts_desc->set_has_tablet_report(false);
   }
 
-  RETURN_NOT_OK(Load<TableLoader>("tables", term));
-  RETURN_NOT_OK(Load<TabletLoader>("tablets", term));
-  RETURN_NOT_OK(Load<NamespaceLoader>("namespaces", term));
-  RETURN_NOT_OK(Load<UDTypeLoader>("user-defined types", term));
-  RETURN_NOT_OK(Load<ClusterConfigLoader>("cluster configuration", term));
-  RETURN_NOT_OK(Load<RoleLoader>("roles", term));
-  RETURN_NOT_OK(Load<RedisConfigLoader>("Redis config", term));
-  RETURN_NOT_OK(Load<SysConfigLoader>("sys config", term));
+  // Tablets depend on tables, and roles share the permissions manager with sys config, so each
+  // chain is loaded in order. The two chains touch disjoint catalog manager state, so they may
+  // run concurrently.
+  auto load_tables_and_tablets = [this, term]() -> Status {
+    RETURN_NOT_OK(Load<TableLoader>("tables", term));
+    return Load<TabletLoader>("tablets", term);
+  };
+  auto load_other_entities = [this, term]() -> Status {
+    RETURN_NOT_OK(Load<NamespaceLoader>("namespaces", term));
+    RETURN_NOT_OK(Load<UDTypeLoader>("user-defined types", term));
+    RETURN_NOT_OK(Load<ClusterConfigLoader>("cluster configuration", term));
+    RETURN_NOT_OK(Load<RoleLoader>("roles", term));
+    RETURN_NOT_OK(Load<RedisConfigLoader>("Redis config", term));
+    return Load<SysConfigLoader>("sys config", term);
+  };
+
+  if (!FLAGS_parallel_sys_catalog_load) {
+    RETURN_NOT_OK(load_tables_and_tablets());
+    return load_other_entities();
+  }
 
-  return Status::OK();
+  auto other_entities_future = std::async(std::launch::async, load_other_entities);
+  auto tables_status = load_tables_and_tablets();
+  auto other_entities_status = other_entities_future.get();
+  RETURN_NOT_OK(tables_status);
+  return other_entities_status;
 }
 
 Status CatalogManager::PrepareDefaultClusterConfig(int64_t term) {
@@ -2187,6 +2255,15 @@ Status CatalogManager::ValidateSplitCandidate(const TabletInfo& tablet_info) {
   return Status::OK();
 }
 
+namespace {
+
+bool ExceedsSplitLoadThreshold(const TabletReplicaDriveInfo& drive_info) {
+  const auto threshold = FLAGS_tablet_split_load_ops_per_sec_threshold;
+  return threshold > 0 && drive_info.read_ops_per_sec + drive_info.write_ops_per_sec > threshold;
+}
+
+} // namespace
+
 bool CatalogManager::ShouldSplitValidCandidate(
     const TabletInfo& tablet_info, const TabletReplicaDriveInfo& drive_info) const {
   if (PREDICT_FALSE(FLAGS_TEST_select_all_tablets_for_split)) {
@@ -2195,6 +2272,9 @@ bool CatalogManager::ShouldSplitValidCandidate(
   if (drive_info.may_have_orphaned_post_split_data) {
     return false;
   }
+  if (ExceedsSplitLoadThreshold(drive_info)) {
+    return true;
+  }
   int64 size = drive_info.sst_files_size;
   DCHECK(size >= 0) << "Detected overflow in casting sst_files_size to signed int.";
   if (size < FLAGS_tablet_split_low_phase_size_threshold_bytes) {
@@ -2308,11 +2388,13 @@ Status CatalogManager::SplitTablet(const TabletId& tablet_id) {
   LOG(INFO) << "Got tablet to split: " << tablet_id;
 
   const auto tablet = VERIFY_RESULT(GetTabletInfo(tablet_id));
+  const auto drive_info = tablet->GetLeaderReplicaDriveInfo();
+  const bool use_key_access_samples = drive_info.ok() && ExceedsSplitLoadThreshold(*drive_info);
 
   VLOG(2) << "Scheduling GetSplitKey request to leader tserver for source tablet ID: "
-          << tablet->tablet_id();
+          << tablet->tablet_id() << ", use key access samples: " << use_key_access_samples;
   auto call = std::make_shared<AsyncGetTabletSplitKey>(
-      master_, AsyncTaskPool(), tablet,
+      master_, AsyncTaskPool(), tablet, use_key_access_samples,
       [this, tablet](const std::string& split_encoded_key, const std::string& split_partition_key) {
         SplitTabletWithKey(tablet, split_encoded_key, split_partition_key);
       });
@@ -5672,9 +5754,20 @@ Status CatalogManager::ProcessTabletReportBatch(
     update->set_tablet_id(tablet_id);
 
     // Get tablet lock on demand.  This works in the batch case because the loop is ordered.
-    tablet_write_locks[tablet_id] = tablet->LockForWrite();
+    // Only a report that carries a committed consensus state can mutate the tablet, so other
+    // reports are evaluated under a read lock that is released before the next tablet is locked,
+    // which avoids copying the tablet metadata for them.
     auto& table_lock = table_read_locks[table->id()];
-    auto& tablet_lock = tablet_write_locks[tablet_id];
+    TabletInfo::ReadLock tablet_read_lock;
+    const PersistentTabletInfo* tablet_data;
+    if (report.has_committed_consensus_state()) {
+      auto& tablet_write_lock = tablet_write_locks[tablet_id];
+      tablet_write_lock = tablet->LockForWrite();
+      tablet_data = &tablet_write_lock.data();
+    } else {
+      tablet_read_lock = tablet->LockForRead();
+      tablet_data = &tablet_read_lock.data();
+    }
 
     TRACE_EVENT1("master", "HandleReportedTablet", "tablet_id", report.tablet_id());
     RETURN_NOT_OK_PREPEND(CheckIsLeaderAndReady(),
@@ -5684,9 +5777,9 @@ Status CatalogManager::ProcessTabletReportBatch(
     VLOG(3) << "tablet report: " << report.ShortDebugString();
 
     // 3. Delete the tablet if it (or its table) have been deleted.
-    if (tablet_lock->is_deleted() ||
+    if (tablet_data->is_deleted() ||
         table_lock->started_deleting()) {
-      const string msg = tablet_lock->pb.state_msg();
+      const string msg = tablet_data->pb.state_msg();
       update->set_state_msg(msg);
       LOG(INFO) << "Got report from deleted tablet " << tablet->ToString()
                 << " (" << msg << "): Sending delete request for this tablet";
@@ -5699,7 +5792,7 @@ Status CatalogManager::ProcessTabletReportBatch(
     }
 
     if (!table_lock->is_running()) {
-      const string msg = tablet_lock->pb.state_msg();
+      const string msg = tablet_data->pb.state_msg();
       LOG(INFO) << "Got report from tablet " << tablet->tablet_id()
                 << " for non-running table " << table->ToString() << ": " << msg;
       update->set_state_msg(msg);
@@ -5713,10 +5806,11 @@ Status CatalogManager::ProcessTabletReportBatch(
     // the opid_index is strictly less than the latest reported committed
     // config. This prevents us from spuriously deleting replicas that have
     // just been added to the committed config and are in the process of copying.
-    const ConsensusStatePB& prev_cstate = tablet_lock->pb.committed_consensus_state();
+    const ConsensusStatePB& prev_cstate = tablet_data->pb.committed_consensus_state();
     const int64_t prev_opid_index = prev_cstate.config().opid_index();
     const int64_t report_opid_index = GetCommittedConsensusStateOpIdIndex(report);
     if (FLAGS_master_tombstone_evicted_tablet_replicas &&
+        !report.committed_consensus_state_unchanged() &&
         report.tablet_data_state() != TABLET_DATA_TOMBSTONED &&
         report.tablet_data_state() != TABLET_DATA_DELETED &&
         report_opid_index < prev_opid_index &&
@@ -5749,12 +5843,15 @@ Status CatalogManager::ProcessTabletReportBatch(
     // replica so that the balancer knows how many tablets are in the middle of remote bootstrap.
     if (report.has_committed_consensus_state()) {
       if (ProcessCommittedConsensusState(
-              ts_desc, is_incremental, report, table_lock, tablet, tablet_lock, rpcs)) {
+              ts_desc, is_incremental, report, table_lock, tablet, tablet_write_locks[tablet_id],
+              rpcs)) {
         // 6. If the tablet was mutated, add it to the tablets to be re-persisted.
         //
         // Done here and not on a per-mutation basis to avoid duplicate entries.
         mutated_tablets.push_back(tablet.get());
       }
+    } else if (report.committed_consensus_state_unchanged()) {
+      // The master already processed this replica state in an earlier report.
     } else if (is_incremental &&
         (report.state() == tablet::NOT_STARTED || report.state() == tablet::BOOTSTRAPPING)) {
       // When a tablet server is restarted, it sends a full tablet report with all of its tablets
@@ -8494,6 +8591,9 @@ return allowed_ts;
 Status CatalogManager::SendCreateTabletRequests(const vector<TabletInfo*>& tablets) {
   auto schedules_to_tablets_map = VERIFY_RESULT(MakeSnapshotSchedulesToObjectIdsMap(
       SysRowEntry::TABLET));
+  const auto max_tablets_per_rpc = FLAGS_max_tablets_per_create_tablets_rpc;
+  // Replicas to create with batched RPCs, grouped by table and tablet server.
+  std::map<std::pair<TableId, TabletServerId>, std::vector<TabletWithSnapshotSchedules>> batches;
   for (TabletInfo *tablet : tablets) {
     const consensus::RaftConfigPB& config =
         tablet->metadata().dirty().pb.committed_consensus_state().config();
@@ -8505,6 +8605,11 @@ Status CatalogManager::SendCreateTabletRequests(const vector<TabletInfo*>& table
       }
     }
     for (const RaftPeerPB& peer : config.peers()) {
+      if (max_tablets_per_rpc > 0) {
+        batches[std::make_pair(tablet->table()->id(), peer.permanent_uuid())].emplace_back(
+            tablet, schedules);
+        continue;
+      }
       auto task = std::make_shared<AsyncCreateReplica>(master_, AsyncTaskPool(),
           peer.permanent_uuid(), tablet, schedules);
       tablet->table()->AddTask(task);
@@ -8512,6 +8617,20 @@ Status CatalogManager::SendCreateTabletRequests(const vector<TabletInfo*>& table
     }
   }
 
+  for (const auto& batch : batches) {
+    const auto& tablets_of_batch = batch.second;
+    const auto& table = tablets_of_batch.front().first->table();
+    for (size_t begin = 0; begin < tablets_of_batch.size(); begin += max_tablets_per_rpc) {
+      const auto end = std::min<size_t>(begin + max_tablets_per_rpc, tablets_of_batch.size());
+      auto task = std::make_shared<AsyncCreateReplicas>(
+          master_, AsyncTaskPool(), batch.first.second, table,
+          std::vector<TabletWithSnapshotSchedules>(
+              tablets_of_batch.begin() + begin, tablets_of_batch.begin() + end));
+      table->AddTask(task);
+      WARN_NOT_OK(ScheduleTask(task), "Failed to send new tablets request");
+    }
+  }
+
   return Status::OK();
 }
 
@@ -8735,8 +8854,30 @@ Status CatalogManager::ConsensusStateToTabletLocations(const consensus::Consensu
   return Status::OK();
 }
 
+namespace {
+
+void FillReplicaPB(
+    const TabletReplica& replica, const TSInformationPB& tsinfo_pb,
+    TabletLocationsPB_ReplicaPB* replica_pb) {
+  replica_pb->set_role(replica.role);
+  replica_pb->set_member_type(replica.member_type);
+
+  TSInfoPB* out_ts_info = replica_pb->mutable_ts_info();
+  out_ts_info->set_permanent_uuid(tsinfo_pb.tserver_instance().permanent_uuid());
+  CopyRegistration(tsinfo_pb.registration().common(), out_ts_info);
+  out_ts_info->set_placement_uuid(tsinfo_pb.registration().common().placement_uuid());
+  *out_ts_info->mutable_capabilities() = tsinfo_pb.registration().capabilities();
+}
+
+} // namespace
+
 Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>& tablet,
                                                TabletLocationsPB* locs_pb) {
+  // This is on the path of every GetTableLocations, so everything needed from the tablet metadata
+  // is read under a single acquisition of its lock.
+  const bool is_system_tablet = system_tablets_.find(tablet->id()) != system_tablets_.end();
+  std::shared_ptr<const TabletInfo::ReplicaMap> locs;
+  consensus::ConsensusStatePB cstate;
   {
     auto l_tablet = tablet->LockForRead();
     if (l_tablet->is_hidden()) {
@@ -8744,10 +8885,39 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
     }
     locs_pb->set_table_id(l_tablet->pb.table_id());
     *locs_pb->mutable_table_ids() = l_tablet->pb.table_ids();
+
+    if (!is_system_tablet) {
+      if (PREDICT_FALSE(l_tablet->is_deleted())) {
+        std::vector<TabletId> split_tablet_ids;
+        for (const auto& split_tablet_id : l_tablet->pb.split_tablet_ids()) {
+          split_tablet_ids.push_back(split_tablet_id);
+        }
+        return STATUS(
+            NotFound, "Tablet deleted", l_tablet->pb.state_msg(),
+            SplitChildTabletIdsData(split_tablet_ids));
+      }
+
+      if (PREDICT_FALSE(!l_tablet->is_running())) {
+        return STATUS_FORMAT(ServiceUnavailable, "Tablet $0 not running", tablet->id());
+      }
+
+      locs = tablet->GetReplicaLocations();
+      if (locs->empty() && l_tablet->pb.has_committed_consensus_state()) {
+        cstate = l_tablet->pb.committed_consensus_state();
+      }
+
+      const auto& metadata = tablet->metadata().state().pb;
+      locs_pb->mutable_partition()->CopyFrom(metadata.partition());
+      locs_pb->set_split_depth(metadata.split_depth());
+      locs_pb->set_split_parent_tablet_id(metadata.split_parent_tablet_id());
+      for (const auto& split_tablet_id : metadata.split_tablet_ids()) {
+        *locs_pb->add_split_tablet_ids() = split_tablet_id;
+      }
+    }
   }
 
   // For system tables, the set of replicas is always the set of masters.
-  if (system_tablets_.find(tablet->id()) != system_tablets_.end()) {
+  if (is_system_tablet) {
     consensus::ConsensusStatePB master_consensus;
     RETURN_NOT_OK(GetCurrentConfig(&master_consensus));
     locs_pb->set_tablet_id(tablet->tablet_id());
@@ -8766,38 +8936,6 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
 
   TSRegistrationPB reg;
 
-  std::shared_ptr<const TabletInfo::ReplicaMap> locs;
-  consensus::ConsensusStatePB cstate;
-  {
-    auto l_tablet = tablet->LockForRead();
-    if (PREDICT_FALSE(l_tablet->is_deleted())) {
-      std::vector<TabletId> split_tablet_ids;
-      for (const auto& split_tablet_id : l_tablet->pb.split_tablet_ids()) {
-        split_tablet_ids.push_back(split_tablet_id);
-      }
-      return STATUS(
-          NotFound, "Tablet deleted", l_tablet->pb.state_msg(),
-          SplitChildTabletIdsData(split_tablet_ids));
-    }
-
-    if (PREDICT_FALSE(!l_tablet->is_running())) {
-      return STATUS_FORMAT(ServiceUnavailable, "Tablet $0 not running", tablet->id());
-    }
-
-    locs = tablet->GetReplicaLocations();
-    if (locs->empty() && l_tablet->pb.has_committed_consensus_state()) {
-      cstate = l_tablet->pb.committed_consensus_state();
-    }
-
-    const auto& metadata = tablet->metadata().state().pb;
-    locs_pb->mutable_partition()->CopyFrom(metadata.partition());
-    locs_pb->set_split_depth(metadata.split_depth());
-    locs_pb->set_split_parent_tablet_id(metadata.split_parent_tablet_id());
-    for (const auto& split_tablet_id : metadata.split_tablet_ids()) {
-      *locs_pb->add_split_tablet_ids() = split_tablet_id;
-    }
-  }
-
   locs_pb->set_tablet_id(tablet->tablet_id());
   locs_pb->set_stale(locs->empty());
 
@@ -8808,18 +8946,34 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
                    << cstate.config().peers_size();
     }
 
-    for (const TabletInfo::ReplicaMap::value_type& replica : *locs) {
-      TabletLocationsPB_ReplicaPB* replica_pb = locs_pb->add_replicas();
-      replica_pb->set_role(replica.second.role);
-      replica_pb->set_member_type(replica.second.member_type);
-      auto tsinfo_pb = replica.second.ts_desc->GetTSInformationPB();
+    if (!FLAGS_cache_tablet_replica_locations_pb) {
+      for (const TabletInfo::ReplicaMap::value_type& replica : *locs) {
+        FillReplicaPB(
+            replica.second, *replica.second.ts_desc->GetTSInformationPB(),
+            locs_pb->add_replicas());
+      }
+      return Status::OK();
+    }
 
-      TSInfoPB* out_ts_info = replica_pb->mutable_ts_info();
-      out_ts_info->set_permanent_uuid(tsinfo_pb->tserver_instance().permanent_uuid());
-      CopyRegistration(tsinfo_pb->registration().common(), out_ts_info);
-      out_ts_info->set_placement_uuid(tsinfo_pb->registration().common().placement_uuid());
-      *out_ts_info->mutable_capabilities() = tsinfo_pb->registration().capabilities();
+    std::vector<std::shared_ptr<TSInformationPB>> ts_informations;
+    ts_informations.reserve(locs->size());
+    for (const TabletInfo::ReplicaMap::value_type& replica : *locs) {
+      ts_informations.push_back(replica.second.ts_desc->GetTSInformationPB());
+    }
+    auto cache = tablet->GetReplicaLocationsPBCache();
+    if (!cache || cache->replica_locations != locs || cache->ts_informations != ts_informations) {
+      auto new_cache = std::make_shared<TabletInfo::ReplicaLocationsPBCache>();
+      auto ts_information_it = ts_informations.begin();
+      for (const TabletInfo::ReplicaMap::value_type& replica : *locs) {
+        FillReplicaPB(replica.second, **ts_information_it, new_cache->replicas.Add());
+        ++ts_information_it;
+      }
+      new_cache->replica_locations = locs;
+      new_cache->ts_informations = std::move(ts_informations);
+      tablet->SetReplicaLocationsPBCache(new_cache);
+      cache = std::move(new_cache);
     }
+    locs_pb->mutable_replicas()->MergeFrom(cache->replicas);
     return Status::OK();
   }
 
@@ -9082,6 +9236,43 @@ void CatalogManager::ReportMetrics() {
   metric_num_tablet_servers_dead_->set_value(ts_descs.size() - num_live_servers);
 }
 
+void CatalogManager::FindTabletMergeCandidates() {
+  if (FLAGS_tablet_merge_size_threshold_bytes <= 0) {
+    metric_tablet_merge_candidates_->set_value(0);
+    return;
+  }
+  const auto now = CoarseMonoClock::Now();
+  if (now < next_tablet_merge_candidates_scan_) {
+    return;
+  }
+  next_tablet_merge_candidates_scan_ =
+      now + std::chrono::seconds(FLAGS_tablet_merge_candidates_scan_interval_secs);
+
+  // Merging the tablets of a pair is not implemented yet, the candidates let operators see how
+  // many tablets could be saved.
+  uint32_t num_candidates = 0;
+  for (const auto& table : GetTables(GetTablesMode::kRunning)) {
+    if (table->colocated() || table->GetTableType() == TRANSACTION_STATUS_TABLE_TYPE) {
+      continue;
+    }
+    TabletInfos tablets;
+    table->GetAllTablets(&tablets);
+    const auto candidates = CatalogManagerUtil::FindTabletMergeCandidates(
+        tablets, FLAGS_tablet_merge_size_threshold_bytes,
+        FLAGS_tablet_merge_load_ops_per_sec_threshold);
+    for (const auto& candidate : candidates) {
+      VLOG(1) << "Tablet merge candidate of table " << table->ToString() << ": "
+              << candidate.first->tablet_id() << " and " << candidate.second->tablet_id();
+    }
+    if (!candidates.empty()) {
+      LOG(INFO) << "Table " << table->ToString() << " has " << candidates.size()
+                << " pairs of adjacent small and cold tablets";
+    }
+    num_candidates += candidates.size();
+  }
+  metric_tablet_merge_candidates_->set_value(num_candidates);
+}
+
 std::string CatalogManager::LogPrefix() const {
   if (tablet_peer()) {
     return consensus::MakeTabletLogPrefix(
@@ -9742,7 +9933,9 @@ void CatalogManager::ProcessTabletPathInfo(const std::string& ts_uuid,
                                         tablet_info.sst_file_size(),
                                         tablet_info.wal_file_size(),
                                         tablet_info.uncompressed_sst_file_size(),
-                                        tablet_info.may_have_orphaned_post_split_data()};
+                                        tablet_info.may_have_orphaned_post_split_data(),
+                                        tablet_info.read_ops_per_sec(),
+                                        tablet_info.write_ops_per_sec()};
       tablet->UpdateReplicaDriveInfo(ts_uuid, drive_info);
       WARN_NOT_OK(
           tablet_split_manager_.ScheduleSplitIfNeeded(*tablet, ts_uuid, drive_info),
@@ -1214,6 +1214,10 @@ class CatalogManager :
   // Report metrics.
   void ReportMetrics();
 
+  // Periodically counts the pairs of adjacent tablets that could be merged, see
+  // FLAGS_tablet_merge_size_threshold_bytes.
+  void FindTabletMergeCandidates();
+
   // Conventional "T xxx P yyy: " prefix for logging.
   std::string LogPrefix() const;
 
@@ -1412,6 +1416,10 @@ class CatalogManager :
   // Number of dead tservers metric.
   scoped_refptr<AtomicGauge<uint32_t>> metric_num_tablet_servers_dead_;
 
+  // Number of tablet merge candidates found by the last scan.
+  scoped_refptr<AtomicGauge<uint32_t>> metric_tablet_merge_candidates_;
+  CoarseTimePoint next_tablet_merge_candidates_scan_;
+
   friend class ClusterLoadBalancer;
 
   // Policy for load balancing tablets on tablet servers.
@@ -124,6 +124,7 @@ void CatalogManagerBgTasks::Run() {
 
       // Report metrics.
       catalog_manager_->ReportMetrics();
+      catalog_manager_->FindTabletMergeCandidates();
 
       // Cleanup old tasks from tracker.
       catalog_manager_->tasks_tracker_->CleanupOldTasks();
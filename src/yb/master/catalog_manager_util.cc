@@ -13,6 +13,8 @@
 
 #include "yb/master/catalog_manager_util.h"
 
+#include <algorithm>
+
 #include <gflags/gflags.h>
 
 #include "yb/util/flag_tags.h"
@@ -224,6 +226,53 @@ Result<std::string> CatalogManagerUtil::GetPlacementUuidFromRaftPeer(
   }
 }
 
+std::vector<std::pair<TabletInfoPtr, TabletInfoPtr>>
+CatalogManagerUtil::FindTabletMergeCandidates(
+    const TabletInfos& tablets, uint64_t max_tablet_size_bytes, double max_ops_per_sec) {
+  struct ColdTablet {
+    TabletInfoPtr tablet;
+    PartitionPB partition;
+    uint64_t size;
+  };
+  std::vector<ColdTablet> cold_tablets;
+  for (const auto& tablet : tablets) {
+    ColdTablet cold_tablet{tablet, PartitionPB(), 0};
+    {
+      const auto lock = tablet->LockForRead();
+      if (lock->pb.state() != SysTabletsEntryPB::RUNNING) {
+        continue;
+      }
+      cold_tablet.partition = lock->pb.partition();
+    }
+    auto drive_info = tablet->GetLeaderReplicaDriveInfo();
+    if (!drive_info.ok() || drive_info->may_have_orphaned_post_split_data ||
+        drive_info->sst_files_size >= max_tablet_size_bytes ||
+        drive_info->read_ops_per_sec + drive_info->write_ops_per_sec > max_ops_per_sec) {
+      continue;
+    }
+    cold_tablet.size = drive_info->sst_files_size;
+    cold_tablets.push_back(std::move(cold_tablet));
+  }
+  std::sort(cold_tablets.begin(), cold_tablets.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.partition.partition_key_start() < rhs.partition.partition_key_start();
+  });
+
+  std::vector<std::pair<TabletInfoPtr, TabletInfoPtr>> result;
+  for (size_t i = 0; i + 1 < cold_tablets.size(); ++i) {
+    const auto& left = cold_tablets[i];
+    const auto& right = cold_tablets[i + 1];
+    if (left.partition.partition_key_end().empty() ||
+        left.partition.partition_key_end() != right.partition.partition_key_start() ||
+        left.size + right.size > max_tablet_size_bytes) {
+      continue;
+    }
+    result.emplace_back(left.tablet, right.tablet);
+    // The right tablet is already paired.
+    ++i;
+  }
+  return result;
+}
+
 CHECKED_STATUS CatalogManagerUtil::CheckIfCanDeleteSingleTablet(
     const scoped_refptr<TabletInfo>& tablet) {
   const auto& tablet_id = tablet->tablet_id();
@@ -73,6 +73,13 @@ class CatalogManagerUtil {
   // Returns error if tablet partition is not covered by running inner tablets partitions.
   static CHECKED_STATUS CheckIfCanDeleteSingleTablet(const scoped_refptr<TabletInfo>& tablet);
 
+  // Returns pairs of adjacent running tablets, that could be merged into one tablet because their
+  // leaders report that they are cold and small: each is smaller than max_tablet_size_bytes,
+  // together they are not larger than it, and each serves at most max_ops_per_sec reads and
+  // writes. A tablet is part of at most one pair. Pairs are ordered by partition key.
+  static std::vector<std::pair<TabletInfoPtr, TabletInfoPtr>> FindTabletMergeCandidates(
+      const TabletInfos& tablets, uint64_t max_tablet_size_bytes, double max_ops_per_sec);
+
   // Checks if one cloudinfo is a prefix of another. This assumes that ci1 and ci2 are
   // prefixes.
   static bool IsCloudInfoPrefix(const CloudInfoPB& ci1, const CloudInfoPB& ci2);
@@ -124,6 +124,20 @@ DEFINE_bool(load_balancer_count_move_as_add, true,
             "Should we enable state change to count add server triggered by load move as just an "
             "add instead of both an add and remove.");
 
+DEFINE_bool(load_balancer_use_tserver_cost, false,
+            "When two tablet servers hold the same number of tablets, order them by the SST size "
+            "and read/write rate they report in heartbeats, so that new replicas go to the less "
+            "busy server and moves are taken from the busier one.");
+TAG_FLAG(load_balancer_use_tserver_cost, advanced);
+TAG_FLAG(load_balancer_use_tserver_cost, runtime);
+
+DEFINE_double(load_balancer_tserver_cost_bytes_per_op, 1024 * 1024,
+              "Number of SST bytes that one read or write operation per second on a tablet server "
+              "is considered equivalent to when computing its cost. Only used when "
+              "load_balancer_use_tserver_cost is set.");
+TAG_FLAG(load_balancer_tserver_cost_bytes_per_op, advanced);
+TAG_FLAG(load_balancer_tserver_cost_bytes_per_op, runtime);
+
 namespace yb {
 namespace master {
 
@@ -64,6 +64,10 @@ DECLARE_int32(load_balancer_max_concurrent_moves_per_table);
 
 DECLARE_bool(allow_leader_balancing_dead_node);
 
+DECLARE_bool(load_balancer_use_tserver_cost);
+
+DECLARE_double(load_balancer_tserver_cost_bytes_per_op);
+
 namespace yb {
 namespace master {
 
@@ -184,6 +188,10 @@ struct CBTabletServerMetadata {
   // The set of tablet ids that have possible non relevant data. Replica should be compacted
   // first before moving
   std::set<TabletId> parent_data_tablets;
+
+  // Cost of this tablet server computed from its reported metrics, used to break load ties.
+  // Snapshotted once per run so that sorting sees consistent values.
+  double cost = 0;
 };
 
 struct CBTabletServerLoadCounts {
@@ -294,6 +302,12 @@ class PerTableLoadState {
       load_a = global_state_->GetGlobalLoad(a);
       load_b = global_state_->GetGlobalLoad(b);
       if (load_a == load_b) {
+        // Both counts are equal; prefer the server that reports less data and traffic.
+        auto cost_a = per_ts_meta_.at(a).cost;
+        auto cost_b = per_ts_meta_.at(b).cost;
+        if (cost_a != cost_b) {
+          return cost_a < cost_b;
+        }
         return a < b;
       }
     }
@@ -540,6 +554,11 @@ class PerTableLoadState {
     // tablet servers that happen to not be serving any tablets, so were not in the map yet.
     auto& ts_meta = per_ts_meta_[ts_uuid];
     ts_meta.descriptor = ts_desc;
+    if (FLAGS_load_balancer_use_tserver_cost) {
+      ts_meta.cost = ts_desc->total_sst_file_size() +
+                     (ts_desc->read_ops_per_sec() + ts_desc->write_ops_per_sec()) *
+                     FLAGS_load_balancer_tserver_cost_bytes_per_op;
+    }
 
     // Also insert into per_ts_global_meta_ if we have yet to.
     global_state_->per_ts_global_meta_.emplace(ts_uuid, CBTabletServerLoadCounts());
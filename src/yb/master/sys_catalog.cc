@@ -579,6 +579,7 @@ Status SysCatalogTable::OpenTablet(const scoped_refptr<tablet::RaftGroupMetadata
           tablet->GetTabletMetricsEntity(),
           raft_pool(),
           tablet_prepare_pool(),
+          nullptr /* raft_apply_pool */,
           nullptr /* retryable_requests */),
       "Failed to Init() TabletPeer");
 
@@ -731,6 +732,7 @@ Status SysCatalogTable::Visit(VisitorBase* visitor) {
   }));
 
   auto duration = CoarseMonoClock::Now() - start;
+  std::lock_guard<std::mutex> lock(visitor_duration_metrics_mutex_);
   string id = Format("num_entries_with_type_$0_loaded", std::to_string(visitor->entry_type()));
   if (visitor_duration_metrics_.find(id) == visitor_duration_metrics_.end()) {
     string description = id + " metric for SysCatalogTable::Visit";
@@ -32,6 +32,7 @@
 #ifndef YB_MASTER_SYS_CATALOG_H_
 #define YB_MASTER_SYS_CATALOG_H_
 
+#include <mutex>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -261,6 +262,8 @@ class SysCatalogTable {
 
   scoped_refptr<Counter> peer_write_count;
 
+  // Protects visitor_duration_metrics_; the sys catalog may be visited by several loaders at once.
+  std::mutex visitor_duration_metrics_mutex_;
   std::unordered_map<std::string, scoped_refptr<AtomicGauge<uint64>>> visitor_duration_metrics_;
 
   std::shared_ptr<tserver::TabletMemoryManager> mem_manager_;
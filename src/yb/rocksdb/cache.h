@@ -66,6 +66,17 @@ extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits);
 extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                                      bool strict_capacity_limit);
 
+// Create a new cache with CLOCK eviction policy, that does not lock on lookup and release.
+// Each shard has a fixed size hash table, dimensioned for capacity / estimated_entry_charge
+// entries. When entries are smaller, the cache holds less than capacity bytes.
+constexpr size_t kDefaultClockCacheEntryCharge = 32 * 1024;
+
+extern shared_ptr<Cache> NewClockCache(size_t capacity);
+extern shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits);
+extern shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits,
+                                       bool strict_capacity_limit,
+                                       size_t estimated_entry_charge);
+
 using QueryId = int64_t;
 // Query ids to represent values for the default query id.
 constexpr QueryId kDefaultQueryId = 0;
@@ -135,6 +146,17 @@ class Cache {
   // to it have been released.
   virtual void Erase(const Slice& key) = 0;
 
+  // Returns true if the cache has a mapping for "key". Implementations should not touch the
+  // entry, the default one looks it up, so it could affect the eviction order.
+  virtual bool Contains(const Slice& key) {
+    Handle* handle = Lookup(key, kInMultiTouchId);
+    if (handle == nullptr) {
+      return false;
+    }
+    Release(handle);
+    return true;
+  }
+
   // Return a new numeric id.  May be used by multiple clients who are
   // sharing the same cache to partition the key space.  Typically the
   // client will allocate a new id at startup and prepend the id to
@@ -184,7 +206,9 @@ class Cache {
   virtual void ApplyToAllCacheEntries(void (*callback)(void*, size_t),
                                       bool thread_safe) = 0;
 
-  virtual void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) = 0;
+  virtual void SetMetrics(
+      const scoped_refptr<yb::MetricEntity>& entity,
+      yb::BlockCacheKind kind = yb::BlockCacheKind::kUncompressed) = 0;
 
   // Tries to evict specified amount of bytes from cache.
   virtual size_t Evict(size_t required) { return 0; }
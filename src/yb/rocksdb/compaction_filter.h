@@ -30,10 +30,12 @@
 
 #include "yb/util/slice.h"
 #include "yb/rocksdb/metadata.h"
+#include "yb/rocksdb/status.h"
 
 namespace rocksdb {
 
 class SliceTransform;
+struct FileMetaData;
 
 // Context information of a compaction run
 struct CompactionFilterContext {
@@ -46,8 +48,10 @@ struct CompactionFilterContext {
 
 // CompactionFilter allows an application to modify/delete a key-value at
 // the time of compaction.
-
-YB_DEFINE_ENUM(FilterDecision, (kKeep)(kDiscard));
+//
+// kDelay keeps the key-value, but postpones its output until CompleteDelayedValue returns its
+// final value, see CompleteDelayedValue.
+YB_DEFINE_ENUM(FilterDecision, (kKeep)(kDiscard)(kDelay));
 
 class CompactionFilter {
  public:
@@ -123,9 +127,25 @@ class CompactionFilter {
     return false;
   }
 
+  // Invoked after each call to Filter while there is a key-value delayed by kDelay, and at the end
+  // of the compaction input with end_of_input set. Returns true when the delayed key-value is
+  // complete, storing its final value to value, and should always return true at the end of the
+  // input. The delayed key-value and the key-values kept after it are held by the compaction until
+  // then, so a filter could change the delayed value based on the key-values that follow it.
+  virtual bool CompleteDelayedValue(bool end_of_input, std::string* value) {
+    return true;
+  }
+
   virtual void CompactionFinished() {
   }
 
+  // Invoked after output files of the compaction are written, before they are installed. Filters
+  // that write data referenced by the output files outside of them should make it durable here.
+  // The compaction fails when an error is returned.
+  virtual Status SyncExternalData() {
+    return Status::OK();
+  }
+
   // By default, compaction will only call Filter() on keys written after the
   // most recent call to GetSnapshot(). However, if the compaction filter
   // overrides IgnoreSnapshots to make it return false, the compaction filter
@@ -165,6 +185,28 @@ class CompactionFilterFactory {
   virtual std::unique_ptr<CompactionFilter> CreateCompactionFilter(
       const CompactionFilter::Context& context) = 0;
 
+  // Returns files from the specified list, whose records are all obsolete, so they could be
+  // deleted without compaction. Files are listed from newest to oldest, files that are being
+  // compacted should not be returned.
+  virtual std::vector<FileMetaData*> ObsoleteFiles(const std::vector<FileMetaData*>& files) {
+    return std::vector<FileMetaData*>();
+  }
+
+  // Returns the time window of each of the specified files, or an empty vector when files should
+  // not be grouped by time windows. Files are listed from newest to oldest. Universal compaction
+  // compacts only sorted runs of the same window, and compacts runs of windows older than the
+  // window of the newest file, that are closed for writes, only once into a single sorted run.
+  virtual std::vector<uint64_t> FileTimeWindows(const std::vector<FileMetaData*>& files) {
+    return std::vector<uint64_t>();
+  }
+
+  // Returns the prefix of user_key, that should be used as a boundary between subcompactions.
+  // Compaction filters created for subcompactions see disjoint key ranges, so keys that
+  // depend on each other, like records of the same document, should not be split between them.
+  virtual Slice SubcompactionBoundary(const Slice& user_key) {
+    return user_key;
+  }
+
   // Returns a name that identifies this compaction filter factory.
   virtual const char* Name() const = 0;
 };
@@ -900,7 +900,10 @@ class DB {
   // Needed for StackableDB
   virtual DB* GetRootDB() { return this; }
 
-  virtual CHECKED_STATUS Import(const std::string& source_dir) {
+  // Imports data from other database dir. When flushed_frontier is specified, it is applied to the
+  // flushed frontier of this database atomically with adding the imported files.
+  virtual CHECKED_STATUS Import(
+      const std::string& source_dir, const UserFrontierPtr& flushed_frontier) {
     return STATUS(NotSupported, "");
   }
 
@@ -909,6 +912,17 @@ class DB {
   // Returns approximate middle key (see Version::GetMiddleKey).
   virtual yb::Result<std::string> GetMiddleKey() = 0;
 
+  // Returns data blocks of SST files present in the block cache, at most max_blocks in total.
+  virtual yb::Result<std::vector<SstDataBlocks>> GetCachedDataBlocks(size_t max_blocks) {
+    return STATUS(NotSupported, "");
+  }
+
+  // Loads data blocks of the SST file into the block cache, e.g. ones returned by
+  // GetCachedDataBlocks before restart. Does nothing when there is no such file anymore.
+  virtual CHECKED_STATUS WarmUpDataBlocks(const SstDataBlocks& file) {
+    return STATUS(NotSupported, "");
+  }
+
   // Used in testing to make the old memtable immutable and start writing to a new one.
   virtual void TEST_SwitchMemtable() {}
 
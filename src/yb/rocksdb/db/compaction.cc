@@ -586,7 +586,12 @@ bool Compaction::ShouldFormSubcompactions() const {
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
     return start_level_ == 0 && !IsOutputLevelEmpty();
   } else if (IsCompactionStyleUniversal()) {
-    return number_levels_ > 1 && output_level_ > 0;
+    if (number_levels_ == 1) {
+      // All output files have the same sequence numbers range, so universal compaction picker
+      // treats them as a single sorted run.
+      return true;
+    }
+    return output_level_ > 0;
   } else {
     return false;
   }
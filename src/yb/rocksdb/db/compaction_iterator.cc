@@ -84,9 +84,63 @@ void CompactionIterator::SeekToFirst() {
 
   NextFromInput();
   PrepareOutput();
+  BufferOutputs();
 }
 
 void CompactionIterator::Next() {
+  if (num_ready_) {
+    buffered_.pop_front();
+    --num_ready_;
+    if (!num_ready_) {
+      // The current output follows the buffered ones, and is not returned yet.
+      BufferOutputs();
+    }
+    return;
+  }
+  NextUnbuffered();
+  BufferOutputs();
+}
+
+void CompactionIterator::BufferOutputs() {
+  while (!num_ready_ && (delay_current_ || delayed_idx_)) {
+    if (!valid_) {
+      DCHECK(!delay_current_);
+      delay_current_ = false;
+      MaybeCompleteDelayedValue(/* end_of_input= */ true);
+      return;
+    }
+    if (delay_current_) {
+      DCHECK(!delayed_idx_);
+      delayed_idx_ = buffered_.size();
+      delay_current_ = false;
+    }
+    buffered_.emplace_back();
+    auto& output = buffered_.back();
+    output.key_data.assign(key_.cdata(), key_.size());
+    output.value_data.assign(value_.cdata(), value_.size());
+    output.key = output.key_data;
+    output.value = output.value_data;
+    output.ikey = ikey_;
+    output.ikey.user_key = ExtractUserKey(output.key);
+    NextUnbuffered();
+  }
+}
+
+void CompactionIterator::MaybeCompleteDelayedValue(bool end_of_input) {
+  if (!delayed_idx_) {
+    return;
+  }
+  auto& delayed = buffered_[*delayed_idx_];
+  if (!compaction_filter_->CompleteDelayedValue(end_of_input, &delayed.value_data)) {
+    DCHECK(!end_of_input);
+    return;
+  }
+  delayed.value = delayed.value_data;
+  num_ready_ = buffered_.size();
+  delayed_idx_.reset();
+}
+
+void CompactionIterator::NextUnbuffered() {
   // If there is a merge output, return it before continuing to process the
   // input.
   if (merge_out_iter_.Valid()) {
@@ -184,6 +238,7 @@ void CompactionIterator::NextFromInput() {
       has_outputted_key_ = false;
       current_user_key_sequence_ = kMaxSequenceNumber;
       current_user_key_snapshot_ = 0;
+      delay_current_ = false;
 
       // apply the compaction filter to the first occurrence of the user key
       if (compaction_filter_ != nullptr && ikey_.type == kTypeValue &&
@@ -196,9 +251,12 @@ void CompactionIterator::NextFromInput() {
         bool value_changed = false;
         bool to_delete = false;
         compaction_filter_value_.clear();
-        to_delete = compaction_filter_->Filter(
+        const auto decision = compaction_filter_->Filter(
             compaction_->level(), ikey_.user_key, value_,
-            &compaction_filter_value_, &value_changed) != FilterDecision::kKeep;
+            &compaction_filter_value_, &value_changed);
+        to_delete = decision == FilterDecision::kDiscard;
+        delay_current_ = decision == FilterDecision::kDelay;
+        MaybeCompleteDelayedValue(/* end_of_input= */ false);
         if (to_delete) {
           // convert the current key to a delete
           ikey_.type = kTypeDeletion;
@@ -29,6 +29,8 @@
 #include <string>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include "yb/rocksdb/db/compaction.h"
 #include "yb/rocksdb/db/merge_helper.h"
 #include "yb/rocksdb/compaction_filter.h"
@@ -76,15 +78,38 @@ class CompactionIterator {
   void Next();
 
   // Getters
-  const Slice& key() const { return key_; }
-  const Slice& value() const { return value_; }
+  const Slice& key() const { return num_ready_ ? buffered_.front().key : key_; }
+  const Slice& value() const { return num_ready_ ? buffered_.front().value : value_; }
   const Status& status() const { return status_; }
-  const ParsedInternalKey& ikey() const { return ikey_; }
-  bool Valid() const { return valid_; }
-  const Slice& user_key() const { return current_user_key_; }
+  const ParsedInternalKey& ikey() const { return num_ready_ ? buffered_.front().ikey : ikey_; }
+  bool Valid() const { return num_ready_ || valid_; }
+  const Slice& user_key() const {
+    return num_ready_ ? buffered_.front().ikey.user_key : current_user_key_;
+  }
   const CompactionIteratorStats& iter_stats() const { return iter_stats_; }
 
  private:
+  // A copy of an output held while the compaction filter completes a delayed value, see
+  // FilterDecision::kDelay.
+  struct BufferedOutput {
+    std::string key_data;
+    std::string value_data;
+    Slice key;
+    Slice value;
+    ParsedInternalKey ikey;
+  };
+
+  // Produces the next record in the compaction, before it is buffered.
+  void NextUnbuffered();
+
+  // Buffers outputs, starting from the current one, while there is a delayed value. Stops at the
+  // first output that could be returned.
+  void BufferOutputs();
+
+  // Asks the compaction filter to complete the delayed value, and makes buffered outputs ready
+  // when it does.
+  void MaybeCompleteDelayedValue(bool end_of_input);
+
   // Processes the input stream to find the next output
   void NextFromInput();
 
@@ -153,6 +178,17 @@ class CompactionIterator {
 
   MergeOutputIterator merge_out_iter_;
   std::string compaction_filter_value_;
+
+  // Whether the compaction filter delayed the current output.
+  bool delay_current_ = false;
+  // Outputs held while the compaction filter completes the delayed value. When num_ready_ is not
+  // zero, that many outputs are complete and returned before the current output. Otherwise the
+  // outputs start with the delayed one. Elements of deque are not moved by push_back and
+  // pop_front, so slices of an output stay valid.
+  std::deque<BufferedOutput> buffered_;
+  size_t num_ready_ = 0;
+  // Index of the delayed output in buffered_, if there is one.
+  boost::optional<size_t> delayed_idx_;
   // "level_ptrs" holds indices that remember which file of an associated
   // level we were last checking during the last call to compaction->
   // KeyNotExistsBeyondOutputLevel(). This allows future calls to the function
@@ -49,6 +49,7 @@
 #include "yb/rocksdb/db/memtable_list.h"
 #include "yb/rocksdb/db/merge_context.h"
 #include "yb/rocksdb/db/merge_helper.h"
+#include "yb/rocksdb/db/table_cache.h"
 #include "yb/rocksdb/db/version_set.h"
 #include "yb/rocksdb/port/likely.h"
 #include "yb/rocksdb/port/port.h"
@@ -245,6 +246,7 @@ CompactionJob::CompactionJob(
       db_options_(db_options),
       env_options_(env_options),
       env_(db_options.env),
+      env_options_for_outputs_(env_->OptimizeForCompactionTableWrite(env_options, db_options)),
       versions_(versions),
       shutting_down_(shutting_down),
       log_buffer_(log_buffer),
@@ -320,6 +322,31 @@ struct RangeWithSize {
       : range(a, b), size(s) {}
 };
 
+void CompactionJob::AddIndexSplitKeys(
+    const LevelFilesBrief& flevel, std::vector<Slice>* bounds) {
+  auto* cfd = compact_->compaction->column_family_data();
+  for (size_t i = 0; i < flevel.num_files; i++) {
+    auto trwh = cfd->table_cache()->GetTableReader(
+        env_options_, cfd->internal_comparator(), flevel.files[i].fd, kDefaultQueryId,
+        /* no_io =*/ false, cfd->internal_stats()->GetFileReadHist(0),
+        /* skip_filters =*/ true);
+    if (!trwh.ok()) {
+      RLOG(InfoLogLevel::WARN_LEVEL, db_options_.info_log,
+           "[%s] Failed to open table reader for subcompaction boundaries: %s",
+           cfd->GetName().c_str(), trwh.status().ToString().c_str());
+      continue;
+    }
+    auto split_keys = trwh->table_reader->GetSplitKeys(db_options_.max_subcompactions);
+    if (!split_keys.ok()) {
+      continue;
+    }
+    for (auto& key : *split_keys) {
+      index_split_keys_.push_back(std::move(key));
+      bounds->emplace_back(index_split_keys_.back());
+    }
+  }
+}
+
 // Generates a histogram representing potential divisions of key ranges from
 // the input. It adds the starting and/or ending keys of certain input files
 // to the working set and then finds the approximate size of data in between
@@ -329,6 +356,7 @@ void CompactionJob::GenSubcompactionBoundaries() {
   auto* c = compact_->compaction;
   auto* cfd = c->column_family_data();
   const Comparator* cfd_comparator = cfd->user_comparator();
+  auto* filter_factory = cfd->ioptions()->compaction_filter_factory;
   std::vector<Slice> bounds;
   int start_lvl = c->start_level();
   int out_lvl = c->output_level();
@@ -352,6 +380,11 @@ void CompactionJob::GenSubcompactionBoundaries() {
           bounds.emplace_back(flevel->files[i].smallest.key);
           bounds.emplace_back(flevel->files[i].largest.key);
         }
+        if (c->number_levels() == 1) {
+          // With a single level there are only a few large files to compact, so also add keys
+          // from their indexes, which divide each file into parts of roughly the same size.
+          AddIndexSplitKeys(*flevel, &bounds);
+        }
       } else {
         // For all other levels add the smallest/largest key in the level to
         // encompass the range covered by that level
@@ -424,7 +457,14 @@ void CompactionJob::GenSubcompactionBoundaries() {
         continue;
       }
       if (sum >= mean) {
-        boundaries_.emplace_back(ExtractUserKey(ranges[i].range.limit));
+        auto boundary = filter_factory
+            ? filter_factory->SubcompactionBoundary(ExtractUserKey(ranges[i].range.limit))
+            : ExtractUserKey(ranges[i].range.limit);
+        if (!boundaries_.empty() && cfd_comparator->Compare(boundaries_.back(), boundary) == 0) {
+          // Ranges are split inside the same unit of the compaction filter, so merge them.
+          continue;
+        }
+        boundaries_.emplace_back(boundary);
         sizes_.emplace_back(sum);
         subcompactions--;
         sum = 0;
@@ -607,8 +647,13 @@ void CompactionJob::ProcessKeyValueCompaction(
 
   if (compaction_filter) {
     // This is used to persist the history cutoff hybrid time chosen for the DocDB compaction
-    // filter.
-    largest_user_frontier_ = compaction_filter->GetLargestUserFrontier();
+    // filter. Each subcompaction has its own filter, so the largest of their frontiers is used.
+    auto frontier = compaction_filter->GetLargestUserFrontier();
+    if (frontier) {
+      std::lock_guard<std::mutex> lock(largest_user_frontier_mutex_);
+      UpdateUserFrontier(
+          &largest_user_frontier_, std::move(frontier), UpdateUserValueType::kLargest);
+    }
   }
 
   MergeHelper merge(
@@ -744,6 +789,9 @@ void CompactionJob::ProcessKeyValueCompaction(
 
   sub_compact->c_iter.reset();
   input.reset();
+  if (status.ok() && compaction_filter) {
+    status = compaction_filter->SyncExternalData();
+  }
   sub_compact->status = status;
   if (compaction_filter) {
     compaction_filter->CompactionFinished();
@@ -923,8 +971,11 @@ Status CompactionJob::InstallCompactionResults(
       compaction->edit()->AddFile(compaction->output_level(), out.meta);
     }
   }
-  if (largest_user_frontier_) {
-    compaction->edit()->UpdateFlushedFrontier(largest_user_frontier_);
+  {
+    std::lock_guard<std::mutex> lock(largest_user_frontier_mutex_);
+    if (largest_user_frontier_) {
+      compaction->edit()->UpdateFlushedFrontier(largest_user_frontier_);
+    }
   }
   return versions_->LogAndApply(compaction->column_family_data(),
                                 mutable_cf_options, compaction->edit(),
@@ -941,7 +992,7 @@ void CompactionJob::RecordCompactionIOStats() {
 Status CompactionJob::OpenFile(const std::string table_name, uint64_t file_number,
     const std::string file_type_label, const std::string fname,
     std::unique_ptr<WritableFile>* writable_file) {
-  Status s = NewWritableFile(env_, fname, writable_file, env_options_);
+  Status s = NewWritableFile(env_, fname, writable_file, env_options_for_outputs_);
   if (!s.ok()) {
     RLOG(InfoLogLevel::ERROR_LEVEL, db_options_.info_log,
         "[%s] [JOB %d] OpenCompactionOutputFiles for table #%" PRIu64
@@ -993,7 +1044,8 @@ Status CompactionJob::OpenCompactionOutputFile(
         (*writable_file)->SetPreallocationBlockSize(preallocation_block_size);
       }
       writer->reset(new WritableFileWriter(
-          std::move(*writable_file), env_options_, sub_compact->compaction->suspender()));
+          std::move(*writable_file), env_options_for_outputs_,
+          sub_compact->compaction->suspender()));
     };
 
     const bool is_split_sst = cfd->ioptions()->table_factory->IsSplitSstForWriteSupported();
@@ -30,6 +30,7 @@
 #include <deque>
 #include <functional>
 #include <limits>
+#include <mutex>
 #include <set>
 #include <string>
 #include <utility>
@@ -110,6 +111,8 @@ class CompactionJob {
 
   void AggregateStatistics();
   void GenSubcompactionBoundaries();
+  // Adds keys from the indexes of the specified files as potential subcompaction boundaries.
+  void AddIndexSplitKeys(const LevelFilesBrief& flevel, std::vector<Slice>* bounds);
 
   // update the thread status for starting a compaction.
   void ReportStartedCompaction(Compaction* compaction);
@@ -153,6 +156,8 @@ class CompactionJob {
   const DBOptions& db_options_;
   const EnvOptions& env_options_;
   Env* env_;
+  // Used for compaction output files.
+  const EnvOptions env_options_for_outputs_;
   VersionSet* versions_;
   std::atomic<bool>* shutting_down_;
   LogBuffer* log_buffer_;
@@ -185,8 +190,12 @@ class CompactionJob {
   std::vector<Slice> boundaries_;
   // Stores the approx size of keys covered in the range of each subcompaction
   std::vector<uint64_t> sizes_;
+  // Stores the keys from SST indexes, that could be referenced by boundaries_. Deque keeps
+  // references to its elements valid when new keys are added.
+  std::deque<std::string> index_split_keys_;
 
-  UserFrontierPtr largest_user_frontier_;
+  std::mutex largest_user_frontier_mutex_;
+  UserFrontierPtr largest_user_frontier_ GUARDED_BY(largest_user_frontier_mutex_);
 };
 
 }  // namespace rocksdb
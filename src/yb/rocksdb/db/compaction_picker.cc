@@ -28,10 +28,13 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
 #include <limits>
 #include <queue>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <gflags/gflags.h>
 
@@ -48,6 +51,14 @@
 DEFINE_bool(aggressive_compaction_for_read_amp, false,
             "Determines if we should compact aggressively to reduce read amplification based on "
             "number of files alone, without regards to relative sizes of the SSTable files.");
+DEFINE_int32(read_triggered_compaction_files_threshold, 0,
+             "When the average number of SST files read by iterators of a DB with universal "
+             "compaction exceeds this value, compact the most recent files to reduce read "
+             "amplification. 0 to disable.");
+DEFINE_int32(read_triggered_compaction_min_reads, 1000,
+             "Minimal number of reads to observe before triggering a read triggered compaction.");
+DEFINE_int64(read_triggered_compaction_max_bytes, 1024 * 1024 * 1024,
+             "Maximal total size of input files of a read triggered compaction.");
 
 namespace rocksdb {
 
@@ -1154,20 +1165,49 @@ bool LevelCompactionPicker::PickCompactionBySize(VersionStorageInfo* vstorage,
 bool UniversalCompactionPicker::NeedsCompaction(
     const VersionStorageInfo* vstorage) const {
   const int kLevel0 = 0;
-  return vstorage->CompactionScore(kLevel0) >= 1;
+  return vstorage->CompactionScore(kLevel0) >= 1 ||
+         read_triggered_compaction_requested_.load(std::memory_order_acquire);
+}
+
+bool UniversalCompactionPicker::RecordRead(size_t num_files) {
+  const int threshold = FLAGS_read_triggered_compaction_files_threshold;
+  if (threshold <= 0) {
+    return false;
+  }
+  const auto num_files_read =
+      num_files_read_.fetch_add(num_files, std::memory_order_relaxed) + num_files;
+  const auto num_reads = num_reads_.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (num_reads < static_cast<uint64_t>(std::max(FLAGS_read_triggered_compaction_min_reads, 1)) ||
+      num_files_read <= num_reads * threshold) {
+    return false;
+  }
+  bool expected = false;
+  return read_triggered_compaction_requested_.compare_exchange_strong(
+      expected, true, std::memory_order_acq_rel);
 }
 
 struct UniversalCompactionPicker::SortedRun {
   SortedRun(int _level, FileMetaData* _file, uint64_t _size,
             uint64_t _compensated_file_size, bool _being_compacted)
       : level(_level),
-        file(_file),
         size(_size),
         compensated_file_size(_compensated_file_size),
         being_compacted(_being_compacted) {
     assert(compensated_file_size > 0);
     // Allowed either one of level and file.
-    assert((level != 0) != (file != nullptr));
+    assert((level != 0) != (_file != nullptr));
+    if (_file) {
+      files.push_back(_file);
+    }
+  }
+
+  // Adds level 0 file with the same sequence numbers range as other files of this sorted run.
+  void AddFile(FileMetaData* file) {
+    assert(level == 0);
+    files.push_back(file);
+    size += file->fd.GetTotalFileSize();
+    compensated_file_size += file->compensated_file_size;
+    being_compacted = being_compacted || file->being_compacted;
   }
 
   void Dump(char* out_buf, size_t out_buf_size,
@@ -1178,9 +1218,10 @@ struct UniversalCompactionPicker::SortedRun {
                     size_t sorted_run_count) const;
 
   int level;
-  // `file` Will be null for level > 0. For level = 0, the sorted run is
-  // for this file.
-  FileMetaData* file;
+  // `files` will be empty for level > 0. For level = 0, the sorted run is
+  // for these files. There are several files, when they were produced by the same compaction
+  // with subcompactions, so they have the same sequence numbers range and disjoint key ranges.
+  std::vector<FileMetaData*> files;
   // For level > 0, `size` and `compensated_file_size` are sum of sizes all
   // files in the level. `being_compacted` should be the same for all files
   // in a non-zero level. Use the value here.
@@ -1193,14 +1234,17 @@ void UniversalCompactionPicker::SortedRun::Dump(char* out_buf,
                                                 size_t out_buf_size,
                                                 bool print_path) const {
   if (level == 0) {
-    assert(file != nullptr);
+    assert(!files.empty());
+    const auto* file = files.front();
+    const auto num_files = files.size();
     if (file->fd.GetPathId() == 0 || !print_path) {
-      snprintf(out_buf, out_buf_size, "file %" PRIu64, file->fd.GetNumber());
+      snprintf(out_buf, out_buf_size, "file %" PRIu64 " (%" ROCKSDB_PRIszt " files)",
+               file->fd.GetNumber(), num_files);
     } else {
       snprintf(out_buf, out_buf_size, "file %" PRIu64
                                       "(path "
-                                      "%" PRIu32 ")",
-               file->fd.GetNumber(), file->fd.GetPathId());
+                                      "%" PRIu32 ") (%" ROCKSDB_PRIszt " files)",
+               file->fd.GetNumber(), file->fd.GetPathId(), num_files);
     }
   } else {
     snprintf(out_buf, out_buf_size, "level %d", level);
@@ -1210,13 +1254,13 @@ void UniversalCompactionPicker::SortedRun::Dump(char* out_buf,
 void UniversalCompactionPicker::SortedRun::DumpSizeInfo(
     char* out_buf, size_t out_buf_size, size_t sorted_run_count) const {
   if (level == 0) {
-    assert(file != nullptr);
+    assert(!files.empty());
     snprintf(out_buf, out_buf_size,
              "file %" PRIu64 "[%" ROCKSDB_PRIszt
-             "] "
+             "] (%" ROCKSDB_PRIszt " files) "
              "with size %" PRIu64 " (compensated size %" PRIu64 ")",
-             file->fd.GetNumber(), sorted_run_count, file->fd.GetTotalFileSize(),
-             file->compensated_file_size);
+             files.front()->fd.GetNumber(), sorted_run_count, files.size(), size,
+             compensated_file_size);
   } else {
     snprintf(out_buf, out_buf_size,
              "level %d[%" ROCKSDB_PRIszt
@@ -1231,15 +1275,30 @@ std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
                                                    const ImmutableCFOptions& ioptions,
                                                    uint64_t max_file_size) {
   std::vector<std::vector<SortedRun>> ret(1);
-  for (FileMetaData* f : vstorage.LevelFiles(0)) {
-    if (f->fd.GetTotalFileSize() <= max_file_size) {
+  const auto& level0_files = vstorage.LevelFiles(0);
+  for (auto it = level0_files.begin(); it != level0_files.end();) {
+    // Files produced by the same compaction with subcompactions form a single sorted run, and
+    // are compacted only together.
+    auto run_end = std::find_if(it + 1, level0_files.end(), [it](FileMetaData* f) {
+      return f->smallest.seqno != (**it).smallest.seqno ||
+             f->largest.seqno != (**it).largest.seqno;
+    });
+    const bool too_large = std::any_of(it, run_end, [max_file_size](FileMetaData* f) {
+      return f->fd.GetTotalFileSize() > max_file_size;
+    });
+    if (!too_large) {
+      FileMetaData* f = *it;
       ret.back().emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
           f->being_compacted);
+      while (++it != run_end) {
+        ret.back().back().AddFile(*it);
+      }
     // If last sequence is empty it means that there are multiple too-large-to-compact files in
     // a row. So we just don't start new sequence in this case.
     } else if (!ret.back().empty()) {
       ret.emplace_back();
     }
+    it = run_end;
   }
 
   for (int level = 1; level < vstorage.num_levels(); level++) {
@@ -1359,13 +1418,57 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompaction(
     const MutableCFOptions& mutable_cf_options,
     VersionStorageInfo* vstorage,
     LogBuffer* log_buffer) {
+  auto obsolete_files_compaction = PickCompactionUniversalObsoleteFiles(
+      cf_name, mutable_cf_options, vstorage, log_buffer);
+  if (obsolete_files_compaction) {
+    return obsolete_files_compaction;
+  }
+
   std::vector<std::vector<SortedRun>> sorted_runs = CalculateSortedRuns(
       *vstorage,
       ioptions_,
       mutable_cf_options.max_file_size_for_compaction);
+  const auto time_windows = SplitSortedRunsByTimeWindow(*vstorage, &sorted_runs);
+
+  if (read_triggered_compaction_requested_.exchange(false, std::memory_order_acq_rel)) {
+    // Start collecting read statistics of the new set of files from scratch.
+    num_reads_.store(0, std::memory_order_relaxed);
+    num_files_read_.store(0, std::memory_order_relaxed);
+    auto result = PickCompactionUniversalReadTriggered(
+        cf_name, mutable_cf_options, vstorage, sorted_runs.front(), log_buffer);
+    if (result != nullptr) {
+      LOG_TO_BUFFER(log_buffer, "[%s] Universal: compacting for observed read amp",
+                    cf_name.c_str());
+      MeasureTime(ioptions_.statistics, NUM_FILES_IN_SINGLE_COMPACTION,
+                  result->inputs(0)->size());
+      level0_compactions_in_progress_.insert(result.get());
+      return result;
+    }
+  }
+
+  if (!time_windows.empty()) {
+    // Sequences are ordered from the newest one, so the first one belongs to the newest window.
+    // Runs of older windows are compacted once into a single sorted run, and only runs of the
+    // newest window are compacted by size.
+    const auto newest_window = time_windows.front();
+    for (size_t i = 0; i != sorted_runs.size(); ++i) {
+      if (time_windows[i] >= newest_window) {
+        continue;
+      }
+      auto result = PickCompactionUniversalTimeWindow(
+          cf_name, mutable_cf_options, vstorage, sorted_runs[i], log_buffer);
+      if (result != nullptr) {
+        return result;
+      }
+    }
+  }
 
-  for (const auto& block : sorted_runs) {
-    auto result = DoPickCompaction(cf_name, mutable_cf_options, vstorage, log_buffer, block);
+  for (size_t i = 0; i != sorted_runs.size(); ++i) {
+    if (!time_windows.empty() && time_windows[i] < time_windows.front()) {
+      continue;
+    }
+    auto result = DoPickCompaction(
+        cf_name, mutable_cf_options, vstorage, log_buffer, sorted_runs[i]);
     if (result != nullptr) {
       return result;
     }
@@ -1373,6 +1476,88 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompaction(
   return nullptr;
 }
 
+std::vector<uint64_t> UniversalCompactionPicker::SplitSortedRunsByTimeWindow(
+    const VersionStorageInfo& vstorage, std::vector<std::vector<SortedRun>>* sorted_runs) {
+  // Other levels could contain records of any time window.
+  if (ioptions_.compaction_filter_factory == nullptr || vstorage.num_levels() != 1) {
+    return std::vector<uint64_t>();
+  }
+  const auto& level_files = vstorage.LevelFiles(0);
+  auto file_windows = ioptions_.compaction_filter_factory->FileTimeWindows(level_files);
+  if (file_windows.empty()) {
+    return std::vector<uint64_t>();
+  }
+  DCHECK_EQ(file_windows.size(), level_files.size());
+  std::unordered_map<const FileMetaData*, uint64_t> window_of_file;
+  for (size_t i = 0; i != level_files.size(); ++i) {
+    window_of_file.emplace(level_files[i], file_windows[i]);
+  }
+
+  std::vector<std::vector<SortedRun>> result;
+  std::vector<uint64_t> windows;
+  for (auto& sequence : *sorted_runs) {
+    bool start_sequence = true;
+    for (auto& sr : sequence) {
+      // Files of the same sorted run are compacted together, so the run belongs to the newest
+      // window of its files.
+      uint64_t window = 0;
+      for (auto* f : sr.files) {
+        window = std::max(window, window_of_file[f]);
+      }
+      if (start_sequence || window != windows.back()) {
+        result.emplace_back();
+        windows.push_back(window);
+        start_sequence = false;
+      }
+      result.back().push_back(std::move(sr));
+    }
+  }
+  *sorted_runs = std::move(result);
+  return windows;
+}
+
+std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompactionUniversalTimeWindow(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, const std::vector<SortedRun>& sorted_runs,
+    LogBuffer* log_buffer) {
+  if (sorted_runs.size() < 2) {
+    return nullptr;
+  }
+  uint64_t total_size = 0;
+  for (const auto& sr : sorted_runs) {
+    if (sr.being_compacted) {
+      return nullptr;
+    }
+    total_size += sr.size;
+  }
+
+  std::vector<CompactionInputFiles> inputs(1);
+  inputs[0].level = 0;
+  for (size_t i = 0; i != sorted_runs.size(); ++i) {
+    auto& picking_sr = sorted_runs[i];
+    inputs[0].files.insert(
+        inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
+    char file_num_buf[256];
+    picking_sr.DumpSizeInfo(file_num_buf, sizeof(file_num_buf), i);
+    LOG_TO_BUFFER(log_buffer, "[%s] Universal: time window picking %s",
+                  cf_name.c_str(), file_num_buf);
+  }
+
+  auto c = Compaction::Create(
+      vstorage, mutable_cf_options, std::move(inputs), 0 /* output_level */,
+      mutable_cf_options.MaxFileSizeForLevel(0), LLONG_MAX, GetPathId(ioptions_, total_size),
+      GetCompressionType(ioptions_, 0, 1), /* grandparents = */ std::vector<FileMetaData*>(),
+      ioptions_.info_log, /* is_manual = */ false, vstorage->CompactionScore(0),
+      /* deletion_compaction = */ false, CompactionReason::kUniversalTimeWindow);
+  if (c) {
+    LOG_TO_BUFFER(log_buffer, "[%s] Universal: compacting closed time window",
+                  cf_name.c_str());
+    MeasureTime(ioptions_.statistics, NUM_FILES_IN_SINGLE_COMPACTION, c->inputs(0)->size());
+    level0_compactions_in_progress_.insert(c.get());
+  }
+  return c;
+}
+
 std::unique_ptr<Compaction> UniversalCompactionPicker::DoPickCompaction(
     const std::string& cf_name,
     const MutableCFOptions& mutable_cf_options,
@@ -1457,6 +1642,7 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::DoPickCompaction(
 // validate that all the chosen files of L0 are non overlapping in time
 #ifndef NDEBUG
   SequenceNumber prev_smallest_seqno = 0U;
+  SequenceNumber prev_largest_seqno = 0U;
   bool is_first = true;
 
   size_t level_index = 0U;
@@ -1465,10 +1651,13 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::DoPickCompaction(
       DCHECK_LE(f->smallest.seqno, f->largest.seqno);
       if (is_first) {
         is_first = false;
-      } else {
+      } else if (f->smallest.seqno != prev_smallest_seqno ||
+                 f->largest.seqno != prev_largest_seqno) {
+        // Files of the same sorted run have the same sequence numbers range.
         DCHECK_GT(prev_smallest_seqno, f->largest.seqno);
       }
       prev_smallest_seqno = f->smallest.seqno;
+      prev_largest_seqno = f->largest.seqno;
     }
     level_index = 1U;
   }
@@ -1502,6 +1691,42 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::DoPickCompaction(
   return c;
 }
 
+std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompactionUniversalObsoleteFiles(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, LogBuffer* log_buffer) {
+  // Files could be deleted only when they don't overlap with files of other levels.
+  if (ioptions_.compaction_filter_factory == nullptr || vstorage->num_levels() != 1) {
+    return nullptr;
+  }
+  const auto& level_files = vstorage->LevelFiles(0);
+  auto obsolete_files = ioptions_.compaction_filter_factory->ObsoleteFiles(level_files);
+  if (obsolete_files.empty()) {
+    return nullptr;
+  }
+
+  std::vector<CompactionInputFiles> inputs(1);
+  inputs[0].level = 0;
+  for (auto* f : obsolete_files) {
+    DCHECK(!f->being_compacted);
+    inputs[0].files.push_back(f);
+    char tmp_fsize[16];
+    AppendHumanBytes(f->fd.GetTotalFileSize(), tmp_fsize, sizeof(tmp_fsize));
+    LOG_TO_BUFFER(log_buffer, "[%s] Universal: picking obsolete file %" PRIu64
+                              " with size %s for deletion",
+                  cf_name.c_str(), f->fd.GetNumber(), tmp_fsize);
+  }
+  auto c = Compaction::Create(
+      vstorage, mutable_cf_options, std::move(inputs), 0 /* output_level */,
+      0 /* target_file_size */, 0 /* max_grandparent_overlap_bytes */, 0 /* output_path_id */,
+      kNoCompression, std::vector<FileMetaData*>(), ioptions_.info_log, /* is manual */ false,
+      vstorage->CompactionScore(0),
+      /* is deletion compaction */ true, CompactionReason::kUniversalObsoleteFiles);
+  if (c) {
+    level0_compactions_in_progress_.insert(c.get());
+  }
+  return c;
+}
+
 uint32_t UniversalCompactionPicker::GetPathId(
     const ImmutableCFOptions& ioptions, uint64_t file_size) {
   // Two conditions need to be satisfied:
@@ -1698,8 +1923,8 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompactionUniversalRe
   for (size_t i = start_index; i < first_index_after; i++) {
     auto& picking_sr = sorted_runs[i];
     if (picking_sr.level == 0) {
-      FileMetaData* picking_file = picking_sr.file;
-      inputs[0].files.push_back(picking_file);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -1727,6 +1952,67 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompactionUniversalRe
       /* deletion_compaction = */ false, compaction_reason);
 }
 
+std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompactionUniversalReadTriggered(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, const std::vector<SortedRun>& sorted_runs,
+    LogBuffer* log_buffer) {
+  // Sorted runs are ordered from the most recent one, so the picked runs are the smallest ones,
+  // and merging them reduces the number of files to read for the least I/O.
+  const uint64_t max_bytes = FLAGS_read_triggered_compaction_max_bytes;
+  const size_t max_merge_width = ioptions_.compaction_options_universal.max_merge_width;
+  size_t start_index = 0;
+  while (start_index < sorted_runs.size() && sorted_runs[start_index].being_compacted) {
+    ++start_index;
+  }
+  size_t first_index_after = start_index;
+  uint64_t total_size = 0;
+  while (first_index_after < sorted_runs.size() &&
+         first_index_after - start_index < max_merge_width) {
+    const auto& sr = sorted_runs[first_index_after];
+    if (sr.being_compacted || sr.level != 0 || total_size + sr.size > max_bytes) {
+      break;
+    }
+    total_size += sr.size;
+    ++first_index_after;
+  }
+  if (first_index_after - start_index < 2) {
+    LOG_TO_BUFFER(log_buffer,
+                  "[%s] Universal: no sorted runs to compact for read amp within %" PRIu64
+                  " bytes", cf_name.c_str(), max_bytes);
+    return nullptr;
+  }
+
+  int output_level;
+  if (first_index_after == sorted_runs.size()) {
+    output_level = vstorage->num_levels() - 1;
+  } else if (sorted_runs[first_index_after].level == 0) {
+    output_level = 0;
+  } else {
+    output_level = sorted_runs[first_index_after].level - 1;
+  }
+
+  std::vector<CompactionInputFiles> inputs(vstorage->num_levels());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    inputs[i].level = static_cast<int>(i);
+  }
+  for (size_t i = start_index; i < first_index_after; i++) {
+    auto& picking_sr = sorted_runs[i];
+    inputs[0].files.insert(
+        inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
+    char file_num_buf[256];
+    picking_sr.DumpSizeInfo(file_num_buf, sizeof(file_num_buf), i);
+    LOG_TO_BUFFER(log_buffer, "[%s] Universal: Picking %s", cf_name.c_str(), file_num_buf);
+  }
+
+  return Compaction::Create(
+      vstorage, mutable_cf_options, std::move(inputs), output_level,
+      mutable_cf_options.MaxFileSizeForLevel(output_level), LLONG_MAX,
+      GetPathId(ioptions_, total_size), GetCompressionType(ioptions_, 0, 1),
+      /* grandparents = */ std::vector<FileMetaData*>(), ioptions_.info_log,
+      /* is_manual = */ false, vstorage->CompactionScore(0),
+      /* deletion_compaction = */ false, CompactionReason::kUniversalReadTriggered);
+}
+
 // Look at overall size amplification. If size amplification
 // exceeeds the configured value, then do a compaction
 // of the candidate files all the way upto the earliest
@@ -1825,8 +2111,8 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompactionUniversalSi
   for (size_t loop = start_index; loop < sorted_runs.size(); loop++) {
     auto& picking_sr = sorted_runs[loop];
     if (picking_sr.level == 0) {
-      FileMetaData* f = picking_sr.file;
-      inputs[0].files.push_back(f);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <set>
 #include <string>
@@ -135,6 +136,11 @@ class CompactionPicker {
     return !level0_compactions_in_progress_.empty();
   }
 
+  // Records that a read had to consult num_files SST files. Returns true when the observed read
+  // amplification requires a compaction, so the caller should schedule it.
+  // Could be called concurrently without DB mutex.
+  virtual bool RecordRead(size_t num_files) { return false; }
+
  protected:
   int NumberLevels() const { return ioptions_.num_levels; }
 
@@ -261,6 +267,8 @@ class UniversalCompactionPicker : public CompactionPicker {
   virtual bool NeedsCompaction(const VersionStorageInfo* vstorage) const
       override;
 
+  bool RecordRead(size_t num_files) override;
+
  private:
   struct SortedRun;
 
@@ -271,6 +279,11 @@ class UniversalCompactionPicker : public CompactionPicker {
       LogBuffer* log_buffer,
       const std::vector<SortedRun>& sorted_runs);
 
+  // Pick files, that could be deleted without compaction, because all their records are obsolete.
+  std::unique_ptr<Compaction> PickCompactionUniversalObsoleteFiles(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, LogBuffer* log_buffer);
+
   // Pick Universal compaction to limit read amplification
   std::unique_ptr<Compaction> PickCompactionUniversalReadAmp(
       const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
@@ -278,6 +291,20 @@ class UniversalCompactionPicker : public CompactionPicker {
       unsigned int num_files, size_t always_include_threshold,
       const std::vector<SortedRun>& sorted_runs, LogBuffer* log_buffer);
 
+  // Pick Universal compaction of the most recent sorted runs, that are read by every read, to
+  // reduce observed read amplification. Total size of picked files is limited by
+  // FLAGS_read_triggered_compaction_max_bytes.
+  std::unique_ptr<Compaction> PickCompactionUniversalReadTriggered(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, const std::vector<SortedRun>& sorted_runs,
+      LogBuffer* log_buffer);
+
+  // Pick Universal compaction of all sorted runs of a closed time window into a single sorted run.
+  std::unique_ptr<Compaction> PickCompactionUniversalTimeWindow(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, const std::vector<SortedRun>& sorted_runs,
+      LogBuffer* log_buffer);
+
   // Pick Universal compaction to limit space amplification.
   std::unique_ptr<Compaction> PickCompactionUniversalSizeAmp(
       const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
@@ -295,10 +322,23 @@ class UniversalCompactionPicker : public CompactionPicker {
       const ImmutableCFOptions& ioptions,
       uint64_t max_file_size);
 
+  // Splits sequences of sorted runs at level 0, so all sorted runs of a sequence belong to the
+  // same time window returned by CompactionFilterFactory::FileTimeWindows. Returns time windows of
+  // the resulting sequences, or an empty vector if files are not grouped by time windows.
+  std::vector<uint64_t> SplitSortedRunsByTimeWindow(
+      const VersionStorageInfo& vstorage, std::vector<std::vector<SortedRun>>* sorted_runs);
+
   // Pick a path ID to place a newly generated file, with its estimated file
   // size.
   static uint32_t GetPathId(const ImmutableCFOptions& ioptions,
                             uint64_t file_size);
+
+  // Number of reads and SST files consulted by them since the last read triggered compaction.
+  std::atomic<uint64_t> num_reads_{0};
+  std::atomic<uint64_t> num_files_read_{0};
+
+  // Set when read amplification exceeded the threshold, consumed by PickCompaction.
+  std::atomic<bool> read_triggered_compaction_requested_{false};
 };
 
 class FIFOCompactionPicker : public CompactionPicker {
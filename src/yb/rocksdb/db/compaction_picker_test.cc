@@ -24,11 +24,18 @@
 #include <string>
 #include <utility>
 
+#include <gflags/gflags.h>
+
+#include "yb/rocksdb/compaction_filter.h"
 #include "yb/rocksdb/util/logging.h"
 #include "yb/util/string_util.h"
 #include "yb/rocksdb/util/testharness.h"
 #include "yb/rocksdb/util/testutil.h"
 
+DECLARE_int32(read_triggered_compaction_files_threshold);
+DECLARE_int32(read_triggered_compaction_min_reads);
+DECLARE_int64(read_triggered_compaction_max_bytes);
+
 namespace rocksdb {
 
 class CountingLogger : public Logger {
@@ -475,6 +482,114 @@ TEST_F(CompactionPickerTest, AllowsTrivialMoveUniversal) {
   ASSERT_TRUE(compaction->is_trivial_move());
 }
 
+TEST_F(CompactionPickerTest, ReadTriggeredUniversal) {
+  google::FlagSaver flag_saver;
+  FLAGS_read_triggered_compaction_files_threshold = 2;
+  FLAGS_read_triggered_compaction_min_reads = 10;
+  FLAGS_read_triggered_compaction_max_bytes = 10000;
+
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, icmp_.get());
+  NewVersionStorage(1, kCompactionStyleUniversal);
+
+  // Fewer files than level0_file_num_compaction_trigger, so there is no size based compaction.
+  Add(0, 1U, "150", "300", 1000, 0, 500, 550);
+  Add(0, 2U, "150", "300", 2000, 0, 401, 450);
+  Add(0, 3U, "150", "300", 1000000, 0, 260, 300);
+  UpdateVersionStorageInfo();
+  ASSERT_FALSE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  // Reads that do not exceed the threshold do not trigger compaction.
+  for (int i = 0; i != 20; ++i) {
+    ASSERT_FALSE(universal_compaction_picker.RecordRead(2));
+  }
+  ASSERT_FALSE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  // Compaction is requested once, when the average number of files read exceeds the threshold.
+  int requests = 0;
+  for (int i = 0; i != 40; ++i) {
+    requests += universal_compaction_picker.RecordRead(3);
+  }
+  ASSERT_EQ(requests, 1);
+  ASSERT_TRUE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  // The most recent files are picked within the size limit.
+  std::unique_ptr<Compaction> compaction(
+      universal_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction != nullptr);
+  ASSERT_EQ(compaction->compaction_reason(), CompactionReason::kUniversalReadTriggered);
+  ASSERT_EQ(compaction->num_input_files(0), 2U);
+  ASSERT_EQ(compaction->input(0, 0)->fd.GetNumber(), 1U);
+  ASSERT_EQ(compaction->input(0, 1)->fd.GetNumber(), 2U);
+  ASSERT_FALSE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+}
+
+namespace {
+
+// Assigns time windows to files by file number.
+class TimeWindowCompactionFilterFactory : public CompactionFilterFactory {
+ public:
+  explicit TimeWindowCompactionFilterFactory(std::unordered_map<uint64_t, uint64_t> windows)
+      : windows_(std::move(windows)) {}
+
+  std::unique_ptr<CompactionFilter> CreateCompactionFilter(
+      const CompactionFilter::Context& context) override {
+    return nullptr;
+  }
+
+  std::vector<uint64_t> FileTimeWindows(const std::vector<FileMetaData*>& files) override {
+    std::vector<uint64_t> result;
+    for (auto* f : files) {
+      result.push_back(windows_.at(f->fd.GetNumber()));
+    }
+    return result;
+  }
+
+  const char* Name() const override { return "TimeWindowCompactionFilterFactory"; }
+
+ private:
+  std::unordered_map<uint64_t, uint64_t> windows_;
+};
+
+} // namespace
+
+TEST_F(CompactionPickerTest, TimeWindowUniversal) {
+  TimeWindowCompactionFilterFactory factory({{1, 3}, {2, 3}, {3, 2}, {4, 2}, {5, 2}, {6, 1}});
+  ioptions_.compaction_filter_factory = &factory;
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, icmp_.get());
+  NewVersionStorage(1, kCompactionStyleUniversal);
+
+  Add(0, 1U, "150", "300", 1000, 0, 500, 550);
+  Add(0, 2U, "150", "300", 1000, 0, 401, 450);
+  Add(0, 3U, "150", "300", 1000, 0, 301, 350);
+  Add(0, 4U, "150", "300", 1000, 0, 201, 250);
+  Add(0, 5U, "150", "300", 1000, 0, 101, 150);
+  Add(0, 6U, "150", "300", 1000000, 0, 1, 50);
+  UpdateVersionStorageInfo();
+  ASSERT_TRUE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  // All runs of the closed window are compacted together, without runs of other windows.
+  std::unique_ptr<Compaction> compaction(
+      universal_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction != nullptr);
+  ASSERT_EQ(compaction->compaction_reason(), CompactionReason::kUniversalTimeWindow);
+  ASSERT_EQ(compaction->num_input_files(0), 3U);
+  ASSERT_EQ(compaction->input(0, 0)->fd.GetNumber(), 3U);
+  ASSERT_EQ(compaction->input(0, 2)->fd.GetNumber(), 5U);
+
+  // The newest window has fewer runs than level0_file_num_compaction_trigger, and the single run
+  // of the oldest window is not compacted again.
+  for (size_t i = 0; i != compaction->num_input_files(0); ++i) {
+    compaction->input(0, i)->being_compacted = true;
+  }
+  std::unique_ptr<Compaction> next_compaction(
+      universal_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(next_compaction == nullptr);
+  ioptions_.compaction_filter_factory = nullptr;
+}
+
 TEST_F(CompactionPickerTest, NeedsCompactionFIFO) {
   NewVersionStorage(1, kCompactionStyleFIFO);
   const int kFileCount =
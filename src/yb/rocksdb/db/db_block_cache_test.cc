@@ -179,6 +179,45 @@ TEST_F(DBBlockCacheTest, TestWithoutCompressedBlockCache) {
   FLAGS_cache_overflow_single_touch = true;
 }
 
+TEST_F(DBBlockCacheTest, WarmUpDataBlocks) {
+  constexpr size_t kNumReadBlocks = 5;
+
+  auto table_options = GetTableOptions();
+  table_options.block_cache = NewLRUCache(1 << 20);
+  auto options = GetOptions(table_options);
+  Reopen(options);
+  InitTable(options);
+  ASSERT_OK(Flush());
+
+  for (size_t i = 0; i < kNumReadBlocks; i++) {
+    ASSERT_EQ(std::string(kValueSize, 'a'), Get(ToString(i)));
+  }
+  auto files = ASSERT_RESULT(db_->GetCachedDataBlocks(100));
+  ASSERT_EQ(1, files.size());
+  ASSERT_EQ(kNumReadBlocks, files[0].blocks.size());
+  ASSERT_EQ(3, ASSERT_RESULT(db_->GetCachedDataBlocks(3))[0].blocks.size());
+
+  // Blocks are not cached after reopen with a new cache until loaded by warm up.
+  table_options.block_cache = NewLRUCache(1 << 20);
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+  ASSERT_TRUE(ASSERT_RESULT(db_->GetCachedDataBlocks(100)).empty());
+  ASSERT_OK(db_->WarmUpDataBlocks(files[0]));
+  ASSERT_EQ(kNumReadBlocks, ASSERT_RESULT(db_->GetCachedDataBlocks(100))[0].blocks.size());
+
+  RecordCacheCounters(options);
+  for (size_t i = 0; i < kNumReadBlocks; i++) {
+    ASSERT_EQ(std::string(kValueSize, 'a'), Get(ToString(i)));
+  }
+  CheckCacheCounters(options, 0, kNumReadBlocks, 0, 0);
+
+  // Blocks of files that do not exist anymore are skipped.
+  SstDataBlocks missing_file;
+  missing_file.file_number = files[0].file_number + 100;
+  missing_file.blocks = files[0].blocks;
+  ASSERT_OK(db_->WarmUpDataBlocks(missing_file));
+}
+
 #ifdef SNAPPY
 TEST_F(DBBlockCacheTest, TestWithCompressedBlockCache) {
   ReadOptions read_options;
@@ -102,6 +102,7 @@
 #include "yb/rocksdb/wal_filter.h"
 #include "yb/rocksdb/table/block.h"
 #include "yb/rocksdb/table/block_based_table_factory.h"
+#include "yb/rocksdb/table/iterator_wrapper.h"
 #include "yb/rocksdb/table/merger.h"
 #include "yb/rocksdb/table/table_builder.h"
 #include "yb/rocksdb/table/two_level_iterator.h"
@@ -621,8 +622,12 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname)
   // Give a large number for setting of "infinite" open files.
   const int table_cache_size = (db_options_.max_open_files == -1) ?
         4194304 : db_options_.max_open_files - 10;
-  table_cache_ =
-      NewLRUCache(table_cache_size, db_options_.table_cache_numshardbits);
+  if (db_options_.shared_table_cache) {
+    table_cache_ = NewSharedTableCacheView(db_options_.shared_table_cache);
+  } else {
+    table_cache_ =
+        NewLRUCache(table_cache_size, db_options_.table_cache_numshardbits);
+  }
 
   versions_.reset(new VersionSet(dbname_, &db_options_, env_options_,
                                  table_cache_.get(), &write_buffer_,
@@ -783,6 +788,15 @@ DBImpl::~DBImpl() {
   }
   logs_.clear();
 
+  if (db_options_.shared_table_cache) {
+    // Table readers of this DB would otherwise stay in the shared cache after it is closed.
+    std::vector<FileDescriptor> live_files;
+    versions_->AddLiveFiles(&live_files);
+    for (const auto& fd : live_files) {
+      TableCache::Evict(table_cache_.get(), fd.GetNumber());
+    }
+  }
+
   // versions need to be destroyed before table_cache since it can hold
   // references to table_cache.
   versions_.reset();
@@ -1887,12 +1901,14 @@ Result<FileNumbersHolder> DBImpl::FlushMemTableToOutputFile(
   auto sfm =
       static_cast<SstFileManagerImpl*>(db_options_.sst_file_manager.get());
   if (sfm) {
-    // Notify sst_file_manager that a new file was added
-    std::string file_path = MakeTableFileName(db_options_.db_paths[0].path,
-                                              file_meta.fd.GetNumber());
-    RETURN_NOT_OK(sfm->OnAddFile(file_path));
-    if (cfd->ioptions()->table_factory->IsSplitSstForWriteSupported()) {
-      RETURN_NOT_OK(sfm->OnAddFile(TableBaseToDataFileName(file_path)));
+    // Notify sst_file_manager that new files were added
+    for (const auto& output_file : flush_job.output_files()) {
+      std::string file_path = MakeTableFileName(db_options_.db_paths[0].path,
+                                                output_file.fd.GetNumber());
+      RETURN_NOT_OK(sfm->OnAddFile(file_path));
+      if (cfd->ioptions()->table_factory->IsSplitSstForWriteSupported()) {
+        RETURN_NOT_OK(sfm->OnAddFile(TableBaseToDataFileName(file_path)));
+      }
     }
     if (sfm->IsMaxAllowedSpaceReached() && bg_error_.ok()) {
       bg_error_ = STATUS(IOError, "Max allowed space was reached");
@@ -3535,7 +3551,9 @@ Result<FileNumbersHolder> DBImpl::BackgroundCompaction(
     assert(c->num_input_files(1) == 0);
     assert(c->level() == 0);
     assert(c->column_family_data()->ioptions()->compaction_style ==
-           kCompactionStyleFIFO);
+               kCompactionStyleFIFO ||
+           c->column_family_data()->ioptions()->compaction_style ==
+               kCompactionStyleUniversal);
 
     compaction_job_stats.num_input_files = c->num_input_files(0);
 
@@ -3832,26 +3850,45 @@ static void CleanupIteratorState(void* arg1, void* arg2) {
 InternalIterator* DBImpl::NewInternalIterator(const ReadOptions& read_options,
                                               ColumnFamilyData* cfd,
                                               SuperVersion* super_version,
-                                              Arena* arena) {
+                                              Arena* arena,
+                                              size_t* num_sst_files) {
   InternalIterator* internal_iter;
   assert(arena != nullptr);
   // Need to create internal iterator from the arena.
   MergeIteratorBuilder merge_iter_builder(cfd->internal_comparator().get(), arena);
   // Collect iterator for mutable mem
-  merge_iter_builder.AddIterator(
-      super_version->mem->NewIterator(read_options, arena));
+  if (super_version->mem->FilterKeyMayMatch(read_options)) {
+    merge_iter_builder.AddIterator(
+        super_version->mem->NewIterator(read_options, arena));
+  }
   // Collect all needed child iterators for immutable memtables
   super_version->imm->AddIterators(read_options, &merge_iter_builder);
   // Collect iterators for files in L0 - Ln
-  super_version->current->AddIterators(read_options, env_options_,
-                                       &merge_iter_builder);
+  auto num_files = super_version->current->AddIterators(read_options, env_options_,
+                                                        &merge_iter_builder);
+  if (num_sst_files) {
+    *num_sst_files = num_files;
+  }
   internal_iter = merge_iter_builder.Finish();
+  if (internal_iter == nullptr) {
+    // All memtables and files were filtered out.
+    internal_iter = NewEmptyInternalIterator(arena);
+  }
   IterState* cleanup = new IterState(this, &mutex_, super_version);
   internal_iter->RegisterCleanup(CleanupIteratorState, cleanup, nullptr);
 
   return internal_iter;
 }
 
+void DBImpl::RecordReadAmplification(ColumnFamilyData* cfd, size_t num_sst_files) {
+  if (!cfd->compaction_picker()->RecordRead(num_sst_files)) {
+    return;
+  }
+  InstrumentedMutexLock lock(&mutex_);
+  SchedulePendingCompaction(cfd);
+  MaybeScheduleFlushOrCompaction();
+}
+
 ColumnFamilyHandle* DBImpl::DefaultColumnFamily() const {
   return default_cf_handle_;
 }
@@ -4391,7 +4428,8 @@ Status DBImpl::CreateColumnFamily(const ColumnFamilyOptions& cf_options,
   *handle = nullptr;
 
   s = CheckCompressionSupported(cf_options);
-  if (s.ok() && db_options_.allow_concurrent_memtable_write) {
+  if (s.ok() && (db_options_.allow_concurrent_memtable_write ||
+                 db_options_.memtable_insert_thread_pool)) {
     s = CheckConcurrentWritesSupported(cf_options);
   }
   if (!s.ok()) {
@@ -4664,9 +4702,11 @@ Iterator* DBImpl::NewIterator(const ReadOptions& read_options,
         sv->version_number, read_options.iterate_upper_bound,
         read_options.prefix_same_as_start, read_options.pin_data);
 
+    size_t num_sst_files = 0;
     InternalIterator* internal_iter =
-        NewInternalIterator(read_options, cfd, sv, db_iter->GetArena());
+        NewInternalIterator(read_options, cfd, sv, db_iter->GetArena(), &num_sst_files);
     db_iter->SetIterUnderDBIter(internal_iter);
+    RecordReadAmplification(cfd, num_sst_files);
 
     if (yb::GetAtomicFlag(&FLAGS_rocksdb_use_logging_iterator)) {
       return new TransitionLoggingIteratorWrapper(db_iter, LogPrefix());
@@ -4739,10 +4779,12 @@ Status DBImpl::NewIterators(
           env_, *cfd->ioptions(), cfd->user_comparator(), snapshot,
           sv->mutable_cf_options.max_sequential_skip_in_iterations,
           sv->version_number, nullptr, false, read_options.pin_data);
+      size_t num_sst_files = 0;
       InternalIterator* internal_iter =
-          NewInternalIterator(read_options, cfd, sv, db_iter->GetArena());
+          NewInternalIterator(read_options, cfd, sv, db_iter->GetArena(), &num_sst_files);
       db_iter->SetIterUnderDBIter(internal_iter);
       iterators->push_back(db_iter);
+      RecordReadAmplification(cfd, num_sst_files);
     }
   }
 
@@ -4820,6 +4862,23 @@ Status DBImpl::WriteWithCallback(const WriteOptions& write_options,
 }
 #endif  // ROCKSDB_LITE
 
+bool DBImpl::ShouldInsertInParallel(
+    const autovector<WriteThread::Writer*>& write_group) const {
+  if (db_options_.memtable_insert_thread_pool == nullptr ||
+      db_options_.max_parallel_memtable_inserts < 2 || write_group.size() != 1) {
+    return false;
+  }
+  auto* writer = write_group[0];
+  if (writer->CallbackFailed()) {
+    return false;
+  }
+  const auto* batch = writer->batch;
+  // Single deletes erase entries from the memtable, so their order relative to puts matters.
+  return WriteBatchInternal::Count(batch) >=
+             2 * db_options_.min_entries_per_parallel_memtable_insert &&
+         !batch->HasMerge() && !batch->HasSingleDelete();
+}
+
 Status DBImpl::WriteImpl(const WriteOptions& write_options,
                          WriteBatch* my_batch, WriteCallback* callback) {
 
@@ -5175,11 +5234,21 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
       }
 
       if (!parallel) {
-        InsertFlags insert_flags{InsertFlag::kFilterDeletes};
-        status = WriteBatchInternal::InsertInto(
-            write_group, current_sequence, column_family_memtables_.get(),
-            &flush_scheduler_, write_options.ignore_missing_column_families,
-            0 /*log_number*/, this, insert_flags);
+        if (ShouldInsertInParallel(write_group)) {
+          WriteBatchInternal::SetSequence(w.batch, current_sequence);
+          w.status = WriteBatchInternal::InsertIntoParallel(
+              w.batch, versions_->GetColumnFamilySet(), &flush_scheduler_,
+              write_options.ignore_missing_column_families, this,
+              db_options_.memtable_insert_thread_pool, db_options_.max_parallel_memtable_inserts,
+              db_options_.min_entries_per_parallel_memtable_insert);
+          status = w.status;
+        } else {
+          InsertFlags insert_flags{InsertFlag::kFilterDeletes};
+          status = WriteBatchInternal::InsertInto(
+              write_group, current_sequence, column_family_memtables_.get(),
+              &flush_scheduler_, write_options.ignore_missing_column_families,
+              0 /*log_number*/, this, insert_flags);
+        }
 
         if (status.ok()) {
           // There were no write failures. Set leader's status
@@ -5667,7 +5736,7 @@ ColumnFamilyHandle* DBImpl::GetColumnFamilyHandleUnlocked(
   return cf_memtables->GetColumnFamilyHandle();
 }
 
-Status DBImpl::Import(const std::string& source_dir) {
+Status DBImpl::Import(const std::string& source_dir, const UserFrontierPtr& flushed_frontier) {
   const auto seqno = versions_->LastSequence();
   FlushOptions options;
   RETURN_NOT_OK(Flush(options));
@@ -5676,6 +5745,9 @@ Status DBImpl::Import(const std::string& source_dir) {
   if (!status.ok()) {
     return status;
   }
+  if (flushed_frontier) {
+    edit.UpdateFlushedFrontier(flushed_frontier);
+  }
   return ApplyVersionEdit(&edit);
 }
 
@@ -5692,6 +5764,27 @@ Result<std::string> DBImpl::GetMiddleKey() {
   return default_cf_handle_->cfd()->current()->GetMiddleKey();
 }
 
+Result<std::vector<SstDataBlocks>> DBImpl::GetCachedDataBlocks(size_t max_blocks) {
+  // Reads index blocks, so the DB mutex is not held, the super version keeps the files alive.
+  auto* cfd = default_cf_handle_->cfd();
+  SuperVersion* sv = GetAndRefSuperVersion(cfd);
+  auto se = yb::ScopeExit([this, cfd, sv] {
+    ReturnAndCleanupSuperVersion(cfd, sv);
+  });
+  std::vector<SstDataBlocks> result;
+  RETURN_NOT_OK(sv->current->GetCachedDataBlocks(max_blocks, &result));
+  return result;
+}
+
+Status DBImpl::WarmUpDataBlocks(const SstDataBlocks& file) {
+  auto* cfd = default_cf_handle_->cfd();
+  SuperVersion* sv = GetAndRefSuperVersion(cfd);
+  auto se = yb::ScopeExit([this, cfd, sv] {
+    ReturnAndCleanupSuperVersion(cfd, sv);
+  });
+  return sv->current->WarmUpDataBlocks(file);
+}
+
 void DBImpl::TEST_SwitchMemtable() {
   std::lock_guard<InstrumentedMutex> lock(mutex_);
   WriteContext context;
@@ -6160,7 +6253,8 @@ Status DB::Open(const DBOptions& db_options, const std::string& dbname,
 
   for (auto& cfd : column_families) {
     s = CheckCompressionSupported(cfd.options);
-    if (s.ok() && db_options.allow_concurrent_memtable_write) {
+    if (s.ok() && (db_options.allow_concurrent_memtable_write ||
+                   db_options.memtable_insert_thread_pool)) {
       s = CheckConcurrentWritesSupported(cfd.options);
     }
     if (!s.ok()) {
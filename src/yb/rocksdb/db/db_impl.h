@@ -471,13 +471,18 @@ class DBImpl : public DB {
   // Checks that source database has appropriate seqno.
   // I.e. seqno ranges of imported database does not overlap with seqno ranges of destination db.
   // And max seqno of imported database is less that active seqno of destination db.
-  CHECKED_STATUS Import(const std::string& source_dir) override;
+  CHECKED_STATUS Import(
+      const std::string& source_dir, const UserFrontierPtr& flushed_frontier) override;
 
   bool AreWritesStopped();
   bool NeedsDelay() override;
 
   Result<std::string> GetMiddleKey() override;
 
+  Result<std::vector<SstDataBlocks>> GetCachedDataBlocks(size_t max_blocks) override;
+
+  CHECKED_STATUS WarmUpDataBlocks(const SstDataBlocks& file) override;
+
   // Used in testing to make the old memtable immutable and start writing to a new one.
   void TEST_SwitchMemtable() override;
 
@@ -489,10 +494,17 @@ class DBImpl : public DB {
   const DBOptions db_options_;
   Statistics* stats_;
 
+  // num_sst_files, when specified, is set to the number of SST files the returned iterator has to
+  // read on seek.
   InternalIterator* NewInternalIterator(const ReadOptions&,
                                         ColumnFamilyData* cfd,
                                         SuperVersion* super_version,
-                                        Arena* arena);
+                                        Arena* arena,
+                                        size_t* num_sst_files = nullptr);
+
+  // Records that a user iterator has to read num_sst_files SST files and schedules a compaction
+  // when the read amplification of the column family requires it.
+  void RecordReadAmplification(ColumnFamilyData* cfd, size_t num_sst_files);
 
   // Except in DB::Open(), WriteOptionsFile can only be called when:
   // 1. WriteThread::Writer::EnterUnbatched() is used.
@@ -518,6 +530,10 @@ class DBImpl : public DB {
                    WriteCallback* callback);
 
  private:
+  // Whether the write group consists of a single batch, that is large enough to be inserted into
+  // memtables by several threads (see DBOptions::memtable_insert_thread_pool).
+  bool ShouldInsertInParallel(const autovector<WriteThread::Writer*>& write_group) const;
+
   friend class DB;
   friend class InternalStats;
 #ifndef ROCKSDB_LITE
@@ -254,6 +254,7 @@ inline bool DBIter::ParseKey(ParsedInternalKey* ikey) {
 
 void DBIter::Next() {
   assert(valid_);
+  PERF_COUNTER_ADD(iter_next_count, 1);
 
   if (direction_ == kReverse) {
     FindNextUserKey();
@@ -452,6 +453,7 @@ void DBIter::MergeValuesNewToOld() {
 
 void DBIter::Prev() {
   assert(valid_);
+  PERF_COUNTER_ADD(iter_prev_count, 1);
   if (direction_ == kForward) {
     ReverseToBackward();
   }
@@ -752,6 +754,7 @@ void DBIter::Seek(const Slice& target) {
   saved_key_.Clear();
   // now savved_key is used to store internal key.
   saved_key_.SetInternalKey(target, sequence_);
+  PERF_COUNTER_ADD(iter_seek_count, 1);
 
   {
     PERF_TIMER_GUARD(seek_internal_seek_time);
@@ -785,6 +788,7 @@ void DBIter::SeekToFirst() {
   }
   direction_ = kForward;
   ClearSavedValue();
+  PERF_COUNTER_ADD(iter_seek_count, 1);
 
   {
     PERF_TIMER_GUARD(seek_internal_seek_time);
@@ -816,6 +820,7 @@ void DBIter::SeekToLast() {
   }
   direction_ = kReverse;
   ClearSavedValue();
+  PERF_COUNTER_ADD(iter_seek_count, 1);
 
   {
     PERF_TIMER_GUARD(seek_internal_seek_time);
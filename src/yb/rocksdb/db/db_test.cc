@@ -90,6 +90,7 @@
 #include "yb/util/priority_thread_pool.h"
 #include "yb/util/slice.h"
 #include "yb/util/string_util.h"
+#include "yb/util/threadpool.h"
 #include "yb/util/tsan_util.h"
 
 DECLARE_bool(use_priority_thread_pool_for_compactions);
@@ -5306,6 +5307,50 @@ TEST_F(DBTest, ConcurrentMemtableNotSupported) {
   ASSERT_NOK(db_->CreateColumnFamily(cf_options, "name", &handle));
 }
 
+TEST_F(DBTest, ParallelMemtableInsert) {
+  std::unique_ptr<yb::ThreadPool> pool;
+  ASSERT_OK(yb::ThreadPoolBuilder("memtable-insert").set_max_threads(3).Build(&pool));
+
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.memtable_insert_thread_pool = pool.get();
+  options.min_entries_per_parallel_memtable_insert = 16;
+  options.max_parallel_memtable_inserts = 4;
+  options.memtable_filter_bloom_bits = 10;
+  DestroyAndReopen(options);
+
+  constexpr int kNumKeys = 1000;
+  WriteBatch batch;
+  for (int i = 0; i != kNumKeys; ++i) {
+    batch.Put(Key(i), "v" + ToString(i));
+  }
+  // Keys that are overwritten in the same batch should keep the last value.
+  batch.Put(Key(0), "last");
+  batch.Delete(Key(1));
+  ASSERT_OK(db_->Write(WriteOptions(), &batch));
+
+  ASSERT_EQ("last", Get(Key(0)));
+  ASSERT_EQ("NOT_FOUND", Get(Key(1)));
+  for (int i = 2; i != kNumKeys; ++i) {
+    ASSERT_EQ("v" + ToString(i), Get(Key(i)));
+  }
+
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  int count = 0;
+  std::string prev;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ASSERT_LT(prev, iter->key().ToString());
+    prev = iter->key().ToString();
+    ++count;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(kNumKeys - 1, count);
+
+  ASSERT_OK(Flush());
+  ASSERT_EQ("last", Get(Key(0)));
+  ASSERT_EQ("v" + ToString(kNumKeys - 1), Get(Key(kNumKeys - 1)));
+}
+
 #endif  // ROCKSDB_LITE
 
 TEST_F(DBTest, SanitizeNumThreads) {
@@ -72,6 +72,25 @@ TEST_F(DBTest2, IteratorPropertyVersionNumber) {
   delete iter2;
   delete iter3;
 }
+
+TEST_F(DBTest2, SharedTableCache) {
+  auto shared_cache = NewLRUCache(1024 * 1024);
+  Options options = CurrentOptions();
+  options.shared_table_cache = shared_cache;
+  Reopen(options);
+  ASSERT_OK(Put("a", "1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("b", "2"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("1", Get("a"));
+  ASSERT_EQ("2", Get("b"));
+  ASSERT_GT(shared_cache->GetUsage(), 0);
+
+  // Table readers of a closed DB are removed from the shared cache.
+  Close();
+  ASSERT_EQ(shared_cache->GetUsage(), 0);
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
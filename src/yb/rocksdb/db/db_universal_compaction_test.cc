@@ -21,6 +21,10 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <deque>
+#include <mutex>
+#include <set>
+
 #include "yb/rocksdb/db/db_test_util.h"
 #include "yb/rocksdb/port/stack_trace.h"
 #if !defined(ROCKSDB_LITE)
@@ -127,6 +131,57 @@ class DelayFilterFactory : public CompactionFilterFactory {
  private:
   DBTestBase* db_test;
 };
+
+std::string DocumentKey(int doc, int subkey) {
+  char buf[100];
+  snprintf(buf, sizeof(buf), "doc%04d/%d", doc, subkey);
+  return std::string(buf);
+}
+
+// Records documents, i.e. key prefixes before '/', seen by the compaction filter.
+class DocumentsFilter : public CompactionFilter {
+ public:
+  explicit DocumentsFilter(std::set<std::string>* documents) : documents_(documents) {}
+
+  FilterDecision Filter(int level, const Slice& key, const Slice& value,
+                        std::string* new_value, bool* value_changed) override {
+    auto str = key.ToBuffer();
+    documents_->insert(str.substr(0, str.find('/')));
+    return FilterDecision::kKeep;
+  }
+
+  const char* Name() const override { return "DocumentsFilter"; }
+
+ private:
+  std::set<std::string>* documents_;
+};
+
+class DocumentsFilterFactory : public CompactionFilterFactory {
+ public:
+  std::unique_ptr<CompactionFilter> CreateCompactionFilter(
+      const CompactionFilter::Context& context) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    documents_.emplace_back();
+    return std::make_unique<DocumentsFilter>(&documents_.back());
+  }
+
+  Slice SubcompactionBoundary(const Slice& user_key) override {
+    auto pos = user_key.ToBuffer().find('/');
+    return pos == std::string::npos ? user_key : user_key.Prefix(pos + 1);
+  }
+
+  const char* Name() const override { return "DocumentsFilterFactory"; }
+
+  // Documents seen by each of the created filters.
+  std::deque<std::set<std::string>> documents() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return documents_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::deque<std::set<std::string>> documents_;
+};
 }  // namespace
 
 // Make sure we don't trigger a problem if the trigger conditon is given
@@ -1474,6 +1529,70 @@ TEST_F(DBTestUniversalCompaction, IncludeFilesSmallerThanThreshold) {
   GenerateFilesAndCheckCompactionResult(options, file_sizes, value_size, 1);
 }
 
+TEST_F(DBTestUniversalCompaction, SubcompactionsDoNotSplitDocuments) {
+  constexpr int kNumFiles = 4;
+  constexpr int kDocsPerFile = 50;
+  constexpr int kKeysPerDoc = 5;
+
+  Options options;
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  options.write_buffer_size = 10_MB;
+  options.target_file_size_base = 32_KB;
+  options.max_subcompactions = 4;
+  options.disable_auto_compactions = true;
+  auto filter_factory = std::make_shared<DocumentsFilterFactory>();
+  options.compaction_filter_factory = filter_factory;
+  options = CurrentOptions(options);
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  // Documents of each file are interleaved with documents of other files, so each file covers
+  // almost the whole key range.
+  for (int file = 0; file != kNumFiles; ++file) {
+    for (int doc = file; doc < kNumFiles * kDocsPerFile; doc += kNumFiles) {
+      for (int subkey = 0; subkey != kKeysPerDoc; ++subkey) {
+        ASSERT_OK(Put(DocumentKey(doc, subkey), RandomString(&rnd, 1_KB)));
+      }
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ(kNumFiles, NumTableFilesAtLevel(0));
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+
+  // Compaction was split by keys from SST indexes, and each document was processed by a single
+  // subcompaction.
+  const auto documents = filter_factory->documents();
+  ASSERT_GT(documents.size(), 1U);
+  std::set<std::string> all_documents;
+  for (const auto& subcompaction_documents : documents) {
+    for (const auto& doc : subcompaction_documents) {
+      ASSERT_TRUE(all_documents.insert(doc).second) << "Document split: " << doc;
+    }
+  }
+  ASSERT_EQ(static_cast<size_t>(kNumFiles * kDocsPerFile), all_documents.size());
+
+  // Output files of subcompactions have the same sequence numbers range and form a single sorted
+  // run.
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_GT(files.size(), 1U);
+  for (const auto& file : files) {
+    ASSERT_EQ(files[0].smallest.seqno, file.smallest.seqno);
+    ASSERT_EQ(files[0].largest.seqno, file.largest.seqno);
+  }
+  ASSERT_OK(dbfull()->EnableAutoCompaction({dbfull()->DefaultColumnFamily()}));
+  dbfull()->TEST_WaitForCompact();
+  ASSERT_EQ(files.size(), static_cast<size_t>(NumTableFilesAtLevel(0)));
+
+  for (int doc = 0; doc != kNumFiles * kDocsPerFile; ++doc) {
+    for (int subkey = 0; subkey != kKeysPerDoc; ++subkey) {
+      ASSERT_NE("NOT_FOUND", Get(DocumentKey(doc, subkey)));
+    }
+  }
+}
+
 }  // namespace rocksdb
 
 #endif  // !defined(ROCKSDB_LITE)
@@ -32,6 +32,7 @@
 #include <algorithm>
 #include <vector>
 #include <chrono>
+#include <thread>
 
 #include "yb/rocksdb/db/builder.h"
 #include "yb/rocksdb/db/db_iter.h"
@@ -79,8 +80,124 @@ DEFINE_int32(rocksdb_nothing_in_memtable_to_flush_sleep_ms, 10,
 DEFINE_test_flag(bool, rocksdb_crash_on_flush, false,
                  "When set, memtable flush in rocksdb crashes.");
 
+DEFINE_int32(rocksdb_max_flush_parallelism, 1,
+    "Maximum number of SST files a memtable flush is split into by user key ranges, each of them "
+    "is written by a separate thread. 1 means that a flush writes a single SST file.");
+TAG_FLAG(rocksdb_max_flush_parallelism, advanced);
+TAG_FLAG(rocksdb_max_flush_parallelism, runtime);
+
+DEFINE_uint64(rocksdb_min_flush_partition_size_bytes, 64 * 1024 * 1024,
+    "Minimum memory usage of flushed memtables per SST file written by a parallel flush.");
+TAG_FLAG(rocksdb_min_flush_partition_size_bytes, advanced);
+TAG_FLAG(rocksdb_min_flush_partition_size_bytes, runtime);
+
 namespace rocksdb {
 
+namespace {
+
+// Number of memtable samples per flush partition, used to pick partition boundaries.
+constexpr size_t kFlushSamplesPerPartition = 16;
+
+// Iterates entries of the wrapped iterator with user keys in [lower, upper). Null bound means
+// that the range is not bounded from that side.
+class UserKeyRangeIterator : public InternalIterator {
+ public:
+  UserKeyRangeIterator(InternalIterator* iter, const Comparator* user_comparator,
+                       const std::string* lower, const std::string* upper)
+      : iter_(iter), user_comparator_(user_comparator), lower_(lower), upper_(upper) {
+    if (lower_) {
+      lower_ikey_ = InternalKey::MaxPossibleForUserKey(*lower_);
+    }
+    if (upper_) {
+      upper_ikey_ = InternalKey::MaxPossibleForUserKey(*upper_);
+    }
+  }
+
+  bool Valid() const override {
+    return valid_;
+  }
+
+  void SeekToFirst() override {
+    if (lower_) {
+      iter_->Seek(lower_ikey_.Encode());
+    } else {
+      iter_->SeekToFirst();
+    }
+    UpdateValid();
+  }
+
+  void SeekToLast() override {
+    if (upper_) {
+      iter_->Seek(upper_ikey_.Encode());
+      if (iter_->Valid()) {
+        iter_->Prev();
+      } else {
+        iter_->SeekToLast();
+      }
+    } else {
+      iter_->SeekToLast();
+    }
+    UpdateValid();
+  }
+
+  void Seek(const Slice& target) override {
+    if (lower_ && user_comparator_->Compare(ExtractUserKey(target), *lower_) < 0) {
+      iter_->Seek(lower_ikey_.Encode());
+    } else {
+      iter_->Seek(target);
+    }
+    UpdateValid();
+  }
+
+  void Next() override {
+    iter_->Next();
+    UpdateValid();
+  }
+
+  void Prev() override {
+    iter_->Prev();
+    UpdateValid();
+  }
+
+  Slice key() const override {
+    return iter_->key();
+  }
+
+  Slice value() const override {
+    return iter_->value();
+  }
+
+  Status status() const override {
+    return iter_->status();
+  }
+
+ private:
+  void UpdateValid() {
+    valid_ = false;
+    if (!iter_->Valid()) {
+      return;
+    }
+    const auto user_key = ExtractUserKey(iter_->key());
+    if (lower_ && user_comparator_->Compare(user_key, *lower_) < 0) {
+      return;
+    }
+    if (upper_ && user_comparator_->Compare(user_key, *upper_) >= 0) {
+      return;
+    }
+    valid_ = true;
+  }
+
+  InternalIterator* const iter_;
+  const Comparator* const user_comparator_;
+  const std::string* const lower_;
+  const std::string* const upper_;
+  InternalKey lower_ikey_;
+  InternalKey upper_ikey_;
+  bool valid_ = false;
+};
+
+} // namespace
+
 FlushJob::FlushJob(const std::string& dbname, ColumnFamilyData* cfd,
                    const DBOptions& db_options,
                    const MutableCFOptions& mutable_cf_options,
@@ -144,7 +261,6 @@ Result<FileNumbersHolder> FlushJob::Run(FileMetaData* file_meta) {
   }
 
   // Save the contents of the earliest memtable as a new Table
-  FileMetaData meta;
   autovector<MemTable*> mems;
   cfd_->imm()->PickMemtablesToFlush(&mems, mem_table_flush_filter_);
   if (mems.empty()) {
@@ -175,7 +291,10 @@ Result<FileNumbersHolder> FlushJob::Run(FileMetaData* file_meta) {
   edit->SetColumnFamily(cfd_->GetID());
 
   // This will release and re-acquire the mutex.
-  auto fnum = WriteLevel0Table(mems, edit, &meta);
+  auto fnum = WriteLevel0Table(mems, edit);
+  // All files written by this flush are committed together, as a batch identified by the number
+  // of the first file.
+  const auto& meta = output_files_.front();
 
   if (fnum.ok() && ((shutting_down_->load(std::memory_order_acquire) &&
                      disable_flush_on_shutdown_->load(std::memory_order_acquire)) ||
@@ -216,41 +335,164 @@ Result<FileNumbersHolder> FlushJob::Run(FileMetaData* file_meta) {
   return fnum;
 }
 
+std::vector<std::string> FlushJob::PickSplitUserKeys(const autovector<MemTable*>& mems) {
+  const auto max_parallelism = FLAGS_rocksdb_max_flush_parallelism;
+  if (max_parallelism <= 1) {
+    return {};
+  }
+  size_t total_memory_usage = 0;
+  for (auto* mem : mems) {
+    total_memory_usage += mem->ApproximateMemoryUsage();
+  }
+  const auto num_partitions = std::min<size_t>(
+      max_parallelism,
+      total_memory_usage / std::max<uint64_t>(FLAGS_rocksdb_min_flush_partition_size_bytes, 1));
+  if (num_partitions <= 1) {
+    return {};
+  }
+
+  // Memtables being flushed are immutable, so they are sampled and samples are sorted without
+  // blocking writers and other background jobs on the DB mutex.
+  std::vector<std::string> samples;
+  db_mutex_->Unlock();
+  for (auto* mem : mems) {
+    mem->SampleUserKeys(num_partitions * kFlushSamplesPerPartition, &samples);
+  }
+  const auto* user_comparator = cfd_->user_comparator();
+  std::sort(samples.begin(), samples.end(), [user_comparator](const auto& lhs, const auto& rhs) {
+    return user_comparator->Compare(lhs, rhs) < 0;
+  });
+  samples.erase(
+      std::unique(samples.begin(), samples.end(), [user_comparator](const auto& lhs,
+                                                                    const auto& rhs) {
+        return user_comparator->Compare(lhs, rhs) == 0;
+      }),
+      samples.end());
+  db_mutex_->Lock();
+
+  // Split keys are picked after the first sample, so every partition contains at least the
+  // entries of its lower bound.
+  std::vector<std::string> result;
+  size_t last_index = 0;
+  for (size_t i = 1; i < num_partitions; ++i) {
+    const size_t index = i * samples.size() / num_partitions;
+    if (index == last_index) {
+      continue;
+    }
+    result.push_back(std::move(samples[index]));
+    last_index = index;
+  }
+  return result;
+}
+
+Status FlushJob::WriteOutputFile(
+    const autovector<MemTable*>& mems, const std::string* lower, const std::string* upper,
+    FileMetaData* meta, TableProperties* table_properties) {
+  std::vector<InternalIterator*> memtables;
+  ReadOptions ro;
+  ro.total_order_seek = true;
+  Arena arena;
+  for (MemTable* m : mems) {
+    memtables.push_back(m->NewIterator(ro, &arena));
+  }
+
+  TableFileCreationInfo info;
+  Status s;
+  {
+    ScopedArenaIterator merging_iter(
+        NewMergingIterator(cfd_->internal_comparator().get(), &memtables[0],
+                           static_cast<int>(memtables.size()), &arena));
+    UserKeyRangeIterator iter(merging_iter.get(), cfd_->user_comparator(), lower, upper);
+    RLOG(InfoLogLevel::INFO_LEVEL, db_options_.info_log,
+        "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": started",
+        cfd_->GetName().c_str(), job_context_->job_id, meta->fd.GetNumber());
+
+    s = BuildTable(dbname_,
+                   db_options_.env,
+                   *cfd_->ioptions(),
+                   env_options_,
+                   cfd_->table_cache(),
+                   &iter,
+                   meta,
+                   cfd_->internal_comparator(),
+                   cfd_->int_tbl_prop_collector_factories(),
+                   cfd_->GetID(),
+                   existing_snapshots_,
+                   earliest_write_conflict_snapshot_,
+                   output_compression_,
+                   cfd_->ioptions()->compression_opts,
+                   mutable_cf_options_.paranoid_file_checks,
+                   cfd_->internal_stats(),
+                   db_options_.boundary_extractor.get(),
+                   Env::IO_HIGH,
+                   table_properties);
+    info.table_properties = *table_properties;
+    LogFlush(db_options_.info_log);
+  }
+  RLOG(InfoLogLevel::INFO_LEVEL, db_options_.info_log,
+      "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": %" PRIu64
+      " bytes %s"
+      "%s",
+      cfd_->GetName().c_str(), job_context_->job_id, meta->fd.GetNumber(),
+      meta->fd.GetTotalFileSize(), s.ToString().c_str(),
+      meta->marked_for_compaction ? " (needs compaction)" : "");
+
+  // output to event logger
+  if (s.ok()) {
+    info.db_name = dbname_;
+    info.cf_name = cfd_->GetName();
+    info.file_path = TableFileName(db_options_.db_paths,
+                                   meta->fd.GetNumber(),
+                                   meta->fd.GetPathId());
+    info.file_size = meta->fd.GetTotalFileSize();
+    info.job_id = job_context_->job_id;
+    EventHelpers::LogAndNotifyTableFileCreation(
+        event_logger_, db_options_.listeners,
+        meta->fd, info);
+    TEST_SYNC_POINT("FlushJob::LogAndNotifyTableFileCreation()");
+  }
+  return s;
+}
+
 Result<FileNumbersHolder> FlushJob::WriteLevel0Table(
-    const autovector<MemTable*>& mems, VersionEdit* edit, FileMetaData* meta) {
+    const autovector<MemTable*>& mems, VersionEdit* edit) {
   db_mutex_->AssertHeld();
   const uint64_t start_micros = db_options_.env->NowMicros();
-  auto file_number_holder = file_numbers_provider_->NewFileNumber();
-  auto file_number = file_number_holder.Last();
-  // path 0 for level 0 file.
-  meta->fd = FileDescriptor(file_number, 0, 0, 0);
+  const auto split_user_keys = PickSplitUserKeys(mems);
+  auto file_number_holder = file_numbers_provider_->CreateHolder();
+  file_number_holder.Reserve(split_user_keys.size() + 1);
+  output_files_.clear();
+  output_files_.resize(split_user_keys.size() + 1);
+  for (auto& meta : output_files_) {
+    // path 0 for level 0 file.
+    meta.fd = FileDescriptor(
+        file_numbers_provider_->NewFileNumber(&file_number_holder), 0, 0, 0);
+  }
 
-  Status s;
+  std::vector<Status> statuses(output_files_.size());
+  std::vector<TableProperties> table_properties(output_files_.size());
   {
     db_mutex_->Unlock();
     if (log_buffer_) {
       log_buffer_->FlushBufferToLog();
     }
-    std::vector<InternalIterator*> memtables;
-    ReadOptions ro;
-    ro.total_order_seek = true;
-    Arena arena;
     uint64_t total_num_entries = 0, total_num_deletes = 0;
     size_t total_memory_usage = 0;
     for (MemTable* m : mems) {
       RLOG(InfoLogLevel::INFO_LEVEL, db_options_.info_log,
           "[%s] [JOB %d] Flushing memtable with next log file: %" PRIu64 "\n",
           cfd_->GetName().c_str(), job_context_->job_id, m->GetNextLogNumber());
-      memtables.push_back(m->NewIterator(ro, &arena));
       total_num_entries += m->num_entries();
       total_num_deletes += m->num_deletes();
       total_memory_usage += m->ApproximateMemoryUsage();
       const auto* range = m->Frontiers();
       if (range) {
-        UserFrontier::Update(
-            &range->Smallest(), UpdateUserValueType::kSmallest, &meta->smallest.user_frontier);
-        UserFrontier::Update(
-            &range->Largest(), UpdateUserValueType::kLargest, &meta->largest.user_frontier);
+        for (auto& meta : output_files_) {
+          UserFrontier::Update(
+              &range->Smallest(), UpdateUserValueType::kSmallest, &meta.smallest.user_frontier);
+          UserFrontier::Update(
+              &range->Largest(), UpdateUserValueType::kLargest, &meta.largest.user_frontier);
+        }
       }
     }
 
@@ -259,62 +501,28 @@ Result<FileNumbersHolder> FlushJob::WriteLevel0Table(
                          << "num_memtables" << mems.size() << "num_entries"
                          << total_num_entries << "num_deletes"
                          << total_num_deletes << "memory_usage"
-                         << total_memory_usage;
-
-    TableFileCreationInfo info;
-    {
-      ScopedArenaIterator iter(
-          NewMergingIterator(cfd_->internal_comparator().get(), &memtables[0],
-                             static_cast<int>(memtables.size()), &arena));
-      RLOG(InfoLogLevel::INFO_LEVEL, db_options_.info_log,
-          "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": started",
-          cfd_->GetName().c_str(), job_context_->job_id, meta->fd.GetNumber());
-
-      TEST_SYNC_POINT_CALLBACK("FlushJob::WriteLevel0Table:output_compression",
-                               &output_compression_);
-      s = BuildTable(dbname_,
-                     db_options_.env,
-                     *cfd_->ioptions(),
-                     env_options_,
-                     cfd_->table_cache(),
-                     iter.get(),
-                     meta,
-                     cfd_->internal_comparator(),
-                     cfd_->int_tbl_prop_collector_factories(),
-                     cfd_->GetID(),
-                     existing_snapshots_,
-                     earliest_write_conflict_snapshot_,
-                     output_compression_,
-                     cfd_->ioptions()->compression_opts,
-                     mutable_cf_options_.paranoid_file_checks,
-                     cfd_->internal_stats(),
-                     db_options_.boundary_extractor.get(),
-                     Env::IO_HIGH,
-                     &table_properties_);
-      info.table_properties = table_properties_;
-      LogFlush(db_options_.info_log);
+                         << total_memory_usage << "num_output_files"
+                         << output_files_.size();
+
+    TEST_SYNC_POINT_CALLBACK("FlushJob::WriteLevel0Table:output_compression",
+                             &output_compression_);
+
+    // Output i contains user keys in [split_user_keys[i - 1], split_user_keys[i]).
+    auto write_output = [this, &mems, &split_user_keys, &statuses, &table_properties](size_t i) {
+      statuses[i] = WriteOutputFile(
+          mems, i == 0 ? nullptr : &split_user_keys[i - 1],
+          i == split_user_keys.size() ? nullptr : &split_user_keys[i],
+          &output_files_[i], &table_properties[i]);
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(output_files_.size() - 1);
+    for (size_t i = 1; i < output_files_.size(); ++i) {
+      threads.emplace_back(write_output, i);
     }
-    RLOG(InfoLogLevel::INFO_LEVEL, db_options_.info_log,
-        "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": %" PRIu64
-        " bytes %s"
-        "%s",
-        cfd_->GetName().c_str(), job_context_->job_id, meta->fd.GetNumber(),
-        meta->fd.GetTotalFileSize(), s.ToString().c_str(),
-        meta->marked_for_compaction ? " (needs compaction)" : "");
-
-    // output to event logger
-    if (s.ok()) {
-      info.db_name = dbname_;
-      info.cf_name = cfd_->GetName();
-      info.file_path = TableFileName(db_options_.db_paths,
-                                     meta->fd.GetNumber(),
-                                     meta->fd.GetPathId());
-      info.file_size = meta->fd.GetTotalFileSize();
-      info.job_id = job_context_->job_id;
-      EventHelpers::LogAndNotifyTableFileCreation(
-          event_logger_, db_options_.listeners,
-          meta->fd, info);
-      TEST_SYNC_POINT("FlushJob::LogAndNotifyTableFileCreation()");
+    // The first output is written by the current thread.
+    write_output(0);
+    for (auto& thread : threads) {
+      thread.join();
     }
 
     if (!db_options_.disableDataSync && output_file_directory_ != nullptr) {
@@ -324,24 +532,56 @@ Result<FileNumbersHolder> FlushJob::WriteLevel0Table(
     db_mutex_->Lock();
   }
 
-  // Note that if total_file_size is zero, the file has been deleted and
-  // should not be added to the manifest.
-  if (s.ok() && meta->fd.GetTotalFileSize() > 0) {
-    // if we have more than 1 background thread, then we cannot
-    // insert files directly into higher levels because some other
-    // threads could be concurrently producing compacted files for
-    // that key range.
-    // Add file to L0
-    edit->AddCleanedFile(0 /* level */, *meta);
+  Status s;
+  for (const auto& status : statuses) {
+    if (!status.ok()) {
+      s = status;
+      break;
+    }
+  }
+
+  if (output_files_.size() > 1) {
+    // Files written by a flush should have the same sequence number range and frontiers, so
+    // compaction treats them as a single sorted run, like files written by subcompactions.
+    FileMetaData boundaries;
+    for (const auto& meta : output_files_) {
+      if (meta.fd.GetTotalFileSize() > 0) {
+        boundaries.UpdateBoundariesExceptKey(meta.smallest, UpdateBoundariesType::kSmallest);
+        boundaries.UpdateBoundariesExceptKey(meta.largest, UpdateBoundariesType::kLargest);
+      }
+    }
+    for (auto& meta : output_files_) {
+      meta.UpdateBoundariesExceptKey(boundaries.smallest, UpdateBoundariesType::kSmallest);
+      meta.UpdateBoundariesExceptKey(boundaries.largest, UpdateBoundariesType::kLargest);
+    }
+  }
+
+  table_properties_ = table_properties[0];
+  uint64_t bytes_written = 0;
+  for (size_t i = 0; i != output_files_.size(); ++i) {
+    const auto& meta = output_files_[i];
+    if (i != 0) {
+      table_properties_.Add(table_properties[i]);
+    }
+    bytes_written += meta.fd.GetTotalFileSize();
+    // Note that if total_file_size is zero, the file has been deleted and
+    // should not be added to the manifest.
+    if (s.ok() && meta.fd.GetTotalFileSize() > 0) {
+      // if we have more than 1 background thread, then we cannot
+      // insert files directly into higher levels because some other
+      // threads could be concurrently producing compacted files for
+      // that key range.
+      // Add file to L0
+      edit->AddCleanedFile(0 /* level */, meta);
+    }
   }
 
   InternalStats::CompactionStats stats(1);
   stats.micros = db_options_.env->NowMicros() - start_micros;
-  stats.bytes_written = meta->fd.GetTotalFileSize();
+  stats.bytes_written = bytes_written;
   cfd_->internal_stats()->AddCompactionStats(0 /* level */, stats);
-  cfd_->internal_stats()->AddCFStats(InternalStats::BYTES_FLUSHED,
-      meta->fd.GetTotalFileSize());
-  RecordTick(stats_, COMPACT_WRITE_BYTES, meta->fd.GetTotalFileSize());
+  cfd_->internal_stats()->AddCFStats(InternalStats::BYTES_FLUSHED, bytes_written);
+  RecordTick(stats_, COMPACT_WRITE_BYTES, bytes_written);
   if (s.ok()) {
     return file_number_holder;
   } else {
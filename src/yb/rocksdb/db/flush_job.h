@@ -92,15 +92,31 @@ class FlushJob {
 
   ~FlushJob();
 
+  // Fills file_meta with the first of written files.
   Result<FileNumbersHolder> Run(FileMetaData* file_meta = nullptr);
   TableProperties GetTableProperties() const { return table_properties_; }
 
+  // Files written by Run, ordered by key range. There are several files when the flush is split by
+  // key ranges, see rocksdb_max_flush_parallelism.
+  const std::vector<FileMetaData>& output_files() const { return output_files_; }
+
  private:
   void ReportStartedFlush();
   void ReportFlushInputSize(const autovector<MemTable*>& mems);
   void RecordFlushIOStats();
   Result<FileNumbersHolder> WriteLevel0Table(
-      const autovector<MemTable*>& mems, VersionEdit* edit, FileMetaData* meta);
+      const autovector<MemTable*>& mems, VersionEdit* edit);
+
+  // Returns user keys splitting the flush into key ranges written to separate files in parallel.
+  // Empty when the flush should write a single file.
+  // Required that db_mutex_ is held, it is released while memtables are sampled.
+  std::vector<std::string> PickSplitUserKeys(const autovector<MemTable*>& mems);
+
+  // Writes memtable entries with user keys in [lower, upper) to the file described by meta.
+  // Null bound means that the range is not bounded from that side.
+  Status WriteOutputFile(
+      const autovector<MemTable*>& mems, const std::string* lower, const std::string* upper,
+      FileMetaData* meta, TableProperties* table_properties);
   const std::string& dbname_;
   ColumnFamilyData* cfd_;
   const DBOptions& db_options_;
@@ -122,6 +138,7 @@ class FlushJob {
   Statistics* stats_;
   EventLogger* event_logger_;
   TableProperties table_properties_;
+  std::vector<FileMetaData> output_files_;
 };
 
 }  // namespace rocksdb
@@ -24,6 +24,8 @@
 
 #include <boost/functional/hash.hpp>
 
+#include <gflags/gflags.h>
+
 #include "yb/rocksdb/db/file_numbers.h"
 #include "yb/rocksdb/db/flush_job.h"
 #include "yb/rocksdb/db/column_family.h"
@@ -36,6 +38,9 @@
 #include "yb/rocksdb/util/testutil.h"
 #include "yb/rocksdb/table/mock_table.h"
 
+DECLARE_int32(rocksdb_max_flush_parallelism);
+DECLARE_uint64(rocksdb_min_flush_partition_size_bytes);
+
 namespace rocksdb {
 
 // TODO(icanadi) Mock out everything else:
@@ -174,6 +179,63 @@ TEST_F(FlushJobTest, NonEmpty) {
   job_context.Clean();
 }
 
+TEST_F(FlushJobTest, Parallel) {
+  google::FlagSaver flag_saver;
+  FLAGS_rocksdb_max_flush_parallelism = 4;
+  FLAGS_rocksdb_min_flush_partition_size_bytes = 1;
+
+  JobContext job_context(0);
+  auto cfd = versions_->GetColumnFamilySet()->GetDefault();
+  auto new_mem = cfd->ConstructNewMemtable(*cfd->GetLatestMutableCFOptions(),
+                                           kMaxSequenceNumber);
+  new_mem->Ref();
+  auto inserted_keys = mock::MakeMockFile();
+  for (int i = 1; i < 10000; ++i) {
+    std::string key(ToString((i + 1000) % 10000));
+    std::string value("value" + key);
+    new_mem->Add(SequenceNumber(i), kTypeValue, key, value);
+    InternalKey internal_key(key, SequenceNumber(i), kTypeValue);
+    inserted_keys.emplace(internal_key.Encode().ToBuffer(), value);
+  }
+  test::TestUserFrontiers frontiers(1, 12345);
+  new_mem->UpdateFrontiers(frontiers);
+
+  autovector<MemTable*> to_delete;
+  cfd->imm()->Add(new_mem, &to_delete);
+  for (auto& m : to_delete) {
+    delete m;
+  }
+
+  EventLogger event_logger(db_options_.info_log.get());
+  FileNumbersProvider file_numbers_provider(versions_.get());
+  FlushJob flush_job(
+      dbname_, versions_->GetColumnFamilySet()->GetDefault(), db_options_,
+      *cfd->GetLatestMutableCFOptions(), env_options_, versions_.get(), &mutex_, &shutting_down_,
+      &disable_flush_on_shutdown_, {}, kMaxSequenceNumber, MemTableFilter(), &file_numbers_provider,
+      &job_context, nullptr, nullptr, nullptr, kNoCompression, nullptr, &event_logger);
+  mutex_.Lock();
+  ASSERT_OK(yb::ResultToStatus(flush_job.Run()));
+  mutex_.Unlock();
+
+  const auto& files = flush_job.output_files();
+  ASSERT_EQ(files.size(), 4U);
+  ASSERT_EQ(ToString(0), files.front().smallest.key.user_key().ToString());
+  ASSERT_EQ(ToString(9999), files.back().largest.key.user_key().ToString());
+  for (size_t i = 0; i != files.size(); ++i) {
+    // All files form a single sorted run.
+    ASSERT_EQ(1, files[i].smallest.seqno);
+    ASSERT_EQ(9999, files[i].largest.seqno);
+    ASSERT_TRUE(frontiers.Smallest().Equals(*files[i].smallest.user_frontier));
+    ASSERT_TRUE(frontiers.Largest().Equals(*files[i].largest.user_frontier));
+    if (i != 0) {
+      ASSERT_LT(files[i - 1].largest.key.user_key().ToString(),
+                files[i].smallest.key.user_key().ToString());
+    }
+  }
+  mock_table_factory_->AssertFilesUnion(files.size(), inserted_keys);
+  job_context.Clean();
+}
+
 TEST_F(FlushJobTest, Snapshots) {
   JobContext job_context(0);
   auto cfd = versions_->GetColumnFamilySet()->GetDefault();
@@ -65,6 +65,7 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <atomic>
+#include <vector>
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/util/allocator.h"
 #include "yb/rocksdb/util/random.h"
@@ -110,6 +111,11 @@ class InlineSkipList {
   // Return estimated number of entries smaller than `key`.
   uint64_t EstimateCount(const char* key) const;
 
+  // Appends to keys the keys of the highest level that has at least min_samples nodes, or of the
+  // bottom level if there is no such level. So keys are ordered and split the list into roughly
+  // equal parts.
+  void SampleKeys(size_t min_samples, std::vector<const char*>* keys) const;
+
   // Iteration over the contents of a skip list
   class Iterator {
    public:
@@ -476,6 +482,24 @@ uint64_t InlineSkipList<Comparator>::EstimateCount(const char* key) const {
   }
 }
 
+template <class Comparator>
+void InlineSkipList<Comparator>::SampleKeys(
+    size_t min_samples, std::vector<const char*>* keys) const {
+  for (int level = GetMaxHeight() - 1; level >= 0; --level) {
+    size_t count = 0;
+    for (Node* x = head_->Next(level); x != nullptr && count < min_samples; x = x->Next(level)) {
+      ++count;
+    }
+    if (count < min_samples && level != 0) {
+      continue;
+    }
+    for (Node* x = head_->Next(level); x != nullptr; x = x->Next(level)) {
+      keys->push_back(x->Key());
+    }
+    return;
+  }
+}
+
 template <class Comparator>
 InlineSkipList<Comparator>::InlineSkipList(const Comparator cmp,
                                            Allocator* allocator,
@@ -36,6 +36,7 @@
 #include "yb/rocksdb/iterator.h"
 #include "yb/rocksdb/merge_operator.h"
 #include "yb/rocksdb/slice_transform.h"
+#include "yb/rocksdb/table.h"
 #include "yb/rocksdb/table/internal_iterator.h"
 #include "yb/rocksdb/table/merger.h"
 #include "yb/rocksdb/util/arena.h"
@@ -85,7 +86,7 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
       moptions_(ioptions, mutable_cf_options),
       refs_(0),
       kArenaBlockSize(OptimizeBlockSize(moptions_.arena_block_size)),
-      arena_(moptions_.arena_block_size, 0),
+      arena_(moptions_.arena_block_size, ioptions.memtable_huge_page_size),
       allocator_(&arena_, write_buffer),
       table_(ioptions.memtable_factory->CreateMemTableRep(
           comparator_, &allocator_, ioptions.prefix_extractor,
@@ -103,6 +104,8 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
                  ? moptions_.inplace_update_num_locks
                  : 0),
       prefix_extractor_(ioptions.prefix_extractor),
+      filter_key_transformer_(ioptions.table_factory
+          ? ioptions.table_factory->GetFilterKeyTransformer() : nullptr),
       flush_state_(FlushState::kNotRequested),
       env_(ioptions.env) {
   UpdateFlushState();
@@ -118,6 +121,13 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
         ioptions.info_log));
   }
 
+  if (ioptions.memtable_filter_bloom_bits > 0) {
+    filter_bloom_.reset(new DynamicBloom(
+        &allocator_, ioptions.memtable_filter_bloom_bits, ioptions.bloom_locality,
+        moptions_.memtable_prefix_bloom_probes, nullptr,
+        moptions_.memtable_prefix_bloom_huge_page_tlb_size, ioptions.info_log));
+  }
+
   if (moptions_.mem_tracker) {
     arena_.SetMemTracker(moptions_.mem_tracker);
   }
@@ -348,6 +358,26 @@ InternalIterator* MemTable::NewIterator(const ReadOptions& read_options,
   return new (mem) MemTableIterator(*this, read_options, arena);
 }
 
+bool MemTable::FilterKeyMayMatch(const ReadOptions& read_options) const {
+  if (!filter_bloom_ || !read_options.table_aware_file_filter) {
+    return true;
+  }
+  const Slice user_key = read_options.table_aware_file_filter->user_key();
+  if (user_key.empty()) {
+    return true;
+  }
+  const Slice filter_key = GetFilterKey(user_key);
+  if (filter_key.empty()) {
+    return true;
+  }
+  if (!filter_bloom_->MayContain(filter_key)) {
+    PERF_COUNTER_ADD(bloom_memtable_miss_count, 1);
+    return false;
+  }
+  PERF_COUNTER_ADD(bloom_memtable_hit_count, 1);
+  return true;
+}
+
 port::RWMutex* MemTable::GetLock(const Slice& key) {
   static murmur_hash hash;
   return &locks_[hash(key) % locks_.size()];
@@ -393,6 +423,15 @@ uint64_t MemTable::ApproximateSize(const Slice& start_ikey,
   return entry_count * (data_size / n);
 }
 
+void MemTable::SampleUserKeys(size_t min_samples, std::vector<std::string>* user_keys) {
+  std::vector<const char*> entries;
+  table_->SampleEntries(min_samples, &entries);
+  user_keys->reserve(user_keys->size() + entries.size());
+  for (const char* entry : entries) {
+    user_keys->push_back(ExtractUserKey(GetLengthPrefixedSlice(entry)).ToString());
+  }
+}
+
 void MemTable::Add(SequenceNumber s, ValueType type,
                    const Slice& key, /* user key */
                    const Slice& value, bool allow_concurrent) {
@@ -437,6 +476,12 @@ void MemTable::Add(SequenceNumber s, ValueType type,
       assert(prefix_extractor_);
       prefix_bloom_->Add(prefix_extractor_->Transform(key));
     }
+    if (filter_bloom_) {
+      const Slice filter_key = GetFilterKey(key);
+      if (!filter_key.empty()) {
+        filter_bloom_->Add(filter_key);
+      }
+    }
 
     // The first sequence number inserted into the memtable.
     // Multiple occurences of the same sequence number in the write batch are allowed
@@ -464,6 +509,12 @@ void MemTable::Add(SequenceNumber s, ValueType type,
       assert(prefix_extractor_);
       prefix_bloom_->AddConcurrently(prefix_extractor_->Transform(key));
     }
+    if (filter_bloom_) {
+      const Slice filter_key = GetFilterKey(key);
+      if (!filter_key.empty()) {
+        filter_bloom_->AddConcurrently(filter_key);
+      }
+    }
 
     // atomically update first_seqno_ and earliest_seqno_.
     uint64_t cur_seq_num = first_seqno_.load(std::memory_order_relaxed);
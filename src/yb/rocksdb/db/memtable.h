@@ -181,6 +181,10 @@ class MemTable {
   //        those allocated in arena.
   InternalIterator* NewIterator(const ReadOptions& read_options, Arena* arena);
 
+  // Returns false if the memtable does not have entries with the filter key of
+  // read_options.table_aware_file_filter user key, so it could be skipped by the read.
+  bool FilterKeyMayMatch(const ReadOptions& read_options) const;
+
   // Add an entry into memtable that maps key to value at the
   // specified sequence number and with the specified type.
   // Typically value will be empty if type==kTypeDeletion.
@@ -333,6 +337,10 @@ class MemTable {
 
   uint64_t ApproximateSize(const Slice& start_ikey, const Slice& end_ikey);
 
+  // Appends to user_keys ordered user keys that split this memtable into roughly equal parts, at
+  // least min_samples of them if the memtable has enough entries. Neighbouring keys could be equal.
+  void SampleUserKeys(size_t min_samples, std::vector<std::string>* user_keys);
+
   // Get the lock associated for the key
   port::RWMutex* GetLock(const Slice& key);
 
@@ -412,6 +420,14 @@ class MemTable {
   const SliceTransform* const prefix_extractor_;
   std::unique_ptr<DynamicBloom> prefix_bloom_;
 
+  const FilterPolicy::KeyTransformer* const filter_key_transformer_;
+  // Bloom filter on filter keys of the entries, see memtable_filter_bloom_bits.
+  std::unique_ptr<DynamicBloom> filter_bloom_;
+
+  Slice GetFilterKey(const Slice& user_key) const {
+    return filter_key_transformer_ ? filter_key_transformer_->Transform(user_key) : user_key;
+  }
+
   std::atomic<FlushState> flush_state_;
 
   Env* env_;
@@ -168,8 +168,10 @@ void MemTableListVersion::AddIterators(
 void MemTableListVersion::AddIterators(
     const ReadOptions& options, MergeIteratorBuilder* merge_iter_builder) {
   for (auto& m : memlist_) {
-    merge_iter_builder->AddIterator(
-        m->NewIterator(options, merge_iter_builder->GetArena()));
+    if (m->FilterKeyMayMatch(options)) {
+      merge_iter_builder->AddIterator(
+          m->NewIterator(options, merge_iter_builder->GetArena()));
+    }
   }
 }
 
@@ -591,6 +591,27 @@ TEST_F(PerfContextTest, FalseDBMutexWait) {
   }
 }
 
+TEST_F(PerfContextTest, IteratorOperationCount) {
+  DestroyDB(kDbName, Options());
+  auto db = OpenDb();
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(db->Put(WriteOptions(), "k" + ToString(i), "v" + ToString(i)));
+  }
+
+  perf_context.Reset();
+  std::unique_ptr<Iterator> iter(db->NewIterator(ReadOptions()));
+  iter->Seek("k3");
+  iter->Next();
+  iter->Next();
+  iter->Prev();
+  iter->SeekToFirst();
+  iter->SeekToLast();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(3, perf_context.iter_seek_count);
+  ASSERT_EQ(2, perf_context.iter_next_count);
+  ASSERT_EQ(1, perf_context.iter_prev_count);
+}
+
 TEST_F(PerfContextTest, ToString) {
   perf_context.Reset();
   perf_context.block_read_count = 12345;
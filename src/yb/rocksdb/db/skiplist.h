@@ -84,6 +84,12 @@ class SkipListBase {
   // Return estimated number of entries smaller than `key`.
   uint64_t EstimateCount(Key key) const;
 
+  // Appends to keys the keys of the highest level that has at least min_samples nodes, or of the
+  // bottom level if there is no such level. So keys are ordered and split the list into roughly
+  // equal parts.
+  template <class Container>
+  void SampleKeys(size_t min_samples, Container* keys) const;
+
   // Iteration over the contents of a skip list
   class Iterator {
    public:
@@ -451,6 +457,25 @@ uint64_t SkipListBase<Key, Comparator, NodeType>::EstimateCount(Key key) const {
   }
 }
 
+template<class Key, class Comparator, class NodeType>
+template <class Container>
+void SkipListBase<Key, Comparator, NodeType>::SampleKeys(
+    size_t min_samples, Container* keys) const {
+  for (int level = GetMaxHeight() - 1; level >= 0; --level) {
+    size_t count = 0;
+    for (Node* x = head_->Next(level); x != nullptr && count < min_samples; x = x->Next(level)) {
+      ++count;
+    }
+    if (count < min_samples && level != 0) {
+      continue;
+    }
+    for (Node* x = head_->Next(level); x != nullptr; x = x->Next(level)) {
+      keys->push_back(x->key);
+    }
+    return;
+  }
+}
+
 template<class Key, class Comparator, class NodeType>
 void SkipListBase<Key, Comparator, NodeType>::PrepareInsert(Key key) {
   // fast path for sequential insertion
@@ -23,6 +23,8 @@
 
 #include "yb/rocksdb/db/table_cache.h"
 
+#include <array>
+
 #include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/db/filename.h"
 #include "yb/rocksdb/db/version_edit.h"
@@ -500,4 +502,110 @@ void TableCache::Evict(Cache* cache, uint64_t file_number) {
   cache->Erase(GetSliceForFileNumber(&file_number));
 }
 
+namespace {
+
+class SharedTableCacheView : public Cache {
+ public:
+  explicit SharedTableCacheView(std::shared_ptr<Cache> cache)
+      : cache_(std::move(cache)), id_(cache_->NewId()) {}
+
+  Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value), Handle** handle,
+                Statistics* statistics) override {
+    charge = std::max<size_t>(static_cast<TableReader*>(value)->ApproximateMemoryUsage(), 1);
+    KeyBuffer buffer;
+    return cache_->Insert(
+        PrefixedKey(key, &buffer), query_id, value, charge, deleter, handle, statistics);
+  }
+
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics) override {
+    KeyBuffer buffer;
+    return cache_->Lookup(PrefixedKey(key, &buffer), query_id, statistics);
+  }
+
+  void Release(Handle* handle) override {
+    cache_->Release(handle);
+  }
+
+  void* Value(Handle* handle) override {
+    return cache_->Value(handle);
+  }
+
+  void Erase(const Slice& key) override {
+    KeyBuffer buffer;
+    cache_->Erase(PrefixedKey(key, &buffer));
+  }
+
+  uint64_t NewId() override {
+    return cache_->NewId();
+  }
+
+  // Capacity and usage are the ones of the shared cache.
+  void SetCapacity(size_t capacity) override {
+    cache_->SetCapacity(capacity);
+  }
+
+  bool HasStrictCapacityLimit() const override {
+    return cache_->HasStrictCapacityLimit();
+  }
+
+  size_t GetCapacity() const override {
+    return cache_->GetCapacity();
+  }
+
+  size_t GetUsage() const override {
+    return cache_->GetUsage();
+  }
+
+  size_t GetUsage(Handle* handle) const override {
+    return cache_->GetUsage(handle);
+  }
+
+  size_t GetPinnedUsage() const override {
+    return cache_->GetPinnedUsage();
+  }
+
+  SubCacheType GetSubCacheType(Handle* e) const override {
+    return cache_->GetSubCacheType(e);
+  }
+
+  // Visits the entries of all DBs sharing the cache.
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) override {
+    cache_->ApplyToAllCacheEntries(callback, thread_safe);
+  }
+
+  void SetMetrics(
+      const scoped_refptr<yb::MetricEntity>& entity, yb::BlockCacheKind kind) override {
+    cache_->SetMetrics(entity, kind);
+  }
+
+  size_t Evict(size_t required) override {
+    return cache_->Evict(required);
+  }
+
+  std::vector<std::pair<size_t, size_t>> TEST_GetIndividualUsages() override {
+    return cache_->TEST_GetIndividualUsages();
+  }
+
+ private:
+  // Table cache keys are file numbers, see GetSliceForFileNumber, prefixed with the view id.
+  using KeyBuffer = std::array<char, 2 * sizeof(uint64_t)>;
+
+  Slice PrefixedKey(const Slice& key, KeyBuffer* buffer) const {
+    DCHECK_EQ(key.size(), sizeof(uint64_t));
+    EncodeFixed64(buffer->data(), id_);
+    memcpy(buffer->data() + sizeof(uint64_t), key.data(), key.size());
+    return Slice(buffer->data(), buffer->size());
+  }
+
+  const std::shared_ptr<Cache> cache_;
+  const uint64_t id_;
+};
+
+} // namespace
+
+std::shared_ptr<Cache> NewSharedTableCacheView(std::shared_ptr<Cache> shared_cache) {
+  return std::make_shared<SharedTableCacheView>(std::move(shared_cache));
+}
+
 }  // namespace rocksdb
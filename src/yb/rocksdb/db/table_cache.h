@@ -192,6 +192,12 @@ class TableCache {
   std::string row_cache_id_;
 };
 
+// Returns a view of the table reader cache shared by multiple DBs, used as the table cache of a
+// single DB. Keys of the view are prefixed with an id of the view, so file numbers of different
+// DBs do not collide, and table readers are charged by their approximate memory usage instead of
+// by count.
+std::shared_ptr<Cache> NewSharedTableCacheView(std::shared_ptr<Cache> shared_cache);
+
 }  // namespace rocksdb
 
 #endif // YB_ROCKSDB_DB_TABLE_CACHE_H
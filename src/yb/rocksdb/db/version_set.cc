@@ -799,17 +799,18 @@ uint64_t VersionStorageInfo::GetEstimatedActiveKeys() const {
   }
 }
 
-void Version::AddIterators(const ReadOptions& read_options,
-                           const EnvOptions& soptions,
-                           MergeIteratorBuilder* merge_iter_builder) {
+size_t Version::AddIterators(const ReadOptions& read_options,
+                             const EnvOptions& soptions,
+                             MergeIteratorBuilder* merge_iter_builder) {
   assert(storage_info_.finalized_);
 
   if (storage_info_.num_non_empty_levels() == 0) {
     // No file in the Version.
-    return;
+    return 0;
   }
 
   auto* arena = merge_iter_builder->GetArena();
+  size_t num_files = 0;
 
   // Merge all level zero files together since they may overlap
   for (size_t i = 0; i < storage_info_.LevelFilesBrief(0).num_files; i++) {
@@ -833,6 +834,7 @@ void Version::AddIterators(const ReadOptions& read_options,
       }
       if (file_iter) {
         merge_iter_builder->AddIterator(file_iter);
+        ++num_files;
       }
     }
   }
@@ -854,8 +856,11 @@ void Version::AddIterators(const ReadOptions& read_options,
       auto* first_level_iter = new (mem) LevelFileNumIterator(
           *cfd_->internal_comparator(), &storage_info_.LevelFilesBrief(level));
       merge_iter_builder->AddIterator(NewTwoLevelIterator(state, first_level_iter, arena, false));
+      // A seek reads a single file of a level with non overlapping files.
+      ++num_files;
     }
   }
+  return num_files;
 }
 
 VersionStorageInfo::VersionStorageInfo(
@@ -1245,10 +1250,18 @@ void VersionStorageInfo::ComputeCompactionScore(
       // overwrites/deletions).
       int num_sorted_runs = 0;
       uint64_t total_size = 0;
+      const FileMetaData* prev_file = nullptr;
       for (auto* f : files_[level]) {
         if (!f->being_compacted) {
           total_size += f->compensated_file_size;
-          num_sorted_runs++;
+          // Files produced by the same universal compaction with subcompactions have the same
+          // sequence numbers range and form a single sorted run.
+          if (compaction_style_ != kCompactionStyleUniversal || !prev_file ||
+              prev_file->smallest.seqno != f->smallest.seqno ||
+              prev_file->largest.seqno != f->largest.seqno) {
+            num_sorted_runs++;
+          }
+          prev_file = f;
         }
       }
       if (compaction_style_ == kCompactionStyleUniversal) {
@@ -2086,6 +2099,46 @@ Result<std::string> Version::GetMiddleKey() {
   return trwh.table_reader->GetMiddleKey();
 }
 
+Status Version::GetCachedDataBlocks(size_t max_blocks, std::vector<SstDataBlocks>* files) {
+  size_t num_blocks = 0;
+  for (int level = 0; level < storage_info_.num_levels_; ++level) {
+    for (const auto* file : storage_info_.files_[level]) {
+      if (num_blocks >= max_blocks) {
+        return Status::OK();
+      }
+      const auto trwh = VERIFY_RESULT(table_cache_->GetTableReader(
+          vset_->env_options_, cfd_->internal_comparator(), file->fd, kDefaultQueryId,
+          /* no_io =*/ false, cfd_->internal_stats()->GetFileReadHist(level),
+          IsFilterSkipped(level)));
+      SstDataBlocks file_blocks;
+      file_blocks.file_number = file->fd.GetNumber();
+      RETURN_NOT_OK(trwh.table_reader->GetCachedDataBlocks(
+          max_blocks - num_blocks, &file_blocks.blocks));
+      if (!file_blocks.blocks.empty()) {
+        num_blocks += file_blocks.blocks.size();
+        files->push_back(std::move(file_blocks));
+      }
+    }
+  }
+  return Status::OK();
+}
+
+Status Version::WarmUpDataBlocks(const SstDataBlocks& file_blocks) {
+  for (int level = 0; level < storage_info_.num_levels_; ++level) {
+    for (const auto* file : storage_info_.files_[level]) {
+      if (file->fd.GetNumber() != file_blocks.file_number) {
+        continue;
+      }
+      const auto trwh = VERIFY_RESULT(table_cache_->GetTableReader(
+          vset_->env_options_, cfd_->internal_comparator(), file->fd, kDefaultQueryId,
+          /* no_io =*/ false, cfd_->internal_stats()->GetFileReadHist(level),
+          IsFilterSkipped(level)));
+      return trwh.table_reader->WarmUpDataBlocks(file_blocks.blocks);
+    }
+  }
+  return Status::OK();
+}
+
 // this is used to batch writes to the manifest file
 struct VersionSet::ManifestWriter {
   Status status;
@@ -2112,7 +2165,8 @@ VersionSet::VersionSet(const std::string& dbname, const DBOptions* db_options,
       dbname_(dbname),
       db_options_(db_options),
       env_options_(storage_options),
-      env_options_compactions_(env_options_) {}
+      env_options_compactions_(
+          db_options->env->OptimizeForCompactionTableRead(env_options_, *db_options)) {}
 
 VersionSet::~VersionSet() {
   // we need to delete column_family_set_ because its destructor depends on
@@ -3578,7 +3632,7 @@ InternalIterator* VersionSet::MakeInputIterator(Compaction* c) {
         // Create concatenating iterator for the files from this level
         list[num++] = NewTwoLevelIterator(
             new LevelFileIteratorState(
-                cfd->table_cache(), read_options, env_options_,
+                cfd->table_cache(), read_options, env_options_compactions_,
                 cfd->internal_comparator(),
                 nullptr /* no per level latency histogram */,
                 true /* for_compaction */, false /* prefix enabled */,
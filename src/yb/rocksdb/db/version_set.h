@@ -442,8 +442,9 @@ class Version {
   // Append to *iters a sequence of iterators that will
   // yield the contents of this Version when merged together.
   // REQUIRES: This version has been saved (see VersionSet::SaveTo)
-  void AddIterators(const ReadOptions&, const EnvOptions& soptions,
-                    MergeIteratorBuilder* merger_iter_builder);
+  // Returns the number of SST files that have to be read to seek the merged iterator.
+  size_t AddIterators(const ReadOptions&, const EnvOptions& soptions,
+                      MergeIteratorBuilder* merger_iter_builder);
 
   // Lookup the value for key.  If found, store it in *val and
   // return OK.  Else return a non-OK status.
@@ -521,6 +522,14 @@ class Version {
   // Returns Status(Incomplete) if there are no SST files for this version.
   Result<std::string> GetMiddleKey();
 
+  // Appends to files data blocks of SST files of this version present in the block cache, at most
+  // max_blocks in total. Files of lower levels go first.
+  CHECKED_STATUS GetCachedDataBlocks(size_t max_blocks, std::vector<SstDataBlocks>* files);
+
+  // Loads specified data blocks of the file into the block cache. Does nothing when the file is not
+  // present in this version.
+  CHECKED_STATUS WarmUpDataBlocks(const SstDataBlocks& file);
+
   ColumnFamilyData* cfd() const { return cfd_; }
 
   // Return the next Version in the linked list. Used for debug only
@@ -821,8 +830,8 @@ class VersionSet {
   // env options for all reads and writes except compactions
   const EnvOptions& env_options_;
 
-  // env options used for compactions. This is a copy of
-  // env_options_ but with readaheads set to readahead_compactions_.
+  // env options used for compaction inputs. This is a copy of
+  // env_options_ optimized by Env::OptimizeForCompactionTableRead.
   const EnvOptions env_options_compactions_;
 
   // No copying allowed
@@ -43,6 +43,7 @@
 
 #include "yb/rocksdb/write_batch.h"
 
+#include <algorithm>
 #include <stack>
 #include <stdexcept>
 #include <vector>
@@ -62,6 +63,9 @@
 
 #include "yb/gutil/macros.h"
 
+#include "yb/util/countdown_latch.h"
+#include "yb/util/threadpool.h"
+
 namespace rocksdb {
 
 // anon namespace for file-local types
@@ -892,6 +896,124 @@ Status WriteBatchInternal::InsertInto(const WriteBatch* batch,
   return batch->Iterate(&inserter);
 }
 
+namespace {
+
+// Collects entries of a write batch, so they could be split between inserters running in parallel.
+class WriteBatchEntriesCollector : public WriteBatch::Handler {
+ public:
+  struct Entry {
+    uint32_t column_family_id;
+    ValueType type;
+    Slice key;
+    Slice value;
+  };
+
+  CHECKED_STATUS PutCF(uint32_t column_family_id, const Slice& key,
+                       const Slice& value) override {
+    entries_.push_back(Entry{column_family_id, kTypeValue, key, value});
+    return Status::OK();
+  }
+
+  CHECKED_STATUS DeleteCF(uint32_t column_family_id, const Slice& key) override {
+    entries_.push_back(Entry{column_family_id, kTypeDeletion, key, Slice()});
+    return Status::OK();
+  }
+
+  CHECKED_STATUS SingleDeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return STATUS(NotSupported, "Single delete could not be inserted in parallel");
+  }
+
+  CHECKED_STATUS MergeCF(uint32_t column_family_id, const Slice& key,
+                         const Slice& value) override {
+    return STATUS(NotSupported, "Merge could not be inserted in parallel");
+  }
+
+  CHECKED_STATUS Frontiers(const UserFrontiers& frontiers) override {
+    frontiers_ = &frontiers;
+    return Status::OK();
+  }
+
+  const std::vector<Entry>& entries() const { return entries_; }
+  const UserFrontiers* frontiers() const { return frontiers_; }
+
+ private:
+  std::vector<Entry> entries_;
+  const UserFrontiers* frontiers_ = nullptr;
+};
+
+// Inserts entries [begin, end) of the batch, the first of them gets specified sequence number.
+Status InsertEntries(
+    const WriteBatchEntriesCollector::Entry* begin, const WriteBatchEntriesCollector::Entry* end,
+    SequenceNumber sequence, ColumnFamilySet* column_family_set, FlushScheduler* flush_scheduler,
+    bool ignore_missing_column_families, DB* db) {
+  ColumnFamilyMemTablesImpl column_family_memtables(column_family_set);
+  MemTableInserter inserter(sequence, &column_family_memtables, flush_scheduler,
+                            ignore_missing_column_families, 0 /* log_number */, db,
+                            InsertFlags{InsertFlag::kConcurrentMemtableWrites});
+  for (auto it = begin; it != end; ++it) {
+    if (it->type == kTypeValue) {
+      RETURN_NOT_OK(inserter.PutCF(it->column_family_id, it->key, it->value));
+    } else {
+      RETURN_NOT_OK(inserter.DeleteCF(it->column_family_id, it->key));
+    }
+  }
+  return Status::OK();
+}
+
+} // namespace
+
+Status WriteBatchInternal::InsertIntoParallel(const WriteBatch* batch,
+                                              ColumnFamilySet* column_family_set,
+                                              FlushScheduler* flush_scheduler,
+                                              bool ignore_missing_column_families,
+                                              DB* db,
+                                              yb::ThreadPool* thread_pool,
+                                              size_t max_parts,
+                                              size_t min_entries_per_part) {
+  WriteBatchEntriesCollector collector;
+  RETURN_NOT_OK(batch->Iterate(&collector));
+  const SequenceNumber sequence = WriteBatchInternal::Sequence(batch);
+
+  if (collector.frontiers()) {
+    ColumnFamilyMemTablesImpl column_family_memtables(column_family_set);
+    MemTableInserter inserter(sequence, &column_family_memtables, flush_scheduler,
+                              ignore_missing_column_families, 0 /* log_number */, db,
+                              InsertFlags{InsertFlag::kConcurrentMemtableWrites});
+    RETURN_NOT_OK(inserter.Frontiers(*collector.frontiers()));
+  }
+
+  const auto& entries = collector.entries();
+  const size_t num_parts = std::max<size_t>(
+      1, std::min(max_parts, entries.size() / std::max<size_t>(min_entries_per_part, 1)));
+  const size_t part_size = (entries.size() + num_parts - 1) / num_parts;
+
+  // The calling thread inserts the first part, and the rest are submitted to the thread pool.
+  std::vector<Status> statuses(num_parts);
+  yb::CountDownLatch latch(num_parts - 1);
+  for (size_t part = 1; part < num_parts; ++part) {
+    const size_t begin = part * part_size;
+    const size_t end = std::min(begin + part_size, entries.size());
+    auto task = [&, begin, end, part] {
+      statuses[part] = InsertEntries(
+          entries.data() + begin, entries.data() + end, sequence + begin, column_family_set,
+          flush_scheduler, ignore_missing_column_families, db);
+      latch.CountDown();
+    };
+    if (!thread_pool->SubmitFunc(task).ok()) {
+      task();
+    }
+  }
+  statuses[0] = InsertEntries(
+      entries.data(), entries.data() + std::min(part_size, entries.size()), sequence,
+      column_family_set, flush_scheduler, ignore_missing_column_families, db);
+  latch.Wait();
+
+  for (const auto& status : statuses) {
+    RETURN_NOT_OK(status);
+  }
+  return Status::OK();
+}
+
 void WriteBatchInternal::SetContents(WriteBatch* b, const Slice& contents) {
   DCHECK_GE(contents.size(), kHeader);
   b->rep_.assign(contents.cdata(), contents.size());
@@ -40,6 +40,7 @@ namespace rocksdb {
 class MemTable;
 class FlushScheduler;
 class ColumnFamilyData;
+class ColumnFamilySet;
 
 class ColumnFamilyMemTables {
  public:
@@ -176,6 +177,19 @@ class WriteBatchInternal {
                            uint64_t log_number = 0, DB* db = nullptr,
                            InsertFlags insert_flags = InsertFlags());
 
+  // Inserts entries of a single batch, that has no merges and single deletes, into memtables.
+  // Entries are split into at most max_parts ranges of at least min_entries_per_part entries,
+  // which are inserted concurrently by the calling thread and tasks of thread_pool.
+  // Memtables should support concurrent inserts.
+  static Status InsertIntoParallel(const WriteBatch* batch,
+                                   ColumnFamilySet* column_family_set,
+                                   FlushScheduler* flush_scheduler,
+                                   bool ignore_missing_column_families,
+                                   DB* db,
+                                   yb::ThreadPool* thread_pool,
+                                   size_t max_parts,
+                                   size_t min_entries_per_part);
+
   static void Append(WriteBatch* dst, const WriteBatch* src);
 
   // Returns the byte size of appending a WriteBatch with ByteSize
@@ -105,6 +105,9 @@ struct EnvOptions : public yb::FileSystemOptions {
   // If true, set the FD_CLOEXEC on open fd.
   bool set_fd_cloexec = true;
 
+  // If true, then bypass OS buffers with O_DIRECT when the file system supports it.
+  bool use_direct_io = false;
+
   // Allows OS to incrementally sync files to disk while they are being
   // written, in the background. Issue one request for every bytes_per_sync
   // written. 0 turns it off.
@@ -458,6 +461,14 @@ class Env {
   virtual EnvOptions OptimizeForManifestWrite(const EnvOptions& env_options)
       const;
 
+  // OptimizeForCompactionTableWrite and OptimizeForCompactionTableRead create a new EnvOptions
+  // object that is a copy of the EnvOptions in the parameters, but is optimized for writing
+  // compaction outputs and reading compaction inputs respectively.
+  virtual EnvOptions OptimizeForCompactionTableWrite(const EnvOptions& env_options,
+                                                     const DBOptions& db_options) const;
+  virtual EnvOptions OptimizeForCompactionTableRead(const EnvOptions& env_options,
+                                                    const DBOptions& db_options) const;
+
   virtual bool IsPlainText() const {
     return true;
   }
@@ -97,6 +97,10 @@ struct ImmutableCFOptions {
   // to PlainTalbeOptions just like bloom_bits_per_key
   uint32_t bloom_locality;
 
+  uint32_t memtable_filter_bloom_bits;
+
+  size_t memtable_huge_page_size;
+
   bool purge_redundant_kvs_while_flush;
 
   uint32_t min_partial_merge_operands;
@@ -74,6 +74,12 @@ enum class CompactionReason {
   kManualCompaction,
   // DB::SuggestCompactRange() marked files for compaction
   kFilesMarkedForCompaction,
+  // [Universal] All records of files are obsolete, so files are deleted without compaction
+  kUniversalObsoleteFiles,
+  // [Universal] Average number of files read by iterators exceeded the threshold
+  kUniversalReadTriggered,
+  // [Universal] Sorted runs of a closed time window are compacted into a single sorted run
+  kUniversalTimeWindow,
 };
 
 #ifndef ROCKSDB_LITE
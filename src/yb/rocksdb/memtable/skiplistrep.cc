@@ -93,6 +93,10 @@ class SkipListRep : public MemTableRep {
     return (end_count >= start_count) ? (end_count - start_count) : 0;
   }
 
+  void SampleEntries(size_t min_samples, std::vector<const char*>* entries) override {
+    skip_list_.SampleKeys(min_samples, entries);
+  }
+
   ~SkipListRep() override { }
 
   // Iteration over the contents of a skip list
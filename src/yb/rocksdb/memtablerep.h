@@ -56,6 +56,7 @@
 
 #include <memory>
 #include <stdexcept>
+#include <vector>
 
 #include "yb/util/slice.h"
 #include "yb/util/strongly_typed_bool.h"
@@ -145,6 +146,11 @@ class MemTableRep {
     return 0;
   }
 
+  // Appends to entries ordered entries that split this rep into roughly equal parts, at least
+  // min_samples of them if the rep has enough entries. Could append nothing if the rep does not
+  // support sampling.
+  virtual void SampleEntries(size_t min_samples, std::vector<const char*>* entries) {}
+
   // Report an approximation of how much memory has been used other than memory
   // that was allocated through the allocator.  Safe to call from any thread.
   virtual size_t ApproximateMemoryUsage() = 0;
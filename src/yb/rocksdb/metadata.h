@@ -300,6 +300,18 @@ struct LiveFileMetaData : SstFileMetaData {
   }
 };
 
+// Location of a data block within the data file of a SST file.
+struct DataBlockLocation {
+  uint64_t offset = 0;
+  uint64_t size = 0;
+};
+
+// Data blocks of a SST file, e.g. ones present in the block cache.
+struct SstDataBlocks {
+  uint64_t file_number = 0;
+  std::vector<DataBlockLocation> blocks;
+};
+
 }  // namespace rocksdb
 
 #endif  // YB_ROCKSDB_METADATA_H
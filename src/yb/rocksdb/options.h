@@ -46,6 +46,7 @@ namespace yb {
 
 class MemTracker;
 class PriorityThreadPool;
+class ThreadPool;
 
 }
 
@@ -168,9 +169,25 @@ struct CompressionOptions {
   int window_bits;
   int level;
   int strategy;
-  CompressionOptions() : window_bits(-14), level(-1), strategy(0) {}
-  CompressionOptions(int wbits, int _lev, int _strategy)
-      : window_bits(wbits), level(_lev), strategy(_strategy) {}
+  // Max size of the dictionary, that is trained for each table file from samples of its data
+  // blocks, and used to compress them. Only supported by ZSTD, 0 disables dictionary compression.
+  uint32_t max_dict_bytes;
+  // Size of data blocks that are buffered as training samples, before they are compressed and
+  // written. 0 means 100 * max_dict_bytes.
+  uint32_t zstd_max_train_bytes;
+  // Max number of threads of thread_pool, that compress data blocks of a table file while the
+  // table builder keeps adding keys to the next blocks. 1 means that blocks are compressed by the
+  // thread that builds the table.
+  uint32_t parallel_threads = 1;
+  // Thread pool shared by table builders for parallel compression. Blocks are compressed by the
+  // thread that builds the table when it is not set.
+  yb::ThreadPool* thread_pool = nullptr;
+  CompressionOptions()
+      : window_bits(-14), level(-1), strategy(0), max_dict_bytes(0), zstd_max_train_bytes(0) {}
+  CompressionOptions(int wbits, int _lev, int _strategy, uint32_t _max_dict_bytes = 0,
+                     uint32_t _zstd_max_train_bytes = 0)
+      : window_bits(wbits), level(_lev), strategy(_strategy), max_dict_bytes(_max_dict_bytes),
+        zstd_max_train_bytes(_zstd_max_train_bytes) {}
 };
 
 enum UpdateStatus {    // Return status For inplace update callback
@@ -772,6 +789,20 @@ struct ColumnFamilyOptions {
   // Default: 0
   uint32_t bloom_locality;
 
+  // Size in bits of the memtable bloom filter on filter keys of the entries, i.e. user keys
+  // transformed with the key transformer of the table filter policy. Lets the reads that use
+  // ReadOptions::table_aware_file_filter skip memtables, that don't have entries with the filter
+  // key they are looking for. 0 disables the filter.
+  // Default: 0
+  uint32_t memtable_filter_bloom_bits = 0;
+
+  // Page size to allocate memtable arena blocks with, so that memtable inserts and lookups see
+  // fewer TLB misses. Blocks are allocated from reserved huge pages (vm.nr_hugepages) when
+  // possible, otherwise they are mmaped and madvised for transparent huge pages. Should be the
+  // huge page size of the system, e.g. 2MB. 0 allocates arena blocks with malloc.
+  // Default: 0
+  size_t memtable_huge_page_size = 0;
+
   // Maximum number of successive merge operations on a key in the memtable.
   //
   // When a merge operation is added to the memtable and the maximum number of
@@ -876,6 +907,19 @@ struct DBOptions {
 
   yb::PriorityThreadPool* priority_thread_pool_for_compactions_and_flushes = nullptr;
 
+  // When set, a write batch that is written alone and has at least
+  // 2 * min_entries_per_parallel_memtable_insert entries is split into ranges of at least that
+  // many entries, that are inserted into memtables concurrently by the writing thread and tasks of
+  // this pool. Batches with merges or single deletes are always inserted by the writing thread.
+  // Requires memtables that support concurrent inserts, same as allow_concurrent_memtable_write.
+  yb::ThreadPool* memtable_insert_thread_pool = nullptr;
+
+  // Min number of entries in each range of the batch inserted in parallel.
+  size_t min_entries_per_parallel_memtable_insert = 1024;
+
+  // Max number of ranges the batch is split into for parallel insert.
+  size_t max_parallel_memtable_inserts = 4;
+
   // Use to control write rate of flush and compaction. Flush has higher
   // priority than compaction. Rate limiting is disabled if nullptr.
   // If rate limiter is enabled, bytes_per_sync is set to 1MB by default.
@@ -1174,6 +1218,13 @@ struct DBOptions {
   // Default: 0
   size_t compaction_readahead_size;
 
+  // If true, compaction output files are written with O_DIRECT, and so are compaction inputs when
+  // new_table_reader_for_compaction_inputs is set. Compaction then does not evict the OS page
+  // cache used by foreground reads. Ignored when the file system does not support O_DIRECT.
+  //
+  // Default: false
+  bool use_direct_io_for_compaction;
+
   // This is a maximum buffer size that is used by WinMmapReadableFile in
   // unbuffered disk I/O mode. We need to maintain an aligned buffer for
   // reads. We allow the buffer to grow until the specified value and then
@@ -1350,6 +1401,11 @@ struct DBOptions {
   // Adds ability to modify iterator created for SST file.
   // For instance some additional filtering could be added.
   std::shared_ptr<IteratorReplacer> iterator_replacer;
+
+  // Cache of table readers shared by multiple DBs, see NewSharedTableCacheView. Table readers are
+  // charged by their approximate memory usage. When not set, the DB caches up to max_open_files
+  // table readers in its own cache.
+  std::shared_ptr<Cache> shared_table_cache;
 };
 
 // Options to control the behavior of a database (passed to DB::Open)
@@ -1406,6 +1462,10 @@ class TableAwareReadFileFilter {
  public:
   virtual bool Filter(TableReader*) const = 0;
 
+  // User key, that files are filtered by. Memtables that don't have entries with the same filter
+  // key are skipped as well (see memtable_filter_bloom_bits). Empty if not known.
+  virtual Slice user_key() const { return Slice(); }
+
  protected:
   virtual ~TableAwareReadFileFilter() {}
 };
@@ -106,6 +106,10 @@ struct PerfContext {
   uint64_t bloom_sst_hit_count;
   // total number of SST table bloom misses
   uint64_t bloom_sst_miss_count;
+  // total number of seeks, nexts and prevs of DB iterators
+  uint64_t iter_seek_count;
+  uint64_t iter_next_count;
+  uint64_t iter_prev_count;
 };
 
 #if defined(NPERF_CONTEXT) || defined(IOS_CROSS_COMPILE)
@@ -0,0 +1,108 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_ROCKSDB_PERSISTENT_CACHE_H
+#define YB_ROCKSDB_PERSISTENT_CACHE_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "yb/rocksdb/status.h"
+
+#include "yb/util/mem_tracker.h"
+#include "yb/util/metrics.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+class Env;
+
+using namespace yb::size_literals;
+
+// Secondary tier of the block cache, that keeps uncompressed blocks on a local device.
+// Blocks are inserted when they are evicted from the block cache, and looked up on block cache
+// miss before reading the table file. Keys are the block cache keys built from the unique id of
+// the table file, so they remain valid across restarts.
+class PersistentCache {
+ public:
+  virtual ~PersistentCache() = default;
+
+  // Schedules the block to be stored. Cache could decline to store it, for instance when the
+  // device could not keep up with the writes.
+  virtual void Insert(const Slice& key, const Slice& data) = 0;
+
+  // Reads the block stored with specified key. Returns NotFound if there is no such block.
+  virtual Status Lookup(const Slice& key, std::unique_ptr<char[]>* data, size_t* size) = 0;
+
+  // Total size of the stored blocks.
+  virtual size_t GetUsage() const = 0;
+};
+
+// Persistent cache as seen by the blocks of a single table file. The table reader closes it
+// together with the file, so blocks of files that are obsolete, or were closed at shutdown, are
+// not stored when they are evicted from the block cache afterwards.
+class PersistentCacheFile {
+ public:
+  explicit PersistentCacheFile(std::shared_ptr<PersistentCache> cache)
+      : cache_(std::move(cache)) {}
+
+  // Cache used to look up blocks of the file.
+  PersistentCache* cache() const {
+    return cache_.get();
+  }
+
+  // Cache that should receive blocks of the file evicted from the block cache, or nullptr if the
+  // file was closed.
+  PersistentCache* spill_cache() const {
+    return open_.load(std::memory_order_acquire) ? cache_.get() : nullptr;
+  }
+
+  void Close() {
+    open_.store(false, std::memory_order_release);
+  }
+
+ private:
+  const std::shared_ptr<PersistentCache> cache_;
+  std::atomic<bool> open_{true};
+};
+
+struct PersistentCacheOptions {
+  Env* env = nullptr;
+
+  // Directory for the cache files. It is exclusively owned by the cache.
+  std::string path;
+
+  // Max total size of the cache files.
+  size_t capacity = 0;
+
+  // Cache is a log of segment files of this size. When the capacity is exceeded, the oldest
+  // segment is deleted together with all blocks stored in it.
+  size_t segment_size = 64_MB;
+
+  // Max size of the blocks waiting to be written. When more than a half of it is used, only the
+  // blocks that were declined before are admitted.
+  size_t max_pending_bytes = 32_MB;
+
+  std::shared_ptr<yb::MemTracker> parent_mem_tracker;
+  scoped_refptr<yb::MetricEntity> metric_entity;
+};
+
+// Creates the cache in options.path, picking up blocks stored there by the previous run.
+Status NewPersistentCache(
+    const PersistentCacheOptions& options, std::shared_ptr<PersistentCache>* cache);
+
+} // namespace rocksdb
+
+#endif // YB_ROCKSDB_PERSISTENT_CACHE_H
@@ -70,9 +70,15 @@ class RateLimiter {
 // continuouly. This fairness parameter grants low-pri requests permission by
 // 1/fairness chance even though high-pri requests exist to avoid starvation.
 // You should be good by leaving it at default 10.
+// @auto_tuned: Enables dynamic adjustment of the rate limit within the range
+// [rate_bytes_per_sec / 20, rate_bytes_per_sec], according to the recent demand for background
+// writes. The limit goes up while requests keep waiting for refills, i.e. flushes and compactions
+// are falling behind, and goes down while they do not use the budget, so a later burst of
+// background writes does not compete with foreground I/O at the full rate.
 extern RateLimiter* NewGenericRateLimiter(
     int64_t rate_bytes_per_sec,
     int64_t refill_period_us = 100 * 1000,
-    int32_t fairness = 10);
+    int32_t fairness = 10,
+    bool auto_tuned = false);
 
 }  // namespace rocksdb
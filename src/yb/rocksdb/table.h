@@ -37,6 +37,7 @@
 #include <unordered_map>
 
 #include "yb/rocksdb/env.h"
+#include "yb/rocksdb/filter_policy.h"
 #include "yb/rocksdb/iterator.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/immutable_options.h"
@@ -47,6 +48,7 @@ namespace rocksdb {
 
 // -- Block-based Table
 class FlushBlockPolicyFactory;
+class PersistentCache;
 struct TableReaderOptions;
 struct TableBuilderOptions;
 class TableBuilder;
@@ -78,6 +80,19 @@ YB_DEFINE_ENUM(IndexType,
   (kMultiLevelBinarySearch)
 );
 
+// Encoding of keys in data blocks.
+enum class KeyValueEncodingFormat : char {
+  // Each key is stored as the size of the prefix shared with the previous key followed by the
+  // rest of the key.
+  kKeyDeltaEncodingSharedPrefix,
+  // Additionally allows each key to take a run of bytes located at the same distance from the end
+  // of the key from the previous key. DocDB keys end with an encoded DocHybridTime followed by the
+  // internal key footer, so adjacent keys with different doc keys usually share the high-order
+  // bytes of their hybrid times in such a run, which prefix compression can't reach.
+  // Blocks written with this encoding can't be read by versions that don't know about it.
+  kKeyDeltaEncodingSharedPrefixAndMiddle,
+};
+
 // For advanced user only
 struct BlockBasedTableOptions {
   // @flush_block_policy_factory creates the instances of flush block policy.
@@ -96,6 +111,12 @@ struct BlockBasedTableOptions {
   // Note: Fixed-size bloom filter data blocks are never pre-loaded.
   bool cache_index_and_filter_blocks = false;
 
+  // When cache_index_and_filter_blocks is set, keep the data index reader, that holds the top
+  // level index block, in the table reader instead of the block cache, and add lower level index
+  // blocks and filter blocks to the multi-touch part of the block cache at once. So under cache
+  // pressure a point read does not need extra reads of index blocks before the data block.
+  bool high_priority_index_and_filter_blocks = false;
+
   IndexType index_type = IndexType::kMultiLevelBinarySearch;
 
   // Influence the behavior when kHashSearch is used.
@@ -122,6 +143,10 @@ struct BlockBasedTableOptions {
   // If NULL, rocksdb will not use a compressed block cache.
   std::shared_ptr<Cache> block_cache_compressed = nullptr;
 
+  // If non-NULL, uncompressed blocks evicted from block_cache are stored in this cache, and
+  // looked up there before reading the table file. Used only for files that have a unique id.
+  std::shared_ptr<PersistentCache> persistent_cache = nullptr;
+
   // Approximate size of user data packed per block, in bytes. Note that the
   // block size specified here corresponds to uncompressed data.  The
   // actual size of the unit read from disk may be smaller if
@@ -133,6 +158,11 @@ struct BlockBasedTableOptions {
   // Size of each filter block, in bytes. Only applicable for fixed size filter block.
   size_t filter_block_size = 64 * 1024;
 
+  // When an iterator reads data blocks sequentially, it hints the file to read ahead the
+  // following data, doubling the readahead size up to this limit while the reads stay
+  // sequential, and starting over after a seek. 0 disables readahead of user scans.
+  size_t max_scan_readahead_size = 0;
+
   // This is used to close a block before it reaches the configured
   // 'block_size'. If the percentage of free space in the current block is less
   // than this specified number and adding a new record to the block will
@@ -162,6 +192,11 @@ struct BlockBasedTableOptions {
   // Default: true
   bool use_delta_encoding = true;
 
+  // Encoding of keys in data blocks, index blocks always use kKeyDeltaEncodingSharedPrefix.
+  // Readers detect the encoding of each block, so this only affects newly written files.
+  KeyValueEncodingFormat data_block_key_value_encoding_format =
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
+
   // If non-nullptr, use the specified filter policy for new SST files to reduce disk reads.
   // Many applications will benefit from passing the result of
   // NewBloomFilterPolicy() here.
@@ -423,6 +458,10 @@ class TableFactory {
   // DocDbAwareFilterPolicy and HashedComponentsExtractor.
   virtual std::shared_ptr<TableAwareReadFileFilter> NewTableAwareReadFileFilter(
       const ReadOptions &read_options, const Slice &user_key) const { return nullptr; }
+
+  // Returns the key transformer used to get filter keys from user keys, or nullptr if user keys
+  // are used as filter keys as is.
+  virtual const FilterPolicy::KeyTransformer* GetFilterKeyTransformer() const { return nullptr; }
 };
 
 #ifndef ROCKSDB_LITE
@@ -27,17 +27,31 @@
 
 #include <algorithm>
 #include <string>
+#include <typeinfo>
 #include <unordered_map>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include "yb/rocksdb/comparator.h"
+#include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/table/format.h"
+#include "yb/rocksdb/table/block_builder.h"
 #include "yb/rocksdb/table/block_hash_index.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/logging.h"
 #include "yb/rocksdb/util/perf_context_imp.h"
 
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(rocksdb_block_normalized_key_prefixes, false,
+            "Whether seeks within data and index blocks search restart points using an array of "
+            "fixed-width key prefixes built when the block is first read, and compare full keys "
+            "only when prefixes are equal.");
+TAG_FLAG(rocksdb_block_normalized_key_prefixes, advanced);
+TAG_FLAG(rocksdb_block_normalized_key_prefixes, runtime);
+
 namespace rocksdb {
 
 namespace {
@@ -80,6 +94,45 @@ static inline const char* DecodeEntry(const char* p, const char* limit,
   return p;
 }
 
+// The same as DecodeEntry, but for blocks using kKeyDeltaEncodingSharedPrefixAndMiddle (see
+// block_builder.cc). Returns a pointer to the key delta, which is followed by
+// "*non_shared_suffix" bytes of the key suffix.
+static inline const char* DecodeEntryWithSharedMiddle(const char* p, const char* limit,
+                                                      uint32_t* shared,
+                                                      uint32_t* non_shared,
+                                                      uint32_t* value_length,
+                                                      uint32_t* shared_middle,
+                                                      uint32_t* non_shared_suffix) {
+  if (limit - p < 3) return nullptr;
+  *shared = reinterpret_cast<const unsigned char*>(p)[0];
+  *non_shared = reinterpret_cast<const unsigned char*>(p)[1];
+  *value_length = reinterpret_cast<const unsigned char*>(p)[2];
+  if ((*shared | *non_shared | *value_length) < 128) {
+    // Fast path: all three values are encoded in one byte each
+    p += 3;
+  } else {
+    if ((p = GetVarint32Ptr(p, limit, shared)) == nullptr) return nullptr;
+    if ((p = GetVarint32Ptr(p, limit, non_shared)) == nullptr) return nullptr;
+    if ((p = GetVarint32Ptr(p, limit, value_length)) == nullptr) return nullptr;
+  }
+
+  const bool has_shared_middle = (*non_shared & 1) != 0;
+  *non_shared >>= 1;
+  if (has_shared_middle) {
+    if ((p = GetVarint32Ptr(p, limit, shared_middle)) == nullptr) return nullptr;
+    if ((p = GetVarint32Ptr(p, limit, non_shared_suffix)) == nullptr) return nullptr;
+  } else {
+    *shared_middle = 0;
+    *non_shared_suffix = 0;
+  }
+
+  if (static_cast<uint64_t>(limit - p) <
+          static_cast<uint64_t>(*non_shared) + *non_shared_suffix + *value_length) {
+    return nullptr;
+  }
+  return p;
+}
+
 void BlockIter::Next() {
   assert(Valid());
   ParseNextKey();
@@ -108,7 +161,8 @@ void BlockIter::Prev() {
 
 void BlockIter::Initialize(const Comparator* comparator, const char* data,
                            uint32_t restarts, uint32_t num_restarts, BlockHashIndex* hash_index,
-                           BlockPrefixIndex* prefix_index) {
+                           BlockPrefixIndex* prefix_index,
+                           KeyValueEncodingFormat key_value_encoding_format) {
   DCHECK(data_ == nullptr); // Ensure it is called only once
   DCHECK_GT(num_restarts, 0); // Ensure the param is valid
 
@@ -120,6 +174,7 @@ void BlockIter::Initialize(const Comparator* comparator, const char* data,
   restart_index_ = num_restarts_;
   hash_index_ = hash_index;
   prefix_index_ = prefix_index;
+  key_value_encoding_format_ = key_value_encoding_format;
 }
 
 
@@ -134,6 +189,7 @@ void BlockIter::Seek(const Slice& target) {
     ok = PrefixSeek(target, &index);
   } else {
     ok = hash_index_ ? HashSeek(target, &index)
+      : restart_key_prefixes_ ? NormalizedPrefixSeek(target, &index)
       : BinarySeek(target, 0, num_restarts_ - 1, &index);
   }
 
@@ -202,12 +258,30 @@ bool BlockIter::ParseNextKey() {
 
   // Decode next entry
   uint32_t shared, non_shared, value_length;
-  p = DecodeEntry(p, limit, &shared, &non_shared, &value_length);
-  if (p == nullptr || key_.Size() < shared) {
+  uint32_t shared_middle = 0, non_shared_suffix = 0;
+  if (key_value_encoding_format_ == KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix) {
+    p = DecodeEntry(p, limit, &shared, &non_shared, &value_length);
+  } else {
+    p = DecodeEntryWithSharedMiddle(
+        p, limit, &shared, &non_shared, &value_length, &shared_middle, &non_shared_suffix);
+  }
+  if (p == nullptr || key_.Size() < shared ||
+      key_.Size() < static_cast<uint64_t>(shared_middle) + non_shared_suffix) {
     CorruptionError();
     return false;
   } else {
-    if (shared == 0) {
+    if (shared_middle != 0) {
+      // The middle part of the previous key is overwritten by the new key, so assemble the new
+      // key in a separate buffer.
+      const Slice prev_key = key_.GetKey();
+      key_buffer_.assign(prev_key.cdata(), shared);
+      key_buffer_.append(p, non_shared);
+      key_buffer_.append(
+          prev_key.cend() - non_shared_suffix - shared_middle, shared_middle);
+      key_buffer_.append(p + non_shared, non_shared_suffix);
+      key_.SetKey(key_buffer_);
+      non_shared += non_shared_suffix;
+    } else if (shared == 0) {
       // If this key dont share any bytes with prev key then we dont need
       // to decode it and can use it's address in the block directly.
       key_.SetKey(Slice(p, non_shared), false /* copy */);
@@ -232,16 +306,11 @@ bool BlockIter::BinarySeek(const Slice& target, uint32_t left, uint32_t right,
 
   while (left < right) {
     uint32_t mid = (left + right + 1) / 2;
-    uint32_t region_offset = GetRestartPoint(mid);
-    uint32_t shared, non_shared, value_length;
-    const char* key_ptr =
-        DecodeEntry(data_ + region_offset, data_ + restarts_, &shared,
-                    &non_shared, &value_length);
-    if (key_ptr == nullptr || (shared != 0)) {
+    Slice mid_key;
+    if (DecodeRestartKey(mid, &mid_key) == nullptr) {
       CorruptionError();
       return false;
     }
-    Slice mid_key(key_ptr, non_shared);
     int cmp = Compare(mid_key, target);
     if (cmp < 0) {
       // Key at "mid" is smaller than "target". Therefore all
@@ -260,21 +329,111 @@ bool BlockIter::BinarySeek(const Slice& target, uint32_t left, uint32_t right,
   return true;
 }
 
+namespace {
+
+// Returns the big endian encoded 8 bytes of key starting at offset, padded with zeros.
+// Prefixes of bytewise ordered keys are ordered the same way, except that different keys could
+// have equal prefixes.
+inline uint64_t NormalizedKeyPrefix(const Slice& key, size_t offset) {
+  uint64_t result = 0;
+  const size_t size = std::min<size_t>(key.size() - offset, sizeof(result));
+  const auto* p = key.data() + offset;
+  for (size_t i = 0; i != size; ++i) {
+    result |= static_cast<uint64_t>(p[i]) << (8 * (sizeof(result) - 1 - i));
+  }
+  return result;
+}
+
+// Returns the number of prefixes that are less than value, or less than or equal to value when
+// or_equal is set. A branch-free binary search, the compiler uses conditional moves for it.
+template <bool or_equal>
+inline size_t CountPrefixesBefore(const std::vector<uint64_t>& prefixes, uint64_t value) {
+  const uint64_t* base = prefixes.data();
+  size_t size = prefixes.size();
+  while (size > 1) {
+    const size_t half = size / 2;
+    base = (or_equal ? base[half] <= value : base[half] < value) ? base + half : base;
+    size -= half;
+  }
+  return base - prefixes.data() + (or_equal ? *base <= value : *base < value);
+}
+
+} // namespace
+
+bool BlockIter::NormalizedPrefixSeek(const Slice& target, uint32_t* index) {
+  const auto& restart_key_prefixes = *restart_key_prefixes_;
+  if (target.size() < restart_key_prefixes.key_suffix_size) {
+    return BinarySeek(target, 0, num_restarts_ - 1, index);
+  }
+  const Slice target_key(target.data(), target.size() - restart_key_prefixes.key_suffix_size);
+  const Slice shared_prefix(restart_key_prefixes.shared_prefix);
+  int cmp = memcmp(
+      target_key.data(), shared_prefix.data(), std::min(target_key.size(), shared_prefix.size()));
+  if (cmp == 0 && target_key.size() < shared_prefix.size()) {
+    cmp = -1;
+  }
+  if (cmp != 0) {
+    // Target is before or after all restart keys.
+    *index = cmp < 0 ? 0 : num_restarts_ - 1;
+    return true;
+  }
+
+  const auto target_prefix = NormalizedKeyPrefix(target_key, shared_prefix.size());
+  const auto& prefixes = restart_key_prefixes.prefixes;
+  // Restart keys before begin are less than target, restart keys starting from end are greater
+  // than target.
+  const auto begin = static_cast<uint32_t>(CountPrefixesBefore<false>(prefixes, target_prefix));
+  const auto end = static_cast<uint32_t>(CountPrefixesBefore<true>(prefixes, target_prefix));
+  const uint32_t left = begin == 0 ? 0 : begin - 1;
+  if (begin == end) {
+    *index = left;
+    return true;
+  }
+  return BinarySeek(target, left, end - 1, index);
+}
+
 // Compare target key and the block key of the block of `block_index`.
 // Return -1 if error.
 int BlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
-  uint32_t region_offset = GetRestartPoint(block_index);
-  uint32_t shared, non_shared, value_length;
-  const char* key_ptr = DecodeEntry(data_ + region_offset, data_ + restarts_,
-                                    &shared, &non_shared, &value_length);
-  if (key_ptr == nullptr || (shared != 0)) {
+  Slice block_key;
+  if (DecodeRestartKey(block_index, &block_key) == nullptr) {
     CorruptionError();
     return 1;  // Return target is smaller
   }
-  Slice block_key(key_ptr, non_shared);
   return Compare(block_key, target);
 }
 
+namespace {
+
+// Decodes the key of the restart point entry at p. Restart points always store the whole key.
+const char* DecodeRestartKeyAt(
+    const char* p, const char* limit, KeyValueEncodingFormat key_value_encoding_format,
+    Slice* key) {
+  uint32_t shared, non_shared, value_length;
+  if (key_value_encoding_format == KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix) {
+    p = DecodeEntry(p, limit, &shared, &non_shared, &value_length);
+    if (p == nullptr || shared != 0) {
+      return nullptr;
+    }
+  } else {
+    uint32_t shared_middle, non_shared_suffix;
+    p = DecodeEntryWithSharedMiddle(
+        p, limit, &shared, &non_shared, &value_length, &shared_middle, &non_shared_suffix);
+    if (p == nullptr || shared != 0 || shared_middle != 0) {
+      return nullptr;
+    }
+  }
+  *key = Slice(p, non_shared);
+  return p;
+}
+
+} // namespace
+
+const char* BlockIter::DecodeRestartKey(uint32_t restart_index, Slice* key) {
+  return DecodeRestartKeyAt(
+      data_ + GetRestartPoint(restart_index), data_ + restarts_, key_value_encoding_format_, key);
+}
+
 // Binary search in block_ids to find the first block
 // with a key >= target
 bool BlockIter::BinaryBlockIndexSeek(const Slice& target, uint32_t* block_ids,
@@ -357,7 +516,7 @@ bool BlockIter::PrefixSeek(const Slice& target, uint32_t* index) {
 
 uint32_t Block::NumRestarts() const {
   assert(size_ >= kMinBlockSize);
-  return DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  return DecodeFixed32(data_ + size_ - sizeof(uint32_t)) & ~kSharedMiddleEncodingFlag;
 }
 
 Block::Block(BlockContents&& contents)
@@ -367,6 +526,9 @@ Block::Block(BlockContents&& contents)
   if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
   } else {
+    if (DecodeFixed32(data_ + size_ - sizeof(uint32_t)) & kSharedMiddleEncodingFlag) {
+      key_value_encoding_format_ = KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefixAndMiddle;
+    }
     restart_offset_ =
         static_cast<uint32_t>(size_) - (1 + NumRestarts()) * sizeof(uint32_t);
     if (restart_offset_ > size_ - sizeof(uint32_t)) {
@@ -403,10 +565,13 @@ InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
 
     if (iter != nullptr) {
       iter->Initialize(cmp, data_, restart_offset_, num_restarts,
-                    hash_index_ptr, prefix_index_ptr);
+                    hash_index_ptr, prefix_index_ptr, key_value_encoding_format_);
     } else {
       iter = new BlockIter(cmp, data_, restart_offset_, num_restarts,
-                           hash_index_ptr, prefix_index_ptr);
+                           hash_index_ptr, prefix_index_ptr, key_value_encoding_format_);
+    }
+    if (FLAGS_rocksdb_block_normalized_key_prefixes && cmp != nullptr) {
+      iter->SetRestartKeyPrefixes(GetRestartKeyPrefixes(cmp));
     }
   }
 
@@ -421,6 +586,92 @@ void Block::SetBlockPrefixIndex(BlockPrefixIndex* prefix_index) {
   prefix_index_.reset(prefix_index);
 }
 
+namespace {
+
+// Packed sequence number and value type at the end of an internal key.
+constexpr size_t kInternalKeyTrailerSize = sizeof(uint64_t);
+
+// Returns the number of trailing key bytes ignored by the comparator when keys are ordered
+// bytewise, or boost::none if the comparator does not order keys bytewise.
+boost::optional<size_t> BytewiseKeySuffixSize(const Comparator* comparator) {
+  if (comparator == BytewiseComparator()) {
+    return 0;
+  }
+  // Subclasses could override the order, so only the exact class is accepted.
+  if (typeid(*comparator) == typeid(InternalKeyComparator) &&
+      static_cast<const InternalKeyComparator*>(comparator)->user_comparator() ==
+          BytewiseComparator()) {
+    return kInternalKeyTrailerSize;
+  }
+  return boost::none;
+}
+
+std::unique_ptr<RestartKeyPrefixes> BuildRestartKeyPrefixes(
+    const Comparator* comparator, const std::vector<Slice>& restart_keys) {
+  const auto key_suffix_size = BytewiseKeySuffixSize(comparator);
+  if (!key_suffix_size || restart_keys.empty()) {
+    return nullptr;
+  }
+  for (const auto& key : restart_keys) {
+    if (key.size() < *key_suffix_size) {
+      return nullptr;
+    }
+  }
+
+  auto result = std::make_unique<RestartKeyPrefixes>();
+  result->comparator = comparator;
+  result->key_suffix_size = *key_suffix_size;
+  // Keys are ordered, so bytes shared by the first and the last keys are shared by all keys.
+  const Slice first(restart_keys.front().data(), restart_keys.front().size() - *key_suffix_size);
+  const Slice last(restart_keys.back().data(), restart_keys.back().size() - *key_suffix_size);
+  result->shared_prefix.assign(first.cdata(), first.difference_offset(last));
+  result->prefixes.reserve(restart_keys.size());
+  for (const auto& key : restart_keys) {
+    result->prefixes.push_back(NormalizedKeyPrefix(
+        Slice(key.data(), key.size() - *key_suffix_size), result->shared_prefix.size()));
+  }
+  return result;
+}
+
+} // namespace
+
+const RestartKeyPrefixes* Block::GetRestartKeyPrefixes(const Comparator* comparator) {
+  std::call_once(restart_key_prefixes_once_, [this, comparator] {
+    const uint32_t num_restarts = NumRestarts();
+    std::vector<Slice> restart_keys;
+    restart_keys.reserve(num_restarts);
+    for (uint32_t i = 0; i != num_restarts; ++i) {
+      auto key = GetRestartKey(i);
+      if (!key.ok()) {
+        // Corrupted blocks are searched without prefixes, so the error is reported by the seek.
+        return;
+      }
+      restart_keys.push_back(*key);
+    }
+    restart_key_prefixes_ = BuildRestartKeyPrefixes(comparator, restart_keys);
+  });
+  if (restart_key_prefixes_ && restart_key_prefixes_->comparator == comparator) {
+    return restart_key_prefixes_.get();
+  }
+  return nullptr;
+}
+
+void Block::PrepareRestartKeyPrefixes(const Comparator* comparator) {
+  if (FLAGS_rocksdb_block_normalized_key_prefixes && comparator != nullptr) {
+    GetRestartKeyPrefixes(comparator);
+  } else {
+    std::call_once(restart_key_prefixes_once_, [] {});
+  }
+}
+
+size_t Block::RestartKeyPrefixesMemoryUsage() const {
+  if (!restart_key_prefixes_) {
+    return 0;
+  }
+  return sizeof(RestartKeyPrefixes) + restart_key_prefixes_->shared_prefix.capacity() +
+         restart_key_prefixes_->prefixes.capacity() * sizeof(uint64_t);
+}
+
 size_t Block::ApproximateMemoryUsage() const {
   size_t usage = usable_size();
   if (hash_index_) {
@@ -429,6 +680,7 @@ size_t Block::ApproximateMemoryUsage() const {
   if (prefix_index_) {
     usage += prefix_index_->ApproximateMemoryUsage();
   }
+  usage += RestartKeyPrefixesMemoryUsage();
   return usage;
 }
 
@@ -439,16 +691,40 @@ yb::Result<Slice> Block::GetMiddleKey() const {
     return STATUS(Incomplete, "Empty block");
   }
 
-  const auto restart_idx = (NumRestarts() - 1) / 2;
+  return GetRestartKey((NumRestarts() - 1) / 2);
+}
+
+yb::Result<std::vector<Slice>> Block::GetSplitKeys(size_t num_parts) const {
+  if (size_ < kMinBlockSize) {
+    return BadBlockContentsError();
+  }
+  std::vector<Slice> result;
+  if (size_ == kMinBlockSize || num_parts < 2) {
+    return result;
+  }
 
+  const uint32_t num_restarts = NumRestarts();
+  uint32_t prev_restart_idx = 0;
+  for (size_t part = 1; part < num_parts; ++part) {
+    const auto restart_idx = static_cast<uint32_t>(num_restarts * part / num_parts);
+    if (restart_idx == prev_restart_idx) {
+      continue;
+    }
+    result.push_back(VERIFY_RESULT(GetRestartKey(restart_idx)));
+    prev_restart_idx = restart_idx;
+  }
+  return result;
+}
+
+yb::Result<Slice> Block::GetRestartKey(uint32_t restart_idx) const {
   const auto entry_offset = DecodeFixed32(data_ + restart_offset_ + restart_idx * sizeof(uint32_t));
-  uint32_t shared, non_shared, value_length;
-  const char* key_ptr = DecodeEntry(
-      data_ + entry_offset, data_ + restart_offset_, &shared, &non_shared, &value_length);
-  if (key_ptr == nullptr || (shared != 0)) {
+  Slice key;
+  if (DecodeRestartKeyAt(
+          data_ + entry_offset, data_ + restart_offset_, key_value_encoding_format_, &key) ==
+      nullptr) {
     return BadEntryInBlockError();
   }
-  return Slice(key_ptr, non_shared);
+  return key;
 }
 
 }  // namespace rocksdb
@@ -26,12 +26,19 @@
 #pragma once
 #include <stddef.h>
 #include <stdint.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #ifdef ROCKSDB_MALLOC_USABLE_SIZE
 #include <malloc.h>
 #endif
 
 #include "yb/rocksdb/iterator.h"
 #include "yb/rocksdb/options.h"
+#include "yb/rocksdb/table.h"
 #include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
 #include "yb/rocksdb/table/block_hash_index.h"
@@ -45,6 +52,21 @@ class Comparator;
 class BlockIter;
 class BlockHashIndex;
 class BlockPrefixIndex;
+class PersistentCacheFile;
+
+// Fixed-width normalized prefixes of the restart keys of a block, stored in a contiguous array, so
+// restart points could be searched without decoding keys and calling the comparator. Only built
+// for comparators that order keys bytewise, ignoring the key_suffix_size trailing bytes which are
+// compared only when prefixes are equal (the internal key trailer).
+struct RestartKeyPrefixes {
+  // Comparator the prefixes were built for.
+  const Comparator* comparator = nullptr;
+  size_t key_suffix_size = 0;
+  // Bytes shared by all restart keys, they are not included into prefixes.
+  std::string shared_prefix;
+  // Big endian encoded 8 bytes following shared_prefix in each restart key, padded with zeros.
+  std::vector<uint64_t> prefixes;
+};
 
 class Block {
  public:
@@ -64,7 +86,20 @@ class Block {
 #endif  // ROCKSDB_MALLOC_USABLE_SIZE
     return size_;
   }
+
+  // Size charged for the block by the block cache, including restart key prefixes.
+  size_t cache_charge() const {
+    return usable_size() + RestartKeyPrefixesMemoryUsage();
+  }
+
+  // Builds restart key prefixes for the comparator right away when
+  // rocksdb_block_normalized_key_prefixes is set, otherwise they are never built for this block.
+  // Called before the block is charged to a cache, so that the charge includes the prefixes and
+  // does not change while the block is cached.
+  void PrepareRestartKeyPrefixes(const Comparator* comparator);
+
   uint32_t NumRestarts() const;
+  KeyValueEncodingFormat key_value_encoding_format() const { return key_value_encoding_format_; }
   CompressionType compression_type() const {
     return contents_.compression_type;
   }
@@ -88,6 +123,15 @@ class Block {
   void SetBlockHashIndex(BlockHashIndex* hash_index);
   void SetBlockPrefixIndex(BlockPrefixIndex* prefix_index);
 
+  // Persistent cache that should receive the block contents, when the block is evicted from the
+  // block cache while its file is open.
+  const std::shared_ptr<PersistentCacheFile>& persistent_cache() const {
+    return persistent_cache_;
+  }
+  void set_persistent_cache(std::shared_ptr<PersistentCacheFile> persistent_cache) {
+    persistent_cache_ = std::move(persistent_cache);
+  }
+
   // Report an approximation of how much memory has been used.
   size_t ApproximateMemoryUsage() const;
 
@@ -95,13 +139,31 @@ class Block {
   // points description).
   yb::Result<Slice> GetMiddleKey() const;
 
+  // Returns restart keys from this block, which divide it into num_parts parts with roughly the
+  // same number of restart points. Fewer keys are returned when the block does not have enough
+  // restart points.
+  yb::Result<std::vector<Slice>> GetSplitKeys(size_t num_parts) const;
+
  private:
+  yb::Result<Slice> GetRestartKey(uint32_t restart_idx) const;
+
+  // Returns restart key prefixes for the comparator, building them on first use. Returns nullptr
+  // if the comparator does not order keys bytewise.
+  const RestartKeyPrefixes* GetRestartKeyPrefixes(const Comparator* comparator);
+
+  size_t RestartKeyPrefixesMemoryUsage() const;
+
   BlockContents contents_;
   const char* data_;            // contents_.data.data()
   size_t size_;                 // contents_.data.size()
   uint32_t restart_offset_;     // Offset in data_ of restart array
+  KeyValueEncodingFormat key_value_encoding_format_ =
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
   std::unique_ptr<BlockHashIndex> hash_index_;
   std::unique_ptr<BlockPrefixIndex> prefix_index_;
+  std::shared_ptr<PersistentCacheFile> persistent_cache_;
+  std::once_flag restart_key_prefixes_once_;
+  std::unique_ptr<RestartKeyPrefixes> restart_key_prefixes_;
 
   // No copying allowed
   Block(const Block&);
@@ -123,20 +185,30 @@ class BlockIter : public InternalIterator {
 
   BlockIter(const Comparator* comparator, const char* data, uint32_t restarts,
        uint32_t num_restarts, BlockHashIndex* hash_index,
-       BlockPrefixIndex* prefix_index)
+       BlockPrefixIndex* prefix_index,
+       KeyValueEncodingFormat key_value_encoding_format =
+           KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix)
       : BlockIter() {
     Initialize(comparator, data, restarts, num_restarts,
-        hash_index, prefix_index);
+        hash_index, prefix_index, key_value_encoding_format);
   }
 
   void Initialize(const Comparator* comparator, const char* data,
       uint32_t restarts, uint32_t num_restarts, BlockHashIndex* hash_index,
-      BlockPrefixIndex* prefix_index);
+      BlockPrefixIndex* prefix_index,
+      KeyValueEncodingFormat key_value_encoding_format =
+          KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix);
 
   void SetStatus(Status s) {
     status_ = s;
   }
 
+  // Makes Seek search restart points using the prefixes, they should be built for the comparator
+  // of this iterator.
+  void SetRestartKeyPrefixes(const RestartKeyPrefixes* restart_key_prefixes) {
+    restart_key_prefixes_ = restart_key_prefixes;
+  }
+
   virtual bool Valid() const override { return current_ < restarts_; }
   virtual Status status() const override { return status_; }
   virtual Slice key() const override {
@@ -184,6 +256,11 @@ class BlockIter : public InternalIterator {
   Status status_;
   BlockHashIndex* hash_index_;
   BlockPrefixIndex* prefix_index_;
+  KeyValueEncodingFormat key_value_encoding_format_ =
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
+  // Used to assemble keys that share a middle part with the previous key.
+  std::string key_buffer_;
+  const RestartKeyPrefixes* restart_key_prefixes_ = nullptr;
 
   inline int Compare(const Slice& a, const Slice& b) const {
     return comparator_->Compare(a, b);
@@ -214,9 +291,16 @@ class BlockIter : public InternalIterator {
 
   bool ParseNextKey();
 
+  // Returns the key stored at the given restart point, or nullptr on corruption.
+  const char* DecodeRestartKey(uint32_t restart_index, Slice* key);
+
   bool BinarySeek(const Slice& target, uint32_t left, uint32_t right,
                   uint32_t* index);
 
+  // The same as BinarySeek over all restart points, but compares full keys only for restart
+  // points whose prefix is equal to the prefix of target.
+  bool NormalizedPrefixSeek(const Slice& target, uint32_t* index);
+
   int CompareBlockKey(uint32_t block_index, const Slice& target);
 
   bool BinaryBlockIndexSeek(const Slice& target, uint32_t* block_ids,
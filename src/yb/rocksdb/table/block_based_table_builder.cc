@@ -27,8 +27,12 @@
 #include <inttypes.h>
 #include <stdio.h>
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -61,8 +65,10 @@
 #include "yb/rocksdb/util/stop_watch.h"
 #include "yb/rocksdb/util/xxhash.h"
 
+#include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/string_util.h"
+#include "yb/util/threadpool.h"
 
 #include "yb/gutil/macros.h"
 
@@ -110,7 +116,8 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
-                    std::string* compressed_output) {
+                    std::string* compressed_output,
+                    const CompressionDict* compression_dict) {
   if (*type == kNoCompression) {
     return raw;
   }
@@ -163,7 +170,7 @@ Slice CompressBlock(const Slice& raw,
       break;     // fall back to no compression.
     case kZSTDNotFinalCompression:
       if (ZSTD_Compress(compression_options, raw.cdata(), raw.size(),
-                        compressed_output) &&
+                        compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -177,6 +184,135 @@ Slice CompressBlock(const Slice& raw,
   return raw;
 }
 
+// Data block, that was finished but is not written to the file yet.
+struct PendingDataBlock {
+  std::string contents;
+  std::string last_key;
+  std::string next_block_first_key;
+
+  // Filled by ParallelBlockCompressor.
+  std::string compressed_output;
+  CompressionType type = kNoCompression;
+  bool compressed = false;
+};
+
+// Compresses data blocks on a thread pool shared by all table builders, using at most
+// max_workers tasks of the pool at a time. Blocks are returned in the order they were added, so
+// the thread that builds the table writes them and updates the index as before.
+class ParallelBlockCompressor {
+ public:
+  typedef std::function<void(PendingDataBlock*)> CompressFunction;
+
+  ParallelBlockCompressor(
+      yb::ThreadPool* thread_pool, size_t max_workers, CompressFunction compress)
+      : thread_pool_(thread_pool), max_workers_(max_workers), compress_(std::move(compress)) {
+  }
+
+  ~ParallelBlockCompressor() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Workers only finish compressing the blocks they picked up, so the remaining ones are not
+    // compressed at all.
+    queue_.clear();
+    workers_done_cond_.wait(lock, [this] { return num_workers_ == 0; });
+  }
+
+  ParallelBlockCompressor(const ParallelBlockCompressor&) = delete;
+  void operator=(const ParallelBlockCompressor&) = delete;
+
+  void Add(std::unique_ptr<PendingDataBlock> block) {
+    raw_size_ += block->contents.size();
+    auto* block_ptr = block.get();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      blocks_.push_back(std::move(block));
+      queue_.push_back(block_ptr);
+      if (num_workers_ >= max_workers_) {
+        return;
+      }
+      ++num_workers_;
+    }
+    auto status = thread_pool_->SubmitFunc(std::bind(&ParallelBlockCompressor::Run, this));
+    if (!status.ok()) {
+      // The pool is shutting down, so the block is compressed by the thread that builds the table.
+      YB_LOG_EVERY_N_SECS(WARNING, 10) << "Failed to submit block compression: " << status;
+      std::unique_lock<std::mutex> lock(mutex_);
+      --num_workers_;
+      CompressQueued(&lock);
+      workers_done_cond_.notify_all();
+    }
+  }
+
+  // Returns the oldest block if it is compressed, waiting for it when wait is true.
+  // Returns nullptr if there are no blocks, or the oldest one is not compressed yet and wait is
+  // false.
+  std::unique_ptr<PendingDataBlock> Pop(bool wait) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (blocks_.empty() || (!wait && !blocks_.front()->compressed)) {
+      return nullptr;
+    }
+    compressed_cond_.wait(lock, [this] { return blocks_.front()->compressed; });
+    auto result = std::move(blocks_.front());
+    blocks_.pop_front();
+    lock.unlock();
+    raw_size_ -= result->contents.size();
+    return result;
+  }
+
+  // Number of blocks, that were added but not popped yet.
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return blocks_.size();
+  }
+
+  // Total uncompressed size of the blocks, that were added but not popped yet.
+  size_t raw_size() const {
+    return raw_size_;
+  }
+
+  size_t max_workers() const { return max_workers_; }
+
+ private:
+  // Task of the thread pool, that compresses queued blocks until there are none left.
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    CompressQueued(&lock);
+    // The worker is unregistered under the same lock as it saw the empty queue, so a block added
+    // after that submits a new task. The destructor could proceed right after the notification.
+    --num_workers_;
+    workers_done_cond_.notify_all();
+  }
+
+  void CompressQueued(std::unique_lock<std::mutex>* lock) {
+    while (!queue_.empty()) {
+      auto* block = queue_.front();
+      queue_.pop_front();
+      lock->unlock();
+      compress_(block);
+      lock->lock();
+      block->compressed = true;
+      // Only the thread that builds the table waits for compressed blocks.
+      compressed_cond_.notify_one();
+    }
+  }
+
+  yb::ThreadPool* const thread_pool_;
+  const size_t max_workers_;
+  const CompressFunction compress_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable compressed_cond_;
+  std::condition_variable workers_done_cond_;
+  // Number of submitted tasks, that did not finish yet.
+  size_t num_workers_ = 0;
+  // All blocks that were not popped yet, in the order they were added.
+  std::deque<std::unique_ptr<PendingDataBlock>> blocks_;
+  // Blocks that are not picked up by workers yet.
+  std::deque<PendingDataBlock*> queue_;
+  // Only accessed by the thread that builds the table, so it is read for each added key without
+  // locking mutex_.
+  size_t raw_size_ = 0;
+};
+
 }  // namespace
 
 // kBlockBasedTableMagicNumber was picked by running
@@ -303,6 +439,18 @@ struct BlockBasedTableBuilder::Rep {
 
   yb::MemTrackerPtr mem_tracker;
 
+  // Whether data blocks are buffered for dictionary training. Buffered blocks are kept
+  // uncompressed as training samples until the dictionary is ready.
+  bool buffer_data_blocks = false;
+  size_t dict_train_bytes = 0;
+  std::vector<PendingDataBlock> buffered_data_blocks;
+  size_t buffered_data_size = 0;
+  std::unique_ptr<CompressionDict> compression_dict;
+
+  // Set when data blocks are compressed by worker threads. Declared after compression_dict, since
+  // worker threads use it.
+  std::unique_ptr<ParallelBlockCompressor> parallel_compressor;
+
   Rep(const ImmutableCFOptions& _ioptions,
       const BlockBasedTableOptions& table_opt,
       const InternalKeyComparatorPtr& icomparator,
@@ -315,6 +463,22 @@ struct BlockBasedTableBuilder::Rep {
       const bool skip_filters);
 
   bool is_split_sst() const { return data_writer != metadata_writer; }
+
+  // Data block offsets are not known until the block is written, so writing of data blocks can't
+  // be deferred with the filter and index types that need offsets or block numbers as keys are
+  // added.
+  bool can_defer_data_blocks() const {
+    return filter_type != FilterType::kBlockBasedFilter &&
+           table_options.index_type != IndexType::kHashSearch;
+  }
+
+  // Offset in the data file after all data blocks flushed so far, accounting blocks that are
+  // buffered or being compressed uncompressed, as TotalFileSize does. Equals data_writer->offset
+  // when data blocks are not deferred.
+  uint64_t logical_data_offset() const {
+    return data_writer->offset + buffered_data_size +
+           (parallel_compressor ? parallel_compressor->raw_size() : 0);
+  }
 };
 
 Status BlockBasedTableBuilder::BlockBasedTablePropertiesCollector::Finish(
@@ -352,7 +516,8 @@ BlockBasedTableBuilder::Rep::Rep(
       filter_block_builder(skip_filters ? nullptr : CreateFilterBlockBuilder(
           _ioptions, table_options, filter_type)),
       data_block_builder(table_options.block_restart_interval,
-                 table_options.use_delta_encoding),
+                 table_options.use_delta_encoding,
+                 table_options.data_block_key_value_encoding_format),
       internal_prefix_transform(_ioptions.prefix_extractor),
       filter_key_transformer(table_opt.filter_policy ?
           table_opt.filter_policy->GetKeyTransformer() : nullptr),
@@ -392,6 +557,14 @@ BlockBasedTableBuilder::Rep::Rep(
       new BlockBasedTablePropertiesCollector(
           this, table_options.index_type, table_options.whole_key_filtering,
           _ioptions.prefix_extractor != nullptr));
+
+  if (compression_type == kZSTDNotFinalCompression && compression_opts.max_dict_bytes > 0 &&
+      ZSTD_DictSupported() && can_defer_data_blocks()) {
+    buffer_data_blocks = true;
+    dict_train_bytes = compression_opts.zstd_max_train_bytes > 0
+        ? compression_opts.zstd_max_train_bytes
+        : 100 * static_cast<size_t>(compression_opts.max_dict_bytes);
+  }
 }
 
 BlockBasedTableBuilder::BlockBasedTableBuilder(
@@ -433,6 +606,17 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
           &rep_->metadata_writer->compressed_cache_key_prefix);
     }
   }
+
+  if (rep_->compression_type != kNoCompression && compression_opts.parallel_threads > 1 &&
+      compression_opts.thread_pool && rep_->can_defer_data_blocks()) {
+    rep_->parallel_compressor = std::make_unique<ParallelBlockCompressor>(
+        compression_opts.thread_pool, compression_opts.parallel_threads,
+        [this](PendingDataBlock* block) {
+          block->type = rep_->compression_type;
+          CompressBlockContents(block->contents, rep_->compression_dict.get(), &block->type,
+                                &block->compressed_output);
+        });
+  }
 }
 
 BlockBasedTableBuilder::~BlockBasedTableBuilder() {
@@ -478,7 +662,9 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
 
   r->data_index_builder->OnKeyAdded(key);
 
-  NotifyCollectTableCollectorsOnAdd(key, value, r->data_writer->offset,
+  // Data blocks could be buffered or being compressed, so data_writer->offset could lag behind
+  // the data added so far.
+  NotifyCollectTableCollectorsOnAdd(key, value, r->logical_data_offset(),
       r->table_properties_collectors,
       r->ioptions.info_log);
 }
@@ -487,10 +673,83 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   Rep* const r = rep_;
   assert(!r->closed);
   if (!ok()) return;
-  size_t data_block_size = 0;
 
+  if (r->buffer_data_blocks) {
+    if (!r->data_block_builder.empty()) {
+      const Slice contents = r->data_block_builder.Finish();
+      r->buffered_data_size += contents.size();
+      r->buffered_data_blocks.emplace_back();
+      auto& block = r->buffered_data_blocks.back();
+      block.contents = contents.ToBuffer();
+      block.last_key = r->last_key;
+      block.next_block_first_key = next_block_first_key.ToBuffer();
+      r->data_block_builder.Reset();
+    }
+    if (r->buffered_data_size >= r->dict_train_bytes) {
+      EnterUnbuffered();
+    }
+    return;
+  }
+
+  if (r->parallel_compressor) {
+    if (!r->data_block_builder.empty()) {
+      auto block = std::make_unique<PendingDataBlock>();
+      block->contents = r->data_block_builder.Finish().ToBuffer();
+      block->last_key = r->last_key;
+      block->next_block_first_key = next_block_first_key.ToBuffer();
+      r->parallel_compressor->Add(std::move(block));
+      r->data_block_builder.Reset();
+    }
+    WriteCompressedDataBlocks(/* wait_all= */ false);
+    return;
+  }
+
+  Slice raw_block_contents;
   if (!r->data_block_builder.empty()) {
-    data_block_size = WriteBlock(&r->data_block_builder, &r->data_pending_handle,
+    raw_block_contents = r->data_block_builder.Finish();
+  }
+  WriteDataBlock(raw_block_contents, &r->last_key, next_block_first_key);
+  r->data_block_builder.Reset();
+}
+
+void BlockBasedTableBuilder::WriteDataBlock(
+    const Slice& raw_block_contents, std::string* last_key, const Slice& next_block_first_key) {
+  Rep* const r = rep_;
+  auto type = r->compression_type;
+  Slice block_contents;
+  if (!raw_block_contents.empty()) {
+    block_contents = CompressBlockContents(
+        raw_block_contents, r->compression_dict.get(), &type, &r->compressed_output);
+  }
+  WriteCompressedDataBlock(block_contents, type, last_key, next_block_first_key);
+  r->compressed_output.clear();
+}
+
+void BlockBasedTableBuilder::WriteCompressedDataBlocks(bool wait_all) {
+  Rep* const r = rep_;
+  // Limit the number of blocks in flight, so the memory used by them stays bounded.
+  const size_t max_blocks_in_flight = 2 * r->parallel_compressor->max_workers();
+  while (ok()) {
+    const size_t blocks_in_flight = r->parallel_compressor->size();
+    auto block = r->parallel_compressor->Pop(
+        wait_all ? blocks_in_flight > 0 : blocks_in_flight > max_blocks_in_flight);
+    if (!block) {
+      break;
+    }
+    WriteCompressedDataBlock(
+        block->type == kNoCompression ? block->contents : block->compressed_output, block->type,
+        &block->last_key, block->next_block_first_key);
+  }
+}
+
+void BlockBasedTableBuilder::WriteCompressedDataBlock(
+    const Slice& block_contents, CompressionType type, std::string* last_key,
+    const Slice& next_block_first_key) {
+  Rep* const r = rep_;
+  size_t data_block_size = 0;
+
+  if (!block_contents.empty()) {
+    data_block_size = WriteRawBlock(block_contents, type, &r->data_pending_handle,
         r->data_writer.get());
   }
   if (!ok()) return;
@@ -502,7 +761,10 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
 
   if (r->filter_block_builder != nullptr && r->filter_type == FilterType::kBlockBasedFilter) {
     // For FilterType::kBlockBasedFilter separate block of bloom filter is written per data block.
-    r->filter_block_builder->StartBlock(r->data_writer->offset);
+    // Filter blocks are keyed by the offset of the next data block, so data blocks are written
+    // right away with this filter type, see can_defer_data_blocks.
+    DCHECK_EQ(r->logical_data_offset(), r->data_writer->offset);
+    r->filter_block_builder->StartBlock(r->logical_data_offset());
   }
 
   r->props.data_size += data_block_size;
@@ -515,7 +777,7 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   // "the r" as the key for the index block entry since it is >= all
   // entries in the first block and < all entries in subsequent
   // blocks.
-  r->data_index_builder->AddIndexEntry(&r->last_key,
+  r->data_index_builder->AddIndexEntry(last_key,
       next_block_first_key.empty() ? nullptr : &next_block_first_key,
       r->data_pending_handle);
   while (r->data_index_builder->ShouldFlush()) {
@@ -534,6 +796,44 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   }
 }
 
+void BlockBasedTableBuilder::EnterUnbuffered() {
+  Rep* const r = rep_;
+  r->buffer_data_blocks = false;
+
+  std::string samples;
+  std::vector<size_t> sample_lens;
+  samples.reserve(std::min(r->buffered_data_size, r->dict_train_bytes));
+  sample_lens.reserve(r->buffered_data_blocks.size());
+  for (const auto& block : r->buffered_data_blocks) {
+    if (samples.size() + block.contents.size() > r->dict_train_bytes && !samples.empty()) {
+      break;
+    }
+    samples.append(block.contents);
+    sample_lens.push_back(block.contents.size());
+  }
+  auto dict = ZSTD_TrainDictionary(samples, sample_lens, r->compression_opts.max_dict_bytes);
+  if (!dict.empty()) {
+    r->compression_dict = std::make_unique<CompressionDict>(
+        std::move(dict), r->compression_opts.level);
+  } else {
+    RLOG(InfoLogLevel::INFO_LEVEL, r->ioptions.info_log,
+        "Failed to train compression dictionary from %zu samples of total size %zu",
+        sample_lens.size(), samples.size());
+  }
+
+  for (auto& block : r->buffered_data_blocks) {
+    if (r->parallel_compressor) {
+      r->parallel_compressor->Add(std::make_unique<PendingDataBlock>(std::move(block)));
+      WriteCompressedDataBlocks(/* wait_all= */ false);
+    } else {
+      WriteDataBlock(block.contents, &block.last_key, block.next_block_first_key);
+    }
+    if (!ok()) break;
+  }
+  r->buffered_data_blocks.clear();
+  r->buffered_data_size = 0;
+}
+
 void BlockBasedTableBuilder::FlushFilterBlock(const Slice* const next_block_first_filter_key) {
   Rep* const r = rep_;
   assert(!r->closed);
@@ -572,7 +872,8 @@ size_t BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
 
 size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
                                           BlockHandle* handle,
-                                          FileWriterWithOffsetAndCachePrefix* writer_info) {
+                                          FileWriterWithOffsetAndCachePrefix* writer_info,
+                                          const CompressionDict* compression_dict) {
   // File format contains a sequence of blocks where each block has:
   //    block_data: uint8[n]
   //    type: uint8
@@ -581,21 +882,26 @@ size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   Rep* r = rep_;
 
   auto type = r->compression_type;
-  Slice block_contents;
-  if (raw_block_contents.size() < kCompressionSizeLimit) {
-    block_contents =
-        CompressBlock(raw_block_contents, r->compression_opts, &type,
-                      r->table_options.format_version, &r->compressed_output);
-  } else {
-    RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
-    type = kNoCompression;
-    block_contents = raw_block_contents;
-  }
+  const Slice block_contents = CompressBlockContents(
+      raw_block_contents, compression_dict, &type, &r->compressed_output);
   size_t block_size = WriteRawBlock(block_contents, type, handle, writer_info);
   r->compressed_output.clear();
   return block_size;
 }
 
+Slice BlockBasedTableBuilder::CompressBlockContents(
+    const Slice& raw_block_contents, const CompressionDict* compression_dict,
+    CompressionType* type, std::string* compressed_output) const {
+  const Rep* r = rep_;
+  if (raw_block_contents.size() >= kCompressionSizeLimit) {
+    RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
+    *type = kNoCompression;
+    return raw_block_contents;
+  }
+  return CompressBlock(raw_block_contents, r->compression_opts, type,
+                       r->table_options.format_version, compressed_output, compression_dict);
+}
+
 size_t BlockBasedTableBuilder::WriteRawBlock(const Slice& block_contents,
                                              CompressionType type,
                                              BlockHandle* handle,
@@ -706,6 +1012,13 @@ Status BlockBasedTableBuilder::Finish() {
   if (!r->data_block_builder.empty()) {
     FlushDataBlock(end_slice);  // no more data block
   }
+  if (r->buffer_data_blocks) {
+    EnterUnbuffered();
+  }
+  if (r->parallel_compressor) {
+    WriteCompressedDataBlocks(/* wait_all= */ true);
+    r->parallel_compressor.reset();
+  }
   if (r->filter_block_builder != nullptr) {
     FlushFilterBlock(nullptr);  // no more filter block
   }
@@ -722,8 +1035,9 @@ Status BlockBasedTableBuilder::Finish() {
   // Write meta blocks and metaindex block with the following order.
   //    1. [meta block: filter]
   //    2. [other meta blocks]
-  //    3. [meta block: properties]
-  //    4. [metaindex block]
+  //    3. [meta block: compression dictionary]
+  //    4. [meta block: properties]
+  //    5. [metaindex block]
   // write meta blocks
   MetaIndexBuilder meta_index_builder;
   for (const auto& item : r->data_index_blocks.meta_blocks) {
@@ -770,6 +1084,15 @@ Status BlockBasedTableBuilder::Finish() {
       }
     }
 
+    // Write compression dictionary block.
+    if (r->compression_dict) {
+      BlockHandle compression_dict_block_handle;
+      WriteRawBlock(r->compression_dict->raw(), kNoCompression, &compression_dict_block_handle,
+          r->metadata_writer.get());
+      meta_index_builder.Add(
+          block_based_table::kCompressionDictBlock, compression_dict_block_handle);
+    }
+
     // Write properties block.
     {
       PropertyBlockBuilder property_block_builder;
@@ -847,6 +1170,8 @@ void BlockBasedTableBuilder::Abandon() {
   Rep* r = rep_;
   assert(!r->closed);
   r->closed = true;
+  r->parallel_compressor.reset();
+  r->buffered_data_blocks.clear();
 }
 
 uint64_t BlockBasedTableBuilder::NumEntries() const {
@@ -854,8 +1179,8 @@ uint64_t BlockBasedTableBuilder::NumEntries() const {
 }
 
 uint64_t BlockBasedTableBuilder::TotalFileSize() const {
-  return rep_->is_split_sst() ? rep_->metadata_writer->offset + rep_->data_writer->offset :
-      rep_->metadata_writer->offset;
+  // Buffered data blocks and blocks being compressed are accounted uncompressed.
+  return (rep_->is_split_sst() ? rep_->metadata_writer->offset : 0) + rep_->logical_data_offset();
 }
 
 uint64_t BlockBasedTableBuilder::BaseFileSize() const {
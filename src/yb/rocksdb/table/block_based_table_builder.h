@@ -39,6 +39,7 @@ namespace rocksdb {
 
 class BlockBuilder;
 class BlockHandle;
+class CompressionDict;
 class WritableFile;
 struct BlockBasedTableOptions;
 
@@ -112,9 +113,15 @@ class BlockBasedTableBuilder : public TableBuilder {
       FileWriterWithOffsetAndCachePrefix* writer_info);
   // Directly write block content to the file. Returns number of bytes written to file.
   size_t WriteBlock(const Slice& block_contents, BlockHandle* handle,
-      FileWriterWithOffsetAndCachePrefix* writer_info);
+      FileWriterWithOffsetAndCachePrefix* writer_info,
+      const CompressionDict* compression_dict = nullptr);
   size_t WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle,
       FileWriterWithOffsetAndCachePrefix* writer_info);
+  // Compresses block contents with the table compression type. Returns either compressed_output
+  // or raw_block_contents, when the block is not compressed. Could be called concurrently.
+  Slice CompressBlockContents(const Slice& raw_block_contents,
+      const CompressionDict* compression_dict, CompressionType* type,
+      std::string* compressed_output) const;
   Status InsertBlockInCache(const Slice& block_contents,
                             const CompressionType type,
                             const BlockHandle* handle,
@@ -130,6 +137,22 @@ class BlockBasedTableBuilder : public TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called.
   void FlushDataBlock(const Slice& next_block_first_key);
 
+  // Write data block and add it to the data index. last_key is the last key of the block and
+  // could be shortened by the index builder.
+  void WriteDataBlock(const Slice& raw_block_contents, std::string* last_key,
+                      const Slice& next_block_first_key);
+
+  // Same as WriteDataBlock, but for the block that is already compressed with specified type.
+  void WriteCompressedDataBlock(const Slice& block_contents, CompressionType type,
+                                std::string* last_key, const Slice& next_block_first_key);
+
+  // Writes data blocks compressed by worker threads. When wait_all is false, waits only while
+  // too many blocks are in flight.
+  void WriteCompressedDataBlocks(bool wait_all);
+
+  // Train the compression dictionary on the buffered data blocks, and write them.
+  void EnterUnbuffered();
+
   // Flush the current filter block into disk. next_block_first_filter_key should be nullptr if this
   // is the last block written to disk.
   // REQUIRES: Finish(), Abandon() have not been called.
@@ -201,6 +201,11 @@ std::shared_ptr<TableAwareReadFileFilter> BlockBasedTableFactory::NewTableAwareR
   return std::make_shared<BloomFilterAwareFileFilter>(read_options, user_key);
 }
 
+const FilterPolicy::KeyTransformer* BlockBasedTableFactory::GetFilterKeyTransformer() const {
+  return table_options_.filter_policy ? table_options_.filter_policy->GetKeyTransformer()
+                                      : nullptr;
+}
+
 TableFactory* NewBlockBasedTableFactory(
     const BlockBasedTableOptions& _table_options) {
   return new BlockBasedTableFactory(_table_options);
@@ -25,6 +25,7 @@ namespace block_based_table {
 constexpr char kFilterBlockPrefix[] = "filter.";
 constexpr char kFullFilterBlockPrefix[] = "fullfilter.";
 constexpr char kFixedSizeFilterBlockPrefix[] = "fixedsizefilter.";
+constexpr char kCompressionDictBlock[] = "rocksdb.compression_dict";
 
 // Read the block identified by "handle" from "file".
 // The only relevant option is options.verify_checksums for now.
@@ -34,10 +35,11 @@ inline CHECKED_STATUS ReadBlockFromFile(
     RandomAccessFileReader* file, const Footer& footer, const ReadOptions& options,
     const BlockHandle& handle, std::unique_ptr<Block>* result, Env* env,
     const std::shared_ptr<yb::MemTracker>& mem_tracker,
-    bool do_uncompress = true) {
+    bool do_uncompress = true,
+    const UncompressionDict* compression_dict = nullptr) {
   BlockContents contents;
   Status s = ReadBlockContents(file, footer, options, handle, &contents, env,
-                               mem_tracker, do_uncompress);
+                               mem_tracker, do_uncompress, compression_dict);
   if (s.ok()) {
     result->reset(new Block(std::move(contents)));
   }
@@ -68,7 +70,9 @@ inline Slice GetCacheKey(const CacheKeyPrefixBuffer& cache_key_prefix, const Blo
 }
 
 // Generate a cache key prefix from the file. Used for both data and metadata files.
-inline void GenerateCachePrefix(
+// Returns true if the prefix was generated from the unique id of the file, so it does not change
+// across restarts.
+inline bool GenerateCachePrefix(
     Cache* cc, yb::FileWithUniqueId* file, CacheKeyPrefixBuffer* prefix) {
   // generate an id from the file
   prefix->size = file->GetUniqueId(prefix->data);
@@ -78,7 +82,9 @@ inline void GenerateCachePrefix(
   if (prefix->size == 0) {
     char* end = EncodeVarint64(prefix->data, cc->NewId());
     prefix->size = static_cast<size_t>(end - prefix->data);
+    return false;
   }
+  return true;
 }
 
 } // namespace block_based_table
@@ -23,6 +23,8 @@
 
 #include "yb/rocksdb/table/block_based_table_reader.h"
 
+#include <algorithm>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <cinttypes>
@@ -34,7 +36,9 @@
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/filter_policy.h"
 #include "yb/rocksdb/iterator.h"
+#include "yb/rocksdb/metadata.h"
 #include "yb/rocksdb/options.h"
+#include "yb/rocksdb/persistent_cache.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/table_properties.h"
@@ -56,6 +60,7 @@
 #include "yb/rocksdb/table/two_level_iterator.h"
 
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/compression.h"
 #include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/perf_context_imp.h"
 #include "yb/rocksdb/util/stop_watch.h"
@@ -92,6 +97,32 @@ void DeleteCachedEntry(const Slice& key, void* value) {
   delete entry;
 }
 
+// Delete the block evicted from the block cache. While its file is open, the block is stored in
+// the persistent cache first.
+void DeleteCachedBlock(const Slice& key, void* value) {
+  auto block = reinterpret_cast<Block*>(value);
+  if (block->persistent_cache() && block->compression_type() == kNoCompression) {
+    auto* spill_cache = block->persistent_cache()->spill_cache();
+    if (spill_cache) {
+      spill_cache->Insert(key, Slice(block->data(), block->size()));
+    }
+  }
+  delete block;
+}
+
+// Read the uncompressed block stored in the persistent cache. Returns nullptr if it is not there.
+std::unique_ptr<Block> GetBlockFromPersistentCache(
+    PersistentCache* persistent_cache, const Slice& key,
+    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+  std::unique_ptr<char[]> data;
+  size_t size = 0;
+  if (!persistent_cache->Lookup(key, &data, &size).ok()) {
+    return nullptr;
+  }
+  return std::make_unique<Block>(BlockContents(
+      std::move(data), size, true /* cachable */, kNoCompression, mem_tracker));
+}
+
 // Release the cached entry and decrement its ref count.
 void ReleaseCachedEntry(void* arg, void* h) {
   Cache* cache = reinterpret_cast<Cache*>(arg);
@@ -149,8 +180,19 @@ struct BlockBasedTable::FileReaderWithCachePrefix {
   // Similar prefix, but for compressed blocks cache:
   block_based_table::CacheKeyPrefixBuffer compressed_cache_key_prefix;
 
+  // Uncompressed blocks of the file are stored in the persistent cache, with block cache keys.
+  // Enabled only when cache_key_prefix is derived from the file unique id, so these keys remain
+  // valid after restart.
+  std::shared_ptr<PersistentCacheFile> persistent_cache;
+
   explicit FileReaderWithCachePrefix(unique_ptr<RandomAccessFileReader>&& _reader) :
       reader(std::move(_reader)) {}
+
+  ~FileReaderWithCachePrefix() {
+    if (persistent_cache) {
+      persistent_cache->Close();
+    }
+  }
 };
 
 // CachableEntry represents the entries that *may* be fetched from block cache.
@@ -240,11 +282,30 @@ struct BlockBasedTable::Rep {
 
   DataIndexLoadMode data_index_load_mode = static_cast<DataIndexLoadMode>(0);
   yb::MemTrackerPtr mem_tracker;
+
+  // Digested dictionary for data blocks, if they were compressed with dictionary.
+  std::unique_ptr<UncompressionDict> compression_dict;
+
+  // Set by the first call to GetCachedDataBlocks, that walks the whole data index. After that,
+  // data blocks inserted into the block cache are tracked, so following calls only check blocks
+  // found by the previous call and blocks inserted since then.
+  std::atomic<bool> track_cached_data_blocks{false};
+  // Protects the fields below.
+  std::mutex cached_data_blocks_mutex;
+  // Data blocks found in the block cache by the previous call to GetCachedDataBlocks.
+  std::vector<DataBlockLocation> cached_data_blocks;
+  // Data blocks inserted into the block cache since the previous call to GetCachedDataBlocks.
+  std::vector<DataBlockLocation> inserted_data_blocks;
+  // Set when more than max_inserted_data_blocks were inserted, so the next call to
+  // GetCachedDataBlocks walks the whole data index again.
+  bool inserted_data_blocks_overflow = false;
+  size_t max_inserted_data_blocks = 0;
 };
 
-// BlockEntryIteratorState doesn't actually store any iterator state and is only used as an adapter
-// to BlockBasedTable. It is used by TwoLevelIterator and MultiLevelIterator to call BlockBasedTable
-// functions in order to check if prefix may match or to create a secondary iterator.
+// BlockEntryIteratorState is mostly an adapter to BlockBasedTable. It is used by TwoLevelIterator
+// and MultiLevelIterator to call BlockBasedTable functions in order to check if prefix may match or
+// to create a secondary iterator. The only iterator state it keeps is for readahead of sequentially
+// read data blocks.
 class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
  public:
   BlockEntryIteratorState(
@@ -257,6 +318,10 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
         block_type_(block_type) {}
 
   InternalIterator* NewSecondaryIterator(const Slice& index_value) override {
+    if (block_type_ == BlockType::kData &&
+        table_->rep_->table_options.max_scan_readahead_size != 0) {
+      MaybeReadahead(index_value);
+    }
     return table_->NewDataBlockIterator(read_options_, index_value, block_type_);
   }
 
@@ -268,6 +333,40 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   }
 
  private:
+  // Starts readahead after kMinSequentialReads data blocks are read one after another, so point
+  // reads and short scans do not read unneeded data.
+  static constexpr int kMinSequentialReads = 2;
+  static constexpr size_t kInitialReadaheadSize = 64 * 1024;
+
+  void MaybeReadahead(const Slice& index_value) {
+    BlockHandle handle;
+    Slice input = index_value;
+    if (!handle.DecodeFrom(&input).ok()) {
+      return;
+    }
+    const uint64_t block_end = handle.offset() + handle.size() + kBlockTrailerSize;
+    if (handle.offset() != next_block_offset_) {
+      // Seek or backward scan, start over.
+      num_sequential_reads_ = 0;
+      readahead_size_ = 0;
+      readahead_limit_ = 0;
+    } else if (++num_sequential_reads_ >= kMinSequentialReads &&
+               block_end + readahead_size_ / 2 >= readahead_limit_) {
+      // Read ahead once half of the previous readahead is consumed, so the next part is read
+      // before the iterator reaches it.
+      const size_t max_size = table_->rep_->table_options.max_scan_readahead_size;
+      readahead_size_ = std::min(
+          readahead_size_ ? readahead_size_ * 2 : kInitialReadaheadSize, max_size);
+      const uint64_t start = std::max(readahead_limit_, block_end);
+      readahead_limit_ = block_end + readahead_size_;
+      if (readahead_limit_ > start) {
+        table_->GetBlockReader(BlockType::kData)->reader->Prefetch(
+            start, readahead_limit_ - start);
+      }
+    }
+    next_block_offset_ = block_end;
+  }
+
   // Don't own table_. BlockEntryIteratorState should only be stored in iterators or in
   // corresponding BlockBasedTable. TableReader (superclass of BlockBasedTable) is only destroyed
   // after iterator is deleted.
@@ -275,6 +374,11 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   const ReadOptions read_options_;
   const bool skip_filters_;
   const BlockType block_type_;
+
+  uint64_t next_block_offset_ = 0;
+  int num_sequential_reads_ = 0;
+  size_t readahead_size_ = 0;
+  uint64_t readahead_limit_ = 0;
 };
 
 
@@ -300,10 +404,18 @@ void BlockBasedTable::SetupCacheKeyPrefix(Rep* rep,
     FileReaderWithCachePrefix* reader_with_cache_prefix) {
   reader_with_cache_prefix->cache_key_prefix.size = 0;
   reader_with_cache_prefix->compressed_cache_key_prefix.size = 0;
+  if (reader_with_cache_prefix->persistent_cache) {
+    reader_with_cache_prefix->persistent_cache->Close();
+    reader_with_cache_prefix->persistent_cache = nullptr;
+  }
   if (rep->table_options.block_cache != nullptr) {
-    GenerateCachePrefix(rep->table_options.block_cache.get(),
-        reader_with_cache_prefix->reader->file(),
+    const bool prefix_from_unique_id = GenerateCachePrefix(
+        rep->table_options.block_cache.get(), reader_with_cache_prefix->reader->file(),
         &reader_with_cache_prefix->cache_key_prefix);
+    if (prefix_from_unique_id && rep->table_options.persistent_cache) {
+      reader_with_cache_prefix->persistent_cache =
+          std::make_shared<PersistentCacheFile>(rep->table_options.persistent_cache);
+    }
   }
   if (rep->table_options.block_cache_compressed != nullptr) {
     GenerateCachePrefix(rep->table_options.block_cache_compressed.get(),
@@ -415,6 +527,8 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
 
   RETURN_NOT_OK(new_table->SetupFilter(meta_iter.get()));
 
+  RETURN_NOT_OK(new_table->ReadCompressionDictBlock(meta_iter.get()));
+
   if (data_index_load_mode == DataIndexLoadMode::PRELOAD_ON_OPEN) {
     // Will use block cache for data index access?
     if (table_options.cache_index_and_filter_blocks) {
@@ -553,6 +667,26 @@ Status BlockBasedTable::ReadPropertiesBlock(InternalIterator* meta_iter) {
   return Status::OK();
 }
 
+Status BlockBasedTable::ReadCompressionDictBlock(InternalIterator* meta_iter) {
+  meta_iter->Seek(block_based_table::kCompressionDictBlock);
+  if (!meta_iter->Valid() || meta_iter->key() != block_based_table::kCompressionDictBlock) {
+    return meta_iter->status();
+  }
+
+  BlockHandle handle;
+  Slice handle_value = meta_iter->value();
+  RETURN_NOT_OK(handle.DecodeFrom(&handle_value));
+  BlockContents contents;
+  RETURN_NOT_OK(ReadBlockContents(
+      rep_->base_reader_with_cache_prefix->reader.get(), rep_->footer, ReadOptions::kDefault,
+      handle, &contents, rep_->ioptions.env, rep_->mem_tracker, true /* do_uncompress */));
+  rep_->compression_dict = std::make_unique<UncompressionDict>(contents.data);
+  if (!rep_->compression_dict->valid()) {
+    return STATUS(NotSupported, "Failed to load compression dictionary");
+  }
+  return Status::OK();
+}
+
 Status BlockBasedTable::SetupFilter(InternalIterator* meta_iter) {
   // Find filter handle and filter type.
   if (!rep_->filter_policy) {
@@ -738,7 +872,9 @@ Status BlockBasedTable::GetDataBlockFromCache(
     Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
     const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
     uint32_t format_version, BlockType block_type,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    const std::shared_ptr<yb::MemTracker>& mem_tracker,
+    const std::shared_ptr<PersistentCacheFile>& persistent_cache,
+    const UncompressionDict* compression_dict, const Comparator* comparator, bool* inserted) {
   Status s;
   Block* compressed_block = nullptr;
   Cache::Handle* block_cache_compressed_handle = nullptr;
@@ -782,7 +918,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
   // Retrieve the uncompressed contents into a new buffer
   BlockContents contents;
   s = UncompressBlockContents(compressed_block->data(), compressed_block->size(), &contents,
-                              format_version, mem_tracker);
+                              format_version, mem_tracker, compression_dict);
 
   // Insert uncompressed block into block cache
   if (s.ok()) {
@@ -790,12 +926,16 @@ Status BlockBasedTable::GetDataBlockFromCache(
     assert(block->value->compression_type() == kNoCompression);
     if (block_cache != nullptr && block->value->cachable() &&
         read_options.fill_cache) {
+      block->value->set_persistent_cache(persistent_cache);
+      block->value->PrepareRestartKeyPrefixes(comparator);
       s = block_cache->Insert(block_cache_key, read_options.query_id, block->value,
-                              block->value->usable_size(), &DeleteCachedEntry<Block>,
+                              block->value->cache_charge(), &DeleteCachedBlock,
                               &block->cache_handle, statistics);
       if (!s.ok()) {
         delete block->value;
         block->value = nullptr;
+      } else if (inserted) {
+        *inserted = true;
       }
     }
   }
@@ -810,7 +950,9 @@ Status BlockBasedTable::PutDataBlockToCache(
     Cache* block_cache, Cache* block_cache_compressed,
     const ReadOptions& read_options, Statistics* statistics,
     CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    const std::shared_ptr<yb::MemTracker>& mem_tracker,
+    const std::shared_ptr<PersistentCacheFile>& persistent_cache,
+    const UncompressionDict* compression_dict, const Comparator* comparator) {
   assert(raw_block->compression_type() == kNoCompression ||
          block_cache_compressed != nullptr);
 
@@ -819,7 +961,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   BlockContents contents;
   if (raw_block->compression_type() != kNoCompression) {
     s = UncompressBlockContents(raw_block->data(), raw_block->size(), &contents,
-                                format_version, mem_tracker);
+                                format_version, mem_tracker, compression_dict);
   }
   if (!s.ok()) {
     delete raw_block;
@@ -852,9 +994,11 @@ Status BlockBasedTable::PutDataBlockToCache(
   // insert into uncompressed block cache
   assert((block->value->compression_type() == kNoCompression));
   if (block_cache != nullptr && block->value->cachable()) {
+    block->value->set_persistent_cache(persistent_cache);
+    block->value->PrepareRestartKeyPrefixes(comparator);
     s = block_cache->Insert(block_cache_key, read_options.query_id, block->value,
-                            block->value->usable_size(),
-                            &DeleteCachedEntry<Block>, &block->cache_handle, statistics);
+                            block->value->cache_charge(),
+                            &DeleteCachedBlock, &block->cache_handle, statistics);
     if (!s.ok()) {
       delete block->value;
       block->value = nullptr;
@@ -1028,7 +1172,10 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
     filter = ReadFilterBlock(*filter_block_handle, rep_, &filter_size);
     if (filter != nullptr) {
       assert(filter_size > 0);
-      Status s = block_cache->Insert(filter_block_cache_key, query_id,
+      const auto insert_query_id =
+          rep_->table_options.high_priority_index_and_filter_blocks && query_id != kNoCacheQueryId
+              ? kInMultiTouchId : query_id;
+      Status s = block_cache->Insert(filter_block_cache_key, insert_query_id,
                                      filter, filter_size,
                                      &DeleteCachedEntry<FilterBlockReader>, &cache_handle,
                                      statistics);
@@ -1072,7 +1219,8 @@ yb::Result<BlockBasedTable::CachableEntry<IndexReader>> BlockBasedTable::GetInde
   Cache* const block_cache = rep_->table_options.block_cache.get();
 
   if (block_cache && (rep_->data_index_load_mode == DataIndexLoadMode::USE_CACHE ||
-      rep_->table_options.cache_index_and_filter_blocks)) {
+      (rep_->table_options.cache_index_and_filter_blocks &&
+       !rep_->table_options.high_priority_index_and_filter_blocks))) {
     char cache_key[block_based_table::kCacheKeyBufferSize];
     auto key = GetCacheKey(rep_->base_reader_with_cache_prefix->cache_key_prefix,
         rep_->footer.index_handle(), cache_key);
@@ -1145,10 +1293,21 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
 // into an iterator over the contents of the corresponding block.
 // If input_iter is null, new a iterator
 // If input_iter is not null, update this iter and return it
-InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
+InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& read_options,
     const Slice& index_value, BlockType block_type, BlockIter* input_iter) {
   PERF_TIMER_GUARD(new_table_block_iter_nanos);
 
+  // Lower level index blocks go to the multi-touch part of the block cache at once.
+  ReadOptions high_priority_read_options;
+  const bool high_priority = block_type == BlockType::kIndex &&
+                             rep_->table_options.high_priority_index_and_filter_blocks &&
+                             read_options.query_id != kNoCacheQueryId;
+  if (high_priority) {
+    high_priority_read_options = read_options;
+    high_priority_read_options.query_id = kInMultiTouchId;
+  }
+  const ReadOptions& ro = high_priority ? high_priority_read_options : read_options;
+
   const bool no_io = (ro.read_tier == kBlockCacheTier);
   Cache* block_cache = rep_->table_options.block_cache.get();
   Cache* block_cache_compressed =
@@ -1171,6 +1330,9 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
   }
 
   FileReaderWithCachePrefix* reader = GetBlockReader(block_type);
+  // Only data blocks are compressed with dictionary.
+  const UncompressionDict* compression_dict =
+      block_type == BlockType::kData ? rep_->compression_dict.get() : nullptr;
 
   // If either block cache is enabled, we'll try to read from it.
   if (block_cache != nullptr || block_cache_compressed != nullptr) {
@@ -1189,25 +1351,39 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
       ckey = GetCacheKey(reader->compressed_cache_key_prefix, handle, compressed_cache_key);
     }
 
+    const bool track_inserted = block_type == BlockType::kData &&
+        rep_->track_cached_data_blocks.load(std::memory_order_acquire);
+    bool inserted = false;
     s = GetDataBlockFromCache(
         key, ckey, block_cache, block_cache_compressed, statistics, ro, &block,
-        rep_->table_options.format_version, block_type, rep_->mem_tracker);
+        rep_->table_options.format_version, block_type, rep_->mem_tracker,
+        reader->persistent_cache, compression_dict, rep_->comparator.get(), &inserted);
 
     if (block.value == nullptr && !no_io && ro.fill_cache) {
       std::unique_ptr<Block> raw_block;
-      {
+      if (reader->persistent_cache) {
+        raw_block = GetBlockFromPersistentCache(
+            reader->persistent_cache->cache(), key, rep_->mem_tracker);
+      }
+      if (!raw_block) {
         StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
         s = block_based_table::ReadBlockFromFile(
             reader->reader.get(), rep_->footer, ro, handle, &raw_block, rep_->ioptions.env,
-            rep_->mem_tracker, block_cache_compressed == nullptr);
+            rep_->mem_tracker, block_cache_compressed == nullptr, compression_dict);
       }
 
       if (s.ok()) {
         s = PutDataBlockToCache(key, ckey, block_cache, block_cache_compressed,
                                 ro, statistics, &block, raw_block.release(),
-                                rep_->table_options.format_version, rep_->mem_tracker);
+                                rep_->table_options.format_version, rep_->mem_tracker,
+                                reader->persistent_cache, compression_dict,
+                                rep_->comparator.get());
+        inserted = block.cache_handle != nullptr;
       }
     }
+    if (track_inserted && inserted) {
+      DataBlockInsertedToCache(handle);
+    }
   }
 
   // Didn't get any data from block caches.
@@ -1224,7 +1400,7 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
     std::unique_ptr<Block> block_value;
     s = block_based_table::ReadBlockFromFile(
         reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env,
-        rep_->mem_tracker);
+        rep_->mem_tracker, true /* do_uncompress */, compression_dict);
     if (s.ok()) {
       block.value = block_value.release();
     }
@@ -1513,6 +1689,106 @@ Status BlockBasedTable::Prefetch(const Slice* const begin,
   return Status::OK();
 }
 
+Status BlockBasedTable::GetCachedDataBlocks(
+    size_t max_blocks, std::vector<DataBlockLocation>* blocks) {
+  Cache* block_cache = rep_->table_options.block_cache.get();
+  if (block_cache == nullptr) {
+    return Status::OK();
+  }
+
+  std::vector<DataBlockLocation> candidates;
+  bool walk_index;
+  {
+    std::lock_guard<std::mutex> lock(rep_->cached_data_blocks_mutex);
+    walk_index = !rep_->track_cached_data_blocks.load(std::memory_order_acquire) ||
+                 rep_->inserted_data_blocks_overflow;
+    if (!walk_index) {
+      candidates.swap(rep_->cached_data_blocks);
+      candidates.insert(
+          candidates.end(), rep_->inserted_data_blocks.begin(), rep_->inserted_data_blocks.end());
+    }
+    rep_->inserted_data_blocks.clear();
+    rep_->inserted_data_blocks_overflow = false;
+    rep_->max_inserted_data_blocks = max_blocks;
+    // Blocks inserted while the index is walked below are checked by the next call.
+    rep_->track_cached_data_blocks.store(true, std::memory_order_release);
+  }
+
+  if (walk_index) {
+    IndexIteratorHolder iiter_holder(this, ReadOptions::kDefault);
+    InternalIterator& iiter = *iiter_holder.iter();
+    RETURN_NOT_OK(iiter.status());
+    for (iiter.SeekToFirst(); iiter.Valid(); iiter.Next()) {
+      BlockHandle handle;
+      Slice input = iiter.value();
+      RETURN_NOT_OK(handle.DecodeFrom(&input));
+      candidates.push_back(DataBlockLocation{handle.offset(), handle.size()});
+    }
+    RETURN_NOT_OK(iiter.status());
+  } else {
+    std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.offset < rhs.offset;
+    });
+    candidates.erase(
+        std::unique(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+          return lhs.offset == rhs.offset;
+        }),
+        candidates.end());
+  }
+
+  // All cached blocks are remembered, even when more than max_blocks are found, because blocks
+  // that are not remembered would only be found by walking the whole index again.
+  std::vector<DataBlockLocation> found;
+  char cache_key_storage[block_based_table::kCacheKeyBufferSize];
+  for (const auto& block : candidates) {
+    const Slice cache_key = GetCacheKey(
+        rep_->data_reader_with_cache_prefix->cache_key_prefix,
+        BlockHandle(block.offset, block.size), cache_key_storage);
+    if (block_cache->Contains(cache_key)) {
+      found.push_back(block);
+    }
+  }
+  blocks->insert(
+      blocks->end(), found.begin(), found.begin() + std::min(found.size(), max_blocks));
+
+  std::lock_guard<std::mutex> lock(rep_->cached_data_blocks_mutex);
+  rep_->cached_data_blocks = std::move(found);
+  return Status::OK();
+}
+
+void BlockBasedTable::DataBlockInsertedToCache(const BlockHandle& handle) {
+  std::lock_guard<std::mutex> lock(rep_->cached_data_blocks_mutex);
+  if (rep_->inserted_data_blocks_overflow) {
+    return;
+  }
+  if (rep_->inserted_data_blocks.size() >= rep_->max_inserted_data_blocks) {
+    rep_->inserted_data_blocks_overflow = true;
+    rep_->inserted_data_blocks.clear();
+    rep_->inserted_data_blocks.shrink_to_fit();
+    return;
+  }
+  rep_->inserted_data_blocks.push_back(DataBlockLocation{handle.offset(), handle.size()});
+}
+
+Status BlockBasedTable::WarmUpDataBlocks(const std::vector<DataBlockLocation>& blocks) {
+  if (rep_->table_options.block_cache == nullptr) {
+    return Status::OK();
+  }
+
+  std::string block_handle;
+  for (const auto& block : blocks) {
+    block_handle.clear();
+    BlockHandle(block.offset, block.size).AppendEncodedTo(&block_handle);
+    // With the LRU cache, blocks are inserted into the single touch part with kDefaultQueryId, so
+    // warm up could only evict other single touch entries, but not multi touch ones. A block moves
+    // to the multi touch part when it is read by a query with a different query id.
+    BlockIter biter;
+    NewDataBlockIterator(ReadOptions::kDefault, block_handle, BlockType::kData, &biter);
+    RETURN_NOT_OK(biter.status());
+  }
+  return Status::OK();
+}
+
 bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
                                       const Slice& key) {
   std::unique_ptr<InternalIterator> iiter(NewIndexIterator(options));
@@ -1533,7 +1809,8 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
   Slice ckey;
 
   s = GetDataBlockFromCache(cache_key, ckey, block_cache, nullptr, nullptr, options, &block,
-      rep_->table_options.format_version, BlockType::kData, rep_->mem_tracker);
+      rep_->table_options.format_version, BlockType::kData, rep_->mem_tracker,
+      nullptr /* persistent_cache */, rep_->compression_dict.get(), rep_->comparator.get());
   assert(s.ok());
   bool in_cache = block.value != nullptr;
   if (in_cache) {
@@ -1891,7 +2168,8 @@ const ImmutableCFOptions& BlockBasedTable::ioptions() {
   return rep_->ioptions;
 }
 
-yb::Result<std::string> BlockBasedTable::GetMiddleKey() {
+yb::Result<std::vector<std::string>> BlockBasedTable::GetKeysFromIndex(
+    const std::function<yb::Result<std::vector<Slice>>(IndexReader*)>& get_index_keys) {
   auto index_reader = VERIFY_RESULT(GetIndexReader(ReadOptions::kDefault));
 
   // TODO: remove this trick after https://github.com/yugabyte/yugabyte-db/issues/4720 is resolved.
@@ -1899,11 +2177,32 @@ yb::Result<std::string> BlockBasedTable::GetMiddleKey() {
     index_reader.Release(rep_->table_options.block_cache.get());
   });
 
-  const auto index_middle_key = VERIFY_RESULT(index_reader.value->GetMiddleKey());
+  const auto index_keys = VERIFY_RESULT(get_index_keys(index_reader.value));
+  std::vector<std::string> result;
+  if (index_keys.empty()) {
+    return result;
+  }
   std::unique_ptr<InternalIterator> iter(
       NewIterator(ReadOptions::kDefault, nullptr, /* skip_filters =*/ true));
-  iter->Seek(index_middle_key);
-  if (!iter->Valid()) {
+  for (const auto& index_key : index_keys) {
+    iter->Seek(index_key);
+    if (!iter->Valid()) {
+      break;
+    }
+    if (result.empty() || result.back() != iter->key()) {
+      result.push_back(iter->key().ToBuffer());
+    }
+  }
+  RETURN_NOT_OK(iter->status());
+  return result;
+}
+
+yb::Result<std::string> BlockBasedTable::GetMiddleKey() {
+  auto keys = VERIFY_RESULT(GetKeysFromIndex(
+      [](IndexReader* index_reader) -> yb::Result<std::vector<Slice>> {
+    return std::vector<Slice>{VERIFY_RESULT(index_reader->GetMiddleKey())};
+  }));
+  if (keys.empty()) {
     // There are no keys in SST that are >= index_middle_key. That means SST is empty or just have
     // the single data block.
     // For tablet splitting we don't need to handle such small files, but if needed for other cases
@@ -1911,7 +2210,13 @@ yb::Result<std::string> BlockBasedTable::GetMiddleKey() {
     // in the SST.
     return STATUS(Incomplete, "Empty or to small SST");
   }
-  return iter->key().ToBuffer();
+  return std::move(keys.front());
+}
+
+yb::Result<std::vector<std::string>> BlockBasedTable::GetSplitKeys(size_t num_parts) {
+  return GetKeysFromIndex([num_parts](IndexReader* index_reader) {
+    return index_reader->GetSplitKeys(num_parts);
+  });
 }
 
 }  // namespace rocksdb
@@ -25,6 +25,7 @@
 #define YB_ROCKSDB_TABLE_BLOCK_BASED_TABLE_READER_H
 
 #include <stdint.h>
+#include <functional>
 #include <memory>
 #include <utility>
 #include <string>
@@ -51,8 +52,10 @@ class FullFilterBlockReader;
 class Footer;
 class InternalKeyComparator;
 class Iterator;
+class PersistentCacheFile;
 class TableCache;
 class TableReader;
+class UncompressionDict;
 class WritableFile;
 struct BlockBasedTableOptions;
 struct EnvOptions;
@@ -92,6 +95,8 @@ class BloomFilterAwareFileFilter : public TableAwareReadFileFilter {
 
   bool Filter(TableReader* reader) const override;
 
+  Slice user_key() const override { return user_key_; }
+
  private:
   const ReadOptions read_options_;
   const std::string user_key_;
@@ -189,6 +194,13 @@ class BlockBasedTable : public TableReader {
 
   yb::Result<std::string> GetMiddleKey() override;
 
+  yb::Result<std::vector<std::string>> GetSplitKeys(size_t num_parts) override;
+
+  CHECKED_STATUS GetCachedDataBlocks(
+      size_t max_blocks, std::vector<DataBlockLocation>* blocks) override;
+
+  CHECKED_STATUS WarmUpDataBlocks(const std::vector<DataBlockLocation>& blocks) override;
+
   ~BlockBasedTable();
 
   bool TEST_filter_block_preloaded() const;
@@ -232,6 +244,12 @@ class BlockBasedTable : public TableReader {
   // - If read_options.read_tier != kBlockCacheTier: new index reader will be created and cached.
   yb::Result<CachableEntry<IndexReader>> GetIndexReader(const ReadOptions& read_options);
 
+  // Returns keys picked from the index by get_index_keys, replaced with the first keys actually
+  // written at or after them, since keys from the index could be shortened. Keys that are beyond
+  // the last key of the file are skipped, and duplicates are removed.
+  yb::Result<std::vector<std::string>> GetKeysFromIndex(
+      const std::function<yb::Result<std::vector<Slice>>(IndexReader*)>& get_index_keys);
+
   // Get the iterator from the index reader.
   // If input_iter is not set, return new Iterator
   // If input_iter is set, update it and return:
@@ -247,18 +265,27 @@ class BlockBasedTable : public TableReader {
   // block_cache_compressed.
   // On success, Status::OK with be returned and @block will be populated with
   // pointer to the block as well as its block handle.
+  // If inserted is not null, it is set to true when the block found in block_cache_compressed was
+  // inserted into block_cache.
   static CHECKED_STATUS GetDataBlockFromCache(
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
       const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
       uint32_t format_version, BlockType block_type,
-      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+      const std::shared_ptr<PersistentCacheFile>& persistent_cache,
+      const UncompressionDict* compression_dict, const Comparator* comparator,
+      bool* inserted = nullptr);
 
   // Put a raw block (maybe compressed) to the corresponding block caches.
   // This method will perform decompression against raw_block if needed and then
-  // populate the block caches.
+  // populate the block caches. When persistent_cache is specified, the uncompressed block is
+  // stored there after eviction from block_cache.
   // On success, Status::OK will be returned; also @block will be populated with
   // uncompressed block and its cache handle.
+  // Restart key prefixes of the uncompressed block are built for comparator before it is charged
+  // to block_cache, see Block::PrepareRestartKeyPrefixes. The same applies to
+  // GetDataBlockFromCache.
   //
   // REQUIRES: raw_block is heap-allocated. PutDataBlockToCache() will be
   // responsible for releasing its memory if error occurs.
@@ -267,7 +294,9 @@ class BlockBasedTable : public TableReader {
       Cache* block_cache, Cache* block_cache_compressed,
       const ReadOptions& read_options, Statistics* statistics,
       CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+      const std::shared_ptr<PersistentCacheFile>& persistent_cache,
+      const UncompressionDict* compression_dict, const Comparator* comparator);
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
@@ -292,6 +321,8 @@ class BlockBasedTable : public TableReader {
 
   CHECKED_STATUS SetupFilter(InternalIterator* meta_iter);
 
+  CHECKED_STATUS ReadCompressionDictBlock(InternalIterator* meta_iter);
+
   // Read the meta block from sst.
   static CHECKED_STATUS ReadMetaBlock(
       Rep* rep, std::unique_ptr<Block>* meta_block, std::unique_ptr<InternalIterator>* iter);
@@ -309,6 +340,9 @@ class BlockBasedTable : public TableReader {
 
   FileReaderWithCachePrefix* GetBlockReader(BlockType block_type);
 
+  // Remembers the data block inserted into the block cache for the next GetCachedDataBlocks call.
+  void DataBlockInsertedToCache(const BlockHandle& handle);
+
   explicit BlockBasedTable(Rep* rep) : rep_(rep) {}
 
   // Helper functions for DumpTable()
@@ -40,10 +40,25 @@
 //     value: char[value_length]
 // shared_bytes == 0 for restart points.
 //
+// With KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefixAndMiddle an entry has the form:
+//     shared_bytes: varint32
+//     (unshared_bytes << 1) | has_shared_middle: varint32
+//     value_length: varint32
+//     shared_middle_bytes: varint32, only when has_shared_middle is set
+//     unshared_suffix_bytes: varint32, only when has_shared_middle is set
+//     key_delta: char[unshared_bytes]
+//     key_suffix: char[unshared_suffix_bytes]
+//     value: char[value_length]
+// The key consists of shared_bytes of the previous key, key_delta, the shared_middle_bytes of the
+// previous key that precede its last unshared_suffix_bytes bytes, and key_suffix.
+// Restart points store the whole key in key_delta.
+//
 // The trailer of the block has the form:
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+// The most significant bit of num_restarts is set for blocks using
+// kKeyDeltaEncodingSharedPrefixAndMiddle.
 
 #include "yb/rocksdb/table/block_builder.h"
 
@@ -57,9 +72,47 @@
 
 namespace rocksdb {
 
-BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding)
+namespace {
+
+// Shared middle costs up to 2 extra header bytes, so shorter runs are not worth sharing.
+constexpr size_t kMinSharedMiddleSize = 3;
+
+// Finds the longest run of bytes of key after its first shared_prefix bytes, that are equal to the
+// bytes of last_key at the same distance from the end of the key.
+void FindSharedMiddle(
+    const Slice& last_key, const Slice& key, size_t shared_prefix, size_t* shared_middle,
+    size_t* non_shared_suffix) {
+  *shared_middle = 0;
+  *non_shared_suffix = 0;
+  const size_t limit = std::min(key.size() - shared_prefix, last_key.size());
+  const char* key_end = key.cend();
+  const char* last_key_end = last_key.cend();
+  size_t run = 0;
+  for (size_t i = 1; i <= limit; ++i) {
+    if (key_end[-i] != last_key_end[-i]) {
+      run = 0;
+      continue;
+    }
+    ++run;
+    if (run > *shared_middle) {
+      *shared_middle = run;
+      *non_shared_suffix = i - run;
+    }
+  }
+  if (*shared_middle < kMinSharedMiddleSize) {
+    *shared_middle = 0;
+    *non_shared_suffix = 0;
+  }
+}
+
+} // namespace
+
+BlockBuilder::BlockBuilder(
+    int block_restart_interval, bool use_delta_encoding,
+    KeyValueEncodingFormat key_value_encoding_format)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
+      key_value_encoding_format_(key_value_encoding_format),
       restarts_(),
       counter_(0),
       finished_(false) {
@@ -110,7 +163,12 @@ Slice BlockBuilder::Finish() {
   for (size_t i = 0; i < restarts_.size(); i++) {
     PutFixed32(&buffer_, restarts_[i]);
   }
-  PutFixed32(&buffer_, static_cast<uint32_t>(restarts_.size()));
+  uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
+  if (key_value_encoding_format_ ==
+          KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefixAndMiddle) {
+    num_restarts |= kSharedMiddleEncodingFlag;
+  }
+  PutFixed32(&buffer_, num_restarts);
   finished_ = true;
   return Slice(buffer_);
 }
@@ -120,6 +178,10 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
   assert(!finished_);
   assert(counter_ <= block_restart_interval_);
   size_t shared = 0;  // number of bytes shared with prev key
+  size_t shared_middle = 0;
+  size_t non_shared_suffix = 0;
+  const bool shared_middle_encoding =
+      key_value_encoding_format_ == KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefixAndMiddle;
   if (counter_ >= block_restart_interval_) {
     // Restart compression
     restarts_.push_back(static_cast<uint32_t>(buffer_.size()));
@@ -130,7 +192,29 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
     while ((shared < min_length) && (last_key_piece[shared] == key[shared])) {
       shared++;
     }
+    if (shared_middle_encoding) {
+      FindSharedMiddle(last_key_piece, key, shared, &shared_middle, &non_shared_suffix);
+    }
   }
+
+  if (shared_middle_encoding) {
+    const size_t non_shared = key.size() - shared - shared_middle - non_shared_suffix;
+    const bool has_shared_middle = shared_middle != 0;
+    PutVarint32(&buffer_, static_cast<uint32_t>(shared));
+    PutVarint32(&buffer_, static_cast<uint32_t>(non_shared << 1 | has_shared_middle));
+    PutVarint32(&buffer_, static_cast<uint32_t>(value.size()));
+    if (has_shared_middle) {
+      PutVarint32(&buffer_, static_cast<uint32_t>(shared_middle));
+      PutVarint32(&buffer_, static_cast<uint32_t>(non_shared_suffix));
+    }
+    buffer_.append(key.cdata() + shared, non_shared);
+    buffer_.append(key.cend() - non_shared_suffix, non_shared_suffix);
+    buffer_.append(value.cdata(), value.size());
+    last_key_.assign(key.cdata(), key.size());
+    counter_++;
+    return;
+  }
+
   const size_t non_shared = key.size() - shared;
 
   // Add "<shared><non_shared><value_size>" to buffer_
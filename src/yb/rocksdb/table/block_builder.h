@@ -26,17 +26,25 @@
 
 #include <stdint.h>
 #include <vector>
+
+#include "yb/rocksdb/table.h"
 #include "yb/util/slice.h"
 
 namespace rocksdb {
 
+// Set in num_restarts of the block trailer for blocks written with
+// KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefixAndMiddle.
+constexpr uint32_t kSharedMiddleEncodingFlag = 0x80000000;
+
 class BlockBuilder {
  public:
   BlockBuilder(const BlockBuilder&) = delete;
   void operator=(const BlockBuilder&) = delete;
 
   explicit BlockBuilder(int block_restart_interval,
-                        bool use_delta_encoding = true);
+                        bool use_delta_encoding = true,
+                        KeyValueEncodingFormat key_value_encoding_format =
+                            KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -67,6 +75,7 @@ class BlockBuilder {
  private:
   const int          block_restart_interval_;
   const bool         use_delta_encoding_;
+  const KeyValueEncodingFormat key_value_encoding_format_;
 
   std::string           buffer_;    // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
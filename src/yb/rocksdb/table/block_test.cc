@@ -18,9 +18,13 @@
 // under the License.
 //
 #include <stdio.h>
+
+#include <algorithm>
 #include <string>
 #include <vector>
 
+#include <gflags/gflags.h>
+
 #include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/db/memtable.h"
 #include "yb/rocksdb/db/write_batch_internal.h"
@@ -37,6 +41,8 @@
 #include "yb/rocksdb/util/testharness.h"
 #include "yb/rocksdb/util/testutil.h"
 
+DECLARE_bool(rocksdb_block_normalized_key_prefixes);
+
 namespace rocksdb {
 
 std::string GenerateKey(int primary_key, int secondary_key, int padding_size,
@@ -249,20 +255,41 @@ std::string GetPaddedNum(int i) {
   return StringPrintf("%010d", i);
 }
 
-yb::Result<std::string> GetMiddleKey(const int num_keys, const int block_restart_interval) {
-  BlockBuilder builder(block_restart_interval);
-
+std::unique_ptr<Block> BuildBlock(const int num_keys, BlockBuilder* builder) {
   for (int i = 1; i <= num_keys; ++i) {
     const auto padded_num = GetPaddedNum(i);
-    builder.Add("k" + padded_num, "v" + padded_num);
+    builder->Add("k" + padded_num, "v" + padded_num);
   }
 
   BlockContents contents;
-  contents.data = builder.Finish();
+  contents.data = builder->Finish();
   contents.cachable = false;
-  Block reader(std::move(contents));
+  return std::make_unique<Block>(std::move(contents));
+}
 
-  return VERIFY_RESULT(reader.GetMiddleKey()).ToString();
+yb::Result<std::string> GetMiddleKey(const int num_keys, const int block_restart_interval) {
+  BlockBuilder builder(block_restart_interval);
+  auto reader = BuildBlock(num_keys, &builder);
+
+  return VERIFY_RESULT(reader->GetMiddleKey()).ToString();
+}
+
+void CheckSplitKeys(
+    const int num_keys, const int block_restart_interval, const size_t num_parts,
+    const std::vector<int>& expected_split_keys) {
+  BlockBuilder builder(block_restart_interval);
+  auto reader = BuildBlock(num_keys, &builder);
+
+  const auto split_keys = ASSERT_RESULT(reader->GetSplitKeys(num_parts));
+  std::vector<std::string> expected;
+  for (auto key : expected_split_keys) {
+    expected.push_back("k" + GetPaddedNum(key));
+  }
+  std::vector<std::string> actual;
+  for (const auto& key : split_keys) {
+    actual.push_back(key.ToString());
+  }
+  ASSERT_EQ(expected, actual) << "For num_keys = " << num_keys << ", num_parts = " << num_parts;
 }
 
 void CheckMiddleKey(
@@ -287,6 +314,199 @@ TEST_F(BlockTest, GetMiddleKey) {
   CheckMiddleKey(/* num_keys =*/ 16, block_restart_interval, /* expected_middle_key =*/ 8);
 }
 
+TEST_F(BlockTest, SharedMiddleEncoding) {
+  Random rnd(301);
+  Options options = Options();
+  constexpr int kNumRecords = 10000;
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  // Keys differ in the middle while sharing a long tail, similar to the hybrid time of rows
+  // written by the same transaction.
+  const std::string tail = RandomString(&rnd, 12);
+  for (int i = 0; i < kNumRecords; ++i) {
+    char buf[20];
+    snprintf(buf, sizeof(buf), "%08d", i);
+    keys.push_back(std::string(buf) + RandomString(&rnd, i % 3) + tail +
+                   RandomString(&rnd, (i / 7) % 3));
+    values.push_back(RandomString(&rnd, 10));
+  }
+
+  BlockBuilder prefix_builder(16);
+  BlockBuilder builder(
+      16, /* use_delta_encoding =*/ true,
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefixAndMiddle);
+  for (int i = 0; i < kNumRecords; ++i) {
+    prefix_builder.Add(keys[i], values[i]);
+    builder.Add(keys[i], values[i]);
+  }
+  const size_t prefix_encoded_size = prefix_builder.Finish().size();
+
+  BlockContents contents;
+  contents.data = builder.Finish();
+  contents.cachable = false;
+  ASSERT_LT(contents.data.size(), prefix_encoded_size);
+  Block reader(std::move(contents));
+  ASSERT_EQ(KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefixAndMiddle,
+            reader.key_value_encoding_format());
+
+  std::unique_ptr<InternalIterator> iter(reader.NewIterator(options.comparator));
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); ++count, iter->Next()) {
+    ASSERT_EQ(keys[count], iter->key().ToString());
+    ASSERT_EQ(values[count], iter->value().ToString());
+  }
+  ASSERT_EQ(kNumRecords, count);
+
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    --count;
+    ASSERT_EQ(keys[count], iter->key().ToString());
+    ASSERT_EQ(values[count], iter->value().ToString());
+  }
+  ASSERT_EQ(0, count);
+
+  for (int i = 0; i < kNumRecords; ++i) {
+    const int index = rnd.Uniform(kNumRecords);
+    iter->Seek(keys[index]);
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(keys[index], iter->key().ToString());
+    ASSERT_EQ(values[index], iter->value().ToString());
+  }
+}
+
+namespace {
+
+// Checks that seeks using restart key prefixes find the same entries as seeks without them.
+void CheckNormalizedKeyPrefixesSeek(
+    const Comparator* comparator, const std::vector<std::string>& keys,
+    const std::vector<std::string>& targets) {
+  BlockBuilder builder(4);
+  for (const auto& key : keys) {
+    builder.Add(key, "value");
+  }
+  const Slice raw_block = builder.Finish();
+  BlockContents contents;
+  contents.data = raw_block;
+  contents.cachable = false;
+  Block reader(std::move(contents));
+  BlockContents prefixes_contents;
+  prefixes_contents.data = raw_block;
+  prefixes_contents.cachable = false;
+  Block prefixes_reader(std::move(prefixes_contents));
+
+  std::unique_ptr<InternalIterator> iter(reader.NewIterator(comparator));
+  std::unique_ptr<InternalIterator> prefixes_iter;
+  {
+    google::FlagSaver flag_saver;
+    FLAGS_rocksdb_block_normalized_key_prefixes = true;
+    prefixes_iter.reset(prefixes_reader.NewIterator(comparator));
+  }
+  ASSERT_GT(prefixes_reader.ApproximateMemoryUsage(), reader.ApproximateMemoryUsage());
+
+  for (const auto& target : targets) {
+    iter->Seek(target);
+    prefixes_iter->Seek(target);
+    ASSERT_EQ(iter->Valid(), prefixes_iter->Valid()) << Slice(target).ToDebugString();
+    if (iter->Valid()) {
+      ASSERT_EQ(iter->key().ToDebugString(), prefixes_iter->key().ToDebugString());
+    }
+  }
+}
+
+} // namespace
+
+TEST_F(BlockTest, NormalizedKeyPrefixes) {
+  google::FlagSaver flag_saver;
+  Random rnd(301);
+  constexpr int kNumRecords = 2000;
+
+  // Keys share a long prefix and differ in few middle bytes, so prefixes are often equal.
+  std::vector<std::string> user_keys;
+  for (int i = 0; i < kNumRecords; ++i) {
+    char buf[20];
+    snprintf(buf, sizeof(buf), "%06d", i / 4);
+    user_keys.push_back("shared_prefix_" + std::string(buf) + RandomString(&rnd, i % 5));
+  }
+  std::sort(user_keys.begin(), user_keys.end());
+  user_keys.erase(std::unique(user_keys.begin(), user_keys.end()), user_keys.end());
+
+  std::vector<std::string> targets = {"", "a", "shared", "shared_prefix_", "zzz"};
+  for (int i = 0; i < kNumRecords; ++i) {
+    const auto& key = user_keys[rnd.Uniform(static_cast<int>(user_keys.size()))];
+    targets.push_back(key);
+    targets.push_back(key.substr(0, rnd.Uniform(static_cast<int>(key.size()) + 1)));
+    targets.push_back(key + RandomString(&rnd, 1));
+  }
+  CheckNormalizedKeyPrefixesSeek(BytewiseComparator(), user_keys, targets);
+
+  // Internal keys, several versions of the same user key.
+  InternalKeyComparator internal_comparator(BytewiseComparator());
+  std::vector<std::string> internal_keys;
+  for (const auto& user_key : user_keys) {
+    for (SequenceNumber seqno = 3; seqno != 0; --seqno) {
+      internal_keys.push_back(InternalKey(user_key, seqno, kTypeValue).Encode().ToString());
+    }
+  }
+  std::vector<std::string> internal_targets;
+  for (const auto& target : targets) {
+    const SequenceNumber seqno = rnd.Uniform(5);
+    internal_targets.push_back(InternalKey(target, seqno, kTypeValue).Encode().ToString());
+  }
+  CheckNormalizedKeyPrefixesSeek(&internal_comparator, internal_keys, internal_targets);
+}
+
+// Restart key prefixes of a block that is charged to the cache are built only before the charge.
+TEST_F(BlockTest, NormalizedKeyPrefixesCacheCharge) {
+  google::FlagSaver flag_saver;
+  BlockBuilder builder(1);
+  for (int i = 0; i != 100; ++i) {
+    char key[16];
+    snprintf(key, sizeof(key), "key%05d", i);
+    builder.Add(key, "value");
+  }
+  const Slice raw_block = builder.Finish();
+  auto make_block = [&raw_block] {
+    BlockContents contents;
+    contents.data = raw_block;
+    contents.cachable = false;
+    return std::make_unique<Block>(std::move(contents));
+  };
+
+  FLAGS_rocksdb_block_normalized_key_prefixes = true;
+  auto block = make_block();
+  ASSERT_EQ(block->cache_charge(), block->usable_size());
+  block->PrepareRestartKeyPrefixes(BytewiseComparator());
+  const auto charge = block->cache_charge();
+  ASSERT_GT(charge, block->usable_size());
+  std::unique_ptr<InternalIterator> iter(block->NewIterator(BytewiseComparator()));
+  iter->Seek("key00050");
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("key00050", iter->key().ToString());
+  ASSERT_EQ(charge, block->cache_charge());
+
+  // Prefixes are not built later for a block charged without them.
+  iter.reset();
+  FLAGS_rocksdb_block_normalized_key_prefixes = false;
+  block = make_block();
+  block->PrepareRestartKeyPrefixes(BytewiseComparator());
+  FLAGS_rocksdb_block_normalized_key_prefixes = true;
+  iter.reset(block->NewIterator(BytewiseComparator()));
+  iter->Seek("key00050");
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("key00050", iter->key().ToString());
+  ASSERT_EQ(block->cache_charge(), block->usable_size());
+}
+
+TEST_F(BlockTest, GetSplitKeys) {
+  CheckSplitKeys(/* num_keys =*/ 0, /* block_restart_interval =*/ 1, /* num_parts =*/ 4, {});
+  CheckSplitKeys(/* num_keys =*/ 16, /* block_restart_interval =*/ 1, /* num_parts =*/ 1, {});
+  CheckSplitKeys(/* num_keys =*/ 16, /* block_restart_interval =*/ 1, /* num_parts =*/ 4,
+                 {5, 9, 13});
+  // Not enough restart points for the requested number of parts.
+  CheckSplitKeys(/* num_keys =*/ 2, /* block_restart_interval =*/ 1, /* num_parts =*/ 4, {2});
+  // Only restart keys are used.
+  CheckSplitKeys(/* num_keys =*/ 16, /* block_restart_interval =*/ 4, /* num_parts =*/ 2, {9});
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char **argv) {
@@ -41,6 +41,7 @@ namespace rocksdb {
 
 class Block;
 struct ReadOptions;
+class UncompressionDict;
 
 // the length of the magic number in bytes.
 const int kMagicNumberLengthByte = 8;
@@ -250,7 +251,8 @@ extern Status ReadBlockContents(RandomAccessFileReader* file,
                                 const BlockHandle& handle,
                                 BlockContents* contents, Env* env,
                                 const std::shared_ptr<yb::MemTracker>& mem_tracker,
-                                bool do_uncompress);
+                                bool do_uncompress,
+                                const UncompressionDict* compression_dict = nullptr);
 
 // The 'data' points to the raw block contents read in from file.
 // This method allocates a new heap buffer and the raw block
@@ -262,7 +264,8 @@ extern Status ReadBlockContents(RandomAccessFileReader* file,
 extern Status UncompressBlockContents(const char* data, size_t n,
                                       BlockContents* contents,
                                       uint32_t compress_format_version,
-                                      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+                                      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                                      const UncompressionDict* compression_dict = nullptr);
 
 // Implementation details follow.  Clients should ignore,
 
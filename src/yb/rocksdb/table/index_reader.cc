@@ -33,6 +33,8 @@ Status BinarySearchIndexReader::Create(
       file, footer, ReadOptions::kDefault, index_handle, &index_block, env, mem_tracker);
 
   if (s.ok()) {
+    // Index reader could be charged to the block cache, see usable_size.
+    index_block->PrepareRestartKeyPrefixes(comparator.get());
     index_reader->reset(new BinarySearchIndexReader(comparator, std::move(index_block)));
   }
 
@@ -42,6 +44,10 @@ Result<Slice> BinarySearchIndexReader::GetMiddleKey() {
   return index_block_->GetMiddleKey();
 }
 
+Result<std::vector<Slice>> BinarySearchIndexReader::GetSplitKeys(size_t num_parts) {
+  return index_block_->GetSplitKeys(num_parts);
+}
+
 Status HashIndexReader::Create(const SliceTransform* hash_key_extractor,
                        const Footer& footer, RandomAccessFileReader* file,
                        Env* env, const ComparatorPtr& comparator,
@@ -62,6 +68,8 @@ Status HashIndexReader::Create(const SliceTransform* hash_key_extractor,
   // back to the original binary search index.
   // So, Create will succeed regardless, from this point on.
   HashIndexReader* new_index_reader;
+  // Hash index is used instead of restart key prefixes.
+  index_block->PrepareRestartKeyPrefixes(nullptr /* comparator */);
   index_reader->reset(new_index_reader = new HashIndexReader(comparator, std::move(index_block)));
 
   // Get prefixes block
@@ -131,6 +139,10 @@ Result<Slice> HashIndexReader::GetMiddleKey() {
   return index_block_->GetMiddleKey();
 }
 
+Result<std::vector<Slice>> HashIndexReader::GetSplitKeys(size_t num_parts) {
+  return index_block_->GetSplitKeys(num_parts);
+}
+
 class MultiLevelIterator : public InternalIterator {
  public:
   static constexpr auto kIterChainInitialCapacity = 4;
@@ -294,6 +306,8 @@ Result<std::unique_ptr<MultiLevelIndexReader>> MultiLevelIndexReader::Create(
       file, footer, ReadOptions::kDefault, top_level_index_handle, &index_block, env,
       mem_tracker));
 
+  // Index reader could be charged to the block cache, see usable_size.
+  index_block->PrepareRestartKeyPrefixes(comparator.get());
   return std::make_unique<MultiLevelIndexReader>(comparator, num_levels, std::move(index_block));
 }
 
@@ -309,4 +323,8 @@ Result<Slice> MultiLevelIndexReader::GetMiddleKey() {
   return top_level_index_block_->GetMiddleKey();
 }
 
+Result<std::vector<Slice>> MultiLevelIndexReader::GetSplitKeys(size_t num_parts) {
+  return top_level_index_block_->GetSplitKeys(num_parts);
+}
+
 } // namespace rocksdb
@@ -62,6 +62,11 @@ class IndexReader {
   // written into the index (see ShortenedIndexBuilder).
   virtual Result<Slice> GetMiddleKey() = 0;
 
+  // Returns keys from the index, which divide it into num_parts parts of roughly the same size.
+  // Keys have the same semantics as for GetMiddleKey. For multi-level index only the top level is
+  // used, so fewer keys could be returned.
+  virtual Result<std::vector<Slice>> GetSplitKeys(size_t num_parts) = 0;
+
   // The size of the index.
   virtual size_t size() const = 0;
   // Memory usage of the index block
@@ -104,7 +109,7 @@ class BinarySearchIndexReader : public IndexReader {
 
   size_t usable_size() const override {
     DCHECK(index_block_);
-    return index_block_->usable_size();
+    return index_block_->cache_charge();
   }
 
   size_t ApproximateMemoryUsage() const override {
@@ -114,6 +119,8 @@ class BinarySearchIndexReader : public IndexReader {
 
   Result<Slice> GetMiddleKey() override;
 
+  Result<std::vector<Slice>> GetSplitKeys(size_t num_parts) override;
+
  private:
   BinarySearchIndexReader(const ComparatorPtr& comparator,
                           std::unique_ptr<Block>&& index_block)
@@ -160,6 +167,8 @@ class HashIndexReader : public IndexReader {
 
   Result<Slice> GetMiddleKey() override;
 
+  Result<std::vector<Slice>> GetSplitKeys(size_t num_parts) override;
+
  private:
   HashIndexReader(const ComparatorPtr& comparator, std::unique_ptr<Block>&& index_block)
       : IndexReader(comparator), index_block_(std::move(index_block)) {
@@ -201,11 +210,13 @@ class MultiLevelIndexReader : public IndexReader {
 
   Result<Slice> GetMiddleKey() override;
 
+  Result<std::vector<Slice>> GetSplitKeys(size_t num_parts) override;
+
  private:
   size_t size() const override { return top_level_index_block_->size(); }
 
   size_t usable_size() const override {
-    return top_level_index_block_->usable_size();
+    return top_level_index_block_->cache_charge();
   }
 
   size_t ApproximateMemoryUsage() const override {
@@ -139,6 +139,18 @@ void MockTableFactory::AssertSingleFile(
   ASSERT_TRUE(file_contents == file_system_.files.begin()->second);
 }
 
+void MockTableFactory::AssertFilesUnion(
+    size_t num_files, const stl_wrappers::KVMap& file_contents) {
+  ASSERT_EQ(file_system_.files.size(), num_files);
+  stl_wrappers::KVMap files_union;
+  for (const auto& file : file_system_.files) {
+    for (const auto& kv : file.second) {
+      ASSERT_TRUE(files_union.insert(kv).second);
+    }
+  }
+  ASSERT_TRUE(file_contents == files_union);
+}
+
 void MockTableFactory::AssertLatestFile(
     const stl_wrappers::KVMap& file_contents) {
   ASSERT_GE(file_system_.files.size(), 1U);
@@ -201,6 +201,10 @@ class MockTableFactory : public TableFactory {
   void AssertSingleFile(const stl_wrappers::KVMap& file_contents);
   void AssertLatestFile(const stl_wrappers::KVMap& file_contents);
 
+  // This function will assert that exactly num_files files exist, that no key is present in
+  // several files and that the union of their contents is equal to file_contents.
+  void AssertFilesUnion(size_t num_files, const stl_wrappers::KVMap& file_contents);
+
  private:
   uint32_t GetAndWriteNextID(WritableFileWriter* file) const;
   uint32_t GetIDFromFile(RandomAccessFileReader* file) const;
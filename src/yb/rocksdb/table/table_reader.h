@@ -25,6 +25,7 @@
 #define YB_ROCKSDB_TABLE_TABLE_READER_H
 
 #include <memory>
+#include <vector>
 
 #include "yb/util/slice.h"
 
@@ -37,6 +38,7 @@ struct ReadOptions;
 struct TableProperties;
 class GetContext;
 class InternalIterator;
+struct DataBlockLocation;
 
 // A Table is a sorted map from strings to strings.  Tables are
 // immutable and persistent.  A Table may be safely accessed from
@@ -120,6 +122,22 @@ class TableReader {
   virtual yb::Result<std::string> GetMiddleKey() {
     return STATUS(NotSupported, "GetMiddleKey() not supported");
   }
+
+  // Returns keys which divide SST file into num_parts parts of roughly the same size. Fewer keys
+  // are returned when the file is too small. Returned keys are actually present in the file.
+  virtual yb::Result<std::vector<std::string>> GetSplitKeys(size_t num_parts) {
+    return STATUS(NotSupported, "GetSplitKeys() not supported");
+  }
+
+  // Appends to blocks data blocks of this table present in the block cache, at most max_blocks.
+  virtual Status GetCachedDataBlocks(size_t max_blocks, std::vector<DataBlockLocation>* blocks) {
+    return STATUS(NotSupported, "GetCachedDataBlocks() not supported");
+  }
+
+  // Loads specified data blocks into the block cache.
+  virtual Status WarmUpDataBlocks(const std::vector<DataBlockLocation>& blocks) {
+    return STATUS(NotSupported, "WarmUpDataBlocks() not supported");
+  }
 };
 
 }  // namespace rocksdb
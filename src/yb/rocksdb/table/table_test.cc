@@ -63,6 +63,7 @@
 #include "yb/rocksdb/util/testharness.h"
 #include "yb/rocksdb/util/testutil.h"
 #include "yb/util/enums.h"
+#include "yb/util/threadpool.h"
 
 DECLARE_double(cache_single_touch_ratio);
 
@@ -298,7 +299,7 @@ class TableConstructor: public Constructor {
                             internal_comparator,
                             int_tbl_prop_collector_factories,
                             options.compression,
-                            CompressionOptions(),
+                            options.compression_opts,
                             /* skip_filters */ false),
         TablePropertiesCollectorFactory::Context::kUnknownColumnFamily,
         file_writer_.get()));
@@ -1840,6 +1841,40 @@ TEST_F(BlockBasedTableTest, FilterBlockInBlockCache) {
   props.AssertFilterBlockStat(0, 0);
 }
 
+TEST_F(BlockBasedTableTest, HighPriorityIndexBlocks) {
+  Options options;
+  options.create_if_missing = true;
+  options.statistics = CreateDBStatisticsForTests();
+
+  // The cache is too small to keep even one entry.
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1);
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.high_priority_index_and_filter_blocks = true;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+
+  TableConstructor c(BytewiseComparator());
+  c.Add("key", "value");
+  const ImmutableCFOptions ioptions(options);
+  c.Finish(options, ioptions, table_options,
+           GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+  auto* reader = dynamic_cast<BlockBasedTable*>(c.GetTableReader());
+  ASSERT_FALSE(reader->TEST_index_reader_loaded());
+
+  // The index reader is kept by the table reader instead of the block cache, so it is read only
+  // once, while the data block is read each time.
+  for (int i = 1; i <= 3; ++i) {
+    unique_ptr<InternalIterator> iter(c.NewIterator());
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_TRUE(reader->TEST_index_reader_loaded());
+    BlockCachePropertiesSnapshot props(options.statistics.get());
+    props.AssertEqual(0, 0, i /* data block miss */, 0);
+  }
+}
+
 void ValidateBlockSizeDeviation(int value, int expected) {
   BlockBasedTableOptions table_options;
   table_options.block_size_deviation = value;
@@ -2169,6 +2204,97 @@ TEST_F(GeneralTableTest, ApproximateOffsetOfCompressed) {
   }
 }
 
+TEST_F(GeneralTableTest, ZSTDDictionaryCompression) {
+  if (!ZSTD_DictSupported()) {
+    fprintf(stderr, "skipping zstd dictionary compression test\n");
+    return;
+  }
+  Random rnd(301);
+  TableConstructor c(BytewiseComparator());
+  std::string tmp;
+  for (int i = 0; i < 200; ++i) {
+    char key[16];
+    snprintf(key, sizeof(key), "k%05d", i);
+    c.Add(key, CompressibleString(&rnd, 0.25, 500, &tmp));
+  }
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  Options options;
+  auto ikc = std::make_shared<test::PlainInternalKeyComparator>(options.comparator);
+  options.compression = kZSTDNotFinalCompression;
+  options.compression_opts.max_dict_bytes = 4096;
+  options.compression_opts.zstd_max_train_bytes = 32768;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  const ImmutableCFOptions ioptions(options);
+  c.Finish(options, ioptions, table_options, ikc, &keys, &kvmap);
+
+  // Blocks buffered for training and the ones written after it should both be readable.
+  std::unique_ptr<InternalIterator> iter(c.NewIterator());
+  auto expected = kvmap.begin();
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++expected) {
+    ASSERT_TRUE(expected != kvmap.end());
+    ASSERT_EQ(expected->first, iter->key().ToString());
+    ASSERT_EQ(expected->second, iter->value().ToString());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_TRUE(expected == kvmap.end());
+}
+
+TEST_F(GeneralTableTest, ParallelCompression) {
+  std::vector<CompressionType> compression_types;
+  if (Snappy_Supported()) {
+    compression_types.push_back(kSnappyCompression);
+  }
+  if (LZ4_Supported()) {
+    compression_types.push_back(kLZ4Compression);
+  }
+  if (ZSTD_Supported()) {
+    compression_types.push_back(kZSTDNotFinalCompression);
+  }
+
+  std::unique_ptr<yb::ThreadPool> thread_pool;
+  ASSERT_OK(yb::ThreadPoolBuilder("compress").set_max_threads(2).Build(&thread_pool));
+
+  for (auto compression_type : compression_types) {
+    Random rnd(301);
+    TableConstructor c(BytewiseComparator());
+    std::string tmp;
+    for (int i = 0; i < 1000; ++i) {
+      char key[16];
+      snprintf(key, sizeof(key), "k%05d", i);
+      c.Add(key, CompressibleString(&rnd, 0.25, 300, &tmp));
+    }
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+    Options options;
+    auto ikc = std::make_shared<test::PlainInternalKeyComparator>(options.comparator);
+    options.compression = compression_type;
+    // The builder uses up to parallel_threads tasks of the pool, while the pool is smaller.
+    options.compression_opts.parallel_threads = 4;
+    options.compression_opts.thread_pool = thread_pool.get();
+    BlockBasedTableOptions table_options;
+    table_options.block_size = 1024;
+    const ImmutableCFOptions ioptions(options);
+    c.Finish(options, ioptions, table_options, ikc, &keys, &kvmap);
+    ASSERT_GT(c.GetTableReader()->GetTableProperties()->num_data_blocks, 100);
+
+    // Blocks should be written in key order, so the index points to the right ones.
+    std::unique_ptr<InternalIterator> iter(c.NewIterator());
+    auto expected = kvmap.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++expected) {
+      ASSERT_TRUE(expected != kvmap.end());
+      ASSERT_EQ(expected->first, iter->key().ToString());
+      ASSERT_EQ(expected->second, iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_TRUE(expected == kvmap.end());
+    iter->Seek("k00500");
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ("k00500", iter->key().ToString());
+  }
+}
+
 TEST_F(HarnessTest, Randomized) {
 #if defined(THREAD_SANITIZER)
   static constexpr int kMaxNumEntries = 200;
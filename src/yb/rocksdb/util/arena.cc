@@ -144,11 +144,24 @@ char* Arena::AllocateFromHugePage(size_t bytes) {
   void* addr = mmap(nullptr, bytes, (PROT_READ | PROT_WRITE),
                     (MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB), 0, 0);
 
+#ifdef MADV_HUGEPAGE
+  if (addr == MAP_FAILED) {
+    // No huge pages are reserved, ask for transparent huge pages instead. They are used when
+    // THP is enabled in the "madvise" or "always" mode and the kernel has free huge pages.
+    addr = mmap(nullptr, bytes, (PROT_READ | PROT_WRITE), (MAP_PRIVATE | MAP_ANONYMOUS), -1, 0);
+    if (addr != MAP_FAILED) {
+      // Failure only means that the block is backed by regular pages.
+      madvise(addr, bytes, MADV_HUGEPAGE);
+    }
+  }
+#endif
+
   if (addr == MAP_FAILED) {
     return nullptr;
   }
   // the following shouldn't throw because of the above reserve()
   huge_blocks_.emplace_back(MmapInfo(addr, bytes));
+  Consumed(bytes);
   return reinterpret_cast<char*>(addr);
 #else
   return nullptr;
@@ -401,6 +401,7 @@ class LRUCache {
                         Statistics* statistics = nullptr);
   void Release(Cache::Handle* handle);
   void Erase(const Slice& key, uint32_t hash);
+  bool Contains(const Slice& key, uint32_t hash);
   size_t Evict(size_t required);
 
   // Although in some platforms the update of size_t is atomic, to make sure
@@ -815,6 +816,11 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
   return s;
 }
 
+bool LRUCache::Contains(const Slice& key, uint32_t hash) {
+  MutexLock l(&mutex_);
+  return table_.Lookup(key, hash) != nullptr;
+}
+
 void LRUCache::Erase(const Slice& key, uint32_t hash) {
   LRUHandle* e;
   bool last_reference = false;
@@ -940,6 +946,11 @@ class ShardedLRUCache : public Cache {
     shards_[Shard(hash)].Erase(key, hash);
   }
 
+  bool Contains(const Slice& key) override {
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Contains(key, hash);
+  }
+
   void* Value(Handle* handle) override {
     return reinterpret_cast<LRUHandle*>(handle)->value;
   }
@@ -996,9 +1007,10 @@ class ShardedLRUCache : public Cache {
     }
   }
 
-  virtual void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+  virtual void SetMetrics(
+      const scoped_refptr<yb::MetricEntity>& entity, yb::BlockCacheKind kind) override {
     int num_shards = 1 << num_shard_bits_;
-    metrics_ = std::make_shared<yb::CacheMetrics>(entity);
+    metrics_ = std::make_shared<yb::CacheMetrics>(entity, kind);
     for (int s = 0; s < num_shards; s++) {
       shards_[s].SetMetrics(metrics_);
     }
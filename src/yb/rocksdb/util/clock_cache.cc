@@ -0,0 +1,824 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/statistics.h"
+#include "yb/rocksdb/util/hash.h"
+#include "yb/rocksdb/util/statistics.h"
+
+#include "yb/gutil/macros.h"
+
+#include "yb/util/cache_metrics.h"
+#include "yb/util/enums.h"
+#include "yb/util/metrics.h"
+#include "yb/util/random_util.h"
+
+DECLARE_double(cache_single_touch_ratio);
+
+namespace rocksdb {
+
+namespace {
+
+// CLOCK cache implementation.
+//
+// Each shard is a fixed size open addressing hash table with linear probing. Slot of the table
+// holds the entry itself, and its state, reference count and clock counter are packed into a
+// single atomic word (meta), so Lookup and Release do not take any locks. Insert of a new entry
+// takes the shard insert mutex, so concurrent inserts of the same key do not add duplicates:
+//
+// kEmpty        - slot is free.
+// kConstruction - slot is exclusively owned by a thread that fills or frees the entry.
+// kVisible      - entry could be found by Lookup.
+// kInvisible    - entry was erased or replaced, but is still referenced by some handles.
+//
+// Lookup pins a visible slot by incrementing its reference count, and only then checks the key.
+// Slot could be taken into exclusive ownership only with a compare-exchange that expects zero
+// references, so a pinned entry is never freed. Exclusive owner leaves kConstruction state with
+// a plain store, that overwrites increments done by readers that raced with it.
+//
+// Eviction follows CLOCK policy: clock hand sweeps the slots, decrementing the clock counter of
+// unreferenced entries, and evicting the ones whose counter is already zero.
+//
+// Scan resistance follows the single-touch/multi-touch split of the LRU cache. Entry starts with
+// the lowest clock counter, so it is evicted first. Entry that is looked up by a query other than
+// the one that inserted it becomes multi-touch and gets the highest clock counter on each hit.
+// Also multi-touch entries are not decremented by the clock hand, while their total charge fits
+// into the multi-touch share of the capacity (1 - cache_single_touch_ratio). So the entries
+// touched by a single long scan do not push out the ones that are shared between queries.
+
+constexpr uint64_t kOneRef = 1;
+constexpr int kRefsBits = 30;
+constexpr uint64_t kRefsMask = (1ULL << kRefsBits) - 1;
+
+constexpr int kClockShift = kRefsBits;
+constexpr uint64_t kClockOne = 1ULL << kClockShift;
+constexpr uint64_t kMaxClock = 3;
+constexpr uint64_t kClockMask = kMaxClock << kClockShift;
+
+constexpr int kStateShift = 62;
+
+enum class SlotState : uint64_t {
+  kEmpty = 0,
+  kConstruction = 1,
+  kVisible = 2,
+  kInvisible = 3,
+};
+
+constexpr uint64_t kStateMask = 3ULL << kStateShift;
+
+inline SlotState GetState(uint64_t meta) {
+  return static_cast<SlotState>(meta >> kStateShift);
+}
+
+inline uint64_t GetRefs(uint64_t meta) {
+  return meta & kRefsMask;
+}
+
+inline uint64_t GetClock(uint64_t meta) {
+  return (meta & kClockMask) >> kClockShift;
+}
+
+inline uint64_t MakeMeta(SlotState state, uint64_t clock, uint64_t refs) {
+  return (static_cast<uint64_t>(state) << kStateShift) | (clock << kClockShift) | refs;
+}
+
+// Maximal number of slots probed by lookup and insert.
+constexpr size_t kMaxProbes = 256;
+
+// Table size is chosen so that it is filled to this ratio, when all entries have estimated charge.
+constexpr double kLoadFactor = 0.7;
+
+constexpr size_t kMinSlotsPerShard = 16;
+
+// Keys of the block cache are short, so they are usually stored in the slot itself.
+constexpr size_t kInlineKeySize = 32;
+
+struct ClockHandle {
+  std::atomic<uint64_t> meta{0};
+
+  // Number of entries that were placed after this slot in their probe sequence. Lookup could stop
+  // at the slot without displacements.
+  std::atomic<uint32_t> displacements{0};
+
+  // Fields below are written only by the exclusive owner of the slot, and read only by threads
+  // that hold a reference to it.
+  uint32_t hash = 0;
+  // Entry is not in the table, because it was full. Such entry is freed on the last release.
+  bool detached = false;
+  // Updated on promotion to multi-touch.
+  std::atomic<QueryId> query_id{kDefaultQueryId};
+  void* value = nullptr;
+  void (*deleter)(const Slice&, void* value) = nullptr;
+  size_t charge = 0;
+  size_t key_size = 0;
+  char* key_data = nullptr;
+  char inline_key[kInlineKeySize];
+
+  ~ClockHandle() {
+    ReleaseKey();
+  }
+
+  Slice key() const {
+    return Slice(key_data, key_size);
+  }
+
+  void AssignKey(const Slice& key) {
+    key_size = key.size();
+    key_data = key_size <= kInlineKeySize ? inline_key : new char[key_size];
+    memcpy(key_data, key.data(), key_size);
+  }
+
+  void ReleaseKey() {
+    if (key_data != inline_key) {
+      delete[] key_data;
+    }
+    key_data = nullptr;
+  }
+
+  SubCacheType GetSubCacheType() const {
+    return query_id.load(std::memory_order_relaxed) == kInMultiTouchId ? MULTI_TOUCH
+                                                                        : SINGLE_TOUCH;
+  }
+};
+
+// A single shard of sharded clock cache.
+class ClockCacheShard {
+ public:
+  ClockCacheShard() = default;
+  ~ClockCacheShard();
+
+  // Separate from constructor so caller can easily make an array of shards.
+  void Init(size_t capacity, size_t num_slots, bool strict_capacity_limit);
+
+  void SetMetrics(shared_ptr<yb::CacheMetrics> metrics) {
+    metrics_ = std::move(metrics);
+  }
+
+  void SetCapacity(size_t capacity);
+
+  Status Insert(const Slice& key, uint32_t hash, QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value), Cache::Handle** handle,
+                Statistics* statistics);
+  Cache::Handle* Lookup(const Slice& key, uint32_t hash, QueryId query_id,
+                        Statistics* statistics);
+  void Release(Cache::Handle* handle);
+  void Erase(const Slice& key, uint32_t hash);
+  size_t Evict(size_t required);
+
+  size_t GetUsage() const {
+    return usage_.load(std::memory_order_relaxed);
+  }
+
+  size_t GetPinnedUsage() const {
+    return pinned_usage_.load(std::memory_order_relaxed);
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t));
+
+  std::pair<size_t, size_t> TEST_GetIndividualUsages() const {
+    auto multi_touch_usage = multi_touch_usage_.load(std::memory_order_relaxed);
+    return std::make_pair(GetUsage() - multi_touch_usage, multi_touch_usage);
+  }
+
+ private:
+  // Increments reference count of the slot. Returns true if the slot was pinned, i.e. contains
+  // a visible or invisible entry, that should be released with Unref.
+  bool TryPin(ClockHandle* h);
+
+  // Releases a reference, and frees the entry if it was the last reference to an invisible one.
+  void Unref(ClockHandle* h);
+
+  // Returns pinned visible entry with specified key, or nullptr if there is no such entry.
+  ClockHandle* FindAndPin(const Slice& key, uint32_t hash);
+
+  // Takes an empty slot into exclusive ownership, or returns nullptr if there is no empty slot
+  // in the probe sequence of the hash.
+  ClockHandle* Occupy(uint32_t hash);
+
+  // Invokes deleter of the entry owned exclusively, and makes its slot empty.
+  void FreeEntry(ClockHandle* h);
+
+  // Moves clock hand for at most max_steps slots, until done(freed_charge, freed_entries) returns
+  // true. Returns charge of evicted entries. When protect_multi_touch is true, multi-touch entries
+  // are skipped while they fit into their share of the capacity.
+  template <class Done>
+  size_t Sweep(size_t max_steps, bool protect_multi_touch, const Done& done);
+
+  // Evicts entries until usage does not exceed capacity. Returns false if it did not succeed.
+  bool EvictToCapacity();
+
+  void AddUsage(SubCacheType type, size_t charge);
+  void SubUsage(SubCacheType type, size_t charge);
+
+  std::unique_ptr<ClockHandle[]> slots_;
+  size_t mask_ = 0;
+  size_t max_probes_ = 0;
+
+  std::atomic<size_t> capacity_{0};
+  bool strict_capacity_limit_ = false;
+
+  // Charge of all entries allocated by the shard, including detached and invisible ones.
+  std::atomic<size_t> usage_{0};
+  std::atomic<size_t> pinned_usage_{0};
+  std::atomic<size_t> multi_touch_usage_{0};
+
+  std::atomic<size_t> clock_hand_{0};
+
+  // Serializes replacement of the existing entry with the same key and publishing of the new one.
+  std::mutex insert_mutex_;
+
+  shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+ClockCacheShard::~ClockCacheShard() {
+  if (!slots_) {
+    return;
+  }
+  // Entries that are still referenced externally are leaked, the same as in LRU cache.
+  for (size_t i = 0; i <= mask_; ++i) {
+    auto& slot = slots_[i];
+    auto meta = slot.meta.load(std::memory_order_acquire);
+    if (GetState(meta) == SlotState::kVisible && GetRefs(meta) == 0) {
+      (*slot.deleter)(slot.key(), slot.value);
+      SubUsage(slot.GetSubCacheType(), slot.charge);
+    }
+  }
+}
+
+void ClockCacheShard::Init(size_t capacity, size_t num_slots, bool strict_capacity_limit) {
+  size_t length = kMinSlotsPerShard;
+  while (length < num_slots) {
+    length *= 2;
+  }
+  slots_.reset(new ClockHandle[length]);
+  mask_ = length - 1;
+  max_probes_ = std::min(length, kMaxProbes);
+  capacity_.store(capacity, std::memory_order_relaxed);
+  strict_capacity_limit_ = strict_capacity_limit;
+}
+
+void ClockCacheShard::AddUsage(SubCacheType type, size_t charge) {
+  if (type == MULTI_TOUCH) {
+    multi_touch_usage_.fetch_add(charge, std::memory_order_relaxed);
+  }
+  if (metrics_) {
+    if (type == MULTI_TOUCH) {
+      metrics_->multi_touch_cache_usage->IncrementBy(charge);
+    } else {
+      metrics_->single_touch_cache_usage->IncrementBy(charge);
+    }
+    metrics_->cache_usage->IncrementBy(charge);
+  }
+}
+
+void ClockCacheShard::SubUsage(SubCacheType type, size_t charge) {
+  usage_.fetch_sub(charge, std::memory_order_relaxed);
+  if (type == MULTI_TOUCH) {
+    multi_touch_usage_.fetch_sub(charge, std::memory_order_relaxed);
+  }
+  if (metrics_) {
+    if (type == MULTI_TOUCH) {
+      metrics_->multi_touch_cache_usage->DecrementBy(charge);
+    } else {
+      metrics_->single_touch_cache_usage->DecrementBy(charge);
+    }
+    metrics_->cache_usage->DecrementBy(charge);
+  }
+}
+
+bool ClockCacheShard::TryPin(ClockHandle* h) {
+  auto old_meta = h->meta.fetch_add(kOneRef, std::memory_order_acq_rel);
+  switch (GetState(old_meta)) {
+    case SlotState::kVisible: FALLTHROUGH_INTENDED;
+    case SlotState::kInvisible:
+      if (GetRefs(old_meta) == 0) {
+        pinned_usage_.fetch_add(h->charge, std::memory_order_relaxed);
+      }
+      return true;
+    case SlotState::kEmpty:
+      // Nobody could take the slot while the reference count is not zero, so undo is safe.
+      h->meta.fetch_sub(kOneRef, std::memory_order_relaxed);
+      return false;
+    case SlotState::kConstruction:
+      // Exclusive owner will overwrite the reference count.
+      return false;
+  }
+  FATAL_INVALID_ENUM_VALUE(SlotState, GetState(old_meta));
+}
+
+void ClockCacheShard::Unref(ClockHandle* h) {
+  const auto charge = h->charge;
+  const bool detached = h->detached;
+  auto old_meta = h->meta.fetch_sub(kOneRef, std::memory_order_acq_rel);
+  DCHECK_GT(GetRefs(old_meta), 0);
+  if (GetRefs(old_meta) != 1) {
+    return;
+  }
+  pinned_usage_.fetch_sub(charge, std::memory_order_relaxed);
+  if (detached) {
+    (*h->deleter)(h->key(), h->value);
+    SubUsage(h->GetSubCacheType(), charge);
+    delete h;
+    return;
+  }
+  if (GetState(old_meta) != SlotState::kInvisible) {
+    return;
+  }
+  // When the entry was pinned concurrently, the thread that pinned it will free it.
+  auto expected = old_meta - kOneRef;
+  if (h->meta.compare_exchange_strong(
+          expected, MakeMeta(SlotState::kConstruction, 0, 0), std::memory_order_acquire)) {
+    FreeEntry(h);
+  }
+}
+
+void ClockCacheShard::FreeEntry(ClockHandle* h) {
+  (*h->deleter)(h->key(), h->value);
+  SubUsage(h->GetSubCacheType(), h->charge);
+  h->ReleaseKey();
+
+  const size_t pos = h - slots_.get();
+  for (size_t i = h->hash & mask_; i != pos; i = (i + 1) & mask_) {
+    slots_[i].displacements.fetch_sub(1, std::memory_order_relaxed);
+  }
+  h->meta.store(0, std::memory_order_release);
+}
+
+ClockHandle* ClockCacheShard::FindAndPin(const Slice& key, uint32_t hash) {
+  size_t index = hash & mask_;
+  for (size_t probe = 0; probe != max_probes_; ++probe) {
+    auto* h = &slots_[(index + probe) & mask_];
+    if (GetState(h->meta.load(std::memory_order_acquire)) == SlotState::kVisible && TryPin(h)) {
+      if (GetState(h->meta.load(std::memory_order_acquire)) == SlotState::kVisible &&
+          h->hash == hash && h->key() == key) {
+        return h;
+      }
+      Unref(h);
+    }
+    if (h->displacements.load(std::memory_order_relaxed) == 0) {
+      break;
+    }
+  }
+  return nullptr;
+}
+
+ClockHandle* ClockCacheShard::Occupy(uint32_t hash) {
+  size_t index = hash & mask_;
+  for (size_t probe = 0; probe != max_probes_; ++probe) {
+    auto* h = &slots_[(index + probe) & mask_];
+    uint64_t expected = 0;
+    if (h->meta.compare_exchange_strong(
+            expected, MakeMeta(SlotState::kConstruction, 0, 0), std::memory_order_acquire)) {
+      return h;
+    }
+    h->displacements.fetch_add(1, std::memory_order_relaxed);
+  }
+  for (size_t probe = 0; probe != max_probes_; ++probe) {
+    slots_[(index + probe) & mask_].displacements.fetch_sub(1, std::memory_order_relaxed);
+  }
+  return nullptr;
+}
+
+template <class Done>
+size_t ClockCacheShard::Sweep(size_t max_steps, bool protect_multi_touch, const Done& done) {
+  const size_t multi_touch_capacity = protect_multi_touch
+      ? static_cast<size_t>((1 - FLAGS_cache_single_touch_ratio) *
+                            capacity_.load(std::memory_order_relaxed))
+      : 0;
+  size_t freed_charge = 0;
+  size_t freed_entries = 0;
+  for (size_t step = 0; step != max_steps && !done(freed_charge, freed_entries); ++step) {
+    auto* h = &slots_[clock_hand_.fetch_add(1, std::memory_order_relaxed) & mask_];
+    auto meta = h->meta.load(std::memory_order_relaxed);
+    if (GetState(meta) != SlotState::kVisible || GetRefs(meta) != 0) {
+      continue;
+    }
+    if (protect_multi_touch && h->GetSubCacheType() == MULTI_TOUCH &&
+        multi_touch_usage_.load(std::memory_order_relaxed) <= multi_touch_capacity) {
+      continue;
+    }
+    if (GetClock(meta) > 0) {
+      h->meta.compare_exchange_strong(meta, meta - kClockOne, std::memory_order_relaxed);
+      continue;
+    }
+    if (h->meta.compare_exchange_strong(
+            meta, MakeMeta(SlotState::kConstruction, 0, 0), std::memory_order_acquire)) {
+      freed_charge += h->charge;
+      ++freed_entries;
+      FreeEntry(h);
+    }
+  }
+  return freed_charge;
+}
+
+bool ClockCacheShard::EvictToCapacity() {
+  // Enough steps to decrement the highest clock counter of every entry down to zero and evict it.
+  const size_t max_steps = (mask_ + 1) * (kMaxClock + 1);
+  const auto capacity = capacity_.load(std::memory_order_relaxed);
+  auto done = [this, capacity](size_t, size_t) {
+    return usage_.load(std::memory_order_relaxed) <= capacity;
+  };
+  // Multi-touch entries are evicted beyond their share only when there are not enough
+  // single-touch ones.
+  Sweep(max_steps, true /* protect_multi_touch */, done);
+  if (!done(0, 0)) {
+    Sweep(max_steps, false /* protect_multi_touch */, done);
+  }
+  return done(0, 0);
+}
+
+void ClockCacheShard::SetCapacity(size_t capacity) {
+  capacity_.store(capacity, std::memory_order_relaxed);
+  EvictToCapacity();
+}
+
+size_t ClockCacheShard::Evict(size_t required) {
+  const size_t max_steps = (mask_ + 1) * (kMaxClock + 1);
+  auto freed_charge = Sweep(max_steps, true /* protect_multi_touch */,
+                            [required](size_t charge, size_t) { return charge >= required; });
+  if (freed_charge < required) {
+    const auto left = required - freed_charge;
+    freed_charge += Sweep(max_steps, false /* protect_multi_touch */,
+                          [left](size_t charge, size_t) { return charge >= left; });
+  }
+  return freed_charge;
+}
+
+Status ClockCacheShard::Insert(
+    const Slice& key, uint32_t hash, QueryId query_id, void* value, size_t charge,
+    void (*deleter)(const Slice& key, void* value), Cache::Handle** handle,
+    Statistics* statistics) {
+  // Don't use the cache if disabled by the caller using the special query id.
+  if (query_id == kNoCacheQueryId) {
+    return Status::OK();
+  }
+  if (FLAGS_cache_single_touch_ratio == 0) {
+    query_id = kInMultiTouchId;
+  } else if (FLAGS_cache_single_touch_ratio == 1 && query_id == kInMultiTouchId) {
+    query_id = kDefaultQueryId;
+  }
+  const auto subcache_type = query_id == kInMultiTouchId ? MULTI_TOUCH : SINGLE_TOUCH;
+
+  const auto capacity = capacity_.load(std::memory_order_relaxed);
+  if (usage_.fetch_add(charge, std::memory_order_relaxed) + charge > capacity &&
+      !EvictToCapacity() && strict_capacity_limit_) {
+    usage_.fetch_sub(charge, std::memory_order_relaxed);
+    if (handle == nullptr) {
+      (*deleter)(key, value);
+    } else {
+      *handle = nullptr;
+    }
+    RecordTick(statistics, BLOCK_CACHE_ADD_FAILURES);
+    return STATUS(Incomplete, "Insert failed due to CLOCK cache being full.");
+  }
+
+  std::lock_guard<std::mutex> lock(insert_mutex_);
+  // New entry replaces the existing one.
+  Erase(key, hash);
+
+  auto* h = Occupy(hash);
+  if (!h) {
+    // All slots in the probe sequence are occupied, try to free one of them.
+    Sweep((mask_ + 1) * (kMaxClock + 1), false /* protect_multi_touch */,
+          [](size_t, size_t freed_entries) { return freed_entries != 0; });
+    h = Occupy(hash);
+  }
+  if (!h) {
+    if (handle == nullptr) {
+      // Entry could not be cached, as if it was immediately evicted.
+      usage_.fetch_sub(charge, std::memory_order_relaxed);
+      (*deleter)(key, value);
+      return Status::OK();
+    }
+    h = new ClockHandle;
+    h->detached = true;
+  }
+
+  h->hash = hash;
+  h->query_id.store(query_id, std::memory_order_relaxed);
+  h->value = value;
+  h->deleter = deleter;
+  h->charge = charge;
+  h->AssignKey(key);
+
+  AddUsage(subcache_type, charge);
+  const uint64_t refs = handle ? 1 : 0;
+  if (refs) {
+    pinned_usage_.fetch_add(charge, std::memory_order_relaxed);
+  }
+  h->meta.store(
+      MakeMeta(SlotState::kVisible, subcache_type == MULTI_TOUCH ? kMaxClock : 0, refs),
+      std::memory_order_release);
+  if (handle) {
+    *handle = reinterpret_cast<Cache::Handle*>(h);
+  }
+
+  if (statistics != nullptr) {
+    RecordTick(statistics, BLOCK_CACHE_ADD);
+    RecordTick(statistics, BLOCK_CACHE_BYTES_WRITE, charge);
+    if (subcache_type == SubCacheType::SINGLE_TOUCH) {
+      RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_ADD);
+      RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_WRITE, charge);
+    } else {
+      RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_ADD);
+      RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, charge);
+    }
+  }
+  return Status::OK();
+}
+
+Cache::Handle* ClockCacheShard::Lookup(
+    const Slice& key, uint32_t hash, QueryId query_id, Statistics* statistics) {
+  auto* h = FindAndPin(key, hash);
+  if (h != nullptr) {
+    auto entry_query_id = h->query_id.load(std::memory_order_relaxed);
+    if (entry_query_id == kInMultiTouchId) {
+      h->meta.fetch_or(kClockMask, std::memory_order_relaxed);
+    } else if (entry_query_id != query_id && FLAGS_cache_single_touch_ratio < 1 &&
+               h->query_id.compare_exchange_strong(
+                   entry_query_id, kInMultiTouchId, std::memory_order_relaxed)) {
+      // Touched by another query, so promote to multi-touch.
+      multi_touch_usage_.fetch_add(h->charge, std::memory_order_relaxed);
+      if (metrics_) {
+        metrics_->multi_touch_cache_usage->IncrementBy(h->charge);
+        metrics_->single_touch_cache_usage->DecrementBy(h->charge);
+      }
+      h->meta.fetch_or(kClockMask, std::memory_order_relaxed);
+    } else {
+      h->meta.fetch_or(kClockOne, std::memory_order_relaxed);
+    }
+
+    if (statistics != nullptr) {
+      RecordTick(statistics, BLOCK_CACHE_HIT);
+      RecordTick(statistics, BLOCK_CACHE_BYTES_READ, h->charge);
+      if (h->GetSubCacheType() == SubCacheType::SINGLE_TOUCH) {
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_READ, h->charge);
+      } else {
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, h->charge);
+      }
+    }
+  } else if (statistics != nullptr) {
+    RecordTick(statistics, BLOCK_CACHE_MISS);
+  }
+
+  if (metrics_ != nullptr) {
+    metrics_->lookups->Increment();
+    if (h != nullptr) {
+      metrics_->cache_hits->Increment();
+    } else {
+      metrics_->cache_misses->Increment();
+    }
+  }
+  return reinterpret_cast<Cache::Handle*>(h);
+}
+
+void ClockCacheShard::Release(Cache::Handle* handle) {
+  if (handle == nullptr) {
+    return;
+  }
+  auto* h = reinterpret_cast<ClockHandle*>(handle);
+  const auto charge = h->charge;
+  const bool visible = !h->detached &&
+                       GetState(h->meta.load(std::memory_order_relaxed)) == SlotState::kVisible;
+  Unref(h);
+  // Entry that was kept over capacity because it was referenced, could be evicted now.
+  if (visible &&
+      usage_.load(std::memory_order_relaxed) > capacity_.load(std::memory_order_relaxed)) {
+    Sweep(mask_ + 1, true /* protect_multi_touch */, [this, charge](size_t freed_charge, size_t) {
+      return freed_charge >= charge ||
+             usage_.load(std::memory_order_relaxed) <= capacity_.load(std::memory_order_relaxed);
+    });
+  }
+}
+
+void ClockCacheShard::Erase(const Slice& key, uint32_t hash) {
+  while (auto* h = FindAndPin(key, hash)) {
+    auto meta = h->meta.load(std::memory_order_relaxed);
+    while (GetState(meta) == SlotState::kVisible &&
+           !h->meta.compare_exchange_weak(
+               meta, (meta & ~kStateMask) | MakeMeta(SlotState::kInvisible, 0, 0),
+               std::memory_order_acq_rel)) {
+    }
+    Unref(h);
+  }
+}
+
+void ClockCacheShard::ApplyToAllCacheEntries(void (*callback)(void*, size_t)) {
+  for (size_t i = 0; i <= mask_; ++i) {
+    auto* h = &slots_[i];
+    if (GetState(h->meta.load(std::memory_order_acquire)) != SlotState::kVisible || !TryPin(h)) {
+      continue;
+    }
+    if (GetState(h->meta.load(std::memory_order_acquire)) == SlotState::kVisible) {
+      callback(h->value, h->charge);
+    }
+    Unref(h);
+  }
+}
+
+static int kNumShardBits = 4;          // default values, can be overridden
+
+class ShardedClockCache : public Cache {
+ public:
+  ShardedClockCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit,
+                    size_t estimated_entry_charge)
+      : num_shard_bits_(num_shard_bits),
+        capacity_(capacity),
+        strict_capacity_limit_(strict_capacity_limit) {
+    const size_t num_shards = 1ULL << num_shard_bits_;
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    const size_t slots_per_shard = static_cast<size_t>(
+        per_shard / std::max<size_t>(estimated_entry_charge, 1) / kLoadFactor) + 1;
+    shards_ = new ClockCacheShard[num_shards];
+    for (size_t s = 0; s < num_shards; s++) {
+      shards_[s].Init(per_shard, slots_per_shard, strict_capacity_limit);
+    }
+  }
+
+  virtual ~ShardedClockCache() {
+    delete[] shards_;
+  }
+
+  void SetCapacity(size_t capacity) override {
+    const size_t num_shards = 1ULL << num_shard_bits_;
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    std::lock_guard<std::mutex> lock(capacity_mutex_);
+    for (size_t s = 0; s < num_shards; s++) {
+      shards_[s].SetCapacity(per_shard);
+    }
+    capacity_ = capacity;
+  }
+
+  Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value),
+                Handle** handle, Statistics* statistics) override {
+    // Queries with no cache query ids are not cached.
+    if (query_id == kNoCacheQueryId) {
+      return Status::OK();
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Insert(key, hash, query_id, value, charge, deleter,
+                                       handle, statistics);
+  }
+
+  size_t Evict(size_t bytes_to_evict) override {
+    const size_t num_shards = 1ULL << num_shard_bits_;
+    size_t total_evicted = 0;
+    // Start at random shard.
+    auto index = Shard(yb::RandomUniformInt<uint32_t>());
+    for (size_t i = 0; bytes_to_evict > total_evicted && i != num_shards; ++i) {
+      total_evicted += shards_[index].Evict(bytes_to_evict - total_evicted);
+      index = (index + 1) & (num_shards - 1);
+    }
+    return total_evicted;
+  }
+
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics) override {
+    if (query_id == kNoCacheQueryId) {
+      return nullptr;
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Lookup(key, hash, query_id, statistics);
+  }
+
+  void Release(Handle* handle) override {
+    if (handle == nullptr) {
+      return;
+    }
+    shards_[Shard(reinterpret_cast<ClockHandle*>(handle)->hash)].Release(handle);
+  }
+
+  void Erase(const Slice& key) override {
+    const uint32_t hash = HashSlice(key);
+    shards_[Shard(hash)].Erase(key, hash);
+  }
+
+  void* Value(Handle* handle) override {
+    return reinterpret_cast<ClockHandle*>(handle)->value;
+  }
+
+  uint64_t NewId() override {
+    return last_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  size_t GetCapacity() const override { return capacity_; }
+
+  bool HasStrictCapacityLimit() const override {
+    return strict_capacity_limit_;
+  }
+
+  size_t GetUsage() const override {
+    const size_t num_shards = 1ULL << num_shard_bits_;
+    size_t usage = 0;
+    for (size_t s = 0; s < num_shards; s++) {
+      usage += shards_[s].GetUsage();
+    }
+    return usage;
+  }
+
+  size_t GetUsage(Handle* handle) const override {
+    return reinterpret_cast<ClockHandle*>(handle)->charge;
+  }
+
+  size_t GetPinnedUsage() const override {
+    const size_t num_shards = 1ULL << num_shard_bits_;
+    size_t usage = 0;
+    for (size_t s = 0; s < num_shards; s++) {
+      usage += shards_[s].GetPinnedUsage();
+    }
+    return usage;
+  }
+
+  SubCacheType GetSubCacheType(Handle* e) const override {
+    return reinterpret_cast<ClockHandle*>(e)->GetSubCacheType();
+  }
+
+  void DisownData() override {
+    shards_ = nullptr;
+  }
+
+  // Shards are not locked, so entries are always visited in thread safe manner.
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) override {
+    const size_t num_shards = 1ULL << num_shard_bits_;
+    for (size_t s = 0; s < num_shards; s++) {
+      shards_[s].ApplyToAllCacheEntries(callback);
+    }
+  }
+
+  void SetMetrics(
+      const scoped_refptr<yb::MetricEntity>& entity, yb::BlockCacheKind kind) override {
+    const size_t num_shards = 1ULL << num_shard_bits_;
+    metrics_ = std::make_shared<yb::CacheMetrics>(entity, kind);
+    for (size_t s = 0; s < num_shards; s++) {
+      shards_[s].SetMetrics(metrics_);
+    }
+  }
+
+  std::vector<std::pair<size_t, size_t>> TEST_GetIndividualUsages() override {
+    std::vector<std::pair<size_t, size_t>> cache_sizes;
+    cache_sizes.reserve(1 << num_shard_bits_);
+
+    for (int i = 0; i < 1 << num_shard_bits_; ++i) {
+      cache_sizes.emplace_back(shards_[i].TEST_GetIndividualUsages());
+    }
+    return cache_sizes;
+  }
+
+ private:
+  static inline uint32_t HashSlice(const Slice& s) {
+    return Hash(s.data(), s.size(), 0);
+  }
+
+  uint32_t Shard(uint32_t hash) const {
+    // Note, hash >> 32 yields hash in gcc, not the zero we expect!
+    return (num_shard_bits_ > 0) ? (hash >> (32 - num_shard_bits_)) : 0;
+  }
+
+  ClockCacheShard* shards_;
+  std::atomic<uint64_t> last_id_{0};
+  std::mutex capacity_mutex_;
+  const size_t num_shard_bits_;
+  size_t capacity_;
+  const bool strict_capacity_limit_;
+  shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+}  // namespace
+
+shared_ptr<Cache> NewClockCache(size_t capacity) {
+  return NewClockCache(capacity, kNumShardBits, false, kDefaultClockCacheEntryCharge);
+}
+
+shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits) {
+  return NewClockCache(capacity, num_shard_bits, false, kDefaultClockCacheEntryCharge);
+}
+
+shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit,
+                                size_t estimated_entry_charge) {
+  if (num_shard_bits >= 20) {
+    return nullptr;  // the cache cannot be sharded into too many fine pieces
+  }
+  return std::make_shared<ShardedClockCache>(
+      capacity, num_shard_bits, strict_capacity_limit, estimated_entry_charge);
+}
+
+}  // namespace rocksdb
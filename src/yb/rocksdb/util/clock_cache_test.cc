@@ -0,0 +1,247 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/testharness.h"
+
+namespace rocksdb {
+
+namespace {
+
+std::string EncodeKey(int k) {
+  std::string result;
+  PutFixed32(&result, k);
+  return result;
+}
+
+void* EncodeValue(uintptr_t v) { return reinterpret_cast<void*>(v); }
+
+int DecodeValue(void* v) {
+  return static_cast<int>(reinterpret_cast<uintptr_t>(v));
+}
+
+std::atomic<int> num_deleted{0};
+
+void Deleter(const Slice& key, void* v) {
+  ++num_deleted;
+}
+
+constexpr QueryId kTestQueryId = 1;
+constexpr QueryId kOtherQueryId = 2;
+
+constexpr int kCapacity = 100;
+
+} // namespace
+
+class ClockCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    num_deleted = 0;
+  }
+
+  Status Insert(int key, int value, QueryId query_id = kTestQueryId, size_t charge = 1) {
+    return cache_->Insert(EncodeKey(key), query_id, EncodeValue(value), charge, &Deleter);
+  }
+
+  int Lookup(int key, QueryId query_id = kTestQueryId) {
+    auto* handle = cache_->Lookup(EncodeKey(key), query_id);
+    if (handle == nullptr) {
+      return -1;
+    }
+    auto result = DecodeValue(cache_->Value(handle));
+    cache_->Release(handle);
+    return result;
+  }
+
+  shared_ptr<Cache> cache_ = NewClockCache(
+      kCapacity, 0 /* num_shard_bits */, false /* strict_capacity_limit */,
+      1 /* estimated_entry_charge */);
+};
+
+TEST_F(ClockCacheTest, HitAndMiss) {
+  ASSERT_EQ(-1, Lookup(100));
+
+  ASSERT_OK(Insert(100, 101));
+  ASSERT_EQ(101, Lookup(100));
+  ASSERT_EQ(-1, Lookup(200));
+
+  ASSERT_OK(Insert(200, 201));
+  ASSERT_EQ(101, Lookup(100));
+  ASSERT_EQ(201, Lookup(200));
+
+  // Insert with the same key replaces the value.
+  ASSERT_OK(Insert(100, 102));
+  ASSERT_EQ(102, Lookup(100));
+  ASSERT_EQ(1, num_deleted.load());
+  ASSERT_EQ(2U, cache_->GetUsage());
+}
+
+TEST_F(ClockCacheTest, Erase) {
+  cache_->Erase(EncodeKey(200));
+  ASSERT_EQ(0, num_deleted.load());
+
+  ASSERT_OK(Insert(100, 101));
+  ASSERT_OK(Insert(200, 201));
+  cache_->Erase(EncodeKey(100));
+  ASSERT_EQ(-1, Lookup(100));
+  ASSERT_EQ(201, Lookup(200));
+  ASSERT_EQ(1, num_deleted.load());
+  ASSERT_EQ(1U, cache_->GetUsage());
+}
+
+TEST_F(ClockCacheTest, EntriesArePinned) {
+  ASSERT_OK(Insert(100, 101));
+  auto* h1 = cache_->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_EQ(101, DecodeValue(cache_->Value(h1)));
+  ASSERT_EQ(1U, cache_->GetPinnedUsage());
+
+  cache_->Erase(EncodeKey(100));
+  ASSERT_EQ(-1, Lookup(100));
+  // Erased entry is freed only after the last release.
+  ASSERT_EQ(0, num_deleted.load());
+  ASSERT_EQ(101, DecodeValue(cache_->Value(h1)));
+
+  cache_->Release(h1);
+  ASSERT_EQ(1, num_deleted.load());
+  ASSERT_EQ(0U, cache_->GetUsage());
+  ASSERT_EQ(0U, cache_->GetPinnedUsage());
+}
+
+TEST_F(ClockCacheTest, Capacity) {
+  for (int i = 0; i != 10 * kCapacity; ++i) {
+    ASSERT_OK(Insert(i, i));
+    ASSERT_LE(cache_->GetUsage(), static_cast<size_t>(kCapacity));
+  }
+  // The most recently inserted entry is not evicted.
+  ASSERT_EQ(10 * kCapacity - 1, Lookup(10 * kCapacity - 1));
+}
+
+TEST_F(ClockCacheTest, ScanResistance) {
+  // Entries touched by several queries are kept, while a long scan passes through the cache.
+  constexpr int kNumHot = kCapacity / 4;
+  for (int i = 0; i != kNumHot; ++i) {
+    ASSERT_OK(Insert(i, i));
+    ASSERT_EQ(i, Lookup(i, kOtherQueryId));
+    auto* handle = cache_->Lookup(EncodeKey(i), kTestQueryId);
+    ASSERT_EQ(MULTI_TOUCH, cache_->GetSubCacheType(handle));
+    cache_->Release(handle);
+  }
+
+  for (int i = kNumHot; i != 10 * kCapacity; ++i) {
+    ASSERT_OK(Insert(i, i, kTestQueryId));
+    // Repeated touches by the same query do not promote the entry.
+    ASSERT_EQ(i, Lookup(i, kTestQueryId));
+  }
+
+  for (int i = 0; i != kNumHot; ++i) {
+    ASSERT_EQ(i, Lookup(i, kOtherQueryId));
+  }
+}
+
+TEST_F(ClockCacheTest, StrictCapacityLimit) {
+  auto cache = NewClockCache(
+      10, 0 /* num_shard_bits */, true /* strict_capacity_limit */,
+      1 /* estimated_entry_charge */);
+  std::vector<Cache::Handle*> handles(10);
+  for (int i = 0; i != 10; ++i) {
+    ASSERT_OK(cache->Insert(EncodeKey(i), kTestQueryId, EncodeValue(i), 1, &Deleter, &handles[i]));
+  }
+  Cache::Handle* handle = nullptr;
+  auto status = cache->Insert(EncodeKey(10), kTestQueryId, EncodeValue(10), 1, &Deleter, &handle);
+  ASSERT_TRUE(status.IsIncomplete()) << status;
+  ASSERT_EQ(nullptr, handle);
+
+  for (auto* h : handles) {
+    cache->Release(h);
+  }
+  ASSERT_OK(cache->Insert(EncodeKey(10), kTestQueryId, EncodeValue(10), 1, &Deleter));
+  ASSERT_LE(cache->GetUsage(), 10U);
+}
+
+TEST_F(ClockCacheTest, Evict) {
+  for (int i = 0; i != kCapacity; ++i) {
+    ASSERT_OK(Insert(i, i));
+  }
+  ASSERT_EQ(kCapacity / 2U, cache_->Evict(kCapacity / 2));
+  ASSERT_EQ(kCapacity / 2U, cache_->GetUsage());
+}
+
+TEST_F(ClockCacheTest, Concurrent) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumOps = 100000;
+  constexpr int kNumKeys = 1000;
+  auto cache = NewClockCache(
+      kNumKeys / 2, 2 /* num_shard_bits */, false /* strict_capacity_limit */,
+      1 /* estimated_entry_charge */);
+  std::atomic<int> num_inserted{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([&cache, &num_inserted, t] {
+      for (int i = 0; i != kNumOps; ++i) {
+        auto key = EncodeKey((i * 7919 + t) % kNumKeys);
+        switch (i % 10) {
+          case 0: case 1: case 2:
+            ASSERT_OK(cache->Insert(key, t, EncodeValue(i), 1, &Deleter));
+            ++num_inserted;
+            break;
+          case 3:
+            cache->Erase(key);
+            break;
+          default:
+            if (auto* handle = cache->Lookup(key, t)) {
+              cache->Release(handle);
+            }
+            break;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(0U, cache->GetPinnedUsage());
+  cache.reset();
+  ASSERT_EQ(num_inserted.load(), num_deleted.load());
+}
+
+// Concurrent inserts of the same key replace each other, and do not leave duplicate entries.
+TEST_F(ClockCacheTest, ConcurrentInsertSameKey) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumOps = 10000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([this, t] {
+      for (int i = 0; i != kNumOps; ++i) {
+        ASSERT_OK(Insert(100, t * kNumOps + i, t));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(1U, cache_->GetUsage());
+  ASSERT_EQ(kNumThreads * kNumOps - 1, num_deleted.load());
+  ASSERT_NE(-1, Lookup(100));
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
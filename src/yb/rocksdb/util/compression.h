@@ -25,7 +25,9 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/util/coding.h"
@@ -49,6 +51,11 @@
 
 #if defined(ZSTD)
 #include <zstd.h>
+// Digested dictionaries and dictionary training are stable since ZSTD 1.1.3.
+#if ZSTD_VERSION_NUMBER >= 10103
+#include <zdict.h>
+#define ROCKSDB_ZSTD_DICT
+#endif
 #endif
 
 namespace rocksdb {
@@ -88,6 +95,13 @@ inline bool ZSTD_Supported() {
   return false;
 }
 
+inline bool ZSTD_DictSupported() {
+#ifdef ROCKSDB_ZSTD_DICT
+  return true;
+#endif
+  return false;
+}
+
 inline bool CompressionTypeSupported(CompressionType compression_type) {
   switch (compression_type) {
     case kNoCompression:
@@ -620,8 +634,97 @@ inline bool LZ4HC_Compress(const CompressionOptions& opts,
   return false;
 }
 
+// Dictionary used to compress data blocks of a single table file, together with its digested
+// form. Could be shared by multiple threads.
+class CompressionDict {
+ public:
+  CompressionDict(std::string dict, int level) : dict_(std::move(dict)) {
+#ifdef ROCKSDB_ZSTD_DICT
+    cdict_ = ZSTD_createCDict(dict_.data(), dict_.size(), level);
+#endif
+  }
+
+  ~CompressionDict() {
+#ifdef ROCKSDB_ZSTD_DICT
+    ZSTD_freeCDict(cdict_);
+#endif
+  }
+
+  CompressionDict(const CompressionDict&) = delete;
+  void operator=(const CompressionDict&) = delete;
+
+  const std::string& raw() const { return dict_; }
+
+#ifdef ROCKSDB_ZSTD_DICT
+  ZSTD_CDict* zstd_cdict() const { return cdict_; }
+#endif
+
+ private:
+  std::string dict_;
+#ifdef ROCKSDB_ZSTD_DICT
+  ZSTD_CDict* cdict_ = nullptr;
+#endif
+};
+
+// Digested dictionary for decompression of data blocks of a table file. Could be shared by
+// multiple threads.
+class UncompressionDict {
+ public:
+  explicit UncompressionDict(const Slice& dict) {
+#ifdef ROCKSDB_ZSTD_DICT
+    ddict_ = ZSTD_createDDict(dict.data(), dict.size());
+#endif
+  }
+
+  ~UncompressionDict() {
+#ifdef ROCKSDB_ZSTD_DICT
+    ZSTD_freeDDict(ddict_);
+#endif
+  }
+
+  UncompressionDict(const UncompressionDict&) = delete;
+  void operator=(const UncompressionDict&) = delete;
+
+#ifdef ROCKSDB_ZSTD_DICT
+  ZSTD_DDict* zstd_ddict() const { return ddict_; }
+#endif
+
+  bool valid() const {
+#ifdef ROCKSDB_ZSTD_DICT
+    return ddict_ != nullptr;
+#endif
+    return false;
+  }
+
+ private:
+#ifdef ROCKSDB_ZSTD_DICT
+  ZSTD_DDict* ddict_ = nullptr;
+#endif
+};
+
+// Trains ZSTD dictionary of at most max_dict_bytes from samples, that are stored one after
+// another. Returns empty string if the dictionary could not be trained, for instance when there
+// are too few samples.
+inline std::string ZSTD_TrainDictionary(const std::string& samples,
+                                        const std::vector<size_t>& sample_lens,
+                                        size_t max_dict_bytes) {
+#ifdef ROCKSDB_ZSTD_DICT
+  std::string dict(max_dict_bytes, '\0');
+  size_t dict_len = ZDICT_trainFromBuffer(
+      &dict[0], max_dict_bytes, samples.data(), sample_lens.data(),
+      static_cast<unsigned>(sample_lens.size()));
+  if (ZDICT_isError(dict_len)) {
+    return std::string();
+  }
+  dict.resize(dict_len);
+  return dict;
+#endif
+  return std::string();
+}
+
 inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
-                          size_t length, ::std::string* output) {
+                          size_t length, ::std::string* output,
+                          const CompressionDict* dict = nullptr) {
 #ifdef ZSTD
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -633,9 +736,23 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 
   size_t compressBound = ZSTD_compressBound(length);
   output->resize(static_cast<size_t>(output_header_len + compressBound));
-  size_t outlen = ZSTD_compress(&(*output)[output_header_len], compressBound,
-                                input, length, opts.level);
-  if (outlen == 0) {
+  size_t outlen;
+#ifdef ROCKSDB_ZSTD_DICT
+  if (dict != nullptr && dict->zstd_cdict() != nullptr) {
+    struct CCtxDeleter {
+      void operator()(ZSTD_CCtx* cctx) const { ZSTD_freeCCtx(cctx); }
+    };
+    static thread_local std::unique_ptr<ZSTD_CCtx, CCtxDeleter> cctx(ZSTD_createCCtx());
+    outlen = ZSTD_compress_usingCDict(cctx.get(), &(*output)[output_header_len],
+                                      compressBound, input, length, dict->zstd_cdict());
+  } else {
+    outlen = ZSTD_compress(&(*output)[output_header_len], compressBound, input, length,
+                           opts.level);
+  }
+#else
+  outlen = ZSTD_compress(&(*output)[output_header_len], compressBound, input, length, opts.level);
+#endif
+  if (outlen == 0 || ZSTD_isError(outlen)) {
     return false;
   }
   output->resize(output_header_len + outlen);
@@ -645,7 +762,8 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 }
 
 inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
-                             int* decompress_size) {
+                             int* decompress_size,
+                             const UncompressionDict* dict = nullptr) {
 #ifdef ZSTD
   uint32_t output_len = 0;
   if (!compression::GetDecompressedSizeInfo(&input_data, &input_length,
@@ -654,9 +772,27 @@ inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
   }
 
   char* output = new char[output_len];
-  size_t actual_output_length =
-      ZSTD_decompress(output, output_len, input_data, input_length);
-  assert(actual_output_length == output_len);
+  size_t actual_output_length;
+  if (dict != nullptr) {
+#ifdef ROCKSDB_ZSTD_DICT
+    struct DCtxDeleter {
+      void operator()(ZSTD_DCtx* dctx) const { ZSTD_freeDCtx(dctx); }
+    };
+    static thread_local std::unique_ptr<ZSTD_DCtx, DCtxDeleter> dctx(ZSTD_createDCtx());
+    actual_output_length = dict->valid()
+        ? ZSTD_decompress_usingDDict(
+              dctx.get(), output, output_len, input_data, input_length, dict->zstd_ddict())
+        : 0;
+#else
+    actual_output_length = 0;
+#endif
+  } else {
+    actual_output_length = ZSTD_decompress(output, output_len, input_data, input_length);
+  }
+  if (actual_output_length != output_len) {
+    delete[] output;
+    return nullptr;
+  }
   *decompress_size = static_cast<int>(actual_output_length);
   return output;
 #endif
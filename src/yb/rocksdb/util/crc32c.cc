@@ -388,6 +388,141 @@ uint32_t ExtendImpl(uint32_t crc, const char* buf, size_t size) {
   return static_cast<uint32_t>(l ^ 0xffffffffu);
 }
 
+#if defined(__SSE4_2__) && defined(__LP64__)
+#define HAVE_INTERLEAVED_CRC32
+
+// CRC32C of a large buffer is computed as 3 interleaved streams, so the latency of the crc32
+// instruction is hidden. CRC of a stream is combined with the following one by shifting it over
+// the stream length, i.e. computing CRC of the stream followed by zeros, using precomputed tables.
+static constexpr size_t kLongStreamSize = 8192;
+static constexpr size_t kShortStreamSize = 256;
+
+// Reversed CRC32C polynomial.
+static constexpr uint32_t kCrc32cPoly = 0x82f63b78;
+
+static uint32_t Gf2MatrixTimes(const uint32_t* mat, uint32_t vec) {
+  uint32_t sum = 0;
+  while (vec) {
+    if (vec & 1) {
+      sum ^= *mat;
+    }
+    vec >>= 1;
+    ++mat;
+  }
+  return sum;
+}
+
+static void Gf2MatrixSquare(uint32_t* square, const uint32_t* mat) {
+  for (int n = 0; n != 32; ++n) {
+    square[n] = Gf2MatrixTimes(mat, mat[n]);
+  }
+}
+
+class ZerosShifter {
+ public:
+  // length should be a power of two.
+  explicit ZerosShifter(size_t length) {
+    uint32_t even[32];
+    uint32_t odd[32];
+    // Operator for one zero bit.
+    odd[0] = kCrc32cPoly;
+    uint32_t row = 1;
+    for (int n = 1; n != 32; ++n) {
+      odd[n] = row;
+      row <<= 1;
+    }
+    // Operators for 2 and 4 zero bits.
+    Gf2MatrixSquare(even, odd);
+    Gf2MatrixSquare(odd, even);
+    // Each square doubles the number of zero bits, the first one gives operator for 1 zero byte.
+    const uint32_t* op = odd;
+    for (;;) {
+      Gf2MatrixSquare(even, odd);
+      op = even;
+      length >>= 1;
+      if (length == 0) {
+        break;
+      }
+      Gf2MatrixSquare(odd, even);
+      op = odd;
+      length >>= 1;
+      if (length == 0) {
+        break;
+      }
+    }
+    for (uint32_t n = 0; n != 256; ++n) {
+      table_[0][n] = Gf2MatrixTimes(op, n);
+      table_[1][n] = Gf2MatrixTimes(op, n << 8);
+      table_[2][n] = Gf2MatrixTimes(op, n << 16);
+      table_[3][n] = Gf2MatrixTimes(op, n << 24);
+    }
+  }
+
+  uint32_t Shift(uint32_t crc) const {
+    return table_[0][crc & 0xff] ^ table_[1][(crc >> 8) & 0xff] ^
+           table_[2][(crc >> 16) & 0xff] ^ table_[3][crc >> 24];
+  }
+
+ private:
+  uint32_t table_[4][256];
+};
+
+static inline void InterleavedStreams(
+    size_t stream_size, const ZerosShifter& shifter, uint64_t* crc, uint8_t const **p,
+    size_t* size) {
+  while (*size >= stream_size * 3) {
+    uint64_t crc0 = *crc;
+    uint64_t crc1 = 0;
+    uint64_t crc2 = 0;
+    const uint8_t* next = *p;
+    const uint8_t* end = next + stream_size;
+    do {
+      crc0 = _mm_crc32_u64(crc0, LE_LOAD64(next));
+      crc1 = _mm_crc32_u64(crc1, LE_LOAD64(next + stream_size));
+      crc2 = _mm_crc32_u64(crc2, LE_LOAD64(next + stream_size * 2));
+      next += 8;
+    } while (next != end);
+    crc0 = shifter.Shift(static_cast<uint32_t>(crc0)) ^ crc1;
+    *crc = shifter.Shift(static_cast<uint32_t>(crc0)) ^ crc2;
+    *p += stream_size * 3;
+    *size -= stream_size * 3;
+  }
+}
+
+static uint32_t ExtendInterleaved(uint32_t crc, const char* buf, size_t size) {
+  static const ZerosShifter long_shifter(kLongStreamSize);
+  static const ZerosShifter short_shifter(kShortStreamSize);
+
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(buf);
+  uint64_t l = crc ^ 0xffffffffu;
+  while (size != 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0) {
+    l = _mm_crc32_u8(static_cast<uint32_t>(l), *p++);
+    --size;
+  }
+  InterleavedStreams(kLongStreamSize, long_shifter, &l, &p, &size);
+  InterleavedStreams(kShortStreamSize, short_shifter, &l, &p, &size);
+  while (size >= 8) {
+    l = _mm_crc32_u64(l, LE_LOAD64(p));
+    p += 8;
+    size -= 8;
+  }
+  while (size != 0) {
+    l = _mm_crc32_u8(static_cast<uint32_t>(l), *p++);
+    --size;
+  }
+  return static_cast<uint32_t>(l ^ 0xffffffffu);
+}
+
+// Large buffers could be checksummed as interleaved streams, small buffers do not benefit from it.
+static uint32_t ExtendFast(uint32_t crc, const char* buf, size_t size) {
+  if (size >= kShortStreamSize * 3) {
+    return ExtendInterleaved(crc, buf, size);
+  }
+  return ExtendImpl<Fast_CRC32>(crc, buf, size);
+}
+
+#endif
+
 // Detect if SS42 or not.
 static bool isSSE42() {
 #if defined(__GNUC__) && defined(__x86_64__) && !defined(IOS_CROSS_COMPILE)
@@ -403,7 +538,11 @@ static bool isSSE42() {
 typedef uint32_t (*Function)(uint32_t, const char*, size_t);
 
 static inline Function Choose_Extend() {
+#ifdef HAVE_INTERLEAVED_CRC32
+  return isSSE42() ? ExtendFast : ExtendImpl<Slow_CRC32>;
+#else
   return isSSE42() ? ExtendImpl<Fast_CRC32> : ExtendImpl<Slow_CRC32>;
+#endif
 }
 
 bool IsFastCrc32Supported() {
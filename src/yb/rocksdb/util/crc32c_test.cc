@@ -21,6 +21,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <algorithm>
+#include <string>
+
 #include "yb/rocksdb/util/crc32c.h"
 #include "yb/rocksdb/util/testharness.h"
 
@@ -75,6 +78,24 @@ TEST(CRC, Extend) {
             Extend(Value("hello ", 6), "world", 5));
 }
 
+TEST(CRC, LargeBuffers) {
+  // Large buffers are checksummed as interleaved streams, while small pieces are not, so the
+  // results should match.
+  std::string data(100000, 0);
+  for (size_t i = 0; i != data.size(); ++i) {
+    data[i] = static_cast<char>(i * 7 + (i >> 8));
+  }
+  for (size_t size : {768, 1000, 24576, 24581, 100000 - 7}) {
+    for (size_t offset : {0, 1, 7}) {
+      uint32_t expected = 0;
+      for (size_t i = 0; i < size; i += 100) {
+        expected = Extend(expected, data.data() + offset + i, std::min<size_t>(100, size - i));
+      }
+      ASSERT_EQ(expected, Value(data.data() + offset, size)) << size << ", " << offset;
+    }
+  }
+}
+
 TEST(CRC, Mask) {
   uint32_t crc = Value("foo", 3);
   ASSERT_NE(crc, Mask(crc));
@@ -52,6 +52,9 @@
 #endif
 #include <deque>
 #include <set>
+
+#include <gflags/gflags.h>
+
 #include "yb/rocksdb/port/port.h"
 #include "yb/util/slice.h"
 #include "yb/rocksdb/options.h"
@@ -78,6 +81,9 @@
 #endif
 
 #include "yb/util/file_system_posix.h"
+#include "yb/util/logging.h"
+
+DECLARE_bool(rocksdb_use_io_uring);
 
 #define STATUS_IO_ERROR(context, err_number) STATUS(IOError, (context), strerror(err_number))
 
@@ -600,9 +606,10 @@ class PosixRocksDBFileFactory : public RocksDBFileFactory {
     result->reset();
     Status s;
     int fd;
+    bool direct = options.use_direct_io && !options.use_mmap_reads;
     {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_RDONLY);
+      fd = OpenMaybeDirect(fname, O_RDONLY, 0, &direct);
     }
     SetFD_CLOEXEC(fd, &options);
     if (fd < 0) {
@@ -622,6 +629,10 @@ class PosixRocksDBFileFactory : public RocksDBFileFactory {
         }
       }
       close(fd);
+    } else if (direct || FLAGS_rocksdb_use_io_uring) {
+      EnvOptions async_options = options;
+      async_options.use_direct_io = direct;
+      *result = std::make_unique<PosixAsyncRandomAccessFile>(fname, fd, async_options);
     } else {
       *result = std::make_unique<yb::PosixRandomAccessFile>(fname, fd, options);
     }
@@ -634,12 +645,16 @@ class PosixRocksDBFileFactory : public RocksDBFileFactory {
     result->reset();
     Status s;
     int fd = -1;
+    bool direct = options.use_direct_io;
     do {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+      fd = OpenMaybeDirect(fname, O_CREAT | O_RDWR | O_TRUNC, 0644, &direct);
     } while (fd < 0 && errno == EINTR);
     if (fd < 0) {
       s = STATUS_IO_ERROR(fname, errno);
+    } else if (direct) {
+      SetFD_CLOEXEC(fd, &options);
+      *result = std::make_unique<PosixDirectWritableFile>(fname, fd, options);
     } else {
       SetFD_CLOEXEC(fd, &options);
       if (options.use_mmap_writes) {
@@ -729,6 +744,22 @@ class PosixRocksDBFileFactory : public RocksDBFileFactory {
   bool forceMmapOff = false;
   size_t page_size_ = getpagesize();
 
+  // Opens the file with O_DIRECT if *direct is true. When the file system does not support
+  // O_DIRECT, falls back to buffered I/O and resets *direct.
+  static int OpenMaybeDirect(const std::string& fname, int flags, mode_t mode, bool* direct) {
+#if defined(__linux__)
+    if (*direct) {
+      int fd = open(fname.c_str(), flags | O_DIRECT, mode);
+      if (fd >= 0 || errno != EINVAL) {
+        return fd;
+      }
+      YB_LOG_EVERY_N_SECS(WARNING, 60) << "O_DIRECT is not supported for " << fname;
+    }
+#endif
+    *direct = false;
+    return open(fname.c_str(), flags, mode);
+  }
+
   bool SupportsFastAllocate(const std::string& path) {
 #ifdef ROCKSDB_FALLOCATE_PRESENT
     struct statfs s;
@@ -46,12 +46,15 @@
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/log_buffer.h"
 #include "yb/rocksdb/util/mutexlock.h"
 #include "yb/util/string_util.h"
 #include "yb/rocksdb/util/testharness.h"
 #include "yb/rocksdb/util/testutil.h"
 
+DECLARE_bool(rocksdb_use_io_uring);
+
 namespace rocksdb {
 
 namespace {
@@ -1086,6 +1089,59 @@ TEST_F(EnvPosixTest, WritableFileWrapper) {
   EXPECT_EQ(14, step);
 }
 
+// Writes unaligned data through O_DIRECT file and reads it back with readahead, that reads next
+// window in background when io_uring is available.
+TEST_F(EnvPosixTest, DirectIOWithReadahead) {
+  constexpr size_t kRecordSize = 1000;
+  constexpr size_t kNumRecords = 1000;
+  constexpr size_t kReadaheadSize = 64 * 1024;
+  const std::string fname = test::TmpDir() + "/direct_io_testfile";
+  EnvOptions options;
+  options.use_direct_io = true;
+  options.use_mmap_writes = false;
+  Random rnd(301);
+  std::string data;
+  for (size_t i = 0; i != kNumRecords; ++i) {
+    data += RandomString(&rnd, static_cast<int>(kRecordSize));
+  }
+
+  for (bool use_io_uring : {false, true}) {
+    FLAGS_rocksdb_use_io_uring = use_io_uring;
+    {
+      unique_ptr<WritableFile> wfile;
+      ASSERT_OK(env_->NewWritableFile(fname, &wfile, options));
+      WritableFileWriter writer(std::move(wfile), options);
+      for (size_t i = 0; i != kNumRecords; ++i) {
+        ASSERT_OK(writer.Append(Slice(data.data() + i * kRecordSize, kRecordSize)));
+        if (i % 100 == 0) {
+          // Flush rewrites the partial last page.
+          ASSERT_OK(writer.Flush());
+        }
+      }
+      ASSERT_OK(writer.Close());
+    }
+    uint64_t file_size = 0;
+    ASSERT_OK(env_->GetFileSize(fname, &file_size));
+    ASSERT_EQ(data.size(), file_size);
+
+    unique_ptr<RandomAccessFile> file;
+    ASSERT_OK(env_->NewRandomAccessFile(fname, &file, options));
+    file = NewReadaheadRandomAccessFile(std::move(file), kReadaheadSize);
+    std::string scratch(kRecordSize, 0);
+    for (size_t i = 0; i != kNumRecords; ++i) {
+      Slice result;
+      ASSERT_OK(file->Read(i * kRecordSize, kRecordSize, &result, &scratch[0]));
+      ASSERT_EQ(Slice(data.data() + i * kRecordSize, kRecordSize), result) << i;
+    }
+    Slice result;
+    ASSERT_OK(file->Read(data.size() - 10, kRecordSize, &result, &scratch[0]));
+    ASSERT_EQ(Slice(data.data() + data.size() - 10, 10), result);
+    file.reset();
+    ASSERT_OK(env_->DeleteFile(fname));
+  }
+  FLAGS_rocksdb_use_io_uring = false;
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -177,6 +177,10 @@ Status WritableFileWriter::Close() {
   // In unbuffered mode we write whole pages so
   // we need to let the file know where data ends.
   Status interim = writable_file_->Truncate(filesize_);
+  if (interim.ok() && direct_io_) {
+    // Sync skips direct I/O files, but the size set by truncate still has to be persisted.
+    interim = writable_file_->Fsync();
+  }
   if (!interim.ok() && s.ok()) {
     s = interim;
   }
@@ -440,6 +444,15 @@ class ReadaheadRandomAccessFile : public yb::RandomAccessFileWrapper {
 
   ReadaheadRandomAccessFile& operator=(const ReadaheadRandomAccessFile&) = delete;
 
+  ~ReadaheadRandomAccessFile() {
+    // Background read writes to prefetch_buffer_, so it should be completed before the buffer
+    // is freed.
+    if (prefetch_in_progress_) {
+      Slice prefetch_result;
+      WARN_NOT_OK(target()->WaitForRead(&prefetch_result), "Failed to complete readahead");
+    }
+  }
+
   CHECKED_STATUS Read(uint64_t offset, size_t n, Slice* result, uint8_t* scratch) const override {
     if (n >= readahead_size_) {
       return RandomAccessFileWrapper::Read(offset, n, result, scratch);
@@ -455,18 +468,21 @@ class ReadaheadRandomAccessFile : public yb::RandomAccessFileWrapper {
 
     std::unique_lock<std::mutex> lk(lock_);
 
-    size_t copied = 0;
-    // if offset between [buffer_offset_, buffer_offset_ + buffer_len>
-    if (offset >= buffer_offset_ && offset < buffer_len_ + buffer_offset_) {
-      uint64_t offset_in_buffer = offset - buffer_offset_;
-      copied = std::min(buffer_len_ - static_cast<size_t>(offset_in_buffer), n);
-      memcpy(scratch, buffer_.get() + offset_in_buffer, copied);
+    size_t copied = CopyFromBuffer(offset, n, scratch);
+    if (copied == n) {
+      // fully cached
+      *result = Slice(scratch, n);
+      return Status::OK();
+    }
+    if (TakePrefetched(offset + copied)) {
+      copied += CopyFromBuffer(offset + copied, n - copied, scratch + copied);
       if (copied == n) {
-        // fully cached
+        StartPrefetch();
         *result = Slice(scratch, n);
         return Status::OK();
       }
     }
+
     Slice readahead_result;
     Status s = RandomAccessFileWrapper::Read(offset + copied, readahead_size_, &readahead_result,
       buffer_.get());
@@ -481,6 +497,7 @@ class ReadaheadRandomAccessFile : public yb::RandomAccessFileWrapper {
     if (readahead_result.data() == buffer_.get()) {
       buffer_offset_ = offset + copied;
       buffer_len_ = readahead_result.size();
+      StartPrefetch();
     } else {
       buffer_len_ = 0;
     }
@@ -489,6 +506,54 @@ class ReadaheadRandomAccessFile : public yb::RandomAccessFileWrapper {
   }
 
  private:
+  // Copies up to n bytes at offset from buffer_, returns the number of copied bytes.
+  size_t CopyFromBuffer(uint64_t offset, size_t n, uint8_t* scratch) const {
+    // if offset between [buffer_offset_, buffer_offset_ + buffer_len>
+    if (offset < buffer_offset_ || offset >= buffer_len_ + buffer_offset_) {
+      return 0;
+    }
+    uint64_t offset_in_buffer = offset - buffer_offset_;
+    size_t copied = std::min(buffer_len_ - static_cast<size_t>(offset_in_buffer), n);
+    memcpy(scratch, buffer_.get() + offset_in_buffer, copied);
+    return copied;
+  }
+
+  // Starts reading the window that follows buffer_ in background, if the file supports it.
+  void StartPrefetch() const {
+    if (!async_reads_supported_ || prefetch_in_progress_ || buffer_len_ != readahead_size_) {
+      return;
+    }
+    if (!prefetch_buffer_) {
+      prefetch_buffer_.reset(new uint8_t[readahead_size_]);
+    }
+    prefetch_offset_ = buffer_offset_ + buffer_len_;
+    Status s = target()->ReadAsync(prefetch_offset_, readahead_size_, prefetch_buffer_.get());
+    if (s.ok()) {
+      prefetch_in_progress_ = true;
+    } else if (s.IsNotSupported()) {
+      async_reads_supported_ = false;
+    }
+    // Other errors are reported by the synchronous read of the same data.
+  }
+
+  // Completes the background read, and makes it the current buffer if it contains offset.
+  bool TakePrefetched(uint64_t offset) const {
+    if (!prefetch_in_progress_) {
+      return false;
+    }
+    prefetch_in_progress_ = false;
+    Slice prefetch_result;
+    Status s = target()->WaitForRead(&prefetch_result);
+    if (!s.ok() || prefetch_result.data() != prefetch_buffer_.get() ||
+        offset < prefetch_offset_ || offset >= prefetch_offset_ + prefetch_result.size()) {
+      return false;
+    }
+    buffer_.swap(prefetch_buffer_);
+    buffer_offset_ = prefetch_offset_;
+    buffer_len_ = prefetch_result.size();
+    return true;
+  }
+
   size_t               readahead_size_;
   const bool           forward_calls_;
 
@@ -496,6 +561,12 @@ class ReadaheadRandomAccessFile : public yb::RandomAccessFileWrapper {
   mutable std::unique_ptr<uint8_t[]> buffer_;
   mutable uint64_t     buffer_offset_;
   mutable size_t       buffer_len_;
+
+  // Next window, that is read in background while buffer_ is consumed.
+  mutable std::unique_ptr<uint8_t[]> prefetch_buffer_;
+  mutable uint64_t     prefetch_offset_ = 0;
+  mutable bool         prefetch_in_progress_ = false;
+  mutable bool         async_reads_supported_ = true;
 };
 }  // namespace
 
@@ -113,6 +113,9 @@ class RandomAccessFileReader {
   CHECKED_STATUS ReadAndValidate(
       uint64_t offset, size_t n, Slice* result, char* scratch, const yb::ReadValidator& validator);
 
+  // See RandomAccessFile::Prefetch.
+  void Prefetch(uint64_t offset, size_t n) { file_->Prefetch(offset, n); }
+
   RandomAccessFile* file() { return file_.get(); }
 };
 
@@ -40,17 +40,34 @@
 #include <sys/statfs.h>
 #include <sys/syscall.h>
 #endif
+
+#include <gflags/gflags.h>
+
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/io_uring.h"
 #include "yb/rocksdb/util/posix_logger.h"
 #include "yb/rocksdb/util/sync_point.h"
 
 #include "yb/util/file_system_posix.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
 #include "yb/util/malloc.h"
 #include "yb/util/slice.h"
 #include "yb/util/stats/iostats_context_imp.h"
 #include "yb/util/string_util.h"
 
+DEFINE_bool(rocksdb_use_io_uring, false,
+            "Use io_uring for asynchronous RocksDB readahead and O_DIRECT writes, when supported "
+            "by the kernel.");
+TAG_FLAG(rocksdb_use_io_uring, advanced);
+
+DEFINE_int32(rocksdb_io_uring_queue_depth, 16,
+             "Max number of io_uring requests in flight per RocksDB file.");
+TAG_FLAG(rocksdb_io_uring_queue_depth, advanced);
+
+DECLARE_int32(o_direct_block_alignment_bytes);
+
 namespace rocksdb {
 
 // A wrapper for fadvise, if the platform doesn't support fadvise,
@@ -497,6 +514,331 @@ size_t PosixWritableFile::GetUniqueId(char* id) const {
 }
 #endif
 
+namespace {
+
+std::unique_ptr<IoUring> CreateIoUring(const std::string& filename) {
+  if (!FLAGS_rocksdb_use_io_uring) {
+    return nullptr;
+  }
+  auto ring = IoUring::Create(FLAGS_rocksdb_io_uring_queue_depth);
+  if (!ring.ok()) {
+    YB_LOG_EVERY_N_SECS(WARNING, 60) << "Failed to create io_uring for " << filename << ": "
+                                     << ring.status();
+    return nullptr;
+  }
+  return std::move(*ring);
+}
+
+size_t DirectIOAlignment() {
+  return static_cast<size_t>(FLAGS_o_direct_block_alignment_bytes);
+}
+
+// Reads up to n bytes at offset, stops at the end of file.
+Status PreadFully(const std::string& filename, int fd, uint64_t offset, size_t n, char* buf,
+                  size_t* bytes_read) {
+  size_t done = 0;
+  while (done < n) {
+    ssize_t r = pread(fd, buf + done, n - done, static_cast<off_t>(offset + done));
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return STATUS_IO_ERROR(filename, errno);
+    }
+    if (r == 0) {
+      break;
+    }
+    done += r;
+  }
+  *bytes_read = done;
+  return Status::OK();
+}
+
+} // namespace
+
+/*
+ * PosixDirectWritableFile
+ */
+PosixDirectWritableFile::PosixDirectWritableFile(
+    const std::string& fname, int fd, const EnvOptions& options)
+    : filename_(fname), fd_(fd), ring_(CreateIoUring(fname)) {
+#ifdef ROCKSDB_FALLOCATE_PRESENT
+  allow_fallocate_ = options.allow_fallocate;
+  fallocate_with_keep_size_ = options.fallocate_with_keep_size;
+#endif
+}
+
+PosixDirectWritableFile::~PosixDirectWritableFile() {
+  if (fd_ >= 0) {
+    WARN_NOT_OK(PosixDirectWritableFile::Close(), "Failed to close posix direct writable file");
+  }
+}
+
+size_t PosixDirectWritableFile::GetRequiredBufferAlignment() const {
+  return DirectIOAlignment();
+}
+
+Status PosixDirectWritableFile::Append(const Slice& data) {
+  return STATUS(NotSupported, "Append is not supported with O_DIRECT, use PositionedAppend");
+}
+
+Status PosixDirectWritableFile::PositionedAppend(const Slice& data, uint64_t offset) {
+  const size_t alignment = DirectIOAlignment();
+  if (offset % alignment != 0 || data.size() % alignment != 0) {
+    return STATUS_FORMAT(InvalidArgument, "Unaligned O_DIRECT write to $0: offset $1, size $2",
+                         filename_, offset, data.size());
+  }
+  RETURN_NOT_OK(write_status_);
+
+  if (!ring_) {
+    const char* src = data.cdata();
+    size_t left = data.size();
+    while (left != 0) {
+      ssize_t done = pwrite(fd_, src, left, static_cast<off_t>(offset));
+      if (done < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return STATUS_IO_ERROR(filename_, errno);
+      }
+      left -= done;
+      src += done;
+      offset += done;
+    }
+    filesize_ = std::max<uint64_t>(filesize_, offset);
+    return Status::OK();
+  }
+
+  // The kernel could reorder writes in flight, so the last partial page, that is rewritten
+  // by the next flush, should be written before it is written again.
+  const uint64_t end = offset + data.size();
+  for (const auto& id_and_write : pending_writes_) {
+    const auto& write = id_and_write.second;
+    if (write.offset < end && offset < write.offset + write.buffer.CurrentSize()) {
+      RETURN_NOT_OK(WaitForAllWrites());
+      break;
+    }
+  }
+  while (ring_->in_flight() >= ring_->depth()) {
+    RETURN_NOT_OK(WaitForOneWrite());
+  }
+
+  // The caller reuses its buffer, so the data is copied.
+  PendingWrite write;
+  write.buffer.Alignment(alignment);
+  write.buffer.AllocateNewBuffer(data.size());
+  write.buffer.Append(data.cdata(), data.size());
+  write.offset = offset;
+  const uint64_t id = next_write_id_++;
+  if (!ring_->PrepareWrite(fd_, write.buffer.BufferStart(), data.size(), offset, id)) {
+    return STATUS_FORMAT(IllegalState, "Failed to queue write to $0", filename_);
+  }
+  pending_writes_.emplace(id, std::move(write));
+  filesize_ = std::max<uint64_t>(filesize_, end);
+  return Status::OK();
+}
+
+Status PosixDirectWritableFile::WaitForOneWrite() {
+  uint64_t id = 0;
+  int result = 0;
+  RETURN_NOT_OK(ring_->WaitCompletion(&id, &result));
+  auto it = pending_writes_.find(id);
+  if (it == pending_writes_.end()) {
+    return STATUS_FORMAT(IllegalState, "Unknown write $0 completed for $1", id, filename_);
+  }
+  const size_t size = it->second.buffer.CurrentSize();
+  pending_writes_.erase(it);
+  if (write_status_.ok()) {
+    if (result < 0) {
+      write_status_ = STATUS_IO_ERROR(filename_, -result);
+    } else if (static_cast<size_t>(result) != size) {
+      write_status_ = STATUS_FORMAT(
+          IOError, "Short write to $0: $1 of $2 bytes", filename_, result, size);
+    }
+  }
+  return write_status_;
+}
+
+Status PosixDirectWritableFile::WaitForAllWrites() {
+  if (!ring_) {
+    return Status::OK();
+  }
+  Status result;
+  while (ring_->in_flight() != 0) {
+    Status s = WaitForOneWrite();
+    if (!s.ok() && result.ok()) {
+      result = s;
+    }
+  }
+  return result;
+}
+
+Status PosixDirectWritableFile::Truncate(uint64_t size) {
+  RETURN_NOT_OK(WaitForAllWrites());
+  // Writes are padded to whole pages, so the file is trimmed to the actual data size.
+  if (ftruncate(fd_, static_cast<off_t>(size)) < 0) {
+    return STATUS_IO_ERROR(filename_, errno);
+  }
+  filesize_ = size;
+  return Status::OK();
+}
+
+Status PosixDirectWritableFile::Close() {
+  Status s = WaitForAllWrites();
+  if (close(fd_) < 0 && s.ok()) {
+    s = STATUS_IO_ERROR(filename_, errno);
+  }
+  fd_ = -1;
+  return s;
+}
+
+Status PosixDirectWritableFile::Flush() {
+  RETURN_NOT_OK(write_status_);
+  // Writes prepared since the last flush are passed to the kernel in a single batch.
+  return ring_ ? ring_->Submit() : Status::OK();
+}
+
+Status PosixDirectWritableFile::Sync() {
+  RETURN_NOT_OK(WaitForAllWrites());
+  // O_DIRECT does not persist the file size and allocation metadata.
+  if (fdatasync(fd_) < 0) {
+    return STATUS_IO_ERROR(filename_, errno);
+  }
+  return Status::OK();
+}
+
+Status PosixDirectWritableFile::Fsync() {
+  RETURN_NOT_OK(WaitForAllWrites());
+  if (fsync(fd_) < 0) {
+    return STATUS_IO_ERROR(filename_, errno);
+  }
+  return Status::OK();
+}
+
+#ifdef ROCKSDB_FALLOCATE_PRESENT
+Status PosixDirectWritableFile::Allocate(uint64_t offset, uint64_t len) {
+  IOSTATS_TIMER_GUARD(allocate_nanos);
+  if (allow_fallocate_ &&
+      fallocate(fd_, fallocate_with_keep_size_ ? FALLOC_FL_KEEP_SIZE : 0,
+                static_cast<off_t>(offset), static_cast<off_t>(len)) != 0) {
+    return STATUS_IO_ERROR(filename_, errno);
+  }
+  return Status::OK();
+}
+
+size_t PosixDirectWritableFile::GetUniqueId(char* id) const {
+  return yb::GetUniqueIdFromFile(fd_, pointer_cast<uint8_t*>(id));
+}
+#endif
+
+/*
+ * PosixAsyncRandomAccessFile
+ */
+PosixAsyncRandomAccessFile::PosixAsyncRandomAccessFile(
+    const std::string& fname, int fd, const EnvOptions& options)
+    : yb::PosixRandomAccessFile(fname, fd, options), direct_(options.use_direct_io) {
+}
+
+PosixAsyncRandomAccessFile::~PosixAsyncRandomAccessFile() {
+  // The kernel could still write to the buffer, so wait for the read to complete.
+  if (read_in_progress_) {
+    Slice result;
+    WARN_NOT_OK(DoWaitForRead(&result), "Failed to complete read");
+  }
+}
+
+Status PosixAsyncRandomAccessFile::Read(
+    uint64_t offset, size_t n, Slice* result, uint8_t* scratch) const {
+  if (!direct_) {
+    return PosixRandomAccessFile::Read(offset, n, result, scratch);
+  }
+
+  const size_t alignment = DirectIOAlignment();
+  const uint64_t aligned_offset = TruncateToPageBoundary(alignment, offset);
+  const size_t aligned_size = Roundup(offset + n, alignment) - aligned_offset;
+  AlignedBuffer buffer;
+  buffer.Alignment(alignment);
+  buffer.AllocateNewBuffer(aligned_size);
+  size_t bytes_read = 0;
+  Status s = PreadFully(filename(), fd(), aligned_offset, aligned_size, buffer.Destination(),
+                        &bytes_read);
+  if (!s.ok()) {
+    *result = Slice();
+    return s;
+  }
+  const size_t skip = offset - aligned_offset;
+  const size_t size = bytes_read > skip ? std::min(bytes_read - skip, n) : 0;
+  memcpy(scratch, buffer.BufferStart() + skip, size);
+  *result = Slice(scratch, size);
+  return Status::OK();
+}
+
+Status PosixAsyncRandomAccessFile::ReadAsync(uint64_t offset, size_t n, uint8_t* scratch) {
+  if (read_in_progress_) {
+    return STATUS_FORMAT(IllegalState, "Read of $0 is already in progress", filename());
+  }
+  if (!ring_) {
+    if (ring_failed_ || !(ring_ = CreateIoUring(filename()))) {
+      ring_failed_ = true;
+      return STATUS(NotSupported, "io_uring is not available");
+    }
+  }
+
+  void* buf = scratch;
+  uint64_t read_offset = offset;
+  size_t read_size = n;
+  if (direct_) {
+    const size_t alignment = DirectIOAlignment();
+    read_offset = TruncateToPageBoundary(alignment, offset);
+    read_size = Roundup(offset + n, alignment) - read_offset;
+    if (direct_buffer_.Capacity() < read_size) {
+      direct_buffer_.Alignment(alignment);
+      direct_buffer_.AllocateNewBuffer(read_size);
+    }
+    buf = direct_buffer_.Destination();
+  }
+  if (!ring_->PrepareRead(fd(), buf, read_size, read_offset, 0 /* user_data */)) {
+    return STATUS_FORMAT(IllegalState, "Failed to queue read of $0", filename());
+  }
+  read_in_progress_ = true;
+  read_offset_ = offset;
+  read_size_ = n;
+  read_scratch_ = scratch;
+  return ring_->Submit();
+}
+
+Status PosixAsyncRandomAccessFile::WaitForRead(Slice* result) {
+  if (!read_in_progress_) {
+    return STATUS_FORMAT(IllegalState, "No read of $0 in progress", filename());
+  }
+  return DoWaitForRead(result);
+}
+
+Status PosixAsyncRandomAccessFile::DoWaitForRead(Slice* result) {
+  read_in_progress_ = false;
+  uint64_t user_data = 0;
+  int bytes_read = 0;
+  RETURN_NOT_OK(ring_->WaitCompletion(&user_data, &bytes_read));
+  if (bytes_read < 0) {
+    return STATUS_IO_ERROR(filename(), -bytes_read);
+  }
+
+  size_t size = bytes_read;
+  if (direct_) {
+    const size_t skip = read_offset_ - TruncateToPageBoundary(DirectIOAlignment(), read_offset_);
+    size = size > skip ? std::min(size - skip, read_size_) : 0;
+    memcpy(read_scratch_, direct_buffer_.BufferStart() + skip, size);
+  }
+  if (size < read_size_ && size != 0) {
+    // Short read before the end of file, read the rest synchronously.
+    Slice rest;
+    RETURN_NOT_OK(Read(read_offset_ + size, read_size_ - size, &rest, read_scratch_ + size));
+    size += rest.size();
+  }
+  *result = Slice(read_scratch_, size);
+  return Status::OK();
+}
+
 PosixDirectory::~PosixDirectory() { close(fd_); }
 
 Status PosixDirectory::Fsync() {
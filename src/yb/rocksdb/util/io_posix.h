@@ -25,7 +25,13 @@
 
 #pragma once
 #include <unistd.h>
+
+#include <map>
+
 #include "yb/rocksdb/env.h"
+#include "yb/rocksdb/util/aligned_buffer.h"
+
+#include "yb/util/file_system_posix.h"
 
 // For non linux platform, the following macros are used only as place
 // holder.
@@ -41,6 +47,8 @@ namespace rocksdb {
 
 #define STATUS_IO_ERROR(context, err_number) STATUS(IOError, (context), strerror(err_number))
 
+class IoUring;
+
 class PosixWritableFile : public WritableFile {
  private:
   const std::string filename_;
@@ -74,6 +82,84 @@ class PosixWritableFile : public WritableFile {
 #endif
 };
 
+// Writable file opened with O_DIRECT. Used through WritableFileWriter, that issues whole
+// aligned pages with PositionedAppend. When io_uring is available, up to
+// FLAGS_rocksdb_io_uring_queue_depth writes are kept in flight, and they are waited for by
+// Sync, Truncate and Close.
+class PosixDirectWritableFile : public WritableFile {
+ public:
+  PosixDirectWritableFile(const std::string& fname, int fd, const EnvOptions& options);
+  ~PosixDirectWritableFile();
+
+  bool UseOSBuffer() const override { return false; }
+  bool UseDirectIO() const override { return true; }
+  size_t GetRequiredBufferAlignment() const override;
+
+  Status Append(const Slice& data) override;
+  Status PositionedAppend(const Slice& data, uint64_t offset) override;
+  Status Truncate(uint64_t size) override;
+  Status Close() override;
+  Status Flush() override;
+  Status Sync() override;
+  Status Fsync() override;
+  uint64_t GetFileSize() override { return filesize_; }
+  Status InvalidateCache(size_t offset, size_t length) override { return Status::OK(); }
+#ifdef ROCKSDB_FALLOCATE_PRESENT
+  Status Allocate(uint64_t offset, uint64_t len) override;
+  size_t GetUniqueId(char* id) const override;
+#endif
+
+ private:
+  struct PendingWrite {
+    AlignedBuffer buffer;
+    uint64_t offset;
+  };
+
+  Status WaitForOneWrite();
+  Status WaitForAllWrites();
+
+  const std::string filename_;
+  int fd_;
+  uint64_t filesize_ = 0;
+#ifdef ROCKSDB_FALLOCATE_PRESENT
+  bool allow_fallocate_;
+  bool fallocate_with_keep_size_;
+#endif
+  std::unique_ptr<IoUring> ring_;
+  uint64_t next_write_id_ = 0;
+  std::map<uint64_t, PendingWrite> pending_writes_;
+  // First error of a write that completed in background.
+  Status write_status_;
+};
+
+// Random access file, that implements ReadAsync with io_uring, and O_DIRECT reads through an
+// aligned bounce buffer when opened with use_direct_io. The ring is created on the first
+// ReadAsync, so files that are not used for readahead do not pay for it.
+class PosixAsyncRandomAccessFile : public yb::PosixRandomAccessFile {
+ public:
+  PosixAsyncRandomAccessFile(const std::string& fname, int fd, const EnvOptions& options);
+  ~PosixAsyncRandomAccessFile();
+
+  CHECKED_STATUS Read(uint64_t offset, size_t n, Slice* result, uint8_t* scratch) const override;
+  CHECKED_STATUS ReadAsync(uint64_t offset, size_t n, uint8_t* scratch) override;
+  CHECKED_STATUS WaitForRead(Slice* result) override;
+
+ private:
+  CHECKED_STATUS DoWaitForRead(Slice* result);
+
+  const bool direct_;
+  std::unique_ptr<IoUring> ring_;
+  bool ring_failed_ = false;
+
+  bool read_in_progress_ = false;
+  uint64_t read_offset_ = 0;
+  size_t read_size_ = 0;
+  uint8_t* read_scratch_ = nullptr;
+  // Used instead of read_scratch_ for O_DIRECT reads, starts at read_offset_ rounded down to
+  // alignment.
+  AlignedBuffer direct_buffer_;
+};
+
 class PosixMmapReadableFile : public RandomAccessFile {
  private:
   int fd_;
@@ -0,0 +1,299 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/util/io_uring.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+#endif
+
+// IORING_FEAT_FAST_POLL appeared in the same kernel headers (5.7) as the probe interface and
+// IORING_OP_READ/IORING_OP_WRITE, so use it to detect whether headers are recent enough.
+#if defined(IORING_FEAT_FAST_POLL)
+#define YB_HAVE_IO_URING 1
+#endif
+
+#include "yb/util/format.h"
+
+namespace rocksdb {
+
+#if defined(YB_HAVE_IO_URING)
+
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+#ifndef __NR_io_uring_register
+#define __NR_io_uring_register 427
+#endif
+
+namespace {
+
+template <class T>
+T* RingPointer(void* base, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+} // namespace
+
+class IoUring::Impl {
+ public:
+  ~Impl() {
+    if (sqes_ != MAP_FAILED) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_) {
+      munmap(cq_ptr_, cq_size_);
+    }
+    if (sq_ptr_ != MAP_FAILED) {
+      munmap(sq_ptr_, sq_size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  CHECKED_STATUS Init(uint32_t depth) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    fd_ = static_cast<int>(syscall(__NR_io_uring_setup, depth, &params));
+    if (fd_ < 0) {
+      return STATUS(NotSupported, "io_uring_setup failed", strerror(errno));
+    }
+    RETURN_NOT_OK(CheckOpsSupported());
+
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+    }
+    sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                   IORING_OFF_SQ_RING);
+    if (sq_ptr_ == MAP_FAILED) {
+      return STATUS(IOError, "Failed to map io_uring submission queue", strerror(errno));
+    }
+    if (single_mmap) {
+      cq_ptr_ = sq_ptr_;
+    } else {
+      cq_ptr_ = mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                     IORING_OFF_CQ_RING);
+      if (cq_ptr_ == MAP_FAILED) {
+        return STATUS(IOError, "Failed to map io_uring completion queue", strerror(errno));
+      }
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                 IORING_OFF_SQES);
+    if (sqes_ == MAP_FAILED) {
+      return STATUS(IOError, "Failed to map io_uring submission entries", strerror(errno));
+    }
+
+    sq_head_ = RingPointer<uint32_t>(sq_ptr_, params.sq_off.head);
+    sq_tail_ = RingPointer<uint32_t>(sq_ptr_, params.sq_off.tail);
+    sq_mask_ = *RingPointer<uint32_t>(sq_ptr_, params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    sq_array_ = RingPointer<uint32_t>(sq_ptr_, params.sq_off.array);
+    cq_head_ = RingPointer<uint32_t>(cq_ptr_, params.cq_off.head);
+    cq_tail_ = RingPointer<uint32_t>(cq_ptr_, params.cq_off.tail);
+    cq_mask_ = *RingPointer<uint32_t>(cq_ptr_, params.cq_off.ring_mask);
+    cqes_ = RingPointer<io_uring_cqe>(cq_ptr_, params.cq_off.cqes);
+    return Status::OK();
+  }
+
+  bool Prepare(uint8_t opcode, int fd, void* buf, size_t len, uint64_t offset,
+               uint64_t user_data) {
+    const uint32_t tail = *sq_tail_;
+    if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+      return false;
+    }
+    const uint32_t index = tail & sq_mask_;
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqes_) + index;
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = static_cast<uint32_t>(len);
+    sqe->off = offset;
+    sqe->user_data = user_data;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    ++to_submit_;
+    return true;
+  }
+
+  CHECKED_STATUS Enter(uint32_t min_complete) {
+    for (;;) {
+      const uint32_t flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+      const int result = static_cast<int>(syscall(
+          __NR_io_uring_enter, fd_, to_submit_, min_complete, flags, nullptr, 0));
+      if (result < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return STATUS(IOError, "io_uring_enter failed", strerror(errno));
+      }
+      to_submit_ -= static_cast<uint32_t>(result);
+      if (to_submit_ == 0 || min_complete) {
+        return Status::OK();
+      }
+    }
+  }
+
+  CHECKED_STATUS Submit() {
+    if (to_submit_ == 0) {
+      return Status::OK();
+    }
+    return Enter(0);
+  }
+
+  CHECKED_STATUS WaitCompletion(uint64_t* user_data, int* result) {
+    for (;;) {
+      const uint32_t head = *cq_head_;
+      if (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+        const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+        *user_data = cqe.user_data;
+        *result = cqe.res;
+        __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+        return Status::OK();
+      }
+      RETURN_NOT_OK(Enter(1));
+    }
+  }
+
+ private:
+  CHECKED_STATUS CheckOpsSupported() {
+    constexpr size_t kNumProbeOps = 256;
+    const size_t size = sizeof(io_uring_probe) + kNumProbeOps * sizeof(io_uring_probe_op);
+    std::unique_ptr<char[]> buffer(new char[size]);
+    memset(buffer.get(), 0, size);
+    auto* probe = reinterpret_cast<io_uring_probe*>(buffer.get());
+    if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, kNumProbeOps) < 0) {
+      return STATUS(NotSupported, "io_uring probe failed", strerror(errno));
+    }
+    for (auto op : {IORING_OP_READ, IORING_OP_WRITE}) {
+      if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+        return STATUS_FORMAT(NotSupported, "io_uring operation $0 is not supported", op);
+      }
+    }
+    return Status::OK();
+  }
+
+  int fd_ = -1;
+  void* sq_ptr_ = MAP_FAILED;
+  void* cq_ptr_ = MAP_FAILED;
+  void* sqes_ = MAP_FAILED;
+  size_t sq_size_ = 0;
+  size_t cq_size_ = 0;
+  size_t sqes_size_ = 0;
+
+  uint32_t* sq_head_ = nullptr;
+  uint32_t* sq_tail_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t sq_entries_ = 0;
+  uint32_t* sq_array_ = nullptr;
+  uint32_t* cq_head_ = nullptr;
+  uint32_t* cq_tail_ = nullptr;
+  uint32_t cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+
+  // Number of prepared entries that were not consumed by the kernel yet.
+  uint32_t to_submit_ = 0;
+};
+
+yb::Result<std::unique_ptr<IoUring>> IoUring::Create(uint32_t depth) {
+  auto impl = std::make_unique<Impl>();
+  RETURN_NOT_OK(impl->Init(depth));
+  return std::unique_ptr<IoUring>(new IoUring(std::move(impl), depth));
+}
+
+bool IoUring::PrepareRead(int fd, void* buf, size_t len, uint64_t offset, uint64_t user_data) {
+  if (in_flight_ >= depth_ || !impl_->Prepare(IORING_OP_READ, fd, buf, len, offset, user_data)) {
+    return false;
+  }
+  ++in_flight_;
+  return true;
+}
+
+bool IoUring::PrepareWrite(
+    int fd, const void* buf, size_t len, uint64_t offset, uint64_t user_data) {
+  if (in_flight_ >= depth_ ||
+      !impl_->Prepare(IORING_OP_WRITE, fd, const_cast<void*>(buf), len, offset, user_data)) {
+    return false;
+  }
+  ++in_flight_;
+  return true;
+}
+
+Status IoUring::Submit() {
+  return impl_->Submit();
+}
+
+Status IoUring::WaitCompletion(uint64_t* user_data, int* result) {
+  if (in_flight_ == 0) {
+    return STATUS(IllegalState, "No io_uring requests in flight");
+  }
+  RETURN_NOT_OK(impl_->WaitCompletion(user_data, result));
+  --in_flight_;
+  return Status::OK();
+}
+
+#else // YB_HAVE_IO_URING
+
+class IoUring::Impl {
+};
+
+yb::Result<std::unique_ptr<IoUring>> IoUring::Create(uint32_t depth) {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+bool IoUring::PrepareRead(int fd, void* buf, size_t len, uint64_t offset, uint64_t user_data) {
+  return false;
+}
+
+bool IoUring::PrepareWrite(
+    int fd, const void* buf, size_t len, uint64_t offset, uint64_t user_data) {
+  return false;
+}
+
+Status IoUring::Submit() {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+Status IoUring::WaitCompletion(uint64_t* user_data, int* result) {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+#endif // YB_HAVE_IO_URING
+
+IoUring::IoUring(std::unique_ptr<Impl> impl, uint32_t depth)
+    : impl_(std::move(impl)), depth_(depth) {
+}
+
+IoUring::~IoUring() = default;
+
+} // namespace rocksdb
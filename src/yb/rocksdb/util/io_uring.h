@@ -0,0 +1,73 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_ROCKSDB_UTIL_IO_URING_H
+#define YB_ROCKSDB_UTIL_IO_URING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "yb/rocksdb/status.h"
+
+#include "yb/util/result.h"
+
+namespace rocksdb {
+
+// Minimal wrapper around the Linux io_uring submission and completion queues, implemented with
+// raw system calls. Requests are queued with Prepare* and passed to the kernel in one batch by
+// Submit.
+//
+// Not thread safe, each ring is owned by a single file or thread.
+class IoUring {
+ public:
+  // Returns NotSupported when io_uring is not available on the platform, was not compiled in,
+  // or the running kernel lacks the IORING_OP_READ/IORING_OP_WRITE operations.
+  static yb::Result<std::unique_ptr<IoUring>> Create(uint32_t depth);
+
+  ~IoUring();
+
+  IoUring(const IoUring&) = delete;
+  void operator=(const IoUring&) = delete;
+
+  // Queue read or write of len bytes at offset. Returns false if the submission queue is full.
+  // Buffer should stay valid until the request is completed.
+  bool PrepareRead(int fd, void* buf, size_t len, uint64_t offset, uint64_t user_data);
+  bool PrepareWrite(int fd, const void* buf, size_t len, uint64_t offset, uint64_t user_data);
+
+  // Passes all prepared requests to the kernel with a single system call.
+  CHECKED_STATUS Submit();
+
+  // Waits for the next completed request, submitting prepared ones first.
+  // result is the number of transferred bytes, or negated errno.
+  CHECKED_STATUS WaitCompletion(uint64_t* user_data, int* result);
+
+  // Number of prepared or submitted requests, that were not returned by WaitCompletion yet.
+  size_t in_flight() const { return in_flight_; }
+
+  uint32_t depth() const { return depth_; }
+
+ private:
+  class Impl;
+
+  explicit IoUring(std::unique_ptr<Impl> impl, uint32_t depth);
+
+  std::unique_ptr<Impl> impl_;
+  const uint32_t depth_;
+  size_t in_flight_ = 0;
+};
+
+} // namespace rocksdb
+
+#endif // YB_ROCKSDB_UTIL_IO_URING_H
@@ -74,6 +74,8 @@ ImmutableCFOptions::ImmutableCFOptions(const Options& options)
           options.table_properties_collector_factories),
       advise_random_on_open(options.advise_random_on_open),
       bloom_locality(options.bloom_locality),
+      memtable_filter_bloom_bits(options.memtable_filter_bloom_bits),
+      memtable_huge_page_size(options.memtable_huge_page_size),
       purge_redundant_kvs_while_flush(options.purge_redundant_kvs_while_flush),
       min_partial_merge_operands(options.min_partial_merge_operands),
       disable_data_sync(options.disableDataSync),
@@ -211,6 +213,8 @@ ColumnFamilyOptions::ColumnFamilyOptions(const Options& options)
       memtable_prefix_bloom_huge_page_tlb_size(
           options.memtable_prefix_bloom_huge_page_tlb_size),
       bloom_locality(options.bloom_locality),
+      memtable_filter_bloom_bits(options.memtable_filter_bloom_bits),
+      memtable_huge_page_size(options.memtable_huge_page_size),
       max_successive_merges(options.max_successive_merges),
       min_partial_merge_operands(options.min_partial_merge_operands),
       optimize_filters_for_hits(options.optimize_filters_for_hits),
@@ -274,6 +278,7 @@ DBOptions::DBOptions()
       access_hint_on_compaction_start(NORMAL),
       new_table_reader_for_compaction_inputs(false),
       compaction_readahead_size(0),
+      use_direct_io_for_compaction(false),
       random_access_max_buffer_size(1024 * 1024),
       writable_file_max_buffer_size(1024 * 1024),
       use_adaptive_mutex(false),
@@ -375,6 +380,8 @@ void DBOptions::Dump(Logger* log) const {
       "               Options.compaction_readahead_size: %" ROCKSDB_PRIszt
          "d",
          compaction_readahead_size);
+  RHEADER(log, "            Options.use_direct_io_for_compaction: %d",
+      use_direct_io_for_compaction);
   RHEADER(
       log,
       "               Options.random_access_max_buffer_size: %" ROCKSDB_PRIszt
@@ -403,6 +410,12 @@ void DBOptions::Dump(Logger* log) const {
       allow_concurrent_memtable_write);
   RHEADER(log, "      Options.enable_write_thread_adaptive_yield: %d",
       enable_write_thread_adaptive_yield);
+  RHEADER(log, "             Options.memtable_insert_thread_pool: %p",
+      memtable_insert_thread_pool);
+  RHEADER(log, "Options.min_entries_per_parallel_memtable_insert: %" ROCKSDB_PRIszt,
+      min_entries_per_parallel_memtable_insert);
+  RHEADER(log, "           Options.max_parallel_memtable_inserts: %" ROCKSDB_PRIszt,
+      max_parallel_memtable_inserts);
   RHEADER(log, "             Options.write_thread_max_yield_usec: %" PRIu64,
       write_thread_max_yield_usec);
   RHEADER(log, "            Options.write_thread_slow_yield_usec: %" PRIu64,
@@ -413,6 +426,12 @@ void DBOptions::Dump(Logger* log) const {
     } else {
       RHEADER(log, "                               Options.row_cache: None");
     }
+    if (shared_table_cache) {
+      RHEADER(log, "                      Options.shared_table_cache: %" ROCKSDB_PRIszt,
+          shared_table_cache->GetCapacity());
+    } else {
+      RHEADER(log, "                      Options.shared_table_cache: None");
+    }
   RHEADER(log, "                           Options.initial_seqno: %" PRIu64, initial_seqno);
 #ifndef ROCKSDB_LITE
   RHEADER(log, "       Options.wal_filter: %s",
@@ -457,6 +476,12 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compression_opts.level);
   RHEADER(log, "              Options.compression_opts.strategy: %d",
       compression_opts.strategy);
+  RHEADER(log, "        Options.compression_opts.max_dict_bytes: %" PRIu32,
+      compression_opts.max_dict_bytes);
+  RHEADER(log, "  Options.compression_opts.zstd_max_train_bytes: %" PRIu32,
+      compression_opts.zstd_max_train_bytes);
+  RHEADER(log, "      Options.compression_opts.parallel_threads: %" PRIu32,
+      compression_opts.parallel_threads);
   RHEADER(log, "     Options.level0_file_num_compaction_trigger: %d",
       level0_file_num_compaction_trigger);
   RHEADER(log, "         Options.level0_slowdown_writes_trigger: %d",
@@ -551,6 +576,10 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
          memtable_prefix_bloom_huge_page_tlb_size);
   RHEADER(log, "                          Options.bloom_locality: %d",
       bloom_locality);
+  RHEADER(log, "              Options.memtable_filter_bloom_bits: %" PRIu32,
+      memtable_filter_bloom_bits);
+  RHEADER(log, "                 Options.memtable_huge_page_size: %" ROCKSDB_PRIszt,
+      memtable_huge_page_size);
 
   RHEADER(log,
       "                   Options.max_successive_merges: %" ROCKSDB_PRIszt,
@@ -224,6 +224,9 @@ static std::unordered_map<std::string, OptionTypeInfo> db_options_type_info = {
     {"compaction_readahead_size",
      {offsetof(struct DBOptions, compaction_readahead_size), OptionType::kSizeT,
       OptionVerificationType::kNormal}},
+    {"use_direct_io_for_compaction",
+     {offsetof(struct DBOptions, use_direct_io_for_compaction), OptionType::kBoolean,
+      OptionVerificationType::kNormal}},
     {"random_access_max_buffer_size",
      {offsetof(struct DBOptions, random_access_max_buffer_size),
       OptionType::kSizeT, OptionVerificationType::kNormal}},
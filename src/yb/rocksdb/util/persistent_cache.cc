@@ -0,0 +1,675 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/persistent_cache.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/crc32c.h"
+
+#include "yb/util/format.h"
+#include "yb/util/stol_utils.h"
+
+METRIC_DEFINE_counter(server, persistent_cache_hits,
+                      "Persistent Cache Hits", yb::MetricUnit::kBlocks,
+                      "Number of blocks read from the persistent cache");
+METRIC_DEFINE_counter(server, persistent_cache_misses,
+                      "Persistent Cache Misses", yb::MetricUnit::kBlocks,
+                      "Number of lookups that did not find a block in the persistent cache");
+METRIC_DEFINE_counter(server, persistent_cache_inserts,
+                      "Persistent Cache Inserts", yb::MetricUnit::kBlocks,
+                      "Number of blocks written to the persistent cache");
+METRIC_DEFINE_counter(server, persistent_cache_declined,
+                      "Persistent Cache Declined Inserts", yb::MetricUnit::kBlocks,
+                      "Number of blocks that were not admitted to the persistent cache, because "
+                      "it was busy with writes");
+METRIC_DEFINE_counter(server, persistent_cache_bytes_written,
+                      "Persistent Cache Bytes Written", yb::MetricUnit::kBytes,
+                      "Number of bytes written to the persistent cache files");
+METRIC_DEFINE_gauge_uint64(server, persistent_cache_usage,
+                           "Persistent Cache Usage", yb::MetricUnit::kBytes,
+                           "Total size of the persistent cache files");
+
+namespace rocksdb {
+
+namespace {
+
+// Segment file is a sequence of records:
+//   masked crc32c of the rest of the record (fixed32)
+//   key size (fixed32)
+//   data size (fixed32)
+//   key
+//   data
+//
+// When a segment is complete, its index is written to a separate file, so blocks could be picked
+// up on restart without reading the whole segment. Index file is a sequence of entries:
+//   hash of the key (fixed64)
+//   record offset (fixed32)
+//   record size (fixed32)
+// followed by masked crc32c of all entries (fixed32).
+constexpr size_t kRecordHeaderSize = 12;
+constexpr size_t kIndexEntrySize = 16;
+constexpr char kSegmentSuffix[] = ".pcache";
+constexpr char kIndexSuffix[] = ".pindex";
+
+// Approximate memory used by an entry of the in-memory index, including hash table node and
+// the hash stored in the segment.
+constexpr size_t kIndexEntryMemoryUsage = 64;
+
+// Number of slots used to remember declined blocks.
+constexpr size_t kNumDeclinedSlots = 64 * 1024;
+
+std::string EncodeRecord(const Slice& key, const Slice& data) {
+  std::string result;
+  result.reserve(kRecordHeaderSize + key.size() + data.size());
+  PutFixed32(&result, 0);
+  PutFixed32(&result, static_cast<uint32_t>(key.size()));
+  PutFixed32(&result, static_cast<uint32_t>(data.size()));
+  result.append(key.cdata(), key.size());
+  result.append(data.cdata(), data.size());
+  EncodeFixed32(
+      &result[0], crc32c::Mask(crc32c::Value(result.data() + 4, result.size() - 4)));
+  return result;
+}
+
+// Checks record and extracts key and data from it.
+Status DecodeRecord(const Slice& record, Slice* key, Slice* data) {
+  if (record.size() < kRecordHeaderSize) {
+    return STATUS_FORMAT(Corruption, "Persistent cache record is too short: $0", record.size());
+  }
+  const char* header = record.cdata();
+  const uint32_t key_size = DecodeFixed32(header + 4);
+  const uint32_t data_size = DecodeFixed32(header + 8);
+  if (kRecordHeaderSize + key_size + data_size != record.size()) {
+    return STATUS_FORMAT(
+        Corruption, "Wrong persistent cache record size: $0, key size: $1, data size: $2",
+        record.size(), key_size, data_size);
+  }
+  const auto expected_crc = crc32c::Unmask(DecodeFixed32(header));
+  const auto actual_crc = crc32c::Value(header + 4, record.size() - 4);
+  if (expected_crc != actual_crc) {
+    return STATUS_FORMAT(
+        Corruption, "Wrong persistent cache record checksum: $0, expected: $1",
+        actual_crc, expected_crc);
+  }
+  *key = Slice(header + kRecordHeaderSize, key_size);
+  *data = Slice(header + kRecordHeaderSize + key_size, data_size);
+  return Status::OK();
+}
+
+struct PersistentCacheMetrics {
+  explicit PersistentCacheMetrics(const scoped_refptr<yb::MetricEntity>& entity)
+      : hits(METRIC_persistent_cache_hits.Instantiate(entity)),
+        misses(METRIC_persistent_cache_misses.Instantiate(entity)),
+        inserts(METRIC_persistent_cache_inserts.Instantiate(entity)),
+        declined(METRIC_persistent_cache_declined.Instantiate(entity)),
+        bytes_written(METRIC_persistent_cache_bytes_written.Instantiate(entity)),
+        usage(METRIC_persistent_cache_usage.Instantiate(entity, 0)) {}
+
+  scoped_refptr<yb::Counter> hits;
+  scoped_refptr<yb::Counter> misses;
+  scoped_refptr<yb::Counter> inserts;
+  scoped_refptr<yb::Counter> declined;
+  scoped_refptr<yb::Counter> bytes_written;
+  scoped_refptr<yb::AtomicGauge<uint64_t>> usage;
+};
+
+class FilePersistentCache : public PersistentCache {
+ public:
+  explicit FilePersistentCache(const PersistentCacheOptions& options)
+      : options_(options),
+        mem_tracker_(yb::MemTracker::FindOrCreateTracker(
+            "PersistentCache", options.parent_mem_tracker)),
+        declined_(new uint64_t[kNumDeclinedSlots]()) {
+    if (options.metric_entity) {
+      metrics_.reset(new PersistentCacheMetrics(options.metric_entity));
+    }
+    // Records are read by lookups right after they are flushed, so write them with plain writes.
+    env_options_.use_mmap_writes = false;
+  }
+
+  ~FilePersistentCache() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    cond_.notify_all();
+    if (writer_thread_.joinable()) {
+      writer_thread_.join();
+    }
+    if (writer_) {
+      WARN_NOT_OK(FinishSegment(), "Failed to finish persistent cache segment");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    mem_tracker_->Release(pending_bytes_ + index_.size() * kIndexEntryMemoryUsage);
+  }
+
+  Status Init();
+
+  void Insert(const Slice& key, const Slice& data) override;
+
+  Status Lookup(const Slice& key, std::unique_ptr<char[]>* data, size_t* size) override;
+
+  size_t GetUsage() const override {
+    return usage_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Location {
+    uint64_t segment;
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  struct Segment {
+    std::shared_ptr<RandomAccessFile> file;
+    size_t size = 0;
+    // Hashes of keys of records stored in this segment, used to clean up the index when the
+    // segment is deleted.
+    std::vector<uint64_t> hashes;
+  };
+
+  struct PendingBlock {
+    uint64_t hash;
+    std::string record;
+  };
+
+  struct WrittenBlock {
+    uint64_t hash;
+    Location location;
+  };
+
+  std::string SegmentPath(uint64_t id) const {
+    return yb::Format("$0/$1$2", options_.path, id, kSegmentSuffix);
+  }
+
+  std::string IndexPath(uint64_t id) const {
+    return yb::Format("$0/$1$2", options_.path, id, kIndexSuffix);
+  }
+
+  // Decides whether block should be written. Blocks are always admitted while the device keeps up
+  // with the writes. When the pending writes use more than a half of max_pending_bytes, only the
+  // blocks that were already declined once are admitted, i.e. the blocks that are evicted from
+  // the block cache repeatedly.
+  bool Admit(uint64_t hash, size_t size) REQUIRES(mutex_);
+
+  // Loads the index of the segment, from the index file if it exists, or by reading the segment.
+  Status RecoverSegment(uint64_t id);
+  Status ReadSegmentIndex(uint64_t id, Segment* segment, std::vector<WrittenBlock>* blocks);
+  Status ScanSegment(uint64_t id, Segment* segment, std::vector<WrittenBlock>* blocks);
+
+  // Adds written blocks to the index and deletes old segments if capacity is exceeded.
+  void Publish(const std::vector<WrittenBlock>& blocks);
+
+  Status OpenSegment();
+  Status FinishSegment();
+
+  void WriterThread();
+  Status WriteBlocks(std::deque<PendingBlock>* blocks, std::vector<WrittenBlock>* written);
+
+  void UpdateUsage(int64_t delta);
+
+  const PersistentCacheOptions options_;
+  EnvOptions env_options_;
+  std::shared_ptr<yb::MemTracker> mem_tracker_;
+  std::unique_ptr<PersistentCacheMetrics> metrics_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool stopping_ GUARDED_BY(mutex_) = false;
+  std::unordered_map<uint64_t, Location> index_ GUARDED_BY(mutex_);
+  std::map<uint64_t, Segment> segments_ GUARDED_BY(mutex_);
+  std::deque<PendingBlock> pending_ GUARDED_BY(mutex_);
+  std::unordered_set<uint64_t> pending_hashes_ GUARDED_BY(mutex_);
+  size_t pending_bytes_ GUARDED_BY(mutex_) = 0;
+  // Hashes of recently declined blocks, indexed by hash.
+  std::unique_ptr<uint64_t[]> declined_ GUARDED_BY(mutex_);
+  std::atomic<size_t> usage_{0};
+
+  // Accessed only by the writer thread, or before it is started and after it is joined.
+  uint64_t current_segment_ = 0;
+  std::unique_ptr<WritableFile> writer_;
+  size_t current_size_ = 0;
+  std::vector<WrittenBlock> current_index_;
+  std::thread writer_thread_;
+};
+
+Status FilePersistentCache::Init() {
+  auto* env = options_.env;
+  RETURN_NOT_OK(env->CreateDirIfMissing(options_.path));
+
+  std::vector<std::string> children;
+  RETURN_NOT_OK(env->GetChildren(options_.path, &children));
+  std::vector<uint64_t> ids;
+  for (const auto& child : children) {
+    Slice name(child);
+    if (!name.ends_with(kSegmentSuffix)) {
+      continue;
+    }
+    name.remove_suffix(strlen(kSegmentSuffix));
+    auto id = yb::CheckedStoll(name);
+    if (!id.ok() || *id < 0) {
+      LOG(WARNING) << "Unexpected file in persistent cache directory: " << child;
+      continue;
+    }
+    ids.push_back(*id);
+  }
+  std::sort(ids.begin(), ids.end());
+  for (auto id : ids) {
+    current_segment_ = id;
+    auto status = RecoverSegment(id);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to recover persistent cache segment " << SegmentPath(id) << ": "
+                   << status;
+      WARN_NOT_OK(env->DeleteFile(SegmentPath(id)), "Failed to delete segment");
+    }
+  }
+  size_t num_blocks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_blocks = index_.size();
+  }
+  LOG(INFO) << "Persistent cache in " << options_.path << " recovered " << num_blocks
+            << " blocks, " << GetUsage() << " bytes";
+
+  RETURN_NOT_OK(OpenSegment());
+  writer_thread_ = std::thread(&FilePersistentCache::WriterThread, this);
+  return Status::OK();
+}
+
+Status FilePersistentCache::RecoverSegment(uint64_t id) {
+  Segment segment;
+  {
+    std::unique_ptr<RandomAccessFile> file;
+    RETURN_NOT_OK(options_.env->NewRandomAccessFile(SegmentPath(id), &file, env_options_));
+    segment.file = std::move(file);
+  }
+  segment.size = VERIFY_RESULT(segment.file->Size());
+  const auto segment_size = segment.size;
+  std::vector<WrittenBlock> blocks;
+  auto status = ReadSegmentIndex(id, &segment, &blocks);
+  if (!status.ok()) {
+    if (!status.IsNotFound()) {
+      LOG(WARNING) << "Failed to read persistent cache index " << IndexPath(id) << ": " << status;
+    }
+    blocks.clear();
+    RETURN_NOT_OK(ScanSegment(id, &segment, &blocks));
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    segments_.emplace(id, std::move(segment));
+  }
+  UpdateUsage(segment_size);
+  Publish(blocks);
+  return Status::OK();
+}
+
+Status FilePersistentCache::ReadSegmentIndex(
+    uint64_t id, Segment* segment, std::vector<WrittenBlock>* blocks) {
+  const auto path = IndexPath(id);
+  RETURN_NOT_OK(options_.env->FileExists(path));
+  std::unique_ptr<RandomAccessFile> file;
+  RETURN_NOT_OK(options_.env->NewRandomAccessFile(path, &file, env_options_));
+  const auto size = VERIFY_RESULT(file->Size());
+  if (size < 4 || (size - 4) % kIndexEntrySize != 0) {
+    return STATUS_FORMAT(Corruption, "Wrong index file size: $0", size);
+  }
+  std::unique_ptr<uint8_t[]> buffer(new uint8_t[size]);
+  Slice content;
+  RETURN_NOT_OK(file->Read(0, size, &content, buffer.get()));
+  if (content.size() != size) {
+    return STATUS_FORMAT(Corruption, "Index file truncated: $0 of $1", content.size(), size);
+  }
+  const char* data = content.cdata();
+  const auto expected_crc = crc32c::Unmask(DecodeFixed32(data + size - 4));
+  const auto actual_crc = crc32c::Value(data, size - 4);
+  if (expected_crc != actual_crc) {
+    return STATUS_FORMAT(
+        Corruption, "Wrong index file checksum: $0, expected: $1", actual_crc, expected_crc);
+  }
+  for (const char* p = data; p != data + size - 4; p += kIndexEntrySize) {
+    WrittenBlock block = {
+      .hash = DecodeFixed64(p),
+      .location = Location {
+        .segment = id,
+        .offset = DecodeFixed32(p + 8),
+        .size = DecodeFixed32(p + 12),
+      },
+    };
+    if (block.location.offset + block.location.size > segment->size) {
+      return STATUS_FORMAT(
+          Corruption, "Record out of segment bounds: $0 + $1 > $2",
+          block.location.offset, block.location.size, segment->size);
+    }
+    blocks->push_back(block);
+  }
+  return Status::OK();
+}
+
+Status FilePersistentCache::ScanSegment(
+    uint64_t id, Segment* segment, std::vector<WrittenBlock>* blocks) {
+  std::vector<uint8_t> buffer;
+  uint8_t header[kRecordHeaderSize];
+  size_t offset = 0;
+  while (offset + kRecordHeaderSize <= segment->size) {
+    Slice slice;
+    RETURN_NOT_OK(segment->file->Read(offset, kRecordHeaderSize, &slice, header));
+    if (slice.size() != kRecordHeaderSize) {
+      break;
+    }
+    const size_t record_size =
+        kRecordHeaderSize + DecodeFixed32(slice.cdata() + 4) + DecodeFixed32(slice.cdata() + 8);
+    if (offset + record_size > segment->size) {
+      break;
+    }
+    buffer.resize(record_size);
+    RETURN_NOT_OK(segment->file->Read(offset, record_size, &slice, buffer.data()));
+    Slice key, data;
+    if (slice.size() != record_size || !DecodeRecord(slice, &key, &data).ok()) {
+      break;
+    }
+    blocks->push_back(WrittenBlock {
+      .hash = key.hash(),
+      .location = Location {
+        .segment = id,
+        .offset = static_cast<uint32_t>(offset),
+        .size = static_cast<uint32_t>(record_size),
+      },
+    });
+    offset += record_size;
+  }
+  if (offset != segment->size) {
+    LOG(WARNING) << "Persistent cache segment " << SegmentPath(id) << " has " << offset
+                 << " valid bytes of " << segment->size;
+  }
+  return Status::OK();
+}
+
+bool FilePersistentCache::Admit(uint64_t hash, size_t size) {
+  auto& declined = declined_[hash % kNumDeclinedSlots];
+  bool result;
+  if (pending_bytes_ + size > options_.max_pending_bytes) {
+    result = false;
+  } else if (pending_bytes_ * 2 <= options_.max_pending_bytes) {
+    result = true;
+  } else {
+    result = declined == hash;
+  }
+  if (result) {
+    declined = 0;
+  } else {
+    declined = hash;
+    if (metrics_) {
+      metrics_->declined->Increment();
+    }
+  }
+  return result;
+}
+
+void FilePersistentCache::Insert(const Slice& key, const Slice& data) {
+  const auto hash = key.hash();
+  const size_t record_size = kRecordHeaderSize + key.size() + data.size();
+  if (record_size > options_.segment_size) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_ || index_.count(hash) || pending_hashes_.count(hash) ||
+        !Admit(hash, record_size)) {
+      return;
+    }
+    pending_hashes_.insert(hash);
+    pending_bytes_ += record_size;
+  }
+  mem_tracker_->Consume(record_size);
+
+  auto record = EncodeRecord(key, data);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.push_back(PendingBlock { .hash = hash, .record = std::move(record) });
+  }
+  cond_.notify_one();
+}
+
+Status FilePersistentCache::Lookup(
+    const Slice& key, std::unique_ptr<char[]>* data, size_t* size) {
+  const auto hash = key.hash();
+  Location location;
+  std::shared_ptr<RandomAccessFile> file;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(hash);
+    if (it != index_.end()) {
+      location = it->second;
+      file = segments_[location.segment].file;
+    }
+  }
+  if (!file) {
+    if (metrics_) {
+      metrics_->misses->Increment();
+    }
+    return STATUS(NotFound, "Block not found in persistent cache");
+  }
+
+  std::unique_ptr<uint8_t[]> buffer(new uint8_t[location.size]);
+  Slice record;
+  auto status = file->Read(location.offset, location.size, &record, buffer.get());
+  Slice record_key, record_data;
+  if (status.ok()) {
+    status = DecodeRecord(record, &record_key, &record_data);
+  }
+  if (status.ok() && record_key != key) {
+    // Other key with the same hash.
+    status = STATUS(NotFound, "Block not found in persistent cache");
+  }
+  if (!status.ok()) {
+    if (!status.IsNotFound()) {
+      LOG(WARNING) << "Failed to read block from persistent cache: " << status;
+    }
+    if (metrics_) {
+      metrics_->misses->Increment();
+    }
+    return status;
+  }
+
+  data->reset(new char[record_data.size()]);
+  memcpy(data->get(), record_data.data(), record_data.size());
+  *size = record_data.size();
+  if (metrics_) {
+    metrics_->hits->Increment();
+  }
+  return Status::OK();
+}
+
+void FilePersistentCache::Publish(const std::vector<WrittenBlock>& blocks) {
+  std::vector<std::string> obsolete_segments;
+  int64_t new_entries = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& block : blocks) {
+      auto segment_it = segments_.find(block.location.segment);
+      if (segment_it == segments_.end()) {
+        continue;
+      }
+      segment_it->second.hashes.push_back(block.hash);
+      auto inserted = index_.emplace(block.hash, block.location);
+      if (inserted.second) {
+        ++new_entries;
+      } else {
+        inserted.first->second = block.location;
+      }
+    }
+    // The current segment is never deleted.
+    while (usage_.load(std::memory_order_relaxed) > options_.capacity && segments_.size() > 1) {
+      auto it = segments_.begin();
+      for (auto hash : it->second.hashes) {
+        auto index_it = index_.find(hash);
+        if (index_it != index_.end() && index_it->second.segment == it->first) {
+          index_.erase(index_it);
+          --new_entries;
+        }
+      }
+      UpdateUsage(-static_cast<int64_t>(it->second.size));
+      obsolete_segments.push_back(SegmentPath(it->first));
+      obsolete_segments.push_back(IndexPath(it->first));
+      segments_.erase(it);
+    }
+  }
+  if (new_entries > 0) {
+    mem_tracker_->Consume(new_entries * kIndexEntryMemoryUsage);
+  } else if (new_entries < 0) {
+    mem_tracker_->Release(-new_entries * kIndexEntryMemoryUsage);
+  }
+  // Segment could be still read by concurrent lookups, but it is fine to delete an open file.
+  for (const auto& path : obsolete_segments) {
+    if (options_.env->FileExists(path).ok()) {
+      WARN_NOT_OK(options_.env->DeleteFile(path), "Failed to delete persistent cache file");
+    }
+  }
+}
+
+Status FilePersistentCache::OpenSegment() {
+  ++current_segment_;
+  const auto path = SegmentPath(current_segment_);
+  RETURN_NOT_OK(options_.env->NewWritableFile(path, &writer_, env_options_));
+  std::unique_ptr<RandomAccessFile> file;
+  RETURN_NOT_OK(options_.env->NewRandomAccessFile(path, &file, env_options_));
+  current_size_ = 0;
+  current_index_.clear();
+  std::lock_guard<std::mutex> lock(mutex_);
+  segments_[current_segment_].file = std::move(file);
+  return Status::OK();
+}
+
+Status FilePersistentCache::FinishSegment() {
+  auto writer = std::move(writer_);
+  RETURN_NOT_OK(writer->Close());
+
+  std::string index;
+  index.reserve(current_index_.size() * kIndexEntrySize + 4);
+  for (const auto& block : current_index_) {
+    PutFixed64(&index, block.hash);
+    PutFixed32(&index, block.location.offset);
+    PutFixed32(&index, block.location.size);
+  }
+  PutFixed32(&index, crc32c::Mask(crc32c::Value(index.data(), index.size())));
+  std::unique_ptr<WritableFile> index_writer;
+  RETURN_NOT_OK(options_.env->NewWritableFile(
+      IndexPath(current_segment_), &index_writer, env_options_));
+  RETURN_NOT_OK(index_writer->Append(index));
+  return index_writer->Close();
+}
+
+void FilePersistentCache::UpdateUsage(int64_t delta) {
+  usage_.fetch_add(delta, std::memory_order_relaxed);
+  if (metrics_) {
+    metrics_->usage->IncrementBy(delta);
+  }
+}
+
+Status FilePersistentCache::WriteBlocks(
+    std::deque<PendingBlock>* blocks, std::vector<WrittenBlock>* written) {
+  size_t bytes_written = 0;
+  for (auto& block : *blocks) {
+    if (current_size_ + block.record.size() > options_.segment_size) {
+      RETURN_NOT_OK(FinishSegment());
+      RETURN_NOT_OK(OpenSegment());
+    }
+    RETURN_NOT_OK(writer_->Append(block.record));
+    WrittenBlock written_block = {
+      .hash = block.hash,
+      .location = Location {
+        .segment = current_segment_,
+        .offset = static_cast<uint32_t>(current_size_),
+        .size = static_cast<uint32_t>(block.record.size()),
+      },
+    };
+    current_index_.push_back(written_block);
+    written->push_back(written_block);
+    current_size_ += block.record.size();
+    bytes_written += block.record.size();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      segments_[current_segment_].size = current_size_;
+    }
+    UpdateUsage(block.record.size());
+  }
+  // Blocks become visible to lookups only after they reach the file.
+  RETURN_NOT_OK(writer_->Flush());
+  if (metrics_) {
+    metrics_->inserts->IncrementBy(written->size());
+    metrics_->bytes_written->IncrementBy(bytes_written);
+  }
+  return Status::OK();
+}
+
+void FilePersistentCache::WriterThread() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  bool failed = false;
+  while (!stopping_) {
+    if (pending_.empty()) {
+      cond_.wait(lock);
+      continue;
+    }
+    std::deque<PendingBlock> blocks;
+    blocks.swap(pending_);
+    lock.unlock();
+
+    std::vector<WrittenBlock> written;
+    if (!failed) {
+      auto status = WriteBlocks(&blocks, &written);
+      if (!status.ok()) {
+        // Cache is just an optimization, so stop writing to it, but keep serving lookups.
+        LOG(WARNING) << "Failed to write to persistent cache, stop caching: " << status;
+        failed = true;
+        written.clear();
+      }
+    }
+    Publish(written);
+
+    size_t bytes = 0;
+    lock.lock();
+    for (const auto& block : blocks) {
+      pending_hashes_.erase(block.hash);
+      bytes += block.record.size();
+    }
+    pending_bytes_ -= bytes;
+    mem_tracker_->Release(bytes);
+  }
+}
+
+} // namespace
+
+Status NewPersistentCache(
+    const PersistentCacheOptions& options, std::shared_ptr<PersistentCache>* cache) {
+  auto result = std::make_shared<FilePersistentCache>(options);
+  RETURN_NOT_OK(result->Init());
+  *cache = std::move(result);
+  return Status::OK();
+}
+
+} // namespace rocksdb
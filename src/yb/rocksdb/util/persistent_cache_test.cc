@@ -0,0 +1,200 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+#include <vector>
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/persistent_cache.h"
+#include "yb/rocksdb/util/testharness.h"
+
+#include "yb/util/format.h"
+
+namespace rocksdb {
+
+namespace {
+
+std::string MakeKey(int i) {
+  return yb::Format("key-$0", i);
+}
+
+std::string MakeData(int i, size_t size) {
+  std::string result;
+  result.reserve(size);
+  while (result.size() < size) {
+    result += yb::Format("data-$0-", i);
+  }
+  result.resize(size);
+  return result;
+}
+
+} // namespace
+
+class PersistentCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    options_.env = Env::Default();
+    options_.path = test::TmpDir() + "/persistent_cache_test";
+    options_.capacity = 1_MB;
+    options_.segment_size = 64_KB;
+    options_.max_pending_bytes = 8_MB;
+    DestroyDir();
+    Open();
+  }
+
+  void TearDown() override {
+    cache_.reset();
+    DestroyDir();
+  }
+
+  void Open() {
+    cache_.reset();
+    ASSERT_OK(NewPersistentCache(options_, &cache_));
+  }
+
+  void DestroyDir() {
+    std::vector<std::string> children;
+    if (!options_.env->GetChildren(options_.path, &children).ok()) {
+      return;
+    }
+    for (const auto& child : children) {
+      if (child != "." && child != "..") {
+        ASSERT_OK(options_.env->DeleteFile(options_.path + "/" + child));
+      }
+    }
+    ASSERT_OK(options_.env->DeleteDir(options_.path));
+  }
+
+  // Returns data stored by key, or empty string if it is not found.
+  std::string Lookup(const std::string& key) {
+    std::unique_ptr<char[]> data;
+    size_t size = 0;
+    if (!cache_->Lookup(key, &data, &size).ok()) {
+      return std::string();
+    }
+    return std::string(data.get(), size);
+  }
+
+  // Blocks are written asynchronously, so wait until the block is found.
+  std::string WaitForLookup(const std::string& key) {
+    for (int i = 0; i != 1000; ++i) {
+      auto result = Lookup(key);
+      if (!result.empty()) {
+        return result;
+      }
+      options_.env->SleepForMicroseconds(10000);
+    }
+    return std::string();
+  }
+
+  PersistentCacheOptions options_;
+  std::shared_ptr<PersistentCache> cache_;
+};
+
+TEST_F(PersistentCacheTest, InsertAndLookup) {
+  ASSERT_EQ("", Lookup(MakeKey(1)));
+
+  const auto data = MakeData(1, 4_KB);
+  cache_->Insert(MakeKey(1), data);
+  ASSERT_EQ(data, WaitForLookup(MakeKey(1)));
+  ASSERT_EQ("", Lookup(MakeKey(2)));
+  ASSERT_GE(cache_->GetUsage(), data.size());
+}
+
+TEST_F(PersistentCacheTest, CloseFile) {
+  PersistentCacheFile file(cache_);
+  ASSERT_EQ(cache_.get(), file.cache());
+  ASSERT_EQ(cache_.get(), file.spill_cache());
+
+  // Blocks of a closed file are still looked up, but are not stored anymore.
+  file.Close();
+  ASSERT_EQ(cache_.get(), file.cache());
+  ASSERT_EQ(nullptr, file.spill_cache());
+}
+
+TEST_F(PersistentCacheTest, Recovery) {
+  // Spans several segments, each of them but the last one has an index file.
+  constexpr int kNumBlocks = 50;
+  constexpr size_t kBlockSize = 4_KB;
+  for (int i = 0; i != kNumBlocks; ++i) {
+    cache_->Insert(MakeKey(i), MakeData(i, kBlockSize));
+    ASSERT_EQ(MakeData(i, kBlockSize), WaitForLookup(MakeKey(i)));
+  }
+
+  Open();
+  for (int i = 0; i != kNumBlocks; ++i) {
+    ASSERT_EQ(MakeData(i, kBlockSize), Lookup(MakeKey(i))) << i;
+  }
+
+  // Without index files, blocks are recovered by reading the segments.
+  cache_.reset();
+  std::vector<std::string> children;
+  ASSERT_OK(options_.env->GetChildren(options_.path, &children));
+  for (const auto& child : children) {
+    if (Slice(child).ends_with(".pindex")) {
+      ASSERT_OK(options_.env->DeleteFile(options_.path + "/" + child));
+    }
+  }
+  Open();
+  for (int i = 0; i != kNumBlocks; ++i) {
+    ASSERT_EQ(MakeData(i, kBlockSize), Lookup(MakeKey(i))) << i;
+  }
+}
+
+TEST_F(PersistentCacheTest, Capacity) {
+  constexpr int kNumBlocks = 1000;
+  constexpr size_t kBlockSize = 4_KB;
+  for (int i = 0; i != kNumBlocks; ++i) {
+    cache_->Insert(MakeKey(i), MakeData(i, kBlockSize));
+    ASSERT_EQ(MakeData(i, kBlockSize), WaitForLookup(MakeKey(i)));
+    ASSERT_LE(cache_->GetUsage(), options_.capacity + options_.segment_size);
+  }
+  // Oldest blocks are dropped together with their segments.
+  ASSERT_EQ("", Lookup(MakeKey(0)));
+}
+
+TEST_F(PersistentCacheTest, Corruption) {
+  const auto data = MakeData(1, 4_KB);
+  cache_->Insert(MakeKey(1), data);
+  ASSERT_EQ(data, WaitForLookup(MakeKey(1)));
+  cache_.reset();
+
+  // Corrupt the data of the block.
+  std::vector<std::string> children;
+  ASSERT_OK(options_.env->GetChildren(options_.path, &children));
+  for (const auto& child : children) {
+    if (!Slice(child).ends_with(".pcache")) {
+      continue;
+    }
+    const auto path = options_.path + "/" + child;
+    uint64_t size = 0;
+    ASSERT_OK(options_.env->GetFileSize(path, &size));
+    if (size == 0) {
+      continue;
+    }
+    std::string contents;
+    ASSERT_OK(ReadFileToString(options_.env, path, &contents));
+    contents[contents.size() - 1] ^= 1;
+    ASSERT_OK(WriteStringToFile(options_.env, contents, path));
+  }
+
+  Open();
+  ASSERT_EQ("", Lookup(MakeKey(1)));
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
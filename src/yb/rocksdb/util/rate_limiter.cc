@@ -26,6 +26,19 @@
 
 namespace rocksdb {
 
+namespace {
+
+// Parameters of auto tuning: the rate is adjusted once per kRefillsPerTune refill periods, by
+// kAdjustFactorPct percent, when requests waited for refill in more than kHighWatermarkPct or
+// less than kLowWatermarkPct of the periods. The rate does not go below 1/kAllowedRangeFactor of
+// the configured one.
+constexpr int64_t kRefillsPerTune = 100;
+constexpr int64_t kAdjustFactorPct = 5;
+constexpr int64_t kHighWatermarkPct = 90;
+constexpr int64_t kLowWatermarkPct = 50;
+constexpr int64_t kAllowedRangeFactor = 20;
+
+} // namespace
 
 // Pending request
 struct GenericRateLimiter::Req {
@@ -38,7 +51,8 @@ struct GenericRateLimiter::Req {
 
 GenericRateLimiter::GenericRateLimiter(int64_t rate_bytes_per_sec,
                                        int64_t refill_period_us,
-                                       int32_t fairness)
+                                       int32_t fairness,
+                                       bool auto_tuned)
     : refill_period_us_(refill_period_us),
       refill_bytes_per_period_(
           CalculateRefillBytesPerPeriod(rate_bytes_per_sec)),
@@ -50,7 +64,10 @@ GenericRateLimiter::GenericRateLimiter(int64_t rate_bytes_per_sec,
       next_refill_us_(env_->NowMicros()),
       fairness_(fairness > 100 ? 100 : fairness),
       rnd_((uint32_t)time(nullptr)),
-      leader_(nullptr) {
+      leader_(nullptr),
+      auto_tuned_(auto_tuned),
+      max_bytes_per_sec_(rate_bytes_per_sec),
+      tuned_time_us_(next_refill_us_) {
   total_requests_[0] = 0;
   total_requests_[1] = 0;
   total_bytes_through_[0] = 0;
@@ -76,6 +93,7 @@ GenericRateLimiter::~GenericRateLimiter() {
 // This API allows user to dynamically change rate limiter's bytes per second.
 void GenericRateLimiter::SetBytesPerSecond(int64_t bytes_per_second) {
   DCHECK_GT(bytes_per_second, 0);
+  max_bytes_per_sec_.store(bytes_per_second, std::memory_order_relaxed);
   refill_bytes_per_period_.store(
       CalculateRefillBytesPerPeriod(bytes_per_second),
       std::memory_order_relaxed);
@@ -84,13 +102,20 @@ void GenericRateLimiter::SetBytesPerSecond(int64_t bytes_per_second) {
 }
 
 void GenericRateLimiter::Request(int64_t bytes, const Env::IOPriority pri) {
-  assert(bytes <= refill_bytes_per_period_.load(std::memory_order_relaxed));
+  // Auto tuned limiter could decrease the rate after the caller checked GetSingleBurstBytes.
+  assert(bytes <= CalculateRefillBytesPerPeriod(
+      max_bytes_per_sec_.load(std::memory_order_relaxed)));
 
   MutexLock g(&request_mutex_);
   if (stop_) {
     return;
   }
 
+  if (auto_tuned_ &&
+      env_->NowMicros() >= tuned_time_us_ + kRefillsPerTune * refill_period_us_) {
+    Tune();
+  }
+
   ++total_requests_[pri];
 
   if (available_bytes_ >= bytes) {
@@ -120,6 +145,7 @@ void GenericRateLimiter::Request(int64_t bytes, const Env::IOPriority pri) {
          (!queue_[Env::IO_LOW].empty() &&
             &r == queue_[Env::IO_LOW].front()))) {
       leader_ = &r;
+      ++num_drains_;
       timedout = r.cv.TimedWait(next_refill_us_);
     } else {
       // Not at the front of queue or an leader has already been elected
@@ -205,6 +231,11 @@ void GenericRateLimiter::Refill() {
     while (!queue->empty()) {
       auto* next_req = queue->front();
       if (available_bytes_ < next_req->bytes) {
+        // Grant the request partially, so a request for more bytes than are refilled per period,
+        // after the rate was decreased, is not starved.
+        next_req->bytes -= available_bytes_;
+        total_bytes_through_[use_pri] += available_bytes_;
+        available_bytes_ = 0;
         break;
       }
       available_bytes_ -= next_req->bytes;
@@ -220,13 +251,39 @@ void GenericRateLimiter::Refill() {
   }
 }
 
+void GenericRateLimiter::Tune() {
+  const int64_t now_us = env_->NowMicros();
+  const int64_t elapsed_periods =
+      std::max<int64_t>((now_us - tuned_time_us_) / refill_period_us_, 1);
+  const int64_t drained_pct = (num_drains_ - prev_num_drains_) * 100 / elapsed_periods;
+  tuned_time_us_ = now_us;
+  prev_num_drains_ = num_drains_;
+
+  const int64_t max_bytes_per_sec = max_bytes_per_sec_.load(std::memory_order_relaxed);
+  const int64_t min_bytes_per_sec = std::max<int64_t>(max_bytes_per_sec / kAllowedRangeFactor, 1);
+  const int64_t prev_bytes_per_sec = GetBytesPerSecond();
+  int64_t new_bytes_per_sec = prev_bytes_per_sec;
+  if (drained_pct > kHighWatermarkPct) {
+    // Round up, so that a small rate could still grow.
+    new_bytes_per_sec = (prev_bytes_per_sec * (100 + kAdjustFactorPct) + 99) / 100;
+  } else if (drained_pct < kLowWatermarkPct) {
+    new_bytes_per_sec = prev_bytes_per_sec * 100 / (100 + kAdjustFactorPct);
+  }
+  new_bytes_per_sec = std::max(std::min(new_bytes_per_sec, max_bytes_per_sec), min_bytes_per_sec);
+  if (new_bytes_per_sec != prev_bytes_per_sec) {
+    refill_bytes_per_period_.store(
+        std::max<int64_t>(CalculateRefillBytesPerPeriod(new_bytes_per_sec), 1),
+        std::memory_order_relaxed);
+  }
+}
+
 RateLimiter* NewGenericRateLimiter(
-    int64_t rate_bytes_per_sec, int64_t refill_period_us, int32_t fairness) {
+    int64_t rate_bytes_per_sec, int64_t refill_period_us, int32_t fairness, bool auto_tuned) {
   assert(rate_bytes_per_sec > 0);
   assert(refill_period_us > 0);
   assert(fairness > 0);
   return new GenericRateLimiter(
-      rate_bytes_per_sec, refill_period_us, fairness);
+      rate_bytes_per_sec, refill_period_us, fairness, auto_tuned);
 }
 
 }  // namespace rocksdb
@@ -36,13 +36,19 @@ namespace rocksdb {
 class GenericRateLimiter : public RateLimiter {
  public:
   GenericRateLimiter(int64_t refill_bytes,
-      int64_t refill_period_us, int32_t fairness);
+      int64_t refill_period_us, int32_t fairness, bool auto_tuned = false);
 
   virtual ~GenericRateLimiter();
 
   // This API allows user to dynamically change rate limiter's bytes per second.
+  // For auto tuned rate limiter it changes the upper bound of the rate.
   virtual void SetBytesPerSecond(int64_t bytes_per_second) override;
 
+  // Returns the current rate limit, that could differ from the one set for auto tuned limiter.
+  int64_t GetBytesPerSecond() const {
+    return refill_bytes_per_period_.load(std::memory_order_relaxed) * 1000000 / refill_period_us_;
+  }
+
   // Request for token to write bytes. If this request can not be satisfied,
   // the call is blocked. Caller is responsible to make sure
   // bytes <= GetSingleBurstBytes()
@@ -73,6 +79,11 @@ class GenericRateLimiter : public RateLimiter {
 
  private:
   void Refill();
+
+  // Adjusts the rate of auto tuned limiter according to the fraction of refill periods, since the
+  // previous adjustment, that requests had to wait for the refill.
+  void Tune();
+
   int64_t CalculateRefillBytesPerPeriod(int64_t rate_bytes_per_sec) {
     return rate_bytes_per_sec * refill_period_us_ / 1000000;
   }
@@ -100,6 +111,14 @@ class GenericRateLimiter : public RateLimiter {
   struct Req;
   Req* leader_;
   std::deque<Req*> queue_[Env::IO_TOTAL];
+
+  const bool auto_tuned_;
+  // Upper bound of the rate of auto tuned limiter, the rate itself otherwise.
+  std::atomic<int64_t> max_bytes_per_sec_;
+  // Number of times requests had to wait for the next refill.
+  int64_t num_drains_ = 0;
+  int64_t prev_num_drains_ = 0;
+  int64_t tuned_time_us_;
 };
 
 }  // namespace rocksdb
@@ -101,6 +101,36 @@ TEST_F(RateLimiterTest, Rate) {
     }
   }
 }
+
+TEST_F(RateLimiterTest, AutoTuned) {
+  constexpr int64_t kMaxBytesPerSec = 10 * 1000 * 1000;
+  // With 1ms refill period the rate is adjusted every 100ms.
+  constexpr int64_t kRefillPeriodUs = 1000;
+  auto* env = Env::Default();
+  GenericRateLimiter limiter(kMaxBytesPerSec, kRefillPeriodUs, 10, /* auto_tuned = */ true);
+  ASSERT_EQ(limiter.GetBytesPerSecond(), kMaxBytesPerSec);
+
+  // Requests that use a small part of the budget decrease the rate.
+  auto until = env->NowMicros() + 1000000;
+  while (env->NowMicros() < until) {
+    limiter.Request(1024, Env::IO_LOW);
+    env->SleepForMicroseconds(10000);
+  }
+  const auto decreased_bytes_per_sec = limiter.GetBytesPerSecond();
+  fprintf(stderr, "rate after light load: %" PRIi64 " KB/sec\n", decreased_bytes_per_sec / 1024);
+  ASSERT_LT(decreased_bytes_per_sec, kMaxBytesPerSec);
+  ASSERT_GE(decreased_bytes_per_sec, kMaxBytesPerSec / 20);
+
+  // Requests that keep waiting for refills increase the rate, up to the configured one.
+  until = env->NowMicros() + 1000000;
+  while (env->NowMicros() < until) {
+    limiter.Request(limiter.GetSingleBurstBytes(), Env::IO_LOW);
+  }
+  const auto increased_bytes_per_sec = limiter.GetBytesPerSecond();
+  fprintf(stderr, "rate after heavy load: %" PRIi64 " KB/sec\n", increased_bytes_per_sec / 1024);
+  ASSERT_GT(increased_bytes_per_sec, decreased_bytes_per_sec);
+  ASSERT_LE(increased_bytes_per_sec, kMaxBytesPerSec);
+}
 #endif
 
 }  // namespace rocksdb
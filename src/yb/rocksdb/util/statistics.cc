@@ -174,7 +174,7 @@ void StatisticsMetricImpl::histogramData(uint32_t histogramType, HistogramData*
     return;
   }
 
-  const yb::HdrHistogram* hist = histograms_[histogramType]->histogram();
+  auto hist = histograms_[histogramType]->Snapshot();
   data->count = hist->CurrentCount();
   data->sum = hist->CurrentSum();
   data->min = hist->MinValue();
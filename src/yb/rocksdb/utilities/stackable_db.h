@@ -288,6 +288,14 @@ class StackableDB : public DB {
     return db_->GetMiddleKey();
   };
 
+  yb::Result<std::vector<SstDataBlocks>> GetCachedDataBlocks(size_t max_blocks) override {
+    return db_->GetCachedDataBlocks(max_blocks);
+  }
+
+  CHECKED_STATUS WarmUpDataBlocks(const SstDataBlocks& file) override {
+    return db_->WarmUpDataBlocks(file);
+  }
+
   virtual void GetColumnFamilyMetaData(
       ColumnFamilyHandle *column_family,
       ColumnFamilyMetaData* cf_meta) override {
@@ -57,8 +57,8 @@ class EncryptedSequentialFile : public SequentialFileWrapper {
     if (!scratch) {
       return STATUS(InvalidArgument, "scratch argument is null.");
     }
-    uint8_t* buf = static_cast<uint8_t*>(EncryptionBuffer::Get()->GetBuffer(n));
-    RETURN_NOT_OK(SequentialFileWrapper::Read(n, result, buf));
+    // Decrypt in place when the underlying file reads into scratch.
+    RETURN_NOT_OK(SequentialFileWrapper::Read(n, result, scratch));
     RETURN_NOT_OK(stream_->Decrypt(offset_, *result, scratch));
     *result = Slice(scratch, result->size());
     offset_ += result->size();
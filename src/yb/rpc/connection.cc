@@ -307,7 +307,7 @@ Result<ProcessDataResult> Connection::ProcessReceived(
 Status Connection::HandleCallResponse(CallData* call_data) {
   DCHECK(reactor_->IsCurrentThread());
   CallResponse resp;
-  RETURN_NOT_OK(resp.ParseFrom(call_data));
+  RETURN_NOT_OK(resp.ParseFrom(call_data, rpc_metrics_));
 
   ++responded_call_count_;
   auto awaiting = awaiting_response_.find(resp.call_id());
@@ -86,6 +86,7 @@ InboundCall::InboundCall(ConnectionPtr conn, RpcMetrics* rpc_metrics,
       conn_(std::move(conn)),
       rpc_metrics_(rpc_metrics ? rpc_metrics : &conn_->rpc_metrics()),
       call_processed_listener_(std::move(call_processed_listener)) {
+  trace_->MaybeSample();
   TRACE_TO(trace_, "Created InboundCall");
   IncrementCounter(rpc_metrics_->inbound_calls_created);
   IncrementGauge(rpc_metrics_->inbound_calls_alive);
@@ -146,6 +146,9 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
   // If the client did not specify a deadline, returns MonoTime::Max().
   virtual CoarseTimePoint GetClientDeadline() const = 0;
 
+  // Whether the client marked this call as background work.
+  virtual bool IsBackgroundPriority() const { return false; }
+
   // Returns the time spent in the service queue -- from the time the call was received, until
   // it gets handled.
   MonoDelta GetTimeInQueue() const;
@@ -212,6 +215,8 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
 
   void QueueResponse(bool is_success);
 
+  RpcMetrics& rpc_metrics() { return *rpc_metrics_; }
+
   // The serialized bytes of the request param protobuf. Set by ParseFrom().
   // This references memory held by 'request_data_'.
   Slice serialized_request_;
@@ -77,6 +77,11 @@ class LocalYBInboundCall : public YBInboundCall {
     return sidecars_.size() - 1;
   }
 
+  size_t AddRpcSidecar(RefCntBuffer car) override {
+    sidecars_.push_back(std::move(car));
+    return sidecars_.size() - 1;
+  }
+
  protected:
   void Respond(const google::protobuf::MessageLite& response, bool is_success) override;
 
@@ -39,6 +39,8 @@
 
 #include <gflags/gflags.h>
 
+#include <lz4.h>
+
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/walltime.h"
 
@@ -89,6 +91,35 @@ using strings::Substitute;
 using google::protobuf::Message;
 using google::protobuf::io::CodedOutputStream;
 
+namespace {
+
+// Fits an OutboundCall with the control block of std::allocate_shared.
+struct OutboundCallBlock {
+  std::aligned_storage<sizeof(OutboundCall) + 64, alignof(std::max_align_t)>::type storage;
+};
+
+ThreadSafeObjectPool<OutboundCallBlock>& OutboundCallBlockPool() {
+  static ThreadSafeObjectPool<OutboundCallBlock> pool;
+  return pool;
+}
+
+} // namespace
+
+void* AllocateOutboundCallMemory(size_t size) {
+  if (size > sizeof(OutboundCallBlock)) {
+    return ::operator new(size);
+  }
+  return OutboundCallBlockPool().Take();
+}
+
+void FreeOutboundCallMemory(void* ptr, size_t size) {
+  if (size > sizeof(OutboundCallBlock)) {
+    ::operator delete(ptr);
+    return;
+  }
+  OutboundCallBlockPool().Release(static_cast<OutboundCallBlock*>(ptr));
+}
+
 OutboundCallMetrics::OutboundCallMetrics(const scoped_refptr<MetricEntity>& entity)
     : queue_time(METRIC_handler_latency_outbound_call_queue_time.Instantiate(entity)),
       send_time(METRIC_handler_latency_outbound_call_send_time.Instantiate(entity)),
@@ -546,6 +577,12 @@ Status OutboundCall::InitHeader(RequestHeader* header, bool copy) {
       }
       header->set_timeout_millis(timeout_millis);
     }
+    if (controller_->background_priority()) {
+      header->set_priority_class(RPC_PRIORITY_BACKGROUND);
+    }
+    if (controller_->accept_compressed_sidecars()) {
+      header->set_accepted_sidecars_compression(RPC_COMPRESSION_LZ4);
+    }
   }
   return Status::OK();
 }
@@ -587,7 +624,30 @@ Result<Slice> CallResponse::GetSidecar(int idx) const {
   return Slice(sidecar_bounds_[idx], sidecar_bounds_[idx + 1]);
 }
 
-Status CallResponse::ParseFrom(CallData* call_data) {
+Status CallResponse::DecompressSidecars(const Slice& compressed, RpcMetrics* rpc_metrics) {
+  if (header_.sidecars_compression() != RPC_COMPRESSION_LZ4) {
+    return STATUS_FORMAT(
+        NotSupported, "Unsupported sidecars compression: $0",
+        RpcCompressionPB_Name(header_.sidecars_compression()));
+  }
+  auto start = MonoTime::Now();
+  RefCntBuffer buffer(header_.uncompressed_sidecars_size());
+  int size = LZ4_decompress_safe(
+      compressed.cdata(), buffer.data(), compressed.size(), buffer.size());
+  if (size < 0 || static_cast<size_t>(size) != buffer.size()) {
+    return STATUS_FORMAT(
+        Corruption, "Failed to decompress sidecars, result: $0, expected size: $1",
+        size, buffer.size());
+  }
+  decompressed_sidecars_ = std::move(buffer);
+  if (rpc_metrics && rpc_metrics->sidecars_decompression_time_us) {
+    rpc_metrics->sidecars_decompression_time_us->IncrementBy(
+        MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+  }
+  return Status::OK();
+}
+
+Status CallResponse::ParseFrom(CallData* call_data, RpcMetrics* rpc_metrics) {
   CHECK(!parsed_);
   Slice entire_message;
 
@@ -599,23 +659,33 @@ Status CallResponse::ParseFrom(CallData* call_data) {
   const size_t sidecars = header_.sidecar_offsets_size();
 
   if (sidecars > 0) {
-    serialized_response_ = Slice(entire_message.data(),
-                                 header_.sidecar_offsets(0));
+    const uint32_t first_offset = header_.sidecar_offsets(0);
+    if (first_offset > entire_message.size()) {
+      return STATUS_FORMAT(
+          Corruption, "Invalid sidecar offsets; first sidecar starts at $0, but the entire "
+          "message has length $1", first_offset, entire_message.size());
+    }
+    serialized_response_ = Slice(entire_message.data(), first_offset);
+    Slice sidecars_data(entire_message.data() + first_offset, entire_message.end());
+    if (header_.sidecars_compression() != RPC_COMPRESSION_NONE) {
+      RETURN_NOT_OK(DecompressSidecars(sidecars_data, rpc_metrics));
+      sidecars_data = decompressed_sidecars_.AsSlice();
+    }
     sidecar_bounds_.reserve(sidecars + 1);
 
-    uint32_t prev_offset = 0;
+    uint32_t prev_offset = first_offset;
     for (auto offset : header_.sidecar_offsets()) {
-      if (offset > entire_message.size() || offset < prev_offset) {
+      if (offset < prev_offset || offset - first_offset > sidecars_data.size()) {
         return STATUS_FORMAT(
             Corruption,
             "Invalid sidecar offsets; sidecar apparently starts at $0,"
             " ends at $1, but the entire message has length $2",
-            prev_offset, offset, entire_message.size());
+            prev_offset, offset, first_offset + sidecars_data.size());
       }
-      sidecar_bounds_.push_back(entire_message.data() + offset);
+      sidecar_bounds_.push_back(sidecars_data.data() + offset - first_offset);
       prev_offset = offset;
     }
-    sidecar_bounds_.emplace_back(entire_message.end());
+    sidecar_bounds_.emplace_back(sidecars_data.end());
   } else {
     serialized_response_ = entire_message;
   }
@@ -138,7 +138,8 @@ class CallResponse {
 
   // Parse the response received from a call. This must be called before any
   // other methods on this object. Takes ownership of data content.
-  CHECKED_STATUS ParseFrom(CallData* data);
+  // Compressed sidecars are decompressed here, rpc_metrics is used to account the time spent on it.
+  CHECKED_STATUS ParseFrom(CallData* data, RpcMetrics* rpc_metrics = nullptr);
 
   // Return true if the call succeeded.
   bool is_success() const {
@@ -163,10 +164,13 @@ class CallResponse {
 
   size_t DynamicMemoryUsage() const {
     return DynamicMemoryUsageOf(header_, response_data_) +
-           GetFlatDynamicMemoryUsageOf(sidecar_bounds_);
+           GetFlatDynamicMemoryUsageOf(sidecar_bounds_) +
+           decompressed_sidecars_.DynamicMemoryUsage();
   }
 
  private:
+  CHECKED_STATUS DecompressSidecars(const Slice& compressed, RpcMetrics* rpc_metrics);
+
   // True once ParseFrom() is called.
   bool parsed_;
 
@@ -177,7 +181,8 @@ class CallResponse {
   // This slice refers to memory allocated by transfer_
   Slice serialized_response_;
 
-  // Slices of data for rpc sidecars. They point into memory owned by transfer_.
+  // Slices of data for rpc sidecars. They point into memory owned by transfer_, or into
+  // decompressed_sidecars_ when sidecars were sent compressed.
   // Number of sidecars chould be obtained from header_.
   boost::container::small_vector<const uint8_t*, kMinBufferForSidecarSlices> sidecar_bounds_;
 
@@ -185,6 +190,8 @@ class CallResponse {
   // and sidecar_slices_ refer into its data.
   CallData response_data_;
 
+  RefCntBuffer decompressed_sidecars_;
+
   DISALLOW_COPY_AND_ASSIGN(CallResponse);
 };
 
@@ -204,6 +211,37 @@ class InvokeCallbackTask : public rpc::ThreadPoolTask {
   OutboundCallPtr call_;
 };
 
+// Outbound calls are created and destroyed at a high rate, so their memory, together with the
+// shared_ptr control block, is taken from a free list instead of the general purpose allocator.
+void* AllocateOutboundCallMemory(size_t size);
+void FreeOutboundCallMemory(void* ptr, size_t size);
+
+// Allocator for std::allocate_shared of outbound calls.
+template <class T>
+class OutboundCallAllocator {
+ public:
+  typedef T value_type;
+
+  OutboundCallAllocator() = default;
+
+  template <class U>
+  OutboundCallAllocator(const OutboundCallAllocator<U>&) {} // NOLINT
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(AllocateOutboundCallMemory(n * sizeof(T)));
+  }
+
+  void deallocate(T* ptr, size_t n) {
+    FreeOutboundCallMemory(ptr, n * sizeof(T));
+  }
+
+  template <class U>
+  bool operator==(const OutboundCallAllocator<U>&) const { return true; }
+
+  template <class U>
+  bool operator!=(const OutboundCallAllocator<U>&) const { return false; }
+};
+
 // Tracks the status of a call on the client side.
 //
 // This is an internal-facing class -- clients interact with the
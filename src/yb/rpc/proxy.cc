@@ -159,15 +159,16 @@ void Proxy::DoAsyncRequest(const RemoteMethod* method,
                                           controller,
                                           &context_->rpc_metrics(),
                                           std::move(callback)) :
-      std::make_shared<OutboundCall>(method,
-                                     outbound_call_metrics_,
-                                     resp,
-                                     controller,
-                                     &context_->rpc_metrics(),
-                                     std::move(callback),
-                                     GetCallbackThreadPool(
-                                         force_run_callback_on_reactor,
-                                         controller->invoke_callback_mode()));
+      std::allocate_shared<OutboundCall>(OutboundCallAllocator<OutboundCall>(),
+                                         method,
+                                         outbound_call_metrics_,
+                                         resp,
+                                         controller,
+                                         &context_->rpc_metrics(),
+                                         std::move(callback),
+                                         GetCallbackThreadPool(
+                                             force_run_callback_on_reactor,
+                                             controller->invoke_callback_mode()));
   auto call = controller->call_.get();
   Status s = call->SetRequestParam(req, mem_tracker_);
   if (PREDICT_FALSE(!s.ok())) {
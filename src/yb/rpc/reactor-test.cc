@@ -37,6 +37,8 @@
 #include "yb/rpc/rpc-test-base.h"
 #include "yb/util/countdown_latch.h"
 
+DECLARE_bool(rpc_use_timing_wheel);
+
 using std::shared_ptr;
 using namespace std::literals;
 using namespace std::placeholders;
@@ -81,6 +83,17 @@ class ReactorTest : public RpcTestBase {
   CountDownLatch latch_;
 };
 
+// Sets rpc_use_timing_wheel before the messenger is created, and resets it after the messenger is
+// destroyed.
+class UseTimingWheel {
+ public:
+  UseTimingWheel() { FLAGS_rpc_use_timing_wheel = true; }
+  ~UseTimingWheel() { FLAGS_rpc_use_timing_wheel = false; }
+};
+
+class ReactorTimingWheelTest : private UseTimingWheel, public ReactorTest {
+};
+
 TEST_F(ReactorTest, TestFunctionIsCalled) {
   auto task_id = messenger_->ScheduleOnReactor(
       std::bind(&ReactorTest::ScheduledTask, this, _1, Status::OK()), 0s,
@@ -101,6 +114,26 @@ TEST_F(ReactorTest, TestFunctionIsCalledAtTheRightTime) {
   CHECK_GE(delta.ToMilliseconds(), 100);
 }
 
+TEST_F(ReactorTimingWheelTest, TestFunctionIsCalledAtTheRightTime) {
+  MonoTime before = MonoTime::Now();
+  auto task_id = messenger_->ScheduleOnReactor(
+      std::bind(&ReactorTest::ScheduledTask, this, _1, Status::OK()),
+      100ms, SOURCE_LOCATION(), nullptr /* messenger */);
+  ASSERT_EQ(task_id, 0);
+  latch_.Wait();
+  MonoDelta delta = MonoTime::Now().GetDeltaSince(before);
+  ASSERT_GE(delta.ToMilliseconds(), 100);
+}
+
+TEST_F(ReactorTimingWheelTest, TestFunctionIsCalledIfReactorShutdown) {
+  auto task_id = messenger_->ScheduleOnReactor(
+      std::bind(&ReactorTest::ScheduledTask, this, _1, STATUS(Aborted, "doesn't matter")),
+      60s, SOURCE_LOCATION(), nullptr /* messenger */);
+  ASSERT_EQ(task_id, 0);
+  messenger_->Shutdown();
+  latch_.Wait();
+}
+
 TEST_F(ReactorTest, TestFunctionIsCalledIfReactorShutdown) {
   auto task_id = messenger_->ScheduleOnReactor(
       std::bind(&ReactorTest::ScheduledTask, this, _1, STATUS(Aborted, "doesn't matter")),
@@ -36,6 +36,7 @@
 
 #include <functional>
 #include <list>
+#include <limits>
 #include <map>
 #include <memory>
 #include <set>
@@ -49,6 +50,7 @@
 #include "yb/gutil/ref_counted.h"
 
 #include "yb/rpc/outbound_call.h"
+#include "yb/rpc/timing_wheel.h"
 
 #include "yb/util/thread.h"
 #include "yb/util/locks.h"
@@ -222,7 +224,7 @@ YB_DEFINE_ENUM(MarkAsDoneResult,
 //    invoked, even during reactor shutdown.
 // 2. To differentiate between Abort and non-Abort, the user function receives a Status as its first
 //    argument.
-class DelayedTask : public ReactorTask {
+class DelayedTask : public ReactorTask, public TimingWheelEntry {
  public:
   DelayedTask(StatusFunctor func, MonoDelta when, int64_t id,
               const SourceLocation& source_location, Messenger* messenger);
@@ -248,6 +250,13 @@ class DelayedTask : public ReactorTask {
   // libev callback for when the registered timer fires.
   void TimerHandler(ev::timer& rwatcher, int revents); // NOLINT
 
+  // Invoked on the reactor thread when the task's time has come, by the libev timer or by the
+  // reactor timing wheel.
+  void HandleTimeout(int revents);
+
+  // Stops the libev timer or removes the task from the reactor timing wheel.
+  void StopTimer();
+
   // User function to invoke when timer fires or when task is aborted.
   StatusFunctor func_;
 
@@ -257,7 +266,7 @@ class DelayedTask : public ReactorTask {
   // Link back to registering reactor thread.
   Reactor* reactor_ = nullptr;
 
-  // libev timer. Set when Run() is invoked.
+  // libev timer. Set when Run() is invoked, unless the reactor timing wheel is used.
   ev::timer timer_;
 
   // This task's id.
@@ -401,6 +410,12 @@ class Reactor {
   // connection_keepalive_time_
   void ScanIdleConnections();
 
+  // Reactor timing wheel of delayed tasks, used when rpc_use_timing_wheel is set.
+  void AddToTimingWheel(DelayedTask* task, MonoDelta delay);
+  void RemoveFromTimingWheel(DelayedTask* task);
+  void StartTimingWheelTimer();
+  void TimingWheelHandler(ev::timer& watcher, int revents); // NOLINT
+
   // Assign a new outbound call to the appropriate connection object.
   // If this fails, the call is marked failed and completed.
   ConnectionPtr AssignOutboundCall(const OutboundCallPtr &call);
@@ -428,6 +443,9 @@ class Reactor {
   // parent messenger
   Messenger* const messenger_;
 
+  // Index of this reactor in the messenger.
+  const int index_;
+
   const std::string name_;
 
   const std::string log_prefix_;
@@ -463,6 +481,15 @@ class Reactor {
   // Scheduled (but not yet run) delayed tasks.
   std::set<std::shared_ptr<DelayedTask>> scheduled_tasks_;
 
+  // When set, scheduled_tasks_ expire from timing_wheel_, driven by the single
+  // timing_wheel_timer_, instead of having a libev timer each.
+  const bool use_timing_wheel_;
+  const std::chrono::steady_clock::time_point timing_wheel_origin_;
+  TimingWheel timing_wheel_;
+  ev::timer timing_wheel_timer_;
+  // Tick timing_wheel_timer_ is started for.
+  int64_t timing_wheel_timer_tick_ = std::numeric_limits<int64_t>::max();
+
   ReactorTasks async_handler_tasks_;
 
   // The current monotonic time.  Updated every coarse_timer_granularity_.
@@ -30,17 +30,38 @@
 // under the License.
 //
 
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <thread>
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
 #include "yb/rpc/rpc-test-base.h"
 #include "yb/rpc/rtest.proxy.h"
+#include "yb/rpc/secure_stream.h"
+#include "yb/rpc/tcp_stream.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/test_util.h"
 
 using namespace std::literals; // NOLINT
+using namespace yb::size_literals; // NOLINT
+
+DECLARE_int32(rpc_thread_pool_worker_spin_iterations);
+
+DEFINE_int32(rpc_bench_run_time_ms, 1000,
+             "How long each configuration of BenchmarkMatrix is run.");
+DEFINE_int32(rpc_bench_target_qps_per_thread, 0,
+             "If not 0, each client thread of BenchmarkMatrix sends calls on a fixed schedule "
+             "with this rate, and latency is measured from the scheduled send time, so queueing "
+             "delays are not hidden. Otherwise the next call is sent when the previous one is "
+             "done.");
+DEFINE_string(rpc_bench_output_file, "",
+              "File to append BenchmarkMatrix results to, one JSON object per line.");
 
 using std::string;
 using std::shared_ptr;
@@ -55,6 +76,8 @@ class RpcBench : public RpcTestBase {
  protected:
   friend class ClientThread;
 
+  void DoBenchmarkCalls();
+
   HostPort server_hostport_;
   std::atomic<bool> should_run_{true};
 };
@@ -100,8 +123,7 @@ class ClientThread {
 };
 
 
-// Test making successful RPC calls.
-TEST_F(RpcBench, BenchmarkCalls) {
+void RpcBench::DoBenchmarkCalls() {
   TestServerOptions options;
   options.n_worker_threads = 1;
 
@@ -149,6 +171,220 @@ TEST_F(RpcBench, BenchmarkCalls) {
   LOG(INFO) << "Sys CPU per req:  " << sys_cpu_micros_per_req << "us";
 }
 
+// Test making successful RPC calls.
+TEST_F(RpcBench, BenchmarkCalls) {
+  DoBenchmarkCalls();
+}
+
+// Same as above, but idle service workers spin before going to sleep.
+TEST_F(RpcBench, BenchmarkCallsWithSpinningWorkers) {
+  FLAGS_rpc_thread_pool_worker_spin_iterations = 1000;
+  DoBenchmarkCalls();
+}
+
+namespace {
+
+struct BenchmarkConfig {
+  std::string name;
+  // Size of the echoed payload or of the returned sidecar.
+  size_t payload_size;
+  // Return the payload as a sidecar instead of echoing it in the response protobuf.
+  bool sidecar;
+  bool secure;
+  int num_connections_to_server;
+  size_t num_client_reactors;
+  size_t num_client_threads;
+};
+
+const std::vector<BenchmarkConfig> kBenchmarkConfigs = {
+  { "tiny", 16, false, false, 1, 1, 16 },
+  { "small", 1_KB, false, false, 1, 2, 16 },
+  { "large", 256_KB, false, false, 1, 2, 4 },
+  { "small_sidecar", 1_KB, true, false, 1, 2, 16 },
+  { "large_sidecar", 1_MB, true, false, 1, 2, 4 },
+  { "tiny_many_connections", 16, false, false, 8, 4, 64 },
+  { "tiny_tls", 16, false, true, 1, 1, 16 },
+  { "large_tls", 256_KB, false, true, 1, 2, 4 },
+  { "large_sidecar_tls", 1_MB, true, true, 1, 2, 4 },
+};
+
+struct BenchmarkStats {
+  std::atomic<uint64_t> calls{0};
+  // Call latencies in microseconds.
+  HdrHistogram latency{60000000, 2};
+};
+
+void RunBenchmarkClient(
+    const BenchmarkConfig& config, Proxy* proxy, const std::atomic<bool>& stop,
+    BenchmarkStats* stats) {
+  CDSAttacher attacher;
+  const auto qps = FLAGS_rpc_bench_target_qps_per_thread;
+  const auto interval = qps > 0
+      ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(1s) / qps
+      : std::chrono::steady_clock::duration::zero();
+  auto next_send = std::chrono::steady_clock::now();
+
+  rpc_test::EchoRequestPB echo_req;
+  rpc_test::EchoResponsePB echo_resp;
+  rpc_test::SendStringsRequestPB strings_req;
+  rpc_test::SendStringsResponsePB strings_resp;
+  if (config.sidecar) {
+    strings_req.set_random_seed(1);
+    strings_req.add_sizes(config.payload_size);
+  } else {
+    echo_req.set_data(RandomHumanReadableString(config.payload_size));
+  }
+
+  while (!stop.load(std::memory_order_acquire)) {
+    auto start = std::chrono::steady_clock::now();
+    if (interval != std::chrono::steady_clock::duration::zero()) {
+      if (next_send > start) {
+        std::this_thread::sleep_until(next_send);
+      }
+      start = next_send;
+      next_send += interval;
+    }
+    RpcController controller;
+    controller.set_timeout(10s);
+    if (config.sidecar) {
+      CHECK_OK(proxy->SyncRequest(
+          CalculatorServiceMethods::SendStringsMethod(), strings_req, &strings_resp, &controller));
+    } else {
+      CHECK_OK(proxy->SyncRequest(
+          CalculatorServiceMethods::EchoMethod(), echo_req, &echo_resp, &controller));
+    }
+    stats->latency.Increment(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    stats->calls.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+std::string BenchmarkResultToJson(
+    const BenchmarkConfig& config, const BenchmarkStats& stats, double seconds) {
+  std::stringstream out;
+  JsonWriter jw(&out, JsonWriter::COMPACT);
+  jw.StartObject();
+  jw.String("name");
+  jw.String(config.name);
+  jw.String("payload_size");
+  jw.Uint64(config.payload_size);
+  jw.String("sidecar");
+  jw.Bool(config.sidecar);
+  jw.String("secure");
+  jw.Bool(config.secure);
+  jw.String("connections");
+  jw.Int(config.num_connections_to_server);
+  jw.String("client_reactors");
+  jw.Uint64(config.num_client_reactors);
+  jw.String("client_threads");
+  jw.Uint64(config.num_client_threads);
+  jw.String("target_qps_per_thread");
+  jw.Int(FLAGS_rpc_bench_target_qps_per_thread);
+  const auto calls = stats.calls.load();
+  jw.String("calls");
+  jw.Uint64(calls);
+  jw.String("calls_per_sec");
+  jw.Double(calls / seconds);
+
+  const auto& latency = stats.latency;
+  jw.String("latency_us");
+  jw.StartObject();
+  jw.String("mean");
+  jw.Double(latency.MeanValue());
+  for (auto percentile : {50.0, 99.0, 99.9}) {
+    jw.String(Format("p$0", percentile));
+    jw.Uint64(latency.ValueAtPercentile(percentile));
+  }
+  jw.String("max");
+  jw.Uint64(latency.MaxValue());
+  jw.EndObject();
+
+  jw.EndObject();
+  return out.str();
+}
+
+} // namespace
+
+class RpcBenchMatrix : public RpcTestBase {
+ protected:
+  void SetUp() override {
+    RpcTestBase::SetUp();
+    secure_context_ = std::make_unique<SecureContext>();
+    ASSERT_OK(secure_context_->TEST_GenerateKeys(1024, "127.0.0.1"));
+  }
+
+  std::unique_ptr<Messenger> CreateBenchmarkMessenger(
+      const std::string& name, const MessengerOptions& options, bool secure) {
+    auto builder = CreateMessengerBuilder(name, options);
+    if (secure) {
+      builder.SetListenProtocol(SecureStreamProtocol());
+      builder.AddStreamFactory(
+          SecureStreamProtocol(),
+          SecureStreamFactory(TcpStream::Factory(), MemTracker::GetRootTracker(),
+                              secure_context_.get()));
+    }
+    return EXPECT_RESULT(builder.Build());
+  }
+
+  // Runs the benchmark for config and returns its results as a JSON object.
+  std::string RunBenchmark(const BenchmarkConfig& config) {
+    TestServerOptions server_options;
+    auto server_messenger = CreateBenchmarkMessenger(
+        "TestServer", server_options.messenger_options, config.secure);
+    TestServer server(
+        std::make_unique<GenericCalculatorService>(), std::move(server_messenger),
+        server_options);
+    auto server_hostport = HostPort::FromBoundEndpoint(server.bound_endpoint());
+
+    MessengerOptions client_options = kDefaultClientMessengerOptions;
+    client_options.n_reactors = config.num_client_reactors;
+    client_options.num_connections_to_server = config.num_connections_to_server;
+    auto client_messenger = CreateAutoShutdownMessengerHolder(
+        CreateBenchmarkMessenger("Client", client_options, config.secure));
+    Proxy proxy(client_messenger.get(), server_hostport,
+                config.secure ? SecureStreamProtocol() : nullptr);
+
+    BenchmarkStats stats;
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i != config.num_client_threads; ++i) {
+      threads.emplace_back([&config, &proxy, &stop, &stats] {
+        RunBenchmarkClient(config, &proxy, stop, &stats);
+      });
+    }
+    std::this_thread::sleep_for(FLAGS_rpc_bench_run_time_ms * 1ms);
+    stop.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    server.Shutdown();
+    return BenchmarkResultToJson(config, stats, seconds);
+  }
+
+  std::unique_ptr<SecureContext> secure_context_;
+};
+
+// Runs calls of different shapes over plain and encrypted connections, and reports throughput
+// and latency percentiles of each configuration as JSON, so changes of the RPC layer could be
+// compared with each other.
+TEST_F(RpcBenchMatrix, BenchmarkMatrix) {
+  std::ofstream output;
+  if (!FLAGS_rpc_bench_output_file.empty()) {
+    output.open(FLAGS_rpc_bench_output_file, std::ios_base::app);
+    ASSERT_TRUE(output.good()) << "Failed to open " << FLAGS_rpc_bench_output_file;
+  }
+  for (const auto& config : kBenchmarkConfigs) {
+    auto result = RunBenchmark(config);
+    LOG(INFO) << "RPC benchmark result: " << result;
+    if (output.is_open()) {
+      output << result << std::endl;
+    }
+  }
+}
+
 } // namespace rpc
 } // namespace yb
 
@@ -61,6 +61,19 @@ namespace {
 
 constexpr size_t kQueueLength = 1000;
 
+// Fills sidecar with random bytes. Compressible sidecar repeats the same short random chunk.
+void FillSidecar(uint8_t* dest, size_t size, bool compressible, Random* rng) {
+  constexpr size_t kChunkSize = 64;
+  if (!compressible || size <= kChunkSize) {
+    RandomString(dest, size, rng);
+    return;
+  }
+  RandomString(dest, kChunkSize, rng);
+  for (size_t offset = kChunkSize; offset < size; offset += kChunkSize) {
+    memcpy(dest + offset, dest, std::min(kChunkSize, size - offset));
+  }
+}
+
 Slice GetSidecarPointer(const RpcController& controller, int idx, int expected_size) {
   Slice sidecar = CHECK_RESULT(controller.GetSidecar(idx));
   CHECK_EQ(expected_size, sidecar.size());
@@ -147,7 +160,7 @@ void GenericCalculatorService::DoSendStrings(InboundCall* incoming) {
   SendStringsResponsePB resp;
   for (auto size : req.sizes()) {
     auto sidecar = RefCntBuffer(size);
-    RandomString(sidecar.udata(), size, &r);
+    FillSidecar(sidecar.udata(), size, req.compressible(), &r);
     resp.add_sidecars(down_cast<YBInboundCall*>(incoming)->AddRpcSidecar(sidecar.as_slice()));
   }
 
@@ -378,7 +391,8 @@ CHECKED_STATUS RpcTestBase::DoTestSyncCall(Proxy* proxy, const RemoteMethod* met
 
 void RpcTestBase::DoTestSidecar(Proxy* proxy,
                                 std::vector<size_t> sizes,
-                                Status::Code expected_code) {
+                                Status::Code expected_code,
+                                bool compressible) {
   const uint32_t kSeed = 12345;
 
   SendStringsRequestPB req;
@@ -386,10 +400,12 @@ void RpcTestBase::DoTestSidecar(Proxy* proxy,
     req.add_sizes(size);
   }
   req.set_random_seed(kSeed);
+  req.set_compressible(compressible);
 
   SendStringsResponsePB resp;
   RpcController controller;
   controller.set_timeout(MonoDelta::FromMilliseconds(10000));
+  controller.set_accept_compressed_sidecars(compressible);
   auto status = proxy->SyncRequest(
       CalculatorServiceMethods::SendStringsMethod(), req, &resp, &controller);
 
@@ -405,7 +421,7 @@ void RpcTestBase::DoTestSidecar(Proxy* proxy,
     size_t size = sizes[i];
     expected.resize(size);
     Slice sidecar = GetSidecarPointer(controller, resp.sidecars(i), size);
-    RandomString(expected.data(), size, &rng);
+    FillSidecar(expected.data(), size, compressible, &rng);
     ASSERT_EQ(0, sidecar.compare(expected)) << "Invalid sidecar at " << i << " position";
   }
 }
@@ -192,9 +192,12 @@ class RpcTestBase : public YBTest {
 
   CHECKED_STATUS DoTestSyncCall(Proxy* proxy, const RemoteMethod *method);
 
+  // If compressible is true, the server is allowed to compress sidecars and fills them with
+  // compressible data.
   void DoTestSidecar(Proxy* proxy,
                      std::vector<size_t> sizes,
-                     Status::Code expected_code = Status::Code::kOk);
+                     Status::Code expected_code = Status::Code::kOk,
+                     bool compressible = false);
 
   void DoTestExpectTimeout(Proxy* proxy, const MonoDelta &timeout);
 
@@ -50,6 +50,7 @@
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/join.h"
 
+#include "yb/rpc/rpc_metrics.h"
 #include "yb/rpc/secure_stream.h"
 #include "yb/rpc/serialization.h"
 #include "yb/rpc/tcp_stream.h"
@@ -76,6 +77,8 @@ DECLARE_int32(rpc_throttle_threshold_bytes);
 DECLARE_bool(TEST_pause_calculator_echo_request);
 DECLARE_bool(binary_call_parser_reject_on_mem_tracker_hard_limit);
 DECLARE_string(vmodule);
+DECLARE_int32(ssl_coalesce_write_size);
+DECLARE_int32(ssl_bio_pair_buffer_size);
 
 using namespace std::chrono_literals;
 using std::string;
@@ -433,6 +436,27 @@ TEST_F(TestRpc, TestRpcSidecar) {
   DoTestSidecar(&p, sizes);
 }
 
+TEST_F(TestRpc, TestCompressedRpcSidecar) {
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+  auto& metrics = server_messenger()->rpc_metrics();
+
+  // Sidecars smaller than rpc_sidecars_compression_min_size are not compressed.
+  DoTestSidecar(&p, {123, 456}, Status::Code::kOk, /* compressible= */ true);
+  ASSERT_EQ(metrics.sidecars_compression_input_bytes->value(), 0);
+
+  const int64_t kCompressedSize = 5_MB + 123;
+  DoTestSidecar(&p, {3_MB, 123, 2_MB}, Status::Code::kOk, /* compressible= */ true);
+  ASSERT_EQ(metrics.sidecars_compression_input_bytes->value(), kCompressedSize);
+  ASSERT_LT(metrics.sidecars_compression_output_bytes->value(), kCompressedSize / 10);
+
+  // Random data is not compressed, because the caller does not accept compressed sidecars.
+  DoTestSidecar(&p, {1_MB});
+  ASSERT_EQ(metrics.sidecars_compression_input_bytes->value(), kCompressedSize);
+}
+
 // Test that timeouts are properly handled.
 TEST_F(TestRpc, TestCallTimeout) {
   HostPort server_addr;
@@ -1077,6 +1101,33 @@ TEST_F(TestRpcSecure, TLS) {
   ASSERT_EQ(30, resp.result());
 }
 
+TEST_F(TestRpcSecure, CoalescedWrites) {
+  FLAGS_ssl_coalesce_write_size = 16_KB;
+  FLAGS_ssl_bio_pair_buffer_size = 256_KB;
+
+  auto client_messenger = rpc::CreateAutoShutdownMessengerHolder(CreateSecureMessenger("Client"));
+  auto proxy_cache = std::make_unique<ProxyCache>(client_messenger.get());
+
+  TestServerOptions options;
+  HostPort server_hostport;
+  StartTestServerWithGeneratedCode(
+      CreateSecureMessenger("TestServer", kDefaultServerMessengerOptions), &server_hostport,
+      options);
+
+  rpc_test::CalculatorServiceProxy p(proxy_cache.get(), server_hostport, SecureStreamProtocol());
+
+  // Both small messages, that are coalesced, and messages larger than the BIO buffer.
+  for (size_t size : {10_KB, 1_MB}) {
+    RpcController controller;
+    controller.set_timeout(5s);
+    rpc_test::EchoRequestPB req;
+    req.set_data(RandomHumanReadableString(size));
+    rpc_test::EchoResponsePB resp;
+    ASSERT_OK(p.Echo(req, &resp, &controller));
+    ASSERT_EQ(req.data(), resp.data());
+  }
+}
+
 TEST_F(TestRpcSecure, CantAllocateReadBuffer) {
   // Set up server.
   TestServerOptions options = SetupServerForTestCantAllocateReadBuffer();
@@ -45,6 +45,7 @@
 #include "yb/rpc/reactor.h"
 #include "yb/rpc/yb_rpc.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/hdr_histogram.h"
 #include "yb/util/metrics.h"
 #include "yb/util/trace.h"
@@ -55,6 +56,12 @@
 using google::protobuf::Message;
 DECLARE_int32(rpc_max_message_size);
 
+DEFINE_bool(rpc_allocate_messages_on_arena, false,
+            "Allocate request and response protobufs of inbound calls on a per call arena, "
+            "for services whose protos enable arenas.");
+TAG_FLAG(rpc_allocate_messages_on_arena, advanced);
+TAG_FLAG(rpc_allocate_messages_on_arena, runtime);
+
 namespace yb {
 namespace rpc {
 
@@ -91,6 +98,10 @@ scoped_refptr<debug::ConvertableToTraceFormat> TracePb(const Message& msg) {
 }
 }  // anonymous namespace
 
+bool ShouldAllocateRpcMessagesOnArena() {
+  return FLAGS_rpc_allocate_messages_on_arena;
+}
+
 RpcContext::~RpcContext() {
   if (call_ && !responded_) {
     LOG(DFATAL) << "RpcContext is destroyed, but response has not been sent, for call: "
@@ -173,6 +184,10 @@ size_t RpcContext::AddRpcSidecar(const Slice& car) {
   return call_->AddRpcSidecar(car);
 }
 
+size_t RpcContext::AddRpcSidecar(RefCntBuffer car) {
+  return call_->AddRpcSidecar(std::move(car));
+}
+
 void RpcContext::ResetRpcSidecars() {
   call_->ResetRpcSidecars();
 }
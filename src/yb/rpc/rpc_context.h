@@ -32,7 +32,11 @@
 #ifndef YB_RPC_RPC_CONTEXT_H
 #define YB_RPC_RPC_CONTEXT_H
 
+#include <memory>
 #include <string>
+#include <type_traits>
+
+#include <google/protobuf/arena.h>
 
 #include "yb/rpc/rpc_header.pb.h"
 #include "yb/rpc/service_if.h"
@@ -59,6 +63,78 @@ namespace rpc {
 
 class YBInboundCall;
 
+// Request and response protobufs of an inbound call.
+struct RpcCallMessages {
+  std::shared_ptr<google::protobuf::Message> request;
+  std::shared_ptr<google::protobuf::Message> response;
+};
+
+// Returns true if messages that support arenas should be allocated on a per call arena, see
+// rpc_allocate_messages_on_arena.
+bool ShouldAllocateRpcMessagesOnArena();
+
+namespace internal {
+
+template <class Req, class Resp>
+class RpcCallMessagesHolder {
+ public:
+  Req* request() { return &request_; }
+  Resp* response() { return &response_; }
+
+ private:
+  Req request_;
+  Resp response_;
+};
+
+template <class Req, class Resp>
+class RpcCallArenaMessagesHolder {
+ public:
+  Req* request() { return request_; }
+  Resp* response() { return response_; }
+
+ private:
+  google::protobuf::Arena arena_;
+  Req* request_ = google::protobuf::Arena::CreateMessage<Req>(&arena_);
+  Resp* response_ = google::protobuf::Arena::CreateMessage<Resp>(&arena_);
+};
+
+template <class Holder>
+RpcCallMessages MakeRpcCallMessages(std::shared_ptr<Holder> holder) {
+  auto* request = holder->request();
+  auto* response = holder->response();
+  return RpcCallMessages {
+    .request = std::shared_ptr<google::protobuf::Message>(holder, request),
+    .response = std::shared_ptr<google::protobuf::Message>(std::move(holder), response),
+  };
+}
+
+} // namespace internal
+
+// Allocates request and response of a call with a single allocation. When both messages support
+// arenas, they could be allocated on an arena that is freed together with the call, so sub-messages
+// of a big request are not allocated and freed one by one.
+template <class Req, class Resp>
+typename std::enable_if<google::protobuf::Arena::is_arena_constructable<Req>::value &&
+                        google::protobuf::Arena::is_arena_constructable<Resp>::value,
+                        RpcCallMessages>::type
+AllocateRpcCallMessages() {
+  if (ShouldAllocateRpcMessagesOnArena()) {
+    return internal::MakeRpcCallMessages(
+        std::make_shared<internal::RpcCallArenaMessagesHolder<Req, Resp>>());
+  }
+  return internal::MakeRpcCallMessages(
+      std::make_shared<internal::RpcCallMessagesHolder<Req, Resp>>());
+}
+
+template <class Req, class Resp>
+typename std::enable_if<!google::protobuf::Arena::is_arena_constructable<Req>::value ||
+                        !google::protobuf::Arena::is_arena_constructable<Resp>::value,
+                        RpcCallMessages>::type
+AllocateRpcCallMessages() {
+  return internal::MakeRpcCallMessages(
+      std::make_shared<internal::RpcCallMessagesHolder<Req, Resp>>());
+}
+
 // The context provided to a generated ServiceIf. This provides
 // methods to respond to the RPC. In the future, this will also
 // include methods to access information about the caller: e.g
@@ -73,6 +149,11 @@ class RpcContext {
              std::shared_ptr<google::protobuf::Message> request_pb,
              std::shared_ptr<google::protobuf::Message> response_pb,
              RpcMethodMetrics metrics);
+  RpcContext(std::shared_ptr<YBInboundCall> call,
+             RpcCallMessages messages,
+             RpcMethodMetrics metrics)
+      : RpcContext(std::move(call), std::move(messages.request), std::move(messages.response),
+                   std::move(metrics)) {}
   RpcContext(std::shared_ptr<LocalYBInboundCall> call,
              RpcMethodMetrics metrics);
 
@@ -173,6 +254,10 @@ class RpcContext {
   // Returns the index of the sidecar.
   size_t AddRpcSidecar(const Slice& car);
 
+  // Same as above, but the buffer is sent as is, without copying it. So it is preferred when
+  // the sidecar is already stored in a RefCntBuffer.
+  size_t AddRpcSidecar(RefCntBuffer car);
+
   // Removes all RpcSidecars.
   void ResetRpcSidecars();
 
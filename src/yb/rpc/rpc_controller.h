@@ -146,6 +146,15 @@ class RpcController {
 
   InvokeCallbackMode invoke_callback_mode() { return invoke_callback_mode_; }
 
+  // Marks the call as background work, that the server could delay in favor of normal calls.
+  void set_background_priority(bool value) { background_priority_ = value; }
+  bool background_priority() const { return background_priority_; }
+
+  // Allows the server to send response sidecars compressed, see
+  // rpc_sidecars_compression_min_size.
+  void set_accept_compressed_sidecars(bool value) { accept_compressed_sidecars_ = value; }
+  bool accept_compressed_sidecars() const { return accept_compressed_sidecars_; }
+
   // Return the configured timeout.
   MonoDelta timeout() const;
 
@@ -171,6 +180,8 @@ class RpcController {
   OutboundCallPtr call_;
   bool allow_local_calls_in_curr_thread_ = false;
   InvokeCallbackMode invoke_callback_mode_ = InvokeCallbackMode::kThreadPoolNormal;
+  bool background_priority_ = false;
+  bool accept_compressed_sidecars_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(RpcController);
 };
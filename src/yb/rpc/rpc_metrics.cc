@@ -43,6 +43,27 @@ METRIC_DEFINE_counter(server, rpc_outbound_calls_created,
                       yb::MetricUnit::kRequests,
                       "Number of created RPC outbound calls.");
 
+METRIC_DEFINE_counter(server, rpc_sidecars_compression_input_bytes,
+                      "Size of compressed RPC response sidecars before compression.",
+                      yb::MetricUnit::kBytes,
+                      "Size of compressed RPC response sidecars before compression.");
+
+METRIC_DEFINE_counter(server, rpc_sidecars_compression_output_bytes,
+                      "Size of compressed RPC response sidecars after compression.",
+                      yb::MetricUnit::kBytes,
+                      "Size of compressed RPC response sidecars after compression.");
+
+METRIC_DEFINE_counter(server, rpc_sidecars_compression_time_us,
+                      "Time spent compressing RPC response sidecars.",
+                      yb::MetricUnit::kMicroseconds,
+                      "Time spent compressing RPC response sidecars, including the attempts "
+                      "that did not make them smaller.");
+
+METRIC_DEFINE_counter(server, rpc_sidecars_decompression_time_us,
+                      "Time spent decompressing received RPC response sidecars.",
+                      yb::MetricUnit::kMicroseconds,
+                      "Time spent decompressing received RPC response sidecars.");
+
 namespace yb {
 namespace rpc {
 
@@ -54,6 +75,14 @@ RpcMetrics::RpcMetrics(const scoped_refptr<MetricEntity>& metric_entity) {
     inbound_calls_created = METRIC_rpc_inbound_calls_created.Instantiate(metric_entity);
     outbound_calls_alive = METRIC_rpc_outbound_calls_alive.Instantiate(metric_entity, 0);
     outbound_calls_created = METRIC_rpc_outbound_calls_created.Instantiate(metric_entity);
+    sidecars_compression_input_bytes =
+        METRIC_rpc_sidecars_compression_input_bytes.Instantiate(metric_entity);
+    sidecars_compression_output_bytes =
+        METRIC_rpc_sidecars_compression_output_bytes.Instantiate(metric_entity);
+    sidecars_compression_time_us =
+        METRIC_rpc_sidecars_compression_time_us.Instantiate(metric_entity);
+    sidecars_decompression_time_us =
+        METRIC_rpc_sidecars_decompression_time_us.Instantiate(metric_entity);
   }
 }
 
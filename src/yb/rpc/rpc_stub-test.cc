@@ -54,6 +54,7 @@
 #include "yb/util/net/net_util.h"
 
 DEFINE_bool(is_panic_test_child, false, "Used by TestRpcPanic");
+DECLARE_bool(rpc_skip_eagain_syscalls);
 DECLARE_bool(socket_inject_short_recvs);
 DECLARE_int32(rpc_slow_query_threshold_ms);
 DECLARE_int32(TEST_delay_connect_ms);
@@ -315,6 +316,44 @@ TEST_F(RpcStubTest, TestBigCallData) {
   }
 }
 
+// Sends many small calls at once, so they are queued to the same connection and written with
+// several iovecs per writev, together with big calls that are written and received in parts.
+TEST_F(RpcStubTest, SkipEagainSyscalls) {
+  constexpr int kNumSmallCalls = 500;
+  constexpr int kNumBigCalls = 4;
+  constexpr size_t kSmallMessageSize = 100;
+  constexpr size_t kBigMessageSize = NonTsanVsTsan(8_MB, 1_MB);
+
+  struct Call {
+    EchoRequestPB req;
+    EchoResponsePB resp;
+    RpcController controller;
+  };
+
+  CalculatorServiceProxy p(proxy_cache_.get(), server_hostport_);
+  for (bool skip_eagain_syscalls : {false, true}) {
+    SCOPED_TRACE(Format("skip_eagain_syscalls: $0", skip_eagain_syscalls));
+    FLAGS_rpc_skip_eagain_syscalls = skip_eagain_syscalls;
+
+    std::vector<Call> calls(kNumSmallCalls + kNumBigCalls);
+    CountDownLatch latch(calls.size());
+    for (size_t i = 0; i != calls.size(); ++i) {
+      auto& call = calls[i];
+      // Big calls are interleaved with small ones.
+      const bool big = i % (kNumSmallCalls / kNumBigCalls + 1) == 0;
+      call.req.set_data(RandomHumanReadableString(big ? kBigMessageSize : kSmallMessageSize));
+      call.controller.set_timeout(60s);
+      p.EchoAsync(call.req, &call.resp, &call.controller, [&latch] { latch.CountDown(); });
+    }
+    latch.Wait();
+
+    for (const auto& call : calls) {
+      ASSERT_OK(call.controller.status());
+      ASSERT_EQ(call.req.data(), call.resp.data());
+    }
+  }
+}
+
 TEST_F(RpcStubTest, TestRespondDeferred) {
   CalculatorServiceProxy p(proxy_cache_.get(), server_hostport_);
 
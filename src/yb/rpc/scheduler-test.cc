@@ -24,8 +24,11 @@
 
 #include "yb/util/countdown_latch.h"
 #include "yb/util/memory/memory.h"
+#include "yb/util/random_util.h"
 #include "yb/util/tostring.h"
 
+DECLARE_bool(rpc_use_timing_wheel);
+
 namespace yb {
 namespace rpc {
 
@@ -47,10 +50,25 @@ class SchedulerTest : public RpcTestBase {
   }
 
  protected:
+  void TestFunctionIsCalledAtTheRightTime();
+  void TestAbort();
+
+  // Schedules and aborts tasks, like RPC timeouts cancelled once calls complete, and logs the
+  // time per task.
+  void BenchmarkScheduleAndAbort();
+
   boost::optional<IoThreadPool> pool_;
   boost::optional<Scheduler> scheduler_;
 };
 
+class SchedulerTimingWheelTest : public SchedulerTest {
+ public:
+  void SetUp() override {
+    FLAGS_rpc_use_timing_wheel = true;
+    SchedulerTest::SetUp();
+  }
+};
+
 const int kCycles = 1000;
 
 auto SetPromiseValueToStatusFunctor(std::promise<Status>* promise) {
@@ -66,7 +84,7 @@ TEST_F(SchedulerTest, TestFunctionIsCalled) {
   }
 }
 
-TEST_F(SchedulerTest, TestFunctionIsCalledAtTheRightTime) {
+void SchedulerTest::TestFunctionIsCalledAtTheRightTime() {
   using yb::ToString;
 
   for (int i = 0; i != 10; ++i) {
@@ -88,6 +106,14 @@ TEST_F(SchedulerTest, TestFunctionIsCalledAtTheRightTime) {
   }
 }
 
+TEST_F(SchedulerTest, TestFunctionIsCalledAtTheRightTime) {
+  TestFunctionIsCalledAtTheRightTime();
+}
+
+TEST_F(SchedulerTimingWheelTest, TestFunctionIsCalledAtTheRightTime) {
+  TestFunctionIsCalledAtTheRightTime();
+}
+
 TEST_F(SchedulerTest, TestFunctionIsCalledIfReactorShutdown) {
   std::promise<Status> promise;
   auto future = promise.get_future();
@@ -96,7 +122,7 @@ TEST_F(SchedulerTest, TestFunctionIsCalledIfReactorShutdown) {
   ASSERT_TRUE(future.get().IsAborted());
 }
 
-TEST_F(SchedulerTest, Abort) {
+void SchedulerTest::TestAbort() {
   for (int i = 0; i != kCycles; ++i) {
     std::promise<Status> promise;
     auto future = promise.get_future();
@@ -108,6 +134,64 @@ TEST_F(SchedulerTest, Abort) {
   }
 }
 
+TEST_F(SchedulerTest, Abort) {
+  TestAbort();
+}
+
+TEST_F(SchedulerTimingWheelTest, Abort) {
+  TestAbort();
+}
+
+TEST_F(SchedulerTimingWheelTest, ShutdownAbortsTasks) {
+  constexpr int kTasks = 100;
+  std::atomic<int> aborted(0);
+  CountDownLatch latch(kTasks);
+  for (int i = 0; i != kTasks; ++i) {
+    // Mix of short and long delays, some of them beyond the range of the wheel top level.
+    scheduler_->Schedule([&aborted, &latch](const Status& status) {
+      aborted += status.IsServiceUnavailable() || status.IsAborted();
+      latch.CountDown();
+    }, i % 2 ? 60s : 24h);
+  }
+  scheduler_->Shutdown();
+  ASSERT_TRUE(latch.WaitFor(5s));
+  ASSERT_EQ(kTasks, aborted.load());
+}
+
+void SchedulerTest::BenchmarkScheduleAndAbort() {
+  constexpr int kTasks = 100000;
+  std::mt19937_64 rng(42);
+  std::vector<std::chrono::steady_clock::duration> delays;
+  delays.reserve(kTasks);
+  for (int i = 0; i != kTasks; ++i) {
+    delays.push_back(std::chrono::milliseconds(RandomUniformInt(1000, 60000, &rng)));
+  }
+  std::vector<ScheduledTaskId> task_ids(kTasks);
+  CountDownLatch latch(kTasks);
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i != kTasks; ++i) {
+    task_ids[i] = scheduler_->Schedule([&latch](const Status& status) {
+      latch.CountDown();
+    }, delays[i]);
+  }
+  for (auto task_id : task_ids) {
+    scheduler_->Abort(task_id);
+  }
+  latch.Wait();
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  LOG(INFO) << "Schedule and abort, timing wheel: " << FLAGS_rpc_use_timing_wheel << ", "
+            << std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / kTasks
+            << " ns per task";
+}
+
+TEST_F(SchedulerTest, ScheduleAndAbortBenchmark) {
+  BenchmarkScheduleAndAbort();
+}
+
+TEST_F(SchedulerTimingWheelTest, ScheduleAndAbortBenchmark) {
+  BenchmarkScheduleAndAbort();
+}
+
 TEST_F(SchedulerTest, Shutdown) {
   const size_t kThreads = 8;
   std::vector<std::thread> threads;
@@ -15,7 +15,9 @@
 
 #include "yb/rpc/scheduler.h"
 
+#include <limits>
 #include <thread>
+#include <unordered_map>
 
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/strand.hpp>
@@ -27,6 +29,8 @@
 
 #include <glog/logging.h>
 
+#include "yb/rpc/timing_wheel.h"
+
 #include "yb/util/errno.h"
 #include "yb/util/logging.h"
 #include "yb/util/status.h"
@@ -37,6 +41,8 @@ using boost::multi_index::const_mem_fun;
 using boost::multi_index::hashed_unique;
 using boost::multi_index::ordered_non_unique;
 
+DECLARE_bool(rpc_use_timing_wheel);
+
 namespace yb {
 namespace rpc {
 
@@ -49,16 +55,30 @@ constexpr int64_t kShutdownMark = -(1ULL << 32U);
 class Scheduler::Impl {
  public:
   explicit Impl(IoService* io_service)
-      : io_service_(*io_service), strand_(*io_service), timer_(*io_service) {}
+      : io_service_(*io_service), strand_(*io_service), timer_(*io_service),
+        use_timing_wheel_(FLAGS_rpc_use_timing_wheel),
+        wheel_origin_(std::chrono::steady_clock::now()) {}
 
   ~Impl() {
     Shutdown();
     DCHECK_EQ(timer_counter_, 0);
     DCHECK(tasks_.empty());
+    DCHECK(wheel_tasks_.empty());
   }
 
   void Abort(ScheduledTaskId task_id) {
     strand_.dispatch([this, task_id] {
+      if (use_timing_wheel_) {
+        auto it = wheel_tasks_.find(task_id);
+        if (it != wheel_tasks_.end()) {
+          wheel_.Cancel(&it->second);
+          io_service_.post([task = std::move(it->second.task)] {
+            task->Run(STATUS(Aborted, "Task aborted"));
+          });
+          wheel_tasks_.erase(it);
+        }
+        return;
+      }
       auto& index = tasks_.get<IdTag>();
       auto it = index.find(task_id);
       if (it != index.end()) {
@@ -84,6 +104,13 @@ class Scheduler::Impl {
           io_service_.post([task, status] { task->Run(status); });
         }
         tasks_.clear();
+        wheel_.Clear([](TimingWheelEntry*) {});
+        for (auto& id_and_task : wheel_tasks_) {
+          io_service_.post([task = std::move(id_and_task.second.task), status] {
+            task->Run(status);
+          });
+        }
+        wheel_tasks_.clear();
       });
     }
   }
@@ -97,6 +124,11 @@ class Scheduler::Impl {
         return;
       }
 
+      if (use_timing_wheel_) {
+        ScheduleOnWheel(std::move(task));
+        return;
+      }
+
       auto pair = tasks_.insert(task);
       CHECK(pair.second);
       if (pair.first == tasks_.begin()) {
@@ -137,6 +169,20 @@ class Scheduler::Impl {
       return;
     }
 
+    if (use_timing_wheel_) {
+      timer_tick_ = kNoTimerTick;
+      const auto now_tick = PassedTimingWheelTick(
+          wheel_origin_, std::chrono::steady_clock::now());
+      wheel_.Advance(now_tick, [this](TimingWheelEntry* entry) {
+        auto* wheel_task = static_cast<WheelTask*>(entry);
+        io_service_.post([task = std::move(wheel_task->task)] { task->Run(Status::OK()); });
+        // Destroys the entry, that is already removed from the wheel.
+        wheel_tasks_.erase(wheel_task->id);
+      });
+      StartWheelTimer();
+      return;
+    }
+
     auto now = std::chrono::steady_clock::now();
     while (!tasks_.empty() && (*tasks_.begin())->time() <= now) {
       io_service_.post([task = *tasks_.begin()] { task->Run(Status::OK()); });
@@ -148,6 +194,53 @@ class Scheduler::Impl {
     }
   }
 
+  // Entry of the timing wheel, stored in wheel_tasks_.
+  struct WheelTask : public TimingWheelEntry {
+    WheelTask(ScheduledTaskId id_, std::shared_ptr<ScheduledTaskBase> task_)
+        : id(id_), task(std::move(task_)) {}
+
+    const ScheduledTaskId id;
+    std::shared_ptr<ScheduledTaskBase> task;
+  };
+
+  static constexpr int64_t kNoTimerTick = std::numeric_limits<int64_t>::max();
+
+  void ScheduleOnWheel(std::shared_ptr<ScheduledTaskBase> task) {
+    DCHECK(strand_.running_in_this_thread());
+    const auto id = task->id();
+    const auto tick = ToTimingWheelTick(wheel_origin_, task->time());
+    if (wheel_.empty()) {
+      // Catch up with the current time, so the task does not have to be moved down soon.
+      wheel_.Advance(PassedTimingWheelTick(wheel_origin_, std::chrono::steady_clock::now()),
+                     [](TimingWheelEntry*) {});
+    }
+    auto pair = wheel_tasks_.emplace(
+        std::piecewise_construct, std::forward_as_tuple(id),
+        std::forward_as_tuple(id, std::move(task)));
+    CHECK(pair.second);
+    wheel_.Schedule(&pair.first->second, tick);
+    StartWheelTimer();
+  }
+
+  // Starts the timer for the next event of the wheel, unless it is already started for an
+  // earlier tick.
+  void StartWheelTimer() {
+    DCHECK(strand_.running_in_this_thread());
+    if (wheel_.empty()) {
+      return;
+    }
+    const auto tick = wheel_.NextEventTick();
+    if (tick >= timer_tick_) {
+      return;
+    }
+    timer_tick_ = tick;
+    boost::system::error_code ec;
+    timer_.expires_at(FromTimingWheelTick(wheel_origin_, tick), ec);
+    LOG_IF(ERROR, ec) << "Reschedule timer failed: " << ec.message();
+    ++timer_counter_;
+    timer_.async_wait(strand_.wrap(std::bind(&Impl::HandleTimer, this, _1)));
+  }
+
   class IdTag;
 
   typedef boost::multi_index_container<
@@ -171,6 +264,15 @@ class Scheduler::Impl {
   boost::asio::steady_timer timer_;
   int timer_counter_ = 0;
   std::atomic<bool> closing_ = {false};
+
+  // Tasks are kept in wheel_ instead of tasks_ when rpc_use_timing_wheel is set. Protected by
+  // strand_, as well as timer_tick_.
+  const bool use_timing_wheel_;
+  const SteadyTimePoint wheel_origin_;
+  TimingWheel wheel_;
+  std::unordered_map<ScheduledTaskId, WheelTask> wheel_tasks_;
+  // Tick the timer is started for.
+  int64_t timer_tick_ = kNoTimerTick;
 };
 
 Scheduler::Scheduler(IoService* io_service) : impl_(new Impl(io_service)) {}
@@ -27,6 +27,8 @@
 
 #include "yb/util/enums.h"
 #include "yb/util/errno.h"
+#include "yb/util/faststring.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/logging.h"
 #include "yb/util/scope_exit.h"
@@ -49,6 +51,19 @@ DEFINE_string(cipher_list, "",
 DEFINE_string(ciphersuites, "",
               "Define the available TLSv1.3 ciphersuites.");
 
+DEFINE_int32(ssl_coalesce_write_size, 0,
+             "Adjacent buffers of an outbound message that are smaller than this are combined "
+             "before encryption, so they are sent in a single TLS record instead of a record "
+             "per buffer. 0 disables coalescing.");
+TAG_FLAG(ssl_coalesce_write_size, advanced);
+TAG_FLAG(ssl_coalesce_write_size, runtime);
+
+DEFINE_int32(ssl_bio_pair_buffer_size, 0,
+             "Size of the buffer that holds encrypted data before it is passed to the socket. "
+             "A larger buffer lets big responses be encrypted and sent in fewer chunks. "
+             "0 uses the OpenSSL default.");
+TAG_FLAG(ssl_bio_pair_buffer_size, advanced);
+
 namespace yb {
 namespace rpc {
 
@@ -455,6 +470,7 @@ class SecureStream : public Stream, public StreamContext {
   bool MatchUid(X509* cert, GENERAL_NAMES* gens);
   bool MatchUidEntry(const Slice& value, const char* name);
   CHECKED_STATUS SendEncrypted(OutboundDataPtr data);
+  CHECKED_STATUS SslWrite(Slice slice);
   Result<bool> WriteEncrypted(OutboundDataPtr data);
   CHECKED_STATUS ReadDecrypted();
   CHECKED_STATUS HandshakeOrRead();
@@ -506,32 +522,52 @@ void SecureStream::Shutdown(const Status& status) {
 Status SecureStream::SendEncrypted(OutboundDataPtr data) {
   boost::container::small_vector<RefCntBuffer, 10> queue;
   data->Serialize(&queue);
+  const size_t coalesce_size = std::max(FLAGS_ssl_coalesce_write_size, 0);
+  faststring coalesced;
   for (const auto& buf : queue) {
-    Slice slice(buf.data(), buf.size());
-    for (;;) {
-      auto len = SSL_write(ssl_.get(), slice.data(), slice.size());
-      if (len == slice.size()) {
-        break;
-      }
-      auto error = len <= 0 ? SSL_get_error(ssl_.get(), len) : SSL_ERROR_NONE;
-      VLOG_WITH_PREFIX(4) << "SSL_write was not full: " << slice.size() << ", written: " << len
-                          << ", error: " << error;
-      if (error != SSL_ERROR_NONE) {
-        if (error != SSL_ERROR_WANT_WRITE || !VERIFY_RESULT(WriteEncrypted(nullptr))) {
-          return STATUS_FORMAT(
-              NetworkError, "SSL write failed: $0 ($1)", SSLErrorMessage(error), error);
-        }
-      } else {
-        RETURN_NOT_OK(WriteEncrypted(nullptr));
-      }
-      if (len > 0) {
-        slice.remove_prefix(len);
+    if (buf.size() < coalesce_size) {
+      if (coalesced.size() + buf.size() > coalesce_size) {
+        RETURN_NOT_OK(SslWrite(coalesced));
+        coalesced.clear();
       }
+      coalesced.append(buf.data(), buf.size());
+      continue;
+    }
+    if (!coalesced.empty()) {
+      RETURN_NOT_OK(SslWrite(coalesced));
+      coalesced.clear();
     }
+    RETURN_NOT_OK(SslWrite(buf.AsSlice()));
+  }
+  if (!coalesced.empty()) {
+    RETURN_NOT_OK(SslWrite(coalesced));
   }
   return ResultToStatus(WriteEncrypted(std::move(data)));
 }
 
+Status SecureStream::SslWrite(Slice slice) {
+  for (;;) {
+    auto len = SSL_write(ssl_.get(), slice.data(), slice.size());
+    if (len == slice.size()) {
+      return Status::OK();
+    }
+    auto error = len <= 0 ? SSL_get_error(ssl_.get(), len) : SSL_ERROR_NONE;
+    VLOG_WITH_PREFIX(4) << "SSL_write was not full: " << slice.size() << ", written: " << len
+                        << ", error: " << error;
+    if (error != SSL_ERROR_NONE) {
+      if (error != SSL_ERROR_WANT_WRITE || !VERIFY_RESULT(WriteEncrypted(nullptr))) {
+        return STATUS_FORMAT(
+            NetworkError, "SSL write failed: $0 ($1)", SSLErrorMessage(error), error);
+      }
+    } else {
+      RETURN_NOT_OK(WriteEncrypted(nullptr));
+    }
+    if (len > 0) {
+      slice.remove_prefix(len);
+    }
+  }
+}
+
 Result<size_t> SecureStream::Send(OutboundDataPtr data) {
   switch (state_) {
   case SecureState::kInitial:
@@ -826,7 +862,8 @@ Status SecureStream::Init() {
 
     BIO* int_bio = nullptr;
     BIO* temp_bio = nullptr;
-    BIO_new_bio_pair(&int_bio, 0, &temp_bio, 0);
+    const size_t bio_buffer_size = std::max(FLAGS_ssl_bio_pair_buffer_size, 0);
+    BIO_new_bio_pair(&int_bio, bio_buffer_size, &temp_bio, bio_buffer_size);
     SSL_set_bio(ssl_.get(), int_bio, int_bio);
     bio_.reset(temp_bio);
 
@@ -32,7 +32,10 @@
 
 #include "yb/rpc/service_pool.h"
 
+#include <algorithm>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
 #include <vector>
@@ -45,6 +48,7 @@
 #include <glog/logging.h>
 
 #include "yb/gutil/ref_counted.h"
+#include "yb/gutil/thread_annotations.h"
 
 #include "yb/rpc/inbound_call.h"
 #include "yb/rpc/messenger.h"
@@ -78,6 +82,12 @@ TAG_FLAG(backpressure_recovery_period_ms, runtime);
 DEFINE_test_flag(bool, enable_backpressure_mode_for_testing, false,
             "For testing purposes. Enables the rpc's to be considered timed out in the queue even "
             "when we have not had any backpressure in the recent past.");
+DEFINE_int32(rpc_background_call_dequeue_ratio, 0,
+             "When positive, each service queues calls with background priority separately from "
+             "normal calls, and while both kinds are waiting dequeues one background call per "
+             "this many normal calls. Expired calls are dropped when dequeued. "
+             "0 keeps a single queue per service.");
+TAG_FLAG(rpc_background_call_dequeue_ratio, advanced);
 
 METRIC_DEFINE_coarse_histogram(server, rpc_incoming_queue_time,
                         "RPC Queue Time",
@@ -122,6 +132,7 @@ class ServicePoolImpl final : public InboundCallHandler {
                   ServiceIfPtr service,
                   const scoped_refptr<MetricEntity>& entity)
       : max_queued_calls_(max_tasks),
+        background_call_dequeue_ratio_(std::max(FLAGS_rpc_background_call_dequeue_ratio, 0)),
         thread_pool_(*thread_pool),
         scheduler_(*scheduler),
         service_(std::move(service)),
@@ -191,6 +202,11 @@ class ServicePoolImpl final : public InboundCallHandler {
       ScheduleCheckTimeout(call_deadline);
     }
 
+    if (background_call_dequeue_ratio_) {
+      std::lock_guard<std::mutex> lock(priority_queues_mutex_);
+      (call->IsBackgroundPriority() ? background_calls_ : normal_calls_).push_back(call);
+    }
+
     thread_pool_.Enqueue(task);
   }
 
@@ -245,6 +261,22 @@ class ServicePoolImpl final : public InboundCallHandler {
   }
 
   void Handle(InboundCallPtr incoming) override {
+    if (!background_call_dequeue_ratio_) {
+      HandleCall(std::move(incoming));
+      return;
+    }
+    // Each queued call has its own task, but the task handles the call chosen by priority.
+    // Calls that were already processed, e.g. timed out by CheckTimeout, don't consume the task.
+    while ((incoming = DequeuePrioritized())) {
+      if (HandleCall(std::move(incoming))) {
+        return;
+      }
+    }
+  }
+
+ private:
+  // Returns false if the call was already processed by someone else.
+  bool HandleCall(InboundCallPtr incoming) {
     incoming->RecordHandlingStarted(incoming_queue_time_);
     ADOPT_TRACE(incoming->trace());
 
@@ -256,10 +288,11 @@ class ServicePoolImpl final : public InboundCallHandler {
     } else {
       TRACE_TO(incoming->trace(), "Handling call");
 
-      if (incoming->TryStartProcessing()) {
-        service_->Handle(std::move(incoming));
+      if (!incoming->TryStartProcessing()) {
+        return false;
       }
-      return;
+      service_->Handle(std::move(incoming));
+      return true;
     }
 
     TRACE_TO(incoming->trace(), error_message);
@@ -268,14 +301,45 @@ class ServicePoolImpl final : public InboundCallHandler {
 
     // Respond as a failure, even though the client will probably ignore
     // the response anyway.
-    TimedOut(incoming.get(), error_message, rpcs_timed_out_in_queue_.get());
+    return TimedOut(incoming.get(), error_message, rpcs_timed_out_in_queue_.get());
   }
 
- private:
-  void TimedOut(InboundCall* call, const char* error_message, Counter* metric) {
+  // Picks the next call to handle, responding to expired calls found on the way without
+  // spending a task on each of them.
+  InboundCallPtr DequeuePrioritized() {
+    std::vector<InboundCallPtr> expired;
+    InboundCallPtr result;
+    {
+      std::lock_guard<std::mutex> lock(priority_queues_mutex_);
+      while (!normal_calls_.empty() || !background_calls_.empty()) {
+        const bool background =
+            normal_calls_.empty() ||
+            (!background_calls_.empty() &&
+             normal_calls_since_background_ >= background_call_dequeue_ratio_);
+        auto& queue = background ? background_calls_ : normal_calls_;
+        auto call = std::move(queue.front());
+        queue.pop_front();
+        normal_calls_since_background_ = background ? 0 : normal_calls_since_background_ + 1;
+        if (PREDICT_FALSE(call->ClientTimedOut())) {
+          expired.push_back(std::move(call));
+          continue;
+        }
+        result = std::move(call);
+        break;
+      }
+    }
+    for (const auto& call : expired) {
+      TimedOut(call.get(), kTimedOutInQueue, rpcs_timed_out_early_in_queue_.get());
+    }
+    return result;
+  }
+
+  bool TimedOut(InboundCall* call, const char* error_message, Counter* metric) {
     if (call->RespondTimedOutIfPending(error_message)) {
       metric->Increment();
+      return true;
     }
+    return false;
   }
 
   bool ShouldDropRequestDuringHighLoad(const InboundCallPtr& incoming) {
@@ -398,6 +462,7 @@ class ServicePoolImpl final : public InboundCallHandler {
   }
 
   const size_t max_queued_calls_;
+  const int background_call_dequeue_ratio_;
   ThreadPool& thread_pool_;
   Scheduler& scheduler_;
   ServiceIfPtr service_;
@@ -410,6 +475,12 @@ class ServicePoolImpl final : public InboundCallHandler {
   std::atomic<CoarseDuration> last_backpressure_at_{CoarseTimePoint().time_since_epoch()};
   std::atomic<int64_t> queued_calls_{0};
 
+  // Used only when background_call_dequeue_ratio_ is positive.
+  std::mutex priority_queues_mutex_;
+  std::deque<InboundCallPtr> normal_calls_ GUARDED_BY(priority_queues_mutex_);
+  std::deque<InboundCallPtr> background_calls_ GUARDED_BY(priority_queues_mutex_);
+  int normal_calls_since_background_ GUARDED_BY(priority_queues_mutex_) = 0;
+
   // It is too expensive to update timeout priority queue when each call is received.
   // So we are doing the following trick.
   // All calls are added to pre_check_timeout_queue_, w/o priority.
@@ -28,12 +28,28 @@ DECLARE_uint64(rpc_connection_timeout_ms);
 DEFINE_test_flag(int32, delay_connect_ms, 0,
                  "Delay connect in tests for specified amount of milliseconds.");
 
+DEFINE_bool(rpc_skip_eagain_syscalls, false,
+            "Stop reading from a socket after a receive that did not fill the read buffer, and "
+            "stop writing after a short write, waiting for the next readiness event instead of "
+            "issuing a system call that would fail with EAGAIN.");
+TAG_FLAG(rpc_skip_eagain_syscalls, advanced);
+TAG_FLAG(rpc_skip_eagain_syscalls, runtime);
+
 namespace yb {
 namespace rpc {
 
 namespace {
 
-const size_t kMaxIov = 16;
+// Many small calls are often queued to the same connection, so send them with fewer writev calls.
+const size_t kMaxIov = 64;
+
+size_t IovFullSize(const iovec* iov, int len) {
+  size_t result = 0;
+  for (int i = 0; i != len; ++i) {
+    result += iov[i].iov_len;
+  }
+  return result;
+}
 
 }
 
@@ -191,6 +207,7 @@ Status TcpStream::DoWrite() {
   }
 
   // If we weren't waiting write to be ready, we could try to write data to socket.
+  const bool skip_eagain_syscalls = FLAGS_rpc_skip_eagain_syscalls;
   while (!sending_.empty()) {
     iovec iov[kMaxIov];
     auto fill_result = FillIov(iov);
@@ -237,6 +254,12 @@ Status TcpStream::DoWrite() {
         context_->Transferred(data, Status::OK());
       }
     }
+
+    // Short write means that the socket send buffer is full, so the next write would fail.
+    if (skip_eagain_syscalls &&
+        static_cast<size_t>(written) < IovFullSize(iov, fill_result.len)) {
+      break;
+    }
   }
 
   return Status::OK();
@@ -300,7 +323,8 @@ Status TcpStream::ReadHandler() {
   context_->UpdateLastRead();
 
   for (;;) {
-    auto received = Receive();
+    bool drained = false;
+    auto received = Receive(&drained);
     if (PREDICT_FALSE(!received.ok())) {
       if (Errno(received.status()) == ESHUTDOWN) {
         VLOG_WITH_PREFIX(1) << "Shut down by remote end.";
@@ -319,13 +343,13 @@ Status TcpStream::ReadHandler() {
     if (!continue_receiving.ok()) {
       return continue_receiving.status();
     }
-    if (!continue_receiving.get()) {
+    if (!continue_receiving.get() || drained) {
       return Status::OK();
     }
   }
 }
 
-Result<bool> TcpStream::Receive() {
+Result<bool> TcpStream::Receive(bool* drained) {
   auto iov = ReadBuffer().PrepareAppend();
   if (!iov.ok()) {
     VLOG_WITH_PREFIX(3) << "ReadBuffer().PrepareAppend() error: " << iov.status();
@@ -365,6 +389,10 @@ Result<bool> TcpStream::Receive() {
   }
   DVLOG_WITH_PREFIX(4) << "socket_.Recvv() bytes: " << *nread;
 
+  // Receive that did not fill the buffer took everything the socket had.
+  *drained = FLAGS_rpc_skip_eagain_syscalls && *nread > 0 &&
+             static_cast<size_t>(*nread) < IoVecsFullSize(*iov);
+
   ReadBuffer().DataAppended(*nread);
   return *nread != 0;
 }
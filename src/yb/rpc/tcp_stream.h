@@ -97,7 +97,8 @@ class TcpStream : public Stream {
   CHECKED_STATUS ReadHandler();
   CHECKED_STATUS WriteHandler(bool just_connected);
 
-  Result<bool> Receive();
+  // Sets drained to true if the socket has no more data to receive at this moment.
+  Result<bool> Receive(bool* drained);
   // Try to parse received data and process it.
   Result<bool> TryProcessReceived();
 
@@ -22,10 +22,22 @@
 #include <cds/container/basket_queue.h>
 #include <cds/gc/dhp.h>
 
+#include <gflags/gflags.h>
+
+#include "yb/gutil/atomicops.h"
+
 #include "yb/util/debug-util.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/thread.h"
 
+DEFINE_int32(rpc_thread_pool_worker_spin_iterations, 0,
+             "Number of attempts an idle RPC worker makes to pick up a new task before it goes "
+             "to sleep. Spinning avoids a sleep and a wakeup per task when there is a stream of "
+             "short calls, at the cost of CPU burnt by idle workers. 0 disables spinning.");
+TAG_FLAG(rpc_thread_pool_worker_spin_iterations, advanced);
+TAG_FLAG(rpc_thread_pool_worker_spin_iterations, runtime);
+
 namespace yb {
 namespace rpc {
 
@@ -114,6 +126,12 @@ class Worker {
     if (share_->task_queue.pop(*task)) {
       return true;
     }
+    for (auto i = FLAGS_rpc_thread_pool_worker_spin_iterations; i > 0 && !stop_requested_; --i) {
+      base::subtle::PauseCPU();
+      if (share_->task_queue.pop(*task)) {
+        return true;
+      }
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     waiting_task_ = true;
     auto se = ScopeExit([this] {
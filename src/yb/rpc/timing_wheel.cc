@@ -0,0 +1,120 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include "yb/rpc/timing_wheel.h"
+
+#include <limits>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(rpc_use_timing_wheel, false,
+            "Keep timers of the RPC scheduler and reactor delayed tasks in hierarchical timing "
+            "wheels with O(1) schedule and cancel, instead of ordered containers and per task "
+            "libev timers. Timers fire with the granularity of 1ms.");
+TAG_FLAG(rpc_use_timing_wheel, advanced);
+
+namespace yb {
+namespace rpc {
+
+namespace {
+
+// Returns the smallest k in [1, kSlots] such that bit (base + k) % kSlots of bits is set.
+// Returns 0 if no bits are set.
+int64_t NextOccupied(uint64_t bits, int64_t base) {
+  if (bits == 0) {
+    return 0;
+  }
+  const auto start = (base + 1) & (TimingWheel::kSlots - 1);
+  const auto rotated = start ? (bits >> start) | (bits << (TimingWheel::kSlots - start)) : bits;
+  return __builtin_ctzll(rotated) + 1;
+}
+
+} // namespace
+
+void TimingWheel::Schedule(TimingWheelEntry* entry, int64_t deadline_tick) {
+  DCHECK(!entry->scheduled());
+  entry->deadline_tick_ = std::max(deadline_tick, now_ + 1);
+  Insert(entry, entry->deadline_tick_);
+  ++size_;
+}
+
+void TimingWheel::Cancel(TimingWheelEntry* entry) {
+  DCHECK(entry->scheduled());
+  auto& slot = slots_[entry->level_][entry->slot_];
+  slot.erase(Slot::s_iterator_to(*entry));
+  if (slot.empty()) {
+    occupied_[entry->level_] &= ~(1ULL << entry->slot_);
+  }
+  --size_;
+}
+
+int64_t TimingWheel::NextEventTick() const {
+  auto result = std::numeric_limits<int64_t>::max();
+  for (size_t level = 0; level != kLevels; ++level) {
+    const auto shift = level * kSlotBits;
+    const auto base = now_ >> shift;
+    const auto k = NextOccupied(occupied_[level], base);
+    if (k) {
+      // Slots of level 0 expire at their tick, slots of other levels are cascaded when the level
+      // below wraps around to them.
+      result = std::min(result, (base + k) << shift);
+    }
+  }
+  return result;
+}
+
+void TimingWheel::Insert(TimingWheelEntry* entry, int64_t deadline_tick) {
+  DCHECK_GE(deadline_tick, now_);
+  size_t level = 0;
+  size_t shift = 0;
+  while (level + 1 != kLevels && (deadline_tick >> shift) - (now_ >> shift) >= kSlots) {
+    ++level;
+    shift += kSlotBits;
+  }
+  auto index = deadline_tick >> shift;
+  // The deadline is beyond the top level, park the entry in its last slot. It will be inserted
+  // again when the slot is cascaded.
+  index = std::min<int64_t>(index, (now_ >> shift) + kSlots - 1);
+  const auto slot = index & kSlotMask;
+  entry->level_ = level;
+  entry->slot_ = slot;
+  slots_[level][slot].push_back(*entry);
+  occupied_[level] |= 1ULL << slot;
+}
+
+void TimingWheel::Cascade(size_t level) {
+  Slot taken;
+  TakeSlot(level, (now_ >> (level * kSlotBits)) & kSlotMask, &taken);
+  while (!taken.empty()) {
+    auto& entry = taken.front();
+    taken.pop_front();
+    // Entries expiring right now go to the current slot of level 0, that is expired right after
+    // cascading.
+    Insert(&entry, entry.deadline_tick_);
+  }
+}
+
+void TimingWheel::TakeSlot(size_t level, size_t slot, Slot* out) {
+  if (!(occupied_[level] & (1ULL << slot))) {
+    return;
+  }
+  out->splice(out->end(), slots_[level][slot]);
+  occupied_[level] &= ~(1ULL << slot);
+}
+
+} // namespace rpc
+} // namespace yb
@@ -0,0 +1,188 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#ifndef YB_RPC_TIMING_WHEEL_H
+#define YB_RPC_TIMING_WHEEL_H
+
+#include <array>
+#include <chrono>
+
+#include <boost/intrusive/list.hpp>
+
+#include <glog/logging.h>
+
+namespace yb {
+namespace rpc {
+
+// Granularity of the timing wheels used for RPC timers.
+constexpr std::chrono::milliseconds kTimingWheelTick{1};
+
+// Converts the time to the number of ticks since origin, rounding up so that timers never fire
+// before their time.
+inline int64_t ToTimingWheelTick(
+    std::chrono::steady_clock::time_point origin, std::chrono::steady_clock::time_point time) {
+  constexpr std::chrono::steady_clock::duration kTick = kTimingWheelTick;
+  return (time - origin + kTick - std::chrono::steady_clock::duration(1)) / kTick;
+}
+
+// The last tick that has fully passed at the time, the tick to advance the wheel to.
+inline int64_t PassedTimingWheelTick(
+    std::chrono::steady_clock::time_point origin, std::chrono::steady_clock::time_point time) {
+  constexpr std::chrono::steady_clock::duration kTick = kTimingWheelTick;
+  return (time - origin) / kTick;
+}
+
+inline std::chrono::steady_clock::time_point FromTimingWheelTick(
+    std::chrono::steady_clock::time_point origin, int64_t tick) {
+  return origin + tick * kTimingWheelTick;
+}
+
+// Base class of the entries of TimingWheel, so scheduling does not allocate.
+class TimingWheelEntry : public boost::intrusive::list_base_hook<> {
+ public:
+  bool scheduled() const { return is_linked(); }
+
+  int64_t deadline_tick() const { return deadline_tick_; }
+
+ private:
+  friend class TimingWheel;
+
+  int64_t deadline_tick_ = 0;
+  uint8_t level_ = 0;
+  uint8_t slot_ = 0;
+};
+
+// Hierarchical timing wheel: kLevels levels of kSlots slots each, level N slots covering
+// kSlots^N ticks. Schedule and Cancel are O(1), entries are moved to lower levels as their
+// deadlines approach. Entries further than kSlots^kLevels ticks are parked in the top level and
+// rescheduled when it is reached.
+//
+// Time is measured in ticks, converting the clock to ticks is up to the user. Entries are not
+// owned by the wheel and should be cancelled before being destroyed. Not thread safe.
+class TimingWheel {
+ public:
+  static constexpr size_t kSlotBits = 6;
+  static constexpr size_t kSlots = 1ULL << kSlotBits;
+  static constexpr size_t kLevels = 4;
+
+  explicit TimingWheel(int64_t now_tick = 0) : now_(now_tick) {}
+
+  ~TimingWheel() {
+    DCHECK_EQ(size_, 0U);
+  }
+
+  TimingWheel(const TimingWheel&) = delete;
+  void operator=(const TimingWheel&) = delete;
+
+  // The last tick the wheel was advanced to.
+  int64_t now_tick() const { return now_; }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Schedules the entry to expire at the deadline tick, or at the next tick if the deadline has
+  // already passed.
+  void Schedule(TimingWheelEntry* entry, int64_t deadline_tick);
+
+  // Removes the scheduled entry from the wheel.
+  void Cancel(TimingWheelEntry* entry);
+
+  // The first tick when the wheel has something to do, either expire or move entries. Advancing
+  // the wheel before it is a no-op, that is when a timer should be fired. Returns
+  // std::numeric_limits<int64_t>::max() when the wheel is empty.
+  int64_t NextEventTick() const;
+
+  // Advances the wheel to the tick, invoking callback(TimingWheelEntry*) for each expired entry,
+  // after the entry is removed from the wheel. The callback could schedule and cancel entries.
+  template <class F>
+  void Advance(int64_t tick, const F& callback) {
+    while (now_ < tick) {
+      const auto next_event_tick = size_ ? NextEventTick() : tick + 1;
+      if (next_event_tick > tick) {
+        now_ = tick;
+        break;
+      }
+      now_ = next_event_tick;
+      for (size_t level = kLevels; --level > 0;) {
+        if ((now_ & LevelMask(level)) == 0) {
+          Cascade(level);
+        }
+      }
+      Slot expired;
+      TakeSlot(0, now_ & kSlotMask, &expired);
+      while (!expired.empty()) {
+        auto& entry = expired.front();
+        expired.pop_front();
+        if (entry.deadline_tick_ > now_) {
+          // Could happen only when the entry is scheduled from the callback.
+          Insert(&entry, entry.deadline_tick_);
+          continue;
+        }
+        --size_;
+        callback(&entry);
+      }
+    }
+  }
+
+  // Removes all entries from the wheel, invoking callback(TimingWheelEntry*) for each of them.
+  template <class F>
+  void Clear(const F& callback) {
+    for (size_t level = 0; level != kLevels; ++level) {
+      for (size_t slot = 0; slot != kSlots; ++slot) {
+        Slot taken;
+        TakeSlot(level, slot, &taken);
+        while (!taken.empty()) {
+          auto& entry = taken.front();
+          taken.pop_front();
+          --size_;
+          callback(&entry);
+        }
+      }
+    }
+  }
+
+ private:
+  using Slot = boost::intrusive::list<
+      TimingWheelEntry, boost::intrusive::constant_time_size<false>>;
+
+  static constexpr int64_t kSlotMask = kSlots - 1;
+
+  static constexpr int64_t LevelMask(size_t level) {
+    return (1LL << (level * kSlotBits)) - 1;
+  }
+
+  // Puts the entry to the slot matching the deadline tick, that should not be before now_.
+  // Does not update size_.
+  void Insert(TimingWheelEntry* entry, int64_t deadline_tick);
+
+  // Moves entries of the current slot of the level to lower levels.
+  void Cascade(size_t level);
+
+  // Moves entries of the slot to out.
+  void TakeSlot(size_t level, size_t slot, Slot* out);
+
+  std::array<std::array<Slot, kSlots>, kLevels> slots_;
+
+  // Bit N of occupied_[level] is set when slot N of the level is not empty.
+  std::array<uint64_t, kLevels> occupied_ = {};
+
+  int64_t now_;
+  size_t size_ = 0;
+};
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_TIMING_WHEEL_H
@@ -15,6 +15,8 @@
 
 #include "yb/rpc/yb_rpc.h"
 
+#include <lz4.h>
+
 #include <google/protobuf/io/coded_stream.h>
 
 #include "yb/gutil/endian.h"
@@ -22,6 +24,7 @@
 #include "yb/rpc/connection.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/reactor.h"
+#include "yb/rpc/rpc_metrics.h"
 #include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/rpc/serialization.h"
 
@@ -48,6 +51,12 @@ DEFINE_bool(enable_rpc_keepalive, true, "Whether to enable RPC keepalive mechani
 
 DEFINE_uint64(min_sidecar_buffer_size, 16_KB, "Minimal buffer to allocate for sidecar");
 
+DEFINE_uint64(rpc_sidecars_compression_min_size, 16_KB,
+              "Response sidecars are compressed with LZ4 when the caller accepts compressed "
+              "sidecars and their total size is at least this many bytes. 0 disables compression.");
+TAG_FLAG(rpc_sidecars_compression_min_size, advanced);
+TAG_FLAG(rpc_sidecars_compression_min_size, runtime);
+
 DEFINE_test_flag(int32, yb_inbound_big_calls_parse_delay_ms, false,
     "Test flag for simulating slow parsing of inbound calls larger than "
     "rpc_throttle_threshold_bytes");
@@ -325,6 +334,23 @@ size_t YBInboundCall::AddRpcSidecar(Slice car) {
   return num_sidecars_++;
 }
 
+size_t YBInboundCall::AddRpcSidecar(RefCntBuffer car) {
+  sidecar_offsets_.Add(total_sidecars_size_);
+  total_sidecars_size_ += car.size();
+  // The buffer is sent as a separate gather entry, so the unused tail of the last buffer should
+  // not be sent, and following sidecars could not be appended to it.
+  if (!sidecar_buffers_.empty()) {
+    sidecar_buffers_.back().Shrink(filled_bytes_in_last_sidecar_buffer_);
+  }
+  if (consumption_) {
+    consumption_.Add(car.size());
+  }
+  filled_bytes_in_last_sidecar_buffer_ = car.size();
+  sidecar_buffers_.push_back(std::move(car));
+
+  return num_sidecars_++;
+}
+
 void YBInboundCall::ResetRpcSidecars() {
   if (consumption_) {
     for (const auto& buffer : sidecar_buffers_) {
@@ -354,6 +380,59 @@ void YBInboundCall::AllocateSidecarBuffer(size_t size) {
   }
 }
 
+bool YBInboundCall::CompressSidecars() {
+  const auto min_size = FLAGS_rpc_sidecars_compression_min_size;
+  if (header_.accepted_sidecars_compression() != RPC_COMPRESSION_LZ4 || min_size == 0 ||
+      total_sidecars_size_ < min_size || total_sidecars_size_ > LZ4_MAX_INPUT_SIZE) {
+    return false;
+  }
+
+  auto start = MonoTime::Now();
+  size_t allocated_size = 0;
+  for (const auto& buffer : sidecar_buffers_) {
+    allocated_size += buffer.size();
+  }
+  sidecar_buffers_.back().Shrink(filled_bytes_in_last_sidecar_buffer_);
+  std::string joined;
+  Slice input;
+  if (sidecar_buffers_.size() == 1) {
+    input = sidecar_buffers_.front().AsSlice();
+  } else {
+    joined.reserve(total_sidecars_size_);
+    for (const auto& buffer : sidecar_buffers_) {
+      joined.append(buffer.data(), buffer.size());
+    }
+    input = joined;
+  }
+
+  RefCntBuffer compressed(LZ4_compressBound(input.size()));
+  int compressed_size = LZ4_compress_default(
+      input.cdata(), compressed.data(), input.size(), compressed.size());
+  const bool smaller = compressed_size > 0 && static_cast<size_t>(compressed_size) < input.size();
+  auto& metrics = rpc_metrics();
+  if (metrics.sidecars_compression_time_us) {
+    metrics.sidecars_compression_time_us->IncrementBy(
+        MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+  }
+  if (!smaller) {
+    return false;
+  }
+  if (metrics.sidecars_compression_input_bytes) {
+    metrics.sidecars_compression_input_bytes->IncrementBy(input.size());
+    metrics.sidecars_compression_output_bytes->IncrementBy(compressed_size);
+  }
+
+  compressed.Shrink(compressed_size);
+  if (consumption_) {
+    consumption_.Add(
+        static_cast<int64_t>(compressed.size()) - static_cast<int64_t>(allocated_size));
+  }
+  sidecar_buffers_.clear();
+  sidecar_buffers_.push_back(std::move(compressed));
+  filled_bytes_in_last_sidecar_buffer_ = compressed_size;
+  return true;
+}
+
 Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLite& response,
                                               bool is_success) {
   using serialization::SerializeMessage;
@@ -364,6 +443,13 @@ Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLit
   ResponseHeader resp_hdr;
   resp_hdr.set_call_id(header_.call_id());
   resp_hdr.set_is_error(!is_success);
+  // Size of sidecars as they are sent.
+  size_t sidecars_size = total_sidecars_size_;
+  if (is_success && CompressSidecars()) {
+    resp_hdr.set_sidecars_compression(RPC_COMPRESSION_LZ4);
+    resp_hdr.set_uncompressed_sidecars_size(total_sidecars_size_);
+    sidecars_size = filled_bytes_in_last_sidecar_buffer_;
+  }
   for (auto& offset : sidecar_offsets_) {
     offset += protobuf_msg_size;
   }
@@ -372,7 +458,7 @@ Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLit
   size_t message_size = 0;
   auto status = SerializeMessage(response,
                                  /* param_buf */ nullptr,
-                                 total_sidecars_size_,
+                                 sidecars_size,
                                  /* use_cached_size */ true,
                                  /* offset */ 0,
                                  &message_size);
@@ -381,7 +467,7 @@ Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLit
   }
   size_t header_size = 0;
   status = SerializeHeader(resp_hdr,
-                           message_size + total_sidecars_size_,
+                           message_size + sidecars_size,
                            &response_buf_,
                            message_size,
                            &header_size);
@@ -390,7 +476,7 @@ Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLit
   }
   return SerializeMessage(response,
                           &response_buf_,
-                          total_sidecars_size_,
+                          sidecars_size,
                           /* use_cached_size */ true,
                           header_size);
 }
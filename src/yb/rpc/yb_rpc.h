@@ -125,6 +125,9 @@ class YBInboundCall : public InboundCall {
   // See RpcContext::AddRpcSidecar()
   virtual size_t AddRpcSidecar(Slice car);
 
+  // See RpcContext::AddRpcSidecar(RefCntBuffer)
+  virtual size_t AddRpcSidecar(RefCntBuffer car);
+
   // See RpcContext::ResetRpcSidecars()
   void ResetRpcSidecars();
 
@@ -166,6 +169,10 @@ class YBInboundCall : public InboundCall {
 
   CoarseTimePoint GetClientDeadline() const override;
 
+  bool IsBackgroundPriority() const override {
+    return header_.priority_class() == RPC_PRIORITY_BACKGROUND;
+  }
+
   MonoTime ReceiveTime() const {
     return timing_.time_received;
   }
@@ -209,6 +216,10 @@ class YBInboundCall : public InboundCall {
 
   // Returns number of bytes copied.
   size_t CopyToLastSidecarBuffer(const Slice& slice);
+
+  // Replaces sidecar buffers with a single LZ4 compressed buffer, if the caller accepts it and
+  // compression makes sidecars smaller. Returns true if sidecars were compressed.
+  bool CompressSidecars();
   void AllocateSidecarBuffer(size_t size);
 
   // The header of the incoming call. Set by ParseFrom()
@@ -268,6 +268,11 @@ static void ParseRequestOptions(const Webserver::WebRequest& req,
   if (promethus_opts) {
     arg = FindWithDefault(req.parsed_args, "level", "debug");
     promethus_opts->level = MetricLevelFromName(arg);
+
+    const string* entity_types_param = FindOrNull(req.parsed_args, "entity_types");
+    if (entity_types_param != nullptr) {
+      SplitStringUsing(*entity_types_param, ",", &promethus_opts->entity_types);
+    }
   }
 
   if (json_mode) {
@@ -90,6 +90,24 @@ TEST(MockHybridClockTest, TestMockedSystemClock) {
             HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(time.time_point, 1).ToUint64());
 }
 
+TEST(BoundedClockTest, UncertaintyWindowFollowsClockError) {
+  MockClock mock_clock;
+  mock_clock.Set({ 1000000, 10 });
+  scoped_refptr<HybridClock> clock(
+      new HybridClock(std::make_shared<BoundedClock>(mock_clock.AsClock())));
+  ASSERT_OK(clock->Init());
+
+  auto range = clock->NowRange();
+  ASSERT_EQ(range.first.GetPhysicalValueMicros(), 1000000 - 10);
+  ASSERT_EQ(range.second.GetPhysicalValueMicros(), 1000000 + 10);
+
+  // The window grows with the reported error, independently of max_clock_skew_usec.
+  mock_clock.Set({ 2000000, 1000 });
+  range = clock->NowRange();
+  ASSERT_EQ(range.first.GetPhysicalValueMicros(), 2000000 - 1000);
+  ASSERT_EQ(range.second.GetPhysicalValueMicros(), 2000000 + 1000);
+}
+
 // Test that two subsequent time reads are monotonically increasing.
 TEST_F(HybridClockTest, TestNow_ValuesIncreaseMonotonically) {
   const HybridTime now1 = clock_->Now();
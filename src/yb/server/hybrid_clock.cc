@@ -66,10 +66,12 @@ METRIC_DEFINE_gauge_int64(server, hybrid_clock_skew,
                            "Server clock skew.");
 
 DEFINE_string(time_source, "",
-              "The clock source that HybridClock should use (for tests only). "
-              "Leave empty for WallClock, other values depend on added clock providers and "
-              "specific for appropriate tests, that adds them.");
-TAG_FLAG(time_source, hidden);
+              "The clock source that HybridClock should use. Leave empty for WallClock. "
+              "bounded_adjtime uses the error bound of the kernel clock, maintained by a "
+              "precision time daemon such as chrony, instead of max_clock_skew_usec as the read "
+              "uncertainty window. It must be used by all servers of the cluster. Other values "
+              "depend on added clock providers and are specific for tests that add them.");
+TAG_FLAG(time_source, advanced);
 
 DEFINE_bool(fail_on_out_of_range_clock_skew, true,
             "In case transactional tables are present, crash the process if clock skew greater "
@@ -90,12 +92,19 @@ std::unordered_map<std::string, PhysicalClockProvider> providers;
 
 std::atomic<bool> clock_skew_control_enabled{false};
 
+const std::string kBoundedAdjTimeSource = "bounded_adjtime";
+
 // options should be in format clock_name[,extra_data] and extra_data would be passed to
 // clock factory.
 PhysicalClockPtr GetClock(const std::string& options) {
   if (options.empty()) {
     return WallClock();
   }
+#if !defined(__APPLE__)
+  if (options == kBoundedAdjTimeSource) {
+    return BoundedAdjTimeClock();
+  }
+#endif
 
   auto pos = options.find(',');
   auto name = pos == std::string::npos ? options : options.substr(0, pos);
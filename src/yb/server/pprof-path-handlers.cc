@@ -50,7 +50,10 @@
 #endif
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <deque>
 #include <fstream>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -63,14 +66,29 @@
 #include "yb/gutil/sysinfo.h"
 #include "yb/server/webserver.h"
 #include "yb/util/env.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/monotime.h"
 #include "yb/util/spinlock_profiling.h"
 #include "yb/util/status.h"
+#include "yb/util/thread.h"
 
 DECLARE_bool(enable_process_lifetime_heap_profiling);
 DECLARE_string(heap_profile_path);
 
+DEFINE_int32(continuous_profiling_window_secs, 0,
+             "When positive, the server continuously collects CPU (with tcmalloc) and lock "
+             "contention profiles in windows of this many seconds, and keeps the most recent "
+             "ones in memory, see /pprof/continuous_profile and /pprof/continuous_contention. "
+             "While enabled, on-demand CPU and contention profiling of the /pprof handlers is "
+             "not available. Takes effect when the web server starts.");
+TAG_FLAG(continuous_profiling_window_secs, advanced);
+
+DEFINE_int32(continuous_profiling_num_windows, 10,
+             "Number of most recent continuous profiling windows kept in memory.");
+TAG_FLAG(continuous_profiling_num_windows, advanced);
+TAG_FLAG(continuous_profiling_num_windows, runtime);
+
 
 using std::endl;
 using std::ifstream;
@@ -158,7 +176,10 @@ static void PprofCpuProfileHandler(const Webserver::WebRequest& req,
             << " profiler file name=" << tmp_prof_file_name
             << " seconds=" << seconds;
 
-  ProfilerStart(tmp_prof_file_name.c_str());
+  if (!ProfilerStart(tmp_prof_file_name.c_str())) {
+    (*output) << "Unable to start cpu profile, the profiler may already be running";
+    return;
+  }
   SleepFor(MonoDelta::FromSeconds(seconds));
   ProfilerStop();
   ifstream prof_file(tmp_prof_file_name.c_str(), std::ios::in);
@@ -185,12 +206,9 @@ static void PprofGrowthHandler(const Webserver::WebRequest& req, Webserver::WebR
 #endif
 }
 
-// Lock contention profiling
-static void PprofContentionHandler(const Webserver::WebRequest& req,
-                                    Webserver::WebResponse* resp) {
-  std::stringstream *output = &resp->output;
-  string secs_str = FindWithDefault(req.parsed_args, "seconds", "");
-  int32_t seconds = ParseLeadingInt32Value(secs_str.c_str(), PPROF_DEFAULT_SAMPLE_SECS);
+// Collects a lock contention profile for the given number of seconds, in the format expected by
+// pprof.
+static void CollectContentionProfile(int32_t seconds, std::stringstream* output) {
   int64_t discarded_samples = 0;
 
   *output << "--- contention" << endl;
@@ -215,6 +233,110 @@ static void PprofContentionHandler(const Webserver::WebRequest& req,
 #endif // defined(__linux__)
 }
 
+// Lock contention profiling
+static void PprofContentionHandler(const Webserver::WebRequest& req,
+                                    Webserver::WebResponse* resp) {
+  std::stringstream *output = &resp->output;
+  if (FLAGS_continuous_profiling_window_secs > 0) {
+    *output << "Continuous profiling is running, see /pprof/continuous_contention";
+    return;
+  }
+  string secs_str = FindWithDefault(req.parsed_args, "seconds", "");
+  int32_t seconds = ParseLeadingInt32Value(secs_str.c_str(), PPROF_DEFAULT_SAMPLE_SECS);
+  CollectContentionProfile(seconds, output);
+}
+
+namespace {
+
+// Collects CPU and contention profiles in consecutive windows of
+// FLAGS_continuous_profiling_window_secs on a background thread, keeping the last
+// FLAGS_continuous_profiling_num_windows of them.
+class ContinuousProfiler {
+ public:
+  static ContinuousProfiler& Instance() {
+    static ContinuousProfiler instance;
+    return instance;
+  }
+
+  void StartOnce() {
+    std::call_once(start_once_, [this] {
+      WARN_NOT_OK(Thread::Create("pprof", "continuous_profiler", &ContinuousProfiler::Run, this,
+                                 &thread_),
+                  "Failed to start continuous profiler");
+    });
+  }
+
+  // Writes the window-th most recent CPU or contention profile, where 0 is the latest one,
+  // returning false if there is no such window.
+  bool GetProfile(bool cpu, size_t window, std::stringstream* output) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (window >= windows_.size()) {
+      return false;
+    }
+    const auto& profiles = windows_[windows_.size() - 1 - window];
+    *output << (cpu ? profiles.cpu : profiles.contention);
+    return true;
+  }
+
+ private:
+  struct Profiles {
+    std::string cpu;
+    std::string contention;
+  };
+
+  void Run() {
+    for (;;) {
+      auto seconds = FLAGS_continuous_profiling_window_secs;
+      Profiles profiles;
+#ifdef TCMALLOC_ENABLED
+      string file_name = strings::Substitute("/tmp/yb_continuous_cpu_profile.$0", getpid());
+      bool cpu_started = ProfilerStart(file_name.c_str());
+#endif
+      std::stringstream contention;
+      CollectContentionProfile(seconds, &contention);
+      profiles.contention = contention.str();
+#ifdef TCMALLOC_ENABLED
+      if (cpu_started) {
+        ProfilerStop();
+        faststring cpu_profile;
+        WARN_NOT_OK(ReadFileToString(Env::Default(), file_name, &cpu_profile),
+                    "Failed to read cpu profile");
+        profiles.cpu = cpu_profile.ToString();
+        WARN_NOT_OK(Env::Default()->DeleteFile(file_name), "Failed to delete cpu profile");
+      }
+#endif
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      windows_.push_back(std::move(profiles));
+      while (windows_.size() >
+                 static_cast<size_t>(std::max(FLAGS_continuous_profiling_num_windows, 1))) {
+        windows_.pop_front();
+      }
+    }
+  }
+
+  std::once_flag start_once_;
+  scoped_refptr<Thread> thread_;
+  std::mutex mutex_;
+  std::deque<Profiles> windows_;
+};
+
+void ContinuousProfileHandler(
+    bool cpu, const Webserver::WebRequest& req, Webserver::WebResponse* resp) {
+  std::stringstream *output = &resp->output;
+  if (FLAGS_continuous_profiling_window_secs <= 0) {
+    *output << "Continuous profiling is disabled";
+    return;
+  }
+  string window_str = FindWithDefault(req.parsed_args, "window", "");
+  int32_t window = ParseLeadingInt32Value(window_str.c_str(), 0);
+  if (window < 0 || !ContinuousProfiler::Instance().GetProfile(cpu, window, output)) {
+    *output << "No profile for window " << window;
+  }
+}
+
+} // namespace
+
 
 // pprof asks for the url /pprof/symbol to map from hex addresses to variable names.
 // When the server receives a GET request for /pprof/symbol, it should return a line
@@ -280,6 +402,20 @@ void AddPprofPathHandlers(Webserver* webserver) {
   webserver->RegisterPathHandler("/pprof/profile", "", PprofCpuProfileHandler, false, false);
   webserver->RegisterPathHandler("/pprof/symbol", "", PprofSymbolHandler, false, false);
   webserver->RegisterPathHandler("/pprof/contention", "", PprofContentionHandler, false, false);
+
+  // Profiles of recent windows collected by continuous profiling. The optional window argument
+  // selects how many windows back to go, 0 (the default) being the latest complete window.
+  if (FLAGS_continuous_profiling_window_secs > 0) {
+    ContinuousProfiler::Instance().StartOnce();
+  }
+  webserver->RegisterPathHandler(
+      "/pprof/continuous_profile", "",
+      std::bind(&ContinuousProfileHandler, true, std::placeholders::_1, std::placeholders::_2),
+      false, false);
+  webserver->RegisterPathHandler(
+      "/pprof/continuous_contention", "",
+      std::bind(&ContinuousProfileHandler, false, std::placeholders::_1, std::placeholders::_2),
+      false, false);
 }
 
 } // namespace yb
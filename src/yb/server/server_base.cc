@@ -73,6 +73,7 @@
 #include "yb/util/spinlock_profiling.h"
 #include "yb/util/thread.h"
 #include "yb/util/version_info.h"
+#include "yb/util/wait_state.h"
 #include "yb/util/encryption_util.h"
 #include "yb/gutil/sysinfo.h"
 
@@ -251,6 +252,7 @@ Status RpcServerBase::Init() {
   glog_metrics_.reset(new ScopedGLogMetrics(metric_entity_));
   tcmalloc::RegisterMetrics(metric_entity_);
   RegisterSpinLockContentionMetrics(metric_entity_);
+  RegisterWaitEventMetrics(metric_entity_);
 
   InitSpinLockContentionProfiling();
 
@@ -13,11 +13,14 @@
 
 #include "yb/tablet/apply_intents_task.h"
 
+#include <thread>
+
 #include "yb/docdb/docdb.h"
 
 #include "yb/tablet/running_transaction.h"
 
 #include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
 
 using namespace std::literals;
 
@@ -25,6 +28,20 @@ DEFINE_int64(apply_intents_task_injected_delay_ms, 0,
              "Inject such delay before applying intents for large transactions. "
              "Could be used to throttle the apply speed.");
 
+DEFINE_int64(apply_intents_max_records_per_sec, 0,
+             "Max number of records per second applied to the regular RocksDB of a tablet by a "
+             "large transaction, that is applied in several batches. 0 means no limit.");
+TAG_FLAG(apply_intents_max_records_per_sec, runtime);
+TAG_FLAG(apply_intents_max_records_per_sec, advanced);
+
+DEFINE_int32(apply_intents_max_write_delay_wait_ms, 1000,
+             "Max time a large transaction waits before applying its next batch of intents, while "
+             "the regular RocksDB of the tablet requires write delay. 0 means do not wait.");
+TAG_FLAG(apply_intents_max_write_delay_wait_ms, runtime);
+TAG_FLAG(apply_intents_max_write_delay_wait_ms, advanced);
+
+DECLARE_int32(txn_max_apply_batch_records);
+
 namespace yb {
 namespace tablet {
 
@@ -55,6 +72,7 @@ void ApplyIntentsTask::Run() {
       VLOG_WITH_PREFIX(1) << "Abort because of shutdown";
       break;
     }
+    const auto step_start = CoarseMonoClock::now();
     auto result = applier_.ApplyIntents(apply_data_);
     if (!result.ok()) {
       LOG_WITH_PREFIX(DFATAL)
@@ -68,6 +86,43 @@ void ApplyIntentsTask::Run() {
     if (!result->active()) {
       break;
     }
+
+    Throttle(step_start);
+  }
+}
+
+void ApplyIntentsTask::Throttle(CoarseTimePoint step_start) {
+  const auto max_records_per_sec = FLAGS_apply_intents_max_records_per_sec;
+  if (max_records_per_sec > 0) {
+    const auto step_duration = std::chrono::microseconds(
+        FLAGS_txn_max_apply_batch_records * 1000000LL / max_records_per_sec);
+    SleepUntil(step_start + step_duration);
+  }
+
+  // Foreground writes are rejected while the regular RocksDB requires write delay, so give
+  // flushes and compactions a chance to catch up before writing the next batch.
+  const auto wait_deadline =
+      CoarseMonoClock::now() + FLAGS_apply_intents_max_write_delay_wait_ms * 1ms;
+  while (!applier_.ShouldApplyIntentsBatch() && CoarseMonoClock::now() < wait_deadline) {
+    YB_LOG_EVERY_N_SECS(INFO, 10) << LogPrefix() << "Wait for write delay to apply next batch";
+    if (!SleepUntil(std::min(wait_deadline, CoarseMonoClock::now() + 10ms))) {
+      break;
+    }
+  }
+}
+
+bool ApplyIntentsTask::SleepUntil(CoarseTimePoint deadline) {
+  // Sleep in small steps, so shutdown is not delayed by the throttling.
+  constexpr auto kMaxSleep = 100ms;
+  for (;;) {
+    if (running_transaction_context_.Closing()) {
+      return false;
+    }
+    const auto now = CoarseMonoClock::now();
+    if (now >= deadline) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::min<CoarseDuration>(deadline - now, kMaxSleep));
   }
 }
 
@@ -40,6 +40,13 @@ class ApplyIntentsTask : public rpc::StrandTask {
  private:
   std::string LogPrefix() const;
 
+  // Delays the next batch of a large transaction according to the apply rate limit, and while the
+  // regular RocksDB requires write delay, so the apply does not starve foreground writes.
+  void Throttle(CoarseTimePoint step_start);
+
+  // Returns false if the wait was interrupted by shutdown.
+  bool SleepUntil(CoarseTimePoint deadline);
+
   TransactionIntentApplier& applier_;
   RunningTransactionContext& running_transaction_context_;
   const TransactionApplyData& apply_data_;
@@ -41,6 +41,7 @@
 #include "yb/tablet/tablet.pb.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/priority_thread_pool.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 #include "yb/util/thread.h"
@@ -224,6 +225,28 @@ TEST_F(MaintenanceManagerTest, TestRegisterUnregister) {
   CHECK_OK(ThreadJoiner(thread.get()).Join());
 }
 
+// Test that ops are run when the manager uses a priority thread pool.
+TEST_F(MaintenanceManagerTest, TestPriorityThreadPool) {
+  manager_->Shutdown();
+  PriorityThreadPool thread_pool(2);
+  MaintenanceManager::Options options;
+  options.num_threads = 2;
+  options.polling_interval_ms = 1;
+  options.history_size = kHistorySize;
+  options.parent_mem_tracker = test_tracker_;
+  options.priority_thread_pool = &thread_pool;
+  manager_.reset(new MaintenanceManager(options));
+  ASSERT_OK(manager_->Init());
+
+  TestMaintenanceOp op("op", MaintenanceOp::HIGH_IO_USAGE, OP_RUNNABLE, test_tracker_);
+  op.set_ram_anchored(1100);
+  manager_->RegisterOp(&op);
+  op.WaitForState(OP_FINISHED);
+  manager_->UnregisterOp(&op);
+  manager_->Shutdown();
+  thread_pool.Shutdown();
+}
+
 // Test that we'll run an operation that doesn't improve performance when memory
 // pressure gets high.
 TEST_F(MaintenanceManagerTest, TestMemoryPressure) {
@@ -48,6 +48,7 @@
 #include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/priority_thread_pool.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/thread.h"
 
@@ -70,6 +71,12 @@ DEFINE_int32(maintenance_manager_history_size, 8,
        "Number of completed operations the manager is keeping track of.");
 TAG_FLAG(maintenance_manager_history_size, hidden);
 
+DEFINE_int32(maintenance_manager_task_priority, -1,
+       "Priority of maintenance ops when they are run on a priority thread pool shared with "
+       "other background work. Flushes use priority 100 and compactions 0 and above, so the "
+       "default makes maintenance ops yield to both.");
+TAG_FLAG(maintenance_manager_task_priority, advanced);
+
 DEFINE_bool(enable_maintenance_manager, true,
        "Enable the maintenance manager, runs compaction and tablet cleaning tasks.");
 TAG_FLAG(enable_maintenance_manager, unsafe);
@@ -80,6 +87,35 @@ using yb::tablet::MaintenanceManagerStatusPB;
 using yb::tablet::MaintenanceManagerStatusPB_CompletedOpPB;
 using yb::tablet::MaintenanceManagerStatusPB_MaintenanceOpPB;
 
+// Runs a prepared maintenance op on the priority thread pool.
+class MaintenanceManagerTask : public PriorityThreadPoolTask {
+ public:
+  MaintenanceManagerTask(MaintenanceManager* manager, MaintenanceOp* op)
+      : manager_(manager), op_(op) {}
+
+  void Run(const Status& status, PriorityThreadPoolSuspender* suspender) override {
+    if (!status.ok()) {
+      LOG(INFO) << "Not running " << op_->name() << ": " << status;
+      std::lock_guard<Mutex> guard(manager_->lock_);
+      manager_->OpFinished(op_);
+      return;
+    }
+    manager_->LaunchOp(op_);
+  }
+
+  bool ShouldRemoveWithKey(void* key) override {
+    return key == manager_;
+  }
+
+  std::string ToString() const override {
+    return Format("{ maintenance_op: $0 }", op_->name());
+  }
+
+ private:
+  MaintenanceManager* const manager_;
+  MaintenanceOp* const op_;
+};
+
 MaintenanceOpStats::MaintenanceOpStats() {
   Clear();
 }
@@ -110,11 +146,13 @@ const MaintenanceManager::Options MaintenanceManager::DEFAULT_OPTIONS = {
   0,
   0,
   shared_ptr<MemTracker>(),
+  nullptr,
 };
 
 MaintenanceManager::MaintenanceManager(const Options& options)
   : num_threads_(options.num_threads <= 0 ?
       FLAGS_maintenance_manager_num_threads : options.num_threads),
+    priority_thread_pool_(options.priority_thread_pool),
     cond_(&lock_),
     shutdown_(false),
     running_ops_(0),
@@ -124,8 +162,10 @@ MaintenanceManager::MaintenanceManager(const Options& options)
     completed_ops_count_(0),
     parent_mem_tracker_(!options.parent_mem_tracker ?
         MemTracker::GetRootTracker() : options.parent_mem_tracker) {
-  CHECK_OK(ThreadPoolBuilder("MaintenanceMgr").set_min_threads(num_threads_)
-               .set_max_threads(num_threads_).Build(&thread_pool_));
+  if (!priority_thread_pool_) {
+    CHECK_OK(ThreadPoolBuilder("MaintenanceMgr").set_min_threads(num_threads_)
+                 .set_max_threads(num_threads_).Build(&thread_pool_));
+  }
   uint32_t history_size = options.history_size == 0 ?
                           FLAGS_maintenance_manager_history_size :
                           options.history_size;
@@ -155,7 +195,17 @@ void MaintenanceManager::Shutdown() {
   if (monitor_thread_.get()) {
     CHECK_OK(ThreadJoiner(monitor_thread_.get()).Join());
     monitor_thread_.reset();
-    thread_pool_->Shutdown();
+    if (priority_thread_pool_) {
+      // Abort ops that did not start yet and wait for the running ones, like thread pool
+      // shutdown does.
+      priority_thread_pool_->Remove(this);
+      std::unique_lock<Mutex> guard(lock_);
+      while (running_ops_ > 0) {
+        cond_.Wait();
+      }
+    } else {
+      thread_pool_->Shutdown();
+    }
   }
 }
 
@@ -235,6 +285,16 @@ void MaintenanceManager::RunSchedulerThread() {
     }
 
     // Run the maintenance operation.
+    if (priority_thread_pool_) {
+      auto task = std::make_unique<MaintenanceManagerTask>(this, op);
+      Status s = priority_thread_pool_->Submit(
+          FLAGS_maintenance_manager_task_priority, &task);
+      if (!s.ok()) {
+        LOG(WARNING) << "Failed to submit " << op->name() << ": " << s;
+        OpFinished(op);
+      }
+      continue;
+    }
     Status s = thread_pool_->SubmitFunc(std::bind(&MaintenanceManager::LaunchOp, this, op));
     CHECK(s.ok());
   }
@@ -388,9 +448,17 @@ void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
 
   op->DurationHistogram()->Increment(delta.ToMilliseconds());
 
+  OpFinished(op);
+}
+
+void MaintenanceManager::OpFinished(MaintenanceOp* op) {
   running_ops_--;
   op->running_--;
   op->cond_->Signal();
+  if (priority_thread_pool_) {
+    // Shutdown waits for running ops to finish.
+    cond_.Broadcast();
+  }
 }
 
 void MaintenanceManager::GetMaintenanceManagerStatusDump(MaintenanceManagerStatusPB* out_pb) {
@@ -56,6 +56,7 @@ class AtomicGauge;
 class Histogram;
 class MaintenanceManager;
 class MemTracker;
+class PriorityThreadPool;
 
 class MaintenanceOpStats {
  public:
@@ -239,6 +240,9 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
     int32_t polling_interval_ms;
     uint32_t history_size;
     std::shared_ptr<MemTracker> parent_mem_tracker;
+    // When set, ops are run as tasks of this pool, shared with other background work, instead
+    // of a dedicated thread pool.
+    PriorityThreadPool* priority_thread_pool = nullptr;
   };
 
   explicit MaintenanceManager(const Options& options);
@@ -260,6 +264,7 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
   static const Options DEFAULT_OPTIONS;
 
  private:
+  friend class MaintenanceManagerTask;
   FRIEND_TEST(MaintenanceManagerTest, TestLogRetentionPrioritization);
   typedef std::map<MaintenanceOp*, MaintenanceOpStats,
           MaintenanceOpComparator> OpMapTy;
@@ -271,11 +276,15 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
 
   void LaunchOp(MaintenanceOp* op);
 
+  // Updates the accounting of a finished or aborted op.
+  void OpFinished(MaintenanceOp* op);
+
   const int32_t num_threads_;
   OpMapTy ops_; // registered operations
   Mutex lock_;
   scoped_refptr<yb::Thread> monitor_thread_;
   std::unique_ptr<ThreadPool> thread_pool_;
+  PriorityThreadPool* const priority_thread_pool_;
   ConditionVariable cond_;
   bool shutdown_;
   uint64_t running_ops_;
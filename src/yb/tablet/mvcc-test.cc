@@ -30,6 +30,8 @@
 // under the License.
 //
 
+#include <atomic>
+#include <thread>
 #include <vector>
 #include <sstream>
 
@@ -46,6 +48,8 @@
 using namespace std::literals;
 using std::vector;
 
+DECLARE_bool(enable_lock_free_mvcc_reads);
+
 using yb::server::LogicalClock;
 
 namespace yb {
@@ -363,5 +367,52 @@ TEST_F(MvccTest, WaitForSafeTime) {
   ASSERT_FALSE(manager_.SafeTime(ht3, CoarseMonoClock::now() + 100ms, FixedHybridTimeLease()));
 }
 
+TEST_F(MvccTest, LockFreeSafeTime) {
+  FLAGS_enable_lock_free_mvcc_reads = true;
+
+  constexpr int kNumReaders = 4;
+  std::atomic<bool> stop(false);
+  std::atomic<HybridTime> in_flight(HybridTime::kMin);
+  std::atomic<HybridTime> replicated(HybridTime::kMin);
+
+  std::thread writer([this, &stop, &in_flight, &replicated] {
+    for (int64_t index = 1; !stop.load(); ++index) {
+      OpId op_id(1, index);
+      auto ht = manager_.AddLeaderPending(op_id);
+      in_flight.store(ht);
+      manager_.Replicated(ht, op_id);
+      replicated.store(ht);
+    }
+  });
+
+  std::vector<std::thread> readers;
+  std::atomic<size_t> num_reads(0);
+  for (int i = 0; i != kNumReaders; ++i) {
+    readers.emplace_back([this, &stop, &in_flight, &replicated, &num_reads] {
+      HybridTime prev_safe_time = HybridTime::kMin;
+      while (!stop.load()) {
+        auto safe_time = manager_.SafeTime(FixedHybridTimeLease());
+        // The operation that was not replicated when SafeTime returned, should be after safe time.
+        auto in_flight_ht = in_flight.load();
+        auto replicated_ht = replicated.load();
+        ASSERT_TRUE(replicated_ht >= in_flight_ht || in_flight_ht > safe_time)
+            << "Safe time: " << safe_time << ", in flight: " << in_flight_ht
+            << ", replicated: " << replicated_ht;
+        ASSERT_GE(safe_time, prev_safe_time);
+        prev_safe_time = safe_time;
+        ++num_reads;
+      }
+    });
+  }
+
+  std::this_thread::sleep_for(2s);
+  stop = true;
+  writer.join();
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  LOG(INFO) << "Reads: " << num_reads.load();
+}
+
 } // namespace tablet
 } // namespace yb
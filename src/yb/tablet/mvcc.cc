@@ -46,11 +46,18 @@
 #include "yb/util/flags.h"
 #include "yb/util/logging.h"
 #include "yb/util/scope_exit.h"
+#include "yb/util/wait_state.h"
 
 DEFINE_test_flag(int64, mvcc_op_trace_num_items, 32,
                  "Number of items to keep in an MvccManager operation trace. Set to 0 to disable "
                  "MVCC operation tracing.");
 
+DEFINE_bool(enable_lock_free_mvcc_reads, false,
+            "Compute MVCC safe time without acquiring the MVCC mutex, when it is not required to "
+            "wait for the safe time. Such requests are not recorded in the MVCC operation trace.");
+TAG_FLAG(enable_lock_free_mvcc_reads, advanced);
+TAG_FLAG(enable_lock_free_mvcc_reads, runtime);
+
 namespace yb {
 namespace tablet {
 
@@ -235,6 +242,32 @@ std::string SafeTimeWithSource::ToString() const {
   return Format("{ safe_time: $0 source: $1 }", safe_time, source);
 }
 
+// ------------------------------------------------------------------------------------------------
+// MvccManager::PublishStateScope
+// ------------------------------------------------------------------------------------------------
+
+class MvccManager::PublishStateScope {
+ public:
+  explicit PublishStateScope(MvccManager* mvcc) : mvcc_(mvcc) {
+    mvcc_->state_version_.fetch_add(1);
+  }
+
+  ~PublishStateScope() {
+    auto state = mvcc_->StateUnlocked();
+    mvcc_->published_queue_front_.store(state.queue_front);
+    mvcc_->published_last_replicated_.store(state.last_replicated);
+    mvcc_->published_propagated_safe_time_.store(state.propagated_safe_time);
+    mvcc_->published_leader_only_mode_.store(mvcc_->leader_only_mode_);
+    mvcc_->state_version_.fetch_add(1);
+  }
+
+  PublishStateScope(const PublishStateScope&) = delete;
+  void operator=(const PublishStateScope&) = delete;
+
+ private:
+  MvccManager* const mvcc_;
+};
+
 // ------------------------------------------------------------------------------------------------
 // MvccManager
 // ------------------------------------------------------------------------------------------------
@@ -257,6 +290,7 @@ void MvccManager::Replicated(HybridTime ht, const OpId& op_id) {
 
   {
     std::lock_guard<std::mutex> lock(mutex_);
+    PublishStateScope publish_scope(this);
     if (op_trace_) {
       op_trace_->Add(ReplicatedTraceItem { .ht = ht, .op_id = op_id });
     }
@@ -274,6 +308,7 @@ void MvccManager::Aborted(HybridTime ht, const OpId& op_id) {
 
   {
     std::lock_guard<std::mutex> lock(mutex_);
+    PublishStateScope publish_scope(this);
     if (op_trace_) {
       op_trace_->Add(AbortedTraceItem { .ht = ht, .op_id = op_id });
     }
@@ -298,6 +333,9 @@ bool BadNextOpId(const OpId& prev, const OpId& next) {
 
 HybridTime MvccManager::AddLeaderPending(const OpId& op_id) {
   std::lock_guard<std::mutex> lock(mutex_);
+  // Lock-free readers could use the current time as safe time, when the queue is empty. So the
+  // version should be changed before we pick the time of the new operation.
+  PublishStateScope publish_scope(this);
   auto ht = clock_->Now();
   VLOG_WITH_PREFIX(1) << __func__ << "(" << op_id << "), time: " << ht;
   AddPending(ht, op_id, /* is_follower_side= */ false);
@@ -314,6 +352,7 @@ HybridTime MvccManager::AddLeaderPending(const OpId& op_id) {
 
 void MvccManager::AddFollowerPending(HybridTime ht, const OpId& op_id) {
   std::lock_guard<std::mutex> lock(mutex_);
+  PublishStateScope publish_scope(this);
   VLOG_WITH_PREFIX(1) << __func__ << "(" << ht << ", " << op_id << ")";
 
   AddPending(ht, op_id, /* is_follower_side= */ true);
@@ -331,11 +370,16 @@ void MvccManager::AddPending(HybridTime ht, const OpId& op_id, bool is_follower_
 
   HybridTime last_ht_in_queue = queue_.empty() ? HybridTime::kMin : queue_.back().hybrid_time;
 
+  const HybridTime max_safe_time_returned_with_lease = max_safe_time_returned_with_lease_.load();
+  const HybridTime max_safe_time_returned_without_lease =
+      max_safe_time_returned_without_lease_.load();
+  const HybridTime max_safe_time_returned_for_follower =
+      max_safe_time_returned_for_follower_.load();
   HybridTime sanity_check_lower_bound =
       std::max({
-          max_safe_time_returned_with_lease_.safe_time,
-          max_safe_time_returned_without_lease_.safe_time,
-          max_safe_time_returned_for_follower_.safe_time,
+          max_safe_time_returned_with_lease,
+          max_safe_time_returned_without_lease,
+          max_safe_time_returned_for_follower,
           propagated_safe_time_,
           last_replicated_,
           last_ht_in_queue});
@@ -351,13 +395,12 @@ void MvccManager::AddPending(HybridTime ht, const OpId& op_id, bool is_follower_
           << "\n  " << EXPR_VALUE_FOR_LOG(ht.PhysicalDiff(safe_time)) \
           << "\n  "
 
-#define LOG_INFO_FOR_HT_LOWER_BOUND_WITH_SOURCE(t) LOG_INFO_FOR_HT_LOWER_BOUND_IMPL(t, t.safe_time)
 #define LOG_INFO_FOR_HT_LOWER_BOUND(t) LOG_INFO_FOR_HT_LOWER_BOUND_IMPL(t, t)
 
       ss << "New operation's hybrid time too low: " << ht << ", op id: " << op_id
-         << LOG_INFO_FOR_HT_LOWER_BOUND_WITH_SOURCE(max_safe_time_returned_with_lease_)
-         << LOG_INFO_FOR_HT_LOWER_BOUND_WITH_SOURCE(max_safe_time_returned_without_lease_)
-         << LOG_INFO_FOR_HT_LOWER_BOUND_WITH_SOURCE(max_safe_time_returned_for_follower_)
+         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_with_lease)
+         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_without_lease)
+         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_for_follower)
          << LOG_INFO_FOR_HT_LOWER_BOUND(last_replicated_)
          << LOG_INFO_FOR_HT_LOWER_BOUND(last_ht_in_queue)
          << LOG_INFO_FOR_HT_LOWER_BOUND(propagated_safe_time_)
@@ -403,6 +446,7 @@ void MvccManager::SetLastReplicated(HybridTime ht) {
 
   {
     std::lock_guard<std::mutex> lock(mutex_);
+    PublishStateScope publish_scope(this);
     if (op_trace_) {
       op_trace_->Add(SetLastReplicatedTraceItem { .ht = ht });
     }
@@ -416,6 +460,7 @@ void MvccManager::SetPropagatedSafeTimeOnFollower(HybridTime ht) {
 
   {
     std::lock_guard<std::mutex> lock(mutex_);
+    PublishStateScope publish_scope(this);
     if (op_trace_) {
       op_trace_->Add(SetPropagatedSafeTimeOnFollowerTraceItem { .ht = ht });
     }
@@ -442,6 +487,7 @@ void MvccManager::UpdatePropagatedSafeTimeOnLeader(const FixedHybridTimeLease& h
                                    CoarseTimePoint::max(), // deadline
                                    ht_lease,
                                    &lock);
+    PublishStateScope publish_scope(this);
 #ifndef NDEBUG
     // This should only be called from RaftConsensus::UpdateMajorityReplicated, and ht_lease passed
     // in here should keep increasing, so we should not see propagated_safe_time_ going backwards.
@@ -472,6 +518,7 @@ void MvccManager::UpdatePropagatedSafeTimeOnLeader(const FixedHybridTimeLease& h
 
 void MvccManager::SetLeaderOnlyMode(bool leader_only) {
   std::lock_guard<std::mutex> lock(mutex_);
+  PublishStateScope publish_scope(this);
   if (op_trace_) {
     op_trace_->Add(SetLeaderOnlyModeTraceItem {
       .leader_only = leader_only
@@ -483,6 +530,13 @@ void MvccManager::SetLeaderOnlyMode(bool leader_only) {
 // NO_THREAD_SAFETY_ANALYSIS because this analysis does not work with unique_lock.
 HybridTime MvccManager::SafeTimeForFollower(
     HybridTime min_allowed, CoarseTimePoint deadline) const NO_THREAD_SAFETY_ANALYSIS {
+  if (GetAtomicFlag(&FLAGS_enable_lock_free_mvcc_reads)) {
+    auto safe_time = TrySafeTimeForFollowerWithoutLock(min_allowed);
+    if (safe_time.is_valid()) {
+      return safe_time;
+    }
+  }
+
   std::unique_lock<std::mutex> lock(mutex_);
 
   if (leader_only_mode_) {
@@ -493,35 +547,27 @@ HybridTime MvccManager::SafeTimeForFollower(
 
   SafeTimeWithSource result;
   auto predicate = [this, &result, min_allowed] {
-    // last_replicated_ is updated earlier than propagated_safe_time_, so because of concurrency it
-    // could be greater than propagated_safe_time_.
-    if (propagated_safe_time_ > last_replicated_) {
-      if (queue_.empty() || propagated_safe_time_ < queue_.front().hybrid_time) {
-        result.safe_time = propagated_safe_time_;
-        result.source = SafeTimeSource::kPropagated;
-      } else {
-        result.safe_time = queue_.front().hybrid_time.Decremented();
-        result.source = SafeTimeSource::kNextInQueue;
-      }
-    } else {
-      result.safe_time = last_replicated_;
-      result.source = SafeTimeSource::kLastReplicated;
-    }
+    result = ComputeSafeTimeForFollower(StateUnlocked());
     return result.safe_time >= min_allowed;
   };
-  if (deadline == CoarseTimePoint::max()) {
-    cond_.wait(lock, predicate);
-  } else if (!cond_.wait_until(lock, deadline, predicate)) {
-    return HybridTime::kInvalid;
+  if (!predicate()) {
+    ScopedWaitEvent wait_event(WaitEvent::kMvccSafeTime);
+    if (deadline == CoarseTimePoint::max()) {
+      cond_.wait(lock, predicate);
+    } else if (!cond_.wait_until(lock, deadline, predicate)) {
+      return HybridTime::kInvalid;
+    }
   }
   VLOG_WITH_PREFIX(1) << "SafeTimeForFollower(" << min_allowed
                       << "), result = " << result.ToString();
-  CHECK_GE(result.safe_time, max_safe_time_returned_for_follower_.safe_time)
+  // Lock-free readers could only observe the same state while we are holding the mutex, so they
+  // could not return greater safe time.
+  const auto max_safe_time_returned_for_follower = max_safe_time_returned_for_follower_.load();
+  CHECK_GE(result.safe_time, max_safe_time_returned_for_follower)
       << InvariantViolationLogPrefix()
       << "result: " << result.ToString()
-      << ", max_safe_time_returned_for_follower_: "
-      << max_safe_time_returned_for_follower_.ToString();
-  max_safe_time_returned_for_follower_ = result;
+      << ", max_safe_time_returned_for_follower_: " << max_safe_time_returned_for_follower;
+  UpdateAtomicMax(&max_safe_time_returned_for_follower_, result.safe_time);
   if (op_trace_) {
     op_trace_->Add(SafeTimeForFollowerTraceItem {
       .min_allowed = min_allowed,
@@ -537,6 +583,13 @@ HybridTime MvccManager::SafeTime(
     HybridTime min_allowed,
     CoarseTimePoint deadline,
     const FixedHybridTimeLease& ht_lease) const NO_THREAD_SAFETY_ANALYSIS {
+  if (GetAtomicFlag(&FLAGS_enable_lock_free_mvcc_reads)) {
+    auto safe_time = TrySafeTimeWithoutLock(min_allowed, ht_lease);
+    if (safe_time.is_valid()) {
+      return safe_time;
+    }
+  }
+
   std::unique_lock<std::mutex> lock(mutex_);
   auto safe_time = DoGetSafeTime(min_allowed, deadline, ht_lease, &lock);
   if (op_trace_) {
@@ -550,6 +603,112 @@ HybridTime MvccManager::SafeTime(
   return safe_time;
 }
 
+MvccManager::SafeTimeState MvccManager::StateUnlocked() const {
+  return SafeTimeState {
+    .queue_front = queue_.empty() ? HybridTime::kInvalid : queue_.front().hybrid_time,
+    .last_replicated = last_replicated_,
+    .propagated_safe_time = propagated_safe_time_,
+  };
+}
+
+SafeTimeWithSource MvccManager::ComputeSafeTime(
+    const SafeTimeState& state, const FixedHybridTimeLease& ht_lease,
+    HybridTime max_safe_time_returned_with_lease) const {
+  SafeTimeWithSource result;
+  if (!state.queue_front.is_valid()) {
+    result.safe_time = ht_lease.time.is_valid()
+        ? std::max(max_safe_time_returned_with_lease, ht_lease.time)
+        : clock_->Now();
+    result.source = SafeTimeSource::kNow;
+    VLOG_WITH_PREFIX(2) << "DoGetSafeTime, Now: " << result.safe_time;
+  } else {
+    result.safe_time = state.queue_front.Decremented();
+    result.source = SafeTimeSource::kNextInQueue;
+    VLOG_WITH_PREFIX(2) << "DoGetSafeTime, Queue front (decremented): " << result.safe_time;
+  }
+
+  if (!ht_lease.empty()) {
+    auto used_lease = std::max({ht_lease.lease, max_safe_time_returned_with_lease});
+    if (result.safe_time > used_lease) {
+      result.safe_time = used_lease;
+      result.source = SafeTimeSource::kHybridTimeLease;
+    }
+  }
+
+  // This function could be invoked at a follower, so it has a very old ht_lease. In this case it
+  // is safe to read at least at last_replicated.
+  result.safe_time = std::max(result.safe_time, state.last_replicated);
+  return result;
+}
+
+SafeTimeWithSource MvccManager::ComputeSafeTimeForFollower(const SafeTimeState& state) {
+  SafeTimeWithSource result;
+  // last_replicated_ is updated earlier than propagated_safe_time_, so because of concurrency it
+  // could be greater than propagated_safe_time_.
+  if (state.propagated_safe_time > state.last_replicated) {
+    if (!state.queue_front.is_valid() || state.propagated_safe_time < state.queue_front) {
+      result.safe_time = state.propagated_safe_time;
+      result.source = SafeTimeSource::kPropagated;
+    } else {
+      result.safe_time = state.queue_front.Decremented();
+      result.source = SafeTimeSource::kNextInQueue;
+    }
+  } else {
+    result.safe_time = state.last_replicated;
+    result.source = SafeTimeSource::kLastReplicated;
+  }
+  return result;
+}
+
+HybridTime MvccManager::TrySafeTimeWithoutLock(
+    HybridTime min_allowed, const FixedHybridTimeLease& ht_lease) const {
+  const auto version = state_version_.load();
+  if (version & 1) {
+    return HybridTime::kInvalid;
+  }
+  SafeTimeState state = {
+    .queue_front = published_queue_front_.load(),
+    .last_replicated = published_last_replicated_.load(),
+    .propagated_safe_time = published_propagated_safe_time_.load(),
+  };
+  auto result = ComputeSafeTime(state, ht_lease, max_safe_time_returned_with_lease_.load());
+  // The version is changed before a new operation picks its hybrid time. So if the version is the
+  // same, any operation that was not in the queue will get hybrid time greater than the current
+  // time we could use as result.
+  if (state_version_.load() != version || result.safe_time < min_allowed) {
+    return HybridTime::kInvalid;
+  }
+  VLOG_WITH_PREFIX_AND_FUNC(1)
+      << "(" << min_allowed << ", " << ht_lease << "),  result = " << result.ToString();
+  UpdateAtomicMax(ht_lease.empty() ? &max_safe_time_returned_without_lease_
+                                   : &max_safe_time_returned_with_lease_,
+                  result.safe_time);
+  return result.safe_time;
+}
+
+HybridTime MvccManager::TrySafeTimeForFollowerWithoutLock(HybridTime min_allowed) const {
+  if (published_leader_only_mode_.load()) {
+    return TrySafeTimeWithoutLock(min_allowed, FixedHybridTimeLease());
+  }
+  const auto version = state_version_.load();
+  if (version & 1) {
+    return HybridTime::kInvalid;
+  }
+  SafeTimeState state = {
+    .queue_front = published_queue_front_.load(),
+    .last_replicated = published_last_replicated_.load(),
+    .propagated_safe_time = published_propagated_safe_time_.load(),
+  };
+  auto result = ComputeSafeTimeForFollower(state);
+  if (state_version_.load() != version || result.safe_time < min_allowed) {
+    return HybridTime::kInvalid;
+  }
+  VLOG_WITH_PREFIX(1) << "SafeTimeForFollower(" << min_allowed
+                      << "), result = " << result.ToString();
+  UpdateAtomicMax(&max_safe_time_returned_for_follower_, result.safe_time);
+  return result.safe_time;
+}
+
 HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
                                       const CoarseTimePoint deadline,
                                       const FixedHybridTimeLease& ht_lease,
@@ -566,52 +725,35 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
     LOG_IF_WITH_PREFIX(DFATAL, !ht_lease.time.is_valid()) << "Bad ht lease: " << ht_lease;
   }
 
-  HybridTime result;
-  SafeTimeSource source = SafeTimeSource::kUnknown;
-  auto predicate = [this, &result, &source, min_allowed, ht_lease, has_lease] {
-    if (queue_.empty()) {
-      result = ht_lease.time.is_valid()
-          ? std::max(max_safe_time_returned_with_lease_.safe_time, ht_lease.time)
-          : clock_->Now();
-      source = SafeTimeSource::kNow;
-      VLOG_WITH_PREFIX(2) << "DoGetSafeTime, Now: " << result;
-    } else {
-      result = queue_.front().hybrid_time.Decremented();
-      source = SafeTimeSource::kNextInQueue;
-      VLOG_WITH_PREFIX(2) << "DoGetSafeTime, Queue front (decremented): " << result;
-    }
-
-    if (has_lease) {
-      auto used_lease = std::max({ht_lease.lease, max_safe_time_returned_with_lease_.safe_time});
-      if (result > used_lease) {
-        result = used_lease;
-        source = SafeTimeSource::kHybridTimeLease;
-      }
-    }
-
-    // This function could be invoked at a follower, so it has a very old ht_lease. In this case it
-    // is safe to read at least at last_replicated_.
-    result = std::max(result, last_replicated_);
-
-    return result >= min_allowed;
+  SafeTimeWithSource result;
+  HybridTime enforced_min_time;
+  auto predicate = [this, &result, &enforced_min_time, min_allowed, &ht_lease, has_lease] {
+    // Lock-free readers could increase returned safe time concurrently, so remember the value used
+    // to compute the result.
+    auto max_safe_time_returned_with_lease = max_safe_time_returned_with_lease_.load();
+    enforced_min_time = has_lease ? max_safe_time_returned_with_lease
+                                  : max_safe_time_returned_without_lease_.load();
+    result = ComputeSafeTime(StateUnlocked(), ht_lease, max_safe_time_returned_with_lease);
+    return result.safe_time >= min_allowed;
   };
 
   // In the case of an empty queue, the safe hybrid time to read at is only limited by hybrid time
   // ht_lease, which is by definition higher than min_allowed, so we would not get blocked.
-  if (deadline == CoarseTimePoint::max()) {
-    cond_.wait(*lock, predicate);
-  } else if (!cond_.wait_until(*lock, deadline, predicate)) {
-    return HybridTime::kInvalid;
+  if (!predicate()) {
+    ScopedWaitEvent wait_event(WaitEvent::kMvccSafeTime);
+    if (deadline == CoarseTimePoint::max()) {
+      cond_.wait(*lock, predicate);
+    } else if (!cond_.wait_until(*lock, deadline, predicate)) {
+      return HybridTime::kInvalid;
+    }
   }
   VLOG_WITH_PREFIX_AND_FUNC(1)
-      << "(" << min_allowed << ", " << ht_lease << "),  result = " << result;
+      << "(" << min_allowed << ", " << ht_lease << "),  result = " << result.ToString();
 
-  auto enforced_min_time = has_lease ? max_safe_time_returned_with_lease_.safe_time
-                                     : max_safe_time_returned_without_lease_.safe_time;
-  CHECK_GE(result, enforced_min_time)
+  CHECK_GE(result.safe_time, enforced_min_time)
       << InvariantViolationLogPrefix()
       << ": " << EXPR_VALUE_FOR_LOG(has_lease)
-      << ", " << EXPR_VALUE_FOR_LOG(enforced_min_time.ToUint64() - result.ToUint64())
+      << ", " << EXPR_VALUE_FOR_LOG(enforced_min_time.ToUint64() - result.safe_time.ToUint64())
       << ", " << EXPR_VALUE_FOR_LOG(ht_lease)
       << ", " << EXPR_VALUE_FOR_LOG(last_replicated_)
       << ", " << EXPR_VALUE_FOR_LOG(clock_->Now())
@@ -619,15 +761,16 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
       << ", " << EXPR_VALUE_FOR_LOG(queue_.size())
       << ", " << EXPR_VALUE_FOR_LOG(queue_);
 
-  if (has_lease) {
-    max_safe_time_returned_with_lease_ = { result, source };
-  } else {
-    max_safe_time_returned_without_lease_ = { result, source };
-  }
-  return result;
+  UpdateAtomicMax(has_lease ? &max_safe_time_returned_with_lease_
+                            : &max_safe_time_returned_without_lease_,
+                  result.safe_time);
+  return result.safe_time;
 }
 
 HybridTime MvccManager::LastReplicatedHybridTime() const {
+  if (GetAtomicFlag(&FLAGS_enable_lock_free_mvcc_reads)) {
+    return published_last_replicated_.load();
+  }
   std::lock_guard<std::mutex> lock(mutex_);
   VLOG_WITH_PREFIX(1) << __func__ << "(), result = " << last_replicated_;
   if (op_trace_) {
@@ -32,6 +32,7 @@
 #ifndef YB_TABLET_MVCC_H_
 #define YB_TABLET_MVCC_H_
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <deque>
@@ -86,6 +87,11 @@ inline std::ostream& operator<<(std::ostream& out, const FixedHybridTimeLease& h
 // methods.
 // Operations could be replicated only in the same order as they were added.
 // Time of newly added operation should be after time of all previously added operations.
+//
+// Writers modify the state under the mutex. They also publish the parts of it, that are required to
+// compute safe time, to atomics guarded by a sequence counter. So when enable_lock_free_mvcc_reads
+// is set, readers first try to compute safe time from the published state without the mutex, and
+// only fall back to it when they have to wait.
 class MvccManager {
  public:
   // `prefix` is used for logging.
@@ -163,6 +169,32 @@ class MvccManager {
                            const FixedHybridTimeLease& ht_lease,
                            std::unique_lock<std::mutex>* lock) const REQUIRES(mutex_);
 
+  // State used to compute safe time.
+  struct SafeTimeState {
+    // Hybrid time of the first operation in queue, invalid if queue is empty.
+    HybridTime queue_front;
+    HybridTime last_replicated;
+    HybridTime propagated_safe_time;
+  };
+
+  SafeTimeState StateUnlocked() const;
+
+  SafeTimeWithSource ComputeSafeTime(
+      const SafeTimeState& state, const FixedHybridTimeLease& ht_lease,
+      HybridTime max_safe_time_returned_with_lease) const;
+
+  static SafeTimeWithSource ComputeSafeTimeForFollower(const SafeTimeState& state);
+
+  // Lock-free versions of SafeTime and SafeTimeForFollower. Return invalid hybrid time if the state
+  // was modified concurrently, or safe time is less than min_allowed.
+  HybridTime TrySafeTimeWithoutLock(
+      HybridTime min_allowed, const FixedHybridTimeLease& ht_lease) const;
+  HybridTime TrySafeTimeForFollowerWithoutLock(HybridTime min_allowed) const;
+
+  // Should be created by writers before they modify the state used by safe time computation, and
+  // destroyed after that, under the mutex.
+  class PublishStateScope;
+
   const std::string& LogPrefix() const { return prefix_; }
 
   struct InvariantViolationLoggingHelper;
@@ -215,9 +247,20 @@ class MvccManager {
   // Special flag for RF==1 mode when propagated_safe_time_ can be not up-to-date.
   bool leader_only_mode_ = false;
 
-  mutable SafeTimeWithSource max_safe_time_returned_with_lease_;
-  mutable SafeTimeWithSource max_safe_time_returned_without_lease_;
-  mutable SafeTimeWithSource max_safe_time_returned_for_follower_ { HybridTime::kMin };
+  // Maximal safe times returned so far. Atomic, because they are also updated by lock-free
+  // readers.
+  mutable std::atomic<HybridTime> max_safe_time_returned_with_lease_{HybridTime::kMin};
+  mutable std::atomic<HybridTime> max_safe_time_returned_without_lease_{HybridTime::kMin};
+  mutable std::atomic<HybridTime> max_safe_time_returned_for_follower_{HybridTime::kMin};
+
+  // Odd while a writer modifies the state, incremented twice by each modification.
+  std::atomic<uint64_t> state_version_{0};
+
+  // Copies of the state published for lock-free readers.
+  std::atomic<HybridTime> published_queue_front_{HybridTime::kInvalid};
+  std::atomic<HybridTime> published_last_replicated_{HybridTime::kMin};
+  std::atomic<HybridTime> published_propagated_safe_time_{HybridTime::kMin};
+  std::atomic<bool> published_leader_only_mode_{false};
 
   std::unique_ptr<MvccOpTrace> op_trace_ GUARDED_BY(mutex_);
 };
@@ -0,0 +1,61 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/tablet/operations/import_data_operation.h"
+
+#include <glog/logging.h>
+
+#include "yb/consensus/consensus.pb.h"
+#include "yb/tablet/tablet.h"
+#include "yb/tserver/tserver.pb.h"
+#include "yb/util/trace.h"
+
+namespace yb {
+namespace tablet {
+
+template <>
+void RequestTraits<tserver::ImportDataRequestPB>::SetAllocatedRequest(
+    consensus::ReplicateMsg* replicate, tserver::ImportDataRequestPB* request) {
+  replicate->set_allocated_import_data_request(request);
+}
+
+template <>
+tserver::ImportDataRequestPB* RequestTraits<tserver::ImportDataRequestPB>::MutableRequest(
+    consensus::ReplicateMsg* replicate) {
+  return replicate->mutable_import_data_request();
+}
+
+Status ImportDataOperation::DoAborted(const Status& status) {
+  return status;
+}
+
+Status ImportDataOperation::DoReplicated(int64_t leader_term, Status* complete_status) {
+  TRACE("APPLY IMPORT DATA: started");
+
+  // Files could be missing or unsuitable on this replica only, in this case import is reported
+  // as failed to the client, instead of failing the apply of the operation.
+  auto status = tablet()->ImportData(this);
+  if (!status.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Import from " << request()->source_dir() << " failed: "
+                             << status;
+    *complete_status = status;
+  }
+
+  TRACE("APPLY IMPORT DATA: finished");
+
+  return Status::OK();
+}
+
+}  // namespace tablet
+}  // namespace yb
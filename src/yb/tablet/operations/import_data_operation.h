@@ -0,0 +1,43 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_TABLET_OPERATIONS_IMPORT_DATA_OPERATION_H
+#define YB_TABLET_OPERATIONS_IMPORT_DATA_OPERATION_H
+
+#include "yb/tablet/operations/operation.h"
+
+namespace yb {
+namespace tablet {
+
+// Operation that imports prepared RocksDB files into the regular RocksDB of the tablet.
+// Only metadata is replicated, each replica imports the files from the source directory on its
+// own node.
+class ImportDataOperation
+    : public OperationBase<OperationType::kImportData, tserver::ImportDataRequestPB> {
+ public:
+  template <class... Args>
+  explicit ImportDataOperation(Args&&... args)
+      : OperationBase(std::forward<Args>(args)...) {}
+
+  CHECKED_STATUS Prepare() override { return Status::OK(); }
+
+ private:
+  CHECKED_STATUS DoReplicated(int64_t leader_term, Status* complete_status) override;
+  CHECKED_STATUS DoAborted(const Status& status) override;
+};
+
+}  // namespace tablet
+}  // namespace yb
+
+#endif  // YB_TABLET_OPERATIONS_IMPORT_DATA_OPERATION_H
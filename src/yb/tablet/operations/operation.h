@@ -67,7 +67,8 @@ YB_DEFINE_ENUM(
     ((kTruncate, consensus::TRUNCATE_OP))
     ((kEmpty, consensus::UNKNOWN_OP))
     ((kHistoryCutoff, consensus::HISTORY_CUTOFF_OP))
-    ((kSplit, consensus::SPLIT_OP)));
+    ((kSplit, consensus::SPLIT_OP))
+    ((kImportData, consensus::IMPORT_DATA_OP)));
 
 // Base class for transactions.  There are different implementations for different types (Write,
 // AlterSchema, etc.) OperationDriver implementations use Operations along with Consensus to execute
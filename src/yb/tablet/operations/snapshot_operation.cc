@@ -163,6 +163,7 @@ bool SnapshotOperation::ShouldAllowOpDuringRestore(consensus::OperationType op_t
     case consensus::SPLIT_OP:
       return true;
     case consensus::UPDATE_TRANSACTION_OP: FALLTHROUGH_INTENDED;
+    case consensus::IMPORT_DATA_OP: FALLTHROUGH_INTENDED;
     case consensus::WRITE_OP:
       return !FLAGS_consistent_restore;
   }
@@ -79,7 +79,8 @@ bool SplitOperation::ShouldAllowOpAfterSplitTablet(const consensus::OperationTyp
     case consensus::UPDATE_TRANSACTION_OP: FALLTHROUGH_INTENDED;
     case consensus::SNAPSHOT_OP: FALLTHROUGH_INTENDED;
     case consensus::TRUNCATE_OP: FALLTHROUGH_INTENDED;
-    case consensus::SPLIT_OP:
+    case consensus::SPLIT_OP: FALLTHROUGH_INTENDED;
+    case consensus::IMPORT_DATA_OP:
       return false;
   }
   FATAL_INVALID_ENUM_VALUE(consensus::OperationType, op_type);
@@ -92,6 +92,7 @@ class TabletHarness {
     string root_dir;
     TableType table_type;
     bool enable_metrics;
+    TabletOptions tablet_options;
   };
 
   TabletHarness(const Schema& schema, Options options)
@@ -153,7 +154,7 @@ class TabletHarness {
       .block_based_table_mem_tracker = std::shared_ptr<MemTracker>(),
       .metric_registry = metrics_registry_.get(),
       .log_anchor_registry = new log::LogAnchorRegistry(),
-      .tablet_options = TabletOptions(),
+      .tablet_options = options_.tablet_options,
       .log_prefix_suffix = std::string(),
       .transaction_participant_context = nullptr,
       .local_tablet_filter = client::LocalTabletFilter(),
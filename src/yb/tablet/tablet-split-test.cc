@@ -13,6 +13,8 @@
 //
 //
 
+#include <set>
+
 #include <boost/algorithm/string/join.hpp>
 
 #include "yb/common/ql_protocol_util.h"
@@ -20,6 +22,9 @@
 
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb_debug.h"
+#include "yb/docdb/value_log.h"
+
+#include "yb/gutil/strings/util.h"
 
 #include "yb/tablet/tablet-test-util.h"
 #include "yb/tablet/tablet.h"
@@ -30,6 +35,9 @@
 DECLARE_int64(db_write_buffer_size);
 DECLARE_bool(rocksdb_disable_compactions);
 DECLARE_int32(rocksdb_level0_file_num_compaction_trigger);
+DECLARE_int32(docdb_value_log_min_value_size);
+DECLARE_int32(docdb_value_log_file_size_mb);
+DECLARE_int32(timestamp_history_retention_interval_sec);
 
 namespace yb {
 namespace tablet {
@@ -77,6 +85,35 @@ class TabletSplitTest : public YBTabletTest {
     return YBPartition::HashColumnCompoundValue(tmp);
   }
 
+  void WriteRows(int num_rows, const std::string& value_format) {
+    LocalTabletWriter::Batch batch;
+    for (auto i = 1; i <= num_rows; ++i) {
+      InsertRow(i, Format(value_format, i), &batch);
+    }
+    ASSERT_OK(writer_->WriteBatch(&batch));
+    ASSERT_OK(tablet()->Flush(FlushMode::kSync));
+  }
+
+  void CheckRows(Tablet* tablet, int num_rows, const std::string& value_format) {
+    auto rows = ASSERT_RESULT(SelectAll(tablet));
+    ASSERT_EQ(rows.size(), static_cast<size_t>(num_rows));
+    for (const auto& row : rows) {
+      ASSERT_EQ(row.column(1).string_value(), Format(value_format, row.column(0).int32_value()));
+    }
+  }
+
+  std::set<std::string> ValueLogFiles(const std::string& dir) {
+    std::set<std::string> result;
+    std::vector<std::string> children;
+    CHECK_OK(env_->GetChildren(dir, &children));
+    for (const auto& child : children) {
+      if (HasSuffixString(child, ".vlog")) {
+        result.insert(child);
+      }
+    }
+    return result;
+  }
+
   std::unique_ptr<LocalTabletWriter> writer_;
 };
 
@@ -215,6 +252,55 @@ TEST_F(TabletSplitTest, SplitTablet) {
   ASSERT_TRUE(source_docdb_dump.empty()) << boost::algorithm::join(source_docdb_dump, "\n");
 }
 
+// Values moved to the value log by compaction should be read through the tablet, survive value
+// log garbage collection while referenced, and be available to tablets created from checkpoints.
+TEST_F(TabletSplitTest, ValueLog) {
+  FLAGS_docdb_value_log_min_value_size = 100;
+  FLAGS_docdb_value_log_file_size_mb = 1;
+  FLAGS_timestamp_history_retention_interval_sec = 0;
+
+  constexpr auto kNumRows = 3000;
+  constexpr auto kValuePrefixLength = 1024;
+
+  const auto db_dir = tablet()->metadata()->rocksdb_dir();
+  const auto old_value_format = RandomHumanReadableString(kValuePrefixLength) + "_$0";
+  ASSERT_NO_FATALS(WriteRows(kNumRows, old_value_format));
+  tablet()->ForceRocksDBCompactInTest();
+
+  const auto old_files = ValueLogFiles(db_dir);
+  ASSERT_GT(old_files.size(), 1);
+  ASSERT_TRUE(tablet()->value_log()->MayHaveReferences());
+  ASSERT_NO_FATALS(CheckRows(tablet().get(), kNumRows, old_value_format));
+
+  // Overwritten values are moved to new files, so old files are no longer referenced.
+  const auto new_value_format = RandomHumanReadableString(kValuePrefixLength) + "_$0";
+  ASSERT_NO_FATALS(WriteRows(kNumRows, new_value_format));
+  tablet()->ForceRocksDBCompactInTest();
+  ASSERT_OK(tablet()->value_log()->DeleteObsoleteFiles(tablet()->TEST_db()));
+
+  const auto new_files = ValueLogFiles(db_dir);
+  ASSERT_FALSE(new_files.empty());
+  for (const auto& file : old_files) {
+    ASSERT_EQ(new_files.count(file), 0) << file;
+  }
+  ASSERT_NO_FATALS(CheckRows(tablet().get(), kNumRows, new_value_format));
+
+  // Referenced value log files are linked to the checkpoint of the subtablet.
+  const auto subtablet_id = tablet()->tablet_id() + "-sub";
+  ASSERT_OK(tablet()->CreateSubtablet(
+      subtablet_id, *tablet()->metadata()->partition(), docdb::KeyBounds(),
+      yb::OpId() /* split_op_id */, HybridTime() /* split_hybrid_time */));
+  auto subtablet = ASSERT_RESULT(harness_->OpenTablet(subtablet_id));
+  ASSERT_EQ(ValueLogFiles(subtablet->metadata()->rocksdb_dir()), new_files);
+  ASSERT_NO_FATALS(CheckRows(subtablet.get(), kNumRows, new_value_format));
+
+  // Values of the subtablet are still readable after its compaction and value log garbage
+  // collection.
+  subtablet->ForceRocksDBCompactInTest();
+  ASSERT_OK(subtablet->value_log()->DeleteObsoleteFiles(subtablet->TEST_db()));
+  ASSERT_NO_FATALS(CheckRows(subtablet.get(), kNumRows, new_value_format));
+}
+
 // TODO: Need to test with distributed transactions both pending and committed
 // (but not yet applied) during split.
 // Split tablets should not return unexpected data for not yet applied, but committed transactions
@@ -42,9 +42,15 @@
 
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/join.h"
+#include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/metadata.h"
 #include "yb/tablet/local_tablet_writer.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet-test-base.h"
+#include "yb/tablet/tablet_metadata.h"
+#include "yb/util/path_util.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/slice.h"
 #include "yb/util/test_macros.h"
 
@@ -56,6 +62,9 @@
 using std::shared_ptr;
 using std::unordered_set;
 
+DECLARE_int64(db_block_size_bytes);
+DECLARE_int32(block_cache_warm_up_max_blocks_per_tablet);
+
 namespace yb {
 namespace tablet {
 
@@ -215,5 +224,40 @@ TYPED_TEST(TestTablet, TestFlushedOpId) {
   ASSERT_EQ(id.index, start_index + 2*kCount);
 }
 
+// Test that data blocks saved by the tablet are loaded into a new block cache after reopen.
+TYPED_TEST(TestTablet, BlockCacheWarmUp) {
+  FLAGS_db_block_size_bytes = 1_KB;
+  this->tablet_options_.block_cache = rocksdb::NewLRUCache(8_MB);
+  this->TabletReOpen();
+
+  auto num_cached_blocks = [this]() -> Result<size_t> {
+    const auto files = VERIFY_RESULT(this->tablet()->TEST_db()->GetCachedDataBlocks(
+        FLAGS_block_cache_warm_up_max_blocks_per_tablet));
+    size_t result = 0;
+    for (const auto& file : files) {
+      result += file.blocks.size();
+    }
+    return result;
+  };
+
+  const auto num_rows = this->ClampRowCount(FLAGS_testiterator_num_inserts);
+  this->InsertTestRows(0, num_rows, 0);
+  ASSERT_OK(this->tablet()->Flush(FlushMode::kSync));
+  // Reading all rows loads their data blocks into the block cache.
+  this->VerifyTestRows(0, num_rows);
+  const auto num_saved_blocks = ASSERT_RESULT(num_cached_blocks());
+  ASSERT_GT(num_saved_blocks, 1);
+  ASSERT_OK(this->tablet()->SaveCachedDataBlocks());
+  ASSERT_TRUE(this->env_->FileExists(JoinPathSegments(
+      this->tablet()->metadata()->rocksdb_dir(), "CACHED_DATA_BLOCKS")));
+
+  this->tablet_options_.block_cache = rocksdb::NewLRUCache(8_MB);
+  this->TabletReOpen();
+  ASSERT_LT(ASSERT_RESULT(num_cached_blocks()), num_saved_blocks);
+  ASSERT_OK(this->tablet()->WarmUpBlockCache());
+  ASSERT_EQ(num_saved_blocks, ASSERT_RESULT(num_cached_blocks()));
+  this->VerifyTestRows(0, num_rows);
+}
+
 } // namespace tablet
 } // namespace yb
@@ -52,6 +52,7 @@
 #include "yb/rocksdb/metadata.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/statistics.h"
+#include "yb/rocksdb/table_properties.h"
 #include "yb/rocksdb/utilities/checkpoint.h"
 #include "yb/rocksdb/write_batch.h"
 #include "yb/rocksdb/util/file_util.h"
@@ -95,10 +96,13 @@
 #include "yb/docdb/pgsql_operation.h"
 #include "yb/docdb/primitive_value.h"
 #include "yb/docdb/redis_operation.h"
+#include "yb/docdb/row_cache.h"
+#include "yb/docdb/value_log.h"
 
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stl_util.h"
+#include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksutil/yb_rocksdb.h"
@@ -106,6 +110,7 @@
 #include "yb/server/hybrid_clock.h"
 
 #include "yb/tablet/tablet_fwd.h"
+#include "yb/tablet/tablet.pb.h"
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tablet/snapshot_coordinator.h"
 #include "yb/tablet/tablet_snapshots.h"
@@ -114,6 +119,7 @@
 #include "yb/tablet/transaction_coordinator.h"
 #include "yb/tablet/transaction_participant.h"
 #include "yb/tablet/operations/change_metadata_operation.h"
+#include "yb/tablet/operations/import_data_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/operations/snapshot_operation.h"
@@ -127,12 +133,16 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/jsonwriter.h"
 #include "yb/util/locks.h"
+#include "yb/util/math_util.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/operation_counter.h"
+#include "yb/util/path_util.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/pg_util.h"
 #include "yb/util/scope_exit.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/slice.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
@@ -159,6 +169,11 @@ DEFINE_double(tablet_bloom_target_fp_rate, 0.01f,
               "required for bloom filters.");
 TAG_FLAG(tablet_bloom_target_fp_rate, advanced);
 
+DEFINE_int32(tablet_row_cache_size_mb, 0,
+             "Size of the per tablet cache of rows resolved by point reads of non transactional "
+             "YCQL tables. 0 to disable the cache.");
+TAG_FLAG(tablet_row_cache_size_mb, advanced);
+
 METRIC_DEFINE_entity(table);
 METRIC_DEFINE_entity(tablet);
 
@@ -199,12 +214,27 @@ DEFINE_int32(backfill_index_timeout_grace_margin_ms, -1,
 TAG_FLAG(backfill_index_timeout_grace_margin_ms, advanced);
 TAG_FLAG(backfill_index_timeout_grace_margin_ms, runtime);
 
+DEFINE_int32(backfill_index_target_flush_latency_ms, 0,
+             "When positive, a backfilling tablet that sees a batch of index writes take longer "
+             "than this backs off before its next batch, for as long as the slow batch took (up "
+             "to 10 times this value), to leave the index tablets room for foreground traffic. "
+             "Applied in addition to backfill_index_rate_rows_per_sec.");
+TAG_FLAG(backfill_index_target_flush_latency_ms, advanced);
+TAG_FLAG(backfill_index_target_flush_latency_ms, runtime);
+
 DEFINE_bool(yql_allow_compatible_schema_versions, true,
             "Allow YCQL requests to be accepted even if they originate from a client who is ahead "
             "of the server's schema, but is determined to be compatible with the current version.");
 TAG_FLAG(yql_allow_compatible_schema_versions, advanced);
 TAG_FLAG(yql_allow_compatible_schema_versions, runtime);
 
+DEFINE_bool(ycql_async_user_enforced_index_updates, false,
+            "Do not wait for the index updates of writes to YCQL tables whose indexes have user "
+            "enforced consistency. They are applied in background, and failures are only counted "
+            "in the async_index_update_failures metric, so the index may miss updates.");
+TAG_FLAG(ycql_async_user_enforced_index_updates, advanced);
+TAG_FLAG(ycql_async_user_enforced_index_updates, runtime);
+
 DEFINE_bool(disable_alter_vs_write_mutual_exclusion, false,
              "A safety switch to disable the changes from D8710 which makes a schema "
              "operation take an exclusive lock making all write operations wait for it.");
@@ -214,11 +244,77 @@ TAG_FLAG(disable_alter_vs_write_mutual_exclusion, runtime);
 DEFINE_bool(cleanup_intents_sst_files, true,
             "Cleanup intents files that are no more relevant to any running transaction.");
 
+DEFINE_bool(tombstone_removed_colocated_table_data, false,
+            "When a colocated table is removed from its tablet, write a table tombstone for it, "
+            "so compactions drop its rows instead of keeping them forever.");
+TAG_FLAG(tombstone_removed_colocated_table_data, advanced);
+TAG_FLAG(tombstone_removed_colocated_table_data, runtime);
+
+DEFINE_double(intents_compaction_tombstone_ratio, 0,
+              "Compact intents DB when the number of intents removed since the last such "
+              "compaction exceeds this fraction of the number of entries in intents SST files. "
+              "0 disables the compaction.");
+TAG_FLAG(intents_compaction_tombstone_ratio, advanced);
+TAG_FLAG(intents_compaction_tombstone_ratio, runtime);
+
+DEFINE_int64(intents_compaction_min_tombstones, 100000,
+             "Intents DB is not compacted because of removed intents until at least this number "
+             "of intents was removed.");
+TAG_FLAG(intents_compaction_min_tombstones, advanced);
+TAG_FLAG(intents_compaction_min_tombstones, runtime);
+
+DEFINE_int32(intents_compaction_min_interval_secs, 600,
+             "Min interval between intents DB compactions triggered by removed intents.");
+TAG_FLAG(intents_compaction_min_interval_secs, advanced);
+TAG_FLAG(intents_compaction_min_interval_secs, runtime);
+
+DEFINE_bool(post_split_compact_only_files_outside_key_bounds, false,
+            "Whether the post-split compaction of a tablet only rewrites SST files that have keys "
+            "outside of the tablet key bounds, instead of compacting all files. Files fully "
+            "within the bounds stay hard linked with the parent tablet files.");
+TAG_FLAG(post_split_compact_only_files_outside_key_bounds, advanced);
+TAG_FLAG(post_split_compact_only_files_outside_key_bounds, runtime);
+
 DEFINE_int32(ysql_transaction_abort_timeout_ms, 15 * 60 * 1000,  // 15 minutes
              "Max amount of time we can wait for active transactions to abort on a tablet "
              "after DDL (ie. DROP TABLE) is executed. This deadline is same as "
              "unresponsive_ts_rpc_timeout_ms");
 
+DEFINE_bool(tablet_write_backpressure, false,
+            "Whether to reject part of write requests before RocksDB of the tablet starts to stall "
+            "writes. The probability of rejection grows with the number of SST files, compaction "
+            "debt, number of unflushed memtables and size of intents db.");
+TAG_FLAG(tablet_write_backpressure, advanced);
+TAG_FLAG(tablet_write_backpressure, runtime);
+
+DEFINE_int32(tablet_write_backpressure_start_percentage, 50,
+             "Percentage of the RocksDB write stall trigger at which tablet write backpressure "
+             "starts to reject write requests.");
+TAG_FLAG(tablet_write_backpressure_start_percentage, advanced);
+TAG_FLAG(tablet_write_backpressure_start_percentage, runtime);
+
+DEFINE_int64(tablet_write_backpressure_intents_db_size_limit_mb, 4096,
+             "Size of intents db SST files at which tablet write backpressure rejects all write "
+             "requests. 0 to ignore intents db size.");
+TAG_FLAG(tablet_write_backpressure_intents_db_size_limit_mb, advanced);
+TAG_FLAG(tablet_write_backpressure_intents_db_size_limit_mb, runtime);
+
+DEFINE_int32(tablet_write_backpressure_refresh_interval_ms, 100,
+             "Interval at which tablet write backpressure is recalculated.");
+TAG_FLAG(tablet_write_backpressure_refresh_interval_ms, advanced);
+TAG_FLAG(tablet_write_backpressure_refresh_interval_ms, runtime);
+
+DEFINE_int32(block_cache_warm_up_max_blocks_per_tablet, 4096,
+             "Maximum number of cached data blocks saved per tablet to warm up the block cache.");
+TAG_FLAG(block_cache_warm_up_max_blocks_per_tablet, advanced);
+TAG_FLAG(block_cache_warm_up_max_blocks_per_tablet, runtime);
+
+DEFINE_int64(block_cache_warm_up_bytes_per_sec, 32 * 1024 * 1024,
+             "Rate at which saved data blocks are read to warm up the block cache of a tablet. "
+             "0 for no limit.");
+TAG_FLAG(block_cache_warm_up_bytes_per_sec, advanced);
+TAG_FLAG(block_cache_warm_up_bytes_per_sec, runtime);
+
 DEFINE_test_flag(int32, slowdown_backfill_by_ms, 0,
                  "If set > 0, slows down the backfill process by this amount.");
 
@@ -307,6 +403,10 @@ using docdb::StorageDbType;
 
 namespace {
 
+// Longest backoff after a slow index backfill flush, as a multiple of
+// backfill_index_target_flush_latency_ms.
+constexpr int kMaxFlushLatencyBackoffFactor = 10;
+
 docdb::PartialRangeKeyIntents UsePartialRangeKeyIntents(const RaftGroupMetadata& metadata) {
   return docdb::PartialRangeKeyIntents(metadata.table_type() == TableType::PGSQL_TABLE_TYPE);
 }
@@ -316,6 +416,38 @@ std::string MakeTabletLogPrefix(
   return Format("T $0$1: ", tablet_id, log_prefix_suffix);
 }
 
+scoped_refptr<Counter> WriteCpuTimeCounter(TabletMetrics* metrics) {
+  return metrics ? metrics->write_cpu_time_us : scoped_refptr<Counter>();
+}
+
+// Human readable hashed prefix of the doc key addressed by a request: hash code and values of
+// hashed columns.
+template <class Values>
+std::string HotKeyString(uint16_t hash_code, const Values& hashed_values) {
+  std::string result = StringPrintf("0x%04x", hash_code);
+  for (const auto& value : hashed_values) {
+    result += ' ';
+    result += value.has_value() ? value.value().ShortDebugString() : value.ShortDebugString();
+  }
+  return result;
+}
+
+template <class Request>
+void RecordHotQLKey(bool write, const Request& request, TabletLoadTracker* load_tracker) {
+  if (request.has_hash_code() && load_tracker->ShouldSampleHotKey()) {
+    load_tracker->RecordHotKey(
+        write, HotKeyString(request.hash_code(), request.hashed_column_values()));
+  }
+}
+
+template <class Request>
+void RecordHotPgsqlKey(bool write, const Request& request, TabletLoadTracker* load_tracker) {
+  if (request.has_hash_code() && load_tracker->ShouldSampleHotKey()) {
+    load_tracker->RecordHotKey(
+        write, HotKeyString(request.hash_code(), request.partition_column_values()));
+  }
+}
+
 docdb::ConsensusFrontiers* InitFrontiers(
     const OpId op_id,
     const HybridTime log_ht,
@@ -421,6 +553,11 @@ Tablet::Tablet(const TabletInitData& data)
   if (transactional) {
     server::HybridClock::EnableClockSkewControl();
   }
+  if (FLAGS_tablet_row_cache_size_mb > 0 && table_type_ == TableType::YQL_TABLE_TYPE &&
+      !transactional && !is_sys_catalog_) {
+    row_cache_ = std::make_unique<docdb::RowCache>(
+        FLAGS_tablet_row_cache_size_mb * 1_MB, mem_tracker_, tablet_metrics_entity_);
+  }
   if (txns_enabled_ &&
       data.transaction_participant_context &&
       (is_sys_catalog_ || transactional)) {
@@ -626,6 +763,11 @@ Status Tablet::OpenKeyValueTablet() {
   static const std::string kRegularDB = "RegularDB"s;
   static const std::string kIntentsDB = "IntentsDB"s;
 
+  // Data is replaced, for instance by truncate or snapshot restore.
+  if (row_cache_) {
+    row_cache_->Clear(clock_->Now());
+  }
+
   rocksdb::Options rocksdb_options;
   InitRocksDBOptions(&rocksdb_options, LogPrefix(docdb::StorageDbType::kRegular));
   rocksdb_options.mem_tracker = MemTracker::FindOrCreateTracker(kRegularDB, mem_tracker_);
@@ -637,14 +779,25 @@ Status Tablet::OpenKeyValueTablet() {
   if (tablet_metrics_entity_) {
     rocksdb_options.block_based_table_mem_tracker->SetMetricEntity(
         tablet_metrics_entity_, Format("$0_$1", "BlockBasedTable", kRegularDB));
+    // Memtables of the tablet, the tablet metrics are rolled up per table.
+    rocksdb_options.mem_tracker->SetMetricEntity(
+        tablet_metrics_entity_, Format("$0_$1", "MemTable", kRegularDB));
   }
 
   key_bounds_ = docdb::KeyBounds(metadata()->lower_bound_key(), metadata()->upper_bound_key());
 
+  const string db_dir = metadata()->rocksdb_dir();
+
+  // Always created, so values moved to the value log are read even when it is disabled for new
+  // compactions by docdb_value_log_min_value_size.
+  value_log_ = std::make_unique<docdb::ValueLog>(
+      tablet_options_.env, db_dir, tablet_options_.block_cache,
+      LogPrefix(docdb::StorageDbType::kRegular));
+
   // Install the history cleanup handler. Note that TabletRetentionPolicy is going to hold a raw ptr
   // to this tablet. So, we ensure that rocksdb_ is reset before this tablet gets destroyed.
   rocksdb_options.compaction_filter_factory = make_shared<DocDBCompactionFilterFactory>(
-      retention_policy_, &key_bounds_);
+      retention_policy_, &key_bounds_, value_log_.get());
 
   rocksdb_options.mem_table_flush_filter_factory = MakeMemTableFlushFilterFactory([this] {
     if (mem_table_flush_filter_factory_) {
@@ -661,8 +814,11 @@ Status Tablet::OpenKeyValueTablet() {
   regular_rocksdb_options.listeners.push_back(
       std::make_shared<RegularRocksDbListener>(this, regular_rocksdb_options.log_prefix));
 
-  const string db_dir = metadata()->rocksdb_dir();
   RETURN_NOT_OK(CreateTabletDirectories(db_dir, metadata()->fs_manager()));
+  RETURN_NOT_OK(value_log_->Open());
+  // Shared by the regular and intents DBs, as the rate limiter created by InitRocksDBOptions.
+  RETURN_NOT_OK(docdb::SetDeviceRateLimiter(db_dir, &rocksdb_options));
+  regular_rocksdb_options.rate_limiter = rocksdb_options.rate_limiter;
 
   LOG(INFO) << "Opening RocksDB at: " << db_dir;
   rocksdb::DB* db = nullptr;
@@ -690,6 +846,10 @@ Status Tablet::OpenKeyValueTablet() {
     intents_rocksdb_options.compaction_filter_factory =
         FLAGS_tablet_do_compaction_cleanup_for_intents ?
         std::make_shared<docdb::DocDBIntentsCompactionFilterFactory>(this, &key_bounds_) : nullptr;
+    // Subcompaction boundaries are aligned to documents only by DocDBCompactionFilterFactory, so
+    // intents of the same key could be split between subcompactions. Intents DB is compacted
+    // mostly to remove applied intents, so it is not worth splitting.
+    intents_rocksdb_options.max_subcompactions = 1;
 
     intents_rocksdb_options.mem_tracker = MemTracker::FindOrCreateTracker(kIntentsDB, mem_tracker_);
     intents_rocksdb_options.block_based_table_mem_tracker =
@@ -700,6 +860,8 @@ Status Tablet::OpenKeyValueTablet() {
     if (tablet_metrics_entity_) {
       intents_rocksdb_options.block_based_table_mem_tracker->SetMetricEntity(
           tablet_metrics_entity_, Format("$0_$1", "BlockBasedTable", kIntentsDB));
+      intents_rocksdb_options.mem_tracker->SetMetricEntity(
+          tablet_metrics_entity_, Format("$0_$1", "MemTable", kIntentsDB));
     }
     intents_rocksdb_options.statistics = intentsdb_statistics_;
 
@@ -729,10 +891,36 @@ Status Tablet::OpenKeyValueTablet() {
 }
 
 void Tablet::RegularDbFilesChanged() {
-  std::lock_guard<std::mutex> lock(num_sst_files_changed_listener_mutex_);
-  if (num_sst_files_changed_listener_) {
-    num_sst_files_changed_listener_();
+  {
+    std::lock_guard<std::mutex> lock(num_sst_files_changed_listener_mutex_);
+    if (num_sst_files_changed_listener_) {
+      num_sst_files_changed_listener_();
+    }
+  }
+  DeleteObsoleteValueLogFiles();
+}
+
+void Tablet::DeleteObsoleteValueLogFiles() {
+  auto scoped_read_operation = CreateNonAbortableScopedRWOperation();
+  if (!scoped_read_operation.ok() || state_ != State::kOpen || !value_log_ ||
+      !cleanup_intent_files_token_) {
+    return;
+  }
+
+  WARN_NOT_OK(
+      cleanup_intent_files_token_->SubmitFunc(
+          std::bind(&Tablet::DoDeleteObsoleteValueLogFiles, this)),
+      "Submit delete obsolete value log files failed");
+}
+
+void Tablet::DoDeleteObsoleteValueLogFiles() {
+  auto scoped_read_operation = CreateNonAbortableScopedRWOperation();
+  if (!scoped_read_operation.ok() || !value_log_) {
+    return;
   }
+
+  WARN_NOT_OK(value_log_->DeleteObsoleteFiles(regular_db_.get()),
+              LogPrefix() + "Failed to delete obsolete value log files");
 }
 
 void Tablet::SetCleanupPool(ThreadPool* thread_pool) {
@@ -1007,6 +1195,15 @@ Status Tablet::CompleteShutdownRocksDBs(Destroy destroy, ScopedRWOperationPauses
 
   Status intents_status = ResetRocksDB(destroy, rocksdb_options, &intents_db_);
   Status regular_status = ResetRocksDB(destroy, rocksdb_options, &regular_db_);
+  if (value_log_) {
+    if (destroy) {
+      auto value_log_status = value_log_->DeleteAllFiles();
+      if (regular_status.ok()) {
+        regular_status = value_log_status;
+      }
+    }
+    value_log_.reset();
+  }
   key_bounds_ = docdb::KeyBounds();
   // Reset rocksdb_shutdown_requested_ to the initial state like RocksDBs were never opened,
   // so we don't have to reset it on RocksDB open (we potentially can have several places in the
@@ -1073,6 +1270,7 @@ Status Tablet::ApplyRowOperations(
   if (metrics_) {
     metrics_->rows_inserted->IncrementBy(put_batch.write_pairs().size());
   }
+  ScopedTabletCpuTimeTracker cpu_time_tracker(WriteCpuTimeCounter(metrics_.get()));
 
   return ApplyOperation(
       *operation, write_request.batch_idx(), put_batch, already_applied_to_regular_db);
@@ -1155,6 +1353,10 @@ Status Tablet::ApplyKeyValueRowOperations(
     RETURN_NOT_OK(PrepareTransactionWriteBatch(batch_idx, put_batch, hybrid_time, &write_batch));
     WriteToRocksDB(frontiers, &write_batch, StorageDbType::kIntents);
   } else {
+    if (row_cache_) {
+      InvalidateRowCache(put_batch, hybrid_time);
+    }
+
     rocksdb::WriteBatch regular_write_batch;
     auto* regular_write_batch_ptr = !already_applied_to_regular_db ? &regular_write_batch : nullptr;
     // See comments for PrepareNonTransactionWriteBatch.
@@ -1183,6 +1385,27 @@ Status Tablet::ApplyKeyValueRowOperations(
   return Status::OK();
 }
 
+void Tablet::InvalidateRowCache(const KeyValueWriteBatchPB& put_batch, HybridTime hybrid_time) {
+  // External writes become visible at their own hybrid time, that could be before the read time
+  // of a concurrent read. So the cache is disabled for tablets that receive them.
+  if (!put_batch.apply_external_transactions().empty()) {
+    row_cache_->Clear(HybridTime::kMax);
+    return;
+  }
+  for (const auto& pair : put_batch.write_pairs()) {
+    if (pair.has_external_hybrid_time()) {
+      row_cache_->Clear(HybridTime::kMax);
+      return;
+    }
+    auto sizes = docdb::DocKey::EncodedHashPartAndDocKeySizes(pair.key());
+    if (!sizes.ok()) {
+      row_cache_->Clear(hybrid_time);
+      return;
+    }
+    row_cache_->Invalidate(Slice(pair.key()).Prefix(sizes->first), hybrid_time);
+  }
+}
+
 void Tablet::WriteToRocksDB(
     const rocksdb::UserFrontiers* frontiers,
     rocksdb::WriteBatch* write_batch,
@@ -1257,6 +1480,7 @@ void SetupKeyValueBatch(WriteRequestPB* write_request, WriteRequestPB* batch_req
 //--------------------------------------------------------------------------------------------------
 // Redis Request Processing.
 void Tablet::KeyValueBatchFromRedisWriteBatch(std::unique_ptr<WriteOperation> operation) {
+  ScopedTabletCpuTimeTracker cpu_time_tracker(WriteCpuTimeCounter(metrics_.get()));
   auto scoped_read_operation = CreateNonAbortableScopedRWOperation();
   if (!scoped_read_operation.ok()) {
     WriteOperation::StartSynchronization(std::move(operation), MoveStatus(scoped_read_operation));
@@ -1334,6 +1558,8 @@ Status Tablet::HandleQLReadRequest(
   auto scoped_read_operation = CreateNonAbortableScopedRWOperation(deadline);
   RETURN_NOT_OK(scoped_read_operation);
   ScopedTabletMetricsTracker metrics_tracker(metrics_->ql_read_latency);
+  load_tracker_.RecordRead(ql_read_request.has_hash_code(), ql_read_request.hash_code());
+  RecordHotQLKey(/* write= */ false, ql_read_request, &load_tracker_);
 
   if (!IsSchemaVersionCompatible(metadata()->schema_version(), ql_read_request)) {
     DVLOG(1) << "Setting status for read as YQL_STATUS_SCHEMA_VERSION_MISMATCH";
@@ -1398,6 +1624,7 @@ CHECKED_STATUS Tablet::CreatePagingStateForRead(const QLReadRequestPB& ql_read_r
 }
 
 void Tablet::KeyValueBatchFromQLWriteBatch(std::unique_ptr<WriteOperation> operation) {
+  ScopedTabletCpuTimeTracker cpu_time_tracker(WriteCpuTimeCounter(metrics_.get()));
   DVLOG(2) << " Schema version for  " << metadata_->table_name() << " is "
            << metadata_->schema_version();
   auto scoped_read_operation = CreateNonAbortableScopedRWOperation();
@@ -1425,6 +1652,8 @@ void Tablet::KeyValueBatchFromQLWriteBatch(std::unique_ptr<WriteOperation> opera
   for (size_t i = 0; i < ql_write_batch->size(); i++) {
     QLWriteRequestPB* req = ql_write_batch->Mutable(i);
     QLResponsePB* resp = operation->response()->add_ql_response_batch();
+    load_tracker_.RecordWrite(req->has_hash_code(), req->hash_code());
+    RecordHotQLKey(/* write= */ true, *req, &load_tracker_);
     if (!IsSchemaVersionCompatible(table_info->schema_version, *req)) {
       DVLOG(1) << " On " << table_info->table_name
                << " Setting status for write as YQL_STATUS_SCHEMA_VERSION_MISMATCH tserver's: "
@@ -1582,11 +1811,54 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
     return;
   }
 
+  if (!txn && FLAGS_ycql_async_user_enforced_index_updates) {
+    UpdateQLIndexesAsync(session, index_ops);
+    CompleteQLWriteBatch(std::move(operation), Status::OK());
+    return;
+  }
+
   session->FlushAsync(std::bind(
       &Tablet::UpdateQLIndexesFlushed, this, operation.release(), session, txn,
       std::move(index_ops), _1));
 }
 
+void Tablet::UpdateQLIndexesAsync(const client::YBSessionPtr& session,
+                                  const IndexOps& index_ops) {
+  // The base table write ops are gone when the callback is invoked, and so could be the tablet, so
+  // it refers to the index ops and metrics only.
+  std::vector<std::shared_ptr<client::YBqlWriteOp>> ops;
+  ops.reserve(index_ops.size());
+  for (const auto& pair : index_ops) {
+    ops.push_back(pair.first);
+  }
+  auto in_flight = metrics_->async_index_updates_in_flight;
+  auto lag = metrics_->async_index_update_lag;
+  auto failures = metrics_->async_index_update_failures;
+  in_flight->IncrementBy(ops.size());
+  const auto start = MonoTime::Now();
+  session->FlushAsync(
+      [session, ops = std::move(ops), in_flight, lag, failures, start, tablet_id = tablet_id()](
+          client::FlushStatus* flush_status) {
+    lag->Increment(MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+    in_flight->DecrementBy(ops.size());
+    size_t num_failed = 0;
+    for (const auto& op : ops) {
+      if (op->response().status() != QLResponsePB::YQL_STATUS_OK) {
+        ++num_failed;
+      }
+    }
+    if (!flush_status->status.ok()) {
+      num_failed = std::max(num_failed, std::max<size_t>(flush_status->errors.size(), 1));
+    }
+    if (num_failed != 0) {
+      failures->IncrementBy(num_failed);
+      YB_LOG_EVERY_N_SECS(WARNING, 10)
+          << "T " << tablet_id << ": " << num_failed << " of " << ops.size()
+          << " asynchronous index updates failed: " << flush_status->status;
+    }
+  });
+}
+
 void Tablet::UpdateQLIndexesFlushed(
     WriteOperation* op, const client::YBSessionPtr& session, const client::YBTransactionPtr& txn,
     const IndexOps& index_ops, client::FlushStatus* flush_status) {
@@ -1652,6 +1924,8 @@ Status Tablet::HandlePgsqlReadRequest(
   RETURN_NOT_OK(scoped_read_operation);
   // TODO(neil) Work on metrics for PGSQL.
   // ScopedTabletMetricsTracker metrics_tracker(metrics_->pgsql_read_latency);
+  load_tracker_.RecordRead(pgsql_read_request.has_hash_code(), pgsql_read_request.hash_code());
+  RecordHotPgsqlKey(/* write= */ false, pgsql_read_request, &load_tracker_);
 
   const shared_ptr<tablet::TableInfo> table_info =
       VERIFY_RESULT(metadata_->GetTableInfo(pgsql_read_request.table_id()));
@@ -1779,6 +2053,8 @@ CHECKED_STATUS Tablet::PreparePgsqlWriteOperations(WriteOperation* operation) {
   for (size_t i = 0; i < pgsql_write_batch->size(); i++) {
     PgsqlWriteRequestPB* req = pgsql_write_batch->Mutable(i);
     PgsqlResponsePB* resp = operation->response()->add_pgsql_response_batch();
+    load_tracker_.RecordWrite(req->has_hash_code(), req->hash_code());
+    RecordHotPgsqlKey(/* write= */ true, *req, &load_tracker_);
     // Table-level tombstones should not be requested for non-colocated tables.
     if ((req->stmt_type() == PgsqlWriteRequestPB::PGSQL_TRUNCATE_COLOCATED) &&
         !metadata_->colocated()) {
@@ -1813,6 +2089,7 @@ CHECKED_STATUS Tablet::PreparePgsqlWriteOperations(WriteOperation* operation) {
 }
 
 void Tablet::KeyValueBatchFromPgsqlWriteBatch(std::unique_ptr<WriteOperation> operation) {
+  ScopedTabletCpuTimeTracker cpu_time_tracker(WriteCpuTimeCounter(metrics_.get()));
   auto scoped_read_operation = CreateNonAbortableScopedRWOperation();
   if (!scoped_read_operation.ok()) {
     WriteOperation::StartSynchronization(std::move(operation), MoveStatus(scoped_read_operation));
@@ -1954,7 +2231,27 @@ Status Tablet::WaitForFlush() {
 
 Status Tablet::ImportData(const std::string& source_dir) {
   // We import only regular records, so don't have to deal with intents here.
-  return regular_db_->Import(source_dir);
+  RETURN_NOT_OK(regular_db_->Import(source_dir, nullptr /* flushed_frontier */));
+  if (row_cache_) {
+    row_cache_->Clear(clock_->Now());
+  }
+  return Status::OK();
+}
+
+Status Tablet::ImportData(ImportDataOperation* operation) {
+  auto scoped_read_operation = CreateNonAbortableScopedRWOperation();
+  RETURN_NOT_OK(scoped_read_operation);
+
+  docdb::ConsensusFrontier frontier;
+  frontier.set_op_id(operation->op_id());
+  frontier.set_hybrid_time(operation->hybrid_time());
+  RETURN_NOT_OK(regular_db_->Import(operation->request()->source_dir(), frontier.Clone()));
+  if (row_cache_) {
+    row_cache_->Clear(clock_->Now());
+  }
+  LOG_WITH_PREFIX(INFO) << "Imported data from " << operation->request()->source_dir()
+                        << " at " << operation->op_id();
+  return Status::OK();
 }
 
 // We apply intents by iterating over whole transaction reverse index.
@@ -1968,6 +2265,11 @@ Result<docdb::ApplyTransactionState> Tablet::ApplyIntents(const TransactionApply
       tablet_id(), data.transaction_id, data.commit_ht, &key_bounds_, data.apply_state, data.log_ht,
       &regular_write_batch, intents_db_.get(), nullptr /* intents_write_batch */));
 
+  // Keys of applied intents are not tracked, so all cached rows are invalidated.
+  if (row_cache_) {
+    row_cache_->Clear(data.commit_ht);
+  }
+
   // data.hybrid_time contains transaction commit time.
   // We don't set transaction field of put_batch, otherwise we would write another bunch of intents.
   docdb::ConsensusFrontiers frontiers;
@@ -1982,6 +2284,7 @@ CHECKED_STATUS Tablet::RemoveIntentsImpl(const RemoveIntentsData& data, const Id
   RETURN_NOT_OK(scoped_read_operation);
 
   rocksdb::WriteBatch intents_write_batch;
+  int64_t num_tombstones = 0;
   for (const auto& id : ids) {
     boost::optional<docdb::ApplyTransactionState> apply_state;
     for (;;) {
@@ -1995,6 +2298,7 @@ CHECKED_STATUS Tablet::RemoveIntentsImpl(const RemoveIntentsData& data, const Id
 
       docdb::ConsensusFrontiers frontiers;
       auto frontiers_ptr = InitFrontiers(data, &frontiers);
+      num_tombstones += intents_write_batch.Count();
       WriteToRocksDB(frontiers_ptr, &intents_write_batch, StorageDbType::kIntents);
 
       apply_state = std::move(new_apply_state);
@@ -2006,10 +2310,68 @@ CHECKED_STATUS Tablet::RemoveIntentsImpl(const RemoveIntentsData& data, const Id
 
   docdb::ConsensusFrontiers frontiers;
   auto frontiers_ptr = InitFrontiers(data, &frontiers);
+  num_tombstones += intents_write_batch.Count();
   WriteToRocksDB(frontiers_ptr, &intents_write_batch, StorageDbType::kIntents);
+  MaybeCompactIntentsDb(num_tombstones);
   return Status::OK();
 }
 
+void Tablet::MaybeCompactIntentsDb(int64_t new_tombstones) {
+  auto tombstones = intents_tombstones_since_compaction_.fetch_add(
+      new_tombstones, std::memory_order_acq_rel) + new_tombstones;
+  const auto ratio = GetAtomicFlag(&FLAGS_intents_compaction_tombstone_ratio);
+  if (ratio <= 0 || tombstones < GetAtomicFlag(&FLAGS_intents_compaction_min_tombstones) ||
+      !cleanup_intent_files_token_) {
+    return;
+  }
+
+  bool expected = false;
+  if (!intents_compaction_scheduled_.compare_exchange_strong(
+          expected, true, std::memory_order_acq_rel)) {
+    return;
+  }
+  auto now = CoarseMonoClock::now();
+  if (last_intents_compaction_time_ != CoarseTimePoint() &&
+      now - last_intents_compaction_time_ <
+          GetAtomicFlag(&FLAGS_intents_compaction_min_interval_secs) * 1s) {
+    intents_compaction_scheduled_.store(false, std::memory_order_release);
+    return;
+  }
+
+  rocksdb::TablePropertiesCollection properties;
+  auto status = intents_db_->GetPropertiesOfAllTables(&properties);
+  uint64_t num_entries = 0;
+  for (const auto& file_and_properties : properties) {
+    num_entries += file_and_properties.second->num_entries;
+  }
+  if (!status.ok() || tombstones < ratio * num_entries) {
+    WARN_NOT_OK(status, LogPrefix() + "Failed to get intents DB table properties");
+    intents_compaction_scheduled_.store(false, std::memory_order_release);
+    return;
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Compacting intents DB, removed intents: " << tombstones
+                        << ", entries in SST files: " << num_entries;
+  last_intents_compaction_time_ = now;
+  status = cleanup_intent_files_token_->SubmitFunc(std::bind(&Tablet::CompactIntentsDb, this));
+  if (!status.ok()) {
+    WARN_NOT_OK(status, LogPrefix() + "Submit intents DB compaction failed");
+    intents_compaction_scheduled_.store(false, std::memory_order_release);
+  }
+}
+
+void Tablet::CompactIntentsDb() {
+  auto scoped_read_operation = CreateNonAbortableScopedRWOperation();
+  if (scoped_read_operation.ok() && state_ == State::kOpen) {
+    // Tombstones written after this point are not necessarily removed by this compaction,
+    // but it is fine to underestimate them.
+    intents_tombstones_since_compaction_.store(0, std::memory_order_release);
+    WARN_NOT_OK(docdb::ForceRocksDBCompact(intents_db_.get()),
+                LogPrefix() + "Intents DB compaction failed");
+  }
+  intents_compaction_scheduled_.store(false, std::memory_order_release);
+}
+
 
 Status Tablet::RemoveIntents(const RemoveIntentsData& data, const TransactionId& id) {
   return RemoveIntentsImpl(data, std::initializer_list<TransactionId>{id});
@@ -2063,7 +2425,21 @@ Status Tablet::AddTable(const TableInfoPB& table_info) {
   return Status::OK();
 }
 
-Status Tablet::RemoveTable(const std::string& table_id) {
+Status Tablet::RemoveTable(const std::string& table_id, const Operation& operation) {
+  if (FLAGS_tombstone_removed_colocated_table_data && metadata_->colocated()) {
+    auto table_info = metadata_->GetTableInfo(table_id);
+    if (table_info.ok() && ((**table_info).schema.has_pgtable_id() ||
+                            (**table_info).schema.has_cotable_id())) {
+      // The same table tombstone as TRUNCATE of a colocated table writes. It is replayed with the
+      // operation at bootstrap, writing it again is harmless.
+      docdb::KeyValueWriteBatchPB write_batch;
+      auto* pair = write_batch.add_write_pairs();
+      pair->set_key(docdb::DocKey((**table_info).schema).Encode().ToStringBuffer());
+      pair->set_value(docdb::Value(docdb::PrimitiveValue::kTombstone).Encode());
+      RETURN_NOT_OK(ApplyOperation(operation, /* batch_idx= */ -1, write_batch));
+      LOG_WITH_PREFIX(INFO) << "Wrote table tombstone for removed table " << table_id;
+    }
+  }
   metadata_->RemoveTable(table_id);
   RETURN_NOT_OK(metadata_->Flush());
   return Status::OK();
@@ -2122,6 +2498,9 @@ Status Tablet::AlterSchema(ChangeMetadataOperation *operation) {
 
   metadata_->SetSchema(*operation->schema(), operation->index_map(), deleted_cols,
                        operation->schema_version(), current_table_info->table_id);
+  if (row_cache_) {
+    row_cache_->Clear(clock_->Now());
+  }
   if (operation->has_new_table_name()) {
     metadata_->SetTableName(current_table_info->namespace_name, operation->new_table_name());
     if (table_metrics_entity_) {
@@ -2353,6 +2732,10 @@ Status Tablet::BackfillIndexes(
     // We need: grace_margin_ms >= 1000 * batch_size / rate_per_sec;
     // By default, we will set it to twice the minimum value + 1s.
     grace_margin_ms = (rate_per_sec > 0 ? 1000 * (1 + 2.0 * batch_size / rate_per_sec) : 1000);
+    // Leave room for the longest latency backoff as well.
+    grace_margin_ms +=
+        kMaxFlushLatencyBackoffFactor *
+        std::max(GetAtomicFlag(&FLAGS_backfill_index_target_flush_latency_ms), 0);
     YB_LOG_EVERY_N(INFO, 100000) << "Using grace margin of " << grace_margin_ms << "ms";
   }
   const yb::CoarseDuration kMargin = grace_margin_ms * 1ms;
@@ -2479,9 +2862,22 @@ Status Tablet::FlushIndexBatchIfRequired(
   VLOG(1) << Format("Flushing $0 ops to the index",
                     (!ops_by_primary_key.empty() ? ops_by_primary_key.size()
                                                  : write_ops.size()));
+  const auto flush_start = CoarseMonoClock::Now();
   RETURN_NOT_OK(FlushWithRetries(session, write_ops, kMaxNumRetries, failed_indexes));
 
   auto now = CoarseMonoClock::Now();
+  const auto target_flush_latency =
+      GetAtomicFlag(&FLAGS_backfill_index_target_flush_latency_ms) * 1ms;
+  if (target_flush_latency > 0ms && now - flush_start > target_flush_latency) {
+    // Slow index writes mean the index tablets are busy, so give foreground traffic a share of
+    // them proportional to how long this batch held them.
+    const auto backoff = std::min<CoarseDuration>(
+        now - flush_start, kMaxFlushLatencyBackoffFactor * target_flush_latency);
+    VLOG(2) << "Index flush took " << MonoDelta(now - flush_start) << ", backing off for "
+            << MonoDelta(backoff);
+    SleepFor(MonoDelta(backoff));
+    now = CoarseMonoClock::Now();
+  }
   if (FLAGS_backfill_index_rate_rows_per_sec > 0) {
     auto duration_since_last_batch = MonoDelta(now - *last_flushed_at);
     auto expected_duration_ms = MonoDelta::FromMilliseconds(
@@ -2920,6 +3316,7 @@ class DocWriteOperation : public std::enable_shared_from_this<DocWriteOperation>
       docdb::ResolveOperationConflicts(
           operation_->doc_ops(), now, tablet_.doc_db(), partial_range_key_intents,
           transaction_participant, tablet_.metrics()->transaction_conflicts.get(),
+          &prepare_result_.lock_batch, operation_->deadline(),
           [self = shared_from_this(), now](const Result<HybridTime>& result) {
             if (!result.ok()) {
               self->InvokeCallback(result.status());
@@ -2956,6 +3353,7 @@ class DocWriteOperation : public std::enable_shared_from_this<DocWriteOperation>
         read_time_ ? read_time_.read : HybridTime::kMax,
         tablet_.doc_db(), partial_range_key_intents,
         transaction_participant, tablet_.metrics()->transaction_conflicts.get(),
+        &prepare_result_.lock_batch, operation_->deadline(),
         [self = shared_from_this()](const Result<HybridTime>& result) {
           if (!result.ok()) {
             self->InvokeCallback(result.status());
@@ -3204,6 +3602,103 @@ Status Tablet::ForceFullRocksDBCompact() {
   return Status::OK();
 }
 
+namespace {
+
+const std::string kCachedDataBlocksFileName = "CACHED_DATA_BLOCKS";
+
+// Data blocks are loaded in chunks of this size, sleeping between chunks to keep the rate limit.
+constexpr size_t kWarmUpChunkBytes = 1024 * 1024;
+
+} // namespace
+
+Status Tablet::SaveCachedDataBlocks() {
+  auto scoped_operation = CreateNonAbortableScopedRWOperation();
+  RETURN_NOT_OK(scoped_operation);
+
+  if (!regular_db_) {
+    return Status::OK();
+  }
+  const auto files = VERIFY_RESULT(regular_db_->GetCachedDataBlocks(
+      FLAGS_block_cache_warm_up_max_blocks_per_tablet));
+  CachedDataBlocksPB pb;
+  for (const auto& file : files) {
+    auto* file_pb = pb.add_files();
+    file_pb->set_file_number(file.file_number);
+    for (const auto& block : file.blocks) {
+      file_pb->add_block_offsets(block.offset);
+      file_pb->add_block_sizes(block.size);
+    }
+  }
+  return pb_util::WritePBContainerToPath(
+      metadata_->fs_manager()->env(),
+      JoinPathSegments(metadata_->rocksdb_dir(), kCachedDataBlocksFileName), pb,
+      pb_util::OVERWRITE, pb_util::NO_SYNC);
+}
+
+Status Tablet::WarmUpBlockCache() {
+  auto* env = metadata_->fs_manager()->env();
+  const auto path = JoinPathSegments(metadata_->rocksdb_dir(), kCachedDataBlocksFileName);
+  if (!env->FileExists(path)) {
+    return Status::OK();
+  }
+  CachedDataBlocksPB pb;
+  RETURN_NOT_OK(pb_util::ReadPBContainerFromPath(env, path, &pb));
+
+  const auto start = CoarseMonoClock::Now();
+  size_t total_bytes = 0;
+  size_t num_blocks = 0;
+  rocksdb::SstDataBlocks chunk;
+  size_t chunk_bytes = 0;
+  auto load_chunk = [this, &chunk, &chunk_bytes, &total_bytes, &num_blocks, start]() -> Status {
+    {
+      auto scoped_operation = CreateNonAbortableScopedRWOperation();
+      RETURN_NOT_OK(scoped_operation);
+      if (!regular_db_) {
+        return STATUS(IllegalState, "Regular DB is not open");
+      }
+      RETURN_NOT_OK(regular_db_->WarmUpDataBlocks(chunk));
+    }
+    total_bytes += chunk_bytes;
+    num_blocks += chunk.blocks.size();
+    chunk.blocks.clear();
+    chunk_bytes = 0;
+    const auto bytes_per_sec = FLAGS_block_cache_warm_up_bytes_per_sec;
+    if (bytes_per_sec > 0) {
+      const auto wait_until =
+          start + std::chrono::microseconds(total_bytes * 1000000 / bytes_per_sec);
+      const auto now = CoarseMonoClock::Now();
+      if (wait_until > now) {
+        SleepFor(wait_until - now);
+      }
+    }
+    return Status::OK();
+  };
+
+  for (const auto& file_pb : pb.files()) {
+    if (file_pb.block_offsets_size() != file_pb.block_sizes_size()) {
+      return STATUS_FORMAT(
+          Corruption, "Different number of block offsets and sizes in $0: $1 vs $2",
+          path, file_pb.block_offsets_size(), file_pb.block_sizes_size());
+    }
+    chunk.file_number = file_pb.file_number();
+    for (int i = 0; i != file_pb.block_offsets_size(); ++i) {
+      chunk.blocks.push_back(
+          rocksdb::DataBlockLocation{file_pb.block_offsets(i), file_pb.block_sizes(i)});
+      chunk_bytes += file_pb.block_sizes(i);
+      if (chunk_bytes >= kWarmUpChunkBytes) {
+        RETURN_NOT_OK(load_chunk());
+      }
+    }
+    if (!chunk.blocks.empty()) {
+      RETURN_NOT_OK(load_chunk());
+    }
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Warmed up block cache with " << num_blocks << " data blocks, "
+                        << total_bytes << " bytes in " << MonoDelta(CoarseMonoClock::Now() - start);
+  return Status::OK();
+}
+
 std::string Tablet::TEST_DocDBDumpStr(IncludeIntents include_intents) {
   if (!regular_db_) return "";
 
@@ -3295,6 +3790,98 @@ std::pair<int, int> Tablet::GetNumMemtables() const {
   return std::make_pair(intents_num_memtables, regular_num_memtables);
 }
 
+std::pair<uint64_t, uint64_t> Tablet::GetActiveMemtablesSize() const {
+  uint64_t intents_size = 0;
+  uint64_t regular_size = 0;
+
+  {
+    auto scoped_operation = CreateNonAbortableScopedRWOperation();
+    std::lock_guard<rw_spinlock> lock(component_lock_);
+    if (intents_db_) {
+      intents_db_->GetIntProperty(rocksdb::DB::Properties::kCurSizeActiveMemTable, &intents_size);
+    }
+    if (regular_db_) {
+      regular_db_->GetIntProperty(rocksdb::DB::Properties::kCurSizeActiveMemTable, &regular_size);
+    }
+  }
+
+  return std::make_pair(intents_size, regular_size);
+}
+
+namespace {
+
+// Updates backpressure with pressure of the resource, that grows linearly from 0 at
+// tablet_write_backpressure_start_percentage of the limit to 1 at the limit.
+void UpdateWriteBackpressure(
+    const char* resource, uint64_t value, uint64_t limit, WriteBackpressure* backpressure) {
+  // Zero and max limits mean that RocksDB does not stall writes because of this resource.
+  if (limit == 0 || limit >= std::numeric_limits<int>::max()) {
+    return;
+  }
+  const auto start_percentage = fit_bounds(FLAGS_tablet_write_backpressure_start_percentage, 0, 99);
+  const auto start = limit * start_percentage / 100;
+  if (value <= start) {
+    return;
+  }
+  const auto level = static_cast<double>(value - start) / (limit - start);
+  if (level > backpressure->level) {
+    backpressure->level = level;
+    backpressure->reason = Format("$0 $1 against limit $2", resource, value, limit);
+  }
+}
+
+} // namespace
+
+WriteBackpressure Tablet::GetWriteBackpressure() {
+  if (!FLAGS_tablet_write_backpressure) {
+    return WriteBackpressure();
+  }
+
+  const auto now = CoarseMonoClock::Now();
+  std::lock_guard<std::mutex> backpressure_lock(write_backpressure_mutex_);
+  if (now < write_backpressure_refresh_time_) {
+    return write_backpressure_;
+  }
+  write_backpressure_refresh_time_ =
+      now + FLAGS_tablet_write_backpressure_refresh_interval_ms * 1ms;
+
+  WriteBackpressure result;
+  auto scoped_operation = CreateNonAbortableScopedRWOperation();
+  std::lock_guard<rw_spinlock> lock(component_lock_);
+  if (!scoped_operation.ok()) {
+    write_backpressure_ = result;
+    return result;
+  }
+  if (regular_db_) {
+    const auto& options = regular_db_->GetOptions();
+    UpdateWriteBackpressure(
+        "SST files", regular_db_->GetCurrentVersionNumSSTFiles(),
+        options.level0_slowdown_writes_trigger, &result);
+    uint64_t pending_compaction_bytes = 0;
+    if (regular_db_->GetIntProperty(
+            rocksdb::DB::Properties::kEstimatePendingCompactionBytes,
+            &pending_compaction_bytes)) {
+      UpdateWriteBackpressure(
+          "Pending compaction bytes", pending_compaction_bytes,
+          options.soft_pending_compaction_bytes_limit, &result);
+    }
+    // RocksDB stops writes when the number of immutable memtables reaches max_write_buffer_number.
+    UpdateWriteBackpressure(
+        "Unflushed memtables", regular_db_->GetCfdImmNumNotFlushed(),
+        options.max_write_buffer_number, &result);
+  }
+  if (intents_db_) {
+    UpdateWriteBackpressure(
+        "Intents db SST files size", intents_db_->GetCurrentVersionSstFilesSize(),
+        FLAGS_tablet_write_backpressure_intents_db_size_limit_mb * 1_MB, &result);
+    UpdateWriteBackpressure(
+        "Intents db unflushed memtables", intents_db_->GetCfdImmNumNotFlushed(),
+        intents_db_->GetOptions().max_write_buffer_number, &result);
+  }
+  write_backpressure_ = result;
+  return result;
+}
+
 // ------------------------------------------------------------------------------------------------
 
 Result<TransactionOperationContextOpt> Tablet::CreateTransactionOperationContext(
@@ -3479,6 +4066,32 @@ Result<std::string> Tablet::GetEncodedMiddleSplitKey() const {
   return middle_key;
 }
 
+Result<std::string> Tablet::GetEncodedLoadSplitKey() const {
+  // Hash codes of fewer requests do not describe the load distribution well enough.
+  constexpr size_t kMinSamples = 100;
+
+  if (!metadata()->partition_schema()->IsHashPartitioning()) {
+    return STATUS_FORMAT(
+        NotSupported, "Load split key is only supported for hash partitioned tablet $0",
+        tablet_id());
+  }
+  const auto hash_code = load_tracker_.SampledMedianHashCode(kMinSamples);
+  if (!hash_code) {
+    return STATUS_FORMAT(IllegalState, "Not enough key access samples for tablet $0", tablet_id());
+  }
+  docdb::KeyBytes split_key;
+  docdb::DocKeyEncoderAfterTableIdStep(&split_key).Hash(*hash_code, std::vector<PrimitiveValue>());
+  const Slice split_key_slice = split_key.AsSlice();
+  if (split_key_slice.compare(key_bounds_.lower) <= 0 ||
+      (!key_bounds_.upper.empty() && split_key_slice.compare(key_bounds_.upper) >= 0)) {
+    return STATUS_FORMAT(
+        IllegalState, "Load split key $0 is out of bounds of tablet $1 (key_bounds: $2 - $3)",
+        split_key_slice.ToDebugHexString(), tablet_id(),
+        Slice(key_bounds_.lower).ToDebugHexString(), Slice(key_bounds_.upper).ToDebugHexString());
+  }
+  return split_key.ToStringBuffer();
+}
+
 Status Tablet::TriggerPostSplitCompactionIfNeeded(
     std::function<std::unique_ptr<ThreadPoolToken>()> get_token_for_compaction) {
   if (post_split_compaction_task_pool_token_) {
@@ -3495,10 +4108,55 @@ Status Tablet::TriggerPostSplitCompactionIfNeeded(
 
 void Tablet::TriggerPostSplitCompactionSync() {
   TEST_PAUSE_IF_FLAG(TEST_pause_before_post_split_compation);
+  if (FLAGS_post_split_compact_only_files_outside_key_bounds) {
+    auto status = CompactFilesOutsideKeyBounds();
+    if (status.ok()) {
+      return;
+    }
+    LOG_WITH_PREFIX(WARNING) << "Failed to compact post-split files outside of key bounds, "
+                             << "falling back to full compaction: " << status;
+  }
   WARN_WITH_PREFIX_NOT_OK(
       ForceFullRocksDBCompact(), LogPrefix() + "Failed to compact post-split tablet.");
 }
 
+Status Tablet::CompactFilesOutsideKeyBounds() {
+  auto scoped_operation = CreateAbortableScopedRWOperation();
+  RETURN_NOT_OK(scoped_operation);
+
+  if (regular_db_) {
+    const auto files = regular_db_->GetLiveFilesMetaData();
+    std::vector<std::string> input_files;
+    for (const auto& file : files) {
+      if (!key_bounds_.IsWithinBounds(file.smallest.key) ||
+          !key_bounds_.IsWithinBounds(file.largest.key)) {
+        input_files.push_back(file.name);
+      }
+    }
+    LOG_WITH_PREFIX(INFO) << "Post-split compaction of " << input_files.size() << " out of "
+                          << files.size() << " files: " << AsString(input_files);
+    if (!input_files.empty()) {
+      // Out of bounds keys are dropped by the compaction, see DocDBCompactionFilter.
+      RETURN_NOT_OK_PREPEND(
+          regular_db_->CompactFiles(
+              rocksdb::CompactionOptions(), input_files, /* output_level = */ 0),
+          "Post-split compaction failed");
+    }
+  }
+  if (intents_db_) {
+    RETURN_NOT_OK_PREPEND(
+        intents_db_->Flush(rocksdb::FlushOptions()), "Pre-compaction flush of intents db failed");
+    RETURN_NOT_OK(docdb::ForceRocksDBCompact(intents_db_.get()));
+  }
+
+  // That is not a full compaction, so RegularRocksDbListener does not mark the tablet.
+  if (!metadata_->has_been_fully_compacted()) {
+    metadata_->set_has_been_fully_compacted(true);
+    RETURN_NOT_OK(metadata_->Flush());
+  }
+  return Status::OK();
+}
+
 Status Tablet::VerifyDataIntegrity() {
   LOG_WITH_PREFIX(INFO) << "Beginning data integrity checks on this tablet";
 
@@ -72,6 +72,7 @@
 #include "yb/tablet/operation_filter.h"
 #include "yb/tablet/operations/snapshot_operation.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
+#include "yb/tablet/tablet_load_tracker.h"
 #include "yb/tablet/tablet_metadata.h"
 #include "yb/tablet/tablet_options.h"
 #include "yb/tablet/transaction_participant.h"
@@ -139,6 +140,14 @@ inline bool HasFlags(FlushFlags lhs, FlushFlags rhs) {
 
 class WriteOperation;
 
+// How close RocksDB of a tablet is to stalling writes.
+struct WriteBackpressure {
+  // 0 when all resources are below their soft limits, 1 when some resource reached its hard limit.
+  double level = 0;
+  // Description of the resource with the highest pressure.
+  std::string reason;
+};
+
 using AddTableListener = std::function<Status(const TableInfo&)>;
 using DocWriteOperationCallback =
     boost::function<void(std::unique_ptr<WriteOperation>, const Status&)>;
@@ -254,6 +263,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS ImportData(const std::string& source_dir);
 
+  // Apply replicated import data operation. Flushed frontier of the regular RocksDB is updated
+  // with the operation together with adding the imported files, so it is not replayed on bootstrap.
+  CHECKED_STATUS ImportData(ImportDataOperation* operation);
+
   Result<docdb::ApplyTransactionState> ApplyIntents(const TransactionApplyData& data) override;
 
   CHECKED_STATUS RemoveIntents(const RemoveIntentsData& data, const TransactionId& id) override;
@@ -280,6 +293,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       HybridTime hybrid_time,
       AlreadyAppliedToRegularDB already_applied_to_regular_db = AlreadyAppliedToRegularDB::kFalse);
 
+  // Invalidates rows of the row cache, that could be overwritten by put_batch.
+  void InvalidateRowCache(const docdb::KeyValueWriteBatchPB& put_batch, HybridTime hybrid_time);
+
   void WriteToRocksDB(
       const rocksdb::UserFrontiers* frontiers,
       rocksdb::WriteBatch* write_batch,
@@ -377,8 +393,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Apply replicated add table operation.
   CHECKED_STATUS AddTable(const TableInfoPB& table_info);
 
-  // Apply replicated remove table operation.
-  CHECKED_STATUS RemoveTable(const std::string& table_id);
+  // Apply replicated remove table operation. Data of a removed colocated table is deleted
+  // with a table tombstone written at the hybrid time of the operation, when enabled.
+  CHECKED_STATUS RemoveTable(const std::string& table_id, const Operation& operation);
 
   // Truncate this tablet by resetting the content of RocksDB.
   CHECKED_STATUS Truncate(TruncateOperation* operation);
@@ -421,6 +438,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // May be nullptr in unit tests, etc.
   TabletMetrics* metrics() { return metrics_.get(); }
 
+  TabletLoadTracker& load_tracker() { return load_tracker_; }
+
   // Return handle to the metric entity of this tablet/table.
   const scoped_refptr<MetricEntity>& GetTableMetricsEntity() const {
     return table_metrics_entity_;
@@ -525,13 +544,31 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS ForceFullRocksDBCompact();
 
-  docdb::DocDB doc_db() const { return { regular_db_.get(), intents_db_.get(), &key_bounds_ }; }
+  // Saves data blocks of the regular DB present in the block cache to the RocksDB directory.
+  CHECKED_STATUS SaveCachedDataBlocks();
+
+  // Loads data blocks saved by SaveCachedDataBlocks into the block cache, reading at most
+  // block_cache_warm_up_bytes_per_sec.
+  CHECKED_STATUS WarmUpBlockCache();
+
+  docdb::DocDB doc_db() const {
+    return { regular_db_.get(), intents_db_.get(), &key_bounds_, row_cache_.get(),
+             value_log_.get() };
+  }
+
+  docdb::ValueLog* value_log() const {
+    return value_log_.get();
+  }
 
   // Returns approximate middle key for tablet split:
   // - for hash-based partitions: encoded hash code in order to split by hash code.
   // - for range-based partitions: encoded doc key in order to split by row.
   Result<std::string> GetEncodedMiddleSplitKey() const;
 
+  // Returns split key that divides sampled reads and writes of the tablet into halves.
+  // Only supported for hash-based partitions, the key is an encoded hash code.
+  Result<std::string> GetEncodedLoadSplitKey() const;
+
   std::string TEST_DocDBDumpStr(IncludeIntents include_intents = IncludeIntents::kFalse);
 
   void TEST_DocDBDumpToContainer(
@@ -555,6 +592,14 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Returns the number of memtables in intents and regular db-s.
   std::pair<int, int> GetNumMemtables() const;
 
+  // Returns approximate size of the active memtables in intents and regular db-s.
+  std::pair<uint64_t, uint64_t> GetActiveMemtablesSize() const;
+
+  // Returns write backpressure based on SST files number, compaction debt, unflushed memtables and
+  // intents db size. Recalculated at most once per
+  // tablet_write_backpressure_refresh_interval_ms.
+  WriteBackpressure GetWriteBackpressure();
+
   void SetHybridTimeLeaseProvider(HybridTimeLeaseProvider provider) {
     ht_lease_provider_ = std::move(provider);
   }
@@ -754,6 +799,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   void TriggerPostSplitCompactionSync();
 
+  // Compacts SST files of the regular DB that have keys outside of the tablet key bounds, leaving
+  // files that are fully within the bounds shared with the parent tablet.
+  CHECKED_STATUS CompactFilesOutsideKeyBounds();
+
   // Opens read-only rocksdb at the specified directory and checks for any file corruption.
   CHECKED_STATUS OpenDbAndCheckIntegrity(const std::string& db_dir);
 
@@ -785,6 +834,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // TODO: now that this is single-threaded again, we should change it to rw_spinlock
   mutable rw_spinlock component_lock_;
 
+  std::mutex write_backpressure_mutex_;
+  CoarseTimePoint write_backpressure_refresh_time_ GUARDED_BY(write_backpressure_mutex_);
+  WriteBackpressure write_backpressure_ GUARDED_BY(write_backpressure_mutex_);
+
   scoped_refptr<log::LogAnchorRegistry> log_anchor_registry_;
   std::shared_ptr<MemTracker> mem_tracker_;
   std::shared_ptr<MemTracker> block_based_table_mem_tracker_;
@@ -792,6 +845,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   MetricEntityPtr tablet_metrics_entity_;
   MetricEntityPtr table_metrics_entity_;
   std::unique_ptr<TabletMetrics> metrics_;
+
+  TabletLoadTracker load_tracker_;
   FunctionGaugeDetacher metric_detacher_;
 
   // A pointer to the server's clock.
@@ -819,6 +874,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   std::shared_ptr<rocksdb::Statistics> regulardb_statistics_;
   std::shared_ptr<rocksdb::Statistics> intentsdb_statistics_;
 
+  // Large values of the regular DB, should outlive it because compactions append to it.
+  std::unique_ptr<docdb::ValueLog> value_log_;
+
   // RocksDB database instances for key-value tables.
   std::unique_ptr<rocksdb::DB> regular_db_;
   std::unique_ptr<rocksdb::DB> intents_db_;
@@ -827,6 +885,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Optional key bounds (see docdb::KeyBounds) served by this tablet.
   docdb::KeyBounds key_bounds_;
 
+  // Cache of rows resolved by point reads, only used for non transactional tables.
+  std::unique_ptr<docdb::RowCache> row_cache_;
+
   std::unique_ptr<common::YQLStorageIf> ql_storage_;
 
   // This is for docdb fine-grained locking.
@@ -896,6 +957,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   void UpdateQLIndexesFlushed(
       WriteOperation* op, const client::YBSessionPtr& session, const client::YBTransactionPtr& txn,
       const IndexOps& index_ops, client::FlushStatus* flush_status);
+  // Flushes index updates of non-transactional writes without waiting for them.
+  void UpdateQLIndexesAsync(const client::YBSessionPtr& session, const IndexOps& index_ops);
 
   void CompleteQLWriteBatch(std::unique_ptr<WriteOperation> operation, const Status& status);
 
@@ -910,8 +973,21 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   void RegularDbFilesChanged();
 
+  // Deletes value log files that are not referenced by SST files of the regular DB anymore.
+  void DeleteObsoleteValueLogFiles();
+  void DoDeleteObsoleteValueLogFiles();
+
+  // Compacts intents DB in background when the number of intent deletes written since the last
+  // such compaction is high compared to the number of entries in intents SST files.
+  void MaybeCompactIntentsDb(int64_t new_tombstones);
+  void CompactIntentsDb();
+
   Result<HybridTime> ApplierSafeTime(HybridTime min_allowed, CoarseTimePoint deadline) override;
 
+  bool ShouldApplyIntentsBatch() override {
+    return ShouldApplyWrite();
+  }
+
   void MinRunningHybridTimeSatisfied() override {
     CleanupIntentFiles();
   }
@@ -931,6 +1007,12 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::unique_ptr<ThreadPoolToken> cleanup_intent_files_token_;
 
+  std::atomic<int64_t> intents_tombstones_since_compaction_{0};
+  // Set while intents compaction is being checked or is in progress.
+  std::atomic<bool> intents_compaction_scheduled_{false};
+  // Only accessed by the thread that set intents_compaction_scheduled_.
+  CoarseTimePoint last_intents_compaction_time_;
+
   std::unique_ptr<TabletSnapshots> snapshots_;
 
   SnapshotCoordinator* snapshot_coordinator_ = nullptr;
@@ -31,6 +31,9 @@
 //
 #include "yb/tablet/tablet_bootstrap.h"
 
+#include <deque>
+#include <future>
+
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/consensus.pb.h"
 #include "yb/consensus/consensus_util.h"
@@ -49,6 +52,7 @@
 #include "yb/tablet/tablet_splitter.h"
 #include "yb/tablet/operations/change_metadata_operation.h"
 #include "yb/tablet/operations/history_cutoff_operation.h"
+#include "yb/tablet/operations/import_data_operation.h"
 #include "yb/tablet/operations/snapshot_operation.h"
 #include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
@@ -61,6 +65,7 @@
 #include "yb/util/scope_exit.h"
 #include "yb/util/status.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/threadpool.h"
 #include "yb/util/env_util.h"
 #include "yb/consensus/log_index.h"
 #include "yb/docdb/consensus_frontier.h"
@@ -91,6 +96,12 @@ DEFINE_bool(skip_flushed_entries, true,
             "Only replay WAL entries that are not flushed to RocksDB or within the retryable "
             "request timeout.");
 
+DEFINE_int32(tablet_bootstrap_segments_read_ahead, 2,
+             "Number of log segments that are read and decoded in background during tablet "
+             "bootstrap, while entries of the previous segments are replayed. 0 to read "
+             "segments on the bootstrap thread.");
+TAG_FLAG(tablet_bootstrap_segments_read_ahead, advanced);
+
 DECLARE_int32(retryable_request_timeout_secs);
 
 DEFINE_uint64(transaction_status_tablet_log_segment_size_bytes, 4_MB,
@@ -396,6 +407,60 @@ ReplayDecision ShouldReplayOperation(
   return {index > regular_flushed_index};
 }
 
+// Pool shared by all bootstrapping tablets, that reads and decodes log segments ahead of replay.
+ThreadPool* SegmentReadAheadThreadPool() {
+  static std::unique_ptr<ThreadPool> read_ahead_thread_pool = [] {
+    std::unique_ptr<ThreadPool> result;
+    CHECK_OK(ThreadPoolBuilder("log-read-ahead").Build(&result));
+    return result;
+  }();
+  return read_ahead_thread_pool.get();
+}
+
+// Reads entries of the segments of the provided range in order. Up to
+// tablet_bootstrap_segments_read_ahead segments following the one being replayed are read in
+// background.
+class SegmentReadAhead {
+ public:
+  SegmentReadAhead(log::SegmentSequence::const_iterator begin,
+                   log::SegmentSequence::const_iterator end)
+      : next_(begin), end_(end),
+        read_ahead_(std::max(FLAGS_tablet_bootstrap_segments_read_ahead, 0)) {
+  }
+
+  // Returns entries of the next segment, should be called once per segment of the range.
+  log::ReadEntriesResult Next() {
+    if (read_ahead_ == 0) {
+      return (*next_++)->ReadEntries();
+    }
+    Schedule();
+    auto result = pending_.front().get();
+    pending_.pop_front();
+    Schedule();
+    return result;
+  }
+
+ private:
+  void Schedule() {
+    while (next_ != end_ && pending_.size() <= read_ahead_) {
+      log::ReadableLogSegmentPtr segment = *next_++;
+      auto promise = std::make_shared<std::promise<log::ReadEntriesResult>>();
+      pending_.push_back(promise->get_future());
+      auto status = SegmentReadAheadThreadPool()->SubmitFunc([segment, promise] {
+        promise->set_value(segment->ReadEntries());
+      });
+      if (!status.ok()) {
+        promise->set_value(segment->ReadEntries());
+      }
+    }
+  }
+
+  log::SegmentSequence::const_iterator next_;
+  const log::SegmentSequence::const_iterator end_;
+  const size_t read_ahead_;
+  std::deque<std::future<log::ReadEntriesResult>> pending_;
+};
+
 bool WriteOpHasTransaction(const ReplicateMsg& replicate) {
   if (!replicate.has_write_request()) {
     return false;
@@ -883,6 +948,9 @@ class TabletBootstrap {
       case consensus::SPLIT_OP:
         return PlaySplitOpRequest(replicate);
 
+      case consensus::IMPORT_DATA_OP:
+        return PlayImportDataRequest(replicate);
+
       // Unexpected cases:
       case consensus::UNKNOWN_OP:
         return STATUS(IllegalState, Substitute("Unsupported operation type: $0", op_type));
@@ -1201,10 +1269,11 @@ class TabletBootstrap {
     yb::OpId last_committed_op_id;
     yb::OpId last_read_entry_op_id;
     RestartSafeCoarseTimePoint last_entry_time;
+    SegmentReadAhead read_ahead(iter, segments.cend());
     for (; iter != segments.end(); ++iter) {
       const scoped_refptr<ReadableLogSegment>& segment = *iter;
 
-      auto read_result = segment->ReadEntries();
+      auto read_result = read_ahead.Next();
       last_committed_op_id = std::max(last_committed_op_id, read_result.committed_op_id);
       if (!read_result.entries.empty()) {
         last_read_entry_op_id = yb::OpId::FromPB(read_result.entries.back()->replicate().id());
@@ -1434,6 +1503,22 @@ class TabletBootstrap {
     return Status::OK();
   }
 
+  // Import is replayed only when it was not flushed, i.e. the regular RocksDB does not contain
+  // the imported files yet, because they are added in the same version edit as the flushed
+  // frontier of the operation.
+  CHECKED_STATUS PlayImportDataRequest(ReplicateMsg* replicate_msg) {
+    ImportDataOperation operation(tablet_.get(), replicate_msg->mutable_import_data_request());
+    operation.set_op_id(OpId::FromPB(replicate_msg->id()));
+    operation.set_hybrid_time(HybridTime(replicate_msg->hybrid_time()));
+
+    auto status = tablet_->ImportData(&operation);
+    // Failed import does not fail the bootstrap, the same as ImportDataOperation::DoReplicated.
+    LOG_IF_WITH_PREFIX(WARNING, !status.ok())
+        << "Failed to import from " << operation.request()->source_dir() << ": " << status;
+
+    return Status::OK();
+  }
+
   CHECKED_STATUS PlayUpdateTransactionRequest(
       ReplicateMsg* replicate_msg, AlreadyAppliedToRegularDB already_applied_to_regular_db) {
     SCHECK(replicate_msg->has_hybrid_time(),
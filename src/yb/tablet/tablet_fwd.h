@@ -40,6 +40,7 @@ class TabletPeer;
 typedef std::shared_ptr<TabletPeer> TabletPeerPtr;
 
 class ChangeMetadataOperation;
+class ImportDataOperation;
 class Operation;
 class OperationFilter;
 class SnapshotCoordinator;
@@ -0,0 +1,107 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/tablet/tablet_load_tracker.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+DECLARE_int32(tablet_hot_key_sample_interval);
+DECLARE_int32(tablet_key_access_sample_interval);
+
+namespace yb {
+namespace tablet {
+
+class TabletLoadTrackerTest : public YBTest {
+};
+
+TEST_F(TabletLoadTrackerTest, Load) {
+  TabletLoadTracker tracker;
+  auto start = CoarseMonoClock::Now();
+
+  ASSERT_FALSE(tracker.UpdateAndGetLoad(start, 10s));
+  for (int i = 0; i != 100; ++i) {
+    tracker.RecordRead(false, 0);
+  }
+  for (int i = 0; i != 50; ++i) {
+    tracker.RecordWrite(false, 0);
+  }
+  // Window is not covered yet.
+  ASSERT_FALSE(tracker.UpdateAndGetLoad(start + 5s, 10s));
+
+  auto load = tracker.UpdateAndGetLoad(start + 10s, 10s);
+  ASSERT_TRUE(load);
+  ASSERT_DOUBLE_EQ(load->read_ops_per_sec, 10);
+  ASSERT_DOUBLE_EQ(load->write_ops_per_sec, 5);
+
+  // No new accesses, so the window starting at start + 5s has no reads.
+  load = tracker.UpdateAndGetLoad(start + 15s, 10s);
+  ASSERT_TRUE(load);
+  ASSERT_DOUBLE_EQ(load->read_ops_per_sec, 0);
+  ASSERT_DOUBLE_EQ(load->write_ops_per_sec, 0);
+}
+
+TEST_F(TabletLoadTrackerTest, MedianHashCode) {
+  FLAGS_tablet_key_access_sample_interval = 1;
+  TabletLoadTracker tracker;
+
+  ASSERT_FALSE(tracker.SampledMedianHashCode(1));
+
+  // Most of the accesses go to the hot hash code, so it should be chosen regardless of the range
+  // of other hash codes.
+  constexpr uint32_t kHotHashCode = 1000;
+  for (int i = 0; i != 60; ++i) {
+    tracker.RecordWrite(true, kHotHashCode);
+  }
+  for (uint32_t i = 0; i != 40; ++i) {
+    tracker.RecordRead(true, 50000 + i);
+  }
+  // Accesses without hash code are not sampled.
+  tracker.RecordRead(false, 0);
+
+  ASSERT_FALSE(tracker.SampledMedianHashCode(101));
+  auto median = tracker.SampledMedianHashCode(100);
+  ASSERT_TRUE(median);
+  ASSERT_EQ(*median, kHotHashCode);
+}
+
+TEST_F(TabletLoadTrackerTest, HotKeys) {
+  FLAGS_tablet_hot_key_sample_interval = 2;
+  TabletLoadTracker tracker;
+
+  int num_sampled = 0;
+  for (int i = 0; i != 100; ++i) {
+    if (tracker.ShouldSampleHotKey()) {
+      ++num_sampled;
+      tracker.RecordHotKey(/* write= */ i % 10 != 0, i % 10 == 0 ? "read" : "write");
+    }
+  }
+  ASSERT_EQ(num_sampled, 50);
+
+  auto write_keys = tracker.TopHotKeys(/* write= */ true, 10);
+  ASSERT_EQ(write_keys.size(), 1);
+  ASSERT_EQ(write_keys[0].key, "write");
+  ASSERT_EQ(write_keys[0].count, 40);
+  auto read_keys = tracker.TopHotKeys(/* write= */ false, 10);
+  ASSERT_EQ(read_keys.size(), 1);
+  ASSERT_EQ(read_keys[0].key, "read");
+  ASSERT_EQ(read_keys[0].count, 10);
+
+  FLAGS_tablet_hot_key_sample_interval = 0;
+  ASSERT_FALSE(tracker.ShouldSampleHotKey());
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,125 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/tablet_load_tracker.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(tablet_key_access_sample_interval, 64,
+             "Every Nth read or write addressing a single hash code is added to the sample used "
+             "to choose the split key of a tablet that is split because of its load. "
+             "0 disables sampling.");
+TAG_FLAG(tablet_key_access_sample_interval, advanced);
+TAG_FLAG(tablet_key_access_sample_interval, runtime);
+
+DEFINE_int32(tablet_hot_key_sample_interval, 0,
+             "Every Nth read or write addressing a single hash code is added to the sketch of the "
+             "most frequently accessed keys of the tablet. 0 disables hot key tracking.");
+TAG_FLAG(tablet_hot_key_sample_interval, advanced);
+TAG_FLAG(tablet_hot_key_sample_interval, runtime);
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+constexpr size_t kMaxSamples = 1024;
+constexpr size_t kHotKeySketchCapacity = 64;
+
+} // namespace
+
+TabletLoadTracker::TabletLoadTracker()
+    : read_hot_keys_(kHotKeySketchCapacity), write_hot_keys_(kHotKeySketchCapacity) {
+  samples_.reserve(kMaxSamples);
+}
+
+void TabletLoadTracker::Record(
+    std::atomic<uint64_t>* counter, bool has_hash_code, uint32_t hash_code) {
+  counter->fetch_add(1, std::memory_order_relaxed);
+  if (!has_hash_code) {
+    return;
+  }
+  const auto interval = FLAGS_tablet_key_access_sample_interval;
+  if (interval <= 0 ||
+      num_hashed_accesses_.fetch_add(1, std::memory_order_relaxed) % interval != 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (samples_.size() < kMaxSamples) {
+    samples_.push_back(static_cast<uint16_t>(hash_code));
+  } else {
+    samples_[next_sample_] = static_cast<uint16_t>(hash_code);
+    next_sample_ = (next_sample_ + 1) % kMaxSamples;
+  }
+}
+
+boost::optional<TabletLoad> TabletLoadTracker::UpdateAndGetLoad(
+    CoarseTimePoint now, CoarseDuration window) {
+  const auto num_reads = this->num_reads();
+  const auto num_writes = this->num_writes();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  snapshots_.push_back(CountersSnapshot{now, num_reads, num_writes});
+  // Keep the newest snapshot that is at least window old, it is the start of the window.
+  while (snapshots_.size() > 1 && now - snapshots_[1].time >= window) {
+    snapshots_.pop_front();
+  }
+  const auto& start = snapshots_.front();
+  const auto span = now - start.time;
+  if (span < window || span <= CoarseDuration::zero()) {
+    return boost::none;
+  }
+  const double seconds = std::chrono::duration<double>(span).count();
+  return TabletLoad{
+    .read_ops_per_sec = (num_reads - start.num_reads) / seconds,
+    .write_ops_per_sec = (num_writes - start.num_writes) / seconds,
+  };
+}
+
+boost::optional<uint16_t> TabletLoadTracker::SampledMedianHashCode(size_t min_samples) const {
+  std::vector<uint16_t> samples;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (samples_.empty() || samples_.size() < min_samples) {
+      return boost::none;
+    }
+    samples = samples_;
+  }
+  auto median = samples.begin() + samples.size() / 2;
+  std::nth_element(samples.begin(), median, samples.end());
+  return *median;
+}
+
+bool TabletLoadTracker::ShouldSampleHotKey() {
+  const auto interval = FLAGS_tablet_hot_key_sample_interval;
+  return interval > 0 &&
+         num_hot_key_candidates_.fetch_add(1, std::memory_order_relaxed) % interval == 0;
+}
+
+void TabletLoadTracker::RecordHotKey(bool write, const Slice& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  (write ? write_hot_keys_ : read_hot_keys_).Add(key);
+}
+
+std::vector<SpaceSavingSketch::Entry> TabletLoadTracker::TopHotKeys(
+    bool write, size_t max_keys) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return (write ? write_hot_keys_ : read_hot_keys_).Top(max_keys);
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,107 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_TABLET_LOAD_TRACKER_H
+#define YB_TABLET_TABLET_LOAD_TRACKER_H
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/space_saving_sketch.h"
+
+namespace yb {
+namespace tablet {
+
+struct TabletLoad {
+  double read_ops_per_sec = 0;
+  double write_ops_per_sec = 0;
+};
+
+// Counts reads and writes served by a tablet and keeps a sample of the hash codes they accessed.
+// The load is reported to the master in heartbeats, and the sample is used to choose the split
+// key that divides the load between the split tablets.
+// It also tracks the most frequently accessed keys for diagnostics of hot tablets.
+class TabletLoadTracker {
+ public:
+  TabletLoadTracker();
+
+  TabletLoadTracker(const TabletLoadTracker&) = delete;
+  void operator=(const TabletLoadTracker&) = delete;
+
+  // hash_code is ignored when the request does not address a single hash code.
+  void RecordRead(bool has_hash_code, uint32_t hash_code) {
+    Record(&num_reads_, has_hash_code, hash_code);
+  }
+
+  void RecordWrite(bool has_hash_code, uint32_t hash_code) {
+    Record(&num_writes_, has_hash_code, hash_code);
+  }
+
+  uint64_t num_reads() const {
+    return num_reads_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t num_writes() const {
+    return num_writes_.load(std::memory_order_relaxed);
+  }
+
+  // Remembers the current counters and returns average load over the last window.
+  // Returns none until the tracker has been updated for the whole window, so a short burst
+  // right after the tablet was opened does not look like sustained load.
+  boost::optional<TabletLoad> UpdateAndGetLoad(CoarseTimePoint now, CoarseDuration window);
+
+  // Returns the median of the sampled hash codes, or none if fewer than min_samples were taken.
+  boost::optional<uint16_t> SampledMedianHashCode(size_t min_samples) const;
+
+  // Returns true if the key of the current access should be passed to RecordHotKey.
+  bool ShouldSampleHotKey();
+
+  void RecordHotKey(bool write, const Slice& key);
+
+  // Returns up to max_keys most frequently sampled read or write keys.
+  std::vector<SpaceSavingSketch::Entry> TopHotKeys(bool write, size_t max_keys) const;
+
+ private:
+  void Record(std::atomic<uint64_t>* counter, bool has_hash_code, uint32_t hash_code);
+
+  struct CountersSnapshot {
+    CoarseTimePoint time;
+    uint64_t num_reads;
+    uint64_t num_writes;
+  };
+
+  std::atomic<uint64_t> num_reads_{0};
+  std::atomic<uint64_t> num_writes_{0};
+  std::atomic<uint64_t> num_hashed_accesses_{0};
+  std::atomic<uint64_t> num_hot_key_candidates_{0};
+
+  mutable std::mutex mutex_;
+  // Ring buffer of sampled hash codes.
+  std::vector<uint16_t> samples_ GUARDED_BY(mutex_);
+  size_t next_sample_ GUARDED_BY(mutex_) = 0;
+  std::deque<CountersSnapshot> snapshots_ GUARDED_BY(mutex_);
+  SpaceSavingSketch read_hot_keys_ GUARDED_BY(mutex_);
+  SpaceSavingSketch write_hot_keys_ GUARDED_BY(mutex_);
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_TABLET_LOAD_TRACKER_H
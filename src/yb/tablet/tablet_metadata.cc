@@ -71,6 +71,14 @@ TAG_FLAG(enable_tablet_orphaned_block_deletion, advanced);
 TAG_FLAG(enable_tablet_orphaned_block_deletion, hidden);
 TAG_FLAG(enable_tablet_orphaned_block_deletion, runtime);
 
+DEFINE_bool(remote_bootstrap_reuse_tombstoned_sst_files, false,
+            "Whether SST files of a tombstoned tablet are kept as hard links, so that a later "
+            "remote bootstrap of the tablet could reuse the files that did not change on the "
+            "leader instead of downloading them. The files use disk space until the tablet is "
+            "bootstrapped or deleted.");
+TAG_FLAG(remote_bootstrap_reuse_tombstoned_sst_files, advanced);
+TAG_FLAG(remote_bootstrap_reuse_tombstoned_sst_files, runtime);
+
 using std::shared_ptr;
 
 using base::subtle::Barrier_AtomicIncrement;
@@ -85,6 +93,32 @@ const int64 kNoDurableMemStore = -1;
 const std::string kIntentsSubdir = "intents";
 const std::string kIntentsDBSuffix = ".intents";
 const std::string kSnapshotsDirSuffix = ".snapshots";
+const std::string kReusableFilesDirSuffix = ".reusable";
+
+namespace {
+
+// Hard links SST files of the DB in db_dir to dest_dir, skipping files that already exist there
+// after a previous tombstone.
+Status LinkSstFiles(Env* env, const std::string& db_dir, const std::string& dest_dir) {
+  if (!env->FileExists(db_dir)) {
+    return Status::OK();
+  }
+  std::vector<std::string> files;
+  RETURN_NOT_OK(env->GetChildren(db_dir, ExcludeDots::kTrue, &files));
+  RETURN_NOT_OK(env->CreateDirs(dest_dir));
+  for (const auto& file : files) {
+    if (file.find(".sst") == std::string::npos) {
+      continue;
+    }
+    const auto dest_path = JoinPathSegments(dest_dir, file);
+    if (!env->FileExists(dest_path)) {
+      RETURN_NOT_OK(env->LinkFile(JoinPathSegments(db_dir, file), dest_path));
+    }
+  }
+  return Status::OK();
+}
+
+} // namespace
 
 // ============================================================================
 //  Raft group metadata
@@ -370,6 +404,26 @@ Status RaftGroupMetadata::DeleteTabletData(TabletDataState delete_type,
     }
   }
 
+  const auto reusable_files_dir = this->reusable_files_dir();
+  if (delete_type == TABLET_DATA_TOMBSTONED &&
+      FLAGS_remote_bootstrap_reuse_tombstoned_sst_files) {
+    Env* env = fs_manager_->env();
+    auto status = LinkSstFiles(env, rocksdb_dir(), reusable_files_dir);
+    if (status.ok()) {
+      status = LinkSstFiles(
+          env, intents_rocksdb_dir(), JoinPathSegments(reusable_files_dir, kIntentsSubdir));
+    }
+    if (status.ok()) {
+      LOG(INFO) << "Kept SST files for remote bootstrap at: " << reusable_files_dir;
+    } else {
+      LOG(WARNING) << "Failed to keep SST files for remote bootstrap at " << reusable_files_dir
+                   << ": " << status;
+    }
+  } else if (fs_manager_->env()->FileExists(reusable_files_dir)) {
+    auto s = fs_manager_->env()->DeleteRecursively(reusable_files_dir);
+    LOG_IF(WARNING, !s.ok()) << "Unable to delete reusable files directory " << reusable_files_dir;
+  }
+
   rocksdb::Options rocksdb_options;
   TabletOptions tablet_options;
   std::string log_prefix = consensus::MakeTabletLogPrefix(raft_group_id_, fs_manager_->uuid());
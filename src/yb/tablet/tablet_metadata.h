@@ -69,6 +69,7 @@ extern const int64 kNoDurableMemStore;
 extern const std::string kIntentsSubdir;
 extern const std::string kIntentsDBSuffix;
 extern const std::string kSnapshotsDirSuffix;
+extern const std::string kReusableFilesDirSuffix;
 
   // Table info.
 struct TableInfo {
@@ -329,6 +330,10 @@ class RaftGroupMetadata : public RefCountedThreadSafe<RaftGroupMetadata> {
   const std::string& rocksdb_dir() const { return kv_store_.rocksdb_dir; }
   std::string intents_rocksdb_dir() const { return kv_store_.rocksdb_dir + kIntentsDBSuffix; }
   std::string snapshots_dir() const { return kv_store_.rocksdb_dir + kSnapshotsDirSuffix; }
+  // SST files of the tombstoned tablet, that remote bootstrap could reuse instead of downloading.
+  std::string reusable_files_dir() const {
+    return kv_store_.rocksdb_dir + kReusableFilesDirSuffix;
+  }
 
   const std::string& lower_bound_key() const { return kv_store_.lower_bound_key; }
   const std::string& upper_bound_key() const { return kv_store_.upper_bound_key; }
@@ -32,9 +32,17 @@
 #include "yb/tablet/tablet_metrics.h"
 
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/walltime.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/metrics.h"
 #include "yb/util/trace.h"
 
+DEFINE_bool(tablet_cpu_time_accounting, false,
+            "Whether to charge the CPU time of serving reads and applying writes to the "
+            "read_cpu_time_us and write_cpu_time_us metrics of the tablet.");
+TAG_FLAG(tablet_cpu_time_accounting, runtime);
+TAG_FLAG(tablet_cpu_time_accounting, evolving);
+
 // Tablet-specific metrics.
 METRIC_DEFINE_counter(tablet, rows_inserted, "Rows Inserted",
     yb::MetricUnit::kRows,
@@ -102,6 +110,11 @@ METRIC_DEFINE_counter(tablet, majority_sst_files_rejections,
   yb::MetricUnit::kRequests,
   "Number of RPC requests rejected due to number of majority SST files.");
 
+METRIC_DEFINE_counter(tablet, write_backpressure_rejections,
+  "Write Backpressure Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of RPC requests rejected due to write backpressure of the tablet.");
+
 METRIC_DEFINE_counter(tablet, transaction_conflicts,
   "Distributed Transaction Conflicts",
   yb::MetricUnit::kRequests,
@@ -132,6 +145,32 @@ METRIC_DEFINE_counter(tablet, tablet_data_corruptions,
   yb::MetricUnit::kUnits,
   "Number of times this tablet was flagged for corrupted data");
 
+METRIC_DEFINE_gauge_int64(tablet, async_index_updates_in_flight,
+  "Asynchronous Index Updates In Flight",
+  yb::MetricUnit::kOperations,
+  "Number of index updates of this tablet that are applied asynchronously and not done yet.");
+
+METRIC_DEFINE_coarse_histogram(table, async_index_update_lag,
+  "Asynchronous Index Update Lag",
+  yb::MetricUnit::kMicroseconds,
+  "Time from the start of a base table write to the completion of its asynchronous index "
+  "updates.");
+
+METRIC_DEFINE_counter(tablet, async_index_update_failures,
+  "Asynchronous Index Update Failures",
+  yb::MetricUnit::kOperations,
+  "Number of asynchronous index updates that failed. The index may miss these updates.");
+
+METRIC_DEFINE_counter(tablet, read_cpu_time_us,
+  "Read CPU Time",
+  yb::MetricUnit::kMicroseconds,
+  "CPU time spent executing read requests of this tablet.");
+
+METRIC_DEFINE_counter(tablet, write_cpu_time_us,
+  "Write CPU Time",
+  yb::MetricUnit::kMicroseconds,
+  "CPU time spent preparing and applying write requests of this tablet.");
+
 using strings::Substitute;
 
 namespace yb {
@@ -148,13 +187,20 @@ TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& table_entity,
     MINIT(tablet_entity, not_leader_rejections),
     MINIT(tablet_entity, leader_memory_pressure_rejections),
     MINIT(tablet_entity, majority_sst_files_rejections),
+    MINIT(tablet_entity, write_backpressure_rejections),
     MINIT(tablet_entity, transaction_conflicts),
     MINIT(tablet_entity, expired_transactions),
     MINIT(tablet_entity, restart_read_requests),
     MINIT(tablet_entity, consistent_prefix_read_requests),
     MINIT(tablet_entity, pgsql_consistent_prefix_read_rows),
     MINIT(tablet_entity, tablet_data_corruptions),
-    MINIT(tablet_entity, rows_inserted) {
+    MINIT(tablet_entity, rows_inserted),
+    async_index_updates_in_flight(
+        METRIC_async_index_updates_in_flight.Instantiate(tablet_entity, 0)),
+    MINIT(table_entity, async_index_update_lag),
+    MINIT(tablet_entity, async_index_update_failures),
+    MINIT(tablet_entity, read_cpu_time_us),
+    MINIT(tablet_entity, write_cpu_time_us) {
 }
 #undef MINIT
 
@@ -164,5 +210,18 @@ ScopedTabletMetricsTracker::ScopedTabletMetricsTracker(scoped_refptr<Histogram>
 ScopedTabletMetricsTracker::~ScopedTabletMetricsTracker() {
   latency_->Increment(MonoTime::Now().GetDeltaSince(start_time_).ToMicroseconds());
 }
+
+ScopedTabletCpuTimeTracker::ScopedTabletCpuTimeTracker(const scoped_refptr<Counter>& counter)
+    : counter_(FLAGS_tablet_cpu_time_accounting ? counter : scoped_refptr<Counter>()) {
+  if (counter_) {
+    start_us_ = GetThreadCpuTimeMicros();
+  }
+}
+
+ScopedTabletCpuTimeTracker::~ScopedTabletCpuTimeTracker() {
+  if (counter_) {
+    counter_->IncrementBy(GetThreadCpuTimeMicros() - start_us_);
+  }
+}
 } // namespace tablet
 } // namespace yb
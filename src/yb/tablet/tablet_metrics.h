@@ -64,6 +64,7 @@ struct TabletMetrics {
   scoped_refptr<Counter> not_leader_rejections;
   scoped_refptr<Counter> leader_memory_pressure_rejections;
   scoped_refptr<Counter> majority_sst_files_rejections;
+  scoped_refptr<Counter> write_backpressure_rejections;
   scoped_refptr<Counter> transaction_conflicts;
   scoped_refptr<Counter> expired_transactions;
   scoped_refptr<Counter> restart_read_requests;
@@ -72,6 +73,13 @@ struct TabletMetrics {
   scoped_refptr<Counter> tablet_data_corruptions;
 
   scoped_refptr<Counter> rows_inserted;
+
+  scoped_refptr<AtomicGauge<int64_t>> async_index_updates_in_flight;
+  scoped_refptr<Histogram> async_index_update_lag;
+  scoped_refptr<Counter> async_index_update_failures;
+
+  scoped_refptr<Counter> read_cpu_time_us;
+  scoped_refptr<Counter> write_cpu_time_us;
 };
 
 class ScopedTabletMetricsTracker {
@@ -84,6 +92,20 @@ class ScopedTabletMetricsTracker {
   MonoTime start_time_;
 };
 
+// Adds the CPU time spent by the current thread during its lifetime to the counter, when
+// --tablet_cpu_time_accounting is set.
+class ScopedTabletCpuTimeTracker {
+ public:
+  explicit ScopedTabletCpuTimeTracker(const scoped_refptr<Counter>& counter);
+  ~ScopedTabletCpuTimeTracker();
+
+ private:
+  scoped_refptr<Counter> counter_;
+  int64_t start_us_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedTabletCpuTimeTracker);
+};
+
 } // namespace tablet
 } // namespace yb
 #endif /* YB_TABLET_TABLET_METRICS_H */
@@ -31,6 +31,7 @@ namespace rocksdb {
 class Cache;
 class EventListener;
 class MemoryMonitor;
+class PersistentCache;
 class Env;
 }
 
@@ -45,10 +46,17 @@ YB_STRONGLY_TYPED_BOOL(IsDropTable);
 
 struct TabletOptions {
   std::shared_ptr<rocksdb::Cache> block_cache;
+  // Compressed tier of the block cache, looked up on block cache misses before reading from disk.
+  std::shared_ptr<rocksdb::Cache> compressed_block_cache;
+  std::shared_ptr<rocksdb::PersistentCache> persistent_cache;
+  // Cache of SST file readers shared by the regular and intents DBs of all tablets.
+  std::shared_ptr<rocksdb::Cache> table_reader_cache;
   std::shared_ptr<rocksdb::MemoryMonitor> memory_monitor;
   std::vector<std::shared_ptr<rocksdb::EventListener>> listeners;
   yb::Env* env = Env::Default();
   rocksdb::Env* rocksdb_env = rocksdb::Env::Default();
+  // Don't read table properties of SST files to update statistics when RocksDB is opened.
+  bool skip_stats_update_on_db_open = false;
 };
 
 struct TabletInitData {
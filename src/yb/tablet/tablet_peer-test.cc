@@ -173,6 +173,7 @@ class TabletPeerTest : public YBTabletTest {
                                            tablet_metric_entity_,
                                            raft_pool_.get(),
                                            tablet_prepare_pool_.get(),
+                                           nullptr /* raft_apply_pool */,
                                            nullptr /* retryable_requests */));
   }
 
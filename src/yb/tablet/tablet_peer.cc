@@ -74,6 +74,7 @@
 
 #include "yb/tablet/operations/change_metadata_operation.h"
 #include "yb/tablet/operations/history_cutoff_operation.h"
+#include "yb/tablet/operations/import_data_operation.h"
 #include "yb/tablet/operations/operation_driver.h"
 #include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
@@ -187,6 +188,7 @@ Status TabletPeer::InitTabletPeer(
     const scoped_refptr<MetricEntity>& tablet_metric_entity,
     ThreadPool* raft_pool,
     ThreadPool* tablet_prepare_pool,
+    ThreadPool* raft_apply_pool,
     consensus::RetryableRequests* retryable_requests) {
   DCHECK(tablet) << "A TabletPeer must be provided with a Tablet";
   DCHECK(log) << "A TabletPeer must be provided with a Log";
@@ -268,6 +270,7 @@ Status TabletPeer::InitTabletPeer(
         mark_dirty_clbk_,
         tablet_->table_type(),
         raft_pool,
+        raft_apply_pool,
         retryable_requests);
     has_consensus_.store(true, std::memory_order_release);
 
@@ -275,7 +278,8 @@ Status TabletPeer::InitTabletPeer(
     operation_tracker_.SetPostTracker(
         std::bind(&RaftConsensus::TrackOperationMemory, consensus_.get(), _1));
 
-    prepare_thread_ = std::make_unique<Preparer>(consensus_.get(), tablet_prepare_pool);
+    prepare_thread_ = std::make_unique<Preparer>(
+        consensus_.get(), tablet_prepare_pool, tablet_->GetTabletMetricsEntity());
 
     ChangeConfigReplicated(RaftConfig()); // Set initial flag value.
   }
@@ -770,6 +774,9 @@ consensus::OperationType MapOperationTypeToPB(OperationType operation_type) {
     case OperationType::kSplit:
       return consensus::SPLIT_OP;
 
+    case OperationType::kImportData:
+      return consensus::IMPORT_DATA_OP;
+
     case OperationType::kEmpty:
       LOG(FATAL) << "OperationType::kEmpty cannot be converted to consensus::OperationType";
   }
@@ -1008,6 +1015,11 @@ std::unique_ptr<Operation> TabletPeer::CreateOperation(consensus::ReplicateMsg*
           " operation must receive an SplitOpRequestPB";
       return std::make_unique<SplitOperation>(tablet(), tablet_splitter_);
 
+    case consensus::IMPORT_DATA_OP:
+      DCHECK(replicate_msg->has_import_data_request()) << "IMPORT_DATA_OP replica"
+          " operation must receive an ImportDataRequestPB";
+      return std::make_unique<ImportDataOperation>(tablet());
+
     case consensus::UNKNOWN_OP: FALLTHROUGH_INTENDED;
     case consensus::NO_OP: FALLTHROUGH_INTENDED;
     case consensus::CHANGE_CONFIG_OP:
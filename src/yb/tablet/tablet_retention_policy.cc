@@ -80,10 +80,18 @@ HistoryRetentionDirective TabletRetentionPolicy::GetRetentionDirective() {
     }
   }
 
+  const auto schema = metadata_.schema();
+  const auto time_window_seconds = schema->table_properties().compaction_time_window_seconds();
+  MonoDelta compaction_time_window;
+  if (time_window_seconds != 0) {
+    compaction_time_window = MonoDelta::FromSeconds(time_window_seconds);
+  }
+
   return {history_cutoff, std::move(deleted_before_history_cutoff),
-          TableTTL(*metadata_.schema()),
+          TableTTL(*schema),
           docdb::ShouldRetainDeleteMarkersInMajorCompaction(
-              ShouldRetainDeleteMarkersInMajorCompaction())};
+              ShouldRetainDeleteMarkersInMajorCompaction()),
+          compaction_time_window};
 }
 
 Status TabletRetentionPolicy::RegisterReaderTimestamp(HybridTime timestamp) {
@@ -19,6 +19,7 @@
 
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/value_log.h"
 
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/util/file_util.h"
@@ -29,12 +30,20 @@
 #include "yb/tablet/tablet_metadata.h"
 #include "yb/tablet/operations/snapshot_operation.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/operation_counter.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/trace.h"
 
 using namespace std::literals;
 
+DEFINE_bool(tablet_snapshot_write_files_manifest, false,
+            "When set, every tablet snapshot directory gets a manifest listing the path and size "
+            "of each of its files. SST files are immutable and hard-linked into snapshots, so "
+            "backup tooling can skip files already listed in an earlier snapshot of the tablet.");
+TAG_FLAG(tablet_snapshot_write_files_manifest, advanced);
+TAG_FLAG(tablet_snapshot_write_files_manifest, runtime);
+
 namespace yb {
 namespace tablet {
 
@@ -44,6 +53,8 @@ const std::string kTempSnapshotDirSuffix = ".tmp";
 
 } // namespace
 
+const std::string TabletSnapshots::kSnapshotFilesManifest = "SNAPSHOT_FILES";
+
 struct TabletSnapshots::RestoreMetadata {
   boost::optional<Schema> schema;
   boost::optional<IndexMap> index_map;
@@ -155,6 +166,12 @@ Status TabletSnapshots::Create(const CreateSnapshotData& data) {
     RETURN_NOT_OK(patcher.SetHybridTimeFilter(snapshot_hybrid_time));
   }
 
+  if (GetAtomicFlag(&FLAGS_tablet_snapshot_write_files_manifest)) {
+    RETURN_NOT_OK_PREPEND(
+        WriteFilesManifest(tmp_snapshot_dir),
+        Format("Cannot write files manifest to $0", tmp_snapshot_dir));
+  }
+
   RETURN_NOT_OK_PREPEND(
       env->RenameFile(tmp_snapshot_dir, snapshot_dir),
       Format("Cannot rename temp snapshot dir $0 to $1", tmp_snapshot_dir, snapshot_dir));
@@ -173,6 +190,28 @@ Status TabletSnapshots::Create(const CreateSnapshotData& data) {
   return Status::OK();
 }
 
+Status TabletSnapshots::WriteFilesManifest(const std::string& dir) {
+  std::string manifest;
+  std::vector<std::string> pending_dirs = {""};
+  while (!pending_dirs.empty()) {
+    const auto relative_dir = std::move(pending_dirs.back());
+    pending_dirs.pop_back();
+    const auto absolute_dir = JoinPathSegments(dir, relative_dir);
+    for (const auto& child : VERIFY_RESULT(env().GetChildren(absolute_dir, ExcludeDots::kTrue))) {
+      const auto relative_path =
+          relative_dir.empty() ? child : JoinPathSegments(relative_dir, child);
+      const auto absolute_path = JoinPathSegments(dir, relative_path);
+      if (VERIFY_RESULT(env().IsDirectory(absolute_path))) {
+        pending_dirs.push_back(relative_path);
+        continue;
+      }
+      const auto size = VERIFY_RESULT(env().GetFileSize(absolute_path));
+      manifest += Format("$0\t$1\n", relative_path, size);
+    }
+  }
+  return WriteStringToFileSync(&env(), manifest, JoinPathSegments(dir, kSnapshotFilesManifest));
+}
+
 Env& TabletSnapshots::env() {
   return *metadata().fs_manager()->env();
 }
@@ -263,6 +302,10 @@ Status TabletSnapshots::RestoreCheckpoint(
       LOG_WITH_PREFIX(WARNING) << "Copy checkpoint files status: " << s;
       return STATUS(IllegalState, "Unable to copy checkpoint files", s.ToString());
     }
+    const auto manifest_path = JoinPathSegments(db_dir, kSnapshotFilesManifest);
+    if (env().FileExists(manifest_path)) {
+      RETURN_NOT_OK(env().DeleteFile(manifest_path));
+    }
   }
 
   {
@@ -390,6 +433,14 @@ Status TabletSnapshots::CreateCheckpoint(
   RETURN_NOT_OK_PREPEND(metadata().fs_manager()->CreateDirIfMissing(parent_dir),
                         Format("Unable to create checkpoints directory $0", parent_dir));
 
+  // Value log files referenced by SST files of the checkpoint should not be deleted before they
+  // are linked to the checkpoint.
+  auto* value_log = tablet().value_log();
+  std::unique_lock<std::mutex> value_log_deletions_lock;
+  if (value_log) {
+    value_log_deletions_lock = value_log->LockFileDeletions();
+  }
+
   // Order does not matter because we flush both DBs and does not have parallel writes.
   Status status;
   if (has_intents_db()) {
@@ -398,6 +449,9 @@ Status TabletSnapshots::CreateCheckpoint(
   if (status.ok()) {
     status = rocksdb::checkpoint::CreateCheckpoint(&regular_db(), dir);
   }
+  if (status.ok() && value_log) {
+    status = value_log->LinkFiles(dir);
+  }
   if (status.ok() && has_intents_db() &&
       create_intents_checkpoint_in == CreateIntentsCheckpointIn::kUseIntentsDbSuffix) {
     status = Env::Default()->RenameFile(temp_intents_dir, final_intents_dir);
@@ -86,6 +86,9 @@ class TabletSnapshots : public TabletComponent {
 
   static bool IsTempSnapshotDir(const std::string& dir);
 
+  // Name of the file listing the files of a snapshot, see tablet_snapshot_write_files_manifest.
+  static const std::string kSnapshotFilesManifest;
+
  private:
   struct RestoreMetadata;
 
@@ -99,6 +102,11 @@ class TabletSnapshots : public TabletComponent {
   CHECKED_STATUS Apply(SnapshotOperation* operation);
 
   CHECKED_STATUS CleanupSnapshotDir(const std::string& dir);
+
+  // Writes kSnapshotFilesManifest into the snapshot directory, listing every file of the snapshot
+  // with its size.
+  CHECKED_STATUS WriteFilesManifest(const std::string& dir);
+
   Env& env();
 
   std::string TEST_last_rocksdb_checkpoint_dir_;
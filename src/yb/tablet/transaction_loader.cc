@@ -42,11 +42,13 @@ namespace tablet {
 
 namespace {
 
-docdb::BoundedRocksDbIterator CreateFullScanIterator(rocksdb::DB* db) {
+docdb::BoundedRocksDbIterator CreateFullScanIterator(
+    rocksdb::DB* db, docdb::ValueLog* value_log = nullptr) {
   return docdb::BoundedRocksDbIterator(docdb::CreateRocksDBIterator(
       db, &docdb::KeyBounds::kNoBounds,
       docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
-      /* user_key_for_filter= */ boost::none, rocksdb::kDefaultQueryId));
+      /* user_key_for_filter= */ boost::none, rocksdb::kDefaultQueryId,
+      /* file_filter= */ nullptr, /* iterate_upper_bound= */ nullptr, value_log));
 }
 
 } // namespace
@@ -65,7 +67,7 @@ class TransactionLoader::Executor {
     if (!scoped_pending_operation_.ok()) {
       return false;
     }
-    regular_iterator_ = CreateFullScanIterator(db.regular);
+    regular_iterator_ = CreateFullScanIterator(db.regular, db.value_log);
     intents_iterator_ = CreateFullScanIterator(db.intents);
     auto& load_thread = loader_.load_thread_;
     load_thread = std::thread(&Executor::Execute, this);
@@ -38,10 +38,12 @@
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/transaction_dump.h"
+#include "yb/docdb/transaction_status_cache.h"
 
 #include "yb/rpc/poller.h"
 #include "yb/rpc/rpc.h"
 #include "yb/rpc/rpc_context.h"
+#include "yb/rpc/scheduler.h"
 #include "yb/rpc/thread_pool.h"
 
 #include "yb/tablet/cleanup_aborts_task.h"
@@ -92,6 +94,10 @@ DEFINE_uint64(max_transactions_in_status_request, 128,
 
 DEFINE_uint64(transactions_cleanup_cache_size, 64, "Transactions cleanup cache size.");
 
+DEFINE_uint64(transactions_shared_status_cache_size, 1024,
+              "Number of committed transactions, whose commit times are cached at tablet level and "
+              "shared between reads. Zero disables the cache.");
+
 DEFINE_uint64(transactions_status_poll_interval_ms, 500 * yb::kTimeMultiplier,
               "Transactions poll interval.");
 
@@ -113,6 +119,30 @@ namespace {
 
 YB_STRONGLY_TYPED_BOOL(PostApplyCleanup);
 
+// Operation waiting for a running transaction, see WaitForTransactionDone.
+// Could be woken by removal of the transaction and by deadline, callback is invoked only once.
+class TransactionWaiter {
+ public:
+  explicit TransactionWaiter(TransactionWaitCallback callback) : callback_(std::move(callback)) {}
+
+  void Wake(const Status& status) {
+    bool expected = false;
+    if (woken_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+      callback_(status);
+    }
+  }
+
+  bool woken() const {
+    return woken_.load(std::memory_order_acquire);
+  }
+
+ private:
+  TransactionWaitCallback callback_;
+  std::atomic<bool> woken_{false};
+};
+
+typedef std::shared_ptr<TransactionWaiter> TransactionWaiterPtr;
+
 } // namespace
 
 std::string TransactionApplyData::ToString() const {
@@ -127,6 +157,7 @@ class TransactionParticipant::Impl
        const scoped_refptr<MetricEntity>& entity)
       : RunningTransactionContext(context, applier),
         log_prefix_(context->LogPrefix()),
+        shared_status_cache_(FLAGS_transactions_shared_status_cache_size, entity),
         loader_(this, entity),
         poller_(log_prefix_, std::bind(&Impl::Poll, this)) {
     LOG_WITH_PREFIX(INFO) << "Create";
@@ -163,12 +194,18 @@ class TransactionParticipant::Impl
     LOG_IF_WITH_PREFIX(DFATAL, !closing_.load()) << __func__ << " w/o StartShutdown";
 
     decltype(status_resolvers_) status_resolvers;
+    decltype(waiters_) waiters;
     {
       MinRunningNotifier min_running_notifier(nullptr /* applier */);
       std::lock_guard<std::mutex> lock(mutex_);
       transactions_.clear();
       TransactionsModifiedUnlocked(&min_running_notifier);
       status_resolvers.swap(status_resolvers_);
+      waiters.swap(waiters_);
+    }
+
+    for (auto& id_and_waiter : waiters) {
+      id_and_waiter.second->Wake(STATUS(Aborted, "Transaction participant shutdown"));
     }
 
     rpcs_.Shutdown();
@@ -227,6 +264,51 @@ class TransactionParticipant::Impl
     return true;
   }
 
+  docdb::SharedTransactionStatusCache* shared_status_cache() {
+    return &shared_status_cache_;
+  }
+
+  bool WaitForTransactionDone(
+      const TransactionId& id, CoarseTimePoint deadline, TransactionWaitCallback callback) {
+    auto waiter = std::make_shared<TransactionWaiter>(std::move(callback));
+    bool running;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running = !Closing() && transactions_.find(id) != transactions_.end();
+      if (running) {
+        waiters_.emplace(id, waiter);
+      }
+    }
+    if (!running) {
+      ScheduleWake(waiter);
+      return true;
+    }
+    auto delay = std::max<CoarseMonoClock::Duration>(
+        deadline - CoarseMonoClock::now(), CoarseMonoClock::Duration::zero());
+    participant_context_.scheduler().Schedule(
+        [waiter](const Status& status) {
+          // Aborted status means that scheduler was shut down, the waiter is woken by
+          // CompleteShutdown in this case. The woken waiter is erased from waiters_ by Poll.
+          if (!status.IsAborted()) {
+            waiter->Wake(Status::OK());
+          }
+        },
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay));
+    return true;
+  }
+
+  bool ScheduleRetry(CoarseDuration delay, TransactionWaitCallback callback) {
+    if (Closing()) {
+      return false;
+    }
+    participant_context_.scheduler().Schedule(
+        [callback = std::move(callback)](const Status& status) {
+          callback(status);
+        },
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay));
+    return true;
+  }
+
   HybridTime LocalCommitTime(const TransactionId& id) {
     std::lock_guard<std::mutex> lock(mutex_);
     auto it = transactions_.find(id);
@@ -1251,10 +1333,43 @@ class TransactionParticipant::Impl
     LOG_IF_WITH_PREFIX(DFATAL, !recently_removed_transactions_.insert(transaction.id()).second)
         << "Transaction removed twice: " << transaction.id();
     VLOG_WITH_PREFIX(4) << "Remove transaction: " << transaction.id();
+    shared_status_cache_.Erase(transaction.id());
+    WakeWaitersUnlocked(transaction.id());
     transactions_.erase(it);
     TransactionsModifiedUnlocked(min_running_notifier);
   }
 
+  // Wakes operations waiting for the specified transaction. Waiters are resumed through the
+  // scheduler, since they resolve conflicts again and should not do it under mutex_.
+  void WakeWaitersUnlocked(const TransactionId& id) REQUIRES(mutex_) {
+    auto range = waiters_.equal_range(id);
+    for (auto it = range.first; it != range.second; ++it) {
+      ScheduleWake(it->second);
+    }
+    waiters_.erase(range.first, range.second);
+  }
+
+  // Wakes the waiter on the scheduler thread, so its callback is never invoked by the caller
+  // itself, that could hold mutex_ or be in the middle of conflict resolution.
+  void ScheduleWake(const TransactionWaiterPtr& waiter) {
+    participant_context_.scheduler().Schedule(
+        [waiter](const Status& status) {
+          waiter->Wake(status.IsAborted() ? status : Status::OK());
+        },
+        std::chrono::steady_clock::duration::zero());
+  }
+
+  // Erases waiters that were woken by deadline, while their transactions are still running.
+  void CleanupWaitersUnlocked() REQUIRES(mutex_) {
+    for (auto it = waiters_.begin(); it != waiters_.end();) {
+      if (it->second->woken()) {
+        it = waiters_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
   void CleanupRecentlyRemovedTransactions(CoarseTimePoint now) {
     while (!recently_removed_transactions_cleanup_queue_.empty() &&
            recently_removed_transactions_cleanup_queue_.front().time <= now) {
@@ -1381,6 +1496,7 @@ class TransactionParticipant::Impl
       std::lock_guard<std::mutex> lock(mutex_);
 
       ProcessRemoveQueueUnlocked(&min_running_notifier);
+      CleanupWaitersUnlocked();
       if (ANNOTATE_UNPROTECTED_READ(FLAGS_transactions_poll_check_aborted)) {
         CheckForAbortedTransactions();
       }
@@ -1511,12 +1627,18 @@ class TransactionParticipant::Impl
   };
   std::deque<RecentlyRemovedTransaction> recently_removed_transactions_cleanup_queue_;
 
+  // Operations waiting for running transactions to be applied or removed.
+  std::unordered_multimap<TransactionId, TransactionWaiterPtr, TransactionIdHash> waiters_
+      GUARDED_BY(mutex_);
+
   std::mutex status_resolvers_mutex_;
   std::deque<TransactionStatusResolver> status_resolvers_ GUARDED_BY(status_resolvers_mutex_);
 
   scoped_refptr<AtomicGauge<uint64_t>> metric_transactions_running_;
   scoped_refptr<Counter> metric_transaction_not_found_;
 
+  docdb::SharedTransactionStatusCache shared_status_cache_;
+
   TransactionLoader loader_;
   std::atomic<bool> closing_{false};
   CountDownLatch start_latch_{1};
@@ -1684,6 +1806,20 @@ void TransactionParticipant::IgnoreAllTransactionsStartedBefore(HybridTime limit
   impl_->IgnoreAllTransactionsStartedBefore(limit);
 }
 
+docdb::SharedTransactionStatusCache* TransactionParticipant::shared_status_cache() {
+  return impl_->shared_status_cache();
+}
+
+bool TransactionParticipant::WaitForTransactionDone(
+    const TransactionId& id, CoarseTimePoint deadline, TransactionWaitCallback callback) {
+  return impl_->WaitForTransactionDone(id, deadline, std::move(callback));
+}
+
+bool TransactionParticipant::ScheduleRetry(
+    CoarseDuration delay, TransactionWaitCallback callback) {
+  return impl_->ScheduleRetry(delay, std::move(callback));
+}
+
 const TabletId& TransactionParticipant::tablet_id() const {
   return impl_->participant_context()->tablet_id();
 }
@@ -95,6 +95,10 @@ class TransactionIntentApplier {
 
   virtual Result<HybridTime> ApplierSafeTime(HybridTime min_allowed, CoarseTimePoint deadline) = 0;
 
+  // Returns false when the regular RocksDB is under write pressure, so a large transaction should
+  // postpone applying its next batch of intents.
+  virtual bool ShouldApplyIntentsBatch() = 0;
+
   // See TransactionParticipant::WaitMinRunningHybridTime below
   virtual void MinRunningHybridTimeSatisfied() = 0;
 
@@ -221,6 +225,14 @@ class TransactionParticipant : public TransactionStatusManager {
 
   Result<HybridTime> WaitForSafeTime(HybridTime safe_time, CoarseTimePoint deadline) override;
 
+  docdb::SharedTransactionStatusCache* shared_status_cache() override;
+
+  bool WaitForTransactionDone(
+      const TransactionId& id, CoarseTimePoint deadline,
+      TransactionWaitCallback callback) override;
+
+  bool ScheduleRetry(CoarseDuration delay, TransactionWaitCallback callback) override;
+
   // When minimal start hybrid time of running transaction will be at least `ht` applier
   // method `MinRunningHybridTimeSatisfied` will be invoked.
   void WaitMinRunningHybridTime(HybridTime ht);
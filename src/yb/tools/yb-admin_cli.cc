@@ -371,6 +371,29 @@ void ClusterAdminCli::RegisterCommandHandlers(ClusterAdminClientClass* client) {
         return Status::OK();
       });
 
+  Register(
+      "import_data",
+      " <table> <source_root>",
+      [client](const CLIArguments& args) -> Status {
+        std::string source_root;
+        const auto table_name = VERIFY_RESULT(ResolveSingleTableName(
+            client, args.begin(), args.end(),
+            [&source_root](auto i, const auto& end) -> Status {
+              if (std::next(i) == end) {
+                source_root = *i;
+                return Status::OK();
+              }
+              return ClusterAdminCli::kInvalidArguments;
+            }));
+        if (source_root.empty()) {
+          return ClusterAdminCli::kInvalidArguments;
+        }
+        RETURN_NOT_OK_PREPEND(
+            client->ImportData(table_name, source_root),
+            Substitute("Unable to import data into table $0", table_name.ToString()));
+        return Status::OK();
+      });
+
   static const auto kTableName = "<(<keyspace> <table_name>)|tableid.<table_id>>";
   static const auto kPlacementInfo = "placement_info";
   static const auto kReplicationFactor = "replication_factor";
@@ -703,6 +726,25 @@ void ClusterAdminCli::RegisterCommandHandlers(ClusterAdminClientClass* client) {
         return Status::OK();
       });
 
+  Register(
+      "list_tablet_hot_keys", " <tablet_id> [max_keys]",
+      [client](const CLIArguments& args) -> Status {
+        if (args.size() < 1 || args.size() > 2) {
+          return ClusterAdminCli::kInvalidArguments;
+        }
+        const string& tablet_id = args[0];
+        int max_keys = 10;
+        if (args.size() > 1) {
+          max_keys = VERIFY_RESULT(CheckedStoi(args[1]));
+          if (max_keys <= 0) {
+            return ClusterAdminCli::kInvalidArguments;
+          }
+        }
+        RETURN_NOT_OK_PREPEND(client->ListTabletHotKeys(tablet_id, max_keys),
+                              Substitute("Unable to list hot keys of tablet $0", tablet_id));
+        return Status::OK();
+      });
+
   Register(
       "set_load_balancer_enabled", " <0|1>",
       [client](const CLIArguments& args) -> Status {
@@ -56,6 +56,8 @@
 #include "yb/master/sys_catalog.h"
 #include "yb/rpc/messenger.h"
 
+#include "yb/util/countdown_latch.h"
+#include "yb/util/path_util.h"
 #include "yb/util/string_case.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/string_util.h"
@@ -1224,6 +1226,63 @@ Status ClusterAdminClient::ListTablets(const YBTableName& table_name, int max_ta
   return Status::OK();
 }
 
+Status ClusterAdminClient::ImportData(
+    const YBTableName& table_name, const std::string& source_root) {
+  vector<string> tablet_ids, ranges;
+  std::vector<master::TabletLocationsPB> locations;
+  RETURN_NOT_OK(yb_client_->GetTablets(
+      table_name, 0 /* max_tablets */, &tablet_ids, &ranges, &locations));
+
+  struct TabletImport {
+    std::unique_ptr<TabletServerServiceProxy> proxy;
+    tserver::ImportDataRequestPB req;
+    tserver::ImportDataResponsePB resp;
+    rpc::RpcController controller;
+  };
+  std::vector<TabletImport> imports(tablet_ids.size());
+  for (size_t i = 0; i != tablet_ids.size(); ++i) {
+    auto& import = imports[i];
+    for (const auto& replica : locations[i].replicas()) {
+      if (replica.role() == RaftPeerPB::LEADER) {
+        import.proxy = std::make_unique<TabletServerServiceProxy>(
+            proxy_cache_.get(), HostPortFromPB(replica.ts_info().private_rpc_addresses(0)));
+        break;
+      }
+    }
+    if (!import.proxy) {
+      return STATUS_FORMAT(NotFound, "No leader found for tablet $0", tablet_ids[i]);
+    }
+    import.req.set_tablet_id(tablet_ids[i]);
+    import.req.set_source_dir(JoinPathSegments(source_root, tablet_ids[i]));
+    import.req.set_replicated(true);
+    import.controller.set_timeout(timeout_);
+  }
+
+  // Tablets are imported independently, so all requests are sent at once.
+  CountDownLatch latch(imports.size());
+  for (auto& import : imports) {
+    import.proxy->ImportDataAsync(
+        import.req, &import.resp, &import.controller, [&latch] { latch.CountDown(); });
+  }
+  latch.Wait();
+
+  Status result;
+  for (auto& import : imports) {
+    auto status = import.controller.status();
+    if (status.ok() && import.resp.has_error()) {
+      status = StatusFromPB(import.resp.error().status());
+    }
+    if (!status.ok()) {
+      LOG(ERROR) << "Failed to import data into tablet " << import.req.tablet_id() << ": "
+                 << status;
+      result = status;
+    } else {
+      cout << "Imported data into tablet " << import.req.tablet_id() << endl;
+    }
+  }
+  return result;
+}
+
 Status ClusterAdminClient::LaunchBackfillIndexForTable(const YBTableName& table_name) {
   master::LaunchBackfillIndexForTableRequestPB req;
   table_name.SetIntoTableIdentifierPB(req.mutable_table_identifier());
@@ -1272,6 +1331,40 @@ Status ClusterAdminClient::ListPerTabletTabletServers(const TabletId& tablet_id)
   return Status::OK();
 }
 
+Status ClusterAdminClient::ListTabletHotKeys(const TabletId& tablet_id, int max_keys) {
+  master::GetTabletLocationsRequestPB locations_req;
+  locations_req.add_tablet_ids(tablet_id);
+  const auto locations_resp = VERIFY_RESULT(InvokeRpc(&MasterServiceProxy::GetTabletLocations,
+      master_proxy_.get(), locations_req));
+  if (locations_resp.tablet_locations_size() != 1) {
+    return STATUS_FORMAT(IllegalState,
+                         "Incorrect number of locations $0 for tablet $1.",
+                         locations_resp.tablet_locations_size(), tablet_id);
+  }
+
+  tserver::GetTabletHotKeysRequestPB req;
+  req.set_tablet_id(tablet_id);
+  req.set_max_keys(max_keys);
+  for (const auto& replica : locations_resp.tablet_locations(0).replicas()) {
+    TabletServerServiceProxy ts_proxy(
+        proxy_cache_.get(), HostPortFromPB(replica.ts_info().private_rpc_addresses(0)));
+    const auto resp = VERIFY_RESULT(InvokeRpc(&TabletServerServiceProxy::GetTabletHotKeys,
+        &ts_proxy, req));
+
+    cout << "Server " << replica.ts_info().permanent_uuid() << " ("
+         << PBEnumToString(replica.role()) << ")" << endl;
+    for (bool write : {false, true}) {
+      const auto& keys = write ? resp.write_keys() : resp.read_keys();
+      cout << "  " << (write ? "Writes" : "Reads") << ":" << endl;
+      for (const auto& key : keys) {
+        cout << "    " << key.count() << " (max overestimate " << key.error() << ")" << kColumnSep
+             << key.key() << endl;
+      }
+    }
+  }
+  return Status::OK();
+}
+
 Status ClusterAdminClient::DeleteTable(const YBTableName& table_name) {
   RETURN_NOT_OK(yb_client_->DeleteTable(table_name));
   cout << "Deleted table " << table_name.ToString() << endl;
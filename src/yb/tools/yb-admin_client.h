@@ -133,6 +133,10 @@ class ClusterAdminClient {
   // List all tablets of this table
   CHECKED_STATUS ListTablets(const client::YBTableName& table_name, int max_tablets);
 
+  // Imports RocksDB files into all tablets of the table in parallel, replicated through Raft.
+  // Files of a tablet should be staged at <source_root>/<tablet_id> on every its replica.
+  CHECKED_STATUS ImportData(const client::YBTableName& table_name, const std::string& source_root);
+
   // Per Tablet list of all tablet servers
   CHECKED_STATUS ListPerTabletTabletServers(const PeerId& tablet_id);
 
@@ -169,6 +173,9 @@ class ClusterAdminClient {
   // List all the tablets a certain tablet server is serving
   CHECKED_STATUS ListTabletsForTabletServer(const PeerId& ts_uuid);
 
+  // List the most frequently accessed keys of a tablet at each of its replicas.
+  CHECKED_STATUS ListTabletHotKeys(const TabletId& tablet_id, int max_keys);
+
   CHECKED_STATUS SetLoadBalancerEnabled(bool is_enabled);
 
   CHECKED_STATUS GetLoadBalancerState();
@@ -290,6 +290,7 @@ Status Heartbeater::Thread::ConnectToMaster() {
 
   // Reset report state if we have master failover.
   sending_full_report_ = false;
+  server_->tablet_manager()->ResetReportedConsensusStates();
 
   // Pings are common for both Master and Tserver.
   auto new_proxy = std::make_unique<server::GenericServiceProxy>(
@@ -184,6 +184,25 @@ Status RemoteBootstrapClient::SetTabletToReplace(const RaftGroupMetadataPtr& met
   return Status::OK();
 }
 
+Status RemoteBootstrapClient::ListReusableFiles(
+    const std::string& dir, const std::string& prefix,
+    google::protobuf::RepeatedPtrField<tablet::FilePB>* files) {
+  std::vector<std::string> children;
+  RETURN_NOT_OK(env().GetChildren(dir, ExcludeDots::kTrue, &children));
+  for (const auto& child : children) {
+    const auto path = JoinPathSegments(dir, child);
+    const auto name = prefix.empty() ? child : JoinPathSegments(prefix, child);
+    if (VERIFY_RESULT(env().IsDirectory(path))) {
+      RETURN_NOT_OK(ListReusableFiles(path, name, files));
+      continue;
+    }
+    auto* file = files->Add();
+    file->set_name(name);
+    file->set_size_bytes(VERIFY_RESULT(env().GetFileSize(path)));
+  }
+  return Status::OK();
+}
+
 Status RemoteBootstrapClient::Start(const string& bootstrap_peer_uuid,
                                     rpc::ProxyCache* proxy_cache,
                                     const HostPort& bootstrap_peer_addr,
@@ -201,6 +220,15 @@ Status RemoteBootstrapClient::Start(const string& bootstrap_peer_uuid,
   BeginRemoteBootstrapSessionRequestPB req;
   req.set_requestor_uuid(permanent_uuid());
   req.set_tablet_id(tablet_id_);
+  // SST files kept by the tombstoned replica are reused when their checksums match.
+  if (replace_tombstoned_tablet_ && env().FileExists(meta_->reusable_files_dir())) {
+    auto status = ListReusableFiles(
+        meta_->reusable_files_dir(), "" /* prefix */, req.mutable_reusable_rocksdb_files());
+    if (!status.ok()) {
+      LOG_WITH_PREFIX(WARNING) << "Failed to list reusable files: " << status;
+      req.clear_reusable_rocksdb_files();
+    }
+  }
 
   rpc::RpcController controller;
   controller.set_timeout(MonoDelta::FromMilliseconds(
@@ -641,15 +669,22 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
 
   RETURN_NOT_OK(CreateTabletDirectories(rocksdb_dir, meta_->fs_manager()));
 
+  const auto reusable_files_dir = meta_->reusable_files_dir();
+  const bool reuse_files = env().FileExists(reusable_files_dir);
+  if (reuse_files) {
+    downloader_.SetLocalFilesDir(reusable_files_dir);
+  }
+
   DataIdPB data_id;
   data_id.set_type(DataIdPB::ROCKSDB_FILE);
-  for (auto const& file_pb : new_superblock_.kv_store().rocksdb_files()) {
-    auto start = MonoTime::Now();
-    RETURN_NOT_OK(downloader_.DownloadFile(file_pb, rocksdb_dir, &data_id));
-    auto elapsed = MonoTime::Now().GetDeltaSince(start);
-    LOG_WITH_PREFIX(INFO)
-        << "Downloaded file " << file_pb.name() << " of size " << file_pb.size_bytes()
-        << " in " << elapsed.ToSeconds() << " seconds";
+  RETURN_NOT_OK(downloader_.DownloadFiles(
+      new_superblock_.kv_store().rocksdb_files(), rocksdb_dir, data_id));
+
+  if (reuse_files) {
+    // Reused files are hard linked to rocksdb_dir, so the rest of them are not needed.
+    auto s = env().DeleteRecursively(reusable_files_dir);
+    LOG_IF_WITH_PREFIX(WARNING, !s.ok())
+        << "Unable to delete reusable files directory " << reusable_files_dir << ": " << s;
   }
 
   // To avoid adding new file type to remote bootstrap we move intents as subdir of regular DB.
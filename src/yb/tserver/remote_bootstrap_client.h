@@ -171,6 +171,11 @@ class RemoteBootstrapClient {
 
   CHECKED_STATUS DownloadRocksDBFiles();
 
+  // Adds files in dir and its subdirectories to files, prepending prefix to their names.
+  CHECKED_STATUS ListReusableFiles(
+      const std::string& dir, const std::string& prefix,
+      google::protobuf::RepeatedPtrField<tablet::FilePB>* files);
+
   // End the remote bootstrap session.
   CHECKED_STATUS EndRemoteSession();
 
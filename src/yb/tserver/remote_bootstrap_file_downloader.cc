@@ -22,9 +22,12 @@
 #include "yb/tserver/remote_bootstrap.proxy.h"
 
 #include "yb/util/crc.h"
+#include "yb/util/env_util.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/scope_exit.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/thread.h"
 #include "yb/util/net/rate_limiter.h"
 
 using namespace yb::size_literals;
@@ -45,6 +48,12 @@ DEFINE_int64(remote_bootstrap_rate_limit_bytes_per_sec, 256_MB,
              "the total limit will be 2 * remote_bootstrap_rate_limit_bytes_per_sec because a "
              "tserver or master can act both as a sender and receiver at the same time.");
 
+DEFINE_int32(remote_bootstrap_max_concurrent_file_downloads, 1,
+             "Max number of files of a single remote bootstrap session that are downloaded "
+             "concurrently. The rate limit is shared by all concurrent downloads.");
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, advanced);
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, runtime);
+
 DEFINE_int32(bytes_remote_bootstrap_durable_write_mb, 8,
              "Explicitly call fsync after downloading the specified amount of data in MB "
              "during a remote bootstrap session. If 0 fsync() is not called.");
@@ -73,6 +82,9 @@ CHECKED_STATUS ExtractRemoteError(
           " from remote service");
 }
 
+// Number of files that are being downloaded by all remote bootstrap sessions of this process.
+std::atomic<int32_t> file_downloads_in_progress{0};
+
 } // namespace
 
 extern std::atomic<int32_t> remote_bootstrap_clients_started_;
@@ -100,43 +112,162 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
   RETURN_NOT_OK(env().CreateDirs(DirName(file_path)));
 
   if (file_pb.inode() != 0) {
-    auto it = inode2file_.find(file_pb.inode());
-    if (it != inode2file_.end()) {
+    std::string existing_file;
+    {
+      std::lock_guard<std::mutex> lock(inode2file_mutex_);
+      auto it = inode2file_.find(file_pb.inode());
+      if (it != inode2file_.end()) {
+        existing_file = it->second;
+      }
+    }
+    if (!existing_file.empty()) {
       VLOG_WITH_PREFIX(2) << "File with the same inode already found: " << file_path
-                          << " => " << it->second;
-      auto link_status = env().LinkFile(it->second, file_path);
+                          << " => " << existing_file;
+      auto link_status = env().LinkFile(existing_file, file_path);
       if (link_status.ok()) {
         return Status::OK();
       }
       // TODO fallback to copy.
-      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << it->second
+      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << existing_file
                              << ": " << link_status;
     }
   }
 
-  WritableFileOptions opts;
-  opts.sync_on_close = true;
-  std::unique_ptr<WritableFile> file;
-  RETURN_NOT_OK(env().NewWritableFile(opts, file_path, &file));
-
-  data_id->set_file_name(file_pb.name());
-  RETURN_NOT_OK_PREPEND(DownloadFile(*data_id, file.get()),
-                        Format("Unable to download $0 file $1",
-                               DataIdPB::IdType_Name(data_id->type()), file_path));
-  VLOG_WITH_PREFIX(2) << "Downloaded file " << file_path;
+  if (!LinkLocalFile(file_pb, file_path)) {
+    WritableFileOptions opts;
+    opts.sync_on_close = true;
+    std::unique_ptr<WritableFile> file;
+    RETURN_NOT_OK(env().NewWritableFile(opts, file_path, &file));
+
+    data_id->set_file_name(file_pb.name());
+    RETURN_NOT_OK_PREPEND(DownloadFile(*data_id, file.get()),
+                          Format("Unable to download $0 file $1",
+                                 DataIdPB::IdType_Name(data_id->type()), file_path));
+    VLOG_WITH_PREFIX(2) << "Downloaded file " << file_path;
+  }
 
   if (file_pb.inode() != 0) {
+    std::lock_guard<std::mutex> lock(inode2file_mutex_);
     inode2file_.emplace(file_pb.inode(), file_path);
   }
 
   return Status::OK();
 }
 
+bool RemoteBootstrapFileDownloader::LinkLocalFile(
+    const tablet::FilePB& file_pb, const std::string& file_path) {
+  if (local_files_dir_.empty() || !file_pb.has_crc32c()) {
+    return false;
+  }
+  auto local_path = JoinPathSegments(local_files_dir_, file_pb.name());
+  if (!env().FileExists(local_path)) {
+    return false;
+  }
+  auto size = env().GetFileSize(local_path);
+  if (!size.ok() || *size != file_pb.size_bytes()) {
+    return false;
+  }
+  auto crc32c = env_util::ComputeFileCrc32c(&env(), local_path);
+  if (!crc32c.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Failed to compute checksum of " << local_path << ": "
+                             << crc32c.status();
+    return false;
+  }
+  if (*crc32c != file_pb.crc32c()) {
+    VLOG_WITH_PREFIX(1) << "Checksum of local file " << local_path << " does not match";
+    return false;
+  }
+  auto link_status = env().LinkFile(local_path, file_path);
+  if (!link_status.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Failed to link local file: " << file_path << " => "
+                             << local_path << ": " << link_status;
+    return false;
+  }
+  LOG_WITH_PREFIX(INFO) << "Reused local file " << local_path << " of size "
+                        << file_pb.size_bytes();
+  return true;
+}
+
+Status RemoteBootstrapFileDownloader::DownloadFiles(
+    const google::protobuf::RepeatedPtrField<tablet::FilePB>& files, const std::string& dir,
+    const DataIdPB& data_id) {
+  // Files with the same inode form one group that is downloaded sequentially.
+  std::vector<std::vector<const tablet::FilePB*>> groups;
+  std::unordered_map<uint64_t, size_t> inode2group;
+  for (const auto& file_pb : files) {
+    // Directories are created in advance, since concurrent CreateDirs could fail.
+    RETURN_NOT_OK(env().CreateDirs(DirName(JoinPathSegments(dir, file_pb.name()))));
+    if (file_pb.inode() != 0) {
+      auto it = inode2group.emplace(file_pb.inode(), groups.size()).first;
+      if (it->second != groups.size()) {
+        groups[it->second].push_back(&file_pb);
+        continue;
+      }
+    }
+    groups.push_back({&file_pb});
+  }
+
+  std::atomic<size_t> next_group{0};
+  std::atomic<bool> failed{false};
+  std::mutex status_mutex;
+  Status status;
+  auto download = [this, &groups, &next_group, &failed, &status_mutex, &status, &dir, &data_id] {
+    for (;;) {
+      auto group_idx = next_group.fetch_add(1, std::memory_order_acq_rel);
+      if (group_idx >= groups.size() || failed.load(std::memory_order_acquire)) {
+        return;
+      }
+      for (const auto* file_pb : groups[group_idx]) {
+        auto file_data_id = data_id;
+        auto start = MonoTime::Now();
+        auto file_status = DownloadFile(*file_pb, dir, &file_data_id);
+        if (!file_status.ok()) {
+          std::lock_guard<std::mutex> lock(status_mutex);
+          if (status.ok()) {
+            status = file_status;
+          }
+          failed.store(true, std::memory_order_release);
+          return;
+        }
+        LOG_WITH_PREFIX(INFO)
+            << "Downloaded file " << file_pb->name() << " of size " << file_pb->size_bytes()
+            << " in " << MonoTime::Now().GetDeltaSince(start).ToSeconds() << " seconds";
+      }
+    }
+  };
+
+  const size_t num_streams = std::min<size_t>(
+      std::max(FLAGS_remote_bootstrap_max_concurrent_file_downloads, 1), groups.size());
+  std::vector<scoped_refptr<Thread>> threads;
+  for (size_t i = 1; i < num_streams; ++i) {
+    scoped_refptr<Thread> thread;
+    auto create_status = Thread::Create(
+        "remote_bootstrap", Format("rb-download-$0", i), download, &thread);
+    if (!create_status.ok()) {
+      // Could still proceed with fewer streams.
+      LOG_WITH_PREFIX(WARNING) << "Failed to start download thread: " << create_status;
+      break;
+    }
+    threads.push_back(std::move(thread));
+  }
+  download();
+  for (const auto& thread : threads) {
+    thread->Join();
+  }
+
+  return status;
+}
+
 template<class Appendable>
 Status RemoteBootstrapFileDownloader::DownloadFile(
     const DataIdPB& data_id, Appendable* appendable) {
   constexpr int kBytesReservedForMessageHeaders = 16384;
 
+  file_downloads_in_progress.fetch_add(1, std::memory_order_acq_rel);
+  auto se = ScopeExit([] {
+    file_downloads_in_progress.fetch_sub(1, std::memory_order_acq_rel);
+  });
+
   // For periodic sync, indicates number of bytes which need to be sync'ed.
   size_t periodic_sync_unsynced_bytes = 0;
   uint64_t offset = 0;
@@ -154,8 +285,12 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
                                    << remote_bootstrap_clients_started;
         return static_cast<uint64_t>(FLAGS_remote_bootstrap_rate_limit_bytes_per_sec);
       }
+      // With concurrent file downloads a session could have several downloads in progress.
+      auto num_downloads = std::max(
+          remote_bootstrap_clients_started,
+          file_downloads_in_progress.load(std::memory_order_acquire));
       return static_cast<uint64_t>(
-          FLAGS_remote_bootstrap_rate_limit_bytes_per_sec / remote_bootstrap_clients_started);
+          FLAGS_remote_bootstrap_rate_limit_bytes_per_sec / num_downloads);
     };
 
     rate_limiter = std::make_unique<RateLimiter>(rate_updater);
@@ -166,6 +301,7 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
 
   rpc::RpcController controller;
   controller.set_timeout(session_idle_timeout_);
+  controller.set_background_priority(true);
   FetchDataRequestPB req;
 
   bool done = false;
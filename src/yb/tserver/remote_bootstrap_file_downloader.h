@@ -15,6 +15,7 @@
 #define YB_TSERVER_REMOTE_BOOTSTRAP_FILE_DOWNLOADER_H
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -24,6 +25,8 @@
 
 #include "yb/tserver/remote_bootstrap.pb.h"
 
+#include "yb/gutil/thread_annotations.h"
+
 #include "yb/util/monotime.h"
 #include "yb/util/status.h"
 
@@ -45,9 +48,22 @@ class RemoteBootstrapFileDownloader {
       std::shared_ptr<RemoteBootstrapServiceProxy> proxy, std::string session_id,
       MonoDelta session_idle_timeout);
 
+  // Files with CRC32C set are hard linked from this dir instead of being downloaded, when the
+  // dir contains a file with the same name, size and checksum.
+  void SetLocalFilesDir(std::string dir) {
+    local_files_dir_ = std::move(dir);
+  }
+
   CHECKED_STATUS DownloadFile(
       const tablet::FilePB& file_pb, const std::string& dir, DataIdPB* data_id);
 
+  // Downloads files to dir, using up to remote_bootstrap_max_concurrent_file_downloads
+  // concurrent FetchData streams. Files that share an inode are downloaded by the same stream,
+  // so all of them except the first one become hard links.
+  CHECKED_STATUS DownloadFiles(
+      const google::protobuf::RepeatedPtrField<tablet::FilePB>& files, const std::string& dir,
+      const DataIdPB& data_id);
+
   // Download a single remote file. The block and WAL implementations delegate
   // to this method when downloading files.
   //
@@ -69,6 +85,9 @@ class RemoteBootstrapFileDownloader {
  private:
   CHECKED_STATUS VerifyData(uint64_t offset, const DataChunkPB& resp);
 
+  // Returns whether a matching file from local_files_dir_ was linked to file_path.
+  bool LinkLocalFile(const tablet::FilePB& file_pb, const std::string& file_path);
+
   const std::string& LogPrefix() const {
     return log_prefix_;
   }
@@ -81,7 +100,9 @@ class RemoteBootstrapFileDownloader {
   std::shared_ptr<RemoteBootstrapServiceProxy> proxy_;
   std::string session_id_;
   MonoDelta session_idle_timeout_ = MonoDelta::kZero;
-  std::unordered_map<uint64_t, std::string> inode2file_;
+  std::string local_files_dir_;
+  std::mutex inode2file_mutex_;
+  std::unordered_map<uint64_t, std::string> inode2file_ GUARDED_BY(inode2file_mutex_);
 };
 
 CHECKED_STATUS UnwindRemoteError(const Status& status, const rpc::RpcController& controller);
@@ -12,11 +12,13 @@
 //
 
 #include <algorithm>
+#include <map>
 
 #include "yb/tablet/tablet_snapshots.h"
 
 #include "yb/tserver/remote_bootstrap_client-test.h"
 
+DECLARE_bool(remote_bootstrap_reuse_tombstoned_sst_files);
 
 using std::shared_ptr;
 
@@ -31,6 +33,29 @@ using tablet::TabletStatusListener;
 class RemoteBootstrapRocksDBClientTest : public RemoteBootstrapClientTest {
  public:
   RemoteBootstrapRocksDBClientTest() : RemoteBootstrapClientTest(YQL_TABLE_TYPE) {}
+
+ protected:
+  // Returns inodes of SST files in dir by file name.
+  std::map<std::string, uint64_t> SstFileINodes(const std::string& dir) {
+    std::map<std::string, uint64_t> result;
+    std::vector<std::string> files;
+    CHECK_OK(fs_manager_->ListDir(dir, &files));
+    for (const auto& file : files) {
+      if (file.find(".sst") != std::string::npos) {
+        result.emplace(file, CHECK_RESULT(env_->GetFileINode(JoinPathSegments(dir, file))));
+      }
+    }
+    return result;
+  }
+
+  // Completes the remote bootstrap started by the fixture and tombstones the downloaded tablet.
+  void FetchAndTombstone() {
+    TabletStatusListener listener(meta_);
+    ASSERT_OK(client_->FetchAll(&listener));
+    ASSERT_OK(client_->Finish());
+    ASSERT_OK(meta_->DeleteTabletData(
+        tablet::TABLET_DATA_TOMBSTONED, tablet_peer_->GetLatestLogEntryOpId()));
+  }
 };
 
 // Basic begin / end remote bootstrap session.
@@ -81,5 +106,54 @@ TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
   }
 }
 
+// SST files of a tombstoned tablet are kept as hard links when reuse is enabled.
+TEST_F(RemoteBootstrapRocksDBClientTest, TombstoneKeepsSstFiles) {
+  FLAGS_remote_bootstrap_reuse_tombstoned_sst_files = true;
+  TabletStatusListener listener(meta_);
+  ASSERT_OK(client_->FetchAll(&listener));
+  ASSERT_OK(client_->Finish());
+
+  const auto sst_files = SstFileINodes(meta_->rocksdb_dir());
+  ASSERT_FALSE(sst_files.empty());
+  ASSERT_OK(meta_->DeleteTabletData(
+      tablet::TABLET_DATA_TOMBSTONED, tablet_peer_->GetLatestLogEntryOpId()));
+  ASSERT_FALSE(env_->FileExists(meta_->rocksdb_dir()));
+  // Kept files are links to the files of the deleted DB.
+  ASSERT_EQ(SstFileINodes(meta_->reusable_files_dir()), sst_files);
+
+  // Deleting the tablet also deletes the kept files.
+  ASSERT_OK(meta_->DeleteTabletData(
+      tablet::TABLET_DATA_DELETED, tablet_peer_->GetLatestLogEntryOpId()));
+  ASSERT_FALSE(env_->FileExists(meta_->reusable_files_dir()));
+}
+
+// Remote bootstrap of a tombstoned tablet links kept SST files matching the leader ones instead of
+// downloading them.
+TEST_F(RemoteBootstrapRocksDBClientTest, ReuseTombstonedSstFiles) {
+  FLAGS_remote_bootstrap_reuse_tombstoned_sst_files = true;
+  ASSERT_NO_FATALS(FetchAndTombstone());
+  const auto kept_files = SstFileINodes(meta_->reusable_files_dir());
+  ASSERT_FALSE(kept_files.empty());
+
+  client_ = std::make_unique<RemoteBootstrapClient>(GetTabletId(), fs_manager_.get());
+  ASSERT_OK(client_->SetTabletToReplace(meta_, tablet_peer_->GetLatestLogEntryOpId().term));
+  HostPort host_port = HostPortFromPB(leader_.last_known_private_addr()[0]);
+  ASSERT_OK(client_->Start(leader_.permanent_uuid(), proxy_cache_.get(), host_port, &meta_));
+  TabletStatusListener listener(meta_);
+  ASSERT_OK(client_->FetchAll(&listener));
+  ASSERT_OK(client_->Finish());
+
+  // The leader did not change its SST files, so all of them are reused.
+  ASSERT_EQ(SstFileINodes(meta_->rocksdb_dir()), kept_files);
+  ASSERT_FALSE(env_->FileExists(meta_->reusable_files_dir()));
+
+  auto checkpoint_dir = tablet_peer_->tablet()->snapshots().TEST_LastRocksDBCheckpointDir();
+  for (const auto& file : kept_files) {
+    ASSERT_OK(CompareFileContents(
+        JoinPathSegments(meta_->rocksdb_dir(), file.first),
+        JoinPathSegments(checkpoint_dir, file.first)));
+  }
+}
+
 } // namespace tserver
 } // namespace yb
@@ -13,6 +13,8 @@
 
 #include "yb/tserver/remote_bootstrap_session-test.h"
 
+#include "yb/util/env_util.h"
+
 namespace yb {
 namespace tserver {
 
@@ -74,6 +76,36 @@ TEST_F(RemoteBootstrapRocksDBTest, CheckSuperBlockHasRocksDBFields) {
   }
 }
 
+TEST_F(RemoteBootstrapRocksDBTest, RocksDBFileChecksums) {
+  const auto& source_files = session_->tablet_superblock().kv_store().rocksdb_files();
+  ASSERT_GT(source_files.size(), 1);
+  ASSERT_FALSE(source_files.Get(0).has_crc32c());
+
+  // The first file matches by name and size, the second one only by name.
+  google::protobuf::RepeatedPtrField<tablet::FilePB> reusable_files;
+  auto* reusable_file = reusable_files.Add();
+  reusable_file->set_name(source_files.Get(0).name());
+  reusable_file->set_size_bytes(source_files.Get(0).size_bytes());
+  reusable_file = reusable_files.Add();
+  reusable_file->set_name(source_files.Get(1).name());
+  reusable_file->set_size_bytes(source_files.Get(1).size_bytes() + 1);
+
+  auto session = make_scoped_refptr<RemoteBootstrapSession>(
+      tablet_peer_, "TestChecksumSession", "FakeUUID", nullptr /* nsessions */);
+  ASSERT_OK(session->Init(reusable_files));
+  const auto& files = session->tablet_superblock().kv_store().rocksdb_files();
+  ASSERT_EQ(files.size(), source_files.size());
+  for (const auto& file : files) {
+    if (file.name() != source_files.Get(0).name()) {
+      ASSERT_FALSE(file.has_crc32c()) << file.name();
+      continue;
+    }
+    ASSERT_TRUE(file.has_crc32c());
+    auto file_path = JoinPathSegments(session->checkpoint_dir_, file.name());
+    ASSERT_EQ(file.crc32c(), ASSERT_RESULT(env_util::ComputeFileCrc32c(env_.get(), file_path)));
+  }
+}
+
 TEST_F(RemoteBootstrapRocksDBTest, TestNonExistentRocksDBFile) {
   GetDataPieceInfo info;
   auto status = session_->GetRocksDBFilePiece("SomeNonExistentFile", &info);
@@ -182,7 +182,7 @@ void RemoteBootstrapServiceImpl::BeginRemoteBootstrapSession(
     it->second.ResetExpiration();
   }
 
-  RPC_RETURN_NOT_OK(session->Init(),
+  RPC_RETURN_NOT_OK(session->Init(req->reusable_rocksdb_files()),
                     RemoteBootstrapErrorPB::UNKNOWN_ERROR,
                     Substitute("Error initializing remote bootstrap session for tablet $0",
                                tablet_id));
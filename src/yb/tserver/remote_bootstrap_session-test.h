@@ -173,6 +173,7 @@ class RemoteBootstrapTest : public YBTabletTest {
         tablet_metric_entity,
         raft_pool_.get(),
         tablet_prepare_pool_.get(),
+        nullptr /* raft_apply_pool */,
         nullptr /* retryable_requests */));
     consensus::ConsensusBootstrapInfo boot_info;
     ASSERT_OK(tablet_peer_->Start(boot_info));
@@ -47,6 +47,7 @@
 
 #include "yb/tserver/remote_bootstrap_snapshots.h"
 
+#include "yb/util/env_util.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
@@ -210,9 +211,38 @@ Result<google::protobuf::RepeatedPtrField<tablet::FilePB>> ListFiles(const std::
   return result;
 }
 
+// Sets CRC32C of files that match one of reusable_files by name and size, so the checksum is
+// computed only for files that the client could reuse.
+Status SetReusableFileChecksums(
+    const std::string& dir,
+    const google::protobuf::RepeatedPtrField<tablet::FilePB>& reusable_files,
+    google::protobuf::RepeatedPtrField<tablet::FilePB>* files) {
+  if (reusable_files.empty()) {
+    return Status::OK();
+  }
+  std::unordered_map<std::string, uint64_t> reusable_file_sizes;
+  for (const auto& file : reusable_files) {
+    reusable_file_sizes.emplace(file.name(), file.size_bytes());
+  }
+  for (auto& file : *files) {
+    auto it = reusable_file_sizes.find(file.name());
+    if (it == reusable_file_sizes.end() || it->second != file.size_bytes()) {
+      continue;
+    }
+    file.set_crc32c(VERIFY_RESULT(env_util::ComputeFileCrc32c(
+        Env::Default(), JoinPathSegments(dir, file.name()))));
+  }
+  return Status::OK();
+}
+
 const std::string RemoteBootstrapSession::kCheckpointsDir = "checkpoints";
 
 Status RemoteBootstrapSession::Init() {
+  return Init(google::protobuf::RepeatedPtrField<tablet::FilePB>());
+}
+
+Status RemoteBootstrapSession::Init(
+    const google::protobuf::RepeatedPtrField<tablet::FilePB>& reusable_rocksdb_files) {
   // Take locks to support re-initialization of the same session.
   std::lock_guard<std::mutex> lock(mutex_);
   RETURN_NOT_OK(UnregisterAnchorIfNeededUnlocked());
@@ -254,6 +284,8 @@ Status RemoteBootstrapSession::Init() {
   auto status = tablet->snapshots().CreateCheckpoint(checkpoint_dir_);
   if (status.ok()) {
     *kv_store->mutable_rocksdb_files() = VERIFY_RESULT(ListFiles(checkpoint_dir_));
+    RETURN_NOT_OK(SetReusableFileChecksums(
+        checkpoint_dir_, reusable_rocksdb_files, kv_store->mutable_rocksdb_files()));
   } else if (!status.IsNotSupported()) {
     RETURN_NOT_OK(status);
   }
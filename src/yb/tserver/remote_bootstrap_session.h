@@ -100,6 +100,11 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
   // tablet superblock and list of WAL segments.
   CHECKED_STATUS Init();
 
+  // Same as above, but also sets CRC32C of RocksDB files in the superblock that match
+  // reusable_rocksdb_files of the client by name and size.
+  CHECKED_STATUS Init(
+      const google::protobuf::RepeatedPtrField<tablet::FilePB>& reusable_rocksdb_files);
+
   // Return ID of tablet corresponding to this session.
   const std::string& tablet_id() const;
 
@@ -147,6 +152,7 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
 
   FRIEND_TEST(RemoteBootstrapRocksDBTest, TestCheckpointDirectory);
   FRIEND_TEST(RemoteBootstrapRocksDBTest, CheckSuperBlockHasRocksDBFields);
+  FRIEND_TEST(RemoteBootstrapRocksDBTest, RocksDBFileChecksums);
   FRIEND_TEST(RemoteBootstrapRocksDBTest, CheckSuperBlockHasSnapshotFields);
   FRIEND_TEST(RemoteBootstrapRocksDBTest, TestNonExistentRocksDBFile);
 
@@ -13,6 +13,9 @@
 
 #include "yb/tserver/tablet_memory_manager.h"
 
+#include <queue>
+#include <unordered_set>
+
 #include "yb/consensus/log_cache.h"
 #include "yb/consensus/raft_consensus.h"
 
@@ -20,17 +23,25 @@
 
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/memory_monitor.h"
+#include "yb/rocksdb/persistent_cache.h"
 
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_options.h"
+#include "yb/tablet/tablet_metadata.h"
 #include "yb/tablet/tablet_peer.h"
 
 #include "yb/util/background_task.h"
+#include "yb/util/cache_metrics.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
+#include "yb/util/metrics.h"
+#include "yb/util/size_literals.h"
 
 using namespace std::literals;
 using namespace std::placeholders;
+using namespace yb::size_literals;
+
+DECLARE_int64(db_block_size_bytes);
 
 DEFINE_bool(enable_log_cache_gc, true,
             "Set to true to enable log cache garbage collector.");
@@ -39,6 +50,12 @@ DEFINE_bool(log_cache_gc_evict_only_over_allocated, true,
             "If set to true, log cache garbage collection would evict only memory that was "
             "allocated over limit for log cache. Otherwise it will try to evict requested number "
             "of bytes.");
+DEFINE_bool(log_cache_gc_evict_oldest_first, true,
+            "If set to true, log cache garbage collection evicts the least recently appended "
+            "entries across all tablets first. Otherwise it evicts from the tablets with the "
+            "largest log cache first.");
+TAG_FLAG(log_cache_gc_evict_oldest_first, advanced);
+
 DEFINE_int64(global_memstore_size_percentage, 10,
              "Percentage of total available memory to use for the global memstore. "
              "Default is 10. See also memstore_size_mb and "
@@ -48,6 +65,35 @@ DEFINE_int64(global_memstore_size_mb_max, 2048,
              "memory. However, this flag limits it in absolute size. Value of 0 "
              "means no limit on the value obtained by the percentage. Default is 2048.");
 
+DEFINE_bool(enable_weighted_memstore_arbitration, false,
+            "When the global memstore limit is reached, choose tablets to flush by a weighted "
+            "score of memtable size, memtable age, WAL size and intents memtable size, and flush "
+            "on all data directories in parallel. Otherwise the tablet with the oldest memtable "
+            "write is flushed.");
+TAG_FLAG(enable_weighted_memstore_arbitration, advanced);
+TAG_FLAG(enable_weighted_memstore_arbitration, runtime);
+
+DEFINE_double(memstore_arbitration_size_weight, 1.0,
+              "Weight of the memtable size in the flush score, see "
+              "enable_weighted_memstore_arbitration.");
+TAG_FLAG(memstore_arbitration_size_weight, advanced);
+TAG_FLAG(memstore_arbitration_size_weight, runtime);
+
+DEFINE_double(memstore_arbitration_age_weight, 0.5,
+              "Weight of the age of the oldest memtable write in the flush score.");
+TAG_FLAG(memstore_arbitration_age_weight, advanced);
+TAG_FLAG(memstore_arbitration_age_weight, runtime);
+
+DEFINE_double(memstore_arbitration_wal_weight, 0.5,
+              "Weight of the WAL size retained by the tablet in the flush score.");
+TAG_FLAG(memstore_arbitration_wal_weight, advanced);
+TAG_FLAG(memstore_arbitration_wal_weight, runtime);
+
+DEFINE_double(memstore_arbitration_intents_weight, 0.5,
+              "Weight of the intents memtable size in the flush score.");
+TAG_FLAG(memstore_arbitration_intents_weight, advanced);
+TAG_FLAG(memstore_arbitration_intents_weight, runtime);
+
 namespace {
   constexpr int kDbCacheSizeUsePercentage = -1;
   constexpr int kDbCacheSizeCacheDisabled = -2;
@@ -73,6 +119,55 @@ DEFINE_int32(db_block_cache_num_shard_bits, 4,
              "Number of bits to use for sharding the block cache (defaults to 4 bits)");
 TAG_FLAG(db_block_cache_num_shard_bits, advanced);
 
+DEFINE_string(db_block_cache_type, "lru",
+              "Implementation of RocksDB block cache: lru or clock. Clock cache does not take "
+              "locks on lookup, and is sized by FLAGS_db_block_size_bytes per entry.");
+TAG_FLAG(db_block_cache_type, advanced);
+
+namespace {
+
+bool ValidateBlockCacheType(const char* flagname, const std::string& value) {
+  if (value != "lru" && value != "clock") {
+    LOG(ERROR) << "Expect " << flagname << " to be lru or clock, got: " << value;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+__attribute__((unused))
+DEFINE_validator(db_block_cache_type, &ValidateBlockCacheType);
+
+DEFINE_string(db_persistent_cache_path, "",
+              "Directory on a local device for the secondary tier of RocksDB block cache. Blocks "
+              "evicted from the block cache are stored there. Empty value disables the tier.");
+TAG_FLAG(db_persistent_cache_path, advanced);
+
+DEFINE_int64(db_persistent_cache_size_bytes, 0,
+             "Max size of the secondary tier of RocksDB block cache, see "
+             "FLAGS_db_persistent_cache_path.");
+TAG_FLAG(db_persistent_cache_size_bytes, advanced);
+
+DEFINE_int32(db_compressed_block_cache_size_percentage, 0,
+             "Percentage of the block cache memory given to the compressed tier of the block "
+             "cache. It keeps compressed data blocks, so a block evicted from the uncompressed "
+             "tier is uncompressed from memory instead of read from disk. 0 disables the tier.");
+TAG_FLAG(db_compressed_block_cache_size_percentage, advanced);
+
+DEFINE_int32(db_compressed_block_cache_resize_interval_ms, 0,
+             "Interval of moving block cache memory between the uncompressed and compressed tiers "
+             "according to the hit rate of the compressed tier. 0 keeps the split configured by "
+             "db_compressed_block_cache_size_percentage.");
+TAG_FLAG(db_compressed_block_cache_resize_interval_ms, advanced);
+
+DEFINE_int64(db_table_reader_cache_size_bytes, 0,
+             "Capacity of the cache of SST file readers shared by all RocksDB instances of the "
+             "server, in bytes of approximate table reader memory. The least recently used readers "
+             "are closed when it is full. 0 gives each RocksDB instance its own cache, bounded "
+             "by the number of open files.");
+TAG_FLAG(db_table_reader_cache_size_bytes, advanced);
+
 DEFINE_test_flag(bool, pretend_memory_exceeded_enforce_flush, false,
                   "Always pretend memory has been exceeded to enforce background flush.");
 
@@ -147,6 +242,43 @@ size_t GetLogCacheSize(tablet::TabletPeer* peer) {
   return down_cast<consensus::RaftConsensus*>(peer->consensus())->LogCacheSize();
 }
 
+CoarseTimePoint GetLogCacheOldestEvictableEntryTime(tablet::TabletPeer* peer) {
+  return down_cast<consensus::RaftConsensus*>(
+      peer->consensus())->LogCacheOldestEvictableEntryTime();
+}
+
+// Amount of bytes evicted from a single tablet before checking whether another tablet has older
+// entries.
+constexpr size_t kLogCacheGcChunkSize = 1_MB;
+
+// Evicts the least recently appended entries across all tablets, approximating a global LRU by
+// evicting in chunks from the tablet with the oldest evictable entry.
+size_t EvictLogCacheOldestFirst(const std::vector<tablet::TabletPeerPtr>& peers, size_t bytes_to_evict) {
+  using Candidate = std::pair<CoarseTimePoint, tablet::TabletPeer*>;
+  auto cmp = [](const Candidate& lhs, const Candidate& rhs) { return lhs.first > rhs.first; };
+  std::priority_queue<Candidate, std::vector<Candidate>, decltype(cmp)> queue(cmp);
+  for (const auto& peer : peers) {
+    auto time = GetLogCacheOldestEvictableEntryTime(peer.get());
+    if (time != CoarseTimePoint::max()) {
+      queue.emplace(time, peer.get());
+    }
+  }
+
+  size_t total_evicted = 0;
+  while (total_evicted < bytes_to_evict && !queue.empty()) {
+    auto* peer = queue.top().second;
+    queue.pop();
+    size_t evicted = down_cast<consensus::RaftConsensus*>(peer->consensus())->EvictLogCache(
+        std::min(bytes_to_evict - total_evicted, kLogCacheGcChunkSize));
+    total_evicted += evicted;
+    auto time = GetLogCacheOldestEvictableEntryTime(peer);
+    if (evicted > 0 && time != CoarseTimePoint::max()) {
+      queue.emplace(time, peer);
+    }
+  }
+  return total_evicted;
+}
+
 }  // namespace
 
 TabletMemoryManager::TabletMemoryManager(
@@ -159,6 +291,7 @@ TabletMemoryManager::TabletMemoryManager(
   peers_fn_ = peers_fn;
 
   InitBlockCache(metrics, default_block_cache_size_percentage, options);
+  InitTableReaderCache(options);
   InitLogCacheGC();
   // Assign background_task_ if necessary.
   ConfigureBackgroundTask(options);
@@ -168,6 +301,9 @@ CHECKED_STATUS TabletMemoryManager::Init() {
   if (background_task_) {
     RETURN_NOT_OK(background_task_->Init());
   }
+  if (block_cache_tiers_task_) {
+    RETURN_NOT_OK(block_cache_tiers_task_->Init());
+  }
   return Status::OK();
 }
 
@@ -175,6 +311,9 @@ void TabletMemoryManager::Shutdown() {
   if (background_task_) {
     background_task_->Shutdown();
   }
+  if (block_cache_tiers_task_) {
+    block_cache_tiers_task_->Shutdown();
+  }
 }
 
 std::shared_ptr<MemTracker> TabletMemoryManager::block_based_table_mem_tracker() {
@@ -193,11 +332,132 @@ void TabletMemoryManager::InitBlockCache(
       server_mem_tracker_);
 
   if (block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
-    options->block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
-                                                FLAGS_db_block_cache_num_shard_bits);
+    if (FLAGS_db_block_cache_type == "clock") {
+      options->block_cache = rocksdb::NewClockCache(
+          block_cache_size_bytes, FLAGS_db_block_cache_num_shard_bits,
+          false /* strict_capacity_limit */, FLAGS_db_block_size_bytes);
+    } else {
+      options->block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
+                                                  FLAGS_db_block_cache_num_shard_bits);
+    }
     options->block_cache->SetMetrics(metrics);
     block_based_table_gc_ = std::make_shared<LRUCacheGC>(options->block_cache);
     block_based_table_mem_tracker_->AddGarbageCollector(block_based_table_gc_);
+    InitCompressedBlockCache(metrics, options);
+    InitPersistentCache(metrics, options);
+  }
+}
+
+void TabletMemoryManager::InitTableReaderCache(tablet::TabletOptions* options) {
+  if (FLAGS_db_table_reader_cache_size_bytes <= 0) {
+    return;
+  }
+  options->table_reader_cache = rocksdb::NewLRUCache(
+      FLAGS_db_table_reader_cache_size_bytes, FLAGS_db_block_cache_num_shard_bits);
+  auto cache = options->table_reader_cache;
+  table_reader_cache_mem_tracker_ = MemTracker::CreateTracker(
+      -1 /* byte_limit */, "TableReaders", [cache] { return cache->GetUsage(); },
+      server_mem_tracker_);
+}
+
+void TabletMemoryManager::InitCompressedBlockCache(
+    const scoped_refptr<MetricEntity>& metrics, tablet::TabletOptions* options) {
+  if (FLAGS_db_compressed_block_cache_size_percentage <= 0) {
+    return;
+  }
+  const size_t total_capacity = options->block_cache->GetCapacity();
+  const size_t compressed_capacity =
+      total_capacity * std::min(FLAGS_db_compressed_block_cache_size_percentage, 90) / 100;
+  options->block_cache->SetCapacity(total_capacity - compressed_capacity);
+  options->compressed_block_cache = rocksdb::NewLRUCache(
+      compressed_capacity, FLAGS_db_block_cache_num_shard_bits);
+  options->compressed_block_cache->SetMetrics(metrics, BlockCacheKind::kCompressed);
+  compressed_block_cache_gc_ = std::make_shared<LRUCacheGC>(options->compressed_block_cache);
+  block_based_table_mem_tracker_->AddGarbageCollector(compressed_block_cache_gc_);
+
+  if (FLAGS_db_compressed_block_cache_resize_interval_ms > 0) {
+    block_cache_ = options->block_cache;
+    compressed_block_cache_ = options->compressed_block_cache;
+    // Instantiates the same metrics that the compressed block cache updates.
+    compressed_block_cache_metrics_ =
+        std::make_unique<CacheMetrics>(metrics, BlockCacheKind::kCompressed);
+    block_cache_tiers_task_ = std::make_unique<BackgroundTask>(
+        std::function<void()>([this]() { ResizeBlockCacheTiers(); }),
+        "tablet manager", "block cache tiers resizer",
+        std::chrono::milliseconds(FLAGS_db_compressed_block_cache_resize_interval_ms));
+  }
+}
+
+void TabletMemoryManager::ResizeBlockCacheTiers() {
+  // A lookup in the compressed tier happens on a miss in the uncompressed tier. A hit saves a
+  // disk read for the cost of uncompressing the block, so while the compressed tier hits often,
+  // memory is better used for 3-4 times more compressed blocks. While it hits rarely, it mostly
+  // keeps blocks that are not read again, and memory is better used for uncompressed blocks.
+  constexpr uint64_t kMinLookups = 1000;
+  constexpr double kGrowHitRatio = 0.3;
+  constexpr double kShrinkHitRatio = 0.1;
+  // Memory moved per resize, and bounds of the compressed tier, in fractions of the total size.
+  constexpr size_t kStepFraction = 20;
+  constexpr size_t kMinFraction = 20;
+  constexpr size_t kMaxFraction = 2;
+
+  const uint64_t hits = compressed_block_cache_metrics_->cache_hits->value();
+  const uint64_t misses = compressed_block_cache_metrics_->cache_misses->value();
+  const uint64_t new_hits = hits - prev_compressed_block_cache_hits_;
+  const uint64_t new_lookups = new_hits + misses - prev_compressed_block_cache_misses_;
+  if (new_lookups < kMinLookups) {
+    return;
+  }
+  prev_compressed_block_cache_hits_ = hits;
+  prev_compressed_block_cache_misses_ = misses;
+
+  const double hit_ratio = static_cast<double>(new_hits) / new_lookups;
+  const size_t capacity = block_cache_->GetCapacity();
+  const size_t compressed_capacity = compressed_block_cache_->GetCapacity();
+  const size_t total_capacity = capacity + compressed_capacity;
+  const size_t step = total_capacity / kStepFraction;
+  size_t new_compressed_capacity = compressed_capacity;
+  if (hit_ratio >= kGrowHitRatio) {
+    new_compressed_capacity = std::min(compressed_capacity + step, total_capacity / kMaxFraction);
+  } else if (hit_ratio < kShrinkHitRatio) {
+    new_compressed_capacity = std::max(
+        compressed_capacity - std::min(step, compressed_capacity), total_capacity / kMinFraction);
+  }
+  if (new_compressed_capacity == compressed_capacity) {
+    return;
+  }
+
+  // Shrink a tier before growing the other one, so the total capacity is never exceeded.
+  if (new_compressed_capacity > compressed_capacity) {
+    block_cache_->SetCapacity(total_capacity - new_compressed_capacity);
+    compressed_block_cache_->SetCapacity(new_compressed_capacity);
+  } else {
+    compressed_block_cache_->SetCapacity(new_compressed_capacity);
+    block_cache_->SetCapacity(total_capacity - new_compressed_capacity);
+  }
+  LOG(INFO) << "Compressed block cache hit ratio " << hit_ratio << ", resized from "
+            << HumanReadableNumBytes::ToString(compressed_capacity) << " to "
+            << HumanReadableNumBytes::ToString(new_compressed_capacity) << " of "
+            << HumanReadableNumBytes::ToString(total_capacity);
+}
+
+void TabletMemoryManager::InitPersistentCache(
+    const scoped_refptr<MetricEntity>& metrics, tablet::TabletOptions* options) {
+  if (FLAGS_db_persistent_cache_path.empty() || FLAGS_db_persistent_cache_size_bytes <= 0) {
+    return;
+  }
+  rocksdb::PersistentCacheOptions cache_options;
+  cache_options.env = options->rocksdb_env;
+  cache_options.path = FLAGS_db_persistent_cache_path;
+  cache_options.capacity = FLAGS_db_persistent_cache_size_bytes;
+  cache_options.parent_mem_tracker = block_based_table_mem_tracker_;
+  cache_options.metric_entity = metrics;
+  auto status = rocksdb::NewPersistentCache(cache_options, &options->persistent_cache);
+  if (!status.ok()) {
+    // Server could work without the persistent cache, just with higher read latency.
+    LOG(WARNING) << "Failed to create persistent cache in " << cache_options.path << ": "
+                 << status;
+    options->persistent_cache = nullptr;
   }
 }
 
@@ -258,21 +518,25 @@ void TabletMemoryManager::LogCacheGC(MemTracker* log_cache_mem_tracker, size_t b
   }
 
   auto peers = peers_fn_();
-  // Sort by inverse log size.
-  std::sort(peers.begin(), peers.end(), [](const auto& lhs, const auto& rhs) {
-    return GetLogCacheSize(lhs.get()) > GetLogCacheSize(rhs.get());
-  });
-
   size_t total_evicted = 0;
-  for (const auto& peer : peers) {
-    if (GetLogCacheSize(peer.get()) <= 0) {
-      continue;
-    }
-    size_t evicted = down_cast<consensus::RaftConsensus*>(
-        peer->consensus())->EvictLogCache(bytes_to_evict - total_evicted);
-    total_evicted += evicted;
-    if (total_evicted >= bytes_to_evict) {
-      break;
+  if (FLAGS_log_cache_gc_evict_oldest_first) {
+    total_evicted = EvictLogCacheOldestFirst(peers, bytes_to_evict);
+  } else {
+    // Sort by inverse log size.
+    std::sort(peers.begin(), peers.end(), [](const auto& lhs, const auto& rhs) {
+      return GetLogCacheSize(lhs.get()) > GetLogCacheSize(rhs.get());
+    });
+
+    for (const auto& peer : peers) {
+      if (GetLogCacheSize(peer.get()) <= 0) {
+        continue;
+      }
+      size_t evicted = down_cast<consensus::RaftConsensus*>(
+          peer->consensus())->EvictLogCache(bytes_to_evict - total_evicted);
+      total_evicted += evicted;
+      if (total_evicted >= bytes_to_evict) {
+        break;
+      }
     }
   }
 
@@ -288,24 +552,143 @@ void TabletMemoryManager::FlushTabletIfLimitExceeded() {
     YB_LOG_EVERY_N_SECS(INFO, 5) << Format("Memstore global limit of $0 bytes reached, looking for "
                                            "tablet to flush", memory_monitor_->limit());
     auto flush_tick = rocksdb::FlushTick();
+    if (FLAGS_enable_weighted_memstore_arbitration) {
+      if (!FlushWeightedCandidates(flush_tick)) {
+        // Flushes that are already running release enough memory, the next memory reservation
+        // over the limit wakes us up again.
+        break;
+      }
+      continue;
+    }
     tablet::TabletPeerPtr tablet_to_flush = TabletToFlush();
     // TODO(bojanserafimov): If tablet_to_flush flushes now because of other reasons,
     // we will schedule a second flush, which will unnecessarily stall writes for a short time. This
     // will not happen often, but should be fixed.
     if (tablet_to_flush) {
-      LOG(INFO)
-          << LogPrefix(tablet_to_flush)
-          << "Flushing tablet with oldest memstore write at "
-          << tablet_to_flush->tablet()->OldestMutableMemtableWriteHybridTime();
-      WARN_NOT_OK(
-          tablet_to_flush->tablet()->Flush(
-              tablet::FlushMode::kAsync, tablet::FlushFlags::kAll, flush_tick),
-          Substitute("Flush failed on $0", tablet_to_flush->tablet_id()));
-      for (auto listener : TEST_listeners) {
-        listener->StartedFlush(tablet_to_flush->tablet_id());
-      }
+      StartFlush(
+          tablet_to_flush, flush_tick,
+          Format("oldest memstore write at $0",
+                 tablet_to_flush->tablet()->OldestMutableMemtableWriteHybridTime()));
+    }
+  }
+}
+
+void TabletMemoryManager::StartFlush(
+    const tablet::TabletPeerPtr& peer, int64_t flush_tick, const std::string& reason) {
+  LOG(INFO) << LogPrefix(peer) << "Flushing tablet with " << reason;
+  WARN_NOT_OK(
+      peer->tablet()->Flush(tablet::FlushMode::kAsync, tablet::FlushFlags::kAll, flush_tick),
+      Substitute("Flush failed on $0", peer->tablet_id()));
+  for (auto listener : TEST_listeners) {
+    listener->StartedFlush(peer->tablet_id());
+  }
+}
+
+std::vector<MemstoreFlushCandidate> TabletMemoryManager::GetFlushCandidates() {
+  std::vector<MemstoreFlushCandidate> result;
+  uint64_t max_memtable_bytes = 0;
+  uint64_t max_intents_bytes = 0;
+  uint64_t max_wal_bytes = 0;
+  MonoDelta max_age = MonoDelta::kZero;
+  for (const tablet::TabletPeerPtr& peer : peers_fn_()) {
+    const auto tablet = peer->shared_tablet();
+    if (!tablet) {
+      continue;
     }
+    const auto ht = tablet->OldestMutableMemtableWriteHybridTime();
+    if (!ht.ok()) {
+      YB_LOG_EVERY_N_SECS(WARNING, 5) << Format(
+          "Failed to get oldest mutable memtable write ht for tablet $0: $1",
+          tablet->tablet_id(), ht.status());
+      continue;
+    }
+    if (*ht == HybridTime::kMax) {
+      continue;
+    }
+    MemstoreFlushCandidate candidate;
+    candidate.peer = peer;
+    std::tie(candidate.intents_memtable_bytes, candidate.regular_memtable_bytes) =
+        tablet->GetActiveMemtablesSize();
+    const auto now = tablet->clock()->Now();
+    candidate.memtable_age = MonoDelta::FromMicroseconds(std::max<int64_t>(
+        0, now.GetPhysicalValueMicros() - ht->GetPhysicalValueMicros()));
+    candidate.wal_bytes = peer->log_available() ? peer->log()->OnDiskSize() : 0;
+
+    max_memtable_bytes = std::max(max_memtable_bytes, candidate.memtable_bytes());
+    max_intents_bytes = std::max(max_intents_bytes, candidate.intents_memtable_bytes);
+    max_wal_bytes = std::max(max_wal_bytes, candidate.wal_bytes);
+    max_age = std::max(max_age, candidate.memtable_age);
+    result.push_back(std::move(candidate));
+  }
+
+  // Each component is normalized by its maximum across candidates, so weights are comparable.
+  auto normalized = [](double value, double max) {
+    return max > 0 ? value / max : 0.0;
+  };
+  for (auto& candidate : result) {
+    candidate.score =
+        FLAGS_memstore_arbitration_size_weight *
+            normalized(candidate.memtable_bytes(), max_memtable_bytes) +
+        FLAGS_memstore_arbitration_age_weight *
+            normalized(candidate.memtable_age.ToSeconds(), max_age.ToSeconds()) +
+        FLAGS_memstore_arbitration_wal_weight *
+            normalized(candidate.wal_bytes, max_wal_bytes) +
+        FLAGS_memstore_arbitration_intents_weight *
+            normalized(candidate.intents_memtable_bytes, max_intents_bytes);
   }
+  std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.score > rhs.score;
+  });
+  return result;
+}
+
+bool TabletMemoryManager::FlushWeightedCandidates(int64_t flush_tick) {
+  const auto candidates = GetFlushCandidates();
+  const size_t usage = memory_monitor_->memory_usage();
+  const size_t limit = memory_monitor_->limit();
+  size_t active_bytes = 0;
+  for (const auto& candidate : candidates) {
+    active_bytes += candidate.memtable_bytes();
+  }
+  // Memory of immutable memtables is going to be released by flushes that are already running.
+  const size_t pending_bytes = usage > active_bytes ? usage - active_bytes : 0;
+  if (usage < limit + pending_bytes && !FLAGS_TEST_pretend_memory_exceeded_enforce_flush) {
+    return false;
+  }
+  const size_t bytes_to_release = usage - std::min(usage, limit + pending_bytes);
+
+  std::unordered_set<std::string> data_dirs;
+  size_t released_bytes = 0;
+  bool started = false;
+  for (const auto& candidate : candidates) {
+    if (started && released_bytes >= bytes_to_release) {
+      break;
+    }
+    // Flush of a single tablet per data directory, so flushes to different disks run in
+    // parallel. The next round picks the next tablet on each directory if still needed.
+    if (!data_dirs.insert(candidate.peer->tablet_metadata()->data_root_dir()).second) {
+      continue;
+    }
+    StartFlush(
+        candidate.peer, flush_tick,
+        Format("flush score $0, memtables $1, intents memtables $2, oldest write $3 ago, WAL $4",
+               candidate.score,
+               HumanReadableNumBytes::ToString(candidate.memtable_bytes()),
+               HumanReadableNumBytes::ToString(candidate.intents_memtable_bytes),
+               candidate.memtable_age,
+               HumanReadableNumBytes::ToString(candidate.wal_bytes)));
+    released_bytes += candidate.memtable_bytes();
+    started = true;
+  }
+  return started;
+}
+
+size_t TabletMemoryManager::memstore_usage() const {
+  return memory_monitor_ ? memory_monitor_->memory_usage() : 0;
+}
+
+size_t TabletMemoryManager::memstore_limit() const {
+  return memory_monitor_ ? memory_monitor_->limit() : 0;
 }
 
 // Return the tablet with the oldest write in memstore, or nullptr if all tablet memstores are
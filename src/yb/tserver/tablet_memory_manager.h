@@ -24,6 +24,8 @@
 #include "yb/tablet/tablet_options.h"
 
 #include "yb/util/background_task.h"
+#include "yb/util/cache_metrics.h"
+#include "yb/util/monotime.h"
 #include "yb/util/mem_tracker.h"
 
 namespace yb {
@@ -35,6 +37,22 @@ class TabletMemoryManagerListenerIf {
   virtual void StartedFlush(const TabletId& tablet_id) {}
 };
 
+// Memstore state of a tablet, that is considered when choosing tablets to flush.
+struct MemstoreFlushCandidate {
+  tablet::TabletPeerPtr peer;
+  uint64_t regular_memtable_bytes = 0;
+  uint64_t intents_memtable_bytes = 0;
+  // Time since the oldest write in the mutable memtables.
+  MonoDelta memtable_age;
+  // WAL size, that cannot be garbage collected until the memtables are flushed.
+  uint64_t wal_bytes = 0;
+  double score = 0;
+
+  uint64_t memtable_bytes() const {
+    return regular_memtable_bytes + intents_memtable_bytes;
+  }
+};
+
 // TabletMemoryManager keeps track of memory management for a tablet, including:
 // - Block cache initialization and tracking
 // - Log cache garbage collection
@@ -65,6 +83,13 @@ class TabletMemoryManager {
   // Flushing function for the memstore.
   void FlushTabletIfLimitExceeded();
 
+  // Returns tablets with non empty mutable memtables ordered by decreasing flush score.
+  std::vector<MemstoreFlushCandidate> GetFlushCandidates();
+
+  // Global memstore usage and limit in bytes, 0 if the limit is not enforced.
+  size_t memstore_usage() const;
+  size_t memstore_limit() const;
+
   std::vector<std::shared_ptr<TabletMemoryManagerListenerIf>> TEST_listeners;
 
  private:
@@ -76,6 +101,24 @@ class TabletMemoryManager {
       const int32_t default_block_cache_size_percentage,
       tablet::TabletOptions* options);
 
+  // Initializes the table reader cache shared by all RocksDB instances, when it is configured by
+  // db_table_reader_cache_size_bytes flag.
+  void InitTableReaderCache(tablet::TabletOptions* options);
+
+  // Initializes the compressed tier of the block cache, taking its memory from the block cache,
+  // when it is configured by db_compressed_block_cache_size_percentage flag.
+  void InitCompressedBlockCache(
+      const scoped_refptr<MetricEntity>& metrics, tablet::TabletOptions* options);
+
+  // Moves memory between the uncompressed and compressed tiers of the block cache according to
+  // the hit ratio of the compressed tier since the previous call.
+  void ResizeBlockCacheTiers();
+
+  // Initializes the secondary tier of the block cache on a local device, when it is configured by
+  // db_persistent_cache_path and db_persistent_cache_size_bytes flags.
+  void InitPersistentCache(
+      const scoped_refptr<MetricEntity>& metrics, tablet::TabletOptions* options);
+
   // Initializes the log cache garbage collector.
   void InitLogCacheGC();
 
@@ -90,6 +133,14 @@ class TabletMemoryManager {
   // if no tablet meets the criteria.  Uses peers_fn_ to determine the full list of peers to check.
   tablet::TabletPeerPtr TabletToFlush();
 
+  // Flushes the best scored tablet of each data directory, until memstore memory that is going
+  // to be released covers the amount over the limit. Returns false if no flush was started.
+  bool FlushWeightedCandidates(int64_t flush_tick);
+
+  void StartFlush(
+      const tablet::TabletPeerPtr& peer, int64_t flush_tick,
+      const std::string& reason);
+
   // Function to return a log prefix with the tablet's tablet_id and permanent_uuid.
   std::string LogPrefix(const tablet::TabletPeerPtr& peer) const;
 
@@ -102,8 +153,21 @@ class TabletMemoryManager {
 
   std::shared_ptr<GarbageCollector> block_based_table_gc_;
 
+  std::shared_ptr<GarbageCollector> compressed_block_cache_gc_;
+
+  // Block cache tiers, set when they are resized by block_cache_tiers_task_.
+  std::shared_ptr<rocksdb::Cache> block_cache_;
+  std::shared_ptr<rocksdb::Cache> compressed_block_cache_;
+  std::unique_ptr<CacheMetrics> compressed_block_cache_metrics_;
+  uint64_t prev_compressed_block_cache_hits_ = 0;
+  uint64_t prev_compressed_block_cache_misses_ = 0;
+  std::unique_ptr<BackgroundTask> block_cache_tiers_task_;
+
   std::shared_ptr<GarbageCollector> log_cache_gc_;
 
+  // Reports memory used by readers in the shared table reader cache.
+  std::shared_ptr<MemTracker> table_reader_cache_mem_tracker_;
+
   std::unique_ptr<BackgroundTask> background_task_;
 
   std::shared_ptr<rocksdb::MemoryMonitor> memory_monitor_;
@@ -84,11 +84,13 @@ DECLARE_int32(metrics_retirement_age_ms);
 DECLARE_string(block_manager);
 DECLARE_string(rpc_bind_addresses);
 DECLARE_bool(disable_clock_sync_error);
+DECLARE_bool(tablet_cpu_time_accounting);
 
 // Declare these metrics prototypes for simpler unit testing of their behavior.
 METRIC_DECLARE_counter(rows_inserted);
 METRIC_DECLARE_counter(rows_updated);
 METRIC_DECLARE_counter(rows_deleted);
+METRIC_DECLARE_counter(write_cpu_time_us);
 
 namespace yb {
 namespace tserver {
@@ -331,6 +333,21 @@ TEST_F(TabletServerTest, TestInsert) {
   ASSERT_GE(now_after.value(), now_before.value());
 }
 
+TEST_F(TabletServerTest, TestWriteCpuTimeAccounting) {
+  std::shared_ptr<TabletPeer> tablet;
+  ASSERT_TRUE(mini_server_->server()->tablet_manager()->LookupTablet(kTabletId, &tablet));
+  auto write_cpu_time_us =
+      METRIC_write_cpu_time_us.Instantiate(tablet->tablet()->GetTabletMetricsEntity());
+
+  InsertTestRowsRemote(0, 0, 100, 10);
+  ASSERT_EQ(0, write_cpu_time_us->value());
+
+  FLAGS_tablet_cpu_time_accounting = true;
+  InsertTestRowsRemote(0, 100, 1000, 10);
+  ASSERT_GT(write_cpu_time_us->value(), 0);
+  FLAGS_tablet_cpu_time_accounting = false;
+}
+
 TEST_F(TabletServerTest, TestExternalConsistencyModes_ClientPropagated) {
   WriteRequestPB req;
   req.set_tablet_id(kTabletId);
@@ -44,6 +44,8 @@
 #include "yb/client/transaction_manager.h"
 #include "yb/client/transaction_pool.h"
 
+#include "yb/docdb/docdb_rocksdb_util.h"
+
 #include "yb/fs/fs_manager.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rpc/service_if.h"
@@ -130,11 +132,29 @@ DEFINE_bool(start_pgsql_proxy, false,
             "Whether to run a PostgreSQL server as a child process of the tablet server");
 
 DEFINE_bool(tserver_enable_metrics_snapshotter, false, "Should metrics snapshotter be enabled");
+
+DEFINE_bool(maintenance_manager_use_priority_thread_pool, false,
+            "Run maintenance manager ops on the priority thread pool used by RocksDB compactions "
+            "and flushes, with priority maintenance_manager_task_priority, instead of a "
+            "separate thread pool.");
+TAG_FLAG(maintenance_manager_use_priority_thread_pool, advanced);
 DECLARE_int32(num_concurrent_backfills_allowed);
 
 namespace yb {
 namespace tserver {
 
+namespace {
+
+MaintenanceManager::Options MaintenanceManagerOptions() {
+  auto result = MaintenanceManager::DEFAULT_OPTIONS;
+  if (FLAGS_maintenance_manager_use_priority_thread_pool) {
+    result.priority_thread_pool = docdb::GetGlobalPriorityThreadPool();
+  }
+  return result;
+}
+
+} // namespace
+
 TabletServer::TabletServer(const TabletServerOptions& opts)
     : RpcAndWebServerBase(
           "TabletServer", opts, "yb.tabletserver", server::CreateMemTrackerForServer()),
@@ -142,7 +162,7 @@ TabletServer::TabletServer(const TabletServerOptions& opts)
       opts_(opts),
       tablet_manager_(new TSTabletManager(fs_manager_.get(), this, metric_registry())),
       path_handlers_(new TabletServerPathHandlers(this)),
-      maintenance_manager_(new MaintenanceManager(MaintenanceManager::DEFAULT_OPTIONS)),
+      maintenance_manager_(new MaintenanceManager(MaintenanceManagerOptions())),
       master_config_index_(0),
       tablet_server_service_(nullptr),
       shared_object_(CHECK_RESULT(TServerSharedObject::Create())) {
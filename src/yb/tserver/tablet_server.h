@@ -131,6 +131,8 @@ class TabletServer : public server::RpcAndWebServerBase, public TabletServerIf {
 
   const scoped_refptr<MetricEntity>& MetricEnt() const override { return metric_entity(); }
 
+  rpc::ProxyCache& proxy_cache() override { return RpcAndWebServerBase::proxy_cache(); }
+
   CHECKED_STATUS PopulateLiveTServers(const master::TSHeartbeatResponsePB& heartbeat_resp);
 
   CHECKED_STATUS GetLiveTServers(
@@ -48,6 +48,8 @@ class TabletServerIf : public LocalTabletServer {
   virtual client::TransactionPool* TransactionPool() = 0;
 
   virtual client::YBClient* client() = 0;
+
+  virtual rpc::ProxyCache& proxy_cache() = 0;
 };
 
 } // namespace tserver
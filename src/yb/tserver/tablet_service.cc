@@ -37,6 +37,7 @@
 #include <string>
 #include <vector>
 
+#include "yb/client/client.h"
 #include "yb/client/forward_rpc.h"
 #include "yb/client/transaction.h"
 #include "yb/client/transaction_pool.h"
@@ -67,6 +68,7 @@
 #include "yb/tablet/tablet_metrics.h"
 
 #include "yb/tablet/operations/change_metadata_operation.h"
+#include "yb/tablet/operations/import_data_operation.h"
 #include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
@@ -77,6 +79,7 @@
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/tserver/tserver_error.h"
 #include "yb/tserver/tserver.pb.h"
+#include "yb/tserver/tserver_service.proxy.h"
 
 #include "yb/util/crc.h"
 #include "yb/util/debug/long_operation_tracker.h"
@@ -345,6 +348,12 @@ void AdjustYsqlOperationTransactionality(
   }
 }
 
+void SetupError(TabletServerErrorPB* error, const Status& s) {
+  auto ts_error = TabletServerError::FromStatus(s);
+  StatusToPB(s, error->mutable_status());
+  error->set_code(ts_error ? ts_error->value() : TabletServerErrorPB::UNKNOWN_ERROR);
+}
+
 } // namespace
 
 template<class Resp>
@@ -386,6 +395,14 @@ bool TabletServiceImpl::CheckWriteThrottlingOrRespond(
     }
   }
 
+  const auto backpressure = tablet->GetWriteBackpressure();
+  if (backpressure.level > 0 && backpressure.level >= 1 - score) {
+    tablet->metrics()->write_backpressure_rejections->Increment();
+    auto message = Format("Write backpressure: $0, level: $1, score: $2",
+                          backpressure.reason, backpressure.level, score);
+    return RejectWrite(tablet_peer, message, score + backpressure.level, resp, context);
+  }
+
   if (FLAGS_TEST_write_rejection_percentage != 0 &&
       score >= 1.0 - FLAGS_TEST_write_rejection_percentage * 0.01) {
     auto status = Format("TEST: Write request rejected, desired percentage: $0, score: $1",
@@ -520,7 +537,8 @@ class ScanResultChecksummer {
 
 TabletServiceImpl::TabletServiceImpl(TabletServerIf* server)
     : TabletServerServiceIf(server->MetricEnt()),
-      server_(server) {
+      server_(server),
+      local_proxy_(std::make_unique<TabletServerServiceProxy>(&server->proxy_cache(), HostPort())) {
 }
 
 TabletServiceAdminImpl::TabletServiceAdminImpl(TabletServer* server)
@@ -1024,6 +1042,70 @@ void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
   }
 }
 
+void TabletServiceImpl::UpdateTransactions(const UpdateTransactionsRequestPB* req,
+                                           UpdateTransactionsResponsePB* resp,
+                                           rpc::RpcContext context) {
+  TRACE("UpdateTransactions");
+
+  VLOG(1) << "UpdateTransactions: " << req->ShortDebugString()
+          << ", context: " << context.ToString();
+  UpdateClock(*req, server_->Clock());
+
+  auto tablet = LookupLeaderTabletOrRespond(
+      server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
+  if (!tablet) {
+    return;
+  }
+
+  auto* coordinator = tablet.tablet->transaction_coordinator();
+  if (!coordinator) {
+    SetupErrorAndRespond(
+        resp->mutable_error(),
+        STATUS_FORMAT(InvalidArgument, "Does not have transaction coordinator: $0",
+                      req->tablet_id()),
+        &context);
+    return;
+  }
+  for (const auto& state : req->states()) {
+    if (state.status() != TransactionStatus::PENDING) {
+      SetupErrorAndRespond(
+          resp->mutable_error(),
+          STATUS_FORMAT(InvalidArgument, "Only heartbeats could be batched, but $0 found",
+                        TransactionStatus_Name(state.status())),
+          &context);
+      return;
+    }
+  }
+
+  auto clock = server_->Clock();
+  if (req->states().empty()) {
+    resp->set_propagated_hybrid_time(clock->Now().ToUint64());
+    context.RespondSuccess();
+    return;
+  }
+
+  // Each heartbeat is a separate operation, so a failure of one transaction does not affect
+  // the others. Operations submitted together are replicated by the preparer in one batch.
+  for (int i = 0; i != req->states_size(); ++i) {
+    resp->add_transaction_status();
+  }
+  auto shared_context = std::make_shared<rpc::RpcContext>(std::move(context));
+  auto num_incomplete = std::make_shared<std::atomic<int>>(req->states_size());
+  for (int i = 0; i != req->states_size(); ++i) {
+    auto operation = std::make_unique<tablet::UpdateTxnOperation>(
+        tablet.tablet.get(), &req->states(i));
+    operation->set_completion_callback(
+        [shared_context, num_incomplete, resp, clock, i](const Status& status) {
+      StatusToPB(status, resp->mutable_transaction_status(i));
+      if (num_incomplete->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        resp->set_propagated_hybrid_time(clock->Now().ToUint64());
+        shared_context->RespondSuccess();
+      }
+    });
+    coordinator->Handle(std::move(operation), tablet.leader_term);
+  }
+}
+
 template <class Req, class Resp, class Action>
 void TabletServiceImpl::PerformAtLeader(
     const Req& req, Resp* resp, rpc::RpcContext* context, const Action& action) {
@@ -1167,6 +1249,42 @@ void TabletServiceAdminImpl::CreateTablet(const CreateTabletRequestPB* req,
   }
 }
 
+void TabletServiceAdminImpl::BatchCreateTablets(const BatchCreateTabletsRequestPB* req,
+                                                BatchCreateTabletsResponsePB* resp,
+                                                rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(
+          server_->tablet_manager(), "BatchCreateTablets", req, resp, &context)) {
+    return;
+  }
+  LOG(INFO) << "Processing BatchCreateTablets for " << req->tablets_size() << " tablets";
+
+  // Creating tablet metadata writes and syncs several files, so tablets are created in parallel
+  // on the tablet open pool. Errors are reported per tablet.
+  const size_t count = req->tablets_size();
+  std::vector<Status> statuses(count);
+  CountDownLatch latch(count);
+  for (size_t i = 0; i != count; ++i) {
+    auto* tablet_resp = resp->add_tablets();
+    auto create = [this, tablet_req = &req->tablets(i), tablet_resp, status = &statuses[i],
+                   &latch] {
+      *status = DoCreateTablet(tablet_req, tablet_resp);
+      latch.CountDown();
+    };
+    auto submit_status = server_->tablet_manager()->open_tablet_pool()->SubmitFunc(create);
+    if (!submit_status.ok()) {
+      create();
+    }
+  }
+  latch.Wait();
+
+  for (size_t i = 0; i != count; ++i) {
+    if (!statuses[i].ok()) {
+      SetupError(resp->mutable_tablets(i)->mutable_error(), statuses[i]);
+    }
+  }
+  context.RespondSuccess();
+}
+
 Status TabletServiceAdminImpl::DoCreateTablet(const CreateTabletRequestPB* req,
                                               CreateTabletResponsePB* resp) {
   if (PREDICT_FALSE(FLAGS_TEST_txn_status_table_tablet_creation_delay_ms > 0 &&
@@ -1409,7 +1527,13 @@ void TabletServiceAdminImpl::GetSplitKey(
   }
 
   const auto& tablet = leader_tablet_peer.tablet;
-  const auto split_encoded_key = tablet->GetEncodedMiddleSplitKey();
+  auto split_encoded_key = req->use_key_access_samples()
+      ? tablet->GetEncodedLoadSplitKey() : tablet->GetEncodedMiddleSplitKey();
+  if (!split_encoded_key.ok() && req->use_key_access_samples()) {
+    LOG(INFO) << "Falling back to middle split key for tablet " << req->tablet_id() << ": "
+              << split_encoded_key.status();
+    split_encoded_key = tablet->GetEncodedMiddleSplitKey();
+  }
   if (split_encoded_key.ok()) {
     resp->set_split_encoded_key(*split_encoded_key);
   } else {
@@ -1473,6 +1597,99 @@ bool EmptyWriteBatch(const docdb::KeyValueWriteBatchPB& write_batch) {
   return write_batch.write_pairs().empty() && write_batch.apply_external_transactions().empty();
 }
 
+namespace {
+
+// Executes sub-requests of WriteMulti as local calls to Write and responds when all of them are
+// done.
+class WriteMultiCall : public std::enable_shared_from_this<WriteMultiCall> {
+ public:
+  WriteMultiCall(
+      const WriteMultiRequestPB* req, WriteMultiResponsePB* resp, rpc::RpcContext context)
+      : req_(*req), resp_(*resp), context_(std::move(context)),
+        controllers_(req->requests_size()), num_incomplete_(req->requests_size()) {
+    for (int i = 0; i != req->requests_size(); ++i) {
+      resp->add_responses();
+    }
+  }
+
+  void Start(TabletServerServiceProxy* proxy) {
+    const auto deadline = context_.GetClientDeadline();
+    auto self = shared_from_this();
+    for (int i = 0; i != req_.requests_size(); ++i) {
+      auto& controller = controllers_[i];
+      if (deadline != CoarseTimePoint::max()) {
+        controller.set_deadline(deadline);
+      }
+      // The last sub-request is executed in the current thread, others are queued to the service
+      // thread pool, so they are processed in parallel.
+      controller.set_allow_local_calls_in_curr_thread(i + 1 == req_.requests_size());
+      proxy->WriteAsync(
+          req_.requests(i), resp_.mutable_responses(i), &controller, [self] {
+        self->SubRequestDone();
+      });
+    }
+  }
+
+ private:
+  void SubRequestDone() {
+    if (num_incomplete_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    for (int i = 0; i != req_.requests_size(); ++i) {
+      auto status = controllers_[i].status();
+      auto& response = *resp_.mutable_responses(i);
+      if (status.ok()) {
+        status = MoveSidecars(controllers_[i], &response);
+      }
+      if (!status.ok()) {
+        response.Clear();
+        StatusToPB(status, response.mutable_error()->mutable_status());
+        response.mutable_error()->set_code(TabletServerErrorPB::UNKNOWN_ERROR);
+      }
+    }
+    context_.RespondSuccess();
+  }
+
+  // Sidecars of sub-requests are attached to the WriteMulti call, so their indexes are remapped.
+  Status MoveSidecars(const rpc::RpcController& controller, WriteResponsePB* response) {
+    for (auto& ql_response : *response->mutable_ql_response_batch()) {
+      if (ql_response.has_rows_data_sidecar()) {
+        auto sidecar = VERIFY_RESULT(controller.GetSidecar(ql_response.rows_data_sidecar()));
+        ql_response.set_rows_data_sidecar(context_.AddRpcSidecar(sidecar));
+      }
+    }
+    for (auto& pgsql_response : *response->mutable_pgsql_response_batch()) {
+      if (pgsql_response.has_rows_data_sidecar()) {
+        auto sidecar = VERIFY_RESULT(controller.GetSidecar(pgsql_response.rows_data_sidecar()));
+        pgsql_response.set_rows_data_sidecar(context_.AddRpcSidecar(sidecar));
+      }
+    }
+    return Status::OK();
+  }
+
+  const WriteMultiRequestPB& req_;
+  WriteMultiResponsePB& resp_;
+  rpc::RpcContext context_;
+  std::vector<rpc::RpcController> controllers_;
+  std::atomic<int> num_incomplete_;
+};
+
+} // namespace
+
+void TabletServiceImpl::WriteMulti(const WriteMultiRequestPB* req,
+                                   WriteMultiResponsePB* resp,
+                                   rpc::RpcContext context) {
+  TRACE("WriteMulti");
+  VLOG(2) << "Received WriteMulti RPC with " << req->requests_size() << " requests";
+
+  if (req->requests().empty()) {
+    context.RespondSuccess();
+    return;
+  }
+
+  std::make_shared<WriteMultiCall>(req, resp, std::move(context))->Start(local_proxy_.get());
+}
+
 void TabletServiceImpl::Write(const WriteRequestPB* req,
                               WriteResponsePB* resp,
                               rpc::RpcContext context) {
@@ -2100,6 +2317,11 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
 }
 
 void TabletServiceImpl::CompleteRead(ReadContext* read_context) {
+  // System tablets do not have tablet metrics.
+  auto* tablet = dynamic_cast<Tablet*>(read_context->tablet.get());
+  tablet::ScopedTabletCpuTimeTracker cpu_time_tracker(
+      tablet && tablet->metrics() ? tablet->metrics()->read_cpu_time_us
+                                  : scoped_refptr<Counter>());
   for (;;) {
     read_context->resp->Clear();
     read_context->context.ResetRpcSidecars();
@@ -2396,6 +2618,68 @@ void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
   context.RespondSuccess();
 }
 
+void ConsensusServiceImpl::MultiRaftUpdateConsensus(
+    const consensus::MultiRaftConsensusRequestPB* req,
+    consensus::MultiRaftConsensusResponsePB* resp,
+    rpc::RpcContext context) {
+  DVLOG(3) << "Received Batch Consensus Update RPC: " << req->ShortDebugString();
+  const auto& local_uuid = tablet_manager_->NodeInstance().permanent_uuid();
+  // The same checks as UpdateConsensus does, but errors are reported in the response of each
+  // request instead of responding to the whole RPC.
+  for (const auto& const_request : req->consensus_request()) {
+    auto* request = const_cast<ConsensusRequestPB*>(&const_request);
+    auto* response = resp->add_consensus_response();
+    if (PREDICT_FALSE(!request->dest_uuid().empty() && request->dest_uuid() != local_uuid)) {
+      SetupError(response->mutable_error(), STATUS_FORMAT(
+          InvalidArgument,
+          "MultiRaftUpdateConsensus: Wrong destination UUID requested. Local UUID: $0. "
+              "Requested UUID: $1",
+          local_uuid, request->dest_uuid()).CloneAndAddErrorCode(
+              TabletServerError(TabletServerErrorPB::WRONG_SERVER_UUID)));
+      continue;
+    }
+
+    TabletPeerPtr tablet_peer;
+    Status s = tablet_manager_->GetTabletPeer(request->tablet_id(), &tablet_peer);
+    if (PREDICT_FALSE(!s.ok())) {
+      SetupError(response->mutable_error(), s.CloneAndAddErrorCode(TabletServerError(
+          s.IsServiceUnavailable() ? TabletServerErrorPB::UNKNOWN_ERROR
+                                   : TabletServerErrorPB::TABLET_NOT_FOUND)));
+      continue;
+    }
+    tablet::RaftGroupStatePB state = tablet_peer->state();
+    if (PREDICT_FALSE(state != tablet::RUNNING)) {
+      SetupError(response->mutable_error(),
+                 STATUS(IllegalState, "Tablet not RUNNING", tablet::RaftGroupStateError(state))
+                     .CloneAndAddErrorCode(
+                         TabletServerError(TabletServerErrorPB::TABLET_NOT_RUNNING)));
+      continue;
+    }
+    auto consensus = tablet_peer->shared_raft_consensus();
+    if (!consensus) {
+      SetupError(response->mutable_error(),
+                 STATUS(ServiceUnavailable, "Consensus unavailable. Tablet not running")
+                     .CloneAndAddErrorCode(
+                         TabletServerError(TabletServerErrorPB::TABLET_NOT_RUNNING)));
+      continue;
+    }
+
+    s = consensus->Update(request, response, context.GetClientDeadline());
+    if (PREDICT_FALSE(!s.ok())) {
+      response->Clear();
+      SetupError(response->mutable_error(), s);
+      continue;
+    }
+
+    auto tablet = tablet_peer->shared_tablet();
+    if (tablet) {
+      response->set_num_sst_files(tablet->GetCurrentVersionNumSSTFiles());
+    }
+    response->set_propagated_hybrid_time(tablet_peer->clock().Now().ToUint64());
+  }
+  context.RespondSuccess();
+}
+
 void ConsensusServiceImpl::RequestConsensusVote(const VoteRequestPB* req,
                                                 VoteResponsePB* resp,
                                                 rpc::RpcContext context) {
@@ -2527,7 +2811,11 @@ void ConsensusServiceImpl::RunLeaderElection(const RunLeaderElectionRequestPB* r
     .must_be_committed_opid = OpId::FromPB(req->committed_index()),
     .originator_uuid = req->has_originator_uuid() ? req->originator_uuid() : std::string(),
     .suppress_vote_request = consensus::TEST_SuppressVoteRequest(req->suppress_vote_request()),
-    .initial_election = req->initial_election() });
+    .initial_election = req->initial_election(),
+    .relinquished_lease_term = req->has_leader_lease_relinquished_term()
+        ? req->leader_lease_relinquished_term() : OpId::kUnknownTerm,
+    .relinquished_lease_ht = req->has_leader_lease_relinquished_ht()
+        ? HybridTime(req->leader_lease_relinquished_ht()) : HybridTime() });
   scope.CheckStatus(s, resp);
 }
 
@@ -2745,6 +3033,24 @@ void TabletServiceImpl::ListTabletsForTabletServer(const ListTabletsForTabletSer
   context.RespondSuccess();
 }
 
+void TabletServiceImpl::GetTabletHotKeys(const GetTabletHotKeysRequestPB* req,
+                                         GetTabletHotKeysResponsePB* resp,
+                                         rpc::RpcContext context) {
+  auto peer = VERIFY_RESULT_OR_RETURN(LookupTabletPeerOrRespond(
+      server_->tablet_peer_lookup(), req->tablet_id(), resp, &context));
+
+  auto& load_tracker = peer.tablet->load_tracker();
+  for (bool write : {false, true}) {
+    for (const auto& entry : load_tracker.TopHotKeys(write, req->max_keys())) {
+      auto* hot_key = write ? resp->add_write_keys() : resp->add_read_keys();
+      hot_key->set_key(entry.key);
+      hot_key->set_count(entry.count);
+      hot_key->set_error(entry.error);
+    }
+  }
+  context.RespondSuccess();
+}
+
 namespace {
 
 Result<uint64_t> CalcChecksum(tablet::Tablet* tablet, CoarseTimePoint deadline) {
@@ -2792,6 +3098,27 @@ void TabletServiceImpl::Checksum(const ChecksumRequestPB* req,
 void TabletServiceImpl::ImportData(const ImportDataRequestPB* req,
                                    ImportDataResponsePB* resp,
                                    rpc::RpcContext context) {
+  if (req->replicated()) {
+    TRACE("ImportData");
+
+    UpdateClock(*req, server_->Clock());
+
+    auto tablet = LookupLeaderTabletOrRespond(
+        server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
+    if (!tablet) {
+      return;
+    }
+
+    auto operation = std::make_unique<ImportDataOperation>(tablet.peer->tablet(), req);
+
+    operation->set_completion_callback(
+        MakeRpcOperationCompletionCallback(std::move(context), resp, server_->Clock()));
+
+    // Submit the import data op. The RPC will be responded to asynchronously.
+    tablet.peer->Submit(std::move(operation), tablet.leader_term);
+    return;
+  }
+
   auto peer = VERIFY_RESULT_OR_RETURN(LookupTabletPeerOrRespond(
       server_->tablet_peer_lookup(), req->tablet_id(), resp, &context));
 
@@ -2843,6 +3170,101 @@ void TabletServiceImpl::TakeTransaction(const TakeTransactionRequestPB* req,
   context.RespondSuccess();
 }
 
+void TabletServiceImpl::GetYsqlTableSchema(const GetYsqlTableSchemaRequestPB* req,
+                                           GetYsqlTableSchemaResponsePB* resp,
+                                           rpc::RpcContext context) {
+  const TableId& table_id = req->table_id();
+  {
+    std::lock_guard<std::mutex> lock(ysql_table_schemas_mutex_);
+    auto it = ysql_table_schemas_.find(table_id);
+    if (it != ysql_table_schemas_.end() && !req->force_refresh() &&
+        it->second.catalog_version >= req->ysql_catalog_version()) {
+      resp->set_table_schema(it->second.table_schema);
+      context.RespondSuccess();
+      return;
+    }
+  }
+
+  // Read the version before fetching, so the entry never claims to be newer than its schema.
+  uint64_t catalog_version = 0;
+  server_->get_ysql_catalog_version(&catalog_version, nullptr /* last_breaking_version */);
+  master::GetTableSchemaResponsePB schema_resp;
+  auto status = server_->client()->GetTableSchemaById(table_id, &schema_resp);
+  if (!status.ok()) {
+    {
+      std::lock_guard<std::mutex> lock(ysql_table_schemas_mutex_);
+      ysql_table_schemas_.erase(table_id);
+    }
+    SetupErrorAndRespond(resp->mutable_error(), status, &context);
+    return;
+  }
+
+  auto* table_schema = resp->mutable_table_schema();
+  schema_resp.SerializeToString(table_schema);
+  {
+    std::lock_guard<std::mutex> lock(ysql_table_schemas_mutex_);
+    auto& entry = ysql_table_schemas_[table_id];
+    // Concurrent requests could have stored a schema fetched at a later version meanwhile.
+    if (entry.table_schema.empty() || entry.catalog_version <= catalog_version) {
+      entry.catalog_version = catalog_version;
+      entry.table_schema = *table_schema;
+    }
+  }
+  context.RespondSuccess();
+}
+
+void TabletServiceImpl::TakeYsqlSequenceValues(const TakeYsqlSequenceValuesRequestPB* req,
+                                               TakeYsqlSequenceValuesResponsePB* resp,
+                                               rpc::RpcContext context) {
+  int64_t first_value = 0;
+  int64_t count = 0;
+  {
+    std::lock_guard<std::mutex> lock(ysql_sequence_values_mutex_);
+    auto it = ysql_sequence_values_.find(std::make_pair(req->db_oid(), req->seq_oid()));
+    if (it != ysql_sequence_values_.end()) {
+      auto& values = it->second;
+      if (values.catalog_version < req->ysql_catalog_version() ||
+          values.increment != req->increment()) {
+        // The sequence could have been altered after the values were claimed.
+        ysql_sequence_values_.erase(it);
+      } else if (values.catalog_version == req->ysql_catalog_version() &&
+                 !values.ranges.empty()) {
+        auto& range = values.ranges.front();
+        first_value = range.first;
+        count = std::min(range.second, std::max<int64_t>(req->max_count(), 1));
+        range.first += count * values.increment;
+        range.second -= count;
+        if (range.second == 0) {
+          values.ranges.pop_front();
+        }
+      }
+    }
+  }
+  resp->set_first_value(first_value);
+  resp->set_count(count);
+  context.RespondSuccess();
+}
+
+void TabletServiceImpl::PutYsqlSequenceValues(const PutYsqlSequenceValuesRequestPB* req,
+                                              PutYsqlSequenceValuesResponsePB* resp,
+                                              rpc::RpcContext context) {
+  if (req->count() > 0 && req->increment() != 0) {
+    std::lock_guard<std::mutex> lock(ysql_sequence_values_mutex_);
+    auto& values = ysql_sequence_values_[std::make_pair(req->db_oid(), req->seq_oid())];
+    if (values.ranges.empty() || values.catalog_version < req->ysql_catalog_version() ||
+        values.increment != req->increment()) {
+      values.catalog_version = req->ysql_catalog_version();
+      values.increment = req->increment();
+      values.ranges.clear();
+    }
+    // Values claimed by a backend at an older catalog version are dropped.
+    if (values.catalog_version == req->ysql_catalog_version()) {
+      values.ranges.emplace_back(req->first_value(), req->count());
+    }
+  }
+  context.RespondSuccess();
+}
+
 void TabletServiceImpl::Shutdown() {
 }
 
@@ -32,8 +32,12 @@
 #ifndef YB_TSERVER_TABLET_SERVICE_H_
 #define YB_TSERVER_TABLET_SERVICE_H_
 
+#include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "yb/common/read_hybrid_time.h"
@@ -72,6 +76,10 @@ class TabletServiceImpl : public TabletServerServiceIf {
 
   void Write(const WriteRequestPB* req, WriteResponsePB* resp, rpc::RpcContext context) override;
 
+  void WriteMulti(
+      const WriteMultiRequestPB* req, WriteMultiResponsePB* resp,
+      rpc::RpcContext context) override;
+
   void Read(const ReadRequestPB* req, ReadResponsePB* resp, rpc::RpcContext context) override;
 
   void NoOp(const NoOpRequestPB* req, NoOpResponsePB* resp, rpc::RpcContext context) override;
@@ -91,6 +99,10 @@ class TabletServiceImpl : public TabletServerServiceIf {
                                   ListTabletsForTabletServerResponsePB* resp,
                                   rpc::RpcContext context) override;
 
+  void GetTabletHotKeys(const GetTabletHotKeysRequestPB* req,
+                        GetTabletHotKeysResponsePB* resp,
+                        rpc::RpcContext context) override;
+
   void GetLogLocation(
       const GetLogLocationRequestPB* req,
       GetLogLocationResponsePB* resp,
@@ -108,6 +120,10 @@ class TabletServiceImpl : public TabletServerServiceIf {
                          UpdateTransactionResponsePB* resp,
                          rpc::RpcContext context) override;
 
+  void UpdateTransactions(const UpdateTransactionsRequestPB* req,
+                          UpdateTransactionsResponsePB* resp,
+                          rpc::RpcContext context) override;
+
   void GetTransactionStatus(const GetTransactionStatusRequestPB* req,
                             GetTransactionStatusResponsePB* resp,
                             rpc::RpcContext context) override;
@@ -136,6 +152,18 @@ class TabletServiceImpl : public TabletServerServiceIf {
                        TakeTransactionResponsePB* resp,
                        rpc::RpcContext context) override;
 
+  void GetYsqlTableSchema(const GetYsqlTableSchemaRequestPB* req,
+                          GetYsqlTableSchemaResponsePB* resp,
+                          rpc::RpcContext context) override;
+
+  void TakeYsqlSequenceValues(const TakeYsqlSequenceValuesRequestPB* req,
+                              TakeYsqlSequenceValuesResponsePB* resp,
+                              rpc::RpcContext context) override;
+
+  void PutYsqlSequenceValues(const PutYsqlSequenceValuesRequestPB* req,
+                             PutYsqlSequenceValuesResponsePB* resp,
+                             rpc::RpcContext context) override;
+
   void Shutdown() override;
 
  private:
@@ -186,6 +214,35 @@ class TabletServiceImpl : public TabletServerServiceIf {
   void UpdateConsistentPrefixMetrics(ReadContext* read_context);
 
   TabletServerIf *const server_;
+
+  // Proxy to this service that is used to dispatch sub-requests of WriteMulti as local calls.
+  std::unique_ptr<TabletServerServiceProxy> local_proxy_;
+
+  // Schema of a YSQL table cached for the postgres backends of this node.
+  struct YsqlTableSchemaEntry {
+    // Catalog version of this tserver read before the schema was fetched from the master.
+    uint64_t catalog_version;
+    // Serialized master::GetTableSchemaResponsePB.
+    std::string table_schema;
+  };
+
+  std::mutex ysql_table_schemas_mutex_;
+  std::unordered_map<TableId, YsqlTableSchemaEntry> ysql_table_schemas_
+      GUARDED_BY(ysql_table_schemas_mutex_);
+
+  // Values of a YSQL sequence claimed in the sequences table by a local backend and not used yet.
+  struct YsqlSequenceValues {
+    // Catalog version and increment of the sequence when the values were claimed.
+    uint64_t catalog_version = 0;
+    int64_t increment = 0;
+    // Ranges of values, as pairs of first value and number of values.
+    std::deque<std::pair<int64_t, int64_t>> ranges;
+  };
+
+  std::mutex ysql_sequence_values_mutex_;
+  // Keyed by database oid and sequence oid.
+  std::map<std::pair<uint32_t, uint32_t>, YsqlSequenceValues> ysql_sequence_values_
+      GUARDED_BY(ysql_sequence_values_mutex_);
 };
 
 class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
@@ -197,6 +254,12 @@ class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
                     CreateTabletResponsePB* resp,
                     rpc::RpcContext context) override;
 
+  // Creates multiple tablets in parallel, used by the master when creating tables with many
+  // tablets.
+  void BatchCreateTablets(const BatchCreateTabletsRequestPB* req,
+                          BatchCreateTabletsResponsePB* resp,
+                          rpc::RpcContext context) override;
+
   void DeleteTablet(const DeleteTabletRequestPB* req,
                     DeleteTabletResponsePB* resp,
                     rpc::RpcContext context) override;
@@ -276,6 +339,10 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                consensus::ConsensusResponsePB *resp,
                                rpc::RpcContext context) override;
 
+  void MultiRaftUpdateConsensus(const consensus::MultiRaftConsensusRequestPB *req,
+                                consensus::MultiRaftConsensusResponsePB *resp,
+                                rpc::RpcContext context) override;
+
   virtual void RequestConsensusVote(const consensus::VoteRequestPB* req,
                                     consensus::VoteResponsePB* resp,
                                     rpc::RpcContext context) override;
@@ -61,6 +61,7 @@
   ASSERT_NO_FATALS(AssertMonotonicReportSeqno(report_seqno, tablet_report))
 
 DECLARE_bool(TEST_pretend_memory_exceeded_enforce_flush);
+DECLARE_bool(enable_weighted_memstore_arbitration);
 
 namespace yb {
 namespace tserver {
@@ -135,6 +136,8 @@ class TsTabletManagerTest : public YBTest {
   }
 
  protected:
+  void TestProperBackgroundFlushOnStartup();
+
   std::unique_ptr<MiniTabletServer> mini_server_;
   FsManager* fs_manager_;
   TSTabletManager* tablet_manager_;
@@ -258,7 +261,7 @@ TEST_F(TsTabletManagerTest, TestTombstonedTabletsAreUnregistered) {
   assert_tablet_assignment_count(kTabletId2, 1);
 }
 
-TEST_F(TsTabletManagerTest, TestProperBackgroundFlushOnStartup) {
+void TsTabletManagerTest::TestProperBackgroundFlushOnStartup() {
   FlagSaver flag_saver;
   FLAGS_TEST_pretend_memory_exceeded_enforce_flush = true;
 
@@ -303,6 +306,15 @@ TEST_F(TsTabletManagerTest, TestProperBackgroundFlushOnStartup) {
   }
 }
 
+TEST_F(TsTabletManagerTest, TestProperBackgroundFlushOnStartup) {
+  TestProperBackgroundFlushOnStartup();
+}
+
+TEST_F(TsTabletManagerTest, TestProperBackgroundFlushOnStartupWeightedArbitration) {
+  FLAGS_enable_weighted_memstore_arbitration = true;
+  TestProperBackgroundFlushOnStartup();
+}
+
 static void AssertMonotonicReportSeqno(int64_t* report_seqno,
                                        const TabletReportPB &report) {
   ASSERT_LT(*report_seqno, report.sequence_number());
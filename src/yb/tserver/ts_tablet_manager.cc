@@ -38,6 +38,7 @@
 #include <mutex>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <vector>
 
 #include <boost/optional/optional.hpp>
@@ -187,6 +188,12 @@ DEFINE_int32(verify_tablet_data_interval_sec, 0,
 DEFINE_bool(skip_tablet_data_verification, false,
             "Skip checking tablet data for corruption.");
 
+DEFINE_int32(block_cache_save_interval_sec, 0,
+             "Interval at which data blocks of leader tablets present in the block cache are saved "
+             "to the tablet directories. Saved blocks are loaded into the block cache when the "
+             "tablet becomes leader, e.g. after restart. 0 to disable saving and warming up.");
+TAG_FLAG(block_cache_save_interval_sec, advanced);
+
 DEFINE_int32(read_pool_max_threads, 128,
              "The maximum number of threads allowed for read_pool_. This pool is used "
              "to run multiple read operations, that are part of the same tablet rpc, "
@@ -218,6 +225,33 @@ DEFINE_int32(tserver_yb_client_default_timeout_ms, kTServerYbClientDefaultTimeou
 DEFINE_bool(enable_restart_transaction_status_tablets_first, true,
             "Set to true to prioritize bootstrapping transaction status tablets first.");
 
+DEFINE_int32(cold_tablet_idle_secs, 0,
+             "Tablets whose WAL segments were not modified for this number of seconds are "
+             "considered cold at tablet server startup. Cold tablets are opened after all other "
+             "tablets and do not read SST file properties while opening RocksDB. 0 disables it.");
+TAG_FLAG(cold_tablet_idle_secs, advanced);
+
+DEFINE_bool(prioritize_tablet_open_by_replay_cost, false,
+            "At tablet server startup, open tablets this server was probably leader for first, "
+            "then the other tablets in ascending order of WAL size, so tablets that are fast to "
+            "bootstrap become available early.");
+TAG_FLAG(prioritize_tablet_open_by_replay_cost, advanced);
+
+DEFINE_bool(tablet_report_omit_unchanged_consensus_state, false,
+            "Omit committed consensus state from incremental tablet reports for tablets whose "
+            "state and committed consensus state did not change since the report acknowledged by "
+            "the master, so the master does not process it again.");
+TAG_FLAG(tablet_report_omit_unchanged_consensus_state, advanced);
+TAG_FLAG(tablet_report_omit_unchanged_consensus_state, runtime);
+
+DEFINE_bool(tablet_dir_placement_by_disk_usage, false,
+            "When choosing the data and WAL directories of a new tablet among the directories "
+            "with the fewest tablets of its table, pick the one where the tablets of all tables "
+            "use the least disk space, then the one with the most free space, instead of the "
+            "first one.");
+TAG_FLAG(tablet_dir_placement_by_disk_usage, advanced);
+TAG_FLAG(tablet_dir_placement_by_disk_usage, runtime);
+
 namespace yb {
 namespace tserver {
 
@@ -346,6 +380,10 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
                .set_min_threads(1)
                .unlimited_threads()
                .Build(&raft_pool_));
+  CHECK_OK(ThreadPoolBuilder("raft-apply")
+               .set_min_threads(1)
+               .unlimited_threads()
+               .Build(&raft_apply_pool_));
   CHECK_OK(ThreadPoolBuilder("prepare")
                .set_min_threads(1)
                .unlimited_threads()
@@ -380,6 +418,14 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
               .set_metrics(THREAD_POOL_METRICS_INSTANCE(
                   server_->metric_entity(), admin_triggered_compaction_pool))
               .Build(&admin_triggered_compaction_pool_));
+  // A single thread, so warm up reads compete with queries for the disk as little as possible.
+  CHECK_OK(ThreadPoolBuilder("block-cache-warm-up")
+              .set_max_threads(1)
+              .Build(&block_cache_warm_up_pool_));
+  // Separate from the warm up pool, so rate limited warm up does not delay saving.
+  CHECK_OK(ThreadPoolBuilder("block-cache-save")
+              .set_max_threads(1)
+              .Build(&block_cache_save_pool_));
 
   mem_manager_ = std::make_shared<TabletMemoryManager>(
       &tablet_options_,
@@ -392,6 +438,88 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
 TSTabletManager::~TSTabletManager() {
 }
 
+namespace {
+
+// Returns true if none of the WAL segments of the tablet was modified during last idle_secs.
+// Any error is treated as a hot tablet.
+bool IsColdTablet(Env* env, const RaftGroupMetadata& meta, int32_t idle_secs, int64_t now_secs) {
+  const auto& wal_dir = meta.wal_dir();
+  std::vector<std::string> children;
+  if (!env->GetChildren(wal_dir, ExcludeDots::kTrue, &children).ok()) {
+    return false;
+  }
+  bool has_segments = false;
+  for (const auto& child : children) {
+    if (!log::IsLogFileName(child)) {
+      continue;
+    }
+    auto mtime = env->GetFileModificationTime(JoinPathSegments(wal_dir, child));
+    if (!mtime.ok() || now_secs - static_cast<int64_t>(*mtime) < idle_secs) {
+      return false;
+    }
+    has_segments = true;
+  }
+  return has_segments;
+}
+
+// Total size of WAL segments, i.e. an estimate of the tablet bootstrap cost.
+uint64_t WalSegmentsSize(Env* env, const RaftGroupMetadata& meta) {
+  const auto& wal_dir = meta.wal_dir();
+  std::vector<std::string> children;
+  if (!env->GetChildren(wal_dir, ExcludeDots::kTrue, &children).ok()) {
+    return 0;
+  }
+  uint64_t result = 0;
+  for (const auto& child : children) {
+    if (log::IsLogFileName(child)) {
+      auto size = env->GetFileSize(JoinPathSegments(wal_dir, child));
+      if (size.ok()) {
+        result += *size;
+      }
+    }
+  }
+  return result;
+}
+
+// Leader is not persisted, but a peer votes for itself only when it runs an election, so having
+// voted for itself in the last known term means it was most likely the leader.
+bool VotedForItself(FsManager* fs_manager, const TabletId& tablet_id) {
+  std::unique_ptr<ConsensusMetadata> cmeta;
+  if (!ConsensusMetadata::Load(fs_manager, tablet_id, fs_manager->uuid(), &cmeta).ok()) {
+    return false;
+  }
+  return cmeta->has_voted_for() && cmeta->voted_for() == fs_manager->uuid();
+}
+
+} // namespace
+
+void TSTabletManager::SortTabletsToOpen(std::deque<RaftGroupMetadataPtr>* metas) {
+  struct Candidate {
+    RaftGroupMetadataPtr meta;
+    bool transaction_status;
+    bool voted_for_itself;
+    uint64_t wal_size;
+  };
+  std::vector<Candidate> candidates;
+  candidates.reserve(metas->size());
+  for (auto& meta : *metas) {
+    const bool transaction_status = FLAGS_enable_restart_transaction_status_tablets_first &&
+                                    meta->table_type() == TRANSACTION_STATUS_TABLE_TYPE;
+    const bool voted_for_itself = VotedForItself(fs_manager_, meta->raft_group_id());
+    const uint64_t wal_size = WalSegmentsSize(fs_manager_->env(), *meta);
+    candidates.push_back({std::move(meta), transaction_status, voted_for_itself, wal_size});
+  }
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const Candidate& lhs, const Candidate& rhs) {
+    return std::make_tuple(!lhs.transaction_status, !lhs.voted_for_itself, lhs.wal_size) <
+           std::make_tuple(!rhs.transaction_status, !rhs.voted_for_itself, rhs.wal_size);
+  });
+  metas->clear();
+  for (auto& candidate : candidates) {
+    metas->push_back(std::move(candidate.meta));
+  }
+}
+
 Status TSTabletManager::Init() {
   CHECK_EQ(state(), MANAGER_INITIALIZING);
 
@@ -444,6 +572,10 @@ Status TSTabletManager::Init() {
   InitLocalRaftPeerPB();
 
   deque<RaftGroupMetadataPtr> metas;
+  vector<RaftGroupMetadataPtr> cold_metas;
+  const int32_t cold_tablet_idle_secs = FLAGS_cold_tablet_idle_secs;
+  const int64_t now_secs = std::chrono::duration_cast<std::chrono::seconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
 
   // First, load all of the tablet metadata. We do this before we start
   // submitting the actual OpenTablet() tasks so that we don't have to compete
@@ -460,6 +592,12 @@ Status TSTabletManager::Init() {
     RegisterDataAndWalDir(
         fs_manager_, meta->table_id(), meta->raft_group_id(), meta->data_root_dir(),
         meta->wal_root_dir());
+    if (cold_tablet_idle_secs > 0 && meta->table_type() != TRANSACTION_STATUS_TABLE_TYPE &&
+        IsColdTablet(fs_manager_->env(), *meta, cold_tablet_idle_secs, now_secs)) {
+      // Cold tablets are opened last, so they don't delay tablets that serve traffic.
+      cold_metas.push_back(meta);
+      continue;
+    }
     if (FLAGS_enable_restart_transaction_status_tablets_first) {
       // Prioritize bootstrapping transaction status tablets first.
       if (meta->table_type() == TRANSACTION_STATUS_TABLE_TYPE) {
@@ -475,16 +613,30 @@ Status TSTabletManager::Init() {
   MonoDelta elapsed = MonoTime::Now().GetDeltaSince(start);
   LOG(INFO) << "Loaded metadata for " << tablet_ids.size() << " tablet in "
             << elapsed.ToMilliseconds() << " ms";
+  if (!cold_metas.empty()) {
+    LOG(INFO) << "Found " << cold_metas.size() << " cold tablets, they will be opened last";
+  }
+
+  if (FLAGS_prioritize_tablet_open_by_replay_cost) {
+    SortTabletsToOpen(&metas);
+  }
 
   // Now submit the "Open" task for each.
-  for (const RaftGroupMetadataPtr& meta : metas) {
+  const size_t num_hot_tablets = metas.size();
+  metas.insert(metas.end(), cold_metas.begin(), cold_metas.end());
+  num_tablets_to_open_at_startup_.store(metas.size(), std::memory_order_release);
+  for (size_t i = 0; i != metas.size(); ++i) {
+    const RaftGroupMetadataPtr& meta = metas[i];
     scoped_refptr<TransitionInProgressDeleter> deleter;
     RETURN_NOT_OK(StartTabletStateTransition(
         meta->raft_group_id(), "opening tablet", &deleter));
 
     TabletPeerPtr tablet_peer = VERIFY_RESULT(CreateAndRegisterTabletPeer(meta, NEW_PEER));
     RETURN_NOT_OK(open_tablet_pool_->SubmitFunc(
-        std::bind(&TSTabletManager::OpenTablet, this, meta, deleter)));
+        [this, meta, deleter, cold_tablet = ColdTablet(i >= num_hot_tablets)] {
+      OpenTablet(meta, deleter, cold_tablet);
+      num_tablets_opened_at_startup_.fetch_add(1, std::memory_order_acq_rel);
+    }));
   }
 
   {
@@ -500,6 +652,9 @@ Status TSTabletManager::Init() {
   verify_tablet_data_poller_ = std::make_unique<rpc::Poller>(
       LogPrefix(), std::bind(&TSTabletManager::VerifyTabletData, this));
 
+  save_cached_data_blocks_poller_ = std::make_unique<rpc::Poller>(
+      LogPrefix(), std::bind(&TSTabletManager::SaveCachedDataBlocks, this));
+
   return Status::OK();
 }
 
@@ -551,6 +706,11 @@ Status TSTabletManager::Start() {
     LOG(INFO)
         << "Tablet data verification is disabled by verify_tablet_data_interval_sec flag set to 0";
   }
+  if (FLAGS_block_cache_save_interval_sec > 0) {
+    save_cached_data_blocks_poller_->Start(
+        &server_->messenger()->scheduler(), FLAGS_block_cache_save_interval_sec * 1s);
+    LOG(INFO) << "Saving of cached data blocks started...";
+  }
 
   return Status::OK();
 }
@@ -665,7 +825,8 @@ Result<TabletPeerPtr> TSTabletManager::CreateNewTablet(
 
   // We can run this synchronously since there is nothing to bootstrap.
   RETURN_NOT_OK(
-      open_tablet_pool_->SubmitFunc(std::bind(&TSTabletManager::OpenTablet, this, meta, deleter)));
+      open_tablet_pool_->SubmitFunc(std::bind(
+          &TSTabletManager::OpenTablet, this, meta, deleter, ColdTablet::kFalse)));
 
   return new_peer;
 }
@@ -779,7 +940,8 @@ void TSTabletManager::CreatePeerAndOpenTablet(
     }
     return;
   }
-  s = open_tablet_pool_->SubmitFunc(std::bind(&TSTabletManager::OpenTablet, this, meta, deleter));
+  s = open_tablet_pool_->SubmitFunc(std::bind(
+      &TSTabletManager::OpenTablet, this, meta, deleter, ColdTablet::kFalse));
   if (!s.ok()) {
     LOG(DFATAL) << Format("Failed to schedule opening tablet $0: $1", meta->table_id(), s);
     return;
@@ -1306,7 +1468,8 @@ Status TSTabletManager::OpenTabletMeta(const string& tablet_id,
 }
 
 void TSTabletManager::OpenTablet(const RaftGroupMetadataPtr& meta,
-                                 const scoped_refptr<TransitionInProgressDeleter>& deleter) {
+                                 const scoped_refptr<TransitionInProgressDeleter>& deleter,
+                                 ColdTablet cold_tablet) {
   string tablet_id = meta->raft_group_id();
   TRACE_EVENT1("tserver", "TSTabletManager::OpenTablet",
                "tablet_id", tablet_id);
@@ -1367,6 +1530,10 @@ void TSTabletManager::OpenTablet(const RaftGroupMetadataPtr& meta,
       .allowed_history_cutoff_provider = std::bind(
           &TSTabletManager::AllowedHistoryCutoff, this, _1),
     };
+    if (cold_tablet) {
+      // Statistics would be computed from SST file properties, that costs a read per file.
+      tablet_init_data.tablet_options.skip_stats_update_on_db_open = true;
+    }
     tablet::BootstrapTabletData data = {
       .tablet_init_data = tablet_init_data,
       .listener = tablet_peer->status_listener(),
@@ -1395,6 +1562,7 @@ void TSTabletManager::OpenTablet(const RaftGroupMetadataPtr& meta,
         tablet->GetTabletMetricsEntity(),
         raft_pool(),
         tablet_prepare_pool(),
+        raft_apply_pool(),
         &retryable_requests);
 
     if (!s.ok()) {
@@ -1479,6 +1647,8 @@ void TSTabletManager::StartShutdown() {
 
   verify_tablet_data_poller_->Shutdown();
 
+  save_cached_data_blocks_poller_->Shutdown();
+
   async_client_init_->Shutdown();
 
   mem_manager_->Shutdown();
@@ -1540,6 +1710,9 @@ void TSTabletManager::CompleteShutdown() {
   if (raft_pool_) {
     raft_pool_->Shutdown();
   }
+  if (raft_apply_pool_) {
+    raft_apply_pool_->Shutdown();
+  }
   if (tablet_prepare_pool_) {
     tablet_prepare_pool_->Shutdown();
   }
@@ -1552,6 +1725,12 @@ void TSTabletManager::CompleteShutdown() {
   if (admin_triggered_compaction_pool_) {
     admin_triggered_compaction_pool_->Shutdown();
   }
+  if (block_cache_warm_up_pool_) {
+    block_cache_warm_up_pool_->Shutdown();
+  }
+  if (block_cache_save_pool_) {
+    block_cache_save_pool_->Shutdown();
+  }
 
   {
     std::lock_guard<RWMutex> l(mutex_);
@@ -1702,12 +1881,48 @@ TSTabletManager::TabletPeers TSTabletManager::GetTabletPeers() const {
 
 void TSTabletManager::ApplyChange(const string& tablet_id,
                                   shared_ptr<consensus::StateChangeContext> context) {
+  if (FLAGS_block_cache_save_interval_sec > 0 &&
+      context->reason == consensus::StateChangeReason::NEW_LEADER_ELECTED &&
+      context->new_leader_uuid == fs_manager_->uuid()) {
+    WarmUpBlockCache(tablet_id);
+  }
   WARN_NOT_OK(
       apply_pool_->SubmitFunc(
           std::bind(&TSTabletManager::MarkTabletDirty, this, tablet_id, context)),
       "Unable to run MarkDirty callback")
 }
 
+void TSTabletManager::SaveCachedDataBlocks() {
+  // Only leaders serve reads, so followers keep data blocks saved while they were leaders.
+  WARN_NOT_OK(block_cache_save_pool_->SubmitFunc([this] {
+    for (const TabletPeerPtr& peer : GetTabletPeers()) {
+      if (peer->state() != RUNNING ||
+          peer->LeaderStatus() != consensus::LeaderStatus::LEADER_AND_READY) {
+        continue;
+      }
+      auto tablet = peer->shared_tablet();
+      if (tablet) {
+        WARN_NOT_OK(tablet->SaveCachedDataBlocks(),
+                    TabletLogPrefix(peer->tablet_id()) + "Failed to save cached data blocks");
+      }
+    }
+  }), "Failed to submit saving of cached data blocks");
+}
+
+void TSTabletManager::WarmUpBlockCache(const TabletId& tablet_id) {
+  WARN_NOT_OK(block_cache_warm_up_pool_->SubmitFunc([this, tablet_id] {
+    TabletPeerPtr peer;
+    if (!LookupTablet(tablet_id, &peer)) {
+      return;
+    }
+    auto tablet = peer->shared_tablet();
+    if (tablet) {
+      WARN_NOT_OK(tablet->WarmUpBlockCache(),
+                  TabletLogPrefix(tablet_id) + "Failed to warm up block cache");
+    }
+  }), TabletLogPrefix(tablet_id) + "Failed to submit block cache warm up");
+}
+
 void TSTabletManager::MarkTabletDirty(const TabletId& tablet_id,
                                       std::shared_ptr<consensus::StateChangeContext> context) {
   std::lock_guard<RWMutex> lock(mutex_);
@@ -1918,6 +2133,7 @@ void TSTabletManager::GenerateTabletReport(TabletReportPB* report, bool include_
         report->add_removed_tablet_ids(tablet_id);
         // Don't count this as a 'dirty_tablet_' because the Master may not have it either.
         dirty_tablets_.erase(tablet_id);
+        reported_consensus_states_.erase(tablet_id);
       }
     }
     dirty_count = dirty_tablets_.size();
@@ -1929,6 +2145,42 @@ void TSTabletManager::GenerateTabletReport(TabletReportPB* report, bool include_
     if (report->updated_tablets_size() >= report_limit) break;
   }
   report->set_remaining_tablet_count(dirty_count - report->updated_tablets_size());
+
+  if (FLAGS_tablet_report_omit_unchanged_consensus_state) {
+    OmitUnchangedConsensusStates(report);
+  }
+}
+
+void TSTabletManager::OmitUnchangedConsensusStates(TabletReportPB* report) {
+  std::lock_guard<RWMutex> lock(mutex_);
+  for (auto& reported_tablet : *report->mutable_updated_tablets()) {
+    if (!reported_tablet.has_committed_consensus_state()) {
+      continue;
+    }
+    // State and data state are part of the fingerprint, because the master updates the replica
+    // only together with consensus state.
+    std::string fingerprint;
+    fingerprint.push_back(static_cast<char>(reported_tablet.state()));
+    fingerprint.push_back(static_cast<char>(reported_tablet.tablet_data_state()));
+    reported_tablet.committed_consensus_state().AppendToString(&fingerprint);
+
+    auto& reported_state = reported_consensus_states_[reported_tablet.tablet_id()];
+    if (reported_state.acked_fingerprint == fingerprint) {
+      reported_tablet.clear_committed_consensus_state();
+      reported_tablet.set_committed_consensus_state_unchanged(true);
+      continue;
+    }
+    // Master could process this report even if we don't receive the response, so the acked
+    // state is not known until this report is acknowledged.
+    reported_state.acked_fingerprint.clear();
+    reported_state.sent_seq = report->sequence_number();
+    reported_state.sent_fingerprint = std::move(fingerprint);
+  }
+}
+
+void TSTabletManager::ResetReportedConsensusStates() {
+  std::lock_guard<RWMutex> lock(mutex_);
+  reported_consensus_states_.clear();
 }
 
 void TSTabletManager::StartFullTabletReport(TabletReportPB* report) {
@@ -1944,6 +2196,8 @@ void TSTabletManager::StartFullTabletReport(TabletReportPB* report) {
     std::lock_guard<RWMutex> write_lock(mutex_);
     uint32_t cur_report_seq = next_report_seq_++;
     report->set_sequence_number(cur_report_seq);
+    // Master drops everything it knows about this server on a full report.
+    reported_consensus_states_.clear();
     GetTabletPeersUnlocked(&to_report);
     // Mark all tablets as dirty, to be cleaned when reading the heartbeat response.
     for (const auto& peer : to_report) {
@@ -1978,6 +2232,12 @@ void TSTabletManager::MarkTabletReportAcknowledged(int32_t acked_seq,
         dirty_tablets_.erase(it);
       }
     }
+    auto reported_it = reported_consensus_states_.find(tablet.tablet_id());
+    if (reported_it != reported_consensus_states_.end() &&
+        reported_it->second.sent_seq == acked_seq) {
+      reported_it->second.acked_fingerprint = std::move(reported_it->second.sent_fingerprint);
+      reported_it->second.sent_fingerprint.clear();
+    }
   }
 #ifndef NDEBUG
   // Verify dirty_tablets_ always processes all tablet changes.
@@ -2058,6 +2318,13 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
   }
   LOG(INFO) << "Get and update data/wal directory assignment map for table: " \
             << table_id << " and tablet " << tablet_id;
+  boost::optional<RootDirUsage> data_dir_usage;
+  boost::optional<RootDirUsage> wal_dir_usage;
+  if (FLAGS_tablet_dir_placement_by_disk_usage) {
+    // Collected before locking dir_assignment_mutex_, since it locks mutex_ to list the tablets.
+    data_dir_usage = GetRootDirUsage(TabletDirType::kData);
+    wal_dir_usage = GetRootDirUsage(TabletDirType::kWal);
+  }
   std::lock_guard<std::mutex> dir_assignment_lock(dir_assignment_mutex_);
   // Initialize the map if the directory mapping does not exist.
   auto data_root_dirs = fs_manager->GetDataRootDirs();
@@ -2070,24 +2337,12 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
     }
   }
   // Find the data directory with the least count of tablets for this table.
-  table_data_assignment_iter = table_data_assignment_map_.find(table_id);
-  auto data_assignment_value_map = table_data_assignment_iter->second;
-  string min_dir;
-  uint64_t min_dir_count = kuint64max;
-  for (auto it = data_assignment_value_map.begin(); it != data_assignment_value_map.end(); ++it) {
-    if (min_dir_count > it->second.size()) {
-      min_dir = it->first;
-      min_dir_count = it->second.size();
-    }
-  }
-  *data_root_dir = min_dir;
-  // Increment the count for min_dir.
-  auto data_assignment_value_iter = table_data_assignment_map_[table_id].find(min_dir);
-  data_assignment_value_iter->second.insert(tablet_id);
+  auto& data_assignment_value_map = table_data_assignment_map_[table_id];
+  *data_root_dir = PickRootDir(data_assignment_value_map, data_dir_usage.get_ptr());
+  // Increment the count for the picked directory.
+  data_assignment_value_map[*data_root_dir].insert(tablet_id);
 
   // Find the wal directory with the least count of tablets for this table.
-  min_dir = "";
-  min_dir_count = kuint64max;
   auto wal_root_dirs = fs_manager->GetWalRootDirs();
   CHECK(!wal_root_dirs.empty()) << "No wal root directories found";
   auto table_wal_assignment_iter = table_wal_assignment_map_.find(table_id);
@@ -2097,17 +2352,71 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
       table_wal_assignment_map_[table_id][wal_root_iter] = tablet_id_set;
     }
   }
-  table_wal_assignment_iter = table_wal_assignment_map_.find(table_id);
-  auto wal_assignment_value_map = table_wal_assignment_iter->second;
-  for (auto it = wal_assignment_value_map.begin(); it != wal_assignment_value_map.end(); ++it) {
-    if (min_dir_count > it->second.size()) {
-      min_dir = it->first;
-      min_dir_count = it->second.size();
+  auto& wal_assignment_value_map = table_wal_assignment_map_[table_id];
+  *wal_root_dir = PickRootDir(wal_assignment_value_map, wal_dir_usage.get_ptr());
+  wal_assignment_value_map[*wal_root_dir].insert(tablet_id);
+}
+
+TSTabletManager::RootDirUsage TSTabletManager::GetRootDirUsage(TabletDirType dir_type) const {
+  RootDirUsage result;
+  for (const auto& peer : GetTabletPeers()) {
+    const auto& meta = peer->tablet_metadata();
+    if (!meta) {
+      continue;
+    }
+    if (dir_type == TabletDirType::kData) {
+      auto tablet = peer->shared_tablet();
+      if (tablet) {
+        result[meta->data_root_dir()].used_bytes += tablet->GetCurrentVersionSstFilesSize();
+      }
+    } else if (peer->log_available()) {
+      result[meta->wal_root_dir()].used_bytes += peer->log()->OnDiskSize();
+    }
+  }
+  const auto root_dirs = dir_type == TabletDirType::kData ? fs_manager_->GetDataRootDirs()
+                                                          : fs_manager_->GetWalRootDirs();
+  for (const auto& root_dir : root_dirs) {
+    auto free_bytes = fs_manager_->env()->GetFreeSpaceBytes(root_dir);
+    if (free_bytes.ok()) {
+      result[root_dir].free_bytes = *free_bytes;
+    } else {
+      YB_LOG_EVERY_N_SECS(WARNING, 60) << "Failed to get free space of " << root_dir << ": "
+                                       << free_bytes.status();
+    }
+  }
+  return result;
+}
+
+std::string TSTabletManager::PickRootDir(
+    const TabletIdSetByDirectoryMap& tablets_by_dir, const RootDirUsage* usage) {
+  static const DirUsage kNoUsage;
+  string min_dir;
+  uint64_t min_dir_count = kuint64max;
+  const DirUsage* min_dir_usage = &kNoUsage;
+  for (const auto& dir_and_tablets : tablets_by_dir) {
+    const auto count = dir_and_tablets.second.size();
+    if (count > min_dir_count) {
+      continue;
+    }
+    const DirUsage* dir_usage = &kNoUsage;
+    if (usage) {
+      auto it = usage->find(dir_and_tablets.first);
+      if (it != usage->end()) {
+        dir_usage = &it->second;
+      }
+    }
+    if (count == min_dir_count) {
+      if (!usage ||
+          std::make_pair(dir_usage->used_bytes, -dir_usage->free_bytes) >=
+              std::make_pair(min_dir_usage->used_bytes, -min_dir_usage->free_bytes)) {
+        continue;
+      }
     }
+    min_dir = dir_and_tablets.first;
+    min_dir_count = count;
+    min_dir_usage = dir_usage;
   }
-  *wal_root_dir = min_dir;
-  auto wal_assignment_value_iter = table_wal_assignment_map_[table_id].find(min_dir);
-  wal_assignment_value_iter->second.insert(tablet_id);
+  return min_dir;
 }
 
 void TSTabletManager::RegisterDataAndWalDir(FsManager* fs_manager,
@@ -32,6 +32,7 @@
 #ifndef YB_TSERVER_TS_TABLET_MANAGER_H
 #define YB_TSERVER_TS_TABLET_MANAGER_H
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -114,6 +115,9 @@ typedef boost::container::static_vector<TabletCreationMetaData, kNumSplitParts>
 // Type of tablet directory.
 YB_DEFINE_ENUM(TabletDirType, (kData)(kWal));
 
+// Whether the tablet had no recent writes at tablet server startup, see cold_tablet_idle_secs.
+YB_STRONGLY_TYPED_BOOL(ColdTablet);
+
 // Keeps track of the tablets hosted on the tablet server side.
 //
 // TODO: will also be responsible for keeping the local metadata about
@@ -151,8 +155,10 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
 
   ThreadPool* tablet_prepare_pool() const { return tablet_prepare_pool_.get(); }
   ThreadPool* raft_pool() const { return raft_pool_.get(); }
+  ThreadPool* raft_apply_pool() const { return raft_apply_pool_.get(); }
   ThreadPool* read_pool() const { return read_pool_.get(); }
   ThreadPool* append_pool() const { return append_pool_.get(); }
+  ThreadPool* open_tablet_pool() const { return open_tablet_pool_.get(); }
 
   // Create a new tablet and register it with the tablet manager. The new tablet
   // is persisted on disk and opened before this method returns.
@@ -233,6 +239,10 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Start a full tablet report and reset any incremental state tracking.
   void StartFullTabletReport(master::TabletReportPB* report);
 
+  // Forget consensus states acknowledged by the master, so the next incremental report contains
+  // them all. Should be called when the leader master changes.
+  void ResetReportedConsensusStates();
+
   // Mark that the master successfully received and processed the given tablet report.
   // 'seq_num' - only remove tablets unchanged since the acknowledged report sequence number.
   // 'updates' - explicitly ACK'd updates from the Master, may be a subset of request tablets.
@@ -283,6 +293,15 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Return the number of tablets for which this ts is a leader.
   int GetLeaderCount() const;
 
+  // Progress of opening tablets found on disk at startup.
+  size_t num_tablets_to_open_at_startup() const {
+    return num_tablets_to_open_at_startup_.load(std::memory_order_acquire);
+  }
+
+  size_t num_tablets_opened_at_startup() const {
+    return num_tablets_opened_at_startup_.load(std::memory_order_acquire);
+  }
+
   // Set the number of tablets which are waiting to be bootstrapped and can go to RUNNING
   // state in the response proto. Also set the total number of runnable tablets on this tserver.
   // If the tablet manager itself is not initialized, then INT_MAX is set for both.
@@ -324,6 +343,12 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Background task that verifies the data on each tablet for consistency.
   void VerifyTabletData();
 
+  // Background task that saves data blocks of leader tablets present in the block cache.
+  void SaveCachedDataBlocks();
+
+  // Loads data blocks saved by the tablet into the block cache in the background.
+  void WarmUpBlockCache(const TabletId& tablet_id);
+
   client::YBClient& client();
 
   tablet::TabletOptions* TEST_tablet_options() { return &tablet_options_; }
@@ -359,6 +384,17 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   };
   typedef std::unordered_map<std::string, TabletReportState> DirtyMap;
 
+  // Serialized state and committed consensus state of a tablet, as sent in the report with
+  // sequence number sent_seq and as last acknowledged by the master.
+  struct ReportedConsensusState {
+    uint32_t sent_seq = 0;
+    std::string sent_fingerprint;
+    std::string acked_fingerprint;
+  };
+
+  // Replaces committed consensus states that the master already has with the unchanged mark.
+  void OmitUnchangedConsensusStates(master::TabletReportPB* report);
+
   // Returns Status::OK() iff state_ == MANAGER_RUNNING.
   CHECKED_STATUS CheckRunningUnlocked(boost::optional<TabletServerErrorPB::Code>* error_code) const
       REQUIRES_SHARED(mutex_);
@@ -395,8 +431,13 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // method. A TransitionInProgressDeleter must be passed as 'deleter' into
   // this method in order to remove that transition-in-progress entry when
   // opening the tablet is complete (in either a success or a failure case).
+  // Orders tablets to open at startup: transaction status tablets, then tablets this server was
+  // likely the leader for, then by ascending WAL size.
+  void SortTabletsToOpen(std::deque<tablet::RaftGroupMetadataPtr>* metas);
+
   void OpenTablet(const scoped_refptr<tablet::RaftGroupMetadata>& meta,
-                  const scoped_refptr<TransitionInProgressDeleter>& deleter);
+                  const scoped_refptr<TransitionInProgressDeleter>& deleter,
+                  ColdTablet cold_tablet = ColdTablet::kFalse);
 
   // Open a tablet whose metadata has already been loaded.
   void BootstrapAndInitTablet(const scoped_refptr<tablet::RaftGroupMetadata>& meta,
@@ -424,6 +465,22 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Returns either table_data_assignment_map_ or table_wal_assignment_map_ depending on dir_type.
   TableDiskAssignmentMap* GetTableDiskAssignmentMapUnlocked(TabletDirType dir_type);
 
+  struct DirUsage {
+    // Size of SST files for data directories, or WAL files for WAL directories, of the tablets.
+    uint64_t used_bytes = 0;
+    int64_t free_bytes = 0;
+  };
+
+  typedef std::unordered_map<std::string, DirUsage> RootDirUsage;
+
+  // Returns the disk usage of the tablets of all tables, and free space, per root directory.
+  RootDirUsage GetRootDirUsage(TabletDirType dir_type) const EXCLUDES(dir_assignment_mutex_);
+
+  // Returns the directory with the least tablets of the table. When usage is specified, ties are
+  // broken by the least used bytes, then by the most free bytes.
+  static std::string PickRootDir(
+      const TabletIdSetByDirectoryMap& tablets_by_dir, const RootDirUsage* usage);
+
   // Returns assigned root dir of specified type for specified table and tablet.
   // If root dir is not registered for the specified table_id and tablet_id combination - returns
   // error.
@@ -518,6 +575,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Tablets aren't removed from this Map until the Master acknowledges it in response.
   DirtyMap dirty_tablets_ GUARDED_BY(mutex_);
 
+  std::unordered_map<TabletId, ReportedConsensusState> reported_consensus_states_
+      GUARDED_BY(mutex_);
+
   typedef std::set<TabletId> TabletIdSet;
 
   TabletIdSet tablets_being_remote_bootstrapped_ GUARDED_BY(mutex_);
@@ -549,6 +609,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Thread pool for Raft-related operations, shared between all tablets.
   std::unique_ptr<ThreadPool> raft_pool_;
 
+  // Thread pool for applying committed Raft write operations, shared between all tablets.
+  std::unique_ptr<ThreadPool> raft_apply_pool_;
+
   // Thread pool for appender threads, shared between all tablets.
   std::unique_ptr<ThreadPool> append_pool_;
 
@@ -569,6 +632,14 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Used for verifying tablet data integrity.
   std::unique_ptr<rpc::Poller> verify_tablet_data_poller_;
 
+  // Thread pool for warming up the block cache with data blocks saved by tablets.
+  std::unique_ptr<ThreadPool> block_cache_warm_up_pool_;
+
+  // Thread pool for saving data blocks of leader tablets present in the block cache.
+  std::unique_ptr<ThreadPool> block_cache_save_pool_;
+
+  std::unique_ptr<rpc::Poller> save_cached_data_blocks_poller_;
+
   // For block cache and memory monitor shared across tablets
   tablet::TabletOptions tablet_options_;
 
@@ -582,6 +653,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
 
   std::atomic<int32_t> num_tablets_being_remote_bootstrapped_{0};
 
+  std::atomic<size_t> num_tablets_to_open_at_startup_{0};
+  std::atomic<size_t> num_tablets_opened_at_startup_{0};
+
   mutable simple_spinlock snapshot_schedule_allowed_history_cutoff_mutex_;
   std::unordered_map<SnapshotScheduleId, HybridTime, SnapshotScheduleIdHash>
       snapshot_schedule_allowed_history_cutoff_
@@ -47,6 +47,7 @@
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/stringprintf.h"
 #include "yb/server/webui_util.h"
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tablet/tablet.h"
@@ -54,12 +55,15 @@
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/tablet/tablet_metadata.h"
 #include "yb/tablet/tablet_peer.h"
+#include "yb/tserver/tablet_memory_manager.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/util/url-coding.h"
 #include "yb/util/version_info.h"
 #include "yb/util/version_info.pb.h"
 
+DECLARE_int32(tablet_hot_key_sample_interval);
+
 namespace {
 
 // A struct representing some information about a tablet peer.
@@ -215,7 +219,8 @@ void HandleTabletPage(
       {"tablet-consensus-status", "Consensus Status"},
       {"log-anchors", "Tablet Log Anchors"},
       {"transactions", "Transactions"},
-      {"rocksdb", "RocksDB" }};
+      {"rocksdb", "RocksDB" },
+      {"tablet-hot-keys", "Hot Keys"}};
 
   auto encoded_tablet_id = UrlEncodeToString(tablet_id);
   for (const auto& entry : entries) {
@@ -291,6 +296,37 @@ void HandleTransactionsPage(
   *output << "Tablet is non transactional";
 }
 
+void HandleHotKeysPage(
+    const std::string& tablet_id, const tablet::TabletPeerPtr& peer,
+    const Webserver::WebRequest& req, Webserver::WebResponse* resp) {
+  constexpr size_t kMaxHotKeys = 20;
+
+  std::stringstream *output = &resp->output;
+  auto tablet = peer->shared_tablet();
+  if (!tablet) {
+    *output << "Tablet " << EscapeForHtmlToString(tablet_id) << " not running";
+    return;
+  }
+
+  *output << "<h1>Hot Keys for Tablet " << EscapeForHtmlToString(tablet_id) << "</h1>"
+          << std::endl;
+  if (FLAGS_tablet_hot_key_sample_interval <= 0) {
+    *output << "<p>Hot key tracking is disabled, see tablet_hot_key_sample_interval</p>"
+            << std::endl;
+  }
+  for (bool write : {false, true}) {
+    *output << "<h2>" << (write ? "Writes" : "Reads") << "</h2>" << std::endl;
+    *output << "<table class='table table-striped'>" << std::endl;
+    *output << "  <tr><th>Key</th><th>Sampled accesses</th><th>Max overestimate</th></tr>"
+            << std::endl;
+    for (const auto& entry : tablet->load_tracker().TopHotKeys(write, kMaxHotKeys)) {
+      *output << "  <tr><td>" << EscapeForHtmlToString(entry.key) << "</td><td>" << entry.count
+              << "</td><td>" << entry.error << "</td></tr>" << std::endl;
+    }
+    *output << "</table>" << std::endl;
+  }
+}
+
 void DumpRocksDB(const char* title, rocksdb::DB* db, std::ostream* out) {
   if (db) {
     *out << "<h2>" << title << "</h2>" << std::endl;
@@ -361,6 +397,7 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
   RegisterTabletPathHandler(server, tserver_, "/log-anchors", &HandleLogAnchorsPage);
   RegisterTabletPathHandler(server, tserver_, "/transactions", &HandleTransactionsPage);
   RegisterTabletPathHandler(server, tserver_, "/rocksdb", &HandleRocksDBPage);
+  RegisterTabletPathHandler(server, tserver_, "/tablet-hot-keys", &HandleHotKeysPage);
   server->RegisterPathHandler(
       "/", "Dashboards",
       std::bind(&TabletServerPathHandlers::HandleDashboardsPage, this, _1, _2), true /* styled */,
@@ -369,6 +406,10 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
       "/maintenance-manager", "",
       std::bind(&TabletServerPathHandlers::HandleMaintenanceManagerPage, this, _1, _2),
       true /* styled */, false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/memstores", "",
+      std::bind(&TabletServerPathHandlers::HandleMemstoresPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
   server->RegisterPathHandler(
       "/api/v1/health-check", "TServer Health Check",
       std::bind(&TabletServerPathHandlers::HandleHealthCheck, this, _1, _2),
@@ -597,6 +638,12 @@ void TabletServerPathHandlers::HandleTabletsPage(const Webserver::WebRequest& re
   std::sort(peers.begin(), peers.end(), &CompareByTabletId);
 
   *output << "<h1>Tablets</h1>\n";
+  const auto num_to_open = tserver_->tablet_manager()->num_tablets_to_open_at_startup();
+  const auto num_opened = tserver_->tablet_manager()->num_tablets_opened_at_startup();
+  if (num_opened < num_to_open) {
+    *output << "<p>Opened " << num_opened << " of " << num_to_open
+            << " tablets found at startup</p>\n";
+  }
   *output << "<table class='table table-striped'>\n";
   *output << "  <tr><th>Namespace</th><th>Table name</th><th>Table UUID</th><th>Tablet ID</th>"
       "<th>Partition</th>"
@@ -694,6 +741,9 @@ void TabletServerPathHandlers::HandleDashboardsPage(const Webserver::WebRequest&
   *output << GetDashboardLine("maintenance-manager", "Maintenance Manager",
                               "List of operations that are currently running and those "
                               "that are registered.");
+  *output << GetDashboardLine("memstores", "Memstores",
+                              "Memtables of the tablets in the order they would be flushed "
+                              "when the global memstore limit is reached.");
 }
 
 string TabletServerPathHandlers::GetDashboardLine(const std::string& link,
@@ -764,6 +814,35 @@ void TabletServerPathHandlers::HandleMaintenanceManagerPage(const Webserver::Web
   *output << "</table>\n";
 }
 
+void TabletServerPathHandlers::HandleMemstoresPage(const Webserver::WebRequest& req,
+                                                   Webserver::WebResponse* resp) {
+  std::stringstream *output = &resp->output;
+  auto* memory_manager = tserver_->tablet_manager()->tablet_memory_manager();
+  *output << "<h1>Memstores</h1>\n";
+  *output << Substitute("<p>Global memstore usage: $0 of $1</p>\n",
+                        HumanReadableNumBytes::ToString(memory_manager->memstore_usage()),
+                        HumanReadableNumBytes::ToString(memory_manager->memstore_limit()));
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Tablet ID</th><th>Table name</th><th>Data directory</th>"
+          << "<th>Memtables</th><th>Intents memtables</th><th>Oldest write age</th>"
+          << "<th>WAL size</th><th>Flush score</th></tr>\n";
+  for (const auto& candidate : memory_manager->GetFlushCandidates()) {
+    const auto& meta = candidate.peer->tablet_metadata();
+    *output << Substitute(
+        "<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td><td>$5</td><td>$6</td>"
+        "<td>$7</td></tr>\n",
+        TabletLink(candidate.peer->tablet_id()),
+        EscapeForHtmlToString(meta->table_name()),
+        EscapeForHtmlToString(meta->data_root_dir()),
+        HumanReadableNumBytes::ToString(candidate.regular_memtable_bytes),
+        HumanReadableNumBytes::ToString(candidate.intents_memtable_bytes),
+        HumanReadableElapsedTime::ToShortString(candidate.memtable_age.ToSeconds()),
+        HumanReadableNumBytes::ToString(candidate.wal_bytes),
+        StringPrintf("%.3f", candidate.score));
+  }
+  *output << "</table>\n";
+}
+
 void TabletServerPathHandlers::HandleHealthCheck(const Webserver::WebRequest& req,
                                                  Webserver::WebResponse* resp) {
   std::stringstream *output = &resp->output;
@@ -18,6 +18,7 @@
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
 
@@ -25,6 +26,11 @@ DEFINE_int32(tserver_heartbeat_metrics_interval_ms, 5000,
              "Interval (in milliseconds) at which tserver sends its metrics in a heartbeat to "
              "master.");
 
+DEFINE_int32(tablet_load_report_window_secs, 60,
+             "Per-tablet read and write rates reported to master in heartbeats are averaged over "
+             "this number of seconds.");
+TAG_FLAG(tablet_load_report_window_secs, advanced);
+
 using namespace std::literals;
 
 namespace yb {
@@ -34,6 +40,7 @@ void addTabletData(master::TabletPathInfoPB* path_info,
                    const std::shared_ptr<tablet::TabletPeer>& tablet_peer,
                    uint64_t sst_file_size,
                    uint64_t uncompressed_sst_file_size,
+                   const boost::optional<tablet::TabletLoad>& load,
                    std::unordered_map<std::string, master::ListTabletsOnPathPB*>* paths) {
   std::string data_dir = tablet_peer->tablet_metadata()->data_root_dir();
   const auto& tablet = tablet_peer->shared_tablet();
@@ -60,6 +67,10 @@ void addTabletData(master::TabletPathInfoPB* path_info,
   tablet_on_path->set_uncompressed_sst_file_size(uncompressed_sst_file_size);
   tablet_on_path->set_may_have_orphaned_post_split_data(
       tablet_peer->shared_tablet()->MayHaveOrphanedPostSplitData());
+  if (load) {
+    tablet_on_path->set_read_ops_per_sec(load->read_ops_per_sec);
+    tablet_on_path->set_write_ops_per_sec(load->write_ops_per_sec);
+  }
 }
 
 
@@ -85,6 +96,8 @@ void TServerMetricsHeartbeatDataProvider::DoAddData(
       !req->has_tablet_report() || req->tablet_report().is_incremental() ?
         req->mutable_tablet_path_info() : nullptr;
 
+  const auto now = CoarseMonoClock::Now();
+  const auto load_window = FLAGS_tablet_load_report_window_secs * 1s;
   for (const auto& tablet_peer : server().tablet_manager()->GetTabletPeers()) {
     if (tablet_peer) {
       auto tablet = tablet_peer->shared_tablet();
@@ -93,9 +106,10 @@ void TServerMetricsHeartbeatDataProvider::DoAddData(
         total_file_sizes += sizes.first;
         uncompressed_file_sizes += sizes.second;
         num_files += tablet->GetCurrentVersionNumSSTFiles();
+        auto load = tablet->load_tracker().UpdateAndGetLoad(now, load_window);
 
         if (path_info) {
-          addTabletData(path_info, tablet_peer, sizes.first, sizes.second, &paths);
+          addTabletData(path_info, tablet_peer, sizes.first, sizes.second, load, &paths);
         }
       }
     }
@@ -0,0 +1,79 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/async_future.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class AsyncFutureTest : public YBTest {
+};
+
+TEST_F(AsyncFutureTest, GetFromAnotherThread) {
+  AsyncPromise<std::unique_ptr<int>> promise;
+  auto future = promise.GetFuture();
+  ASSERT_FALSE(future.IsReady());
+  std::thread thread([promise] {
+    promise.SetValue(std::make_unique<int>(42));
+  });
+  ASSERT_EQ(*future.Get(), 42);
+  ASSERT_FALSE(future.valid());
+  thread.join();
+}
+
+TEST_F(AsyncFutureTest, Then) {
+  // Continuation is invoked when the value is set.
+  AsyncPromise<int> promise;
+  int result = 0;
+  promise.GetFuture().Then([&result](int value) { result = value; });
+  ASSERT_EQ(result, 0);
+  promise.SetValue(1);
+  ASSERT_EQ(result, 1);
+
+  // Continuation is invoked immediately when the value is already available.
+  auto future = MakeAsyncFuture<int>([](auto callback) { callback(2); });
+  ASSERT_TRUE(future.IsReady());
+  future.Then([&result](int value) { result = value; });
+  ASSERT_EQ(result, 2);
+}
+
+TEST_F(AsyncFutureTest, MapAndWhenAll) {
+  constexpr size_t kNumFutures = 10;
+  std::vector<AsyncPromise<int>> promises(kNumFutures);
+  std::vector<AsyncFuture<std::string>> futures;
+  for (auto& promise : promises) {
+    futures.push_back(promise.GetFuture().Map([](int value) { return std::to_string(value); }));
+  }
+  auto all = WhenAll(std::move(futures));
+  std::vector<std::thread> threads;
+  for (size_t i = kNumFutures; i-- > 0;) {
+    threads.emplace_back([&promises, i] { promises[i].SetValue(i); });
+  }
+  auto values = all.Get();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(values.size(), kNumFutures);
+  for (size_t i = 0; i != kNumFutures; ++i) {
+    ASSERT_EQ(values[i], std::to_string(i));
+  }
+
+  ASSERT_TRUE(WhenAll(std::vector<AsyncFuture<int>>()).Get().empty());
+}
+
+} // namespace yb
@@ -0,0 +1,215 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_ASYNC_FUTURE_H
+#define YB_UTIL_ASYNC_FUTURE_H
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include <glog/logging.h>
+
+namespace yb {
+
+namespace internal {
+
+template <class T>
+class AsyncFutureState {
+ public:
+  void SetValue(T value) {
+    std::function<void(T)> continuation;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      LOG_IF(DFATAL, has_value_) << "Async future value set twice";
+      has_value_ = true;
+      if (!continuation_) {
+        value_ = std::move(value);
+        cond_.notify_all();
+        return;
+      }
+      continuation.swap(continuation_);
+    }
+    continuation(std::move(value));
+  }
+
+  void SetContinuation(std::function<void(T)> continuation) {
+    boost::optional<T> value;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!value_) {
+        LOG_IF(DFATAL, has_value_ || continuation_) << "Async future value already consumed";
+        continuation_ = std::move(continuation);
+        return;
+      }
+      value.swap(value_);
+    }
+    continuation(std::move(*value));
+  }
+
+  T Get() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    LOG_IF(DFATAL, continuation_) << "Get for async future with continuation";
+    cond_.wait(lock, [this] { return value_.is_initialized(); });
+    T result = std::move(*value_);
+    value_.reset();
+    return result;
+  }
+
+  bool IsReady() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return value_.is_initialized();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  // has_value_ remains true after value_ was passed to a continuation or taken by Get.
+  bool has_value_ = false;
+  boost::optional<T> value_;
+  std::function<void(T)> continuation_;
+};
+
+} // namespace internal
+
+template <class T>
+class AsyncFuture;
+
+// Producer side of AsyncFuture. Value should be set exactly once, from any thread.
+template <class T>
+class AsyncPromise {
+ public:
+  AsyncPromise() : state_(std::make_shared<internal::AsyncFutureState<T>>()) {}
+
+  AsyncFuture<T> GetFuture() const;
+
+  void SetValue(T value) const {
+    state_->SetValue(std::move(value));
+  }
+
+ private:
+  std::shared_ptr<internal::AsyncFutureState<T>> state_;
+};
+
+// Result of an asynchronous operation, that, unlike std::future, could be consumed by a
+// continuation. So callers that pipeline a lot of requests do not need a thread that waits for
+// each of them.
+//
+// The value is consumed only once, either by Get or by Then.
+template <class T>
+class AsyncFuture {
+ public:
+  AsyncFuture() = default;
+
+  bool valid() const {
+    return state_ != nullptr;
+  }
+
+  bool IsReady() const {
+    return state_->IsReady();
+  }
+
+  // Blocks until the value is ready and returns it.
+  T Get() {
+    auto state = std::move(state_);
+    return state->Get();
+  }
+
+  // Invokes f(T) with the value, in the thread that sets the value, or in the current thread if
+  // the value is already available. Usually it is a reactor thread, so f should not block.
+  template <class F>
+  void Then(F f) {
+    auto state = std::move(state_);
+    state->SetContinuation(std::move(f));
+  }
+
+  // Returns future of f(T) applied to the value of this future.
+  template <class F>
+  auto Map(F f) -> AsyncFuture<decltype(f(std::declval<T>()))> {
+    AsyncPromise<decltype(f(std::declval<T>()))> promise;
+    auto result = promise.GetFuture();
+    Then([promise, f](T value) {
+      promise.SetValue(f(std::move(value)));
+    });
+    return result;
+  }
+
+ private:
+  friend class AsyncPromise<T>;
+
+  explicit AsyncFuture(std::shared_ptr<internal::AsyncFutureState<T>> state)
+      : state_(std::move(state)) {}
+
+  std::shared_ptr<internal::AsyncFutureState<T>> state_;
+};
+
+template <class T>
+AsyncFuture<T> AsyncPromise<T>::GetFuture() const {
+  return AsyncFuture<T>(state_);
+}
+
+// Functor is any functor that accepts callback as only argument, like in MakeFuture.
+template <class T, class Functor>
+AsyncFuture<T> MakeAsyncFuture(const Functor& functor) {
+  AsyncPromise<T> promise;
+  auto future = promise.GetFuture();
+  functor([promise](T value) {
+    promise.SetValue(std::move(value));
+  });
+  return future;
+}
+
+// Returns future of all values, in the same order as futures.
+template <class T>
+AsyncFuture<std::vector<T>> WhenAll(std::vector<AsyncFuture<T>> futures) {
+  struct State {
+    std::mutex mutex;
+    std::vector<boost::optional<T>> values;
+    size_t left;
+    AsyncPromise<std::vector<T>> promise;
+  };
+  auto state = std::make_shared<State>();
+  state->values.resize(futures.size());
+  state->left = futures.size();
+  auto result = state->promise.GetFuture();
+  if (futures.empty()) {
+    state->promise.SetValue(std::vector<T>());
+    return result;
+  }
+  for (size_t i = 0; i != futures.size(); ++i) {
+    futures[i].Then([state, i](T value) {
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->values[i] = std::move(value);
+        if (--state->left != 0) {
+          return;
+        }
+      }
+      std::vector<T> values;
+      values.reserve(state->values.size());
+      for (auto& value : state->values) {
+        values.push_back(std::move(*value));
+      }
+      state->promise.SetValue(std::move(values));
+    });
+  }
+  return result;
+}
+
+} // namespace yb
+
+#endif // YB_UTIL_ASYNC_FUTURE_H
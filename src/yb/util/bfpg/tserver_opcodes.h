@@ -49,6 +49,9 @@ enum class TSOpcode : int32_t {
 
   // Serialized YSQL/PG Expr Node.
   kPgEvalExprCall,
+
+  // Serialized YSQL/PG boolean Expr Node, that is used to filter rows.
+  kPgEvalBoolExprCall,
 };
 
 bool IsAggregateOpcode(TSOpcode op);
@@ -71,21 +71,94 @@ METRIC_DEFINE_gauge_uint64(server, block_cache_multi_touch_usage,
                            "Multi Cache Block Cache Memory Usage",
                            yb::MetricUnit::kBytes,
                            "Memory consumed by the multi cache block cache");
+METRIC_DEFINE_counter(server, compressed_block_cache_inserts,
+                      "Compressed Block Cache Inserts", yb::MetricUnit::kBlocks,
+                      "Number of blocks inserted in the compressed block cache");
+METRIC_DEFINE_counter(server, compressed_block_cache_lookups,
+                      "Compressed Block Cache Lookups", yb::MetricUnit::kBlocks,
+                      "Number of blocks looked up from the compressed block cache");
+METRIC_DEFINE_counter(server, compressed_block_cache_evictions,
+                      "Compressed Block Cache Evictions", yb::MetricUnit::kBlocks,
+                      "Number of blocks evicted from the compressed block cache");
+METRIC_DEFINE_counter(server, compressed_block_cache_misses,
+                      "Compressed Block Cache Misses", yb::MetricUnit::kBlocks,
+                      "Number of lookups in the compressed block cache that didn't yield a block");
+METRIC_DEFINE_counter(server, compressed_block_cache_misses_caching,
+                      "Compressed Block Cache Misses (Caching)", yb::MetricUnit::kBlocks,
+                      "Number of lookups in the compressed block cache that were expecting a "
+                      "block that didn't yield one");
+METRIC_DEFINE_counter(server, compressed_block_cache_hits,
+                      "Compressed Block Cache Hits", yb::MetricUnit::kBlocks,
+                      "Number of lookups in the compressed block cache that found a block");
+METRIC_DEFINE_counter(server, compressed_block_cache_hits_caching,
+                      "Compressed Block Cache Hits (Caching)", yb::MetricUnit::kBlocks,
+                      "Number of lookups in the compressed block cache that were expecting a "
+                      "block that found one");
+
+METRIC_DEFINE_gauge_uint64(server, compressed_block_cache_usage,
+                           "Compressed Block Cache Memory Usage", yb::MetricUnit::kBytes,
+                           "Memory consumed by the compressed block cache");
+METRIC_DEFINE_gauge_uint64(server, compressed_block_cache_single_touch_usage,
+                           "Single Touch Compressed Block Cache Memory Usage",
+                           yb::MetricUnit::kBytes,
+                           "Memory consumed by the single touch compressed block cache");
+METRIC_DEFINE_gauge_uint64(server, compressed_block_cache_multi_touch_usage,
+                           "Multi Touch Compressed Block Cache Memory Usage",
+                           yb::MetricUnit::kBytes,
+                           "Memory consumed by the multi touch compressed block cache");
+
 namespace yb {
 
-#define MINIT(member, x) member(METRIC_##x.Instantiate(entity))
-#define GINIT(member, x) member(METRIC_##x.Instantiate(entity, 0))
-CacheMetrics::CacheMetrics(const scoped_refptr<MetricEntity>& entity)
-  : MINIT(inserts, block_cache_inserts),
-    MINIT(lookups, block_cache_lookups),
-    MINIT(evictions, block_cache_evictions),
-    MINIT(cache_hits, block_cache_hits),
-    MINIT(cache_hits_caching, block_cache_hits_caching),
-    MINIT(cache_misses, block_cache_misses),
-    MINIT(cache_misses_caching, block_cache_misses_caching),
-    GINIT(cache_usage, block_cache_usage),
-    GINIT(single_touch_cache_usage, block_cache_single_touch_usage),
-    GINIT(multi_touch_cache_usage, block_cache_multi_touch_usage) {
+struct CacheMetricPrototypes {
+  const CounterPrototype* inserts;
+  const CounterPrototype* lookups;
+  const CounterPrototype* evictions;
+  const CounterPrototype* cache_hits;
+  const CounterPrototype* cache_hits_caching;
+  const CounterPrototype* cache_misses;
+  const CounterPrototype* cache_misses_caching;
+  const GaugePrototype<uint64_t>* cache_usage;
+  const GaugePrototype<uint64_t>* single_touch_cache_usage;
+  const GaugePrototype<uint64_t>* multi_touch_cache_usage;
+};
+
+namespace {
+
+#define CACHE_METRIC_PROTOTYPES(prefix) { \
+    &METRIC_##prefix##_inserts, &METRIC_##prefix##_lookups, &METRIC_##prefix##_evictions, \
+    &METRIC_##prefix##_hits, &METRIC_##prefix##_hits_caching, &METRIC_##prefix##_misses, \
+    &METRIC_##prefix##_misses_caching, &METRIC_##prefix##_usage, \
+    &METRIC_##prefix##_single_touch_usage, &METRIC_##prefix##_multi_touch_usage }
+
+const CacheMetricPrototypes& GetPrototypes(BlockCacheKind kind) {
+  static const CacheMetricPrototypes kUncompressed = CACHE_METRIC_PROTOTYPES(block_cache);
+  static const CacheMetricPrototypes kCompressed =
+      CACHE_METRIC_PROTOTYPES(compressed_block_cache);
+  return kind == BlockCacheKind::kCompressed ? kCompressed : kUncompressed;
+}
+
+#undef CACHE_METRIC_PROTOTYPES
+
+} // namespace
+
+#define MINIT(member) member(prototypes.member->Instantiate(entity))
+#define GINIT(member) member(prototypes.member->Instantiate(entity, 0))
+CacheMetrics::CacheMetrics(const scoped_refptr<MetricEntity>& entity, BlockCacheKind kind)
+  : CacheMetrics(entity, GetPrototypes(kind)) {
+}
+
+CacheMetrics::CacheMetrics(
+    const scoped_refptr<MetricEntity>& entity, const CacheMetricPrototypes& prototypes)
+  : MINIT(inserts),
+    MINIT(lookups),
+    MINIT(evictions),
+    MINIT(cache_hits),
+    MINIT(cache_hits_caching),
+    MINIT(cache_misses),
+    MINIT(cache_misses_caching),
+    GINIT(cache_usage),
+    GINIT(single_touch_cache_usage),
+    GINIT(multi_touch_cache_usage) {
 }
 #undef MINIT
 #undef GINIT
@@ -37,6 +37,8 @@
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 
+#include "yb/util/enums.h"
+
 namespace yb {
 
 template<class T>
@@ -44,8 +46,14 @@ class AtomicGauge;
 class Counter;
 class MetricEntity;
 
+struct CacheMetricPrototypes;
+
+// Tiers of the block cache are monitored by separate sets of metrics.
+YB_DEFINE_ENUM(BlockCacheKind, (kUncompressed)(kCompressed));
+
 struct CacheMetrics {
-  explicit CacheMetrics(const scoped_refptr<MetricEntity>& metric_entity);
+  explicit CacheMetrics(const scoped_refptr<MetricEntity>& metric_entity,
+                        BlockCacheKind kind = BlockCacheKind::kUncompressed);
 
   scoped_refptr<Counter> inserts;
   scoped_refptr<Counter> lookups;
@@ -58,6 +66,10 @@ struct CacheMetrics {
   scoped_refptr<AtomicGauge<uint64_t> > cache_usage;
   scoped_refptr<AtomicGauge<uint64_t> > single_touch_cache_usage;
   scoped_refptr<AtomicGauge<uint64_t> > multi_touch_cache_usage;
+
+ private:
+  CacheMetrics(const scoped_refptr<MetricEntity>& metric_entity,
+               const CacheMetricPrototypes& prototypes);
 };
 
 } // namespace yb
@@ -37,7 +37,7 @@ class BlockAccessCipherStream {
   explicit BlockAccessCipherStream(EncryptionParamsPtr encryption_params);
   CHECKED_STATUS Init();
 
-  // Encrypt data at an offset.
+  // Encrypt data at an offset. The output may point to the same buffer as the input.
   CHECKED_STATUS Encrypt(
       uint64_t file_offset,
       const Slice& input,
@@ -59,8 +59,11 @@ class BlockAccessCipherStream {
   bool UseOpensslCompatibleCounterOverflow();
 
  private:
+  // Encrypts the input using the key stream of the given block, starting block_offset bytes into
+  // that block.
   CHECKED_STATUS EncryptByBlock(
       uint64_t block_index,
+      size_t block_offset,
       const Slice& input,
       void* output,
       EncryptionOverflowWorkaround counter_overflow_workaround =
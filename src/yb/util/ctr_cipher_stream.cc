@@ -54,8 +54,9 @@ Status BlockAccessCipherStream::Init() {
           encryption_params_->key_size);
   }
 
+  // Expand the key schedule once. Later calls to EVP_EncryptInit_ex only reset the iv.
   const auto encrypt_init_ex_result = EVP_EncryptInit_ex(
-      encryption_context_.get(), cipher, /* impl */ nullptr, /* key */ nullptr,
+      encryption_context_.get(), cipher, /* impl */ nullptr, encryption_params_->key,
       /* iv */ nullptr);
   if (encrypt_init_ex_result != 1) {
     return STATUS_FORMAT(InternalError,
@@ -87,27 +88,26 @@ Status BlockAccessCipherStream::Encrypt(
   }
 
   uint64_t block_index = file_offset / EncryptionParams::kBlockSize;
-  uint64_t block_offset = file_offset % EncryptionParams::kBlockSize;
-  size_t first_block_size = 0;
-  // Encrypt the first block alone if it is not byte aligned with the block size.
-  if (block_offset > 0) {
-    first_block_size = std::min(data_size, EncryptionParams::kBlockSize - block_offset);
-    uint8_t input_buf[EncryptionParams::kBlockSize];
-    uint8_t output_buf[EncryptionParams::kBlockSize];
-    memcpy(input_buf + block_offset, input.data(), first_block_size);
-    RETURN_NOT_OK(EncryptByBlock(
-        block_index, Slice(input_buf, EncryptionParams::kBlockSize), output_buf,
-        counter_overflow_workaround));
-    memcpy(output, output_buf + block_offset, first_block_size);
-    block_index++;
-    data_size -= first_block_size;
+  const size_t block_offset = file_offset % EncryptionParams::kBlockSize;
+  size_t first_chunk_size = data_size;
+  // The iv of every call is computed by IncrementCounter, while OpenSSL increments the whole iv
+  // within a call. So when the data starts in the middle of a block whose successor wraps the
+  // 32-bit counter, encrypt that first block alone to keep the iv of the next block unchanged.
+  // Otherwise the whole range is encrypted with a single call.
+  if (block_offset > 0 &&
+      static_cast<uint32_t>(encryption_params_->counter + block_index + 1) == 0) {
+    first_chunk_size = std::min<size_t>(data_size, EncryptionParams::kBlockSize - block_offset);
   }
+  RETURN_NOT_OK(EncryptByBlock(
+      block_index, block_offset, Slice(input.data(), first_chunk_size), output,
+      counter_overflow_workaround));
+  data_size -= first_chunk_size;
 
-  // Encrypt the rest of the data.
   if (data_size > 0) {
-    RETURN_NOT_OK(EncryptByBlock(block_index,
-                                 Slice(input.data() + first_block_size, data_size),
-                                 static_cast<uint8_t*>(output) + first_block_size,
+    RETURN_NOT_OK(EncryptByBlock(block_index + 1,
+                                 /* block_offset */ 0,
+                                 Slice(input.data() + first_chunk_size, data_size),
+                                 static_cast<uint8_t*>(output) + first_chunk_size,
                                  counter_overflow_workaround));
   }
   return Status::OK();
@@ -126,7 +126,7 @@ bool BlockAccessCipherStream::UseOpensslCompatibleCounterOverflow() {
 }
 
 Status BlockAccessCipherStream::EncryptByBlock(
-    uint64_t block_index, const Slice& input, void* output,
+    uint64_t block_index, size_t block_offset, const Slice& input, void* output,
     EncryptionOverflowWorkaround counter_overflow_workaround) {
   const uint64_t data_size = input.size();
   if (data_size == 0) {
@@ -151,7 +151,7 @@ Status BlockAccessCipherStream::EncryptByBlock(
 
   const int init_result =
       EVP_EncryptInit_ex(encryption_context_.get(), /* cipher */ nullptr, /* impl */ nullptr,
-                         encryption_params_->key, iv);
+                         /* key */ nullptr, iv);
   if (init_result != 1) {
     return STATUS_FORMAT(InternalError,
                          "EVP_EncryptInit_ex returned $0 when encrypting/decrypting $1 bytes "
@@ -159,8 +159,21 @@ Status BlockAccessCipherStream::EncryptByBlock(
                          init_result, data_size, block_index);
   }
 
-  // Perform the encryption.
   int bytes_updated = 0;
+  // Skip the key stream of the bytes of the first block that precede the data.
+  if (block_offset > 0) {
+    uint8_t skip_buf[EncryptionParams::kBlockSize] = {0};
+    const int skip_result = EVP_EncryptUpdate(
+        encryption_context_.get(), skip_buf, &bytes_updated, skip_buf, block_offset);
+    if (skip_result != 1) {
+      return STATUS_FORMAT(InternalError,
+                           "EVP_EncryptUpdate returned $0 when skipping $1 bytes "
+                           "at block index $2.",
+                           skip_result, block_offset, block_index);
+    }
+  }
+
+  // Perform the encryption. Input and output may point to the same buffer.
   const int update_result = EVP_EncryptUpdate(
       encryption_context_.get(), static_cast<uint8_t*>(output), &bytes_updated, input.data(),
       data_size);
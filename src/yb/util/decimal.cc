@@ -465,19 +465,32 @@ Decimal Decimal::operator+(const Decimal& other) const {
 
   // Normalize the exponents
   // eg. if we are adding 0.1E+3 and 0.5E+2, we first convert them to 0.1E+3 and 0.05E+3
-  VarInt max_exponent = std::max(other1.exponent_, decimal.exponent_);
   VarInt var_int_one(1);
-  if (decimal.exponent_ < max_exponent) {
-    VarInt increase_varint = max_exponent - decimal.exponent_;
-    int64_t increase = CHECK_RESULT(increase_varint.ToInt64());
-    decimal.digits_.insert(decimal.digits_.begin(), increase, 0);
-    decimal.exponent_ = max_exponent;
-  }
-  if (other1.exponent_ < max_exponent) {
-    VarInt increase_varint = max_exponent - other1.exponent_;
-    int64_t increase = CHECK_RESULT(increase_varint.ToInt64());
-    other1.digits_.insert(other1.digits_.begin(), increase, 0);
-    other1.exponent_ = max_exponent;
+  auto exponent = decimal.exponent_.ToInt64();
+  auto other_exponent = other1.exponent_.ToInt64();
+  if (exponent.ok() && other_exponent.ok()) {
+    // Exponents practically always fit into int64_t, so normalize them without allocating VarInt
+    // temporaries. Only the exponent of the result matters after normalization.
+    if (*exponent < *other_exponent) {
+      decimal.digits_.insert(decimal.digits_.begin(), *other_exponent - *exponent, 0);
+      decimal.exponent_ = other1.exponent_;
+    } else if (*other_exponent < *exponent) {
+      other1.digits_.insert(other1.digits_.begin(), *exponent - *other_exponent, 0);
+    }
+  } else {
+    VarInt max_exponent = std::max(other1.exponent_, decimal.exponent_);
+    if (decimal.exponent_ < max_exponent) {
+      VarInt increase_varint = max_exponent - decimal.exponent_;
+      int64_t increase = CHECK_RESULT(increase_varint.ToInt64());
+      decimal.digits_.insert(decimal.digits_.begin(), increase, 0);
+      decimal.exponent_ = max_exponent;
+    }
+    if (other1.exponent_ < max_exponent) {
+      VarInt increase_varint = max_exponent - other1.exponent_;
+      int64_t increase = CHECK_RESULT(increase_varint.ToInt64());
+      other1.digits_.insert(other1.digits_.begin(), increase, 0);
+      other1.exponent_ = max_exponent;
+    }
   }
 
   // Make length of digits the same.
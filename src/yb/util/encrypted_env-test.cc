@@ -22,6 +22,8 @@
 #include "yb/util/header_manager_mock_impl.h"
 #include "yb/util/encryption_test_util.h"
 #include "yb/util/random_util.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/stopwatch.h"
 
 #include <glog/logging.h>
 #include <gtest/gtest.h>
@@ -30,6 +32,8 @@ namespace yb {
 namespace enterprise {
 
 constexpr uint32_t kDataSize = 1000;
+constexpr size_t kBenchmarkChunkSize = 64_KB;
+constexpr size_t kBenchmarkNumChunks = 1024;
 
 class TestEncryptedEnv : public YBTest {};
 
@@ -59,5 +63,49 @@ TEST_F(TestEncryptedEnv, FileOps) {
   }
 }
 
+// Measures sequential write and random access read throughput with and without encryption.
+TEST_F(TestEncryptedEnv, Throughput) {
+  auto header_manager = GetMockHeaderManager();
+  HeaderManager* hm_ptr = header_manager.get();
+
+  auto env = yb::NewEncryptedEnv(std::move(header_manager));
+  auto fname_template = "test-fileXXXXXX";
+  auto bytes = RandomBytes(kBenchmarkChunkSize);
+  Slice data(bytes.data(), kBenchmarkChunkSize);
+  std::vector<uint8_t> scratch(kBenchmarkChunkSize);
+
+  for (bool encrypted : {false, true}) {
+    down_cast<HeaderManagerMockImpl*>(hm_ptr)->SetFileEncryption(encrypted);
+
+    string fname;
+    std::unique_ptr<WritableFile> writable_file;
+    ASSERT_OK(env->NewTempWritableFile(
+        WritableFileOptions(), fname_template, &fname, &writable_file));
+    LOG_TIMING(INFO, Format("writing $0 bytes, encrypted: $1",
+                            kBenchmarkChunkSize * kBenchmarkNumChunks, encrypted)) {
+      for (size_t i = 0; i != kBenchmarkNumChunks; ++i) {
+        ASSERT_OK(writable_file->Append(data));
+      }
+      ASSERT_OK(writable_file->Close());
+    }
+
+    std::unique_ptr<RandomAccessFile> ra_file;
+    ASSERT_OK(env->NewRandomAccessFile(fname, &ra_file));
+    LOG_TIMING(INFO, Format("reading $0 bytes, encrypted: $1",
+                            kBenchmarkChunkSize * kBenchmarkNumChunks, encrypted)) {
+      for (size_t i = 0; i != kBenchmarkNumChunks; ++i) {
+        Slice result;
+        // Use an offset which is not aligned with the cipher block size.
+        const size_t offset = i * kBenchmarkChunkSize + i % EncryptionParams::kBlockSize;
+        const size_t size = kBenchmarkChunkSize - EncryptionParams::kBlockSize;
+        ASSERT_OK(ra_file->Read(offset, size, &result, scratch.data()));
+        ASSERT_EQ(size, result.size());
+      }
+    }
+
+    ASSERT_OK(env->DeleteFile(fname));
+  }
+}
+
 } // namespace enterprise
 } // namespace yb
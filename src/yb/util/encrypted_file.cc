@@ -50,8 +50,9 @@ Status EncryptedRandomAccessFile::ReadInternal(
   if (!scratch) {
     return STATUS(InvalidArgument, "scratch argument is null.");
   }
-  uint8_t* buf = static_cast<uint8_t*>(EncryptionBuffer::Get()->GetBuffer(n));
-  RETURN_NOT_OK(RandomAccessFileWrapper::Read(offset + header_size_, n, result, buf));
+  // Read straight into scratch and decrypt in place, there is no need for an intermediate buffer.
+  RETURN_NOT_OK(RandomAccessFileWrapper::Read(
+      offset + header_size_, n, result, reinterpret_cast<uint8_t*>(scratch)));
   RETURN_NOT_OK(stream_->Decrypt(offset, *result, scratch, counter_overflow_workaround));
   *result = Slice(scratch, result->size());
   return Status::OK();
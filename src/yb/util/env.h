@@ -326,6 +326,9 @@ class Env {
   // of space consumed by the file, not the user-facing file size.
   virtual Result<uint64_t> GetFileSizeOnDisk(const std::string& fname) = 0;
 
+  // Returns the last modification time of fname, in seconds since the epoch.
+  virtual Result<uint64_t> GetFileModificationTime(const std::string& fname) = 0;
+
   // Returns the block size of the filesystem where fname resides.
   // fname must exist but it may be a file or a directory.
   virtual Result<uint64_t> GetBlockSize(const std::string& fname) = 0;
@@ -508,10 +511,15 @@ struct WritableFileOptions {
   // See CreateMode for details.
   Env::CreateMode mode;
 
+  // With OPEN_EXISTING mode, write from the beginning of the file instead of appending to it.
+  // File keeps its allocated blocks, stale contents past the written data are the caller's concern.
+  bool overwrite;
+
   WritableFileOptions()
     : sync_on_close(false),
       o_direct(false),
-      mode(Env::CREATE_IF_NON_EXISTING_TRUNCATE) { }
+      mode(Env::CREATE_IF_NON_EXISTING_TRUNCATE),
+      overwrite(false) { }
 };
 
 // A file abstraction for sequential writing.  The implementation
@@ -770,6 +778,9 @@ class EnvWrapper : public Env {
   Result<uint64_t> GetFileSizeOnDisk(const std::string& f) override {
     return target_->GetFileSizeOnDisk(f);
   }
+  Result<uint64_t> GetFileModificationTime(const std::string& f) override {
+    return target_->GetFileModificationTime(f);
+  }
   Result<uint64_t> GetBlockSize(const std::string& f) override {
     return target_->GetBlockSize(f);
   }
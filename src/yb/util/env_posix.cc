@@ -1091,6 +1091,12 @@ class PosixEnv : public Env {
         });
   }
 
+  Result<uint64_t> GetFileModificationTime(const std::string& fname) override {
+    return GetFileStat(
+        fname, "PosixEnv::GetFileModificationTime",
+        [](const struct stat& sbuf) { return sbuf.st_mtime; });
+  }
+
   Result<uint64_t> GetBlockSize(const string& fname) override {
     return GetFileStat(
         fname, "PosixEnv::GetBlockSize", [](const struct stat& sbuf) { return sbuf.st_blksize; });
@@ -1588,7 +1594,7 @@ class PosixFileFactory : public FileFactory {
                                     const WritableFileOptions& opts,
                                     std::unique_ptr<WritableFile>* result) {
     uint64_t file_size = 0;
-    if (opts.mode == PosixEnv::OPEN_EXISTING) {
+    if (opts.mode == PosixEnv::OPEN_EXISTING && !opts.overwrite) {
       auto lseek_result = lseek(fd, 0, SEEK_END);
       if (lseek_result < 0) {
         return STATUS_IO_ERROR(fname, errno);
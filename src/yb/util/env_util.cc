@@ -39,6 +39,7 @@
 #include <boost/container/small_vector.hpp>
 
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/crc.h"
 #include "yb/util/env.h"
 #include "yb/util/env_util.h"
 #include "yb/util/path_util.h"
@@ -207,6 +208,25 @@ Status CopyFile(Env* env, const string& source_path, const string& dest_path,
   return Status::OK();
 }
 
+Result<uint32_t> ComputeFileCrc32c(Env* env, const std::string& path) {
+  std::unique_ptr<SequentialFile> file;
+  RETURN_NOT_OK(env->NewSequentialFile(path, &file));
+
+  const size_t kBufferSize = 1024 * 1024;
+  std::unique_ptr<uint8_t[]> scratch(new uint8_t[kBufferSize]);
+  crc::Crc* crc32c = crc::GetCrc32cInstance();
+  uint64_t value = 0;
+  for (;;) {
+    Slice data;
+    RETURN_NOT_OK(file->Read(kBufferSize, &data, scratch.get()));
+    if (data.empty()) {
+      break;
+    }
+    crc32c->Compute(data.data(), data.size(), &value);
+  }
+  return static_cast<uint32_t>(value);
+}
+
 ScopedFileDeleter::ScopedFileDeleter(Env* env, std::string path)
     : env_(DCHECK_NOTNULL(env)), path_(std::move(path)), should_delete_(true) {}
 
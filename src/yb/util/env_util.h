@@ -91,6 +91,9 @@ Status CopyFile(
     Env* env, const std::string& source_path, const std::string& dest_path,
     WritableFileOptions opts = WritableFileOptions());
 
+// Returns CRC32C of the contents of the file.
+Result<uint32_t> ComputeFileCrc32c(Env* env, const std::string& path);
+
 // Deletes a file or directory when this object goes out of scope.
 //
 // The deletion may be cancelled by calling .Cancel().
@@ -176,12 +176,30 @@ class RandomAccessFile : public FileWithUniqueId {
 
   virtual void Hint(AccessPattern pattern) {}
 
+  // Hints that "n" bytes starting at "offset" will be read soon, so the platform could start
+  // reading them in background.
+  virtual void Prefetch(uint64_t offset, size_t n) {}
+
   // Remove any kind of caching of data from the offset to offset+length
   // of this file. If the length is 0, then it refers to the end of file.
   // If the system is not caching the file contents, then this is a noop.
   virtual Status InvalidateCache(size_t offset, size_t length) {
     return STATUS(NotSupported, "InvalidateCache not supported.");
   }
+
+  // Starts reading up to "n" bytes from the file starting at "offset" into "scratch" in
+  // background. The read is finished by WaitForRead, only one read could be in progress.
+  // Returns NotSupported if the file does not have asynchronous reads, so Read should be used.
+  //
+  // REQUIRES: External synchronization
+  virtual CHECKED_STATUS ReadAsync(uint64_t offset, size_t n, uint8_t* scratch) {
+    return STATUS(NotSupported, "ReadAsync not supported.");
+  }
+
+  // Waits for the read started by ReadAsync, "*result" has the same meaning as in Read.
+  virtual CHECKED_STATUS WaitForRead(Slice* result) {
+    return STATUS(NotSupported, "WaitForRead not supported.");
+  }
 };
 
 class SequentialFileWrapper : public SequentialFile {
@@ -238,10 +256,15 @@ class RandomAccessFileWrapper : public RandomAccessFile {
 
   void Hint(AccessPattern pattern) override { return target_->Hint(pattern); }
 
+  void Prefetch(uint64_t offset, size_t n) override { target_->Prefetch(offset, n); }
+
   Status InvalidateCache(size_t offset, size_t length) override {
     return target_->InvalidateCache(offset, length);
   }
 
+  // ReadAsync and WaitForRead are not forwarded, because wrappers usually transform data
+  // returned by Read.
+
  private:
   std::unique_ptr<RandomAccessFile> target_;
 };
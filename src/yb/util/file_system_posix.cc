@@ -252,6 +252,10 @@ void PosixRandomAccessFile::Hint(AccessPattern pattern) {
   }
 }
 
+void PosixRandomAccessFile::Prefetch(uint64_t offset, size_t n) {
+  Fadvise(fd_, offset, n, POSIX_FADV_WILLNEED);
+}
+
 Status PosixRandomAccessFile::InvalidateCache(size_t offset, size_t length) {
 #ifndef __linux__
   return Status::OK();
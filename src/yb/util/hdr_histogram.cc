@@ -212,6 +212,48 @@ void HdrHistogram::IncrementBy(int64_t value, int64_t count) {
   }
 }
 
+void HdrHistogram::MergeFrom(const HdrHistogram& other) {
+  DCHECK_EQ(highest_trackable_value_, other.highest_trackable_value_);
+  DCHECK_EQ(num_significant_digits_, other.num_significant_digits_);
+
+  uint64_t total_merged_count = 0;
+  for (int i = 0; i < counts_array_length_; i++) {
+    uint64_t count = NoBarrier_Load(&other.counts_[i]);
+    if (count) {
+      NoBarrier_AtomicIncrement(&counts_[i], count);
+      total_merged_count += count;
+    }
+  }
+  NoBarrier_AtomicIncrement(&total_count_, NoBarrier_Load(&other.total_count_));
+  // As in the copy constructor, keep the current count consistent with the merged counts.
+  NoBarrier_AtomicIncrement(&current_count_, total_merged_count);
+  NoBarrier_AtomicIncrement(&total_sum_, NoBarrier_Load(&other.total_sum_));
+  NoBarrier_AtomicIncrement(&current_sum_, NoBarrier_Load(&other.current_sum_));
+
+  if (total_merged_count == 0) {
+    return;
+  }
+
+  // Loads min_value_ directly, MinValue() would hide it while this histogram is empty.
+  {
+    Atomic64 value = NoBarrier_Load(&other.min_value_);
+    Atomic64 min_val;
+    while (value < (min_val = NoBarrier_Load(&min_value_))) {
+      Atomic64 old_val = NoBarrier_CompareAndSwap(&min_value_, min_val, value);
+      if (old_val == min_val) break; // CAS success.
+    }
+  }
+
+  {
+    Atomic64 value = NoBarrier_Load(&other.max_value_);
+    Atomic64 max_val;
+    while (value > (max_val = NoBarrier_Load(&max_value_))) {
+      Atomic64 old_val = NoBarrier_CompareAndSwap(&max_value_, max_val, value);
+      if (old_val == max_val) break; // CAS success.
+    }
+  }
+}
+
 void HdrHistogram::IncrementWithExpectedInterval(int64_t value,
                                                  int64_t expected_interval_between_samples) {
   Increment(value);
@@ -46,6 +46,7 @@
 
 DECLARE_int32(memory_limit_soft_percentage);
 DECLARE_int64(mem_tracker_update_consumption_interval_us);
+DECLARE_int64(mem_tracker_consumption_batch_bytes);
 
 namespace yb {
 
@@ -358,4 +359,46 @@ TEST(MemTrackerTest, UnregisterFromParent) {
   shared_ptr<MemTracker> c2 = MemTracker::CreateTracker("child", p);
 }
 
+TEST(MemTrackerTest, BatchedConsumption) {
+  google::FlagSaver saver;
+  FLAGS_mem_tracker_consumption_batch_bytes = 100;
+
+  shared_ptr<MemTracker> p = MemTracker::CreateTracker("parent");
+  shared_ptr<MemTracker> c = MemTracker::CreateTracker("child", p);
+
+  // Small updates are batched until flushed.
+  c->Consume(10);
+  c->Consume(20);
+  c->Release(5);
+  ASSERT_EQ(0, c->consumption());
+  ASSERT_EQ(0, p->consumption());
+  c->FlushPendingConsumption();
+  ASSERT_EQ(25, c->consumption());
+  ASSERT_EQ(25, p->consumption());
+
+  // Large updates are applied immediately.
+  c->Consume(1000);
+  ASSERT_EQ(1025, c->consumption());
+  ASSERT_EQ(1025, p->consumption());
+
+  // Batching enough bytes on a thread flushes them.
+  for (int i = 0; i != 10; ++i) {
+    c->Release(10);
+  }
+  ASSERT_LT(c->consumption(), 1025);
+  c->FlushPendingConsumption();
+  ASSERT_EQ(925, c->consumption());
+  ASSERT_EQ(925, p->consumption());
+  c->Release(925);
+  ASSERT_EQ(0, c->consumption());
+  ASSERT_EQ(0, p->consumption());
+
+  // Trackers with limits are never batched.
+  shared_ptr<MemTracker> l = MemTracker::CreateTracker(1000, "limited", p);
+  l->Consume(10);
+  ASSERT_EQ(10, l->consumption());
+  ASSERT_EQ(10, p->consumption());
+  l->Release(10);
+}
+
 } // namespace yb
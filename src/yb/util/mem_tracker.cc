@@ -33,6 +33,7 @@
 #include "yb/util/mem_tracker.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <deque>
 #include <limits>
 #include <list>
@@ -111,6 +112,14 @@ DEFINE_int64(mem_tracker_update_consumption_interval_us, 2000000,
              "Interval that is used to update memory consumption from external source. "
              "For instance from tcmalloc statistics.");
 
+DEFINE_int64(mem_tracker_consumption_batch_bytes, 0,
+             "When positive, Consume()/Release() calls smaller than this many bytes on memory "
+             "trackers without enforced limits are accumulated in a striped per-tracker counter "
+             "and propagated to ancestor trackers in batches, instead of updating every ancestor "
+             "on each call. Ancestor consumption may then lag by roughly this many bytes per "
+             "thread, until the next periodic flush. 0 disables batching.");
+TAG_FLAG(mem_tracker_consumption_batch_bytes, advanced);
+
 namespace yb {
 
 // NOTE: this class has been adapted from Impala, so the code style varies
@@ -135,6 +144,9 @@ GoogleOnceType root_tracker_once = GOOGLE_ONCE_INIT;
 // is greater than GC_RELEASE_SIZE, this will trigger a tcmalloc gc.
 Atomic64 released_memory_since_gc;
 
+// Bytes batched by the current thread since it last flushed a tracker's pending consumption.
+thread_local int64_t batched_bytes_since_flush = 0;
+
 // Validate that various flags are percentages.
 bool ValidatePercentage(const char* flagname, int value) {
   if (value >= 0 && value <= 100) {
@@ -354,6 +366,13 @@ MemTracker::MemTracker(int64_t byte_limit, const string& id,
         limit_trackers_.end(), parent_->limit_trackers_.begin(), parent_->limit_trackers_.end());
   }
 
+  // Limits of trackers with a consumption functor are checked against the external source,
+  // so deferring updates of consumption_ does not affect them.
+  batch_consumption_ = FLAGS_mem_tracker_consumption_batch_bytes > 0 && !consumption_functor_ &&
+      std::all_of(limit_trackers_.begin(), limit_trackers_.end(), [](MemTracker* tracker) {
+        return static_cast<bool>(tracker->consumption_functor_);
+      });
+
   if (create_metrics) {
     for (MemTracker* tracker = this; tracker; tracker = tracker->parent().get()) {
       if (tracker->metric_entity()) {
@@ -367,6 +386,7 @@ MemTracker::MemTracker(int64_t byte_limit, const string& id,
 
 MemTracker::~MemTracker() {
   VLOG(1) << "Destroying tracker " << ToString();
+  FlushPendingConsumption();
   if (!consumption_functor_) {
     DCHECK_EQ(consumption(), 0) << "Memory tracker " << ToString();
   }
@@ -486,6 +506,12 @@ bool MemTracker::UpdateConsumption(bool force) {
       if (metrics_) {
         metrics_->metric_->set_value(value);
       }
+      if (!parent_ && FLAGS_mem_tracker_consumption_batch_bytes > 0) {
+        // Bound the time batched consumption could stay invisible to ancestor trackers.
+        for (const auto& tracker : ListTrackers()) {
+          tracker->FlushPendingConsumption();
+        }
+      }
     }
     return true;
   }
@@ -508,6 +534,9 @@ void MemTracker::Consume(int64_t bytes) {
   if (PREDICT_FALSE(enable_logging_)) {
     LogUpdate(true, bytes);
   }
+  if (batch_consumption_ && BatchConsumption(bytes)) {
+    return;
+  }
   for (auto& tracker : all_trackers_) {
     if (!tracker->UpdateConsumption()) {
       IncrementBy(bytes, &tracker->consumption_, tracker->metrics_);
@@ -518,6 +547,7 @@ void MemTracker::Consume(int64_t bytes) {
 
 bool MemTracker::TryConsume(int64_t bytes, MemTracker** blocking_mem_tracker) {
   UpdateConsumption();
+  FlushPendingConsumption();
   if (bytes <= 0) {
     return true;
   }
@@ -592,6 +622,9 @@ void MemTracker::Release(int64_t bytes) {
   if (PREDICT_FALSE(enable_logging_)) {
     LogUpdate(false, bytes);
   }
+  if (batch_consumption_ && BatchConsumption(-bytes)) {
+    return;
+  }
 
   for (auto& tracker : all_trackers_) {
     if (!tracker->UpdateConsumption()) {
@@ -607,6 +640,44 @@ void MemTracker::Release(int64_t bytes) {
   }
 }
 
+bool MemTracker::BatchConsumption(int64_t delta) {
+  const int64_t batch_bytes = FLAGS_mem_tracker_consumption_batch_bytes;
+  const int64_t abs_delta = std::abs(delta);
+  if (abs_delta >= batch_bytes) {
+    return false;
+  }
+  pending_consumption_.IncrementBy(delta);
+  batched_bytes_since_flush += abs_delta;
+  if (batched_bytes_since_flush >= batch_bytes) {
+    batched_bytes_since_flush = 0;
+    FlushPendingConsumption();
+  }
+  return true;
+}
+
+void MemTracker::FlushPendingConsumption() {
+  if (!batch_consumption_) {
+    return;
+  }
+  bool expected = false;
+  if (!flushing_pending_consumption_.compare_exchange_strong(expected, true)) {
+    // Somebody else is flushing right now.
+    return;
+  }
+  // Value() is not an atomic snapshot, but every delta that it observed is subtracted exactly
+  // once below, so concurrent updates are never lost, only left for the next flush.
+  auto bytes = pending_consumption_.Value();
+  if (bytes != 0) {
+    pending_consumption_.IncrementBy(-bytes);
+    for (auto& tracker : all_trackers_) {
+      if (!tracker->consumption_functor_) {
+        IncrementBy(bytes, &tracker->consumption_, tracker->metrics_);
+      }
+    }
+  }
+  flushing_pending_consumption_.store(false, std::memory_order_release);
+}
+
 bool MemTracker::AnyLimitExceeded() {
   for (const auto& tracker : limit_trackers_) {
     if (tracker->LimitExceeded()) {
@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
@@ -51,6 +52,7 @@
 #include "yb/util/locks.h"
 #include "yb/util/mutex.h"
 #include "yb/util/random.h"
+#include "yb/util/striped64.h"
 #include "yb/util/strongly_typed_bool.h"
 
 namespace yb {
@@ -289,6 +291,10 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
   // Decreases consumption of this tracker and its ancestors by 'bytes'.
   void Release(int64_t bytes);
 
+  // Applies consumption changes batched in pending_consumption_ to this tracker and its
+  // ancestors. No-op if batching is not enabled for this tracker.
+  void FlushPendingConsumption();
+
   // Returns true if a valid limit of this tracker or one of its ancestors is
   // exceeded.
   bool AnyLimitExceeded();
@@ -397,6 +403,11 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
   // can cause us to go way over mem limits.
   void GcTcmalloc();
 
+  // Accumulates delta in pending_consumption_ when it is small enough to be batched, flushing
+  // it once the current thread batched enough bytes. Returns false if delta should be applied
+  // immediately.
+  bool BatchConsumption(int64_t delta);
+
   // Logs the stack of the current consume/release. Used for debugging only.
   void LogUpdate(bool is_consume, int64_t bytes) const;
 
@@ -440,6 +451,14 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
 
   HighWaterMark consumption_{0};
 
+  // When true, small Consume()/Release() calls are accumulated in pending_consumption_ and
+  // applied to the tracker hierarchy in batches, see FLAGS_mem_tracker_consumption_batch_bytes.
+  // Only enabled for trackers that have no limit enforced through consumption_ along their path
+  // to the root.
+  bool batch_consumption_ = false;
+  LongAdder pending_consumption_;
+  std::atomic<bool> flushing_pending_consumption_{false};
+
   // this tracker plus all of its ancestors
   std::vector<MemTracker*> all_trackers_;
   // all_trackers_ with valid limits
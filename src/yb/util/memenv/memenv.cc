@@ -355,6 +355,10 @@ class InMemoryEnv : public EnvWrapper {
     return GetFileSize(fname);
   }
 
+  Result<uint64_t> GetFileModificationTime(const std::string& fname) override {
+    return STATUS(NotSupported, "GetFileModificationTime is not supported by InMemoryEnv");
+  }
+
   Result<uint64_t> GetBlockSize(const string& fname) override {
     // The default for ext3/ext4 filesystems.
     return 4096;
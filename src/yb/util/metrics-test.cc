@@ -31,6 +31,7 @@
 //
 
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
@@ -51,6 +52,7 @@ using std::string;
 using std::unordered_set;
 using std::vector;
 
+DECLARE_int32(metrics_histogram_stripes);
 DECLARE_int32(metrics_retirement_age_ms);
 
 namespace yb {
@@ -241,6 +243,32 @@ TEST_F(MetricsTest, AggregationTest) {
   ASSERT_NO_FATALS(DoAggregationTest({1, 2, 3, 4}, max_gauge, "test_max_gauge", 4));
 }
 
+METRIC_DEFINE_counter(server, test_server_counter, "Test Server Counter", MetricUnit::kRequests,
+                      "Test counter of a server entity.");
+
+TEST_F(MetricsTest, PrometheusEntityTypesFilter) {
+  auto server_entity = METRIC_ENTITY_server.Instantiate(&registry_, "yb.test");
+  auto counter = METRIC_test_server_counter.Instantiate(server_entity);
+  counter->IncrementBy(7);
+
+  auto write = [this](const vector<string>& entity_types) -> Result<string> {
+    std::stringstream output;
+    PrometheusWriter writer(&output);
+    MetricPrometheusOptions opts;
+    opts.entity_types = entity_types;
+    RETURN_NOT_OK(registry_.WriteForPrometheus(&writer, opts));
+    return output.str();
+  };
+
+  auto output = ASSERT_RESULT(write({}));
+  ASSERT_STR_CONTAINS(output, "test_server_counter{");
+  ASSERT_STR_CONTAINS(output, "metric_id=\"yb.test\"");
+  output = ASSERT_RESULT(write({"tablet", "server"}));
+  ASSERT_STR_CONTAINS(output, "test_server_counter{");
+  output = ASSERT_RESULT(write({"tablet"}));
+  ASSERT_STR_NOT_CONTAINS(output, "test_server_counter");
+}
+
 TEST_F(MetricsTest, SimpleHistogramTest) {
   scoped_refptr<Histogram> hist = METRIC_test_hist.Instantiate(entity_);
   hist->Increment(2);
@@ -299,6 +327,41 @@ TEST_F(MetricsTest, ResetHistogramTest) {
   EXPECT_EQ(0, hist->histogram_->ValueAtPercentile(100));
 }
 
+METRIC_DEFINE_histogram_with_percentiles(test_entity, test_striped_hist, "Test Striped Histogram",
+                        MetricUnit::kMilliseconds, "A striped histogram.", 100000000L, 2);
+
+TEST_F(MetricsTest, StripedHistogramTest) {
+  FLAGS_metrics_histogram_stripes = 4;
+  scoped_refptr<Histogram> hist = METRIC_test_striped_hist.Instantiate(entity_);
+  ASSERT_EQ(3, hist->extra_stripes_.size());
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t != 4; ++t) {
+    threads.emplace_back([hist, t] {
+      for (int i = 1; i <= 100; i++) {
+        hist->Increment(t * 100 + i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(400, hist->TotalCount());
+  auto snapshot = hist->Snapshot();
+  ASSERT_EQ(400, snapshot->CurrentCount());
+  ASSERT_EQ(80200, snapshot->TotalSum());
+  ASSERT_EQ(1, snapshot->MinValue());
+  ASSERT_EQ(400, snapshot->MaxValue());
+  ASSERT_EQ(200, snapshot->ValueAtPercentile(50));
+
+  HistogramSnapshotPB snapshot_pb;
+  ASSERT_OK(hist->GetAndResetHistogramSnapshotPB(&snapshot_pb, MetricJsonOptions()));
+  ASSERT_EQ(400, snapshot_pb.total_count());
+  ASSERT_EQ(0, hist->Snapshot()->CurrentCount());
+  ASSERT_EQ(400, hist->TotalCount());
+}
+
 TEST_F(MetricsTest, JsonPrintTest) {
   scoped_refptr<Counter> bytes_seen = METRIC_reqs_pending.Instantiate(entity_);
   bytes_seen->Increment();
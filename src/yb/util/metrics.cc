@@ -31,6 +31,7 @@
 //
 #include "yb/util/metrics.h"
 
+#include <atomic>
 #include <iostream>
 #include <map>
 #include <regex>
@@ -67,6 +68,13 @@ DEFINE_bool(expose_metric_histogram_percentiles, true,
 
 // Process/server-wide metrics should go into the 'server' entity.
 // More complex applications will define other entities.
+DEFINE_int32(metrics_histogram_stripes, 1,
+             "Number of independent bucket arrays that every histogram metric spreads recording "
+             "threads over. Values are merged when the histogram is read. Higher values reduce "
+             "contention of threads recording into the same histogram, at the cost of memory "
+             "per histogram and slower reads. Applies to histograms created after the change.");
+TAG_FLAG(metrics_histogram_stripes, advanced);
+
 METRIC_DEFINE_entity(server);
 
 namespace yb {
@@ -311,6 +319,12 @@ Status MetricEntity::WriteAsJson(JsonWriter* writer,
 CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer,
                                                 const vector<string>& requested_metrics,
                                                 const MetricPrometheusOptions& opts) const {
+  if (!opts.entity_types.empty() &&
+      std::find(opts.entity_types.begin(), opts.entity_types.end(), prototype_->name()) ==
+          opts.entity_types.end()) {
+    return Status::OK();
+  }
+
   bool select_all = MatchMetricInList(id(), requested_metrics);
 
   // We want the keys to be in alphabetical order when printing, so we use an ordered map here.
@@ -889,10 +903,31 @@ scoped_refptr<Histogram> HistogramPrototype::Instantiate(
 // Histogram
 /////////////////////////////////////////////////
 
+namespace {
+
+void InitExtraStripes(const HdrHistogram& histogram,
+                      std::vector<std::unique_ptr<HdrHistogram>>* extra_stripes) {
+  for (int i = 1; i < FLAGS_metrics_histogram_stripes; ++i) {
+    extra_stripes->emplace_back(new HdrHistogram(
+        histogram.highest_trackable_value(), histogram.num_significant_digits()));
+  }
+}
+
+// Threads are assigned stripes round robin, so concurrently recording threads use different
+// stripes as long as there are enough of them.
+size_t ThreadStripeIndex() {
+  static std::atomic<size_t> next_index{0};
+  thread_local size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+  return index;
+}
+
+} // namespace
+
 Histogram::Histogram(const HistogramPrototype* proto)
   : Metric(proto),
     histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())),
     export_percentiles_(proto->export_percentiles()) {
+  InitExtraStripes(*histogram_, &extra_stripes_);
 }
 
 Histogram::Histogram(
@@ -901,14 +936,38 @@ Histogram::Histogram(
   : Metric(std::move(proto)),
     histogram_(new HdrHistogram(highest_trackable_value, num_significant_digits)),
     export_percentiles_(export_percentiles) {
+  InitExtraStripes(*histogram_, &extra_stripes_);
+}
+
+HdrHistogram* Histogram::StripeForCurrentThread() const {
+  if (extra_stripes_.empty()) {
+    return histogram_.get();
+  }
+  size_t index = ThreadStripeIndex() % (extra_stripes_.size() + 1);
+  return index == 0 ? histogram_.get() : extra_stripes_[index - 1].get();
 }
 
 void Histogram::Increment(int64_t value) {
-  histogram_->Increment(value);
+  StripeForCurrentThread()->Increment(value);
 }
 
 void Histogram::IncrementBy(int64_t value, int64_t amount) {
-  histogram_->IncrementBy(value, amount);
+  StripeForCurrentThread()->IncrementBy(value, amount);
+}
+
+std::unique_ptr<HdrHistogram> Histogram::Snapshot() const {
+  std::unique_ptr<HdrHistogram> result(new HdrHistogram(*histogram_));
+  for (const auto& stripe : extra_stripes_) {
+    result->MergeFrom(*stripe);
+  }
+  return result;
+}
+
+void Histogram::ResetPercentiles() const {
+  histogram_->ResetPercentiles();
+  for (const auto& stripe : extra_stripes_) {
+    stripe->ResetPercentiles();
+  }
 }
 
 Status Histogram::WriteAsJson(JsonWriter* writer,
@@ -930,12 +989,13 @@ CHECKED_STATUS Histogram::WriteForPrometheus(
     return Status::OK();
   }
 
-  HdrHistogram snapshot(*histogram_);
+  auto snapshot_holder = Snapshot();
+  const HdrHistogram& snapshot = *snapshot_holder;
   // HdrHistogram reports percentiles based on all the data points from the
   // begining of time. We are interested in the percentiles based on just
   // the "newly-arrived" data. So, we will reset the histogram's percentiles
   // between each invocation.
-  histogram_->ResetPercentiles();
+  ResetPercentiles();
 
   // Representing the sum and count require suffixed names.
   std::string hist_name = prototype_->name();
@@ -975,12 +1035,13 @@ CHECKED_STATUS Histogram::WriteForPrometheus(
 
 Status Histogram::GetAndResetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
                                                  const MetricJsonOptions& opts) const {
-  HdrHistogram snapshot(*histogram_);
+  auto snapshot_holder = Snapshot();
+  const HdrHistogram& snapshot = *snapshot_holder;
   // HdrHistogram reports percentiles based on all the data points from the
   // begining of time. We are interested in the percentiles based on just
   // the "newly-arrived" data. So, we will reset the histogram's percentiles
   // between each invocation.
-  histogram_->ResetPercentiles();
+  ResetPercentiles();
 
   snapshot_pb->set_name(prototype_->name());
   if (opts.include_schema_info) {
@@ -1016,22 +1077,26 @@ Status Histogram::GetAndResetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_p
 }
 
 uint64_t Histogram::CountInBucketForValueForTests(uint64_t value) const {
-  return histogram_->CountInBucketForValue(value);
+  return Snapshot()->CountInBucketForValue(value);
 }
 
 uint64_t Histogram::TotalCount() const {
-  return histogram_->TotalCount();
+  uint64_t result = histogram_->TotalCount();
+  for (const auto& stripe : extra_stripes_) {
+    result += stripe->TotalCount();
+  }
+  return result;
 }
 
 uint64_t Histogram::MinValueForTests() const {
-  return histogram_->MinValue();
+  return Snapshot()->MinValue();
 }
 
 uint64_t Histogram::MaxValueForTests() const {
-  return histogram_->MaxValue();
+  return Snapshot()->MaxValue();
 }
 double Histogram::MeanValueForTests() const {
-  return histogram_->MeanValue();
+  return Snapshot()->MeanValue();
 }
 
 ScopedLatencyMetric::ScopedLatencyMetric(
@@ -519,6 +519,10 @@ struct MetricPrometheusOptions {
   // Include the metrics at a level and above.
   // Default: debug
   MetricLevel level;
+
+  // Include only the metrics of entities of these types, e.g. "server" or "tablet".
+  // Default: empty, i.e. all entity types.
+  std::vector<std::string> entity_types;
 };
 
 class MetricEntityPrototype {
@@ -715,10 +719,14 @@ class PrometheusWriter {
   CHECKED_STATUS FlushAggregatedValues() {
     for (const auto& entry : per_table_values_) {
       const auto& attrs = per_table_attributes_[entry.first];
+      // All metrics of a table have the same labels, so they are formatted only once.
+      cached_labels_attr_ = &attrs;
+      cached_labels_.clear();
       for (const auto& metric_entry : entry.second) {
         RETURN_NOT_OK(FlushSingleEntry(attrs, metric_entry.first, metric_entry.second));
       }
     }
+    cached_labels_attr_ = nullptr;
     return Status::OK();
   }
 
@@ -730,27 +738,43 @@ class PrometheusWriter {
   virtual CHECKED_STATUS FlushSingleEntry(const MetricEntity::AttributeMap& attr,
       const std::string& name, const int64_t& value) {
     *output_ << name;
-    size_t total_elements = attr.size();
-    if (total_elements > 0) {
-      *output_ << "{";
-      for (const auto& entry : attr) {
-        *output_ << entry.first << "=\"" << entry.second << "\"";
-        if (--total_elements > 0) {
-          *output_ << ",";
-        }
+    if (&attr == cached_labels_attr_) {
+      if (cached_labels_.empty()) {
+        cached_labels_ = FormatLabels(attr);
       }
-      *output_ << "}";
+      *output_ << cached_labels_;
+    } else {
+      *output_ << FormatLabels(attr);
     }
-    *output_ << " " << value;
-    *output_ << " " << timestamp_;
-    *output_ << std::endl;
+    *output_ << " " << value << " " << timestamp_ << "\n";
     return Status::OK();
   }
 
+  static std::string FormatLabels(const MetricEntity::AttributeMap& attr) {
+    if (attr.empty()) {
+      return std::string();
+    }
+    std::string result = "{";
+    for (const auto& entry : attr) {
+      if (result.size() > 1) {
+        result += ',';
+      }
+      result += entry.first;
+      result += "=\"";
+      result += entry.second;
+      result += '"';
+    }
+    result += '}';
+    return result;
+  }
+
   // Map from table_id to attributes
   std::map<std::string, MetricEntity::AttributeMap> per_table_attributes_;
   // Map from table_id to map of metric_name to value
   std::map<std::string, std::map<std::string, double>> per_table_values_;
+  // Labels of the table being flushed by FlushAggregatedValues, formatted on first use.
+  const MetricEntity::AttributeMap* cached_labels_attr_ = nullptr;
+  std::string cached_labels_;
   // Output stream
   std::stringstream* output_;
   // Timestamp for all metrics belonging to this writer instance.
@@ -1479,8 +1503,13 @@ class Histogram : public Metric {
 
   // Returns a pointer to the underlying histogram. The implementation of HdrHistogram
   //   // is thread safe.
+  // When the histogram is striped, only covers values recorded into the first stripe, use
+  // Snapshot() to get all of them.
   const HdrHistogram* histogram() const { return histogram_.get(); }
 
+  // Returns a copy of the recorded data, merged from all stripes.
+  std::unique_ptr<HdrHistogram> Snapshot() const;
+
   uint64_t CountInBucketForValueForTests(uint64_t value) const;
   uint64_t MinValueForTests() const;
   uint64_t MaxValueForTests() const;
@@ -1489,12 +1518,22 @@ class Histogram : public Metric {
  private:
   FRIEND_TEST(MetricsTest, SimpleHistogramTest);
   FRIEND_TEST(MetricsTest, ResetHistogramTest);
+  FRIEND_TEST(MetricsTest, StripedHistogramTest);
   friend class MetricEntity;
   explicit Histogram(const HistogramPrototype* proto);
   explicit Histogram(std::unique_ptr<HistogramPrototype> proto, uint64_t highest_trackable_value,
         int num_significant_digits, ExportPercentiles export_percentiles);
 
+  // Returns the stripe that the current thread records into.
+  HdrHistogram* StripeForCurrentThread() const;
+
+  // Resets percentiles of all stripes, see HdrHistogram::ResetPercentiles().
+  void ResetPercentiles() const;
+
   const std::unique_ptr<HdrHistogram> histogram_;
+  // Stripes in addition to histogram_ that recording threads are spread over, to avoid
+  // contending on a single set of buckets. See FLAGS_metrics_histogram_stripes.
+  std::vector<std::unique_ptr<HdrHistogram>> extra_stripes_;
   const ExportPercentiles export_percentiles_;
   DISALLOW_COPY_AND_ASSIGN(Histogram);
 };
@@ -31,6 +31,10 @@
 //
 #include "yb/util/pb_util-internal.h"
 
+#include <algorithm>
+
+#include "yb/util/crc.h"
+
 namespace yb {
 namespace pb_util {
 namespace internal {
@@ -116,6 +120,26 @@ bool WritableFileOutputStream::Next(void **data, int *size) {
   return true;
 }
 
+bool Crc32cArrayOutputStream::Next(void **data, int *size) {
+  UpdateCrc();
+  if (position_ == size_) {
+    return false;
+  }
+
+  size_t available = std::min(chunk_size_, size_ - position_);
+  *data = data_ + position_;
+  *size = available;
+  position_ += available;
+  return true;
+}
+
+void Crc32cArrayOutputStream::UpdateCrc() {
+  if (position_ != chunk_start_) {
+    crc::GetCrc32cInstance()->Compute(data_ + chunk_start_, position_ - chunk_start_, &crc_);
+    chunk_start_ = position_;
+  }
+}
+
 } // namespace internal
 } // namespace pb_util
 } // namespace yb
@@ -131,6 +131,49 @@ class WritableFileOutputStream : public google::protobuf::io::ZeroCopyOutputStre
   WritableFile *wfile_;
 };
 
+// Output Stream used by AppendToStringWithCrc32c()
+// Returns the preallocated array in chunks that fit into L1 cache, and computes CRC32C of a chunk
+// when the next one is requested, i.e. right after the chunk was filled.
+class Crc32cArrayOutputStream : public google::protobuf::io::ZeroCopyOutputStream {
+ public:
+  Crc32cArrayOutputStream(uint8_t* data, size_t size, size_t chunk_size = kDefaultChunkSize)
+    : data_(data), size_(size), chunk_size_(chunk_size) {
+    CHECK_GT(chunk_size, 0);
+  }
+
+  bool Next(void **data, int *size) override;
+
+  void BackUp(int count) override {
+    CHECK_GE(count, 0);
+    CHECK_LE(count, position_ - chunk_start_);
+    position_ -= count;
+  }
+
+  int64 ByteCount() const override {
+    return position_;
+  }
+
+  // Returns CRC32C of all bytes written to the stream.
+  uint32_t Finish() {
+    UpdateCrc();
+    return static_cast<uint32_t>(crc_);
+  }
+
+ private:
+  static const size_t kDefaultChunkSize = 4096;
+
+  void UpdateCrc();
+
+  uint8_t* const data_;
+  const size_t size_;
+  const size_t chunk_size_;
+
+  // Start of the chunk that is not included into crc_ yet.
+  size_t chunk_start_ = 0;
+  size_t position_ = 0;
+  uint64_t crc_ = 0;
+};
+
 } // namespace internal
 } // namespace pb_util
 } // namespace yb
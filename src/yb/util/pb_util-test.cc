@@ -42,6 +42,7 @@
 #include <google/protobuf/descriptor.pb.h>
 #include <gtest/gtest.h>
 
+#include "yb/util/crc.h"
 #include "yb/util/env_util.h"
 #include "yb/util/memenv/memenv.h"
 #include "yb/util/pb_util.h"
@@ -459,6 +460,27 @@ TEST_F(TestPBUtil, TestEnumToString) {
 #endif
 }
 
+TEST_F(TestPBUtil, TestAppendToStringWithCrc32c) {
+  // Messages smaller and bigger than a chunk of the checksumming stream.
+  for (size_t note_size : {0, 100, 10000, 100000}) {
+    ProtoContainerTestPB pb;
+    pb.set_name(kTestKeyvalName);
+    pb.set_value(kTestKeyvalValue);
+    pb.set_note(string(note_size, 'x'));
+
+    const string kPrefix = "prefix";
+    faststring expected;
+    expected.append(kPrefix);
+    AppendToString(pb, &expected);
+
+    faststring output;
+    output.append(kPrefix);
+    const auto crc = AppendToStringWithCrc32c(pb, &output);
+    ASSERT_EQ(expected.ToString(), output.ToString());
+    ASSERT_EQ(crc::Crc32c(output.data() + kPrefix.size(), output.size() - kPrefix.size()), crc);
+  }
+}
+
 TEST_F(TestPBUtil, TestPBRequiredToRepeated) {
   // Write the file with required fields.
   {
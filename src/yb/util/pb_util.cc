@@ -87,6 +87,7 @@ using google::protobuf::MessageLite;
 using google::protobuf::Reflection;
 using google::protobuf::SimpleDescriptorDatabase;
 using yb::crc::Crc;
+using yb::pb_util::internal::Crc32cArrayOutputStream;
 using yb::pb_util::internal::SequentialFileFileInputStream;
 using yb::pb_util::internal::WritableFileOutputStream;
 using std::deque;
@@ -193,6 +194,24 @@ void AppendPartialToString(const MessageLite &msg, std::string* output) {
   DoAppendPartialToString(msg, output);
 }
 
+uint32_t AppendToStringWithCrc32c(const MessageLite &msg, faststring *output) {
+  DCHECK(msg.IsInitialized()) << InitializationErrorMessage("serialize", msg);
+  int old_size = output->size();
+  int byte_size = msg.ByteSize();
+
+  output->resize(old_size + byte_size);
+
+  Crc32cArrayOutputStream stream(GetUInt8Ptr(output->data()) + old_size, byte_size);
+  {
+    google::protobuf::io::CodedOutputStream coded_output(&stream);
+    msg.SerializeWithCachedSizes(&coded_output);
+    if (coded_output.HadError() || coded_output.ByteCount() != byte_size) {
+      ByteSizeConsistencyError(byte_size, msg.ByteSize(), coded_output.ByteCount());
+    }
+  }
+  return stream.Finish();
+}
+
 void SerializeToString(const MessageLite &msg, faststring *output) {
   output->clear();
   AppendToString(msg, output);
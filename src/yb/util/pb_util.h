@@ -87,6 +87,10 @@ void AppendToString(const MessageLite &msg, faststring *output);
 void AppendPartialToString(const MessageLite &msg, faststring *output);
 void AppendPartialToString(const MessageLite &msg, std::string *output);
 
+// Same as AppendToString, but also returns CRC32C of the appended bytes. The checksum is computed
+// chunk by chunk while serializing, so each chunk is checksummed while it is still in cache.
+uint32_t AppendToStringWithCrc32c(const MessageLite &msg, faststring *output);
+
 // See MessageLite::SerializeToString.
 void SerializeToString(const MessageLite &msg, faststring *output);
 
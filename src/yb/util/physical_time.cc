@@ -129,8 +129,18 @@ const PhysicalClockPtr& AdjTimeClock() {
   static PhysicalClockPtr instance = std::make_shared<AdjTimeClockImpl>();
   return instance;
 }
+
+const PhysicalClockPtr& BoundedAdjTimeClock() {
+  static PhysicalClockPtr instance = std::make_shared<BoundedClock>(AdjTimeClock());
+  return instance;
+}
 #endif
 
+Result<PhysicalTime> BoundedClock::Now() {
+  auto now = VERIFY_RESULT(impl_->Now());
+  return PhysicalTime{ now.time_point - now.max_error, now.max_error };
+}
+
 Result<PhysicalTime> MockClock::Now() {
   return CheckClockSyncError(value_.load(boost::memory_order_acquire));
 }
@@ -64,10 +64,34 @@ class MockClock : public PhysicalClock {
   boost::atomic<PhysicalTime> value_{{0, 0}};
 };
 
+// Clock that uses the error bound reported by another clock, instead of max_clock_skew_usec, as
+// the uncertainty window of reads. With a precision time source (chrony, PTP) this bound is much
+// smaller than the configured maximal skew.
+//
+// The earliest possible true time is returned as the time point. So if all servers of the cluster
+// use this clock, no server can assign a hybrid time later than the true time, and the latest
+// possible true time of this server bounds the hybrid times of events preceding a read.
+class BoundedClock : public PhysicalClock {
+ public:
+  explicit BoundedClock(PhysicalClockPtr impl) : impl_(std::move(impl)) {}
+
+  Result<PhysicalTime> Now() override;
+
+  MicrosTime MaxGlobalTime(PhysicalTime time) override {
+    return time.time_point + 2 * time.max_error;
+  }
+
+ private:
+  PhysicalClockPtr impl_;
+};
+
 const PhysicalClockPtr& WallClock();
 
 #if !defined(__APPLE__)
 const PhysicalClockPtr& AdjTimeClock();
+
+// BoundedClock over the kernel clock, using the maximal error maintained by the time daemon.
+const PhysicalClockPtr& BoundedAdjTimeClock();
 #endif
 
 } // namespace yb
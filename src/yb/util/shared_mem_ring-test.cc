@@ -0,0 +1,95 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/shared_mem.h"
+#include "yb/util/shared_mem_ring.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class SharedMemRingTest : public YBTest {};
+
+TEST_F(SharedMemRingTest, Simple) {
+  using Ring = SharedMemRing<64>;
+  auto ring = std::make_unique<Ring>();
+  std::string out;
+
+  ASSERT_TRUE(ring->Empty());
+  ASSERT_FALSE(ring->Pop(&out));
+  ASSERT_FALSE(ring->Push(std::string(Ring::kMaxMessageSize + 1, 'x')));
+
+  ASSERT_TRUE(ring->Push("hello"));
+  ASSERT_TRUE(ring->Push(""));
+  ASSERT_TRUE(ring->Pop(&out));
+  ASSERT_EQ(out, "hello");
+  ASSERT_TRUE(ring->Pop(&out));
+  ASSERT_EQ(out, "");
+  ASSERT_TRUE(ring->Empty());
+
+  // Each iteration starts at a different offset, so messages wrap around the end of the ring.
+  for (int i = 0; i != 100; ++i) {
+    std::string message(i % 20, 'a' + i % 26);
+    ASSERT_TRUE(ring->Push(message));
+    ASSERT_TRUE(ring->Pop(&out));
+    ASSERT_EQ(out, message);
+  }
+
+  // Fill the ring, then all accepted messages should be read back in order.
+  int num_pushed = 0;
+  while (ring->Push(std::to_string(num_pushed))) {
+    ++num_pushed;
+  }
+  ASSERT_GE(num_pushed, 1);
+  ASSERT_LE(num_pushed, 64 / 16);
+  for (int i = 0; i != num_pushed; ++i) {
+    ASSERT_TRUE(ring->Pop(&out));
+    ASSERT_EQ(out, std::to_string(i));
+  }
+  ASSERT_TRUE(ring->Empty());
+}
+
+TEST_F(SharedMemRingTest, ProducerConsumer) {
+  using Ring = SharedMemRing<4096>;
+  auto ring_object = ASSERT_RESULT(SharedMemoryObject<Ring>::Create());
+  auto* ring = ring_object.get();
+  constexpr int kNumMessages = 100000;
+
+  std::thread producer([ring] {
+    for (int i = 0; i != kNumMessages;) {
+      auto value = std::to_string(i);
+      if (ring->Push(std::string(i % 100, '.') + value)) {
+        ++i;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::string out;
+  for (int i = 0; i != kNumMessages;) {
+    if (ring->Pop(&out)) {
+      ASSERT_EQ(out, std::string(i % 100, '.') + std::to_string(i));
+      ++i;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  ASSERT_TRUE(ring->Empty());
+}
+
+} // namespace yb
@@ -0,0 +1,151 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_SHARED_MEM_RING_H
+#define YB_UTIL_SHARED_MEM_RING_H
+
+#include <string.h>
+
+#include <atomic>
+#include <limits>
+#include <string>
+
+#include <glog/logging.h>
+
+#include "yb/gutil/port.h"
+
+#include "yb/util/atomic.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+
+// Single producer, single consumer queue of variable length messages.
+// It does not contain pointers and uses only lock-free atomics, so it could be placed in shared
+// memory and used by two processes, for instance with SharedMemoryObject.
+//
+// Messages are stored contiguously, so the producer could fill a message in place and the
+// consumer could process it in place, without intermediate copies.
+template <size_t kCapacity>
+class SharedMemRing {
+  static constexpr size_t kHeaderSize = sizeof(uint64_t);
+  static constexpr size_t kMask = kCapacity - 1;
+  static constexpr uint64_t kWrapMarker = std::numeric_limits<uint64_t>::max();
+
+ public:
+  static_assert(kCapacity && (kCapacity & (kCapacity - 1)) == 0,
+                "Capacity should be a power of 2");
+  static_assert(kCapacity >= 2 * kHeaderSize, "Capacity is too small");
+
+  SharedMemRing() {
+    LOG_IF(FATAL, !IsAcceptableAtomicImpl(head_)) << "Shared memory atomics must be lock-free";
+  }
+
+  SharedMemRing(const SharedMemRing&) = delete;
+  void operator=(const SharedMemRing&) = delete;
+
+  // Max size of a single message.
+  static constexpr size_t kMaxMessageSize = kCapacity / 2 - kHeaderSize;
+
+  // Reserves size bytes for the next message, calls fill(char* out) to fill them and publishes
+  // the message. Returns false, without calling fill, if there is not enough free space.
+  // Should be called by the producer only.
+  template <class F>
+  bool Emplace(size_t size, const F& fill) {
+    if (size > kMaxMessageSize) {
+      return false;
+    }
+    const size_t required = kHeaderSize + AlignUp(size);
+    auto tail = tail_.load(std::memory_order_relaxed);
+    const auto head = head_.load(std::memory_order_acquire);
+    const size_t offset = tail & kMask;
+    const size_t contiguous = kCapacity - offset;
+    const bool wrap = contiguous < required;
+    if (tail + (wrap ? contiguous : 0) + required - head > kCapacity) {
+      return false;
+    }
+    if (wrap) {
+      // Offsets are aligned to the header size, so there is always place for the marker.
+      WriteHeader(offset, kWrapMarker);
+      tail += contiguous;
+    }
+    const size_t message_offset = tail & kMask;
+    WriteHeader(message_offset, size);
+    fill(data_ + message_offset + kHeaderSize);
+    tail_.store(tail + required, std::memory_order_release);
+    return true;
+  }
+
+  bool Push(const Slice& message) {
+    return Emplace(message.size(), [&message](char* out) {
+      memcpy(out, message.data(), message.size());
+    });
+  }
+
+  // Calls process(const Slice& message) for the oldest message in place and removes it.
+  // The slice is valid only during this call. Returns false if the ring is empty.
+  // Should be called by the consumer only.
+  template <class F>
+  bool Consume(const F& process) {
+    auto head = head_.load(std::memory_order_relaxed);
+    const auto tail = tail_.load(std::memory_order_acquire);
+    if (head == tail) {
+      return false;
+    }
+    size_t offset = head & kMask;
+    uint64_t size = ReadHeader(offset);
+    if (size == kWrapMarker) {
+      // Message that follows the marker is published together with it.
+      head += kCapacity - offset;
+      offset = 0;
+      size = ReadHeader(offset);
+    }
+    process(Slice(data_ + offset + kHeaderSize, size));
+    head_.store(head + kHeaderSize + AlignUp(size), std::memory_order_release);
+    return true;
+  }
+
+  bool Pop(std::string* out) {
+    return Consume([out](const Slice& message) {
+      out->assign(message.cdata(), message.size());
+    });
+  }
+
+  bool Empty() const {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+  }
+
+ private:
+  static size_t AlignUp(size_t size) {
+    return (size + kHeaderSize - 1) & ~(kHeaderSize - 1);
+  }
+
+  void WriteHeader(size_t offset, uint64_t value) {
+    memcpy(data_ + offset, &value, sizeof(value));
+  }
+
+  uint64_t ReadHeader(size_t offset) const {
+    uint64_t result;
+    memcpy(&result, data_ + offset, sizeof(result));
+    return result;
+  }
+
+  // Positions grow monotonically, offset in data_ is position modulo capacity.
+  // Head is written by the consumer only, tail by the producer only.
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> head_{0};
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> tail_{0};
+  alignas(CACHELINE_SIZE) char data_[kCapacity];
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_SHARED_MEM_RING_H
@@ -0,0 +1,81 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/util/random_util.h"
+#include "yb/util/space_saving_sketch.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class SpaceSavingSketchTest : public YBTest {
+};
+
+TEST_F(SpaceSavingSketchTest, Exact) {
+  SpaceSavingSketch sketch(4);
+  for (int i = 0; i != 3; ++i) {
+    sketch.Add("a");
+  }
+  sketch.Add("b", 5);
+  sketch.Add("c");
+
+  auto top = sketch.Top(10);
+  ASSERT_EQ(top.size(), 3);
+  ASSERT_EQ(top[0].key, "b");
+  ASSERT_EQ(top[0].count, 5);
+  ASSERT_EQ(top[1].key, "a");
+  ASSERT_EQ(top[1].count, 3);
+  ASSERT_EQ(top[2].key, "c");
+  for (const auto& entry : top) {
+    ASSERT_EQ(entry.error, 0);
+  }
+  ASSERT_EQ(sketch.total(), 9);
+
+  ASSERT_EQ(sketch.Top(1).size(), 1);
+
+  sketch.Clear();
+  ASSERT_TRUE(sketch.Top(10).empty());
+  ASSERT_EQ(sketch.total(), 0);
+}
+
+TEST_F(SpaceSavingSketchTest, HeavyHitters) {
+  constexpr size_t kCapacity = 16;
+  constexpr int kNumHotKeys = 3;
+  constexpr int kIterations = 100000;
+  SpaceSavingSketch sketch(kCapacity);
+
+  // Every fourth key is one of the hot keys, the rest are spread over many cold keys.
+  std::vector<uint64_t> hot_counts(kNumHotKeys);
+  for (int i = 0; i != kIterations; ++i) {
+    if (i % 4 == 0) {
+      auto hot_key = RandomUniformInt(0, kNumHotKeys - 1);
+      ++hot_counts[hot_key];
+      sketch.Add("hot" + std::to_string(hot_key));
+    } else {
+      sketch.Add("cold" + std::to_string(RandomUniformInt(0, 10000)));
+    }
+  }
+
+  auto top = sketch.Top(kNumHotKeys);
+  ASSERT_EQ(top.size(), kNumHotKeys);
+  for (const auto& entry : top) {
+    ASSERT_EQ(entry.key.substr(0, 3), "hot") << entry.key;
+    auto real_count = hot_counts[std::stoi(entry.key.substr(3))];
+    ASSERT_GE(entry.count, real_count);
+    ASSERT_LE(entry.count - entry.error, real_count);
+    ASSERT_LE(entry.error, sketch.total() / kCapacity);
+  }
+}
+
+} // namespace yb
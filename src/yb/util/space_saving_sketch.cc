@@ -0,0 +1,75 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/space_saving_sketch.h"
+
+#include <algorithm>
+
+#include <glog/logging.h>
+
+namespace yb {
+
+SpaceSavingSketch::SpaceSavingSketch(size_t capacity) : capacity_(capacity) {
+  CHECK_GT(capacity, 0);
+  entries_.reserve(capacity);
+  index_.reserve(capacity);
+}
+
+void SpaceSavingSketch::Add(const Slice& key, uint64_t weight) {
+  total_ += weight;
+  std::string key_str = key.ToBuffer();
+  auto it = index_.find(key_str);
+  if (it != index_.end()) {
+    entries_[it->second].count += weight;
+    return;
+  }
+  if (entries_.size() < capacity_) {
+    index_.emplace(key_str, entries_.size());
+    entries_.push_back(Entry{std::move(key_str), weight, 0});
+    return;
+  }
+  // Capacity is small and keys are usually sampled, so linear search for the minimum is cheaper
+  // than keeping the entries ordered.
+  auto min_it = std::min_element(
+      entries_.begin(), entries_.end(), [](const Entry& lhs, const Entry& rhs) {
+    return lhs.count < rhs.count;
+  });
+  const size_t idx = min_it - entries_.begin();
+  index_.erase(min_it->key);
+  min_it->error = min_it->count;
+  min_it->count += weight;
+  min_it->key = key_str;
+  index_.emplace(std::move(key_str), idx);
+}
+
+std::vector<SpaceSavingSketch::Entry> SpaceSavingSketch::Top(size_t max_entries) const {
+  std::vector<Entry> result(entries_);
+  auto compare = [](const Entry& lhs, const Entry& rhs) {
+    return lhs.count > rhs.count;
+  };
+  if (result.size() > max_entries) {
+    std::partial_sort(result.begin(), result.begin() + max_entries, result.end(), compare);
+    result.resize(max_entries);
+  } else {
+    std::sort(result.begin(), result.end(), compare);
+  }
+  return result;
+}
+
+void SpaceSavingSketch::Clear() {
+  total_ = 0;
+  entries_.clear();
+  index_.clear();
+}
+
+} // namespace yb
@@ -0,0 +1,67 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_SPACE_SAVING_SKETCH_H
+#define YB_UTIL_SPACE_SAVING_SKETCH_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/util/slice.h"
+
+namespace yb {
+
+// Finds the most frequent keys of a stream in bounded memory, using the Space-Saving algorithm.
+// At most capacity keys are tracked. When a new key arrives and the sketch is full, it replaces
+// the key with the smallest count and inherits that count as its error. So a reported count
+// overestimates the real one by at most error, and every key that occurs more than
+// total / capacity times is guaranteed to be tracked.
+//
+// Not thread safe.
+class SpaceSavingSketch {
+ public:
+  struct Entry {
+    std::string key;
+    uint64_t count;
+    uint64_t error;
+  };
+
+  explicit SpaceSavingSketch(size_t capacity);
+
+  SpaceSavingSketch(const SpaceSavingSketch&) = delete;
+  void operator=(const SpaceSavingSketch&) = delete;
+
+  void Add(const Slice& key, uint64_t weight = 1);
+
+  // Returns up to max_entries tracked keys in descending order of count.
+  std::vector<Entry> Top(size_t max_entries) const;
+
+  // Sum of weights of all added keys.
+  uint64_t total() const {
+    return total_;
+  }
+
+  void Clear();
+
+ private:
+  const size_t capacity_;
+  uint64_t total_ = 0;
+  std::vector<Entry> entries_;
+  // Maps key to its index in entries_.
+  std::unordered_map<std::string, size_t> index_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_SPACE_SAVING_SKETCH_H
@@ -67,6 +67,7 @@ using std::vector;
 
 using strings::Substitute;
 DECLARE_bool(enable_tracing);
+DECLARE_bool(TEST_thread_pool_fail_create_thread);
 
 using std::shared_ptr;
 
@@ -204,7 +205,7 @@ TEST_F(TestThreadPool, TestThreadPoolWithNoMinimum) {
   // Finish all work
   latch.CountDown();
   thread_pool->Wait();
-  ASSERT_EQ(0, thread_pool->active_threads_);
+  ASSERT_EQ(0, thread_pool->active_threads_.load());
   thread_pool->Shutdown();
   ASSERT_EQ(0, thread_pool->num_threads_);
 }
@@ -298,7 +299,7 @@ TEST_F(TestThreadPool, TestVariableSizeThreadPool) {
   // Finish all work
   latch.CountDown();
   thread_pool->Wait();
-  ASSERT_EQ(0, thread_pool->active_threads_);
+  ASSERT_EQ(0, thread_pool->active_threads_.load());
   thread_pool->Shutdown();
   ASSERT_EQ(0, thread_pool->num_threads_);
 }
@@ -701,6 +702,109 @@ TEST_P(TestThreadPoolTokenTypes, TestTokenSubmissionsAdhereToMaxQueueSize) {
   ASSERT_TRUE(s.IsServiceUnavailable());
 }
 
+TEST_F(TestThreadPool, TestSerialTokensConcurrentSubmit) {
+  const int kNumTokens = 100;
+  const int kSubmitThreads = 8;
+  const int kTasksPerThread = 2000;
+
+  std::unique_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test").Build(&thread_pool));
+
+  struct TokenState {
+    unique_ptr<ThreadPoolToken> token;
+    std::atomic<int> running{0};
+    // Accessed only by tasks of the token, that are run serially.
+    int num_tasks = 0;
+    std::vector<int> last_index = std::vector<int>(kSubmitThreads, -1);
+    bool ordered = true;
+  };
+  std::vector<TokenState> states(kNumTokens);
+  for (auto& state : states) {
+    state.token = thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL);
+  }
+
+  std::atomic<bool> overlapped{false};
+  vector<thread> threads;
+  for (int thread_idx = 0; thread_idx != kSubmitThreads; ++thread_idx) {
+    threads.emplace_back([&, thread_idx] {
+      for (int i = 0; i != kTasksPerThread; ++i) {
+        auto& state = states[(i * 7 + thread_idx) % kNumTokens];
+        ASSERT_OK(state.token->SubmitFunc([&state, &overlapped, thread_idx, i] {
+          if (state.running.fetch_add(1) != 0) {
+            overlapped = true;
+          }
+          // Tasks submitted by the same thread are run in submission order.
+          if (state.last_index[thread_idx] >= i) {
+            state.ordered = false;
+          }
+          state.last_index[thread_idx] = i;
+          ++state.num_tasks;
+          state.running.fetch_sub(1);
+        }));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  int total_tasks = 0;
+  for (auto& state : states) {
+    state.token->Wait();
+    total_tasks += state.num_tasks;
+    ASSERT_TRUE(state.ordered);
+  }
+  ASSERT_FALSE(overlapped);
+  ASSERT_EQ(kSubmitThreads * kTasksPerThread, total_tasks);
+}
+
+// When the pool has no threads and fails to create one, tasks accepted by a SERIAL token are run
+// by the submitting thread, instead of being dropped.
+TEST_F(TestThreadPool, TestSerialTokenFailedThreadCreation) {
+  const int kSubmitThreads = 4;
+  const int kTasksPerThread = 1000;
+
+  std::unique_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test").set_min_threads(0).Build(&thread_pool));
+  auto token = thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL);
+
+  FLAGS_TEST_thread_pool_fail_create_thread = true;
+  auto se = ScopeExit([] {
+    FLAGS_TEST_thread_pool_fail_create_thread = false;
+  });
+
+  std::atomic<int> running{0};
+  std::atomic<bool> overlapped{false};
+  std::atomic<int> num_tasks{0};
+  vector<thread> threads;
+  for (int thread_idx = 0; thread_idx != kSubmitThreads; ++thread_idx) {
+    threads.emplace_back([&] {
+      for (int i = 0; i != kTasksPerThread; ++i) {
+        ASSERT_OK(token->SubmitFunc([&] {
+          if (running.fetch_add(1) != 0) {
+            overlapped = true;
+          }
+          ++num_tasks;
+          running.fetch_sub(1);
+        }));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  token->Wait();
+
+  ASSERT_FALSE(overlapped);
+  ASSERT_EQ(kSubmitThreads * kTasksPerThread, num_tasks.load());
+
+  // Worker threads are used again once they could be created.
+  FLAGS_TEST_thread_pool_fail_create_thread = false;
+  ASSERT_OK(token->SubmitFunc([&num_tasks] { ++num_tasks; }));
+  token->Wait();
+  ASSERT_EQ(kSubmitThreads * kTasksPerThread + 1, num_tasks.load());
+}
+
 TEST_F(TestThreadPool, TestTokenConcurrency) {
   const int kNumTokens = 20;
   const int kTestRuntimeSecs = 1;
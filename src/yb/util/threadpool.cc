@@ -48,6 +48,7 @@
 
 #include "yb/util/debug/long_operation_tracker.h"
 #include "yb/util/errno.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/metrics.h"
 #include "yb/util/stopwatch.h"
@@ -55,6 +56,9 @@
 #include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
 
+DEFINE_test_flag(bool, thread_pool_fail_create_thread, false,
+    "If true, the thread pool fails to create new worker threads.");
+
 namespace yb {
 
 using strings::Substitute;
@@ -152,6 +156,9 @@ void ThreadPoolToken::Shutdown() {
   // also prevents lock inversions.
   deque<ThreadPool::Task> to_release = std::move(entries_);
   pool_->total_queued_tasks_ -= to_release.size();
+  if (mode_ == ThreadPool::ExecutionMode::SERIAL) {
+    StopSerialTasksUnlocked(&to_release);
+  }
 
   switch (state()) {
     case ThreadPoolTokenState::kIdle:
@@ -195,17 +202,15 @@ void ThreadPoolToken::Shutdown() {
 
   // Finally release the queued tasks, outside the lock.
   unique_lock.Unlock();
-  for (auto& t : to_release) {
-    if (t.trace) {
-      t.trace->Release();
-    }
-  }
+  ThreadPool::ReleaseTasks(&to_release);
 }
 
 void ThreadPoolToken::Wait() {
   MutexLock unique_lock(pool_->lock_);
   pool_->CheckNotPoolThreadUnlocked();
-  while (IsActive()) {
+  // Tasks submitted via SERIAL token could be already accepted, while the token is not scheduled
+  // yet by the submission that got the first task.
+  while (IsActive() || HasUnscheduledSerialTasks()) {
     not_running_cond_.Wait();
   }
 }
@@ -213,7 +218,7 @@ void ThreadPoolToken::Wait() {
 bool ThreadPoolToken::WaitUntil(const MonoTime& until) {
   MutexLock unique_lock(pool_->lock_);
   pool_->CheckNotPoolThreadUnlocked();
-  while (IsActive()) {
+  while (IsActive() || HasUnscheduledSerialTasks()) {
     if (!not_running_cond_.WaitUntil(until)) {
       return false;
     }
@@ -225,6 +230,27 @@ bool ThreadPoolToken::WaitFor(const MonoDelta& delta) {
   return WaitUntil(MonoTime::Now() + delta);
 }
 
+void ThreadPoolToken::StopSerialTasksUnlocked(deque<ThreadPool::Task>* tasks) {
+  serial_accepts_tasks_.store(false, std::memory_order_seq_cst);
+  // Pairs with the fence in ThreadPool::DoSubmitSerial. Either the submission sees that the token
+  // does not accept tasks, or its task is drained below.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  DrainSerialTasksUnlocked(tasks);
+}
+
+void ThreadPoolToken::DrainSerialTasksUnlocked(deque<ThreadPool::Task>* tasks) {
+  int64_t drained = 0;
+  while (auto* entry = serial_tasks_.Pop()) {
+    tasks->push_back(std::move(entry->task));
+    delete entry;
+    ++drained;
+  }
+  if (drained) {
+    serial_unfinished_tasks_.fetch_sub(drained, std::memory_order_acq_rel);
+    pool_->total_queued_tasks_.fetch_sub(drained, std::memory_order_acq_rel);
+  }
+}
+
 void ThreadPoolToken::Transition(ThreadPoolTokenState new_state) {
 #ifndef NDEBUG
   CHECK_NE(state_, new_state);
@@ -234,7 +260,7 @@ void ThreadPoolToken::Transition(ThreadPoolTokenState new_state) {
       CHECK(new_state == ThreadPoolTokenState::kRunning ||
             new_state == ThreadPoolTokenState::kQuiesced);
       if (new_state == ThreadPoolTokenState::kRunning) {
-        CHECK(!entries_.empty());
+        CHECK(mode_ == ThreadPool::ExecutionMode::SERIAL || !entries_.empty());
       } else {
         CHECK(entries_.empty());
         CHECK_EQ(active_threads_, 0);
@@ -355,6 +381,10 @@ void ThreadPool::Shutdown() {
     if (!t->entries_.empty()) {
       to_release.emplace_back(std::move(t->entries_));
     }
+    if (t->mode() == ExecutionMode::SERIAL) {
+      to_release.emplace_back();
+      t->StopSerialTasksUnlocked(&to_release.back());
+    }
     switch (t->state()) {
       case ThreadPoolTokenState::kIdle:
         // The token is idle; we can quiesce it immediately.
@@ -382,6 +412,12 @@ void ThreadPool::Shutdown() {
   while (num_threads_ > 0) {
     no_threads_cond_.Wait();
   }
+  // SERIAL tokens could also be run by submitting threads, see RunSerialTasksInline.
+  for (auto* t : tokens_) {
+    while (t->state() == ThreadPoolTokenState::kQuiescing) {
+      t->not_running_cond_.Wait();
+    }
+  }
 
   // All the threads have exited. Check the state of each token.
   for (auto* t : tokens_) {
@@ -392,11 +428,7 @@ void ThreadPool::Shutdown() {
   // Finally release the queued tasks, outside the lock.
   unique_lock.Unlock();
   for (auto& token : to_release) {
-    for (auto& t : token) {
-      if (t.trace) {
-        t.trace->Release();
-      }
-    }
+    ReleaseTasks(&token);
   }
 }
 
@@ -438,8 +470,169 @@ Status ThreadPool::Submit(const std::shared_ptr<Runnable>& r) {
   return DoSubmit(std::move(r), tokenless_.get());
 }
 
+ThreadPool::Task ThreadPool::MakeTask(std::shared_ptr<Runnable> runnable, MonoTime submit_time) {
+  Task e;
+  e.runnable = std::move(runnable);
+  e.trace = Trace::CurrentTrace();
+  // Need to AddRef, since the thread which submitted the task may go away,
+  // and we don't want the trace to be destructed while waiting in the queue.
+  if (e.trace) {
+    e.trace->AddRef();
+  }
+  e.submit_time = submit_time;
+  return e;
+}
+
+void ThreadPool::ReleaseTasks(deque<Task>* tasks) {
+  for (auto& t : *tasks) {
+    if (t.trace) {
+      t.trace->Release();
+    }
+  }
+}
+
+Status ThreadPool::RejectedTaskStatusUnlocked(ThreadPoolToken* token) {
+  if (PREDICT_FALSE(!pool_status_.ok())) {
+    return pool_status_;
+  }
+  return STATUS(ServiceUnavailable, "Thread pool token was shut down.", "", Errno(ESHUTDOWN));
+}
+
+Status ThreadPool::DoSubmitSerial(std::shared_ptr<Runnable> runnable, ThreadPoolToken* token) {
+  MonoTime submit_time = MonoTime::Now();
+
+  if (PREDICT_FALSE(!token->serial_accepts_tasks_.load(std::memory_order_acquire))) {
+    MutexLock guard(lock_);
+    return RejectedTaskStatusUnlocked(token);
+  }
+
+  // Size limit check. Concurrent submissions could exceed the limit by the number of submitting
+  // threads.
+  int64_t capacity_remaining =
+      static_cast<int64_t>(max_threads_) - active_threads_.load(std::memory_order_acquire) +
+      static_cast<int64_t>(max_queue_size_) - total_queued_tasks_.load(std::memory_order_acquire);
+  if (capacity_remaining < 1) {
+    return STATUS(ServiceUnavailable,
+                  Substitute("Thread pool is at capacity ($0/$1 tasks running, $2/$3 tasks queued)",
+                             active_threads_.load(), max_threads_, total_queued_tasks_.load(),
+                             max_queue_size_),
+                  "", Errno(ESHUTDOWN));
+  }
+
+  auto* entry = new ThreadPoolToken::SerialTask;
+  entry->task = MakeTask(std::move(runnable), submit_time);
+  token->serial_tasks_.Push(entry);
+  int64_t length_at_submit = total_queued_tasks_.fetch_add(1, std::memory_order_acq_rel);
+  auto unfinished_tasks = token->serial_unfinished_tasks_.fetch_add(1, std::memory_order_acq_rel);
+
+  // Pairs with the fence in ThreadPoolToken::StopSerialTasksUnlocked.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (PREDICT_FALSE(!token->serial_accepts_tasks_.load(std::memory_order_acquire))) {
+    // The token was shut down concurrently, so the task might be not drained by the shutdown.
+    deque<Task> to_release;
+    MutexLock guard(lock_);
+    token->DrainSerialTasksUnlocked(&to_release);
+    auto status = RejectedTaskStatusUnlocked(token);
+    guard.Unlock();
+    ReleaseTasks(&to_release);
+    return status;
+  }
+
+  if (unfinished_tasks == 0) {
+    deque<Task> to_release;
+    MutexLock guard(lock_);
+    bool run_inline = false;
+    auto status = ScheduleSerialTokenUnlocked(token, &to_release, &run_inline);
+    guard.Unlock();
+    if (run_inline) {
+      RunSerialTasksInline(token);
+    } else if (!status.ok()) {
+      ReleaseTasks(&to_release);
+      return status;
+    } else {
+      not_empty_.Signal();
+    }
+  }
+
+  if (metrics_.queue_length_histogram) {
+    metrics_.queue_length_histogram->Increment(length_at_submit);
+  }
+  if (token->metrics_.queue_length_histogram) {
+    token->metrics_.queue_length_histogram->Increment(length_at_submit);
+  }
+
+  return Status::OK();
+}
+
+Status ThreadPool::ScheduleSerialTokenUnlocked(
+    ThreadPoolToken* token, deque<Task>* to_release, bool* run_inline) {
+  if (PREDICT_FALSE(!pool_status_.ok() || !token->MaySubmitNewTasks())) {
+    token->DrainSerialTasksUnlocked(to_release);
+    return RejectedTaskStatusUnlocked(token);
+  }
+
+  DCHECK_EQ(ThreadPoolTokenState::kIdle, token->state());
+  int inactive_threads = num_threads_ - active_threads_;
+  int additional_threads = (queue_.size() + 1) - inactive_threads;
+  if (additional_threads > 0 && num_threads_ < max_threads_) {
+    Status status = CreateThreadUnlocked();
+    if (!status.ok()) {
+      LOG(WARNING) << "Thread pool failed to create thread: " << status << ", num_threads: "
+                   << num_threads_ << ", max_threads: " << max_threads_;
+      if (num_threads_ == 0) {
+        // Tasks submitted concurrently via this token were already accepted, so they could not
+        // be rejected. The submitting thread runs the token instead of a worker.
+        token->Transition(ThreadPoolTokenState::kRunning);
+        token->active_threads_++;
+        *run_inline = true;
+        return status;
+      }
+    }
+  }
+
+  queue_.emplace_back(token);
+  token->Transition(ThreadPoolTokenState::kRunning);
+  return Status::OK();
+}
+
+void ThreadPool::RunSerialTasksInline(ThreadPoolToken* token) {
+  MutexLock unique_lock(lock_);
+  for (;;) {
+    // The token could be shut down concurrently, draining the rest of its tasks.
+    auto* entry = token->state() == ThreadPoolTokenState::kRunning
+        ? token->serial_tasks_.Pop() : nullptr;
+    if (entry) {
+      Task task = std::move(entry->task);
+      delete entry;
+      --total_queued_tasks_;
+      unique_lock.Unlock();
+      {
+        ADOPT_TRACE(task.trace);
+        if (task.trace) {
+          task.trace->Release();
+        }
+        task.runnable->Run();
+        task.runnable.reset();
+      }
+      unique_lock.Lock();
+      if (token->serial_unfinished_tasks_.fetch_sub(1, std::memory_order_acq_rel) > 1) {
+        continue;
+      }
+    }
+    break;
+  }
+  if (--token->active_threads_ == 0) {
+    token->Transition(token->state() == ThreadPoolTokenState::kQuiescing
+        ? ThreadPoolTokenState::kQuiesced : ThreadPoolTokenState::kIdle);
+  }
+}
+
 Status ThreadPool::DoSubmit(const std::shared_ptr<Runnable> task, ThreadPoolToken* token) {
   DCHECK(token);
+  if (token->mode() == ExecutionMode::SERIAL) {
+    return DoSubmitSerial(std::move(task), token);
+  }
+
   MonoTime submit_time = MonoTime::Now();
 
   MutexLock guard(lock_);
@@ -457,7 +650,8 @@ Status ThreadPool::DoSubmit(const std::shared_ptr<Runnable> task, ThreadPoolToke
   if (capacity_remaining < 1) {
     return STATUS(ServiceUnavailable,
                   Substitute("Thread pool is at capacity ($0/$1 tasks running, $2/$3 tasks queued)",
-                             num_threads_, max_threads_, total_queued_tasks_, max_queue_size_),
+                             num_threads_, max_threads_, total_queued_tasks_.load(),
+                             max_queue_size_),
                   "", Errno(ESHUTDOWN));
   }
 
@@ -470,10 +664,8 @@ Status ThreadPool::DoSubmit(const std::shared_ptr<Runnable> task, ThreadPoolToke
   // It's also harmless.
   //
   // Of course, we never create more than max_threads_ threads no matter what.
-  int threads_from_this_submit =
-      token->IsActive() && token->mode() == ExecutionMode::SERIAL ? 0 : 1;
   int inactive_threads = num_threads_ - active_threads_;
-  int additional_threads = (queue_.size() + threads_from_this_submit) - inactive_threads;
+  int additional_threads = (queue_.size() + 1) - inactive_threads;
   if (additional_threads > 0 && num_threads_ < max_threads_) {
     Status status = CreateThreadUnlocked();
     if (!status.ok()) {
@@ -488,29 +680,16 @@ Status ThreadPool::DoSubmit(const std::shared_ptr<Runnable> task, ThreadPoolToke
     }
   }
 
-  Task e;
-  e.runnable = task;
-  e.trace = Trace::CurrentTrace();
-  // Need to AddRef, since the thread which submitted the task may go away,
-  // and we don't want the trace to be destructed while waiting in the queue.
-  if (e.trace) {
-    e.trace->AddRef();
-  }
-  e.submit_time = submit_time;
-
   // Add the task to the token's queue.
   ThreadPoolTokenState state = token->state();
   DCHECK(state == ThreadPoolTokenState::kIdle ||
          state == ThreadPoolTokenState::kRunning);
-  token->entries_.emplace_back(std::move(e));
-  if (state == ThreadPoolTokenState::kIdle ||
-      token->mode() == ExecutionMode::CONCURRENT) {
-    queue_.emplace_back(token);
-    if (state == ThreadPoolTokenState::kIdle) {
-      token->Transition(ThreadPoolTokenState::kRunning);
-    }
+  token->entries_.emplace_back(MakeTask(task, submit_time));
+  queue_.emplace_back(token);
+  if (state == ThreadPoolTokenState::kIdle) {
+    token->Transition(ThreadPoolTokenState::kRunning);
   }
-  int length_at_submit = total_queued_tasks_++;
+  int64_t length_at_submit = total_queued_tasks_++;
 
   guard.Unlock();
   not_empty_.Signal();
@@ -580,12 +759,23 @@ void ThreadPool::DispatchThread(bool permanent) {
     ThreadPoolToken* token = queue_.front();
     queue_.pop_front();
     DCHECK_EQ(ThreadPoolTokenState::kRunning, token->state());
-    DCHECK(!token->entries_.empty());
-    Task task = std::move(token->entries_.front());
-    token->entries_.pop_front();
+    Task task;
+    if (token->mode() == ExecutionMode::SERIAL) {
+      // Only the worker running the token pops its tasks, and the token is scheduled only when
+      // it has unfinished tasks that were already pushed.
+      auto* entry = token->serial_tasks_.Pop();
+      DCHECK(entry);
+      task = std::move(entry->task);
+      delete entry;
+    } else {
+      DCHECK(!token->entries_.empty());
+      task = std::move(token->entries_.front());
+      token->entries_.pop_front();
+    }
     token->active_threads_++;
-    --total_queued_tasks_;
+    // Increment active threads first, so capacity checked without the lock is never overestimated.
     ++active_threads_;
+    --total_queued_tasks_;
 
     unique_lock.Unlock();
 
@@ -634,14 +824,21 @@ void ThreadPool::DispatchThread(bool permanent) {
     ThreadPoolTokenState state = token->state();
     DCHECK(state == ThreadPoolTokenState::kRunning ||
            state == ThreadPoolTokenState::kQuiescing);
+    const bool serial = token->mode() == ExecutionMode::SERIAL;
+    const bool has_serial_tasks =
+        serial && token->serial_unfinished_tasks_.fetch_sub(1, std::memory_order_acq_rel) > 1;
     if (--token->active_threads_ == 0) {
       if (state == ThreadPoolTokenState::kQuiescing) {
         DCHECK(token->entries_.empty());
         token->Transition(ThreadPoolTokenState::kQuiesced);
+      } else if (serial) {
+        if (has_serial_tasks) {
+          queue_.emplace_back(token);
+        } else {
+          token->Transition(ThreadPoolTokenState::kIdle);
+        }
       } else if (token->entries_.empty()) {
         token->Transition(ThreadPoolTokenState::kIdle);
-      } else if (token->mode() == ExecutionMode::SERIAL) {
-        queue_.emplace_back(token);
       }
     }
     if (--active_threads_ == 0) {
@@ -661,13 +858,16 @@ void ThreadPool::DispatchThread(bool permanent) {
     // Sanity check: if we're the last thread exiting, the queue ought to be
     // empty. Otherwise it will never get processed.
     CHECK(queue_.empty());
-    DCHECK_EQ(0, total_queued_tasks_);
+    DCHECK_EQ(0, total_queued_tasks_.load());
   }
 }
 
 Status ThreadPool::CreateThreadUnlocked() {
   // The first few threads are permanent, and do not time out.
   bool permanent = (num_threads_ < min_threads_);
+  if (PREDICT_FALSE(FLAGS_TEST_thread_pool_fail_create_thread)) {
+    return STATUS(RuntimeError, "Could not create thread", Errno(EAGAIN));
+  }
   scoped_refptr<Thread> t;
   Status s = yb::Thread::Create("thread pool", strings::Substitute("$0 [worker]", name_),
                                   &ThreadPool::DispatchThread, this, permanent, &t);
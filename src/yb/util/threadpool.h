@@ -32,6 +32,7 @@
 #ifndef YB_UTIL_THREADPOOL_H
 #define YB_UTIL_THREADPOOL_H
 
+#include <atomic>
 #include <deque>
 #include <functional>
 #include <memory>
@@ -46,6 +47,7 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/util/condition_variable.h"
 #include "yb/util/enums.h"
+#include "yb/util/lockfree.h"
 #include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
 #include "yb/util/mutex.h"
@@ -322,6 +324,29 @@ class ThreadPool {
   // Submits a task to be run via token.
   Status DoSubmit(std::shared_ptr<Runnable> r, ThreadPoolToken* token);
 
+  // Submits a task to be run via SERIAL token. The pool lock is taken only when the token has no
+  // unfinished tasks, so it should be scheduled, or when the token does not accept tasks.
+  Status DoSubmitSerial(std::shared_ptr<Runnable> r, ThreadPoolToken* token);
+
+  // Adds the SERIAL token, that got its first unfinished task, to the queue of tokens to run.
+  // When the pool has no threads and fails to create one, sets run_inline instead, so the caller
+  // should run the token via RunSerialTasksInline after releasing lock_.
+  // Required that lock_ is held.
+  Status ScheduleSerialTokenUnlocked(
+      ThreadPoolToken* token, std::deque<Task>* to_release, bool* run_inline);
+
+  // Runs tasks of the SERIAL token on the calling thread, until the token has no unfinished tasks.
+  void RunSerialTasksInline(ThreadPoolToken* token);
+
+  // Returns the status for a task submitted via token, which does not accept tasks.
+  // Required that lock_ is held.
+  Status RejectedTaskStatusUnlocked(ThreadPoolToken* token);
+
+  static Task MakeTask(std::shared_ptr<Runnable> runnable, MonoTime submit_time);
+
+  // Releases traces of tasks that will not be run.
+  static void ReleaseTasks(std::deque<Task>* tasks);
+
   // Releases token 't' and invalidates it.
   void ReleaseToken(ThreadPoolToken* t);
 
@@ -337,12 +362,14 @@ class ThreadPool {
   ConditionVariable no_threads_cond_;
   ConditionVariable not_empty_;
   int num_threads_;
-  int active_threads_;
+
+  // Modified under lock_, read without it by SERIAL token submissions to check capacity.
+  std::atomic<int> active_threads_;
 
   // Total number of client tasks queued, either directly (queue_) or
   // indirectly (tokens_).
-  // Protected by lock_.
-  int total_queued_tasks_;
+  // Modified under lock_, except by SERIAL token submissions.
+  std::atomic<int64_t> total_queued_tasks_;
 
   // All allocated tokens.
   // Tokens are owned by the clients.
@@ -400,7 +427,9 @@ YB_DEFINE_ENUM(ThreadPoolTokenState,
 // thread pool. Tokens can only be created via ThreadPool::NewToken().
 //
 // All functions are thread-safe. Mutable members are protected via the
-// ThreadPool's lock.
+// ThreadPool's lock, except the queue of SERIAL tokens: tasks are pushed to it without the lock,
+// and popped under the lock by the worker thread running the token, so submissions to tokens that
+// already have unfinished tasks do not contend on the pool lock.
 class ThreadPoolToken {
  public:
   // Destroys the token.
@@ -452,6 +481,19 @@ class ThreadPoolToken {
   // Changes this token's state to 'new_state' taking actions as needed.
   void Transition(ThreadPoolTokenState new_state);
 
+  // Stops accepting tasks via SERIAL token and moves the queued tasks to 'tasks'.
+  // Required that the pool lock is held.
+  void StopSerialTasksUnlocked(std::deque<ThreadPool::Task>* tasks);
+
+  // Moves the tasks queued to SERIAL token to 'tasks'. Required that the pool lock is held.
+  void DrainSerialTasksUnlocked(std::deque<ThreadPool::Task>* tasks);
+
+  // Returns true if a SERIAL token got tasks, but was not scheduled to run them yet.
+  bool HasUnscheduledSerialTasks() const {
+    return state_ == ThreadPoolTokenState::kIdle &&
+           serial_unfinished_tasks_.load(std::memory_order_acquire) > 0;
+  }
+
   // Returns true if this token has a task queued and ready to run, or if a
   // task belonging to this token is already running.
   bool IsActive() const {
@@ -480,9 +522,24 @@ class ThreadPoolToken {
   // Token state machine.
   ThreadPoolTokenState state_;
 
-  // Queued client tasks.
+  // Queued client tasks of CONCURRENT token.
   std::deque<ThreadPool::Task> entries_;
 
+  struct SerialTask : public MPSCQueueEntry<SerialTask> {
+    ThreadPool::Task task;
+  };
+
+  // Queued client tasks of SERIAL token.
+  MPSCQueue<SerialTask> serial_tasks_;
+
+  // Number of tasks of SERIAL token that were submitted, but not finished yet. The submission
+  // that changes it from zero schedules the token to run, while the worker that changes it to
+  // zero makes the token idle.
+  std::atomic<int64_t> serial_unfinished_tasks_{0};
+
+  // Whether new tasks may be submitted via SERIAL token, read without the pool lock.
+  std::atomic<bool> serial_accepts_tasks_{true};
+
   // Condition variable for "token is idle". Waiters wake up when the token
   // transitions to kIdle or kQuiesced.
   ConditionVariable not_running_cond_;
@@ -52,6 +52,8 @@ using rapidjson::Value;
 using std::string;
 using std::vector;
 
+DECLARE_int32(trace_sampling_1_in_n);
+
 namespace yb {
 
 class TraceTest : public YBTest {
@@ -121,6 +123,32 @@ TEST_F(TraceTest, TestChildTrace) {
             XOutDigits(traceA->DumpToString(false)));
 }
 
+TEST_F(TraceTest, TestSampled) {
+  FLAGS_enable_tracing = false;
+  scoped_refptr<Trace> not_sampled(new Trace);
+  ASSERT_FALSE(not_sampled->MaybeSample());
+  TRACE_TO(not_sampled, "not collected");
+  ASSERT_EQ("", not_sampled->DumpToString(false));
+
+  FLAGS_trace_sampling_1_in_n = 1;
+  scoped_refptr<Trace> sampled(new Trace);
+  ASSERT_TRUE(sampled->MaybeSample());
+  scoped_refptr<Trace> child(new Trace);
+  sampled->AddChildTrace(child.get());
+  ASSERT_TRUE(child->sampled());
+  {
+    ADOPT_TRACE(child.get());
+    TRACE("hello from child");
+  }
+  TRACE_TO(sampled, "hello from parent");
+
+  string result = XOutDigits(sampled->DumpToString(false));
+  ASSERT_EQ("XXXX XX:XX:XX.XXXXXX trace-test.cc:XXX] hello from parent\n"
+            "..  Related trace:\n"
+            "..  XXXX XX:XX:XX.XXXXXX trace-test.cc:XXX] hello from child\n",
+            result);
+}
+
 static void GenerateTraceEvents(int thread_id,
                                 int num_events) {
   for (int i = 0; i < num_events; i++) {
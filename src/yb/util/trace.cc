@@ -49,6 +49,7 @@
 #include "yb/util/memory/arena.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/object_pool.h"
+#include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 
 DEFINE_bool(enable_tracing, false, "Flag to enable/disable tracing across the code.");
@@ -59,6 +60,14 @@ DEFINE_int32(tracing_level, 0, "verbosity levels (like --v) up to which tracing
 TAG_FLAG(tracing_level, advanced);
 TAG_FLAG(tracing_level, runtime);
 
+DEFINE_int32(trace_sampling_1_in_n, 0,
+             "When enable_tracing is off, collect traces for a random 1 in N of the incoming RPC "
+             "calls, including traces of the operations and outbound calls they start. Slow "
+             "sampled calls are logged with their traces, as when enable_tracing is on. 0 "
+             "disables sampling.");
+TAG_FLAG(trace_sampling_1_in_n, advanced);
+TAG_FLAG(trace_sampling_1_in_n, runtime);
+
 namespace yb {
 
 using strings::internal::SubstituteArg;
@@ -366,8 +375,21 @@ void Trace::DumpCurrentTrace() {
   t->Dump(&std::cerr, true);
 }
 
+bool Trace::MaybeSample() {
+  auto sampling_1_in_n = GetAtomicFlag(&FLAGS_trace_sampling_1_in_n);
+  if (sampling_1_in_n <= 0 || GetAtomicFlag(&FLAGS_enable_tracing) ||
+      !RandomWithChance(sampling_1_in_n)) {
+    return false;
+  }
+  set_sampled();
+  return true;
+}
+
 void Trace::AddChildTrace(Trace* child_trace) {
   CHECK_NOTNULL(child_trace);
+  if (sampled()) {
+    child_trace->set_sampled();
+  }
   {
     std::lock_guard<simple_spinlock> l(lock_);
     scoped_refptr<Trace> ptr(child_trace);
@@ -52,6 +52,11 @@
 DECLARE_bool(enable_tracing);
 DECLARE_int32(tracing_level);
 
+// Whether trace messages should be collected into 'trace': either tracing is enabled globally
+// or 'trace' was picked for sampling, see Trace::set_sampled().
+#define YB_TRACE_ENABLED_FOR(trace) \
+  (GetAtomicFlag(&FLAGS_enable_tracing) || ((trace) && (trace)->sampled()))
+
 // Adopt a Trace on the current thread for the duration of the current
 // scope. The old current Trace is restored when the scope is exited.
 //
@@ -65,10 +70,9 @@ DECLARE_int32(tracing_level);
 //  VTRACE(1, "Acquired timestamp $0", timestamp);
 #define VTRACE(level, format, substitutions...) \
   do { \
-    if (GetAtomicFlag(&FLAGS_enable_tracing) && \
-            level <= GetAtomicFlag(&FLAGS_tracing_level)) { \
+    if (level <= GetAtomicFlag(&FLAGS_tracing_level)) { \
       yb::Trace* _trace = Trace::CurrentTrace(); \
-      if (_trace) { \
+      if (_trace && YB_TRACE_ENABLED_FOR(_trace)) { \
         _trace->SubstituteAndTrace(__FILE__, __LINE__, MonoTime::Now(), (format),  \
           ##substitutions); \
       } \
@@ -85,7 +89,7 @@ DECLARE_int32(tracing_level);
 // Like the above, but takes the trace pointer as an explicit argument.
 #define VTRACE_TO(level, trace, format, substitutions...) \
   do { \
-    if (GetAtomicFlag(&FLAGS_enable_tracing) && \
+    if (YB_TRACE_ENABLED_FOR(trace) && \
             level <= GetAtomicFlag(&FLAGS_tracing_level)) { \
       (trace)->SubstituteAndTrace( \
           __FILE__, __LINE__, MonoTime::Now(), (format), ##substitutions); \
@@ -98,7 +102,7 @@ DECLARE_int32(tracing_level);
 // Like the above, but takes the trace pointer as an explicit argument.
 #define TRACE_TO_WITH_TIME(trace, time, format, substitutions...) \
   do { \
-    if (GetAtomicFlag(&FLAGS_enable_tracing)) { \
+    if (YB_TRACE_ENABLED_FOR(trace)) { \
       (trace)->SubstituteAndTrace( \
           __FILE__, __LINE__, (time), (format), ##substitutions); \
     } \
@@ -106,7 +110,7 @@ DECLARE_int32(tracing_level);
 
 #define PLAIN_TRACE_TO(trace, message) \
   do { \
-    if (GetAtomicFlag(&FLAGS_enable_tracing)) { \
+    if (YB_TRACE_ENABLED_FOR(trace)) { \
       (trace)->Trace(__FILE__, __LINE__, (message)); \
     } \
   } while (0)
@@ -116,11 +120,9 @@ DECLARE_int32(tracing_level);
 #define PRINT_THIS_TRACE() \
   TRACE("Requesting to print this trace"); \
   do { \
-    if (GetAtomicFlag(&FLAGS_enable_tracing)) { \
-      yb::Trace* _trace = Trace::CurrentTrace(); \
-      if (_trace) { \
-        _trace->set_must_print(true); \
-      } \
+    yb::Trace* _trace = Trace::CurrentTrace(); \
+    if (_trace && YB_TRACE_ENABLED_FOR(_trace)) { \
+      _trace->set_must_print(true); \
     } \
   } while (0)
 
@@ -210,6 +212,19 @@ class Trace : public RefCountedThreadSafe<Trace> {
     must_print_ = flag;
   }
 
+  // Sampled traces collect messages even when FLAGS_enable_tracing is off.
+  bool sampled() const {
+    return sampled_.load(std::memory_order_relaxed);
+  }
+
+  void set_sampled() {
+    sampled_.store(true, std::memory_order_relaxed);
+  }
+
+  // Marks this trace as sampled with probability 1 / FLAGS_trace_sampling_1_in_n, when tracing
+  // is not enabled globally. Returns true if the trace was sampled.
+  bool MaybeSample();
+
  private:
   friend class ScopedAdoptTrace;
   friend class RefCountedThreadSafe<Trace>;
@@ -243,6 +258,10 @@ class Trace : public RefCountedThreadSafe<Trace> {
   // A hint to request that the collected trace be printed.
   bool must_print_ = false;
 
+  // Whether this trace was picked to collect messages while tracing is disabled globally.
+  // Inherited by child traces.
+  std::atomic<bool> sampled_{false};
+
   std::vector<scoped_refptr<Trace> > child_traces_;
 
   DISALLOW_COPY_AND_ASSIGN(Trace);
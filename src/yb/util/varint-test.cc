@@ -226,5 +226,32 @@ TEST_F(VarIntTest, TestTwosComplementEncoding) {
   }
 }
 
+TEST_F(VarIntTest, TryAddComparable) {
+  const std::vector<int64_t> small_values = {
+    -(1LL << 62) + 1, -(1LL << 40), -129, -1, 0, 1, 63, 64, 8191, 8192, (1LL << 62) - 1,
+  };
+  for (auto lhs : small_values) {
+    for (auto rhs : small_values) {
+      SCOPED_TRACE(Format("lhs: $0, rhs: $1", lhs, rhs));
+      std::string sum;
+      ASSERT_TRUE(VarInt::TryAddComparable(
+          VarInt(lhs).EncodeToComparable(), VarInt(rhs).EncodeToComparable(), &sum));
+      ASSERT_EQ((VarInt(lhs) + VarInt(rhs)).EncodeToComparable(), sum);
+    }
+  }
+
+  // Values of 2^62 and beyond by absolute value have to go through arbitrary precision.
+  for (const auto& value : values_) {
+    const auto encoded = value.EncodeToComparable();
+    std::string sum;
+    const bool fast = VarInt::TryAddComparable(encoded, VarInt(1).EncodeToComparable(), &sum);
+    if (fast) {
+      ASSERT_EQ((value + VarInt(1)).EncodeToComparable(), sum);
+    } else {
+      ASSERT_GT(encoded.size(), 9U);
+    }
+  }
+}
+
 } // namespace util
 } // namespace yb
@@ -15,6 +15,8 @@
 
 #include <openssl/bn.h>
 
+#include "yb/util/fast_varint.h"
+
 namespace yb {
 namespace util {
 
@@ -202,6 +204,36 @@ Status VarInt::DecodeFromComparable(const string& str) {
   return DecodeFromComparable(Slice(str));
 }
 
+namespace {
+
+// The comparable encoding of n bytes holds 7 * n - 1 bits of magnitude, so values encoded in at
+// most 9 bytes are less than 2^62 by absolute value, and the sum of two of them fits into int64_t.
+// For such values the encoding matches FastEncodeSignedVarInt.
+constexpr size_t kMaxEncodedSizeForFastAdd = 9;
+
+bool DecodeSmallComparable(Slice slice, int64_t* value) {
+  if (slice.empty() || slice.size() > kMaxEncodedSizeForFastAdd) {
+    return false;
+  }
+  auto decoded = FastDecodeSignedVarInt(&slice);
+  if (!decoded.ok() || !slice.empty()) {
+    return false;
+  }
+  *value = *decoded;
+  return true;
+}
+
+} // namespace
+
+bool VarInt::TryAddComparable(const Slice& lhs, const Slice& rhs, std::string* sum) {
+  int64_t lhs_value, rhs_value;
+  if (!DecodeSmallComparable(lhs, &lhs_value) || !DecodeSmallComparable(rhs, &rhs_value)) {
+    return false;
+  }
+  *sum = FastEncodeSignedVarIntToStr(lhs_value + rhs_value);
+  return true;
+}
+
 std::string VarInt::EncodeToTwosComplement() const {
   if (BN_is_zero(impl_.get())) {
     return std::string(1, 0);
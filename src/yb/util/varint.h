@@ -189,6 +189,11 @@ class VarInt {
   CHECKED_STATUS DecodeFromComparable(const Slice& string);
   CHECKED_STATUS DecodeFromComparable(const std::string& string);
 
+  // Adds two varints in comparable encoding without converting them to arbitrary precision,
+  // when both of them are small enough for the sum to fit into int64_t. Returns false, leaving
+  // sum untouched, when this fast path is not applicable and the caller should decode the values.
+  static bool TryAddComparable(const Slice& lhs, const Slice& rhs, std::string* sum);
+
   // Each byte in the encoding encodes two digits, and a continuation bit in the beginning.
   // The continuation bit is zero if and only if this is the last byte of the encoding.
   std::string EncodeToTwosComplement() const;
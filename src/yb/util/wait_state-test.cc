@@ -0,0 +1,44 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <thread>
+
+#include "yb/util/test_util.h"
+#include "yb/util/wait_state.h"
+
+namespace yb {
+
+class WaitStateTest : public YBTest {
+};
+
+TEST_F(WaitStateTest, TestScopedWaitEvent) {
+  ASSERT_EQ(WaitEvent::kNone, CurrentWaitEvent());
+  auto initial_micros = GetWaitEventMicros(WaitEvent::kWalSync);
+  auto initial_waiters = GetWaitEventWaiters(WaitEvent::kWalSync);
+  {
+    ScopedWaitEvent wait_event(WaitEvent::kWalSync);
+    ASSERT_EQ(WaitEvent::kWalSync, CurrentWaitEvent());
+    ASSERT_EQ(initial_waiters + 1, GetWaitEventWaiters(WaitEvent::kWalSync));
+    {
+      ScopedWaitEvent nested_wait_event(WaitEvent::kLockManager);
+      ASSERT_EQ(WaitEvent::kLockManager, CurrentWaitEvent());
+    }
+    ASSERT_EQ(WaitEvent::kWalSync, CurrentWaitEvent());
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(WaitEvent::kNone, CurrentWaitEvent());
+  ASSERT_EQ(initial_waiters, GetWaitEventWaiters(WaitEvent::kWalSync));
+  ASSERT_GE(GetWaitEventMicros(WaitEvent::kWalSync), initial_micros + 10000);
+}
+
+} // namespace yb
@@ -0,0 +1,110 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/wait_state.h"
+
+#include "yb/gutil/bind.h"
+#include "yb/util/metrics.h"
+#include "yb/util/striped64.h"
+
+METRIC_DEFINE_gauge_uint64(server, wait_event_lock_manager_time,
+    "Lock Manager Wait Time", yb::MetricUnit::kMicroseconds,
+    "Time spent waiting for conflicting DocDB locks since the server started.",
+    yb::EXPOSE_AS_COUNTER);
+METRIC_DEFINE_gauge_uint64(server, wait_event_lock_manager_waiters,
+    "Lock Manager Waiters", yb::MetricUnit::kThreads,
+    "Number of threads currently waiting for conflicting DocDB locks.");
+METRIC_DEFINE_gauge_uint64(server, wait_event_mvcc_safe_time_time,
+    "MVCC Safe Time Wait Time", yb::MetricUnit::kMicroseconds,
+    "Time spent waiting for MVCC safe time to reach the read time since the server started.",
+    yb::EXPOSE_AS_COUNTER);
+METRIC_DEFINE_gauge_uint64(server, wait_event_mvcc_safe_time_waiters,
+    "MVCC Safe Time Waiters", yb::MetricUnit::kThreads,
+    "Number of threads currently waiting for MVCC safe time to reach the read time.");
+METRIC_DEFINE_gauge_uint64(server, wait_event_wal_sync_time,
+    "WAL Sync Wait Time", yb::MetricUnit::kMicroseconds,
+    "Time spent waiting for the WAL to be synced to disk since the server started.",
+    yb::EXPOSE_AS_COUNTER);
+METRIC_DEFINE_gauge_uint64(server, wait_event_wal_sync_waiters,
+    "WAL Sync Waiters", yb::MetricUnit::kThreads,
+    "Number of threads currently waiting for the WAL to be synced to disk.");
+
+namespace yb {
+
+namespace {
+
+thread_local WaitEvent current_wait_event = WaitEvent::kNone;
+
+struct WaitEventStats {
+  LongAdder micros;
+  LongAdder waiters;
+};
+
+WaitEventStats* Stats() {
+  static WaitEventStats stats[kWaitEventMapSize];
+  return stats;
+}
+
+} // namespace
+
+WaitEvent CurrentWaitEvent() {
+  return current_wait_event;
+}
+
+uint64_t GetWaitEventMicros(WaitEvent event) {
+  return Stats()[to_underlying(event)].micros.Value();
+}
+
+uint64_t GetWaitEventWaiters(WaitEvent event) {
+  return Stats()[to_underlying(event)].waiters.Value();
+}
+
+void RegisterWaitEventMetrics(const scoped_refptr<MetricEntity>& entity) {
+  struct EventMetrics {
+    WaitEvent event;
+    GaugePrototype<uint64_t>* time;
+    GaugePrototype<uint64_t>* waiters;
+  };
+  const EventMetrics kEventMetrics[] = {
+    {WaitEvent::kLockManager, &METRIC_wait_event_lock_manager_time,
+     &METRIC_wait_event_lock_manager_waiters},
+    {WaitEvent::kMvccSafeTime, &METRIC_wait_event_mvcc_safe_time_time,
+     &METRIC_wait_event_mvcc_safe_time_waiters},
+    {WaitEvent::kWalSync, &METRIC_wait_event_wal_sync_time,
+     &METRIC_wait_event_wal_sync_waiters},
+  };
+  for (const auto& metrics : kEventMetrics) {
+    entity->NeverRetire(
+        metrics.time->InstantiateFunctionGauge(
+            entity, Bind(&GetWaitEventMicros, metrics.event)));
+    entity->NeverRetire(
+        metrics.waiters->InstantiateFunctionGauge(
+            entity, Bind(&GetWaitEventWaiters, metrics.event)));
+  }
+}
+
+ScopedWaitEvent::ScopedWaitEvent(WaitEvent event)
+    : event_(event), previous_event_(current_wait_event), start_(std::chrono::steady_clock::now()) {
+  current_wait_event = event;
+  Stats()[to_underlying(event_)].waiters.Increment();
+}
+
+ScopedWaitEvent::~ScopedWaitEvent() {
+  auto& stats = Stats()[to_underlying(event_)];
+  stats.waiters.Decrement();
+  stats.micros.IncrementBy(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start_).count());
+  current_wait_event = previous_event_;
+}
+
+} // namespace yb
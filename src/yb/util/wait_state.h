@@ -0,0 +1,69 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_WAIT_STATE_H
+#define YB_UTIL_WAIT_STATE_H
+
+#include <chrono>
+
+#include "yb/gutil/ref_counted.h"
+#include "yb/util/enums.h"
+
+namespace yb {
+
+class MetricEntity;
+
+// Blocking points of the request path that we keep wait time statistics for.
+YB_DEFINE_ENUM(WaitEvent,
+               (kNone)
+               // Waiting for a conflicting DocDB lock in SharedLockManager.
+               (kLockManager)
+               // Waiting for MVCC safe time to reach the requested read time.
+               (kMvccSafeTime)
+               // Waiting for the WAL to be synced to disk.
+               (kWalSync));
+
+// Returns the wait event the current thread is blocked on, kNone if the thread is not inside
+// a ScopedWaitEvent.
+WaitEvent CurrentWaitEvent();
+
+// Total time in microseconds that threads have spent waiting on the given event since the process
+// started.
+uint64_t GetWaitEventMicros(WaitEvent event);
+
+// Number of threads currently waiting on the given event.
+uint64_t GetWaitEventWaiters(WaitEvent event);
+
+// Registers gauges for the wait time and current waiters of every wait event with the given
+// server entity.
+void RegisterWaitEventMetrics(const scoped_refptr<MetricEntity>& entity);
+
+// Marks the current thread as waiting on the given event while in scope, and accounts the time
+// spent in scope to that event.
+class ScopedWaitEvent {
+ public:
+  explicit ScopedWaitEvent(WaitEvent event);
+  ~ScopedWaitEvent();
+
+  ScopedWaitEvent(const ScopedWaitEvent&) = delete;
+  void operator=(const ScopedWaitEvent&) = delete;
+
+ private:
+  const WaitEvent event_;
+  const WaitEvent previous_event_;
+  const std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_WAIT_STATE_H
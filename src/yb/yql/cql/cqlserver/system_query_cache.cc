@@ -28,10 +28,12 @@
 
 #include "yb/rpc/io_thread_pool.h"
 #include "yb/rpc/scheduler.h"
+#include "yb/rpc/messenger.h"
 #include "yb/util/async_util.h"
 #include "yb/util/format.h"
 #include "yb/util/monotime.h"
 #include "yb/util/string_util.h"
+#include "yb/yql/cql/ql/util/cql_message.h"
 #include "yb/yql/cql/cqlserver/cql_service.h"
 #include "yb/yql/cql/ql/util/statement_params.h"
 #include "yb/yql/cql/ql/util/statement_result.h"
@@ -85,6 +87,12 @@ __attribute__((unused))
 DEFINE_validator(cql_system_query_cache_tables, &validate_tables);
 DEFINE_bool(cql_system_query_cache_empty_responses, true,
             "Whether to cache empty responses from the master.");
+DEFINE_bool(cql_system_query_cache_push_partition_events, false,
+            "When the system query cache is refreshed, push a SCHEMA_CHANGE event to all CQL "
+            "clients for each table whose partitions or replica leaders changed since the "
+            "previous refresh, so that drivers reload their partition map of that table only.");
+TAG_FLAG(cql_system_query_cache_push_partition_events, advanced);
+TAG_FLAG(cql_system_query_cache_push_partition_events, runtime);
 
 namespace yb {
 namespace cqlserver {
@@ -92,6 +100,13 @@ namespace cqlserver {
 using ql::RowsResult;
 using ql::ExecutedResult;
 
+namespace {
+
+const char* const kPartitionsQuery =
+    "SELECT keyspace_name, table_name, start_key, end_key, replica_addresses FROM system.partitions";
+
+} // namespace
+
 // TODO: Possibly do a case-insensitive string comparison.  This may be easier
 // said than done, since capitalization does matter for comparisons in WHERE
 // clauses, etc.
@@ -102,7 +117,7 @@ const char* SYSTEM_QUERIES[] = {
   "SELECT peer, data_center, rack, release_version, rpc_address, tokens FROM system.peers",
   "SELECT data_center, rack, release_version FROM system.local WHERE key='local'",
   "SELECT data_center, rack, release_version, partitioner, tokens FROM system.local WHERE key='local'",
-  "SELECT keyspace_name, table_name, start_key, end_key, replica_addresses FROM system.partitions",
+  kPartitionsQuery,
 
   "SELECT * FROM system.local WHERE key='local'",
   "SELECT schema_version FROM system.local WHERE key='local'",
@@ -209,6 +224,9 @@ void SystemQueryCache::RefreshCache() {
 
     if (status.ok()) {
       auto rows_result = std::dynamic_pointer_cast<RowsResult>(result);
+      if (FLAGS_cql_system_query_cache_push_partition_events && query == kPartitionsQuery) {
+        PushPartitionChangeEvents(*rows_result);
+      }
       if (FLAGS_cql_system_query_cache_empty_responses ||
           rows_result->GetRowBlock()->row_count() > 0) {
         (*new_cache)[query] = rows_result;
@@ -233,6 +251,49 @@ void SystemQueryCache::RefreshCache() {
   ScheduleRefreshCache(false /* now */);
 }
 
+void SystemQueryCache::PushPartitionChangeEvents(const RowsResult& partitions) {
+  // The rows of a table are listed in partition order, so the concatenation of its rows changes
+  // when its partition boundaries or its replicas and their roles change.
+  std::map<std::pair<std::string, std::string>, std::string> table_partitions;
+  const auto row_block = partitions.GetRowBlock();
+  for (const auto& row : row_block->rows()) {
+    auto& value = table_partitions[std::make_pair(row.column(0).string_value(),
+                                                  row.column(1).string_value())];
+    for (size_t i = 2; i < row.column_count(); ++i) {
+      value += row.column(i).ToString();
+    }
+    value += ';';
+  }
+
+  auto events = std::make_shared<ql::CQLServerEventList>();
+  bool has_events = false;
+  if (table_partitions_loaded_) {
+    for (const auto& entry : table_partitions) {
+      const auto it = table_partitions_.find(entry.first);
+      if (it != table_partitions_.end() && it->second == entry.second) {
+        continue;
+      }
+      VLOG(1) << "Partitions of " << entry.first.first << "." << entry.first.second << " changed";
+      std::unique_ptr<ql::EventResponse> response(new ql::SchemaChangeEventResponse(
+          "UPDATED", "TABLE", entry.first.first, entry.first.second));
+      events->AddEvent(std::make_unique<ql::CQLServerEvent>(std::move(response)));
+      has_events = true;
+    }
+  }
+  table_partitions_ = std::move(table_partitions);
+  table_partitions_loaded_ = true;
+
+  auto messenger = service_impl_->messenger();
+  if (!has_events || messenger == nullptr) {
+    return;
+  }
+  Status s = messenger->QueueEventOnAllReactors(events, SOURCE_LOCATION());
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to push partition change events: " << events->ToString()
+                 << ", due to: " << s;
+  }
+}
+
 void SystemQueryCache::ScheduleRefreshCache(bool now) {
   DCHECK(pool_);
   DCHECK(scheduler_);
@@ -21,6 +21,7 @@
 #define YB_YQL_CQL_CQLSERVER_SYSTEM_QUERY_CACHE_H_
 
 #include <condition_variable>
+#include <map>
 #include <mutex>
 #include <unordered_map>
 #include <boost/optional.hpp>
@@ -60,6 +61,9 @@ class SystemQueryCache {
     void ScheduleRefreshCache(bool now);
     void ExecuteSync(const std::string& stmt, Status* status,
         ExecutedResult::SharedPtr* result_ptr);
+    // Compares the partitions of the tables in a system.partitions result with the previous one
+    // and pushes an event for each table whose partitions or replicas changed.
+    void PushPartitionChangeEvents(const RowsResult& partitions);
 
     cqlserver::CQLServiceImpl* const service_impl_;
     std::vector<std::string> queries_;
@@ -69,6 +73,11 @@ class SystemQueryCache {
     MonoTime last_updated_ GUARDED_BY(cache_mutex_);
     std::mutex cache_mutex_;
 
+    // The partitions and replicas of each table, as of the last refresh, keyed by keyspace and
+    // table name. Only accessed from the refresh thread.
+    std::map<std::pair<std::string, std::string>, std::string> table_partitions_;
+    bool table_partitions_loaded_ = false;
+
     // Required for executing statements
     ql::StatementParameters stmt_params_;
 
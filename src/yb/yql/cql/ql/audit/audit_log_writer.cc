@@ -0,0 +1,148 @@
+//--------------------------------------------------------------------------------------------------
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//--------------------------------------------------------------------------------------------------
+
+#include "yb/yql/cql/ql/audit/audit_log_writer.h"
+
+#include "yb/util/env.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/thread.h"
+
+DEFINE_string(ycql_audit_log_dir, "",
+              "Directory of YCQL audit log files written when ycql_audit_log_to_file is set. "
+              "Empty means log_dir.");
+
+DEFINE_int32(ycql_audit_log_file_size_limit_mb, 64,
+             "Size of a YCQL audit log file, after which the log rolls to a new file.");
+TAG_FLAG(ycql_audit_log_file_size_limit_mb, advanced);
+
+DEFINE_int64(ycql_audit_log_buffer_size_bytes, 16 * 1024 * 1024,
+             "Maximum size of YCQL audit records queued to be written to the audit log file.");
+TAG_FLAG(ycql_audit_log_buffer_size_bytes, advanced);
+
+DEFINE_int32(ycql_audit_log_flush_interval_ms, 100,
+             "Interval at which queued YCQL audit records are written to the audit log file.");
+TAG_FLAG(ycql_audit_log_flush_interval_ms, advanced);
+TAG_FLAG(ycql_audit_log_flush_interval_ms, runtime);
+
+DEFINE_bool(ycql_audit_log_drop_on_overflow, false,
+            "Whether YCQL audit records are dropped when the audit log buffer is full. "
+            "Otherwise the request waits until queued records are written.");
+TAG_FLAG(ycql_audit_log_drop_on_overflow, runtime);
+
+namespace yb {
+namespace ql {
+namespace audit {
+
+AuditLogWriter& AuditLogWriter::Instance() {
+  // Never destroyed, so records could be appended while the process exits.
+  static AuditLogWriter* instance = new AuditLogWriter();
+  return *instance;
+}
+
+AuditLogWriter::AuditLogWriter()
+    : log_(Env::Default(),
+           FLAGS_ycql_audit_log_dir.empty() ? FLAGS_log_dir : FLAGS_ycql_audit_log_dir,
+           "ycql_audit") {
+  log_.SetSizeLimitBytes(FLAGS_ycql_audit_log_file_size_limit_mb * 1_MB);
+  CHECK_OK(Thread::Create("ycql", "audit_log_writer", &AuditLogWriter::Run, this, &thread_));
+}
+
+bool AuditLogWriter::Append(std::string record) {
+  const size_t max_bytes = FLAGS_ycql_audit_log_buffer_size_bytes;
+  const size_t size = record.size() + 1;
+  auto queued_bytes = queued_bytes_.load(std::memory_order_acquire);
+  // A record bigger than the buffer is accepted when the buffer is empty.
+  if (queued_bytes != 0 && queued_bytes + size > max_bytes) {
+    if (FLAGS_ycql_audit_log_drop_on_overflow) {
+      records_dropped_.fetch_add(1, std::memory_order_relaxed);
+      YB_LOG_EVERY_N_SECS(WARNING, 10)
+          << "YCQL audit log buffer is full, dropped " << records_dropped() << " records";
+      return false;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    writer_cond_.notify_one();
+    written_cond_.wait(lock, [this, max_bytes, size] {
+      auto queued_bytes = queued_bytes_.load(std::memory_order_acquire);
+      return queued_bytes == 0 || queued_bytes + size <= max_bytes;
+    });
+  }
+
+  queued_bytes = queued_bytes_.fetch_add(size, std::memory_order_acq_rel);
+  auto* entry = new AuditLogRecord;
+  entry->text = std::move(record);
+  queue_.Push(entry);
+  records_queued_.fetch_add(1, std::memory_order_release);
+
+  // Wake up the writer early when half of the buffer is used.
+  if (queued_bytes < max_bytes / 2 && queued_bytes + size >= max_bytes / 2) {
+    writer_cond_.notify_one();
+  }
+  return true;
+}
+
+void AuditLogWriter::Flush() {
+  const auto records_queued = records_queued_.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> lock(mutex_);
+  flush_requested_ = true;
+  writer_cond_.notify_one();
+  written_cond_.wait(lock, [this, records_queued] {
+    return records_written_.load(std::memory_order_acquire) >= records_queued;
+  });
+}
+
+void AuditLogWriter::Run() {
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (!flush_requested_) {
+        writer_cond_.wait_for(
+            lock, std::chrono::milliseconds(FLAGS_ycql_audit_log_flush_interval_ms));
+      }
+      flush_requested_ = false;
+    }
+
+    if (WriteQueued() != 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      written_cond_.notify_all();
+    }
+  }
+}
+
+size_t AuditLogWriter::WriteQueued() {
+  std::string buffer;
+  size_t records = 0;
+  while (auto* entry = queue_.Pop()) {
+    buffer.append(entry->text);
+    buffer.push_back('\n');
+    delete entry;
+    ++records;
+  }
+  if (records == 0) {
+    return 0;
+  }
+
+  auto status = log_.Append(buffer);
+  if (!status.ok()) {
+    YB_LOG_EVERY_N_SECS(WARNING, 10) << "Failed to write YCQL audit log: " << status;
+  }
+  queued_bytes_.fetch_sub(buffer.size(), std::memory_order_acq_rel);
+  records_written_.fetch_add(records, std::memory_order_acq_rel);
+  return records;
+}
+
+} // namespace audit
+} // namespace ql
+} // namespace yb
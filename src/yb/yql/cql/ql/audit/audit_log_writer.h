@@ -0,0 +1,94 @@
+//--------------------------------------------------------------------------------------------------
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// Writes YCQL audit records to a dedicated rolling log file in the background.
+// Request threads only push formatted records to a lock-free queue, a writer thread appends them
+// to the file in batches. The size of queued records is bounded by
+// ycql_audit_log_buffer_size_bytes, when the buffer is full records are either dropped and counted,
+// or the request thread waits for the writer to catch up.
+//--------------------------------------------------------------------------------------------------
+
+#ifndef YB_YQL_CQL_QL_AUDIT_AUDIT_LOG_WRITER_H_
+#define YB_YQL_CQL_QL_AUDIT_AUDIT_LOG_WRITER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/lockfree.h"
+#include "yb/util/rolling_log.h"
+
+namespace yb {
+
+class Thread;
+
+namespace ql {
+namespace audit {
+
+struct AuditLogRecord : public MPSCQueueEntry<AuditLogRecord> {
+  std::string text;
+};
+
+class AuditLogWriter {
+ public:
+  // Returns the process wide writer, its thread is started on first use.
+  static AuditLogWriter& Instance();
+
+  // Queues the record to be written. Returns false if the record was dropped because the buffer
+  // is full and ycql_audit_log_drop_on_overflow is set.
+  bool Append(std::string record);
+
+  // Waits until records queued before this call are written to the file.
+  void Flush();
+
+  uint64_t records_dropped() const {
+    return records_dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  AuditLogWriter();
+
+  void Run();
+
+  // Writes all queued records to the log, returns number of written records.
+  size_t WriteQueued();
+
+  MPSCQueue<AuditLogRecord> queue_;
+
+  // Total size of records in the queue. Concurrent appends could exceed the buffer size by the
+  // size of records being appended.
+  std::atomic<size_t> queued_bytes_{0};
+  std::atomic<uint64_t> records_dropped_{0};
+  std::atomic<uint64_t> records_queued_{0};
+  std::atomic<uint64_t> records_written_{0};
+
+  std::mutex mutex_;
+  // Wakes up the writer thread.
+  std::condition_variable writer_cond_;
+  // Wakes up threads waiting for the written records.
+  std::condition_variable written_cond_;
+  bool flush_requested_ = false;
+
+  // Accessed only by the writer thread.
+  RollingLog log_;
+  scoped_refptr<Thread> thread_;
+};
+
+} // namespace audit
+} // namespace ql
+} // namespace yb
+
+#endif // YB_YQL_CQL_QL_AUDIT_AUDIT_LOG_WRITER_H_
@@ -21,6 +21,7 @@
 
 #include "yb/rpc/connection.h"
 #include "yb/util/date_time.h"
+#include "yb/yql/cql/ql/audit/audit_log_writer.h"
 #include "yb/yql/cql/ql/ptree/pt_alter_keyspace.h"
 #include "yb/yql/cql/ql/ptree/pt_alter_table.h"
 #include "yb/yql/cql/ql/ptree/pt_create_index.h"
@@ -89,6 +90,13 @@ DEFINE_string(ycql_audit_excluded_users,
               "Comma separated list of users to be excluded from the audit log");
 TAG_FLAG(ycql_audit_excluded_users, runtime);
 
+DEFINE_bool(ycql_audit_log_to_file,
+            false,
+            "Write YCQL audit records to a dedicated rolling log file from a background thread, "
+            "instead of writing them to the server log on the request path. "
+            "See ycql_audit_log_* flags for the file, buffer and overflow configuration");
+TAG_FLAG(ycql_audit_log_to_file, runtime);
+
 
 namespace yb {
 namespace ql {
@@ -525,6 +533,11 @@ CHECKED_STATUS AddLogEntry(const LogEntry& e) {
     str.append("; ");
     str.append(e.error_message);
   }
+  if (FLAGS_ycql_audit_log_to_file) {
+    // Records dropped because of a full buffer are counted by the writer.
+    AuditLogWriter::Instance().Append(std::move(str));
+    return Status::OK();
+  }
   // Since glog uses macros, it's not too convenient to extract a log level.
   auto severity = boost::algorithm::to_lower_copy(FLAGS_ycql_audit_log_level);
   if (severity == "info") {
@@ -79,9 +79,12 @@ CHECKED_STATUS Executor::ColumnArgsToPB(const PTDmlStmt *tnode, QLWriteRequestPB
     }
   }
 
-  common::Jsonb jsonb_null;
-  RETURN_NOT_OK(jsonb_null.FromString("null"));
   const MCVector<JsonColumnArg>& jsoncol_args = tnode->json_col_args();
+  common::Jsonb jsonb_null;
+  if (!jsoncol_args.empty()) {
+    // Parsing is not free, so only do it when there are json columns.
+    RETURN_NOT_OK(jsonb_null.FromString("null"));
+  }
   for (const JsonColumnArg& col : jsoncol_args) {
     QLExpressionPB expr_pb;
     RETURN_NOT_OK(PTExprToPB(col.expr(), &expr_pb));
@@ -30,8 +30,9 @@ using client::YBqlReadOpPtr;
 using client::YBSessionPtr;
 using client::YBTransactionPtr;
 
-ExecContext::ExecContext(const ParseTree& parse_tree, const StatementParameters& params)
-    : parse_tree_(parse_tree), params_(params) {
+ExecContext::ExecContext(const ParseTree& parse_tree, const StatementParameters& params,
+                         Arena* exec_mem)
+    : parse_tree_(parse_tree), params_(params), tnode_contexts_(exec_mem) {
 }
 
 ExecContext::~ExecContext() {
@@ -459,8 +459,9 @@ class ExecContext : public ProcessContextBase {
   // Constructor & destructor.
 
   // Constructs an execution context to execute a statement. The context saves references to the
-  // parse tree and parameters.
-  ExecContext(const ParseTree& parse_tree, const StatementParameters& params);
+  // parse tree and parameters. The tnode contexts are allocated from exec_mem, which should
+  // outlive this context.
+  ExecContext(const ParseTree& parse_tree, const StatementParameters& params, Arena* exec_mem);
   virtual ~ExecContext();
 
   // Returns the statement string being executed.
@@ -480,7 +481,7 @@ class ExecContext : public ProcessContextBase {
   TnodeContext* AddTnode(const TreeNode *tnode);
 
   // Return the tnode contexts being executed.
-  std::list<TnodeContext>& tnode_contexts() {
+  MCList<TnodeContext>& tnode_contexts() {
     return tnode_contexts_;
   }
 
@@ -541,7 +542,7 @@ class ExecContext : public ProcessContextBase {
   client::Restart restart_ = client::Restart::kFalse;
 
   // Contexts to execute statement tnodes.
-  std::list<TnodeContext> tnode_contexts_;
+  MCList<TnodeContext> tnode_contexts_;
 
   // Transaction and session to apply transactional write operations in and the start time.
   client::YBTransactionPtr transaction_;
@@ -22,12 +22,14 @@
 #include "yb/client/client.h"
 #include "yb/client/error.h"
 #include "yb/client/rejection_score_source.h"
+#include "yb/client/session.h"
 #include "yb/client/table.h"
 #include "yb/client/table_alterer.h"
 #include "yb/client/table_creator.h"
 #include "yb/client/yb_op.h"
 
 #include "yb/common/common.pb.h"
+#include "yb/common/partition.h"
 #include "yb/common/ql_protocol_util.h"
 #include "yb/common/ql_value.h"
 #include "yb/common/wire_protocol.h"
@@ -79,11 +81,38 @@ DEFINE_bool(ycql_serial_operation_in_transaction_block, true,
             "If true, operations within a transaction block must be executed in order, "
             "at least semantically speaking.");
 
+DEFINE_uint64(ycql_batch_flush_bytes, 0,
+              "When positive, non-transactional operations of a BATCH statement are flushed "
+              "while the batch is executed, each time their requests reach this size, instead of "
+              "all at once at its end. 0 disables it.");
+TAG_FLAG(ycql_batch_flush_bytes, advanced);
+
+DEFINE_uint64(ycql_batch_max_in_flight_flushes, 2,
+              "Maximal number of concurrent flushes of a BATCH statement when "
+              "ycql_batch_flush_bytes is positive. Bounds the bytes in flight of the batch to "
+              "ycql_batch_max_in_flight_flushes * ycql_batch_flush_bytes.");
+TAG_FLAG(ycql_batch_max_in_flight_flushes, advanced);
+
+DEFINE_uint64(ycql_page_size_limit_bytes, 0,
+              "When positive, a page of SELECT results also ends, with a paging state, after its "
+              "rows data reaches this size, even if it has fewer rows than the page size. Tablet "
+              "servers stop reading at this size as well. 0 disables it.");
+TAG_FLAG(ycql_page_size_limit_bytes, advanced);
+
+DEFINE_int32(ycql_parallel_aggregate_scan_max_tablets, 0,
+             "When positive, an aggregate SELECT that scans the whole table reads all its tablets "
+             "in parallel, and merges their partial aggregates, instead of reading them one after "
+             "another. Only tables with at most this number of tablets are read that way. 0 "
+             "disables it.");
+TAG_FLAG(ycql_parallel_aggregate_scan_max_tablets, advanced);
+TAG_FLAG(ycql_parallel_aggregate_scan_max_tablets, runtime);
+
 Executor::Executor(QLEnv* ql_env, AuditLogger* audit_logger, Rescheduler* rescheduler,
                    const QLMetrics* ql_metrics)
     : ql_env_(ql_env),
       audit_logger_(*audit_logger),
       rescheduler_(rescheduler),
+      exec_contexts_(&exec_mem_),
       session_(ql_env_->NewSession()),
       ql_metrics_(ql_metrics) {
 }
@@ -142,6 +171,20 @@ void Executor::ExecuteAsync(const StatementBatch& batch, StatementExecutedCallba
   session_->SetForceConsistentRead(client::ForceConsistentRead::kFalse);
   session_->SetReadPoint(client::Restart::kFalse);
 
+  // Large batches are sent while their statements are executed, so that their ops don't wait for
+  // the whole batch to be built and don't go to the tservers all at once. The session still
+  // groups the ops of each flush by tablet. Apply can block, which is fine here, since batches
+  // are executed in a service thread. Auto flush is turned off before the ops are
+  // processed in flush callbacks.
+  if (FLAGS_ycql_batch_flush_bytes > 0) {
+    client::AutoFlushOptions auto_flush_options;
+    auto_flush_options.max_buffer_bytes = FLAGS_ycql_batch_flush_bytes;
+    auto_flush_options.max_in_flight_batches =
+        std::max<uint64_t>(FLAGS_ycql_batch_max_in_flight_flushes, 1);
+    session_->SetAutoFlush(auto_flush_options);
+    session_auto_flush_ = true;
+  }
+
   // Table for DML batches, where all statements must modify the same table.
   client::YBTablePtr dml_batch_table;
 
@@ -221,7 +264,7 @@ void Executor::ExecuteAsync(const StatementBatch& batch, StatementExecutedCallba
 
 Status Executor::Execute(const ParseTree& parse_tree, const StatementParameters& params) {
   // Prepare execution context and execute the parse tree's root node.
-  exec_contexts_.emplace_back(parse_tree, params);
+  exec_contexts_.emplace_back(parse_tree, params, &exec_mem_);
   exec_context_ = &exec_contexts_.back();
   auto root_node = parse_tree.root().get();
   RETURN_NOT_OK(PreExecTreeNode(root_node));
@@ -1046,6 +1089,37 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
     }
   }
 
+  // An aggregate over the whole table is read from all tablets in parallel, one op per tablet, and
+  // the partial aggregates they return are merged by AggregateResultSets. Each op is bounded to the
+  // hash range of its tablet, so it is done after a single read.
+  const int32_t max_parallel_tablets = FLAGS_ycql_parallel_aggregate_scan_max_tablets;
+  if (max_parallel_tablets > 0 && tnode->is_aggregate() && !tnode->child_select() &&
+      !continue_user_request && !tnode->limit() && !tnode->offset() &&
+      req->hashed_column_values().empty() && !req->has_hash_code() && !req->has_max_hash_code() &&
+      tnode_context->UnreadPartitionsRemaining() == 0) {
+    const auto partitions = table->GetPartitionsShared();
+    const size_t num_tablets = partitions->size();
+    if (num_tablets > 1 && num_tablets <= static_cast<size_t>(max_parallel_tablets)) {
+      for (size_t i = 0; i < num_tablets; ++i) {
+        YBqlReadOpPtr op(i == 0 ? select_op : YBqlReadOpPtr(table->NewQLSelect()));
+        if (i > 0) {
+          op->mutable_request()->CopyFrom(select_op->request());
+          op->set_yb_consistency_level(select_op->yb_consistency_level());
+        }
+        const string& start_key = (*partitions)[i];
+        const uint16_t hash_code =
+            start_key.empty() ? 0 : PartitionSchema::DecodeMultiColumnHashValue(start_key);
+        const uint16_t max_hash_code = i + 1 == num_tablets
+            ? std::numeric_limits<uint16_t>::max()
+            : PartitionSchema::DecodeMultiColumnHashValue((*partitions)[i + 1]) - 1;
+        op->mutable_request()->set_hash_code(hash_code);
+        op->mutable_request()->set_max_hash_code(max_hash_code);
+        RETURN_NOT_OK(AddOperation(op, tnode_context));
+      }
+      return Status::OK();
+    }
+  }
+
   // If this select statement uses an uncovered index underneath, save this op as a template to
   // read from the table once the primary keys are returned from the uncovered index. The paging
   // state should be used by the underlying select from the index only which decides where to
@@ -1057,6 +1131,12 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
     return Status::OK();
   }
 
+  // Bound the size of the page too, when it is continued with a paging state.
+  if (FLAGS_ycql_page_size_limit_bytes > 0 && req->return_paging_state() &&
+      !req->is_aggregate()) {
+    req->set_rows_data_size_limit(FLAGS_ycql_page_size_limit_bytes);
+  }
+
   // Add the operation.
   return AddOperation(select_op, tnode_context);
 }
@@ -1164,9 +1244,14 @@ Result<bool> Executor::FetchMoreRows(const PTSelectStmt* tnode,
   const int64_t total_rows_skipped = query_state->skip_count();
   const int64_t total_row_count = query_state->read_count();
 
-  // If we reached the fetch limit (min of paging_size and limit clause), this batch is done.
+  // If we reached the fetch limit (min of paging_size and limit clause) or the size limit of the
+  // page, this batch is done.
   int64_t fetch_limit = query_state->max_fetch_size();
-  if (fetch_limit >= 0 && current_fetch_row_count >= fetch_limit) {
+  const auto& request = op->request();
+  const bool size_limit_reached =
+      request.rows_data_size_limit() > 0 && current_fetch_row_count > 0 &&
+      tnode_context->rows_result()->rows_data().size() >= request.rows_data_size_limit();
+  if ((fetch_limit >= 0 && current_fetch_row_count >= fetch_limit) || size_limit_reached) {
     // If we need to return a paging state to the user, we create it here so that we can resume from
     // the exact place where we left off: partition index and primary key within that partition.
     if (op->request().return_paging_state()) {
@@ -1229,6 +1314,9 @@ Status Executor::ExecPTNode(const PTInsertStmt *tnode, TnodeContext* tnode_conte
   YBqlWriteOpPtr insert_op(table->NewQLInsert());
   QLWriteRequestPB *req = insert_op->mutable_request();
 
+  // Set the column references and other parts of the request that were computed by the analyzer.
+  req->MergeFrom(tnode->write_request_template());
+
   // Set the ttl.
   Status s = TtlToPB(tnode, req);
   if (PREDICT_FALSE(!s.ok())) {
@@ -1261,12 +1349,6 @@ Status Executor::ExecPTNode(const PTInsertStmt *tnode, TnodeContext* tnode_conte
     }
   }
 
-  // Setup the column values that need to be read.
-  s = ColumnRefsToPB(tnode, req->mutable_column_refs());
-  if (PREDICT_FALSE(!s.ok())) {
-    return exec_context_->Error(tnode, s, ErrorCode::INVALID_ARGUMENTS);
-  }
-
   // Set the IF clause.
   if (tnode->if_clause() != nullptr) {
     s = PTExprToPB(tnode->if_clause(), insert_op->mutable_request()->mutable_if_expr());
@@ -1276,11 +1358,6 @@ Status Executor::ExecPTNode(const PTInsertStmt *tnode, TnodeContext* tnode_conte
     req->set_else_error(tnode->else_error());
   }
 
-  // Set the RETURNS clause if set.
-  if (tnode->returns_status()) {
-    req->set_returns_status(true);
-  }
-
   // Set whether write op writes to the static/primary row.
   insert_op->set_writes_static_row(tnode->ModifiesStaticRow());
   insert_op->set_writes_primary_row(tnode->ModifiesPrimaryRow());
@@ -1672,7 +1749,7 @@ void Executor::FlushAsync(ResetAsyncCalls* reset_async_calls) {
   write_batch_.Clear();
   std::vector<std::pair<YBSessionPtr, ExecContext*>> flush_sessions;
   std::vector<ExecContext*> commit_contexts;
-  if (NeedsFlush(session_)) {
+  if (session_auto_flush_ || NeedsFlush(session_)) {
     flush_sessions.push_back({session_, nullptr});
   }
   for (ExecContext& exec_context : exec_contexts_) {
@@ -1747,6 +1824,11 @@ void Executor::FlushAsync(ResetAsyncCalls* reset_async_calls) {
 // deferred to ProcessAsyncResults() that will be invoked exclusively.
 void Executor::FlushAsyncDone(client::FlushStatus* flush_status, ExecContext* exec_context) {
   TRACE("Flush Async Done");
+  if (exec_context == nullptr && session_auto_flush_) {
+    // Ops that are applied from here on should not block a reactor thread, see ExecuteAsync.
+    session_->SetAutoFlush(client::AutoFlushOptions());
+    session_auto_flush_ = false;
+  }
   // Process FlushAsync status for either transactional session in an ExecContext, or the
   // non-transactional session in the Executor for other ExecContexts with no transactional session.
 
@@ -2609,7 +2691,12 @@ void Executor::StatementExecuted(const Status& s, ResetAsyncCalls* reset_async_c
 void Executor::Reset(ResetAsyncCalls* reset_async_calls) {
   exec_context_ = nullptr;
   exec_contexts_.clear();
+  exec_mem_.Reset();
   write_batch_.Clear();
+  if (session_auto_flush_) {
+    session_->SetAutoFlush(client::AutoFlushOptions());
+    session_auto_flush_ = false;
+  }
   session_->Abort();
   num_flushes_ = 0;
   result_ = nullptr;
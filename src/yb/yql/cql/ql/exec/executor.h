@@ -465,7 +465,10 @@ class Executor : public QLExprExecutor {
   // Execution context of the statement currently being executed, and the contexts for all
   // statements in execution. The contexts are created and destroyed for each execution.
   ExecContext* exec_context_ = nullptr;
-  std::list<ExecContext> exec_contexts_;
+  // Memory of the contexts, released in bulk when the execution is reset. It keeps its buffer, so
+  // repeated executions do not need to allocate it again.
+  Arena exec_mem_;
+  MCList<ExecContext> exec_contexts_;
 
   // Batch of outstanding write operations that are being applied.
   WriteBatch write_batch_;
@@ -497,6 +500,10 @@ class Executor : public QLExprExecutor {
   // Whether this is a batch with statements that returns status.
   boost::optional<bool> returns_status_batch_opt_;
 
+  // Whether session_ flushes the ops of the current batch while it is executed. Then session_ has
+  // to be flushed even if it has no buffered ops, to wait for the auto flushed ones.
+  bool session_auto_flush_ = false;
+
   class ExecutorTask : public rpc::ThreadPoolTask {
    public:
     ExecutorTask& Bind(Executor* executor, ResetAsyncCalls* reset_async_calls);
@@ -73,6 +73,19 @@ CHECKED_STATUS PTInsertStmt::Analyze(SemContext *sem_context) {
   // Analyze indexes for write operations.
   RETURN_NOT_OK(AnalyzeIndexesForWrites(sem_context));
 
+  // Precompute the column references, which are final now, for the executor.
+  write_request_template_.Clear();
+  QLReferencedColumnsPB* column_refs_pb = write_request_template_.mutable_column_refs();
+  for (auto column_ref : column_refs_) {
+    column_refs_pb->add_ids(column_ref);
+  }
+  for (auto column_ref : static_column_refs_) {
+    column_refs_pb->add_static_ids(column_ref);
+  }
+  if (returns_status_) {
+    write_request_template_.set_returns_status(true);
+  }
+
   return Status::OK();
 }
 
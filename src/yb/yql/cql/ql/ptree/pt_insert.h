@@ -18,6 +18,8 @@
 #ifndef YB_YQL_CQL_QL_PTREE_PT_INSERT_H_
 #define YB_YQL_CQL_QL_PTREE_PT_INSERT_H_
 
+#include "yb/common/ql_protocol.pb.h"
+
 #include "yb/yql/cql/ql/ptree/column_desc.h"
 #include "yb/yql/cql/ql/ptree/list_node.h"
 #include "yb/yql/cql/ql/ptree/pt_dml.h"
@@ -80,6 +82,12 @@ class PTInsertStmt : public PTDmlStmt {
     return inserting_value_;
   }
 
+  // Parts of the write request that do not depend on bind values. They are computed once at the
+  // end of the analysis and merged into the request of every execution of the statement.
+  const QLWriteRequestPB& write_request_template() const {
+    return write_request_template_;
+  }
+
  private:
 
   //
@@ -112,6 +120,7 @@ class PTInsertStmt : public PTDmlStmt {
 
   // -- The semantic analyzer will decorate this node with the following information --
 
+  QLWriteRequestPB write_request_template_;
 };
 
 }  // namespace ql
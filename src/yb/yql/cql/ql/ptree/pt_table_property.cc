@@ -15,6 +15,7 @@
 
 #include "yb/client/schema.h"
 #include "yb/client/table.h"
+#include "yb/gutil/strings/util.h"
 
 #include "yb/yql/cql/ql/ptree/pt_table_property.h"
 #include "yb/yql/cql/ql/ptree/sem_context.h"
@@ -488,10 +489,12 @@ Status PTTablePropertyMap::SetTableProperty(yb::TableProperties *table_property)
   }
   switch (iterator->second) {
     case PropertyMapType::kCaching: FALLTHROUGH_INTENDED;
-    case PropertyMapType::kCompaction: FALLTHROUGH_INTENDED;
     case PropertyMapType::kCompression:
       LOG(WARNING) << "Ignoring table property " << table_property_name;
       break;
+    case PropertyMapType::kCompaction:
+      RETURN_NOT_OK(SetCompactionTableProperty(table_property));
+      break;
     case PropertyMapType::kTransactions:
       for (const auto& subproperty : map_elements_->node_list()) {
         string subproperty_name;
@@ -519,6 +522,43 @@ Status PTTablePropertyMap::SetTableProperty(yb::TableProperties *table_property)
   return Status::OK();
 }
 
+Status PTTablePropertyMap::SetCompactionTableProperty(
+    yb::TableProperties *table_property) const {
+  // Only TimeWindowCompactionStrategy changes how SST files are compacted, other strategies use
+  // size tiered compaction. Subproperties were validated by AnalyzeCompaction.
+  bool time_window = false;
+  int64_t window_size = 1;
+  string window_unit = "days";
+  for (const auto& subproperty : map_elements_->node_list()) {
+    string subproperty_name;
+    ToLowerCase(subproperty->lhs()->c_str(), &subproperty_name);
+    if (subproperty_name == "class") {
+      string class_name;
+      RETURN_NOT_OK(GetStringValueFromExpr(subproperty->rhs(), false, subproperty_name,
+                                           &class_name));
+      time_window = HasSuffixString(class_name, Compaction::kTimeWindowClass);
+    } else if (subproperty_name == "compaction_window_size") {
+      RETURN_NOT_OK(GetIntValueFromExpr(subproperty->rhs(), subproperty_name, &window_size));
+    } else if (subproperty_name == "compaction_window_unit") {
+      RETURN_NOT_OK(
+          GetStringValueFromExpr(subproperty->rhs(), true, subproperty_name, &window_unit));
+    }
+  }
+  if (!time_window) {
+    table_property->SetCompactionTimeWindowSeconds(0);
+    return Status::OK();
+  }
+
+  int64_t unit_seconds = 24 * 60 * 60;
+  if (window_unit == "minutes") {
+    unit_seconds = 60;
+  } else if (window_unit == "hours") {
+    unit_seconds = 60 * 60;
+  }
+  table_property->SetCompactionTimeWindowSeconds(window_size * unit_seconds);
+  return Status::OK();
+}
+
 Status PTTablePropertyMap::AnalyzeCompaction() {
   vector<string> invalid_subproperties;
   vector<PTTableProperty::SharedPtr> subproperties;
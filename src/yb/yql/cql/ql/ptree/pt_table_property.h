@@ -217,6 +217,7 @@ class PTTablePropertyMap : public PTTableProperty {
   Status AnalyzeCaching();
   Status AnalyzeCompaction();
   Status AnalyzeCompression();
+  Status SetCompactionTableProperty(yb::TableProperties *table_property) const;
   Status AnalyzeTransactions(SemContext *sem_context);
 
   static const std::map<std::string, PTTablePropertyMap::PropertyMapType> kPropertyDataTypes;
@@ -262,6 +263,7 @@ struct Compaction {
 
   static constexpr auto kClassPrefix = "org.apache.cassandra.db.compaction.";
   static const auto kClassPrefixLen = std::strlen(kClassPrefix);
+  static constexpr auto kTimeWindowClass = "TimeWindowCompactionStrategy";
 
   static const std::map<std::string, std::set<Subproperty>> kClassSubproperties;
 
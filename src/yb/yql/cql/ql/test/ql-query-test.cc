@@ -31,6 +31,8 @@ using std::unique_ptr;
 using std::shared_ptr;
 using strings::Substitute;
 
+DECLARE_uint64(ycql_page_size_limit_bytes);
+
 namespace yb {
 namespace ql {
 
@@ -864,6 +866,42 @@ TEST_F(TestQLQuery, TestPagingState) {
   }
 }
 
+TEST_F(TestQLQuery, TestPagingStateWithSizeLimit) {
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+  TestQLProcessor *processor = GetQLProcessor();
+  CHECK_VALID_STMT("CREATE TABLE t (h int, r int, v text, primary key((h), r));");
+
+  static constexpr int kNumRows = 100;
+  const string value(100, 'x');
+  for (int i = 1; i <= kNumRows; i++) {
+    CHECK_VALID_STMT(Substitute("INSERT INTO t (h, r, v) VALUES (1, $0, '$1');", i, value));
+  }
+
+  // Each page should stop after about 5 rows of data, though the page size is larger.
+  FLAGS_ycql_page_size_limit_bytes = 5 * value.size();
+  StatementParameters params;
+  params.set_page_size(50);
+  int page_count = 0;
+  int i = 0;
+  do {
+    CHECK_OK(processor->Run("SELECT r, v FROM t WHERE h = 1;", params));
+    std::shared_ptr<QLRowBlock> row_block = processor->row_block();
+    ASSERT_GT(row_block->row_count(), 0);
+    ASSERT_LE(row_block->row_count(), 6);
+    for (const auto& row : row_block->rows()) {
+      ASSERT_EQ(row.column(0).int32_value(), ++i);
+      ASSERT_EQ(row.column(1).string_value(), value);
+    }
+    page_count++;
+    if (processor->rows_result()->paging_state().empty()) {
+      break;
+    }
+    CHECK_OK(params.SetPagingState(processor->rows_result()->paging_state()));
+  } while (true);
+  ASSERT_EQ(i, kNumRows);
+  ASSERT_GE(page_count, kNumRows / 6);
+}
+
 #define RUN_PAGINATION_WITH_DESC_TEST(processor, type, values, rows)                               \
 do {                                                                                               \
   /* Creating the table. */                                                                        \
@@ -20,6 +20,7 @@
 #include "yb/util/debug-util.h"
 #include "yb/yql/pggate/pg_dml.h"
 #include "yb/yql/pggate/pg_select_index.h"
+#include "yb/yql/pggate/pggate_flags.h"
 #include "yb/yql/pggate/util/pg_doc_data.h"
 
 namespace yb {
@@ -71,6 +72,11 @@ Status PgDml::AppendTarget(PgExpr *target) {
   return Status::OK();
 }
 
+Status PgDml::AppendColumnRef(PgExpr *colref) {
+  SCHECK(colref->is_colref(), InvalidArgument, "Column reference is expected");
+  return colref->PrepareForRead(this, nullptr /* expr_pb */);
+}
+
 Status PgDml::AppendTargetPB(PgExpr *target) {
   // Append to targets_.
   targets_.push_back(target);
@@ -325,9 +331,34 @@ Result<bool> PgDml::FetchDataFromServer() {
     RETURN_NOT_OK(doc_op_->GetResult(&rowsets_));
   }
 
+  RETURN_NOT_OK(PrefetchNextSecondaryIndexBatch());
   return true;
 }
 
+Status PgDml::PrefetchNextSecondaryIndexBatch() {
+  // Rows of the current batch of ybctids are all received, the next batch is read from the table
+  // while Postgres processes them. The index already prefetches its next page of ybctids, so index
+  // and table reads overlap.
+  if (!FLAGS_ysql_pipeline_index_scan_table_reads || !doc_op_->end_of_data() ||
+      !secondary_index_query_ || !secondary_index_query_->has_doc_op()) {
+    return Status::OK();
+  }
+
+  // With LIMIT, rows of the next batch are likely not needed. With row locks, rows of the next
+  // batch would be locked even if the scan stops before returning them.
+  const auto& exec_params = doc_op_->ExecParameters();
+  if (!exec_params.limit_use_default || exec_params.rowmark >= 0) {
+    return Status::OK();
+  }
+
+  if (!VERIFY_RESULT(ProcessSecondaryIndexRequest(nullptr))) {
+    return Status::OK();
+  }
+  SCHECK_EQ(VERIFY_RESULT(doc_op_->Execute()), RequestSent::kTrue, IllegalState,
+            "YSQL read operation was not sent");
+  return Status::OK();
+}
+
 Result<bool> PgDml::GetNextRow(PgTuple *pg_tuple) {
   for (auto rowset_iter = rowsets_.begin(); rowset_iter != rowsets_.end();) {
     // Check if the rowset has any data.
@@ -347,7 +378,7 @@ Result<bool> PgDml::GetNextRow(PgTuple *pg_tuple) {
     if (rowset.NextRowOrder() <= current_row_order_) {
       // Write row to postgres tuple.
       int64_t row_order = -1;
-      RETURN_NOT_OK(rowset.WritePgTuple(targets_, pg_tuple, &row_order));
+      RETURN_NOT_OK(rowset.WritePgTuple(targets_, grouping_columns_, pg_tuple, &row_order));
       SCHECK(row_order == -1 || row_order == current_row_order_, InternalError,
              "The resulting row are not arranged in indexing order");
 
@@ -375,5 +406,14 @@ bool PgDml::has_aggregate_targets() {
   return num_aggregate_targets > 0;
 }
 
+void PgDml::AddExecStats(PgExecStats *stats) const {
+  if (doc_op_) {
+    doc_op_->AddExecStats(stats);
+  }
+  if (secondary_index_query_) {
+    secondary_index_query_->AddExecStats(stats);
+  }
+}
+
 }  // namespace pggate
 }  // namespace yb
@@ -36,6 +36,10 @@ class PgDml : public PgStatement {
   // Append a target in SELECT or RETURNING.
   CHECKED_STATUS AppendTarget(PgExpr *target);
 
+  // Request to read the referenced column, without returning it. It is used when the column is
+  // referenced only by expressions evaluated by DocDB.
+  CHECKED_STATUS AppendColumnRef(PgExpr *colref);
+
   // Prepare column for both ends.
   // - Prepare protobuf to communicate with DocDB.
   // - Prepare PgExpr to send data back to Postgres layer.
@@ -68,6 +72,10 @@ class PgDml : public PgStatement {
   // Returns TRUE if docdb replies with more data.
   Result<bool> FetchDataFromServer();
 
+  // Sends the read of the next batch of ybctids from the secondary index, when
+  // ysql_pipeline_index_scan_table_reads is set and the current batch is received.
+  CHECKED_STATUS PrefetchNextSecondaryIndexBatch();
+
   // Returns TRUE if desired row is found.
   Result<bool> GetNextRow(PgTuple *pg_tuple);
 
@@ -79,6 +87,9 @@ class PgDml : public PgStatement {
     return doc_op_ != nullptr;
   }
 
+  // Add DocDB execution stats of the requests of this statement and its secondary index query.
+  void AddExecStats(PgExecStats *stats) const;
+
  protected:
   // Method members.
   // Constructor.
@@ -134,6 +145,10 @@ class PgDml : public PgStatement {
   PgTableDesc::ScopedRefPtr target_desc_;
   std::vector<PgExpr*> targets_;
 
+  // Columns that aggregate targets are grouped by. DocDB returns their values after the values of
+  // aggregate targets, one row per group.
+  std::vector<PgExpr*> grouping_columns_;
+
   // bind_desc_ is the descriptor of the table whose key columns' values will be specified by the
   // the DML statement being executed.
   // - For primary key binding, "bind_desc_" is the descriptor of the main table as we don't have
@@ -14,12 +14,16 @@
 //--------------------------------------------------------------------------------------------------
 
 #include "yb/yql/pggate/pg_dml_read.h"
+
+#include <algorithm>
+
 #include "yb/yql/pggate/pg_select_index.h"
 #include "yb/yql/pggate/util/pg_doc_data.h"
 #include "yb/client/yb_op.h"
 #include "yb/client/table.h"
 #include "yb/common/pg_system_attr.h"
 #include "yb/docdb/primitive_value.h"
+#include "yb/yql/pggate/pggate_flags.h"
 
 namespace yb {
 namespace pggate {
@@ -31,6 +35,8 @@ auto Find(const boost::unordered_map<Key, Value>& map, const CompatibleKey& key)
   return map.find(key, boost::hash<CompatibleKey>(), std::equal_to<CompatibleKey>());
 }
 
+using InOperands = google::protobuf::RepeatedPtrField<PgsqlExpressionPB>;
+
 using DocKeyBuilder = std::function<docdb::DocKey(const vector<docdb::PrimitiveValue>&)>;
 
 Result<DocKeyBuilder> CreateDocKeyBuilder(
@@ -223,10 +229,13 @@ Status PgDmlRead::Exec(const PgExecParameters *exec_params) {
     RETURN_NOT_OK(doc_op_->ExecuteInit(exec_params));
   }
 
+  SCHECK(!exec_params || exec_params->num_parallel_workers <= 1 || !secondary_index_query_,
+         NotSupported, "Parallel workers can only divide sequential scans and aggregates");
+
   if (doc_op_ &&
       !secondary_index_query_ &&
       exec_params &&
-      (exec_params->rowmark > -1) &&
+      (exec_params->rowmark > -1 || FLAGS_ysql_batch_primary_key_in_lookups) &&
       CanBuildYbctidsFromPrimaryBinds()) {
     RETURN_NOT_OK(SubstitutePrimaryBindsWithYbctids());
   } else {
@@ -245,6 +254,11 @@ Status PgDmlRead::Exec(const PgExecParameters *exec_params) {
     // request (PgsqlReadRequestPB::index_request).
     doc_op_->AbandonExecution();
 
+  } else if (doc_op_ && exec_params && exec_params->num_parallel_workers > 1 &&
+             exec_params->parallel_worker_index >= target_desc_->GetPartitionCount()) {
+    // There are more parallel workers than partitions, nothing to read for this one.
+    doc_op_->AbandonExecution();
+
   } else {
     // Update bind values for constants and placeholders.
     RETURN_NOT_OK(UpdateBindPBs());
@@ -328,6 +342,48 @@ Status PgDmlRead::BindColumnCondBetween(int attr_num, PgExpr *attr_value, PgExpr
   return Status::OK();
 }
 
+Status PgDmlRead::SetWhereExpr(PgExpr *where_expr) {
+  SCHECK(!read_req_->has_where_expr(), IllegalState, "WHERE expression is already set");
+  SCHECK_EQ(read_req_->distinct_prefix_length(), 0, NotSupported,
+            "WHERE expression cannot be used with a distinct prefix scan");
+  return where_expr->PrepareForRead(this, read_req_->mutable_where_expr());
+}
+
+Status PgDmlRead::AppendGroupingColumn(PgExpr *colref) {
+  SCHECK(colref->is_colref(), InvalidArgument, "Column reference is expected");
+  SCHECK(!secondary_index_query_, NotSupported, "Grouped aggregates cannot be read via index");
+  SCHECK(!targets_.empty() && has_aggregate_targets(), IllegalState,
+         "Grouping column should follow aggregate targets");
+  grouping_columns_.push_back(colref);
+  return colref->PrepareForRead(this, read_req_->add_group_by_exprs());
+}
+
+Status PgDmlRead::SetDistinctPrefixLength(int prefix_length) {
+  if (secondary_index_query_) {
+    return secondary_index_query_->SetDistinctPrefixLength(prefix_length);
+  }
+  SCHECK_GE(prefix_length, 0, InvalidArgument, "Negative distinct prefix length");
+  // Rows skipped after the first row of the prefix could match the filter when it does not.
+  SCHECK(!read_req_->has_where_expr(), NotSupported,
+         "Distinct prefix scan cannot be used with a WHERE expression");
+  read_req_->set_distinct_prefix_length(prefix_length);
+  return Status::OK();
+}
+
+void PgDmlRead::SetCollectExecStats(bool collect) {
+  if (secondary_index_query_) {
+    secondary_index_query_->SetCollectExecStats(collect);
+  }
+  read_req_->set_collect_execution_stats(collect);
+}
+
+void PgDmlRead::SetFillBlockCache(bool fill) {
+  if (secondary_index_query_) {
+    secondary_index_query_->SetFillBlockCache(fill);
+  }
+  read_req_->set_fill_block_cache(fill);
+}
+
 Status PgDmlRead::BindColumnCondIn(int attr_num, int n_attr_values, PgExpr **attr_values) {
   if (secondary_index_query_) {
     // Bind by secondary key.
@@ -412,7 +468,11 @@ Status PgDmlRead::BindColumnCondIn(int attr_num, int n_attr_values, PgExpr **att
 }
 
 Status PgDmlRead::SubstitutePrimaryBindsWithYbctids() {
-  const auto ybctids = VERIFY_RESULT(BuildYbctidsFromPrimaryBinds());
+  auto ybctids = VERIFY_RESULT(BuildYbctidsFromPrimaryBinds());
+  // Rows are returned in the order of ybctids, encoded keys are ordered like rows of the table.
+  // Duplicates in the IN clause should not produce duplicate rows.
+  std::sort(ybctids.begin(), ybctids.end());
+  ybctids.erase(std::unique(ybctids.begin(), ybctids.end()), ybctids.end());
   std::vector<Slice> ybctidsAsSlice;
   for (const auto& ybctid : ybctids) {
     ybctidsAsSlice.emplace_back(ybctid);
@@ -424,77 +484,105 @@ Status PgDmlRead::SubstitutePrimaryBindsWithYbctids() {
   return doc_op_->PopulateDmlByYbctidOps(&ybctidsAsSlice);
 }
 
-// Function builds vector of ybctids from primary key binds.
-// Required precondition that one and only one range key component has IN clause and all
+// Function builds vector of ybctids from primary key binds, one per combination of values of
+// IN clauses.
+// Required precondition that at least one key component has IN clause and all
 // other key components are set must be checked by caller code.
 Result<std::vector<std::string>> PgDmlRead::BuildYbctidsFromPrimaryBinds() {
-  google::protobuf::RepeatedPtrField<PgsqlExpressionPB> hashed_values;
-  vector<docdb::PrimitiveValue> hashed_components, range_components;
-  hashed_components.reserve(bind_desc_->num_hash_key_columns());
-  range_components.reserve(
-      bind_desc_->num_hash_key_columns() - bind_desc_->num_hash_key_columns());
-  for (size_t i = 0; i < bind_desc_->num_hash_key_columns(); ++i) {
-    auto& col = bind_desc_->columns()[i];
-    hashed_components.push_back(VERIFY_RESULT(
-        BuildKeyColumnValue(col, *col.bind_pb(), hashed_values.Add())));
+  const auto& columns = bind_desc_->columns();
+  const auto num_hash_key_columns = bind_desc_->num_hash_key_columns();
+  const auto num_key_columns = bind_desc_->num_key_columns();
+  // For IN clause expr->has_condition() returns 'true'.
+  std::vector<std::pair<size_t, const InOperands*>> in_columns;
+  size_t num_combinations = 1;
+  for (size_t i = 0; i < num_key_columns; ++i) {
+    const auto* expr = columns[i].bind_pb();
+    if (expr->has_condition()) {
+      const auto& in_operands = expr->condition().operands(1).condition().operands();
+      in_columns.emplace_back(i, &in_operands);
+      num_combinations *= in_operands.size();
+    }
+  }
+  if (in_columns.empty()) {
+    return STATUS(IllegalState, "Can't build ybctids, bad preconditions");
   }
 
-  auto dockey_builder = VERIFY_RESULT(CreateDocKeyBuilder(
-      hashed_components, hashed_values, bind_desc_->table()->partition_schema()));
-
-  for (size_t i = bind_desc_->num_hash_key_columns(); i < bind_desc_->num_key_columns(); ++i) {
-    auto& col = bind_desc_->columns()[i];
-    auto& expr = *col.bind_pb();
-    // For IN clause expr->has_condition() returns 'true'.
-    if (expr.has_condition()) {
-      const auto prefix_len = range_components.size();
-      // Form ybctid for each value in IN clause.
-      std::vector <std::string> ybctids;
-      for (const auto& in_exp : expr.condition().operands(1).condition().operands()) {
-        range_components.push_back(VERIFY_RESULT(BuildKeyColumnValue(col, in_exp)));
-        // Range key component has one and only one IN clause,
-        // all remains components has explicit values. Add them as is.
-        for (size_t j = i + 1; j < bind_desc_->num_key_columns(); ++j) {
-          auto& suffix_col = bind_desc_->columns()[j];
-          range_components.push_back(VERIFY_RESULT(
-              BuildKeyColumnValue(suffix_col, *suffix_col.bind_pb())));
-        }
-        const auto doc_key = dockey_builder(range_components);
-        ybctids.push_back(doc_key.Encode().ToStringBuffer());
-        range_components.resize(prefix_len);
+  std::vector<std::string> ybctids;
+  ybctids.reserve(num_combinations);
+  vector<docdb::PrimitiveValue> hashed_components, range_components;
+  hashed_components.reserve(num_hash_key_columns);
+  range_components.reserve(num_key_columns - num_hash_key_columns);
+  std::vector<const PgsqlExpressionPB*> key_exprs(num_key_columns);
+  for (size_t i = 0; i < num_key_columns; ++i) {
+    key_exprs[i] = columns[i].bind_pb();
+  }
+  // Form ybctid for each combination of values in IN clauses, all remaining components have
+  // explicit values.
+  for (size_t combination = 0; combination != num_combinations; ++combination) {
+    auto pos = combination;
+    for (auto it = in_columns.rbegin(); it != in_columns.rend(); ++it) {
+      const auto& in_operands = *it->second;
+      key_exprs[it->first] = &in_operands.Get(pos % in_operands.size());
+      pos /= in_operands.size();
+    }
+    google::protobuf::RepeatedPtrField<PgsqlExpressionPB> hashed_values;
+    hashed_components.clear();
+    range_components.clear();
+    for (size_t i = 0; i < num_key_columns; ++i) {
+      auto& col = columns[i];
+      const auto& expr = *key_exprs[i];
+      if (i < num_hash_key_columns) {
+        hashed_components.push_back(VERIFY_RESULT(
+            BuildKeyColumnValue(col, expr, hashed_values.Add())));
+      } else {
+        range_components.push_back(VERIFY_RESULT(BuildKeyColumnValue(col, expr)));
       }
-      return std::move(ybctids);
-    } else {
-      range_components.push_back(VERIFY_RESULT(BuildKeyColumnValue(col, expr)));
     }
+    auto dockey_builder = VERIFY_RESULT(CreateDocKeyBuilder(
+        hashed_components, hashed_values, bind_desc_->table()->partition_schema()));
+    ybctids.push_back(dockey_builder(range_components).Encode().ToStringBuffer());
   }
-  return STATUS(IllegalState, "Can't build ybctids, bad preconditions");
+  return std::move(ybctids);
 }
 
-// Function checks that one and only one range key component has IN clause
-// and all other key components are set.
+// Function checks that at least one key component has IN clause and all other key
+// components are set. IN clause on a hash key component is supported only when
+// ysql_batch_primary_key_in_lookups is set. IN clauses on multiple key components are supported
+// only when ysql_batch_primary_key_in_lookups is set and the number of combinations of their
+// values does not exceed ysql_max_primary_key_in_lookup_combinations.
 bool PgDmlRead::CanBuildYbctidsFromPrimaryBinds() const {
   if (!bind_desc_) {
     return false;
   }
 
-  size_t range_components_in_clause_count = 0;
+  const int64_t max_combinations = FLAGS_ysql_max_primary_key_in_lookup_combinations;
+  size_t in_clause_count = 0;
+  int64_t num_combinations = 1;
 
   for (size_t i = 0; i < bind_desc_->num_key_columns(); ++i) {
     auto& col = bind_desc_->columns()[i];
     auto* expr = col.bind_pb();
     // For IN clause expr->has_condition() returns 'true'.
     if (expr->has_condition()) {
-      if ((i < bind_desc_->num_hash_key_columns()) || (++range_components_in_clause_count > 1)) {
+      if (i < bind_desc_->num_hash_key_columns() && !FLAGS_ysql_batch_primary_key_in_lookups) {
         // unsupported IN clause
         return false;
       }
+      ++in_clause_count;
+      // Stop counting after the limit, so the product does not overflow.
+      num_combinations = std::min(
+          num_combinations * expr->condition().operands(1).condition().operands_size(),
+          max_combinations + 1);
     } else if (expr_binds_.find(expr) == expr_binds_.end()) {
       // missing key component found
       return false;
     }
   }
-  return range_components_in_clause_count == 1;
+  if (in_clause_count > 1) {
+    return FLAGS_ysql_batch_primary_key_in_lookups &&
+           num_combinations <= max_combinations;
+  }
+  return in_clause_count == 1;
 }
 
 // Moves IN operator bound for range key component into 'condition_expr' field
@@ -67,6 +67,25 @@ class PgDmlRead : public PgDml {
   // Bind a column with an IN condition.
   CHECKED_STATUS BindColumnCondIn(int attnum, int n_attr_values, PgExpr **attr_values);
 
+  // Set the filter that DocDB applies to rows of the table before returning them.
+  // Columns referenced by the filter should be appended with AppendColumnRef or AppendTarget.
+  CHECKED_STATUS SetWhereExpr(PgExpr *where_expr);
+
+  // Group aggregate targets by the given column, so DocDB returns partial aggregates per group.
+  // All aggregate targets should be appended before grouping columns.
+  CHECKED_STATUS AppendGroupingColumn(PgExpr *colref);
+
+  // Scan only the first row for each distinct combination of values of prefix_length leading
+  // key columns, skipping the rest of the rows with DocDB seeks. Used for skip scans, when the
+  // leading columns have few distinct values.
+  CHECKED_STATUS SetDistinctPrefixLength(int prefix_length);
+
+  // Request DocDB execution stats with the rows, see PgDml::AddExecStats.
+  void SetCollectExecStats(bool collect);
+
+  // Whether DocDB adds the blocks read by the scan to the block cache.
+  void SetFillBlockCache(bool fill);
+
   // Execute.
   virtual CHECKED_STATUS Exec(const PgExecParameters *exec_params);
 
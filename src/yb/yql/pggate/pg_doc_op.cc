@@ -48,12 +48,13 @@ using yb::client::YBOperation;
 namespace yb {
 namespace pggate {
 
-PgDocResult::PgDocResult(string&& data) : data_(move(data)) {
+PgDocResult::PgDocResult(string&& data, bool columnar)
+    : data_(move(data)), columnar_(columnar) {
   PgDocData::LoadCache(data_, &row_count_, &row_iterator_);
 }
 
-PgDocResult::PgDocResult(string&& data, std::list<int64_t>&& row_orders)
-    : data_(move(data)), row_orders_(move(row_orders)) {
+PgDocResult::PgDocResult(string&& data, std::list<int64_t>&& row_orders, bool columnar)
+    : data_(move(data)), columnar_(columnar), row_orders_(move(row_orders)) {
   PgDocData::LoadCache(data_, &row_count_, &row_iterator_);
 }
 
@@ -64,9 +65,39 @@ int64_t PgDocResult::NextRowOrder() {
   return row_orders_.size() > 0 ? row_orders_.front() : -1;
 }
 
-Status PgDocResult::WritePgTuple(const std::vector<PgExpr*>& targets, PgTuple *pg_tuple,
+Status PgDocResult::LoadColumnsIfNecessary() {
+  if (!columnar_ || columns_loaded_) {
+    return Status::OK();
+  }
+  RETURN_NOT_OK(PgDocData::LoadColumns(
+      row_iterator_, row_count_, &null_bitmaps_, &column_iterators_));
+  row_iterator_.clear();
+  columns_loaded_ = true;
+  return Status::OK();
+}
+
+Status PgDocResult::WritePgTuple(const std::vector<PgExpr*>& targets,
+                                 const std::vector<PgExpr*>& grouping_columns,
+                                 PgTuple *pg_tuple,
                                  int64_t *row_order) {
+  RETURN_NOT_OK(LoadColumnsIfNecessary());
+  if (columnar_) {
+    SCHECK_EQ(targets.size() + grouping_columns.size(), column_iterators_.size(), InternalError,
+              "Wrong number of columns in columnar rows data");
+  }
   int attr_num = 0;
+  size_t column_idx = 0;
+  auto translate = [this, &column_idx, pg_tuple](const PgExpr *expr, int attr_num) {
+    if (columnar_) {
+      PgWireDataHeader header = PgDocData::ColumnDataHeader(
+          null_bitmaps_[column_idx], current_row_);
+      expr->TranslateData(&column_iterators_[column_idx], header, attr_num - 1, pg_tuple);
+      ++column_idx;
+    } else {
+      PgWireDataHeader header = PgDocData::ReadDataHeader(&row_iterator_);
+      expr->TranslateData(&row_iterator_, header, attr_num - 1, pg_tuple);
+    }
+  };
   for (const PgExpr *target : targets) {
     if (!target->is_colref() && !target->is_aggregate()) {
       return STATUS(InternalError,
@@ -77,10 +108,12 @@ Status PgDocResult::WritePgTuple(const std::vector<PgExpr*>& targets, PgTuple *p
     } else {
       attr_num++;
     }
-
-    PgWireDataHeader header = PgDocData::ReadDataHeader(&row_iterator_);
-    target->TranslateData(&row_iterator_, header, attr_num - 1, pg_tuple);
+    translate(target, attr_num);
+  }
+  for (const PgExpr *grouping_column : grouping_columns) {
+    translate(grouping_column, ++attr_num);
   }
+  ++current_row_;
 
   if (row_orders_.size()) {
     *row_order = row_orders_.front();
@@ -97,22 +130,54 @@ Status PgDocResult::ProcessSystemColumns() {
   }
   syscol_processed_ = true;
 
+  RETURN_NOT_OK(LoadColumnsIfNecessary());
+  if (columnar_) {
+    SCHECK(!column_iterators_.empty(), InternalError, "System column ybctid is missing");
+  }
+  Slice* iterator = columnar_ ? &column_iterators_[0] : &row_iterator_;
   for (int i = 0; i < row_count_; i++) {
-    PgWireDataHeader header = PgDocData::ReadDataHeader(&row_iterator_);
+    PgWireDataHeader header = columnar_ ? PgDocData::ColumnDataHeader(null_bitmaps_[0], i)
+                                        : PgDocData::ReadDataHeader(iterator);
     SCHECK(!header.is_null(), InternalError, "System column ybctid cannot be NULL");
 
     int64_t data_size;
-    size_t read_size = PgDocData::ReadNumber(&row_iterator_, &data_size);
-    row_iterator_.remove_prefix(read_size);
+    size_t read_size = PgDocData::ReadNumber(iterator, &data_size);
+    iterator->remove_prefix(read_size);
 
-    ybctids_.emplace_back(row_iterator_.data(), data_size);
-    row_iterator_.remove_prefix(data_size);
+    ybctids_.emplace_back(iterator->data(), data_size);
+    iterator->remove_prefix(data_size);
   }
+  current_row_ = row_count_;
   return Status::OK();
 }
 
 //--------------------------------------------------------------------------------------------------
 
+void PgSampleReservoir::Add(double key, const Slice& ybctid) {
+  if (rows_.size() < targrows_) {
+    rows_.emplace(key, ybctid.ToBuffer());
+  } else if (key < rows_.top().first) {
+    rows_.pop();
+    rows_.emplace(key, ybctid.ToBuffer());
+  }
+}
+
+double PgSampleReservoir::key_threshold() const {
+  return rows_.size() < targrows_ ? 1.0 : rows_.top().first;
+}
+
+std::vector<std::string> PgSampleReservoir::TakeYbctids() {
+  std::vector<std::string> result;
+  result.reserve(rows_.size());
+  while (!rows_.empty()) {
+    result.push_back(rows_.top().second);
+    rows_.pop();
+  }
+  return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+
 PgDocOp::PgDocOp(const PgSession::ScopedRefPtr& pg_session,
                  const PgTableDesc::ScopedRefPtr& table_desc,
                  const PgObjectId& relation_id)
@@ -170,7 +235,7 @@ Status PgDocOp::GetResult(list<PgDocResult> *rowsets) {
     auto rows = VERIFY_RESULT(ProcessResponse(response_.GetStatus(pg_session_.get())));
     // In case ProcessResponse doesn't fail with an error
     // it should return non empty rows and/or set end_of_data_.
-    DCHECK(!rows.empty() || end_of_data_);
+    DCHECK(!rows.empty() || end_of_data_ || MayReturnEmptyResult());
     rowsets->splice(rowsets->end(), rows);
     // Prefetch next portion of data if needed.
     if (!(end_of_data_ || suppress_next_result_prefetching_)) {
@@ -188,6 +253,19 @@ Result<int32_t> PgDocOp::GetRowsAffectedCount() const {
   return rows_affected_count_;
 }
 
+void PgDocOp::AddExecStats(PgExecStats *stats) const {
+  stats->num_requests += exec_stats_.num_requests;
+  stats->rows_examined += exec_stats_.rows_examined;
+  stats->rows_returned += exec_stats_.rows_returned;
+  stats->rocksdb_seeks += exec_stats_.rocksdb_seeks;
+  stats->rocksdb_nexts += exec_stats_.rocksdb_nexts;
+  stats->rocksdb_prevs += exec_stats_.rocksdb_prevs;
+  stats->block_cache_hits += exec_stats_.block_cache_hits;
+  stats->block_reads += exec_stats_.block_reads;
+  stats->block_read_bytes += exec_stats_.block_read_bytes;
+  stats->execution_time_us += exec_stats_.execution_time_us;
+}
+
 Status PgDocOp::ClonePgsqlOps(int op_count) {
   // Allocate batch operator, one per partition.
   SCHECK(op_count > 0, InternalError, "Table must have at least one partition");
@@ -291,12 +369,31 @@ Result<std::list<PgDocResult>> PgDocOp::ProcessResponseResult() {
     // Get total number of rows that are operated on.
     rows_affected_count_ += pgsql_op->response().rows_affected_count();
 
+    // Ops that were not sent in this round keep their previous response, so stats are cleared
+    // once consumed.
+    if (pgsql_op->response().has_execution_stats()) {
+      const auto& stats = pgsql_op->response().execution_stats();
+      ++exec_stats_.num_requests;
+      exec_stats_.rows_examined += stats.rows_examined();
+      exec_stats_.rows_returned += stats.rows_returned();
+      exec_stats_.rocksdb_seeks += stats.rocksdb_seeks();
+      exec_stats_.rocksdb_nexts += stats.rocksdb_nexts();
+      exec_stats_.rocksdb_prevs += stats.rocksdb_prevs();
+      exec_stats_.block_cache_hits += stats.block_cache_hits();
+      exec_stats_.block_reads += stats.block_reads();
+      exec_stats_.block_read_bytes += stats.block_read_bytes();
+      exec_stats_.execution_time_us += stats.execution_time_us();
+      pgsql_op->mutable_response()->clear_execution_stats();
+    }
+
     // Get contents.
     if (!pgsql_op->rows_data().empty()) {
+      const bool columnar = pgsql_op->response().columnar_rows_data();
       if (no_sorting_order) {
-        result.emplace_back(pgsql_op->rows_data());
+        result.emplace_back(pgsql_op->rows_data(), columnar);
       } else {
-        result.emplace_back(pgsql_op->rows_data(), std::move(batch_row_orders_[op_index]));
+        result.emplace_back(
+            pgsql_op->rows_data(), std::move(batch_row_orders_[op_index]), columnar);
       }
     }
   }
@@ -323,6 +420,12 @@ Status PgDocReadOp::ExecuteInit(const PgExecParameters *exec_params) {
   RETURN_NOT_OK(PgDocOp::ExecuteInit(exec_params));
 
   template_op_->mutable_request()->set_return_paging_state(true);
+  const auto& request = template_op_->request();
+  if (request.has_sampling_state()) {
+    sample_reservoir_ = std::make_unique<PgSampleReservoir>(request.sampling_state().targrows());
+  } else if (FLAGS_ysql_enable_columnar_scan_results && !request.is_aggregate()) {
+    template_op_->mutable_request()->set_columnar_result(true);
+  }
   SetRequestPrefetchLimit();
   SetRowMark();
   SetReadTime();
@@ -330,8 +433,19 @@ Status PgDocReadOp::ExecuteInit(const PgExecParameters *exec_params) {
 }
 
 Result<std::list<PgDocResult>> PgDocReadOp::ProcessResponseImpl() {
+  if (sample_reservoir_) {
+    // Sampled rows are kept in the reservoir until the whole table is scanned.
+    RETURN_NOT_OK(ProcessSampleResponses());
+    RETURN_NOT_OK(ProcessResponsePagingState());
+    return std::list<PgDocResult>();
+  }
+
   // Process result from tablet server and check result status.
   auto result = VERIFY_RESULT(ProcessResponseResult());
+  for (const auto& batch : result) {
+    fetched_rows_ += batch.row_count();
+    fetched_bytes_ += batch.data_size();
+  }
 
   // Process paging state and check status.
   RETURN_NOT_OK(ProcessResponsePagingState());
@@ -350,18 +464,25 @@ Status PgDocReadOp::CreateRequests() {
   // All information from the SQL request has been collected and setup. This code populate
   // Protobuf requests before sending them to DocDB. For performance reasons, requests are
   // constructed differently for different statement.
-  if (template_op_->request().is_aggregate()) {
+  if (template_op_->request().is_aggregate() || template_op_->request().has_sampling_state()) {
     // Optimization for COUNT() operator.
     // - SELECT count(*) FROM sql_table;
     // - Multiple requests are created to run sequential COUNT() in parallel.
+    // Sampling scans use the same per-partition requests, as tablets are sampled independently.
     return PopulateParallelSelectCountOps();
 
   } else if (template_op_->request().partition_column_values_size() > 0) {
     // Optimization for multiple hash keys.
     // - SELECT * FROM sql_table WHERE hash_c1 IN (1, 2, 3) AND hash_c2 IN (4, 5, 6);
     // - Multiple requests for differrent hash permutations / keys.
+    SCHECK_LE(exec_params_.num_parallel_workers, 1, NotSupported,
+              "Parallel workers can only divide sequential scans and aggregates");
     return PopulateNextHashPermutationOps();
 
+  } else if (exec_params_.num_parallel_workers > 1 && exec_params_.partition_key == nullptr) {
+    // Parallel worker scans its share of partitions.
+    return PopulateOpsByPartitions();
+
   } else {
     // No optimization.
     if (exec_params_.partition_key != nullptr) {
@@ -556,9 +677,7 @@ Status PgDocReadOp::InitializeHashPermutationStates() {
 
 Status PgDocReadOp::PopulateParallelSelectCountOps() {
   // Create batch operators, one per partition, to SELECT COUNT() in parallel.
-  // TODO(tsplit): what if table partition is changed during PgDocReadOp lifecycle before or after
-  // the following line?
-  RETURN_NOT_OK(ClonePgsqlOps(table_desc_->GetPartitionCount()));
+  RETURN_NOT_OK(PopulateOpsByPartitions());
   // Set "pararallelism_level_" to control how many operators can be sent at one time.
   //
   // TODO(neil) The calculation for this control variable should be applied to ALL operators, but
@@ -576,15 +695,38 @@ Status PgDocReadOp::PopulateParallelSelectCountOps() {
     parallelism_level_ =
       std::min(std::max(tserver_count * 2, kMinParSelCountParallelism), kMaxParSelCountParallelism);
   }
+  return Status::OK();
+}
+
+std::vector<size_t> PgDocReadOp::PartitionsToScan() const {
+  const auto num_workers = exec_params_.num_parallel_workers;
+  const size_t num_partitions = table_desc_->GetPartitionCount();
+  std::vector<size_t> result;
+  for (size_t partition = 0; partition < num_partitions; ++partition) {
+    if (num_workers <= 1 ||
+        partition % num_workers == static_cast<size_t>(exec_params_.parallel_worker_index)) {
+      result.push_back(partition);
+    }
+  }
+  return result;
+}
+
+Status PgDocReadOp::PopulateOpsByPartitions() {
+  // TODO(tsplit): what if table partition is changed during PgDocReadOp lifecycle before or after
+  // the following line?
+  const auto partitions = PartitionsToScan();
+  SCHECK(!partitions.empty(), IllegalState, "No partitions to scan");
+  RETURN_NOT_OK(ClonePgsqlOps(partitions.size()));
 
   // Assign partitions to operators.
   const auto& partition_keys = table_desc_->GetPartitions();
-  SCHECK_EQ(partition_keys.size(), pgsql_ops_.size(), IllegalState,
-            "Number of partitions and number of partition keys are not the same");
+  SCHECK_GE(pgsql_ops_.size(), partitions.size(), IllegalState,
+            "Number of operators is less than number of partitions to scan");
 
-  for (int partition = 0; partition < partition_keys.size(); partition++) {
+  for (size_t op_index = 0; op_index < partitions.size(); op_index++) {
+    const auto partition = partitions[op_index];
     // Construct a new YBPgsqlReadOp.
-    pgsql_ops_[partition]->set_active(true);
+    pgsql_ops_[op_index]->set_active(true);
 
     // Use partition index to setup the protobuf to identify the partition that this request
     // is for. Batcher will use this information to send the request to correct tablet server, and
@@ -595,13 +737,13 @@ Status PgDocReadOp::PopulateParallelSelectCountOps() {
     if (partition < partition_keys.size() - 1) {
       upper_bound = partition_keys[partition + 1];
     }
-    RETURN_NOT_OK(table_desc_->SetScanBoundary(GetReadOp(partition)->mutable_request(),
+    RETURN_NOT_OK(table_desc_->SetScanBoundary(GetReadOp(op_index)->mutable_request(),
                                                partition_keys[partition],
                                                true /* lower_bound_is_inclusive */,
                                                upper_bound,
                                                false /* upper_bound_is_inclusive */));
   }
-  active_op_count_ = partition_keys.size();
+  active_op_count_ = partitions.size();
   request_population_completed_ = true;
 
   return Status::OK();
@@ -673,6 +815,11 @@ Status PgDocReadOp::ProcessResponsePagingState() {
       // This allows long-running queries to continue in the presence of other DDL statements
       // as long as they do not affect the table(s) being queried.
       req->clear_ysql_catalog_version();
+
+      const auto adaptive_limit = AdaptivePrefetchLimit(*req);
+      if (adaptive_limit > 0) {
+        req->set_limit(adaptive_limit);
+      }
     }
 
     // Check for batch execution.
@@ -707,6 +854,36 @@ Status PgDocReadOp::ProcessResponsePagingState() {
   return Status::OK();
 }
 
+Status PgDocReadOp::ProcessSampleResponses() {
+  for (int op_index = 0; op_index < active_op_count_; op_index++) {
+    YBPgsqlReadOp *read_op = GetReadOp(op_index);
+    RETURN_NOT_OK(pg_session_->HandleResponse(*read_op, PgObjectId()));
+
+    // Responses are cleared once consumed, ops that were not sent in this round have none.
+    auto& res = *read_op->mutable_response();
+    sample_reservoir_->AddScannedRows(res.sample_scanned_rows());
+    res.clear_sample_scanned_rows();
+    if (res.sample_keys_size() > 0) {
+      PgDocResult rows(read_op->rows_data());
+      RETURN_NOT_OK(rows.ProcessSystemColumns());
+      const auto& ybctids = rows.ybctids();
+      SCHECK_EQ(ybctids.size(), static_cast<size_t>(res.sample_keys_size()), InternalError,
+                "Each sampled row should have a key");
+      for (size_t i = 0; i < ybctids.size(); ++i) {
+        sample_reservoir_->Add(res.sample_keys(i), ybctids[i]);
+      }
+      res.clear_sample_keys();
+    }
+  }
+
+  const double key_threshold = sample_reservoir_->key_threshold();
+  for (auto& op : pgsql_ops_) {
+    auto* read_req = static_cast<YBPgsqlReadOp*>(op.get())->mutable_request();
+    read_req->mutable_sampling_state()->set_key_threshold(key_threshold);
+  }
+  return Status::OK();
+}
+
 void PgDocReadOp::SetRequestPrefetchLimit() {
   // Predict the maximum prefetch-limit using the associated gflags.
   PgsqlReadRequestPB *req = template_op_->mutable_request();
@@ -730,6 +907,28 @@ void PgDocReadOp::SetRequestPrefetchLimit() {
     suppress_next_result_prefetching_ = false;
   }
   req->set_limit(limit_count);
+
+  // Aggregates return a single row per tablet, so only the row limit applies to them.
+  if (FLAGS_ysql_prefetch_size_limit_bytes > 0 && !req->is_aggregate()) {
+    req->set_size_limit(FLAGS_ysql_prefetch_size_limit_bytes);
+  }
+}
+
+int64_t PgDocReadOp::AdaptivePrefetchLimit(const PgsqlReadRequestPB& req) const {
+  // The statement LIMIT is already smaller than the prefetch limit, keep it.
+  if (!req.has_size_limit() || suppress_next_result_prefetching_ || fetched_rows_ == 0) {
+    return 0;
+  }
+  const uint64_t row_width = std::max<uint64_t>(fetched_bytes_ / fetched_rows_, 1);
+  double limit = static_cast<double>(req.size_limit() / row_width);
+  if (!req.is_forward_scan()) {
+    limit *= FLAGS_ysql_backward_prefetch_scale_factor;
+  }
+  limit = std::min<double>(limit, FLAGS_ysql_max_adaptive_prefetch_limit);
+  if (!exec_params_.limit_use_default) {
+    limit = std::min<double>(limit, exec_params_.limit_count + exec_params_.limit_offset);
+  }
+  return std::max<int64_t>(static_cast<int64_t>(limit), 1);
 }
 
 void PgDocReadOp::SetRowMark() {
@@ -749,6 +948,12 @@ void PgDocReadOp::SetReadTime() {
     // TODO(jason): don't assume that read_time being set means it's always for backfill
     // (issue #6854).
     template_op_->SetIsForBackfill(true);
+  } else if (exec_params_.read_from_followers && exec_params_.follower_read_staleness_ms > 0) {
+    // Read all tablets at the same time in the past, so that any replica whose safe time has
+    // reached it could serve the read, and the result is a consistent snapshot of the table.
+    const auto now = pg_session_->clock()->Now();
+    template_op_->SetReadTime(ReadHybridTime::SingleTime(HybridTime::FromMicros(
+        now.GetPhysicalValueMicros() - exec_params_.follower_read_staleness_ms * 1000LL)));
   }
 }
 
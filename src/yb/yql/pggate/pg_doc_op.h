@@ -16,6 +16,7 @@
 #define YB_YQL_PGGATE_PG_DOC_OP_H_
 
 #include <deque>
+#include <queue>
 
 #include <boost/optional.hpp>
 
@@ -32,8 +33,8 @@ YB_STRONGLY_TYPED_BOOL(RequestSent);
 // PgDocResult represents a batch of rows in ONE reply from tablet servers.
 class PgDocResult {
  public:
-  explicit PgDocResult(string&& data);
-  PgDocResult(string&& data, std::list<int64_t>&& row_orders);
+  explicit PgDocResult(string&& data, bool columnar = false);
+  PgDocResult(string&& data, std::list<int64_t>&& row_orders, bool columnar = false);
   ~PgDocResult();
 
   PgDocResult(const PgDocResult&) = delete;
@@ -44,11 +45,17 @@ class PgDocResult {
 
   // End of this batch.
   bool is_eof() const {
+    if (columnar_) {
+      return current_row_ >= row_count_;
+    }
     return row_count_ == 0 || row_iterator_.empty();
   }
 
   // Get the postgres tuple from this batch.
-  CHECKED_STATUS WritePgTuple(const std::vector<PgExpr*>& targets, PgTuple *pg_tuple,
+  // Values of grouping_columns follow targets, and are written to the following attributes.
+  CHECKED_STATUS WritePgTuple(const std::vector<PgExpr*>& targets,
+                              const std::vector<PgExpr*>& grouping_columns,
+                              PgTuple *pg_tuple,
                               int64_t *row_order);
 
   // Get system columns' values from this batch.
@@ -67,13 +74,29 @@ class PgDocResult {
     return row_count_;
   }
 
+  // Size of the rows data in this batch.
+  size_t data_size() const {
+    return data_.size();
+  }
+
  private:
+  // Locates columns in "data_" when it is in columnar layout. See PgDocColumnarWriter.
+  CHECKED_STATUS LoadColumnsIfNecessary();
+
   // Data selected from DocDB.
   string data_;
 
   // Iterator on "data_" from row to row.
   Slice row_iterator_;
 
+  // Whether "data_" is in columnar layout. In this case values of column i are read from
+  // column_iterators_[i] and their NULL-ness from null_bitmaps_[i].
+  const bool columnar_;
+  bool columns_loaded_ = false;
+  std::vector<Slice> null_bitmaps_;
+  std::vector<Slice> column_iterators_;
+  int64_t current_row_ = 0;
+
   // The row number of only this batch.
   int64_t row_count_ = 0;
 
@@ -88,6 +111,38 @@ class PgDocResult {
   bool syscol_processed_ = false;
 };
 
+//--------------------------------------------------------------------------------------------------
+// PgSampleReservoir keeps the ybctids of the rows with the lowest sampling keys returned by the
+// tablets of a sampling scan. See PgsqlSamplingStatePB.
+class PgSampleReservoir {
+ public:
+  explicit PgSampleReservoir(int targrows) : targrows_(std::max(targrows, 1)) {}
+
+  // Add a row returned by DocDB. It replaces the row with the highest key when the reservoir
+  // is full and the key is lower.
+  void Add(double key, const Slice& ybctid);
+
+  void AddScannedRows(uint64_t scanned_rows) {
+    scanned_rows_ += scanned_rows;
+  }
+
+  // Highest key a row could have to be added to the reservoir.
+  double key_threshold() const;
+
+  // Number of rows scanned by the tablets to pick the sample.
+  uint64_t scanned_rows() const {
+    return scanned_rows_;
+  }
+
+  // Take the ybctids of the sample rows, leaving the reservoir empty.
+  std::vector<std::string> TakeYbctids();
+
+ private:
+  const size_t targrows_;
+  std::priority_queue<std::pair<double, std::string>> rows_;
+  uint64_t scanned_rows_ = 0;
+};
+
 //--------------------------------------------------------------------------------------------------
 // Doc operation API
 // Classes
@@ -226,8 +281,17 @@ class PgDocOp : public std::enable_shared_from_this<PgDocOp> {
 
   // Get the result of the op. No rows will be added to rowsets in case end of data reached.
   CHECKED_STATUS GetResult(std::list<PgDocResult> *rowsets);
+
+  // Whether all requested data has been received.
+  bool end_of_data() const {
+    return end_of_data_;
+  }
   Result<int32_t> GetRowsAffectedCount() const;
 
+  // Add DocDB execution stats of the responses received so far to *stats. Stats are returned only
+  // by read requests that have collect_execution_stats set.
+  void AddExecStats(PgExecStats *stats) const;
+
   // This operation is requested internally within PgGate, and that request does not go through
   // all the steps as other operation from Postgres thru PgDocOp. This is used to create requests
   // for the following select.
@@ -266,6 +330,12 @@ class PgDocOp : public std::enable_shared_from_this<PgDocOp> {
   // Process the result set in server response.
   Result<std::list<PgDocResult>> ProcessResponseResult();
 
+  // Whether a response could have no rows before the end of data. Callers of GetResult() then
+  // check end_of_data() instead of stopping at the first empty result.
+  virtual bool MayReturnEmptyResult() const {
+    return false;
+  }
+
   void SetReadTime();
 
  private:
@@ -323,6 +393,9 @@ class PgDocOp : public std::enable_shared_from_this<PgDocOp> {
   // Executed row count.
   int32_t rows_affected_count_ = 0;
 
+  // Sum of execution stats of the responses, see AddExecStats.
+  PgExecStats exec_stats_ = {};
+
   // Whether all requested data by the statement has been received or there's a run-time error.
   bool end_of_data_ = false;
 
@@ -385,6 +458,11 @@ class PgDocReadOp : public PgDocOp {
 
   CHECKED_STATUS ExecuteInit(const PgExecParameters *exec_params) override;
 
+  // Rows picked by a sampling scan, null for other scans.
+  PgSampleReservoir* sample_reservoir() {
+    return sample_reservoir_.get();
+  }
+
  private:
   // Create protobuf requests using template_op_.
   CHECKED_STATUS CreateRequests() override;
@@ -412,6 +490,13 @@ class PgDocReadOp : public PgDocOp {
   //     Create parallel request for SELECT COUNT().
   CHECKED_STATUS PopulateParallelSelectCountOps();
 
+  // Create operators, one per partition scanned by this parallel worker, or per partition when
+  // parallel workers are not used.
+  CHECKED_STATUS PopulateOpsByPartitions();
+
+  // Returns indexes of partitions scanned by this parallel worker, or all partitions.
+  std::vector<size_t> PartitionsToScan() const;
+
   // Set partition boundaries to a given partition.
   CHECKED_STATUS SetScanPartitionBoundary();
 
@@ -421,12 +506,25 @@ class PgDocReadOp : public PgDocOp {
   // Process response paging state from DocDB.
   CHECKED_STATUS ProcessResponsePagingState();
 
+  // Add rows returned by a sampling scan to the reservoir, and lower the key threshold of the
+  // next requests accordingly.
+  CHECKED_STATUS ProcessSampleResponses();
+
+  // Pages of a sampling scan could have no rows with low enough keys.
+  bool MayReturnEmptyResult() const override {
+    return sample_reservoir_ != nullptr;
+  }
+
   // Reset pgsql operators before reusing them with new arguments / inputs from Postgres.
   CHECKED_STATUS ResetInactivePgsqlOps();
 
   // Analyze options and pick the appropriate prefetch limit.
   void SetRequestPrefetchLimit();
 
+  // Returns the row limit of the next page, so it fits into ysql_prefetch_size_limit_bytes with
+  // the average row width observed so far. Returns 0 when the limit should not be changed.
+  int64_t AdaptivePrefetchLimit(const PgsqlReadRequestPB& req) const;
+
   // Set the row_mark_type field of our read request based on our exec control parameter.
   void SetRowMark();
 
@@ -471,6 +569,13 @@ class PgDocReadOp : public PgDocOp {
   // For a query clause "h1 = 1 AND h2 IN (2,3) AND h3 IN (4,5,6) AND h4 = 7",
   // this will be initialized to [[1], [2, 3], [4, 5, 6], [7]]
   std::vector<std::vector<const PgsqlExpressionPB*>> partition_exprs_;
+
+  // Rows and bytes of rows data received so far, used to estimate the row width.
+  uint64_t fetched_rows_ = 0;
+  uint64_t fetched_bytes_ = 0;
+
+  // Rows picked so far by a sampling scan.
+  std::unique_ptr<PgSampleReservoir> sample_reservoir_;
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -57,7 +57,8 @@ const std::unordered_map<string, PgExpr::Opcode> kOperatorNames = {
   { "count", PgExpr::Opcode::PG_EXPR_COUNT },
   { "max", PgExpr::Opcode::PG_EXPR_MAX },
   { "min", PgExpr::Opcode::PG_EXPR_MIN },
-  { "eval_expr_call", PgExpr::Opcode::PG_EXPR_EVAL_EXPR_CALL }
+  { "eval_expr_call", PgExpr::Opcode::PG_EXPR_EVAL_EXPR_CALL },
+  { "eval_bool_expr_call", PgExpr::Opcode::PG_EXPR_EVAL_BOOL_EXPR_CALL }
 };
 
 PgExpr::PgExpr(Opcode opcode, const YBCPgTypeEntity *type_entity, const PgTypeAttrs *type_attrs)
@@ -100,6 +101,9 @@ bfpg::TSOpcode PgExpr::PGOpcodeToTSOpcode(const PgExpr::Opcode opcode) {
     case Opcode::PG_EXPR_EVAL_EXPR_CALL:
       return bfpg::TSOpcode::kPgEvalExprCall;
 
+    case Opcode::PG_EXPR_EVAL_BOOL_EXPR_CALL:
+      return bfpg::TSOpcode::kPgEvalBoolExprCall;
+
     default:
       LOG(DFATAL) << "No supported TSOpcode for PG opcode: " << static_cast<int32_t>(opcode);
       return bfpg::TSOpcode::kNoOp;
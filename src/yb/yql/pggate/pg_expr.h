@@ -50,6 +50,9 @@ class PgExpr {
     // Serialized YSQL/PG Expr node.
     PG_EXPR_EVAL_EXPR_CALL,
 
+    // Serialized YSQL/PG boolean Expr node, used as a filter of scanned rows.
+    PG_EXPR_EVAL_BOOL_EXPR_CALL,
+
     PG_EXPR_GENERATE_ROWID,
   };
 
@@ -0,0 +1,100 @@
+//--------------------------------------------------------------------------------------------------
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//--------------------------------------------------------------------------------------------------
+
+#include "yb/yql/pggate/pg_sample.h"
+
+#include "yb/client/yb_op.h"
+
+namespace yb {
+namespace pggate {
+
+using std::make_shared;
+
+//--------------------------------------------------------------------------------------------------
+// PgSample
+//--------------------------------------------------------------------------------------------------
+
+PgSample::PgSample(PgSession::ScopedRefPtr pg_session, const PgObjectId& table_id, int targrows)
+    : PgDmlRead(pg_session, table_id, PgObjectId(), nullptr /* prepare_params */),
+      targrows_(targrows) {}
+
+PgSample::~PgSample() {
+}
+
+Status PgSample::Prepare() {
+  SCHECK_GT(targrows_, 0, InvalidArgument, "Sample size must be positive");
+
+  // Prepare target and bind descriptors.
+  target_desc_ = bind_desc_ = VERIFY_RESULT(pg_session_->LoadTable(table_id_));
+
+  // Allocate the READ request used to fetch the sampled rows.
+  auto read_op = target_desc_->NewPgsqlSelect();
+  read_req_ = read_op->mutable_request();
+  doc_op_ = make_shared<PgDocReadOp>(pg_session_, target_desc_, std::move(read_op));
+  PrepareBinds();
+
+  // Allocate the scan that selects the sample. It only returns ybctids of the candidate rows.
+  auto sample_op = target_desc_->NewPgsqlSelect();
+  auto* sample_req = sample_op->mutable_request();
+  sample_req->add_targets()->set_column_id(to_underlying(PgSystemAttrNum::kYBTupleId));
+  sample_req->mutable_sampling_state()->set_targrows(targrows_);
+  sample_op_ = make_shared<PgDocReadOp>(pg_session_, target_desc_, std::move(sample_op));
+  return Status::OK();
+}
+
+Status PgSample::Exec(const PgExecParameters *exec_params) {
+  SCHECK(!executed_, IllegalState, "Sample has already been executed");
+  executed_ = true;
+
+  // Scan the whole table. Candidate rows are accumulated in the reservoir of "sample_op_".
+  RETURN_NOT_OK(sample_op_->ExecuteInit(exec_params));
+  RETURN_NOT_OK(sample_op_->Execute());
+  std::list<PgDocResult> rowsets;
+  while (!sample_op_->end_of_data()) {
+    RETURN_NOT_OK(sample_op_->GetResult(&rowsets));
+    rowsets.clear();
+  }
+  auto* reservoir = sample_op_->sample_reservoir();
+  SCHECK(reservoir, IllegalState, "Sample reservoir was not allocated");
+  scanned_rows_ = reservoir->scanned_rows();
+  const auto sample_ybctids = reservoir->TakeYbctids();
+  sample_op_.reset();
+
+  // Read the sampled rows.
+  SetColumnRefs();
+  RETURN_NOT_OK(doc_op_->ExecuteInit(exec_params));
+  if (sample_ybctids.empty()) {
+    doc_op_->AbandonExecution();
+    return Status::OK();
+  }
+
+  std::vector<Slice> ybctids;
+  ybctids.reserve(sample_ybctids.size());
+  for (const auto& ybctid : sample_ybctids) {
+    ybctids.emplace_back(ybctid);
+  }
+  RETURN_NOT_OK(doc_op_->PopulateDmlByYbctidOps(&ybctids));
+  SCHECK_EQ(VERIFY_RESULT(doc_op_->Execute()), RequestSent::kTrue, IllegalState,
+            "YSQL read operation was not sent");
+  return Status::OK();
+}
+
+Result<double> PgSample::GetEstimatedRowCount() const {
+  SCHECK(executed_, IllegalState, "Sample has not been executed");
+  return static_cast<double>(scanned_rows_);
+}
+
+}  // namespace pggate
+}  // namespace yb
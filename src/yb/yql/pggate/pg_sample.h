@@ -0,0 +1,67 @@
+//--------------------------------------------------------------------------------------------------
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//--------------------------------------------------------------------------------------------------
+
+#ifndef YB_YQL_PGGATE_PG_SAMPLE_H_
+#define YB_YQL_PGGATE_PG_SAMPLE_H_
+
+#include <string>
+#include <vector>
+
+#include "yb/yql/pggate/pg_dml_read.h"
+
+namespace yb {
+namespace pggate {
+
+//--------------------------------------------------------------------------------------------------
+// SAMPLE collects a uniform random sample of table rows for ANALYZE.
+//
+// The sample is taken in two passes:
+// - A scan of all tablets in which DocDB assigns a random key to every row and returns the ybctids
+//   of rows that may still be among the "targrows" lowest keys of the whole table.
+// - A read of the selected rows by ybctid, which is then fetched like any other SELECT.
+//--------------------------------------------------------------------------------------------------
+
+class PgSample : public PgDmlRead {
+ public:
+  PgSample(PgSession::ScopedRefPtr pg_session, const PgObjectId& table_id, int targrows);
+  virtual ~PgSample();
+
+  StmtOp stmt_op() const override { return StmtOp::STMT_SAMPLE; }
+
+  // Prepare query before execution.
+  CHECKED_STATUS Prepare();
+
+  // Select the sample and start reading the sampled rows.
+  CHECKED_STATUS Exec(const PgExecParameters *exec_params) override;
+
+  // Number of live rows seen while sampling. Only valid after Exec().
+  Result<double> GetEstimatedRowCount() const;
+
+ private:
+  // Number of rows to sample.
+  const int targrows_;
+
+  // Operator scanning the table to select the sample.
+  std::shared_ptr<PgDocReadOp> sample_op_;
+
+  // Number of rows scanned by "sample_op_".
+  uint64_t scanned_rows_ = 0;
+
+  bool executed_ = false;
+};
+
+}  // namespace pggate
+}  // namespace yb
+
+#endif // YB_YQL_PGGATE_PG_SAMPLE_H_
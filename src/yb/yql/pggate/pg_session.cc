@@ -42,6 +42,7 @@
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/primitive_value.h"
 
+#include "yb/tserver/tserver_service.proxy.h"
 #include "yb/tserver/tserver_shared_mem.h"
 
 #include "yb/util/flag_tags.h"
@@ -55,6 +56,7 @@ DEFINE_int32(ysql_wait_until_index_permissions_timeout_ms, 60 * 60 * 1000, // 60
              "DEPRECATED: use backfill_index_client_rpc_timeout_ms instead.");
 TAG_FLAG(ysql_wait_until_index_permissions_timeout_ms, advanced);
 DECLARE_int32(TEST_user_ddl_operation_timeout_sec);
+DECLARE_bool(use_node_hostname_for_local_tserver);
 
 namespace yb {
 namespace pggate {
@@ -360,12 +362,14 @@ Status PgSession::RunHelper::Apply(std::shared_ptr<client::YBPgsqlOp> op,
       !force_non_bufferable &&
       op->type() == YBOperation::Type::PGSQL_WRITE) {
     const auto& wop = *down_cast<client::YBPgsqlWriteOp*>(op.get());
-    // Check for buffered operation related to same row.
+    // Check for buffered or in-flight operation related to same row.
     // If multiple operations are performed in context of single RPC second operation will not
     // see the results of first operation on DocDB side.
-    // Multiple operations on same row must be performed in context of different RPC.
+    // Multiple operations on same row must be performed in context of different RPC, and
+    // the second RPC should not be sent before the first one completes.
     // Flush is required in this case.
-    if (PREDICT_FALSE(!buffered_keys.insert(RowIdentifier(wop)).second)) {
+    const auto inserted = buffered_keys.insert(RowIdentifier(wop));
+    if (PREDICT_FALSE(!inserted.second || pg_session_.IsRowWriteInFlight(*inserted.first))) {
       RETURN_NOT_OK(pg_session_.FlushBufferedOperations());
       buffered_keys.insert(RowIdentifier(wop));
     }
@@ -376,8 +380,11 @@ Status PgSession::RunHelper::Apply(std::shared_ptr<client::YBPgsqlOp> op,
     // Flush buffers in case limit of operations in single RPC exceeded.
     return PREDICT_TRUE(buffered_keys.size() < FLAGS_ysql_session_max_batch_size)
         ? Status::OK()
-        : pg_session_.FlushBufferedOperations();
+        : pg_session_.FlushBufferedOperationsPipelined(
+              std::max(FLAGS_ysql_max_in_flight_write_batches, 1) - 1);
   }
+  // Non-bufferable operation should see the results of previously flushed writes.
+  RETURN_NOT_OK(pg_session_.WaitForInFlightWriteBatches());
   bool read_only = op->read_only();
   // Flush all buffered operations (if any) before performing non-bufferable operation
   if (!buffered_keys.empty()) {
@@ -801,6 +808,56 @@ Status PgSession::ReadSequenceTuple(int64_t db_oid,
   return Status::OK();
 }
 
+Status PgSession::TakeNodeCachedSequenceValues(int64_t db_oid,
+                                               int64_t seq_oid,
+                                               uint64_t ysql_catalog_version,
+                                               int64_t increment,
+                                               int64_t max_count,
+                                               int64_t *first_value,
+                                               int64_t *count) {
+  tserver::TakeYsqlSequenceValuesRequestPB req;
+  tserver::TakeYsqlSequenceValuesResponsePB resp;
+  req.set_db_oid(db_oid);
+  req.set_seq_oid(seq_oid);
+  req.set_ysql_catalog_version(ysql_catalog_version);
+  req.set_increment(increment);
+  req.set_max_count(max_count);
+  rpc::RpcController controller;
+  controller.set_timeout(client_->default_rpc_timeout());
+  RETURN_NOT_OK(VERIFY_RESULT(TabletServerProxy())->TakeYsqlSequenceValues(
+      req, &resp, &controller));
+  if (resp.has_error()) {
+    return StatusFromPB(resp.error().status());
+  }
+  *first_value = resp.first_value();
+  *count = resp.count();
+  return Status::OK();
+}
+
+Status PgSession::PutNodeCachedSequenceValues(int64_t db_oid,
+                                              int64_t seq_oid,
+                                              uint64_t ysql_catalog_version,
+                                              int64_t increment,
+                                              int64_t first_value,
+                                              int64_t count) {
+  tserver::PutYsqlSequenceValuesRequestPB req;
+  tserver::PutYsqlSequenceValuesResponsePB resp;
+  req.set_db_oid(db_oid);
+  req.set_seq_oid(seq_oid);
+  req.set_ysql_catalog_version(ysql_catalog_version);
+  req.set_increment(increment);
+  req.set_first_value(first_value);
+  req.set_count(count);
+  rpc::RpcController controller;
+  controller.set_timeout(client_->default_rpc_timeout());
+  RETURN_NOT_OK(VERIFY_RESULT(TabletServerProxy())->PutYsqlSequenceValues(
+      req, &resp, &controller));
+  if (resp.has_error()) {
+    return StatusFromPB(resp.error().status());
+  }
+  return Status::OK();
+}
+
 Status PgSession::DeleteSequenceTuple(int64_t db_oid, int64_t seq_oid) {
   pggate::PgObjectId oid(kPgSequencesDataDatabaseOid, kPgSequencesDataTableOid);
   PgTableDesc::ScopedRefPtr t = VERIFY_RESULT(LoadTable(oid));
@@ -898,32 +955,79 @@ Result<master::AnalyzeTableResponsePB> PgSession::AnalyzeTable(const PgObjectId&
 Result<PgTableDesc::ScopedRefPtr> PgSession::LoadTable(const PgObjectId& table_id) {
   VLOG(3) << "Loading table descriptor for " << table_id;
   const TableId yb_table_id = table_id.GetYBTableId();
-  shared_ptr<YBTable> table;
+  PgTableDesc::ScopedRefPtr prototype;
 
   auto cached_yb_table = table_cache_.find(yb_table_id);
   if (cached_yb_table == table_cache_.end()) {
     VLOG(4) << "Table cache MISS: " << table_id;
-    Status s = client_->OpenTable(yb_table_id, &table);
+    shared_ptr<YBTable> table;
+    Status s = OpenTable(yb_table_id, &table);
     if (!s.ok()) {
       VLOG(3) << "LoadTable: Server returns an error: " << s;
       // TODO: NotFound might not always be the right status here.
       return STATUS_FORMAT(NotFound, "Error loading table with oid $0 in database with oid $1: $2",
                            table_id.object_oid, table_id.database_oid, s.ToUserMessage());
     }
-    table_cache_[yb_table_id] = table;
+    DCHECK_EQ(table->table_type(), YBTableType::PGSQL_TABLE_TYPE);
+    prototype = make_scoped_refptr<PgTableDesc>(table);
+    table_cache_[yb_table_id] = prototype;
   } else {
     VLOG(4) << "Table cache HIT: " << table_id;
-    table = cached_yb_table->second;
+    prototype = cached_yb_table->second;
   }
 
-  DCHECK_EQ(table->table_type(), YBTableType::PGSQL_TABLE_TYPE);
-
-  return make_scoped_refptr<PgTableDesc>(table);
+  // The prototype is never handed out, as statements keep their bind state in its columns.
+  return make_scoped_refptr<PgTableDesc>(*prototype);
 }
 
 void PgSession::InvalidateTableCache(const PgObjectId& table_id) {
   const TableId yb_table_id = table_id.GetYBTableId();
   table_cache_.erase(yb_table_id);
+  // The schema was found stale, so the node level cache might hold the same stale copy.
+  if (FLAGS_ysql_use_node_table_schema_cache) {
+    stale_node_cached_tables_.insert(yb_table_id);
+  }
+}
+
+Status PgSession::OpenTable(const TableId& table_id, std::shared_ptr<client::YBTable>* table) {
+  if (!FLAGS_ysql_use_node_table_schema_cache || !tserver_shared_object_) {
+    return client_->OpenTable(table_id, table);
+  }
+
+  tserver::GetYsqlTableSchemaRequestPB req;
+  tserver::GetYsqlTableSchemaResponsePB resp;
+  req.set_table_id(table_id);
+  req.set_ysql_catalog_version((**tserver_shared_object_).ysql_catalog_version());
+  req.set_force_refresh(stale_node_cached_tables_.erase(table_id) > 0);
+  rpc::RpcController controller;
+  controller.set_timeout(client_->default_admin_operation_timeout());
+  RETURN_NOT_OK(VERIFY_RESULT(TabletServerProxy())->GetYsqlTableSchema(req, &resp, &controller));
+  if (resp.has_error()) {
+    return StatusFromPB(resp.error().status());
+  }
+
+  master::GetTableSchemaResponsePB schema_resp;
+  if (!schema_resp.ParseFromString(resp.table_schema())) {
+    return STATUS_FORMAT(Corruption, "Failed to parse schema of table $0", table_id);
+  }
+  return client_->OpenTable(schema_resp, table);
+}
+
+Result<tserver::TabletServerServiceProxy*> PgSession::TabletServerProxy() {
+  if (!tablet_server_proxy_) {
+    SCHECK(tserver_shared_object_, IllegalState, "Local tablet server is not known");
+    const auto& tserver_shared_data = **tserver_shared_object_;
+    HostPort host_port(tserver_shared_data.endpoint());
+    boost::optional<MonoDelta> resolve_cache_timeout;
+    if (FLAGS_use_node_hostname_for_local_tserver) {
+      host_port = HostPort(tserver_shared_data.host().ToBuffer(),
+                           tserver_shared_data.endpoint().port());
+      resolve_cache_timeout = MonoDelta::kMax;
+    }
+    tablet_server_proxy_ = std::make_unique<tserver::TabletServerServiceProxy>(
+        &client_->proxy_cache(), host_port, nullptr /* protocol */, resolve_cache_timeout);
+  }
+  return tablet_server_proxy_.get();
 }
 
 Status PgSession::StartOperationsBuffering() {
@@ -940,6 +1044,11 @@ Status PgSession::StartOperationsBuffering() {
 Status PgSession::StopOperationsBuffering() {
   SCHECK(buffering_enabled_, IllegalState, "Buffering hasn't been started");
   buffering_enabled_ = false;
+  if (FLAGS_ysql_pipeline_writes_across_statements) {
+    // The statement completes while its last batch is in flight. Its result is handled by the
+    // next operation that depends on it, at the latest by the flush before commit.
+    return FlushBufferedOperationsPipelined(std::max(FLAGS_ysql_max_in_flight_write_batches, 1));
+  }
   return FlushBufferedOperations();
 }
 
@@ -952,8 +1061,50 @@ Status PgSession::ResetOperationsBuffering() {
 }
 
 Status PgSession::FlushBufferedOperations() {
-  return FlushBufferedOperationsImpl(
+  auto status = FlushBufferedOperationsImpl(
       [this](auto ops, auto txn) { return this->FlushOperations(std::move(ops), txn); });
+  auto in_flight_status = WaitForInFlightWriteBatches();
+  return status.ok() ? in_flight_status : status;
+}
+
+Status PgSession::FlushBufferedOperationsPipelined(size_t max_in_flight) {
+  InFlightWriteBatch batch;
+  batch.keys.swap(buffered_keys_);
+  auto status = FlushBufferedOperationsImpl(
+      [this, &batch](auto ops, auto txn) -> Status {
+        auto future = VERIFY_RESULT(StartFlushOperations(ops, txn));
+        batch.flushes.emplace_back(std::move(ops), std::move(future));
+        return Status::OK();
+      });
+  if (!batch.flushes.empty()) {
+    in_flight_write_batches_.push_back(std::move(batch));
+  }
+  RETURN_NOT_OK(status);
+  return WaitForInFlightWriteBatches(max_in_flight);
+}
+
+Status PgSession::WaitForInFlightWriteBatches(size_t max_remaining) {
+  Status status;
+  while (in_flight_write_batches_.size() > max_remaining) {
+    auto batch = std::move(in_flight_write_batches_.front());
+    in_flight_write_batches_.pop_front();
+    for (auto& flush : batch.flushes) {
+      auto flush_status = HandleFlushResult(flush.first, flush.second.get());
+      if (status.ok()) {
+        status = std::move(flush_status);
+      }
+    }
+  }
+  return status;
+}
+
+bool PgSession::IsRowWriteInFlight(const RowIdentifier& row) const {
+  for (const auto& batch : in_flight_write_batches_) {
+    if (batch.keys.count(row)) {
+      return true;
+    }
+  }
+  return false;
 }
 
 void PgSession::DropBufferedOperations() {
@@ -962,6 +1113,9 @@ void PgSession::DropBufferedOperations() {
   buffered_keys_.clear();
   buffered_ops_.clear();
   buffered_txn_ops_.clear();
+  // Operations that were already sent could not be dropped, but the session should not be reused
+  // while they are in flight.
+  WARN_NOT_OK(WaitForInFlightWriteBatches(), "Dropped in-flight write operations failed");
 }
 
 Status PgSession::FlushBufferedOperationsImpl(const Flusher& flusher) {
@@ -1062,6 +1216,12 @@ Status PgSession::ApplyOperation(client::YBSession *session,
 }
 
 Status PgSession::FlushOperations(PgsqlOpBuffer ops, IsTransactionalSession transactional) {
+  auto future = VERIFY_RESULT(StartFlushOperations(ops, transactional));
+  return HandleFlushResult(ops, future.get());
+}
+
+Result<std::future<client::FlushStatus>> PgSession::StartFlushOperations(
+    const PgsqlOpBuffer& ops, IsTransactionalSession transactional) {
   DCHECK(ops.size() > 0 && ops.size() <= FLAGS_ysql_session_max_batch_size);
   auto session = VERIFY_RESULT(GetSession(transactional, IsReadOnlyOperation::kFalse));
   if (session != session_.get()) {
@@ -1076,7 +1236,10 @@ Status PgSession::FlushOperations(PgsqlOpBuffer ops, IsTransactionalSession tran
   for (const auto& buffered_op : ops) {
     RETURN_NOT_OK(ApplyOperation(session, transactional, buffered_op));
   }
-  const auto flush_status = session->FlushFuture().get();
+  return session->FlushFuture();
+}
+
+Status PgSession::HandleFlushResult(const PgsqlOpBuffer& ops, client::FlushStatus flush_status) {
   RETURN_NOT_OK(CombineErrorsToStatus(flush_status.errors, flush_status.status));
   for (const auto& buffered_op : ops) {
     RETURN_NOT_OK(HandleResponse(*buffered_op.operation, buffered_op.relation_id));
@@ -1112,41 +1275,37 @@ Result<bool> PgSession::ForeignKeyReferenceExists(PgOid table_id,
   if (!Erase(&fk_reference_intent_, table_id, ybctid)) {
     return false;
   }
+  const size_t max_batch_size = FLAGS_ysql_max_fk_check_batch_size > 0
+      ? FLAGS_ysql_max_fk_check_batch_size : FLAGS_ysql_session_max_batch_size;
+  // Intents of the table are taken out of the set in the same pass that collects them, so
+  // checking all intents costs a pass over the set per batch, not two.
+  // The reader splits the keys per tablet, and reads all tablets of the batch at once.
+  std::vector<std::string> intent_ybctids;
+  intent_ybctids.reserve(std::min(max_batch_size, fk_reference_intent_.size() + 1) - 1);
+  for (auto it = fk_reference_intent_.begin();
+       it != fk_reference_intent_.end() && intent_ybctids.size() + 1 < max_batch_size;) {
+    if (it->table_id == table_id) {
+      intent_ybctids.push_back(it->ybctid);
+      it = fk_reference_intent_.erase(it);
+    } else {
+      ++it;
+    }
+  }
   std::vector<Slice> ybctids;
-  const auto reserved_size = std::min(FLAGS_ysql_session_max_batch_size,
-                                      static_cast<int32_t>(fk_reference_intent_.size() + 1));
-  ybctids.reserve(reserved_size);
+  ybctids.reserve(intent_ybctids.size() + 1);
   ybctids.push_back(ybctid);
-  // TODO(dmitry): In case number of keys for same table > FLAGS_ysql_session_max_batch_size
-  // two strategy are possible:
-  // 1. select keys belonging to same tablet to reduce number of simultaneous RPC
-  // 2. select keys belonging to different tablets to distribute reads among different nodes
-  const auto intent_match = [table_id](const auto& it) { return it->table_id == table_id; };
-  for (auto it = fk_reference_intent_.begin();
-       it != fk_reference_intent_.end() && ybctids.size() < FLAGS_ysql_session_max_batch_size;
-       ++it) {
-    if (intent_match(it)) {
-      ybctids.push_back(it->ybctid);
+  ybctids.insert(ybctids.end(), intent_ybctids.begin(), intent_ybctids.end());
+  auto existing_ybctids = reader(table_id, ybctids);
+  if (!existing_ybctids.ok()) {
+    // Keep the intents, so the keys are read again when checked after the failure.
+    for (auto& intent_ybctid : intent_ybctids) {
+      fk_reference_intent_.emplace(table_id, std::move(intent_ybctid));
     }
+    return existing_ybctids.status();
   }
-  for (auto& r : VERIFY_RESULT(reader(table_id, ybctids))) {
+  for (auto& r : *existing_ybctids) {
     fk_reference_cache_.emplace(table_id, std::move(r));
   }
-  // Remove used intents.
-  auto intent_count_for_remove = ybctids.size() - 1;
-  if (intent_count_for_remove == fk_reference_intent_.size()) {
-    fk_reference_intent_.clear();
-  } else {
-    for (auto it = fk_reference_intent_.begin();
-        it != fk_reference_intent_.end() && intent_count_for_remove > 0;) {
-      if (intent_match(it)) {
-        it = fk_reference_intent_.erase(it);
-        --intent_count_for_remove;
-      } else {
-        ++it;
-      }
-    }
-  }
   return Find(fk_reference_cache_, table_id, ybctid) != fk_reference_cache_.end();
 }
 
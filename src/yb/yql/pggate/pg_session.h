@@ -14,6 +14,7 @@
 #ifndef YB_YQL_PGGATE_PG_SESSION_H_
 #define YB_YQL_PGGATE_PG_SESSION_H_
 
+#include <deque>
 #include <unordered_set>
 
 #include <boost/optional.hpp>
@@ -39,6 +40,13 @@
 #include "yb/yql/pggate/pg_tabledesc.h"
 
 namespace yb {
+
+namespace tserver {
+
+class TabletServerServiceProxy;
+
+} // namespace tserver
+
 namespace pggate {
 
 YB_STRONGLY_TYPED_BOOL(OpBuffered);
@@ -183,6 +191,22 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
 
   CHECKED_STATUS DeleteDBSequences(int64_t db_oid);
 
+  // Node level cache of sequence values, kept by the local tablet server for all backends.
+  CHECKED_STATUS TakeNodeCachedSequenceValues(int64_t db_oid,
+                                              int64_t seq_oid,
+                                              uint64_t ysql_catalog_version,
+                                              int64_t increment,
+                                              int64_t max_count,
+                                              int64_t *first_value,
+                                              int64_t *count);
+
+  CHECKED_STATUS PutNodeCachedSequenceValues(int64_t db_oid,
+                                             int64_t seq_oid,
+                                             uint64_t ysql_catalog_version,
+                                             int64_t increment,
+                                             int64_t first_value,
+                                             int64_t count);
+
   //------------------------------------------------------------------------------------------------
   // Operations on Tablegroup.
   //------------------------------------------------------------------------------------------------
@@ -218,7 +242,8 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   // Start operation buffering. Buffering must not be in progress.
   CHECKED_STATUS StartOperationsBuffering();
   // Flush all pending buffered operation and stop further buffering.
-  // Buffering must be in progress.
+  // Buffering must be in progress. With ysql_pipeline_writes_across_statements, the flushed
+  // operations could still be in flight when it returns.
   CHECKED_STATUS StopOperationsBuffering();
   // Stop further buffering. Buffering may be in any state,
   // but pending buffered operations are not allowed.
@@ -299,6 +324,10 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
     connected_database_ = "";
   }
 
+  const scoped_refptr<server::HybridClock>& clock() const {
+    return clock_;
+  }
+
   // Generate a new random and unique rowid. It is a v4 UUID.
   string GenerateNewRowid() {
     return rowid_generator_.Next(true /* binary_id */);
@@ -346,8 +375,27 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
  private:
   using Flusher = std::function<Status(PgsqlOpBuffer, IsTransactionalSession)>;
 
+  // Opens the table, loading its schema from the node level cache of the local tablet server
+  // when ysql_use_node_table_schema_cache is set.
+  CHECKED_STATUS OpenTable(const TableId& table_id, std::shared_ptr<client::YBTable>* table);
+
+  // Proxy to the local tablet server, created on first use.
+  Result<tserver::TabletServerServiceProxy*> TabletServerProxy();
+
   CHECKED_STATUS FlushBufferedOperationsImpl(const Flusher& flusher);
   CHECKED_STATUS FlushOperations(PgsqlOpBuffer ops, IsTransactionalSession transactional);
+  // Applies operations to the session and starts flushing them.
+  Result<std::future<client::FlushStatus>> StartFlushOperations(
+      const PgsqlOpBuffer& ops, IsTransactionalSession transactional);
+  CHECKED_STATUS HandleFlushResult(const PgsqlOpBuffer& ops, client::FlushStatus flush_status);
+
+  // Flushes buffered operations without waiting for them, then waits until at most max_in_flight
+  // write batches are in flight.
+  CHECKED_STATUS FlushBufferedOperationsPipelined(size_t max_in_flight);
+  // Waits until at most max_remaining write batches are in flight, oldest first, and handles
+  // their results.
+  CHECKED_STATUS WaitForInFlightWriteBatches(size_t max_remaining = 0);
+  bool IsRowWriteInFlight(const RowIdentifier& row) const;
   CHECKED_STATUS ApplyOperation(client::YBSession* session,
                                 bool transactional,
                                 const BufferableOperation& bop);
@@ -420,7 +468,13 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   // Rowid generator.
   ObjectIdGenerator rowid_generator_;
 
-  std::unordered_map<TableId, std::shared_ptr<client::YBTable>> table_cache_;
+  // Table descriptors are created once per table and then copied for every statement, so that
+  // statements do not rebuild column descriptors from the table schema.
+  std::unordered_map<TableId, PgTableDesc::ScopedRefPtr> table_cache_;
+  // Tables whose schema should be refreshed in the node level cache on the next load.
+  std::unordered_set<TableId> stale_node_cached_tables_;
+  // Proxy to the local tablet server, used for the node level caches.
+  std::unique_ptr<tserver::TabletServerServiceProxy> tablet_server_proxy_;
   boost::unordered_set<PgForeignKeyReference> fk_reference_cache_;
   boost::unordered_set<PgForeignKeyReference> fk_reference_intent_;
 
@@ -430,6 +484,14 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   PgsqlOpBuffer buffered_txn_ops_;
   std::unordered_set<RowIdentifier, boost::hash<RowIdentifier>> buffered_keys_;
 
+  // Buffered operations flushed by FlushBufferedOperationsPipelined, that are not completed yet.
+  struct InFlightWriteBatch {
+    // Keys of the operations being written, they reference the operations.
+    std::unordered_set<RowIdentifier, boost::hash<RowIdentifier>> keys;
+    std::vector<std::pair<PgsqlOpBuffer, std::future<client::FlushStatus>>> flushes;
+  };
+  std::deque<InFlightWriteBatch> in_flight_write_batches_;
+
   const tserver::TServerSharedObject* const tserver_shared_object_;
   const YBCPgCallbacks& pg_callbacks_;
 
@@ -16,6 +16,8 @@
 #include "yb/yql/pggate/pg_statement.h"
 #include "yb/client/yb_op.h"
 
+#include "yb/yql/pggate/pggate_flags.h"
+
 namespace yb {
 namespace pggate {
 
@@ -43,7 +45,18 @@ PgStatement::~PgStatement() {
 }
 
 void PgStatement::AddExpr(PgExpr::SharedPtr expr) {
-  exprs_.push_back(expr);
+  exprs_.push_back(std::move(expr));
+}
+
+Arena* PgStatement::expr_arena() {
+  if (!arena_) {
+    if (!FLAGS_ysql_use_statement_arena) {
+      return nullptr;
+    }
+    // Most statements have a few expressions, so start with a small block.
+    arena_ = std::make_unique<Arena>(1024 /* initial_buffer_size */);
+  }
+  return arena_.get();
 }
 
 }  // namespace pggate
@@ -22,6 +22,8 @@
 
 #include "yb/gutil/ref_counted.h"
 
+#include "yb/util/memory/arena.h"
+
 #include "yb/yql/pggate/pg_session.h"
 #include "yb/yql/pggate/pg_env.h"
 #include "yb/yql/pggate/pg_expr.h"
@@ -55,6 +57,7 @@ enum class StmtOp {
   STMT_CREATE_TABLEGROUP,
   STMT_DROP_TABLEGROUP,
   STMT_ANALYZE,
+  STMT_SAMPLE,
 };
 
 class PgStatement : public PgMemctx::Registrable {
@@ -82,7 +85,23 @@ class PgStatement : public PgMemctx::Registrable {
   // Add expressions that are belong to this statement.
   void AddExpr(PgExpr::SharedPtr expr);
 
+  // Creates an expression that belongs to this statement. When ysql_use_statement_arena is set, the
+  // expression is allocated in the statement arena, so expressions of a statement are released
+  // together with it instead of one by one.
+  template <class Expr, class... Args>
+  Expr* NewExpr(Args&&... args) {
+    auto* arena = expr_arena();
+    auto expr = arena ? arena->AllocateShared<Expr>(std::forward<Args>(args)...)
+                      : std::make_shared<Expr>(std::forward<Args>(args)...);
+    auto* result = expr.get();
+    AddExpr(std::move(expr));
+    return result;
+  }
+
  protected:
+  // Returns the statement arena, or nullptr when expressions are allocated on the heap.
+  Arena* expr_arena();
+
   // YBSession that this statement belongs to.
   PgSession::ScopedRefPtr pg_session_;
 
@@ -90,6 +109,10 @@ class PgStatement : public PgMemctx::Registrable {
   Status status_;
   string errmsg_;
 
+  // Arena of statement expressions, created on first use. Declared before exprs_ so that
+  // expressions are destroyed before their memory is released.
+  std::unique_ptr<Arena> arena_;
+
   // Expression list to be destroyed as soon as the statement is removed from the API.
   std::list<PgExpr::SharedPtr> exprs_;
 };
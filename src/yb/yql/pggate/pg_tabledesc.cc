@@ -30,6 +30,7 @@ PgTableDesc::PgTableDesc(std::shared_ptr<client::YBTable> pg_table)
   const auto& schema = pg_table->schema();
   const int num_columns = schema.num_columns();
   columns_.resize(num_columns);
+  auto attr_num_map = std::make_shared<std::unordered_map<int, size_t>>();
   for (size_t idx = 0; idx < num_columns; idx++) {
     // Find the column descriptor.
     const auto& col = schema.Column(idx);
@@ -45,13 +46,23 @@ PgTableDesc::PgTableDesc(std::shared_ptr<client::YBTable> pg_table)
                col.type(),
                client::YBColumnSchema::ToInternalDataType(col.type()),
                col.sorting_type());
-    attr_num_map_[col.order()] = idx;
+    (*attr_num_map)[col.order()] = idx;
   }
+  attr_num_map_ = std::move(attr_num_map);
 
   // Create virtual columns.
   column_ybctid_.Init(PgSystemAttrNum::kYBTupleId);
 }
 
+PgTableDesc::PgTableDesc(const PgTableDesc& prototype)
+    : table_(prototype.table_),
+      // Partitions may change after the prototype was created, e.g. by tablet splitting.
+      table_partitions_(table_->GetVersionedPartitions()),
+      columns_(prototype.columns_),
+      attr_num_map_(prototype.attr_num_map_),
+      column_ybctid_(prototype.column_ybctid_) {
+}
+
 Result<PgColumn *> PgTableDesc::FindColumn(int attr_num) {
   // Find virtual columns.
   if (attr_num == static_cast<int>(PgSystemAttrNum::kYBTupleId)) {
@@ -59,8 +70,8 @@ Result<PgColumn *> PgTableDesc::FindColumn(int attr_num) {
   }
 
   // Find physical column.
-  const auto itr = attr_num_map_.find(attr_num);
-  if (itr != attr_num_map_.end()) {
+  const auto itr = attr_num_map_->find(attr_num);
+  if (itr != attr_num_map_->end()) {
     return &columns_[itr->second];
   }
 
@@ -68,8 +79,8 @@ Result<PgColumn *> PgTableDesc::FindColumn(int attr_num) {
 }
 
 Status PgTableDesc::GetColumnInfo(int16_t attr_number, bool *is_primary, bool *is_hash) const {
-  const auto itr = attr_num_map_.find(attr_number);
-  if (itr != attr_num_map_.end()) {
+  const auto itr = attr_num_map_->find(attr_number);
+  if (itr != attr_num_map_->end()) {
     const ColumnDesc* desc = columns_[itr->second].desc();
     *is_primary = desc->is_primary();
     *is_hash = desc->is_partition();
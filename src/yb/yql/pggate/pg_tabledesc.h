@@ -39,6 +39,10 @@ class PgTableDesc : public RefCountedThreadSafe<PgTableDesc> {
 
   explicit PgTableDesc(std::shared_ptr<client::YBTable> pg_table);
 
+  // Create a descriptor for a new statement from a descriptor that was never used by a statement.
+  // Column descriptors and the attr number map are not rebuilt from the table schema.
+  PgTableDesc(const PgTableDesc& prototype);
+
   const client::YBTableName& table_name() const;
 
   const std::shared_ptr<client::YBTable> table() const {
@@ -95,7 +99,8 @@ class PgTableDesc : public RefCountedThreadSafe<PgTableDesc> {
   const std::shared_ptr<const client::VersionedTablePartitionList> table_partitions_;
 
   std::vector<PgColumn> columns_;
-  std::unordered_map<int, size_t> attr_num_map_; // Attr number to column index map.
+  // Attr number to column index map, shared by descriptors created from the same prototype.
+  std::shared_ptr<const std::unordered_map<int, size_t>> attr_num_map_;
 
   // Hidden columns.
   PgColumn column_ybctid_;
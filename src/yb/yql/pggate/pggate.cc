@@ -31,6 +31,7 @@
 #include "yb/yql/pggate/pg_delete.h"
 #include "yb/yql/pggate/pg_truncate_colocated.h"
 #include "yb/yql/pggate/pg_select.h"
+#include "yb/yql/pggate/pg_sample.h"
 #include "yb/yql/pggate/pg_txn_manager.h"
 #include "yb/yql/pggate/ybc_pggate.h"
 
@@ -372,6 +373,27 @@ Status PgApiImpl::DeleteSequenceTuple(int64_t db_oid, int64_t seq_oid) {
   return pg_session_->DeleteSequenceTuple(db_oid, seq_oid);
 }
 
+Status PgApiImpl::TakeNodeCachedSequenceValues(int64_t db_oid,
+                                               int64_t seq_oid,
+                                               uint64_t ysql_catalog_version,
+                                               int64_t increment,
+                                               int64_t max_count,
+                                               int64_t *first_value,
+                                               int64_t *count) {
+  return pg_session_->TakeNodeCachedSequenceValues(
+      db_oid, seq_oid, ysql_catalog_version, increment, max_count, first_value, count);
+}
+
+Status PgApiImpl::PutNodeCachedSequenceValues(int64_t db_oid,
+                                              int64_t seq_oid,
+                                              uint64_t ysql_catalog_version,
+                                              int64_t increment,
+                                              int64_t first_value,
+                                              int64_t count) {
+  return pg_session_->PutNodeCachedSequenceValues(
+      db_oid, seq_oid, ysql_catalog_version, increment, first_value, count);
+}
+
 
 //--------------------------------------------------------------------------------------------------
 
@@ -836,6 +858,37 @@ Status PgApiImpl::DmlAppendTarget(PgStatement *handle, PgExpr *target) {
   return down_cast<PgDml*>(handle)->AppendTarget(target);
 }
 
+Status PgApiImpl::DmlAppendColumnRef(PgStatement *handle, PgExpr *colref) {
+  return down_cast<PgDml*>(handle)->AppendColumnRef(colref);
+}
+
+Status PgApiImpl::DmlSetWhereExpr(PgStatement *handle, PgExpr *where_expr) {
+  return down_cast<PgDmlRead*>(handle)->SetWhereExpr(where_expr);
+}
+
+Status PgApiImpl::DmlAppendGroupingColumn(PgStatement *handle, PgExpr *colref) {
+  return down_cast<PgDmlRead*>(handle)->AppendGroupingColumn(colref);
+}
+
+Status PgApiImpl::DmlSetDistinctPrefixLength(PgStatement *handle, int prefix_length) {
+  return down_cast<PgDmlRead*>(handle)->SetDistinctPrefixLength(prefix_length);
+}
+
+Status PgApiImpl::DmlSetCollectExecStats(PgStatement *handle, bool collect) {
+  down_cast<PgDmlRead*>(handle)->SetCollectExecStats(collect);
+  return Status::OK();
+}
+
+Status PgApiImpl::DmlSetFillBlockCache(PgStatement *handle, bool fill) {
+  down_cast<PgDmlRead*>(handle)->SetFillBlockCache(fill);
+  return Status::OK();
+}
+
+Status PgApiImpl::DmlAddExecStats(PgStatement *handle, PgExecStats *stats) {
+  down_cast<PgDml*>(handle)->AddExecStats(stats);
+  return Status::OK();
+}
+
 Status PgApiImpl::DmlBindColumn(PgStatement *handle, int attr_num, PgExpr *attr_value) {
   return down_cast<PgDml*>(handle)->BindColumn(attr_num, attr_value);
 }
@@ -1083,6 +1136,33 @@ Status PgApiImpl::ExecAnalyze(PgStatement *handle, int32_t* rows) {
   return Status::OK();
 }
 
+Status PgApiImpl::NewSample(const PgObjectId& table_id,
+                            int targrows,
+                            PgStatement **handle) {
+  *handle = nullptr;
+  auto sample = std::make_unique<PgSample>(pg_session_, table_id, targrows);
+  RETURN_NOT_OK(sample->Prepare());
+  RETURN_NOT_OK(AddToCurrentPgMemctx(std::move(sample), handle));
+  return Status::OK();
+}
+
+Status PgApiImpl::ExecSample(PgStatement *handle) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SAMPLE)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgSample*>(handle)->Exec(nullptr /* exec_params */);
+}
+
+Status PgApiImpl::GetEstimatedRowCount(PgStatement *handle, double *liverows) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SAMPLE)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  *liverows = VERIFY_RESULT(down_cast<PgSample*>(handle)->GetEstimatedRowCount());
+  return Status::OK();
+}
+
 Status PgApiImpl::DeleteStmtSetIsPersistNeeded(PgStatement *handle, const bool is_persist_needed) {
   if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_DELETE)) {
     // Invalid handle.
@@ -1170,10 +1250,7 @@ Status PgApiImpl::NewColumnRef(PgStatement *stmt, int attr_num, const PgTypeEnti
     // Invalid handle.
     return STATUS(InvalidArgument, "Invalid statement handle");
   }
-  PgColumnRef::SharedPtr colref = make_shared<PgColumnRef>(attr_num, type_entity, type_attrs);
-  stmt->AddExpr(colref);
-
-  *expr_handle = colref.get();
+  *expr_handle = stmt->NewExpr<PgColumnRef>(attr_num, type_entity, type_attrs);
   return Status::OK();
 }
 
@@ -1184,10 +1261,7 @@ Status PgApiImpl::NewConstant(YBCPgStatement stmt, const YBCPgTypeEntity *type_e
     // Invalid handle.
     return STATUS(InvalidArgument, "Invalid statement handle");
   }
-  PgExpr::SharedPtr pg_const = make_shared<PgConstant>(type_entity, datum, is_null);
-  stmt->AddExpr(pg_const);
-
-  *expr_handle = pg_const.get();
+  *expr_handle = stmt->NewExpr<PgConstant>(type_entity, datum, is_null);
   return Status::OK();
 }
 
@@ -1197,10 +1271,7 @@ Status PgApiImpl::NewConstantVirtual(YBCPgStatement stmt, const YBCPgTypeEntity
     // Invalid handle.
     return STATUS(InvalidArgument, "Invalid statement handle");
   }
-  PgExpr::SharedPtr pg_const = make_shared<PgConstant>(type_entity, datum_kind);
-  stmt->AddExpr(pg_const);
-
-  *expr_handle = pg_const.get();
+  *expr_handle = stmt->NewExpr<PgConstant>(type_entity, datum_kind);
   return Status::OK();
 }
 
@@ -1210,11 +1281,8 @@ Status PgApiImpl::NewConstantOp(YBCPgStatement stmt, const YBCPgTypeEntity *type
     // Invalid handle.
     return STATUS(InvalidArgument, "Invalid statement handle");
   }
-  PgExpr::SharedPtr pg_const = make_shared<PgConstant>(type_entity, datum, is_null,
+  *expr_handle = stmt->NewExpr<PgConstant>(type_entity, datum, is_null,
       is_gt ? PgExpr::Opcode::PG_EXPR_GT : PgExpr::Opcode::PG_EXPR_LT);
-  stmt->AddExpr(pg_const);
-
-  *expr_handle = pg_const.get();
   return Status::OK();
 }
 
@@ -1250,10 +1318,7 @@ Status PgApiImpl::NewOperator(PgStatement *stmt, const char *opname,
   RETURN_NOT_OK(PgExpr::CheckOperatorName(opname));
 
   // Create operator.
-  PgExpr::SharedPtr pg_op = make_shared<PgOperator>(opname, type_entity);
-  stmt->AddExpr(pg_op);
-
-  *op_handle = pg_op.get();
+  *op_handle = stmt->NewExpr<PgOperator>(opname, type_entity);
   return Status::OK();
 }
 
@@ -139,6 +139,21 @@ class PgApiImpl {
 
   CHECKED_STATUS DeleteSequenceTuple(int64_t db_oid, int64_t seq_oid);
 
+  CHECKED_STATUS TakeNodeCachedSequenceValues(int64_t db_oid,
+                                              int64_t seq_oid,
+                                              uint64_t ysql_catalog_version,
+                                              int64_t increment,
+                                              int64_t max_count,
+                                              int64_t *first_value,
+                                              int64_t *count);
+
+  CHECKED_STATUS PutNodeCachedSequenceValues(int64_t db_oid,
+                                             int64_t seq_oid,
+                                             uint64_t ysql_catalog_version,
+                                             int64_t increment,
+                                             int64_t first_value,
+                                             int64_t count);
+
   void DeleteStatement(PgStatement *handle);
 
   // Search for type_entity.
@@ -307,6 +322,25 @@ class PgApiImpl {
   // All DML statements
   CHECKED_STATUS DmlAppendTarget(PgStatement *handle, PgExpr *expr);
 
+  // Read the referenced column without returning it.
+  CHECKED_STATUS DmlAppendColumnRef(PgStatement *handle, PgExpr *colref);
+
+  // Filter rows in DocDB by the given boolean expression.
+  CHECKED_STATUS DmlSetWhereExpr(PgStatement *handle, PgExpr *where_expr);
+
+  // Group aggregate targets by the given column in DocDB.
+  CHECKED_STATUS DmlAppendGroupingColumn(PgStatement *handle, PgExpr *colref);
+
+  // Scan only the first row of each distinct prefix of leading key columns.
+  CHECKED_STATUS DmlSetDistinctPrefixLength(PgStatement *handle, int prefix_length);
+
+  // Request DocDB execution stats, and add the stats received so far to *stats.
+  CHECKED_STATUS DmlSetCollectExecStats(PgStatement *handle, bool collect);
+  CHECKED_STATUS DmlAddExecStats(PgStatement *handle, PgExecStats *stats);
+
+  // Do not add the blocks read by a large scan to the DocDB block cache.
+  CHECKED_STATUS DmlSetFillBlockCache(PgStatement *handle, bool fill);
+
   // Binding Columns: Bind column with a value (expression) in a statement.
   // + This API is used to identify the rows you want to operate on. If binding columns are not
   //   there, that means you want to operate on all rows (full scan). You can view this as a
@@ -427,6 +461,16 @@ class PgApiImpl {
 
   CHECKED_STATUS ExecAnalyze(PgStatement *handle, int32_t* rows);
 
+  //------------------------------------------------------------------------------------------------
+  // Sample.
+  CHECKED_STATUS NewSample(const PgObjectId& table_id,
+                           int targrows,
+                           PgStatement **handle);
+
+  CHECKED_STATUS ExecSample(PgStatement *handle);
+
+  CHECKED_STATUS GetEstimatedRowCount(PgStatement *handle, double *liverows);
+
   //------------------------------------------------------------------------------------------------
   // Transaction control.
   PgTxnManager* GetPgTxnManager() { return pg_txn_manager_.get(); }
@@ -54,10 +54,31 @@ DEFINE_int32(ysql_prefetch_limit, 1024,
 DEFINE_double(ysql_backward_prefetch_scale_factor, 0.0625 /* 1/16th */,
               "Scale factor to reduce ysql_prefetch_limit for backward scan");
 
+DEFINE_int64(ysql_prefetch_size_limit_bytes, 0,
+             "Maximum number of bytes of rows data to prefetch in one response. When set, the "
+             "row limit of the following pages of a scan is derived from the observed row width, "
+             "up to ysql_max_adaptive_prefetch_limit rows. 0 disables the byte budget.");
+
+DEFINE_int32(ysql_max_adaptive_prefetch_limit, 65536,
+             "Maximum number of rows to prefetch when the row limit is derived from "
+             "ysql_prefetch_size_limit_bytes");
+
 DEFINE_int32(ysql_session_max_batch_size, 512,
              "Maximum batch size for buffered writes between PostgreSQL server and YugaByte DocDB "
              "services");
 
+DEFINE_int32(ysql_max_in_flight_write_batches, 1,
+             "Maximum number of batches of buffered writes that a YSQL session keeps in flight, "
+             "so bulk writes like COPY send the next batch without waiting for the previous "
+             "one. Errors of a batch are reported when the session waits for it, before the "
+             "statement completes. 1 means each batch is waited for before buffering more.");
+
+DEFINE_bool(ysql_pipeline_writes_across_statements, false,
+            "Whether a statement with buffered writes completes without waiting for its last "
+            "batch of writes, up to ysql_max_in_flight_write_batches batches. The session waits "
+            "for the writes before an operation that could depend on them, like a read, and "
+            "before commit, where errors of the writes are reported.");
+
 DEFINE_bool(ysql_non_txn_copy, false,
             "Execute COPY inserts non-transactionally.");
 
@@ -82,6 +103,11 @@ DEFINE_bool(ysql_suppress_unsupported_error, false,
 DEFINE_int32(ysql_sequence_cache_minval, 100,
              "Set how many sequence numbers to be preallocated in cache.");
 
+DEFINE_int32(ysql_sequence_node_cache_size, 0,
+             "Number of values of a sequence that a backend claims at once, keeping the values it "
+             "does not cache itself in the local tablet server for the other backends of the "
+             "node. 0 disables the node level cache.");
+
 // Top-level flag to enable all YSQL beta features.
 DEFINE_bool(ysql_beta_features, false,
             "Whether to enable all ysql beta features");
@@ -120,6 +146,40 @@ DEFINE_bool(ysql_sleep_before_retry_on_txn_conflict, true,
 // - Use boolean experimental flag just in case introducing "ybRunContext" is a wrong idea.
 DEFINE_bool(ysql_disable_portal_run_context, false, "Whether to use portal ybRunContext.");
 
+DEFINE_bool(ysql_enable_columnar_scan_results, false,
+            "Whether to request rows of non-aggregate scans from DocDB in columnar layout.");
+
+DEFINE_bool(ysql_batch_primary_key_in_lookups, false,
+            "Whether reads that bind every primary key column, one of them to an IN list, "
+            "are sent as batches of row keys, one request per tablet, instead of "
+            "a request per IN value.");
+
+DEFINE_int32(ysql_max_primary_key_in_lookup_combinations, 1024,
+             "Maximum number of combinations of values of IN lists on multiple primary key columns "
+             "for which the read is sent as batches of row keys, one request per tablet, when "
+             "ysql_batch_primary_key_in_lookups is set.");
+
+DEFINE_bool(ysql_use_node_table_schema_cache, false,
+            "Whether to load table schemas through the local tablet server, which caches them for "
+            "all backends of the node, instead of asking the master from every backend.");
+
+DEFINE_int32(ysql_max_fk_check_batch_size, 0,
+             "Maximum number of foreign key references checked by one batched read of the "
+             "referenced table. The read sends one request per tablet holding the references. "
+             "0 means ysql_session_max_batch_size.");
+TAG_FLAG(ysql_max_fk_check_batch_size, advanced);
+
+DEFINE_bool(ysql_pipeline_index_scan_table_reads, false,
+            "Whether a secondary index scan reads the table rows of the next batch of index "
+            "entries while the rows of the current batch are returned, instead of after them. "
+            "Not used for scans with LIMIT or row locks.");
+TAG_FLAG(ysql_pipeline_index_scan_table_reads, advanced);
+
+DEFINE_bool(ysql_use_statement_arena, false,
+            "Whether expressions of a YSQL statement are allocated in an arena owned by the "
+            "statement and released with it, instead of separately on the heap.");
+TAG_FLAG(ysql_use_statement_arena, advanced);
+
 DEFINE_bool(ysql_allow_analyze_cmd, false,
             "Whether to allow ANALYZE cmd to run basic row count estimation.");
 TAG_FLAG(ysql_allow_analyze_cmd, hidden);
@@ -26,7 +26,11 @@ DECLARE_bool(TEST_pggate_ignore_tserver_shm);
 DECLARE_int32(ysql_request_limit);
 DECLARE_int32(ysql_prefetch_limit);
 DECLARE_double(ysql_backward_prefetch_scale_factor);
+DECLARE_int64(ysql_prefetch_size_limit_bytes);
+DECLARE_int32(ysql_max_adaptive_prefetch_limit);
 DECLARE_int32(ysql_session_max_batch_size);
+DECLARE_int32(ysql_max_in_flight_write_batches);
+DECLARE_bool(ysql_pipeline_writes_across_statements);
 DECLARE_bool(ysql_non_txn_copy);
 DECLARE_int32(ysql_max_read_restart_attempts);
 DECLARE_bool(TEST_ysql_disable_transparent_cache_refresh_retry);
@@ -34,6 +38,7 @@ DECLARE_int32(ysql_output_buffer_size);
 DECLARE_int32(ysql_select_parallelism);
 DECLARE_bool(ysql_enable_update_batching);
 DECLARE_int32(ysql_sequence_cache_minval);
+DECLARE_int32(ysql_sequence_node_cache_size);
 
 DECLARE_bool(ysql_suppress_unsupported_error);
 
@@ -44,5 +49,12 @@ DECLARE_int32(ysql_max_write_restart_attempts);
 DECLARE_bool(ysql_sleep_before_retry_on_txn_conflict);
 DECLARE_bool(ysql_disable_portal_run_context);
 DECLARE_bool(ysql_allow_analyze_cmd);
+DECLARE_bool(ysql_enable_columnar_scan_results);
+DECLARE_bool(ysql_batch_primary_key_in_lookups);
+DECLARE_int32(ysql_max_primary_key_in_lookup_combinations);
+DECLARE_bool(ysql_use_node_table_schema_cache);
+DECLARE_bool(ysql_use_statement_arena);
+DECLARE_int32(ysql_max_fk_check_batch_size);
+DECLARE_bool(ysql_pipeline_index_scan_table_reads);
 
 #endif  // YB_YQL_PGGATE_PGGATE_FLAGS_H
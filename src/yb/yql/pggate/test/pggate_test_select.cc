@@ -15,14 +15,17 @@
 
 #include "yb/yql/pggate/test/pggate_test.h"
 #include "yb/common/ybc-internal.h"
+#include "yb/yql/pggate/pggate_flags.h"
 
 namespace yb {
 namespace pggate {
 
 class PggateTestSelect : public PggateTest {
+ protected:
+  void TestSelectOneTablet();
 };
 
-TEST_F(PggateTestSelect, TestSelectOneTablet) {
+void PggateTestSelect::TestSelectOneTablet() {
   CHECK_OK(Init("TestSelectOneTablet"));
 
   const char *tabname = "basic_table";
@@ -265,5 +268,14 @@ TEST_F(PggateTestSelect, TestSelectOneTablet) {
   pg_stmt = nullptr;
 }
 
+TEST_F(PggateTestSelect, TestSelectOneTablet) {
+  TestSelectOneTablet();
+}
+
+TEST_F(PggateTestSelect, TestSelectOneTabletWithStatementArena) {
+  FLAGS_ysql_use_statement_arena = true;
+  TestSelectOneTablet();
+}
+
 } // namespace pggate
 } // namespace yb
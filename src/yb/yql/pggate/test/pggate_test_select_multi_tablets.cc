@@ -13,6 +13,8 @@
 //
 //--------------------------------------------------------------------------------------------------
 
+#include <set>
+
 #include "yb/yql/pggate/test/pggate_test.h"
 #include "yb/common/ybc-internal.h"
 
@@ -277,5 +279,82 @@ TEST_F(PggateTestSelectMultiTablets, TestSelectMultiTablets) {
   pg_stmt = nullptr;
 }
 
+TEST_F(PggateTestSelectMultiTablets, TestParallelWorkers) {
+  CHECK_OK(Init("TestParallelWorkers"));
+
+  const char *tabname = "parallel_table";
+  const YBCPgOid tab_oid = 3;
+  constexpr int kNumTablets = 4;
+  constexpr int kNumRows = 20;
+  YBCPgStatement pg_stmt;
+
+  CHECK_YBC_STATUS(YBCPgNewCreateTable(kDefaultDatabase, kDefaultSchema, tabname,
+                                       kDefaultDatabaseOid, tab_oid,
+                                       false /* is_shared_table */, true /* if_not_exist */,
+                                       false /* add_primary_key */, false /* colocated */,
+                                       kInvalidOid /* tablegroup_id */,
+                                       kInvalidOid /* tablespace_id */,
+                                       &pg_stmt));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "hash_key", 1,
+                                               DataType::INT64, true, true));
+  CHECK_YBC_STATUS(YBCPgCreateTableSetNumTablets(pg_stmt, kNumTablets));
+  CHECK_YBC_STATUS(YBCPgExecCreateTable(pg_stmt));
+
+  CHECK_YBC_STATUS(YBCPgNewInsert(kDefaultDatabaseOid, tab_oid,
+                                  false /* is_single_row_txn */, &pg_stmt));
+  YBCPgExpr expr_hash;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt8(pg_stmt, 0, false, &expr_hash));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 1, expr_hash));
+  for (int i = 0; i < kNumRows; i++) {
+    CHECK_YBC_STATUS(YBCPgUpdateConstInt8(expr_hash, i, false));
+    BeginTransaction();
+    CHECK_YBC_STATUS(YBCPgExecInsert(pg_stmt));
+    CommitTransaction();
+  }
+
+  // Workers together read every row exactly once, extra workers read nothing.
+  auto select_rows = [tab_oid](int num_workers, int worker_index) {
+    YBCPgStatement select_stmt;
+    CHECK_YBC_STATUS(YBCPgNewSelect(kDefaultDatabaseOid, tab_oid,
+                                    NULL /* prepare_params */, &select_stmt));
+    YBCPgExpr colref;
+    CHECK_YBC_STATUS(YBCTestNewColumnRef(select_stmt, 1, DataType::INT64, &colref));
+    CHECK_YBC_STATUS(YBCPgDmlAppendTarget(select_stmt, colref));
+
+    YBCPgExecParameters exec_params;
+    exec_params.num_parallel_workers = num_workers;
+    exec_params.parallel_worker_index = worker_index;
+    CHECK_YBC_STATUS(YBCPgExecSelect(select_stmt, &exec_params));
+
+    std::vector<int64_t> result;
+    uint64_t value;
+    bool isnull;
+    bool has_data = true;
+    while (true) {
+      CHECK_YBC_STATUS(YBCPgDmlFetch(select_stmt, 1, &value, &isnull, nullptr, &has_data));
+      if (!has_data) {
+        break;
+      }
+      result.push_back(static_cast<int64_t>(value));
+    }
+    return result;
+  };
+
+  constexpr int kNumWorkers = 3;
+  std::set<int64_t> keys;
+  size_t total_rows = 0;
+  BeginTransaction();
+  for (int worker_index = 0; worker_index < kNumWorkers; worker_index++) {
+    auto rows = select_rows(kNumWorkers, worker_index);
+    total_rows += rows.size();
+    keys.insert(rows.begin(), rows.end());
+  }
+  CHECK(select_rows(kNumTablets + 1, kNumTablets).empty());
+  CommitTransaction();
+
+  CHECK_EQ(total_rows, static_cast<size_t>(kNumRows));
+  CHECK_EQ(keys.size(), static_cast<size_t>(kNumRows));
+}
+
 } // namespace pggate
 } // namespace yb
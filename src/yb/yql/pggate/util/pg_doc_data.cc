@@ -38,6 +38,10 @@ Status WriteColumn(const QLValuePB& col_value, faststring *buffer) {
     return Status::OK();
   }
 
+  return WriteColumnValue(col_value, buffer);
+}
+
+Status WriteColumnValue(const QLValuePB& col_value, faststring *buffer) {
   switch (col_value.value_case()) {
     case InternalType::VALUE_NOT_SET:
       break;
@@ -104,6 +108,46 @@ Status WriteColumn(const QLValuePB& col_value, faststring *buffer) {
   return Status::OK();
 }
 
+//--------------------------------------------------------------------------------------------------
+// Columnar layout.
+//--------------------------------------------------------------------------------------------------
+
+PgDocColumnarWriter::PgDocColumnarWriter(size_t num_columns) : columns_(num_columns) {
+}
+
+Status PgDocColumnarWriter::WriteColumn(const QLValuePB& col_value) {
+  DCHECK_LT(column_idx_, columns_.size());
+  auto& column = columns_[column_idx_++];
+  const size_t bit = row_count_ % 8;
+  if (bit == 0) {
+    PgWire::WriteUint8(0, &column.null_bitmap);
+    ++data_size_;
+  }
+  if (QLValue::IsNull(col_value)) {
+    column.null_bitmap.data()[column.null_bitmap.size() - 1] |= 1 << bit;
+    return Status::OK();
+  }
+  const size_t old_size = column.data.size();
+  RETURN_NOT_OK(WriteColumnValue(col_value, &column.data));
+  data_size_ += column.data.size() - old_size;
+  return Status::OK();
+}
+
+void PgDocColumnarWriter::FinishRow() {
+  DCHECK_EQ(column_idx_, columns_.size());
+  column_idx_ = 0;
+  ++row_count_;
+}
+
+void PgDocColumnarWriter::Serialize(faststring *buffer) const {
+  PgWire::WriteInt64(columns_.size(), buffer);
+  for (const auto& column : columns_) {
+    PgWire::WriteInt64(column.data.size(), buffer);
+    buffer->append(column.null_bitmap.data(), column.null_bitmap.size());
+    buffer->append(column.data.data(), column.data.size());
+  }
+}
+
 //--------------------------------------------------------------------------------------------------
 // Read Tuple Routine in DocDB Format (wire_protocol).
 //--------------------------------------------------------------------------------------------------
@@ -129,5 +173,40 @@ PgWireDataHeader PgDocData::ReadDataHeader(Slice *cursor) {
   return PgWireDataHeader(header_data);
 }
 
+Status PgDocData::LoadColumns(
+    Slice cursor, int64_t row_count,
+    std::vector<Slice> *null_bitmaps, std::vector<Slice> *column_data) {
+  const size_t bitmap_size = (row_count + 7) / 8;
+  int64_t num_columns;
+  SCHECK_GE(cursor.size(), sizeof(num_columns), Corruption, "Truncated columnar rows data");
+  cursor.remove_prefix(ReadNumber(&cursor, &num_columns));
+  null_bitmaps->clear();
+  column_data->clear();
+  null_bitmaps->reserve(num_columns);
+  column_data->reserve(num_columns);
+  for (int64_t i = 0; i != num_columns; ++i) {
+    int64_t data_size;
+    SCHECK_GE(cursor.size(), sizeof(data_size), Corruption, "Truncated columnar rows data");
+    cursor.remove_prefix(ReadNumber(&cursor, &data_size));
+    SCHECK_GE(data_size, 0, Corruption, "Invalid columnar rows data");
+    SCHECK_GE(cursor.size(), bitmap_size + static_cast<size_t>(data_size), Corruption,
+              "Truncated columnar rows data");
+    null_bitmaps->emplace_back(cursor.data(), bitmap_size);
+    cursor.remove_prefix(bitmap_size);
+    column_data->emplace_back(cursor.data(), data_size);
+    cursor.remove_prefix(data_size);
+  }
+  SCHECK(cursor.empty(), Corruption, "Unexpected data after columnar rows data");
+  return Status::OK();
+}
+
+PgWireDataHeader PgDocData::ColumnDataHeader(const Slice& null_bitmap, int64_t row) {
+  PgWireDataHeader header;
+  if (null_bitmap[row / 8] & (1 << (row % 8))) {
+    header.set_null();
+  }
+  return header;
+}
+
 }  // namespace pggate
 }  // namespace yb
@@ -14,6 +14,8 @@
 #ifndef YB_YQL_PGGATE_UTIL_PG_DOC_DATA_H_
 #define YB_YQL_PGGATE_UTIL_PG_DOC_DATA_H_
 
+#include <vector>
+
 #include "yb/util/bytes_formatter.h"
 #include "yb/yql/pggate/util/pg_wire.h"
 
@@ -22,11 +24,63 @@ namespace pggate {
 
 CHECKED_STATUS WriteColumn(const QLValuePB& col_value, faststring *buffer);
 
+// Writes the column value without data header. Should not be used for NULL values.
+CHECKED_STATUS WriteColumnValue(const QLValuePB& col_value, faststring *buffer);
+
+// Accumulates rows in columnar layout. After the row count, that is written by the caller in the
+// same way as for the row layout, the number of columns (int64) is written and then every column
+// is serialized as:
+//   data size (int64) | null bitmap ((row_count + 7) / 8 bytes) | data
+// Where bit i of the null bitmap is set when the column value of row i is NULL, and data is the
+// concatenation of non-NULL values of the column, encoded with WriteColumnValue. So values of fixed
+// width types form a dense vector.
+class PgDocColumnarWriter {
+ public:
+  explicit PgDocColumnarWriter(size_t num_columns);
+
+  // Values should be written for all columns, in order, before the next row is started.
+  CHECKED_STATUS WriteColumn(const QLValuePB& col_value);
+
+  void FinishRow();
+
+  size_t row_count() const {
+    return row_count_;
+  }
+
+  // Number of bytes accumulated so far, including null bitmaps.
+  size_t data_size() const {
+    return data_size_;
+  }
+
+  // Appends all accumulated columns to the buffer.
+  void Serialize(faststring *buffer) const;
+
+ private:
+  struct Column {
+    faststring null_bitmap;
+    faststring data;
+  };
+
+  std::vector<Column> columns_;
+  size_t column_idx_ = 0;
+  size_t row_count_ = 0;
+  size_t data_size_ = 0;
+};
+
 class PgDocData : public PgWire {
  public:
   static void LoadCache(const string& data, int64_t *total_row_count, Slice *cursor);
 
   static PgWireDataHeader ReadDataHeader(Slice *cursor);
+
+  // Parses data written by PgDocColumnarWriter. The cursor should be positioned after the row count.
+  // Fills null bitmaps and data of all columns, pointing into the cursor's buffer.
+  static CHECKED_STATUS LoadColumns(
+      Slice cursor, int64_t row_count,
+      std::vector<Slice> *null_bitmaps, std::vector<Slice> *column_data);
+
+  // Returns the data header of the value of specified row in the column with given null bitmap.
+  static PgWireDataHeader ColumnDataHeader(const Slice& null_bitmap, int64_t row);
 };
 
 }  // namespace pggate
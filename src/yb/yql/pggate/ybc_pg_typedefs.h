@@ -224,6 +224,12 @@ typedef struct PgExecParameters {
   //   o ORDER BY clause is not processed by YugaByte. Similarly all rows must be fetched and sent
   //     to Postgres code layer.
   // For now we only support one rowmark.
+  // - follower_read_staleness_ms: when greater than 0 and read_from_followers is set, the read
+  //   is done at the time this many milliseconds ago, instead of at the safe time of the replica
+  //   serving each tablet.
+  // - num_parallel_workers: when greater than 1, a sequential scan or an aggregate reads only
+  //   the tablets whose index modulo num_parallel_workers is parallel_worker_index, so parallel
+  //   workers that use the same read_time together read the whole table exactly once.
 #ifdef __cplusplus
   uint64_t limit_count = 0;
   uint64_t limit_offset = 0;
@@ -232,6 +238,9 @@ typedef struct PgExecParameters {
   uint64_t read_time = 0;
   char *partition_key = NULL;
   bool read_from_followers = false;
+  int follower_read_staleness_ms = 0;
+  int parallel_worker_index = 0;
+  int num_parallel_workers = 0;
 #else
   uint64_t limit_count;
   uint64_t limit_offset;
@@ -240,9 +249,31 @@ typedef struct PgExecParameters {
   uint64_t read_time;
   char *partition_key;
   bool read_from_followers;
+  int follower_read_staleness_ms;
+  int parallel_worker_index;
+  int num_parallel_workers;
 #endif
 } YBCPgExecParameters;
 
+// DocDB work done to execute the read requests of a statement, for EXPLAIN ANALYZE.
+// - num_requests: Number of responses the other counters are collected from.
+// - rows_examined: Rows read from DocDB, including those filtered out by DocDB.
+// - rocksdb_*, block_*: RocksDB iterator operations and data block reads, for both regular and
+//   intents RocksDB.
+// - execution_time_us: Total time of executing the requests in tablet servers.
+typedef struct PgExecStats {
+  uint64_t num_requests;
+  uint64_t rows_examined;
+  uint64_t rows_returned;
+  uint64_t rocksdb_seeks;
+  uint64_t rocksdb_nexts;
+  uint64_t rocksdb_prevs;
+  uint64_t block_cache_hits;
+  uint64_t block_reads;
+  uint64_t block_read_bytes;
+  uint64_t execution_time_us;
+} YBCPgExecStats;
+
 typedef struct PgAttrValueDescriptor {
   int attr_num;
   uint64_t datum;
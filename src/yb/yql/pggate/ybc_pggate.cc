@@ -323,6 +323,27 @@ YBCStatus YBCDeleteSequenceTuple(int64_t db_oid, int64_t seq_oid) {
   return ToYBCStatus(pgapi->DeleteSequenceTuple(db_oid, seq_oid));
 }
 
+YBCStatus YBCTakeNodeCachedSequenceValues(int64_t db_oid,
+                                          int64_t seq_oid,
+                                          uint64_t ysql_catalog_version,
+                                          int64_t increment,
+                                          int64_t max_count,
+                                          int64_t *first_value,
+                                          int64_t *count) {
+  return ToYBCStatus(pgapi->TakeNodeCachedSequenceValues(
+      db_oid, seq_oid, ysql_catalog_version, increment, max_count, first_value, count));
+}
+
+YBCStatus YBCPutNodeCachedSequenceValues(int64_t db_oid,
+                                         int64_t seq_oid,
+                                         uint64_t ysql_catalog_version,
+                                         int64_t increment,
+                                         int64_t first_value,
+                                         int64_t count) {
+  return ToYBCStatus(pgapi->PutNodeCachedSequenceValues(
+      db_oid, seq_oid, ysql_catalog_version, increment, first_value, count));
+}
+
 // Table Operations -------------------------------------------------------------------------------
 
 YBCStatus YBCPgNewCreateTable(const char *database_name,
@@ -553,6 +574,34 @@ YBCStatus YBCPgDmlAppendTarget(YBCPgStatement handle, YBCPgExpr target) {
   return ToYBCStatus(pgapi->DmlAppendTarget(handle, target));
 }
 
+YBCStatus YBCPgDmlAppendColumnRef(YBCPgStatement handle, YBCPgExpr colref) {
+  return ToYBCStatus(pgapi->DmlAppendColumnRef(handle, colref));
+}
+
+YBCStatus YBCPgDmlSetWhereExpr(YBCPgStatement handle, YBCPgExpr where_expr) {
+  return ToYBCStatus(pgapi->DmlSetWhereExpr(handle, where_expr));
+}
+
+YBCStatus YBCPgDmlAppendGroupingColumn(YBCPgStatement handle, YBCPgExpr colref) {
+  return ToYBCStatus(pgapi->DmlAppendGroupingColumn(handle, colref));
+}
+
+YBCStatus YBCPgDmlSetDistinctPrefixLength(YBCPgStatement handle, int prefix_length) {
+  return ToYBCStatus(pgapi->DmlSetDistinctPrefixLength(handle, prefix_length));
+}
+
+YBCStatus YBCPgDmlSetCollectExecStats(YBCPgStatement handle, bool collect) {
+  return ToYBCStatus(pgapi->DmlSetCollectExecStats(handle, collect));
+}
+
+YBCStatus YBCPgDmlSetFillBlockCache(YBCPgStatement handle, bool fill) {
+  return ToYBCStatus(pgapi->DmlSetFillBlockCache(handle, fill));
+}
+
+YBCStatus YBCPgDmlAddExecStats(YBCPgStatement handle, YBCPgExecStats *stats) {
+  return ToYBCStatus(pgapi->DmlAddExecStats(handle, stats));
+}
+
 YBCStatus YBCPgDmlBindColumn(YBCPgStatement handle, int attr_num, YBCPgExpr attr_value) {
   return ToYBCStatus(pgapi->DmlBindColumn(handle, attr_num, attr_value));
 }
@@ -625,6 +674,22 @@ YBCStatus YBCPgExecAnalyze(YBCPgStatement handle, int32_t* rows_count) {
   return ToYBCStatus(pgapi->ExecAnalyze(handle, rows_count));
 }
 
+YBCStatus YBCPgNewSample(const YBCPgOid database_oid,
+                         const YBCPgOid table_oid,
+                         int targrows,
+                         YBCPgStatement *handle) {
+  const PgObjectId table_id(database_oid, table_oid);
+  return ToYBCStatus(pgapi->NewSample(table_id, targrows, handle));
+}
+
+YBCStatus YBCPgExecSample(YBCPgStatement handle) {
+  return ToYBCStatus(pgapi->ExecSample(handle));
+}
+
+YBCStatus YBCPgGetEstimatedRowCount(YBCPgStatement handle, double *liverows) {
+  return ToYBCStatus(pgapi->GetEstimatedRowCount(handle, liverows));
+}
+
 // INSERT Operations -------------------------------------------------------------------------------
 YBCStatus YBCPgNewInsert(const YBCPgOid database_oid,
                          const YBCPgOid table_oid,
@@ -922,6 +987,10 @@ int32_t YBCGetSequenceCacheMinval() {
   return FLAGS_ysql_sequence_cache_minval;
 }
 
+int32_t YBCGetSequenceNodeCacheSize() {
+  return FLAGS_ysql_sequence_node_cache_size;
+}
+
 bool YBCGetDisableIndexBackfill() {
   return FLAGS_ysql_disable_index_backfill;
 }
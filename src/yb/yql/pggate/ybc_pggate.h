@@ -108,6 +108,24 @@ YBCStatus YBCReadSequenceTuple(int64_t db_oid,
 
 YBCStatus YBCDeleteSequenceTuple(int64_t db_oid, int64_t seq_oid);
 
+// Take up to max_count values of a sequence from the node level cache of the local tablet server.
+// The values taken are first_value + i * increment for i in [0, count).
+YBCStatus YBCTakeNodeCachedSequenceValues(int64_t db_oid,
+                                          int64_t seq_oid,
+                                          uint64_t ysql_catalog_version,
+                                          int64_t increment,
+                                          int64_t max_count,
+                                          int64_t *first_value,
+                                          int64_t *count);
+
+// Add values of a sequence, already claimed in the sequences table, to the node level cache.
+YBCStatus YBCPutNodeCachedSequenceValues(int64_t db_oid,
+                                         int64_t seq_oid,
+                                         uint64_t ysql_catalog_version,
+                                         int64_t increment,
+                                         int64_t first_value,
+                                         int64_t count);
+
 // Create database.
 YBCStatus YBCPgNewCreateDatabase(const char *database_name,
                                  YBCPgOid database_oid,
@@ -291,6 +309,34 @@ YBCStatus YBCPgBackfillIndex(
 // - INSERT / UPDATE / DELETE ... RETURNING target_expr1, target_expr2, ...
 YBCStatus YBCPgDmlAppendTarget(YBCPgStatement handle, YBCPgExpr target);
 
+// Read the referenced column, that is used only by expressions evaluated in DocDB, without
+// returning it.
+YBCStatus YBCPgDmlAppendColumnRef(YBCPgStatement handle, YBCPgExpr colref);
+
+// Filter rows in DocDB by the given boolean expression, usually an "eval_bool_expr_call"
+// operator. Rows for which it is not true are not returned.
+YBCStatus YBCPgDmlSetWhereExpr(YBCPgStatement handle, YBCPgExpr where_expr);
+
+// Group aggregate targets by the given column. DocDB returns a row of partial aggregates per group,
+// with the values of grouping columns following the aggregates in the order they were appended.
+YBCStatus YBCPgDmlAppendGroupingColumn(YBCPgStatement handle, YBCPgExpr colref);
+
+// Return only the first row for each distinct combination of values of prefix_length leading key
+// columns of the scanned table or index. DocDB seeks over the rest of the rows with the same
+// values, so scans like "SELECT DISTINCT a" skip through the keys instead of reading all of them.
+// Rows with the same prefix could still be returned several times, so the caller should keep
+// removing duplicates. Cannot be combined with YBCPgDmlSetWhereExpr.
+YBCStatus YBCPgDmlSetDistinctPrefixLength(YBCPgStatement handle, int prefix_length);
+
+// Request DocDB execution stats with the rows of a read statement, for EXPLAIN ANALYZE.
+// YBCPgDmlAddExecStats adds the stats of the responses received so far to *stats.
+YBCStatus YBCPgDmlSetCollectExecStats(YBCPgStatement handle, bool collect);
+YBCStatus YBCPgDmlAddExecStats(YBCPgStatement handle, YBCPgExecStats *stats);
+
+// Whether SST blocks read by a read statement are added to the DocDB block cache. Large scans do
+// not add them, so they do not evict the blocks of frequently read rows.
+YBCStatus YBCPgDmlSetFillBlockCache(YBCPgStatement handle, bool fill);
+
 // Binding Columns: Bind column with a value (expression) in a statement.
 // + This API is used to identify the rows you want to operate on. If binding columns are not
 //   there, that means you want to operate on all rows (full scan). You can view this as a
@@ -342,13 +388,12 @@ YBCStatus YBCPgBuildYBTupleId(const YBCPgYBTupleIdDescriptor* data, uint64_t *yb
 
 // DB Operations: WHERE, ORDER_BY, GROUP_BY, etc.
 // + The following operations are run by DocDB.
-//   - Not yet
+//   - API for "where_expr": YBCPgDmlSetWhereExpr
+//   - API for "group_by_expr" of aggregate targets: YBCPgDmlAppendGroupingColumn
 //
 // + The following operations are run by Postgres layer. An API might be added to move these
 //   operations to DocDB.
-//   - API for "where_expr"
 //   - API for "order_by_expr"
-//   - API for "group_by_expr"
 
 
 // Buffer write operations.
@@ -364,6 +409,19 @@ YBCStatus YBCPgNewAnalyze(const YBCPgOid database_oid,
 
 YBCStatus YBCPgExecAnalyze(YBCPgStatement handle, int32_t* rows_count);
 
+// SAMPLE ------------------------------------------------------------------------------------------
+// Collect a random sample of up to targrows rows of the table. After YBCPgExecSample() the sampled
+// rows are fetched with YBCPgDmlFetch() like the result of a SELECT.
+YBCStatus YBCPgNewSample(const YBCPgOid database_oid,
+                         const YBCPgOid table_oid,
+                         int targrows,
+                         YBCPgStatement *handle);
+
+YBCStatus YBCPgExecSample(YBCPgStatement handle);
+
+// Number of live rows seen while collecting the sample.
+YBCStatus YBCPgGetEstimatedRowCount(YBCPgStatement handle, double *liverows);
+
 // INSERT ------------------------------------------------------------------------------------------
 YBCStatus YBCPgNewInsert(YBCPgOid database_oid,
                          YBCPgOid table_oid,
@@ -491,6 +549,9 @@ int32_t YBCGetOutputBufferSize();
 // Retrieves value of ysql_sequence_cache_minval gflag
 int32_t YBCGetSequenceCacheMinval();
 
+// Retrieves value of ysql_sequence_node_cache_size gflag
+int32_t YBCGetSequenceNodeCacheSize();
+
 // Retrieve value of ysql_disable_index_backfill gflag.
 bool YBCGetDisableIndexBackfill();
 
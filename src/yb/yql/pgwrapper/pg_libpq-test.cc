@@ -13,6 +13,7 @@
 #include <signal.h>
 
 #include <fstream>
+#include <set>
 #include <thread>
 
 #include "yb/util/barrier.h"
@@ -29,6 +30,8 @@
 #include "yb/common/pgsql_error.h"
 #include "yb/master/catalog_manager.h"
 #include "yb/tserver/tserver.pb.h"
+#include "yb/tserver/tserver_admin.proxy.h"
+#include "yb/tserver/tserver_service.proxy.h"
 
 using namespace std::literals;
 
@@ -1334,6 +1337,391 @@ TEST_F(PgLibPqTest, YB_DISABLE_TEST_IN_TSAN(ReplayDeletedTableInColocatedDB)) {
   ASSERT_EQ(res, 0);
 }
 
+class PgLibPqRemoveColocatedTableTest : public PgLibPqTest {
+ protected:
+  void UpdateMiniClusterOptions(ExternalMiniClusterOptions* options) override {
+    options->extra_tserver_flags.push_back("--tombstone_removed_colocated_table_data=true");
+    options->extra_tserver_flags.push_back("--timestamp_history_retention_interval_sec=0");
+  }
+
+  // Flushes and compacts all tablets, returning the SST files size of the specified tablet on the
+  // first tablet server.
+  Result<int64_t> CompactAndGetTabletSize(const TabletId& tablet_id) {
+    for (auto* tserver : cluster_->tserver_daemons()) {
+      auto proxy = cluster_->GetProxy<tserver::TabletServerAdminServiceProxy>(tserver);
+      tserver::FlushTabletsRequestPB req;
+      req.set_dest_uuid(tserver->uuid());
+      req.set_all_tablets(true);
+      for (bool is_compaction : {false, true}) {
+        req.set_is_compaction(is_compaction);
+        tserver::FlushTabletsResponsePB resp;
+        rpc::RpcController controller;
+        controller.set_timeout(30s);
+        RETURN_NOT_OK(proxy->FlushTablets(req, &resp, &controller));
+      }
+    }
+    auto proxy = cluster_->GetProxy<tserver::TabletServerServiceProxy>(
+        cluster_->tablet_server(0));
+    tserver::ListTabletsRequestPB req;
+    tserver::ListTabletsResponsePB resp;
+    rpc::RpcController controller;
+    controller.set_timeout(30s);
+    RETURN_NOT_OK(proxy->ListTablets(req, &resp, &controller));
+    for (const auto& tablet : resp.status_and_schema()) {
+      if (tablet.tablet_status().tablet_id() == tablet_id) {
+        return tablet.tablet_status().sst_files_disk_size();
+      }
+    }
+    return STATUS_FORMAT(NotFound, "Tablet $0 not found", tablet_id);
+  }
+};
+
+// Dropping a colocated table writes a table tombstone, so compaction removes its rows, while other
+// tables of the tablet are untouched. Bootstrap replays the removal again without errors.
+TEST_F(PgLibPqRemoveColocatedTableTest, YB_DISABLE_TEST_IN_TSAN(DropTableRemovesRows)) {
+  const std::string kDatabaseName = "testdb";
+  constexpr int kDroppedRows = 5000;
+  constexpr int kKeptRows = 100;
+  auto client = ASSERT_RESULT(cluster_->CreateClient());
+
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.ExecuteFormat("CREATE DATABASE $0 WITH colocated = true", kDatabaseName));
+  conn = ASSERT_RESULT(ConnectToDB(kDatabaseName));
+  ASSERT_OK(conn.Execute("CREATE TABLE foo (k INT PRIMARY KEY, v TEXT)"));
+  ASSERT_OK(conn.Execute("CREATE TABLE bar (k INT PRIMARY KEY, v TEXT)"));
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO foo SELECT i, repeat(md5(i::text), 10) FROM generate_series(1, $0) AS i",
+      kDroppedRows));
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO bar SELECT i, 'value' || i FROM generate_series(1, $0) AS i", kKeptRows));
+
+  const auto tablet_id = ASSERT_RESULT(GetColocatedTabletLocations(
+      client.get(), kDatabaseName, 30s)).tablet_id();
+  const auto size_before = ASSERT_RESULT(CompactAndGetTabletSize(tablet_id));
+  LOG(INFO) << "Colocated tablet size before drop: " << size_before;
+  ASSERT_GT(size_before, 0);
+
+  ASSERT_OK(conn.Execute("DROP TABLE foo"));
+  ASSERT_OK(WaitFor([this, &tablet_id, size_before]() -> Result<bool> {
+    const auto size = VERIFY_RESULT(CompactAndGetTabletSize(tablet_id));
+    LOG(INFO) << "Colocated tablet size after drop: " << size;
+    return size < size_before / 2;
+  }, 60s, "Compact rows of dropped table"));
+
+  const auto kCountRows = "SELECT COUNT(*) FROM bar";
+  ASSERT_EQ(ASSERT_RESULT(conn.FetchValue<int64_t>(kCountRows)), kKeptRows);
+
+  // The tombstone is written again when the removal is replayed from the WAL.
+  for (auto* tserver : cluster_->tserver_daemons()) {
+    tserver->Shutdown();
+    ASSERT_OK(tserver->Restart());
+    ASSERT_OK(cluster_->WaitForTabletsRunning(tserver, MonoDelta::FromSeconds(60)));
+  }
+  conn = ASSERT_RESULT(ConnectToDB(kDatabaseName));
+  ASSERT_EQ(ASSERT_RESULT(conn.FetchValue<int64_t>(kCountRows)), kKeptRows);
+  ASSERT_OK(conn.Execute("INSERT INTO bar VALUES (0, 'zero')"));
+  auto res = ASSERT_RESULT(conn.FetchValue<std::string>("SELECT v FROM bar WHERE k = 0"));
+  ASSERT_EQ(res, "zero");
+}
+
+class PgLibPqBatchedKeyLookupTest : public PgLibPqTest {
+  void UpdateMiniClusterOptions(ExternalMiniClusterOptions* options) override {
+    options->extra_tserver_flags.push_back("--ysql_batch_primary_key_in_lookups=true");
+  }
+};
+
+TEST_F(PgLibPqBatchedKeyLookupTest, YB_DISABLE_TEST_IN_TSAN(InListOnKeyColumns)) {
+  constexpr int kNumKeys = 100;
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute(
+      "CREATE TABLE t (h INT, r INT, v INT, PRIMARY KEY (h HASH, r DESC)) SPLIT INTO 3 TABLETS"));
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO t SELECT i, i % 3, i * 10 FROM generate_series(1, $0) AS i", kNumKeys));
+
+  // IN clause on the hash column, duplicates and missing keys are ignored.
+  auto res = ASSERT_RESULT(conn.Fetch(
+      "SELECT h, v FROM t WHERE h IN (5, 7, 7, 3, 1000) AND r = h % 3 ORDER BY h"));
+  ASSERT_EQ(PQntuples(res.get()), 3);
+  int row = 0;
+  for (int key : {3, 5, 7}) {
+    ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), row, 0)), key);
+    ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), row, 1)), key * 10);
+    ++row;
+  }
+
+  // IN clause on the range column keeps the order of the descending key.
+  ASSERT_OK(conn.Execute("INSERT INTO t VALUES (1000, 1, 1), (1000, 2, 2), (1000, 3, 3)"));
+  res = ASSERT_RESULT(conn.Fetch(
+      "SELECT r FROM t WHERE h = 1000 AND r IN (1, 3, 2, 4) ORDER BY r DESC"));
+  ASSERT_EQ(PQntuples(res.get()), 3);
+  for (int i = 0; i != 3; ++i) {
+    ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), i, 0)), 3 - i);
+  }
+}
+
+TEST_F(PgLibPqBatchedKeyLookupTest, YB_DISABLE_TEST_IN_TSAN(InListsOnMultipleKeyColumns)) {
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute(
+      "CREATE TABLE t (h1 INT, h2 INT, r INT, v INT, PRIMARY KEY ((h1, h2) HASH, r)) "
+      "SPLIT INTO 3 TABLETS"));
+  ASSERT_OK(conn.Execute(
+      "INSERT INTO t SELECT i / 10, i % 10, i % 3, i FROM generate_series(0, 99) AS i"));
+
+  // Combinations of IN values which are missing in the table are ignored.
+  auto res = ASSERT_RESULT(conn.Fetch(
+      "SELECT v FROM t WHERE h1 IN (1, 2, 20) AND h2 IN (4, 5) AND r IN (0, 1, 2) ORDER BY v"));
+  ASSERT_EQ(PQntuples(res.get()), 4);
+  int row = 0;
+  for (int value : {14, 15, 24, 25}) {
+    ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), row, 0)), value);
+    ++row;
+  }
+
+  // IN lists on range partitioned table.
+  ASSERT_OK(conn.Execute(
+      "CREATE TABLE r (r1 INT, r2 INT, v INT, PRIMARY KEY (r1 ASC, r2 ASC)) "
+      "SPLIT AT VALUES ((3), (6))"));
+  ASSERT_OK(conn.Execute(
+      "INSERT INTO r SELECT i / 10, i % 10, i FROM generate_series(0, 99) AS i"));
+  res = ASSERT_RESULT(conn.Fetch(
+      "SELECT v FROM r WHERE r1 IN (8, 1, 4) AND r2 IN (2, 3) ORDER BY r1, r2"));
+  ASSERT_EQ(PQntuples(res.get()), 6);
+  row = 0;
+  for (int value : {12, 13, 42, 43, 82, 83}) {
+    ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), row, 0)), value);
+    ++row;
+  }
+}
+
+class PgLibPqPrefetchSizeLimitTest : public PgLibPqTest {
+  void UpdateMiniClusterOptions(ExternalMiniClusterOptions* options) override {
+    options->extra_tserver_flags.push_back("--ysql_prefetch_size_limit_bytes=4096");
+    options->extra_tserver_flags.push_back("--ysql_max_adaptive_prefetch_limit=5000");
+  }
+};
+
+TEST_F(PgLibPqPrefetchSizeLimitTest, YB_DISABLE_TEST_IN_TSAN(WideAndNarrowRows)) {
+  constexpr int kNumRows = 2000;
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute("CREATE TABLE t (k INT PRIMARY KEY, v TEXT) SPLIT INTO 2 TABLETS"));
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO t SELECT i, repeat('x', 1000) FROM generate_series(1, $0) AS i", kNumRows));
+
+  // Wide rows are returned in pages of a few rows, narrow rows in pages of many rows, both
+  // should return every row exactly once.
+  for (const auto* query : {"SELECT k, v FROM t", "SELECT k FROM t",
+                            "SELECT k, v FROM t WHERE k > 0 ORDER BY k DESC"}) {
+    auto res = ASSERT_RESULT(conn.Fetch(query));
+    ASSERT_EQ(PQntuples(res.get()), kNumRows);
+    std::set<int32_t> keys;
+    for (int i = 0; i != kNumRows; ++i) {
+      keys.insert(ASSERT_RESULT(GetInt32(res.get(), i, 0)));
+    }
+    ASSERT_EQ(keys.size(), static_cast<size_t>(kNumRows));
+  }
+
+  auto res = ASSERT_RESULT(conn.Fetch("SELECT k FROM t WHERE k <= 10 ORDER BY k LIMIT 7"));
+  ASSERT_EQ(PQntuples(res.get()), 7);
+  for (int i = 0; i != 7; ++i) {
+    ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), i, 0)), i + 1);
+  }
+}
+
+TEST_F(PgLibPqTest, YB_DISABLE_TEST_IN_TSAN(ExpressionPushdown)) {
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute(
+      "CREATE TABLE orders (id INT PRIMARY KEY, status TEXT, amount INT) SPLIT INTO 3 TABLETS"));
+  ASSERT_OK(conn.Execute(
+      "INSERT INTO orders SELECT i, CASE WHEN i % 3 = 0 THEN 'open' ELSE 'closed' END, "
+      "CASE WHEN i % 10 = 0 THEN NULL ELSE i END FROM generate_series(1, 300) AS i"));
+
+  const std::vector<std::string> queries = {
+    "SELECT id FROM orders WHERE status = 'open' AND amount > 100 ORDER BY id",
+    "SELECT id FROM orders WHERE status = 'open' OR amount < 10 ORDER BY id",
+    "SELECT id FROM orders WHERE NOT (amount > 50) ORDER BY id",
+    "SELECT id FROM orders WHERE amount IS NULL AND length(status) = 4 ORDER BY id",
+    "SELECT id FROM orders WHERE amount + id > 500 AND id % 7 = 0 ORDER BY id",
+    "SELECT COUNT(*) FROM orders WHERE status <> 'open'",
+  };
+
+  auto fetch_rows = [&conn](const std::string& query) -> Result<std::string> {
+    auto res = VERIFY_RESULT(conn.Fetch(query));
+    std::string result;
+    for (int i = 0; i != PQntuples(res.get()); ++i) {
+      result += VERIFY_RESULT(ToString(res.get(), i, 0)) + "\n";
+    }
+    return result;
+  };
+
+  // Results with filters evaluated by DocDB should match the ones evaluated by Postgres.
+  std::vector<std::string> expected;
+  for (const auto& query : queries) {
+    expected.push_back(ASSERT_RESULT(fetch_rows(query)));
+  }
+
+  ASSERT_OK(conn.Execute("SET yb_enable_expression_pushdown = true"));
+  auto plan = ASSERT_RESULT(fetch_rows(
+      "EXPLAIN SELECT id FROM orders WHERE status = 'open' AND amount > 100"));
+  ASSERT_STR_CONTAINS(plan, "Remote Filter");
+  ASSERT_STR_NOT_CONTAINS(plan, " Filter: ");
+
+  for (size_t i = 0; i != queries.size(); ++i) {
+    ASSERT_EQ(ASSERT_RESULT(fetch_rows(queries[i])), expected[i]) << queries[i];
+  }
+}
+
+class PgLibPqGroupedAggregateTest : public PgLibPqTest {
+  void UpdateMiniClusterOptions(ExternalMiniClusterOptions* options) override {
+    // Fewer groups per response than groups per tablet, so partial aggregates of a group come
+    // from several pages.
+    options->extra_tserver_flags.push_back("--ysql_prefetch_limit=3");
+  }
+};
+
+TEST_F(PgLibPqGroupedAggregateTest, YB_DISABLE_TEST_IN_TSAN(GroupedAggregatePushdown)) {
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute(
+      "CREATE TABLE sales (id INT PRIMARY KEY, region TEXT, store INT, amount INT) "
+      "SPLIT INTO 3 TABLETS"));
+  ASSERT_OK(conn.Execute(
+      "INSERT INTO sales SELECT i, 'region' || (i % 5), i % 3, "
+      "CASE WHEN i % 11 = 0 THEN NULL ELSE i END FROM generate_series(1, 3000) AS i"));
+  ASSERT_OK(conn.Execute("INSERT INTO sales VALUES (3001, NULL, NULL, 1), (3002, NULL, 1, 2)"));
+  ASSERT_OK(conn.Execute("SET enable_sort = false"));
+
+  const std::vector<std::string> queries = {
+    "SELECT region, COUNT(*), SUM(amount), MIN(amount), MAX(amount) FROM sales "
+        "GROUP BY region ORDER BY region",
+    "SELECT store, region, COUNT(amount) FROM sales GROUP BY region, store "
+        "ORDER BY store, region",
+    "SELECT region, COUNT(*) FROM sales GROUP BY region HAVING COUNT(*) > 1 ORDER BY region",
+  };
+
+  auto fetch_rows = [&conn](const std::string& query) -> Result<std::string> {
+    auto res = VERIFY_RESULT(conn.Fetch(query));
+    std::string result;
+    for (int row = 0; row != PQntuples(res.get()); ++row) {
+      for (int column = 0; column != PQnfields(res.get()); ++column) {
+        result += VERIFY_RESULT(ToString(res.get(), row, column)) + ", ";
+      }
+      result += "\n";
+    }
+    return result;
+  };
+
+  // Partial aggregates combined by Postgres should match aggregates of all rows.
+  std::vector<std::string> expected;
+  for (const auto& query : queries) {
+    expected.push_back(ASSERT_RESULT(fetch_rows(query)));
+  }
+
+  ASSERT_OK(conn.Execute("SET yb_enable_grouped_aggregate_pushdown = true"));
+  for (size_t i = 0; i != queries.size(); ++i) {
+    ASSERT_EQ(ASSERT_RESULT(fetch_rows(queries[i])), expected[i]) << queries[i];
+  }
+}
+
+class PgLibPqAnalyzeSamplingTest : public PgLibPqTest {
+  void UpdateMiniClusterOptions(ExternalMiniClusterOptions* options) override {
+    options->extra_tserver_flags.push_back("--ysql_allow_analyze_cmd=true");
+    // Several pages per tablet, so the key threshold is propagated between pages.
+    options->extra_tserver_flags.push_back("--ysql_prefetch_limit=100");
+  }
+};
+
+TEST_F(PgLibPqAnalyzeSamplingTest, YB_DISABLE_TEST_IN_TSAN(AnalyzeSampling)) {
+  constexpr int kNumRows = 5000;
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute(
+      "CREATE TABLE items (id INT PRIMARY KEY, category INT, name TEXT) SPLIT INTO 3 TABLETS"));
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO items SELECT i, i % 5, 'item' || i FROM generate_series(1, $0) AS i",
+      kNumRows));
+
+  // Statistics target 1 samples 300 rows.
+  ASSERT_OK(conn.Execute("SET default_statistics_target = 1"));
+  ASSERT_OK(conn.Execute("SET yb_enable_analyze_sampling = true"));
+  ASSERT_OK(conn.Execute("ANALYZE items"));
+
+  auto reltuples = ASSERT_RESULT(conn.FetchValue<int32_t>(
+      "SELECT reltuples::int FROM pg_class WHERE relname = 'items'"));
+  ASSERT_EQ(reltuples, kNumRows);
+
+  auto n_distinct = ASSERT_RESULT(conn.FetchValue<int32_t>(
+      "SELECT n_distinct::int FROM pg_stats "
+      "WHERE tablename = 'items' AND attname = 'category'"));
+  ASSERT_EQ(n_distinct, 5);
+
+  // Unique column is estimated as distinct in every row.
+  n_distinct = ASSERT_RESULT(conn.FetchValue<int32_t>(
+      "SELECT n_distinct::int FROM pg_stats WHERE tablename = 'items' AND attname = 'id'"));
+  ASSERT_EQ(n_distinct, -1);
+}
+
+class PgLibPqColumnarScanTest : public PgLibPqTest {
+  void UpdateMiniClusterOptions(ExternalMiniClusterOptions* options) override {
+    options->extra_tserver_flags.push_back("--ysql_enable_columnar_scan_results=true");
+    // Several pages per tablet, with row counts that are not multiples of null bitmap byte.
+    options->extra_tserver_flags.push_back("--ysql_prefetch_limit=101");
+  }
+};
+
+TEST_F(PgLibPqColumnarScanTest, YB_DISABLE_TEST_IN_TSAN(ColumnarScan)) {
+  constexpr int kNumRows = 1000;
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute(
+      "CREATE TABLE t (k INT PRIMARY KEY, i BIGINT, f DOUBLE PRECISION, s TEXT, b BOOL) "
+      "SPLIT INTO 3 TABLETS"));
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO t SELECT k, CASE WHEN k % 7 = 0 THEN NULL ELSE k * 1000 END, k * 0.25, "
+      "CASE WHEN k % 5 = 0 THEN NULL ELSE 'value' || k END, "
+      "CASE WHEN k % 3 = 0 THEN NULL ELSE k % 2 = 0 END FROM generate_series(1, $0) AS k",
+      kNumRows));
+
+  auto check_rows = [&conn](const std::string& query, int expected_rows) -> Status {
+    auto res = VERIFY_RESULT(conn.Fetch(query));
+    SCHECK_EQ(PQntuples(res.get()), expected_rows, IllegalState, query);
+    for (int row = 0; row != PQntuples(res.get()); ++row) {
+      const auto k = VERIFY_RESULT(GetInt32(res.get(), row, 0));
+      SCHECK_EQ(PQgetisnull(res.get(), row, 1) != 0, k % 7 == 0, IllegalState, query);
+      if (k % 7 != 0) {
+        SCHECK_EQ(VERIFY_RESULT(GetInt64(res.get(), row, 1)), k * 1000, IllegalState, query);
+      }
+      SCHECK_EQ(VERIFY_RESULT(GetDouble(res.get(), row, 2)), k * 0.25, IllegalState, query);
+      SCHECK_EQ(PQgetisnull(res.get(), row, 3) != 0, k % 5 == 0, IllegalState, query);
+      if (k % 5 != 0) {
+        SCHECK_EQ(VERIFY_RESULT(GetString(res.get(), row, 3)), Format("value$0", k),
+                  IllegalState, query);
+      }
+      SCHECK_EQ(PQgetisnull(res.get(), row, 4) != 0, k % 3 == 0, IllegalState, query);
+      if (k % 3 != 0) {
+        SCHECK_EQ(VERIFY_RESULT(GetBool(res.get(), row, 4)), k % 2 == 0, IllegalState, query);
+      }
+    }
+    return Status::OK();
+  };
+
+  ASSERT_OK(check_rows("SELECT k, i, f, s, b FROM t", kNumRows));
+  ASSERT_OK(check_rows("SELECT k, i, f, s, b FROM t WHERE k > 990", 10));
+  ASSERT_OK(check_rows("SELECT k, i, f, s, b FROM t WHERE k = 7", 1));
+  ASSERT_OK(check_rows(Format("SELECT k, i, f, s, b FROM t WHERE k > $0", kNumRows), 0));
+  // Columns in other order than in the table.
+  auto res = ASSERT_RESULT(conn.Fetch("SELECT s, k FROM t WHERE k IN (4, 5)"));
+  ASSERT_EQ(PQntuples(res.get()), 2);
+  for (int row = 0; row != 2; ++row) {
+    const auto k = ASSERT_RESULT(GetInt32(res.get(), row, 1));
+    ASSERT_EQ(PQgetisnull(res.get(), row, 0) != 0, k == 5);
+  }
+
+  // Updates read ybctid of the rows from the columnar result.
+  ASSERT_OK(conn.Execute("UPDATE t SET i = -1 WHERE s IS NULL"));
+  ASSERT_EQ(ASSERT_RESULT(conn.FetchValue<int64_t>("SELECT COUNT(*) FROM t WHERE i = -1")),
+            kNumRows / 5);
+  ASSERT_OK(conn.Execute("DELETE FROM t WHERE i = -1"));
+  ASSERT_EQ(ASSERT_RESULT(conn.FetchValue<int64_t>("SELECT COUNT(*) FROM t")),
+            kNumRows - kNumRows / 5);
+}
+
 class PgLibPqTablegroupTest : public PgLibPqTest {
   void UpdateMiniClusterOptions(ExternalMiniClusterOptions* options) override {
     // Enable tablegroup beta feature
@@ -18,7 +18,11 @@
 #include "yb/master/mini_master.h"
 #include "yb/master/sys_catalog_constants.h"
 
+#include "yb/tserver/mini_tablet_server.h"
+#include "yb/tserver/tablet_server.h"
+
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
 #include "yb/yql/pggate/pggate_flags.h"
 
 #include "yb/common/pgsql_error.h"
@@ -36,10 +40,13 @@ DECLARE_int32(history_cutoff_propagation_interval_ms);
 DECLARE_int32(timestamp_history_retention_interval_sec);
 DECLARE_int32(txn_max_apply_batch_records);
 DECLARE_int64(apply_intents_task_injected_delay_ms);
+DECLARE_int64(apply_intents_max_records_per_sec);
 DECLARE_uint64(max_clock_skew_usec);
 DECLARE_int64(db_write_buffer_size);
 DECLARE_bool(rocksdb_use_logging_iterator);
 
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_Read);
+
 namespace yb {
 namespace pgwrapper {
 
@@ -676,6 +683,41 @@ TEST_F(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(ForeignKeySnapshot)) {
   TestForeignKey(IsolationLevel::SNAPSHOT_ISOLATION);
 }
 
+class PgMiniBigForeignKeyBatchTest : public PgMiniTest {
+ protected:
+  void SetUp() override {
+    FLAGS_ysql_max_fk_check_batch_size = 10000;
+    PgMiniTest::SetUp();
+  }
+};
+
+TEST_F_EX(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(BulkInsertForeignKeyBatch),
+          PgMiniBigForeignKeyBatchTest) {
+  constexpr int kParentRows = 1000;
+  constexpr int kChildRows = 10000;
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute("CREATE TABLE parent (id INT PRIMARY KEY)"));
+  ASSERT_OK(conn.Execute(
+      "CREATE TABLE child (id INT PRIMARY KEY, parent_id INT REFERENCES parent)"));
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO parent SELECT generate_series(1, $0)", kParentRows));
+
+  // References of all rows are checked by batched reads of the parent table at statement end.
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO child SELECT i, i % $0 + 1 FROM generate_series(1, $1) AS i",
+      kParentRows, kChildRows));
+  ASSERT_EQ(ASSERT_RESULT(conn.FetchValue<int64_t>("SELECT COUNT(*) FROM child")), kChildRows);
+
+  // A single missing reference among the batch fails the statement.
+  auto status = conn.ExecuteFormat(
+      "INSERT INTO child SELECT i, CASE WHEN i = $1 THEN $0 + 1 ELSE i % $0 + 1 END "
+          "FROM generate_series($1, $1 + $2 - 1) AS i",
+      kParentRows, kChildRows + 1, kChildRows);
+  ASSERT_NOK(status);
+  ASSERT_STR_CONTAINS(status.ToString(), "violates foreign key constraint");
+  ASSERT_EQ(ASSERT_RESULT(conn.FetchValue<int64_t>("SELECT COUNT(*) FROM child")), kChildRows);
+}
+
 // ------------------------------------------------------------------------------------------------
 // A test performing manual transaction control on system tables.
 // ------------------------------------------------------------------------------------------------
@@ -959,6 +1001,237 @@ TEST_F_EX(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(ManyRowsInsert), PgMiniSingleTServ
   LOG(INFO) << "Time: " << finish - start;
 }
 
+class PgMiniPipelinedWriteTest : public PgMiniTest {
+ protected:
+  void SetUp() override {
+    FLAGS_ysql_max_in_flight_write_batches = 4;
+    FLAGS_ysql_session_max_batch_size = 64;
+    PgMiniTest::SetUp();
+  }
+};
+
+TEST_F_EX(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(PipelinedCopy), PgMiniPipelinedWriteTest) {
+  constexpr int kRows = 5000;
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute("CREATE TABLE t (key INT PRIMARY KEY, value INT) SPLIT INTO 3 TABLETS"));
+  ASSERT_OK(conn.Execute("CREATE INDEX t_value ON t (value)"));
+
+  ASSERT_OK(conn.CopyBegin("COPY t FROM STDIN WITH BINARY"));
+  for (int key = 1; key <= kRows; ++key) {
+    conn.CopyStartRow(2);
+    conn.CopyPutInt32(key);
+    conn.CopyPutInt32(key % 100);
+  }
+  ASSERT_OK(conn.CopyEnd());
+
+  auto res = ASSERT_RESULT(conn.Fetch("SELECT COUNT(*) FROM t"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt64(res.get(), 0, 0)), kRows);
+  res = ASSERT_RESULT(conn.Fetch("SELECT COUNT(*) FROM t WHERE value = 7"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt64(res.get(), 0, 0)), kRows / 100);
+
+  // Error of a batch that was in flight should fail the statement.
+  ASSERT_OK(conn.CopyBegin("COPY t FROM STDIN WITH BINARY"));
+  for (int key = kRows + 1; key <= kRows * 2; ++key) {
+    conn.CopyStartRow(2);
+    conn.CopyPutInt32(key == kRows + 10 ? 1 : key);
+    conn.CopyPutInt32(key % 100);
+  }
+  ASSERT_NOK(conn.CopyEnd());
+
+  res = ASSERT_RESULT(conn.Fetch("SELECT COUNT(*) FROM t"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt64(res.get(), 0, 0)), kRows);
+}
+
+class PgMiniPipelinedStatementsTest : public PgMiniTest {
+ protected:
+  void SetUp() override {
+    FLAGS_ysql_pipeline_writes_across_statements = true;
+    FLAGS_ysql_max_in_flight_write_batches = 4;
+    PgMiniTest::SetUp();
+  }
+};
+
+TEST_F_EX(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(PipelinedStatements), PgMiniPipelinedStatementsTest) {
+  constexpr int kRows = 100;
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute("CREATE TABLE t (key INT PRIMARY KEY, value INT)"));
+
+  ASSERT_OK(conn.Execute("BEGIN"));
+  for (int key = 1; key <= kRows; ++key) {
+    ASSERT_OK(conn.ExecuteFormat("INSERT INTO t VALUES ($0, $0)", key));
+  }
+  // Reads should see writes of previous statements that could still be in flight.
+  auto res = ASSERT_RESULT(conn.Fetch("SELECT COUNT(*) FROM t"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt64(res.get(), 0, 0)), kRows);
+  ASSERT_OK(conn.Execute("UPDATE t SET value = value + 1 WHERE key = 1"));
+  ASSERT_OK(conn.Execute("COMMIT"));
+
+  res = ASSERT_RESULT(conn.Fetch("SELECT value FROM t WHERE key = 1"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), 2);
+
+  // Error of a write could be reported by a later statement, at the latest by commit.
+  ASSERT_OK(conn.Execute("BEGIN"));
+  ASSERT_OK(conn.ExecuteFormat("INSERT INTO t VALUES ($0, 0)", kRows + 1));
+  if (conn.Execute("INSERT INTO t VALUES (1, 0)").ok()) {
+    ASSERT_NOK(conn.Execute("COMMIT"));
+  } else {
+    ASSERT_OK(conn.Execute("ROLLBACK"));
+  }
+  res = ASSERT_RESULT(conn.Fetch("SELECT COUNT(*) FROM t"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt64(res.get(), 0, 0)), kRows);
+}
+
+class PgMiniPipelinedIndexScanTest : public PgMiniTest {
+ protected:
+  void SetUp() override {
+    FLAGS_ysql_pipeline_index_scan_table_reads = true;
+    FLAGS_ysql_prefetch_limit = 50;
+    PgMiniTest::SetUp();
+  }
+};
+
+TEST_F_EX(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(PipelinedIndexScan), PgMiniPipelinedIndexScanTest) {
+  constexpr int kRows = 2000;
+  constexpr int kValues = 5;
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute(
+      "CREATE TABLE t (key INT PRIMARY KEY, value INT, payload TEXT) SPLIT INTO 3 TABLETS"));
+  ASSERT_OK(conn.Execute("CREATE INDEX t_value ON t (value ASC)"));
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO t SELECT i, i % $0, 'payload_' || i FROM generate_series(1, $1) AS i",
+      kValues, kRows));
+
+  // Payload is not in the index, so rows are read from the table in batches of index entries.
+  auto res = ASSERT_RESULT(conn.Fetch("SELECT key, payload FROM t WHERE value = 3"));
+  ASSERT_EQ(PQntuples(res.get()), kRows / kValues);
+  for (int i = 0; i != PQntuples(res.get()); ++i) {
+    const auto key = ASSERT_RESULT(GetInt32(res.get(), i, 0));
+    ASSERT_EQ(key % kValues, 3);
+    ASSERT_EQ(ASSERT_RESULT(GetString(res.get(), i, 1)), Format("payload_$0", key));
+  }
+
+  // Rows are returned in index order across batches.
+  res = ASSERT_RESULT(conn.Fetch("SELECT value, payload FROM t WHERE value >= 1 ORDER BY value"));
+  ASSERT_EQ(PQntuples(res.get()), kRows - kRows / kValues);
+  int previous_value = 0;
+  for (int i = 0; i != PQntuples(res.get()); ++i) {
+    const auto value = ASSERT_RESULT(GetInt32(res.get(), i, 0));
+    ASSERT_GE(value, previous_value);
+    previous_value = value;
+  }
+
+  res = ASSERT_RESULT(conn.Fetch("SELECT key FROM t WHERE value = 3 LIMIT 10"));
+  ASSERT_EQ(PQntuples(res.get()), 10);
+}
+
+class PgMiniNodeTableSchemaCacheTest : public PgMiniTest {
+ protected:
+  void SetUp() override {
+    FLAGS_ysql_use_node_table_schema_cache = true;
+    PgMiniTest::SetUp();
+  }
+};
+
+TEST_F_EX(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(NodeTableSchemaCache),
+          PgMiniNodeTableSchemaCacheTest) {
+  auto conn1 = ASSERT_RESULT(Connect());
+  auto conn2 = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn1.Execute("CREATE TABLE t (key INT PRIMARY KEY, value INT)"));
+  ASSERT_OK(conn1.Execute("INSERT INTO t VALUES (1, 1)"));
+  auto res = ASSERT_RESULT(conn2.Fetch("SELECT value FROM t WHERE key = 1"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), 1);
+
+  // Schema cached by the tserver for the first backends must not be served after the change.
+  ASSERT_OK(conn1.Execute("ALTER TABLE t ADD COLUMN extra INT"));
+  ASSERT_OK(conn2.Execute("INSERT INTO t VALUES (2, 2, 2)"));
+  auto conn3 = ASSERT_RESULT(Connect());
+  res = ASSERT_RESULT(conn3.Fetch("SELECT extra FROM t WHERE key = 2"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), 2);
+}
+
+class PgMiniSequenceNodeCacheTest : public PgMiniTest {
+ protected:
+  void SetUp() override {
+    FLAGS_ysql_sequence_node_cache_size = 1000;
+    PgMiniTest::SetUp();
+  }
+};
+
+TEST_F_EX(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(SequenceNodeCache), PgMiniSequenceNodeCacheTest) {
+  auto conn1 = ASSERT_RESULT(Connect());
+  auto conn2 = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn1.Execute("CREATE SEQUENCE s CACHE 100"));
+
+  // The first backend claims 1000 values, caches 100 of them and leaves the rest to the node.
+  ASSERT_EQ(ASSERT_RESULT(conn1.FetchValue<int64_t>("SELECT nextval('s')")), 1);
+  ASSERT_EQ(ASSERT_RESULT(conn2.FetchValue<int64_t>("SELECT nextval('s')")), 101);
+
+  // Values cached by the node before the sequence was altered are not handed out.
+  ASSERT_OK(conn1.Execute("ALTER SEQUENCE s INCREMENT 2"));
+  auto conn3 = ASSERT_RESULT(Connect());
+  ASSERT_EQ(ASSERT_RESULT(conn3.FetchValue<int64_t>("SELECT nextval('s')")), 1002);
+}
+
+TEST_F_EX(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(TServerCatalogVersionOnStartup),
+          PgMiniSingleTServerTest) {
+  constexpr int kNumConnections = 5;
+
+  auto* master = ASSERT_RESULT(cluster_->GetLeaderMiniMaster())->master();
+  auto* tserver = cluster_->mini_tablet_server(0)->server();
+  // Backends started with the tserver version validate relcache init files against it, so the
+  // tserver should have the latest version from the master.
+  auto wait_for_tserver_catalog_version = [master, tserver] {
+    return WaitFor([master, tserver]() -> Result<bool> {
+      uint64_t master_version = 0;
+      RETURN_NOT_OK(master->catalog_manager()->GetYsqlCatalogVersion(
+          &master_version, nullptr /* last_breaking_version */));
+      uint64_t tserver_version = 0;
+      tserver->get_ysql_catalog_version(&tserver_version, nullptr /* last_breaking_version */);
+      return tserver_version == master_version;
+    }, 10s * kTimeMultiplier, "Wait for tserver catalog version");
+  };
+
+  // Reads of the sys catalog, including the catalog version table, are served by the master.
+  auto master_reads = METRIC_handler_latency_yb_tserver_TabletServerService_Read.Instantiate(
+      master->metric_entity());
+  auto count_master_reads_by_new_connections = [this, &master_reads]() -> Result<uint64_t> {
+    const auto initial_reads = master_reads->TotalCount();
+    for (int i = 0; i != kNumConnections; ++i) {
+      auto conn = VERIFY_RESULT(Connect());
+      RETURN_NOT_OK(conn.Fetch("SELECT * FROM t"));
+    }
+    return master_reads->TotalCount() - initial_reads;
+  };
+
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute("CREATE TABLE t (key INT PRIMARY KEY, value INT)"));
+  ASSERT_OK(wait_for_tserver_catalog_version());
+  // The first new connection after DDL rebuilds relcache init files.
+  ASSERT_RESULT(count_master_reads_by_new_connections());
+  const auto reads_with_master_version = ASSERT_RESULT(count_master_reads_by_new_connections());
+
+  ASSERT_OK(conn.Execute("ALTER SYSTEM SET yb_use_tserver_catalog_version_on_startup = on"));
+  ASSERT_OK(conn.Fetch("SELECT pg_reload_conf()"));
+  ASSERT_OK(WaitFor([this]() -> Result<bool> {
+    auto new_conn = VERIFY_RESULT(Connect());
+    return VERIFY_RESULT(new_conn.FetchValue<std::string>(
+        "SHOW yb_use_tserver_catalog_version_on_startup")) == "on";
+  }, 10s * kTimeMultiplier, "Wait for configuration reload"));
+  const auto reads_with_tserver_version = ASSERT_RESULT(count_master_reads_by_new_connections());
+  LOG(INFO) << "Master reads by " << kNumConnections << " new connections, with master catalog "
+            << "version: " << reads_with_master_version << ", with tserver catalog version: "
+            << reads_with_tserver_version;
+  // Each new connection reads the catalog version from the master at least once otherwise.
+  ASSERT_LE(reads_with_tserver_version + kNumConnections, reads_with_master_version);
+
+  // New connections still see the latest schema after DDL.
+  ASSERT_OK(conn.Execute("ALTER TABLE t ADD COLUMN extra INT"));
+  ASSERT_OK(conn.Execute("INSERT INTO t VALUES (1, 1, 1)"));
+  ASSERT_OK(wait_for_tserver_catalog_version());
+  auto new_conn = ASSERT_RESULT(Connect());
+  ASSERT_EQ(ASSERT_RESULT(new_conn.FetchValue<int32_t>("SELECT extra FROM t WHERE key = 1")), 1);
+}
+
 TEST_F(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(MoveMaster)) {
   ShutdownAllMasters(cluster_.get());
   cluster_->mini_master(0)->set_pass_master_addresses(false);
@@ -1324,6 +1597,12 @@ TEST_F(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(BigInsertWithRestart)) {
   TestBigInsert(/* restart= */ true);
 }
 
+TEST_F(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(BigInsertWithThrottledApply)) {
+  // Each of 10 apply batches takes about 200ms.
+  FLAGS_apply_intents_max_records_per_sec = RegularBuildVsSanitizers(100000, 10000) / 2;
+  TestBigInsert(/* restart= */ false);
+}
+
 TEST_F(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(BigInsertWithDropTable)) {
   constexpr int kNumRows = 10000;
   FLAGS_txn_max_apply_batch_records = kNumRows / 10;
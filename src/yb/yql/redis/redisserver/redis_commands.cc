@@ -13,6 +13,8 @@
 
 #include "yb/yql/redis/redisserver/redis_commands.h"
 
+#include <map>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/preprocessor/seq/for_each.hpp>
 #include <boost/preprocessor/stringize.hpp>
@@ -32,6 +34,8 @@
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/scheduler.h"
 
+#include "yb/tserver/tablet_server.h"
+
 #include "yb/util/crypt.h"
 #include "yb/util/metrics.h"
 #include "yb/util/redis_util.h"
@@ -60,6 +64,10 @@ DEFINE_bool(yedis_enable_flush, true, "Enables FLUSHDB and FLUSHALL commands in
 DEFINE_bool(use_hashed_redis_password, true, "Store the hash of the redis passwords instead.");
 DEFINE_string(redis_passwords_separator, ",", "The character used to separate multiple passwords.");
 
+DEFINE_bool(redis_cluster_slots_include_replicas, false,
+            "Whether CLUSTER SLOTS lists the followers of each slot range as its replicas, after "
+            "the leader.");
+
 DEFINE_int32(redis_keys_threshold, 10000,
              "Maximum number of keys allowed to be in the db before the KEYS operation errors out");
 
@@ -120,6 +128,8 @@ namespace redisserver {
     ((config, Config, -1, LOCAL)) \
     ((info, Info, -1, LOCAL)) \
     ((role, Role, 1, LOCAL)) \
+    ((readonly, ReadOnly, 1, LOCAL)) \
+    ((readwrite, ReadWrite, 1, LOCAL)) \
     ((select, Select, 2, LOCAL)) \
     ((createdb, CreateDB, 2, LOCAL)) \
     ((listdb, ListDB, 1, LOCAL)) \
@@ -187,6 +197,15 @@ namespace {
 template<class Op>
 using Parser = Status(*)(Op*, const RedisClientCommand&);
 
+void SetConsistencyLevel(yb::client::YBRedisReadOp* op, BatchContext* context) {
+  if (context->call()->connection_context().follower_reads_allowed()) {
+    op->set_yb_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+  }
+}
+
+void SetConsistencyLevel(yb::client::YBRedisWriteOp* op, BatchContext* context) {
+}
+
 template<class Op>
 void Command(
     const RedisCommandInfo& info,
@@ -208,6 +227,7 @@ void Command(
     RespondWithFailure(context->call(), idx, s.message().ToBuffer());
     return;
   }
+  SetConsistencyLevel(op.get(), context);
   context->Apply(idx, std::move(op), info.metrics);
 }
 
@@ -310,75 +330,141 @@ class LocalCommandData {
   BatchContextPtr context_;
 };
 
-void GetTabletLocations(LocalCommandData data, RedisArrayPB* array_response) {
+// Range of Redis cluster slots served by the tablet, the end is inclusive.
+std::pair<uint16_t, uint16_t> TabletSlotRange(const master::TabletLocationsPB& location) {
+  uint16_t start_key = 0;
+  uint16_t end_key_exclusive = kRedisClusterSlots;
+  if (location.partition().has_partition_key_start()) {
+    if (location.partition().partition_key_start().size() == PartitionSchema::kPartitionKeySize) {
+      start_key = PartitionSchema::DecodeMultiColumnHashValue(
+          location.partition().partition_key_start());
+    }
+  }
+  if (location.partition().has_partition_key_end()) {
+    if (location.partition().partition_key_end().size() == PartitionSchema::kPartitionKeySize) {
+      end_key_exclusive = PartitionSchema::DecodeMultiColumnHashValue(
+          location.partition().partition_key_end());
+    }
+  }
+  return {start_key, end_key_exclusive - 1};
+}
+
+Result<std::vector<master::TabletLocationsPB>> GetRedisTabletLocations(LocalCommandData data) {
   vector<string> tablets, partitions;
   vector<master::TabletLocationsPB> locations;
   const auto table_name = RedisServiceData::GetYBTableNameForRedisDatabase(
       data.call()->connection_context().redis_db_to_use());
-  auto s = data.client()->GetTabletsAndUpdateCache(
-      table_name, 0, &tablets, &partitions, &locations);
-  if (!s.ok()) {
-    LOG(ERROR) << "Error getting tablets: " << s.message();
+  RETURN_NOT_OK(data.client()->GetTabletsAndUpdateCache(
+      table_name, 0, &tablets, &partitions, &locations));
+  return locations;
+}
+
+// Host, port and id of the Redis server on the tablet server, as used by CLUSTER SLOTS.
+// Redis servers of all nodes are expected to listen on the same port.
+std::string EncodeRedisNode(LocalCommandData data, const master::TSInfoPB& ts_info) {
+  vector<string> node_info;
+  node_info.reserve(3);
+  node_info.push_back(redisserver::EncodeAsBulkString(
+      DesiredHostPort(ts_info, CloudInfoPB()).host()).ToBuffer());
+  node_info.push_back(redisserver::EncodeAsInteger(
+      data.server()->opts().rpc_opts.default_port).ToBuffer());
+  node_info.push_back(redisserver::EncodeAsBulkString(ts_info.permanent_uuid()).ToBuffer());
+  return redisserver::EncodeAsArrayOfEncodedElements(node_info).ToBuffer();
+}
+
+void GetTabletLocations(LocalCommandData data, RedisArrayPB* array_response) {
+  auto locations = GetRedisTabletLocations(data);
+  if (!locations.ok()) {
+    LOG(ERROR) << "Error getting tablets: " << locations.status().message();
     return;
   }
-  vector<string> response, ts_info;
-  response.reserve(3);
-  ts_info.reserve(2);
-  for (master::TabletLocationsPB &location : locations) {
+  vector<string> response;
+  for (const master::TabletLocationsPB& location : *locations) {
     response.clear();
-    ts_info.clear();
-
-    uint16_t start_key = 0;
-    uint16_t end_key_exclusive = kRedisClusterSlots;
-    if (location.partition().has_partition_key_start()) {
-      if (location.partition().partition_key_start().size() == PartitionSchema::kPartitionKeySize) {
-        start_key = PartitionSchema::DecodeMultiColumnHashValue(
-            location.partition().partition_key_start());
-      }
-    }
-    if (location.partition().has_partition_key_end()) {
-      if (location.partition().partition_key_end().size() == PartitionSchema::kPartitionKeySize) {
-        end_key_exclusive = PartitionSchema::DecodeMultiColumnHashValue(
-            location.partition().partition_key_end());
-      }
-    }
-    response.push_back(redisserver::EncodeAsInteger(start_key).ToBuffer());
-    response.push_back(redisserver::EncodeAsInteger(end_key_exclusive - 1).ToBuffer());
+    const auto slot_range = TabletSlotRange(location);
+    response.push_back(redisserver::EncodeAsInteger(slot_range.first).ToBuffer());
+    response.push_back(redisserver::EncodeAsInteger(slot_range.second).ToBuffer());
 
-    for (const auto &replica : location.replicas()) {
+    // The leader goes first, followed by the followers as its replicas.
+    bool has_leader = false;
+    for (const auto& replica : location.replicas()) {
       if (replica.role() == consensus::RaftPeerPB::LEADER) {
-        auto host = DesiredHostPort(replica.ts_info(), CloudInfoPB()).host();
-        ts_info.push_back(redisserver::EncodeAsBulkString(host).ToBuffer());
-
-        const auto redis_port = data.server()->opts().rpc_opts.default_port;
-
-        VLOG(1) << "Start key: " << start_key
-                << ", end key: " << end_key_exclusive - 1
-                << ", node " << host
-                << ", port " << redis_port;
-
-        ts_info.push_back(redisserver::EncodeAsInteger(redis_port).ToBuffer());
-        ts_info.push_back(
-            redisserver::EncodeAsBulkString(replica.ts_info().permanent_uuid()).ToBuffer());
-        // TODO (hector): add all the replicas to the list of redis servers in charge of this
-        // partition range.
+        VLOG(1) << "Start key: " << slot_range.first
+                << ", end key: " << slot_range.second
+                << ", node " << replica.ts_info().permanent_uuid();
+        response.push_back(EncodeRedisNode(data, replica.ts_info()));
+        has_leader = true;
         break;
       }
     }
-    response.push_back(redisserver::EncodeAsArrayOfEncodedElements(ts_info));
+    if (!has_leader) {
+      response.push_back(redisserver::EncodeAsArrayOfEncodedElements(vector<string>()).ToBuffer());
+    } else if (FLAGS_redis_cluster_slots_include_replicas) {
+      for (const auto& replica : location.replicas()) {
+        if (replica.role() == consensus::RaftPeerPB::FOLLOWER) {
+          response.push_back(EncodeRedisNode(data, replica.ts_info()));
+        }
+      }
+    }
     array_response->add_elements(redisserver::EncodeAsArrayOfEncodedElements(response));
   }
   array_response->set_encoded(true);
 }
 
+// Responds in the CLUSTER NODES format, with a line per tablet server that leads tablets:
+// <id> <ip:port@cport> <flags> <master> <ping-sent> <pong-recv> <config-epoch> <link-state> <slots>
+// Followers are not listed as replicas, because a tablet server leads some tablets and follows
+// others, which the format can not express.
+Status GetClusterNodes(LocalCommandData data, RedisResponsePB* response) {
+  auto locations = VERIFY_RESULT(GetRedisTabletLocations(data));
+  struct NodeSlots {
+    std::string host;
+    std::string slots;
+  };
+  std::map<std::string, NodeSlots> nodes;
+  for (const master::TabletLocationsPB& location : locations) {
+    for (const auto& replica : location.replicas()) {
+      if (replica.role() != consensus::RaftPeerPB::LEADER) {
+        continue;
+      }
+      auto& node = nodes[replica.ts_info().permanent_uuid()];
+      node.host = DesiredHostPort(replica.ts_info(), CloudInfoPB()).host();
+      const auto slot_range = TabletSlotRange(location);
+      node.slots += slot_range.first == slot_range.second
+          ? Format(" $0", slot_range.first)
+          : Format(" $0-$1", slot_range.first, slot_range.second);
+      break;
+    }
+  }
+
+  const auto port = data.server()->opts().rpc_opts.default_port;
+  const auto& local_uuid = data.server()->tserver()->permanent_uuid();
+  std::string result;
+  for (const auto& node : nodes) {
+    result += Format(
+        "$0 $1:$2@$2 $3 - 0 0 0 connected$4\n", node.first, node.second.host, port,
+        node.first == local_uuid ? "myself,master" : "master", node.second.slots);
+  }
+  response->set_string_response(result);
+  return Status::OK();
+}
+
 void ClusterCommand(
     const RedisCommandInfo& info,
     size_t idx,
     BatchContext* context) {
   RedisResponsePB cluster_response;
-  auto array_response = cluster_response.mutable_array_response();
   LocalCommandData data(info, idx, context);
-  GetTabletLocations(data, array_response);
+  if (boost::iequals(data.arg(1).ToBuffer(), "NODES")) {
+    auto status = GetClusterNodes(data, &cluster_response);
+    if (!status.ok()) {
+      RespondWithFailure(data.call(), idx, status.message().ToBuffer());
+      return;
+    }
+  } else {
+    // SLOTS, other subcommands are answered the same way for compatibility.
+    GetTabletLocations(data, cluster_response.mutable_array_response());
+  }
   context->call()->RespondSuccess(idx, info.metrics, &cluster_response);
   VLOG(1) << "Done responding to CLUSTER.";
 }
@@ -544,6 +630,18 @@ void HandleRole(LocalCommandData data) {
   data.Respond(&response);
 }
 
+// READONLY lets the reads of the connection be served by the closest replica, possibly a follower,
+// as long as it is not staler than max_stale_read_bound_time_ms. READWRITE reverts to leader reads.
+void HandleReadOnly(LocalCommandData data) {
+  data.call()->connection_context().set_follower_reads_allowed(true);
+  data.Respond();
+}
+
+void HandleReadWrite(LocalCommandData data) {
+  data.call()->connection_context().set_follower_reads_allowed(false);
+  data.Respond();
+}
+
 void HandleInfo(LocalCommandData data) {
   RedisResponsePB response;
   response.set_code(RedisResponsePB::OK);
@@ -48,9 +48,35 @@ namespace {
 constexpr size_t kMaxNumberOfArgs = 1 << 20;
 constexpr size_t kLineEndLength = 2;
 constexpr size_t kMaxNumberLength = 25;
+// Numbers with at most this many digits cannot overflow int64_t.
+constexpr size_t kMaxFastNumberDigits = 18;
 constexpr char kPositiveInfinity[] = "+inf";
 constexpr char kNegativeInfinity[] = "-inf";
 
+// Parses a plain decimal number, with an optional minus sign, directly from the buffer.
+// Returns false when the input is not such a number, so that the caller falls back to the generic
+// and more thorough parsing, that also produces the error message.
+bool FastParseNumber(const char* begin, const char* end, int64_t* result) {
+  bool negative = false;
+  if (begin != end && *begin == '-') {
+    negative = true;
+    ++begin;
+  }
+  if (begin == end || static_cast<size_t>(end - begin) > kMaxFastNumberDigits) {
+    return false;
+  }
+  int64_t value = 0;
+  for (auto* p = begin; p != end; ++p) {
+    const unsigned digit = static_cast<unsigned char>(*p) - '0';
+    if (digit > 9) {
+      return false;
+    }
+    value = value * 10 + digit;
+  }
+  *result = negative ? -value : value;
+  return true;
+}
+
 string to_lower_case(Slice slice) {
   return boost::to_lower_copy(slice.ToBuffer());
 }
@@ -1201,11 +1227,20 @@ Result<ptrdiff_t> RedisParser::ParseNumber(char prefix,
     return STATUS_FORMAT(
         Corruption, "Too long $0 of length $1", name, expected_stop - number_begin);
   }
-  number_buffer_.reserve(kMaxNumberLength);
-  IoVecsToBuffer(source_, number_begin, expected_stop, &number_buffer_);
-  number_buffer_.push_back(0);
-  auto parsed_number = VERIFY_RESULT(CheckedStoll(
-      Slice(number_buffer_.data(), number_buffer_.size() - 1)));
+  // Argument sizes are parsed once per argument, so avoid copying them out of the buffer, as long
+  // as the number does not span two blocks of data.
+  int64_t parsed_number;
+  auto p = offset_to_idx_and_local_offset(number_begin);
+  const auto number_length = expected_stop - number_begin;
+  const char* number_ptr = IoVecBegin(source_[p.first]) + p.second;
+  if (p.second + number_length > source_[p.first].iov_len ||
+      !FastParseNumber(number_ptr, number_ptr + number_length, &parsed_number)) {
+    number_buffer_.reserve(kMaxNumberLength);
+    IoVecsToBuffer(source_, number_begin, expected_stop, &number_buffer_);
+    number_buffer_.push_back(0);
+    parsed_number = VERIFY_RESULT(CheckedStoll(
+        Slice(number_buffer_.data(), number_buffer_.size() - 1)));
+  }
   static_assert(sizeof(parsed_number) == sizeof(ptrdiff_t), "Expected size");
   SCHECK_BOUNDS(parsed_number,
                 min,
@@ -64,6 +64,16 @@ class RedisConnectionContext : public rpc::ConnectionContextWithQueue {
 
   void SetCleanupHook(std::function<void()> hook) { cleanup_hook_ = std::move(hook); }
 
+  // Whether reads of this connection could be served by followers (READONLY command), with the
+  // staleness bounded by max_stale_read_bound_time_ms on the tablet servers.
+  bool follower_reads_allowed() const {
+    return follower_reads_allowed_.load(std::memory_order_acquire);
+  }
+
+  void set_follower_reads_allowed(bool flag) {
+    follower_reads_allowed_.store(flag, std::memory_order_release);
+  }
+
   // Shutdown this context. Clean up the subscriptions if any.
   void Shutdown(const Status& status) override;
 
@@ -94,6 +104,7 @@ class RedisConnectionContext : public rpc::ConnectionContextWithQueue {
   size_t commands_in_batch_ = 0;
   size_t end_of_batch_ = 0;
   std::atomic<bool> authenticated_{false};
+  std::atomic<bool> follower_reads_allowed_{false};
   std::string redis_db_name_ = "0";
   std::atomic<RedisClientMode> mode_{RedisClientMode::kNormal};
   CoarseTimePoint soft_limit_exceeded_since_{CoarseTimePoint::max()};
@@ -39,7 +39,9 @@
 #include "yb/client/table.h"
 #include "yb/client/yb_op.h"
 
+#include "yb/common/partition.h"
 #include "yb/common/redis_protocol.pb.h"
+#include "yb/common/wire_protocol.h"
 
 #include "yb/yql/redis/redisserver/redis_commands.h"
 #include "yb/yql/redis/redisserver/redis_constants.h"
@@ -50,11 +52,13 @@
 #include "yb/rpc/connection.h"
 #include "yb/rpc/rpc_context.h"
 #include "yb/rpc/rpc_introspection.pb.h"
+#include "yb/rpc/scheduler.h"
 
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/tserver_service.proxy.h"
 
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/locks.h"
 #include "yb/util/logging.h"
 #include "yb/util/memory/mc_types.h"
@@ -121,7 +125,24 @@ DEFINE_int32(redis_password_caching_duration_ms, 5000,
              "The duration for which we will cache the redis passwords. 0 to disable.");
 
 DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
+DEFINE_int32(redis_flush_coalesce_linger_us, 0,
+             "When positive, read and write commands that are ready to be flushed, even from "
+             "different connections, are gathered for up to this time and flushed together with "
+             "a single session, so that commands on the same tablet share an RPC. 0 disables it, "
+             "each batch of a connection being flushed on its own.");
+TAG_FLAG(redis_flush_coalesce_linger_us, advanced);
+DEFINE_int32(redis_flush_coalesce_max_ops, 1000,
+             "Maximal number of operations flushed together when redis_flush_coalesce_linger_us "
+             "is positive. Operations are flushed before the linger time when they reach it.");
+TAG_FLAG(redis_flush_coalesce_max_ops, advanced);
+TAG_FLAG(redis_flush_coalesce_max_ops, runtime);
 DEFINE_bool(enable_redis_auth, true, "Enable AUTH for the Redis service");
+DEFINE_bool(redis_cluster_moved_redirects, false,
+            "Whether commands on keys whose tablet leader is on another node are answered with a "
+            "Redis cluster MOVED redirect to that node, instead of being forwarded to the leader. "
+            "Cluster aware clients then send commands directly to the node of the leader.");
+TAG_FLAG(redis_cluster_moved_redirects, advanced);
+TAG_FLAG(redis_cluster_moved_redirects, runtime);
 
 DECLARE_string(placement_cloud);
 DECLARE_string(placement_region);
@@ -335,6 +356,8 @@ class Operation {
   std::atomic<bool> responded_{false};
 };
 
+class FlushCoalescer;
+
 class SessionPool {
  public:
   void Init(client::YBClient* client,
@@ -365,8 +388,19 @@ class SessionPool {
     available_sessions_metric_->IncrementBy(1);
     queue_.push(session.get());
   }
+
+  // Blocks are flushed through the coalescer, when set, instead of with their own session.
+  FlushCoalescer* coalescer() const {
+    return coalescer_;
+  }
+
+  void set_coalescer(FlushCoalescer* coalescer) {
+    coalescer_ = coalescer;
+  }
+
  private:
   client::YBClient* client_ = nullptr;
+  FlushCoalescer* coalescer_ = nullptr;
   std::mutex mutex_;
   std::vector<std::shared_ptr<client::YBSession>> sessions_;
   boost::lockfree::queue<client::YBSession*> queue_{30};
@@ -397,30 +431,35 @@ class Block : public std::enable_shared_from_this<Block> {
     ops_.push_back(operation);
   }
 
-  void Launch(SessionPool* session_pool, bool allow_local_calls_in_curr_thread = true) {
-    session_pool_ = session_pool;
-    session_ = session_pool->Take();
-    bool has_ok = false;
-    bool applied_operations = false;
-    // Supposed to be called only once.
+  size_t num_ops() const {
+    return ops_.size();
+  }
+
+  void Launch(SessionPool* session_pool, bool allow_local_calls_in_curr_thread = true);
+
+  // Applies the operations of this block to a session that is shared with other blocks. Returns
+  // the callback to invoke once that session is flushed, or nullptr if nothing was applied.
+  client::FlushCallback ApplyShared(client::YBSession* session) {
     client::FlushCallback callback = BlockCallback(shared_from_this());
-    auto status_callback = [callback](const Status& status){
-      client::FlushStatus flush_status = {status, {}};
-      callback(&flush_status);
-    };
-    for (auto* op : ops_) {
-      has_ok = op->Apply(session_.get(), status_callback, &applied_operations) || has_ok;
+    bool applied_operations = false;
+    if (!Apply(session, callback, &applied_operations)) {
+      Processed();
+      return nullptr;
     }
-    if (has_ok) {
-      if (applied_operations) {
-        // Allow local calls in this thread only if no one is waiting behind us.
-        session_->set_allow_local_calls_in_curr_thread(
-            allow_local_calls_in_curr_thread && this->next_ == nullptr);
-        session_->FlushAsync(std::move(callback));
+    if (!applied_operations) {
+      return nullptr;
+    }
+    return callback;
+  }
+
+  // Local operations run their own functor and cannot share a session with other blocks.
+  bool CanShareSession() const {
+    for (auto* op : ops_) {
+      if (op->type() == OperationType::kLocal) {
+        return false;
       }
-    } else {
-      Processed();
     }
+    return true;
   }
 
   BlockPtr SetNext(const BlockPtr& next) {
@@ -435,6 +474,36 @@ class Block : public std::enable_shared_from_this<Block> {
   }
 
  private:
+  void LaunchWithOwnSession(bool allow_local_calls_in_curr_thread) {
+    session_ = session_pool_->Take();
+    bool applied_operations = false;
+    // Supposed to be called only once.
+    client::FlushCallback callback = BlockCallback(shared_from_this());
+    if (Apply(session_.get(), callback, &applied_operations)) {
+      if (applied_operations) {
+        // Allow local calls in this thread only if no one is waiting behind us.
+        session_->set_allow_local_calls_in_curr_thread(
+            allow_local_calls_in_curr_thread && this->next_ == nullptr);
+        session_->FlushAsync(std::move(callback));
+      }
+    } else {
+      Processed();
+    }
+  }
+
+  bool Apply(client::YBSession* session, const client::FlushCallback& callback,
+             bool* applied_operations) {
+    auto status_callback = [callback](const Status& status){
+      client::FlushStatus flush_status = {status, {}};
+      callback(&flush_status);
+    };
+    bool has_ok = false;
+    for (auto* op : ops_) {
+      has_ok = op->Apply(session, status_callback, applied_operations) || has_ok;
+    }
+    return has_ok;
+  }
+
   class BlockCallback {
    public:
     explicit BlockCallback(BlockPtr block) : block_(std::move(block)) {
@@ -475,13 +544,19 @@ class Block : public std::enable_shared_from_this<Block> {
     bool tablet_not_found = false;
     if (!flush_status->status.ok()) {
       for (const auto& error : flush_status->errors) {
-        if (error->status().IsNotFound()) {
-          tablet_not_found = true;
-        }
         op_errors[&error->failed_op()] = std::move(error->status());
         YB_LOG_EVERY_N_SECS(WARNING, 1) << "Explicit error while inserting: "
                                         << error->status().ToString();
       }
+      // The session could be shared with other blocks, so only errors of our own operations count.
+      for (auto* op : ops_) {
+        if (op->has_operation()) {
+          auto it = op_errors.find(&op->operation());
+          if (it != op_errors.end() && it->second.IsNotFound()) {
+            tablet_not_found = true;
+          }
+        }
+      }
     }
 
     if (tablet_not_found && Retrying()) {
@@ -561,6 +636,100 @@ class Block : public std::enable_shared_from_this<Block> {
   int num_retries_ = 1;
 };
 
+// Gathers the blocks that are ready to be flushed, from any connection, for a short linger time
+// and flushes them with a single session. The session batcher then groups their operations by
+// tablet, so that commands of many clients on the same tablet are sent with one RPC. Blocks of a
+// connection are still launched one after another, which keeps the order of its commands.
+class FlushCoalescer {
+ public:
+  FlushCoalescer(SessionPool* session_pool, rpc::Scheduler* scheduler)
+      : session_pool_(session_pool), scheduler_(scheduler) {
+  }
+
+  void Add(const BlockPtr& block) {
+    bool flush_now = false;
+    bool schedule = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.push_back(block);
+      pending_ops_ += block->num_ops();
+      flush_now = pending_ops_ >= static_cast<size_t>(FLAGS_redis_flush_coalesce_max_ops);
+      if (!flush_now && !flush_scheduled_) {
+        flush_scheduled_ = true;
+        schedule = true;
+      }
+    }
+    if (flush_now) {
+      Flush();
+    } else if (schedule) {
+      scheduler_->Schedule([this](const Status& status) {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          flush_scheduled_ = false;
+        }
+        // Pending blocks are flushed even on shutdown, so that their calls get a response.
+        Flush();
+      }, FLAGS_redis_flush_coalesce_linger_us * 1us);
+    }
+  }
+
+ private:
+  void Flush() {
+    std::vector<BlockPtr> blocks;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      blocks.swap(pending_);
+      pending_ops_ = 0;
+    }
+    if (blocks.empty()) {
+      return;
+    }
+
+    auto session = session_pool_->Take();
+    auto callbacks = std::make_shared<std::vector<client::FlushCallback>>();
+    callbacks->reserve(blocks.size());
+    for (const auto& block : blocks) {
+      auto callback = block->ApplyShared(session.get());
+      if (callback) {
+        callbacks->push_back(std::move(callback));
+      }
+    }
+    blocks.clear();
+    if (callbacks->empty()) {
+      session_pool_->Release(session);
+      return;
+    }
+
+    // Callbacks of many connections run after the flush, so do not run it in this thread.
+    session->set_allow_local_calls_in_curr_thread(false);
+    session->FlushAsync([session_pool = session_pool_, session, callbacks](
+        client::FlushStatus* flush_status) {
+      session_pool->Release(session);
+      for (const auto& callback : *callbacks) {
+        callback(flush_status);
+      }
+    });
+  }
+
+  SessionPool* const session_pool_;
+  rpc::Scheduler* const scheduler_;
+
+  std::mutex mutex_;
+  std::vector<BlockPtr> pending_;
+  size_t pending_ops_ = 0;
+  bool flush_scheduled_ = false;
+};
+
+void Block::Launch(SessionPool* session_pool, bool allow_local_calls_in_curr_thread) {
+  session_pool_ = session_pool;
+  auto* coalescer = session_pool->coalescer();
+  if (coalescer != nullptr && CanShareSession()) {
+    coalescer->Add(shared_from_this());
+    return;
+  }
+  LaunchWithOwnSession(allow_local_calls_in_curr_thread);
+}
+
 typedef std::array<rpc::RpcMethodMetrics, kOperationTypeMapSize> InternalMetrics;
 
 struct BlockData {
@@ -803,6 +972,7 @@ struct RedisServiceImplData : public RedisServiceData {
   std::atomic<bool> initialized_;
   client::YBClient* client_ = nullptr;
   SessionPool session_pool_;
+  std::unique_ptr<FlushCoalescer> flush_coalescer_;
   std::unordered_map<std::string, std::shared_ptr<client::YBTable>> db_to_opened_table_;
   std::shared_ptr<client::YBMetaDataCache> tables_cache_;
 
@@ -964,6 +1134,9 @@ class BatchContextImpl : public BatchContext {
     BatchContextPtr self(this);
     for (auto& operation : operations_) {
       if (!operation.responded()) {
+        if (PREDICT_FALSE(FLAGS_redis_cluster_moved_redirects) && RedirectToLeader(&operation)) {
+          continue;
+        }
         auto it = tablets_.find(operation.tablet()->tablet_id());
         if (it == tablets_.end()) {
           it = tablets_.emplace(operation.tablet()->tablet_id(), TabletOperations(&arena_)).first;
@@ -979,6 +1152,32 @@ class BatchContextImpl : public BatchContext {
     tablets_.clear();
   }
 
+  // Responds with MOVED if the leader of the operation tablet is on another node. The slot of a key
+  // is its hash code, so the redirect follows the slot ranges of CLUSTER SLOTS. Leader changes are
+  // picked up by the meta cache when requests to the old leader fail.
+  bool RedirectToLeader(Operation* operation) {
+    if (operation->type() == OperationType::kLocal ||
+        operation->partition_key().size() != PartitionSchema::kPartitionKeySize) {
+      return false;
+    }
+    auto* leader = operation->tablet()->LeaderTServer();
+    if (!leader || leader->IsLocal()) {
+      return false;
+    }
+    const auto& host_port = DesiredHostPort(
+        leader->public_rpc_hostports(), leader->private_rpc_hostports(), leader->cloud_info(),
+        impl_data_->server_->MakeCloudInfoPB());
+    if (host_port.host().empty()) {
+      return false;
+    }
+    // Redis servers of all nodes are expected to listen on the same port.
+    operation->Respond(STATUS_FORMAT(
+        IllegalState, "MOVED $0 $1:$2",
+        PartitionSchema::DecodeMultiColumnHashValue(operation->partition_key()), host_port.host(),
+        impl_data_->server_->opts().rpc_opts.default_port));
+    return true;
+  }
+
   RedisServiceImplData* impl_data_ = nullptr;
 
   const string db_name_;
@@ -1372,6 +1571,11 @@ Status RedisServiceImplData::Initialize() {
     tables_cache_ = std::make_shared<YBMetaDataCache>(
         client_, false /* Update roles permissions cache */);
     session_pool_.Init(client_, server_->metric_entity());
+    if (FLAGS_redis_flush_coalesce_linger_us > 0) {
+      flush_coalescer_ = std::make_unique<FlushCoalescer>(
+          &session_pool_, &server_->messenger()->scheduler());
+      session_pool_.set_coalescer(flush_coalescer_.get());
+    }
 
     initialized_.store(true, std::memory_order_release);
   }
@@ -11,6 +11,7 @@
 // under the License.
 //
 
+#include <atomic>
 #include <chrono>
 #include <cstdio>
 #include <memory>
@@ -55,6 +56,8 @@ DECLARE_bool(TEST_tserver_timeout);
 DECLARE_bool(TEST_enable_backpressure_mode_for_testing);
 DECLARE_bool(yedis_enable_flush);
 DECLARE_int32(redis_service_yb_client_timeout_millis);
+DECLARE_int32(redis_flush_coalesce_linger_us);
+DECLARE_int32(redis_flush_coalesce_max_ops);
 DECLARE_int32(redis_max_value_size);
 DECLARE_int32(redis_max_command_size);
 DECLARE_int32(redis_password_caching_duration_ms);
@@ -1350,6 +1353,66 @@ TEST_F_EX(TestRedisService, SafeBatchPipeline, TestRedisServiceSafeBatch) {
   LOG(INFO) << yb::Format("Safe set: $0ms, get: $1ms", set_time.count(), get_time.count());
 }
 
+class TestRedisServiceFlushCoalescing : public TestRedisService {
+ public:
+  void SetUp() override {
+    FLAGS_redis_flush_coalesce_linger_us = 2000;
+    TestRedisService::SetUp();
+  }
+};
+
+TEST_F_EX(TestRedisService, FlushCoalescing, TestRedisServiceFlushCoalescing) {
+  constexpr int kClients = 20;
+  constexpr int kRounds = 20;
+  // Blocks of different connections are flushed together after the linger time, and then as soon
+  // as a few operations are pending.
+  for (int max_ops : {1000, 3}) {
+    FLAGS_redis_flush_coalesce_max_ops = max_ops;
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+    for (int c = 0; c != kClients; ++c) {
+      threads.emplace_back([this, c, max_ops, &failures] {
+        RedisClient client("127.0.0.1", server_port());
+        const auto key = Format("key_$0", c);
+        for (int r = 0; r != kRounds; ++r) {
+          // Commands of a connection are pipelined, and each of them should observe the previous
+          // one.
+          const auto value = Format("value_$0_$1_$2", max_ops, c, r);
+          std::vector<std::string> replies;
+          auto callback = [&replies](const RedisReply& reply) {
+            replies.push_back(reply.as_string());
+          };
+          client.Send({"SET", key, value}, callback);
+          client.Send({"GET", key}, callback);
+          client.Send({"SET", key, value + "_next"}, callback);
+          client.Send({"GET", key}, callback);
+          client.Commit();
+          const std::vector<std::string> expected = {"OK", value, "OK", value + "_next"};
+          if (replies != expected) {
+            LOG(WARNING) << "Unexpected replies: " << yb::ToString(replies) << ", expected: "
+                         << yb::ToString(expected);
+            ++failures;
+          }
+        }
+        client.Disconnect();
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    ASSERT_EQ(0, failures.load());
+
+    // Values written by all connections are visible to another one.
+    for (int c = 0; c != kClients; ++c) {
+      DoRedisTestBulkString(
+          __LINE__, {"GET", Format("key_$0", c)},
+          Format("value_$0_$1_$2_next", max_ops, c, kRounds - 1));
+    }
+    SyncClient();
+    VerifyCallbacks();
+  }
+}
+
 TEST_F(TestRedisService, BatchedCommandMulti) {
   SendCommandAndExpectResponse(
       __LINE__,
@@ -1509,6 +1572,21 @@ TEST_F(TestRedisService, TestSetThenGet) {
   );
 }
 
+TEST_F(TestRedisService, TestReadOnly) {
+  DoRedisTestOk(__LINE__, {"SET", "key", "value"});
+  SyncClient();
+
+  // Reads of a READONLY connection could be served by a follower that could be slightly stale, so
+  // only check a key that is never written.
+  DoRedisTestOk(__LINE__, {"READONLY"});
+  DoRedisTestNull(__LINE__, {"GET", "missing"});
+  SyncClient();
+
+  DoRedisTestOk(__LINE__, {"READWRITE"});
+  DoRedisTestBulkString(__LINE__, {"GET", "key"}, "value");
+  SyncClient();
+}
+
 TEST_F(TestRedisService, TestUsingOpenSourceClient) {
   DoRedisTestOk(__LINE__, {"SET", "hello", "42"});
 
@@ -3257,6 +3335,36 @@ TEST_F(TestRedisService, TestDummyLocal) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestClusterSlotsAndNodes) {
+  int64_t next_slot = 0;
+  DoRedisTest(__LINE__, {"CLUSTER", "SLOTS"}, RedisReplyType::kArray,
+      [&next_slot](const RedisReply& reply) {
+        const auto& ranges = reply.as_array();
+        ASSERT_GT(ranges.size(), 0);
+        for (const auto& range : ranges) {
+          const auto& range_info = range.as_array();
+          ASSERT_GE(range_info.size(), 3);
+          ASSERT_LE(range_info[0].as_integer(), range_info[1].as_integer());
+          next_slot = std::max(next_slot, range_info[1].as_integer() + 1);
+          // Leader host, port and id.
+          ASSERT_EQ(range_info[2].as_array().size(), 3);
+        }
+      }
+  );
+  SyncClient();
+  ASSERT_EQ(next_slot, 16384);
+
+  DoRedisTest(__LINE__, {"CLUSTER", "NODES"}, RedisReplyType::kString,
+      [](const RedisReply& reply) {
+        const auto nodes = reply.as_string();
+        ASSERT_NE(nodes.find("master - 0 0 0 connected"), string::npos) << nodes;
+        ASSERT_NE(nodes.find(" 0-"), string::npos) << nodes;
+      }
+  );
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestTimeSeriesTtl) {
   FLAGS_emulate_redis_responses = true;
   DoRedisTestOk(__LINE__, {"TSADD", "key", "10", "v", "EXPIRE_IN", "5"});